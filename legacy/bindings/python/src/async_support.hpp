@@ -0,0 +1,84 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include "xenocomm/utils/task_scheduler.hpp"
+
+namespace xenocomm {
+namespace py = pybind11;
+
+// asyncio integration: work finishes on C++ threads and completes futures through the
+// loop's call_soon_threadsafe(), so no Python thread waits on the network
+
+// Settles future on its loop's thread with outcome, unless it was cancelled meanwhile
+inline void complete_soon(const py::object& loop, const py::object& future, py::object outcome, bool failed) {
+    auto settle = py::cpp_function([](py::object future, py::object outcome, bool failed) {
+        if (future.attr("done")().cast<bool>()) {
+            return;
+        }
+        future.attr(failed ? "set_exception" : "set_result")(outcome);
+    });
+    try {
+        loop.attr("call_soon_threadsafe")(settle, future, outcome, failed);
+    } catch (py::error_already_set&) {
+        // The loop has closed, so nobody is left to await the result
+    }
+}
+
+// Workers for calls that block, like sends waiting for acks and negotiation round trips.
+// Never destroyed: a worker may still be finishing when the interpreter exits
+inline utils::TaskScheduler& blocking_workers() {
+    static auto* workers = new utils::TaskScheduler(std::max(4u, std::thread::hardware_concurrency()));
+    return *workers;
+}
+
+// Runs call on a worker without the GIL and returns a future on the running loop that
+// convert(result) completes, or a RuntimeError if call throws. keep is released under the
+// GIL once the call is done; pass it whatever the call reads from (the owner, a buffer)
+template <typename Call, typename Convert>
+py::object run_blocking(Call call, Convert convert, py::object owner, std::shared_ptr<void> keep = nullptr) {
+    struct Pending {
+        py::object loop;
+        py::object future;
+        py::object owner;
+        std::shared_ptr<void> keep;
+    };
+    py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+    py::object future = loop.attr("create_future")();
+    auto pending = std::make_shared<Pending>(Pending{loop, future, std::move(owner), std::move(keep)});
+
+    auto& workers = blocking_workers();
+    auto id = std::make_shared<utils::TaskScheduler::TaskId>(utils::TaskScheduler::INVALID_TASK);
+    *id = workers.add([pending, id, call = std::move(call), convert = std::move(convert)]() mutable {
+        std::optional<decltype(call())> result;
+        std::string error;
+        try {
+            result.emplace(call());
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "Unknown error";
+        }
+        {
+            // Python objects are dropped here, not wherever the task itself is destroyed
+            py::gil_scoped_acquire gil;
+            Pending done = std::move(*pending);
+            if (result) {
+                complete_soon(done.loop, done.future, convert(std::move(*result)), false);
+            } else {
+                complete_soon(done.loop, done.future, py::handle(PyExc_RuntimeError)(error), true);
+            }
+        }
+        blocking_workers().cancel(*id);
+    });
+    workers.runNow(*id);
+    return future;
+}
+
+} // namespace xenocomm
@@ -0,0 +1,178 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include "xenocomm/core/transmission_manager.h"
+#include "async_support.hpp"
+#include "type_converters.hpp"
+
+namespace py = pybind11;
+using namespace xenocomm::core;
+using xenocomm::Result;
+
+namespace {
+
+// Awaitable send() and receive() over one TransmissionManager. Messages are read by the
+// C++ reactor and handed to the event loop, so a process can drive thousands of channels
+// from one Python thread
+class AsyncTransmission {
+public:
+    explicit AsyncTransmission(TransmissionManager& manager)
+        : manager_(manager), state_(std::make_shared<State>()) {}
+
+    ~AsyncTransmission() { close(); }
+
+    AsyncTransmission(const AsyncTransmission&) = delete;
+    AsyncTransmission& operator=(const AsyncTransmission&) = delete;
+
+    py::object send(py::object self, py::buffer data) {
+        // The data is sent in place; the view pins it until the worker is done
+        auto buffer = std::make_shared<py::buffer_info>(data.request());
+        const xenocomm::utils::ByteSpan bytes = xenocomm::contiguous_bytes(*buffer);
+        TransmissionManager* manager = &manager_;
+        return xenocomm::run_blocking(
+            [manager, bytes] { return manager->send(bytes.data(), bytes.size()); },
+            [](Result<void> result) { return py::cast(std::move(result)); },
+            std::move(self), std::move(buffer));
+    }
+
+    py::object receive() {
+        py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+        if (!started_) {
+            start(loop);
+        } else if (!state_->loop.is(loop)) {
+            throw std::runtime_error("AsyncTransmission is bound to another event loop");
+        }
+        py::object future = loop.attr("create_future")();
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->waiting.push_back(future);
+        drain(*state_);
+        return future;
+    }
+
+    // Stops reading and cancels receives still waiting. Call it from the loop's thread
+    void close() {
+        if (!started_) {
+            return;
+        }
+        started_ = false;
+        {
+            // The handler may be waiting for the GIL, and stopping waits for the handler
+            py::gil_scoped_release release;
+            manager_.stop_async_receive();
+        }
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        for (auto& future : state_->waiting) {
+            future.attr("cancel")();
+        }
+        state_->waiting.clear();
+        state_->ready.clear();
+    }
+
+private:
+    struct State {
+        std::mutex mutex;  // Never held while taking the GIL
+        std::deque<Result<std::vector<uint8_t>>> ready;  // Arrived with no receive waiting
+        std::deque<py::object> waiting;                  // Futures; touched only with the GIL
+        std::optional<std::string> ended;                // Why the receive stopped, once it has
+        py::object loop;
+        bool drain_scheduled = false;
+    };
+
+    void start(const py::object& loop) {
+        state_->loop = loop;
+        std::weak_ptr<State> weak = state_;
+        auto started = manager_.start_async_receive([weak](Result<std::vector<uint8_t>> message) {
+            auto state = weak.lock();
+            if (!state) {
+                return;
+            }
+            bool wake;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!message.has_value()) {
+                    state->ended = message.error();
+                }
+                state->ready.push_back(std::move(message));
+                wake = !state->drain_scheduled;
+                state->drain_scheduled = true;
+            }
+            if (wake) {
+                // One wakeup covers everything that arrives before the loop gets to it
+                py::gil_scoped_acquire gil;
+                auto drain_soon = py::cpp_function([weak] {
+                    if (auto state = weak.lock()) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->drain_scheduled = false;
+                        drain(*state);
+                    }
+                });
+                try {
+                    state->loop.attr("call_soon_threadsafe")(drain_soon);
+                } catch (py::error_already_set&) {
+                    // The loop has closed; messages stay queued for a later receive()
+                }
+            }
+        });
+        if (!started.has_value()) {
+            state_->loop = py::object();
+            throw std::runtime_error("Cannot receive asynchronously: " + started.error());
+        }
+        started_ = true;
+    }
+
+    // Pairs waiting futures with messages; requires the GIL and state.mutex
+    static void drain(State& state) {
+        while (!state.waiting.empty()) {
+            py::object future = state.waiting.front();
+            if (future.attr("done")().cast<bool>()) {
+                state.waiting.pop_front();  // Cancelled by its caller
+                continue;
+            }
+            if (!state.ready.empty()) {
+                Result<py::object> result = state.ready.front().has_value()
+                    ? Result<py::object>(xenocomm::to_memoryview(std::move(state.ready.front().value())))
+                    : Result<py::object>(state.ready.front().error());
+                state.ready.pop_front();
+                future.attr("set_result")(std::move(result));
+            } else if (state.ended) {
+                future.attr("set_result")(Result<py::object>(*state.ended));
+            } else {
+                return;
+            }
+            state.waiting.pop_front();
+        }
+    }
+
+    TransmissionManager& manager_;
+    std::shared_ptr<State> state_;
+    bool started_ = false;
+};
+
+} // namespace
+
+void init_async_transmission(py::module_& m) {
+    py::class_<AsyncTransmission>(m, "AsyncTransmission")
+        .def(py::init<TransmissionManager&>(), py::arg("manager"), py::keep_alive<1, 2>())
+        .def("send", [](py::object self, py::buffer data) {
+            return self.cast<AsyncTransmission&>().send(self, std::move(data));
+        }, py::arg("data"), "Awaitable send of any buffer-protocol object; completes with a Result")
+        .def("receive", &AsyncTransmission::receive,
+            "Awaitable receive; completes with a ReceiveResult whose value is a memoryview")
+        .def("close", &AsyncTransmission::close, "Stop receiving and cancel pending receives")
+        .def("__aenter__", [](py::object self) {
+            py::object future = py::module_::import("asyncio").attr("get_running_loop")().attr("create_future")();
+            future.attr("set_result")(self);
+            return future;
+        })
+        .def("__aexit__", [](AsyncTransmission& self, py::args) {
+            self.close();
+            py::object future = py::module_::import("asyncio").attr("get_running_loop")().attr("create_future")();
+            future.attr("set_result")(py::none());
+            return future;
+        });
+}
@@ -10,7 +10,10 @@ void init_capability_signaler(py::module_& m);
 void init_negotiation_protocol(py::module_& m);
 void init_data_transcoder(py::module_& m);
 void init_transmission_manager(py::module_& m);
+void init_async_transmission(py::module_& m);
 void init_feedback_loop(py::module_& m);
+void init_boundary_gateway(py::module_& m);
+void init_swarm_kernels(py::module_& m);
 
 PYBIND11_MODULE(_core, m) {
     m.doc() = "XenoComm SDK Python bindings"; // Module docstring
@@ -24,5 +27,8 @@ PYBIND11_MODULE(_core, m) {
     init_negotiation_protocol(m);
     init_data_transcoder(m);
     init_transmission_manager(m);
+    init_async_transmission(m);
     init_feedback_loop(m);
+    init_boundary_gateway(m);
+    init_swarm_kernels(m);
 } 
\ No newline at end of file
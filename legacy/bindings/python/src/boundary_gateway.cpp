@@ -0,0 +1,107 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "xenocomm/extensions/boundary_gateway.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+
+namespace py = pybind11;
+using namespace xenocomm::extensions;
+
+namespace {
+    // Cache of Python objects; every call holds the GIL, which guards the reference counts it copies
+    using PyResponseCache = ResponseCache<py::object>;
+
+    // Python TTLs are seconds, and 0 never expires; a positive TTL lasts at least a millisecond
+    std::chrono::milliseconds toTtl(const std::optional<double>& seconds) {
+        if (!seconds || *seconds <= 0) {
+            return std::chrono::milliseconds(0);
+        }
+        return std::chrono::milliseconds(std::max<int64_t>(1, static_cast<int64_t>(std::ceil(*seconds * 1000))));
+    }
+}
+
+void init_boundary_gateway(py::module_& m) {
+    py::class_<RateLimit>(m, "RateLimit")
+        .def(py::init<>())
+        .def(py::init([](double capacity, double refillPerSecond) { return RateLimit{capacity, refillPerSecond}; }),
+             py::arg("capacity"), py::arg("refill_rate"))
+        .def_readwrite("capacity", &RateLimit::capacity)
+        .def_readwrite("refill_rate", &RateLimit::refillPerSecond);
+
+    py::class_<TokenBucket>(m, "TokenBucket")
+        .def(py::init([](double capacity, double refillPerSecond) {
+                 return std::make_unique<TokenBucket>(RateLimit{capacity, refillPerSecond});
+             }),
+             py::arg("capacity"), py::arg("refill_rate"))
+        .def("try_acquire", &TokenBucket::tryAcquire, py::arg("tokens") = 1.0)
+        .def("refund", &TokenBucket::refund, py::arg("tokens"))
+        .def("available", &TokenBucket::available)
+        .def("set_limit", &TokenBucket::setLimit, py::arg("limit"))
+        .def("limit", &TokenBucket::limit)
+        .def_property_readonly("acquired", &TokenBucket::acquired)
+        .def_property_readonly("denied", &TokenBucket::denied);
+
+    py::enum_<RateLimitScope>(m, "RateLimitScope")
+        .value("NONE", RateLimitScope::NONE)
+        .value("AGENT", RateLimitScope::AGENT)
+        .value("API", RateLimitScope::API)
+        .value("GLOBAL", RateLimitScope::GLOBAL);
+
+    py::class_<GatewayRateLimitConfig>(m, "GatewayRateLimitConfig")
+        .def(py::init<>())
+        .def_readwrite("per_agent", &GatewayRateLimitConfig::perAgent)
+        .def_readwrite("per_api", &GatewayRateLimitConfig::perApi)
+        .def_readwrite("global_limit", &GatewayRateLimitConfig::global);
+
+    py::class_<GatewayRateLimiter::Decision>(m, "RateLimitDecision")
+        .def_readonly("allowed", &GatewayRateLimiter::Decision::allowed)
+        .def_readonly("limited_by", &GatewayRateLimiter::Decision::limitedBy)
+        .def("__bool__", [](const GatewayRateLimiter::Decision& decision) { return decision.allowed; });
+
+    py::class_<GatewayRateLimiter::Stats>(m, "GatewayRateLimiterStats")
+        .def_readonly("admitted", &GatewayRateLimiter::Stats::admitted)
+        .def_readonly("denied_by_agent", &GatewayRateLimiter::Stats::deniedByAgent)
+        .def_readonly("denied_by_api", &GatewayRateLimiter::Stats::deniedByApi)
+        .def_readonly("denied_globally", &GatewayRateLimiter::Stats::deniedGlobally)
+        .def_readonly("agents", &GatewayRateLimiter::Stats::agents)
+        .def_readonly("apis", &GatewayRateLimiter::Stats::apis);
+
+    py::class_<GatewayRateLimiter>(m, "GatewayRateLimiter")
+        .def(py::init<const GatewayRateLimitConfig&>(), py::arg("config") = GatewayRateLimitConfig())
+        .def("acquire", &GatewayRateLimiter::acquire, py::arg("agent"), py::arg("api"), py::arg("tokens") = 1.0)
+        .def("set_agent_limit", &GatewayRateLimiter::setAgentLimit, py::arg("agent"), py::arg("limit"))
+        .def("set_api_limit", &GatewayRateLimiter::setApiLimit, py::arg("api"), py::arg("limit"))
+        .def("agent_available", &GatewayRateLimiter::agentAvailable, py::arg("agent"))
+        .def("api_available", &GatewayRateLimiter::apiAvailable, py::arg("api"))
+        .def("get_stats", &GatewayRateLimiter::getStats);
+
+    py::class_<PyResponseCache::Stats>(m, "ResponseCacheStats")
+        .def_readonly("entries", &PyResponseCache::Stats::entries)
+        .def_readonly("hits", &PyResponseCache::Stats::hits)
+        .def_readonly("misses", &PyResponseCache::Stats::misses)
+        .def_readonly("evictions", &PyResponseCache::Stats::evictions)
+        .def_readonly("expirations", &PyResponseCache::Stats::expirations);
+
+    py::class_<PyResponseCache>(m, "ResponseCache")
+        .def(py::init([](size_t maxEntries, std::optional<double> defaultTtl) {
+                 return std::make_unique<PyResponseCache>(maxEntries, toTtl(defaultTtl));
+             }),
+             py::arg("max_entries") = 0, py::arg("default_ttl") = py::none())
+        .def("get", &PyResponseCache::get, py::arg("key"))
+        .def("set",
+             [](PyResponseCache& cache, const std::string& key, py::object value, std::optional<double> ttl) {
+                 if (ttl) {
+                     cache.set(key, std::move(value), toTtl(ttl));
+                 } else {
+                     cache.set(key, std::move(value));
+                 }
+             },
+             py::arg("key"), py::arg("value"), py::arg("ttl") = py::none())
+        .def("invalidate", &PyResponseCache::invalidate, py::arg("key"))
+        .def("clear", &PyResponseCache::clear)
+        .def("cleanup_expired", &PyResponseCache::cleanupExpired)
+        .def("__len__", &PyResponseCache::size)
+        .def("get_stats", &PyResponseCache::getStats);
+}
@@ -1,14 +1,134 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <optional>
+#include <string>
 #include "xenocomm/core/data_transcoder.h"
 #include "type_converters.hpp"
 #include "xenocomm/core/base64_transcoder.h"
+#include "xenocomm/core/data_adapters.h"
 
 namespace py = pybind11;
 using namespace xenocomm::core;
 using namespace xenocomm;
 
+namespace {
+
+// Encodes a buffer in place and returns the encoding as a memoryview that owns it
+py::memoryview encode_buffer(DataTranscoder& transcoder, const py::buffer_info& buf, DataFormat format) {
+    xenocomm::utils::ByteSpan data = contiguous_bytes(buf);
+    std::vector<uint8_t> encoded;
+    {
+        py::gil_scoped_release release;
+        encoded = transcoder.encode(data.data(), data.size(), format);
+    }
+    return to_memoryview(std::move(encoded));
+}
+
+// Decodes into an array of T shaped by the metadata, which takes ownership of the
+// decoded bytes instead of copying them. decode() and getMetadata() take vectors, so
+// the encoded input is copied once
+template <typename T>
+py::array_t<T> decode_array(DataTranscoder& transcoder, const py::buffer_info& buf, DataFormat format) {
+    std::vector<uint8_t> encoded = contiguous_bytes(buf).to_vector();
+    auto decoded = std::make_unique<std::vector<uint8_t>>();
+    TranscodingMetadata metadata;
+    {
+        py::gil_scoped_release release;
+        *decoded = transcoder.decode(encoded, format);
+        metadata = transcoder.getMetadata(encoded);
+    }
+
+    // Dimensions that do not account for every element are ignored in favour of a flat array
+    const size_t count = decoded->size() / sizeof(T);
+    std::vector<ssize_t> shape(metadata.dimensions.begin(), metadata.dimensions.end());
+    size_t product = 1;
+    for (size_t dimension : metadata.dimensions) {
+        product *= dimension;
+    }
+    if (shape.empty() || product != count) {
+        shape = {static_cast<ssize_t>(count)};
+    }
+
+    const T* data = reinterpret_cast<const T*>(decoded->data());
+    return py::array_t<T>(shape, data, py::capsule(decoded.release(), [](void* p) {
+        delete static_cast<std::vector<uint8_t>*>(p);
+    }));
+}
+
+// Requires a C-contiguous 2-D array, which the batch calls read and write in place
+void require_matrix(const py::buffer_info& buf, const char* name) {
+    if (buf.ndim != 2 || buf.strides[1] != buf.itemsize || buf.strides[0] != buf.shape[1] * buf.itemsize) {
+        throw py::value_error(std::string(name) + " must be a C-contiguous 2-D array");
+    }
+}
+
+// Encodes each row of a (rows, dims) float32 array with one call into the transcoder.
+// Returns a (rows, stride) uint8 array holding row i's encoding at its start, and the
+// encoded size of each row
+py::tuple encode_batch(DataTranscoder& transcoder, py::array data, DataFormat format, size_t threads) {
+    py::buffer_info buf = data.request();
+    if (buf.format != py::format_descriptor<float>::format()) {
+        throw py::type_error("Expected a float32 array");
+    }
+    require_matrix(buf, "data");
+    const size_t rows = static_cast<size_t>(buf.shape[0]);
+    const size_t row_size = static_cast<size_t>(buf.shape[1]) * sizeof(float);
+    const size_t stride = transcoder.maxEncodedSize(row_size, format);
+
+    py::array_t<uint8_t> encoded({static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(stride)});
+    xenocomm::utils::MutableByteSpan out(encoded.mutable_data(), rows * stride);
+    const xenocomm::utils::ByteSpan input = contiguous_bytes(buf);
+    std::vector<size_t> sizes;
+    {
+        py::gil_scoped_release release;
+        sizes = transcoder.encodeBatch(input, row_size, format, out, threads);
+    }
+    return py::make_tuple(encoded, py::array_t<size_t>(sizes.size(), sizes.data()));
+}
+
+// Decodes each row of encode_batch() output straight into a preallocated (rows, dims)
+// float32 array, and returns that array
+py::array decode_batch(DataTranscoder& transcoder, py::array encoded, DataFormat source_format,
+                       py::array out, std::optional<py::array_t<size_t, py::array::c_style | py::array::forcecast>> sizes,
+                       size_t threads) {
+    py::buffer_info in = encoded.request();
+    py::buffer_info dst = out.request(true);
+    if (in.itemsize != 1) {
+        throw py::type_error("Expected a uint8 array of encoded rows");
+    }
+    if (dst.format != py::format_descriptor<float>::format()) {
+        throw py::type_error("out must be a float32 array");
+    }
+    require_matrix(in, "encoded_data");
+    require_matrix(dst, "out");
+    if (in.shape[0] != dst.shape[0]) {
+        throw py::value_error("encoded_data and out must have the same number of rows");
+    }
+    const size_t rows = static_cast<size_t>(in.shape[0]);
+    const size_t stride = static_cast<size_t>(in.shape[1]);
+
+    // Without sizes, every row fills its stride, as it does for the vector formats
+    std::vector<size_t> row_sizes(rows, stride);
+    if (sizes) {
+        if (sizes->ndim() != 1 || static_cast<size_t>(sizes->shape(0)) != rows) {
+            throw py::value_error("sizes must hold one entry per row");
+        }
+        row_sizes.assign(sizes->data(), sizes->data() + rows);
+    }
+
+    const size_t row_size = static_cast<size_t>(dst.shape[1]) * sizeof(float);
+    const xenocomm::utils::ByteSpan input = contiguous_bytes(in);
+    xenocomm::utils::MutableByteSpan output(static_cast<uint8_t*>(dst.ptr), rows * row_size);
+    {
+        py::gil_scoped_release release;
+        transcoder.decodeBatch(input, stride, row_sizes, source_format, output, row_size, threads);
+    }
+    return out;
+}
+
+} // namespace
+
 void init_data_transcoder(py::module_& m) {
     // Bind DataFormat enum if not already bound in negotiation_protocol
     if (!py::hasattr(m, "DataFormat")) {
@@ -18,6 +138,10 @@ void init_data_transcoder(py::module_& m) {
             .value("COMPRESSED_STATE", DataFormat::COMPRESSED_STATE)
             .value("BINARY_CUSTOM", DataFormat::BINARY_CUSTOM)
             .value("GGWAVE_FSK", DataFormat::GGWAVE_FSK)
+            .value("VECTOR_FLOAT16", DataFormat::VECTOR_FLOAT16)
+            .value("VECTOR_BFLOAT16", DataFormat::VECTOR_BFLOAT16)
+            .value("VECTOR_INT4", DataFormat::VECTOR_INT4)
+            .value("GGWAVE_FSK_MULTIBAND", DataFormat::GGWAVE_FSK_MULTIBAND)
             .export_values();
     }
 
@@ -62,7 +186,8 @@ void init_data_transcoder(py::module_& m) {
     register_buffer<float>(m, "Float32Buffer");
     register_buffer<int8_t>(m, "Int8Buffer");
 
-    // Bind DataTranscoder class with improved memory management and buffer protocol support
+    // Bind DataTranscoder class. Inputs are read in place from any buffer-protocol object
+    // and outputs are handed to Python without copying; the GIL is released while transcoding
     py::class_<DataTranscoder, std::shared_ptr<DataTranscoder>>(m, "DataTranscoder")
         // Encode methods with buffer protocol support
         .def("encode_float32", [](DataTranscoder& self, py::buffer data) {
@@ -70,16 +195,7 @@ void init_data_transcoder(py::module_& m) {
             if (buf.format != py::format_descriptor<float>::format()) {
                 throw py::type_error("Expected a buffer of float32 values");
             }
-            
-            // Create a DataBuffer for efficient handling
-            DataBuffer<float> buffer(
-                std::vector<float>(
-                    static_cast<float*>(buf.ptr),
-                    static_cast<float*>(buf.ptr) + buf.size
-                )
-            );
-            
-            return self.encode(buffer.data(), buffer.size() * sizeof(float), DataFormat::VECTOR_FLOAT32);
+            return encode_buffer(self, buf, DataFormat::VECTOR_FLOAT32);
         }, "Encode float32 buffer data")
         
         .def("encode_int8", [](DataTranscoder& self, py::buffer data) {
@@ -87,82 +203,31 @@ void init_data_transcoder(py::module_& m) {
             if (buf.format != py::format_descriptor<int8_t>::format()) {
                 throw py::type_error("Expected a buffer of int8 values");
             }
-            
-            DataBuffer<int8_t> buffer(
-                std::vector<int8_t>(
-                    static_cast<int8_t*>(buf.ptr),
-                    static_cast<int8_t*>(buf.ptr) + buf.size
-                )
-            );
-            
-            return self.encode(buffer.data(), buffer.size(), DataFormat::VECTOR_INT8);
+            return encode_buffer(self, buf, DataFormat::VECTOR_INT8);
         }, "Encode int8 buffer data")
         
-        .def("encode", [](DataTranscoder& self, py::bytes data, DataFormat format) {
-            std::string str = static_cast<std::string>(data);
-            return self.encode(str.data(), str.size(), format);
+        .def("encode", [](DataTranscoder& self, py::buffer data, DataFormat format) {
+            return encode_buffer(self, data.request(), format);
         }, py::arg("data"), py::arg("format"), "Encode raw bytes data")
 
         // Decode methods with buffer protocol support
-        .def("decode_float32", [](DataTranscoder& self, const std::vector<uint8_t>& encoded_data) {
-            auto decoded = self.decode(encoded_data, DataFormat::VECTOR_FLOAT32);
-            auto metadata = self.getMetadata(encoded_data);
-            
-            std::vector<ssize_t> shape;
-            if (!metadata.dimensions.empty()) {
-                shape = std::vector<ssize_t>(metadata.dimensions.begin(), metadata.dimensions.end());
-            } else {
-                shape = {static_cast<ssize_t>(decoded.size() / sizeof(float))};
-            }
-            
-            // Use DataBuffer for memory-efficient buffer protocol support
-            auto buffer = std::make_unique<DataBuffer<float>>(
-                std::vector<float>(
-                    reinterpret_cast<float*>(decoded.data()),
-                    reinterpret_cast<float*>(decoded.data() + decoded.size())
-                )
-            );
-            
-            return py::array_t<float>(
-                shape,
-                {sizeof(float)},  // Strides
-                buffer->data(),
-                py::capsule(buffer.release(), [](void* p) {
-                    delete static_cast<DataBuffer<float>*>(p);
-                })
-            );
+        .def("decode_float32", [](DataTranscoder& self, py::buffer encoded_data) {
+            return decode_array<float>(self, encoded_data.request(), DataFormat::VECTOR_FLOAT32);
         }, "Decode data to float32 buffer")
         
-        .def("decode_int8", [](DataTranscoder& self, const std::vector<uint8_t>& encoded_data) {
-            auto decoded = self.decode(encoded_data, DataFormat::VECTOR_INT8);
-            auto metadata = self.getMetadata(encoded_data);
-            
-            std::vector<ssize_t> shape;
-            if (!metadata.dimensions.empty()) {
-                shape = std::vector<ssize_t>(metadata.dimensions.begin(), metadata.dimensions.end());
-            } else {
-                shape = {static_cast<ssize_t>(decoded.size())};
-            }
-            
-            // Use DataBuffer for memory-efficient buffer protocol support
-            auto buffer = std::make_unique<DataBuffer<int8_t>>(
-                std::vector<int8_t>(
-                    reinterpret_cast<int8_t*>(decoded.data()),
-                    reinterpret_cast<int8_t*>(decoded.data() + decoded.size())
-                )
-            );
-            
-            return py::array_t<int8_t>(
-                shape,
-                {sizeof(int8_t)},  // Strides
-                buffer->data(),
-                py::capsule(buffer.release(), [](void* p) {
-                    delete static_cast<DataBuffer<int8_t>*>(p);
-                })
-            );
+        .def("decode_int8", [](DataTranscoder& self, py::buffer encoded_data) {
+            return decode_array<int8_t>(self, encoded_data.request(), DataFormat::VECTOR_INT8);
         }, "Decode data to int8 buffer")
         
-        .def("decode", &DataTranscoder::decode,
+        .def("decode", [](DataTranscoder& self, py::buffer encoded_data, DataFormat source_format) {
+            std::vector<uint8_t> encoded = contiguous_bytes(encoded_data.request()).to_vector();
+            std::vector<uint8_t> decoded;
+            {
+                py::gil_scoped_release release;
+                decoded = self.decode(encoded, source_format);
+            }
+            return to_memoryview(std::move(decoded));
+        },
             py::arg("encoded_data"),
             py::arg("source_format"),
             "Decode raw data bytes")
@@ -170,27 +235,70 @@ void init_data_transcoder(py::module_& m) {
         // Utility methods with improved type safety
         .def("is_valid_format", [](DataTranscoder& self, py::buffer data, DataFormat format) {
             py::buffer_info buf = data.request();
+            py::gil_scoped_release release;
             return self.isValidFormat(buf.ptr, buf.size * buf.itemsize, format);
         }, "Check if data format is valid")
         
-        .def("get_metadata", &DataTranscoder::getMetadata,
+        .def("get_metadata", [](DataTranscoder& self, py::buffer encoded_data) {
+            return self.getMetadata(contiguous_bytes(encoded_data.request()).to_vector());
+        },
+            py::arg("encoded_data"),
+            "Get metadata from encoded data")
+
+        // Batch methods: one call per matrix of vectors, split across cores for the vector adapters
+        .def("encode_batch", &encode_batch,
+            py::arg("data"),
+            py::arg("format") = DataFormat::VECTOR_FLOAT32,
+            py::arg("threads") = 0,
+            "Encode each row of a 2-D float32 array; returns (encoded rows, encoded size of each row)")
+
+        .def("decode_batch", &decode_batch,
             py::arg("encoded_data"),
-            "Get metadata from encoded data");
+            py::arg("source_format"),
+            py::arg("out"),
+            py::arg("sizes") = py::none(),
+            py::arg("threads") = 0,
+            "Decode encode_batch() output into the preallocated 2-D float32 array out, and return out");
 
     // Register shared_ptr conversion for DataTranscoder
     register_shared_ptr_conversion<DataTranscoder>(m);
 
+    // The vector adapters; each is safe to use from several threads at once
+    py::class_<VectorFloat32Adapter, DataTranscoder, std::shared_ptr<VectorFloat32Adapter>>(m, "VectorFloat32Adapter")
+        .def(py::init<>());
+    py::class_<VectorInt8Adapter, DataTranscoder, std::shared_ptr<VectorInt8Adapter>>(m, "VectorInt8Adapter")
+        .def(py::init<float>(), py::arg("scale") = 1.0f)
+        .def_static("per_block", [](size_t block_size) {
+            return std::make_shared<VectorInt8Adapter>(VectorInt8Adapter::perBlock(block_size));
+        }, py::arg("block_size") = VectorInt8Adapter::DEFAULT_BLOCK_SIZE, "Scale each block of elements separately")
+        .def_property_readonly("block_size", &VectorInt8Adapter::blockSize);
+    py::class_<VectorFloat16Adapter, DataTranscoder, std::shared_ptr<VectorFloat16Adapter>>(m, "VectorFloat16Adapter")
+        .def(py::init<>());
+    py::class_<VectorBFloat16Adapter, DataTranscoder, std::shared_ptr<VectorBFloat16Adapter>>(m, "VectorBFloat16Adapter")
+        .def(py::init<>());
+    py::class_<VectorInt4Adapter, DataTranscoder, std::shared_ptr<VectorInt4Adapter>>(m, "VectorInt4Adapter")
+        .def(py::init<size_t>(), py::arg("group_size") = VectorInt4Adapter::DEFAULT_GROUP_SIZE)
+        .def_property_readonly("group_size", &VectorInt4Adapter::groupSize);
+
     py::class_<Base64Transcoder, DataTranscoder, std::shared_ptr<Base64Transcoder>>(m, "Base64Transcoder")
         .def(py::init<>())
-        .def("encode", [](Base64Transcoder& self, py::bytes input) {
-            std::string s = input;
-            auto out = self.encode(s.data(), s.size(), DataFormat::BINARY_CUSTOM);
+        .def("encode", [](Base64Transcoder& self, py::buffer input) {
+            py::buffer_info buf = input.request();
+            xenocomm::utils::ByteSpan data = contiguous_bytes(buf);
+            std::vector<uint8_t> out;
+            {
+                py::gil_scoped_release release;
+                out = self.encode(data.data(), data.size(), DataFormat::BINARY_CUSTOM);
+            }
             return py::bytes(reinterpret_cast<const char*>(out.data()), out.size());
         })
-        .def("decode", [](Base64Transcoder& self, py::bytes input) {
-            std::string s = input;
-            std::vector<uint8_t> buf(s.begin(), s.end());
-            auto out = self.decode(buf, DataFormat::BINARY_CUSTOM);
+        .def("decode", [](Base64Transcoder& self, py::buffer input) {
+            std::vector<uint8_t> buf = contiguous_bytes(input.request()).to_vector();
+            std::vector<uint8_t> out;
+            {
+                py::gil_scoped_release release;
+                out = self.decode(buf, DataFormat::BINARY_CUSTOM);
+            }
             return py::bytes(reinterpret_cast<const char*>(out.data()), out.size());
         })
         .def("name", &Base64Transcoder::name);
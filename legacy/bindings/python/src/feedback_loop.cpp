@@ -71,6 +71,7 @@ void init_feedback_loop(py::module& m) {
         .def_readwrite("retention_period", &PersistenceConfig::retentionPeriod)
         .def_readwrite("max_storage_size_bytes", &PersistenceConfig::maxStorageSizeBytes)
         .def_readwrite("enable_compression", &PersistenceConfig::enableCompression)
+        .def_readwrite("compression_level", &PersistenceConfig::compressionLevel)
         .def_readwrite("enable_backup", &PersistenceConfig::enableBackup)
         .def_readwrite("backup_interval_hours", &PersistenceConfig::backupIntervalHours)
         .def_readwrite("max_backup_count", &PersistenceConfig::maxBackupCount);
@@ -2,6 +2,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/operators.h>
 #include "xenocomm/core/negotiation_protocol.h"
+#include "async_support.hpp"
 
 namespace py = pybind11;
 using namespace xenocomm::core;
@@ -14,6 +15,10 @@ void init_negotiation_protocol(py::module& m) {
         .value("COMPRESSED_STATE", DataFormat::COMPRESSED_STATE)
         .value("BINARY_CUSTOM", DataFormat::BINARY_CUSTOM)
         .value("GGWAVE_FSK", DataFormat::GGWAVE_FSK)
+        .value("VECTOR_FLOAT16", DataFormat::VECTOR_FLOAT16)
+        .value("VECTOR_BFLOAT16", DataFormat::VECTOR_BFLOAT16)
+        .value("VECTOR_INT4", DataFormat::VECTOR_INT4)
+        .value("GGWAVE_FSK_MULTIBAND", DataFormat::GGWAVE_FSK_MULTIBAND)
         .export_values();
 
     py::enum_<CompressionAlgorithm>(m, "CompressionAlgorithm")
@@ -158,5 +163,45 @@ void init_negotiation_protocol(py::module& m) {
             "Reject a counter-proposal from the remote agent")
         .def("close_session", &NegotiationProtocol::closeSession,
             py::arg("session_id"),
-            "Close a negotiation session");
+            "Close a negotiation session")
+
+        // Awaitable forms of the calls that wait on the remote agent; they run on a C++
+        // worker and complete on the running event loop
+        .def("initiate_session_async", [](py::object self, const std::string& target_agent_id,
+                                          const NegotiableParams& proposed_params) {
+            NegotiationProtocol* protocol = &self.cast<NegotiationProtocol&>();
+            return xenocomm::run_blocking(
+                [protocol, target_agent_id, proposed_params] {
+                    return protocol->initiateSession(target_agent_id, proposed_params);
+                },
+                [](NegotiationProtocol::SessionId session_id) { return py::cast(session_id); },
+                std::move(self));
+        },
+            py::arg("target_agent_id"),
+            py::arg("proposed_params"),
+            "Initiate a negotiation session; awaitable")
+        .def("respond_to_negotiation_async", [](py::object self, NegotiationProtocol::SessionId session_id,
+                                                NegotiationResponse response_type,
+                                                std::optional<NegotiableParams> response_params) {
+            NegotiationProtocol* protocol = &self.cast<NegotiationProtocol&>();
+            return xenocomm::run_blocking(
+                [protocol, session_id, response_type, response_params] {
+                    return protocol->respondToNegotiation(session_id, response_type, response_params);
+                },
+                [](bool sent) { return py::cast(sent); },
+                std::move(self));
+        },
+            py::arg("session_id"),
+            py::arg("response_type"),
+            py::arg("response_params") = py::none(),
+            "Respond to a negotiation request; awaitable")
+        .def("finalize_session_async", [](py::object self, NegotiationProtocol::SessionId session_id) {
+            NegotiationProtocol* protocol = &self.cast<NegotiationProtocol&>();
+            return xenocomm::run_blocking(
+                [protocol, session_id] { return protocol->finalizeSession(session_id); },
+                [](NegotiableParams params) { return py::cast(std::move(params)); },
+                std::move(self));
+        },
+            py::arg("session_id"),
+            "Finalize a negotiation session; awaitable");
 } 
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "xenocomm/extensions/swarm_kernels.hpp"
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace xenocomm::extensions;
+
+namespace {
+    // Reads any object with NegotiableParams' attribute names, so agent code passes its own instances
+    AgentParams paramsFrom(py::handle obj) {
+        AgentParams params;
+        params.protocolVersion = obj.attr("protocol_version").cast<std::string>();
+        params.dataFormat = obj.attr("data_format").cast<std::string>();
+        params.compression = obj.attr("compression").cast<std::optional<std::string>>();
+        params.errorCorrection = obj.attr("error_correction").cast<std::string>();
+        params.maxMessageSize = obj.attr("max_message_size").cast<int64_t>();
+        params.timeoutMs = obj.attr("timeout_ms").cast<int64_t>();
+        params.encryption = obj.attr("encryption").cast<std::string>();
+        params.streamingEnabled = obj.attr("streaming_enabled").cast<bool>();
+        params.batchSize = obj.attr("batch_size").cast<int64_t>();
+        params.retryPolicy = obj.attr("retry_policy").cast<std::string>();
+        params.maxRetries = obj.attr("max_retries").cast<int64_t>();
+        params.priority = obj.attr("priority").cast<int64_t>();
+        return params;
+    }
+
+    std::vector<AgentParams> paramsFrom(const py::iterable& objs) {
+        std::vector<AgentParams> params;
+        for (auto obj : objs) {
+            params.push_back(paramsFrom(obj));
+        }
+        return params;
+    }
+
+    // Keyword arguments for NegotiableParams, less custom_params
+    py::dict toDict(const AgentParams& params) {
+        py::dict d;
+        d["protocol_version"] = params.protocolVersion;
+        d["data_format"] = params.dataFormat;
+        d["compression"] = params.compression ? py::object(py::str(*params.compression)) : py::object(py::none());
+        d["error_correction"] = params.errorCorrection;
+        d["max_message_size"] = params.maxMessageSize;
+        d["timeout_ms"] = params.timeoutMs;
+        d["encryption"] = params.encryption;
+        d["streaming_enabled"] = params.streamingEnabled;
+        d["batch_size"] = params.batchSize;
+        d["retry_policy"] = params.retryPolicy;
+        d["max_retries"] = params.maxRetries;
+        d["priority"] = params.priority;
+        return d;
+    }
+
+    py::dict toDict(const ParamCompatibilityReport& report) {
+        py::dict d;
+        d["data_format"] = toString(report.dataFormat);
+        d["compression"] = toString(report.compression);
+        d["encryption"] = toString(report.encryption);
+        d["max_message_size"] = toString(report.maxMessageSize);
+        return d;
+    }
+}
+
+void init_swarm_kernels(py::module_& m) {
+    auto swarm = m.def_submodule("swarm", "Native kernels for agent negotiation and emergence loops");
+
+    swarm.def("check_compatibility",
+              [](py::handle self, py::handle other) {
+                  return toDict(checkParamCompatibility(paramsFrom(self), paramsFrom(other)));
+              },
+              py::arg("params"), py::arg("other"),
+              "Compatibility of each contested parameter, keyed by name, valued as ParamCompatibility values");
+
+    swarm.def("check_compatibility_many",
+              [](py::handle proposal, const py::iterable& peers) {
+                  const auto reports = checkParamCompatibility(paramsFrom(proposal), paramsFrom(peers));
+                  py::list out;
+                  for (const auto& report : reports) {
+                      out.append(toDict(report));
+                  }
+                  return out;
+              },
+              py::arg("proposal"), py::arg("peers"));
+
+    swarm.def("compatibility_matrix",
+              [](const py::iterable& agents) {
+                  const auto params = paramsFrom(agents);
+                  const auto matrix = compatibilityMatrix(params);
+                  const size_t n = params.size();
+                  py::list rows;
+                  for (size_t i = 0; i < n; ++i) {
+                      py::list row;
+                      for (size_t j = 0; j < n; ++j) {
+                          row.append(toString(matrix[i * n + j]));
+                      }
+                      rows.append(row);
+                  }
+                  return rows;
+              },
+              py::arg("agents"), "Worst compatibility of every pair of agents, as rows of ParamCompatibility values");
+
+    swarm.def("merge",
+              [](py::handle self, py::handle other, bool preferSelf) {
+                  return toDict(mergeParams(paramsFrom(self), paramsFrom(other), preferSelf));
+              },
+              py::arg("params"), py::arg("other"), py::arg("prefer_self") = true,
+              "Merged parameters as NegotiableParams keyword arguments, without custom_params");
+
+    swarm.def("analyze_trend",
+              [](const std::vector<double>& window, bool lowerIsBetter) {
+                  return toString(analyzeMetricTrend(window, lowerIsBetter));
+              },
+              py::arg("window"), py::arg("lower_is_better") = false, "A MetricTrend value");
+
+    swarm.def("is_anomalous", &isMetricAnomalous, py::arg("samples"));
+}
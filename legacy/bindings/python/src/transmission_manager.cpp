@@ -4,9 +4,11 @@
 #include <pybind11/functional.h>
 #include "xenocomm/core/transmission_manager.h"
 #include "xenocomm/core/error_correction_mode.h"
+#include "type_converters.hpp"
 
 namespace py = pybind11;
 using namespace xenocomm::core;
+using xenocomm::Result;
 
 void init_transmission_manager(py::module& m) {
     // Bind ErrorCorrectionMode enum
@@ -67,6 +69,9 @@ void init_transmission_manager(py::module& m) {
         .def_readwrite("avg_rtt_ms", &TransmissionManager::TransmissionStats::avg_rtt_ms)
         .def_readwrite("min_rtt_ms", &TransmissionManager::TransmissionStats::min_rtt_ms)
         .def_readwrite("max_rtt_ms", &TransmissionManager::TransmissionStats::max_rtt_ms)
+        .def_readwrite("rtt_p50_ms", &TransmissionManager::TransmissionStats::rtt_p50_ms)
+        .def_readwrite("rtt_p99_ms", &TransmissionManager::TransmissionStats::rtt_p99_ms)
+        .def_readwrite("rtt_p999_ms", &TransmissionManager::TransmissionStats::rtt_p999_ms)
         .def_readwrite("current_window_size", &TransmissionManager::TransmissionStats::current_window_size)
         .def_readwrite("packet_loss_count", &TransmissionManager::TransmissionStats::packet_loss_count)
         .def_readwrite("is_encrypted", &TransmissionManager::TransmissionStats::is_encrypted)
@@ -95,21 +100,55 @@ void init_transmission_manager(py::module& m) {
         .def_readwrite("error_message", &TransmissionManager::RetryEvent::error_message)
         .def_readwrite("timestamp", &TransmissionManager::RetryEvent::timestamp);
 
-    // Bind TransmissionManager class
+    // Bind the results of blocking calls; a received message comes back as a memoryview
+    py::class_<Result<void>>(m, "Result")
+        .def("is_ok", &Result<void>::has_value)
+        .def_property_readonly("error", &Result<void>::error);
+
+    py::class_<Result<py::object>>(m, "ReceiveResult")
+        .def("is_ok", &Result<py::object>::has_value)
+        .def_property_readonly("value", [](const Result<py::object>& result) -> py::object {
+            return result.has_value() ? result.value() : py::none();
+        })
+        .def_property_readonly("error", [](const Result<py::object>& result) {
+            return result.has_value() ? std::string() : result.error();
+        });
+
+    // Bind TransmissionManager class. Calls that wait on the network release the GIL so
+    // other Python threads keep running; callbacks take it back while they run
     py::class_<TransmissionManager>(m, "TransmissionManager")
         .def(py::init<ConnectionManager&>())
-        .def("send", &TransmissionManager::send)
-        .def("receive", &TransmissionManager::receive,
-            py::arg("timeout_ms") = 1000)
+        .def("send", [](TransmissionManager& self, py::buffer data) {
+            // Sent from the object's own memory; it cannot be resized while the view is held
+            py::buffer_info buf = data.request();
+            xenocomm::utils::ByteSpan bytes = xenocomm::contiguous_bytes(buf);
+            py::gil_scoped_release release;
+            return self.send(bytes.data(), bytes.size());
+        }, py::arg("data"), "Send any buffer-protocol object (bytes, bytearray, memoryview, numpy array) without copying it")
+        .def("receive", [](TransmissionManager& self, uint32_t timeout_ms) {
+            Result<std::vector<uint8_t>> received = [&] {
+                py::gil_scoped_release release;
+                return self.receive(timeout_ms);
+            }();
+            if (!received.has_value()) {
+                return Result<py::object>(received.error());
+            }
+            return Result<py::object>(xenocomm::to_memoryview(std::move(received.value())));
+        }, py::arg("timeout_ms") = 1000, "Receive a message as a memoryview over the received bytes")
+        .def("bind_connection", &TransmissionManager::bind_connection, py::arg("connection_id"))
         .def("set_config", &TransmissionManager::set_config)
         .def("get_config", &TransmissionManager::get_config)
         .def("get_stats", &TransmissionManager::get_stats)
         .def("reset_stats", &TransmissionManager::reset_stats)
-        .def("wait_for_window_space", &TransmissionManager::wait_for_window_space)
+        .def("wait_for_window_space", [](TransmissionManager& self, size_t data_size, uint32_t timeout_ms) {
+            return self.wait_for_window_space(data_size, std::chrono::milliseconds(timeout_ms));
+        }, py::arg("data_size"), py::arg("timeout_ms") = 1000, py::call_guard<py::gil_scoped_release>())
         .def("release_window_space", &TransmissionManager::release_window_space)
         .def("set_retry_callback", &TransmissionManager::set_retry_callback)
         .def("reset_retry_stats", &TransmissionManager::reset_retry_stats)
         .def("get_security_status", &TransmissionManager::get_security_status)
-        .def("renegotiate_security", &TransmissionManager::renegotiate_security)
-        .def("setup_secure_channel", &TransmissionManager::setup_secure_channel);
-} 
\ No newline at end of file
+        .def("renegotiate_security", &TransmissionManager::renegotiate_security,
+            py::call_guard<py::gil_scoped_release>())
+        .def("setup_secure_channel", &TransmissionManager::setup_secure_channel,
+            py::call_guard<py::gil_scoped_release>());
+}
@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include "xenocomm/utils/byte_span.hpp"
 
 namespace xenocomm {
 namespace py = pybind11;
@@ -87,6 +88,27 @@ py::class_<DataBuffer<T>> register_buffer(py::module_& m, const char* name) {
         });
 }
 
+// Zero-copy views between C++ and buffer-protocol objects (bytes, bytearray,
+// memoryview, numpy arrays)
+
+// The bytes of a C-contiguous buffer, in place; valid while buf is alive
+inline utils::ByteSpan contiguous_bytes(const py::buffer_info& buf) {
+    py::ssize_t expected = buf.itemsize;
+    for (py::ssize_t i = buf.ndim - 1; i >= 0; --i) {
+        if (buf.shape[i] != 1 && buf.strides[i] != expected) {
+            throw py::value_error("Expected a C-contiguous buffer");
+        }
+        expected *= buf.shape[i];
+    }
+    return utils::ByteSpan(static_cast<const uint8_t*>(buf.ptr), static_cast<size_t>(buf.size * buf.itemsize));
+}
+
+// Hands data to Python as a memoryview that owns it, without copying
+inline py::memoryview to_memoryview(std::vector<uint8_t>&& data) {
+    py::object owner = py::cast(DataBuffer<uint8_t>(std::move(data)));
+    return py::memoryview(owner);
+}
+
 // Smart pointer integration with Python reference counting
 template<typename T>
 void register_shared_ptr_conversion(py::module_& m, const char* name = "_SharedPtr") {
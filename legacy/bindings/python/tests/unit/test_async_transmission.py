@@ -0,0 +1,36 @@
+import asyncio
+import pytest
+from xenocomm import AsyncTransmission, ConnectionManager, TransmissionManager
+
+def test_receive_needs_a_transport():
+    conn_manager = ConnectionManager()
+    manager = TransmissionManager(conn_manager)
+    channel = AsyncTransmission(manager)
+
+    async def main():
+        # Nothing is attached for the reactor to watch
+        with pytest.raises(RuntimeError):
+            await channel.receive()
+
+    asyncio.run(main())
+
+def test_send_completes_on_the_loop():
+    conn_manager = ConnectionManager()
+    manager = TransmissionManager(conn_manager)
+
+    async def main():
+        async with AsyncTransmission(manager) as channel:
+            # Sends run on C++ workers; the loop keeps running meanwhile
+            results = await asyncio.gather(*(channel.send(bytes([i] * 16)) for i in range(8)))
+            for result in results:
+                assert not result.is_ok()
+                assert result.error
+
+    asyncio.run(main())
+
+def test_receive_outside_a_loop_fails():
+    conn_manager = ConnectionManager()
+    manager = TransmissionManager(conn_manager)
+    channel = AsyncTransmission(manager)
+    with pytest.raises(RuntimeError):
+        channel.receive()
@@ -24,7 +24,7 @@ def test_float32_transcoding():
     
     # Test encoding
     encoded = transcoder.encode_float32(data)
-    assert isinstance(encoded, bytes) or isinstance(encoded, bytearray)
+    assert isinstance(encoded, (bytes, bytearray, memoryview))
     
     # Test metadata
     meta = transcoder.get_metadata(encoded)
@@ -46,7 +46,7 @@ def test_int8_transcoding():
     
     # Test encoding
     encoded = transcoder.encode_int8(data)
-    assert isinstance(encoded, bytes) or isinstance(encoded, bytearray)
+    assert isinstance(encoded, (bytes, bytearray, memoryview))
     
     # Test metadata
     meta = transcoder.get_metadata(encoded)
@@ -118,4 +118,45 @@ def test_error_handling():
     
     # Test decoding with invalid format
     with pytest.raises(TranscodingError):
-        transcoder.decode_float32(b"invalid data") 
\ No newline at end of file
+        transcoder.decode_float32(b"invalid data")
+
+def test_buffer_protocol_inputs():
+    transcoder = DataTranscoder()
+    data = np.arange(8, dtype=np.float32)
+
+    # Contiguous views are read in place, whatever object exports them
+    expected = bytes(transcoder.encode_float32(data))
+    assert bytes(transcoder.encode_float32(memoryview(data))) == expected
+    assert bytes(transcoder.encode(bytearray(data.tobytes()), DataFormat.VECTOR_FLOAT32)) == expected
+
+    # Strided views have no single run of bytes to read
+    with pytest.raises(ValueError):
+        transcoder.encode_float32(data[::2])
+
+    # Decoded arrays own their memory, so they outlive the encoding they came from
+    encoded = transcoder.encode_float32(data)
+    decoded = transcoder.decode_float32(encoded)
+    del encoded
+    assert np.array_equal(decoded, data)
+
+def test_batch_round_trip():
+    from xenocomm import VectorInt8Adapter
+    transcoder = VectorInt8Adapter.per_block()
+    rng = np.random.default_rng(0)
+    batch = rng.standard_normal((256, 768)).astype(np.float32)
+
+    encoded, sizes = transcoder.encode_batch(batch)
+    assert encoded.shape[0] == 256
+    assert np.all(sizes == encoded.shape[1])
+    # Each row matches what encoding it alone produces
+    assert bytes(encoded[3]) == bytes(transcoder.encode(batch[3], DataFormat.VECTOR_FLOAT32))
+
+    out = np.empty_like(batch)
+    assert transcoder.decode_batch(encoded, DataFormat.VECTOR_INT8, out) is out
+    assert np.allclose(out, batch, atol=0.05)
+
+    # Decoding needs a preallocated float32 matrix with one row per encoding
+    with pytest.raises(ValueError):
+        transcoder.decode_batch(encoded, DataFormat.VECTOR_INT8, np.empty((255, 768), dtype=np.float32))
+    with pytest.raises(TypeError):
+        transcoder.encode_batch(batch.astype(np.float64))
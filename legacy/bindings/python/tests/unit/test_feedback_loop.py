@@ -23,6 +23,7 @@ def test_feedback_loop_config():
     assert persistence.retention_period == timedelta(days=30)
     assert persistence.max_storage_size_bytes == 1024 * 1024 * 1024  # 1GB
     assert persistence.enable_compression is True
+    assert persistence.compression_level == 1
     assert persistence.enable_backup is True
     assert persistence.backup_interval_hours == 24
     assert persistence.max_backup_count == 7
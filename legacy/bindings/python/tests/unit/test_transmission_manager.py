@@ -120,4 +120,16 @@ def test_flow_control():
     
     # Verify stats
     stats = manager.get_stats()
-    assert isinstance(stats.current_window_size, int) 
\ No newline at end of file
+    assert isinstance(stats.current_window_size, int)
+
+def test_send_accepts_buffers():
+    conn_manager = ConnectionManager()
+    manager = TransmissionManager(conn_manager)
+
+    # Without a transport nothing can go out, but every kind of buffer is accepted
+    payload = bytes(range(16))
+    for data in (payload, bytearray(payload), memoryview(payload), np.frombuffer(payload, dtype=np.uint8)):
+        result = manager.send(data)
+        assert not result.is_ok()
+        assert result.error
+
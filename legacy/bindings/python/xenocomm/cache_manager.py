@@ -1,16 +1,23 @@
 import time
 import threading
 
+try:
+    from ._core import ResponseCache as _NativeResponseCache
+except ImportError:  # Extension not built; use the pure-Python cache below
+    _NativeResponseCache = None
+
 class CacheManager:
     """
     Thread-safe cache manager with TTL, manual, and conditional invalidation.
     Tracks cache hits/misses for monitoring.
-    Suitable for use in API adapters and other caching scenarios.
+    Suitable for use in API adapters and other caching scenarios. Delegates to
+    the sharded native ResponseCache when the extension module is available.
     """
     def __init__(self):
         """
         Initialize the cache manager.
         """
+        self._native = _NativeResponseCache() if _NativeResponseCache else None
         self.cache = {}
         self.ttls = {}
         self.metrics = {"hits": 0, "misses": 0}
@@ -27,6 +34,8 @@ class CacheManager:
             Any: The cached value, or None if not found or expired.
         Increments hit/miss metrics.
         """
+        if self._native is not None:
+            return self._native.get(key)
         with self.lock:
             if key in self.cache:
                 if key in self.ttls and time.time() > self.ttls[key]:
@@ -48,6 +57,9 @@ class CacheManager:
             value (Any): The value to cache.
             ttl (float, optional): Time-to-live in seconds. If None, no expiry.
         """
+        if self._native is not None:
+            self._native.set(key, value, ttl or 0)
+            return
         with self.lock:
             self.cache[key] = value
             if ttl:
@@ -60,6 +72,9 @@ class CacheManager:
         Args:
             key (str): The cache key to remove.
         """
+        if self._native is not None:
+            self._native.invalidate(key)
+            return
         with self.lock:
             self._invalidate(key)
 
@@ -67,6 +82,9 @@ class CacheManager:
         """
         Remove all entries from the cache.
         """
+        if self._native is not None:
+            self._native.clear()
+            return
         with self.lock:
             self.cache.clear()
             self.ttls.clear()
@@ -75,6 +93,9 @@ class CacheManager:
         """
         Remove all expired entries from the cache.
         """
+        if self._native is not None:
+            self._native.cleanup_expired()
+            return
         with self.lock:
             now = time.time()
             expired = [k for k, exp in self.ttls.items() if now > exp]
@@ -94,5 +115,8 @@ class CacheManager:
         Returns:
             dict: Dictionary with 'hits' and 'misses' counts.
         """
+        if self._native is not None:
+            stats = self._native.get_stats()
+            return {"hits": stats.hits, "misses": stats.misses}
         with self.lock:
             return dict(self.metrics) 
\ No newline at end of file
@@ -1,12 +1,18 @@
 import time
 import threading
 
+try:
+    from ._core import TokenBucket as _NativeTokenBucket
+except ImportError:  # Extension not built; use the pure-Python bucket below
+    _NativeTokenBucket = None
+
 class RateLimiter:
     """
     Thread-safe token bucket rate limiter for controlling request rates.
 
     Supports per-endpoint configuration by instantiating separate objects.
-    Tracks acquired/denied metrics for monitoring.
+    Tracks acquired/denied metrics for monitoring. Delegates to the lock-free
+    native TokenBucket when the extension module is available.
     """
     def __init__(self, capacity, refill_rate):
         """
@@ -18,6 +24,7 @@ class RateLimiter:
         """
         self.capacity = capacity
         self.refill_rate = refill_rate
+        self._bucket = _NativeTokenBucket(capacity, refill_rate) if _NativeTokenBucket else None
         self.tokens = capacity
         self.last_refill = time.time()
         self.lock = threading.RLock()
@@ -33,6 +40,8 @@ class RateLimiter:
         Returns:
             bool: True if tokens were acquired, False if rate limit exceeded.
         """
+        if self._bucket is not None:
+            return self._bucket.try_acquire(tokens)
         with self.lock:
             self._refill()
             if self.tokens >= tokens:
@@ -59,5 +68,7 @@ class RateLimiter:
         Returns:
             dict: Dictionary with 'acquired' and 'denied' request counts.
         """
+        if self._bucket is not None:
+            return {"acquired": self._bucket.acquired, "denied": self._bucket.denied}
         with self.lock:
             return dict(self.metrics) 
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include "xenocomm/extensions/common_ground/metrics/alignment_metrics.hpp"
+#include "xenocomm/extensions/common_ground/metrics/metric_storage.hpp"
 #include "xenocomm/extensions/common_ground/metrics/visualization.hpp"
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <ctime>
 #include <cstdlib>
+#include <algorithm>
 
 using namespace xenocomm::extensions::common_ground::metrics;
 
@@ -66,8 +68,12 @@ int main(int argc, char** argv) {
     TimeRange range;
     range.start = std::chrono::system_clock::now() - std::chrono::hours(24);
     range.end = std::chrono::system_clock::now();
-    // Render and display dashboard
-    AlignmentTrends trends = metrics.analyzeTrends(range);
+    // Render and display dashboard; a day of minute buckets is reduced to what a chart can show
+    const size_t chartPoints = 120;
+    AlignmentTrends trends = metrics.analyzeTrends(range, chartPoints);
+    // Remember where this view is up to, so a refresh reads only what arrives after it
+    MetricQuery sinceQuery;
+    sinceQuery.since = metrics.getMetricsSince(sinceQuery).cursor;
     std::string trendsReport = visualizer.renderTrends(trends);
     std::vector<std::string> strategies;
     for (const auto& [strategy, _] : trends.strategyPerformance) {
@@ -84,6 +90,13 @@ int main(int argc, char** argv) {
         std::cout << strategyReport;
     }
     std::cout << "====================================================================\n";
+    if (numSamples > 0) {
+        // Incremental refresh: new metrics only, not the whole range again
+        generateSampleData(metrics, std::max(numSamples / 10, 1));
+        MetricPage update = metrics.getMetricsSince(sinceQuery);
+        std::cout << "Refresh: " << update.metrics.size() << " new metrics (cursor "
+                  << sinceQuery.since << " -> " << update.cursor << ")\n";
+    }
     std::cout << "Usage: " << argv[0] << " [num_samples]\n";
     std::cout << "  num_samples: Number of random alignment attempts to generate\n";
     return 0;
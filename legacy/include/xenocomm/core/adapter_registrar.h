@@ -26,12 +26,15 @@ public:
      * 
      * @param format Format the adapter handles
      * @param description Optional description of the adapter
+     * @param sharing SHARED for adapters that keep no state between calls
      */
-    AdapterRegistrar(DataFormat format, const std::string& description = "") {
+    AdapterRegistrar(DataFormat format, const std::string& description = "",
+                     AdapterSharing sharing = AdapterSharing::PER_THREAD) {
         AdapterRegistry::getInstance().registerAdapter(
             format,
             []() { return std::make_unique<T>(); },
-            description
+            description,
+            sharing
         );
     }
 };
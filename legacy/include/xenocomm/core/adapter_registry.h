@@ -1,11 +1,13 @@
 #pragma once
 
 #include "xenocomm/core/data_transcoder.h"
+#include <array>
+#include <atomic>
 #include <memory>
-#include <unordered_map>
 #include <mutex>
 #include <string>
 #include <functional>
+#include <vector>
 
 namespace xenocomm {
 namespace core {
@@ -15,49 +17,79 @@ namespace core {
  */
 using TranscoderFactory = std::function<std::unique_ptr<DataTranscoder>()>;
 
+/**
+ * @brief How instances of a registered adapter are shared between threads
+ */
+enum class AdapterSharing {
+    SHARED,      ///< One instance for all threads; encode/decode must be safe to call concurrently
+    PER_THREAD   ///< One instance per thread, for adapters that keep state between calls
+};
+
 /**
  * @brief Registry for managing and creating data format adapters
- * 
+ *
  * This class provides a centralized registry for format adapters with:
  * - Dynamic registration of built-in and third-party adapters
  * - Factory-based instantiation
  * - Thread-safe singleton access
  * - Caching of frequently used adapters
+ *
+ * Lookups are wait-free: registration publishes an immutable table indexed
+ * by DataFormat, and readers load it with a single atomic read. Shared
+ * adapters are created when registered; per-thread adapters are created by
+ * each thread on its first lookup and kept in thread-local slots. Superseded
+ * tables are retired rather than freed, so a reader never sees one
+ * disappear; registrations are few and the registry lives for the process.
  */
 class AdapterRegistry {
 public:
     /**
      * @brief Get the singleton instance of the registry
-     * 
+     *
      * @return AdapterRegistry& Singleton instance
      */
     static AdapterRegistry& getInstance();
 
     /**
      * @brief Register a new adapter factory for a format
-     * 
+     *
      * @param format Format the adapter handles
      * @param factory Factory function to create adapter instances
      * @param description Optional description of the adapter
-     * @throws std::runtime_error if format already registered
+     * @param sharing Whether one instance serves all threads or each thread gets its own
+     * @throws std::runtime_error if format already registered or out of range
      */
     void registerAdapter(
         DataFormat format,
         TranscoderFactory factory,
-        const std::string& description = "");
+        const std::string& description = "",
+        AdapterSharing sharing = AdapterSharing::PER_THREAD);
 
     /**
      * @brief Create or retrieve a cached instance of an adapter
-     * 
+     *
      * @param format Format to get adapter for
      * @return std::shared_ptr<DataTranscoder> Adapter instance
      * @throws std::runtime_error if format not registered
      */
     std::shared_ptr<DataTranscoder> getAdapter(DataFormat format);
 
+    /**
+     * @brief Wait-free lookup that returns the cached adapter without touching its reference count
+     *
+     * A shared adapter stays valid for the life of the registry; a per-thread
+     * adapter until the calling thread exits or looks the format up again
+     * after clearCache().
+     *
+     * @param format Format to get adapter for
+     * @return DataTranscoder& Adapter instance for this thread
+     * @throws std::runtime_error if format not registered
+     */
+    DataTranscoder& lookup(DataFormat format);
+
     /**
      * @brief Check if an adapter is registered for a format
-     * 
+     *
      * @param format Format to check
      * @return true if adapter is registered
      * @return false if no adapter registered
@@ -66,7 +98,7 @@ public:
 
     /**
      * @brief Get description of registered adapter
-     * 
+     *
      * @param format Format to get description for
      * @return std::string Adapter description
      * @throws std::runtime_error if format not registered
@@ -75,8 +107,9 @@ public:
 
     /**
      * @brief Clear the adapter cache
-     * 
-     * Forces new instances to be created on next getAdapter() call
+     *
+     * Shared adapters are recreated at once; each thread recreates its
+     * per-thread adapters on its next lookup.
      */
     void clearCache();
 
@@ -87,27 +120,37 @@ public:
     AdapterRegistry& operator=(AdapterRegistry&&) = delete;
 
 private:
-    AdapterRegistry() = default;  // Private constructor for singleton
+    AdapterRegistry();  // Private constructor for singleton
 
     struct AdapterInfo {
         TranscoderFactory factory;
         std::string description;
+        AdapterSharing sharing;
+        std::shared_ptr<DataTranscoder> shared;  // The instance, for SHARED adapters
+        uint64_t generation;                     // Identifies this instance set for thread-local slots
     };
 
-    // Thread synchronization
-    mutable std::mutex mutex_;
+    using Table = std::array<std::shared_ptr<const AdapterInfo>, DATA_FORMAT_COUNT>;
 
-    // Registry storage
-    std::unordered_map<DataFormat, AdapterInfo> registry_;
-    
-    // Instance cache
-    std::unordered_map<DataFormat, std::weak_ptr<DataTranscoder>> cache_;
+    /**
+     * @brief Looks up the current entry for a format
+     * @throws std::runtime_error if format not registered
+     */
+    const AdapterInfo& entry(DataFormat format) const;
 
     /**
-     * @brief Clean expired entries from cache
+     * @brief Publishes a new table; the caller holds mutex_
      */
-    void cleanCache();
+    void publish(std::unique_ptr<Table> table);
+
+    // Serializes writers; readers never take it
+    mutable std::mutex mutex_;
+
+    // Current table, and every table it replaced
+    std::atomic<const Table*> table_;
+    std::vector<std::unique_ptr<Table>> tables_;
+    uint64_t next_generation_ = 1;
 };
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
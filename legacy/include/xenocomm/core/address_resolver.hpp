@@ -0,0 +1,117 @@
+#ifndef XENOCOMM_CORE_ADDRESS_RESOLVER_HPP
+#define XENOCOMM_CORE_ADDRESS_RESOLVER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Caching getaddrinfo() front end for stream endpoints.
+ *
+ * Successful lookups are served from the cache for ttl. After that an entry
+ * goes stale: callers still get the old addresses immediately while one
+ * background lookup refreshes it, so reconnects never wait on DNS for a name
+ * they have resolved before. Callers that miss the cache for the same name at
+ * the same time share a single lookup, which keeps a reconnect storm down
+ * to one query. Failures are remembered for negativeTtl.
+ *
+ * getaddrinfo() does not report record TTLs, so the lifetimes are fixed
+ * per resolver rather than taken from DNS.
+ */
+class AddressResolver {
+public:
+    struct Config {
+        std::chrono::milliseconds ttl{30000};         ///< How long a lookup is served without refreshing
+        std::chrono::milliseconds staleTtl{300000};   ///< How long past ttl it may still be served while refreshing
+        std::chrono::milliseconds negativeTtl{1000};  ///< How long a failed lookup is remembered
+        size_t maxEntries = 1024;                     ///< Expired entries are evicted first once this is reached
+    };
+
+    /**
+     * @brief One resolved address, ready for socket() and connect()
+     */
+    struct Address {
+        sockaddr_storage storage;
+        socklen_t length;
+        int family;
+        int socktype;
+        int protocol;
+    };
+
+    using AddressList = std::shared_ptr<const std::vector<Address>>;
+
+    struct Stats {
+        size_t hits = 0;       ///< Served from a fresh entry
+        size_t staleHits = 0;  ///< Served from a stale entry while it refreshed
+        size_t misses = 0;     ///< Had to wait for a lookup
+        size_t lookups = 0;    ///< getaddrinfo() calls, including background refreshes
+    };
+
+    /**
+     * @brief Process-wide resolver used by the transports
+     */
+    static AddressResolver& shared();
+
+    AddressResolver();
+    explicit AddressResolver(const Config& config);
+
+    /**
+     * @brief Resolves host:port, blocking only if no usable entry is cached.
+     *
+     * Addresses are ordered for connection racing: getaddrinfo()'s preference
+     * order with IPv6 and IPv4 interleaved (RFC 8305 section 4).
+     *
+     * @param error Receives the EAI_* code on failure, if non-null
+     * @return The addresses, or nullptr if the name does not resolve
+     */
+    AddressList resolve(const std::string& host, uint16_t port, int* error = nullptr);
+
+    /**
+     * @brief Resolves on a background thread; the returned list is nullptr on failure
+     */
+    std::future<AddressList> resolveAsync(const std::string& host, uint16_t port);
+
+    /**
+     * @brief Drops the entry for host:port so the next resolve() looks it up again
+     */
+    void invalidate(const std::string& host, uint16_t port);
+
+    void clear();
+
+    Stats getStats() const;
+
+    /**
+     * @brief Reorders addresses so families alternate, starting with the first one's family.
+     */
+    static std::vector<Address> interleaveFamilies(const std::vector<Address>& addresses);
+
+private:
+    struct State;
+
+    static AddressList resolveWith(const std::shared_ptr<State>& state, const std::string& host, uint16_t port,
+                                   int* error);
+    static void refresh(const std::shared_ptr<State>& state, const std::string& key, const std::string& host,
+                        uint16_t port);
+
+    // Shared with background refreshes so they can outlive the resolver
+    std::shared_ptr<State> state_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_ADDRESS_RESOLVER_HPP
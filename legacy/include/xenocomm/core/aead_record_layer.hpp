@@ -0,0 +1,148 @@
+#ifndef XENOCOMM_CORE_AEAD_RECORD_LAYER_HPP
+#define XENOCOMM_CORE_AEAD_RECORD_LAYER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "xenocomm/core/security_config.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+#include "xenocomm/utils/result.hpp"
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+namespace xenocomm {
+namespace core {
+
+class SecureContext;
+
+/**
+ * @brief Seals and opens records directly with an EVP AEAD cipher.
+ *
+ * Once a handshake has agreed on keys, records no longer need to pass
+ * through the TLS engine and its memory BIOs: each one is encrypted in
+ * place with AES-GCM or ChaCha20-Poly1305 (hardware accelerated where the
+ * CPU supports it) and carries a 16-byte tag that also authenticates the
+ * caller's associated data, typically the record's header. The key schedule
+ * is expanded once per direction; each record only sets a new nonce, formed
+ * as in TLS 1.3 by XORing the sequence number into the static IV.
+ *
+ * A sequence number must never be reused under one key. Sealing and opening
+ * are each serialized internally, so one layer may be shared by a sending and
+ * several receiving threads; threads that seal in parallel each take their
+ * own Sealer instead.
+ */
+class AeadRecordLayer {
+public:
+    static constexpr size_t TAG_SIZE = 16;
+    static constexpr size_t NONCE_SIZE = 12;
+
+    /**
+     * @brief A private copy of the send direction's cipher state.
+     *
+     * Sealing through a Sealer takes no lock, so workers holding one each can
+     * seal different sequence numbers at the same time. A Sealer must not be
+     * used by two threads at once or outlive its layer.
+     */
+    class Sealer {
+    public:
+        ~Sealer();
+
+        Sealer(const Sealer&) = delete;
+        Sealer& operator=(const Sealer&) = delete;
+
+        /**
+         * @brief Encrypts plaintext into out (which may alias it) and writes TAG_SIZE bytes of tag.
+         */
+        bool seal(uint64_t sequence, utils::ByteSpan aad, utils::ByteSpan plaintext, uint8_t* out, uint8_t* tag);
+
+        /**
+         * @brief Seals a record gathered from several pieces: begin(), update() per piece, finish().
+         *
+         * The output is the same as seal() over the pieces concatenated, so
+         * scattered plaintext never has to be joined first.
+         */
+        bool begin(uint64_t sequence, utils::ByteSpan aad);
+        bool update(utils::ByteSpan plaintext, uint8_t* out);
+        bool finish(uint8_t* tag);
+
+    private:
+        friend class AeadRecordLayer;
+        Sealer(EVP_CIPHER_CTX* context, const std::array<uint8_t, NONCE_SIZE>& iv)
+            : context_(context), iv_(iv) {}
+
+        EVP_CIPHER_CTX* context_;
+        std::array<uint8_t, NONCE_SIZE> iv_;
+    };
+
+    struct DirectionKeys {
+        std::vector<uint8_t> key;                ///< keyLength(suite) bytes
+        std::array<uint8_t, NONCE_SIZE> iv{};
+    };
+
+    /**
+     * @brief Builds a layer from two directions' keys.
+     *
+     * @throws std::runtime_error if the cipher cannot be initialized
+     */
+    AeadRecordLayer(CipherSuite suite, const DirectionKeys& send, const DirectionKeys& receive);
+    ~AeadRecordLayer();
+
+    AeadRecordLayer(const AeadRecordLayer&) = delete;
+    AeadRecordLayer& operator=(const AeadRecordLayer&) = delete;
+
+    /**
+     * @brief Derives both directions' keys from a completed handshake.
+     *
+     * Uses the context's RFC 5705 keying material exporter, so both peers
+     * arrive at the same keys without another round trip; the client's send
+     * key is the server's receive key and vice versa.
+     */
+    static Result<std::shared_ptr<AeadRecordLayer>> fromContext(SecureContext& context);
+
+    static size_t keyLength(CipherSuite suite);
+
+    CipherSuite suite() const { return suite_; }
+
+    /**
+     * @brief Encrypts data in place and writes TAG_SIZE bytes of tag.
+     */
+    bool seal(uint64_t sequence, utils::ByteSpan aad, utils::MutableByteSpan data, uint8_t* tag);
+
+    /**
+     * @brief Copies the send direction's expanded key into a new Sealer.
+     *
+     * @return nullptr if the cipher state cannot be copied
+     */
+    std::unique_ptr<Sealer> makeSealer();
+
+    /**
+     * @brief Verifies tag and decrypts data in place; false if the record was forged or corrupted.
+     *
+     * data is left unspecified when verification fails.
+     */
+    bool open(uint64_t sequence, utils::ByteSpan aad, utils::MutableByteSpan data, const uint8_t* tag);
+
+private:
+    struct Direction {
+        EVP_CIPHER_CTX* context = nullptr;
+        std::array<uint8_t, NONCE_SIZE> iv{};
+        std::mutex mutex;
+    };
+
+    static void initDirection(Direction& direction, CipherSuite suite, const DirectionKeys& keys, bool encrypt);
+    static std::array<uint8_t, NONCE_SIZE> nonceFor(const std::array<uint8_t, NONCE_SIZE>& iv, uint64_t sequence);
+    static bool sealWith(EVP_CIPHER_CTX* context, const std::array<uint8_t, NONCE_SIZE>& nonce,
+                         utils::ByteSpan aad, utils::ByteSpan plaintext, uint8_t* out, uint8_t* tag);
+
+    CipherSuite suite_;
+    Direction send_;
+    Direction receive_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_AEAD_RECORD_LAYER_HPP
@@ -0,0 +1,123 @@
+#ifndef XENOCOMM_CORE_AUTH_CACHE_HPP
+#define XENOCOMM_CORE_AUTH_CACHE_HPP
+
+#include "xenocomm/core/security_config.hpp"
+#include "xenocomm/utils/contention_profile.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Concurrent cache of authentication results with a fixed time-to-live.
+ *
+ * Keys are spread over independently locked shards, so threads validating
+ * different credentials rarely contend. Each shard keeps its entries in
+ * expiry order, so expired entries are always at the front and cleanup costs
+ * only what has expired. Most entries live for the cache's TTL and go on the
+ * back; one given a shorter TTL, such as a credential that expires sooner,
+ * is placed by its expiry. When a shard is full the entry soonest to expire
+ * gives way.
+ */
+class AuthCache {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Stats {
+        size_t entries = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;    ///< Dropped for space before expiring
+        uint64_t expirations = 0;
+
+        float hitRate() const {
+            uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<float>(hits) / static_cast<float>(lookups) : 0.0f;
+        }
+    };
+
+    AuthCache(size_t maxEntries, std::chrono::seconds ttl);
+    explicit AuthCache(const AuthCacheConfig& config)
+        : AuthCache(config.maxCacheSize, config.cacheTimeout) {}
+
+    AuthCache(const AuthCache&) = delete;
+    AuthCache& operator=(const AuthCache&) = delete;
+
+    /**
+     * @brief The value cached for key if it has not expired; counts a hit or a miss.
+     */
+    std::optional<std::string> lookup(const std::string& key);
+
+    /**
+     * @brief Whether key is cached, without touching the hit and miss counters.
+     */
+    bool contains(const std::string& key);
+
+    /**
+     * @brief Caches value under key for one TTL from now, replacing any earlier entry.
+     */
+    void insert(const std::string& key, std::string value);
+
+    /**
+     * @brief Like insert(), but the entry expires after ttl if that is sooner than the cache's TTL.
+     */
+    void insert(const std::string& key, std::string value, std::chrono::seconds ttl);
+
+    bool erase(const std::string& key);
+
+    /**
+     * @brief Drops every expired entry.
+     *
+     * @return Number of entries dropped
+     */
+    size_t cleanupExpired();
+
+    void clear();
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    std::chrono::seconds ttl() const { return ttl_; }
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string key;
+        std::string value;
+        Clock::time_point expires;
+    };
+    using Order = std::list<Entry>;
+
+    struct Shard {
+        utils::ProfiledMutex<> mutex{"auth_cache.shard"};
+        Order order;  // Soonest to expire first
+        std::unordered_map<std::string, Order::iterator> index;
+    };
+
+    Shard& shardFor(const std::string& key);
+    void eraseLocked(Shard& shard, Order::iterator entry);
+    static Order::iterator expiryPosition(Shard& shard, Clock::time_point expires);
+    size_t expireLocked(Shard& shard, Clock::time_point now);
+
+    const size_t shardCapacity_;
+    const std::chrono::seconds ttl_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> size_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> expirations_{0};
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_AUTH_CACHE_HPP
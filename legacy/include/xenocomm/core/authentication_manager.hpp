@@ -51,6 +51,15 @@ public:
      * @return Authentication result
      */
     virtual AuthResult authenticate(const AuthenticationContext& context) = 0;
+
+    /**
+     * @brief Authenticate several agents at once
+     *
+     * Providers that can share work between the contexts override this; by
+     * default each is authenticated in turn.
+     * @return One result per context, in order
+     */
+    virtual std::vector<AuthResult> authenticateBatch(const std::vector<AuthenticationContext>& contexts);
     
     /**
      * @brief Get the authentication method name
@@ -113,6 +122,18 @@ public:
     AuthResult authenticate(const std::string& methodName, 
                           const AuthenticationContext& context);
 
+    /**
+     * @brief Authenticate several agents using the specified method
+     *
+     * For bursts of connections. Each context is tried once, without the
+     * retries of authenticate(); the callback sees every result.
+     * @param methodName Authentication method to use
+     * @param contexts Authentication contexts with credentials
+     * @return One result per context, in order
+     */
+    std::vector<AuthResult> authenticateBatch(const std::string& methodName,
+                                              const std::vector<AuthenticationContext>& contexts);
+
     /**
      * @brief Set callback for authentication events
      * @param callback Function to call on authentication events
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "xenocomm/core/negotiation_protocol.h"
+#include "xenocomm/utils/awaitable.hpp"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+class CompiledPreference;
+class ParameterPerformanceModel;
+
+/**
+ * @brief Configuration for negotiating with many peers at once.
+ */
+struct BatchNegotiationConfig {
+    std::chrono::milliseconds timeout{3000};      ///< Deadline for each round, covering every peer
+    std::chrono::milliseconds pollInterval{2};    ///< Pause between sweeps over sessions still in progress
+    size_t maxParallelInitiations{16};            ///< Threads sending proposals; initiateSession may block on the network
+    bool acceptCounterProposals{true};            ///< Accept counters (those compatible with the preferences, if given)
+    bool convergeOnGroupParams{false};            ///< Renegotiate divergent peers onto one common parameter set
+};
+
+/**
+ * @brief How negotiation with one peer of a batch ended.
+ */
+struct PeerNegotiationOutcome {
+    std::string peerId;
+    NegotiationProtocol::SessionId sessionId{0};               ///< 0 if no session could be started
+    NegotiationState state{NegotiationState::IDLE};            ///< Final state, or the state it was in at the deadline
+    std::optional<NegotiableParams> params;                    ///< Agreed parameters, if FINALIZED
+    std::optional<std::string> error;                          ///< Why the peer has no parameters
+    bool inGroup{false};                                       ///< params equal BatchNegotiationResult::groupParams
+};
+
+/**
+ * @brief Per-peer outcomes of a batch, in the order the peers were given.
+ */
+struct BatchNegotiationResult {
+    std::vector<PeerNegotiationOutcome> peers;
+    std::optional<NegotiableParams> groupParams;  ///< Set shared by the inGroup peers, when converging
+
+    size_t succeeded() const;
+    size_t inGroup() const;
+};
+
+/**
+ * @brief Negotiates one proposal with many peers concurrently.
+ *
+ * Proposals go out from a small pool of threads, and responses are then
+ * collected by sweeping every outstanding session until each one finalizes,
+ * fails or meets the deadline, so a swarm of N peers takes roughly one
+ * round trip rather than N. Counter-proposals are settled as they arrive.
+ * Peers still negotiating at the deadline have their sessions closed.
+ *
+ * With convergeOnGroupParams, the parameter set agreed by the most peers
+ * (the best-scoring one on a tie, when preferences are given) becomes the
+ * group set, and only the peers that agreed on something else are asked
+ * again, in one more concurrent round that accepts nothing but the group
+ * set. A peer that refuses keeps its own parameters and is left out of the
+ * group.
+ *
+ * Given a ParameterPerformanceModel and preferences, each peer is proposed
+ * the data format, compression and error correction that measurements of
+ * its link rank first, where they overturn the static ranking, and group
+ * candidates tie-break on the ranking measured across all peers.
+ *
+ * Works with any NegotiationProtocol, through its public interface only.
+ * The protocol must be safe to call from several threads.
+ */
+class BatchNegotiator {
+public:
+    explicit BatchNegotiator(NegotiationProtocol& protocol,
+                             BatchNegotiationConfig config = BatchNegotiationConfig(),
+                             std::shared_ptr<const ParameterPerformanceModel> performance = nullptr);
+
+    /**
+     * @brief Negotiates proposal with every peer, accepting any counter-proposal if configured to.
+     */
+    BatchNegotiationResult negotiate(const std::vector<std::string>& peerIds,
+                                     const NegotiableParams& proposal);
+
+    /**
+     * @brief Negotiates proposal with every peer, judging counters and group candidates by preferences.
+     */
+    BatchNegotiationResult negotiate(const std::vector<std::string>& peerIds,
+                                     const NegotiableParams& proposal,
+                                     const ParameterPreference& preferences);
+
+    /**
+     * @brief negotiate() without blocking the caller; settles once every peer has.
+     *
+     * Proposals go out as tasks on WorkStealingExecutor::shared() and the
+     * sessions are swept from TimerService::shared() every pollInterval, so
+     * no thread waits on the peers in between and many batches share the
+     * pool. The continuation, or the coroutine co_awaiting the result,
+     * resumes on the executor worker that finished the batch unless
+     * scheduler sends it elsewhere. The negotiator and the protocol must
+     * outlive the result.
+     */
+    utils::Awaitable<BatchNegotiationResult> negotiateAwaitable(const std::vector<std::string>& peerIds,
+                                                                const NegotiableParams& proposal,
+                                                                utils::ContinuationScheduler scheduler = nullptr);
+
+    utils::Awaitable<BatchNegotiationResult> negotiateAwaitable(const std::vector<std::string>& peerIds,
+                                                                const NegotiableParams& proposal,
+                                                                const ParameterPreference& preferences,
+                                                                utils::ContinuationScheduler scheduler = nullptr);
+
+private:
+    struct AsyncBatch;
+
+    /**
+     * @brief Adjusts each peer's proposal to measured performance, if a model was given, and compiles the preferences.
+     */
+    CompiledPreference prepare(const std::vector<std::string>& peerIds,
+                               const ParameterPreference& preferences,
+                               std::vector<NegotiableParams>& proposals) const;
+
+    BatchNegotiationResult run(const std::vector<std::string>& peerIds,
+                               const std::vector<NegotiableParams>& proposals,
+                               const CompiledPreference* preferences);
+
+    /**
+     * @brief One concurrent round: propose to the given outcomes' peers and collect the results.
+     *
+     * @param proposals The proposal for each of peers, in the same order
+     * @param only If set, any counter-proposal other than this set is rejected
+     */
+    void round(std::vector<PeerNegotiationOutcome*>& peers,
+               const std::vector<NegotiableParams>& proposals,
+               const CompiledPreference* preferences,
+               const std::optional<NegotiableParams>& only);
+
+    void initiate(PeerNegotiationOutcome& peer, const NegotiableParams& proposal);
+
+    /**
+     * @brief One pass over the sessions still in progress, dropping those that settled.
+     *
+     * @return true once none are left; at the deadline the rest are closed as timed out
+     */
+    bool sweep(std::vector<PeerNegotiationOutcome*>& pending,
+               const CompiledPreference* preferences,
+               const std::optional<NegotiableParams>& only,
+               std::chrono::steady_clock::time_point deadline);
+
+    bool acceptsCounter(NegotiationProtocol::SessionId sessionId,
+                        const CompiledPreference* preferences,
+                        const std::optional<NegotiableParams>& only) const;
+
+    void converge(BatchNegotiationResult& result, const CompiledPreference* preferences);
+
+    /**
+     * @brief Sets result's group parameters and returns the indices of the peers that agreed on others.
+     */
+    std::vector<size_t> chooseGroup(BatchNegotiationResult& result, const CompiledPreference* preferences) const;
+
+    void adoptRetries(BatchNegotiationResult& result, const std::vector<size_t>& retried,
+                      std::vector<PeerNegotiationOutcome>& retries);
+
+    // negotiateAwaitable() steps
+    utils::Awaitable<BatchNegotiationResult> start(std::shared_ptr<AsyncBatch> batch,
+                                                   const std::vector<std::string>& peerIds);
+    void startRound(std::shared_ptr<AsyncBatch> batch);
+    void sweepLater(std::shared_ptr<AsyncBatch> batch, std::chrono::milliseconds delay);
+    void finishRound(std::shared_ptr<AsyncBatch> batch);
+
+    NegotiationProtocol& protocol_;
+    BatchNegotiationConfig config_;
+    std::shared_ptr<const ParameterPerformanceModel> performance_;
+};
+
+} // namespace core
+} // namespace xenocomm
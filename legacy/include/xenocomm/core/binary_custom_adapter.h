@@ -1,6 +1,8 @@
 #pragma once
 
 #include "xenocomm/core/data_transcoder.h"
+#include "xenocomm/core/binary_schema.h"
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -69,6 +71,34 @@ public:
     TranscodingMetadata getMetadata(
         const std::vector<uint8_t>& encoded_data) const override;
 
+    /**
+     * @brief Reads a BinarySchema message out of encoded data in place
+     * 
+     * Fields are then read from the view without decoding the whole payload.
+     * 
+     * @param encoded_data Encoded data whose payload is a Schema message; must outlive the view
+     * @param verify_checksum Check the payload checksum first, which reads every byte
+     * @return typename Schema::View View of the payload
+     * @throws TranscodingError if the header, checksum or message is invalid
+     */
+    template <typename Schema>
+    typename Schema::View viewMessage(
+        const std::vector<uint8_t>& encoded_data,
+        bool verify_checksum = true) const {
+        if (encoded_data.size() < sizeof(SchemaHeader)) {
+            throw TranscodingError("Encoded data too small to contain header");
+        }
+        SchemaHeader header;
+        std::memcpy(&header, encoded_data.data(), sizeof(SchemaHeader));
+        validateHeader(header, encoded_data.size() - sizeof(SchemaHeader));
+
+        const uint8_t* payload = encoded_data.data() + sizeof(SchemaHeader);
+        if (verify_checksum && calculateChecksum(payload, header.data_size) != header.checksum) {
+            throw TranscodingError("Checksum verification failed");
+        }
+        return typename Schema::View(utils::ByteSpan(payload, header.data_size));
+    }
+
 private:
     static constexpr uint32_t SCHEMA_VERSION = 1;
     static constexpr uint32_t MAGIC_NUMBER = 0xBC5A4D2E;  // "BC" for Binary Custom
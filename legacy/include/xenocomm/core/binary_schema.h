@@ -0,0 +1,410 @@
+#pragma once
+
+#include "xenocomm/core/data_transcoder.h"
+#include "xenocomm/utils/byte_span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Field types for BinarySchema
+ *
+ * Every field gets a slot at a fixed offset: scalars and optionals hold
+ * their value there, variable-length fields an (offset, count) pair
+ * pointing into the tail of the message.
+ */
+namespace schema {
+
+enum class FieldKind : uint8_t { SCALAR = 1, OPTIONAL = 2, REPEATED = 3, BYTES = 4, STRING = 5 };
+
+/// Required arithmetic or enum value
+template <typename T>
+struct Scalar {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Scalar fields hold numbers or enums");
+    using value_type = T;
+    static constexpr FieldKind kind = FieldKind::SCALAR;
+    static constexpr size_t slot_size = sizeof(T);
+    static constexpr size_t element_size = sizeof(T);
+};
+
+/// Arithmetic or enum value that may be absent, tracked in a presence bitmap
+template <typename T>
+struct Optional {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Optional fields hold numbers or enums");
+    using value_type = T;
+    static constexpr FieldKind kind = FieldKind::OPTIONAL;
+    static constexpr size_t slot_size = sizeof(T);
+    static constexpr size_t element_size = sizeof(T);
+};
+
+/// Array of arithmetic or enum values
+template <typename T>
+struct Repeated {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Repeated fields hold numbers or enums");
+    using value_type = T;
+    static constexpr FieldKind kind = FieldKind::REPEATED;
+    static constexpr size_t slot_size = 2 * sizeof(uint32_t);
+    static constexpr size_t element_size = sizeof(T);
+};
+
+/// Opaque byte string
+struct Bytes {
+    using value_type = uint8_t;
+    static constexpr FieldKind kind = FieldKind::BYTES;
+    static constexpr size_t slot_size = 2 * sizeof(uint32_t);
+    static constexpr size_t element_size = 1;
+};
+
+/// Text, read back as a std::string_view
+struct String {
+    using value_type = char;
+    static constexpr FieldKind kind = FieldKind::STRING;
+    static constexpr size_t slot_size = 2 * sizeof(uint32_t);
+    static constexpr size_t element_size = 1;
+};
+
+namespace detail {
+
+template <size_t Size> struct UnsignedOfSize;
+template <> struct UnsignedOfSize<1> { using type = uint8_t; };
+template <> struct UnsignedOfSize<2> { using type = uint16_t; };
+template <> struct UnsignedOfSize<4> { using type = uint32_t; };
+template <> struct UnsignedOfSize<8> { using type = uint64_t; };
+
+// Values are stored little-endian whatever the host order
+template <typename T>
+T load(const uint8_t* bytes) {
+    using Bits = typename UnsignedOfSize<sizeof(T)>::type;
+    Bits bits = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bits |= static_cast<Bits>(static_cast<Bits>(bytes[i]) << (8 * i));
+    }
+#else
+    std::memcpy(&bits, bytes, sizeof(T));
+#endif
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void store(uint8_t* bytes, T value) {
+    using Bits = typename UnsignedOfSize<sizeof(T)>::type;
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+#else
+    std::memcpy(bytes, &bits, sizeof(T));
+#endif
+}
+
+// Describes a field type for the schema fingerprint
+template <typename Field>
+constexpr uint32_t fieldCode() {
+    using T = typename Field::value_type;
+    return static_cast<uint32_t>(Field::kind) << 16 | static_cast<uint32_t>(Field::element_size) << 8 |
+           (std::is_floating_point<T>::value ? 2u : 0u) | (std::is_signed<T>::value ? 1u : 0u);
+}
+
+} // namespace detail
+
+/**
+ * @brief Read-only access to the elements of a repeated field, in place
+ */
+template <typename T>
+class RepeatedView {
+public:
+    RepeatedView() = default;
+    RepeatedView(const uint8_t* data, size_t count) : data_(data), count_(count) {}
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    T operator[](size_t index) const { return detail::load<T>(data_ + index * sizeof(T)); }
+
+    std::vector<T> to_vector() const {
+        std::vector<T> values(count_);
+        for (size_t i = 0; i < count_; ++i) {
+            values[i] = (*this)[i];
+        }
+        return values;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t count_ = 0;
+};
+
+} // namespace schema
+
+/**
+ * @brief A message layout compiled from a list of field types
+ *
+ * Messages are laid out like FlatBuffers tables with the vtable resolved at
+ * compile time: a 32-bit schema fingerprint, a presence bitmap for optional
+ * fields, then one slot per field at a constexpr offset, then the contents
+ * of variable-length fields. View reads any field straight out of the
+ * buffer without decoding the rest, and Builder writes fields in place;
+ * both are inlined templates with no per-field dispatch.
+ *
+ * Fields are addressed by index, usually through an enum:
+ * @code
+ * using Telemetry = BinarySchema<schema::Scalar<uint32_t>, schema::Optional<double>,
+ *                                schema::Repeated<float>, schema::String>;
+ * enum { SENSOR, READING, SAMPLES, LABEL };
+ * Telemetry::Builder builder;
+ * builder.set<SENSOR>(7);
+ * builder.set<LABEL>("intake");
+ * auto bytes = builder.finish();
+ * Telemetry::View view(bytes);
+ * uint32_t sensor = view.get<SENSOR>();
+ * @endcode
+ *
+ * The encoded message is what BinaryCustomAdapter carries as its payload.
+ */
+template <typename... Fields>
+class BinarySchema {
+    static_assert(sizeof...(Fields) > 0, "A schema needs at least one field");
+
+    static constexpr size_t SLOT_SIZES[] = {Fields::slot_size...};
+    static constexpr size_t ELEMENT_SIZES[] = {Fields::element_size...};
+    static constexpr schema::FieldKind KINDS[] = {Fields::kind...};
+    static constexpr uint32_t FIELD_CODES[] = {schema::detail::fieldCode<Fields>()...};
+
+    static constexpr bool isVariable(size_t i) {
+        return KINDS[i] == schema::FieldKind::REPEATED || KINDS[i] == schema::FieldKind::BYTES ||
+               KINDS[i] == schema::FieldKind::STRING;
+    }
+
+    static constexpr size_t presenceBit(size_t field) {
+        size_t bit = 0;
+        for (size_t i = 0; i < field; ++i) {
+            bit += KINDS[i] == schema::FieldKind::OPTIONAL ? 1 : 0;
+        }
+        return bit;
+    }
+
+    static constexpr size_t PRESENCE_OFFSET = sizeof(uint32_t);
+    static constexpr size_t SLOTS_OFFSET = PRESENCE_OFFSET + (presenceBit(sizeof...(Fields)) + 7) / 8;
+
+    static constexpr size_t slotOffset(size_t field) {
+        size_t offset = SLOTS_OFFSET;
+        for (size_t i = 0; i < field; ++i) {
+            offset += SLOT_SIZES[i];
+        }
+        return offset;
+    }
+
+    static constexpr uint32_t fingerprint() {
+        uint32_t hash = 2166136261u;  // FNV-1a over the field codes
+        for (uint32_t code : FIELD_CODES) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                hash = (hash ^ ((code >> shift) & 0xFFu)) * 16777619u;
+            }
+        }
+        return hash;
+    }
+
+public:
+    static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+
+    /// Bytes before any variable-length contents; the size of a message with none
+    static constexpr size_t FIXED_SIZE = slotOffset(FIELD_COUNT);
+
+    /// Identifies the field layout, so a view of another schema's message is rejected
+    static constexpr uint32_t FINGERPRINT = fingerprint();
+
+    template <size_t I>
+    using FieldAt = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+    /**
+     * @brief Writes a message field by field
+     *
+     * Unset scalars read back as zero, unset optionals as absent and unset
+     * variable-length fields as empty. Set each variable-length field at most
+     * once; setting it again leaves the earlier contents in the message.
+     */
+    class Builder {
+    public:
+        Builder() { reset(); }
+
+        /// Sets a scalar or optional field
+        template <size_t I>
+        Builder& set(typename FieldAt<I>::value_type value) {
+            using Field = FieldAt<I>;
+            static_assert(Field::kind == schema::FieldKind::SCALAR || Field::kind == schema::FieldKind::OPTIONAL,
+                          "Variable-length fields are set from a range");
+            schema::detail::store(buffer_.data() + slotOffset(I), value);
+            if (Field::kind == schema::FieldKind::OPTIONAL) {
+                buffer_[PRESENCE_OFFSET + presenceBit(I) / 8] |= static_cast<uint8_t>(1u << (presenceBit(I) % 8));
+            }
+            return *this;
+        }
+
+        /// Sets a repeated field from count values
+        template <size_t I>
+        Builder& set(const typename FieldAt<I>::value_type* values, size_t count) {
+            using Field = FieldAt<I>;
+            static_assert(isVariable(I), "Only variable-length fields are set from a range");
+            const size_t offset = appendTail(count * Field::element_size);
+            if constexpr (Field::element_size == 1) {
+                if (count > 0) {
+                    std::memcpy(buffer_.data() + offset, values, count);
+                }
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    schema::detail::store(buffer_.data() + offset + i * Field::element_size, values[i]);
+                }
+            }
+            return setSlot(I, offset, count);
+        }
+
+        template <size_t I>
+        Builder& set(const std::vector<typename FieldAt<I>::value_type>& values) {
+            return set<I>(values.data(), values.size());
+        }
+
+        /// Sets a string field
+        template <size_t I>
+        Builder& set(std::string_view text) {
+            static_assert(FieldAt<I>::kind == schema::FieldKind::STRING, "Text goes in String fields");
+            return set<I>(text.data(), text.size());
+        }
+
+        template <size_t I>
+        Builder& set(const char* text) {
+            return set<I>(std::string_view(text));
+        }
+
+        /// Sets a bytes field
+        template <size_t I>
+        Builder& set(utils::ByteSpan bytes) {
+            static_assert(FieldAt<I>::kind == schema::FieldKind::BYTES, "Byte strings go in Bytes fields");
+            return set<I>(bytes.data(), bytes.size());
+        }
+
+        size_t size() const { return buffer_.size(); }
+
+        /**
+         * @brief Returns the encoded message and leaves the builder empty
+         */
+        std::vector<uint8_t> finish() {
+            std::vector<uint8_t> message = std::move(buffer_);
+            reset();
+            return message;
+        }
+
+    private:
+        void reset() {
+            buffer_.assign(FIXED_SIZE, 0);
+            schema::detail::store(buffer_.data(), FINGERPRINT);
+        }
+
+        size_t appendTail(size_t bytes) {
+            const size_t offset = buffer_.size();
+            buffer_.resize(offset + bytes);
+            return offset;
+        }
+
+        Builder& setSlot(size_t field, size_t offset, size_t count) {
+            if (offset > UINT32_MAX || count > UINT32_MAX) {
+                throw TranscodingError("Schema message larger than 4 GiB");
+            }
+            schema::detail::store(buffer_.data() + slotOffset(field), static_cast<uint32_t>(offset));
+            schema::detail::store(buffer_.data() + slotOffset(field) + sizeof(uint32_t), static_cast<uint32_t>(count));
+            return *this;
+        }
+
+        std::vector<uint8_t> buffer_;
+    };
+
+    /**
+     * @brief Reads fields of an encoded message in place
+     *
+     * Construction checks the fingerprint and that every variable-length
+     * field lies inside the buffer, so get() never reads out of bounds. The
+     * buffer must outlive the view.
+     */
+    class View {
+    public:
+        /**
+         * @throws TranscodingError if data is not a valid message of this schema
+         */
+        explicit View(utils::ByteSpan data) : data_(data) {
+            if (data_.size() < FIXED_SIZE) {
+                throw TranscodingError("Schema message shorter than its fixed fields");
+            }
+            if (schema::detail::load<uint32_t>(data_.data()) != FINGERPRINT) {
+                throw TranscodingError("Schema message fingerprint mismatch");
+            }
+            for (size_t i = 0; i < FIELD_COUNT; ++i) {
+                if (!isVariable(i)) {
+                    continue;
+                }
+                const uint64_t offset = schema::detail::load<uint32_t>(data_.data() + slotOffset(i));
+                const uint64_t count = schema::detail::load<uint32_t>(data_.data() + slotOffset(i) + sizeof(uint32_t));
+                if (count > 0 && (offset < FIXED_SIZE || offset + count * ELEMENT_SIZES[i] > data_.size())) {
+                    throw TranscodingError("Schema message field out of bounds");
+                }
+            }
+        }
+
+        /// True unless field I is an optional that was not set
+        template <size_t I>
+        bool has() const {
+            if (FieldAt<I>::kind != schema::FieldKind::OPTIONAL) {
+                return true;
+            }
+            return (data_[PRESENCE_OFFSET + presenceBit(I) / 8] >> (presenceBit(I) % 8) & 1u) != 0;
+        }
+
+        /**
+         * @brief Reads field I
+         *
+         * Returns the value for scalars, std::optional for optionals, a
+         * RepeatedView for repeated fields, a ByteSpan for bytes and a
+         * std::string_view for strings; the last three point into the buffer.
+         */
+        template <size_t I>
+        auto get() const {
+            using Field = FieldAt<I>;
+            using T = typename Field::value_type;
+            const uint8_t* slot = data_.data() + slotOffset(I);
+            if constexpr (Field::kind == schema::FieldKind::SCALAR) {
+                return schema::detail::load<T>(slot);
+            } else if constexpr (Field::kind == schema::FieldKind::OPTIONAL) {
+                return has<I>() ? std::optional<T>(schema::detail::load<T>(slot)) : std::optional<T>();
+            } else {
+                const uint8_t* contents = data_.data() + schema::detail::load<uint32_t>(slot);
+                const size_t count = schema::detail::load<uint32_t>(slot + sizeof(uint32_t));
+                if constexpr (Field::kind == schema::FieldKind::REPEATED) {
+                    return schema::RepeatedView<T>(contents, count);
+                } else if constexpr (Field::kind == schema::FieldKind::BYTES) {
+                    return utils::ByteSpan(count > 0 ? contents : nullptr, count);
+                } else {
+                    return std::string_view(count > 0 ? reinterpret_cast<const char*>(contents) : "", count);
+                }
+            }
+        }
+
+        utils::ByteSpan bytes() const { return data_; }
+
+    private:
+        utils::ByteSpan data_;
+    };
+};
+
+} // namespace core
+} // namespace xenocomm
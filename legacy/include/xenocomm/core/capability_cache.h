@@ -1,13 +1,19 @@
 #pragma once
 
 #include "xenocomm/core/capability_signaler.h"
-#include <list>
+#include "xenocomm/utils/contention_profile.hpp"
+#include "xenocomm/utils/metrics_registry.hpp"
+#include <atomic>
 #include <unordered_map>
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace xenocomm {
 namespace core {
@@ -43,63 +49,68 @@ struct CacheConfig {
 };
 
 /**
- * @brief Cache entry containing capability query results and metadata.
- */
-struct CacheEntry {
-    std::string value;
-    std::chrono::steady_clock::time_point expiry;
-};
-
-/**
- * @brief LRU cache for capability query results to improve performance of repeated queries.
+ * @brief Sharded cache for capability query results to improve performance of repeated queries.
+ * 
+ * Keys are spread over independently locked shards, and each shard evicts
+ * with the CLOCK policy: a hit only sets the entry's reference bit under a
+ * shared lock, and an insertion into a full shard sweeps a hand over its
+ * slots, giving referenced entries a second chance and reclaiming expired
+ * ones first. Lookups on different keys, or the same key, therefore run in
+ * parallel and never reorder anything. Caches of up to SHARD_MIN_ENTRIES
+ * entries use a single shard so the configured bound stays exact.
  * 
- * The CapabilityCache implements a least-recently-used (LRU) caching strategy for capability
- * discovery results. It maintains a fixed-size cache with configurable time-to-live (TTL)
- * for entries. The cache is thread-safe and provides statistics tracking.
+ * Values are stored as Value, so callers can cache parsed results rather
+ * than strings, and keys need only be hashable by Hash, so callers can key
+ * by a fixed-size digest instead of building a string per lookup. Statistics are relaxed atomics, kept only when
+ * CacheConfig::track_stats is set.
  * 
  * Performance Characteristics:
  * - Cache lookup: O(1) average case
- * - Cache insertion: O(1) average case
- * - Cache eviction: O(1)
+ * - Cache insertion: O(1) amortized
+ * - Cache eviction: O(1) amortized
  * - Memory usage: O(n) where n is the configured cache size
  */
-class CapabilityCache {
+template <typename Value, typename Key = std::string, typename Hash = std::hash<Key>>
+class BasicCapabilityCache {
 public:
+    static constexpr size_t MAX_SHARDS = 16;
+    static constexpr size_t SHARD_MIN_ENTRIES = 64;
+
     /**
-     * @brief Constructs a CapabilityCache with the specified configuration.
+     * @brief Constructs a cache with the specified configuration.
      * 
      * @param config The cache configuration
      */
-    explicit CapabilityCache(const CacheConfig& config);
+    explicit BasicCapabilityCache(const CacheConfig& config);
 
     /**
      * @brief Default destructor.
      */
-    ~CapabilityCache() = default;
+    ~BasicCapabilityCache() = default;
 
     // Prevent copying
-    CapabilityCache(const CapabilityCache&) = delete;
-    CapabilityCache& operator=(const CapabilityCache&) = delete;
+    BasicCapabilityCache(const BasicCapabilityCache&) = delete;
+    BasicCapabilityCache& operator=(const BasicCapabilityCache&) = delete;
 
-    // Explicitly delete move operations since std::mutex is not movable
-    CapabilityCache(CapabilityCache&&) = delete;
-    CapabilityCache& operator=(CapabilityCache&&) = delete;
+    // Explicitly delete move operations since the shard mutexes are not movable
+    BasicCapabilityCache(BasicCapabilityCache&&) = delete;
+    BasicCapabilityCache& operator=(BasicCapabilityCache&&) = delete;
 
     /**
      * @brief Looks up a capability in the cache.
      * 
      * @param key The capability key to look up
-     * @return The cached capability if found and not expired, std::nullopt otherwise
+     * @return The cached value if found and not expired, std::nullopt otherwise
      */
-    std::optional<std::string> get(const std::string& key);
+    std::optional<Value> get(const Key& key) const;
 
     /**
      * @brief Stores a capability in the cache.
      * 
      * @param key The capability key
-     * @param value The capability value to store
+     * @param value The value to store
      */
-    void put(const std::string& key, const std::string& value);
+    void put(const Key& key, Value value);
 
     /**
      * @brief Removes a capability from the cache.
@@ -107,7 +118,7 @@ public:
      * @param key The capability key to remove
      * @return true if the key was found and removed, false otherwise
      */
-    bool remove(const std::string& key);
+    bool remove(const Key& key);
 
     /**
      * @brief Clears all entries from the cache.
@@ -121,46 +132,228 @@ public:
      */
     CacheStats get_stats() const;
 
+    /**
+     * @brief Reports get_stats() through registry whenever it is exported, labelled cache=<name>
+     *
+     * Registering again replaces the previous registration.
+     */
+    void register_metrics(utils::MetricsRegistry& registry, const std::string& name);
+
 private:
-    // Cache configuration
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        Key key{};
+        Value value{};
+        Clock::time_point expiry;
+        std::atomic<bool> referenced{false};
+        bool occupied{false};
+    };
+
+    struct alignas(64) Shard {
+        mutable utils::ProfiledMutex<std::shared_mutex> mutex{"capability_cache.shard"};
+        std::unordered_map<Key, size_t, Hash> index;  // Key to slot
+        std::unique_ptr<Slot[]> slots;
+        std::vector<size_t> freeSlots;
+        size_t hand{0};
+    };
+
+    static size_t shardCountFor(size_t maxEntries);
+    Shard& shardFor(const Key& key) const;
+    size_t claimSlot(Shard& shard, Clock::time_point now);
+    void release(Shard& shard, size_t slot);
+    void count(std::atomic<size_t>& counter, size_t n = 1) const;
+
     CacheConfig config_;
+    size_t shardCount_;
+    size_t shardCapacity_;
+    std::unique_ptr<Shard[]> shards_;
 
-    // Cache statistics
-    CacheStats stats_;
+    mutable std::atomic<size_t> hits_{0};
+    mutable std::atomic<size_t> misses_{0};
+    std::atomic<size_t> evictions_{0};
+    std::atomic<size_t> insertions_{0};
 
-    // Cache entry key type (hash of capabilities vector)
-    using KeyType = std::string;
+    utils::MetricsRegistration metrics_registration_;  // Last, so it is removed before anything it reads
+};
 
-    // LRU list type (key ordered by access time)
-    using LRUList = std::list<KeyType>;
+template <typename Value, typename Key, typename Hash>
+size_t BasicCapabilityCache<Value, Key, Hash>::shardCountFor(size_t maxEntries) {
+    size_t shards = 1;
+    while (shards < MAX_SHARDS && shards * 2 * SHARD_MIN_ENTRIES <= maxEntries) {
+        shards *= 2;
+    }
+    return shards;
+}
 
-    // Main cache storage
-    std::unordered_map<KeyType, std::pair<CacheEntry, LRUList::iterator>> cache_;
-    
-    // LRU tracking list
-    LRUList lruList_;
+template <typename Value, typename Key, typename Hash>
+BasicCapabilityCache<Value, Key, Hash>::BasicCapabilityCache(const CacheConfig& config)
+    : config_(config),
+      shardCount_(shardCountFor(config.max_entries)),
+      shardCapacity_((config.max_entries + shardCount_ - 1) / shardCount_),
+      shards_(new Shard[shardCount_]) {
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& shard = shards_[i];
+        shard.slots.reset(new Slot[shardCapacity_]);
+        shard.freeSlots.reserve(shardCapacity_);
+        for (size_t slot = shardCapacity_; slot-- > 0;) {
+            shard.freeSlots.push_back(slot);
+        }
+        shard.index.reserve(shardCapacity_);
+    }
+}
 
-    // Thread safety
-    mutable std::mutex mutex_;
+template <typename Value, typename Key, typename Hash>
+typename BasicCapabilityCache<Value, Key, Hash>::Shard& BasicCapabilityCache<Value, Key, Hash>::shardFor(const Key& key) const {
+    // shardCount_ is a power of two
+    return shards_[Hash{}(key) & (shardCount_ - 1)];
+}
 
-    /**
-     * @brief Remove the least recently used entry if cache is full.
-     */
-    void evictIfNeeded();
+template <typename Value, typename Key, typename Hash>
+void BasicCapabilityCache<Value, Key, Hash>::count(std::atomic<size_t>& counter, size_t n) const {
+    if (config_.track_stats) {
+        counter.fetch_add(n, std::memory_order_relaxed);
+    }
+}
 
-    /**
-     * @brief Check if a cache entry has expired.
-     */
-    bool isExpired(const CacheEntry& entry) const;
+template <typename Value, typename Key, typename Hash>
+std::optional<Value> BasicCapabilityCache<Value, Key, Hash>::get(const Key& key) const {
+    Shard& shard = shardFor(key);
+    std::shared_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
 
-    /**
-     * @brief Update LRU status for a cache entry.
-     */
-    void updateLRU(const KeyType& key);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        count(misses_);
+        return std::nullopt;
+    }
+    Slot& slot = shard.slots[it->second];
+    // Expired entries stay until the clock hand or a put reclaims them
+    if (Clock::now() > slot.expiry) {
+        count(misses_);
+        return std::nullopt;
+    }
+    if (!slot.referenced.load(std::memory_order_relaxed)) {
+        slot.referenced.store(true, std::memory_order_relaxed);
+    }
+    count(hits_);
+    return slot.value;
+}
 
-    void evict_expired_entries();
-    void evict_lru_entry();
-};
+template <typename Value, typename Key, typename Hash>
+void BasicCapabilityCache<Value, Key, Hash>::release(Shard& shard, size_t slot) {
+    Slot& entry = shard.slots[slot];
+    shard.index.erase(entry.key);
+    entry.key = Key{};
+    entry.value = Value{};
+    entry.occupied = false;
+    shard.freeSlots.push_back(slot);
+}
+
+template <typename Value, typename Key, typename Hash>
+size_t BasicCapabilityCache<Value, Key, Hash>::claimSlot(Shard& shard, Clock::time_point now) {
+    if (shard.freeSlots.empty()) {
+        // Every slot is occupied; referenced entries get a second chance, which ends within two sweeps
+        for (;;) {
+            size_t slot = shard.hand;
+            shard.hand = (shard.hand + 1) % shardCapacity_;
+            Slot& entry = shard.slots[slot];
+            if (now > entry.expiry || !entry.referenced.exchange(false, std::memory_order_relaxed)) {
+                release(shard, slot);
+                count(evictions_);
+                break;
+            }
+        }
+    }
+    size_t slot = shard.freeSlots.back();
+    shard.freeSlots.pop_back();
+    return slot;
+}
+
+template <typename Value, typename Key, typename Hash>
+void BasicCapabilityCache<Value, Key, Hash>::put(const Key& key, Value value) {
+    if (shardCapacity_ == 0) {
+        return;
+    }
+    const auto now = Clock::now();
+    Shard& shard = shardFor(key);
+    std::unique_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    size_t slot;
+    if (it != shard.index.end()) {
+        slot = it->second;
+    } else {
+        slot = claimSlot(shard, now);
+        shard.index.emplace(key, slot);
+        shard.slots[slot].key = key;
+        shard.slots[slot].occupied = true;
+    }
+
+    Slot& entry = shard.slots[slot];
+    entry.value = std::move(value);
+    entry.expiry = now + config_.ttl;
+    entry.referenced.store(false, std::memory_order_relaxed);
+    count(insertions_);
+}
+
+template <typename Value, typename Key, typename Hash>
+bool BasicCapabilityCache<Value, Key, Hash>::remove(const Key& key) {
+    Shard& shard = shardFor(key);
+    std::unique_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        return false;
+    }
+    release(shard, it->second);
+    count(evictions_);
+    return true;
+}
+
+template <typename Value, typename Key, typename Hash>
+void BasicCapabilityCache<Value, Key, Hash>::clear() {
+    for (size_t i = 0; i < shardCount_; ++i) {
+        Shard& shard = shards_[i];
+        std::unique_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+        count(evictions_, shard.index.size());
+        for (size_t slot = 0; slot < shardCapacity_; ++slot) {
+            if (shard.slots[slot].occupied) {
+                release(shard, slot);
+            }
+        }
+        shard.hand = 0;
+    }
+}
+
+template <typename Value, typename Key, typename Hash>
+CacheStats BasicCapabilityCache<Value, Key, Hash>::get_stats() const {
+    CacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.insertions = insertions_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+template <typename Value, typename Key, typename Hash>
+void BasicCapabilityCache<Value, Key, Hash>::register_metrics(utils::MetricsRegistry& registry,
+                                                              const std::string& name) {
+    metrics_registration_ = registry.addCollector([this, name](utils::MetricsWriter& writer) {
+        const utils::MetricLabels labels{{"cache", name}};
+        const CacheStats stats = get_stats();
+        writer.counter("xenocomm_cache_hits", "Lookups answered from the cache", static_cast<double>(stats.hits), labels);
+        writer.counter("xenocomm_cache_misses", "Lookups not in the cache", static_cast<double>(stats.misses), labels);
+        writer.counter("xenocomm_cache_evictions", "Entries evicted", static_cast<double>(stats.evictions), labels);
+        writer.counter("xenocomm_cache_insertions", "Entries inserted", static_cast<double>(stats.insertions), labels);
+    });
+}
+
+/**
+ * @brief Cache of string values, as used for serialized query results.
+ */
+using CapabilityCache = BasicCapabilityCache<std::string>;
+
+extern template class BasicCapabilityCache<std::string>;
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm 
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "xenocomm/core/capability_signaler.h"
+#include "xenocomm/utils/compressed_bitset.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief A required capability reduced to integers, ready for CapabilityColumns::match().
+ *
+ * Built by CapabilityColumns::compile(); the parameter IDs are only meaningful
+ * to the instance that compiled them.
+ */
+struct CompiledCapabilityQuery {
+    uint32_t name = 0;            // Caller's name ID
+    uint64_t minVersion = 0;      // Inclusive range of Version::packed()
+    uint64_t maxVersion = 0;
+    uint64_t parameterMask = 0;   // Bloom bits of every required (key, value) pair
+    std::vector<uint64_t> parameters;  // Sorted (key ID << 32 | value ID) pairs
+    bool satisfiable = true;      // False if a required key or value was never registered
+};
+
+/**
+ * @brief Agent capabilities stored column by column, matched in bulk.
+ *
+ * Capability::matches() compares names as strings and looks every required
+ * parameter up in a std::map, once per agent. Here each row is one
+ * (agent, capability) with its name ID, packed version and a 64-bit Bloom
+ * mask of its (key, value) pairs in parallel arrays, so a query compiled to
+ * integers is tested four rows per instruction on AVX2 (scalar elsewhere).
+ * Rows whose mask passes have their exact parameter pairs confirmed, and the
+ * agents left over come back as a bitset. Large arrays are split into slices
+ * matched on separate threads.
+ *
+ * Name IDs belong to the caller, so one instance can hold a single name or
+ * many; parameter keys and values are interned here and kept until clear().
+ * Not thread-safe, except that concurrent match() calls are fine.
+ */
+class CapabilityColumns {
+public:
+    /// Below this many rows per thread, a match runs on the calling thread
+    static constexpr size_t PARALLEL_ROW_THRESHOLD = 64 * 1024;
+
+    /// Largest Version::packed(), the open end of a partial-match range
+    static constexpr uint64_t MAX_VERSION = (uint64_t(1) << 48) - 1;
+
+    /**
+     * @brief Appends a row; the caller ensures (agent, name, version) is not already present.
+     */
+    void add(uint32_t agent, uint32_t name, const Capability& capability);
+
+    /**
+     * @brief Removes the row for (agent, name, version).
+     *
+     * The last row takes its place, so row order is not stable.
+     *
+     * @return false if there was no such row
+     */
+    bool remove(uint32_t agent, uint32_t name, uint64_t version);
+
+    void clear();
+    size_t size() const { return names_.size(); }
+
+    /**
+     * @brief Compiles a requirement with the version rules of Capability::matches().
+     *
+     * Partial matching accepts any version at or above the required one;
+     * exact matching also requires the same major version.
+     */
+    CompiledCapabilityQuery compile(uint32_t name, const Capability& required, bool partialMatch) const;
+
+    /**
+     * @brief Compiles a requirement for an explicit inclusive version range.
+     */
+    CompiledCapabilityQuery compile(uint32_t name, uint64_t minVersion, uint64_t maxVersion,
+                                    const std::map<std::string, std::string>& parameters) const;
+
+    /**
+     * @return The agents with at least one row satisfying the query
+     */
+    utils::CompressedBitset match(const CompiledCapabilityQuery& query) const;
+
+private:
+    static uint64_t maskBit(uint64_t pair);
+    void matchSlice(const CompiledCapabilityQuery& query, size_t begin, size_t end, uint64_t* words) const;
+
+    // One entry per row in each column
+    std::vector<uint32_t> names_;
+    std::vector<uint64_t> versions_;
+    std::vector<uint64_t> masks_;
+    std::vector<uint32_t> agents_;
+    std::vector<std::vector<uint64_t>> parameters_;  // Sorted pairs
+
+    std::vector<std::vector<uint32_t>> agentRows_;  // Rows of each agent ID, for removal
+    std::unordered_map<std::string, uint32_t> strings_;  // Parameter keys and values
+};
+
+} // namespace core
+} // namespace xenocomm
@@ -1,15 +1,22 @@
 #pragma once
 
+#include "xenocomm/core/capability_columns.h"
 #include "xenocomm/core/capability_signaler.h"
+#include "xenocomm/core/capability_snapshot.h"
+#include "xenocomm/utils/compressed_bitset.hpp"
+#include "xenocomm/utils/result.hpp"
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include "xenocomm/core/version.h"
 #include <functional>
+#include <utility>
 
 namespace xenocomm {
 namespace core {
@@ -21,6 +28,19 @@ namespace core {
  * to the agents that provide them. This enables efficient discovery of agents
  * based on required capabilities, with O(1) lookup time for each capability
  * and O(k) time for intersecting the results, where k is the number of matching agents.
+ *
+ * Agent IDs and capability names are interned to dense integers, and each
+ * (name, version) keeps its agents in a CompressedBitset, so a multi-capability
+ * query intersects bitmaps word by word instead of building string sets.
+ * Versions are kept sorted with the union of every version at or above each
+ * one precomputed, so a compatible range is one binary search and one list.
+ * Each name's capabilities are also kept in CapabilityColumns, so required
+ * parameters are matched by a vectorized scan over interned IDs instead of
+ * comparing strings capability by capability.
+ * An index can also be served from a CapabilitySnapshot: its rows are read
+ * from the mapped file in place, and later changes are kept in the
+ * structures above as a delta over it, with removed snapshot rows remembered.
+ * Lookups take a shared lock and may run concurrently; updates are exclusive.
  * 
  * The index supports two matching modes:
  * 1. Exact Matching:
@@ -46,6 +66,13 @@ namespace core {
  */
 class CapabilityIndex {
 public:
+    /**
+     * @param synchronized Whether the index locks internally. Owners that
+     *        already keep readers off an instance while it is written, such as
+     *        InMemoryCapabilitySignaler, pass false so lookups touch no shared state.
+     */
+    explicit CapabilityIndex(bool synchronized = true) : synchronized_(synchronized) {}
+
     /**
      * @brief Adds a capability for an agent to the index.
      * 
@@ -60,6 +87,21 @@ public:
      */
     bool addCapability(const std::string& agentId, const Capability& capability);
 
+    /**
+     * @brief Adds many (agent, capability) registrations under one update.
+     * 
+     * The registrations are sorted by capability name and version, so each
+     * name's version list is filled in one pass and its precomputed unions
+     * are rebuilt once for the whole batch; this is the path for loading an
+     * index from scratch or re-registering a restarted node's agents.
+     * 
+     * @param registrations Pairs of agent ID and capability, in any order.
+     * @return The number of registrations that were newly added.
+     * 
+     * Time Complexity: O(n log n) for n registrations, plus one rebuild per name touched
+     */
+    size_t addCapabilities(std::vector<std::pair<std::string, Capability>> registrations);
+
     /**
      * @brief Removes a capability for an agent from the index.
      * 
@@ -81,6 +123,14 @@ public:
      */
     size_t removeAgent(const std::string& agentId);
 
+    /**
+     * @brief Removes all capabilities for several agents under one update.
+     * 
+     * @param agentIds The agents to remove; unknown IDs are ignored.
+     * @return The total number of capabilities that were removed.
+     */
+    size_t removeAgents(const std::vector<std::string>& agentIds);
+
     /**
      * @brief Finds all agents that provide the required capabilities.
      * 
@@ -94,7 +144,8 @@ public:
      *                     If false, requires exact matches for all capability attributes.
      * @return A vector of agent IDs that provide all the required capabilities.
      * 
-     * Time Complexity: O(k) where k is the number of matching agents
+     * Time Complexity: O(k) per required capability, where k is the size of its posting
+     * list; dense lists are intersected 64 agents per word
      * 
      * Example:
      * ```cpp
@@ -113,6 +164,18 @@ public:
         const std::vector<Capability>& capabilities,
         bool partialMatch = false) const;
 
+    /**
+     * @brief Whether one agent is among those findAgents() would return.
+     * 
+     * Answers for a single agent from its own postings and capabilities, so
+     * callers tracking a standing query can recheck just the agents a change touched.
+     * 
+     * Time Complexity: O(r) per required capability, where r is the number of capabilities the agent has
+     */
+    bool matchesAgent(const std::string& agentId,
+                      const std::vector<Capability>& capabilities,
+                      bool partialMatch = false) const;
+
     /**
      * @brief Gets all capabilities registered for an agent.
      * 
@@ -123,6 +186,38 @@ public:
      */
     std::vector<Capability> getAgentCapabilities(const std::string& agentId) const;
 
+    /**
+     * @brief Returns a stamp that changes whenever any agent gains or loses a capability by this name.
+     * 
+     * Stamps are never reused, even across clear(), so a cached lookup that
+     * recorded the stamps of the names it queried is still valid exactly when
+     * they all compare equal. Unindexed names return 0.
+     * 
+     * Time Complexity: O(1)
+     */
+    uint64_t generation(const std::string& name) const;
+
+    /**
+     * @brief Every (agent, capability) in the index, snapshot and delta alike.
+     */
+    std::vector<CapabilityRegistration> registrations() const;
+
+    /**
+     * @brief Writes registrations() to a snapshot file; the lock is not held while writing.
+     */
+    Result<void> saveSnapshot(const std::string& path) const;
+
+    /**
+     * @brief Replaces the contents of the index with a snapshot, served straight from its mapping.
+     * 
+     * Nothing is copied or rebuilt, so the index answers lookups as soon as
+     * this returns; registrations and removals made afterwards apply on top.
+     * Several indexes may share one snapshot.
+     * 
+     * Time Complexity: O(1), besides freeing the previous contents
+     */
+    void loadSnapshot(std::shared_ptr<const CapabilitySnapshot> snapshot);
+
     /**
      * @brief Clears all entries from the index.
      * 
@@ -138,20 +233,60 @@ public:
     size_t size() const;
 
 private:
-    // Maps capability name to a map of versions to sets of agent IDs
-    std::unordered_map<
-        std::string,  // Capability name
-        std::unordered_map<
-            Version,  // Version
-            std::unordered_set<std::string>  // Agent IDs
-        >
-    > capabilityIndex_;
-
-    // Maps agent ID to their set of capabilities
-    std::unordered_map<
-        std::string,  // Agent ID
-        std::unordered_set<Capability>  // Capabilities
-    > agentIndex_;
+    struct AgentEntry {
+        std::string id;
+        std::unordered_set<Capability> capabilities;
+    };
+
+    struct VersionEntry {
+        uint64_t version = 0;               // Version::packed(), so searches compare plain integers
+        utils::CompressedBitset agents;     // Agents providing exactly this version
+        utils::CompressedBitset atOrAbove;  // Agents providing this version or a later one
+    };
+
+    // Sorted by version
+    using VersionPostings = std::vector<VersionEntry>;
+
+    std::unique_lock<std::shared_mutex> writeLock() const;
+    void clearLocked();
+    AgentEntry& agentEntry(uint32_t agent);
+    const AgentEntry& agentEntry(uint32_t agent) const;
+    std::optional<uint32_t> liveSnapshotRow(const std::string& agentId, const Capability& capability) const;
+    bool removeSnapshotRow(uint32_t row);
+    void addSnapshotProviders(const Capability& required, bool partialMatch, utils::CompressedBitset& out) const;
+    std::shared_lock<std::shared_mutex> readLock() const;
+    uint32_t internAgent(const std::string& agentId);
+    uint32_t internCapability(const std::string& name);
+    size_t removeAgentLocked(const std::string& agentId);
+    void releaseAgent(uint32_t agent);
+    void addPosting(uint32_t agent, const Capability& capability);
+    bool erasePosting(uint32_t agent, const Capability& stored);
+    static VersionPostings::const_iterator firstAtOrAbove(VersionPostings::const_iterator first,
+                                                          const VersionPostings& versions, uint64_t version);
+
+    // Dense agent IDs; released ones are reused so posting lists stay compact.
+    // Snapshot agents keep their snapshot index as ID, and the others follow,
+    // so agents_ holds ID snapshotAgents_ + i at i.
+    std::unordered_map<std::string, uint32_t> agentIds_;
+    std::vector<AgentEntry> agents_;
+    std::unordered_map<uint32_t, AgentEntry> snapshotAgentEntries_;  // Snapshot agents changed since loading
+    std::vector<uint32_t> freeAgentIds_;
+
+    std::shared_ptr<const CapabilitySnapshot> snapshot_;
+    uint32_t snapshotAgents_{0};
+    std::unordered_set<uint32_t> removedRows_;  // Snapshot rows unregistered since loading
+    uint64_t snapshotGeneration_{0};            // Stamp of names only the snapshot has touched
+
+    // Dense capability name IDs index postings_
+    std::unordered_map<std::string, uint32_t> capabilityIds_;
+    std::vector<VersionPostings> postings_;
+    std::vector<CapabilityColumns> columns_;  // Indexed like postings_, for parameter matching
+    std::vector<uint64_t> generations_;  // Indexed like postings_
+    uint64_t lastGeneration_{0};
+
+    size_t mappings_{0};
+    const bool synchronized_;
+    mutable std::shared_mutex mutex_;
 };
 
 } // namespace core
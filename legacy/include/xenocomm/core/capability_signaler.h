@@ -123,6 +123,22 @@ struct Capability {
     }
 };
 
+/**
+ * @brief An agent ID and one capability it registers, the unit of multi-agent batches.
+ */
+using CapabilityRegistration = std::pair<std::string, Capability>;
+
+/**
+ * @brief Agents that started or stopped matching a standing discovery query.
+ */
+struct DiscoveryEvent {
+    uint64_t subscription = 0;         // ID subscribe() returned
+    std::vector<std::string> added;    // Agents that match now and did not before
+    std::vector<std::string> removed;  // Agents that matched before and no longer do
+};
+
+using DiscoveryCallback = std::function<void(const DiscoveryEvent&)>;
+
 /**
  * @brief Interface for managing agent capability advertisement and discovery.
  * 
@@ -162,6 +178,60 @@ public:
      */
     virtual bool registerCapability(const std::string& agentId, const Capability& capability) = 0;
 
+    /**
+     * @brief Registers several capabilities for an agent as one update.
+     * 
+     * Implementations with concurrent discovery publish the whole batch at once,
+     * which costs far less than registering the capabilities one by one.
+     * @param agentId The unique identifier of the agent.
+     * @param capabilities The capabilities being registered.
+     * @return The number of capabilities that were newly registered.
+     */
+    virtual size_t registerCapabilities(const std::string& agentId, const std::vector<Capability>& capabilities) {
+        size_t registered = 0;
+        for (const auto& capability : capabilities) {
+            if (registerCapability(agentId, capability)) {
+                ++registered;
+            }
+        }
+        return registered;
+    }
+
+    /**
+     * @brief Registers capabilities for many agents as one update.
+     * 
+     * Meant for bulk loads such as a restarted node re-registering all of its
+     * agents; implementations apply the batch in a single index update.
+     * @param registrations (agent ID, capability) pairs, in any order.
+     * @return The number of capabilities that were newly registered.
+     */
+    virtual size_t registerCapabilities(const std::vector<CapabilityRegistration>& registrations) {
+        size_t registered = 0;
+        for (const auto& [agentId, capability] : registrations) {
+            if (registerCapability(agentId, capability)) {
+                ++registered;
+            }
+        }
+        return registered;
+    }
+
+    /**
+     * @brief Unregisters every capability of several agents as one update.
+     * @param agentIds The agents to remove; unknown IDs are ignored.
+     * @return The number of capabilities that were unregistered.
+     */
+    virtual size_t unregisterAgentBatch(const std::vector<std::string>& agentIds) {
+        size_t removed = 0;
+        for (const auto& agentId : agentIds) {
+            for (const auto& capability : getAgentCapabilities(agentId)) {
+                if (unregisterCapability(agentId, capability)) {
+                    ++removed;
+                }
+            }
+        }
+        return removed;
+    }
+
     /**
      * @brief Unregisters a specific capability for an agent.
      * @param agentId The unique identifier of the agent.
@@ -210,20 +280,72 @@ public:
     /**
      * @brief Registers a capability for a specific agent using a binary representation.
      * @param agentId The unique identifier of the agent.
-     * @param capabilityData The binary representation of the capability.
+     * @param capabilityData One capability written by utils::serializeCapability, or a set
+     *        written by utils::serializeCapabilitySet.
      * @return True if registration was successful (including successful deserialization), false otherwise.
      */
     virtual bool registerCapabilityBinary(const std::string& agentId, const std::vector<uint8_t>& capabilityData) = 0;
 
     /**
      * @brief Retrieves all capabilities registered for a specific agent in a combined binary format.
-     * The format consists of a count of capabilities followed by size-prefixed capability blobs.
-     * [uint32_t count] [uint32_t size1] [cap1_data] [uint32_t size2] [cap2_data] ...
+     * The format is that of utils::serializeCapabilitySet, which stores each distinct string once;
+     * utils::CapabilitySetView reads it without copying.
      * @param agentId The unique identifier of the agent.
      * @return A byte vector containing the serialized capabilities. Returns an empty vector if agent not found or has no capabilities.
      */
     virtual std::vector<uint8_t> getAgentCapabilitiesBinary(const std::string& agentId) = 0;
 
+    /**
+     * @brief Registers a standing discovery query instead of polling discoverAgents().
+     * 
+     * The callback first receives every agent that matches now, then an event
+     * whenever a registration change adds agents to the result or removes
+     * them, in the order the changes were made. It runs on the thread that
+     * made the change and may only read from this signaler: registering,
+     * unregistering or (un)subscribing from inside it would deadlock.
+     * @param requiredCapabilities The query, as for discoverAgents().
+     * @param partialMatch The matching mode, as for discoverAgents().
+     * @param callback Receives the events.
+     * @return An ID for unsubscribe(), or 0 if the query is empty or the implementation has no subscriptions.
+     */
+    virtual uint64_t subscribe(const std::vector<Capability>& requiredCapabilities, bool partialMatch,
+                               DiscoveryCallback callback) {
+        (void)requiredCapabilities;
+        (void)partialMatch;
+        (void)callback;
+        return 0;
+    }
+
+    /**
+     * @brief Ends a subscription; an event already being delivered may still arrive.
+     * @return False if the ID is unknown.
+     */
+    virtual bool unsubscribe(uint64_t subscription) {
+        (void)subscription;
+        return false;
+    }
+
+    /**
+     * @brief Writes every registration to a snapshot file for loadSnapshot().
+     * @param path Where to write; the file is replaced only once the new one is complete.
+     * @return True if the snapshot was written; false if it failed or the implementation keeps none.
+     */
+    virtual bool saveSnapshot(const std::string& path) {
+        (void)path;
+        return false;
+    }
+
+    /**
+     * @brief Replaces all registrations with those of a snapshot file, for a warm start after a restart.
+     * Implementations serve discovery from the mapped file at once and keep later changes on top of it.
+     * @param path A file written by saveSnapshot().
+     * @return True if the snapshot was loaded; false if it is missing, corrupt or unsupported.
+     */
+    virtual bool loadSnapshot(const std::string& path) {
+        (void)path;
+        return false;
+    }
+
 protected:
     // Protected constructor for abstract base class
     CapabilitySignaler() = default;
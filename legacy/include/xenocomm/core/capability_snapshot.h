@@ -0,0 +1,140 @@
+#pragma once
+
+#include "xenocomm/core/capability_signaler.h"
+#include "xenocomm/utils/result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Leading bytes of a capability snapshot file (format version 1).
+ */
+constexpr uint32_t CAPABILITY_SNAPSHOT_MAGIC = 0x31534943;  // "CIS1"
+
+/**
+ * @brief A read-only, memory-mapped image of a CapabilityIndex.
+ *
+ * The file is a fixed header (magic, the count of each table, the string
+ * bytes and a CRC32 of everything after the header) followed by fixed-size
+ * little-endian records, so nothing is parsed when it is opened:
+ * - agents: string reference and row range, sorted by ID; an agent's index
+ *   in this table is its ID.
+ * - names: string reference and version range, sorted by name.
+ * - versions: packed version and posting range, ascending within each name.
+ * - postings: row indices of each (name, version), ascending, so in agent order.
+ * - rows: one per (agent, capability): agent, name, packed version,
+ *   parameter range and the deprecation fields; sorted by agent, name, version.
+ * - parameters: key and value string references.
+ * - strings: the bytes every reference points into, each distinct string once.
+ *
+ * Lookups binary-search the sorted tables, and only the pages a query
+ * touches are read. Every reference is bounds-checked on use, so an
+ * unverified file that is corrupt yields wrong answers, never a bad read.
+ * Immutable and thread-safe; CapabilityIndex layers its changes on top.
+ */
+class CapabilitySnapshot {
+public:
+    /**
+     * @brief Writes registrations as a snapshot; duplicates of (agent, name, version) are dropped.
+     *
+     * The file appears under path only once it is complete.
+     */
+    static Result<void> write(const std::string& path, std::vector<CapabilityRegistration> registrations);
+
+    /**
+     * @brief Maps a snapshot file.
+     *
+     * @param verify Whether to check the checksum, which reads the whole file;
+     *        without it opening takes constant time
+     */
+    static Result<std::shared_ptr<const CapabilitySnapshot>> open(const std::string& path, bool verify = true);
+
+    ~CapabilitySnapshot();
+
+    CapabilitySnapshot(const CapabilitySnapshot&) = delete;
+    CapabilitySnapshot& operator=(const CapabilitySnapshot&) = delete;
+
+    uint32_t agentCount() const { return agentCount_; }
+    uint32_t rowCount() const { return rowCount_; }
+
+    std::string_view agentId(uint32_t agent) const;
+    std::optional<uint32_t> findAgent(std::string_view agentId) const;
+    std::optional<uint32_t> findName(std::string_view name) const;
+
+    /**
+     * @return The first row of the agent and the number of rows it has
+     */
+    std::pair<uint32_t, uint32_t> agentRows(uint32_t agent) const;
+
+    /**
+     * @return The row for the agent's capability of this name and version, if it has one
+     */
+    std::optional<uint32_t> findRow(uint32_t agent, std::string_view name, uint64_t version) const;
+
+    uint32_t rowAgent(uint32_t row) const;
+    std::string_view rowName(uint32_t row) const;
+    uint64_t rowVersion(uint32_t row) const;
+
+    /**
+     * @brief Whether the row's parameters include every required (key, value) pair.
+     */
+    bool rowHasParameters(uint32_t row, const std::map<std::string, std::string>& required) const;
+
+    Capability capability(uint32_t row) const;
+
+    /**
+     * @brief Calls fn(row) for every row of the name at or above minVersion.
+     */
+    template <typename Fn>
+    void forEachRowAtOrAbove(uint32_t name, uint64_t minVersion, Fn&& fn) const {
+        auto [first, count] = nameVersions(name);
+        for (uint32_t v = firstVersionAtOrAbove(first, count, minVersion); v < first + count; ++v) {
+            auto [posting, postings] = versionPostings(v);
+            for (uint32_t i = posting; i < posting + postings; ++i) {
+                const uint32_t row = postingRow(i);
+                if (row < rowCount_) {
+                    fn(row);
+                }
+            }
+        }
+    }
+
+private:
+    CapabilitySnapshot() = default;
+
+    std::string_view string(const uint8_t* reference) const;
+    std::pair<uint32_t, uint32_t> nameVersions(uint32_t name) const;
+    uint32_t firstVersionAtOrAbove(uint32_t first, uint32_t count, uint64_t version) const;
+    std::pair<uint32_t, uint32_t> versionPostings(uint32_t version) const;
+    uint32_t postingRow(uint32_t posting) const;
+    const uint8_t* row(uint32_t row) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    uint32_t agentCount_ = 0;
+    uint32_t nameCount_ = 0;
+    uint32_t versionCount_ = 0;
+    uint32_t rowCount_ = 0;
+    uint32_t parameterCount_ = 0;
+    uint32_t stringBytes_ = 0;
+    // Start of each table in data_
+    const uint8_t* agents_ = nullptr;
+    const uint8_t* names_ = nullptr;
+    const uint8_t* versions_ = nullptr;
+    const uint8_t* postings_ = nullptr;
+    const uint8_t* rows_ = nullptr;
+    const uint8_t* parameters_ = nullptr;
+    const uint8_t* strings_ = nullptr;
+};
+
+} // namespace core
+} // namespace xenocomm
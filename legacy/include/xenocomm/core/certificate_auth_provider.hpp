@@ -1,7 +1,9 @@
 #pragma once
 
 #include "xenocomm/core/authentication_manager.hpp"
+#include "xenocomm/core/auth_cache.hpp"
 #include <openssl/x509.h>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
@@ -19,10 +21,18 @@ struct CertificateAuthConfig {
     bool allowSelfSigned{false};       // Whether to allow self-signed certificates
     std::vector<std::string> allowedDNs; // List of allowed Distinguished Names
     int64_t maxValidityDays{365};      // Maximum certificate validity period in days
+    size_t maxCachedChains{10000};     // Verified certificates remembered by fingerprint; 0 disables
+    std::chrono::seconds chainCacheTTL{300}; // How long a verification stands before the chain is checked again
 };
 
 /**
  * @brief Provider for certificate-based authentication
+ *
+ * Credentials are a DER certificate. A successful verification is cached
+ * under the certificate's SHA-256 fingerprint, so a peer presenting the same
+ * certificate again skips parsing and chain verification until
+ * chainCacheTTL passes. Certificates expiring sooner are not cached, and
+ * loading a new CRL drops every cached verification.
  */
 class CertificateAuthProvider : public AuthenticationProvider {
 public:
@@ -34,6 +44,31 @@ public:
     AuthResult authenticate(const AuthenticationContext& context) override;
     std::string getMethodName() const override;
 
+    /**
+     * @brief Authenticates many peers at once, e.g. agents reconnecting after a restart
+     * 
+     * Cached certificates are answered straight away. Each distinct remaining
+     * certificate is verified once, and those verifications run in parallel
+     * on the shared CryptoWorkerPool.
+     * 
+     * @return One result per context, in the same order
+     */
+    std::vector<AuthResult> authenticateBatch(const std::vector<AuthenticationContext>& contexts) override;
+
+    /**
+     * @brief Re-reads crlPath and forgets every cached verification
+     * 
+     * @return false if the CRL could not be loaded; the cache is cleared regardless
+     */
+    bool reloadCRL();
+
+    /**
+     * @brief Forgets the cached verification of one DER certificate
+     */
+    void invalidate(const std::vector<uint8_t>& certificate);
+
+    AuthCache::Stats getCacheStats() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
@@ -2,9 +2,13 @@
 
 #include "xenocomm/core/data_transcoder.h"
 #include "xenocomm/core/compression_algorithms.h"
+#include "xenocomm/core/compression_selector.h"
 #include <memory>
 #include <chrono>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace xenocomm {
 namespace core {
@@ -16,26 +20,100 @@ class CompressedStateAdapter : public DataTranscoder {
 public:
     /**
      * @brief Constructor
-     * @param algorithm Initial compression algorithm (defaults to RLE)
+     * @param algorithm Compression algorithm (defaults to RLE), or nullptr to let the
+     *        selector pick one for each payload
+     * @param selector_config Link bandwidth and cost model tuning for the selector
      */
-    explicit CompressedStateAdapter(std::unique_ptr<CompressionAlgorithm> algorithm = std::make_unique<RunLengthEncoding>());
+    explicit CompressedStateAdapter(std::unique_ptr<CompressionAlgorithm> algorithm = std::make_unique<RunLengthEncoding>(),
+                                    const CompressionSelectorConfig& selector_config = CompressionSelectorConfig());
 
     std::vector<uint8_t> encode(const void* data, size_t size, DataFormat format) override;
+
+    /**
+     * @brief Encodes a message of the given type; the selector caches its choice per type
+     */
+    std::vector<uint8_t> encode(const void* data, size_t size, DataFormat format, const std::string& message_type);
+
     std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) override;
     bool isValidFormat(const void* data, size_t size, DataFormat format) const override;
     TranscodingMetadata getMetadata(const std::vector<uint8_t>& encoded_data) const override;
 
+    /**
+     * @brief The selector used without a configured algorithm, e.g. to update its link bandwidth
+     */
+    CompressionSelector& selector() { return selector_; }
+
+    /**
+     * @brief A state encoded for one peer by encodeDelta()
+     */
+    struct DeltaFrame {
+        std::vector<uint8_t> data;
+        uint32_t version;   // Pass to acknowledgeDelta() once the peer has decoded it
+        bool snapshot;      // Carries the whole state rather than a diff
+    };
+
+    /**
+     * @brief A state rebuilt by decodeDelta()
+     */
+    struct DecodedState {
+        std::vector<uint8_t> state;
+        uint32_t version;   // What the peer is to acknowledge
+    };
+
+    /**
+     * @brief Encodes a state as the changes since the last one the peer acknowledged
+     *
+     * Bytes that differ from the baseline are sent as runs XORed against it,
+     * and the runs are compressed like any other payload. A peer with no
+     * acknowledged baseline, or a diff no smaller than the state, gets a full
+     * snapshot. The states sent since the baseline are kept until one is
+     * acknowledged, so acknowledgments may lag several sends behind.
+     *
+     * Frames of this mode are decoded with decodeDelta(), not decode().
+     */
+    DeltaFrame encodeDelta(const std::string& peer, const void* data, size_t size,
+                           const std::string& message_type = std::string());
+
+    /**
+     * @brief Makes a sent state the peer's baseline; stale or unknown versions are ignored
+     */
+    void acknowledgeDelta(const std::string& peer, uint32_t version);
+
+    /**
+     * @brief Rebuilds the state a peer encoded with encodeDelta()
+     *
+     * Decoded states are kept until the peer's later frames show they are no
+     * longer needed as a baseline.
+     *
+     * @throws CompressionError with BASELINE_MISSING if the diff's baseline is
+     *         not held, e.g. after a restart; have the sender forgetPeer() and
+     *         resend, which starts again from a snapshot
+     */
+    DecodedState decodeDelta(const std::string& peer, const std::vector<uint8_t>& frame);
+
+    /**
+     * @brief Drops every state kept for the peer, sent or decoded
+     */
+    void forgetPeer(const std::string& peer);
+
 private:
     static constexpr uint8_t MAGIC_HEADER[4] = {'C', 'M', 'P', 'R'};
+    static constexpr uint8_t ALGORITHM_NONE = 0x00;
     static constexpr uint8_t ALGORITHM_RLE = 0x01;
     static constexpr uint8_t ALGORITHM_DELTA = 0x02;
+    static constexpr uint8_t ALGORITHM_LZ4 = 0x03;
+    static constexpr uint8_t ALGORITHM_ZSTD = 0x04;
+    static constexpr uint8_t ALGORITHM_PACKED_DELTA = 0x05;
+    static constexpr uint8_t DELTA_MAGIC[4] = {'C', 'M', 'P', 'D'};
+    static constexpr size_t MAX_DELTA_HISTORY = 8;  // States kept per peer beyond the baseline
 
     std::unique_ptr<CompressionAlgorithm> compression_algorithm_;
+    CompressionSelector selector_;
     
     // Header structure for compressed data
     struct CompressedHeader {
         uint8_t magic[4];           // "CMPR"
-        uint8_t algorithm_id;       // 0x01=RLE, 0x02=Delta
+        uint8_t algorithm_id;       // 0x00=None, 0x01=RLE, 0x02=Delta, 0x03=LZ4, 0x04=Zstd, 0x05=Packed delta
         uint32_t original_size;     // Size of uncompressed data
         uint32_t checksum;          // Checksum of original data
         uint16_t metadata_length;   // Length of JSON metadata
@@ -44,11 +122,37 @@ private:
         // - Compressed payload
     };
 
+    // Header of an encodeDelta() frame, followed by a CMPR payload holding the diff or snapshot
+    struct DeltaHeader {
+        uint8_t magic[4];           // "CMPD"
+        uint32_t base_version;      // State the diff applies to; 0 for a snapshot
+        uint32_t version;
+        uint32_t state_size;        // Size of the rebuilt state
+        uint32_t state_checksum;    // Checksum of the rebuilt state
+    };
+
+    using VersionedStates = std::deque<std::pair<uint32_t, std::vector<uint8_t>>>;  // Oldest first
+
+    struct SentStates {
+        uint32_t next_version = 1;   // Not reset by forgetPeer(), so a peer never sees a version twice
+        uint32_t baseline_version = 0;
+        std::vector<uint8_t> baseline;
+        VersionedStates unacknowledged;
+    };
+
+    static std::vector<uint8_t> diffStates(const std::vector<uint8_t>& base, const std::vector<uint8_t>& state);
+    static std::vector<uint8_t> applyDiff(const std::vector<uint8_t>& base, const std::vector<uint8_t>& diff,
+                                          size_t state_size);
+
+    std::mutex delta_mutex_;  // Guards both maps
+    std::unordered_map<std::string, SentStates> sent_states_;
+    std::unordered_map<std::string, VersionedStates> received_states_;
+
     // Helper methods
-    std::vector<uint8_t> createHeader(const std::vector<uint8_t>& original_data, float compression_ratio) const;
+    std::vector<uint8_t> createHeader(const std::vector<uint8_t>& original_data, const CompressionAlgorithm& algorithm,
+                                      float compression_ratio) const;
     CompressedHeader parseHeader(const std::vector<uint8_t>& data, size_t& header_size) const;
-    std::string createMetadataJson(float compression_ratio) const;
-    std::shared_ptr<CompressionAlgorithm> selectBestAlgorithm(const std::vector<uint8_t>& data) const;
+    std::string createMetadataJson(const CompressionAlgorithm& algorithm, float compression_ratio) const;
     uint8_t getAlgorithmId(const CompressionAlgorithm& algorithm) const;
     std::unique_ptr<CompressionAlgorithm> createAlgorithm(uint8_t algorithm_id) const;
 };
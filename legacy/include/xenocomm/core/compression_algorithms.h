@@ -3,8 +3,10 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <cstddef>
 #include <stdexcept>
 #include <string>
+#include "xenocomm/utils/crc32.hpp"
 
 namespace xenocomm {
 namespace core {
@@ -17,7 +19,8 @@ enum class CompressionErrorCode : uint8_t {
     CHECKSUM_MISMATCH = 0x02,
     UNSUPPORTED_ALGORITHM = 0x03,
     DECOMPRESSION_FAILURE = 0x04,
-    BUFFER_OVERFLOW = 0x05
+    BUFFER_OVERFLOW = 0x05,
+    BASELINE_MISSING = 0x06   // A delta refers to a state the decoder does not hold
 };
 
 /**
@@ -80,21 +83,33 @@ public:
     /**
      * @brief Calculate checksum for data integrity validation
      * @param data Data to calculate checksum for
-     * @return 32-bit checksum
+     * @return 32-bit CRC32 (IEEE) of the data
      */
     static uint32_t calculateChecksum(const std::vector<uint8_t>& data) {
-        uint32_t checksum = 0;
-        for (uint8_t byte : data) {
-            checksum = (checksum << 1) | (checksum >> 31); // Rotate left
-            checksum ^= byte;
-        }
-        return checksum;
+        return utils::crc32(data.data(), data.size());
+    }
+};
+
+/**
+ * @brief Pass-through "compression" that stores data unchanged
+ * Chosen when the link is fast enough that compressing would cost more time
+ * than the bytes it saves.
+ */
+class NoCompression : public CompressionAlgorithm {
+public:
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override { return data; }
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& compressed_data) override { return compressed_data; }
+    bool isSuitableFor(const std::vector<uint8_t>&) const override { return true; }
+    std::string getAlgorithmId() const override { return "NONE"; }
+    std::unique_ptr<CompressionAlgorithm> clone() const override {
+        return std::make_unique<NoCompression>(*this);
     }
 };
 
 /**
  * @brief Run-Length Encoding compression algorithm
- * Efficient for data with repeated values
+ * Efficient for data with repeated values. Output is (count, value) byte
+ * pairs with runs split at 255; run boundaries are found 16 bytes at a time.
  */
 class RunLengthEncoding : public CompressionAlgorithm {
 public:
@@ -122,5 +137,173 @@ public:
     }
 };
 
+/**
+ * @brief Delta coding of 16, 32 or 64-bit elements with bit-packed residuals
+ *
+ * The input is read as little-endian integers of the chosen width (float
+ * telemetry by its bit patterns, which change slowly when the values do).
+ * Each element is replaced by its difference from the previous one, or with
+ * DELTA_OF_DELTA by the change in that difference, which is zero for values
+ * moving at a steady rate. Residuals are zigzag-coded and packed in blocks of
+ * BLOCK_SIZE at the bit width of the largest in the block. Trailing bytes
+ * that do not fill an element are stored as they are.
+ *
+ * The width and order are recorded in the compressed form, so any instance
+ * decompresses any other's output.
+ */
+class PackedDeltaEncoding : public CompressionAlgorithm {
+public:
+    static constexpr size_t BLOCK_SIZE = 128;
+
+    enum class Order : uint8_t {
+        DELTA = 1,           ///< Differences between consecutive elements
+        DELTA_OF_DELTA = 2   ///< Differences between consecutive differences
+    };
+
+    /**
+     * @param element_width Bytes per element: 2, 4 or 8
+     * @throws CompressionError if element_width is not one of those
+     */
+    explicit PackedDeltaEncoding(size_t element_width = 4, Order order = Order::DELTA);
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override;
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& compressed_data) override;
+    bool isSuitableFor(const std::vector<uint8_t>& data) const override;
+    std::string getAlgorithmId() const override { return "PACKED_DELTA"; }
+    std::unique_ptr<CompressionAlgorithm> clone() const override {
+        return std::make_unique<PackedDeltaEncoding>(*this);
+    }
+
+    size_t elementWidth() const { return element_width_; }
+    Order order() const { return order_; }
+
+private:
+    size_t element_width_;
+    Order order_;
+};
+
+/**
+ * @brief LZ4 block compression, the fast general-purpose path
+ *
+ * The compressed form is the original size as a 32-bit integer followed by
+ * one LZ4 block. Only available when the library is built with LZ4; otherwise
+ * compress() and decompress() throw UNSUPPORTED_ALGORITHM.
+ */
+class LZ4Compression : public CompressionAlgorithm {
+public:
+    /**
+     * @param acceleration Trades ratio for speed; 1 is LZ4's default, larger is faster
+     */
+    explicit LZ4Compression(int acceleration = 1);
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override;
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& compressed_data) override;
+    bool isSuitableFor(const std::vector<uint8_t>& data) const override;
+    std::string getAlgorithmId() const override { return "LZ4"; }
+    std::unique_ptr<CompressionAlgorithm> clone() const override {
+        return std::make_unique<LZ4Compression>(*this);
+    }
+
+    static bool isAvailable();
+
+private:
+    int acceleration_;
+};
+
+/**
+ * @brief A Zstandard dictionary, shared by every ZstdCompression using it
+ *
+ * Dictionaries trained on samples of a message schema let small messages of
+ * that schema compress several times better than they do alone. Both peers
+ * need the same dictionary; frames record its ID and decompression refuses a
+ * frame made with a different one. Digested forms are built once and reused.
+ */
+class ZstdDictionary {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    /**
+     * @param content A trained dictionary, or raw content to use as a prefix
+     * @throws CompressionError if Zstandard support is not built in
+     */
+    explicit ZstdDictionary(std::vector<uint8_t> content);
+    ~ZstdDictionary();
+
+    ZstdDictionary(const ZstdDictionary&) = delete;
+    ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+    /**
+     * @brief Trains a dictionary of at most capacity bytes on representative messages
+     *
+     * @throws CompressionError if there are too few samples to train on
+     */
+    static std::shared_ptr<const ZstdDictionary> train(const std::vector<std::vector<uint8_t>>& samples,
+                                                       size_t capacity = DEFAULT_CAPACITY);
+
+    /// Dictionary ID recorded in frames, or 0 for raw content
+    uint32_t id() const { return id_; }
+    const std::vector<uint8_t>& content() const { return content_; }
+
+private:
+    friend class ZstdCompression;
+    struct Digested;  // Compression dictionaries per level and the decompression dictionary
+
+    std::vector<uint8_t> content_;
+    uint32_t id_ = 0;
+    std::unique_ptr<Digested> digested_;
+};
+
+/**
+ * @brief Zstandard compression with a configurable level and optional dictionary
+ *
+ * The compressed form is a standard Zstandard frame carrying the original
+ * size. Compression and decompression contexts are kept per instance and
+ * reused, so an instance must not be used from several threads at once;
+ * clone() one per thread instead. Only available when the library is built
+ * with Zstandard; otherwise compress() and decompress() throw UNSUPPORTED_ALGORITHM.
+ */
+class ZstdCompression : public CompressionAlgorithm {
+public:
+    static constexpr int DEFAULT_LEVEL = 3;
+
+    /**
+     * @param level Compression level, clamped to the range the library supports
+     * @param dictionary Dictionary to compress with and expect in frames, or nullptr
+     */
+    explicit ZstdCompression(int level = DEFAULT_LEVEL, std::shared_ptr<const ZstdDictionary> dictionary = nullptr);
+    ~ZstdCompression() override;
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& data) override;
+    std::vector<uint8_t> decompress(const std::vector<uint8_t>& compressed_data) override;
+    bool isSuitableFor(const std::vector<uint8_t>& data) const override;
+    std::string getAlgorithmId() const override { return "ZSTD"; }
+    std::unique_ptr<CompressionAlgorithm> clone() const override {
+        return std::make_unique<ZstdCompression>(level_, dictionary_);
+    }
+
+    int level() const { return level_; }
+    const std::shared_ptr<const ZstdDictionary>& dictionary() const { return dictionary_; }
+
+    static bool isAvailable();
+
+private:
+    struct Contexts;
+
+    int level_;
+    std::shared_ptr<const ZstdDictionary> dictionary_;
+    std::unique_ptr<Contexts> contexts_;
+};
+
+/**
+ * @brief Creates the algorithm with the given getAlgorithmId()
+ *
+ * The IDs match the names of NegotiationProtocol's CompressionAlgorithm
+ * values, see compressionAlgorithmId(), so a negotiated choice maps straight
+ * to an implementation.
+ *
+ * @return The algorithm, or nullptr if the ID is unknown or its library is not built in
+ */
+std::unique_ptr<CompressionAlgorithm> createCompressionAlgorithm(const std::string& algorithm_id);
+
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "xenocomm/core/compression_algorithms.h"
+#include "xenocomm/utils/byte_span.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Deflate compression whose history window carries over from message to message
+ *
+ * Small messages that resemble the ones before them compress to a fraction
+ * of what they would alone, because each is matched against the last 32 KiB
+ * the connection carried. The price is that messages must be decompressed in
+ * the order they were compressed, every one of them: each frame records the
+ * history's epoch and its sequence in it, and the decompressor refuses a
+ * frame that does not follow on. Losing sync costs a restart, at which the
+ * compressor opens a new epoch with a frame the decompressor resets on.
+ *
+ * One instance serves one connection in both directions; the two halves
+ * are independent and each is safe to use from several threads.
+ */
+class CompressionContext {
+public:
+    static constexpr int DEFAULT_LEVEL = 6;
+    static constexpr size_t HEADER_SIZE = 9;  // Flags byte, then epoch and sequence, 32-bit little-endian
+    static constexpr size_t DEFAULT_MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * @param level zlib compression level, 1 (fast) to 9 (small)
+     * @param max_message_size Largest message decompress() produces, so a corrupt or hostile frame cannot exhaust memory
+     */
+    explicit CompressionContext(int level = DEFAULT_LEVEL, size_t max_message_size = DEFAULT_MAX_MESSAGE_SIZE);
+    ~CompressionContext();
+
+    CompressionContext(const CompressionContext&) = delete;
+    CompressionContext& operator=(const CompressionContext&) = delete;
+
+    /**
+     * @brief Compresses a message against the history and adds it to the history
+     *
+     * @param standalone Compress without the history and leave it untouched, for a
+     *        message that may be decompressed out of turn
+     */
+    std::vector<uint8_t> compress(utils::ByteSpan message, bool standalone = false);
+
+    /**
+     * @brief Decompresses the frame compress() made of a message
+     *
+     * A frame that arrives ahead of its predecessor, as happens when two
+     * threads receive back to back, waits up to wait_for_gap for it.
+     *
+     * @throws CompressionError with DECOMPRESSION_FAILURE if the frame does not
+     *         follow on from the last one, or from a frame that opens an epoch;
+     *         later frames of the epoch fail the same way
+     */
+    std::vector<uint8_t> decompress(utils::ByteSpan frame,
+                                    std::chrono::milliseconds wait_for_gap = std::chrono::milliseconds(100));
+
+    /**
+     * @brief Starts a new epoch with the next compress(), optionally at another level
+     */
+    void resetCompressor();
+    void resetCompressor(int level);
+
+    /**
+     * @brief Forgets the history; decompress() fails until a frame opens a new epoch
+     */
+    void resetDecompressor();
+
+    uint32_t compressorEpoch() const;
+
+    /**
+     * @return Epoch a frame belongs to, or 0 if it is too short to be one
+     */
+    static uint32_t frameEpoch(utils::ByteSpan frame);
+
+private:
+    struct Deflater;
+    struct Inflater;
+
+    size_t max_message_size_;
+
+    mutable std::mutex compress_mutex_;  // Guards the deflater, its epoch and sequence
+    std::unique_ptr<Deflater> deflater_;
+    int level_;
+    uint32_t epoch_ = 0;         // Epoch of the last frame; 0 before the first
+    uint32_t sequence_ = 0;      // Of the next frame in the epoch
+    bool reset_pending_ = true;  // The next frame opens an epoch
+
+    std::mutex decompress_mutex_;         // Guards the inflater and what it expects next
+    std::condition_variable decompress_cv_;  // Signals each frame taken, for those waiting their turn
+    std::unique_ptr<Inflater> inflater_;
+    bool synced_ = false;
+    uint32_t expected_epoch_ = 0;
+    uint32_t expected_sequence_ = 0;
+};
+
+} // namespace core
+} // namespace xenocomm
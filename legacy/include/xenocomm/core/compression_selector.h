@@ -0,0 +1,148 @@
+#pragma once
+
+#include "xenocomm/core/compression_algorithms.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Structure of a payload, measured in one pass over a sample of it
+ */
+struct PayloadProfile {
+    size_t size = 0;                 ///< Size of the whole payload
+    size_t sampled = 0;              ///< Bytes the measurements below cover
+    double entropy = 8.0;            ///< Order-0 entropy of the sample, bits per byte
+    double run_fraction = 0.0;       ///< Fraction of bytes equal to the byte before them
+    double match_fraction = 0.0;     ///< Fraction of 4-byte sequences seen earlier in the sample
+    double packed_delta_ratio = 1.0; ///< Packed size of 32-bit deltas over sampled size
+    double packed_delta_of_delta_ratio = 1.0;  ///< Same for deltas of deltas
+};
+
+/**
+ * @brief Profiles up to sample_bytes of data, taken from evenly spaced windows
+ */
+PayloadProfile profilePayload(const uint8_t* data, size_t size, size_t sample_bytes);
+
+/**
+ * @brief Tuning for CompressionSelector
+ */
+struct CompressionSelectorConfig {
+    double link_bandwidth = 1.25e6;      ///< Bytes per second the compressed payload is sent at
+    size_t sample_bytes = 4096;          ///< Bytes of each payload profiled
+    size_t cache_capacity = 256;         ///< Message types whose choice is remembered
+    uint32_t revalidate_interval = 64;   ///< Messages of a type between fresh profiles
+    double learning_rate = 0.25;         ///< Weight of each observation in the learned model
+    bool count_decompression = true;     ///< Include the receiver's decompression time in the cost
+};
+
+/**
+ * @brief An algorithm and setting chosen for a payload
+ */
+struct CompressionChoice {
+    std::string algorithm_id = "NONE";  ///< "NONE", "RLE", "PACKED_DELTA", "LZ4" or "ZSTD"
+    int level = 0;                      ///< Zstd level; the delta order for PACKED_DELTA
+    double predicted_ratio = 1.0;       ///< Expected compressed size over original size
+    double predicted_seconds = 0.0;     ///< Expected compression, transfer and decompression time
+};
+
+/**
+ * @brief Picks the compression algorithm that gets a payload across fastest
+ *
+ * Each candidate's cost is the time to compress, send the predicted output
+ * over the link and decompress it. Output size is predicted from a profile
+ * of a few KB of the payload and speeds start from typical figures, so on a
+ * fast link storing data uncompressed wins and slower links justify higher
+ * Zstd levels. Both parts are learned from what actual compressions report
+ * back through observe(): speeds per algorithm, and per message type a
+ * correction to each predicted ratio.
+ *
+ * The choice for a message type is cached and re-made after
+ * revalidate_interval messages, when the payload size moves by more than
+ * half, or when the link bandwidth changes. Each re-made choice also
+ * trial-compresses the sample with the runner-up, so its prediction is
+ * corrected too. Thread-safe.
+ */
+class CompressionSelector {
+public:
+    struct Stats {
+        uint64_t selections = 0;
+        uint64_t cache_hits = 0;
+        uint64_t profiles = 0;
+        size_t cached_types = 0;
+    };
+
+    explicit CompressionSelector(const CompressionSelectorConfig& config = CompressionSelectorConfig());
+
+    /**
+     * @brief Chooses how to compress data, a message of the given type
+     */
+    CompressionChoice select(const std::vector<uint8_t>& data, const std::string& message_type = "");
+
+    /**
+     * @brief Creates the algorithm a choice names
+     */
+    static std::unique_ptr<CompressionAlgorithm> createAlgorithm(const CompressionChoice& choice);
+
+    /**
+     * @brief Reports how compressing a message as chosen actually went
+     *
+     * @param elapsed Time compress() took
+     */
+    void observe(const std::string& message_type, const CompressionChoice& choice,
+                 size_t input_size, size_t output_size, std::chrono::nanoseconds elapsed);
+
+    /**
+     * @brief Updates the link bandwidth, e.g. from congestion control, re-making cached choices
+     *
+     * Changes of less than a tenth are ignored.
+     */
+    void setLinkBandwidth(double bytes_per_second);
+    double linkBandwidth() const;
+
+    Stats getStats() const;
+
+private:
+    struct Codec {
+        std::string algorithm_id;
+        int level;
+        double compress_rate;    // Bytes per second, learned
+        double decompress_rate;  // Bytes per second
+        size_t overhead;         // Fixed bytes of framing
+    };
+
+    struct TypeEntry {
+        std::list<std::string>::iterator order;
+        size_t choice = 0;                 // Index into codecs_
+        size_t profiled_size = 0;
+        uint32_t uses = 0;                 // Selections since the last profile
+        std::vector<double> base_ratio;    // Per codec, predicted from the last profile
+        std::vector<double> correction;    // Per codec, learned observed / predicted ratio
+    };
+
+    double baseRatio(const Codec& codec, const PayloadProfile& profile) const;
+    double cost(const Codec& codec, double ratio, size_t size) const;
+    void learnRatio(TypeEntry& entry, size_t codec, double observed_ratio) const;
+    size_t rank(const TypeEntry& entry, size_t size, size_t* runner_up) const;
+    CompressionChoice choiceFor(const TypeEntry& entry, size_t size) const;
+    size_t codecIndex(const CompressionChoice& choice) const;
+    TypeEntry& entryFor(const std::string& message_type);
+
+    CompressionSelectorConfig config_;
+    std::vector<Codec> codecs_;
+    mutable std::mutex mutex_;
+    std::list<std::string> lru_;  // Most recently selected first
+    std::unordered_map<std::string, TypeEntry> types_;
+    Stats stats_;
+};
+
+} // namespace core
+} // namespace xenocomm
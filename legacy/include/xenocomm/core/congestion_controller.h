@@ -0,0 +1,272 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Congestion control algorithms available to TransmissionManager.
+ */
+enum class CongestionControlAlgorithm {
+    AIMD,   ///< Original RTT-threshold scheme: multiplicative increase, then additive; multiplicative backoff
+    CUBIC,  ///< Loss-based window growing as a cubic function of time since the last reduction (RFC 8312)
+    BBR     ///< Model-based window sized to the measured bandwidth-delay product
+};
+
+/**
+ * @brief Tuning shared by all congestion controllers.
+ *
+ * Window sizes are in bytes; segment_size is the fragment payload size used to
+ * convert between bytes and segments.
+ */
+struct CongestionControlConfig {
+    CongestionControlAlgorithm algorithm = CongestionControlAlgorithm::AIMD;
+    uint32_t initial_window = 65535;
+    uint32_t min_window = 1024;
+    uint32_t max_window = 1048576;
+    uint32_t segment_size = 1024;
+
+    // AIMD
+    uint32_t congestion_threshold = 100;  ///< Smoothed RTT increase over min RTT (percent) treated as congestion
+    uint32_t backoff_multiplier = 2;      ///< Window divisor on congestion
+    uint32_t recovery_multiplier = 2;     ///< Window multiplier before the first congestion event
+
+    // CUBIC
+    double cubic_c = 0.4;                 ///< Cubic scaling constant, in segments per second cubed
+    double cubic_beta = 0.7;              ///< Window retained after a loss event
+
+    // BBR
+    uint32_t bbr_bandwidth_window_rounds = 10;  ///< Round trips the max-bandwidth filter remembers
+    uint32_t bbr_min_rtt_window_ms = 10000;     ///< How long a min RTT sample stays valid before PROBE_RTT
+};
+
+/**
+ * @brief Interface for congestion window controllers.
+ *
+ * TransmissionManager reports every acknowledgment and every detected loss;
+ * the controller answers with the congestion window to enforce. Callers
+ * serialize access, so implementations need not be thread-safe.
+ */
+class ICongestionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~ICongestionController() = default;
+
+    /**
+     * @brief Reports newly acknowledged data.
+     *
+     * @param bytes_acked Payload bytes covered by the acknowledgment
+     * @param rtt Round-trip sample, or zero when the fragment was retransmitted (Karn's algorithm)
+     * @param bytes_in_flight Unacknowledged bytes after this acknowledgment
+     * @param now Time the acknowledgment was processed
+     */
+    virtual void onAck(uint32_t bytes_acked, std::chrono::microseconds rtt,
+                       uint32_t bytes_in_flight, Clock::time_point now) = 0;
+
+    /**
+     * @brief Reports a fragment declared lost (timeout or SACK hole).
+     *
+     * @param bytes_lost Payload bytes of the lost fragment
+     * @param now Time the loss was detected
+     */
+    virtual void onLoss(uint32_t bytes_lost, Clock::time_point now) = 0;
+
+    /**
+     * @brief Returns the congestion window in bytes.
+     */
+    virtual uint32_t congestionWindow() const = 0;
+
+    /**
+     * @brief Returns the rate to pace transmissions at, in bytes per second.
+     *
+     * Zero leaves the choice to the caller, which spreads the window over
+     * the smoothed RTT; controllers with a model of the path override this.
+     */
+    virtual double pacingRate() const { return 0; }
+
+    /**
+     * @brief Returns the controller to its initial state.
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Gets the name of the congestion control algorithm.
+     */
+    virtual std::string name() const = 0;
+};
+
+/**
+ * @brief The original TransmissionManager scheme, reacting to RTT inflation.
+ *
+ * Grows the window multiplicatively until the first congestion signal and
+ * additively afterwards, dividing it on congestion or loss. Adjustments are
+ * made at most once per smoothed RTT.
+ */
+class AimdCongestionController : public ICongestionController {
+public:
+    explicit AimdCongestionController(const CongestionControlConfig& config);
+
+    void onAck(uint32_t bytes_acked, std::chrono::microseconds rtt,
+               uint32_t bytes_in_flight, Clock::time_point now) override;
+    void onLoss(uint32_t bytes_lost, Clock::time_point now) override;
+    uint32_t congestionWindow() const override { return cwnd_; }
+    void reset() override;
+    std::string name() const override { return "AIMD"; }
+
+private:
+    void backoff(Clock::time_point now);
+
+    CongestionControlConfig config_;
+    uint32_t cwnd_;
+    bool in_congestion_avoidance_ = false;
+    double srtt_us_ = 0;
+    double min_rtt_us_ = 0;
+    Clock::time_point last_adjustment_{};
+};
+
+/**
+ * @brief CUBIC congestion control (RFC 8312).
+ *
+ * Loss-based: RTT variation alone never shrinks the window, and all losses
+ * within one RTT of a reduction count as a single congestion event.
+ */
+class CubicCongestionController : public ICongestionController {
+public:
+    explicit CubicCongestionController(const CongestionControlConfig& config);
+
+    void onAck(uint32_t bytes_acked, std::chrono::microseconds rtt,
+               uint32_t bytes_in_flight, Clock::time_point now) override;
+    void onLoss(uint32_t bytes_lost, Clock::time_point now) override;
+    uint32_t congestionWindow() const override;
+    void reset() override;
+    std::string name() const override { return "CUBIC"; }
+
+private:
+    CongestionControlConfig config_;
+    double cwnd_;                 // Segments
+    double ssthresh_;             // Segments
+    double w_max_ = 0;            // Window before the last reduction, in segments
+    double k_ = 0;                // Seconds until the cubic curve returns to w_max_
+    bool epoch_started_ = false;
+    Clock::time_point epoch_start_{};
+    Clock::time_point last_reduction_{};
+    bool reduced_once_ = false;
+    double srtt_s_ = 0;
+    double min_rtt_s_ = 0;
+};
+
+/**
+ * @brief BBR-style model-based congestion control.
+ *
+ * Tracks the windowed maximum delivery rate and minimum RTT and sizes the
+ * window to a gain times their product, cycling the gain to probe for more
+ * bandwidth. Isolated losses and RTT spikes do not shrink the window.
+ */
+class BbrCongestionController : public ICongestionController {
+public:
+    explicit BbrCongestionController(const CongestionControlConfig& config);
+
+    void onAck(uint32_t bytes_acked, std::chrono::microseconds rtt,
+               uint32_t bytes_in_flight, Clock::time_point now) override;
+    void onLoss(uint32_t bytes_lost, Clock::time_point now) override;
+    uint32_t congestionWindow() const override;
+    double pacingRate() const override;
+    void reset() override;
+    std::string name() const override { return "BBR"; }
+
+    enum class Mode { STARTUP, DRAIN, PROBE_BW, PROBE_RTT };
+    Mode mode() const { return mode_; }
+    double bottleneckBandwidth() const;  ///< Bytes per second
+    std::chrono::microseconds minRtt() const { return min_rtt_; }
+
+private:
+    struct BandwidthSample {
+        uint64_t round;
+        double bytes_per_second;
+    };
+
+    void endRound(Clock::time_point now);
+    void updateMode(uint32_t bytes_in_flight, Clock::time_point now);
+    uint32_t bdp(double gain) const;
+
+    CongestionControlConfig config_;
+    Mode mode_ = Mode::STARTUP;
+    double cwnd_ = 0;  // Bytes
+
+    // Round-trip accounting: a round ends once min RTT has elapsed since it began
+    uint64_t round_ = 0;
+    Clock::time_point round_start_{};
+    uint64_t round_delivered_ = 0;
+    bool started_ = false;
+
+    std::deque<BandwidthSample> bandwidth_samples_;  // Monotonic max filter over recent rounds
+    std::chrono::microseconds min_rtt_{0};
+    Clock::time_point min_rtt_stamp_{};
+
+    // STARTUP exit: bandwidth stopped growing 25% for three rounds
+    double full_bandwidth_ = 0;
+    uint32_t full_bandwidth_rounds_ = 0;
+
+    size_t cycle_index_ = 0;
+    Clock::time_point probe_rtt_done_{};
+};
+
+/**
+ * @brief Token bucket that spreads transmissions out at a target rate.
+ *
+ * The bucket fills at the rate up to burst bytes; a transmission may go once
+ * the bucket holds its size. Sends that bypass the check, retransmissions
+ * for instance, still consume tokens and may drive the bucket into debt,
+ * which later sends then wait out. A rate of zero turns pacing off. Callers
+ * serialize access.
+ */
+class TokenBucketPacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Sets the rate in bytes per second and the largest burst in bytes.
+     *
+     * Tokens already earned are kept, up to the new burst.
+     */
+    void setRate(double bytes_per_second, uint32_t burst_bytes, Clock::time_point now);
+
+    double rate() const { return rate_; }
+
+    /**
+     * @brief Returns how long a transmission of bytes must wait, zero if it may go now.
+     */
+    Clock::duration delay(uint32_t bytes, Clock::time_point now);
+
+    /**
+     * @brief Takes bytes out of the bucket for a transmission made at now.
+     */
+    void consume(uint32_t bytes, Clock::time_point now);
+
+    void reset();
+
+private:
+    void refill(Clock::time_point now);
+
+    double rate_ = 0;
+    double burst_ = 0;
+    double tokens_ = 0;
+    Clock::time_point last_refill_{};
+};
+
+/**
+ * @brief Factory for creating congestion controllers.
+ */
+class CongestionControllerFactory {
+public:
+    static std::unique_ptr<ICongestionController> create(const CongestionControlConfig& config);
+};
+
+} // namespace core
+} // namespace xenocomm
@@ -1,16 +1,34 @@
 #ifndef XENOCOMM_CORE_CONNECTION_MANAGER_HPP
 #define XENOCOMM_CORE_CONNECTION_MANAGER_HPP
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "xenocomm/core/stream_multiplexer.hpp"
 #include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
 
 namespace xenocomm {
 namespace core {
 
+/**
+ * @brief Thrown when a connection cannot be established or is not found
+ */
+class ConnectionError : public std::runtime_error {
+public:
+    explicit ConnectionError(const std::string& message) : std::runtime_error(message) {}
+};
+
 /**
  * @brief Status of a network connection
  */
@@ -23,35 +41,69 @@ enum class ConnectionStatus {
 
 /**
  * @brief Represents a network connection with its associated metadata
+ *
+ * A connection established with a transport owns it; its status then follows
+ * the transport's state.
  */
 class Connection {
 public:
     using ConnectionId = std::string;
-    
-    Connection(ConnectionId id, const ConnectionConfig& config = ConnectionConfig{})
-        : id_(std::move(id)), config_(config) {}
-    
+    /// Integer stand-in for the ID, assigned by the ConnectionManager; never reused for another connection
+    using Handle = uint64_t;
+    static constexpr Handle INVALID_HANDLE = 0;
+
+    Connection(ConnectionId id, const ConnectionConfig& config = ConnectionConfig{},
+               std::shared_ptr<TransportProtocol> transport = nullptr)
+        : id_(std::move(id)), config_(config), transport_(std::move(transport)) {}
+
     const ConnectionId& getId() const { return id_; }
-    ConnectionStatus getStatus() const { return status_; }
+    Handle getHandle() const { return handle_; }
+    ConnectionStatus getStatus() const;
     const ConnectionConfig& getConfig() const { return config_; }
-    
+
+    /**
+     * @brief The transport carrying this connection's data, or nullptr for metadata only
+     */
+    const std::shared_ptr<TransportProtocol>& getTransport() const { return transport_; }
+
 protected:
+    friend class ConnectionManager;
+
     ConnectionId id_;
+    Handle handle_ = INVALID_HANDLE;
     ConnectionStatus status_{ConnectionStatus::Disconnected};
     ConnectionConfig config_;
+    std::shared_ptr<TransportProtocol> transport_;
 };
 
 /**
  * @brief Core connection management functionality for establishing and managing network connections
+ *
+ * Connections established with a transport (TCPTransport, UDPTransport or a
+ * SecureTransportWrapper around either) carry data: sendv() and receiveBuffer()
+ * run straight on the connection's transport, and TransmissionManager::bind_connection()
+ * attaches a TransmissionManager to one.
+ *
+ * All methods are thread-safe. IDs are spread over independently locked
+ * shards, so establishing and closing connections rarely contend. Each
+ * connection also gets a Handle, and the handle overloads of getConnection(),
+ * sendv() and receiveBuffer() take no lock at all, which makes them the ones to
+ * use on a per-message path. forEachActiveConnection() walks the connections
+ * in place rather than copying them out.
+ *
+ * A reliable connection can also be multiplexed, after which openStream() and
+ * acceptStream() add connections whose transport is one stream of it. Each
+ * stream connection gets its own flow control and a fair share of the link, so
+ * a bulk transfer on one does not hold up the others.
  */
 class ConnectionManager {
 public:
     using ConnectionPtr = std::shared_ptr<Connection>;
     using ConnectionMap = std::unordered_map<Connection::ConnectionId, ConnectionPtr>;
-    
+
     ConnectionManager();
-    virtual ~ConnectionManager() = default;
-    
+    virtual ~ConnectionManager();
+
     /**
      * @brief Establish a new connection with the given ID and configuration
      * @param connectionId Unique identifier for the connection
@@ -61,14 +113,33 @@ public:
      */
     virtual ConnectionPtr establish(const Connection::ConnectionId& connectionId,
                                  const ConnectionConfig& config = ConnectionConfig{});
-    
+
+    /**
+     * @brief Establish a connection carried by the given transport
+     *
+     * The transport is connected to endpoint unless it is connected already,
+     * binding config.localPort first if one is set. The manager owns it from then
+     * on, and disconnects it when the connection is closed. With
+     * config.preferSharedMemory and a peer on this host, a SharedMemoryTransport
+     * carries the connection instead and the given transport is left unused.
+     * @param connectionId Unique identifier for the connection
+     * @param endpoint Remote endpoint as host:port; ignored if the transport is connected
+     * @param transport Transport to carry the connection
+     * @param config Configuration options for the connection
+     * @return Shared pointer to the established connection
+     * @throws ConnectionError if the ID is taken or the transport fails to connect
+     */
+    virtual ConnectionPtr establish(const Connection::ConnectionId& connectionId, const std::string& endpoint,
+                                    std::shared_ptr<TransportProtocol> transport,
+                                    const ConnectionConfig& config = ConnectionConfig{});
+
     /**
      * @brief Close an existing connection
      * @param connectionId ID of the connection to close
      * @return true if connection was closed successfully, false if not found
      */
     virtual bool close(const Connection::ConnectionId& connectionId);
-    
+
     /**
      * @brief Check the status of a connection
      * @param connectionId ID of the connection to check
@@ -76,7 +147,7 @@ public:
      * @throws ConnectionError if connection not found
      */
     virtual ConnectionStatus checkStatus(const Connection::ConnectionId& connectionId) const;
-    
+
     /**
      * @brief Get an existing connection by ID
      * @param connectionId ID of the connection to retrieve
@@ -84,18 +155,143 @@ public:
      * @throws ConnectionError if connection not found
      */
     virtual ConnectionPtr getConnection(const Connection::ConnectionId& connectionId) const;
-    
+
+    /**
+     * @brief Look a connection up by handle, without locking
+     * @return The connection, or nullptr if it has been closed or the handle is invalid
+     */
+    ConnectionPtr getConnection(Connection::Handle handle) const;
+
+    /**
+     * @brief The handle of an existing connection
+     * @throws ConnectionError if connection not found
+     */
+    Connection::Handle getHandle(const Connection::ConnectionId& connectionId) const;
+
     /**
      * @brief Get all active connections
      * @return Vector of connection pointers
      */
     virtual std::vector<ConnectionPtr> getActiveConnections() const;
-    
+
+    /**
+     * @brief Call visit for every connected connection, without copying the set
+     *
+     * No lock is held while visit runs, so it may establish or close
+     * connections; those may or may not be visited.
+     */
+    void forEachActiveConnection(const std::function<void(const ConnectionPtr&)>& visit) const;
+
+    /**
+     * @brief Number of registered connections, connected or not
+     */
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the transport carrying a connection
+     * @param connectionId ID of the connection
+     * @return The connection's transport
+     * @throws ConnectionError if the connection is not found or has no transport
+     */
+    virtual std::shared_ptr<TransportProtocol> getTransport(const Connection::ConnectionId& connectionId) const;
+
+    /**
+     * @brief Gather-write buffers to a connection as one message, without copying them
+     * @return Bytes sent, or -1 on error (including an unknown connection)
+     */
+    virtual ssize_t sendv(const Connection::ConnectionId& connectionId, const utils::ByteSpan* buffers,
+                          size_t count);
+    virtual ssize_t sendv(Connection::Handle handle, const utils::ByteSpan* buffers, size_t count);
+
+    /**
+     * @brief Receive one message from a connection into a pooled buffer
+     * @return Bytes received, 0 on orderly shutdown, or -1 on error (including an unknown connection)
+     */
+    virtual ssize_t receiveBuffer(const Connection::ConnectionId& connectionId, utils::PooledBuffer& buffer,
+                                  size_t maxSize);
+    virtual ssize_t receiveBuffer(Connection::Handle handle, utils::PooledBuffer& buffer, size_t maxSize);
+
+    /**
+     * @brief Start carrying streams over a connection
+     *
+     * Both ends must multiplex, one as Initiator and the other as Acceptor. From
+     * then on the connection's transport belongs to the multiplexer and must
+     * not be used directly; closing the connection shuts the multiplexer down.
+     * @param connectionId ID of a connection established with a reliable transport
+     * @param role This end's role
+     * @param config Multiplexer tuning
+     * @return The multiplexer
+     * @throws ConnectionError if the connection is not found, has no connected
+     *         reliable transport, or is already multiplexed
+     */
+    virtual std::shared_ptr<StreamMultiplexer> multiplex(const Connection::ConnectionId& connectionId,
+                                                         StreamMultiplexer::Role role,
+                                                         const MultiplexerConfig& config = MultiplexerConfig{});
+
+    /**
+     * @brief Open a stream on a multiplexed connection, as a connection of its own
+     * @param parentId ID of the multiplexed connection
+     * @param streamConnectionId ID for the new stream connection
+     * @return The stream connection
+     * @throws ConnectionError if the parent is not multiplexed, the ID is taken or no stream can be opened
+     */
+    virtual ConnectionPtr openStream(const Connection::ConnectionId& parentId,
+                                     const Connection::ConnectionId& streamConnectionId);
+
+    /**
+     * @brief Wait for the peer to open a stream on a multiplexed connection
+     * @param parentId ID of the multiplexed connection
+     * @param streamConnectionId ID for the accepted stream connection
+     * @param timeout How long to wait
+     * @return The stream connection, or nullptr if none arrived in time
+     * @throws ConnectionError if the parent is not multiplexed or the ID is taken
+     */
+    virtual ConnectionPtr acceptStream(const Connection::ConnectionId& parentId,
+                                       const Connection::ConnectionId& streamConnectionId,
+                                       std::chrono::milliseconds timeout);
+
 protected:
-    ConnectionMap connections_;
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t SLOTS_PER_CHUNK = 1024;
+    static constexpr size_t MAX_CHUNKS = 1024;  // Up to a million open connections
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;  // Never held across transport I/O
+        ConnectionMap connections;
+    };
+
+    // Handles index into fixed chunks of slots that are never moved or freed
+    // while the manager lives, so lookups need no lock. A handle carries its
+    // slot's generation in the high bits; reusing a slot bumps the generation,
+    // so a stale handle finds a connection with a different handle and misses.
+    struct Chunk {
+        std::array<std::shared_ptr<Connection>, SLOTS_PER_CHUNK> slots;  // std::atomic_load/store only
+        std::array<uint32_t, SLOTS_PER_CHUNK> generations{};              // Guarded by handleMutex_
+    };
+
+    Shard& shardFor(const Connection::ConnectionId& connectionId) const;
+    ConnectionPtr findConnection(const Connection::ConnectionId& connectionId) const;
+    // Register under a fresh handle; false if the ID is taken
+    bool insert(const ConnectionPtr& connection);
+    ConnectionPtr erase(const Connection::ConnectionId& connectionId);
+    std::shared_ptr<StreamMultiplexer> findMultiplexer(const Connection::ConnectionId& connectionId) const;
+    ConnectionPtr addStream(const Connection::ConnectionId& parentId, const Connection::ConnectionId& streamConnectionId,
+                            std::shared_ptr<MultiplexedStream> stream);
+    std::shared_ptr<TransportProtocol> findTransport(const Connection::ConnectionId& connectionId) const;
+
+    mutable std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> size_{0};
+
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{};
+    std::atomic<size_t> slotsInUse_{0};  // Slots below this have been handed out at least once
+    std::mutex handleMutex_;             // Guards slot allocation and generations
+    std::vector<uint32_t> freeSlots_;
+
+    mutable std::mutex multiplexerMutex_;
+    std::unordered_map<Connection::ConnectionId, std::shared_ptr<StreamMultiplexer>> multiplexers_;  // By parent
 };
 
 } // namespace core
 } // namespace xenocomm
 
-#endif // XENOCOMM_CORE_CONNECTION_MANAGER_HPP 
\ No newline at end of file
+#endif // XENOCOMM_CORE_CONNECTION_MANAGER_HPP
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "xenocomm/core/ranked_discovery.h"
+#include "xenocomm/utils/task_scheduler.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+
+class FeedbackLoop;
+
+namespace core {
+
+class TCPTransport;
+
+/**
+ * @brief How much ConnectionPrewarmer predicts and how much it may open.
+ *
+ * A peer's score is historyWeight times its share of the busiest peer's
+ * transactions in the FeedbackLoop window, plus for each recent hint its
+ * weight, fading linearly to nothing over hintTtl.
+ */
+struct PrewarmConfig {
+    size_t maxPeers = 4;                           ///< Peers warmed per pass, best predictions first
+    size_t connectionsPerPeer = 1;                 ///< Pooled connections opened to each
+    std::chrono::milliseconds interval{10000};     ///< Between scheduled passes; 0 leaves only hints and prewarmNow()
+    std::chrono::milliseconds rewarmAfter{30000};  ///< A peer warmed or failed more recently is skipped
+    std::chrono::milliseconds hintTtl{60000};      ///< How long a hint keeps counting
+    double historyWeight = 1.0;
+    double minScore = 0.05;                        ///< Predictions scoring lower are not warmed
+};
+
+/**
+ * @brief What warming a peer involves beyond pooling connections.
+ *
+ * Each step runs on a TaskScheduler worker and may block. Steps left empty
+ * are skipped.
+ */
+struct PrewarmActions {
+    /// Endpoint (host:port) for a peer, or nullopt to skip it; required
+    std::function<std::optional<std::string>(const std::string& peerId)> resolveEndpoint;
+    /// Completes a handshake ahead of time, so a session ticket is cached for resumption
+    std::function<bool(const std::string& peerId, const std::string& endpoint)> handshake;
+    /// Negotiates ahead of time, so the NegotiationCache holds the result
+    std::function<bool(const std::string& peerId)> negotiate;
+};
+
+/**
+ * @brief A peer expected to be contacted soon.
+ */
+struct PrewarmPrediction {
+    std::string peerId;
+    double score = 0;
+};
+
+/**
+ * @brief Opens connections, handshakes and negotiations to peers before
+ * they are needed.
+ *
+ * Peers are predicted from the FeedbackLoop's per-peer outcomes, with each
+ * outcome's peerId being the peer, and from hints: onDiscovery() hints each
+ * discovered agent, best ranked strongest, since a client usually contacts
+ * what it just discovered. Each pass warms the best predictions not warmed
+ * within rewarmAfter, up to maxPeers: it fills TCPTransport's pool with
+ * warmupConnections(), then runs the handshake and negotiate actions, so the
+ * first message to the peer costs no round trips for setup. Passes run on
+ * the shared TaskScheduler every interval once start()ed, and at once after
+ * a hint.
+ *
+ * Thread-safe. The transport and feedback loop must outlive this object.
+ */
+class ConnectionPrewarmer {
+public:
+    /**
+     * @brief Counts since construction.
+     */
+    struct Stats {
+        uint64_t passes = 0;
+        uint64_t peersWarmed = 0;    ///< Peers every configured step succeeded for
+        uint64_t failures = 0;       ///< Peers some step failed for
+        uint64_t handshakes = 0;     ///< Successful handshake actions
+        uint64_t negotiations = 0;   ///< Successful negotiate actions
+    };
+
+    /**
+     * @param transport Pool to fill; nullptr runs only the actions
+     */
+    ConnectionPrewarmer(TCPTransport* transport, PrewarmActions actions, const FeedbackLoop* feedback = nullptr,
+                        const PrewarmConfig& config = PrewarmConfig{});
+    ~ConnectionPrewarmer();
+
+    ConnectionPrewarmer(const ConnectionPrewarmer&) = delete;
+    ConnectionPrewarmer& operator=(const ConnectionPrewarmer&) = delete;
+
+    /**
+     * @brief Schedules passes every interval, and after hints
+     */
+    void start();
+
+    /**
+     * @brief Stops scheduling passes; returns once none is running
+     */
+    void stop();
+
+    /**
+     * @brief Hints that a peer will probably be contacted soon
+     *
+     * @param weight Added to the peer's score, fading over hintTtl
+     */
+    void hintPeer(const std::string& peerId, double weight = 1.0);
+
+    /**
+     * @brief Hints every agent of a discovery result, the first at weight 1,
+     *        the n-th (counting from 1) at 1 / n
+     */
+    void onDiscovery(const std::vector<RankedAgent>& agents);
+
+    /**
+     * @brief Forgets a peer's hints and warm state, for a peer that has gone away
+     */
+    void forgetPeer(const std::string& peerId);
+
+    /**
+     * @brief Predicted peers scoring at least minScore, best first
+     */
+    std::vector<PrewarmPrediction> predict() const;
+
+    /**
+     * @brief Runs one pass on the calling thread
+     *
+     * @return Peers warmed
+     */
+    size_t prewarmNow();
+
+    Stats stats() const;
+
+    void setConfig(const PrewarmConfig& config);
+    PrewarmConfig getConfig() const;
+
+private:
+    struct Hint {
+        double weight;
+        std::chrono::steady_clock::time_point at;
+    };
+
+    bool warm(const std::string& peerId);
+    void refreshHistory() const;  // Caller holds mutex_
+
+    TCPTransport* transport_;
+    PrewarmActions actions_;
+    const FeedbackLoop* feedback_;
+
+    mutable std::mutex mutex_;
+    PrewarmConfig config_;
+    std::unordered_map<std::string, std::vector<Hint>> hints_;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> lastWarmed_;
+    Stats stats_;
+
+    // Share of the busiest peer's transactions, rebuilt when the feedback loop's window changes
+    mutable std::unordered_map<std::string, double> history_;
+    mutable uint64_t historyGeneration_ = 0;
+    mutable bool historyLoaded_ = false;
+
+    std::mutex passMutex_;  // Serializes passes run by the scheduler and prewarmNow()
+    utils::TaskScheduler::TaskId task_ = utils::TaskScheduler::INVALID_TASK;
+};
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,73 @@
+#ifndef XENOCOMM_CORE_CRYPTO_WORKER_POOL_HPP
+#define XENOCOMM_CORE_CRYPTO_WORKER_POOL_HPP
+
+#include "xenocomm/utils/work_stealing_executor.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Seals a connection's records in parallel and hands them back in order.
+ *
+ * A caller splits a large write into records whose sequence numbers it has
+ * already assigned, then passes runOrdered() one task per record. Idle
+ * workers and the calling thread claim tasks from the front, so records are
+ * sealed on as many cores as are free, and the calling thread emits each one
+ * as soon as it and every record before it are done. Transmission of the
+ * first records therefore overlaps sealing of the later ones, and the peer
+ * still sees them in sequence order.
+ *
+ * The sealing runs on a WorkStealingExecutor, the process-wide one unless
+ * the pool is given threads of its own, so offload adds no threads per
+ * connection. One pool may serve any number of connections.
+ */
+class CryptoWorkerPool {
+public:
+    /**
+     * @param workers Number of threads of its own; 0 runs on
+     *        WorkStealingExecutor::shared().
+     */
+    explicit CryptoWorkerPool(size_t workers = 0);
+
+    CryptoWorkerPool(const CryptoWorkerPool&) = delete;
+    CryptoWorkerPool& operator=(const CryptoWorkerPool&) = delete;
+
+    /**
+     * @brief Process-wide pool for connections that do not bring their own.
+     */
+    static CryptoWorkerPool& shared();
+
+    size_t workerCount() const { return executor_->workerCount(); }
+
+    /**
+     * @brief Runs task(i) for every i below count and complete(i) in index order.
+     *
+     * Tasks run concurrently on the workers and the calling thread; complete
+     * runs only on the calling thread. The first task or completion to
+     * return false stops the run: indices after it are not completed and
+     * tasks not yet started are skipped. Returns once no worker is still
+     * inside task.
+     *
+     * @return true if every index was completed
+     */
+    bool runOrdered(size_t count, const std::function<bool(size_t)>& task,
+                    const std::function<bool(size_t)>& complete);
+
+private:
+    struct Job;
+
+    static void participate(Job& job);
+
+    std::unique_ptr<utils::WorkStealingExecutor> ownedExecutor_;
+    utils::WorkStealingExecutor* executor_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_CRYPTO_WORKER_POOL_HPP
@@ -9,6 +9,9 @@ namespace core {
 
 /**
  * @brief Adapter class for handling 32-bit floating point vector data
+ *
+ * The encoding is the input bytes unchanged, so encodeView() and
+ * decodeView() hand back the caller's buffer and no copy is needed at all.
  */
 class VectorFloat32Adapter : public DataTranscoder {
 public:
@@ -16,25 +19,131 @@ public:
     std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) override;
     bool isValidFormat(const void* data, size_t size, DataFormat format) const override;
     TranscodingMetadata getMetadata(const std::vector<uint8_t>& encoded_data) const override;
-
-private:
-    size_t vector_size_ = 0;  // Number of float32 elements
+    size_t maxEncodedSize(size_t size, DataFormat format) const override;
+    size_t maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const override;
+    size_t encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) override;
+    size_t decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) override;
+    bool isReentrant() const override { return true; }
+    std::optional<utils::ByteSpan> encodeView(utils::ByteSpan data, DataFormat format) const override;
+    std::optional<utils::ByteSpan> decodeView(utils::ByteSpan encoded_data, DataFormat source_format) const override;
 };
 
 /**
  * @brief Adapter class for handling quantized 8-bit integer vector data
+ *
+ * By default every element is quantized with one global scale factor. The
+ * per-block mode instead maps each block of elements onto the full 0-255
+ * range between that block's minimum and maximum, which keeps precision on
+ * vectors with a wide dynamic range (and keeps negative values). Each block
+ * is encoded as its offset and step (two native floats) followed by its codes.
  */
 class VectorInt8Adapter : public DataTranscoder {
 public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64;
+
     VectorInt8Adapter(float scale = 1.0f) : scale_factor_(scale) {}
 
+    /**
+     * @brief Creates an adapter that scales each block of block_size elements separately.
+     *
+     * @throws TranscodingError if block_size is 0
+     */
+    static VectorInt8Adapter perBlock(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    /**
+     * @brief Elements per scale block, or 0 in global-scale mode.
+     */
+    size_t blockSize() const { return block_size_; }
+
+    std::vector<uint8_t> encode(const void* data, size_t size, DataFormat format) override;
+    std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) override;
+    bool isValidFormat(const void* data, size_t size, DataFormat format) const override;
+    TranscodingMetadata getMetadata(const std::vector<uint8_t>& encoded_data) const override;
+    size_t maxEncodedSize(size_t size, DataFormat format) const override;
+    size_t maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const override;
+    size_t encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) override;
+    size_t decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) override;
+    bool isReentrant() const override { return true; }
+
+private:
+    // Number of blocks and elements in a per-block encoding; false if the size is not one
+    bool blockLayout(size_t encoded_size, size_t& blocks, size_t& elements) const;
+
+    float scale_factor_;     // Scaling factor for quantization
+    size_t block_size_ = 0;  // Elements per block; 0 selects the global scale
+};
+
+/**
+ * @brief Adapter class for float32 vectors sent as IEEE half-precision values
+ *
+ * Halves the payload; values keep about three significant decimal digits
+ * and magnitudes up to 65504.
+ */
+class VectorFloat16Adapter : public DataTranscoder {
+public:
+    std::vector<uint8_t> encode(const void* data, size_t size, DataFormat format) override;
+    std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) override;
+    bool isValidFormat(const void* data, size_t size, DataFormat format) const override;
+    TranscodingMetadata getMetadata(const std::vector<uint8_t>& encoded_data) const override;
+    size_t maxEncodedSize(size_t size, DataFormat format) const override;
+    size_t maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const override;
+    size_t encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) override;
+    size_t decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) override;
+    bool isReentrant() const override { return true; }
+};
+
+/**
+ * @brief Adapter class for float32 vectors sent as bfloat16 values
+ *
+ * Halves the payload while keeping the full float32 exponent range, at
+ * about two significant decimal digits.
+ */
+class VectorBFloat16Adapter : public DataTranscoder {
+public:
     std::vector<uint8_t> encode(const void* data, size_t size, DataFormat format) override;
     std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) override;
     bool isValidFormat(const void* data, size_t size, DataFormat format) const override;
     TranscodingMetadata getMetadata(const std::vector<uint8_t>& encoded_data) const override;
+    size_t maxEncodedSize(size_t size, DataFormat format) const override;
+    size_t maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const override;
+    size_t encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) override;
+    size_t decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) override;
+    bool isReentrant() const override { return true; }
+};
+
+/**
+ * @brief Adapter class for float32 vectors quantized to packed 4-bit codes
+ *
+ * Each group of elements is mapped onto codes 0-15 between the group's
+ * minimum (its zero point) and maximum. The encoding starts with the element
+ * count and group size (native uint32 each), followed per group by its
+ * offset and step (native floats) and its codes, two per byte with the
+ * first element in the low nibble. Decoding uses the group size recorded in
+ * the data, so any VectorInt4Adapter decodes any other's output.
+ */
+class VectorInt4Adapter : public DataTranscoder {
+public:
+    static constexpr size_t DEFAULT_GROUP_SIZE = 32;
+
+    /**
+     * @throws TranscodingError if group_size is 0
+     */
+    explicit VectorInt4Adapter(size_t group_size = DEFAULT_GROUP_SIZE);
+
+    std::vector<uint8_t> encode(const void* data, size_t size, DataFormat format) override;
+    std::vector<uint8_t> decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) override;
+    bool isValidFormat(const void* data, size_t size, DataFormat format) const override;
+    TranscodingMetadata getMetadata(const std::vector<uint8_t>& encoded_data) const override;
+    size_t maxEncodedSize(size_t size, DataFormat format) const override;
+    size_t maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const override;
+    size_t encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) override;
+    size_t decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) override;
+    bool isReentrant() const override { return true; }
+
+    size_t groupSize() const { return group_size_; }
 
 private:
-    float scale_factor_;  // Scaling factor for quantization
+    size_t group_size_;  // Elements per scale group when encoding
 };
 
 } // namespace core
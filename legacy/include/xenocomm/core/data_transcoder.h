@@ -1,7 +1,10 @@
 #pragma once
 
+#include "xenocomm/utils/byte_span.hpp"
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <stdexcept>
@@ -17,9 +20,16 @@ enum class DataFormat {
     VECTOR_INT8,       ///< Vector of 8-bit integer values (quantized)
     COMPRESSED_STATE,  ///< Compressed state representation
     BINARY_CUSTOM,     ///< Custom binary serialization format
-    GGWAVE_FSK         ///< Audio-based FSK encoding format
+    GGWAVE_FSK,        ///< Audio-based FSK encoding format
+    VECTOR_FLOAT16,    ///< Vector of IEEE 754 half-precision values
+    VECTOR_BFLOAT16,   ///< Vector of bfloat16 values (upper half of float32)
+    VECTOR_INT4,       ///< Vector of 4-bit codes packed two per byte, with per-group scales
+    GGWAVE_FSK_MULTIBAND  ///< Audio FSK with several tone bands sounding in parallel
 };
 
+/// Number of DataFormat values; keep in step with the last enumerator
+constexpr size_t DATA_FORMAT_COUNT = static_cast<size_t>(DataFormat::GGWAVE_FSK_MULTIBAND) + 1;
+
 /**
  * @brief Exception class for data transcoding errors
  */
@@ -44,6 +54,9 @@ struct TranscodingMetadata {
     size_t encoded_data_size;             ///< Size of the final encoded/compressed data
     float compression_ratio_value;        ///< Achieved compression ratio (encoded_size / uncompressed_size)
     std::string custom_metadata_json;     ///< Additional metadata as a JSON string (e.g., for compression specifics)
+    size_t block_size;                    ///< Elements per quantization block, or 0 if scale_factor covers all
+    std::vector<float> block_scales;      ///< Dequantization step of each block, in block order
+    std::vector<float> block_offsets;     ///< Value the zero code of each block decodes to
     
     TranscodingMetadata() 
         : format(DataFormat::VECTOR_FLOAT32)
@@ -53,7 +66,8 @@ struct TranscodingMetadata {
         , element_size(0)
         , uncompressed_data_size(0)
         , encoded_data_size(0)
-        , compression_ratio_value(0.0f) {}
+        , compression_ratio_value(0.0f)
+        , block_size(0) {}
 };
 
 /**
@@ -117,7 +131,142 @@ public:
     virtual TranscodingMetadata getMetadata(
         const std::vector<uint8_t>& encoded_data) const = 0;
 
+    /**
+     * @brief Upper bound on the bytes encodeInto() writes for size bytes of input
+     * 
+     * @return size_t The bound, or 0 if the adapter cannot tell before encoding
+     * @throws TranscodingError if format is not an input this adapter encodes
+     */
+    virtual size_t maxEncodedSize(size_t size, DataFormat format) const {
+        (void)size;
+        (void)format;
+        return 0;
+    }
+
+    /**
+     * @brief Upper bound on the bytes decodeInto() writes for the given encoded data
+     * 
+     * @return size_t The bound, or 0 if the adapter cannot tell before decoding
+     * @throws TranscodingError if the encoded data is malformed
+     */
+    virtual size_t maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const {
+        (void)encoded_data;
+        (void)source_format;
+        return 0;
+    }
+
+    /**
+     * @brief Encode data into a caller-provided buffer
+     * 
+     * Adapters that report maxEncodedSize() write straight into out without
+     * allocating; the default encodes through encode() and copies the result.
+     * 
+     * @return size_t Bytes written to out
+     * @throws TranscodingError if encoding fails or out is too small
+     */
+    virtual size_t encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) {
+        return copyOut(encode(data.data(), data.size(), format), out);
+    }
+
+    /**
+     * @brief Decode data into a caller-provided buffer
+     * 
+     * @return size_t Bytes written to out
+     * @throws TranscodingError if decoding fails or out is too small
+     */
+    virtual size_t decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) {
+        return copyOut(decode(encoded_data.to_vector(), source_format), out);
+    }
+
+    /**
+     * @brief A view of data itself, if encoding it into format would not change it
+     * 
+     * Lets callers skip the copy for formats that need no transformation. The
+     * view aliases data and is valid as long as data is.
+     */
+    virtual std::optional<utils::ByteSpan> encodeView(utils::ByteSpan data, DataFormat format) const {
+        (void)data;
+        (void)format;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief A view of encoded_data itself, if decoding it would not change it
+     */
+    virtual std::optional<utils::ByteSpan> decodeView(utils::ByteSpan encoded_data, DataFormat source_format) const {
+        (void)encoded_data;
+        (void)source_format;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Whether encodeInto() and decodeInto() may run on several threads at once
+     *
+     * The batch calls split their rows across threads only for transcoders that say so.
+     */
+    virtual bool isReentrant() const { return false; }
+
+    /**
+     * @brief Encodes rows of row_size bytes, laid out back to back in data, in one call
+     *
+     * Row i is written to out at i * maxEncodedSize(row_size, format). Reentrant
+     * transcoders spread large batches over up to max_threads threads (0 allows
+     * one per core).
+     *
+     * @return The encoded size of each row
+     * @throws TranscodingError if data is not whole rows, out is too small, or a row fails
+     */
+    std::vector<size_t> encodeBatch(utils::ByteSpan data, size_t row_size, DataFormat format,
+                                    utils::MutableByteSpan out, size_t max_threads = 0);
+
+    /**
+     * @brief Decodes rows[i] bytes at i * stride in encoded into row i of out, of row_size bytes each
+     *
+     * The inverse of encodeBatch(), with the same threading.
+     *
+     * @throws TranscodingError if a row is malformed or does not decode to exactly row_size bytes
+     */
+    void decodeBatch(utils::ByteSpan encoded, size_t stride, const std::vector<size_t>& rows,
+                     DataFormat source_format, utils::MutableByteSpan out, size_t row_size,
+                     size_t max_threads = 0);
+
 protected:
+    /**
+     * @brief encode() in terms of maxEncodedSize() and encodeInto()
+     */
+    std::vector<uint8_t> encodeToVector(const void* data, size_t size, DataFormat format) {
+        validateInput(data, size);
+        std::vector<uint8_t> encoded_data(maxEncodedSize(size, format));
+        encoded_data.resize(encodeInto(utils::ByteSpan(static_cast<const uint8_t*>(data), size), format, encoded_data));
+        return encoded_data;
+    }
+
+    /**
+     * @brief decode() in terms of maxDecodedSize() and decodeInto()
+     */
+    std::vector<uint8_t> decodeToVector(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+        std::vector<uint8_t> decoded_data(maxDecodedSize(encoded_data, source_format));
+        decoded_data.resize(decodeInto(encoded_data, source_format, decoded_data));
+        return decoded_data;
+    }
+
+    /**
+     * @brief Throws unless out can hold size bytes
+     */
+    static void requireCapacity(utils::MutableByteSpan out, size_t size) {
+        if (out.size() < size) {
+            throw TranscodingError("Output buffer too small");
+        }
+    }
+
+    static size_t copyOut(const std::vector<uint8_t>& result, utils::MutableByteSpan out) {
+        requireCapacity(out, result.size());
+        if (!result.empty()) {
+            std::memcpy(out.data(), result.data(), result.size());
+        }
+        return result.size();
+    }
+
     /**
      * @brief Helper method to validate input parameters
      * 
@@ -3,6 +3,7 @@
 #include "xenocomm/core/transmission_manager.h"
 #include "xenocomm/core/error_correction_mode.h"
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <memory>
@@ -72,8 +73,8 @@ public:
 /**
  * @brief CRC32 implementation for error detection.
  * 
- * Uses the IEEE 802.3 polynomial (0xEDB88320) for CRC32 calculation.
- * This implementation supports both bit-by-bit and table-driven approaches.
+ * Uses the IEEE 802.3 polynomial (0xEDB88320) for CRC32 calculation,
+ * computed by the shared engine in xenocomm/utils/crc32.hpp.
  */
 class CRC32ErrorDetection : public IErrorCorrection {
 public:
@@ -87,21 +88,25 @@ public:
     std::string name() const override { return "CRC32"; }
 
 private:
-    static constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
     static constexpr size_t CRC_SIZE = 4;
     
     uint32_t computeCRC32(const uint8_t* data, size_t length) const;
     bool verifyCRC32(const uint8_t* data, size_t length) const;
-    
-    std::vector<uint32_t> crc_table_;
-    void initCRCTable();
 };
 
 /**
  * @brief Reed-Solomon error correction implementation.
  * 
- * Implements Reed-Solomon error correction using GF(2^8) with configurable
- * parameters for error correction capability.
+ * Systematic Reed-Solomon over GF(2^8) with a Cauchy generator matrix. The
+ * length-prefixed (and optionally interleaved) input is split into
+ * data_shards equal shards, followed by parity_shards parity shards and a
+ * CRC32 per shard. On decode, shards failing their CRC are rebuilt from the
+ * survivors; up to parity_shards / 2 damaged shards are corrected, and the
+ * remaining parity verifies the result. Region arithmetic runs on the SIMD
+ * kernels in xenocomm/utils/gf256.hpp.
+ *
+ * data_shards must be non-zero and data_shards + parity_shards at most 256;
+ * otherwise encode() returns an empty vector and decode() returns nullopt.
  */
 class ReedSolomonCorrection : public IErrorCorrection {
 public:
@@ -115,12 +120,102 @@ public:
     int maxCorrectableErrors() const override;
     std::string name() const override { return "Reed-Solomon"; }
 
+    /**
+     * @brief Returns the encoded size of a payload of the given length.
+     *
+     * @return size_t Bytes encodeInto() writes, 0 for empty input or an invalid config
+     */
+    size_t encodedSize(size_t data_size) const;
+
+    /**
+     * @brief Encodes directly into a caller-provided buffer without allocating.
+     *
+     * @param data Payload to encode
+     * @param size Payload length in bytes
+     * @param out Destination for the shard matrix and CRC trailer
+     * @param capacity Size of out; must be at least encodedSize(size)
+     * @return size_t Bytes written, 0 if the input is empty, the config invalid or out too small
+     */
+    size_t encodeInto(const uint8_t* data, size_t size, uint8_t* out, size_t capacity);
+
+    /**
+     * @brief Decodes directly into a caller-provided buffer.
+     *
+     * Damaged shards are rebuilt in a scratch buffer owned by this instance and
+     * reused across calls, so steady-state decoding does not allocate. An
+     * instance must therefore not decode on several threads at once.
+     *
+     * @param data Encoded shard matrix and CRC trailer
+     * @param size Encoded length in bytes
+     * @param out Destination for the decoded payload
+     * @param capacity Size of out
+     * @return std::optional<size_t> Payload length, nullopt if uncorrectable or out is too small
+     */
+    std::optional<size_t> decodeInto(const uint8_t* data, size_t size, uint8_t* out, size_t capacity);
+
     void configure(const Config& config);
     const Config& get_config() const { return config_; }
 
 private:
+    struct DecodedView {
+        const uint8_t* body;   ///< Length-prefixed payload area, possibly interleaved
+        size_t original_size;  ///< Payload length before padding
+    };
+
+    bool isValidConfig() const;
+    void buildParityMatrix();
+    std::optional<DecodedView> reconstruct(const uint8_t* data, size_t size);
+    void writePayload(const DecodedView& view, uint8_t* out) const;
+
+    Config config_;
+    std::vector<uint8_t> parity_matrix_;  ///< parity_shards x data_shards Cauchy coefficients, row-major
+    std::vector<uint8_t> scratch_;        ///< Rebuilt data shards
+    std::vector<uint8_t> matrix_scratch_; ///< Decode matrix and its inverse
+    std::vector<size_t> survivors_;
+    std::vector<uint8_t> shard_intact_;
+    std::vector<uint8_t> check_scratch_;
+};
+
+struct FountainCorrectionConfig {
+    uint32_t symbol_size = 256;    ///< Bytes per symbol
+    uint32_t block_symbols = 32;   ///< Source symbols per block (K), at most FountainLayout::MAX_BLOCK_SYMBOLS
+    uint32_t repair_symbols = 4;   ///< Repair symbols appended per block
+};
+
+/**
+ * @brief Fixed-rate use of the fountain code in xenocomm/core/fountain_code.h.
+ *
+ * The length-prefixed input is cut into blocks of block_symbols symbols,
+ * each followed by repair_symbols repair symbols, and every symbol carries a
+ * CRC32. On decode, symbols failing their CRC are treated as erased; a block
+ * survives as long as no more than repair_symbols of its symbols are lost
+ * (rarely, one more symbol is needed when the survivors are dependent).
+ * TransmissionManager::send_bulk() uses the same code ratelessly, streaming
+ * repair symbols until receivers have decoded.
+ *
+ * symbol_size and block_symbols must be non-zero and block_symbols at most
+ * FountainLayout::MAX_BLOCK_SYMBOLS; otherwise encode() returns an empty
+ * vector and decode() returns nullopt.
+ */
+class FountainCorrection : public IErrorCorrection {
+public:
+    using Config = FountainCorrectionConfig;
+    explicit FountainCorrection(const Config& config);
+    ~FountainCorrection() override = default;
+
+    std::vector<uint8_t> encode(const std::vector<uint8_t>& data) override;
+    std::optional<std::vector<uint8_t>> decode(const std::vector<uint8_t>& data) override;
+    bool canCorrect() const override { return true; }
+    int maxCorrectableErrors() const override { return static_cast<int>(config_.repair_symbols); }
+    std::string name() const override { return "Fountain"; }
+
+    void configure(const Config& config) { config_ = config; }
+    const Config& get_config() const { return config_; }
+
+private:
+    bool isValidConfig() const;
+
     Config config_;
-    // Additional implementation details will be added in the cpp file
 };
 
 /**
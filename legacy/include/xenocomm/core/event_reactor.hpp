@@ -0,0 +1,144 @@
+#ifndef XENOCOMM_CORE_EVENT_REACTOR_HPP
+#define XENOCOMM_CORE_EVENT_REACTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Readiness-based event loop multiplexing many sockets on a few threads.
+ *
+ * Each loop thread owns one kernel poller (epoll on Linux, kqueue on macOS and
+ * the BSDs, poll() elsewhere). File descriptors and timers are spread across
+ * the loops, and their callbacks run on the owning loop thread. Interest is
+ * level-triggered: a READABLE callback that leaves data unread is invoked
+ * again, so handlers read until the transport reports WOULD_BLOCK.
+ *
+ * Callbacks must not block. Anything long-running (reconnects, handshakes)
+ * belongs on another thread, with the result posted back through post().
+ *
+ * remove() and cancelTimer() guarantee the callback is not running and will
+ * not run again once they return. Called from the callback itself they
+ * return immediately.
+ */
+class EventReactor {
+public:
+    /**
+     * @brief Readiness flags passed to add()/modify() and reported to callbacks.
+     */
+    enum EventFlags : uint32_t {
+        READABLE = 0x1,  ///< Data (or a pending accept) can be read without blocking
+        WRITABLE = 0x2,  ///< Send buffer space is available
+        CLOSED = 0x4,    ///< Peer hung up; reported regardless of interest
+        FAILED = 0x8     ///< Socket error pending; reported regardless of interest
+    };
+
+    using EventCallback = std::function<void(int fd, uint32_t events)>;
+    using TimerCallback = std::function<void()>;
+    using TimerId = uint64_t;
+
+    /**
+     * @brief Starts the loop threads.
+     *
+     * @param threads Number of loop threads, at least 1
+     */
+    explicit EventReactor(size_t threads = 1);
+
+    /**
+     * @brief Stops and joins the loop threads. Pending timers and tasks are dropped.
+     */
+    ~EventReactor();
+
+    EventReactor(const EventReactor&) = delete;
+    EventReactor& operator=(const EventReactor&) = delete;
+
+    /**
+     * @brief Process-wide reactor shared by all transports.
+     */
+    static EventReactor& shared();
+
+    /**
+     * @brief Whether every loop's kernel poller was created.
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Starts watching a file descriptor.
+     *
+     * The descriptor should already be non-blocking.
+     *
+     * @param fd Descriptor to watch; must not already be registered
+     * @param events READABLE and/or WRITABLE interest
+     * @param callback Invoked on the loop thread with the ready events
+     * @return true if the descriptor was registered
+     */
+    bool add(int fd, uint32_t events, EventCallback callback);
+
+    /**
+     * @brief Changes the interest set of a registered descriptor.
+     */
+    bool modify(int fd, uint32_t events);
+
+    /**
+     * @brief Stops watching a descriptor. Must be called before the descriptor is closed.
+     */
+    bool remove(int fd);
+
+    /**
+     * @brief Runs callback once after delay.
+     */
+    TimerId scheduleAfter(std::chrono::milliseconds delay, TimerCallback callback);
+
+    /**
+     * @brief Runs callback every interval until cancelled.
+     */
+    TimerId scheduleEvery(std::chrono::milliseconds interval, TimerCallback callback);
+
+    /**
+     * @brief Cancels a timer. Unknown or already fired ids are ignored.
+     */
+    void cancelTimer(TimerId id);
+
+    /**
+     * @brief Runs task on a loop thread as soon as possible.
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * @brief Whether the calling thread is one of this reactor's loop threads.
+     */
+    bool inLoopThread() const;
+
+    size_t threadCount() const { return loops_.size(); }
+
+    /**
+     * @brief Number of registered descriptors across all loops.
+     */
+    size_t watchedCount() const;
+
+private:
+    struct Loop;
+
+    Loop& loopForFd(int fd) const;
+    Loop& loopForTimer(TimerId id) const;
+    TimerId addTimer(std::chrono::milliseconds delay, std::chrono::milliseconds interval,
+                     TimerCallback callback);
+    void run(Loop& loop);
+
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::atomic<TimerId> nextTimerId_{1};
+    std::atomic<size_t> nextPostLoop_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_EVENT_REACTOR_HPP
@@ -2,9 +2,9 @@
 
 #include "xenocomm/core/feedback_loop.h"
 #include "xenocomm/core/transmission_manager.h"
+#include "xenocomm/utils/task_scheduler.hpp"
 #include <memory>
 #include <functional>
-#include <thread>
 #include <atomic>
 #include <mutex>
 #include <chrono>
@@ -68,6 +68,8 @@ public:
         // Constructor body (if any)
     }
 
+    ~FeedbackIntegration();
+
     /**
      * @brief Starts the feedback integration
      * 
@@ -80,7 +82,8 @@ public:
     /**
      * @brief Stops the feedback integration
      * 
-     * Removes event listeners and stops feedback collection.
+     * Removes event listeners and stops feedback collection. Once it
+     * returns, no strategy update is running or will run.
      */
     void stop();
 
@@ -132,7 +135,8 @@ private:
     core::TransmissionManager& transmission_mgr_;
     Config config_;
     std::atomic<bool> running_{false};
-    std::unique_ptr<std::thread> update_thread_;
+    // Periodic strategy update on the shared scheduler, while auto-updates are enabled
+    utils::TaskScheduler::TaskId update_task_{utils::TaskScheduler::INVALID_TASK};
     mutable std::mutex mutex_;
     StrategyRecommendation latest_recommendation_;
     std::function<void(const StrategyRecommendation&)> strategy_callback_;
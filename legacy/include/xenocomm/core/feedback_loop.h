@@ -1,8 +1,10 @@
 #pragma once
 
 #include "xenocomm/utils/result.hpp"
+#include "xenocomm/utils/metrics_registry.hpp"
 #include <chrono>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -23,6 +25,32 @@ struct CommunicationOutcome {
     std::chrono::system_clock::time_point timestamp;
 };
 
+/**
+ * @brief Low-cardinality dimensions an outcome is reported under
+ *
+ * An empty field is unset. Used as a selector, an empty field matches any value.
+ */
+struct OutcomeLabels {
+    std::string peerId;
+    std::string transport;
+    std::string dataFormat;
+    std::string compression;
+
+    bool operator==(const OutcomeLabels& other) const;
+    bool operator!=(const OutcomeLabels& other) const { return !(*this == other); }
+
+    /**
+     * @brief Whether labels has this selector's value in every field it sets
+     */
+    bool matches(const OutcomeLabels& labels) const;
+};
+
+/**
+ * @brief Value of every field of the label set that outcomes are counted under
+ *        once FeedbackLoopConfig::maxLabelSets distinct sets have been seen
+ */
+constexpr const char* OVERFLOW_LABEL = "other";
+
 /**
  * @brief Statistical distribution metrics for numeric values
  */
@@ -61,6 +89,14 @@ struct MetricsSummary {
     std::chrono::system_clock::time_point windowEnd;
 };
 
+/**
+ * @brief Metrics of the outcomes reported under one label set
+ */
+struct LabeledMetrics {
+    OutcomeLabels labels;
+    MetricsSummary metrics;
+};
+
 /**
  * @brief Detailed performance metrics for a time window
  */
@@ -94,6 +130,7 @@ struct PersistenceConfig {
     std::chrono::hours retentionPeriod{720}; // Default 30 days
     uint64_t maxStorageSizeBytes{1073741824}; // Default 1GB
     bool enableCompression{true};        // Whether to compress stored data
+    int compressionLevel{1};             // zlib level, 1 (fastest) to 9 (smallest)
     bool enableBackup{true};            // Whether to create backup copies
     uint32_t backupIntervalHours{24};   // How often to create backups
     uint32_t maxBackupCount{7};         // Maximum number of backup files to keep
@@ -112,10 +149,25 @@ struct FeedbackLoopConfig {
     bool enableDetailedAnalysis{true};
     uint32_t forecastHorizon{12};   // Number of intervals to forecast
     double outlierThreshold{3.0};   // Standard deviations for outlier detection
+    uint32_t ingestQueueCapacity{4096}; // Outcomes buffered per reporting shard; fixed at construction
+    std::chrono::milliseconds ingestFlushInterval{50}; // How often buffered outcomes are aggregated
+    uint32_t maxLabelSets{256};     // Distinct label sets aggregated separately; later ones share the OVERFLOW_LABEL set
 };
 
 /**
  * @brief FeedbackLoop class for monitoring and optimizing communication performance
+ *
+ * Outcomes are reported without locking: each is stored as a fixed-size
+ * record, its error type interned to an integer, in one of a few lock-free
+ * rings picked per reporting thread. A background thread aggregates the
+ * rings every ingestFlushInterval, and every query aggregates them first, so
+ * an outcome is visible to queries as soon as reportOutcome() returns. Only a
+ * full ring, or the first report of an error type or label set, takes the lock.
+ *
+ * Outcomes reported with OutcomeLabels are also summed per label set, so a
+ * regression can be traced to one peer, transport or encoding rather than
+ * seen only in the link-wide metrics. At most maxLabelSets sets are kept
+ * apart; labeled summaries cover the metrics window to the second.
  */
 class FeedbackLoop {
 public:
@@ -124,6 +176,7 @@ public:
 
     // Outcome reporting methods
     Result<void> reportOutcome(const CommunicationOutcome& outcome);
+    Result<void> reportOutcome(const CommunicationOutcome& outcome, const OutcomeLabels& labels);
     Result<void> recordMetric(const std::string& metricName, double value);
     Result<void> addCommunicationResult(bool success, std::chrono::microseconds latency,
                                       uint32_t bytesTransferred, uint32_t retryCount = 0,
@@ -131,6 +184,12 @@ public:
 
     // Basic query methods
     Result<MetricsSummary> getCurrentMetrics() const;
+    // Summary of the outcomes in the last window, at one-second granularity; window <= metricsWindowSize
+    Result<MetricsSummary> getMetricsForWindow(std::chrono::seconds window) const;
+    // Summary of the labeled outcomes in the window whose labels selector matches
+    Result<MetricsSummary> getMetricsForLabels(const OutcomeLabels& selector) const;
+    // Summary of each label set with outcomes in the window
+    Result<std::vector<LabeledMetrics>> getLabeledMetrics() const;
     Result<std::vector<CommunicationOutcome>> getRecentOutcomes(uint32_t limit = 100) const;
     Result<double> getMetricValue(const std::string& metricName) const;
 
@@ -142,6 +201,25 @@ public:
     Result<std::map<std::string, uint32_t>> getErrorTypeDistribution() const;
     Result<std::vector<CommunicationOutcome>> getOutliers() const;
 
+    /**
+     * @brief Called with the new window generation after outcomes entered or left the window
+     *
+     * Runs on whichever thread aggregated the outcomes, with the loop locked:
+     * it must be quick and must not call back into this FeedbackLoop.
+     */
+    using WindowListener = std::function<void(uint64_t generation)>;
+
+    // Window updates
+    // Generation of the current window; it changes whenever its outcomes or the configuration do
+    uint64_t getWindowGeneration() const;
+    uint64_t subscribeWindowUpdates(WindowListener listener);
+    // Once this returns the listener is not running and will not be called again
+    void unsubscribeWindowUpdates(uint64_t subscription);
+
+    // Reports the window's summary, overall and per label set, through registry whenever it
+    // is exported; series are labelled instance=<instance>. Registering again replaces the last
+    void registerMetrics(utils::MetricsRegistry& registry, const std::string& instance);
+
     // Configuration
     void setConfig(const FeedbackLoopConfig& config);
     const FeedbackLoopConfig& getConfig() const;
@@ -171,6 +249,7 @@ public:
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
+    utils::MetricsRegistration metricsRegistration_;  // After impl_, so it is removed first
 
     // Prevent copying
     FeedbackLoop(const FeedbackLoop&) = delete;
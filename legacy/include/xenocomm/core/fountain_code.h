@@ -0,0 +1,132 @@
+#pragma once
+
+#include "xenocomm/utils/byte_span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief How a payload is cut into source blocks and symbols for fountain coding.
+ *
+ * The payload, zero-padded to whole symbols, is split into blocks of
+ * block_symbols symbols of symbol_size bytes each; the last block may be
+ * shorter. Encoder and decoder derive the same layout from the payload size,
+ * so only that and these two numbers travel with the symbols.
+ */
+struct FountainLayout {
+    static constexpr uint32_t MAX_BLOCK_SYMBOLS = 1024;
+
+    uint64_t payload_size = 0;
+    uint32_t symbol_size = 0;
+    uint32_t block_symbols = 0;
+
+    uint64_t total_symbols() const;
+    uint32_t block_count() const;
+    uint32_t source_symbols(uint32_t block) const;  ///< K of block
+    bool valid() const;  ///< Symbol size non-zero, block_symbols in 1..MAX_BLOCK_SYMBOLS
+};
+
+/**
+ * @brief Systematic rateless encoder: a random linear fountain code over GF(2^8).
+ *
+ * For a block of K source symbols, symbol ID esi < K is source symbol esi
+ * itself and every esi >= K a repair symbol: the sum of all K source symbols,
+ * each scaled by a nonzero coefficient drawn from a generator seeded with the
+ * block and esi. Any esi up to 2^32 - 1 can be produced on demand, so a sender
+ * can go on emitting fresh repair symbols for as long as receivers need them.
+ * A decoder recovers the block from any K symbols whose coefficients are
+ * independent, which K random ones are with probability about 1 - 1/255, each
+ * further symbol dividing the failure rate by 256.
+ *
+ * Repair symbols cost K region multiply-adds each (see utils/gf256.hpp), so
+ * block_symbols trades that cost against how finely loss is averaged.
+ *
+ * The payload is read in place and must outlive the encoder.
+ */
+class FountainEncoder {
+public:
+    /**
+     * @brief Prepares to encode data; check layout().valid() before encoding.
+     */
+    FountainEncoder(utils::ByteSpan data, uint32_t symbol_size, uint32_t block_symbols);
+
+    const FountainLayout& layout() const { return layout_; }
+
+    /**
+     * @brief Writes symbol esi of block into the symbol_size bytes at out.
+     */
+    void encode(uint32_t block, uint32_t esi, uint8_t* out) const;
+
+private:
+    const uint8_t* source_symbol(uint32_t block, uint32_t index) const;
+
+    utils::ByteSpan data_;
+    FountainLayout layout_;
+    std::vector<uint8_t> padded_tail_;  ///< The payload's last symbol, zero-padded to symbol_size
+};
+
+/**
+ * @brief Incremental decoder for FountainEncoder's symbols.
+ *
+ * Each symbol is eliminated against those kept so far as it arrives, so the
+ * work is spread over the transfer rather than done at the end. Source
+ * symbols go straight to their place in the output; only repair symbols
+ * that stand in for lost ones are kept with their coefficients, so beyond
+ * the payload itself a block holds about as many rows as it lost symbols,
+ * and releases them as soon as it is decoded.
+ *
+ * Symbols must arrive intact: verify them before add_symbol(), as one
+ * corrupted symbol spoils its whole block.
+ */
+class FountainDecoder {
+public:
+    explicit FountainDecoder(const FountainLayout& layout);
+    ~FountainDecoder();
+
+    FountainDecoder(const FountainDecoder&) = delete;
+    FountainDecoder& operator=(const FountainDecoder&) = delete;
+
+    const FountainLayout& layout() const { return layout_; }
+
+    /**
+     * @brief Adds symbol esi of block, symbol_size bytes.
+     *
+     * @return true if it told the decoder something new; false if it was
+     *         redundant, for a block already decoded, or out of range
+     */
+    bool add_symbol(uint32_t block, uint32_t esi, utils::ByteSpan symbol);
+
+    bool block_complete(uint32_t block) const;
+    bool complete() const { return blocks_remaining_ == 0; }
+    uint32_t blocks_remaining() const { return blocks_remaining_; }
+
+    /**
+     * @brief The decoded payload, moved out; empty unless complete().
+     */
+    std::vector<uint8_t> take_payload();
+
+private:
+    struct BlockState;
+
+    uint8_t* output_symbol(uint32_t block, uint32_t index);
+    void finish_block(uint32_t block, BlockState& state);
+
+    FountainLayout layout_;
+    std::vector<uint8_t> output_;  ///< Payload padded to whole symbols
+    std::vector<std::unique_ptr<BlockState>> blocks_;  ///< Null once decoded
+    uint32_t blocks_remaining_;
+};
+
+/**
+ * @brief Fills out with the nonzero coefficients repair symbol esi of block gives its first count source symbols.
+ *
+ * Shared by encoder and decoder, which must agree on the generator.
+ */
+void fountain_coefficients(uint32_t block, uint32_t esi, uint8_t* out, uint32_t count);
+
+} // namespace core
+} // namespace xenocomm
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "xenocomm/core/data_transcoder.h"
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,13 +18,15 @@ struct GgwaveFskConfig {
     float frequency_spacing;   ///< Frequency spacing between symbols in Hz
     size_t samples_per_symbol; ///< Number of samples per FSK symbol
     float amplitude;           ///< Signal amplitude (0.0 to 1.0)
+    size_t bands;              ///< Tone bands sounding together in GGWAVE_FSK_MULTIBAND, 2 to 16
 
     GgwaveFskConfig()
         : sample_rate(44100.0f)
         , base_frequency(1000.0f)
-        , frequency_spacing(100.0f)
+        , frequency_spacing(80.0f)  // Keeps symbol 255 below the 22.05 kHz Nyquist limit
         , samples_per_symbol(256)
-        , amplitude(0.5f) {}
+        , amplitude(0.5f)
+        , bands(8) {}
 };
 
 /**
@@ -31,6 +34,23 @@ struct GgwaveFskConfig {
  * 
  * This adapter implements Frequency-Shift Keying (FSK) encoding for data
  * transmission over audio channels using the GGWAVE protocol.
+ *
+ * Symbols are modulated from a shared sine table with a phase accumulator
+ * and demodulated with a bank of Goertzel filters, one per symbol
+ * frequency, evaluated 16 bins at a time with SSE2 or NEON. Frequencies
+ * above half the sample rate alias onto lower symbols, so base_frequency +
+ * 255 * frequency_spacing should stay below it.
+ *
+ * GGWAVE_FSK_MULTIBAND splits the tones into config.bands bands of 16 and
+ * sounds one tone in every band at once, each carrying a nibble, so a
+ * symbol carries bands / 2 bytes instead of one. The header goes out a byte
+ * per symbol, as nibbles in the two lowest bands, followed by the band
+ * count. Simultaneous tones only stay separable when they are orthogonal
+ * over a symbol, so encoding requires frequency_spacing to be at least
+ * sample_rate / samples_per_symbol and every tone to stay below half the
+ * sample rate; 48 kHz with 480 samples per symbol, a 100 Hz spacing and 8
+ * bands gives four bytes per 10 ms. Peers that both offer the format in
+ * negotiation should be configured alike.
  */
 class GgwaveFskAdapter : public DataTranscoder {
 public:
@@ -42,9 +62,10 @@ public:
      * 
      * @param data Raw input data as bytes
      * @param size Size of input data in bytes
-     * @param format Target format for encoding (must be GGWAVE_FSK)
+     * @param format Target format for encoding (GGWAVE_FSK or GGWAVE_FSK_MULTIBAND)
      * @return std::vector<uint8_t> FSK modulated audio data
-     * @throws TranscodingError if encoding fails or format is invalid
+     * @throws TranscodingError if encoding fails, format is invalid, or the
+     *         configuration cannot carry parallel bands
      */
     std::vector<uint8_t> encode(
         const void* data,
@@ -55,7 +76,7 @@ public:
      * @brief Decode FSK modulated audio data
      * 
      * @param encoded_data FSK modulated audio data
-     * @param source_format Format of the encoded data (must be GGWAVE_FSK)
+     * @param source_format Format of the encoded data (GGWAVE_FSK or GGWAVE_FSK_MULTIBAND)
      * @return std::vector<uint8_t> Decoded data
      * @throws TranscodingError if decoding fails or format is invalid
      */
@@ -68,7 +89,7 @@ public:
      * 
      * @param data Data to validate
      * @param size Size of data in bytes
-     * @param format Format to validate against (must be GGWAVE_FSK)
+     * @param format Format to validate against (GGWAVE_FSK or GGWAVE_FSK_MULTIBAND)
      * @return true if data is valid for the format
      * @return false if data is invalid for the format
      */
@@ -101,8 +122,70 @@ public:
      */
     const GgwaveFskConfig& getConfig() const;
 
+    /**
+     * @brief Decodes FSK audio incrementally as it is captured
+     *
+     * The capture side push()es 8-bit samples into a lock-free
+     * single-producer, single-consumer ring buffer, so it can be fed from an
+     * audio callback; the decoding thread poll()s, which demodulates every
+     * complete symbol window and returns messages as they finish. The
+     * stream must start on a symbol boundary and use the adapter's sample
+     * rate, frequencies and symbol length; messages may follow each other
+     * back to back, in either format. The adapter must outlive the decoder
+     * and keep its configuration.
+     */
+    class StreamDecoder {
+    public:
+        /**
+         * @param ring_symbols Ring buffer capacity, in symbols of audio
+         */
+        explicit StreamDecoder(const GgwaveFskAdapter& adapter, size_t ring_symbols = 16);
+
+        /**
+         * @brief Appends captured samples; producer side
+         *
+         * @return Samples accepted; the rest are dropped when the ring is full
+         */
+        size_t push(const uint8_t* samples, size_t count);
+
+        /**
+         * @brief Demodulates buffered audio; consumer side
+         *
+         * @param message Receives the next complete message
+         * @return true if a message was completed
+         * @throws TranscodingError if a message header is invalid; the decoder
+         *         is reset, since symbol alignment can no longer be trusted
+         */
+        bool poll(std::vector<uint8_t>& message);
+
+        /**
+         * @brief Drops buffered audio and any partial message; consumer side
+         */
+        void reset();
+
+        /**
+         * @brief Samples buffered and not yet demodulated
+         */
+        size_t buffered() const;
+
+    private:
+        const GgwaveFskAdapter& adapter_;
+        std::vector<uint8_t> ring_;
+        std::atomic<size_t> head_{0};   // Samples ever written
+        std::atomic<size_t> tail_{0};   // Samples ever consumed
+        std::vector<float> window_;     // One symbol of audio, unwrapped from the ring
+        std::vector<uint8_t> symbols_;  // Header symbols of the message in progress
+        std::vector<uint8_t> paired_;   // The same symbols read as multi-band nibble pairs
+        std::vector<uint8_t> data_;     // Data of the message in progress, once its header is in
+        size_t bands_ = 0;              // Bands of the message in progress, 0 until its header is in
+        size_t received_ = 0;           // Data symbols demodulated so far
+        size_t expected_ = 0;           // Data symbols of the message in progress
+    };
+
 private:
     GgwaveFskConfig config_;
+    std::vector<uint32_t> phase_steps_;         ///< Per symbol, phase advance per sample as a 32-bit fraction of a cycle
+    std::vector<float> goertzel_coefficients_;  ///< Per symbol, 2cos(2*pi*f/sample_rate)
 
     struct FskHeader {
         uint32_t magic;
@@ -114,6 +197,7 @@ private:
     };
 
     static constexpr uint32_t MAGIC_NUMBER = 0xF5CA4D2E;  // "FSK" magic
+    static constexpr uint32_t MULTIBAND_MAGIC_NUMBER = 0xF5CA4D2F;  // Band count symbol follows the header
 
     /**
      * @brief Generate FSK symbol frequencies
@@ -124,30 +208,101 @@ private:
     float getSymbolFrequency(uint8_t symbol) const;
 
     /**
-     * @brief Generate audio samples for a symbol
+     * @brief Recompute the per-symbol modulation and detection tables
+     */
+    void buildTables();
+
+    /**
+     * @brief Generate 8-bit audio samples for a symbol
      * 
      * @param symbol Symbol to generate samples for
-     * @param samples Output vector for samples
+     * @param out Output for samples_per_symbol samples
+     */
+    void modulateSymbol(uint8_t symbol, uint8_t* out) const;
+
+    /**
+     * @brief Generate 8-bit audio samples for one tone in each band
+     *
+     * @param tones Per band, the tone index within the band (0 to 15)
+     * @param bands Number of bands
+     * @param mix Scratch for samples_per_symbol samples
+     * @param out Output for samples_per_symbol samples
      */
-    void generateSymbolSamples(uint8_t symbol, std::vector<float>& samples) const;
+    void modulateBands(const uint8_t* tones, size_t bands, float* mix, uint8_t* out) const;
 
     /**
-     * @brief Detect symbol from audio samples
+     * @brief Detect the symbol in one window of audio samples
      * 
-     * @param samples Audio samples to analyze
-     * @param offset Start offset in samples
-     * @return uint8_t Detected symbol value
+     * @param window Samples scaled to -1.0 to 1.0
+     * @param count Number of samples, at most samples_per_symbol
+     * @return uint8_t Symbol whose frequency has the most energy
      */
-    uint8_t detectSymbol(const std::vector<float>& samples, size_t offset) const;
+    uint8_t detectSymbol(const float* window, size_t count) const;
+
+    /**
+     * @brief Detect one header symbol both ways it may have been sent
+     *
+     * @param single Receives the byte as a single tone
+     * @param paired Receives the byte as a nibble in each of the two lowest bands
+     */
+    void detectHeaderSymbol(const float* window, size_t count, uint8_t& single, uint8_t& paired) const;
+
+    /**
+     * @brief Detect one data symbol and store what it carries
+     *
+     * With one band the symbol is stored as byte number symbol of out; with
+     * more, the tone of each band is stored as the next nibble, low nibble
+     * first, in out, which must start zeroed. Bytes past out_size are dropped.
+     */
+    void detectData(const float* window, size_t count, size_t bands,
+                    size_t symbol, uint8_t* out, size_t out_size) const;
+
+    /**
+     * @brief Detect consecutive data symbols in 8-bit audio samples
+     * 
+     * @param samples Audio samples
+     * @param sample_count Number of samples; a short last window is analyzed as is
+     * @param first_symbol Index of the first symbol to detect
+     * @param bands Bands per symbol, 1 for single-tone symbols
+     * @param out Output for out_size bytes, zeroed
+     * @param out_size Number of bytes to recover
+     */
+    void demodulate(const uint8_t* samples, size_t sample_count,
+                    size_t first_symbol, size_t bands, uint8_t* out, size_t out_size) const;
+
+    /**
+     * @brief Decode a header from the first symbols of 8-bit audio samples
+     *
+     * @param bands Receives the band count, 1 for a single-band header
+     */
+    FskHeader readHeader(const uint8_t* samples, size_t sample_count, size_t& bands) const;
 
     /**
      * @brief Validate FSK header
      * 
      * @param header Header to validate
-     * @param data_size Expected data size
+     * @param bands Band count that came with the header
+     * @param symbol_count Symbols available, header included
      * @throws TranscodingError if header is invalid
      */
-    void validateHeader(const FskHeader& header, size_t data_size) const;
+    void validateHeader(const FskHeader& header, size_t bands, size_t symbol_count) const;
+
+    /**
+     * @brief Check that the configuration can carry config_.bands parallel bands
+     *
+     * @throws TranscodingError if it cannot
+     */
+    void validateBands() const;
+
+    /**
+     * @brief Symbols before the data: the header, plus the band count for multi-band
+     */
+    static size_t headerSymbols(size_t bands);
+
+    /**
+     * @brief Symbols carrying size bytes of data
+     */
+    static size_t dataSymbols(size_t size, size_t bands);
 };
 
 } // namespace core
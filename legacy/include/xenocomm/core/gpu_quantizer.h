@@ -0,0 +1,136 @@
+#pragma once
+
+#include "xenocomm/core/data_adapters.h"
+#include "xenocomm/utils/byte_span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Settings for a GpuQuantizer
+ */
+struct GpuQuantizerConfig {
+    int device = 0;                                                ///< CUDA device ordinal
+    size_t int8_block_size = VectorInt8Adapter::DEFAULT_BLOCK_SIZE;  ///< 0 selects one global scale
+    float int8_scale = 1.0f;                                       ///< Global INT8 scale, when int8_block_size is 0
+    size_t int4_group_size = VectorInt4Adapter::DEFAULT_GROUP_SIZE;
+};
+
+/**
+ * @brief Quantizes float32 vectors that live in GPU memory, on the GPU
+ *
+ * Produces VECTOR_INT8, VECTOR_FLOAT16, VECTOR_BFLOAT16 and VECTOR_INT4
+ * encodings byte for byte in the layouts of the CPU adapters, so receivers
+ * decode them with VectorInt8Adapter (perBlock() with the same block size,
+ * or the same global scale), VectorFloat16Adapter, VectorBFloat16Adapter or
+ * any VectorInt4Adapter. Only the encoded bytes cross the bus: encode()
+ * copies them into a page-locked PinnedBuffer a transport can send from, and
+ * encodeOnDevice() leaves them in device memory for GPUDirect-capable
+ * transports to register. Codes agree with the CPU kernels to within one
+ * step, as the CPU kernels agree among themselves.
+ *
+ * Built only with ENABLE_CUDA and a CUDA toolkit (XENOCOMM_HAVE_CUDA);
+ * elsewhere, and on hosts without a device, available() is false and the
+ * constructor throws. Not thread-safe; use one per thread or stream.
+ */
+class GpuQuantizer {
+public:
+    /**
+     * @brief Page-locked host memory, so device copies into it run at full speed
+     *
+     * Falls back to ordinary heap memory in builds without CUDA.
+     */
+    class PinnedBuffer {
+    public:
+        PinnedBuffer() = default;
+        ~PinnedBuffer();
+        PinnedBuffer(PinnedBuffer&& other) noexcept;
+        PinnedBuffer& operator=(PinnedBuffer&& other) noexcept;
+        PinnedBuffer(const PinnedBuffer&) = delete;
+        PinnedBuffer& operator=(const PinnedBuffer&) = delete;
+
+        /**
+         * @brief Sets the size, reallocating only to grow; contents are not kept
+         *
+         * @throws TranscodingError if the allocation fails
+         */
+        void resize(size_t size);
+
+        uint8_t* data() { return data_; }
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+        size_t capacity() const { return capacity_; }
+        utils::ByteSpan span() const { return utils::ByteSpan(data_, size_); }
+
+    private:
+        void release();
+
+        uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+    };
+
+    /**
+     * @throws TranscodingError if CUDA is unavailable or a setting is invalid
+     */
+    explicit GpuQuantizer(const GpuQuantizerConfig& config = GpuQuantizerConfig{});
+    ~GpuQuantizer();
+
+    GpuQuantizer(const GpuQuantizer&) = delete;
+    GpuQuantizer& operator=(const GpuQuantizer&) = delete;
+
+    /**
+     * @brief Whether CUDA support is built in and this host has a device
+     */
+    static bool available();
+
+    /**
+     * @brief Encoded size of count floats in a format
+     *
+     * @throws TranscodingError for formats the quantizer does not produce
+     */
+    size_t encodedSize(size_t count, DataFormat format) const;
+
+    /**
+     * @brief Quantizes count floats in device memory into a pinned host buffer
+     *
+     * @param device_data Device pointer to the input
+     * @param out Resized to the encoded size and filled on return
+     * @return View of out
+     * @throws TranscodingError if the format is unsupported or CUDA fails
+     */
+    utils::ByteSpan encode(const float* device_data, size_t count, DataFormat format, PinnedBuffer& out);
+
+    /**
+     * @brief Quantizes count floats in device memory, leaving the result there
+     *
+     * @return View of device memory owned by the quantizer, valid until its
+     *         next encode call; not dereferenceable on the host
+     * @throws TranscodingError if the format is unsupported or CUDA fails
+     */
+    utils::ByteSpan encodeOnDevice(const float* device_data, size_t count, DataFormat format);
+
+    /**
+     * @brief Copies host floats into a device staging buffer owned by the quantizer
+     *
+     * For callers whose vectors are not on the device yet.
+     *
+     * @return Device pointer, valid until the next upload
+     * @throws TranscodingError if CUDA fails
+     */
+    const float* upload(const float* host_data, size_t count);
+
+    const GpuQuantizerConfig& config() const { return config_; }
+
+private:
+    struct Device;
+
+    GpuQuantizerConfig config_;
+    std::unique_ptr<Device> device_;
+};
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,68 @@
+#ifndef XENOCOMM_CORE_HANDSHAKE_PIPELINE_HPP
+#define XENOCOMM_CORE_HANDSHAKE_PIPELINE_HPP
+
+#include "xenocomm/core/event_reactor.hpp"
+#include "xenocomm/core/security_manager.h"
+#include "xenocomm/utils/result.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Runs many non-blocking TLS handshakes at once on an EventReactor.
+ *
+ * Each handshake is a SecureContext attached to a connected, non-blocking
+ * socket. The pipeline calls doHandshakeStep() whenever the socket is ready
+ * for whatever the context last waited on, so a handshake costs a reactor
+ * registration rather than a blocked thread while the peer answers, and a
+ * burst of connections handshakes concurrently instead of one at a time.
+ *
+ * Completions run on a reactor thread, or on the timer thread for timeouts,
+ * and must not block. The caller keeps owning the socket throughout.
+ */
+class HandshakePipeline {
+public:
+    using Completion = std::function<void(const Result<void>& result)>;
+
+    explicit HandshakePipeline(EventReactor& reactor = EventReactor::shared(),
+                               std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+
+    /**
+     * @brief Abandons the handshakes still in flight without calling their completions.
+     */
+    ~HandshakePipeline();
+
+    HandshakePipeline(const HandshakePipeline&) = delete;
+    HandshakePipeline& operator=(const HandshakePipeline&) = delete;
+
+    /**
+     * @brief Starts a handshake; done is called once with its outcome.
+     *
+     * @param fd Connected, non-blocking socket with no reactor registration
+     * @param context Context to handshake, e.g. from SecurityManager::createContext()
+     * @return false if fd already has a handshake in flight or the context cannot attach to it
+     */
+    bool start(int fd, std::shared_ptr<SecureContext> context, Completion done);
+
+    /**
+     * @brief Abandons fd's handshake without calling its completion.
+     *
+     * @return true if it was still in flight
+     */
+    bool cancel(int fd);
+
+    size_t inFlight() const;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> impl_;  // Reactor callbacks hold it weakly
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_HANDSHAKE_PIPELINE_HPP
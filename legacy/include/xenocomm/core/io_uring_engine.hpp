@@ -0,0 +1,142 @@
+#ifndef XENOCOMM_CORE_IO_URING_ENGINE_HPP
+#define XENOCOMM_CORE_IO_URING_ENGINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Completion-based socket I/O on Linux io_uring.
+ *
+ * Operations are queued on a submission ring and completed by a single
+ * completion thread, so an async send or receive costs one io_uring_enter()
+ * and no worker-thread hop. Receive streams use multishot recv with a
+ * kernel-provided buffer ring: one submission delivers every subsequent
+ * segment into pre-registered buffers until the stream is stopped.
+ *
+ * Talks to the kernel through the raw syscalls, so no liburing is needed.
+ * On other platforms, or kernels without the required opcodes, isValid()
+ * is false and shared() returns nullptr; callers keep their fallback path.
+ *
+ * Callbacks run on the completion thread and must not block. Buffers passed
+ * to submitSend()/submitRecv() must stay valid until their callback runs.
+ */
+class IoUringEngine {
+public:
+    /**
+     * @brief Called with the byte count, or a negative errno (-ECANCELED on timeout).
+     */
+    using Completion = std::function<void(int result)>;
+
+    /**
+     * @brief Called per received segment; data is nullptr once the stream ends.
+     *
+     * The data pointer is only valid during the call. result is the segment
+     * length, 0 when the peer closed, or a negative errno.
+     */
+    using StreamCallback = std::function<void(const uint8_t* data, int result)>;
+    using StreamId = uint64_t;
+    using OperationId = uint64_t;
+
+    struct Config {
+        unsigned entries = 256;         ///< Submission ring size
+        unsigned buffer_count = 256;    ///< Provided receive buffers (power of two)
+        size_t buffer_size = 16384;     ///< Bytes per provided receive buffer
+    };
+
+    explicit IoUringEngine(const Config& config);
+    IoUringEngine() : IoUringEngine(Config{}) {}
+    ~IoUringEngine();
+
+    IoUringEngine(const IoUringEngine&) = delete;
+    IoUringEngine& operator=(const IoUringEngine&) = delete;
+
+    /**
+     * @brief Process-wide engine, or nullptr when io_uring is unavailable.
+     */
+    static IoUringEngine* shared();
+
+    /**
+     * @brief Whether the ring was created and supports send and recv.
+     */
+    bool isValid() const { return ringFd_ >= 0; }
+
+    /**
+     * @brief Whether receive streams (multishot recv, Linux 6.0+) are available.
+     */
+    bool supportsStreams() const { return bufferRing_ != nullptr; }
+
+    /**
+     * @brief Queues a send of up to size bytes; the completion may report a partial send.
+     *
+     * @param timeout Cancel the operation after this long; zero waits indefinitely
+     * @param id If given, receives the id to cancel() the operation with
+     */
+    bool submitSend(int fd, const uint8_t* data, size_t size, Completion completion,
+                    std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                    OperationId* id = nullptr);
+
+    /**
+     * @brief Queues a single receive into buffer.
+     */
+    bool submitRecv(int fd, uint8_t* buffer, size_t size, Completion completion,
+                    std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                    OperationId* id = nullptr);
+
+    /**
+     * @brief Asks the kernel to abort one operation; its completion reports -ECANCELED.
+     *
+     * Harmless if the operation already completed.
+     */
+    void cancel(OperationId id);
+
+    /**
+     * @brief Starts a multishot receive delivering every segment to callback.
+     *
+     * @return Stream id, or 0 if streams are unsupported or submission failed
+     */
+    StreamId startRecvStream(int fd, StreamCallback callback);
+
+    /**
+     * @brief Cancels a stream. Once this returns the callback is not running and will not run again.
+     */
+    void stopRecvStream(StreamId id);
+
+    /**
+     * @brief Cancels every operation on fd; call before closing a socket with I/O in flight.
+     */
+    void cancelFd(int fd);
+
+    /**
+     * @brief Operations submitted but not yet completed.
+     */
+    size_t pendingCount() const { return pending_.load(); }
+
+private:
+    struct Ring;
+    struct Operation;
+
+    bool submit(const std::shared_ptr<Operation>& operation, std::chrono::milliseconds timeout);
+    void completionLoop();
+    void recycleBuffer(uint16_t bufferId);
+
+    Config config_;
+    int ringFd_ = -1;
+    std::unique_ptr<Ring> ring_;
+    void* bufferRing_ = nullptr;       // io_uring_buf_ring shared with the kernel
+    size_t bufferRingBytes_ = 0;
+    std::unique_ptr<uint8_t[]> buffers_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_IO_URING_ENGINE_HPP
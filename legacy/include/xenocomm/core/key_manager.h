@@ -4,9 +4,13 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <cstdint>
 #include <optional>
+#include <map>
+#include <mutex>
 #include <unordered_map>
 #include "xenocomm/utils/result.hpp"
+#include "xenocomm/utils/task_scheduler.hpp"
 #include "xenocomm/core/security_config.hpp"
 
 namespace xenocomm {
@@ -32,6 +36,7 @@ struct KeyData {
     std::string keyId;                 // Unique identifier for the key
     bool isRevoked = false;            // Whether the key has been revoked
     std::optional<std::string> purpose;  // Optional purpose/usage of the key
+    std::string successorId;           // Key that replaced this one on rotation, empty while current
 };
 
 /**
@@ -44,6 +49,15 @@ struct KeyGenParams {
     std::optional<std::string> purpose;  // Optional purpose/usage
 };
 
+/**
+ * @brief Automatic rotation schedule for a key, see KeyManager::scheduleRotation()
+ */
+struct KeyRotationPolicy {
+    KeyGenParams params;                       // Parameters for each replacement key
+    std::chrono::seconds lead{60};             // Rotate this long before the key expires
+    std::chrono::seconds gracePeriod{86400};   // How long a replaced key keeps decrypting, at most until its own expiry
+};
+
 /**
  * @brief Parameters for key exchange
  */
@@ -63,18 +77,47 @@ struct KeyExchangeResult {
     std::string peerId;  // ID of the peer
 };
 
+/**
+ * @brief Counters for KeyManager's pool of pre-generated keys
+ */
+struct KeyPoolStats {
+    uint64_t hits = 0;            // Keys and key pairs taken from the pool
+    uint64_t misses = 0;          // Generated on the request path because the pool was empty
+    size_t pooledSymmetric = 0;   // Symmetric keys ready now
+    size_t pooledEphemeral = 0;   // Ephemeral ECDH key pairs ready now
+};
+
 /**
  * @brief Manages cryptographic keys including generation, exchange, and lifecycle
+ *
+ * Keys are held in an immutable snapshot that writers copy, modify and
+ * publish atomically, so lookups never take a lock and never wait for a
+ * rotation. A maintenance task on the shared TaskScheduler runs at the next
+ * KeyData::expiryTime or scheduled rotation and handles only the keys that
+ * are due.
+ *
+ * Unless SecurityConfig::keyPool is disabled, symmetric keys and ephemeral
+ * P-256 and X25519 key pairs come from a pool that another task refills in
+ * the background, sized by recent demand. A size or curve is pooled from the
+ * first time it is asked for; key exchanges then only compute the shared
+ * secret.
  */
 class KeyManager {
 public:
     /**
-     * @brief Creates a KeyManager instance
+     * @brief Creates a KeyManager instance and registers its maintenance task
      * 
      * @param config Security configuration
      */
     explicit KeyManager(const SecurityConfig& config);
-    virtual ~KeyManager() = default;
+
+    /**
+     * @brief Stops the maintenance and key pool tasks
+     *
+     * Subclasses overriding key generation or storage should call
+     * stopMaintenance() from their own destructor.
+     */
+    virtual ~KeyManager();
 
     /**
      * @brief Generates a new key pair or symmetric key
@@ -107,6 +150,9 @@ public:
     /**
      * @brief Rotates a key, generating a new one and marking the old one for expiry
      * 
+     * The old key stays valid for a grace period with successorId set, so
+     * messages already sealed under it still open while senders move over.
+     * 
      * @param keyId ID of the key to rotate
      * @param params Parameters for the new key
      * @return Result<KeyData> New key data or error
@@ -136,6 +182,53 @@ public:
      */
     virtual Result<KeyData> getKey(const std::string& keyId) const;
 
+    /**
+     * @brief Lock-free lookup for per-message use
+     * 
+     * The returned key stays alive while held, even if it is rotated or
+     * removed meanwhile.
+     * 
+     * @param keyId ID of the key to retrieve
+     * @return Key, or null if unknown, revoked or expired
+     */
+    std::shared_ptr<const KeyData> findKey(const std::string& keyId) const;
+
+    /**
+     * @brief Like findKey(), but follows rotations to the newest valid key
+     * 
+     * Senders can keep using the ID they started with and pick up each
+     * replacement as soon as it is published.
+     */
+    std::shared_ptr<const KeyData> findCurrentKey(const std::string& keyId) const;
+
+    /**
+     * @brief Rotates a key automatically policy.lead before each expiry
+     * 
+     * Each replacement inherits the policy.
+     * 
+     * @param keyId ID of the key to rotate
+     * @param policy Rotation schedule and parameters for the replacement keys
+     * @return Result<void> Success or error
+     */
+    Result<void> scheduleRotation(const std::string& keyId, const KeyRotationPolicy& policy);
+
+    /**
+     * @brief Stops rotating a key automatically
+     */
+    void cancelRotation(const std::string& keyId);
+
+    /**
+     * @brief Stops the maintenance task; expired keys are then only removed by cleanupKeys()
+     *
+     * Also stops refilling the key pool, so later keys are generated on the request path.
+     */
+    void stopMaintenance();
+
+    /**
+     * @brief Pool hits and misses so far, and the keys ready now
+     */
+    KeyPoolStats getKeyPoolStats() const;
+
     /**
      * @brief Lists all active keys
      * 
@@ -202,14 +295,37 @@ protected:
     virtual Result<void> storeKey(const KeyData& keyData);
 
     /**
-     * @brief Performs cleanup of expired and revoked keys
+     * @brief Removes the expired and revoked keys that are due, without scanning the store
      */
     virtual void cleanupKeys();
 
 private:
+    using KeyStore = std::unordered_map<std::string, std::shared_ptr<const KeyData>>;
+
+    struct Deadline {
+        std::string keyId;
+        bool rotate;  // Rotation point rather than expiry
+    };
+
+    std::shared_ptr<const KeyStore> snapshot() const { return std::atomic_load(&keyStore_); }
+    void publish(std::shared_ptr<const KeyStore> store) { std::atomic_store(&keyStore_, std::move(store)); }
+    void scheduleDeadline(std::chrono::system_clock::time_point when, const std::string& keyId, bool rotate);
+    std::vector<Deadline> takeDueDeadlines(bool includeRotations);
+    void removeExpiredKeys(const std::vector<Deadline>& due);
+    void rotateDueKeys(const std::vector<Deadline>& due);
+    void runMaintenance();
+    void runMaintenanceBy(std::chrono::system_clock::time_point when);
+    void requestPoolRefill();
+
     SecurityConfig config_;
-    std::unordered_map<std::string, KeyData> keyStore_;
-    mutable std::mutex keyStoreMutex_;
+    std::shared_ptr<const KeyStore> keyStore_;  // Replaced atomically, never modified in place
+    mutable std::mutex keyStoreMutex_;          // Serializes writers only
+    std::mutex scheduleMutex_;
+    std::multimap<std::chrono::system_clock::time_point, Deadline> deadlines_;
+    std::unordered_map<std::string, KeyRotationPolicy> rotationPolicies_;
+    bool stopping_{false};
+    utils::TaskScheduler::TaskId maintenanceTask_{utils::TaskScheduler::INVALID_TASK};
+    utils::TaskScheduler::TaskId poolTask_{utils::TaskScheduler::INVALID_TASK};
     std::unique_ptr<class KeyManagerImpl> impl_;
 };
 
@@ -0,0 +1,193 @@
+#ifndef XENOCOMM_CORE_LINK_HEALTH_HPP
+#define XENOCOMM_CORE_LINK_HEALTH_HPP
+
+#include "xenocomm/core/event_reactor.hpp"
+#include "xenocomm/core/transport_protocol.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief When a link's own traffic says it is healthy, idle or failing.
+ */
+struct LinkHealthPolicy {
+    std::chrono::milliseconds idleAfter{5000};  ///< No traffic or heartbeat for this long makes a link idle
+    uint32_t maxConsecutiveErrors = 3;          ///< This many I/O errors in a row make it failing
+
+    /**
+     * @brief Sends since the peer was last heard from that, once the silence
+     * outlasts responseTimeout, make the link failing; 0 disables the check.
+     *
+     * For request/response traffic, where every send should be answered.
+     */
+    uint32_t maxUnansweredSends = 0;
+    std::chrono::milliseconds responseTimeout{10000};
+};
+
+enum class LinkVerdict {
+    HEALTHY,  ///< Recent traffic or heartbeat and no run of errors
+    IDLE,     ///< Nothing recent to judge by; worth a probe
+    FAILING   ///< Errors or unanswered sends say the link is down
+};
+
+/**
+ * @brief Health of one connection inferred from the traffic it already carries.
+ *
+ * Transports record each successful send and receive and each I/O error;
+ * recording is a few relaxed atomic stores, cheap enough for every call.
+ * assess() then judges the link without touching the socket, so an active
+ * probe is only needed once a link has gone quiet.
+ */
+class LinkHealth {
+public:
+    struct Snapshot {
+        int64_t lastHeardMs = 0;  ///< steadyMs() of the last receive, 0 if none
+        int64_t lastSentMs = 0;
+        int64_t lastProbeMs = 0;  ///< Last successful probe or heartbeat
+        uint32_t unansweredSends = 0;
+        uint32_t consecutiveErrors = 0;
+        uint64_t totalErrors = 0;
+    };
+
+    void recordSent();
+    void recordHeard();
+    void recordError();
+
+    /**
+     * @brief Records an active probe; a failed one counts as an error.
+     */
+    void recordProbe(bool ok);
+
+    /**
+     * @brief Starts over for a new connection, which counts as hearing from the peer.
+     */
+    void reset();
+
+    LinkVerdict assess(const LinkHealthPolicy& policy) const;
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Milliseconds on the steady clock, the unit of every timestamp here.
+     */
+    static int64_t steadyMs();
+
+private:
+    std::atomic<int64_t> lastHeardMs_{0};
+    std::atomic<int64_t> lastSentMs_{0};
+    std::atomic<int64_t> lastProbeMs_{0};
+    std::atomic<uint32_t> unansweredSends_{0};
+    std::atomic<uint32_t> consecutiveErrors_{0};
+    std::atomic<uint64_t> totalErrors_{0};
+};
+
+/**
+ * @brief Whether an error reported by a transport says something about the link itself.
+ *
+ * Argument, state and capacity errors are the caller's; these are the network's.
+ */
+bool isLinkError(TransportError error);
+
+/**
+ * @brief One heartbeat per remote host for every registered connection.
+ *
+ * A single timer on the reactor assesses every registered link from its
+ * LinkHealth, which costs no syscalls. Links whose traffic shows them
+ * healthy are left alone. Of a host's idle links, one is probed per round,
+ * and a successful probe stands as the heartbeat for all of that host's
+ * idle links until they go idle again, so a host with a thousand quiet
+ * connections costs one probe per idleAfter rather than a thousand. A link
+ * that turns failing has its failure handler run once, and again only
+ * after it has recovered and failed anew.
+ *
+ * Probes and failure handlers run on a reactor loop thread and must not
+ * block. remove() guarantees neither is running or will run for that link
+ * once it returns, unless called from one of them.
+ */
+class HeartbeatScheduler {
+public:
+    using Registration = uint64_t;
+    using Probe = std::function<bool()>;
+    using FailureHandler = std::function<void()>;
+
+    struct Stats {
+        uint64_t rounds = 0;
+        uint64_t assessments = 0;  ///< Link checks made from traffic alone
+        uint64_t probes = 0;       ///< Active probes issued
+        uint64_t coalesced = 0;    ///< Idle links covered by another link's heartbeat instead of their own probe
+        uint64_t failures = 0;     ///< Failure handlers run
+    };
+
+    explicit HeartbeatScheduler(std::chrono::milliseconds tick = std::chrono::milliseconds(250),
+                                EventReactor& reactor = EventReactor::shared());
+    ~HeartbeatScheduler();
+
+    HeartbeatScheduler(const HeartbeatScheduler&) = delete;
+    HeartbeatScheduler& operator=(const HeartbeatScheduler&) = delete;
+
+    /**
+     * @brief Process-wide scheduler shared by all transports.
+     */
+    static HeartbeatScheduler& shared();
+
+    /**
+     * @brief Starts watching a link; health must outlive the registration.
+     *
+     * @param host Remote host the link's heartbeats are shared with
+     * @return Handle for remove(), never 0
+     */
+    Registration add(const std::string& host, LinkHealth& health, const LinkHealthPolicy& policy,
+                     Probe probe, FailureHandler onFailure);
+
+    void remove(Registration id);
+
+    /**
+     * @brief Runs one round now instead of waiting for the timer.
+     */
+    void runOnce();
+
+    size_t linkCount() const;
+    Stats getStats() const;
+
+private:
+    struct Link {
+        Registration id;
+        LinkHealth* health;
+        LinkHealthPolicy policy;
+        Probe probe;
+        FailureHandler onFailure;
+        bool failureReported = false;  // Only touched by the round
+        bool removed = false;          // Set by remove(), which excludes the round or runs inside it
+    };
+
+    struct Host {
+        std::vector<std::shared_ptr<Link>> links;
+        size_t nextProbe = 0;  // Rotates the probe over the host's idle links
+    };
+
+    EventReactor& reactor_;
+    EventReactor::TimerId timer_{0};
+
+    mutable std::mutex mutex_;  ///< Guards the registry
+    std::unordered_map<std::string, Host> hosts_;
+    std::unordered_map<Registration, std::string> hostOf_;
+    Registration nextId_{1};
+    Stats stats_;
+
+    std::mutex roundMutex_;  ///< Held while a round runs probes and handlers
+    std::atomic<std::thread::id> roundThread_{};
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_LINK_HEALTH_HPP
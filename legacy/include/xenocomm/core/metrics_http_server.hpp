@@ -0,0 +1,56 @@
+#ifndef XENOCOMM_CORE_METRICS_HTTP_SERVER_HPP
+#define XENOCOMM_CORE_METRICS_HTTP_SERVER_HPP
+
+#include "xenocomm/core/socket_defs.hpp"
+#include "xenocomm/utils/metrics_registry.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Serves a MetricsRegistry over HTTP for Prometheus and OpenMetrics scrapers.
+ *
+ * GET /metrics returns the registry's exposition: OpenMetrics when the
+ * request's Accept header asks for application/openmetrics-text, the
+ * Prometheus text format otherwise. Any other path gets 404. Requests are
+ * answered one at a time on the server's own thread; scrapes are rare
+ * enough that it never needs more.
+ */
+class MetricsHttpServer {
+public:
+    explicit MetricsHttpServer(utils::MetricsRegistry& registry = utils::MetricsRegistry::shared());
+    ~MetricsHttpServer();
+
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    /**
+     * @brief Starts listening; port 0 picks a free port, reported by port().
+     *
+     * @return false if already running or the address cannot be bound
+     */
+    bool start(uint16_t port, const std::string& bind_address = "127.0.0.1");
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    uint16_t port() const { return port_; }
+
+private:
+    void serve();
+    void handle(socket_t client);
+
+    utils::MetricsRegistry& registry_;
+    socket_t listener_ = INVALID_SOCKET_VALUE;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_METRICS_HTTP_SERVER_HPP
@@ -34,6 +34,9 @@ public:
     MOCK_METHOD(void, setStateCallback, (std::function<void(ConnectionState)> callback), (override));
     MOCK_METHOD(void, setErrorCallback, (std::function<void(TransportError, const std::string&)> callback), (override));
     MOCK_METHOD(bool, checkHealth, (), (override));
+    MOCK_METHOD(bool, isReliableStream, (), (const, override));
+    MOCK_METHOD(ssize_t, sendFrame, (const utils::ByteSpan* parts, size_t count), (override));
+    MOCK_METHOD(ssize_t, receiveFrame, (utils::PooledBuffer& frame), (override));
 };
 
 } // namespace core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "xenocomm/core/capability_cache.h"
+#include "xenocomm/core/negotiation_protocol.h"
+#include <cstdint>
+#include <string>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Identifies a negotiation whose outcome can be reused.
+ *
+ * Two negotiations with the same peer reach the same parameters as long as
+ * neither side's preferences nor the peer's advertised capabilities have
+ * changed, so the key carries a digest of each alongside the peer.
+ */
+struct NegotiationCacheKey {
+    std::string peerId;           ///< The targetAgentId negotiated with
+    uint64_t preferenceHash{0};   ///< hashPreference() of the local preferences
+    uint64_t capabilityHash{0};   ///< hashPeerCapabilities() of the peer's capabilities
+
+    bool operator==(const NegotiationCacheKey& other) const {
+        return preferenceHash == other.preferenceHash &&
+               capabilityHash == other.capabilityHash &&
+               peerId == other.peerId;
+    }
+};
+
+/**
+ * @brief Hash functor for NegotiationCacheKey.
+ */
+struct NegotiationCacheKeyHash {
+    size_t operator()(const NegotiationCacheKey& key) const;
+};
+
+/**
+ * @brief Digest of a ParameterPreference, covering every ranked option and fallback
+ *
+ * The digest is independent of host byte order, so peers can exchange it.
+ */
+uint64_t hashPreference(const ParameterPreference& preferences);
+
+/**
+ * @brief Digest of the remote capabilities recorded in a negotiation session
+ */
+uint64_t hashPeerCapabilities(const NegotiationSessionData& session);
+
+/**
+ * @brief Decides, as the responder, whether to confirm a resume request
+ *
+ * Cached parameters are confirmed only if they still satisfy the local
+ * requirements; a peer whose preferences changed since the parameters were
+ * agreed refuses, and the initiator falls back to a full negotiation.
+ *
+ * @param preferences The responder's current preferences
+ * @param cachedParams The parameters the initiator asks to resume with
+ * @return true if the responder should reply RESUME_ACK
+ */
+bool acceptsResume(const ParameterPreference& preferences, const NegotiableParams& cachedParams);
+
+/**
+ * @brief Cache of finalized negotiation results for repeat peers.
+ *
+ * Entries expire after CacheConfig::ttl. A hit is confirmed with the peer by
+ * NegotiationProtocol::resumeSession() in one round trip instead of the
+ * propose, respond and finalize exchange.
+ */
+using NegotiationCache = BasicCapabilityCache<NegotiableParams, NegotiationCacheKey, NegotiationCacheKeyHash>;
+
+extern template class BasicCapabilityCache<NegotiableParams, NegotiationCacheKey, NegotiationCacheKeyHash>;
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "xenocomm/core/negotiation_protocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Leading byte of encoded negotiation parameters (format version 1).
+ */
+constexpr uint8_t NEGOTIATION_PARAMS_FORMAT_V1 = 0xA1;
+
+/**
+ * @brief Compact binary encoding of NegotiableParams for negotiation messages.
+ *
+ * The format is:
+ * - format: one byte, NEGOTIATION_PARAMS_FORMAT_V1.
+ * - length: varint byte count of the fields that follow.
+ * - fields: a tag byte each, the field number in the low five bits and the
+ *   wire type in the top three, then the value:
+ *   - BYTE (0): one byte, used for every enum.
+ *   - VARINT (1): a varint; versions of the form major.minor.patch, each
+ *     part below 1024, are packed into one as major << 20 | minor << 10 | patch.
+ *   - BYTES (2): varint length, then that many bytes; versions that do not
+ *     pack are sent as text this way.
+ * Varints are unsigned LEB128: seven bits per byte, low bits first.
+ *
+ * Fields equal to their NegotiableParams default are left out, so a typical
+ * proposal takes a couple of dozen bytes. Each custom parameter is its own
+ * BYTES field holding a key reference (varint), then the value bytes; the
+ * reference is the key's position in the key table plus one, or 0 followed by
+ * the key as length and bytes for keys not in the table. Both peers must use
+ * the same key table; new keys are only ever appended to it.
+ *
+ * Decoders skip fields they do not know by their wire type, so fields can be
+ * added without a new format version.
+ */
+class NegotiationParamsCodec {
+public:
+    /**
+     * @param keys Custom parameter keys to send as table references
+     */
+    explicit NegotiationParamsCodec(std::vector<std::string> keys = defaultKeys());
+
+    /**
+     * @brief The custom parameter keys the SDK itself uses.
+     */
+    static const std::vector<std::string>& defaultKeys();
+
+    /**
+     * @brief Appends the encoding of params to out. Existing contents are preserved.
+     */
+    void encode(const NegotiableParams& params, std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Number of bytes encode() appends for params.
+     */
+    size_t encodedSize(const NegotiableParams& params) const;
+
+    /**
+     * @brief Decodes parameters written by encode(), with bounds checking.
+     *
+     * @param[out] bytesRead Optional pointer to store the number of bytes consumed.
+     * @return False if the bytes are not a valid encoding or an enum is out of range.
+     */
+    bool decode(const uint8_t* data, size_t size, NegotiableParams& out, size_t* bytesRead = nullptr) const;
+
+private:
+    // Writes the fields of params to sink, which either counts or stores them
+    template <typename Sink>
+    void writeFields(const NegotiableParams& params, Sink& sink) const;
+
+    bool readCustomParameter(const uint8_t* data, size_t size, NegotiableParams& out) const;
+
+    std::vector<std::string> keys_;
+    std::unordered_map<std::string, uint32_t> keyIndex_;  // Key -> position in keys_
+};
+
+} // namespace core
+} // namespace xenocomm
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <map>
@@ -23,6 +24,10 @@ enum class DataFormat : uint8_t {
     COMPRESSED_STATE,
     BINARY_CUSTOM,
     GGWAVE_FSK, // Example of a specific modulation scheme
+    VECTOR_FLOAT16,
+    VECTOR_BFLOAT16,
+    VECTOR_INT4,
+    GGWAVE_FSK_MULTIBAND, // GGWAVE_FSK with parallel tone bands; offer it only when configured for it
     // Add more formats as needed
 };
 
@@ -37,6 +42,23 @@ enum class CompressionAlgorithm : uint8_t {
     // Add more algorithms as needed
 };
 
+/**
+ * @brief The getAlgorithmId() of the class implementing a compression algorithm
+ *
+ * createCompressionAlgorithm() in compression_algorithms.h turns the ID into
+ * an implementation, so a negotiated algorithm can be put to use.
+ *
+ * @return The ID, or an empty string for NONE
+ */
+inline std::string compressionAlgorithmId(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::ZLIB: return "ZLIB";
+        case CompressionAlgorithm::LZ4: return "LZ4";
+        case CompressionAlgorithm::ZSTD: return "ZSTD";
+        default: return "";
+    }
+}
+
 /**
  * @brief Defines possible error correction schemes.
  */
@@ -136,6 +158,17 @@ struct NegotiableParams {
     }
 };
 
+/**
+ * @brief Whether updated differs from current only in parameters that can change mid-session.
+ * 
+ * compressionAlgorithm, errorCorrection and customParameters (which carry
+ * transmission settings such as fragment sizes) only affect how the next
+ * message is encoded, so NegotiationProtocol::renegotiateSession() may change
+ * them; versions, the data format and the security parameters are fixed for
+ * the life of a session.
+ */
+bool isRenegotiable(const NegotiableParams& current, const NegotiableParams& updated);
+
 /**
  * @brief Represents a ranked option with fallback alternatives for parameter negotiation.
  * 
@@ -244,6 +277,9 @@ struct ParameterPreference {
      * @param local Local ranked options with fallbacks
      * @param remote Available options from remote peer
      * @return The best matching value or nullopt if no match found
+     *
+     * Defined in preference_table.h; CompiledPreference::findBestMatch() avoids
+     * recompiling local on every call.
      */
     template <typename T>
     std::optional<T> findBestMatchWithFallbacks(
@@ -252,6 +288,9 @@ struct ParameterPreference {
 
     /**
      * @brief Generates alternative parameter sets when initial proposal is rejected.
+     *
+     * Alternatives come best-ranked first; see AlternativeProposals in
+     * preference_table.h to draw them one at a time.
      */
     std::vector<NegotiableParams> generateAlternativeProposals(
         const NegotiableParams& rejectedProposal,
@@ -380,6 +419,16 @@ struct ParameterPreference {
     }
 };
 
+/**
+ * @brief What became of an application message sent speculatively with a proposal.
+ */
+enum class EarlyDataStatus {
+    NONE,       // No early data was sent or received on this session
+    PENDING,    // Sent or received, and the proposal has not been answered yet
+    ACCEPTED,   // The proposal was accepted unchanged, so the responder processes the data
+    REJECTED    // The proposal was countered or rejected; the data was discarded and must be resent
+};
+
 /**
  * @brief Represents the state of a negotiation session.
  * 
@@ -435,6 +484,13 @@ struct NegotiationSessionData {
     std::vector<KeyExchangeMethod> remoteKeyExchange;
     std::vector<AuthenticationMethod> remoteAuth;
     std::vector<KeySize> remoteKeySizes;
+    // Set when the session confirms cached parameters instead of negotiating
+    bool resumed = false;
+    // Parameters offered by renegotiateSession(), until the peer answers
+    std::optional<NegotiableParams> pendingParams;
+    // Application message sent along with the proposal, held by the responder until taken
+    EarlyDataStatus earlyDataStatus = EarlyDataStatus::NONE;
+    std::vector<uint8_t> earlyData;
     // Constructor with initialization
     NegotiationSessionData() {
         // Record initial state timestamp
@@ -555,6 +611,22 @@ public:
     virtual bool rejectCounterProposal(const SessionId sessionId,
                                      const std::optional<std::string>& reason) = 0;
 
+    /**
+     * @brief (Initiator Role) The counter-proposal awaiting a decision, if any.
+     * 
+     * Lets the initiator inspect a counter-proposal before choosing between
+     * acceptCounterProposal() and rejectCounterProposal().
+     * 
+     * @param sessionId The ID of the session to query.
+     * @return The counter-proposed parameters in the COUNTER_RECEIVED state, std::nullopt otherwise
+     *         or if the implementation does not expose them.
+     * @throws std::runtime_error If the session ID is invalid.
+     */
+    virtual std::optional<NegotiableParams> getCounterProposal(const SessionId sessionId) const {
+        (void)sessionId;
+        return std::nullopt;
+    }
+
     /**
      * @brief Closes a negotiation session explicitly.
      * 
@@ -566,6 +638,110 @@ public:
      */
     virtual bool closeSession(const SessionId sessionId) = 0;
 
+    /**
+     * @brief Resumes a session with a peer using parameters agreed in an earlier session.
+     * 
+     * Sends the cached parameters for the peer to confirm in one round trip.
+     * If the peer confirms them the session goes straight to FINALIZED, with no
+     * counter-proposal or finalization step; if it refuses, the session FAILS
+     * and the caller negotiates afresh with initiateSession(). Callers typically
+     * look the parameters up in a NegotiationCache.
+     * 
+     * Implementations without a resume exchange, or that cannot send the
+     * resume request, negotiate in full, proposing the cached parameters.
+     * 
+     * @param targetAgentId The unique identifier of the agent to resume with.
+     * @param cachedParams The parameters previously finalized with this agent.
+     * @return A unique SessionId for the resumed session, or for the full
+     *         negotiation that replaced it.
+     * @throws std::runtime_error If the parameters are invalid or no request can be sent.
+     */
+    virtual SessionId resumeSession(const std::string& targetAgentId,
+                                    const NegotiableParams& cachedParams) {
+        return initiateSession(targetAgentId, cachedParams);
+    }
+
+    /**
+     * @brief Initiates a session and sends the first application message with the proposal.
+     * 
+     * earlyData must already be encoded with proposedParams. If the responder
+     * accepts those parameters unchanged, it processes the message at once
+     * (see takeEarlyData()) and the conversation saves a round trip. If it
+     * counters or rejects, the message is discarded and getEarlyDataStatus()
+     * reports REJECTED; the initiator sends it again, encoded with the final
+     * parameters, once the session is finalized.
+     * 
+     * Early data can be replayed by anyone who captures the proposal, so send
+     * only requests that are safe to process twice.
+     * 
+     * Implementations without early data send the proposal alone and report
+     * NONE, which callers treat like REJECTED.
+     * 
+     * @param targetAgentId The unique identifier of the agent to negotiate with.
+     * @param proposedParams The initial set of parameters, normally the top-ranked ones.
+     * @param earlyData The first application message, encoded with proposedParams.
+     * @return A unique SessionId for the initiated negotiation.
+     * @throws std::runtime_error If initiation fails (e.g., target agent unreachable).
+     */
+    virtual SessionId initiateSessionWithEarlyData(const std::string& targetAgentId,
+                                                   const NegotiableParams& proposedParams,
+                                                   const std::vector<uint8_t>& earlyData) {
+        (void)earlyData;
+        return initiateSession(targetAgentId, proposedParams);
+    }
+
+    /**
+     * @brief Whether the early data of a session was processed, on either side.
+     * 
+     * @param sessionId The ID of the session to query.
+     * @return ACCEPTED once the proposal was accepted unchanged; anything but
+     *         ACCEPTED after the response means the message must be resent.
+     * @throws std::runtime_error If the session ID is invalid.
+     */
+    virtual EarlyDataStatus getEarlyDataStatus(const SessionId sessionId) const {
+        (void)sessionId;
+        return EarlyDataStatus::NONE;
+    }
+
+    /**
+     * @brief (Responder Role) Takes the early data of a session after accepting its proposal.
+     * 
+     * @param sessionId The ID of the session to query.
+     * @return The message, once, if the proposal carried one and was accepted
+     *         unchanged; std::nullopt otherwise.
+     * @throws std::runtime_error If the session ID is invalid.
+     */
+    virtual std::optional<std::vector<uint8_t>> takeEarlyData(const SessionId sessionId) {
+        (void)sessionId;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Changes the parameters of a finalized session without closing it.
+     * 
+     * Offers updatedParams to the peer in-band; only the parameters
+     * isRenegotiable() allows may differ from the agreed ones. The session
+     * stays FINALIZED throughout and messages keep flowing under the agreed
+     * parameters until the peer confirms, at which point getNegotiatedParams()
+     * reports the new set. The caller then hands the change to its
+     * TransmissionManager with set_config(), which applies it at the next
+     * message boundary without waiting for data in flight. If the peer refuses,
+     * the agreed parameters stay in force.
+     * 
+     * Implementations without a renegotiation exchange return false; the caller
+     * then closes the session and negotiates afresh.
+     * 
+     * @param sessionId The ID of a FINALIZED session.
+     * @param updatedParams The agreed parameters with the changes applied.
+     * @return True if the update was offered, false if renegotiation is not supported.
+     * @throws std::runtime_error If the session is not FINALIZED, already renegotiating,
+     *         or updatedParams change a fixed parameter or are invalid.
+     */
+    virtual bool renegotiateSession(const SessionId sessionId, const NegotiableParams& updatedParams) {
+        (void)sessionId; (void)updatedParams;
+        return false;
+    }
+
 protected:
     // Protected constructor for abstract base class
     NegotiationProtocol() = default;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "xenocomm/core/feedback_loop.h"
+#include "xenocomm/utils/result.hpp"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+
+/**
+ * @brief Leading bytes of an outcome segment file (format version 1).
+ */
+constexpr uint32_t OUTCOME_SEGMENT_MAGIC = 0x31475358;  // "XSG1"
+
+/**
+ * @brief A segment file of the store and the outcomes it holds.
+ */
+struct OutcomeSegmentInfo {
+    std::string path;
+    uint32_t count{0};
+    std::chrono::system_clock::time_point first;  ///< Earliest timestamp in the segment
+    std::chrono::system_clock::time_point last;   ///< Latest timestamp in the segment
+    bool verified{false};                         ///< Checksum already checked by a query
+};
+
+/**
+ * @brief Append-only, columnar on-disk history of communication outcomes.
+ *
+ * Each append() writes one immutable segment file. A segment begins with a
+ * fixed header (magic, count, first and last timestamp, the byte length of
+ * each column and a CRC32 of everything after the header), followed by the
+ * columns, each a run of varints for the outcomes in timestamp order:
+ * - timestamps: nanoseconds since the epoch, the first as is and the rest as
+ *   zigzag delta-of-deltas, so evenly spaced outcomes cost a byte each.
+ * - latency: zigzag deltas of the microseconds from the previous outcome.
+ * - bytes, retries, errors: plain varints.
+ * - flags: success in the low bit, the error type's dictionary index above it.
+ * - dictionary: count, then length and bytes of each distinct error type;
+ *   index 0 is always the empty string and is not stored.
+ * - index: after every INDEX_BLOCK outcomes but the last block, a fixed-size
+ *   entry with the block's last timestamp, the timestamp delta and latency
+ *   the decoder holds there, and the offset of the next block in each of the
+ *   six value columns.
+ *
+ * Queries skip segments whose first and last timestamps miss the range,
+ * memory-map the rest, binary-search the index for the block where the range
+ * starts and stop decoding at its end, so reading a short range out of long
+ * history touches a few blocks. A segment's checksum is verified the first
+ * time a query maps it. Saving never rewrites history; compact() merges
+ * segments into one. Thread-safe.
+ */
+class OutcomeSegmentStore {
+public:
+    static constexpr uint32_t INDEX_BLOCK = 128;  ///< Outcomes per index entry
+
+    /**
+     * @param directory Where segment files live; created if missing
+     */
+    explicit OutcomeSegmentStore(std::string directory);
+
+    /**
+     * @brief Writes outcomes as a new segment. They need not be sorted; nothing is written if empty.
+     */
+    Result<void> append(const std::vector<CommunicationOutcome>& outcomes);
+
+    /**
+     * @brief Outcomes with start <= timestamp <= end, in timestamp order.
+     */
+    Result<std::vector<CommunicationOutcome>> query(std::chrono::system_clock::time_point start,
+                                                    std::chrono::system_clock::time_point end) const;
+
+    /**
+     * @brief Merges every segment into one, dropping outcomes before retainFrom.
+     */
+    Result<void> compact(std::chrono::system_clock::time_point retainFrom);
+
+    /**
+     * @brief Deletes segments that hold only outcomes before cutoff.
+     */
+    Result<void> dropBefore(std::chrono::system_clock::time_point cutoff);
+
+    /**
+     * @brief Earliest stored timestamp, or std::nullopt if the store is empty.
+     */
+    std::optional<std::chrono::system_clock::time_point> oldest() const;
+
+    std::vector<OutcomeSegmentInfo> segments() const;
+
+    /**
+     * @brief Encodes sorted outcomes as one segment.
+     */
+    static std::vector<uint8_t> encodeSegment(const std::vector<CommunicationOutcome>& sorted);
+
+    /**
+     * @brief Decodes a segment with bounds and checksum checking, appending
+     *        the outcomes in [start, end] to out.
+     *
+     * @param verify Whether to check the payload checksum, which reads the whole segment
+     * @return False if the bytes are not a valid segment.
+     */
+    static bool decodeSegment(const uint8_t* data, size_t size, std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end, std::vector<CommunicationOutcome>& out,
+                              bool verify = true);
+
+private:
+    Result<void> writeSegment(const std::vector<uint8_t>& bytes, OutcomeSegmentInfo info);
+    void scan();
+
+    std::string directory_;
+    mutable std::mutex mutex_;
+    mutable std::vector<OutcomeSegmentInfo> segments_;  // In file order; queries mark them verified
+    uint64_t nextSequence_{0};
+};
+
+} // namespace xenocomm
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "xenocomm/core/feedback_loop.h"
+#include "xenocomm/core/negotiation_protocol.h"
+#include "xenocomm/core/preference_table.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Tuning for ParameterPerformanceModel
+ */
+struct ParameterPerformanceConfig {
+    double learningRate{0.2};             ///< Weight of each observation in the running averages
+    uint32_t minSamples{8};               ///< Observations of a value before its measurements override its rank
+};
+
+/**
+ * @brief Running measurements of one parameter value on one peer's link
+ */
+struct ParameterStats {
+    double latencySeconds{0.0};    ///< Average time to deliver a message, retries included
+    double retries{0.0};           ///< Average retransmissions per message
+    double successRate{1.0};       ///< Fraction of messages delivered
+    uint32_t samples{0};
+
+    /**
+     * @brief Expected seconds to get a message through
+     *
+     * The average delivery time, scaled up for the messages that never
+     * arrive and must be sent again by a higher layer. Error correction that
+     * saves retransmissions on a lossy link shows up as lower latency and a
+     * higher success rate; on a clean link its encoding time only adds.
+     */
+    double expectedCost() const;
+};
+
+/**
+ * @brief Learns what each data format, compression algorithm and error
+ *        correction scheme costs on each peer's link, and ranks options by it.
+ *
+ * Static ranks say what an agent prefers in general; they cannot say that
+ * Reed-Solomon pays for itself on a lossy radio link and is pure overhead on
+ * a clean wired one. Outcomes of real traffic, reported with the
+ * parameters that were in use, are attributed to each of those three values
+ * and averaged separately per peer and across all peers.
+ *
+ * rankByPerformance() turns the measurements into preferences that the
+ * existing negotiation code consumes unchanged: among the options of a
+ * dimension that have been measured often enough, ranks are reassigned in
+ * order of expected cost, and options without enough data keep their static
+ * rank. A peer with too little history of its own borrows the figures
+ * measured across all peers. Requirements and fallbacks are never changed.
+ * BatchNegotiator, given a model, proposes each peer what its link ranks first.
+ *
+ * If a FeedbackLoop is given, every outcome is also reported to it, labeled
+ * with the peer, data format and compression in use, so its link-wide and
+ * per-label metrics and any StrategyAdapter built on it see the same traffic.
+ * Thread-safe.
+ */
+class ParameterPerformanceModel {
+public:
+    explicit ParameterPerformanceModel(const ParameterPerformanceConfig& config = ParameterPerformanceConfig(),
+                                       std::shared_ptr<FeedbackLoop> feedback = nullptr);
+
+    /**
+     * @brief Records how a message to peerId went under params
+     */
+    void observe(const std::string& peerId, const NegotiableParams& params,
+                 const CommunicationOutcome& outcome);
+
+    /**
+     * @brief Measurements of value on peerId's link; an empty peerId gives the figures across all peers
+     */
+    std::optional<ParameterStats> stats(const std::string& peerId, DataFormat value) const;
+    std::optional<ParameterStats> stats(const std::string& peerId, CompressionAlgorithm value) const;
+    std::optional<ParameterStats> stats(const std::string& peerId, ErrorCorrectionScheme value) const;
+
+    /**
+     * @brief preferences with data formats, compression and error correction re-ranked for peerId
+     */
+    ParameterPreference rankByPerformance(const ParameterPreference& preferences,
+                                          const std::string& peerId) const;
+
+    /**
+     * @brief Forgets everything measured for peerId, e.g. after its link changed
+     */
+    void resetPeer(const std::string& peerId);
+
+private:
+    using Slots = std::array<ParameterStats, RankTable<DataFormat>::SLOTS>;
+
+    struct PeerStats {
+        Slots formats;
+        Slots compression;
+        Slots errorCorrection;
+    };
+
+    void update(ParameterStats& stats, const CommunicationOutcome& outcome) const;
+
+    template <typename T>
+    void rerank(std::vector<RankedOption<T>>& options, const Slots* peer, const Slots& all) const;
+
+    template <typename T>
+    std::optional<ParameterStats> lookup(const std::string& peerId, T value,
+                                         Slots PeerStats::*dimension) const;
+
+    ParameterPerformanceConfig config_;
+    std::shared_ptr<FeedbackLoop> feedback_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, PeerStats> peers_;  // "" holds the figures across all peers
+};
+
+} // namespace core
+} // namespace xenocomm
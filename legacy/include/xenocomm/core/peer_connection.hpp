@@ -0,0 +1,220 @@
+#ifndef XENOCOMM_CORE_PEER_CONNECTION_HPP
+#define XENOCOMM_CORE_PEER_CONNECTION_HPP
+
+#include "xenocomm/core/event_reactor.hpp"
+#include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+#include "xenocomm/utils/frame_codec.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Settings shared by every connection of a PeerConnectionEngine.
+ */
+struct PeerEngineConfig {
+    size_t maxConnections = 1 << 20;            ///< Handles the engine can hold at once
+    std::chrono::milliseconds idleTimeout{0};   ///< Close connections silent this long; 0 keeps them open
+    utils::FrameLengthEncoding encoding = utils::FrameLengthEncoding::VARINT;
+    size_t maxFrameSize = 16 * 1024 * 1024;     ///< Larger inbound frames close the connection
+    size_t maxPendingBytes = 4 * 1024 * 1024;   ///< Unsent bytes one connection may buffer before send() refuses
+    int listenBacklog = 4096;
+};
+
+/**
+ * @brief Many framed peer connections sharing one set of machinery.
+ *
+ * A TCPTransport is a full client: its own pool, priority queues, health
+ * timer, callbacks and error strings, which is right for a handful of
+ * upstream links and far too much for every peer of a busy node. Here each
+ * connection is a small handle in a slab: the socket, its state, the length
+ * prefix being read and two buffers that are empty (and unallocated) while
+ * the connection is idle. Everything else belongs to the engine and is
+ * paid for once: the EventReactor watching the sockets, one idle sweep
+ * timer, the callbacks, a per-loop-thread receive buffer, and striped locks
+ * in place of a mutex per connection.
+ *
+ * Messages are length-prefixed frames, as with TCPTransport's framing.
+ * Inbound frames that arrive whole in one read are delivered as views into
+ * the receive buffer without copying; only frames split across reads are
+ * assembled in the connection's buffer, which is released again once the
+ * frame is delivered. Outbound frames are written straight to the socket;
+ * only what the kernel will not take is buffered until the socket drains.
+ *
+ * Connections are named by ConnectionId, which includes a generation, so an
+ * id whose connection has closed never reaches the connection that reuses
+ * its handle. Callbacks run on the reactor's loop threads, must not block and
+ * should be set before the first connection. Every other method is
+ * thread-safe. POSIX only; on Windows listen(), connect() and adopt() fail.
+ */
+class PeerConnectionEngine {
+public:
+    using ConnectionId = uint64_t;  ///< 0 is never a valid id
+    using MessageCallback = std::function<void(ConnectionId, utils::ByteSpan)>;
+    using StateCallback = std::function<void(ConnectionId, ConnectionState)>;
+
+    /**
+     * @brief What the engine's connections cost, excluding kernel socket buffers.
+     */
+    struct MemoryStats {
+        size_t connections = 0;  ///< Open handles
+        size_t handleBytes = 0;  ///< Slab memory for the handles, in whole chunks
+        size_t bufferBytes = 0;  ///< Capacity of the handles' inbound and outbound buffers
+        size_t engineBytes = 0;  ///< Fixed cost of the engine itself
+    };
+
+    explicit PeerConnectionEngine(const PeerEngineConfig& config = PeerEngineConfig{},
+                                  EventReactor& reactor = EventReactor::shared());
+
+    /**
+     * @brief Closes every connection and the listener, without state callbacks.
+     */
+    ~PeerConnectionEngine();
+
+    PeerConnectionEngine(const PeerConnectionEngine&) = delete;
+    PeerConnectionEngine& operator=(const PeerConnectionEngine&) = delete;
+
+    void setMessageCallback(MessageCallback callback) { messageCallback_ = std::move(callback); }
+    void setStateCallback(StateCallback callback) { stateCallback_ = std::move(callback); }
+
+    /**
+     * @brief Accepts inbound connections on address:port; port 0 picks a free one.
+     *
+     * Accepted connections are reported CONNECTED through the state callback.
+     */
+    bool listen(uint16_t port, const std::string& address = "0.0.0.0");
+
+    /**
+     * @brief Port being listened on, 0 if none.
+     */
+    uint16_t listeningPort() const { return listenPort_; }
+
+    /**
+     * @brief Starts connecting to a numeric IPv4 address without blocking.
+     *
+     * The connection is CONNECTING until the state callback reports it
+     * CONNECTED or DISCONNECTED; frames sent meanwhile are buffered.
+     *
+     * @return The connection, or 0 if it could not be started
+     */
+    ConnectionId connect(const std::string& address, uint16_t port);
+
+    /**
+     * @brief Takes over a connected socket; the engine closes it.
+     *
+     * @return The connection, or 0 if the engine is full (the socket is closed)
+     */
+    ConnectionId adopt(int fd);
+
+    /**
+     * @brief Sends payload as one frame.
+     *
+     * @return false if the connection is closed, or frames already waiting
+     *         for the socket plus this one would exceed maxPendingBytes
+     */
+    bool send(ConnectionId id, utils::ByteSpan payload);
+
+    /**
+     * @brief Closes the connection, reporting DISCONNECTED through the state callback.
+     *
+     * @return false if it was already closed
+     */
+    bool close(ConnectionId id);
+
+    /**
+     * @brief DISCONNECTED for closed or unknown ids.
+     */
+    ConnectionState state(ConnectionId id) const;
+
+    /**
+     * @brief Bytes sent but not yet taken by the kernel.
+     */
+    size_t pendingBytes(ConnectionId id) const;
+
+    size_t connectionCount() const { return connectionCount_.load(std::memory_order_relaxed); }
+
+    MemoryStats memoryStats() const;
+
+    /**
+     * @brief Bytes one handle takes in the slab.
+     */
+    static size_t handleSize();
+
+    std::string getLastError() const;
+
+private:
+    struct Handle;
+    struct Chunk;
+
+    static constexpr size_t CHUNK_SHIFT = 10;
+    static constexpr size_t CHUNK_HANDLES = size_t{1} << CHUNK_SHIFT;
+    static constexpr size_t LOCK_STRIPES = 256;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    Handle* handleAt(uint32_t slot) const;
+    std::mutex& lockFor(uint32_t slot) const { return stripes_[slot % LOCK_STRIPES]; }
+
+    /**
+     * @brief Takes a free handle; NO_SLOT if the engine is full
+     */
+    uint32_t allocateSlot();
+    void releaseSlot(uint32_t slot);
+
+    ConnectionId registerSocket(int fd, ConnectionState initial);
+    void onEvents(ConnectionId id, uint32_t events);
+    void onListenerReadable();
+
+    /**
+     * @brief Reads and delivers what has arrived; false once the connection must close
+     */
+    bool readAvailable(ConnectionId id);
+
+    /**
+     * @brief Writes buffered bytes; requires the handle's stripe lock. False on a socket error
+     */
+    bool flushLocked(Handle& handle);
+
+    /**
+     * @brief Closes the connection; with notify, reports DISCONNECTED
+     */
+    bool closeConnection(ConnectionId id, bool notify);
+    void sweepIdle();
+    uint32_t nowTick() const;
+    void setError(const std::string& message) const;
+
+    PeerEngineConfig config_;
+    EventReactor& reactor_;
+    MessageCallback messageCallback_;
+    StateCallback stateCallback_;
+
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks_;  ///< Allocated on demand, never freed before the engine
+    size_t chunkCount_;
+    mutable std::array<std::mutex, LOCK_STRIPES> stripes_;
+    std::mutex slotMutex_;                  ///< Guards the free list and slab growth
+    uint32_t freeHead_{NO_SLOT};
+    std::atomic<uint32_t> slotsInUse_{0};   ///< High-water mark; slots below it have been handed out
+    std::atomic<size_t> connectionCount_{0};
+
+    int listenFd_{-1};
+    uint16_t listenPort_{0};
+    EventReactor::TimerId sweepTimer_{0};
+    std::chrono::steady_clock::time_point epoch_;
+
+    mutable std::mutex errorMutex_;
+    mutable std::string lastError_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_PEER_CONNECTION_HPP
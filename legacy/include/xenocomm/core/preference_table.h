@@ -0,0 +1,266 @@
+#pragma once
+
+#include "xenocomm/core/negotiation_protocol.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Per-dimension lookup table compiled from a list of ranked options.
+ *
+ * The negotiable enums are small, so a value indexes a dense rank array and
+ * a bitmask of allowed values directly; membership and scoring take one load
+ * each instead of a scan of the option list. Values outside the table share
+ * its last slot, which is never allowed and scores zero.
+ *
+ * @tparam T One of the negotiable parameter enums
+ */
+template <typename T>
+class RankTable {
+public:
+    static constexpr size_t SLOTS = 16;
+    using Mask = uint16_t;
+
+    /**
+     * @brief A value the table can propose, with the rank of the option it comes from
+     */
+    struct Candidate {
+        T value;
+        uint8_t rank;
+    };
+
+    RankTable() = default;
+
+    /**
+     * @brief Compiles options. The first option listing a value sets its rank.
+     */
+    explicit RankTable(const std::vector<RankedOption<T>>& options)
+        : constrained_(!options.empty()) {
+        for (const auto& option : options) {
+            size_t index = slot(option.value);
+            if (index < SLOTS - 1 && !(allowed_ & bit(option.value))) {
+                allowed_ |= bit(option.value);
+                ranks_[index] = option.rank;
+            }
+        }
+
+        // Candidates in rank order, each option's fallbacks right after it
+        std::vector<const RankedOption<T>*> ordered;
+        for (const auto& option : options) {
+            ordered.push_back(&option);
+        }
+        std::stable_sort(ordered.begin(), ordered.end(),
+            [](const auto* a, const auto* b) { return *a < *b; });
+        Mask seen = 0;
+        auto add = [&](T value, uint8_t rank) {
+            if (slot(value) < SLOTS - 1 && !(seen & bit(value))) {
+                seen |= bit(value);
+                candidates_.push_back(Candidate{value, rank});
+            }
+        };
+        for (const auto* option : ordered) {
+            add(option->value, option->rank);
+            for (const auto& fallback : option->fallbacks) {
+                add(fallback, option->rank);
+            }
+        }
+    }
+
+    static size_t slot(T value) {
+        return std::min<size_t>(static_cast<size_t>(value), SLOTS - 1);
+    }
+
+    static Mask bit(T value) {
+        return static_cast<Mask>(1u << slot(value));
+    }
+
+    /**
+     * @brief Mask of a remote peer's values. An empty list means the peer did not say, and allows all.
+     */
+    static Mask maskOf(const std::vector<T>& values) {
+        if (values.empty()) {
+            return static_cast<Mask>(~0u);
+        }
+        Mask mask = 0;
+        for (T value : values) {
+            mask |= bit(value);
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Whether value is one of the options (fallbacks are not)
+     */
+    bool allows(T value) const { return (allowed_ >> slot(value)) & 1u; }
+
+    /**
+     * @brief Rank of value's option, or 0 if it is not an option
+     */
+    uint8_t rank(T value) const { return ranks_[slot(value)]; }
+
+    /**
+     * @brief False if there were no options, in which case the dimension is not negotiated
+     */
+    bool constrained() const { return constrained_; }
+
+    /**
+     * @brief Every option and fallback, most preferred first
+     */
+    const std::vector<Candidate>& candidates() const { return candidates_; }
+
+    /**
+     * @brief The most preferred option or fallback in remoteMask
+     */
+    std::optional<T> bestMatch(Mask remoteMask) const {
+        for (const auto& candidate : candidates_) {
+            if (remoteMask & bit(candidate.value)) {
+                return candidate.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    std::array<uint8_t, SLOTS> ranks_{};
+    Mask allowed_ = 0;
+    bool constrained_ = false;
+    std::vector<Candidate> candidates_;
+};
+
+/**
+ * @brief A ParameterPreference compiled into RankTables for repeated evaluation.
+ *
+ * Build one when the preferences are set and reuse it for every proposal:
+ * checking or scoring a proposal is then a fixed number of table loads with
+ * no scans, which matters when a peer answers with a stream of counter
+ * proposals. The results match the ParameterPreference methods of the same
+ * name. Custom parameters are not compiled; check them separately.
+ *
+ * The compiled tables are a snapshot and do not follow later changes to the
+ * preferences they were built from.
+ */
+class CompiledPreference {
+public:
+    explicit CompiledPreference(const ParameterPreference& preferences);
+
+    /**
+     * @brief Same as ParameterPreference::isCompatibleWithRequirements()
+     */
+    bool isCompatibleWithRequirements(const NegotiableParams& proposal) const;
+
+    /**
+     * @brief Same as ParameterPreference::calculateCompatibilityScore(); lower is better
+     */
+    uint32_t calculateCompatibilityScore(const NegotiableParams& proposal) const;
+
+    /**
+     * @brief The most preferred option or fallback the remote peer also supports
+     */
+    template <typename T>
+    std::optional<T> findBestMatch(const std::vector<T>& remote) const {
+        return table<T>().bestMatch(RankTable<T>::maskOf(remote));
+    }
+
+    template <typename T>
+    const RankTable<T>& table() const {
+        return std::get<RankTable<T>>(tables_);
+    }
+
+private:
+    std::tuple<RankTable<DataFormat>,
+               RankTable<CompressionAlgorithm>,
+               RankTable<ErrorCorrectionScheme>,
+               RankTable<EncryptionAlgorithm>,
+               RankTable<KeyExchangeMethod>,
+               RankTable<AuthenticationMethod>,
+               RankTable<KeySize>> tables_;
+};
+
+/**
+ * @brief Whether an encryption, key exchange and key size combination passes
+ *        ParameterPreference::validateSecurityParameters(), from a table built once.
+ */
+bool isSecurityCombinationValid(EncryptionAlgorithm encryption,
+                                KeyExchangeMethod keyExchange,
+                                KeySize keySize);
+
+/**
+ * @brief Lazily enumerates parameter sets both peers support, best first.
+ *
+ * Each dimension contributes the local options and fallbacks the remote peer
+ * supports, and sets come out in order of the sum of their ranks, ties in
+ * preference order. Only as many sets as are taken are ever built, where
+ * enumerating every combination up front grows with the product of the
+ * dimension sizes. Sets with an invalid security combination are skipped, as
+ * is the rejected proposal if one is given. A dimension with no local
+ * options keeps the base value.
+ */
+class AlternativeProposals {
+public:
+    AlternativeProposals(const CompiledPreference& preferences,
+                         const NegotiableParams& base,
+                         const std::vector<DataFormat>& remoteFormats,
+                         const std::vector<CompressionAlgorithm>& remoteCompression,
+                         const std::vector<ErrorCorrectionScheme>& remoteErrorCorrection,
+                         const std::vector<EncryptionAlgorithm>& remoteEncryption,
+                         const std::vector<KeyExchangeMethod>& remoteKeyExchange,
+                         const std::vector<AuthenticationMethod>& remoteAuth,
+                         const std::vector<KeySize>& remoteKeySizes,
+                         std::optional<NegotiableParams> rejected = std::nullopt);
+
+    /**
+     * @brief The next best parameter set, or nullopt once all are exhausted
+     */
+    std::optional<NegotiableParams> next();
+
+private:
+    static constexpr size_t DIMENSIONS = 7;
+
+    // Position in each dimension's candidate list
+    struct Node {
+        uint32_t cost;
+        std::array<uint8_t, DIMENSIONS> index;
+        uint8_t lastDimension;  // Successors only advance this dimension or later ones
+
+        bool operator>(const Node& other) const {
+            return cost != other.cost ? cost > other.cost : index > other.index;
+        }
+    };
+
+    template <typename T>
+    using Candidates = std::vector<typename RankTable<T>::Candidate>;
+
+    template <typename T>
+    void select(size_t dimension, const RankTable<T>& table, const std::vector<T>& remote, T baseValue);
+
+    NegotiableParams build(const Node& node) const;
+
+    NegotiableParams base_;
+    std::optional<NegotiableParams> rejected_;
+    std::tuple<Candidates<DataFormat>,
+               Candidates<CompressionAlgorithm>,
+               Candidates<ErrorCorrectionScheme>,
+               Candidates<EncryptionAlgorithm>,
+               Candidates<KeyExchangeMethod>,
+               Candidates<AuthenticationMethod>,
+               Candidates<KeySize>> candidates_;
+    std::array<std::vector<uint8_t>, DIMENSIONS> ranks_;  // Candidate ranks, per dimension
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue_;
+};
+
+template <typename T>
+std::optional<T> ParameterPreference::findBestMatchWithFallbacks(
+    const std::vector<RankedOption<T>>& local,
+    const std::vector<T>& remote) const {
+    return RankTable<T>(local).bestMatch(RankTable<T>::maskOf(remote));
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,348 @@
+#ifndef XENOCOMM_CORE_QUIC_TRANSPORT_HPP
+#define XENOCOMM_CORE_QUIC_TRANSPORT_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "xenocomm/core/aead_record_layer.hpp"
+#include "xenocomm/core/congestion_controller.h"
+#include "xenocomm/core/secure_transport_wrapper.hpp"
+#include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/core/udp_transport.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Configuration for QuicTransport
+ */
+struct QuicTransportConfig {
+    ConnectionConfig connectionConfig;   ///< For the UDP socket; localPort binds it
+    SecureTransportConfig secure;        ///< Handshake settings; securityConfig.protocol should be DTLS
+    CongestionControlConfig congestion;  ///< segment_size is taken from maxPacketSize
+    size_t maxPacketSize = 1200;         ///< Whole datagram, header and tag included
+    uint32_t maxAckDelayMs = 25;         ///< Longest a received packet waits to be acknowledged
+    uint32_t idleTimeoutMs = 30000;      ///< Connection fails after this long without hearing from the peer
+    uint32_t streamReceiveWindow = 1024 * 1024;  ///< Per-stream bytes the peer may send ahead of our reads
+    size_t streamSendBuffer = 4 * 1024 * 1024;   ///< Per-stream unacknowledged bytes before send() blocks
+    size_t maxStreams = 256;             ///< Streams either side may use; frames for others are dropped
+    double pacingGain = 1.25;            ///< Pacing rate as a multiple of congestion window per smoothed RTT
+};
+
+/**
+ * @brief QUIC-style transport: encrypted, reliable, multi-stream messaging over one UDP socket
+ *
+ * Everything a TCP connection, a SecureTransportWrapper and TransmissionManager's
+ * reliability layer provide separately happens here in one packet format. Each
+ * datagram is one packet: a 9-byte header (flags and a 64-bit packet number,
+ * authenticated as associated data) and frames sealed with AeadRecordLayer,
+ * using the packet number as the record sequence. Frames are STREAM data, ACKs
+ * with up to 16 ranges, per-stream flow-control credit, PING, path validation
+ * and CONNECTION_CLOSE.
+ *
+ * Streams are independent: a lost packet only holds up the streams whose data
+ * it carried, and messages on other streams are delivered as soon as they are
+ * complete. Each send is one message; streams keep message boundaries and order.
+ * Streams need no setup and are identified by number; the TransportProtocol
+ * methods use stream 0, and sendOnStream() and receiveFromStream() any other.
+ *
+ * Loss is detected RFC 9002 style, by packet threshold and time threshold,
+ * with a probe timeout for tail losses; lost data is resent in new packets.
+ * Sending is limited by a CongestionController window and paced at
+ * pacingGain * cwnd / srtt, so a full window is spread over a round trip instead
+ * of leaving in one burst.
+ *
+ * A peer may change address (a NAT rebinding, or migrate() on the client).
+ * Packets that authenticate from a new address trigger a PATH_CHALLENGE there,
+ * and sends move to the new address once it is answered.
+ *
+ * Keys come either from a handshake run with SecureTransportWrapper over the
+ * UDP socket, using the SecurityManager's settings, or from a record layer
+ * agreed out of band. One I/O thread receives packets and runs timers; sends
+ * go out from the calling thread when the window and pacer allow.
+ */
+class QuicTransport : public TransportProtocol {
+public:
+    struct Stats {
+        uint64_t packetsSent = 0;
+        uint64_t packetsReceived = 0;
+        uint64_t packetsLost = 0;
+        uint64_t packetsDropped = 0;      ///< Failed to authenticate, duplicates or malformed
+        uint64_t bytesRetransmitted = 0;  ///< Stream bytes sent again after a loss
+        uint64_t probeTimeouts = 0;
+        uint64_t pathMigrations = 0;
+        std::chrono::microseconds smoothedRtt{0};
+        uint32_t congestionWindow = 0;
+    };
+
+    /**
+     * @brief Transport whose connect() runs a DTLS handshake with the given security manager
+     */
+    QuicTransport(std::shared_ptr<SecurityManager> securityManager, const QuicTransportConfig& config);
+
+    /**
+     * @brief Transport using keys both peers already agreed on
+     *
+     * The layer must be fresh: packet numbers start at zero, so reusing its
+     * keys for a second connection would reuse nonces. reconnect() therefore
+     * fails in this mode.
+     */
+    QuicTransport(std::shared_ptr<AeadRecordLayer> keys, const QuicTransportConfig& config);
+
+    ~QuicTransport() override;
+
+    QuicTransport(const QuicTransport&) = delete;
+    QuicTransport& operator=(const QuicTransport&) = delete;
+
+    bool connect(const std::string& endpoint, const ConnectionConfig& config) override;
+    bool disconnect() override;
+    bool isConnected() const override;
+
+    ssize_t send(const uint8_t* data, size_t size) override;
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
+    bool isReliableStream() const override { return true; }
+    ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) override;
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override;
+    ssize_t receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) override;
+    ssize_t receive(uint8_t* buffer, size_t size) override;
+
+    /**
+     * @brief Queue one message on a stream
+     *
+     * Returns once the message is buffered for (re)transmission, blocking while
+     * the stream already holds streamSendBuffer unacknowledged bytes.
+     * @return Message size, or -1 on error
+     */
+    ssize_t sendOnStream(uint32_t streamId, const utils::ByteSpan* parts, size_t count);
+
+    /**
+     * @brief Wait for the next message on a stream, up to the receive timeout
+     * @return Message size, or -1 on timeout or error
+     */
+    ssize_t receiveFromStream(uint32_t streamId, utils::PooledBuffer& message);
+
+    /**
+     * @brief Wait for the next message on any stream, in order of completion
+     * @param[out] streamId Stream the message arrived on
+     * @return Message size, or -1 on timeout or error
+     */
+    ssize_t receiveAny(uint32_t& streamId, utils::PooledBuffer& message);
+
+    /**
+     * @brief Move this end of the connection to a new local port
+     *
+     * The peer sees packets from the new address, validates the path and
+     * follows. Nothing in flight is lost; the old socket is closed.
+     * @param localPort Port to bind, 0 for any
+     * @return false if not connected or the new socket cannot be opened
+     */
+    bool migrate(uint16_t localPort = 0);
+
+    Stats getStats() const;
+
+    bool getPeerAddress(std::string& address, uint16_t& port) override;
+    int getSocketFd() const override;
+    bool setNonBlocking(bool nonBlocking) override;
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setSendTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setKeepAlive(bool enable) override;
+    bool setTcpNoDelay(bool) override { return true; }  // Acknowledgments are already delay-bounded
+    bool setReuseAddress(bool enable) override;
+    bool setReceiveBufferSize(size_t size) override;
+    bool setSendBufferSize(size_t size) override;
+    uint32_t getPathMtu() const override { return static_cast<uint32_t>(config_.maxPacketSize); }
+    std::string getLastError() const override;
+    bool setLocalPort(uint16_t port) override;
+    ConnectionState getState() const override;
+    TransportError getLastErrorCode() const override;
+    std::string getErrorDetails() const override;
+    bool reconnect(uint32_t maxAttempts = 3, uint32_t delayMs = 1000) override;
+    void setStateCallback(std::function<void(ConnectionState)> callback) override;
+    void setErrorCallback(std::function<void(TransportError, const std::string&)> callback) override;
+    bool checkHealth() override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum FrameType : uint8_t {
+        PADDING = 0x00,
+        PING = 0x01,
+        ACK = 0x02,
+        STREAM = 0x08,
+        MAX_STREAM_DATA = 0x11,
+        PATH_CHALLENGE = 0x1a,
+        PATH_RESPONSE = 0x1b,
+        CONNECTION_CLOSE = 0x1c
+    };
+    static constexpr uint8_t HEADER_FLAGS = 0x40;
+    static constexpr size_t HEADER_SIZE = 9;
+    static constexpr size_t MESSAGE_PREFIX = 4;  // Big-endian length before each message in a stream
+    static constexpr size_t MAX_ACK_RANGES = 16;
+
+    // Byte ranges [first, second) keyed by start, merged on insert
+    using RangeSet = std::map<uint64_t, uint64_t>;
+
+    struct SendStream {
+        std::deque<uint8_t> buffer;  // Bytes from base not yet acknowledged in order
+        uint64_t base = 0;
+        uint64_t nextOffset = 0;     // First byte never sent
+        uint64_t peerLimit = 0;      // Peer's flow-control limit
+        RangeSet acked;              // Acknowledged ranges beyond base
+        RangeSet lost;               // Ranges to resend
+        bool queued = false;         // In sendOrder_
+    };
+
+    struct Message {
+        utils::PooledBuffer data;
+        uint32_t windowBytes;  // Credit returned once the application reads it
+    };
+
+    struct ReceiveStream {
+        std::map<uint64_t, std::vector<uint8_t>> pending;  // Out-of-order segments by offset
+        std::vector<uint8_t> assembling;                   // In-order bytes not yet a whole message
+        size_t parsed = 0;                                 // Start of the unparsed part of assembling
+        size_t creditedAhead = 0;                          // Unparsed bytes already credited
+        uint64_t contiguous = 0;                           // Bytes received in order
+        uint64_t credited = 0;                             // Bytes given back as credit
+        uint64_t advertised = 0;                           // Limit last granted to the peer
+        bool creditPending = false;                        // A MAX_STREAM_DATA should go out
+        std::deque<Message> messages;
+    };
+
+    struct StreamChunk {
+        uint32_t stream;
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    struct SentPacket {
+        Clock::time_point sent;
+        uint32_t size = 0;
+        bool ackEliciting = false;
+        bool inFlight = false;  // Counted against the congestion window
+        std::vector<StreamChunk> chunks;
+        std::vector<uint32_t> credits;  // Streams whose MAX_STREAM_DATA it carried
+    };
+
+    void init();
+    bool openSocket(uint16_t localPort, std::shared_ptr<UDPTransport>& udp);
+    void ioLoop();
+    void fail(TransportError code, const std::string& reason);  // Requires mutex_
+    void setError(TransportError code, const std::string& details);
+    void updateState(ConnectionState state);
+
+    // All of these require mutex_
+    void handleDatagram(uint8_t* data, size_t size, const std::string& address, uint16_t port, Clock::time_point now);
+    bool handleFrames(const uint8_t* data, size_t size, const std::string& address, uint16_t port,
+                      Clock::time_point now, bool& ackEliciting);
+    bool handleAck(const uint8_t* data, size_t& pos, size_t size, Clock::time_point now);
+    void handleStream(ReceiveStream& stream, uint32_t id, uint64_t offset, const uint8_t* data, size_t length);
+    void onPacketAcked(uint64_t number, SentPacket& packet);
+    void onPacketLost(SentPacket& packet);
+    void detectLosses(Clock::time_point now);
+    void onProbeTimeout(Clock::time_point now);
+    Clock::time_point nextTimer(Clock::time_point now) const;
+    void flush(Clock::time_point now);  // Sends whatever the window, pacer and queues allow
+    size_t writeAck(uint8_t* out, size_t room, Clock::time_point now);
+    size_t writeStreamData(uint8_t* out, size_t room, SentPacket& record);
+    bool sendPacket(const uint8_t* frames, size_t length, SentPacket&& record, Clock::time_point now,
+                    const std::string* address = nullptr, uint16_t port = 0);
+    SendStream* sendStream(uint32_t id);
+    ReceiveStream* receiveStream(uint32_t id);
+    void credit(ReceiveStream& stream, size_t bytes);
+    std::chrono::microseconds probeTimeout() const;
+    ssize_t waitForMessage(std::unique_lock<std::mutex>& lock, uint32_t* streamId, bool any,
+                           utils::PooledBuffer& message);
+
+    std::shared_ptr<SecurityManager> securityManager_;
+    std::shared_ptr<AeadRecordLayer> presharedKeys_;
+    bool presharedUsed_ = false;
+    QuicTransportConfig config_;
+
+    mutable std::mutex mutex_;  // Guards all protocol state; held for socket sends but not while receiving
+    std::condition_variable cv_;        // Messages arrived, buffer space freed or the state changed
+    std::shared_ptr<UDPTransport> udp_;
+    std::shared_ptr<SecureTransportWrapper> handshake_;  // Kept for the lifetime of its keys
+    std::shared_ptr<AeadRecordLayer> keys_;
+    std::unique_ptr<ICongestionController> congestion_;
+    std::thread io_;
+    bool running_ = false;
+    std::string endpoint_;
+    uint16_t localPort_ = 0;
+    std::atomic<ConnectionState> state_{ConnectionState::DISCONNECTED};
+
+    // Packet number space
+    uint64_t nextPacketNumber_ = 0;
+    std::map<uint64_t, SentPacket> sent_;
+    uint64_t largestAcked_ = 0;
+    bool anyAcked_ = false;
+    uint32_t bytesInFlight_ = 0;
+    uint32_t elicitingInFlight_ = 0;
+    RangeSet receivedPackets_;
+    uint64_t largestReceived_ = 0;
+    Clock::time_point largestReceivedTime_{};
+    uint32_t unackedElicitingPackets_ = 0;
+    Clock::time_point ackDeadline_ = Clock::time_point::max();
+
+    // RTT estimate (RFC 9002)
+    std::chrono::microseconds smoothedRtt_{333000};
+    std::chrono::microseconds rttVariance_{166500};
+    std::chrono::microseconds minRtt_{0};
+    std::chrono::microseconds latestRtt_{0};
+    bool rttSampled_ = false;
+    Clock::time_point lastElicitingSent_{};
+    uint32_t probeCount_ = 0;
+    bool probePending_ = false;
+
+    Clock::time_point pacerNext_{};
+    bool pacerBlocked_ = false;
+    Clock::time_point lastReceived_{};
+    Clock::time_point lastSent_{};
+
+    std::unordered_map<uint32_t, SendStream> sendStreams_;
+    std::unordered_map<uint32_t, ReceiveStream> receiveStreams_;
+    std::deque<uint32_t> sendOrder_;   // Round-robin order over streams with something to send
+    std::deque<uint32_t> completed_;   // Stream of each undelivered message, in completion order
+
+    // Path validation
+    std::vector<std::pair<std::array<uint8_t, 8>, std::pair<std::string, uint16_t>>> responses_;
+    bool challenging_ = false;
+    std::array<uint8_t, 8> challenge_{};
+    std::string challengeAddress_;
+    uint16_t challengePort_ = 0;
+    Clock::time_point challengeSent_{};
+    std::string peerAddress_;
+    uint16_t peerPort_ = 0;
+
+    bool keepAlive_ = false;
+    std::atomic<bool> nonBlocking_{false};
+    std::atomic<int64_t> receiveTimeoutMs_{0};  // 0 waits indefinitely
+    std::atomic<int64_t> sendTimeoutMs_{0};
+    utils::PooledBuffer partial_;  // Rest of a message receive() has started on
+    size_t partialOffset_ = 0;
+    Stats stats_;
+
+    mutable std::mutex errorMutex_;
+    TransportError lastError_ = TransportError::NONE;
+    std::string errorDetails_;
+    std::function<void(ConnectionState)> stateCallback_;
+    std::function<void(TransportError, const std::string&)> errorCallback_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_QUIC_TRANSPORT_HPP
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "xenocomm/core/capability_signaler.h"
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+
+class FeedbackLoop;
+
+namespace core {
+
+/**
+ * @brief Weights and defaults RankedDiscovery scores agents with.
+ *
+ * An agent's score is loadWeight * load + latencyWeight * latency / latencyScale;
+ * lower is better. Load is the agent's own report, 0 idle and 1 saturated.
+ */
+struct RankingConfig {
+    double loadWeight = 1.0;
+    double latencyWeight = 1.0;
+    std::chrono::milliseconds latencyScale{10};  ///< Latency worth as much as a full load
+    std::chrono::milliseconds loadTtl{30000};    ///< Load reports older than this are ignored
+    double unknownLoad = 0.5;                    ///< Load assumed for agents without a fresh report
+};
+
+/**
+ * @brief A discovered agent with what its rank was based on.
+ */
+struct RankedAgent {
+    std::string agentId;
+    double score = 0;
+    double load = 0;       ///< As reported, or RankingConfig::unknownLoad
+    double latencyMs = 0;  ///< Average latency to the agent, or the candidates' mean if unmeasured
+    bool loadReported = false;
+    bool latencyMeasured = false;
+};
+
+/**
+ * @brief Discovery that spreads clients over the matching agents instead of
+ * leaving them all to pick the first one.
+ *
+ * Wraps a CapabilitySignaler, whose discoverAgents() still decides which
+ * agents match. Agents report their load through reportLoad(), and latency
+ * comes from the FeedbackLoop's per-peer metrics, with each outcome's
+ * peerId being the agent ID. rank() orders the matches best first, breaking
+ * ties at random, and can cut the list to the top k. choose() picks one agent
+ * by power of two choices: the better of two matches drawn at random. The
+ * many clients of one agent set then spread almost evenly, even when each
+ * acts on load reports that are somewhat stale, where always taking the
+ * best one would stampede it.
+ *
+ * Thread-safe. The signaler and feedback loop must outlive this object.
+ */
+class RankedDiscovery {
+public:
+    explicit RankedDiscovery(CapabilitySignaler& signaler, const FeedbackLoop* feedback = nullptr,
+                             const RankingConfig& config = RankingConfig{});
+
+    /**
+     * @brief Records an agent's current load, replacing its previous report.
+     * @param load 0 for idle to 1 for saturated; values above 1 mean overloaded.
+     */
+    void reportLoad(const std::string& agentId, double load);
+
+    /**
+     * @brief Drops an agent's load report, for an agent that has gone away.
+     */
+    void forgetAgent(const std::string& agentId);
+
+    /**
+     * @brief Matching agents, best first.
+     * @param requiredCapabilities The query, as for CapabilitySignaler::discoverAgents().
+     * @param partialMatch The matching mode, as for CapabilitySignaler::discoverAgents().
+     * @param limit Longest result to return; 0 returns every match.
+     */
+    std::vector<RankedAgent> rank(const std::vector<Capability>& requiredCapabilities, bool partialMatch = false,
+                                  size_t limit = 0);
+
+    /**
+     * @brief One matching agent chosen by power of two choices.
+     * @return The agent, or nullopt if none matches.
+     */
+    std::optional<RankedAgent> choose(const std::vector<Capability>& requiredCapabilities,
+                                      bool partialMatch = false);
+
+    void setConfig(const RankingConfig& config);
+    RankingConfig getConfig() const;
+
+private:
+    struct LoadReport {
+        double load;
+        std::chrono::steady_clock::time_point reportedAt;
+    };
+
+    std::vector<RankedAgent> score(const std::vector<std::string>& agents);
+    void refreshLatencies();  // Caller holds mutex_
+
+    CapabilitySignaler& signaler_;
+    const FeedbackLoop* feedback_;
+
+    mutable std::mutex mutex_;
+    RankingConfig config_;
+    std::unordered_map<std::string, LoadReport> loads_;
+
+    // Average latency per peer, rebuilt when the feedback loop's window changes
+    std::unordered_map<std::string, double> latencies_;
+    uint64_t latencyGeneration_ = 0;
+    bool latenciesLoaded_ = false;
+};
+
+} // namespace core
+} // namespace xenocomm
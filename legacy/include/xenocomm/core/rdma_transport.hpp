@@ -0,0 +1,182 @@
+#ifndef XENOCOMM_CORE_RDMA_TRANSPORT_HPP
+#define XENOCOMM_CORE_RDMA_TRANSPORT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Settings for an RdmaTransport
+ */
+struct RdmaConfig {
+    std::string deviceName;              ///< Empty picks the first device
+    uint8_t port = 1;
+    int gidIndex = 0;                    ///< GID table entry; RoCE fabrics address by GID, not LID
+    uint32_t receiveDepth = 64;          ///< Receives kept posted, and so the sends the peer may have in flight
+    uint32_t sendDepth = 64;             ///< Eager sends in flight
+    size_t eagerLimit = 64 * 1024;       ///< Larger messages are written one-sided into the receiver's memory
+    size_t maxMessageSize = size_t(16) << 30;  ///< Larger incoming messages fail the connection
+    uint32_t pollIntervalMs = 100;       ///< How often the completion thread checks for shutdown while idle
+};
+
+/**
+ * @brief Message transport over an RDMA reliable-connected queue pair (ibverbs)
+ *
+ * Small messages are copied into pre-registered send slots and posted as
+ * two-sided SENDs into receives the peer keeps posted; flow control is by
+ * credit, one per posted receive, returned in every message header. Larger
+ * messages go by rendezvous: the sender announces the size, the receiver
+ * takes a buffer from BufferPool, registers it and replies with its address and
+ * key, and the sender registers its own buffers in place and writes them
+ * one-sided straight into the receiver's, finishing with a write-with-immediate
+ * that completes the message. Bulk payloads are therefore never copied on
+ * either side and cost the CPUs nothing while they move.
+ *
+ * The queue pair is set up over a control transport, any connected reliable
+ * one (a TCPTransport, say), which connect() connects first if needed. Each
+ * side sends its queue pair number, LID, GID and receive depth, and both move
+ * their queue pairs to RTS before anything else crosses. send() returns once a
+ * bulk message has been written, so its buffers can be reused at once.
+ *
+ * Built only where libibverbs is found (XENOCOMM_HAVE_IBVERBS); elsewhere, and
+ * on hosts without an RDMA device, connect() fails and available() is false.
+ */
+class RdmaTransport : public TransportProtocol {
+public:
+    /**
+     * @param control Reliable transport used to exchange queue pair details
+     */
+    explicit RdmaTransport(std::shared_ptr<TransportProtocol> control, const RdmaConfig& config = RdmaConfig{});
+    ~RdmaTransport() override;
+
+    RdmaTransport(const RdmaTransport&) = delete;
+    RdmaTransport& operator=(const RdmaTransport&) = delete;
+
+    /**
+     * @brief Whether RDMA support is built in and this host has a device
+     */
+    static bool available();
+
+    bool connect(const std::string& endpoint, const ConnectionConfig& config) override;
+    bool disconnect() override;
+    bool isConnected() const override;
+
+    ssize_t send(const uint8_t* data, size_t size) override;
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
+    bool isReliableStream() const override { return true; }
+    ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) override;
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override;
+    ssize_t receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) override;
+    ssize_t receive(uint8_t* buffer, size_t size) override;
+
+    bool getPeerAddress(std::string& address, uint16_t& port) override;
+    int getSocketFd() const override { return -1; }
+    bool setNonBlocking(bool nonBlocking) override;
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setSendTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setKeepAlive(bool) override { return true; }
+    bool setTcpNoDelay(bool) override { return true; }
+    bool setReuseAddress(bool) override { return true; }
+    bool setReceiveBufferSize(size_t) override { return true; }
+    bool setSendBufferSize(size_t) override { return true; }
+    std::string getLastError() const override;
+    bool setLocalPort(uint16_t port) override;
+    ConnectionState getState() const override;
+    TransportError getLastErrorCode() const override;
+    std::string getErrorDetails() const override;
+    bool reconnect(uint32_t maxAttempts = 3, uint32_t delayMs = 1000) override;
+    void setStateCallback(std::function<void(ConnectionState)> callback) override;
+    void setErrorCallback(std::function<void(TransportError, const std::string&)> callback) override;
+    bool checkHealth() override { return isConnected(); }
+
+private:
+    struct Verbs;  // Device, queue pair and registered memory; defined only with ibverbs
+
+    // An inbound bulk message, registered and waiting for the peer's writes
+    struct Landing;
+    // An outbound bulk message waiting for the peer's buffer, then for its writes
+    struct Rendezvous {
+        uint64_t remoteAddress = 0;
+        uint32_t remoteKey = 0;
+        bool cleared = false;      // The peer's CTS arrived
+        uint32_t outstanding = 0;  // Signaled writes not yet completed
+    };
+    // A control message that had to wait for a send slot or credit
+    struct PendingControl {
+        uint8_t type;
+        uint64_t a;
+        uint64_t b;
+        uint32_t c;
+    };
+
+    bool setUp(std::string& error);
+    void tearDown();
+    void pollLoop();
+    void handleCompletions();  // Requires mutex_
+    void fail(const std::string& reason);  // Requires mutex_
+    // These require mutex_
+    bool canPost(bool credit) const;
+    bool post(uint8_t type, uint64_t a, uint64_t b, uint32_t c, const utils::ByteSpan* parts, size_t count);
+    void queueControl(uint8_t type, uint64_t a, uint64_t b, uint32_t c);  // Sent as soon as slots allow
+    void flushControl();
+    ssize_t sendBulk(const utils::ByteSpan* parts, size_t count, size_t total, std::unique_lock<std::mutex>& lock);
+    bool waitFor(std::unique_lock<std::mutex>& lock, const std::function<bool()>& ready, int64_t timeoutMs);
+    ssize_t receiveMessage(utils::PooledBuffer& message, size_t maxSize);
+    void setError(TransportError code, const std::string& details);
+    void updateState(ConnectionState state);
+
+    std::shared_ptr<TransportProtocol> control_;
+    const RdmaConfig config_;
+    std::string endpoint_;
+    ConnectionConfig connectionConfig_;
+    std::unique_ptr<Verbs> verbs_;
+
+    std::mutex bulkMutex_;       // One rendezvous at a time keeps the send queue within its depth
+    mutable std::mutex mutex_;  // Guards everything below and posting to the queue pair
+    std::condition_variable cv_;
+    bool running_ = false;
+    bool failed_ = false;
+    std::string error_;
+    uint32_t sendCredits_ = 0;      // Receives the peer has posted for us
+    uint32_t creditsToReturn_ = 0;  // Receives we reposted and have not yet told the peer about
+    size_t peerEagerLimit_ = 0;
+    uint64_t nextRendezvousId_ = 1;
+    std::unordered_map<uint64_t, Rendezvous> outbound_;
+    std::unordered_map<uint64_t, std::unique_ptr<Landing>> inbound_;
+    std::deque<PendingControl> pendingControl_;
+    std::deque<utils::PooledBuffer> messages_;
+    std::thread poller_;
+
+    utils::PooledBuffer partial_;  // Rest of a message receive() has started on
+    size_t partialOffset_ = 0;
+    std::atomic<ConnectionState> state_{ConnectionState::DISCONNECTED};
+    std::atomic<bool> nonBlocking_{false};
+    std::atomic<int64_t> receiveTimeoutMs_{0};  // 0 waits indefinitely
+    std::atomic<int64_t> sendTimeoutMs_{0};
+
+    mutable std::mutex errorMutex_;
+    TransportError lastError_ = TransportError::NONE;
+    std::string errorDetails_;
+    std::function<void(ConnectionState)> stateCallback_;
+    std::function<void(TransportError, const std::string&)> errorCallback_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_RDMA_TRANSPORT_HPP
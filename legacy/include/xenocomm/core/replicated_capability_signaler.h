@@ -0,0 +1,145 @@
+#pragma once
+
+#include "xenocomm/core/capability_signaler.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief A CapabilitySignaler whose registrations are replicated between nodes.
+ *
+ * Each node keeps a full copy of the registry as a last-writer-wins element
+ * set: every (agent, capability name, version) has one state, present with
+ * its parameters or removed, stamped with a Lamport time and the writing
+ * node's ID. Merging keeps the state with the greater stamp, so replicas that
+ * have seen the same updates agree whatever order the updates arrived in,
+ * and applying an update twice changes nothing. Removals are kept as
+ * tombstones so that they win against older registrations that arrive late.
+ *
+ * Local changes are handed to the DeltaSink as encoded deltas for the caller
+ * to gossip over whatever transport it uses; applyDelta() merges deltas from
+ * other nodes and does not forward them. Deltas lost in transit are repaired
+ * by anti-entropy: a node's digest() hashes its elements into BUCKET_COUNT
+ * buckets under one root, and deltaForDigest() answers a peer's digest with
+ * the elements of just the buckets that differ.
+ *
+ * Discovery and capability lookups are served from a local
+ * InMemoryCapabilitySignaler and never leave the node.
+ */
+class ReplicatedCapabilitySignaler : public CapabilitySignaler {
+public:
+    static constexpr size_t BUCKET_COUNT = 256;
+
+    /**
+     * @brief Receives each encoded delta produced by a local change.
+     *
+     * Called after the change is applied locally, without any lock held.
+     */
+    using DeltaSink = std::function<void(const std::vector<uint8_t>& delta)>;
+
+    /**
+     * @param nodeId Identifier of this node, unique among the replicas.
+     * @param sink Where local deltas go; may be empty for a node that only receives.
+     */
+    explicit ReplicatedCapabilitySignaler(std::string nodeId, DeltaSink sink = {});
+    ~ReplicatedCapabilitySignaler() override;
+
+    ReplicatedCapabilitySignaler(const ReplicatedCapabilitySignaler&) = delete;
+    ReplicatedCapabilitySignaler& operator=(const ReplicatedCapabilitySignaler&) = delete;
+
+    bool registerCapability(const std::string& agentId, const Capability& capability) override;
+    size_t registerCapabilities(const std::string& agentId, const std::vector<Capability>& capabilities) override;
+    size_t registerCapabilities(const std::vector<CapabilityRegistration>& registrations) override;
+    bool unregisterCapability(const std::string& agentId, const Capability& capability) override;
+    size_t unregisterAgentBatch(const std::vector<std::string>& agentIds) override;
+
+    std::vector<std::string> discoverAgents(const std::vector<Capability>& requiredCapabilities) override;
+    std::vector<std::string> discoverAgents(const std::vector<Capability>& requiredCapabilities,
+                                            bool partialMatch) override;
+    std::vector<Capability> getAgentCapabilities(const std::string& agentId) override;
+
+    bool registerCapabilityBinary(const std::string& agentId, const std::vector<uint8_t>& capabilityData) override;
+    std::vector<uint8_t> getAgentCapabilitiesBinary(const std::string& agentId) override;
+
+    /**
+     * @brief Merges a delta produced by another replica.
+     *
+     * @return false if the delta is malformed, in which case nothing is applied.
+     */
+    bool applyDelta(const std::vector<uint8_t>& delta);
+
+    /**
+     * @brief Encodes the root and bucket hashes of this replica's elements.
+     */
+    std::vector<uint8_t> digest() const;
+
+    /**
+     * @brief A delta holding every element in the buckets where a peer's digest differs from ours.
+     *
+     * @return An empty vector if the digests match or the peer's digest is malformed.
+     */
+    std::vector<uint8_t> deltaForDigest(const std::vector<uint8_t>& peerDigest) const;
+
+    const std::string& nodeId() const { return nodeId_; }
+
+private:
+    struct Stamp {
+        uint64_t time{0};
+        std::string node;
+
+        bool operator<(const Stamp& other) const {
+            return time != other.time ? time < other.time : node < other.node;
+        }
+    };
+
+    struct Element {
+        std::string agentId;
+        Capability capability;  // Name and version form the key; parameters are the value
+        bool present{false};
+        Stamp stamp;
+    };
+
+    using ElementKey = std::string;
+
+    struct Bucket {
+        std::map<ElementKey, Element> elements;
+        uint64_t hash{0};  // XOR of elementHash over elements
+    };
+
+    static ElementKey keyFor(const std::string& agentId, const Capability& capability);
+    static uint64_t elementHash(const ElementKey& key, const Element& element);
+    static size_t bucketFor(const ElementKey& key);
+
+    // A change the local index needs after a merge, kept in merge order
+    struct LocalChange {
+        bool add{false};
+        CapabilityRegistration registration;
+    };
+
+    // All assume mutex_ is held
+    bool mergeLocked(const ElementKey& key, Element element, std::vector<LocalChange>& changes);
+    Element stampLocked(const std::string& agentId, const Capability& capability, bool present);
+    void applyLocked(std::vector<LocalChange>& changes);
+
+    static void encodeElement(const Element& element, std::vector<uint8_t>& out);
+    void publish(const std::vector<Element>& elements);
+
+    const std::string nodeId_;
+    DeltaSink sink_;
+    std::unique_ptr<CapabilitySignaler> local_;
+
+    mutable std::mutex mutex_;
+    uint64_t clock_{0};
+    std::array<Bucket, BUCKET_COUNT> buckets_;
+};
+
+} // namespace core
+} // namespace xenocomm
@@ -4,19 +4,23 @@
 #include "xenocomm/core/transport_protocol.hpp"
 #include "xenocomm/core/security_manager.h"
 #include "xenocomm/core/security_config.hpp"
+#include "xenocomm/core/aead_record_layer.hpp"
+#include "xenocomm/core/crypto_worker_pool.hpp"
+#include "xenocomm/utils/config_snapshot.hpp"
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include "xenocomm/utils/task_scheduler.hpp"
 #include <openssl/x509.h>
 #include <memory>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <functional>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
 #include <atomic>
 #include <chrono>
 #include <deque>
-#include <sys/uio.h>
 
 namespace xenocomm {
 namespace core {
@@ -116,6 +120,24 @@ public:
      */
     bool isTLS13() const;
 
+    /**
+     * @brief Connects and sends request as TLS 1.3 early data when a cached session allows it
+     * 
+     * Early data reaches the server with the first flight, saving a round
+     * trip, but can be replayed by an attacker, so request must be idempotent.
+     * Needs SecurityConfig::enableEarlyData; without it, or without an
+     * early-data ticket for endpoint, or if the server rejects the early data,
+     * request is sent normally once the handshake completes.
+     * 
+     * @return true if connected and request was sent either way
+     */
+    bool connectWithEarlyData(const std::string& endpoint, utils::ByteSpan request);
+
+    /**
+     * @brief Check if the last handshake resumed a cached session
+     */
+    bool isSessionResumed() const;
+
     /**
      * @brief Force renegotiation of the secure connection
      * 
@@ -130,6 +152,31 @@ public:
      */
     std::string getSecurityLevel() const;
 
+    /**
+     * @brief Retune the connection while records are being sent and received
+     * 
+     * Record batching limits and adaptive record sizing bounds apply from the
+     * next record. Whether batching and adaptive sizing run at all, and what
+     * the handshake settles (protocol, hostname, kernel TLS, crypto offload),
+     * stay as they were at construction; the connection settings apply from
+     * the next connect().
+     */
+    void setConfig(const SecureTransportConfig& config) { config_.publish(config); }
+
+    SecureTransportConfig getConfig() const { return *config_.read(); }
+
+    /**
+     * @brief Send buffers, concatenated, as one message without joining them first
+     * 
+     * With crypto offload each record is sealed straight out of the buffers
+     * it spans and all records leave in one sendFrames() call. Otherwise the
+     * buffers are packed into as few TLS records as fit and the ciphertexts
+     * go out in one sendv(). There is no limit on the number of buffers.
+     * 
+     * @return Total bytes sent, or -1 on error
+     */
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
+
     /**
      * @brief Send multiple buffers using vectored I/O
      * 
@@ -138,36 +185,94 @@ public:
      */
     Result<void> sendv(const std::vector<std::vector<uint8_t>>& buffers);
 
+    /**
+     * @brief Send size bytes of the file open as fd, starting at offset
+     * 
+     * With kernel TLS sending (SecurityConfig::kernelTls) the kernel reads,
+     * encrypts and sends the file without it passing through user space.
+     * Otherwise the file is read in chunks that are sent like any other data.
+     * 
+     * @return Bytes sent, or -1 on error
+     */
+    ssize_t sendFile(int fd, int64_t offset, size_t size);
+
+    /**
+     * @brief Whether the kernel encrypts what this connection sends (SecurityConfig::kernelTls)
+     */
+    bool isKernelTlsSend() const { return kernel_tls_send_; }
+
+    /**
+     * @brief Whether the kernel decrypts what this connection receives
+     */
+    bool isKernelTlsReceive() const { return kernel_tls_receive_; }
+
     // Method to access the underlying transport
     std::shared_ptr<TransportProtocol> getTransport() const { return transport_; }
 
+    /**
+     * @brief Derive record keys from the completed handshake for a caller's own record layer
+     * 
+     * For protocols that only use the wrapper to authenticate the peer and
+     * agree on keys, and frame their own packets afterwards (QuicTransport).
+     * The keys are the ones crypto offload would use, so nothing may be sent
+     * through the wrapper once the caller's layer is in use.
+     * 
+     * @return The layer, or an error if the handshake is not complete
+     */
+    Result<std::shared_ptr<AeadRecordLayer>> exportRecordLayer();
+
 public: // Made verifyCertificateHostname public for the callback
     bool verifyCertificateHostname(X509* cert);
 
 private:
-    struct BatchedMessage {
-        std::vector<uint8_t> data;
-        std::chrono::steady_clock::time_point timestamp;
-        
-        BatchedMessage(std::vector<uint8_t>&& d) 
-            : data(std::move(d)), 
-              timestamp(std::chrono::steady_clock::now()) {}
+    /**
+     * A queued message: a pooled copy of its bytes and the time by which it
+     * must be on the wire, fixed at enqueue from recordBatching.maxDelay.
+     */
+    struct BatchDescriptor {
+        utils::PooledBuffer::Raw payload;
+        std::chrono::steady_clock::time_point deadline;
     };
 
+    /**
+     * Senders push descriptors without locking; whichever thread holds
+     * flushMutex drains them into one preallocated record. The flush task on
+     * the shared TaskScheduler asks to run again at the record's earliest
+     * deadline, and senders ask for an immediate run only when it is idle or
+     * the record would overflow.
+     */
     struct BatchContext {
-        std::queue<BatchedMessage> messages;
-        size_t currentBatchSize{0};
-        std::mutex mutex;
-        std::condition_variable cv;
-        std::thread batchThread;
-        std::atomic<bool> shouldStop{false};
-        
+        enum SleepState : int { RUNNING, IDLE, TIMED };
+
+        explicit BatchContext(const RecordBatchingConfig& config)
+            : messages(std::max<size_t>(64, 4 * config.maxMessagesPerBatch)) {
+            record.reserve(config.maxBatchSize);
+        }
+
+        utils::MpscRing<BatchDescriptor> messages;
+        std::atomic<size_t> queuedMessages{0};
+        std::atomic<size_t> queuedBytes{0};
+
+        std::mutex flushMutex;  // Makes its holder the ring's single consumer and the only sender
+        std::vector<uint8_t> record;
+        size_t recordMessages{0};
+        std::chrono::steady_clock::time_point recordDeadline;
+
+        std::atomic<int> sleepState{IDLE};
+        std::atomic<size_t> sleepingBytes{0};     // Record contents while TIMED, for senders' overflow check
+        std::atomic<size_t> sleepingMessages{0};
+        utils::TaskScheduler::TaskId flushTask{utils::TaskScheduler::INVALID_TASK};
+
         void clear() {
-            std::lock_guard<std::mutex> lock(mutex);
-            while (!messages.empty()) {
-                messages.pop();
+            std::lock_guard<std::mutex> lock(flushMutex);
+            BatchDescriptor descriptor;
+            while (messages.try_pop(descriptor)) {
+                utils::PooledBuffer::adopt(descriptor.payload);
             }
-            currentBatchSize = 0;
+            queuedMessages = 0;
+            queuedBytes = 0;
+            record.clear();
+            recordMessages = 0;
         }
     };
 
@@ -206,16 +311,70 @@ private:
         }
     };
 
+    /**
+     * Records sealed with AeadRecordLayer under keys exported from the
+     * handshake. Each record is one transport frame:
+     * sequence (8 bytes, big-endian), plaintext length (4), ciphertext, tag.
+     */
+    struct OffloadContext {
+        static constexpr size_t HEADER_SIZE = 12;
+        static constexpr size_t OVERHEAD = HEADER_SIZE + AeadRecordLayer::TAG_SIZE;
+
+        std::shared_ptr<AeadRecordLayer> layer;
+        std::unique_ptr<CryptoWorkerPool> ownedPool;
+        CryptoWorkerPool* pool{nullptr};
+
+        std::mutex sendMutex;          // Keeps each write's records contiguous on the wire
+        uint64_t sendSequence{0};
+        // Reused across writes under sendMutex
+        std::vector<std::pair<size_t, size_t>> recordStarts;  // (buffer, offset) where each record begins
+        std::vector<utils::PooledBuffer> records;
+        std::vector<utils::ByteSpan> frames;
+        std::mutex receiveMutex;
+        uint64_t receiveSequence{0};
+        utils::PooledBuffer pending;   // Opened plaintext not yet returned by receive()
+
+        std::mutex sealerMutex;
+        std::vector<std::unique_ptr<AeadRecordLayer::Sealer>> sealers;
+
+        std::unique_ptr<AeadRecordLayer::Sealer> takeSealer() {
+            {
+                std::lock_guard<std::mutex> lock(sealerMutex);
+                if (!sealers.empty()) {
+                    auto sealer = std::move(sealers.back());
+                    sealers.pop_back();
+                    return sealer;
+                }
+            }
+            return layer->makeSealer();
+        }
+
+        void returnSealer(std::unique_ptr<AeadRecordLayer::Sealer> sealer) {
+            if (sealer) {
+                std::lock_guard<std::mutex> lock(sealerMutex);
+                sealers.push_back(std::move(sealer));
+            }
+        }
+    };
+
+    /**
+     * Scratch space for sendv() through the TLS engine, kept between calls
+     * so steady-state sends do not reallocate it.
+     */
     struct VectoredIOContext {
-        static constexpr size_t MAX_IOV = 16;  // Maximum number of iovec structures
-        std::vector<iovec> iovecs;
+        static constexpr size_t MAX_RECORD_PLAINTEXT = 16384;  // TLS record limit
+
+        std::mutex mutex;
+        std::vector<uint8_t> plaintext;
         std::vector<std::vector<uint8_t>> encryptedBuffers;
-        
-        VectoredIOContext() : iovecs(MAX_IOV) {}
-        
+        std::vector<utils::ByteSpan> spans;
+
+        VectoredIOContext() { plaintext.reserve(MAX_RECORD_PLAINTEXT); }
+
         void reset() {
+            plaintext.clear();
             encryptedBuffers.clear();
-            std::fill(iovecs.begin(), iovecs.end(), iovec{});
+            spans.clear();
         }
     };
 
@@ -226,25 +385,34 @@ private:
     void updateConnectionState(ConnectionState newState);
     void handleSecurityError(const std::string& operation);
     Result<void> handleSessionResumption();
+    std::string sessionKey();
+    Result<void> sendPendingEarlyData();
     void cleanupSecureContext();
     Result<void> initializeBatching();
-    void batchingThread();
-    Result<void> processBatch();
+    void stopBatching();
+    void runBatchFlush();
+    bool enqueueBatched(const uint8_t* data, size_t size);
+    Result<void> processBatch(bool force);
+    Result<void> sendBatchRecord();
     Result<void> flushBatch();
     bool shouldBatchMessage(size_t messageSize) const;
+    ssize_t sendRecord(const uint8_t* data, size_t size);
+    Result<void> initializeCryptoOffload();
+    Result<void> attachKernelTls();
+    Result<void> checkKernelTls();
+    ssize_t sendOffloaded(const utils::ByteSpan* parts, size_t count, bool pipelined);
+    ssize_t receiveOffloaded(uint8_t* buffer, size_t size);
     Result<void> initializeAdaptiveRecordSizing();
     void updateRecordSize();
     std::chrono::microseconds calculateAverageRTT() const;
     bool shouldAdjustRecordSize() const;
     void adjustRecordSize(std::chrono::microseconds avgRTT);
     
-    Result<void> sendEncryptedv(const std::vector<std::vector<uint8_t>>& buffers);
-    Result<void> processVectoredIO(const std::vector<std::vector<uint8_t>>& buffers);
-    bool shouldUseVectoredIO(const std::vector<std::vector<uint8_t>>& buffers) const;
+    ssize_t sendGathered(const utils::ByteSpan* buffers, size_t count);
     
     std::shared_ptr<TransportProtocol> transport_;
     std::shared_ptr<SecurityManager> security_manager_;
-    SecureTransportConfig config_;
+    utils::ConfigSnapshot<SecureTransportConfig> config_;  ///< Read without locking on every record
     std::shared_ptr<SecureContext> secure_context_;
     ConnectionState state_;
     TransportError last_error_;
@@ -254,6 +422,10 @@ private:
     bool is_handshake_complete_;
     std::string negotiated_protocol_;
     bool is_server_mode_{false}; // Added: To know if operating in server mode
+    std::string endpoint_;  // Last endpoint connected to; the session cache key
+    std::vector<uint8_t> early_data_out_;  // Request to send as early data on the next handshake
+    size_t early_data_written_{0};
+    std::vector<uint8_t> early_data_in_;   // Early data received as server, served before the stream
 
     // Custom BIO for OpenSSL integration
     struct BIOData;
@@ -261,7 +433,13 @@ private:
 
     std::unique_ptr<BatchContext> batchContext_;
     std::unique_ptr<AdaptiveRecordContext> adaptiveContext_;
+    std::unique_ptr<OffloadContext> offloadContext_;
     std::unique_ptr<VectoredIOContext> vectoredContext_;
+
+    // Kernel TLS: the TLS engine reads and writes the transport's socket itself
+    bool socket_attached_{false};
+    bool kernel_tls_send_{false};
+    bool kernel_tls_receive_{false};
 };
 
 } // namespace core
@@ -64,6 +64,31 @@ struct AdaptiveRecordConfig {
     float shrinkFactor{0.75f};             // Factor to decrease size by
 };
 
+/**
+ * @brief Configuration for sealing records on a pool of crypto workers
+ */
+struct CryptoOffloadConfig {
+    bool enabled{false};                   // Seal records with direct AEAD instead of the TLS engine; both peers must agree
+    size_t workerThreads{0};               // Dedicated pool size; 0 uses the process-wide pool
+    size_t recordSize{16384};              // Plaintext bytes per record
+    size_t minParallelSize{65536};         // Smaller writes are sealed on the calling thread
+};
+
+/**
+ * @brief Configuration for handing TLS records to the Linux kernel (kTLS)
+ *
+ * Once the handshake completes, the kernel encrypts and decrypts records on
+ * the socket itself, or the NIC does where it offers TLS offload, so sends
+ * and receives are plain socket calls and files can be sent with sendfile.
+ * Needs a TLS stream socket, an OpenSSL built with kTLS and the kernel's tls
+ * module, and a cipher the kernel supports; each direction falls back to the
+ * TLS engine on its own if the kernel declines it.
+ */
+struct KernelTlsConfig {
+    bool enabled{false};
+    bool required{false};                  // Fail the handshake unless the kernel takes both directions
+};
+
 /**
  * @brief Configuration for authentication caching
  */
@@ -85,6 +110,20 @@ struct ConnectionPoolConfig {
     bool validateOnBorrow{true};           // Validate connections when borrowed
 };
 
+/**
+ * @brief Configuration for KeyManager's pool of pre-generated keys
+ *
+ * A background task keeps symmetric keys and ephemeral ECDH key pairs ready
+ * for each key size and curve in use, about as many as were taken over the
+ * last demand window, so a burst of exchanges only computes shared secrets.
+ */
+struct KeyPoolConfig {
+    bool enabled{true};                     // Enable/disable the key pool
+    size_t minPooled{4};                   // Keys kept ready per size or curve once it has been used
+    size_t maxPooled{256};                 // Most keys kept ready per size or curve
+    std::chrono::milliseconds demandWindow{1000}; // Window demand is counted over, and refill interval
+};
+
 /**
  * @brief Configuration for security monitoring and logging
  */
@@ -96,6 +135,7 @@ struct SecurityMonitorConfig {
     bool maskSensitiveData{true};          // Mask sensitive data in logs
     size_t maxLogSize{10 * 1024 * 1024};   // Maximum log file size
     size_t maxLogFiles{5};                 // Maximum number of log files to keep
+    size_t eventBufferSize{1024};          // Recent events kept for getSecurityEvents()
 
     bool operator==(const SecurityMonitorConfig& other) const {
         return enablePerformanceMetrics == other.enablePerformanceMetrics &&
@@ -104,7 +144,8 @@ struct SecurityMonitorConfig {
                logLevel == other.logLevel &&
                maskSensitiveData == other.maskSensitiveData &&
                maxLogSize == other.maxLogSize &&
-               maxLogFiles == other.maxLogFiles;
+               maxLogFiles == other.maxLogFiles &&
+               eventBufferSize == other.eventBufferSize;
     }
 
     bool operator!=(const SecurityMonitorConfig& other) const {
@@ -137,7 +178,9 @@ struct SecurityConfig {
     bool enableSessionTickets{true};
     bool enableOCSPStapling{true};
     std::vector<std::string> alpnProtocols;
-    uint32_t maxSessionCacheSize{1000};
+    uint32_t maxSessionCacheSize{1000};     // Sessions kept for resumption, across all endpoints
+    bool enableEarlyData{false};            // TLS 1.3 0-RTT; replayable, so idempotent messages only
+    uint32_t maxEarlyDataSize{16384};       // Early data a server accepts per connection
     
     // DTLS specific settings
     std::chrono::seconds cookieLifetime{300};
@@ -147,8 +190,11 @@ struct SecurityConfig {
     // Performance optimization settings
     RecordBatchingConfig recordBatching;
     AdaptiveRecordConfig adaptiveRecord;
+    CryptoOffloadConfig cryptoOffload;
+    KernelTlsConfig kernelTls;
     AuthCacheConfig authCache;
     ConnectionPoolConfig connectionPool;
+    KeyPoolConfig keyPool;
     bool enableVectoredIO{true};
     bool enableSelectiveEncryption{true};
     
@@ -247,6 +293,10 @@ struct SecurityConfig {
             return "Session cache size must be positive";
         }
         
+        if (enableEarlyData && (protocol != EncryptionProtocol::TLS_1_3 || !enableSessionTickets)) {
+            return "Early data requires TLS 1.3 with session tickets";
+        }
+        
         if (recordBatching.enabled) {
             if (recordBatching.maxBatchSize < recordBatching.minMessageSize) {
                 return "Record batching max size must be greater than min message size";
@@ -269,6 +319,15 @@ struct SecurityConfig {
             }
         }
         
+        if (cryptoOffload.enabled &&
+            (cryptoOffload.recordSize == 0 || cryptoOffload.recordSize > 65536 - 28)) {
+            return "Crypto offload record size must fit in a 64 KB frame with its header and tag";
+        }
+
+        if (kernelTls.enabled && cryptoOffload.enabled) {
+            return "Kernel TLS and crypto offload both replace the TLS engine's records; enable only one";
+        }
+        
         if (authCache.enabled && authCache.maxCacheSize == 0) {
             return "Auth cache size must be positive when enabled";
         }
@@ -282,6 +341,15 @@ struct SecurityConfig {
             }
         }
         
+        if (keyPool.enabled) {
+            if (keyPool.maxPooled < keyPool.minPooled) {
+                return "Key pool max size must be greater than min size";
+            }
+            if (keyPool.demandWindow.count() <= 0) {
+                return "Key pool demand window must be positive";
+            }
+        }
+        
         return std::nullopt;
     }
 };
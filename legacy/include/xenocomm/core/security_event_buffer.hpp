@@ -0,0 +1,116 @@
+#ifndef XENOCOMM_CORE_SECURITY_EVENT_BUFFER_HPP
+#define XENOCOMM_CORE_SECURITY_EVENT_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Security event types for logging
+ */
+enum class SecurityEventType {
+    HANDSHAKE_START,
+    HANDSHAKE_COMPLETE,
+    HANDSHAKE_FAILED,
+    AUTH_SUCCESS,
+    AUTH_FAILURE,
+    CERT_VALIDATION_SUCCESS,
+    CERT_VALIDATION_FAILURE,
+    KEY_ROTATION,
+    CONFIG_CHANGE,
+    SECURITY_VIOLATION
+};
+
+constexpr size_t SECURITY_EVENT_TYPE_COUNT = static_cast<size_t>(SecurityEventType::SECURITY_VIOLATION) + 1;
+
+/**
+ * @brief Security event data for logging
+ */
+struct SecurityEvent {
+    SecurityEventType type;
+    std::chrono::system_clock::time_point timestamp;
+    std::string description;
+    std::optional<std::string> sourceIp;
+    std::optional<std::string> username;
+    std::optional<std::string> certificateSubject;
+    bool isSensitive{false};
+};
+
+/**
+ * @brief The most recent security events, in a fixed number of slots.
+ *
+ * record() claims the next slot with one atomic increment and overwrites
+ * whatever the slot held, so logging costs the same however full the
+ * buffer is. Each slot has its own lock, held only to move an event in or
+ * copy one out, so writers contend only when they lap each other. Every
+ * event type keeps an index of the slots its events went to, so a query
+ * for one type visits only those, and a count of all its events ever
+ * recorded, overwritten or not.
+ */
+class SecurityEventBuffer {
+public:
+    /**
+     * @param capacity Events kept; at least one
+     */
+    explicit SecurityEventBuffer(size_t capacity = 1024);
+
+    SecurityEventBuffer(const SecurityEventBuffer&) = delete;
+    SecurityEventBuffer& operator=(const SecurityEventBuffer&) = delete;
+
+    /**
+     * @brief Stores a copy of event, overwriting the oldest once full. Safe from any thread.
+     */
+    void record(const SecurityEvent& event);
+
+    /**
+     * @brief Up to maxEvents of the kept events, newest first, optionally of one type only
+     */
+    std::vector<SecurityEvent> recent(size_t maxEvents, std::optional<SecurityEventType> type = std::nullopt) const;
+
+    /**
+     * @brief Events of type recorded since construction, including those overwritten since
+     */
+    uint64_t count(SecurityEventType type) const {
+        return typeCounts_[static_cast<size_t>(type)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Events recorded since construction, of all types
+     */
+    uint64_t total() const { return next_.load(std::memory_order_relaxed); }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        mutable std::mutex mutex;
+        uint64_t sequence = 0;  // Sequence number of the event held, plus one; 0 while empty
+        SecurityEvent event{};
+    };
+
+    // Copies out the event numbered sequence if its slot still holds it and type matches
+    bool read(uint64_t sequence, std::optional<SecurityEventType> type, std::vector<SecurityEvent>& out) const;
+
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> next_{0};  // Sequence number of the next event
+
+    // Per type, the sequence numbers (plus one) of its latest events, in a ring indexed by the type's count
+    std::array<std::unique_ptr<std::atomic<uint64_t>[]>, SECURITY_EVENT_TYPE_COUNT> typeIndex_;
+    std::array<std::atomic<uint64_t>, SECURITY_EVENT_TYPE_COUNT> typeCounts_{};
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_SECURITY_EVENT_BUFFER_HPP
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <memory>
@@ -9,61 +12,17 @@
 #include <atomic>
 #include <mutex>
 #include "xenocomm/utils/result.hpp"
+#include "xenocomm/utils/byte_span.hpp"
 #include "xenocomm/core/security_config.hpp"
+#include "xenocomm/core/auth_cache.hpp"
+#include "xenocomm/core/security_metrics.hpp"
+#include "xenocomm/core/security_event_buffer.hpp"
+#include "xenocomm/utils/event_log.hpp"
 #include "xenocomm/core/socket_defs.hpp"
 
 namespace xenocomm {
 namespace core {
 
-/**
- * @brief Performance metrics for security operations
- */
-struct SecurityMetrics {
-    std::atomic<uint64_t> totalEncryptionOps{0};
-    std::atomic<uint64_t> totalDecryptionOps{0};
-    std::atomic<uint64_t> totalHandshakes{0};
-    std::atomic<uint64_t> totalAuthAttempts{0};
-    std::atomic<uint64_t> totalAuthCacheHits{0};
-    std::atomic<uint64_t> totalBytesEncrypted{0};
-    std::atomic<uint64_t> totalBytesDecrypted{0};
-    std::atomic<uint64_t> totalHandshakeTime{0};  // in milliseconds
-    std::atomic<uint64_t> totalEncryptionTime{0}; // in microseconds
-    std::atomic<uint64_t> totalDecryptionTime{0}; // in microseconds
-    std::atomic<uint64_t> peakEncryptionLatency{0}; // in microseconds
-    std::atomic<uint64_t> peakDecryptionLatency{0}; // in microseconds
-    std::atomic<uint64_t> currentConnections{0};
-    std::atomic<uint64_t> peakConnections{0};
-};
-
-/**
- * @brief Security event types for logging
- */
-enum class SecurityEventType {
-    HANDSHAKE_START,
-    HANDSHAKE_COMPLETE,
-    HANDSHAKE_FAILED,
-    AUTH_SUCCESS,
-    AUTH_FAILURE,
-    CERT_VALIDATION_SUCCESS,
-    CERT_VALIDATION_FAILURE,
-    KEY_ROTATION,
-    CONFIG_CHANGE,
-    SECURITY_VIOLATION
-};
-
-/**
- * @brief Security event data for logging
- */
-struct SecurityEvent {
-    SecurityEventType type;
-    std::chrono::system_clock::time_point timestamp;
-    std::string description;
-    std::optional<std::string> sourceIp;
-    std::optional<std::string> username;
-    std::optional<std::string> certificateSubject;
-    bool isSensitive{false};
-};
-
 /**
  * @brief Represents a secure connection context
  */
@@ -73,6 +32,24 @@ public:
     virtual Result<void> handshake() = 0;
     virtual Result<std::vector<uint8_t>> encrypt(const std::vector<uint8_t>& data) = 0;
     virtual Result<std::vector<uint8_t>> decrypt(const std::vector<uint8_t>& data) = 0;
+
+    /**
+     * @brief Decrypts straight into out, truncating to its size; returns the bytes written.
+     *
+     * Lets receive paths decrypt from a pooled buffer into the caller's. The
+     * default goes through decrypt(); contexts that can write in place override it.
+     */
+    virtual Result<size_t> decryptInto(utils::ByteSpan data, utils::MutableByteSpan out) {
+        auto result = decrypt(data.to_vector());
+        if (!result.has_value()) {
+            return Result<size_t>(result.error());
+        }
+        size_t written = std::min(out.size(), result.value().size());
+        if (written > 0) {
+            std::memcpy(out.data(), result.value().data(), written);
+        }
+        return Result<size_t>(written);
+    }
     virtual bool isHandshakeComplete() const = 0;
     virtual std::string getPeerCertificateInfo() const = 0;
     virtual CipherSuite getNegotiatedCipherSuite() const = 0;
@@ -88,16 +65,151 @@ public:
     virtual int getKeySize() const = 0;
     virtual Result<std::vector<uint8_t>> generateDTLSCookie() = 0;
     virtual bool verifyDTLSCookie(const std::vector<uint8_t>& cookie) = 0;
+
+    /**
+     * @brief RFC 5705 keying material from the completed handshake.
+     *
+     * Lets a record layer outside the TLS engine (AeadRecordLayer) derive
+     * keys both peers agree on.
+     */
+    virtual Result<std::vector<uint8_t>> exportKeyingMaterial(const std::string& label, size_t length) {
+        (void)label;
+        (void)length;
+        return Result<std::vector<uint8_t>>(std::string("Keying material export not supported"));
+    }
+
+    virtual bool isServerSide() const { return false; }
+
+    /**
+     * @brief Offers a session cached for endpoint so the handshake can resume it; clients only.
+     *
+     * Sessions the server issues on this connection are cached under the
+     * same endpoint for the next one.
+     * 
+     * @return true if a cached session was offered
+     */
+    virtual bool resumeSession(const std::string& endpoint) { (void)endpoint; return false; }
+
+    /**
+     * @brief Whether the completed handshake resumed a session rather than running in full.
+     */
+    virtual bool isSessionResumed() const { return false; }
+
+    /**
+     * @brief Sends data as TLS 1.3 early data, before the handshake completes.
+     *
+     * Needs a resumed session whose ticket allows early data. An attacker can
+     * replay early data, so only send requests that are safe to repeat. Once
+     * the handshake is done, data the server did not accept must be resent.
+     * 
+     * @return Bytes written
+     */
+    virtual Result<size_t> writeEarlyData(utils::ByteSpan data) {
+        (void)data;
+        return Result<size_t>(std::string("Early data not supported by this context"));
+    }
+
+    virtual bool isEarlyDataAccepted() const { return false; }
+
+    /**
+     * @brief Early data a server received during the handshake; empty after the first call.
+     */
+    virtual std::vector<uint8_t> takeEarlyData() { return std::vector<uint8_t>(); }
+
+    /**
+     * @brief Runs the handshake and records over a connected, non-blocking socket.
+     *
+     * Lets HandshakePipeline drive doHandshakeStep() from socket readiness.
+     * The socket stays owned, and is closed, by the caller.
+     */
+    virtual bool attachSocket(int fd) { (void)fd; return false; }
+
+    /**
+     * @brief Whether the last doHandshakeStep() is waiting to write rather than to read.
+     */
+    virtual bool handshakeWantsWrite() const { return false; }
+
+    /**
+     * @brief Asks the TLS engine to hand records to the kernel once the handshake completes.
+     *
+     * Call after attachSocket() and before the handshake. Whether the kernel
+     * took each direction is known once it completes.
+     *
+     * @return false if this context or its TLS library cannot use kernel TLS
+     */
+    virtual bool enableKernelTls() { return false; }
+
+    /**
+     * @brief Whether the kernel encrypts records sent on the attached socket.
+     *
+     * If so, plaintext written straight to the socket goes out as records.
+     */
+    virtual bool kernelTlsSend() const { return false; }
+
+    /**
+     * @brief Whether the kernel decrypts records received on the attached socket.
+     */
+    virtual bool kernelTlsReceive() const { return false; }
+
+    /**
+     * @brief Sends data as records on the attached socket; returns the bytes written.
+     */
+    virtual Result<size_t> writeToSocket(utils::ByteSpan data) {
+        (void)data;
+        return Result<size_t>(std::string("No socket attached"));
+    }
+
+    /**
+     * @brief Reads application data from the attached socket into out.
+     *
+     * @return Bytes read, or 0 once the peer has closed the connection
+     */
+    virtual Result<size_t> readFromSocket(utils::MutableByteSpan out) {
+        (void)out;
+        return Result<size_t>(std::string("No socket attached"));
+    }
+
+    /**
+     * @brief Sends size bytes of the file open as fd, from offset, as records on the attached socket.
+     *
+     * Needs kernelTlsSend(): the kernel reads and encrypts the file itself.
+     */
+    virtual Result<size_t> sendFile(int fd, int64_t offset, size_t size) {
+        (void)fd;
+        (void)offset;
+        (void)size;
+        return Result<size_t>(std::string("sendfile needs kernel TLS"));
+    }
+
+    /**
+     * @brief Returns the context to its freshly created state for another connection.
+     *
+     * SecurityManager calls this before pooling a released context.
+     * 
+     * @return false if the context cannot be reused
+     */
+    virtual bool reset() { return false; }
 };
 
 /**
  * @brief Manages security operations including encryption, authentication, and monitoring
+ *
+ * Managers whose protocol, cipher, certificate and session settings match
+ * share one OpenSSL SSL_CTX, built the first time any of them needs a
+ * context, so the certificate files are read once per process rather than
+ * once per channel. A rewritten certificate file is read again by the next
+ * manager to start using it.
  */
 class SecurityManager {
 public:
+    static constexpr size_t DTLS_COOKIE_SIZE = 20;  // Bucket, 32-bit little-endian, then a 128-bit MAC
+
     /**
      * @brief Creates a SecurityManager instance
      * 
+     * Only the configuration is checked here; certificates are loaded with
+     * the first context, and createContext() reports any failure to do so.
+     * 
      * @param config Security configuration
      */
     explicit SecurityManager(const SecurityConfig& config);
@@ -111,6 +223,25 @@ public:
      */
     Result<std::shared_ptr<SecureContext>> createContext(bool isServer);
 
+    /**
+     * @brief Fills the idle context pool ahead of a connection burst
+     * 
+     * createContext() hands out idle contexts before creating new ones, and a
+     * context whose last reference is dropped is reset and returns to the
+     * pool. Nothing is warmed at construction; call this ahead of a burst,
+     * e.g. with connectionPool.minPoolSize.
+     * 
+     * @param isServer Role of the contexts to create
+     * @param count Idle contexts wanted, capped at connectionPool.maxPoolSize
+     * @return Idle contexts of that role now in the pool
+     */
+    size_t prewarmContexts(bool isServer, size_t count);
+
+    /**
+     * @brief Number of distinct SSL_CTX objects the managers in this process share
+     */
+    static size_t sharedContextCount();
+
     /**
      * @brief Updates the security configuration
      * 
@@ -129,7 +260,7 @@ public:
     /**
      * @brief Gets the current security metrics
      * 
-     * @return const SecurityMetrics& Current metrics
+     * @return const SecurityMetrics& Current metrics; call snapshot() for totals and percentiles
      */
     const SecurityMetrics& getMetrics() const { return metrics_; }
 
@@ -153,6 +284,13 @@ public:
     /**
      * @brief Generate a DTLS cookie for a client
      * 
+     * Cookies are stateless: DTLS_COOKIE_SIZE bytes naming the time bucket
+     * they were issued in and a MAC of that bucket and the client's address.
+     * Each bucket, SecurityConfig::cookieLifetime long, has its own random
+     * key; a cookie is accepted for the rest of its bucket and all of the
+     * next, so it lives between one and two lifetimes and no more than two
+     * keys are ever kept. Safe to call from any number of threads.
+     * 
      * @param client Network address of the client
      * @return Result<std::vector<uint8_t>> Generated cookie or error
      */
@@ -161,6 +299,11 @@ public:
     /**
      * @brief Verify a DTLS cookie from a client
      * 
+     * Tags under the live key in place, on this thread's HMAC context, and
+     * waits only while a new bucket's key is made, so a flood of forged
+     * ClientHellos costs little more than one MAC each. No key or context is
+     * copied; OpenSSL 3.0 still allocates briefly when the MAC restarts.
+     * 
      * @param cookie Cookie to verify
      * @param source Network address that provided the cookie
      * @return Result<void> Success if cookie is valid, error otherwise
@@ -170,6 +313,9 @@ public:
     /**
      * @brief Gets recent security events
      * 
+     * Newest first, from the last SecurityMonitorConfig::eventBufferSize
+     * events logged.
+     * 
      * @param maxEvents Maximum number of events to return
      * @param filterType Optional event type to filter by
      * @return std::vector<SecurityEvent> List of recent security events
@@ -178,6 +324,13 @@ public:
         size_t maxEvents,
         std::optional<SecurityEventType> filterType = std::nullopt) const;
 
+    /**
+     * @brief Gets the number of events of a type logged since monitoring was last (re)initialized
+     * 
+     * Counts every event, including those no longer kept for getSecurityEvents().
+     */
+    uint64_t getSecurityEventCount(SecurityEventType type) const;
+
     /**
      * @brief Resets performance metrics
      */
@@ -186,7 +339,7 @@ public:
     /**
      * @brief Gets the connection pool status
      * 
-     * @return std::pair<size_t, size_t> Current and available connections
+     * @return std::pair<size_t, size_t> Contexts in use and idle contexts ready for handshakes
      */
     std::pair<size_t, size_t> getConnectionPoolStatus() const;
 
@@ -197,10 +350,22 @@ public:
      */
     std::pair<size_t, float> getAuthCacheStats() const;
 
+    /**
+     * @brief Gets the authentication result cache, sized by SecurityConfig::authCache
+     * 
+     * Pass it to authentication providers (e.g. TokenAuthConfig::cache) so
+     * they share one bounded cache. Null when auth caching is disabled.
+     */
+    std::shared_ptr<AuthCache> getAuthCache() const { return std::atomic_load(&authCache_); }
+
 protected:
     /**
      * @brief Logs a security event
      * 
+     * Stores it for getSecurityEvents() and, with the audit log enabled,
+     * queues a line for security.log, which is written in batches off the
+     * caller's thread.
+     * 
      * @param event Event to log
      */
     virtual void logSecurityEvent(const SecurityEvent& event);
@@ -208,7 +373,7 @@ protected:
     /**
      * @brief Updates performance metrics
      * 
-     * @param operation Type of operation (e.g., "encrypt", "decrypt")
+     * @param operation Type of operation ("encrypt", "decrypt" or "handshake")
      * @param bytes Number of bytes processed
      * @param duration Operation duration
      */
@@ -218,9 +383,8 @@ protected:
         std::chrono::microseconds duration);
 
 private:
-    Result<void> initializeSSL();
-    Result<void> loadCertificates();
-    void cleanupSSL();
+    Result<void> initializeSSL();  // Acquires the shared SSL_CTX unless already held
+    bool cleanupSSL();             // Drops it and the idle contexts made from it; true if one was held
     Result<void> validateConfig(const SecurityConfig& config);
     void initializeMonitoring();
     void cleanupMonitoring();
@@ -229,15 +393,18 @@ private:
     SecurityMetrics metrics_;
     struct SSLData;
     std::unique_ptr<SSLData> sslData_; // Pimpl for OpenSSL data
-    std::vector<SecurityEvent> securityEvents_;
-    mutable std::mutex eventsMutex_;
-    std::unordered_map<std::string, std::chrono::system_clock::time_point> authCache_;
-    mutable std::mutex authCacheMutex_;
-    std::vector<std::shared_ptr<SecureContext>> connectionPool_;
-    mutable std::mutex poolMutex_;
-    Result<std::vector<uint8_t>> generateHmac(const std::vector<uint8_t>& data);
-    std::vector<uint8_t> hmac_key_; // HMAC key for cookie generation
-    std::chrono::seconds cookie_lifetime_{300}; // Cookie lifetime (5 minutes)
+    std::shared_ptr<SecurityEventBuffer> events_;  // Replaced atomically when monitoring is reconfigured
+    std::shared_ptr<utils::EventLog> auditLog_;    // Null unless the audit log is enabled; likewise replaced
+    std::shared_ptr<AuthCache> authCache_;  // Replaced atomically by updateConfig
+    struct ContextPool;
+    std::unique_ptr<SecureContext> newContext(bool isServer, std::string& error);
+    std::shared_ptr<SecureContext> leaseContext(std::unique_ptr<SecureContext> context, uint64_t generation);
+    static void recycleContext(const std::weak_ptr<ContextPool>& pool, SecureContext* context, uint64_t generation);
+
+    std::shared_ptr<ContextPool> contextPool_;  // Shared with leased contexts, which may outlive the manager
+    mutable std::mutex poolMutex_;  // Serializes updateConfig
+    struct CookieKeys;
+    std::unique_ptr<CookieKeys> cookieKeys_;  // Keys of the live cookie buckets
 };
 
 } // namespace core
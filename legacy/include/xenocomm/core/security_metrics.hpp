@@ -0,0 +1,118 @@
+#ifndef XENOCOMM_CORE_SECURITY_METRICS_HPP
+#define XENOCOMM_CORE_SECURITY_METRICS_HPP
+
+#include "xenocomm/utils/latency_histogram.hpp"
+#include "xenocomm/utils/metrics_registry.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Latency distribution exported from a SecurityMetrics histogram, in microseconds
+ */
+struct LatencySummary {
+    uint64_t count{0};
+    uint64_t p50{0};
+    uint64_t p99{0};
+    uint64_t p999{0};
+    uint64_t max{0};
+};
+
+/**
+ * @brief Performance metrics for security operations
+ *
+ * Counters and latency histograms are striped over cache-line aligned slots,
+ * and each thread records into its own slot, so encrypt/decrypt paths on
+ * different cores never write to the same line. Slots are allocated on first
+ * use; snapshot() sums them. Recording is wait-free.
+ */
+class SecurityMetrics {
+public:
+    static constexpr size_t SLOT_COUNT = 16;
+
+    /**
+     * @brief Point-in-time totals across all slots
+     */
+    struct Snapshot {
+        uint64_t totalEncryptionOps{0};
+        uint64_t totalDecryptionOps{0};
+        uint64_t totalHandshakes{0};
+        uint64_t totalAuthAttempts{0};
+        uint64_t totalAuthCacheHits{0};
+        uint64_t totalBytesEncrypted{0};
+        uint64_t totalBytesDecrypted{0};
+        uint64_t totalHandshakeTime{0};  // in milliseconds
+        uint64_t totalEncryptionTime{0}; // in microseconds
+        uint64_t totalDecryptionTime{0}; // in microseconds
+        uint64_t peakEncryptionLatency{0}; // in microseconds
+        uint64_t peakDecryptionLatency{0}; // in microseconds
+        uint64_t currentConnections{0};
+        uint64_t peakConnections{0};
+        LatencySummary encryptionLatency;
+        LatencySummary decryptionLatency;
+        LatencySummary handshakeLatency;
+    };
+
+    SecurityMetrics() = default;
+    ~SecurityMetrics();
+
+    SecurityMetrics(const SecurityMetrics&) = delete;
+    SecurityMetrics& operator=(const SecurityMetrics&) = delete;
+
+    void recordEncryption(size_t bytes, std::chrono::microseconds duration);
+    void recordDecryption(size_t bytes, std::chrono::microseconds duration);
+    void recordHandshake(std::chrono::microseconds duration);
+    void recordAuthAttempt(bool cacheHit);
+
+    /**
+     * @brief Sets the number of open connections and raises the peak if exceeded
+     */
+    void setConnections(uint64_t current);
+
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Zeroes counters and histograms; the connection gauges are left alone
+     */
+    void reset();
+
+    /**
+     * @brief Reports snapshot() through registry whenever it is exported, labelled instance=<instance>
+     *
+     * Const because it leaves the metrics themselves untouched; registering
+     * again replaces the previous registration.
+     */
+    void registerMetrics(utils::MetricsRegistry& registry, const std::string& instance) const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> encryptionOps{0};
+        std::atomic<uint64_t> decryptionOps{0};
+        std::atomic<uint64_t> handshakes{0};
+        std::atomic<uint64_t> authAttempts{0};
+        std::atomic<uint64_t> authCacheHits{0};
+        std::atomic<uint64_t> bytesEncrypted{0};
+        std::atomic<uint64_t> bytesDecrypted{0};
+        utils::LatencyHistogram encryptionLatency;
+        utils::LatencyHistogram decryptionLatency;
+        utils::LatencyHistogram handshakeLatency;
+    };
+
+    Slot& localSlot();
+
+    std::array<std::atomic<Slot*>, SLOT_COUNT> slots_{};
+    alignas(64) std::atomic<uint64_t> currentConnections_{0};
+    std::atomic<uint64_t> peakConnections_{0};
+    mutable utils::MetricsRegistration metricsRegistration_;  // Last, so it is removed before the slots
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_SECURITY_METRICS_HPP
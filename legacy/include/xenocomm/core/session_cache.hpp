@@ -0,0 +1,104 @@
+#ifndef XENOCOMM_CORE_SESSION_CACHE_HPP
+#define XENOCOMM_CORE_SESSION_CACHE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef struct ssl_session_st SSL_SESSION;
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Process-wide cache of TLS client sessions, keyed by endpoint.
+ *
+ * Every session or TLS 1.3 ticket a server issues is stored under the
+ * endpoint the client connected to and offered on the next handshake there,
+ * so reconnects and new pooled connections skip certificate exchange and key
+ * agreement. As RFC 8446 recommends, a TLS 1.3 ticket is handed out at most
+ * once; servers issue several per connection, and each later connection
+ * stores its own. TLS 1.2 sessions are reused until they expire.
+ *
+ * Bounded by a total session count, evicting the oldest first, and by a
+ * lifetime on top of the session's own timeout. Expired sessions are
+ * dropped as they reach the front of the store order, so cleanup costs only
+ * what has expired.
+ */
+class SessionCache {
+public:
+    /// Tickets kept per endpoint; older ones give way to newer
+    static constexpr size_t MAX_SESSIONS_PER_ENDPOINT = 4;
+
+    struct Stats {
+        size_t sessions = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;   ///< Dropped for space or age before being used
+    };
+
+    SessionCache(size_t maxSessions, std::chrono::seconds lifetime);
+    ~SessionCache();
+
+    SessionCache(const SessionCache&) = delete;
+    SessionCache& operator=(const SessionCache&) = delete;
+
+    /**
+     * @brief The cache shared by every SecurityManager in the process.
+     */
+    static SessionCache& shared();
+
+    /**
+     * @brief Applies new limits, evicting at once if the cache is now over them.
+     */
+    void configure(size_t maxSessions, std::chrono::seconds lifetime);
+
+    /**
+     * @brief Adds a session for endpoint, taking over the caller's reference.
+     */
+    void store(const std::string& endpoint, SSL_SESSION* session);
+
+    /**
+     * @brief The newest usable session for endpoint, or nullptr.
+     *
+     * The caller owns one reference and releases it with SSL_SESSION_free.
+     */
+    SSL_SESSION* take(const std::string& endpoint);
+
+    /**
+     * @brief Forgets endpoint's sessions, e.g. after its server rejected one.
+     */
+    void remove(const std::string& endpoint);
+
+    void clear();
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string endpoint;
+        SSL_SESSION* session;
+        std::chrono::steady_clock::time_point expires;
+    };
+    using Order = std::list<Entry>;
+
+    bool usable(const Entry& entry, std::chrono::steady_clock::time_point now) const;
+    void erase(Order::iterator entry);
+    void evictLocked(std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex mutex_;
+    Order order_;  // Oldest first
+    std::unordered_map<std::string, std::vector<Order::iterator>> byEndpoint_;  // Oldest first per endpoint
+    size_t maxSessions_;
+    std::chrono::seconds lifetime_;
+    Stats stats_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_SESSION_CACHE_HPP
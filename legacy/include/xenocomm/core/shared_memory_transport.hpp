@@ -0,0 +1,127 @@
+#ifndef XENOCOMM_CORE_SHARED_MEMORY_TRANSPORT_HPP
+#define XENOCOMM_CORE_SHARED_MEMORY_TRANSPORT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Message transport between processes on one host, through shared memory
+ *
+ * Two processes that would otherwise talk over loopback map one POSIX shared
+ * memory segment instead, holding a single-producer single-consumer ring per
+ * direction. A send copies the message straight into the ring and a receive
+ * copies it out; there is no socket, no fragmentation and no checksum.
+ * Blocked readers and writers sleep on a futex in the segment and are only
+ * woken when the other side has flagged that it is waiting, so a busy
+ * connection makes no system calls at all.
+ *
+ * Both ends connect with the other's "host:port" as endpoint and their own
+ * port in ConnectionConfig::localPort, just as two UDP peers would; the pair
+ * of ports names the segment. The first to arrive creates it, connect() waits
+ * up to connectionTimeoutMs for the other, and the name is unlinked once both
+ * are attached. Messages keep their boundaries. The largest message is
+ * ringCapacity minus 4 bytes.
+ */
+class SharedMemoryTransport : public TransportProtocol {
+public:
+    /**
+     * @param ringCapacity Bytes per direction, rounded up to a power of two
+     */
+    explicit SharedMemoryTransport(size_t ringCapacity = 1024 * 1024);
+    ~SharedMemoryTransport() override;
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    /**
+     * @brief Whether endpoint is on this host, so a peer there could share memory with us
+     */
+    static bool isLocalEndpoint(const std::string& endpoint);
+
+    bool connect(const std::string& endpoint, const ConnectionConfig& config) override;
+    bool disconnect() override;
+    bool isConnected() const override;
+
+    ssize_t send(const uint8_t* data, size_t size) override;
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
+    bool isReliableStream() const override { return true; }
+    ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) override;
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override;
+    ssize_t receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) override;
+    ssize_t receive(uint8_t* buffer, size_t size) override;
+
+    bool getPeerAddress(std::string& address, uint16_t& port) override;
+    int getSocketFd() const override { return -1; }
+    bool setNonBlocking(bool nonBlocking) override;
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setSendTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setKeepAlive(bool) override { return true; }
+    bool setTcpNoDelay(bool) override { return true; }
+    bool setReuseAddress(bool) override { return true; }
+    bool setReceiveBufferSize(size_t) override { return true; }
+    bool setSendBufferSize(size_t) override { return true; }
+    std::string getLastError() const override;
+    bool setLocalPort(uint16_t port) override;
+    ConnectionState getState() const override;
+    TransportError getLastErrorCode() const override;
+    std::string getErrorDetails() const override;
+    bool reconnect(uint32_t maxAttempts = 3, uint32_t delayMs = 1000) override;
+    void setStateCallback(std::function<void(ConnectionState)> callback) override;
+    void setErrorCallback(std::function<void(TransportError, const std::string&)> callback) override;
+    bool checkHealth() override { return isConnected(); }
+
+private:
+    struct Ring;
+    struct Segment;
+
+    // Both wait on ring words and give up at the deadline, or when the peer leaves
+    bool waitForData(Ring& ring, uint64_t tail, std::chrono::steady_clock::time_point deadline, bool timed);
+    bool waitForSpace(Ring& ring, uint64_t head, size_t needed, std::chrono::steady_clock::time_point deadline,
+                      bool timed);
+    ssize_t receiveMessage(utils::PooledBuffer& message, size_t maxSize);
+    void unmap();
+    void setError(TransportError code, const std::string& details);
+    void updateState(ConnectionState state);
+
+    const size_t capacity_;
+    std::string name_;
+    std::string endpoint_;
+    std::string peerHost_;
+    uint16_t peerPort_ = 0;
+    uint16_t localPort_ = 0;
+    Segment* segment_ = nullptr;
+    size_t mappedSize_ = 0;
+    int side_ = 0;  // Writes rings[side_], reads rings[1 - side_]
+    std::atomic<ConnectionState> state_{ConnectionState::DISCONNECTED};
+    std::atomic<bool> closing_{false};  // disconnect() is waking blocked calls before unmapping
+
+    std::mutex sendMutex_;     // One producer per ring
+    std::mutex receiveMutex_;  // One consumer per ring
+    utils::PooledBuffer partial_;  // Rest of a message receive() has started on
+    size_t partialOffset_ = 0;
+
+    std::atomic<bool> nonBlocking_{false};
+    std::atomic<int64_t> receiveTimeoutMs_{0};  // 0 waits indefinitely
+    std::atomic<int64_t> sendTimeoutMs_{0};
+
+    mutable std::mutex errorMutex_;
+    TransportError lastError_ = TransportError::NONE;
+    std::string errorDetails_;
+    std::function<void(ConnectionState)> stateCallback_;
+    std::function<void(TransportError, const std::string&)> errorCallback_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_SHARED_MEMORY_TRANSPORT_HPP
@@ -0,0 +1,283 @@
+#ifndef XENOCOMM_CORE_STATIC_PIPELINE_HPP
+#define XENOCOMM_CORE_STATIC_PIPELINE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "xenocomm/core/aead_record_layer.hpp"
+#include "xenocomm/core/compression_algorithms.h"
+#include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/crc32.hpp"
+#include "xenocomm/utils/result.hpp"
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Policies a StaticPipeline is built from, one per stage.
+ *
+ * Each policy names the flag bits it sets in the frame's leading byte and
+ * the bytes it adds; a policy that does nothing sets neither, and the
+ * pipeline drops its stage at compile time. The flag values extend those of
+ * TransmissionManager's framed path, so a pipeline with only AeadEncryption
+ * exchanges frames with a TransmissionManager that holds the same record layer.
+ */
+namespace pipeline {
+
+/**
+ * @brief One message per transport frame, via sendFrame()/receiveFrame().
+ */
+struct MessageFraming {
+    static ssize_t send(TransportProtocol& transport, const utils::ByteSpan* parts, size_t count) {
+        return transport.sendFrame(parts, count);
+    }
+    static ssize_t receive(TransportProtocol& transport, utils::PooledBuffer& frame) {
+        return transport.receiveFrame(frame);
+    }
+};
+
+struct NoIntegrity {
+    static constexpr uint8_t FLAG = 0;
+    static constexpr size_t OVERHEAD = 0;
+};
+
+/**
+ * @brief A little-endian CRC-32 trailer over everything before it, flags byte included.
+ */
+struct Crc32Integrity {
+    static constexpr uint8_t FLAG = 0x04;
+    static constexpr size_t OVERHEAD = 4;
+
+    static void encode(uint32_t crc, uint8_t* out) {
+        for (size_t i = 0; i < OVERHEAD; ++i) {
+            out[i] = static_cast<uint8_t>(crc >> (8 * i));
+        }
+    }
+    static uint32_t decode(const uint8_t* in) {
+        uint32_t crc = 0;
+        for (size_t i = 0; i < OVERHEAD; ++i) {
+            crc |= static_cast<uint32_t>(in[i]) << (8 * i);
+        }
+        return crc;
+    }
+};
+
+struct NoEncryption {
+    static constexpr uint8_t FLAG = 0;
+    static constexpr size_t OVERHEAD = 0;
+};
+
+/**
+ * @brief Seals each frame with the record layer, the flags byte as associated data.
+ *
+ * Sealing goes through a private Sealer, so it takes no lock; like the
+ * pipeline's send side it must be used by one thread at a time.
+ *
+ * @throws std::runtime_error if the layer is null or its cipher state cannot be copied
+ */
+class AeadEncryption {
+public:
+    static constexpr uint8_t FLAG = 0x01 | 0x02;  // FRAME_ENCRYPTED | FRAME_AEAD
+    static constexpr size_t OVERHEAD = AeadRecordLayer::TAG_SIZE;
+
+    explicit AeadEncryption(std::shared_ptr<AeadRecordLayer> layer)
+        : layer_(std::move(layer)), sealer_(layer_ ? layer_->makeSealer() : nullptr) {
+        if (!sealer_) {
+            throw std::runtime_error("AeadEncryption requires a record layer with a copyable cipher state");
+        }
+    }
+
+    bool seal(uint64_t sequence, utils::ByteSpan aad, utils::ByteSpan plaintext, uint8_t* out, uint8_t* tag) {
+        return sealer_->seal(sequence, aad, plaintext, out, tag);
+    }
+    bool open(uint64_t sequence, utils::ByteSpan aad, utils::MutableByteSpan data, const uint8_t* tag) {
+        return layer_->open(sequence, aad, data, tag);
+    }
+
+private:
+    std::shared_ptr<AeadRecordLayer> layer_;
+    std::unique_ptr<AeadRecordLayer::Sealer> sealer_;
+};
+
+struct NoCompression {
+    static constexpr uint8_t FLAG = 0;
+};
+
+/**
+ * @brief Compresses every message with one algorithm before it is sealed.
+ */
+class AlgorithmCompression {
+public:
+    static constexpr uint8_t FLAG = 0x08;
+
+    explicit AlgorithmCompression(std::unique_ptr<CompressionAlgorithm> algorithm)
+        : algorithm_(std::move(algorithm)) {}
+
+    // Either may throw CompressionError
+    std::vector<uint8_t> compress(utils::ByteSpan data) { return algorithm_->compress(data.to_vector()); }
+    std::vector<uint8_t> decompress(utils::ByteSpan data) { return algorithm_->decompress(data.to_vector()); }
+
+private:
+    std::unique_ptr<CompressionAlgorithm> algorithm_;
+};
+
+} // namespace pipeline
+
+/**
+ * @brief A send/receive path fixed at compile time for a channel whose configuration is known.
+ *
+ * TransmissionManager decides per message whether to encrypt, which error
+ * check to run and how to fragment, and pays for those branches and the
+ * virtual calls behind them every time. When a channel's configuration is
+ * settled up front, a StaticPipeline instantiates just the stages it uses:
+ * disabled stages compile away, enabled ones inline into a single send and
+ * receive function, and the per-message state (sequence counters, the ciphertext
+ * buffer) is reused rather than reallocated.
+ *
+ * A frame is a flags byte, the payload (compressed, then sealed, then its
+ * tag) and the integrity trailer. Frames are never fragmented or
+ * acknowledged, so the transport must carry whole messages reliably and in
+ * order, as stream transports do; anything else stays on TransmissionManager.
+ * Frames whose flags differ from the pipeline's are rejected.
+ *
+ * One thread may send while another receives; neither side is safe for
+ * concurrent use by itself.
+ */
+template <typename Framing, typename Integrity, typename Encryption,
+          typename Compression = pipeline::NoCompression>
+class StaticPipeline {
+public:
+    static constexpr uint8_t FLAGS = Integrity::FLAG | Encryption::FLAG | Compression::FLAG;
+    static constexpr size_t OVERHEAD = 1 + Encryption::OVERHEAD + Integrity::OVERHEAD;
+
+    explicit StaticPipeline(TransportProtocol& transport, Encryption encryption = Encryption(),
+                            Compression compression = Compression())
+        : transport_(transport), encryption_(std::move(encryption)), compression_(std::move(compression)) {}
+
+    utils::Result<void> send(utils::ByteSpan data) {
+        constexpr bool compressed = Compression::FLAG != 0;
+        constexpr bool encrypted = Encryption::OVERHEAD != 0;
+        constexpr bool checked = Integrity::OVERHEAD != 0;
+
+        const uint8_t flags = FLAGS;
+        const auto flags_span = utils::ByteSpan(&flags, 1);
+        // Numbered like TransmissionManager's frames, so both count the same way
+        const uint64_t sequence = FRAME_SEQUENCE_BIT | sent_++;
+
+        utils::ByteSpan payload = data;
+        std::vector<uint8_t> deflated;
+        if constexpr (compressed) {
+            try {
+                deflated = compression_.compress(data);
+            } catch (const std::exception& e) {
+                return utils::Result<void>(std::string("Compression failed: ") + e.what());
+            }
+            payload = utils::ByteSpan(deflated);
+        }
+
+        std::array<uint8_t, Encryption::OVERHEAD + 1> tag{};
+        if constexpr (encrypted) {
+            sealed_.resize(payload.size());
+            if (!encryption_.seal(sequence, flags_span, payload, sealed_.data(), tag.data())) {
+                return utils::Result<void>("Encryption failed: AEAD seal error");
+            }
+            payload = utils::ByteSpan(sealed_);
+        }
+
+        std::array<uint8_t, Integrity::OVERHEAD + 1> trailer{};
+        if constexpr (checked) {
+            uint32_t crc = utils::crc32(flags_span);
+            crc = utils::crc32(payload, crc);
+            if constexpr (encrypted) {
+                crc = utils::crc32(tag.data(), Encryption::OVERHEAD, crc);
+            }
+            Integrity::encode(crc, trailer.data());
+        }
+
+        utils::ByteSpan parts[4] = {flags_span, payload};
+        size_t count = 2;
+        if constexpr (encrypted) {
+            parts[count++] = utils::ByteSpan(tag.data(), Encryption::OVERHEAD);
+        }
+        if constexpr (checked) {
+            parts[count++] = utils::ByteSpan(trailer.data(), Integrity::OVERHEAD);
+        }
+        if (Framing::send(transport_, parts, count) < 0) {
+            return utils::Result<void>("Failed to send frame");
+        }
+        return utils::Result<void>();
+    }
+
+    utils::Result<std::vector<uint8_t>> receive() {
+        using ReceiveResult = utils::Result<std::vector<uint8_t>>;
+        constexpr bool compressed = Compression::FLAG != 0;
+        constexpr bool encrypted = Encryption::OVERHEAD != 0;
+        constexpr bool checked = Integrity::OVERHEAD != 0;
+
+        utils::PooledBuffer frame;
+        if (Framing::receive(transport_, frame) < 0) {
+            return ReceiveResult(utils::Error(utils::ErrorCode::ReceiveFailed, transport_.getErrorDetails()));
+        }
+        // Counted before any check, so a rejected frame does not shift the peer's sequence
+        const uint64_t sequence = FRAME_SEQUENCE_BIT | received_++;
+        if (frame.size() < OVERHEAD) {
+            return ReceiveResult("Frame shorter than the pipeline's overhead");
+        }
+        if (frame.data()[0] != FLAGS) {
+            return ReceiveResult("Frame flags do not match the pipeline");
+        }
+        const auto flags_span = utils::ByteSpan(frame.data(), 1);
+        const size_t length = frame.size() - OVERHEAD;
+        uint8_t* body = frame.data() + 1;
+
+        if constexpr (checked) {
+            const size_t covered = frame.size() - Integrity::OVERHEAD;
+            if (utils::crc32(frame.data(), covered) != Integrity::decode(frame.data() + covered)) {
+                return ReceiveResult(utils::ErrorCode::ErrorCheckMismatch);
+            }
+        }
+        if constexpr (encrypted) {
+            // The pooled frame is ours alone, so it is opened in place
+            if (!encryption_.open(sequence, flags_span, utils::MutableByteSpan(body, length), body + length)) {
+                return ReceiveResult("Decryption failed: AEAD authentication error");
+            }
+        }
+        if constexpr (compressed) {
+            try {
+                return ReceiveResult(compression_.decompress(utils::ByteSpan(body, length)));
+            } catch (const std::exception& e) {
+                return ReceiveResult(std::string("Decompression failed: ") + e.what());
+            }
+        } else {
+            return ReceiveResult(std::vector<uint8_t>(body, body + length));
+        }
+    }
+
+    uint64_t messages_sent() const { return sent_; }
+    uint64_t messages_received() const { return received_; }
+
+private:
+    static constexpr uint64_t FRAME_SEQUENCE_BIT = uint64_t(1) << 63;
+
+    TransportProtocol& transport_;
+    Encryption encryption_;
+    Compression compression_;
+    std::vector<uint8_t> sealed_;  // Ciphertext of the message being sent, kept for the next
+    uint64_t sent_ = 0;
+    uint64_t received_ = 0;
+};
+
+/**
+ * @brief The hot configuration: CRC-32 over AES-GCM (or whichever suite the layer holds), uncompressed.
+ */
+using CrcAeadPipeline = StaticPipeline<pipeline::MessageFraming, pipeline::Crc32Integrity, pipeline::AeadEncryption>;
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_STATIC_PIPELINE_HPP
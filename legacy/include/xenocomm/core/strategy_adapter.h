@@ -6,11 +6,14 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace xenocomm {
 
+class StrategyTuner;
+
 /**
  * @brief Configuration parameters for a communication strategy
  */
@@ -51,6 +54,25 @@ struct ABTestResult {
     std::string explanation;
 };
 
+/**
+ * @brief How a bandit picks the strategy for the next message
+ */
+enum class BanditPolicy {
+    THOMPSON_SAMPLING,  ///< Draw from each strategy's Beta posterior of success, pick the highest draw
+    UCB1                ///< Pick the highest success rate plus its upper confidence bound
+};
+
+/**
+ * @brief What a bandit has learned about one strategy
+ */
+struct BanditArmStats {
+    std::string strategy;
+    uint64_t outcomes{0};          ///< Outcomes recorded for the strategy
+    uint64_t successes{0};
+    double meanLatencyUs{0.0};     ///< Average latency of its outcomes
+    double expectedSuccessRate{0.5}; ///< Posterior mean of its success rate, from a uniform prior
+};
+
 /**
  * @brief Strategy recommendation with explanation
  */
@@ -64,6 +86,13 @@ struct StrategyRecommendation {
 
 /**
  * @brief Interface for strategy adaptation based on feedback data
+ *
+ * The adapter follows the FeedbackLoop's window updates and fetches its
+ * detailed metrics once per window generation; evaluations, insights and
+ * effectiveness scores between updates reuse that snapshot, and
+ * evaluateAndRecommend() reuses its recommendation until the window or the
+ * thresholds change. Outcomes still waiting in the loop's ingestion rings are
+ * seen once the loop aggregates them, within its ingestFlushInterval.
  */
 class StrategyAdapter {
 public:
@@ -83,6 +112,26 @@ public:
                                     const CommunicationOutcome& outcome);
     Result<ABTestResult> getABTestResults() const;
 
+    /**
+     * @brief Starts a bandit over strategies, replacing any running one
+     *
+     * Unlike an A/B test, a bandit has no fixed duration: each call to
+     * selectStrategy() favours the strategies that have succeeded most so
+     * far, while still trying the others often enough to notice if they
+     * improve, so traffic shifts to the winner as evidence accumulates.
+     * A seed makes Thompson sampling's draws, and so its selections,
+     * reproducible.
+     */
+    Result<void> startBandit(const std::vector<std::string>& strategies,
+                             BanditPolicy policy = BanditPolicy::THOMPSON_SAMPLING,
+                             std::optional<uint64_t> seed = std::nullopt);
+    // Strategy to use for the next message; empty if no bandit is running
+    std::optional<std::string> selectStrategy();
+    // Updates the strategy's posterior in constant time
+    Result<void> recordBanditOutcome(const std::string& strategy,
+                                     const CommunicationOutcome& outcome);
+    Result<std::vector<BanditArmStats>> getBanditStats() const;
+
     // Configuration and thresholds
     void setAdaptationThresholds(const AdaptationThresholds& thresholds);
     const AdaptationThresholds& getAdaptationThresholds() const;
@@ -93,8 +142,15 @@ public:
 
     // Real-time adaptation
     Result<bool> shouldAdaptStrategy(const DetailedMetrics& currentMetrics) const;
+    /**
+     * @brief Rule-based configuration for the metrics, with the values a
+     *        tuner has learned for their link class taking precedence
+     */
     Result<StrategyConfig> getOptimalConfig(const DetailedMetrics& metrics) const;
 
+    // Tuner consulted by getOptimalConfig(); nullptr for the rules alone
+    void setTuner(std::shared_ptr<StrategyTuner> tuner);
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "xenocomm/core/feedback_loop.h"
+#include "xenocomm/core/security_config.hpp"
+#include "xenocomm/core/transmission_manager.h"
+#include "xenocomm/utils/result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+
+struct StrategyConfig;
+
+/**
+ * @brief One knob the tuner may turn, and the only values it may give it
+ *
+ * The tuner never sets a value outside values, and moves at most one step
+ * along them at a time, so the list is both the search space and its safe
+ * bounds.
+ */
+struct TunerParameter {
+    std::string name;
+    std::vector<double> values;   ///< Ascending
+    size_t initial{0};            ///< Index of the value in use before anything is learned
+};
+
+/**
+ * @brief Tuned values by parameter name
+ */
+using TunedValues = std::map<std::string, double>;
+
+/**
+ * @brief How StrategyTuner scores and explores
+ *
+ * A trial scores log(goodput) - latencyWeight * log(p99 latency), so only
+ * ratios matter: doubling goodput is worth as much on a slow link as on a
+ * fast one, and with the default weight it is worth doubling p99 latency.
+ */
+struct StrategyTunerConfig {
+    double latencyWeight{1.0};
+    uint32_t minTrials{5};          ///< Trials of a move, and of the incumbent, before it can be adopted
+    double acceptMargin{0.02};      ///< Log-score gain a move must show, beyond two standard errors, to be adopted
+    double safetyFloor{0.7};        ///< A move scoring below this fraction of the incumbent is abandoned after one trial
+    double exploreShare{0.5};       ///< Share of trials that try a move rather than re-measure the incumbent
+    std::string persistencePath;    ///< Learned configurations are saved here on adoption and loaded at construction; empty for none
+};
+
+/**
+ * @brief A configuration to run traffic under, and what it was proposed as
+ */
+struct TunerTrial {
+    std::string linkClass;
+    TunedValues values;
+    int parameter{-1};      ///< Index of the parameter moved, -1 for the incumbent
+    int direction{0};       ///< -1 or +1 step along its values
+    uint64_t epoch{0};      ///< Incumbent generation the trial was proposed against
+};
+
+/**
+ * @brief What the tuner has learned for one link class
+ */
+struct TunerClassStats {
+    TunedValues incumbent;
+    double incumbentScore{0.0};     ///< Mean score of the incumbent's trials
+    uint64_t incumbentTrials{0};
+    uint64_t trials{0};             ///< All trials recorded for the class
+    uint64_t adoptions{0};          ///< Moves that became the incumbent
+};
+
+/**
+ * @brief Learns per link class which values of the transport and record
+ *        layer knobs give the best goodput and p99 latency.
+ *
+ * Searching dozens of knobs jointly would take more trials than a link ever
+ * sees, so the search is local and one knob at a time: each link class has an
+ * incumbent configuration, and every move of one parameter one step up or
+ * down its values is an arm of a bandit. propose() picks the move whose
+ * sampled gain over the incumbent is highest (Thompson sampling over a normal
+ * posterior of each move's score, untried moves first), or re-measures the
+ * incumbent. A move is adopted once its mean score beats the incumbent's by
+ * acceptMargin with two standard errors to spare; the incumbent then takes
+ * that step and the neighbouring moves are learned afresh. A move whose very
+ * first trial falls below safetyFloor of the incumbent is not tried again
+ * until the incumbent changes, so a bad step costs one trial.
+ *
+ * Link classes are the caller's: any string, or classify() for one from the
+ * metrics. Adopted configurations are written to persistencePath and read
+ * back at construction, so a restart resumes from what was learned.
+ * Thread-safe.
+ */
+class StrategyTuner {
+public:
+    explicit StrategyTuner(const StrategyTunerConfig& config = StrategyTunerConfig(),
+                           std::vector<TunerParameter> parameters = defaultParameters());
+
+    /**
+     * @brief The knobs of StrategyConfig, FragmentConfig, FlowControlConfig,
+     *        RecordBatchingConfig and AdaptiveRecordConfig worth tuning, each
+     *        starting at its default
+     */
+    static std::vector<TunerParameter> defaultParameters();
+
+    /**
+     * @brief "lan", "wan", "lossy" or "satellite", from latency and error rate
+     */
+    static std::string classify(const DetailedMetrics& metrics);
+
+    /**
+     * @brief The configuration to run the next stretch of traffic under
+     */
+    TunerTrial propose(const std::string& linkClass);
+
+    /**
+     * @brief Records how a proposed trial went
+     *
+     * @param goodputBps Application bytes delivered per second
+     * @param p99LatencyMs 99th percentile message latency
+     */
+    void record(const TunerTrial& trial, double goodputBps, double p99LatencyMs);
+
+    /**
+     * @brief Records a trial from the metrics of the window it ran in
+     */
+    void record(const TunerTrial& trial, const DetailedMetrics& metrics);
+
+    /**
+     * @brief Best configuration known for the class, the defaults if none
+     */
+    TunedValues best(const std::string& linkClass) const;
+
+    /**
+     * @brief The incumbent, once it has been measured minTrials times, was
+     *        adopted or was restored from persistencePath; nullopt before
+     */
+    std::optional<TunedValues> learned(const std::string& linkClass) const;
+
+    TunerClassStats stats(const std::string& linkClass) const;
+
+    /**
+     * @brief Forgets what was learned for the class
+     */
+    void reset(const std::string& linkClass);
+
+    Result<void> save() const;
+    Result<void> load();
+
+private:
+    struct Arm {
+        uint64_t trials{0};
+        double mean{0.0};
+        double m2{0.0};         // Sum of squared deviations, for the variance
+        bool abandoned{false};
+    };
+
+    struct ClassState {
+        std::vector<size_t> position;   // Index into each parameter's values
+        Arm incumbent;
+        std::vector<Arm> moves;         // 2 * parameter + (direction > 0)
+        uint64_t epoch{0};
+        uint64_t trials{0};
+        uint64_t adoptions{0};
+        bool restored{false};           // Position read back by load()
+    };
+
+    ClassState& state(const std::string& linkClass);
+    TunedValues valuesAt(const std::vector<size_t>& position) const;
+    bool canMove(const ClassState& state, size_t move) const;
+    void adopt(ClassState& state, size_t move);
+    Result<void> saveLocked() const;
+    static void update(Arm& arm, double score);
+
+    StrategyTunerConfig config_;
+    std::vector<TunerParameter> parameters_;
+    mutable std::mutex mutex_;
+    std::map<std::string, ClassState> classes_;
+    std::mt19937_64 random_{std::random_device{}()};
+};
+
+/**
+ * @brief Sets the fields of each configuration that tuned has a value for
+ */
+void applyTuned(const TunedValues& tuned, StrategyConfig& config);
+void applyTuned(const TunedValues& tuned, core::TransmissionManager::FragmentConfig& fragment,
+                core::TransmissionManager::FlowControlConfig& flow);
+void applyTuned(const TunedValues& tuned, core::RecordBatchingConfig& batching,
+                core::AdaptiveRecordConfig& records);
+
+} // namespace xenocomm
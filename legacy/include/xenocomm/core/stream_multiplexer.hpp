@@ -0,0 +1,270 @@
+#ifndef XENOCOMM_CORE_STREAM_MULTIPLEXER_HPP
+#define XENOCOMM_CORE_STREAM_MULTIPLEXER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace core {
+
+class MultiplexedStream;
+
+/**
+ * @brief Tuning for a StreamMultiplexer
+ */
+struct MultiplexerConfig {
+    uint32_t initialStreamWindow = 256 * 1024;  ///< Bytes a stream may have delivered but unread at the receiver
+    size_t chunkSize = 16 * 1024;               ///< Largest DATA frame; streams take turns one chunk at a time
+    size_t maxMessageSize = 16 * 1024 * 1024;   ///< Larger incoming messages reset their stream
+    size_t maxStreams = 4096;                   ///< Open streams, counting both sides; further opens are refused
+    size_t acceptBacklog = 128;                 ///< Peer-opened streams waiting for acceptStream()
+    uint32_t pollIntervalMs = 100;              ///< How often the reader checks for shutdown while the link is idle
+};
+
+/**
+ * @brief Carries many independent streams over one reliable connection
+ *
+ * Every message sent on a stream is cut into DATA frames of at most chunkSize
+ * bytes, each tagged with the stream ID, and a single writer sends one chunk
+ * per ready stream in turn. A large transfer on one stream therefore never
+ * holds up small messages on the others. Each stream has its own flow-control
+ * window: a sender only sends what the receiver has granted, and the receiver
+ * grants more as the application reads, so one slow reader cannot stall the
+ * connection for everyone else.
+ *
+ * Frames are a 10-byte header (type, flags, stream ID and payload length, in
+ * network byte order) and the payload. Streams opened by the Initiator have odd
+ * IDs and those opened by the Acceptor even ones; a stream comes into being on
+ * the peer with its first DATA frame.
+ *
+ * The transport must be connected and reliable (TCPTransport, or a
+ * SecureTransportWrapper around one). The multiplexer takes over reading from
+ * it and sets its receive timeout, so nothing else may use it directly until
+ * shutdown().
+ */
+class StreamMultiplexer : public std::enable_shared_from_this<StreamMultiplexer> {
+public:
+    enum class Role {
+        Initiator,  ///< Opens odd-numbered streams
+        Acceptor    ///< Opens even-numbered streams
+    };
+
+    /**
+     * @brief Create a multiplexer and start its reader and writer threads
+     * @throws std::invalid_argument if transport is null or not connected
+     */
+    static std::shared_ptr<StreamMultiplexer> create(std::shared_ptr<TransportProtocol> transport, Role role,
+                                                     const MultiplexerConfig& config = MultiplexerConfig{});
+
+    ~StreamMultiplexer();
+
+    StreamMultiplexer(const StreamMultiplexer&) = delete;
+    StreamMultiplexer& operator=(const StreamMultiplexer&) = delete;
+
+    /**
+     * @brief Open a new stream to the peer
+     * @return The stream, or nullptr if the multiplexer is down or at maxStreams
+     */
+    std::shared_ptr<MultiplexedStream> openStream();
+
+    /**
+     * @brief Wait for the peer to open a stream
+     * @return The stream, or nullptr on timeout or once the multiplexer is down
+     */
+    std::shared_ptr<MultiplexedStream> acceptStream(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Stop both threads and close every stream; the transport stays connected
+     */
+    void shutdown();
+
+    /**
+     * @brief False once shut down or after the connection failed
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Why the connection failed, if it did
+     */
+    std::string getErrorDetails() const;
+
+    size_t streamCount() const;
+    const MultiplexerConfig& getConfig() const { return config_; }
+    const std::shared_ptr<TransportProtocol>& getTransport() const { return transport_; }
+
+private:
+    friend class MultiplexedStream;
+
+    enum class FrameType : uint8_t {
+        DATA = 0,           ///< A chunk of a message
+        WINDOW_UPDATE = 1,  ///< Payload is a 4-byte credit increment
+        RESET = 2           ///< The sender closed the stream
+    };
+    static constexpr uint8_t FLAG_END_MESSAGE = 0x01;  // DATA: last chunk of a message
+    static constexpr size_t FRAME_HEADER_SIZE = 10;
+
+    // A message waiting to be sent; lives on the sending thread's stack until done
+    struct Outbound {
+        std::vector<utils::ByteSpan> parts;
+        size_t total = 0;
+        size_t offset = 0;  // Bytes already sent
+        bool done = false;
+        bool failed = false;
+    };
+
+    StreamMultiplexer(std::shared_ptr<TransportProtocol> transport, Role role, const MultiplexerConfig& config);
+    void start();
+
+    // All of these require mutex_
+    MultiplexedStream* makeStream(uint32_t id, std::shared_ptr<MultiplexedStream>& owner);
+    void schedule(MultiplexedStream& stream);
+    void queueControl(FrameType type, uint32_t streamId, uint32_t value);
+    void closeStream(MultiplexedStream& stream, bool notifyPeer);
+    void failStreamSends(MultiplexedStream& stream);
+    void fail(const std::string& reason);
+    void consumed(MultiplexedStream& stream, size_t bytes);
+
+    // Called by MultiplexedStream
+    ssize_t sendMessage(MultiplexedStream& stream, const utils::ByteSpan* parts, size_t count);
+    ssize_t receiveMessage(MultiplexedStream& stream, utils::PooledBuffer& message, size_t maxSize);
+    void release(MultiplexedStream& stream);
+
+    void writerLoop();
+    void readerLoop();
+    void dispatch(FrameType type, uint8_t flags, uint32_t streamId, const utils::PooledBuffer& block, size_t offset,
+                  size_t length);
+    void deliver(MultiplexedStream& stream, uint8_t flags, const utils::PooledBuffer& block, size_t offset,
+                 size_t length);
+
+    std::shared_ptr<TransportProtocol> transport_;
+    const Role role_;
+    const MultiplexerConfig config_;
+
+    mutable std::mutex mutex_;  // Guards everything below and all stream state
+    std::condition_variable writerCv_;
+    std::condition_variable acceptCv_;
+    bool stopping_ = false;
+    bool failed_ = false;
+    std::string error_;
+    uint32_t nextStreamId_;
+    uint32_t lastPeerStreamId_ = 0;
+    // Streams unregister themselves under mutex_ before they are destroyed, so
+    // these never dangle while the lock is held
+    std::unordered_map<uint32_t, MultiplexedStream*> streams_;
+    std::deque<MultiplexedStream*> ready_;                      // Streams with a chunk to send, in turn order
+    std::deque<std::shared_ptr<MultiplexedStream>> accepting_;  // Opened by the peer, not yet accepted
+    std::vector<uint8_t> control_;                              // Encoded control frames, sent ahead of data
+
+    std::thread writer_;
+    std::thread reader_;
+};
+
+/**
+ * @brief One stream of a StreamMultiplexer, usable wherever a transport is
+ *
+ * Streams keep message boundaries: each send(), sendv() or sendFrame() is one
+ * message, and receiveFrame() or receiveBuffer() returns one whole message
+ * (receive() copies out the next bytes of the current one). isReliableStream()
+ * is true, so a TransmissionManager bound to a stream sends whole messages.
+ * Sends block until the message has been handed to the connection, waiting
+ * for flow-control credit if the peer is slow to read, up to the send timeout
+ * if one is set. Dropping the last reference closes the stream, as disconnect()
+ * does. A stream does not keep its multiplexer alive; once that is gone, the
+ * stream reports NOT_CONNECTED.
+ */
+class MultiplexedStream : public TransportProtocol {
+public:
+    ~MultiplexedStream() override;
+
+    uint32_t getStreamId() const { return id_; }
+
+    bool connect(const std::string& endpoint, const ConnectionConfig& config) override;
+    bool disconnect() override;
+    bool isConnected() const override;
+
+    ssize_t send(const uint8_t* data, size_t size) override;
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
+    bool isReliableStream() const override { return true; }
+    ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) override;
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override;
+    ssize_t receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) override;
+    ssize_t receive(uint8_t* buffer, size_t size) override;
+
+    bool getPeerAddress(std::string& address, uint16_t& port) override;
+    int getSocketFd() const override { return -1; }
+    bool setNonBlocking(bool nonBlocking) override;
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setSendTimeout(const std::chrono::milliseconds& timeout) override;
+    bool setKeepAlive(bool) override { return true; }
+    bool setTcpNoDelay(bool) override { return true; }
+    bool setReuseAddress(bool) override { return true; }
+    bool setReceiveBufferSize(size_t) override { return true; }
+    bool setSendBufferSize(size_t) override { return true; }
+    std::string getLastError() const override;
+    bool setLocalPort(uint16_t) override { return false; }
+    ConnectionState getState() const override;
+    TransportError getLastErrorCode() const override;
+    std::string getErrorDetails() const override;
+    bool reconnect(uint32_t, uint32_t) override { return false; }
+    void setStateCallback(std::function<void(ConnectionState)> callback) override;
+    void setErrorCallback(std::function<void(TransportError, const std::string&)> callback) override;
+    bool checkHealth() override { return isConnected(); }
+
+private:
+    friend class StreamMultiplexer;
+
+    MultiplexedStream(std::weak_ptr<StreamMultiplexer> mux, uint32_t id, uint32_t window);
+    std::shared_ptr<StreamMultiplexer> multiplexer() const;  // Sets NOT_CONNECTED if it is gone
+    void setError(TransportError code, const std::string& details) const;
+
+    const std::weak_ptr<StreamMultiplexer> mux_;
+    const uint32_t id_;
+
+    // Guarded by the multiplexer's mutex_
+    bool localClosed_ = false;
+    bool remoteClosed_ = false;
+    bool scheduled_ = false;   // In the writer's ready queue
+    bool inFlight_ = false;    // The writer is sending a chunk of outbound_.front()
+    uint32_t sendCredit_;      // Bytes the peer has granted
+    uint32_t receiveWindow_;   // Bytes the peer may still send
+    uint32_t unacknowledged_ = 0;  // Bytes read but not yet granted back
+    std::deque<StreamMultiplexer::Outbound*> outbound_;
+    struct Inbound {
+        utils::PooledBuffer data;
+        uint32_t windowBytes;  // Credit returned once this message is read
+    };
+    std::deque<Inbound> inbound_;
+    utils::PooledBuffer assembling_;  // Chunks of a message still arriving
+    size_t assembled_ = 0;
+    utils::PooledBuffer partial_;     // Rest of a message receive() has started on
+    size_t partialOffset_ = 0;
+    std::condition_variable cv_;
+
+    std::atomic<bool> nonBlocking_{false};
+    std::atomic<int64_t> receiveTimeoutMs_{0};  // 0 waits indefinitely
+    std::atomic<int64_t> sendTimeoutMs_{0};
+
+    mutable std::mutex errorMutex_;
+    mutable TransportError lastError_ = TransportError::NONE;
+    mutable std::string errorDetails_;
+    std::function<void(ConnectionState)> stateCallback_;
+    std::function<void(TransportError, const std::string&)> errorCallback_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_STREAM_MULTIPLEXER_HPP
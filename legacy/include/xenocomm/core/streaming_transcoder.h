@@ -0,0 +1,131 @@
+#pragma once
+
+#include "xenocomm/core/data_transcoder.h"
+#include "xenocomm/utils/byte_span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Header at the start of every encoded stream chunk
+ */
+struct StreamChunkHeader {
+    uint32_t sequence;  ///< Position of the chunk in the stream, from 0
+    uint8_t flags;      ///< STREAM_LAST on the final chunk
+    uint8_t format;     ///< DataFormat the payload is encoded in, passed to decode()
+    uint16_t magic;     ///< STREAM_MAGIC, so stray messages are rejected
+};
+
+static constexpr uint8_t STREAM_LAST = 0x01;
+static constexpr uint16_t STREAM_MAGIC = 0x5853;  // "XS"
+
+/**
+ * @brief Encodes a payload chunk by chunk instead of all at once
+ *
+ * Input is pushed in pieces of any size; every chunk_size bytes of it are
+ * encoded as an independent chunk that pull() hands out straight away, so a
+ * chunk can be on the wire while the next one is still being encoded and the
+ * encoded payload is never held whole. finish() encodes the remainder as the
+ * last chunk. For vector formats chunk_size should be a multiple of the
+ * element size, and of the quantization block size for per-block formats,
+ * so the chunks encode exactly as the whole payload would.
+ *
+ * Not thread-safe; the transcoder must outlive the encoder.
+ */
+class StreamingEncoder {
+public:
+    /**
+     * @param input_format Format of the pushed data, as passed to encode()
+     * @param encoded_format Format the transcoder produces, recorded for the decoder
+     * @throws TranscodingError if chunk_size is 0
+     */
+    StreamingEncoder(DataTranscoder& transcoder, DataFormat input_format, DataFormat encoded_format,
+                     size_t chunk_size);
+
+    /**
+     * @brief Appends input; whole chunks are encoded immediately
+     *
+     * @throws TranscodingError if called after finish() or encoding fails
+     */
+    void push(utils::ByteSpan data);
+
+    /**
+     * @brief Encodes buffered input as the last chunk, which may be empty
+     */
+    void finish();
+
+    /**
+     * @brief Moves the next encoded chunk into chunk
+     *
+     * @return false if no chunk is ready
+     */
+    bool pull(std::vector<uint8_t>& chunk);
+
+    /**
+     * @brief True once finish() has been called and every chunk pulled
+     */
+    bool finished() const { return finished_ && ready_.empty(); }
+
+    size_t chunkSize() const { return chunk_size_; }
+
+private:
+    void encodeChunk(utils::ByteSpan data, bool last);
+
+    DataTranscoder& transcoder_;
+    DataFormat input_format_;
+    DataFormat encoded_format_;
+    size_t chunk_size_;
+    uint32_t next_sequence_ = 0;
+    bool finished_ = false;
+    std::vector<uint8_t> pending_;             // Input short of a whole chunk
+    std::deque<std::vector<uint8_t>> ready_;   // Encoded chunks not yet pulled
+};
+
+/**
+ * @brief Decodes the chunks a StreamingEncoder produced as they arrive
+ *
+ * Chunks may be pushed in any order; pull() returns decoded data in stream
+ * order, so each chunk is decoded as soon as it and its predecessors are in.
+ *
+ * Not thread-safe; the transcoder must outlive the decoder.
+ */
+class StreamingDecoder {
+public:
+    explicit StreamingDecoder(DataTranscoder& transcoder);
+
+    /**
+     * @brief Accepts one encoded chunk, including its header
+     *
+     * @throws TranscodingError if the chunk is malformed, repeated, beyond
+     *         the last chunk, or fails to decode
+     */
+    void push(utils::ByteSpan chunk);
+
+    /**
+     * @brief Moves the next chunk's decoded data, in stream order, into data
+     *
+     * @return false if the next chunk has not arrived yet
+     */
+    bool pull(std::vector<uint8_t>& data);
+
+    /**
+     * @brief True once the last chunk and every chunk before it have been pulled
+     */
+    bool finished() const { return last_sequence_ >= 0 && next_sequence_ > last_sequence_; }
+
+private:
+    std::vector<uint8_t> decodeChunk(DataFormat format, utils::ByteSpan payload);
+
+    DataTranscoder& transcoder_;
+    int64_t next_sequence_ = 0;                          // Next chunk pull() returns
+    int64_t last_sequence_ = -1;                         // Sequence of the STREAM_LAST chunk once seen
+    std::map<uint32_t, std::vector<uint8_t>> decoded_;   // Decoded chunks waiting for their turn
+};
+
+} // namespace core
+} // namespace xenocomm
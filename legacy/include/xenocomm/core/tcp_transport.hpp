@@ -2,8 +2,18 @@
 #define XENOCOMM_CORE_TCP_TRANSPORT_HPP
 
 #include "xenocomm/core/transport_protocol.hpp"
-#include "xenocomm/core/async_worker_pool.hpp"
+#include "xenocomm/core/io_uring_engine.hpp"
+#include "xenocomm/core/link_health.hpp"
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include "xenocomm/utils/awaitable.hpp"
+#include "xenocomm/utils/cancellation.hpp"
+#include "xenocomm/utils/config_snapshot.hpp"
+#include "xenocomm/utils/contention_profile.hpp"
+#include "xenocomm/utils/frame_codec.hpp"
+#include "xenocomm/utils/metrics_registry.hpp"
+#include "xenocomm/utils/work_stealing_executor.hpp"
 #include <string>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <utility>
@@ -87,6 +97,7 @@ public:
         bool inUse = false;
         TransportError lastError = TransportError::NONE;
         std::string lastErrorDetails;
+        uint32_t poolSlot = UINT32_MAX;  ///< Slot in the owning pool shard, UINT32_MAX if unpooled
     };
 
     /**
@@ -123,6 +134,16 @@ public:
         bool enableBatching = false;        ///< Enable batching of async operations
         size_t batchSize = 10;              ///< Maximum operations per batch
         uint32_t priorityLevels = 3;        ///< Number of priority levels (1-10)
+        size_t batchMaxBytes = 16384;       ///< Stop adding queued sends to a writev batch past this size
+        uint32_t starvationLimit = 16;      ///< Higher-priority sends served before a waiting lower one gets a turn
+    };
+
+    /**
+     * @brief Length-prefix framing used by sendFrame()/receiveFrame()
+     */
+    struct FramingConfig {
+        utils::FrameLengthEncoding encoding = utils::FrameLengthEncoding::VARINT;
+        size_t maxFrameSize = 16 * 1024 * 1024;  ///< Larger incoming frames fail the stream with MESSAGE_TOO_LARGE
     };
 
     /**
@@ -136,17 +157,25 @@ public:
 
     /**
      * @brief Result of an async operation that can be cancelled
+     *
+     * cancel() aborts the operation where it is: still queued, waiting on the
+     * socket, or in flight in io_uring. The result then reports failure
+     * (false, or 0 bytes) as soon as the operation has let go of its buffer.
      */
     template<typename T>
     class CancellableAsyncResult {
     public:
-        bool cancel() { return promise_.valid() ? promise_.cancel() : false; }
-        bool isCancelled() const { return cancelled_; }
-        T get() { return promise_.get(); }
-        bool isReady() const { return promise_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        CancellableAsyncResult(std::future<T> result, utils::CancellationToken token)
+            : result_(std::move(result)), token_(std::move(token)) {}
+
+        void cancel() { token_.cancel(); }
+        bool isCancelled() const { return token_.isCancelled(); }
+        T get() { return result_.get(); }
+        bool isReady() const { return result_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        const utils::CancellationToken& token() const { return token_; }
     private:
-        std::future<T> promise_;
-        std::atomic<bool> cancelled_{false};
+        std::future<T> result_;
+        utils::CancellationToken token_;
     };
 
     /**
@@ -177,7 +206,43 @@ public:
     bool disconnect() override;
     bool isConnected() const override;
     ssize_t send(const uint8_t* data, size_t size) override;
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
     ssize_t receive(uint8_t* buffer, size_t size) override;
+    bool isReliableStream() const override { return true; }
+
+    /**
+     * Framed messages: each frame is a length prefix followed by the payload,
+     * so the peer's receiveFrame() returns exactly what was sent. Frames and
+     * raw send()/receive() must not be mixed on one connection, and a frame
+     * is always written whole, blocking for socket space if necessary even
+     * in non-blocking mode.
+     */
+    ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) override;
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override;
+
+    /**
+     * @brief Send several frames, coalesced into as few writes as the kernel allows
+     *
+     * @return Total payload bytes sent, or -1 on error
+     */
+    ssize_t sendFrames(const utils::ByteSpan* frames, size_t count) override;
+
+    /**
+     * @brief Send header and a file region as one frame, the file via sendfile(2)
+     *
+     * The file's pages go from the page cache to the socket without passing
+     * through user space. Files sendfile() cannot read are mapped and written
+     * instead. The frame limit applies to header and file together.
+     *
+     * @return Payload bytes sent, or -1 on error
+     */
+    ssize_t sendFileFrame(utils::ByteSpan header, int fd, int64_t offset, size_t size) override;
+
+    /**
+     * @brief Select the framing format; both peers must agree. Discards any partial inbound frame.
+     */
+    void setFramingConfig(const FramingConfig& config);
+
     bool getPeerAddress(std::string& address, uint16_t& port) override;
     int getSocketFd() const override;
     bool setNonBlocking(bool nonBlocking) override;
@@ -188,6 +253,7 @@ public:
     bool setReuseAddress(bool enable) override;
     bool setReceiveBufferSize(size_t size) override;
     bool setSendBufferSize(size_t size) override;
+    bool setPacingRate(uint64_t bytesPerSecond) override;
     std::string getLastError() const override;
     bool setLocalPort(uint16_t port) override;
     xenocomm::core::ConnectionState getState() const override;
@@ -196,9 +262,23 @@ public:
     bool reconnect(uint32_t maxAttempts = 3, uint32_t delayMs = 1000) override;
     void setStateCallback(std::function<void(xenocomm::core::ConnectionState)> callback) override;
     void setErrorCallback(std::function<void(xenocomm::core::TransportError, const std::string&)> callback) override;
+    /**
+     * @brief Healthy unless the connection's own traffic says otherwise; probes only a quiet connection
+     */
     bool checkHealth() override;
 
+    /**
+     * @brief What the connection's traffic has shown of its health
+     */
+    const LinkHealth& linkHealth() const { return linkHealth_; }
+
     // TCP-specific methods
+    //
+    // The pool keeps one shard per endpoint with up to maxConnections slots.
+    // Idle connections sit on a lock-free free list, so acquire and release
+    // never take a lock; only the first use of an endpoint does, to create
+    // its shard. Each shard reaps its own idle connections on a reactor
+    // timer, keeping at least initialConnections open.
     std::shared_ptr<ConnectionInfo> acquireConnection(const std::string& endpoint);
     void releaseConnection(std::shared_ptr<ConnectionInfo> connection);
     std::string getPoolStats() const;
@@ -206,17 +286,103 @@ public:
     bool warmupConnections(const std::string& endpoint, size_t numConnections);
     std::map<std::string, bool> checkPoolHealth() const;
 
+    /**
+     * @brief Reports getDetailedPoolStats() through registry whenever it is exported
+     *
+     * Series are labelled instance=<instance>; registering again replaces the
+     * previous registration.
+     */
+    void registerMetrics(utils::MetricsRegistry& registry, const std::string& instance);
+
+    /**
+     * @brief Completion for queueSend(); runs on an async worker once the send finished.
+     */
+    using SendCompletion = void (*)(void* context, bool success);
+
+    /**
+     * @brief Called for each received segment; data is nullptr once the stream ends.
+     */
+    using ReceiveHandler = std::function<void(const uint8_t* data, size_t size)>;
+
     // Async operations
+    //
+    // On Linux with io_uring, sends and receives are submitted to the shared
+    // IoUringEngine and complete on its completion thread without a worker
+    // hop. Elsewhere they run as blocking calls on the shared WorkStealingExecutor.
+    // Buffers must stay valid until the returned future is ready. Each
+    // operation carries the caller's CancellationToken::current() with it and
+    // gives up when that is cancelled or its deadline passes.
     std::future<bool> connectAsync(const std::string& endpoint, uint32_t socketTimeoutMs = 5000);
     std::future<bool> sendAsync(const uint8_t* data, size_t size);
     std::future<bool> sendAsync(const std::shared_ptr<ConnectionInfo>& connection, 
                                const uint8_t* data, size_t size);
+
+    /**
+     * @brief Receives up to size bytes; the future yields 0 on error or peer close.
+     */
     std::future<size_t> receiveAsync(uint8_t* buffer, size_t size);
     std::future<size_t> receiveAsync(const std::shared_ptr<ConnectionInfo>& connection,
                                     uint8_t* buffer, size_t size);
 
+    /**
+     * @brief sendAsync()/receiveAsync() under a child of the current token, returned for cancelling.
+     *
+     * @param timeout Deadline for the operation; zero for none beyond the current token's
+     */
+    CancellableAsyncResult<bool> sendAsyncCancellable(const uint8_t* data, size_t size,
+                                                      std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+    CancellableAsyncResult<size_t> receiveAsyncCancellable(uint8_t* buffer, size_t size,
+                                                           std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
     void setAsyncConfig(const AsyncConfig& config);
 
+    /**
+     * @brief Queues a send on the connected socket behind any of higher priority.
+     *
+     * Producers never lock or allocate: the send is a fixed-size descriptor in
+     * a bounded per-priority lock-free ring, drained by one async worker at a
+     * time. Priority is strict, except that a lower level waiting behind
+     * starvationLimit higher-priority sends is served next. With batching
+     * enabled, adjacent queued sends of the same priority go out in one
+     * writev. data must stay valid until complete runs.
+     *
+     * @return false if the queue for priority is full or too many operations are pending
+     */
+    bool queueSend(const uint8_t* data, size_t size, AsyncPriority priority,
+                   SendCompletion complete, void* context);
+
+    /**
+     * @brief Future-returning form of queueSend()
+     */
+    std::future<bool> sendAsync(const uint8_t* data, size_t size, AsyncPriority priority);
+
+    // Awaitable forms of the async operations above
+    //
+    // Same rules for buffers and results, but nothing blocks to collect the
+    // outcome: the continuation, or the coroutine co_awaiting it, is resumed
+    // on the shared EventReactor, so one loop thread can carry many
+    // conversations written as straight-line code.
+    utils::Awaitable<bool> connectAwaitable(const std::string& endpoint, uint32_t socketTimeoutMs = 5000);
+    utils::Awaitable<bool> sendAwaitable(const uint8_t* data, size_t size);
+    utils::Awaitable<bool> sendAwaitable(const uint8_t* data, size_t size, AsyncPriority priority);
+    utils::Awaitable<size_t> receiveAwaitable(uint8_t* buffer, size_t size);
+
+    /**
+     * @brief Delivers every received segment to handler until stopped or closed.
+     *
+     * Uses multishot recv into kernel-provided buffers where available, so
+     * the connection costs one submission rather than one per segment;
+     * otherwise the socket is switched to non-blocking mode and driven by
+     * the shared EventReactor. The data pointer is only valid during the
+     * call, and synchronous receive() must not be mixed in.
+     */
+    bool startReceiveStream(ReceiveHandler handler);
+
+    /**
+     * @brief Stops the receive stream; the handler is not running once this returns.
+     */
+    void stopReceiveStream();
+
 private:
     /**
      * @brief Parse endpoint string into host and port
@@ -233,25 +399,42 @@ private:
      */
     bool setSocketOptions(uint32_t socketTimeoutMs);
 
+
     /**
-     * @brief Bind socket to local port if specified
+     * @brief Validate an existing connection
      */
-    bool bindSocket();
+    bool validateConnection(const std::shared_ptr<ConnectionInfo>& connection);
 
     /**
-     * @brief Create a new connection to the specified endpoint
+     * @brief Clean up idle connections in every shard
      */
-    std::shared_ptr<ConnectionInfo> createConnection(const std::string& endpoint);
+    void cleanupIdleConnections();
 
     /**
-     * @brief Validate an existing connection
+     * @brief Per-endpoint slice of the connection pool, defined in the implementation
      */
-    bool validateConnection(const std::shared_ptr<ConnectionInfo>& connection);
+    struct PoolShard;
+    static constexpr size_t POOL_SHARD_BUCKETS = 256;
 
     /**
-     * @brief Clean up idle connections
+     * @brief Lock-free lookup of an endpoint's shard; nullptr if it has none yet
      */
-    void cleanupIdleConnections();
+    PoolShard* findShard(const std::string& endpoint) const;
+
+    /**
+     * @brief Look up or create the shard for endpoint; nullptr if the shard table is full
+     */
+    PoolShard* findOrCreateShard(const std::string& endpoint);
+
+    /**
+     * @brief Close and delete every shard; pooled connections still borrowed lose their sockets
+     */
+    void destroyPool();
+
+    /**
+     * @brief Open a new connection to shard's endpoint, recording the outcome in its statistics
+     */
+    std::shared_ptr<ConnectionInfo> createConnection(PoolShard& shard);
 
     /**
      * @brief Set error state with code and message
@@ -275,17 +458,22 @@ private:
     void updateState(xenocomm::core::ConnectionState newState);
 
     /**
-     * @brief Perform health check on current connection
+     * @brief Probe the socket itself, for when its traffic says nothing
      */
     bool performHealthCheck();
 
     /**
-     * @brief Start health monitoring thread
+     * @brief What the connection's traffic must show for it to count as healthy
+     */
+    LinkHealthPolicy healthPolicy() const;
+
+    /**
+     * @brief Register with the shared heartbeat scheduler, which probes only once the connection goes quiet
      */
     void startHealthMonitoring();
 
     /**
-     * @brief Stop health monitoring thread
+     * @brief Stop periodic health checks
      */
     void stopHealthMonitoring();
 
@@ -295,14 +483,94 @@ private:
     bool validateAndRepairConnection(std::shared_ptr<ConnectionInfo> connection);
 
     /**
-     * @brief Process priority queues for async operations
+     * @brief Write every frame in buffers (prefixes and payloads interleaved) to the socket
+     */
+    bool writeFrames(std::vector<utils::ByteSpan>& buffers, size_t totalBytes);
+    bool writeFramesLocked(std::vector<utils::ByteSpan>& buffers, size_t totalBytes);  // Requires frameSendMutex_
+
+    /**
+     * @brief Fixed-size descriptor for a send waiting in a priority queue
+     */
+    struct QueuedSend {
+        const uint8_t* data;
+        size_t size;
+        SendCompletion complete;
+        void* context;
+    };
+
+    static constexpr size_t PRIORITY_LEVELS = 3;
+    static constexpr size_t PRIORITY_QUEUE_CAPACITY = 1024;
+
+    /**
+     * @brief One ring per priority level, defined in the implementation
+     */
+    struct PriorityQueues;
+
+    /**
+     * @brief The rings, built by whichever queueSend() comes first
+     */
+    PriorityQueues& priorityQueues();
+
+    /**
+     * @brief Send one batch of queued operations
+     *
+     * Must only run on the single drainer scheduled by queueSend().
+     *
+     * @return Number of queued sends completed
+     */
+    size_t processPriorityQueues();
+
+    /**
+     * @brief Drain loop run on an async worker while sends are queued
+     */
+    void drainPriorityQueues();
+
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+#else
+    using NativeSocket = int;
+#endif
+
+    /**
+     * @brief Shared implementation of the sendAsync/receiveAsync overloads; done runs exactly once
+     */
+    void sendAsyncOn(NativeSocket socket, const uint8_t* data, size_t size, std::function<void(bool)> done);
+    void receiveAsyncOn(NativeSocket socket, uint8_t* buffer, size_t size, std::function<void(size_t)> done);
+
+    /**
+     * @brief A resolver whose consumer resumes on the shared EventReactor
      */
-    void processPriorityQueues();
+    template <typename T>
+    static utils::AwaitableResolver<T> reactorResolver() {
+        return utils::AwaitableResolver<T>([](std::function<void()> resume) {
+            EventReactor::shared().post(std::move(resume));
+        });
+    }
 
     /**
-     * @brief Update response time statistics
+     * @brief Admit an async operation against maxPendingOperations
      */
-    void updateResponseStats(const std::string& endpoint, std::chrono::milliseconds responseTime);
+    bool beginAsyncOperation(const std::string& operation);
+
+    /**
+     * @brief Record the outcome of an async operation; result is bytes or a negative errno
+     */
+    void finishAsyncOperation(int result, const std::string& operation);
+
+    /**
+     * @brief Set the error state for a failed async result without touching the pending count
+     */
+    void reportAsyncResult(int result, const std::string& operation);
+
+    /**
+     * @brief Wait for in-flight async operations before the transport goes away
+     */
+    void drainAsyncOperations();
+
+    /**
+     * @brief Fold a connect time into the shard's moving average
+     */
+    void updateResponseStats(PoolShard& shard, std::chrono::microseconds responseTime);
 
     /**
      * @brief Close the socket
@@ -332,28 +600,37 @@ private:
     std::function<void(xenocomm::core::ConnectionState)> stateCallback_;
     std::function<void(xenocomm::core::TransportError, const std::string&)> errorCallback_;
     mutable std::mutex callbackMutex_;
-    std::unique_ptr<std::thread> healthMonitorThread_;
-    std::atomic<bool> stopHealthMonitor_{false};
+    mutable std::mutex errorMutex_; ///< Guards lastError_ and lastErrorDetails_
+    HeartbeatScheduler::Registration heartbeat_{0}; ///< Health checks on the shared heartbeat scheduler
+    mutable LinkHealth linkHealth_;                  ///< Fed by every send, receive and link error; mutable for setError
+    std::atomic<bool> nonBlocking_{false};
+    std::atomic<int64_t> receiveTimeout_{0}; ///< Last setReceiveTimeout() in ms, 0 for none
     std::chrono::steady_clock::time_point lastHealthCheck_;
-    ConnectionConfig config_;
+    utils::ConfigSnapshot<ConnectionConfig> config_;  ///< Republished by connect(); read without locking
 
     // Connection pool members
     PoolConfig poolConfig_;
-    std::map<std::string, std::vector<std::shared_ptr<ConnectionInfo>>> connectionPool_;
-    std::queue<std::shared_ptr<ConnectionInfo>> availableConnections_;
-    mutable std::mutex poolMutex_;
-    std::atomic<size_t> activeConnections_{0};
-    std::atomic<size_t> totalConnectionsCreated_{0};
-    std::atomic<size_t> failedConnectionAttempts_{0};
-    std::chrono::steady_clock::time_point lastCleanup_;
+    std::unique_ptr<std::atomic<PoolShard*>[]> poolShards_; ///< Open-addressed by endpoint hash; entries are never removed
+    utils::ProfiledMutex<> poolMutex_{"tcp.pool"};          ///< Only serializes shard creation
 
     // Async operation members
-    AsyncWorkerPool asyncWorkerPool_;
+    // Framing members
+    FramingConfig framingConfig_;
+    utils::FrameDecoder frameDecoder_;  ///< Guarded by frameReceiveMutex_
+    std::mutex frameSendMutex_;         ///< Keeps concurrent senders' frames from interleaving
+    std::mutex frameReceiveMutex_;
+
+    utils::WorkStealingExecutor* executor_{&utils::WorkStealingExecutor::shared()}; ///< Runs async operations; shared by every transport
     AsyncConfig asyncConfig_;
-    std::map<AsyncPriority, std::queue<std::function<void()>>> priorityQueues_;
+    std::atomic<PriorityQueues*> priorityQueues_{nullptr};  ///< ~120 KB of rings, so only transports that queue pay for them
+    std::atomic<size_t> queuedSends_{0};  ///< Queued but not yet completed; the 0 -> 1 transition schedules a drain
+    uint32_t starvationStreak_{0};        ///< Drainer-owned count of picks that bypassed a waiting lower level
     std::atomic<size_t> pendingAsyncOperations_{0};
-    std::map<std::string, std::chrono::milliseconds> avgResponseTimes_;
     mutable std::mutex asyncMutex_;
+    IoUringEngine* ioEngine_{IoUringEngine::shared()}; ///< nullptr when io_uring is unavailable
+    std::atomic<IoUringEngine::StreamId> receiveStream_{0};
+    std::atomic<bool> reactorStream_{false};
+    utils::MetricsRegistration metricsRegistration_;  ///< Removed first thing in the destructor
 };
 
 } // namespace core
@@ -1,9 +1,9 @@
 #pragma once
 
 #include "xenocomm/core/negotiation_protocol.h"
+#include "xenocomm/utils/timer_service.hpp"
 #include <chrono>
 #include <atomic>
-#include <thread>
 #include <unordered_map>
 #include <mutex>
 
@@ -28,6 +28,10 @@ struct TimeoutConfig {
  * - Automatic retry logic with exponential backoff
  * - Session cleanup for timed-out negotiations
  * - Thread-safe session state management
+ *
+ * Each session holds one timer on a utils::TimerService, kept at the
+ * session's next timeout and moved on every activity, so expired sessions
+ * are removed when they expire without a thread sweeping the whole table.
  */
 class TimeoutNegotiationProtocol : public NegotiationProtocol {
 public:
@@ -36,12 +40,15 @@ public:
      * 
      * @param config Timeout and retry configuration
      * @param enableLogging Whether to enable logging (default: true)
+     * @param timers Timer service for session expiry; TimerService::shared() if null.
+     *               Must outlive this protocol.
      */
     explicit TimeoutNegotiationProtocol(const TimeoutConfig& config = TimeoutConfig(),
-                                      bool enableLogging = true);
+                                      bool enableLogging = true,
+                                      utils::TimerService* timers = nullptr);
 
     /**
-     * @brief Destructor that ensures cleanup of background threads and resources.
+     * @brief Destructor that cancels the session timers and releases resources.
      */
     ~TimeoutNegotiationProtocol() noexcept override;
 
@@ -59,11 +66,16 @@ public:
 
     std::optional<NegotiableParams> getNegotiatedParams(const SessionId sessionId) const override;
 
+    std::optional<NegotiableParams> getCounterProposal(const SessionId sessionId) const override;
+
     bool acceptCounterProposal(const SessionId sessionId) override;
 
     bool rejectCounterProposal(const SessionId sessionId,
                               const std::optional<std::string>& reason) override;
 
+    bool renegotiateSession(const SessionId sessionId,
+                            const NegotiableParams& updatedParams) override;
+
     bool closeSession(const SessionId sessionId) override;
 
 protected:
@@ -78,11 +90,15 @@ protected:
         NegotiableParams proposedParams;
         std::optional<NegotiableParams> agreedParams;
         std::atomic<bool> isActive{true};
+        utils::TimerService::TimerId expiryTimer{utils::TimerService::INVALID_TIMER};
     };
 
     /**
      * @brief Attempts an operation with retry logic.
      * 
+     * Stops retrying, and cuts the backoff short, once the thread's
+     * CancellationToken::current() is cancelled or its deadline passes.
+     * 
      * @param sessionId The session ID for the operation
      * @param operation The operation to attempt
      * @return True if the operation succeeded within retry limits, false otherwise
@@ -99,16 +115,26 @@ protected:
     bool hasSessionTimedOut(const SessionId sessionId) const;
 
     /**
-     * @brief Updates the last activity time for a session.
+     * @brief Updates the last activity time for a session and moves its expiry timer.
      * 
      * @param sessionId The session to update
      */
     void updateActivityTime(const SessionId sessionId);
 
     /**
-     * @brief Background thread function for cleaning up timed-out sessions.
+     * @brief Timer callback: removes the session if it timed out or was closed.
+     *
+     * The timer may fire early relative to a later deadline if activity raced
+     * with it; the session is then given a new timer instead.
+     *
+     * @param sessionId The session whose timer fired
+     */
+    void onSessionExpiry(const SessionId sessionId);
+
+    /**
+     * @brief First time at which hasSessionTimedOut() will report the session.
      */
-    void cleanupTimedOutSessions();
+    std::chrono::steady_clock::time_point expiryDeadline(const SessionData& session) const;
 
 private:
     TimeoutConfig config_;
@@ -118,9 +144,9 @@ private:
     mutable std::mutex sessionsMutex_;
     std::unordered_map<SessionId, SessionData> sessions_;
     
-    // Cleanup thread management
-    std::thread cleanupThread_;
-    std::atomic<bool> shouldStopCleanup_{false};
+    // Session expiry
+    utils::TimerService* timers_;
+    bool closing_{false};  // Set under sessionsMutex_ once destruction begins
 
     // Session ID generation
     std::atomic<SessionId> nextSessionId_{1};
@@ -5,10 +5,14 @@
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <cstdint>
+#include <vector>
 
 namespace xenocomm {
 namespace core {
 
+class AuthCache;
+
 /**
  * @brief Configuration for token-based authentication
  */
@@ -19,14 +23,28 @@ struct TokenAuthConfig {
                                             std::string& error)>;
     
     TokenValidator validator;           // Custom token validation function
+    std::vector<uint8_t> signingKey;    // HMAC-SHA256 key for signed tokens, checked when no validator is set
     std::chrono::seconds tokenTTL{3600}; // Token time-to-live (default 1 hour)
     bool allowReuse{false};            // Whether to allow token reuse
     size_t minTokenLength{32};         // Minimum token length
     size_t maxTokenLength{512};        // Maximum token length
+    size_t maxActiveTokens{10000};     // Validated tokens remembered until their TTL runs out
+    std::shared_ptr<AuthCache> cache;  // Shared result cache, e.g. SecurityManager::getAuthCache(); its TTL
+                                       // then applies. A private one of maxActiveTokens is used if null
 };
 
 /**
  * @brief Provider for token-based authentication
+ *
+ * Validated tokens are kept in an AuthCache under their SHA-256 digest, so
+ * the cache holds no usable tokens. With reuse allowed, a cached token
+ * authenticates without calling the validator again until it expires.
+ *
+ * Without a validator, tokens must be signed ones from issueToken():
+ * "<agentId>.<expiry>.<signature>", with the expiry in Unix seconds and the
+ * signature the hex HMAC-SHA256 of everything before it under signingKey.
+ * They are checked against precomputed HMAC states, and a cached one expires
+ * from the cache no later than its own expiry.
  */
 class TokenAuthProvider : public AuthenticationProvider {
 public:
@@ -38,6 +56,19 @@ public:
     AuthResult authenticate(const AuthenticationContext& context) override;
     std::string getMethodName() const override;
 
+    /**
+     * @brief Authenticates several connections at once
+     *
+     * Each distinct token is checked once, however many of the contexts present it.
+     */
+    std::vector<AuthResult> authenticateBatch(const std::vector<AuthenticationContext>& contexts) override;
+
+    /**
+     * @brief Issues a token that a provider configured with the same signingKey accepts until expiresAt
+     */
+    static std::string issueToken(const std::vector<uint8_t>& signingKey, const std::string& agentId,
+                                  std::chrono::system_clock::time_point expiresAt);
+
     /**
      * @brief Revoke a specific token
      * @param token Token to revoke
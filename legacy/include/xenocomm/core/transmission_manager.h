@@ -1,20 +1,46 @@
 #pragma once
 
+#include "xenocomm/core/aead_record_layer.hpp"
 #include "xenocomm/core/connection_manager.hpp"
 #include "xenocomm/core/security_manager.h"
 #include "xenocomm/utils/result.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/cancellation.hpp"
+#include "xenocomm/utils/config_snapshot.hpp"
+#include "xenocomm/utils/contention_profile.hpp"
+#include "xenocomm/utils/latency_histogram.hpp"
+#include "xenocomm/utils/memory_budget.hpp"
+#include "xenocomm/utils/message_arena.hpp"
+#include "xenocomm/utils/metrics_registry.hpp"
+#include "xenocomm/utils/task_scheduler.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+#include "xenocomm/utils/timer_wheel.hpp"
 #include "xenocomm/core/security_config.hpp"
 #include "xenocomm/core/error_correction.h"
 #include "xenocomm/core/error_correction_mode.h"
+#include "xenocomm/core/fountain_code.h"
+#include "xenocomm/core/congestion_controller.h"
+#include "xenocomm/core/streaming_transcoder.h"
+#include "xenocomm/core/compression_context.h"
+#include "xenocomm/core/event_reactor.hpp"
 #include <vector>
 #include <cstdint>
 #include <string>
 #include <memory>
 #include <map>
+#include <unordered_map>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <functional>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <set>
+#include <thread>
 
 namespace xenocomm {
 namespace core {
@@ -51,12 +77,20 @@ public:
         uint32_t reassembly_timeout_ms = 5000;  // Default timeout for fragment reassembly
         uint32_t max_fragments = 65535;  // Maximum number of fragments per transmission
         uint32_t fragment_buffer_size = 1024 * 1024;  // Default buffer size for reassembly
+        bool adaptive_sizing = false;  // Resize fragments at runtime from path MTU, loss and RTT
+        uint32_t min_fragment_size = 256;  // Lower bound for adaptive sizing
+        uint32_t resize_interval_packets = 64;  // Packets sent between adaptive size decisions
+        double loss_shrink_threshold = 0.02;  // Retransmission ratio above which fragments shrink
     };
 
     struct RetransmissionConfig {
         uint32_t max_retries = 3;           // Maximum number of retransmission attempts
         uint32_t retry_timeout_ms = 1000;   // Time to wait before retransmission
         uint32_t ack_timeout_ms = 500;      // Time to wait for acknowledgment
+        bool enable_selective_ack = true;   // Batch receiver acknowledgments into SACK frames; fragments
+                                            // the sender is waiting on are still acknowledged at once
+        uint32_t sack_frequency = 16;       // Emit a SACK after this many newly received fragments
+        uint32_t sack_interval_ms = 20;     // ...or once this long has passed since the previous SACK
     };
 
     struct FlowControlConfig {
@@ -68,6 +102,251 @@ public:
         uint32_t backoff_multiplier = 2;         // Multiplicative decrease factor
         uint32_t recovery_multiplier = 2;        // Multiplicative increase factor
         uint32_t min_rtt_samples = 10;           // Minimum RTT samples before adaptation
+        bool enable_pipelining = true;           // Keep up to a window of fragments in flight instead of stop-and-wait
+        uint32_t ack_poll_interval_ms = 1;       // Idle sleep between ACK polls while fragments are in flight
+        CongestionControlAlgorithm congestion_control = CongestionControlAlgorithm::AIMD;  // Window controller
+        double cubic_c = 0.4;                    // CUBIC scaling constant
+        double cubic_beta = 0.7;                 // CUBIC window retained after a loss event
+        uint32_t bbr_min_rtt_window_ms = 10000;  // BBR min RTT lifetime before probing it again
+        bool enable_pacing = true;               // Spread pipelined fragments over the RTT instead of bursting the window
+        double pacing_gain = 1.25;               // Window per smoothed RTT multiple, for controllers without a rate of their own
+        uint32_t pacing_burst_fragments = 2;     // Fragments that may still go back to back
+        uint64_t max_pacing_rate = 0;            // Bytes per second the pacer never exceeds, 0 for no cap
+        bool kernel_pacing = true;               // Also hand the rate to the transport (SO_MAX_PACING_RATE)
+    };
+
+    /**
+     * @brief Forward error correction across fragments.
+     * 
+     * Each group of data_fragments consecutive fragments is followed by
+     * parity_fragments XOR parity fragments; parity j covers the group's
+     * fragments whose position is congruent to j modulo parity_fragments. The
+     * receiver rebuilds any one lost fragment per parity without waiting an
+     * RTT for retransmission, so a burst of up to parity_fragments consecutive
+     * losses per group is recovered. Applies to pipelined sends only.
+     * 
+     * With adaptive set, the sender picks the protection itself from the
+     * retransmission ratio it sees, stepping between ProtectionLevel values:
+     * up as soon as loss crosses a threshold, down only after
+     * step_down_intervals quiet intervals in a row, since FEC hides the loss
+     * it repairs. Heavy FEC deepens parity_fragments to the longest run of
+     * consecutive losses seen, up to max_parity_fragments. enabled and
+     * parity_fragments then only choose the starting level. The receiver
+     * needs no setting: every fragment header carries the K and M it was
+     * coded with.
+     */
+    struct FecConfig {
+        bool enabled = false;
+        uint8_t data_fragments = 8;    // K: data fragments per group
+        uint8_t parity_fragments = 1;  // M: parity fragments per group, at most K
+        bool adaptive = false;
+        uint8_t light_data_fragments = 16;     // K for light FEC, which sends one parity per group
+        uint8_t max_parity_fragments = 4;      // Deepest heavy FEC interleaving, at most data_fragments
+        uint32_t adapt_interval_packets = 128; // Fragments sent between protection decisions
+        double light_loss_threshold = 0.005;   // Retransmission ratio that calls for light FEC
+        double heavy_loss_threshold = 0.03;    // ...and for heavy FEC
+        uint32_t step_down_intervals = 4;      // Intervals below half the level's threshold before lowering it
+    };
+
+    /**
+     * @brief Protection adaptive FEC moves between, weakest first.
+     */
+    enum class ProtectionLevel : uint8_t {
+        CHECKSUM_ONLY,  // CRC only, losses are retransmitted
+        LIGHT_FEC,      // light_data_fragments + 1 parity
+        HEAVY_FEC       // data_fragments + parity deepened for burst loss
+    };
+
+    /**
+     * @brief Reliable one-to-many delivery over a multicast transport
+     * 
+     * The publisher's transport is a UDPTransport connected to the group
+     * address; each subscriber's is bound to the group port, joined to the
+     * group and connected to the publisher. send() then transmits every
+     * fragment once, followed by FEC parity when FecConfig is enabled, and
+     * returns without waiting: subscribers never acknowledge. A subscriber
+     * that has a gap for nack_delay_ms, or whose message stalls that long,
+     * sends the publisher a NACK naming the fragments it still lacks. The
+     * publisher keeps each message for repair_window_ms and resends what is
+     * asked for to the whole group, ignoring further NACKs for the same
+     * fragment for nack_delay_ms, so one repair serves every subscriber that
+     * lost it. NACKs are answered at the start of each send() and by
+     * serve_repairs(). A subscriber that misses every fragment of a message
+     * cannot know to ask for it; FEC parity makes that unlikely.
+     */
+    struct MulticastConfig {
+        bool enabled = false;
+        uint32_t nack_delay_ms = 20;         // Wait before reporting a gap, giving reordering and FEC a chance
+        uint32_t nack_interval_ms = 100;     // Least time between NACKs for one message
+        uint32_t repair_window_ms = 5000;    // How long the publisher keeps a sent message for repairs
+        size_t repair_buffer_bytes = 16 * 1024 * 1024;  // Oldest messages are dropped first beyond this
+    };
+
+    /**
+     * @brief Chunking for send_stream()
+     * 
+     * Each chunk is transcoded and sent as one message, so a chunk must fit
+     * within max_fragments fragments once encoded.
+     */
+    struct StreamConfig {
+        uint32_t chunk_size = 256 * 1024;  // Input bytes per chunk
+    };
+
+    /**
+     * @brief Packing of small sends into shared batches, in the manner of Nagle
+     * 
+     * A send() of at most max_message_size bytes returns at once, leaving the
+     * message in a batch where each is prefixed by its 4-byte length. The batch
+     * goes out as one message, under one header, error check and acknowledgment,
+     * once it holds max_batch_messages messages, once another would take it past
+     * max_batch_bytes, or once its first message has waited max_delay_ms;
+     * flush() sends it sooner. A larger send, or send_stream(), flushes the batch
+     * ahead of itself, so messages keep their order. The receiver unpacks a
+     * batch and receive() returns its messages one at a time.
+     * 
+     * A batch sent after its deadline has no caller waiting on it; if it fails,
+     * the next send() or flush() returns that error and sends nothing. A batch
+     * still pending when the manager is destroyed is dropped.
+     */
+    struct CoalescingConfig {
+        bool enabled = false;
+        uint32_t max_delay_ms = 2;          // Longest the first message of a batch waits
+        uint32_t max_batch_messages = 32;   // Messages per batch
+        uint32_t max_batch_bytes = 0;       // Batch payload limit; 0 for one fragment's worth
+        uint32_t max_message_size = 256;    // Larger sends bypass the batch
+    };
+
+    /**
+     * @brief Compression of messages against what the connection carried before them
+     * 
+     * Every send of at least min_message_size bytes is deflated with a history
+     * window shared by all messages in one direction (see
+     * core::CompressionContext), so small messages that resemble earlier ones,
+     * as control traffic does, shrink to little more than their differences.
+     * The receiver must decompress them in the order they were sent. If it
+     * cannot, it tells the sender, whose next message opens a new history;
+     * messages in between fail to decompress and are lost. Both histories
+     * restart when the connection is rebound or this configuration changes.
+     * Multicast sends are not compressed, and a message sent while it preempts
+     * another is compressed alone, so the history stays in send order.
+     */
+    struct StreamCompressionConfig {
+        bool enabled = false;
+        int level = core::CompressionContext::DEFAULT_LEVEL;  // zlib level, 1 (fast) to 9 (small)
+        uint32_t min_message_size = 32;   // Smaller sends go uncompressed
+    };
+
+    /**
+     * @brief Limits on what a manager buffers, and the signals given as they near
+     * 
+     * Each send's in-flight message, each batched message and each reassembly
+     * buffer is charged, while it lives, against this manager's peer quota
+     * and against utils::MemoryBudget::shared(), which every manager in the
+     * process draws on (give it a limit with setLimit()). A send that does not
+     * fit waits up to admission_timeout_ms for room and then fails with
+     * ErrorCode::BufferFull; try_send() fails at once instead. The first
+     * fragment of a message that does not fit is dropped unacknowledged, so
+     * the sender retransmits it later instead of the receiver growing without
+     * bound. The backpressure callback reports both budgets' watermarks.
+     */
+    struct AdmissionConfig {
+        size_t peer_quota_bytes = 0;            // Bytes buffered for this manager's peer; 0 for no quota
+        double high_watermark = 0.8;            // Fraction of the quota at which backpressure is signalled
+        double low_watermark = 0.5;             // Fraction at which it is lifted again
+        uint32_t admission_timeout_ms = 1000;   // Longest send() waits for room
+    };
+
+    /**
+     * @brief Dropping duplicate and replayed fragments before they cost anything
+     * 
+     * receive() checks each fragment as soon as its header is parsed, before
+     * the CRC, decryption or any copy. A fragment its reassembly context
+     * already holds, data or parity, is a duplicate, typically from a
+     * spurious retransmission. A fragment of a transmission already
+     * delivered is a replay: a sliding window remembers the window_size
+     * transmission IDs up to the highest one delivered and refuses anything
+     * older, as DTLS does for record numbers. Both are dropped, and
+     * acknowledged again as already received, since the usual cause is a
+     * sender that missed an acknowledgment. Only messages that completed,
+     * with every fragment verified, advance the window, so forged headers
+     * cannot move it.
+     * 
+     * A restarted sender counts transmission IDs from zero again, so the
+     * window applies only while a record layer is set, whose keys tie the IDs
+     * to one session, unless unsealed is set too. A new record layer or a
+     * rebound connection starts it afresh. Multicast messages are left to the
+     * contexts they keep once delivered.
+     */
+    struct ReplayConfig {
+        bool enabled = true;
+        uint32_t window_size = 1024;  // Transmission IDs remembered, rounded up to a multiple of 64
+        bool unsealed = false;        // Also applies without a record layer, for senders that never restart
+    };
+
+    /**
+     * @brief Fountain-coded transfer of one large payload with send_bulk()
+     * 
+     * The payload is cut into blocks of block_symbols symbols and sent with
+     * core::FountainEncoder: every source symbol once, plus repair_overhead
+     * repair symbols per source symbol, then round after round of fresh
+     * repair symbols for every block. A receiver decodes a block from any
+     * block_symbols of its symbols, whichever were lost, so nothing is
+     * acknowledged or retransmitted per fragment; each receive_bulk() caller
+     * reports only once it holds the whole payload, and send_bulk() stops
+     * when expected_receivers have done so. One stream thus serves receivers
+     * with any mix of loss rates, each finishing as soon as its own loss
+     * allows, which suits checkpoints sent to many subscribers of a
+     * multicast group.
+     * 
+     * Symbols are not encrypted, so both ends need SecurityLevel::LOW, and a
+     * receiver buffers a whole payload, up to max_payload_bytes, charged
+     * against the admission budgets (see AdmissionConfig).
+     */
+    struct BulkTransferConfig {
+        uint32_t symbol_size = 0;             // Bytes per symbol; 0 for the current fragment size
+        uint32_t block_symbols = 256;         // Source symbols per block, at most FountainLayout::MAX_BLOCK_SYMBOLS
+        double repair_overhead = 0.05;        // Repair symbols per source symbol, in the first pass and each round after
+        uint32_t expected_receivers = 1;      // Completions send_bulk() waits for; 0 streams for max_duration_ms
+        uint32_t max_duration_ms = 600000;    // Longest send_bulk() streams before giving up
+        uint64_t send_rate = 0;               // Bytes per second symbols go out at; 0 for unpaced
+        uint64_t max_payload_bytes = uint64_t{4} << 30;  // Largest payload a receiver accepts
+        uint32_t completion_repeats = 3;      // Copies of each completion a receiver sends, as nothing acknowledges them
+    };
+
+    /**
+     * @brief Order in which queued sends get the connection
+     * 
+     * A send waiting for the connection goes ahead of every lower class. A
+     * message of a higher class also preempts one already being sent: at its
+     * next fragment boundary the lower message steps aside, the urgent one is
+     * sent in full under its own transmission ID, and the lower one resumes
+     * where it stopped. Over a reliable stream each message is a single
+     * frame, so there priority only orders messages between frames.
+     */
+    enum class MessagePriority : uint8_t {
+        BULK,     // State transfers and other large payloads
+        NORMAL,   // What send() without options uses
+        URGENT    // Control messages
+    };
+
+    // What becomes of a message whose deadline passes before it starts
+    enum class ExpiryPolicy : uint8_t {
+        DROP,          // send() fails with ErrorCode::DeadlineExceeded
+        DEPRIORITIZE   // Sent anyway, as BULK
+    };
+
+    /**
+     * @brief Scheduling of one send
+     * 
+     * Among sends of one class the earliest deadline goes first, then the
+     * earliest call. The deadline applies until the message starts; one that
+     * has started is finished, so bound the whole send with a
+     * CancellationToken instead.
+     */
+    struct SendOptions {
+        MessagePriority priority = MessagePriority::NORMAL;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        ExpiryPolicy on_expiry = ExpiryPolicy::DROP;
     };
 
     struct TransmissionStats {
@@ -80,8 +359,29 @@ public:
         double avg_rtt_ms = 0;
         double min_rtt_ms = std::numeric_limits<double>::max();
         double max_rtt_ms = 0;
+        double rtt_p50_ms = 0;    // Percentiles over every RTT sample since reset_stats()
+        double rtt_p99_ms = 0;
+        double rtt_p999_ms = 0;
         uint32_t current_window_size = 0;
+        uint64_t pacing_rate = 0;              // Bytes per second fragments are paced at, 0 when unpaced
         uint32_t packet_loss_count = 0;
+        uint64_t fec_recovered_fragments = 0;  // Lost fragments rebuilt from parity
+        uint64_t nacks_sent = 0;               // Multicast repair requests sent to the publisher
+        uint64_t multicast_repairs = 0;        // Fragments resent to the group in answer to NACKs
+        uint64_t coalesced_messages = 0;       // Messages sent packed into a batch
+        uint64_t admission_refusals = 0;       // Sends and first fragments refused for lack of buffer room
+        uint64_t duplicates_dropped = 0;       // Fragments dropped unverified as already held
+        uint64_t replays_dropped = 0;          // Fragments dropped unverified as of delivered transmissions
+        size_t buffered_bytes = 0;             // Bytes charged to the peer quota right now
+        uint64_t preemptions = 0;              // Times a message stepped aside for a higher priority one
+        uint64_t deadline_drops = 0;           // Sends dropped because their deadline passed before they started
+        uint64_t bulk_symbols_sent = 0;        // Fountain symbols sent by send_bulk()
+        uint64_t bulk_symbols_received = 0;    // Fountain symbols taken in by receive_bulk()
+        ProtectionLevel protection_level = ProtectionLevel::CHECKSUM_ONLY;  // FEC the next send uses
+        uint8_t fec_parity_fragments = 0;      // Parity per group at that level, 0 without FEC
+        uint64_t protection_changes = 0;       // Times adaptive FEC changed level or depth
+        uint32_t current_fragment_size = 0;  // Fragment payload size used for the next send
+        uint32_t path_mtu = 0;               // Last path MTU reported via set_path_mtu (0 if unknown)
         std::chrono::steady_clock::time_point last_update;
         
         // Security-related stats
@@ -99,6 +399,14 @@ public:
         FragmentConfig fragment_config;
         RetransmissionConfig retransmission_config;
         FlowControlConfig flow_control;
+        FecConfig fec;
+        MulticastConfig multicast;
+        StreamConfig stream;
+        CoalescingConfig coalescing;
+        StreamCompressionConfig stream_compression;
+        AdmissionConfig admission;
+        ReplayConfig replay;
+        BulkTransferConfig bulk;
         xenocomm::core::SecurityConfig security;  // Security configuration
         uint8_t retry_attempts = 3;
         bool enable_logging = true;
@@ -114,8 +422,42 @@ public:
         uint32_t error_check;        // Error check value (CRC32 or Reed-Solomon syndrome)
         bool is_encrypted;           // Whether this fragment is encrypted
         uint8_t security_flags;      // Security-related flags
+        uint8_t fec_flags;           // FEC_PARITY if this is a parity fragment
+        uint8_t fec_data_fragments;  // FEC group size K, or 0 when FEC is off
+        uint8_t fec_parity_fragments;// FEC parity fragments per group M
     };
 
+    static constexpr uint8_t FEC_PARITY = 0x01;
+    static constexpr uint8_t MULTICAST_FRAGMENT = 0x02;  // fec_flags: published to a group, repaired by NACK
+    static constexpr uint8_t COALESCED_BATCH = 0x04;     // fec_flags: the message packs several, length-prefixed
+    static constexpr uint8_t STREAM_COMPRESSED = 0x08;   // fec_flags: the message is a CompressionContext frame
+    static constexpr uint8_t ACK_IMMEDIATELY = 0x10;     // fec_flags: the sender waits on this fragment's ack
+    static constexpr uint8_t SECURITY_AEAD = 0x01;  // security_flags: payload sealed by the record layer
+
+    /**
+     * @brief Size of a FragmentHeader on the wire, independent of the struct's layout.
+     *
+     * All fields are little-endian: version (1 byte), flags (1), FEC K (1),
+     * FEC M (1), transmission ID (4), fragment index (2), total fragments (2),
+     * fragment size (4), original size (4), error check (4). flags packs
+     * is_encrypted, SECURITY_AEAD, FEC_PARITY, MULTICAST_FRAGMENT,
+     * COALESCED_BATCH, STREAM_COMPRESSED and ACK_IMMEDIATELY into one bit each.
+     */
+    static constexpr size_t FRAGMENT_HEADER_SIZE = 24;
+    static constexpr uint8_t FRAGMENT_HEADER_VERSION = 1;
+
+    /**
+     * @brief Writes header's wire form into the FRAGMENT_HEADER_SIZE bytes at out.
+     */
+    static void encode_header(const FragmentHeader& header, uint8_t* out);
+
+    /**
+     * @brief Reads a wire header from the start of data.
+     *
+     * @return false if data is too short or carries another header version
+     */
+    static bool decode_header(utils::ByteSpan data, FragmentHeader& header);
+
     struct FragmentAck {
         uint32_t transmission_id;
         uint16_t fragment_index;
@@ -123,6 +465,36 @@ public:
         uint32_t error_code;
     };
 
+    /**
+     * @brief Batched acknowledgment covering many fragments of one transmission.
+     *
+     * Every fragment below cumulative_index has been received. Bit i of
+     * received_bitmap reports fragment cumulative_index + 1 + i; fragment
+     * cumulative_index itself is by definition still missing.
+     */
+    struct SelectiveAck {
+        uint32_t transmission_id;
+        uint16_t cumulative_index;
+        uint16_t total_fragments;
+        uint64_t received_bitmap;
+    };
+
+    static constexpr uint16_t SACK_BITMAP_BITS = 64;
+
+    enum class AckFrameType : uint8_t {
+        FRAGMENT_ACK = 1,   ///< Single-fragment FragmentAck
+        SELECTIVE_ACK = 2,  ///< Cumulative index plus bitmap (SelectiveAck)
+        NACK = 3,           ///< Multicast repair request (SelectiveAck layout, see send_nack())
+        COMPRESSION_RESYNC = 4, ///< Stream compression lost sync (SelectiveAck layout, see send_compression_resync())
+        BULK_COMPLETE = 5       ///< A receiver decoded a bulk transfer (SelectiveAck layout, see send_bulk_complete())
+    };
+
+    struct AckFrame {
+        AckFrameType type;
+        FragmentAck fragment_ack;
+        SelectiveAck selective_ack;
+    };
+
     /**
      * @brief Event types for retry notifications
      */
@@ -147,6 +519,9 @@ public:
 
     /**
      * @brief Retry statistics for monitoring and analysis
+     *
+     * Retry latency is the time from a fragment's first transmission to the
+     * acknowledgment of one of its retransmissions, i.e. what a loss cost.
      */
     struct RetryStats {
         uint64_t total_retries = 0;
@@ -154,13 +529,39 @@ public:
         uint64_t failed_retries = 0;
         uint64_t max_retries_reached = 0;
         double avg_retry_latency_ms = 0;
+        double retry_latency_p50_ms = 0;
+        double retry_latency_p99_ms = 0;
         std::chrono::steady_clock::time_point last_retry;
-        std::map<uint32_t, uint32_t> retry_distribution;  // retry_count -> frequency
+        // retry_count -> frequency; counts above 7 share log-linear buckets keyed by their upper bound
+        std::map<uint32_t, uint32_t> retry_distribution;
+    };
+
+    /**
+     * @brief A budget crossing its high watermark, or falling back to its low one
+     */
+    struct BackpressureEvent {
+        bool engaged;           // true at the high watermark, false once back at the low one
+        bool process_wide;      // The shared process budget crossed, rather than this peer's quota
+        size_t buffered_bytes;  // Bytes charged to that budget at the crossing
     };
 
     // Callback type for retry events
     using RetryCallback = std::function<void(const RetryEvent&)>;
 
+    // Runs on the thread whose send or receive crossed the watermark; must not block
+    using BackpressureCallback = std::function<void(const BackpressureEvent&)>;
+
+    // Callback invoked by whichever receiver thread completes a message, before receive() returns it
+    using MessageCompleteCallback = std::function<void(uint32_t transmission_id, const std::vector<uint8_t>& message)>;
+
+    // Fills the buffer with the next input of a streamed payload, returning the bytes written; 0 ends the stream
+    using StreamSource = std::function<size_t(utils::MutableByteSpan buffer)>;
+
+    // Receives the decoded data of each stream chunk, in stream order
+    using StreamSink = std::function<void(utils::ByteSpan data)>;
+    // Called on a reactor thread with each message an async receive completes, or the error that ended it
+    using AsyncReceiveHandler = std::function<void(Result<std::vector<uint8_t>> message)>;
+
     /**
      * @brief Constructs a TransmissionManager instance.
      * 
@@ -168,6 +569,7 @@ public:
      * @throw std::runtime_error if error correction initialization fails
      */
     explicit TransmissionManager(ConnectionManager& connection_manager);
+    ~TransmissionManager();
 
     /**
      * @brief Sends data through the connection with error correction.
@@ -177,6 +579,75 @@ public:
      */
     Result<void> send(const std::vector<uint8_t>& data);
 
+    /**
+     * @brief Sends data straight from the caller's memory
+     * 
+     * The data is not copied up front; it only has to stay valid and unchanged
+     * until the call returns.
+     * 
+     * @param data The data to send
+     * @param size Size of the data in bytes
+     * @return Result<void> Success or error status
+     */
+    Result<void> send(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Sends data, giving up when token is cancelled or its deadline passes
+     * 
+     * The token becomes CancellationToken::current() for the call, so the
+     * transport's socket waits and the waits for acknowledgments and window
+     * space all end with it. A send abandoned partway returns
+     * ErrorCode::Cancelled; the peer discards the incomplete transmission.
+     */
+    Result<void> send(const uint8_t* data, size_t size, const utils::CancellationToken& token);
+
+    /**
+     * @brief Sends data with a priority and deadline; see SendOptions
+     * 
+     * URGENT messages are never coalesced. Waiting for the connection ends
+     * with CancellationToken::current() as well.
+     * 
+     * @return ErrorCode::DeadlineExceeded if the message was dropped unsent
+     */
+    Result<void> send(const uint8_t* data, size_t size, const SendOptions& options);
+
+    /**
+     * @brief Sends size bytes of a regular file, starting at offset, as one message
+     * 
+     * The receiver gets it from receive() like any other message. For rollback
+     * snapshots, model states and similar bulk files, which never have to be
+     * read into a buffer: over a reliable stream with security at LOW the
+     * transport hands the file to the kernel (sendfile(2) over TCP) behind a
+     * frame header, and is neither coalesced nor compressed. Otherwise the
+     * region is mapped and sent as send() sends memory. The file position is
+     * neither used nor moved; the region must not change until this returns.
+     * A region already in memory, mapped or not, goes to send() directly.
+     */
+    Result<void> send_file(int fd, int64_t offset, size_t size);
+
+    /**
+     * @brief send_file() with a priority and deadline; see SendOptions
+     */
+    Result<void> send_file(int fd, int64_t offset, size_t size, const SendOptions& options);
+
+    /**
+     * @brief send() that returns ErrorCode::BufferFull rather than wait for room
+     * 
+     * Fails at once if another send is in progress or the message does not
+     * fit the peer quota or process budget. Once admitted, it is sent as by
+     * send(), which with coalescing enabled returns without waiting for small
+     * messages.
+     */
+    Result<void> try_send(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Sends the pending batch of coalesced messages now
+     * 
+     * @return Result<void> Error if the batch, or an earlier one sent at its
+     *         deadline, failed; success if nothing was pending
+     */
+    Result<void> flush();
+
     /**
      * @brief Receives data and applies error correction if needed.
      * 
@@ -184,26 +655,198 @@ public:
      */
     Result<std::vector<uint8_t>> receive(uint32_t timeout_ms = 1000);
 
+    /**
+     * @brief Receives data, giving up at timeout_ms or when token is cancelled, whichever is first
+     */
+    Result<std::vector<uint8_t>> receive(uint32_t timeout_ms, const utils::CancellationToken& token);
+
+    /**
+     * @brief Transcodes and sends a payload chunk by chunk
+     * 
+     * Input is read from source and transcoded with a StreamingEncoder into
+     * chunks of StreamConfig::chunk_size, each sent as its own message. The
+     * next chunk is read and encoded on a worker thread while the current one
+     * is transmitted, so the first bytes go out after one chunk is encoded and
+     * neither the input nor the encoded payload is ever held whole. source is
+     * called from that worker, one call at a time. Other senders wait until
+     * the stream has been sent.
+     * 
+     * @param source Supplies the payload
+     * @param transcoder Encodes each chunk; must not be used elsewhere until this returns
+     * @param input_format Format of the payload, as passed to DataTranscoder::encode()
+     * @param encoded_format Format the transcoder produces, which the receiver decodes from
+     * @return Result<void> Success, or the first transmission or encoding error
+     */
+    Result<void> send_stream(const StreamSource& source, DataTranscoder& transcoder,
+                             DataFormat input_format, DataFormat encoded_format);
+
+    /**
+     * @brief Receives and decodes a payload sent with send_stream()
+     * 
+     * Each chunk is decoded on a worker thread while the fragments of the next
+     * are being reassembled, and handed to sink as soon as it is decoded; sink
+     * is called from that worker, one chunk at a time. Returns once the last
+     * chunk has reached sink.
+     * 
+     * @param sink Receives the decoded payload
+     * @param transcoder Decodes each chunk; must not be used elsewhere until this returns
+     * @param timeout_ms Longest wait for each fragment
+     * @return Result<void> Success, or the first reception or decoding error
+     */
+    Result<void> receive_stream(const StreamSink& sink, DataTranscoder& transcoder, uint32_t timeout_ms = 1000);
+
+    /**
+     * @brief Answer multicast subscribers' NACKs for up to timeout_ms
+     * 
+     * A publisher calls this between sends, or from a thread of its own, so
+     * repairs go out while it has nothing new to publish. With a timeout of 0
+     * it answers the NACKs already queued and returns.
+     * 
+     * @return Number of fragments resent to the group
+     */
+    Result<size_t> serve_repairs(uint32_t timeout_ms = 0);
+
+    /**
+     * @brief Stream data to every receiver with a rateless fountain code
+     * 
+     * Sends as BulkTransferConfig describes, until expected_receivers have
+     * reported the payload decoded or max_duration_ms has passed. Completions
+     * are counted per receiving manager, so a receiver reporting twice counts
+     * once. Over a reliable stream this is send().
+     * 
+     * @return Result<void> Success, or an error if the receivers did not all
+     *         finish in time, the configuration is invalid or sending failed
+     */
+    Result<void> send_bulk(utils::ByteSpan data);
+
+    /**
+     * @brief Receive the next payload sent with send_bulk()
+     * 
+     * Takes in symbols until some transfer is decoded, then reports it to the
+     * sender and returns it. Transfers still incomplete when the wait ends are
+     * kept, so the next call picks up where this one stopped; one that gets no
+     * symbol for reassembly_timeout_ms is dropped. Anything other than bulk
+     * symbols received meanwhile is left for receive(). Not available while an
+     * async receive is running. Over a reliable stream this is receive().
+     * 
+     * @param timeout_ms Longest wait for a whole payload
+     * @return Result<std::vector<uint8_t>> The payload, or an error on timeout
+     */
+    Result<std::vector<uint8_t>> receive_bulk(uint32_t timeout_ms);
+
     /**
      * @brief Updates the configuration settings.
      * 
+     * Changes take effect at a message boundary: at once if no send is in
+     * progress, otherwise as soon as the message being sent has gone out, so
+     * every fragment of a message is sent under one configuration. The caller
+     * never waits for fragments in flight, and nothing is drained or reset;
+     * fragments describe their own FEC layout and size, so the receiver
+     * reassembles messages sent before and after the change alike. This is how
+     * parameters renegotiated with NegotiationProtocol::renegotiateSession() are
+     * put into effect. If several changes arrive during one message, the last
+     * one wins. get_config() reflects a change once it has taken effect.
+     * 
      * @param config The new configuration to apply
      */
     void set_config(const Config& config);
 
+    /**
+     * @brief Deliver whole messages as frames when transport is a reliable stream
+     * 
+     * Over a transport whose isReliableStream() is true (TCPTransport), send()
+     * writes each message as a single frame and receive() reads one back:
+     * fragmentation, acknowledgments, retransmission, FEC and the error check
+     * are skipped because the stream already provides them. Encryption still
+     * applies. Other transports carry the fragmented protocol directly, each
+     * fragment received into a pooled buffer. The transport must outlive the
+     * manager; pass nullptr to detach it.
+     * 
+     * @param transport Non-owning transport pointer, or nullptr
+     */
+    void set_transport(TransportProtocol* transport);
+
+    /**
+     * @brief Carry data over a connection established on the ConnectionManager
+     * 
+     * Attaches the connection's transport as set_transport() does, and keeps it
+     * alive for as long as it stays attached, and takes up its configuration
+     * as apply_connection_config() does. Waits for any send or receive in
+     * progress to finish first.
+     * 
+     * @param connection_id A connection established with a transport
+     * @return Error if the connection is unknown or carries no transport
+     */
+    Result<void> bind_connection(const Connection::ConnectionId& connection_id);
+
+    /**
+     * @brief Adopts the per-connection settings this layer honours
+     * 
+     * With ConnectionConfig::lowLatency, sends skip coalescing however it is
+     * configured, and start_async_receive() runs on a thread of its own that
+     * spins on the socket for spinBeforeParkUs before each short park,
+     * pinned to ioThreadCpu if that is set. Takes effect for the next send
+     * and the next start_async_receive().
+     */
+    void apply_connection_config(const ConnectionConfig& config);
+
+    /**
+     * @brief Protect fragments and frames with a record layer instead of the secure context
+     * 
+     * Encrypted payloads are then sealed in place with the layer's AEAD
+     * cipher and carry its tag; for fragments the header fields the receiver
+     * relies on are authenticated as associated data. Both peers need layers
+     * with matching keys, typically from AeadRecordLayer::fromContext() on the
+     * same TLS session. Pass nullptr to fall back to the secure context.
+     */
+    void set_record_layer(std::shared_ptr<AeadRecordLayer> layer);
+
     /**
      * @brief Gets the current configuration.
      * 
-     * @return const Config& The current configuration
+     * Safe to call while set_config() is being applied on another thread.
+     * 
+     * @return Config A copy of the current configuration
      */
-    const Config& get_config() const { return config_; }
+    Config get_config() const { return *config_.read(); }
 
     // Flow control methods
-    const TransmissionStats& get_stats() const;
+    /**
+     * @brief Snapshot of the transmission statistics
+     * 
+     * Counters are maintained lock-free, so the snapshot is cheap but not
+     * atomic as a whole: fields may reflect slightly different instants.
+     */
+    TransmissionStats get_stats() const;
     void reset_stats();
+
+    /**
+     * @brief Reports get_stats() and get_retry_stats() through registry whenever it is exported
+     *
+     * Series are labelled instance=<instance> so several managers can share a
+     * registry. Registering again replaces the previous registration.
+     */
+    void register_metrics(utils::MetricsRegistry& registry, const std::string& instance);
     Result<void> wait_for_window_space(size_t data_size, std::chrono::milliseconds timeout);
     void release_window_space(size_t data_size);
 
+    /**
+     * @brief Report the path MTU towards the peer
+     * 
+     * With FragmentConfig::adaptive_sizing enabled, fragments are sized so a
+     * header and payload fit one IP packet of this size (e.g. from
+     * UDPTransport::getPathMtu()), and shrink or grow from there as measured
+     * loss and RTT change. Without adaptive sizing max_fragment_size is used.
+     * 
+     * @param mtu Path MTU in bytes, including IP and UDP headers (0 if unknown)
+     */
+    void set_path_mtu(uint32_t mtu);
+
+    /**
+     * @brief Fragment payload size the next send() will use
+     */
+    uint32_t current_fragment_size() const;
+
     /**
      * @brief Register a callback for retry events
      * 
@@ -212,11 +855,75 @@ public:
     void set_retry_callback(RetryCallback callback);
 
     /**
-     * @brief Get current retry statistics
+     * @brief Register a callback for watermark crossings of the peer quota and process budget
+     * 
+     * Replaces any earlier callback. Senders can use it to slow down before
+     * sends start failing with ErrorCode::BufferFull.
+     */
+    void set_backpressure_callback(BackpressureCallback callback);
+
+    /**
+     * @brief Whether either budget is above its high watermark and not yet back at its low one
+     */
+    bool under_backpressure() const;
+
+    /**
+     * @brief Register a callback for completed message reassembly
+     * 
+     * receive() may be called from several threads at once; each returns
+     * ErrorCode::IncompleteTransmission until the thread that stores a message's final
+     * fragment, which notifies this callback and returns the whole message.
+     * 
+     * @param callback Function to be called when a message is fully reassembled
+     */
+    void set_message_complete_callback(MessageCompleteCallback callback);
+
+    /**
+     * @brief Receives on an EventReactor loop instead of a waiting thread
+     * 
+     * Registers the attached transport's descriptor with reactor. Whenever it is
+     * readable, datagrams go through the same path as receive(), and each
+     * completed message is passed to handler; fragment-level failures are dropped,
+     * as a receive() caller would retry them. If the transport loses its
+     * connection the error is passed to handler and the receive stops. The socket
+     * is left blocking; send() stops reading it and takes the acks the reactor
+     * sets aside instead.
+     * 
+     * The handler runs on the reactor thread and must not block. Do not call
+     * receive() while an async receive runs, and stop it before attaching
+     * another transport.
+     * 
+     * @return Result<void> Error if no transport with a descriptor is attached or
+     *         an async receive is already running
+     */
+    Result<void> start_async_receive(AsyncReceiveHandler handler, EventReactor& reactor = EventReactor::shared());
+
+    /**
+     * @brief Stops an async receive
      * 
-     * @return const RetryStats& Current retry statistics
+     * Once it returns the handler is not running and will not run again. May be
+     * called from the handler itself.
+     */
+    void stop_async_receive();
+
+    /**
+     * @brief Snapshot of the retry statistics
+     *
+     * Like get_stats(), read from lock-free counters and histograms.
+     */
+    RetryStats get_retry_stats() const;
+
+    /**
+     * @brief RTT at the given percentile (0-100) over every sample since reset_stats()
+     *
+     * Samples and percentiles are kept to within 12.5%; 0 if nothing was sampled.
+     */
+    std::chrono::microseconds rtt_percentile(double percentile) const;
+
+    /**
+     * @brief Retry latency at the given percentile (0-100) since reset_retry_stats()
      */
-    const RetryStats& get_retry_stats() const;
+    std::chrono::microseconds retry_latency_percentile(double percentile) const;
 
     /**
      * @brief Reset retry statistics
@@ -244,85 +951,319 @@ public:
     Result<void> setup_secure_channel();
 
 private:
-    // Fragmentation methods
-    std::vector<std::vector<uint8_t>> fragment_data(const std::vector<uint8_t>& data);
-    Result<void> send_fragment(const std::vector<uint8_t>& fragment, const FragmentHeader& header);
-    Result<std::vector<uint8_t>> receive_fragment();
-    Result<std::vector<uint8_t>> reassemble_fragments(uint32_t transmission_id);
+    // Configuration changes, applied between messages; both require send_mutex_
+    void apply_config(const Config& config);
+    void apply_pending_config();
 
-    // Fragment tracking
-    struct FragmentInfo {
-        std::vector<uint8_t> data;
-        bool received = false;
-        std::chrono::steady_clock::time_point timestamp;
-    };
+    // Send paths; a send's transient state lives in its TransmissionState's arena
+    using FragmentList = std::pmr::vector<utils::ByteSpan>;
+    Result<void> send_locked(utils::ByteSpan data);  // Requires send_mutex_
+    Result<void> send_stop_and_wait(const FragmentList& fragments, uint32_t transmission_id, uint32_t original_size);
+    Result<void> send_pipelined(const FragmentList& fragments, uint32_t transmission_id, uint32_t original_size);
+    Result<void> send_multicast(utils::ByteSpan data);
+    bool fec_config_valid(size_t fragment_count) const;
+    Result<FragmentHeader> prepare_fragment(utils::ByteSpan fragment, uint32_t transmission_id,
+                                            uint16_t fragment_index, uint16_t total_fragments,
+                                            uint32_t original_size, uint8_t fec_flags, bool fec_coded,
+                                            std::pmr::vector<uint8_t>& ciphertext);
+    size_t process_pending_acks(uint32_t transmission_id);
+
+    // Framed paths over a reliable stream transport; a frame is a flags byte and the payload
+    static constexpr uint8_t FRAME_ENCRYPTED = 0x01;
+    static constexpr uint8_t FRAME_AEAD = 0x02;  // With FRAME_ENCRYPTED: sealed by the record layer
+    static constexpr uint8_t FRAME_COALESCED = 0x10;  // The payload is a batch; see CoalescingConfig
+    static constexpr uint8_t FRAME_COMPRESSED = 0x20;  // The payload is a CompressionContext frame
+    bool use_framing() const;
+    Result<void> send_framed(utils::ByteSpan data);
+    Result<void> send_file_locked(int fd, int64_t offset, size_t size, MessagePriority priority);
+    Result<void> send_file_framed(int fd, int64_t offset, size_t size);
+    Result<std::vector<uint8_t>> receive_framed(uint32_t timeout_ms);
+    void apply_receive_timeout(TransportProtocol* transport, uint32_t timeout_ms);  // Requires receive_mutex_
 
+    // Fragmentation methods; fragments are views into the caller's buffer, never copies
+    FragmentList fragment_data(utils::ByteSpan data,
+                               std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    Result<void> send_fragment(utils::ByteSpan fragment, const FragmentHeader& header);
+    Result<utils::PooledBuffer> receive_fragment(uint32_t timeout_ms);
+
+    // Forward error correction
+    Result<void> send_fec_parity(const FragmentList& fragments, uint32_t transmission_id,
+                                 uint32_t original_size, size_t group, uint8_t fec_flags = 0);
+    static uint32_t fec_parity_count(uint32_t total_fragments, uint8_t data_fragments, uint8_t parity_fragments);
+
+    // Fragment tracking
     struct ReassemblyContext {
-        std::map<uint16_t, FragmentInfo> fragments;
-        uint16_t total_fragments;
-        uint32_t original_size;
+        utils::MessageArena arena{2048};  // Bookkeeping below, released with the context
+        std::pmr::vector<uint64_t> received{arena.resource()};  // One bit per fragment index
+        uint16_t received_count = 0;
+        uint16_t total_fragments = 0;
+        uint32_t original_size = 0;
         std::chrono::steady_clock::time_point start_time;
+        std::vector<uint8_t> buffer;  // Preallocated to original_size; fragments are copied straight into place
+        size_t charged = 0;           // Bytes admitted for buffer, released with it
+
+        // Selective acknowledgment bookkeeping
+        uint16_t cumulative_index = 0;                        // First fragment index not yet received
+        uint32_t unacked_fragments = 0;                       // Fragments received since the last SACK
+        std::chrono::steady_clock::time_point last_ack_sent;
+
+        // FEC parity waiting for its group to be down to a single missing fragment
+        uint8_t fec_data_fragments = 0;
+        uint8_t fec_parity_fragments = 0;
+        std::pmr::unordered_map<uint16_t, std::pmr::vector<uint8_t>> parity{arena.resource()};  // parity index -> payload
+
+        // Multicast messages are NACKed rather than acknowledged, and stay behind once delivered
+        // so repairs other subscribers asked for are recognized as duplicates
+        bool multicast = false;
+        bool delivered = false;
+        uint32_t next_expected = 0;  // One past the highest fragment index received
+        std::chrono::steady_clock::time_point last_progress;
+        std::chrono::steady_clock::time_point gap_since;  // Zero while nothing below next_expected is missing
+        std::chrono::steady_clock::time_point last_nack;
+
+        bool has_fragment(uint32_t index) const {
+            return index < total_fragments && (received[index / 64] & (uint64_t{1} << (index % 64))) != 0;
+        }
+        void mark_received(uint32_t index) {
+            received[index / 64] |= uint64_t{1} << (index % 64);
+            ++received_count;
+        }
+        bool complete() const { return received_count == total_fragments; }
     };
 
-    std::map<uint32_t, ReassemblyContext> reassembly_contexts_;
-    uint32_t next_transmission_id_ = 0;
+    // Reassembly state is split across independently locked shards keyed by
+    // transmission ID, so receiver threads working on different messages never contend
+    struct ReassemblyShard {
+        std::mutex mutex;
+        std::unordered_map<uint32_t, ReassemblyContext> contexts;
+        utils::TimerWheel<uint32_t> expiry{std::chrono::milliseconds(10)};  // start_time + reassembly timeout
+    };
+
+    static constexpr size_t REASSEMBLY_SHARD_COUNT = 16;
+    std::array<ReassemblyShard, REASSEMBLY_SHARD_COUNT> reassembly_shards_;
+    ReassemblyShard& reassembly_shard(uint32_t transmission_id);
+    bool try_fec_recovery(uint32_t transmission_id, ReassemblyContext& context, uint16_t parity_index);
+
+    std::atomic<uint32_t> next_transmission_id_{0};
 
     // Fragment error correction methods
     Result<std::vector<uint8_t>> apply_error_correction(const std::vector<uint8_t>& data);
     Result<std::vector<uint8_t>> verify_and_correct(const std::vector<uint8_t>& data);
-    uint32_t calculate_error_check(const std::vector<uint8_t>& data);
+    uint32_t calculate_error_check(utils::ByteSpan data);
     
     // Fragment acknowledgment methods
     Result<void> wait_for_ack(uint32_t transmission_id, uint16_t fragment_index);
     Result<void> send_ack(const FragmentAck& ack);
     Result<FragmentAck> receive_ack();
+    Result<void> send_selective_ack(const SelectiveAck& sack);
+    Result<void> send_nack(const SelectiveAck& nack);
+    Result<AckFrame> receive_ack_frame();  // Answers any NACKs it reads on the way; requires send_mutex_
+    Result<AckFrame> poll_ack_frame();
+    SelectiveAck build_selective_ack(uint32_t transmission_id, ReassemblyContext& context);
+    Result<void> acknowledge_fragment(uint32_t transmission_id, ReassemblyContext& context, bool immediate);
+    void flush_selective_acks();
+    void flush_multicast_nacks();
     
     // Retransmission methods
     Result<void> handle_retransmission(uint32_t transmission_id, uint16_t fragment_index);
+    Result<size_t> handle_retransmission(const SelectiveAck& sack);
+    bool acknowledge_in_flight(uint32_t transmission_id, uint16_t fragment_index);
     Result<void> request_retransmission(uint32_t transmission_id, uint16_t fragment_index);
 
     // Helper methods
     void cleanup_expired_contexts();
-    bool is_reassembly_complete(const ReassemblyContext& context) const;
-    std::vector<uint8_t> serialize_header(const FragmentHeader& header);
-    FragmentHeader deserialize_header(const std::vector<uint8_t>& data);
 
     // Class members
     ConnectionManager& connection_manager_;
-    Config config_;
+    std::atomic<TransportProtocol*> transport_{nullptr};
+    std::shared_ptr<TransportProtocol> bound_transport_;  // Set by bind_connection(); guarded by send_mutex_ and receive_mutex_
+    // Published by apply_config() under send_mutex_; every other path reads a pinned snapshot
+    // of it without locking, so receivers never race a reconfiguration
+    utils::ConfigSnapshot<Config> config_;
     std::unique_ptr<IErrorCorrection> error_correction_;
 
     // Additional tracking for retransmission
+    struct InFlightFragment {
+        FragmentHeader header;
+        utils::ByteSpan plaintext;                                   // View into the caller's buffer
+        std::pmr::vector<uint8_t> ciphertext;                        // Only populated when the fragment is encrypted
+        std::chrono::steady_clock::time_point sent_at;               // Time of the most recent (re)transmission
+        std::chrono::steady_clock::time_point first_sent_at;         // Time of the original transmission
+        std::chrono::steady_clock::time_point deadline;              // When to retransmit if still unacknowledged
+        bool retransmitted = false;                                  // Excluded from RTT sampling (Karn's algorithm)
+
+        InFlightFragment() = default;
+        explicit InFlightFragment(std::pmr::memory_resource* resource) : ciphertext(resource) {}
+
+        utils::ByteSpan payload() const {
+            return header.is_encrypted ? utils::ByteSpan(ciphertext) : plaintext;
+        }
+    };
+
+    // Everything a send allocates comes from its arena and is released in one go when it is erased
     struct TransmissionState {
-        std::map<uint16_t, uint32_t> retry_counts;  // fragment_index -> retry count
+        utils::MessageArena arena;
+        std::pmr::map<uint16_t, uint32_t> retry_counts{arena.resource()};       // fragment_index -> retry count
+        std::pmr::map<uint16_t, InFlightFragment> in_flight{arena.resource()};  // fragment_index -> unacknowledged fragment
+        utils::TimerWheel<uint16_t> retry_timers{std::chrono::milliseconds(1), 256,
+                                                 arena.resource()};  // Fires at each in-flight fragment's deadline
+        // Ciphertext buffers of acknowledged fragments, reused by later ones since the arena never frees
+        std::pmr::vector<std::pmr::vector<uint8_t>> spare_ciphertexts{arena.resource()};
         std::chrono::steady_clock::time_point last_attempt;
         bool complete = false;
+        bool suspended = false;           // Stepped aside for a higher priority message
+        size_t acked_while_suspended = 0; // Fragments acknowledged meanwhile, for the sender to count on resuming
     };
     
     std::map<uint32_t, TransmissionState> transmission_states_;
 
+    // Multicast messages kept for repair, oldest first; guarded by send_mutex_
+    struct MulticastMessage {
+        std::vector<uint8_t> data;               // The fragments' plaintext views point into this
+        std::vector<InFlightFragment> fragments;
+        std::chrono::steady_clock::time_point sent_at;
+        size_t bytes = 0;
+    };
+    std::map<uint32_t, MulticastMessage> multicast_history_;
+    size_t multicast_history_bytes_ = 0;
+    void handle_nack(const SelectiveAck& nack);
+    void expire_multicast_history();
+    std::atomic<uint32_t> pending_multicast_contexts_{0};  // Undelivered multicast reassemblies, so receive() knows to wake for NACKs
+    void schedule_retry(TransmissionState& state, InFlightFragment& fragment,
+                        std::chrono::steady_clock::time_point deadline);
+
     // Flow control and congestion avoidance
     struct WindowState {
         uint32_t current_size;
         uint32_t available_credits;
-        std::chrono::steady_clock::time_point last_adjustment;
-        bool in_congestion_avoidance;
-        std::deque<std::chrono::steady_clock::time_point> rtt_samples;
-        std::mutex mutex;
+        utils::ProfiledMutex<> mutex{"transmission.window"};
     };
 
     WindowState window_state_;
-    TransmissionStats stats_;
 
-    void update_rtt(uint32_t transmission_id, const std::chrono::steady_clock::time_point& send_time);
-    void adjust_window_size(bool packet_loss);
-    bool check_congestion();
-    void apply_backoff();
-    void update_stats(const std::vector<uint8_t>& data, bool is_receive);
+    // Statistics are written from the send and receive paths concurrently without locks
+    struct AtomicTransmissionStats {
+        std::atomic<uint64_t> bytes_sent{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> packets_sent{0};
+        std::atomic<uint64_t> packets_received{0};
+        std::atomic<uint64_t> retransmissions{0};
+        std::atomic<double> current_rtt_ms{0};
+        std::atomic<double> avg_rtt_ms{0};
+        std::atomic<double> min_rtt_ms{std::numeric_limits<double>::max()};
+        std::atomic<double> max_rtt_ms{0};
+        std::atomic<uint32_t> current_window_size{0};
+        std::atomic<uint32_t> packet_loss_count{0};
+        std::atomic<uint64_t> fec_recovered_fragments{0};
+        std::atomic<uint64_t> nacks_sent{0};
+        std::atomic<uint64_t> multicast_repairs{0};
+        std::atomic<uint64_t> coalesced_messages{0};
+        std::atomic<uint64_t> bulk_symbols_sent{0};
+        std::atomic<uint64_t> bulk_symbols_received{0};
+        std::atomic<uint32_t> current_fragment_size{0};
+        std::atomic<uint32_t> path_mtu{0};
+        std::atomic<std::chrono::steady_clock::rep> last_update{0};  // steady_clock ticks since epoch
+        utils::LatencyHistogram rtt_us;  // Every RTT sample, for percentiles
+    };
+
+    AtomicTransmissionStats stats_;
+    SecurityStats security_stats_;  // Guarded by security_mutex_
+
+    bool try_acquire_window_space(size_t data_size, bool nothing_in_flight);
+
+    std::chrono::microseconds update_rtt(uint32_t transmission_id,
+                                         const std::chrono::steady_clock::time_point& send_time);
+
+    // Congestion control: the controller decides the window, these feed it and apply its answer
+    std::unique_ptr<ICongestionController> congestion_controller_;
+    CongestionControlConfig make_congestion_config() const;
+    void on_fragment_acked(uint32_t bytes, std::chrono::microseconds rtt);
+    void on_fragment_lost(uint32_t bytes);
+    void apply_congestion_window();
+    void update_stats(utils::ByteSpan data, bool is_receive);
+
+    // Pacing: a token bucket at the controller's rate gates new pipelined fragments.
+    // The bucket and the smoothed RTT behind its rate are guarded by window_state_.mutex
+    TokenBucketPacer pacer_;
+    double pacing_srtt_us_ = 0;
+    std::atomic<uint64_t> pacing_rate_{0};
+    // Kernel pacing state, touched by the send path only
+    TransportProtocol* kernel_pacing_transport_ = nullptr;
+    uint64_t kernel_pacing_rate_ = 0;      // Last rate handed to that transport
+    bool kernel_pacing_failed_ = false;    // It refused, so it is not asked again
+    void update_pacing_rate();
+    std::chrono::steady_clock::duration pacing_delay(size_t bytes);
+    void apply_kernel_pacing(TransportProtocol* transport);
+    void update_stats(size_t bytes, bool is_receive);
+
+    // Adaptive fragment sizing
+    static constexpr uint32_t IP_UDP_OVERHEAD = 28;  // IPv4 + UDP headers
+    uint32_t fragment_size_ceiling() const;
+    void adapt_fragment_size();
+
+    std::atomic<uint32_t> fragment_size_{0};  // 0 until the first send picks a starting size
+    std::atomic<uint32_t> path_mtu_{0};
+    uint64_t sizing_packets_mark_ = 0;        // stats_ counters at the last sizing decision
+    uint64_t sizing_retransmissions_mark_ = 0;
+
+    // FEC for sends: config_.fec, or the level adaptive protection chose from it.
+    // Changed only between messages under send_mutex_
+    FecConfig fec_;
+    std::atomic<ProtectionLevel> protection_level_{ProtectionLevel::CHECKSUM_ONLY};
+    std::atomic<uint8_t> fec_parity_fragments_{0};  // fec_.parity_fragments, or 0 with FEC off, for get_stats()
+    std::atomic<uint64_t> protection_changes_{0};
+    uint8_t protection_depth_ = 2;            // Heavy FEC parity per group
+    uint32_t protection_quiet_intervals_ = 0;
+    uint64_t protection_packets_mark_ = 0;    // stats_ counters at the last protection decision
+    uint64_t protection_retransmissions_mark_ = 0;
+    uint32_t loss_run_ = 0;                   // Consecutive fragments lost, ending at the last one
+    uint32_t longest_loss_run_ = 0;           // Since the last protection decision
+    uint32_t last_lost_transmission_ = 0;
+    uint16_t last_lost_fragment_ = 0;
+    static ProtectionLevel protection_level_of(const FecConfig& fec);
+    void set_protection(ProtectionLevel level);
+    void adapt_protection();
+    void note_fragment_loss(uint32_t transmission_id, uint16_t fragment_index);
 
     RetryCallback retry_callback_;
-    RetryStats retry_stats_;
-    std::mutex retry_stats_mutex_;
+    MessageCompleteCallback message_complete_callback_;
+
+    // Reactor-driven receive. Posted steps hold it too, so they can tell it has stopped
+    struct AsyncReceiver {
+        std::recursive_mutex mutex;  // Held through each step, so stopping waits one out
+        bool active = true;          // Until it is, owner is alive
+        TransmissionManager* owner = nullptr;
+        EventReactor* reactor = nullptr;
+        int fd = -1;
+        EventReactor::TimerId nack_timer = 0;
+        AsyncReceiveHandler handler;
+        std::thread poller;                 // Low-latency mode: spins on fd in place of the reactor
+        std::atomic<bool> polling{false};
+    };
+    static constexpr uint32_t ASYNC_RECEIVE_TIMEOUT_MS = 1;  // Readiness was reported, so this never really waits
+    static void run_async_receive(const std::shared_ptr<AsyncReceiver>& receiver);
+    static void run_async_poller(const std::shared_ptr<AsyncReceiver>& receiver, int cpu,
+                                 std::chrono::microseconds spin);
+    static void release_poller(AsyncReceiver& receiver);
+    static constexpr uint32_t ASYNC_POLLER_PARK_MS = 10;  // How soon a parked poller notices it was stopped
+    // From apply_connection_config(); read without a lock on the send and receive paths
+    std::atomic<bool> low_latency_{false};
+    std::atomic<int> io_thread_cpu_{-1};
+    std::atomic<uint32_t> spin_before_park_us_{0};
+    std::mutex async_mutex_;
+    std::shared_ptr<AsyncReceiver> async_receiver_;
+    std::atomic<bool> async_receiving_{false};  // Senders then leave the socket to the reactor and take acks from the inbox
+    // Updated from the send path and read by get_retry_stats() without a lock
+    struct AtomicRetryStats {
+        std::atomic<uint64_t> total_retries{0};
+        std::atomic<uint64_t> successful_retries{0};
+        std::atomic<uint64_t> failed_retries{0};
+        std::atomic<uint64_t> max_retries_reached{0};
+        std::atomic<std::chrono::steady_clock::rep> last_retry{0};  // steady_clock ticks since epoch
+        utils::LatencyHistogram attempts;    // Attempt number of every retry event
+        utils::LatencyHistogram latency_us;  // First transmission to acknowledgment of a retried fragment
+    };
+    AtomicRetryStats retry_stats_;
 
     // Enhanced retry handling methods
     void notify_retry_event(RetryEventType type, uint32_t transmission_id, 
@@ -338,12 +1279,142 @@ private:
     Result<std::vector<uint8_t>> decrypt_data(const std::vector<uint8_t>& data);
     void update_security_stats();
     bool verify_security_requirements();
+    std::shared_ptr<AeadRecordLayer> record_layer() const;
+
+    // Record layer nonces: fragments use their header's identity, frames a per-direction counter,
+    // and the top bit keeps the two spaces apart
+    static uint64_t record_sequence(const FragmentHeader& header);
+    static std::array<uint8_t, 19> record_aad(const FragmentHeader& header);
+    static constexpr uint64_t FRAME_SEQUENCE_BIT = uint64_t(1) << 63;
 
     // Security-related private members
     std::shared_ptr<SecureContext> secure_context_;
+    std::shared_ptr<AeadRecordLayer> record_layer_;  // Guarded by security_mutex_
     bool is_secure_channel_established_ = false;
     mutable std::mutex security_mutex_;
-    mutable std::mutex mutex_;
+
+    // Locking: send_mutex_ serializes senders and guards transmission_states_ and the
+    // adaptive sizing marks; receive_mutex_ serializes reading frames off the connection,
+    // after which receivers only contend on their reassembly shard; window_state_.mutex
+    // guards credits and the congestion controller. Never take send_mutex_ or
+    // receive_mutex_ while holding window_state_.mutex.
+    utils::ProfiledMutex<> send_mutex_{"transmission.send"};
+    utils::ProfiledMutex<> receive_mutex_{"transmission.receive"};
+    std::mutex pending_config_mutex_;         // Guards pending_config_ only; never held while taking another lock
+    std::unique_ptr<Config> pending_config_;  // set_config() during a send, applied at the next boundary
+    uint32_t transport_timeout_ms_ = 0;      // Receive timeout last applied to transport_; guarded by receive_mutex_
+
+    // Acknowledgments and fragments share the transport. Each is told apart by size
+    // (every ack frame is shorter than a fragment header), and whichever reader
+    // pulls the other kind off the transport parks it here for its owner
+    std::mutex inbox_mutex_;                          // Guards both inboxes; taken after receive_mutex_
+    std::deque<AckFrame> ack_inbox_;
+    std::deque<utils::PooledBuffer> fragment_inbox_;
+    std::deque<std::vector<uint8_t>> coalesced_inbox_;  // Unpacked batch messages not yet returned; guarded by inbox_mutex_
+    static constexpr size_t MAX_FRAGMENT_DATAGRAM = 65536;  // Largest datagram, so bigger peer fragments are never truncated
+    static bool is_ack_frame(utils::ByteSpan datagram);
+    static AckFrame parse_ack_frame(utils::ByteSpan datagram);
+    uint64_t framed_messages_received_ = 0;  // Frame sequence numbers; guarded by receive_mutex_
+    uint64_t framed_messages_sent_ = 0;      // Guarded by send_mutex_
+
+    // Coalescing of small sends; see CoalescingConfig. All but the inbox are guarded by send_mutex_
+    static constexpr size_t BATCH_LENGTH_SIZE = 4;  // Little-endian length before each batched message
+    Result<void> coalesce_locked(utils::ByteSpan data, bool wait);
+    Result<void> flush_coalesced_locked();
+    void run_coalesce_deadline();  // Runs on the shared TaskScheduler
+    size_t coalesce_batch_limit() const;
+    Result<std::vector<uint8_t>> unpack_batch(uint32_t message_id, const std::vector<uint8_t>& batch);
+    bool take_coalesced(std::vector<uint8_t>& message);
+    std::vector<uint8_t> coalesce_batch_;
+    uint32_t coalesce_count_ = 0;
+    std::chrono::steady_clock::time_point coalesce_deadline_;
+    std::optional<utils::Error> coalesce_error_;  // A deadline flush's failure, for the next send() or flush()
+    utils::TaskScheduler::TaskId coalesce_task_ = utils::TaskScheduler::INVALID_TASK;
+    uint8_t message_flags_ = 0;  // fec_flags added to every fragment of the message being sent
+
+    // Stream compression; see StreamCompressionConfig. The compressing half is used under send_mutex_
+    Result<void> send_message_locked(utils::ByteSpan data);  // send_locked() once the message is final
+    Result<std::vector<uint8_t>> complete_message(uint32_t message_id, std::vector<uint8_t> message,
+                                                  bool compressed, bool batch);
+    Result<void> send_compression_resync(uint32_t epoch);
+    void handle_compression_resync(const SelectiveAck& resync);  // Thread-safe; called wherever acks are read
+    core::CompressionContext stream_compression_;
+
+    // Admission control; see AdmissionConfig. Charges go to both budgets together
+    bool admit(size_t bytes);
+    void release_admission(size_t bytes);
+    Result<void> admit_send(size_t bytes, bool wait);
+    Result<void> send_admitted_locked(utils::ByteSpan data, bool wait, MessagePriority priority);
+    void notify_backpressure(bool engaged, bool process_wide, size_t buffered_bytes);
+    utils::MemoryBudget peer_budget_;
+    utils::MemoryBudget& process_budget_;
+    utils::MemoryBudget::CallbackId peer_watermark_callback_ = 0;
+    utils::MemoryBudget::CallbackId process_watermark_callback_ = 0;
+    std::mutex backpressure_mutex_;  // Guards backpressure_callback_
+    BackpressureCallback backpressure_callback_;
+    std::atomic<uint64_t> admission_refusals_{0};
+
+    // Duplicate and replay filtering; see ReplayConfig. The window is guarded by replay_mutex_,
+    // which is taken after a reassembly shard's mutex
+    enum class Arrival { NEW, DUPLICATE, REPLAYED };
+    Arrival classify_arrival(const FragmentHeader& header, bool replay_protected);
+    struct ReplayWindow {
+        bool started = false;          // Whether anything was delivered yet
+        uint32_t highest = 0;          // Highest transmission ID delivered
+        std::vector<uint64_t> bitmap;  // Bit i: highest - i was delivered
+        bool delivered(uint32_t transmission_id) const;
+        void mark(uint32_t transmission_id, uint32_t window_size);
+    };
+    std::mutex replay_mutex_;
+    ReplayWindow replay_window_;
+    std::atomic<uint64_t> duplicates_dropped_{0};
+    std::atomic<uint64_t> replays_dropped_{0};
+    size_t coalesce_charged_ = 0;  // Admitted bytes of the pending batch; guarded by send_mutex_
+
+    // Send scheduling; see SendOptions. Queued sends wait in ticket order for send_mutex_; the
+    // head of the queue takes it, and a lower priority holder steps aside at a fragment boundary
+    struct SendTicket {
+        MessagePriority priority;
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t sequence;
+        bool operator<(const SendTicket& other) const {
+            if (priority != other.priority) return priority > other.priority;
+            if (deadline != other.deadline) return deadline < other.deadline;
+            return sequence < other.sequence;
+        }
+    };
+    Result<void> wait_send_turn(std::unique_lock<utils::ProfiledMutex<>>& lock, SendTicket& ticket, ExpiryPolicy on_expiry,
+                                bool started);
+    void refresh_waiting_priority();  // Requires schedule_mutex_
+    void yield_send_turn(TransmissionState& state);  // Requires send_mutex_, which it releases and retakes
+    std::mutex schedule_mutex_;  // Guards send_queue_; taken before send_mutex_ is tried, never while waiting for it
+    std::condition_variable schedule_cv_;
+    std::set<SendTicket> send_queue_;
+    std::atomic<int> waiting_priority_{-1};  // Priority at the head of send_queue_, -1 when empty
+    std::atomic<uint64_t> next_ticket_{0};
+    // The scheduled send holding send_mutex_, if any, and its ticket; both guarded by send_mutex_
+    std::unique_lock<utils::ProfiledMutex<>>* send_turn_lock_ = nullptr;
+    SendTicket send_ticket_{MessagePriority::NORMAL, std::chrono::steady_clock::time_point::max(), 0};
+    uint32_t suspended_sends_ = 0;  // Configuration waits until none is suspended; guarded by send_mutex_
+    std::atomic<uint64_t> preemptions_{0};
+    std::atomic<uint64_t> deadline_drops_{0};
+
+    // Fountain-coded bulk transfers; see BulkTransferConfig
+    struct BulkReception {
+        std::unique_ptr<FountainDecoder> decoder;
+        size_t charged = 0;  // Admitted bytes
+        std::chrono::steady_clock::time_point last_symbol;
+    };
+    Result<void> send_bulk_complete(uint32_t transmission_id);
+    void expire_bulk_receptions(std::chrono::steady_clock::time_point now);  // Requires bulk_mutex_
+    std::mutex bulk_mutex_;  // Guards the receptions and completions below; taken after receive_mutex_
+    std::unordered_map<uint32_t, BulkReception> bulk_receptions_;
+    // Transfers this manager decoded, with when it last reported each, so late symbols are answered
+    std::unordered_map<uint32_t, std::chrono::steady_clock::time_point> bulk_completed_;
+    std::deque<std::pair<uint32_t, uint64_t>> bulk_completions_;  // Transfer and receiver token reported; guarded by inbox_mutex_
+    const uint64_t bulk_receiver_token_;  // Tells this manager's completions from other receivers'
+
+    utils::MetricsRegistration metrics_registration_;  // Last, so it is removed before anything it reads
 };
 
 } // namespace core
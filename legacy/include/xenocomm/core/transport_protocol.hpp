@@ -6,6 +6,10 @@
 #include <vector>
 #include <functional>
 #include <chrono>
+#include "xenocomm/core/event_reactor.hpp"
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/byte_span.hpp"
+#include "xenocomm/utils/mapped_file.hpp"
 
 namespace xenocomm {
 namespace core {
@@ -70,6 +74,12 @@ struct ConnectionConfig {
      */
     uint32_t connectionTimeoutMs = 5000;
 
+    /**
+     * @brief How long a connection attempt runs alone before the next resolved
+     * address is tried alongside it (RFC 8305 Connection Attempt Delay).
+     */
+    uint32_t connectAttemptDelayMs = 250;
+
     /**
      * @brief Local port to bind to (optional, 0 means system-assigned).
      */
@@ -99,6 +109,29 @@ struct ConnectionConfig {
      * @brief Interval for health checks in milliseconds.
      */
     uint32_t healthCheckIntervalMs = 5000;
+
+    /**
+     * @brief Let ConnectionManager carry a connection to a peer on this host
+     * over shared memory instead of the transport it was given. Both ends must
+     * set it; if the peer never attaches within connectionTimeoutMs, the given
+     * transport is used after all.
+     */
+    bool preferSharedMemory = false;
+
+    /**
+     * @brief Trade CPU for receive latency on this connection.
+     *
+     * The socket busy-polls its device queue (SO_BUSY_POLL) for busyPollUs,
+     * each blocking receive spins for spinBeforeParkUs before it sleeps, and
+     * a TransmissionManager bound to the connection sends without batching
+     * delays and runs its async receive on a spinning thread of its own,
+     * pinned to ioThreadCpu unless that is -1. Meant for a few hot channels;
+     * every such receiver keeps a core busy.
+     */
+    bool lowLatency = false;
+    uint32_t busyPollUs = 50;
+    uint32_t spinBeforeParkUs = 50;
+    int ioThreadCpu = -1;
 };
 
 /**
@@ -109,7 +142,12 @@ struct ConnectionConfig {
  */
 class TransportProtocol {
 public:
-    virtual ~TransportProtocol() = default;
+    /**
+     * @brief Callback for reactor readiness, receiving EventReactor::EventFlags.
+     */
+    using ReadinessCallback = std::function<void(uint32_t events)>;
+
+    virtual ~TransportProtocol() { detachReactor(); }
 
     /**
      * @brief Connect to a remote endpoint.
@@ -145,6 +183,140 @@ public:
      */
     virtual ssize_t send(const uint8_t* data, size_t size) = 0;
 
+    /**
+     * @brief Send several buffers as a single message (gather write).
+     * 
+     * Lets callers emit a header and a payload that live in different buffers
+     * without first concatenating them. The default implementation coalesces
+     * into a temporary buffer; socket transports override it with
+     * writev/sendmsg so the payload is never copied in user space.
+     * 
+     * @param buffers Array of buffer views to send in order.
+     * @param count Number of entries in buffers.
+     * @return Total number of bytes sent, or -1 on error.
+     */
+    virtual ssize_t sendv(const utils::ByteSpan* buffers, size_t count) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            total += buffers[i].size();
+        }
+        std::vector<uint8_t> coalesced;
+        coalesced.reserve(total);
+        for (size_t i = 0; i < count; ++i) {
+            coalesced.insert(coalesced.end(), buffers[i].begin(), buffers[i].end());
+        }
+        return send(coalesced.data(), coalesced.size());
+    }
+
+    /**
+     * @brief Send several independent messages in one call.
+     *
+     * Datagram transports send one datagram per entry and amortise the
+     * syscall across the batch. The default implementation sends them one by
+     * one and stops at the first failure.
+     *
+     * @param messages Array of messages to send in order.
+     * @param count Number of entries in messages.
+     * @return Number of messages sent (a prefix of the batch), or -1 if none were.
+     */
+    virtual ssize_t sendBatch(const utils::ByteSpan* messages, size_t count) {
+        size_t sent = 0;
+        while (sent < count && send(messages[sent].data(), messages[sent].size()) >= 0) {
+            ++sent;
+        }
+        return sent == 0 && count > 0 ? -1 : static_cast<ssize_t>(sent);
+    }
+
+    /**
+     * @brief Whether bytes arrive reliably and in order, as over TCP.
+     *
+     * Layers above can then skip their own fragmentation, acknowledgments and
+     * checksums and exchange whole messages with sendFrame()/receiveFrame().
+     */
+    virtual bool isReliableStream() const { return false; }
+
+    /**
+     * @brief Send parts, concatenated, as one message that receiveFrame() returns whole.
+     *
+     * Datagram transports already keep message boundaries, so the default is
+     * sendv(). Stream transports add a length prefix.
+     *
+     * @return Number of payload bytes sent, or -1 on error.
+     */
+    virtual ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) {
+        return sendv(parts, count);
+    }
+
+    /**
+     * @brief Send header followed by size bytes of a file as one frame.
+     *
+     * The peer's receiveFrame() returns header and file contents together,
+     * exactly as if both had been passed to sendFrame(). fd must be a regular
+     * file; its file position is left alone. The default maps the region and
+     * sends it with sendFrame(), so the file is never read into a buffer;
+     * stream transports hand it to the kernel with sendfile(2) instead.
+     *
+     * @return Number of payload bytes sent (header and file), or -1 on error.
+     */
+    virtual ssize_t sendFileFrame(utils::ByteSpan header, int fd, int64_t offset, size_t size) {
+        utils::MappedRegion region(fd, offset, size);
+        if (!region.valid()) {
+            return -1;
+        }
+        const utils::ByteSpan parts[] = {header, region.span()};
+        return sendFrame(parts, 2);
+    }
+
+    /**
+     * @brief Send several messages, each received whole by one receiveFrame().
+     *
+     * The default sends them one by one with sendFrame(); stream transports
+     * coalesce the batch into as few writes as the kernel allows.
+     *
+     * @return Total payload bytes sent, or -1 if any message failed.
+     */
+    virtual ssize_t sendFrames(const utils::ByteSpan* frames, size_t count) {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (sendFrame(&frames[i], 1) < 0) {
+                return -1;
+            }
+            total += frames[i].size();
+        }
+        return static_cast<ssize_t>(total);
+    }
+
+    /**
+     * @brief Receive one message sent with sendFrame().
+     *
+     * The default reads a single datagram of up to 64 KB.
+     *
+     * @return Size of the message now held in frame, or -1 on error.
+     */
+    virtual ssize_t receiveFrame(utils::PooledBuffer& frame) {
+        return receiveBuffer(frame, 65536);
+    }
+
+    /**
+     * @brief Receive up to maxSize bytes into a buffer from the shared BufferPool.
+     *
+     * The handle can be passed on, sliced and kept without copying the data.
+     * On success buffer holds exactly the bytes received; otherwise it is
+     * released.
+     *
+     * @return Number of bytes received, or the receive() result on failure.
+     */
+    virtual ssize_t receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) {
+        buffer = utils::BufferPool::shared().acquire(maxSize);
+        ssize_t received = receive(buffer.data(), maxSize);
+        if (received > 0) {
+            buffer.resize(static_cast<size_t>(received));
+        } else {
+            buffer.reset();
+        }
+        return received;
+    }
+
     /**
      * @brief Receive data from the connected endpoint.
      * 
@@ -235,6 +407,27 @@ public:
      */
     virtual bool setSendBufferSize(size_t size) = 0;
 
+    /**
+     * @brief Get the path MTU towards the connected peer.
+     * 
+     * Lets upper layers size datagrams so they are not fragmented by IP.
+     * 
+     * @return Path MTU in bytes including IP headers, or 0 if unknown.
+     */
+    virtual uint32_t getPathMtu() const { return 0; }
+
+    /**
+     * @brief Ask the kernel to pace outgoing packets at a rate.
+     * 
+     * Where the socket supports it (SO_MAX_PACING_RATE on Linux, honoured by
+     * the fq qdisc and by TCP's own pacing) the kernel spreads packets out
+     * instead of sending them back to back.
+     * 
+     * @param bytesPerSecond Pacing rate, or 0 to remove the limit
+     * @return true if the kernel accepted the rate, false if unsupported
+     */
+    virtual bool setPacingRate(uint64_t bytesPerSecond) { (void)bytesPerSecond; return false; }
+
     /**
      * @brief Get the last error message.
      * 
@@ -303,12 +496,61 @@ public:
      */
     virtual bool checkHealth() = 0;
 
+    /**
+     * @brief Register the connected socket with an event reactor.
+     * 
+     * Switches the socket to non-blocking mode. After that, send() and
+     * receive() never wait: they report TransportError::WOULD_BLOCK (TCP
+     * receive() returns 0), and callback runs on a reactor thread once the
+     * socket becomes ready again. The registration ends when the socket is
+     * closed, so it must be renewed after a reconnect.
+     * 
+     * @param reactor Reactor to register with
+     * @param events EventReactor::READABLE and/or EventReactor::WRITABLE interest
+     * @param callback Invoked with the ready events; must not block
+     * @return true if registered, false if not connected or already attached
+     */
+    virtual bool attachReactor(EventReactor& reactor, uint32_t events, ReadinessCallback callback) {
+        int fd = getSocketFd();
+        if (reactor_ || fd < 0 || !callback || !setNonBlocking(true)) {
+            return false;
+        }
+        if (!reactor.add(fd, events, [callback = std::move(callback)](int, uint32_t ready) { callback(ready); })) {
+            return false;
+        }
+        reactor_ = &reactor;
+        reactorFd_ = fd;
+        return true;
+    }
+
+    /**
+     * @brief Change the readiness interest, e.g. add WRITABLE after a send reported WOULD_BLOCK.
+     */
+    virtual bool setReactorInterest(uint32_t events) {
+        return reactor_ && reactor_->modify(reactorFd_, events);
+    }
+
+    /**
+     * @brief Unregister from the reactor. Once this returns the callback is not running.
+     */
+    virtual void detachReactor() {
+        if (reactor_) {
+            reactor_->remove(reactorFd_);
+            reactor_ = nullptr;
+            reactorFd_ = -1;
+        }
+    }
+
 protected:
     TransportProtocol() = default;
     TransportProtocol(const TransportProtocol&) = delete;
     TransportProtocol& operator=(const TransportProtocol&) = delete;
     TransportProtocol(TransportProtocol&&) = delete;
     TransportProtocol& operator=(TransportProtocol&&) = delete;
+
+    // Reactor registration; implementations call detachReactor() before closing their socket
+    EventReactor* reactor_ = nullptr;
+    int reactorFd_ = -1;
 };
 
 } // namespace core
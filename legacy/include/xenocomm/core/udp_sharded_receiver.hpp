@@ -0,0 +1,101 @@
+#ifndef XENOCOMM_CORE_UDP_SHARDED_RECEIVER_HPP
+#define XENOCOMM_CORE_UDP_SHARDED_RECEIVER_HPP
+
+#include "xenocomm/core/udp_transport.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief A UDP listener spread over several SO_REUSEPORT sockets, one receive thread each
+ *
+ * One socket with one receive loop caps inbound processing at a core. Here
+ * every shard owns a UDPTransport bound to the same port and a thread that
+ * drains it with receiveBatch() into its own DatagramRing, so the kernel
+ * splits the load before user space sees it. With steering on, a peer's
+ * datagrams always land on the same shard, so per-peer state such as a
+ * TransmissionManager's reassembly can live on that shard with no locking
+ * across shards.
+ *
+ * The handler runs on the shard's thread, one batch at a time per shard
+ * and concurrently across shards. The ring is only valid during the call.
+ * Replies can go out through the shard's transport with sendTo().
+ */
+class UDPShardedReceiver {
+public:
+    struct Config {
+        uint16_t port = 0;           ///< 0 picks a free port, reported by port()
+        size_t shards = 0;           ///< 0 for one per CPU the process may run on
+        bool steerByPeer = true;     ///< Attach a steering program so a peer keeps its shard
+        bool pinThreads = false;     ///< Pin shard i's thread to the i-th allowed CPU
+        size_t ringSlots = 64;
+        size_t slotSize = 2048;
+        std::chrono::milliseconds pollInterval{100};  ///< How soon stop() is noticed by an idle shard
+    };
+
+    using BatchHandler = std::function<void(size_t shard, UDPTransport& transport, const DatagramRing& ring)>;
+
+    explicit UDPShardedReceiver(Config config);
+    UDPShardedReceiver() : UDPShardedReceiver(Config{}) {}
+    ~UDPShardedReceiver();
+
+    UDPShardedReceiver(const UDPShardedReceiver&) = delete;
+    UDPShardedReceiver& operator=(const UDPShardedReceiver&) = delete;
+
+    /**
+     * @brief Binds every shard and starts their receive threads
+     *
+     * @return false if already running or a shard cannot be set up; lastError() says why
+     */
+    bool start(BatchHandler handler);
+
+    /**
+     * @brief Stops the threads and closes the sockets; the handler is not running once this returns
+     */
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    uint16_t port() const { return port_; }
+    size_t shardCount() const { return shards_.size(); }
+
+    /**
+     * @brief Datagrams a shard has handed to the handler
+     */
+    uint64_t datagramsReceived(size_t shard) const;
+
+    std::string lastError() const { return lastError_; }
+
+private:
+    struct Shard {
+        UDPTransport transport;
+        DatagramRing ring;
+        std::thread thread;
+        std::atomic<uint64_t> datagrams{0};
+
+        Shard(size_t slots, size_t slotSize) : ring(slots, slotSize) {}
+    };
+
+    bool openShard(Shard& shard, uint16_t port);
+    void run(size_t index);
+    void closeShards();
+
+    Config config_;
+    BatchHandler handler_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{false};
+    std::string lastError_;
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_UDP_SHARDED_RECEIVER_HPP
@@ -2,6 +2,9 @@
 #define XENOCOMM_CORE_UDP_TRANSPORT_HPP
 
 #include "xenocomm/core/transport_protocol.hpp"
+#include "xenocomm/core/link_health.hpp"
+#include "xenocomm/core/xdp_socket.hpp"
+#include "xenocomm/utils/config_snapshot.hpp"
 #include <string>
 #include <vector>
 #include <mutex>
@@ -28,6 +31,63 @@
 namespace xenocomm {
 namespace core {
 
+/**
+ * @brief Preallocated receive storage for UDPTransport::receiveBatch()
+ *
+ * Holds a fixed number of slots, each large enough for one datagram (or one
+ * GRO-coalesced super-datagram), plus the message headers recvmmsg needs, so
+ * a receive loop allocates nothing per call. After receiveBatch() the ring
+ * exposes one view per logical datagram; views stay valid until the next
+ * receive into the same ring.
+ */
+class DatagramRing {
+public:
+    /**
+     * @param slots Datagrams (or GRO segment trains) received per syscall
+     * @param slotSize Bytes per slot; use at least 65535 with GRO enabled
+     */
+    explicit DatagramRing(size_t slots = 64, size_t slotSize = 2048);
+
+    size_t capacity() const { return slots_; }
+    size_t slotSize() const { return slotSize_; }
+
+    /**
+     * @brief Datagrams held from the last receive
+     */
+    size_t size() const { return datagrams_.size(); }
+    bool empty() const { return datagrams_.empty(); }
+    utils::ByteSpan operator[](size_t index) const { return datagrams_[index]; }
+    const utils::ByteSpan* begin() const { return datagrams_.data(); }
+    const utils::ByteSpan* end() const { return datagrams_.data() + datagrams_.size(); }
+
+    /**
+     * @brief Address the datagram at index came from
+     */
+    const struct sockaddr_in& sender(size_t index) const { return origins_[index]; }
+
+    void clear() {
+        datagrams_.clear();
+        origins_.clear();
+    }
+
+private:
+    friend class UDPTransport;
+
+    uint8_t* slot(size_t index) { return storage_.data() + index * slotSize_; }
+
+    size_t slots_;
+    size_t slotSize_;
+    std::vector<uint8_t> storage_;
+    std::vector<utils::ByteSpan> datagrams_;
+    std::vector<struct sockaddr_in> origins_;  // Sender of each entry in datagrams_
+#if defined(__linux__)
+    std::vector<struct mmsghdr> headers_;
+    std::vector<struct iovec> iov_;
+    std::vector<struct sockaddr_in> senders_;
+    std::vector<uint8_t> control_;
+#endif
+};
+
 /**
  * @brief UDP transport implementation for XenoComm
  * 
@@ -99,6 +159,46 @@ public:
      */
     ssize_t send(const uint8_t* data, size_t size) override;
 
+    /**
+     * @brief Send several buffers as one UDP datagram
+     * 
+     * Uses sendmsg with a gather list so a protocol header and its payload
+     * go out in a single datagram without being concatenated first.
+     * 
+     * @param buffers Array of buffer views making up the datagram
+     * @param count Number of entries in buffers
+     * @return Number of bytes sent if successful, negative value on error
+     */
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override;
+
+    /**
+     * @brief Send one datagram per entry with as few syscalls as possible
+     * 
+     * On Linux the batch goes out through sendmmsg. With GSO enabled, runs
+     * of equally sized datagrams are additionally handed to the kernel as a
+     * single UDP_SEGMENT message and split by the stack or the NIC.
+     * Elsewhere datagrams are sent one at a time.
+     * 
+     * @param datagrams Array of datagram payloads
+     * @param count Number of entries in datagrams
+     * @return Number of datagrams sent (a prefix of the batch), or -1 if none were
+     */
+    ssize_t sendBatch(const utils::ByteSpan* datagrams, size_t count) override;
+
+    /**
+     * @brief Receive up to ring.capacity() datagrams in one syscall
+     * 
+     * Blocks (subject to the receive timeout) until at least one datagram
+     * arrives, then takes whatever else is already queued. GRO-coalesced
+     * datagrams are split back into their original segments, so the ring
+     * may hold more datagrams than it has slots. Datagrams from unexpected
+     * senders or truncated by a small slot are dropped.
+     * 
+     * @param ring Preallocated receive storage; cleared first
+     * @return Number of datagrams now held in ring, or -1 on error
+     */
+    ssize_t receiveBatch(DatagramRing& ring);
+
     /**
      * @brief Receive data from the remote endpoint
      * 
@@ -112,6 +212,36 @@ public:
      */
     ssize_t receive(uint8_t* buffer, size_t size) override;
 
+    /**
+     * @brief Receive one datagram from any sender and report who sent it
+     * 
+     * Unlike receive(), no sender filter is applied, so protocols that
+     * authenticate their datagrams can notice a peer that moved to a new
+     * address.
+     * 
+     * @param[out] address Sender's IPv4 address
+     * @param[out] port Sender's port
+     * @return Bytes received, or -1 on error
+     */
+    ssize_t receiveFrom(uint8_t* buffer, size_t size, std::string& address, uint16_t& port);
+
+    /**
+     * @brief Send one datagram to an address other than the peer's, e.g. a path probe
+     * 
+     * @return Bytes sent, or -1 on error
+     */
+    ssize_t sendTo(const uint8_t* data, size_t size, const std::string& address, uint16_t port);
+
+    /**
+     * @brief Point later sends and the receive() filter at a new peer address
+     * 
+     * Not synchronized with send() running concurrently; callers that
+     * migrate a live connection must serialize the two.
+     * 
+     * @return false if not connected or the address is not a valid IPv4 address
+     */
+    bool setPeerAddress(const std::string& address, uint16_t port);
+
     /**
      * @brief Get the last error message
      * 
@@ -131,6 +261,55 @@ public:
      */
     bool setLocalPort(uint16_t port) override;
 
+    /**
+     * @brief Bind with SO_REUSEPORT so several transports share one local port
+     * 
+     * Must be called before connect(). The kernel spreads inbound datagrams
+     * across every socket bound to the port, by a hash of the 4-tuple unless
+     * a steering program is attached with attachReusePortSteering(). The
+     * socket is bound even with local port 0, so the port it picked can be
+     * read back with getLocalPort() and handed to the others.
+     * 
+     * @return false if connected or SO_REUSEPORT is unsupported
+     */
+    bool setReusePort(bool enable);
+
+    /**
+     * @brief Take datagrams from any sender in receive() and receiveBatch()
+     * 
+     * For a listening socket, whose peers are only learned from what they
+     * send; DatagramRing::sender() says who each datagram came from.
+     */
+    void setAcceptAnySender(bool enable) { acceptAnySender_ = enable; }
+
+    /**
+     * @brief Steer each peer of this socket's SO_REUSEPORT group to a fixed member
+     * 
+     * Attaches a classic BPF program that picks the group member from a
+     * hash of the sender's IPv4 address and port modulo groupSize, so every
+     * fragment a peer sends lands on the same socket regardless of the
+     * order members are added or removed. Members are numbered in the order
+     * they were bound; see reusePortShard() for the mapping. Must be called
+     * after connect() on a transport bound with setReusePort(); it applies
+     * to the whole group. Linux only.
+     * 
+     * @return false if unsupported or the program was refused
+     */
+    bool attachReusePortSteering(uint32_t groupSize);
+
+    /**
+     * @brief Group member attachReusePortSteering() sends a peer to
+     * 
+     * @param address Sender's IPv4 address in network byte order
+     * @param port Sender's port in network byte order
+     */
+    static uint32_t reusePortShard(uint32_t address, uint16_t port, uint32_t groupSize);
+
+    /**
+     * @return Port the socket is bound to, or 0 if it is not bound
+     */
+    uint16_t getLocalPort() const;
+
     /**
      * @brief Join a multicast group
      * 
@@ -166,6 +345,81 @@ public:
      */
     bool setMulticastLoopback(bool enable);
 
+    /**
+     * @brief Enable/disable path MTU discovery
+     * 
+     * When enabled, datagrams are sent with the Don't Fragment bit set and the
+     * socket is bound to the remote endpoint so the kernel tracks the path MTU
+     * reported by ICMP. Sends larger than the path MTU then fail with
+     * MESSAGE_TOO_LARGE instead of being fragmented. Must be called after
+     * connect(). Only supported on Linux.
+     * 
+     * @param enable true to enable discovery, false to let IP fragment again
+     * @return true if successful, false otherwise
+     */
+    bool enablePathMtuDiscovery(bool enable);
+
+    /**
+     * @brief Get the path MTU discovered towards the remote endpoint
+     * 
+     * @return Path MTU in bytes, or 0 if discovery is disabled or unsupported
+     */
+    uint32_t getPathMtu() const override;
+
+    bool setPacingRate(uint64_t bytesPerSecond) override;
+
+    /**
+     * @brief Enable/disable UDP segmentation offload (UDP_SEGMENT) for sendBatch()
+     * 
+     * Must be called after connect(). Only supported on Linux 4.18+; where
+     * the device cannot segment, sends fall back to plain sendmmsg.
+     * 
+     * @param enable true to coalesce equal-size runs into GSO sends
+     * @return true if the setting took effect, false if unsupported
+     */
+    bool enableGso(bool enable);
+
+    /**
+     * @brief Enable/disable UDP receive offload (UDP_GRO) for receiveBatch()
+     * 
+     * Lets the kernel deliver a train of same-flow datagrams as one buffer,
+     * which receiveBatch() splits again. Must be called after connect().
+     * Only supported on Linux 5.0+. Receive rings need 64 KB slots.
+     * 
+     * @param enable true to accept coalesced datagrams
+     * @return true if the setting took effect, false if unsupported
+     */
+    bool enableGro(bool enable);
+
+    /**
+     * @brief Receive through an AF_XDP socket on one NIC queue, bypassing the kernel stack
+     * 
+     * receiveBatch() then takes the port's datagrams from the queue as views
+     * into the socket's UMEM frames, copied by nobody in zero-copy mode, and
+     * still drains the regular socket for whatever the XDP program leaves to
+     * the kernel: traffic on other queues, IP fragments and the like. See
+     * XdpSocket. Must be called after connect(), with a local port bound;
+     * receive() and receiveFrom() keep using the regular socket. Linux only,
+     * and needs root or CAP_NET_ADMIN and CAP_BPF.
+     * 
+     * @param interfaceName Interface the port's traffic arrives on
+     * @param queue Receive queue of that interface to take it from
+     * @return false, leaving the transport on its regular socket, if AF_XDP could not be set up
+     */
+    bool enableXdp(const std::string& interfaceName, uint32_t queue = 0);
+
+    /**
+     * @brief Go back to receiving through the regular socket only
+     */
+    void disableXdp();
+
+    bool xdpActive() const { return xdp_ != nullptr; }
+
+    /**
+     * @brief Whether the AF_XDP socket runs in zero-copy mode
+     */
+    bool xdpZeroCopy() const;
+
     // New methods from TransportProtocol interface
     ConnectionState getState() const override;
     TransportError getLastErrorCode() const override;
@@ -173,8 +427,16 @@ public:
     bool reconnect(uint32_t maxAttempts = 3, uint32_t delayMs = 1000) override;
     void setStateCallback(std::function<void(ConnectionState)> callback) override;
     void setErrorCallback(std::function<void(TransportError, const std::string&)> callback) override;
+    /**
+     * @brief Healthy unless the socket's own traffic says otherwise; peeks only a quiet socket
+     */
     bool checkHealth() override;
 
+    /**
+     * @brief What the socket's traffic has shown of its health
+     */
+    const LinkHealth& linkHealth() const { return linkHealth_; }
+
     // Implementations for missing TransportProtocol pure virtuals
     bool getPeerAddress(std::string& address, uint16_t& port) override;
     int getSocketFd() const override;
@@ -254,6 +516,28 @@ private:
      */
     bool isBroadcastOrMulticast(const in_addr& addr) const;
 
+    /**
+     * @brief Whether a datagram from sender passes the receive() filter
+     */
+    bool acceptsSender(const sockaddr_in& sender) const;
+
+    /**
+     * @brief In low-latency mode, spin on the socket before a blocking receive
+     */
+    void spinBeforePark();
+
+#if defined(__linux__)
+    /**
+     * @brief Append what recvmmsg delivers to ring; 0 if MSG_DONTWAIT found nothing
+     */
+    ssize_t receiveSocketBatch(DatagramRing& ring, int flags);
+
+    /**
+     * @brief receiveBatch() with an AF_XDP socket attached
+     */
+    ssize_t receiveXdpBatch(DatagramRing& ring);
+#endif
+
     /**
      * @brief Convert system error to TransportError
      */
@@ -276,12 +560,20 @@ private:
     void startHealthMonitor();
     void stopHealthMonitor();
     bool performHealthCheck(); // Ensure only one instance of this remains
+    LinkHealthPolicy healthPolicy() const;
 
     std::atomic<bool> connected_{false};
     mutable std::mutex mutex_;
     mutable std::string lastError_; ///< Made mutable for setError in const methods
     uint16_t localPort_{0};
+    bool pathMtuDiscovery_{false};
+    bool reusePort_{false};
+    std::atomic<bool> acceptAnySender_{false};
+    std::atomic<bool> gso_{false};
+    std::atomic<bool> gro_{false};
     std::chrono::milliseconds timeout_{5000}; // Default 5 second timeout
+    std::unique_ptr<XdpSocket> xdp_;
+    std::vector<XdpSocket::Datagram> xdpDatagrams_;  // Scratch for receiveXdpBatch()
 
 #ifdef _WIN32
     SOCKET socket_{INVALID_SOCKET};
@@ -300,11 +592,13 @@ private:
     std::function<void(TransportError, const std::string&)> errorCallback_;
     mutable std::mutex callbackMutex_;
     // Health monitoring members
-    std::unique_ptr<std::thread> healthMonitorThread_;
-    std::atomic<bool> stopHealthMonitor_{false};
+    HeartbeatScheduler::Registration heartbeat_{0}; ///< Watched by the shared heartbeat scheduler
+    mutable LinkHealth linkHealth_; ///< Fed by every send, receive and link error; mutable for setError
+    std::atomic<bool> reconnectPending_{false};
+    std::atomic<bool> nonBlocking_{false};
     std::chrono::steady_clock::time_point lastHealthCheck_;
     // Config and endpoint
-    ConnectionConfig config_;
+    utils::ConfigSnapshot<ConnectionConfig> config_;  ///< Republished by connect(); read without locking
     std::string currentEndpoint_;
 };
 
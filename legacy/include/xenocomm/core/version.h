@@ -1,5 +1,7 @@
 #pragma once
 
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <functional> // Include for std::hash
@@ -14,16 +16,39 @@ namespace core {
  * - Major version changes indicate breaking changes
  * - Minor version changes indicate backward-compatible feature additions
  * - Patch version changes indicate backward-compatible bug fixes
+ *
+ * Comparisons, compatibility checks and hashing all work on packed(), which
+ * places the three components in one integer ordered like the version
+ * itself, so each is a single integer operation rather than a chain of
+ * branches.
  */
 struct Version {
     uint16_t major{0};
     uint16_t minor{0};
     uint16_t patch{0};
 
-    Version() = default;
-    Version(uint16_t maj, uint16_t min, uint16_t pat) 
+    /// Longest toString() result: "65535.65535.65535"
+    static constexpr size_t MAX_STRING_LENGTH = 17;
+
+    constexpr Version() = default;
+    constexpr Version(uint16_t maj, uint16_t min, uint16_t pat)
         : major(maj), minor(min), patch(pat) {}
 
+    /**
+     * @brief The version as major << 32 | minor << 16 | patch; ordered as versions are.
+     */
+    constexpr uint64_t packed() const {
+        return (static_cast<uint64_t>(major) << 32) | (static_cast<uint64_t>(minor) << 16) | patch;
+    }
+
+    /**
+     * @brief The version packed() returned.
+     */
+    static constexpr Version fromPacked(uint64_t packed) {
+        return Version(static_cast<uint16_t>(packed >> 32), static_cast<uint16_t>(packed >> 16),
+                       static_cast<uint16_t>(packed));
+    }
+
     /**
      * @brief Checks if this version is compatible with the required version.
      * 
@@ -35,23 +60,9 @@ struct Version {
      * @param required The version that must be satisfied
      * @return true if this version is compatible with the required version
      */
-    bool isCompatibleWith(const Version& required) const {
-        // Major versions must match for compatibility
-        if (major != required.major) {
-            return false;
-        }
-        
-        // Minor version must be >= required
-        if (minor < required.minor) {
-            return false;
-        }
-        
-        // If minor versions match, patch must be >= required
-        if (minor == required.minor && patch < required.patch) {
-            return false;
-        }
-        
-        return true;
+    constexpr bool isCompatibleWith(const Version& required) const {
+        // Same major, and minor.patch at or above the required one
+        return major == required.major && packed() >= required.packed();
     }
 
     /**
@@ -64,14 +75,9 @@ struct Version {
      * @param required The version that must be satisfied
      * @return true if this version satisfies the required version
      */
-    bool satisfies(const Version& required) const {
-        // If major versions match, use standard compatibility rules
-        if (major == required.major) {
-            return isCompatibleWith(required);
-        }
-        
-        // If our major version is higher, assume we can satisfy lower versions
-        return major > required.major;
+    constexpr bool satisfies(const Version& required) const {
+        // A higher major, or the same major and a compatible minor.patch, is simply a higher packed value
+        return packed() >= required.packed();
     }
 
     /**
@@ -80,7 +86,7 @@ struct Version {
      * @param other The version to compare against
      * @return true if this version is newer
      */
-    bool isNewerThan(const Version& other) const {
+    constexpr bool isNewerThan(const Version& other) const {
         return *this > other;
     }
 
@@ -90,39 +96,33 @@ struct Version {
      * @return A string in the format "major.minor.patch"
      */
     std::string toString() const {
-        return std::to_string(major) + "." + 
-               std::to_string(minor) + "." + 
-               std::to_string(patch);
-    }
-
-    // Standard comparison operators
-    bool operator<(const Version& other) const {
-        if (major != other.major) return major < other.major;
-        if (minor != other.minor) return minor < other.minor;
-        return patch < other.patch;
-    }
-
-    bool operator>(const Version& other) const {
-        return other < *this;
+        char buffer[MAX_STRING_LENGTH];
+        return std::string(buffer, formatTo(buffer));
     }
 
-    bool operator==(const Version& other) const {
-        return major == other.major && 
-               minor == other.minor && 
-               patch == other.patch;
-    }
-
-    bool operator!=(const Version& other) const {
-        return !(*this == other);
-    }
-
-    bool operator<=(const Version& other) const {
-        return !(other < *this);
+    /**
+     * @brief Writes "major.minor.patch" into out without allocating.
+     *
+     * @param out At least MAX_STRING_LENGTH bytes; not NUL-terminated
+     * @return The number of characters written
+     */
+    size_t formatTo(char* out) const {
+        char* const end = out + MAX_STRING_LENGTH;
+        char* next = std::to_chars(out, end, major).ptr;
+        *next++ = '.';
+        next = std::to_chars(next, end, minor).ptr;
+        *next++ = '.';
+        next = std::to_chars(next, end, patch).ptr;
+        return static_cast<size_t>(next - out);
     }
 
-    bool operator>=(const Version& other) const {
-        return !(*this < other);
-    }
+    // Standard comparison operators
+    constexpr bool operator<(const Version& other) const { return packed() < other.packed(); }
+    constexpr bool operator>(const Version& other) const { return packed() > other.packed(); }
+    constexpr bool operator==(const Version& other) const { return packed() == other.packed(); }
+    constexpr bool operator!=(const Version& other) const { return packed() != other.packed(); }
+    constexpr bool operator<=(const Version& other) const { return packed() <= other.packed(); }
+    constexpr bool operator>=(const Version& other) const { return packed() >= other.packed(); }
 };
 
 } // namespace core
@@ -133,14 +133,9 @@ namespace std {
    template <>
    struct hash<xenocomm::core::Version> {
        std::size_t operator()(const xenocomm::core::Version& v) const noexcept {
-           // Combine hashes using a method similar to boost::hash_combine
-           std::size_t seed = 0;
-           std::hash<uint16_t> hasher;
-           // Combine major, minor, and patch hashes
-           seed ^= hasher(v.major) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-           seed ^= hasher(v.minor) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-           seed ^= hasher(v.patch) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-           return seed;
+           // One multiply spreads the packed components across every bit
+           const uint64_t mixed = v.packed() * 0x9e3779b97f4a7c15ULL;
+           return static_cast<std::size_t>(mixed ^ (mixed >> 32));
        }
    };
 } // namespace std
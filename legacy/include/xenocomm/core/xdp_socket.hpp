@@ -0,0 +1,108 @@
+#ifndef XENOCOMM_CORE_XDP_SOCKET_HPP
+#define XENOCOMM_CORE_XDP_SOCKET_HPP
+
+#include "xenocomm/utils/byte_span.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <netinet/in.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+/**
+ * @brief Kernel-bypass receive of one UDP port from one NIC queue over AF_XDP
+ *
+ * An XDP program on the interface redirects IPv4 datagrams for the port
+ * into this socket's UMEM, a region of frames shared with the driver, before
+ * the kernel allocates anything for them. receive() hands out views straight
+ * into those frames; in zero-copy mode the NIC wrote them there by DMA. Each
+ * view stays valid until the next receive(), which returns its frame to the
+ * fill ring.
+ *
+ * Everything else passes to the kernel as before: other ports and
+ * protocols, IP fragments and datagrams carrying IP options, and traffic on
+ * queues no socket is registered for, so the regular socket bound to the
+ * port keeps receiving those. Sockets on other queues of the same interface
+ * share one program, which must filter the same port. UDP checksums are not
+ * verified.
+ *
+ * Talks to the kernel through the raw bpf() and socket calls, so neither
+ * libbpf nor libxdp is needed. Needs CAP_NET_ADMIN and CAP_BPF (or root)
+ * and Linux 5.9+; elsewhere isValid() is false and error() says why.
+ * Not thread-safe: one thread receives.
+ */
+class XdpSocket {
+public:
+    struct Config {
+        std::string interfaceName;
+        uint32_t queue = 0;
+        uint16_t port = 0;           ///< UDP destination port to redirect
+        uint32_t frameCount = 4096;  ///< UMEM frames, a power of two
+        uint32_t frameSize = 2048;   ///< 2048 or 4096 bytes
+        bool zeroCopy = true;        ///< Ask the driver for zero-copy, else copy into UMEM
+    };
+
+    struct Datagram {
+        utils::ByteSpan payload;
+        struct sockaddr_in sender;
+    };
+
+    explicit XdpSocket(const Config& config);
+    ~XdpSocket();
+
+    XdpSocket(const XdpSocket&) = delete;
+    XdpSocket& operator=(const XdpSocket&) = delete;
+
+    bool isValid() const { return fd_ >= 0; }
+    const std::string& error() const { return error_; }
+
+    /**
+     * @brief Whether the driver delivers straight into UMEM rather than copying into it
+     */
+    bool zeroCopy() const { return zeroCopy_; }
+
+    /**
+     * @brief Descriptor to poll() for readability
+     */
+    int fd() const { return fd_; }
+
+    /**
+     * @brief Takes up to max datagrams that have arrived; never blocks
+     *
+     * Frames handed out by the previous call are recycled first.
+     *
+     * @return Datagrams written to out
+     */
+    size_t receive(Datagram* out, size_t max);
+
+private:
+    struct Ring;
+    struct Program;
+
+    bool open();
+    void close();
+
+    Config config_;
+    std::string error_;
+    int fd_ = -1;
+    bool zeroCopy_ = false;
+    uint8_t* umem_ = nullptr;
+    size_t umemSize_ = 0;
+    std::unique_ptr<Ring> fill_;
+    std::unique_ptr<Ring> rx_;
+    std::shared_ptr<Program> program_;
+    std::vector<uint64_t> held_;  // Frames behind the views last handed out
+};
+
+} // namespace core
+} // namespace xenocomm
+
+#endif // XENOCOMM_CORE_XDP_SOCKET_HPP
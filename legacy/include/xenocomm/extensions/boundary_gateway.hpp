@@ -0,0 +1,398 @@
+#pragma once
+
+#include "xenocomm/utils/contention_profile.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xenocomm {
+namespace extensions {
+
+/**
+ * @brief Burst size and sustained rate of one token bucket
+ */
+struct RateLimit {
+    double capacity = 0;         // Tokens the bucket holds when full
+    double refillPerSecond = 0;  // Tokens added back per second; 0 for a fixed budget that never refills
+};
+
+/**
+ * @brief Token bucket that admits requests without locking
+ *
+ * Kept as the time the bucket would be full again (the generic cell rate
+ * algorithm), so the whole state is one 64-bit word: an acquisition is a
+ * clock read and one compare-and-swap, and threads contending on a bucket
+ * retry rather than wait. Starts full.
+ */
+class TokenBucket {
+public:
+    explicit TokenBucket(const RateLimit& limit);
+
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+
+    /**
+     * @brief Takes tokens if the bucket holds that many; takes nothing otherwise.
+     */
+    bool tryAcquire(double tokens = 1);
+
+    /**
+     * @brief Gives back tokens taken by an acquisition that was not used, up to a full bucket.
+     */
+    void refund(double tokens);
+
+    /**
+     * @brief Tokens that could be taken now.
+     */
+    double available() const;
+
+    /**
+     * @brief Applies a new limit; tokens taken so far count against it.
+     */
+    void setLimit(const RateLimit& limit);
+    RateLimit limit() const;
+
+    uint64_t acquired() const { return acquired_.load(std::memory_order_relaxed); }
+    uint64_t denied() const { return denied_.load(std::memory_order_relaxed); }
+
+private:
+    int64_t now() const;
+
+    // One token costs intervalNs_ of bucket time; the bucket holds toleranceNs_ of it
+    std::atomic<double> intervalNs_;
+    std::atomic<double> toleranceNs_;
+    std::atomic<bool> refills_;
+    std::atomic<int64_t> fullAtNs_{0};  // Bucket time at which it is full again; at or before now means full
+    std::atomic<uint64_t> acquired_{0};
+    std::atomic<uint64_t> denied_{0};
+};
+
+/**
+ * @brief Level of GatewayRateLimiter that refused a request
+ */
+enum class RateLimitScope {
+    NONE,    // Admitted
+    AGENT,
+    API,
+    GLOBAL
+};
+
+/**
+ * @brief Limits of each level of a GatewayRateLimiter; an unset level is unlimited
+ */
+struct GatewayRateLimitConfig {
+    std::optional<RateLimit> perAgent;  // Default bucket of each agent
+    std::optional<RateLimit> perApi;    // Default bucket of each API
+    std::optional<RateLimit> global;    // One bucket shared by all traffic
+};
+
+/**
+ * @brief Hierarchical token buckets for gateway traffic: per agent, per API and overall
+ *
+ * A request is admitted only if every level has the tokens; a level that
+ * refuses it returns those already taken from the levels before it. Buckets
+ * are made on an agent's or API's first request and kept for the limiter's
+ * lifetime; finding one takes a shared lock on one of a few shards, and
+ * admission itself is lock-free. Agents and APIs given their own limit keep
+ * it; the rest use the configured default.
+ */
+class GatewayRateLimiter {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Decision {
+        bool allowed = true;
+        RateLimitScope limitedBy = RateLimitScope::NONE;
+    };
+
+    struct Stats {
+        uint64_t admitted = 0;
+        uint64_t deniedByAgent = 0;
+        uint64_t deniedByApi = 0;
+        uint64_t deniedGlobally = 0;
+        size_t agents = 0;
+        size_t apis = 0;
+    };
+
+    explicit GatewayRateLimiter(const GatewayRateLimitConfig& config = GatewayRateLimitConfig());
+
+    GatewayRateLimiter(const GatewayRateLimiter&) = delete;
+    GatewayRateLimiter& operator=(const GatewayRateLimiter&) = delete;
+
+    /**
+     * @brief Takes tokens from the agent's, the API's and the global bucket, or from none.
+     *
+     * An empty agent or API skips that level.
+     */
+    Decision acquire(const std::string& agent, const std::string& api, double tokens = 1);
+
+    void setAgentLimit(const std::string& agent, const RateLimit& limit);
+    void setApiLimit(const std::string& api, const RateLimit& limit);
+
+    /**
+     * @brief Tokens the agent could take now, or nullopt if agents are unlimited.
+     */
+    std::optional<double> agentAvailable(const std::string& agent);
+    std::optional<double> apiAvailable(const std::string& api);
+
+    Stats getStats() const;
+
+private:
+    struct Shard {
+        mutable utils::ProfiledMutex<std::shared_mutex> mutex{"gateway.rate_limiter"};
+        std::unordered_map<std::string, std::unique_ptr<TokenBucket>> buckets;
+    };
+
+    // One level's buckets, keyed by agent or API
+    struct Level {
+        std::optional<RateLimit> defaultLimit;
+        std::array<Shard, SHARD_COUNT> shards;
+
+        // nullptr if the level is unlimited and key has no limit of its own
+        TokenBucket* find(const std::string& key);
+        void set(const std::string& key, const RateLimit& limit);
+        size_t size() const;
+    };
+
+    Level agents_;
+    Level apis_;
+    std::unique_ptr<TokenBucket> global_;
+    std::atomic<uint64_t> admitted_{0};
+    std::atomic<uint64_t> deniedByAgent_{0};
+    std::atomic<uint64_t> deniedByApi_{0};
+    std::atomic<uint64_t> deniedGlobally_{0};
+};
+
+/**
+ * @brief Sharded cache of gateway responses with per-entry time-to-live
+ *
+ * Keys are spread over independently locked shards. Within a shard, entries
+ * that expire are kept in expiry order, so cleanup costs only what has
+ * expired, and entries that never expire are kept apart in the order they
+ * were stored. When a shard is full the entry soonest to expire gives way,
+ * or failing that the oldest lasting one. Value is copied out on every hit.
+ */
+template <typename Value>
+class ResponseCache {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        size_t entries = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;  // Dropped for space before expiring
+        uint64_t expirations = 0;
+    };
+
+    /**
+     * @param maxEntries Entries kept at most, spread evenly over the shards; 0 for no bound
+     * @param defaultTtl Lifetime of entries stored without their own; zero for entries that never expire
+     */
+    explicit ResponseCache(size_t maxEntries = 0, std::chrono::milliseconds defaultTtl = std::chrono::milliseconds(0))
+        : shardCapacity_(maxEntries == 0 ? 0 : (maxEntries + SHARD_COUNT - 1) / SHARD_COUNT), defaultTtl_(defaultTtl) {}
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    /**
+     * @brief The value stored under key if it has not expired; counts a hit or a miss.
+     */
+    std::optional<Value> get(const std::string& key) {
+        const auto now = Clock::now();
+        Shard& shard = shardFor(key);
+        std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        if (found->second.expiring && found->second.entry->expires <= now) {
+            // Everything ahead of it has expired too
+            expireLocked(shard, now);
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return found->second.entry->value;
+    }
+
+    /**
+     * @brief Stores value under key for the default TTL, replacing any earlier entry.
+     */
+    void set(const std::string& key, Value value) { set(key, std::move(value), defaultTtl_); }
+
+    /**
+     * @brief Stores value under key for ttl; a zero ttl never expires.
+     */
+    void set(const std::string& key, Value value, std::chrono::milliseconds ttl) {
+        const auto now = Clock::now();
+        const bool expiring = ttl.count() > 0;
+        const auto expires = expiring ? now + ttl : Clock::time_point::max();
+        Shard& shard = shardFor(key);
+        std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+        expireLocked(shard, now);
+
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            eraseLocked(shard, found);
+        } else if (shardCapacity_ != 0 && shard.index.size() >= shardCapacity_) {
+            evictLocked(shard);
+        }
+        Order& order = expiring ? shard.expiring : shard.lasting;
+        auto position = expiring ? expiryPosition(shard, expires) : order.end();
+        auto entry = order.insert(position, Entry{key, std::move(value), expires});
+        shard.index.emplace(key, Slot{entry, expiring});
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool invalidate(const std::string& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) {
+            return false;
+        }
+        eraseLocked(shard, found);
+        return true;
+    }
+
+    /**
+     * @brief Drops the entries for which matches(key, value) is true.
+     *
+     * @return Number of entries dropped
+     */
+    size_t invalidateIf(const std::function<bool(const std::string&, const Value&)>& matches) {
+        size_t dropped = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+            for (auto it = shard.index.begin(); it != shard.index.end();) {
+                auto next = std::next(it);
+                if (matches(it->first, it->second.entry->value)) {
+                    eraseLocked(shard, it);
+                    ++dropped;
+                }
+                it = next;
+            }
+        }
+        return dropped;
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+            size_.fetch_sub(shard.index.size(), std::memory_order_relaxed);
+            shard.index.clear();
+            shard.expiring.clear();
+            shard.lasting.clear();
+        }
+    }
+
+    /**
+     * @brief Drops every expired entry.
+     *
+     * @return Number of entries dropped
+     */
+    size_t cleanupExpired() {
+        const auto now = Clock::now();
+        size_t expired = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+            expired += expireLocked(shard, now);
+        }
+        return expired;
+    }
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.entries = size_.load(std::memory_order_relaxed);
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.evictions = evictions_.load(std::memory_order_relaxed);
+        stats.expirations = expirations_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        Value value;
+        Clock::time_point expires;
+    };
+    using Order = std::list<Entry>;
+
+    struct Slot {
+        typename Order::iterator entry;
+        bool expiring;  // Which of the shard's lists holds it
+    };
+    using Index = std::unordered_map<std::string, Slot>;
+
+    struct Shard {
+        utils::ProfiledMutex<> mutex{"gateway.response_cache"};
+        Order expiring;  // Soonest to expire first
+        Order lasting;   // Entries that never expire, oldest first
+        Index index;
+    };
+
+    Shard& shardFor(const std::string& key) { return shards_[std::hash<std::string>{}(key) % SHARD_COUNT]; }
+
+    void eraseLocked(Shard& shard, typename Index::iterator found) {
+        (found->second.expiring ? shard.expiring : shard.lasting).erase(found->second.entry);
+        shard.index.erase(found);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void evictLocked(Shard& shard) {
+        Order& order = shard.expiring.empty() ? shard.lasting : shard.expiring;
+        eraseLocked(shard, shard.index.find(order.front().key));
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t expireLocked(Shard& shard, Clock::time_point now) {
+        size_t expired = 0;
+        while (!shard.expiring.empty() && shard.expiring.front().expires <= now) {
+            eraseLocked(shard, shard.index.find(shard.expiring.front().key));
+            ++expired;
+        }
+        if (expired > 0) {
+            expirations_.fetch_add(expired, std::memory_order_relaxed);
+        }
+        return expired;
+    }
+
+    // Searched from the back, where entries stored with the usual TTL belong straight away
+    static typename Order::iterator expiryPosition(Shard& shard, Clock::time_point expires) {
+        auto position = shard.expiring.end();
+        while (position != shard.expiring.begin() && std::prev(position)->expires > expires) {
+            --position;
+        }
+        return position;
+    }
+
+    const size_t shardCapacity_;  // 0 for no bound
+    const std::chrono::milliseconds defaultTtl_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> size_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> expirations_{0};
+};
+
+} // namespace extensions
+} // namespace xenocomm
@@ -0,0 +1,328 @@
+#pragma once
+#include "context.hpp"
+#include "result.hpp"
+#include "strategies/context_synchronization.hpp"
+#include <any>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace common_ground {
+
+/**
+ * @brief Recent strategy results, so an agent pair that reconnects with the
+ *        same parameters is not verified from scratch.
+ *
+ * A result is keyed by the local and remote agent IDs, the strategy ID and a
+ * fingerprint of the context parameters that strategy depends on: all of them
+ * unless setRelevantParameters() narrows it down. Entries expire after the
+ * TTL, the least recently used one is evicted beyond the capacity, and
+ * invalidateStrategy() drops every result of a strategy that was replaced or
+ * reconfigured.
+ *
+ * Parameters are fingerprinted by value for the types the standard strategies
+ * use (strings, arithmetic types, string vectors and maps, ContextData) and any
+ * registered with registerHasher(). A context with a relevant parameter of
+ * another type cannot be fingerprinted and is never cached. Safe to use from
+ * any thread.
+ */
+class AlignmentCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Hasher = std::function<uint64_t(const std::any&)>;
+
+    /**
+     * @param ttl How long a result stays valid; zero disables the cache.
+     * @param capacity Most results kept at once.
+     */
+    explicit AlignmentCache(std::chrono::milliseconds ttl = std::chrono::seconds(30), size_t capacity = 1024)
+        : ttl_(ttl), capacity_(capacity) {
+        registerHasher<bool>([](const bool& v) { return mix(v ? 1 : 2); });
+        registerArithmetic<int>();
+        registerArithmetic<long>();
+        registerArithmetic<long long>();
+        registerArithmetic<unsigned>();
+        registerArithmetic<unsigned long>();
+        registerArithmetic<unsigned long long>();
+        registerArithmetic<float>();
+        registerArithmetic<double>();
+        registerHasher<std::string>([](const std::string& v) { return hashString(v); });
+        registerHasher<const char*>([](const char* const& v) { return hashString(v ? v : ""); });
+        registerHasher<std::vector<std::string>>([](const std::vector<std::string>& v) { return hashStrings(v); });
+        registerHasher<ContextData>([](const ContextData& v) { return hashStrings(v.parameters); });
+        registerHasher<std::map<std::string, std::string>>(
+            [](const std::map<std::string, std::string>& v) { return hashStringMap(v); });
+        registerHasher<std::unordered_map<std::string, std::string>>(
+            [](const std::unordered_map<std::string, std::string>& v) { return hashStringMap(v); });
+    }
+
+    /**
+     * @brief Fingerprints parameters of type T with hash. Register before use.
+     */
+    template <typename T>
+    void registerHasher(std::function<uint64_t(const T&)> hash) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hashers_[std::type_index(typeid(T))] = [hash = std::move(hash)](const std::any& value) {
+            return hash(std::any_cast<const T&>(value));
+        };
+    }
+
+    /**
+     * @brief Keys strategyId's results on these parameters only.
+     */
+    void setRelevantParameters(const std::string& strategyId, std::set<std::string> keys) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        relevant_[strategyId] = std::move(keys);
+        dropLocked(strategyId);  // Entries keyed on the old set would never match again
+    }
+
+    /**
+     * @brief Fingerprint of the parameters strategyId depends on, if every one can be hashed.
+     */
+    std::optional<uint64_t> fingerprint(const std::string& strategyId, const AlignmentContext& context) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto relevant = relevant_.find(strategyId);
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const auto& [key, value] : context.getParameters()) {
+            if (relevant != relevant_.end() && relevant->second.count(key) == 0) {
+                continue;
+            }
+            auto hasher = hashers_.find(std::type_index(value.type()));
+            if (hasher == hashers_.end()) {
+                return std::nullopt;
+            }
+            hash = combine(hash, hashString(key));
+            hash = combine(hash, hasher->second(value));
+        }
+        return hash;
+    }
+
+    /**
+     * @brief The cached result of strategyId for this context, unless missing or expired.
+     */
+    std::optional<AlignmentResult> find(const std::string& strategyId, const AlignmentContext& context) {
+        if (!enabled()) {
+            return std::nullopt;
+        }
+        auto print = fingerprint(strategyId, context);
+        if (!print) {
+            return std::nullopt;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto strategy = strategies_.find(strategyId);
+        if (strategy == strategies_.end()) {
+            ++misses_;
+            return std::nullopt;
+        }
+        auto entry = strategy->second.find(Key{context.getLocalAgentId(), context.getRemoteAgentId(), *print});
+        if (entry == strategy->second.end()) {
+            ++misses_;
+            return std::nullopt;
+        }
+        if (entry->second.expires <= Clock::now()) {
+            lru_.erase(entry->second.lru);
+            strategy->second.erase(entry);
+            ++misses_;
+            return std::nullopt;
+        }
+        lru_.splice(lru_.begin(), lru_, entry->second.lru);
+        ++hits_;
+        return entry->second.result;
+    }
+
+    /**
+     * @brief Caches result of strategyId for this context, unless it cannot be fingerprinted.
+     *
+     * @param since generation() of strategyId when verification started; if
+     *        the strategy was invalidated since, the result is stale and dropped.
+     */
+    void store(const std::string& strategyId, const AlignmentContext& context, const AlignmentResult& result,
+               std::optional<uint64_t> since = std::nullopt) {
+        if (!enabled()) {
+            return;
+        }
+        auto print = fingerprint(strategyId, context);
+        if (!print) {
+            return;
+        }
+        Key key{context.getLocalAgentId(), context.getRemoteAgentId(), *print};
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (since && generationLocked(strategyId) != *since) {
+            return;
+        }
+        auto& entries = strategies_[strategyId];
+        auto entry = entries.find(key);
+        if (entry != entries.end()) {
+            lru_.erase(entry->second.lru);
+            entries.erase(entry);
+        }
+        lru_.push_front(Slot{strategyId, key});
+        entries.emplace(key, Entry{result, Clock::now() + ttl_, lru_.begin()});
+        while (lru_.size() > capacity_) {
+            const Slot& oldest = lru_.back();
+            auto owner = strategies_.find(oldest.strategyId);
+            owner->second.erase(oldest.key);
+            if (owner->second.empty() && owner->first != strategyId) {
+                strategies_.erase(owner);
+            }
+            lru_.pop_back();
+        }
+    }
+
+    /**
+     * @brief Drops every cached result of strategyId.
+     */
+    void invalidateStrategy(const std::string& strategyId) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropLocked(strategyId);
+    }
+
+    /**
+     * @brief Counts invalidations of strategyId, so results computed across one can be told apart.
+     */
+    uint64_t generation(const std::string& strategyId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return generationLocked(strategyId);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [strategyId, entries] : strategies_) {
+            ++generations_[strategyId];
+        }
+        strategies_.clear();
+        lru_.clear();
+    }
+
+    bool enabled() const { return ttl_.count() > 0 && capacity_ > 0; }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lru_.size();
+    }
+    size_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+    size_t misses() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+private:
+    struct Key {
+        std::string localAgent;
+        std::string remoteAgent;
+        uint64_t fingerprint;
+
+        bool operator==(const Key& other) const {
+            return fingerprint == other.fingerprint && localAgent == other.localAgent &&
+                   remoteAgent == other.remoteAgent;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>(combine(combine(key.fingerprint, hashString(key.localAgent)),
+                                               hashString(key.remoteAgent)));
+        }
+    };
+
+    struct Slot {
+        std::string strategyId;
+        Key key;
+    };
+
+    struct Entry {
+        AlignmentResult result;
+        Clock::time_point expires;
+        std::list<Slot>::iterator lru;
+    };
+
+    template <typename T>
+    void registerArithmetic() {
+        registerHasher<T>([](const T& v) { return mix(std::hash<T>{}(v)); });
+    }
+
+    uint64_t generationLocked(const std::string& strategyId) const {
+        auto it = generations_.find(strategyId);
+        return it == generations_.end() ? 0 : it->second;
+    }
+
+    void dropLocked(const std::string& strategyId) {
+        ++generations_[strategyId];
+        auto strategy = strategies_.find(strategyId);
+        if (strategy == strategies_.end()) {
+            return;
+        }
+        for (auto& [key, entry] : strategy->second) {
+            lru_.erase(entry.lru);
+        }
+        strategies_.erase(strategy);
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    static uint64_t combine(uint64_t seed, uint64_t value) {
+        return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+    }
+
+    // FNV-1a, so fingerprints do not depend on the standard library's string hash
+    static uint64_t hashString(const std::string& s) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : s) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    static uint64_t hashStrings(const std::vector<std::string>& strings) {
+        uint64_t hash = mix(strings.size());
+        for (const auto& s : strings) {
+            hash = combine(hash, hashString(s));
+        }
+        return hash;
+    }
+
+    // Order-independent, so unordered maps with the same contents agree
+    template <typename Map>
+    static uint64_t hashStringMap(const Map& map) {
+        uint64_t hash = mix(map.size());
+        for (const auto& [key, value] : map) {
+            hash += combine(hashString(key), hashString(value));
+        }
+        return hash;
+    }
+
+    const std::chrono::milliseconds ttl_;
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::type_index, Hasher> hashers_;
+    std::unordered_map<std::string, std::set<std::string>> relevant_;
+    std::unordered_map<std::string, std::unordered_map<Key, Entry, KeyHash>> strategies_;
+    std::unordered_map<std::string, uint64_t> generations_;
+    std::list<Slot> lru_;  // Most recently used first
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+} // namespace common_ground
+} // namespace xenocomm
@@ -3,15 +3,104 @@
 #include "types.hpp"
 #include <map>
 #include <any>
+#include <cstddef>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace xenocomm {
 namespace common_ground {
 
+/**
+ * @brief Process-wide interning of parameter names into dense slot indices.
+ *
+ * Names are interned once, when a ParameterKey is created; contexts then
+ * resolve their parameters to slots when they are built, so typed lookups do
+ * no string comparisons at all.
+ */
+class ParameterRegistry {
+public:
+    /**
+     * @brief Index of name, assigning the next free one on first use.
+     */
+    static size_t intern(const std::string& name) {
+        State& state = instance();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto [it, inserted] = state.indices.emplace(name, state.indices.size());
+        return it->second;
+    }
+
+    /**
+     * @brief Slot of every interned name in parameters, null where one is absent.
+     */
+    static std::vector<const std::any*> resolve(const std::map<std::string, std::any>& parameters) {
+        State& state = instance();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        std::vector<const std::any*> slots(state.indices.size(), nullptr);
+        for (const auto& [name, value] : parameters) {
+            auto it = state.indices.find(name);
+            if (it != state.indices.end()) {
+                slots[it->second] = &value;
+            }
+        }
+        return slots;
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<std::string, size_t> indices;
+    };
+
+    static State& instance() {
+        static State state;
+        return state;
+    }
+};
+
+/**
+ * @brief Name and value type of a context parameter, interned at construction.
+ *
+ * Define keys once (e.g. as static members of the strategy that reads them)
+ * and look values up with AlignmentContext::get().
+ */
+template <typename T>
+class ParameterKey {
+public:
+    explicit ParameterKey(std::string name)
+        : name_(std::move(name)), index_(ParameterRegistry::intern(name_)) {}
+
+    const std::string& name() const { return name_; }
+    size_t index() const { return index_; }
+
+private:
+    std::string name_;
+    size_t index_;
+};
+
 class AlignmentContext : public IAlignmentContext {
 public:
     AlignmentContext(const AgentInfo& local, const AgentInfo& remote, std::map<std::string, std::any> params)
-        : localAgent_(local), remoteAgent_(remote), parameters_(std::move(params)) {}
+        : localAgent_(local), remoteAgent_(remote), parameters_(std::move(params)),
+          slots_(ParameterRegistry::resolve(parameters_)) {}
+
+    // Slots point into parameters_, so copies resolve their own
+    AlignmentContext(const AlignmentContext& other)
+        : localAgent_(other.localAgent_), remoteAgent_(other.remoteAgent_), parameters_(other.parameters_),
+          slots_(ParameterRegistry::resolve(parameters_)) {}
+    AlignmentContext& operator=(const AlignmentContext& other) {
+        if (this != &other) {
+            localAgent_ = other.localAgent_;
+            remoteAgent_ = other.remoteAgent_;
+            parameters_ = other.parameters_;
+            slots_ = ParameterRegistry::resolve(parameters_);
+        }
+        return *this;
+    }
+    // Map nodes survive a move, and so do the slots pointing at them
+    AlignmentContext(AlignmentContext&&) = default;
+    AlignmentContext& operator=(AlignmentContext&&) = default;
 
     const std::string& getLocalAgentId() const override { return localAgent_.id; }
     const std::string& getRemoteAgentId() const override { return remoteAgent_.id; }
@@ -20,10 +109,39 @@ public:
     const AgentInfo& getLocalAgent() const { return localAgent_; }
     const AgentInfo& getRemoteAgent() const { return remoteAgent_; }
 
+    /**
+     * @brief Value of key, or null if it is absent or holds another type.
+     *
+     * An index lookup for keys interned before this context was built; keys
+     * interned later fall back to a search by name.
+     */
+    template <typename T>
+    const T* get(const ParameterKey<T>& key) const {
+        const std::any* value = key.index() < slots_.size() ? slots_[key.index()] : findParameter(key.name());
+        return value ? std::any_cast<T>(value) : nullptr;
+    }
+
+    /**
+     * @brief Whether key is present, whatever its type.
+     */
+    template <typename T>
+    bool has(const ParameterKey<T>& key) const {
+        return (key.index() < slots_.size() ? slots_[key.index()] : findParameter(key.name())) != nullptr;
+    }
+
+    /**
+     * @brief String-keyed lookup for parameters without a key; null if absent.
+     */
+    const std::any* findParameter(const std::string& name) const {
+        auto it = parameters_.find(name);
+        return it != parameters_.end() ? &it->second : nullptr;
+    }
+
 private:
     AgentInfo localAgent_;
     AgentInfo remoteAgent_;
     std::map<std::string, std::any> parameters_;
+    std::vector<const std::any*> slots_;  // By ParameterKey index, into parameters_
 };
 
 } // namespace common_ground
@@ -0,0 +1,82 @@
+/**
+ * @file allocation_tracking.hpp
+ * @brief Opt-in counting of heap allocations per thread, for benchmarks.
+ *
+ * Replacing the global allocation functions is a whole-program decision, so
+ * the library never does it. A test or benchmark binary that wants
+ * StrategyTestHarness and the strategy benchmarks to report allocations per
+ * call expands XENOCOMM_TRACK_ALLOCATIONS() once, at namespace scope, in one of
+ * its own source files.
+ *
+ * @see StrategyTestHarness
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace xenocomm {
+namespace common_ground {
+namespace allocation_tracking {
+
+/**
+ * @brief Whether this program counts allocations.
+ */
+inline std::atomic<bool>& installed() {
+    static std::atomic<bool> flag{false};
+    return flag;
+}
+
+/**
+ * @brief Allocations made by the calling thread so far.
+ */
+inline uint64_t& threadAllocations() {
+    static thread_local uint64_t count = 0;
+    return count;
+}
+
+inline void* countedAllocate(std::size_t size) {
+    ++threadAllocations();
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// Kept out of line so the compiler doesn't pair inlined new-expressions with free()
+__attribute__((noinline)) inline void countedRelease(void* memory) noexcept { std::free(memory); }
+
+} // namespace allocation_tracking
+} // namespace common_ground
+} // namespace xenocomm
+
+/**
+ * @brief Replaces the global operator new and delete with counting versions.
+ *
+ * Aligned and nothrow forms keep their standard definitions, which are not
+ * counted.
+ */
+#define XENOCOMM_TRACK_ALLOCATIONS()                                                                  \
+    void* operator new(std::size_t size) {                                                            \
+        return ::xenocomm::common_ground::allocation_tracking::countedAllocate(size);                 \
+    }                                                                                                 \
+    void* operator new[](std::size_t size) {                                                          \
+        return ::xenocomm::common_ground::allocation_tracking::countedAllocate(size);                 \
+    }                                                                                                 \
+    void operator delete(void* memory) noexcept {                                                     \
+        ::xenocomm::common_ground::allocation_tracking::countedRelease(memory);                       \
+    }                                                                                                 \
+    void operator delete[](void* memory) noexcept {                                                   \
+        ::xenocomm::common_ground::allocation_tracking::countedRelease(memory);                       \
+    }                                                                                                 \
+    void operator delete(void* memory, std::size_t) noexcept {                                        \
+        ::xenocomm::common_ground::allocation_tracking::countedRelease(memory);                       \
+    }                                                                                                 \
+    void operator delete[](void* memory, std::size_t) noexcept {                                      \
+        ::xenocomm::common_ground::allocation_tracking::countedRelease(memory);                       \
+    }                                                                                                 \
+    static const bool xenocomm_allocation_tracking_installed =                                        \
+        (::xenocomm::common_ground::allocation_tracking::installed().store(true), true);
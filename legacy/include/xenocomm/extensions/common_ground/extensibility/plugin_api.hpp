@@ -0,0 +1,80 @@
+/**
+ * @file plugin_api.hpp
+ * @brief The interface a strategy plugin library exports to PluginLoader.
+ *
+ * A plugin is a shared library that exports one C function, named by
+ * XENOCOMM_PLUGIN_ENTRY_SYMBOL, returning a PluginDescriptor. The descriptor
+ * lists the plugin's strategies as plain function pointers, which the loader
+ * resolves once when the library is loaded and calls directly afterwards.
+ *
+ * @code
+ * static AlignmentResult verifyEcho(void*, const AlignmentContext& context) { ... }
+ * static bool echoApplies(void*, const AlignmentContext&) { return true; }
+ * static const PluginStrategyEntry STRATEGIES[] = {{"echo", nullptr, echoApplies, verifyEcho}};
+ * static const PluginDescriptor DESCRIPTOR{PLUGIN_ABI_VERSION, "echo", "1.0", STRATEGIES, 1};
+ * XENOCOMM_DEFINE_PLUGIN(DESCRIPTOR)
+ * @endcode
+ *
+ * @see PluginLoader
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "context.hpp"
+#include "result.hpp"
+
+namespace xenocomm {
+namespace common_ground {
+
+/**
+ * @brief Version of this interface; the loader rejects descriptors built against another.
+ */
+constexpr uint32_t PLUGIN_ABI_VERSION = 1;
+
+/**
+ * @brief One strategy a plugin provides.
+ *
+ * state is passed back to both functions and owned by the plugin. Both may be
+ * called from several threads at once, and until the library is unloaded.
+ */
+struct PluginStrategyEntry {
+    const char* id;
+    void* state;
+    bool (*isApplicable)(void* state, const AlignmentContext& context);
+    AlignmentResult (*verify)(void* state, const AlignmentContext& context);
+};
+
+/**
+ * @brief What a plugin exports: its identity and its strategies.
+ *
+ * Must stay valid until the library is unloaded.
+ */
+struct PluginDescriptor {
+    uint32_t abiVersion;
+    const char* name;
+    const char* version;
+    const PluginStrategyEntry* strategies;
+    size_t strategyCount;
+};
+
+} // namespace common_ground
+} // namespace xenocomm
+
+/**
+ * @brief Name of the C function every plugin exports.
+ */
+#define XENOCOMM_PLUGIN_ENTRY_SYMBOL "xenocomm_plugin_descriptor"
+
+extern "C" {
+typedef const xenocomm::common_ground::PluginDescriptor* (*XenocommPluginEntry)();
+}
+
+/**
+ * @brief Exports descriptor, a PluginDescriptor with static storage, as the plugin entry point.
+ */
+#define XENOCOMM_DEFINE_PLUGIN(descriptor)                                                  \
+    extern "C" __attribute__((visibility("default")))                                      \
+    const ::xenocomm::common_ground::PluginDescriptor* xenocomm_plugin_descriptor() {      \
+        return &(descriptor);                                                              \
+    }
@@ -14,14 +14,29 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include "interfaces.hpp"
+#include "plugin_api.hpp"
 
 namespace xenocomm {
 namespace common_ground {
 
+/**
+ * @brief What is known about a plugin. Name, version and strategies are only
+ *        known once it has been loaded.
+ */
+struct PluginMetadata {
+    std::string id;       // File name without "lib" and extension
+    std::string path;
+    std::string name;
+    std::string version;
+    std::vector<std::string> strategyIds;
+    bool loaded = false;
+};
+
 /**
  * @class PluginLoader
  * @brief Plugin architecture for loading external strategy implementations.
@@ -30,6 +45,18 @@ namespace common_ground {
  * provided by plugins, and retrieve plugin metadata. Loaded strategies can be
  * registered with the framework's registry for use in alignment flows.
  *
+ * Plugins found in the plugin directory are loaded lazily, on first use of one
+ * of their strategies, so constructing the loader only lists the directory.
+ * Each strategy's function pointers are resolved into a dispatch table when its
+ * library loads; a strategy handed out calls through that table, with no
+ * lookup by ID or lock.
+ *
+ * The set of plugins and each plugin's current version are published
+ * RCU-style: readers take a reference to the current version and never block,
+ * while loads, unloads and reloads build a new version and swap it in. A
+ * verification in flight keeps the version it started on, and a library is
+ * closed only once nothing uses it any more.
+ *
  * @see StrategyRegistry
  * @see StrategyBuilder
  * @see StrategyComposer
@@ -38,20 +65,46 @@ class PluginLoader {
 public:
     /**
      * @brief Construct a PluginLoader for a given plugin directory.
+     *
+     * Shared libraries in the directory are registered for lazy loading.
+     *
      * @param pluginDir Directory to search for plugins.
      */
     PluginLoader(const std::string& pluginDir);
+    ~PluginLoader();
+
+    PluginLoader(const PluginLoader&) = delete;
+    PluginLoader& operator=(const PluginLoader&) = delete;
 
     /**
      * @brief Load a plugin from the specified path.
+     *
+     * A relative path that does not exist is looked up in the plugin directory.
+     *
      * @param pluginPath Path to the plugin file.
+     * @throws std::runtime_error if the library cannot be opened or is not a valid plugin.
      */
     void loadPlugin(const std::string& pluginPath);
     /**
      * @brief Unload a plugin by its ID.
+     *
+     * Strategies handed out fail from now on; verifications in flight finish first.
+     *
      * @param pluginId Identifier of the plugin to unload.
      */
     void unloadPlugin(const std::string& pluginId);
+    /**
+     * @brief Load a new version of a plugin from its file and switch to it.
+     *
+     * Strategies handed out move to the new version with their next call.
+     * Install the new file by renaming it over the old one: rewriting the
+     * file in place corrupts the version still mapped.
+     *
+     * @param pluginId Identifier of the plugin to reload.
+     * @throws std::runtime_error if the plugin is unknown or the new version is
+     *         invalid; the old version then stays in use.
+     */
+    void reloadPlugin(const std::string& pluginId);
     /**
      * @brief Check if a plugin is loaded.
      * @param pluginId Identifier of the plugin.
@@ -60,12 +113,12 @@ public:
     bool isPluginLoaded(const std::string& pluginId) const;
 
     /**
-     * @brief Get all strategies provided by loaded plugins.
+     * @brief Get all strategies provided by known plugins, loading them as needed.
      * @return List of shared pointers to plugin strategies.
      */
     std::vector<std::shared_ptr<IAlignmentStrategy>> getPluginStrategies() const;
     /**
-     * @brief Get a specific strategy from a plugin.
+     * @brief Get a specific strategy from a plugin, loading the plugin if needed.
      * @param pluginId Identifier of the plugin.
      * @param strategyId Identifier of the strategy.
      * @return Shared pointer to the requested strategy, or nullptr if not found.
@@ -75,9 +128,10 @@ public:
         const std::string& strategyId) const;
 
     /**
-     * @brief Get metadata for a specific plugin.
+     * @brief Get metadata for a specific plugin, without loading it.
      * @param pluginId Identifier of the plugin.
      * @return PluginMetadata object.
+     * @throws std::runtime_error if the plugin is unknown.
      */
     PluginMetadata getPluginMetadata(const std::string& pluginId) const;
     /**
@@ -86,20 +140,32 @@ public:
      */
     std::vector<PluginMetadata> getLoadedPlugins() const;
 
+    struct LoadedPlugin;  // An open library and its dispatch table
+    struct PluginSlot;    // A plugin and its current version, swapped on reload
+
 private:
+    using PluginMap = std::unordered_map<std::string, std::shared_ptr<PluginSlot>>;
+
     std::string pluginDir_;
-    std::unordered_map<std::string, PluginHandle> loadedPlugins_;
+    std::mutex writeMutex_;                // Serializes loads, unloads and reloads; readers never take it
+    std::shared_ptr<const PluginMap> plugins_;  // Replaced whole; read with std::atomic_load
 
+    std::shared_ptr<PluginSlot> findSlot(const std::string& pluginId) const;
+    void addSlot(std::shared_ptr<PluginSlot> slot);
+    /**
+     * @brief Open and validate the library at path (internal use).
+     * @param slot Plugin the version is for; assigns its new strategies dispatch slots.
+     */
+    std::shared_ptr<LoadedPlugin> openPlugin(PluginSlot& slot, const std::string& path) const;
     /**
-     * @brief Validate a plugin handle (internal use).
-     * @param handle Plugin handle to validate.
+     * @brief Validate a plugin descriptor (internal use).
+     * @param descriptor Descriptor to validate.
      */
-    void validatePlugin(const PluginHandle& handle) const;
+    void validatePlugin(const PluginDescriptor* descriptor, const std::string& path) const;
     /**
-     * @brief Register strategies provided by a plugin (internal use).
-     * @param handle Plugin handle.
+     * @brief The current version of slot, loading it on first use (internal use).
      */
-    void registerPluginStrategies(const PluginHandle& handle);
+    std::shared_ptr<const LoadedPlugin> ensureLoaded(PluginSlot& slot) const;
 };
 
 } // namespace common_ground
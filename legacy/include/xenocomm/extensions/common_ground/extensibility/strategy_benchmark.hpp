@@ -0,0 +1,80 @@
+/**
+ * @file strategy_benchmark.hpp
+ * @brief Registers alignment strategies as Google Benchmark benchmarks.
+ *
+ * This is the Google Benchmark counterpart of StrategyTestHarness::runBenchmark().
+ * It cycles through a corpus of contexts and reports p50/p90/p99 latency, and
+ * allocations per call when the binary expands XENOCOMM_TRACK_ALLOCATIONS().
+ * Plugin authors can run their strategies through the same benchmark binaries as
+ * the built-in ones.
+ *
+ * @code
+ * auto corpus = std::make_shared<const ContextCorpus>(generateCorpus(256, makeContext));
+ * registerStrategyBenchmark("Echo", std::make_shared<EchoStrategy>(), corpus)->ThreadRange(1, 8);
+ * @endcode
+ *
+ * @see StrategyTestHarness
+ */
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "interfaces.hpp"
+#include "context.hpp"
+#include "result.hpp"
+#include "allocation_tracking.hpp"
+#include "testing_harness.hpp"
+#include "xenocomm/utils/latency_histogram.hpp"
+
+namespace xenocomm {
+namespace common_ground {
+
+/**
+ * @brief Registers a benchmark that verifies each context of corpus in turn.
+ *
+ * The strategy is shared by all benchmark threads, so it must be safe to verify
+ * from several at once if the benchmark is given a thread range.
+ * @return The registered benchmark, for setting threads, units and so on.
+ */
+inline benchmark::internal::Benchmark* registerStrategyBenchmark(const std::string& name,
+                                                                 std::shared_ptr<IAlignmentStrategy> strategy,
+                                                                 std::shared_ptr<const ContextCorpus> corpus) {
+    if (!strategy || !corpus || corpus->empty()) {
+        throw std::invalid_argument("Strategy benchmark " + name + " needs a strategy and a non-empty corpus");
+    }
+    auto run = [strategy, corpus](benchmark::State& state) {
+        utils::LatencyHistogram latency;
+        size_t next = static_cast<size_t>(state.thread_index()) * 31;
+        const uint64_t allocationsBefore = allocation_tracking::threadAllocations();
+
+        for (auto _ : state) {
+            const AlignmentContext& context = (*corpus)[next++ % corpus->size()];
+            auto start = std::chrono::steady_clock::now();
+            auto result = strategy->verify(context);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            benchmark::DoNotOptimize(result);
+            latency.record(
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        // Per-thread percentiles, averaged across threads
+        for (double percentile : {50.0, 90.0, 99.0}) {
+            state.counters["p" + std::to_string(static_cast<int>(percentile)) + "_ns"] = benchmark::Counter(
+                static_cast<double>(latency.value_at_percentile(percentile)), benchmark::Counter::kAvgThreads);
+        }
+        if (allocation_tracking::installed().load()) {
+            state.counters["allocs_per_call"] = benchmark::Counter(
+                static_cast<double>(allocation_tracking::threadAllocations() - allocationsBefore),
+                benchmark::Counter::kAvgIterations);
+        }
+    };
+    return benchmark::RegisterBenchmark(name.c_str(), run)->UseRealTime();
+}
+
+} // namespace common_ground
+} // namespace xenocomm
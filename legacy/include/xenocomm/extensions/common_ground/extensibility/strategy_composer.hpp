@@ -14,14 +14,76 @@
  */
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <functional>
+#include <future>
 #include "interfaces.hpp"
+#include "context.hpp"
+#include "result.hpp"
+#include "strategy_executor.hpp"
 
 namespace xenocomm {
+namespace utils {
+class TimerService;
+} // namespace utils
+
 namespace common_ground {
 
+/**
+ * @brief How a composite turns its children's results into one.
+ */
+enum class ResultCombinationStrategy {
+    AllMustAlign,  ///< Aligned only if every child is; settled by the first misalignment
+    AnyAligned,    ///< Aligned if any child is; settled by the first alignment
+    Majority       ///< Aligned if more than half are; settled once either side has a majority
+};
+
+/**
+ * @brief Configuration for StrategyComposer::parallel().
+ */
+struct ParallelExecutionConfig {
+    /** @brief Children verifying at once, the calling thread included; 0 for as many as the executor has workers. */
+    size_t maxConcurrency = 0;
+    /** @brief Finish as soon as this many children agree, and return their verdict. */
+    std::optional<size_t> quorum;
+    /** @brief Combination used when no quorum is set or none is reached. */
+    ResultCombinationStrategy combination = ResultCombinationStrategy::AllMustAlign;
+    /** @brief Pool the children run on; the shared one if null. Must outlive the strategy. */
+    StrategyExecutor* executor = nullptr;
+};
+
+/**
+ * @brief Configuration for StrategyComposer::withRetry().
+ *
+ * Attempt n waits initialBackoff * backoffMultiplier^(n-2), at most maxBackoff,
+ * after a misalignment or an exception.
+ */
+struct RetryConfig {
+    size_t maxAttempts = 3;
+    std::chrono::milliseconds initialBackoff{10};
+    double backoffMultiplier = 2.0;
+    std::chrono::milliseconds maxBackoff{1000};
+    /** @brief Fires the backoff of verifyAsync(); the shared service if null. */
+    utils::TimerService* timers = nullptr;
+    /** @brief Runs the attempts of verifyAsync(); the shared pool if null. */
+    StrategyExecutor* executor = nullptr;
+};
+
+/**
+ * @brief A strategy that can verify without holding a thread while it waits.
+ */
+class IAsyncAlignmentStrategy : public IAlignmentStrategy {
+public:
+    /**
+     * @brief Starts verification and returns at once. The context is copied.
+     */
+    virtual std::future<AlignmentResult> verifyAsync(const AlignmentContext& context) = 0;
+};
+
 /**
  * @class StrategyComposer
  * @brief Provides composition patterns for combining alignment strategies.
@@ -51,6 +113,13 @@ public:
 
     /**
      * @brief Create a parallel composition of strategies.
+     *
+     * Children verify concurrently on the configured executor, at most
+     * config.maxConcurrency at a time. Children not yet started are skipped
+     * once the verdict is settled, by the quorum or by the combination.
+     * Verification may be nested: the calling thread works through the
+     * children too, so it never waits on a free worker.
+     *
      * @param strategies List of strategies to execute in parallel.
      * @param config Parallel execution configuration.
      * @return Composed strategy that runs all in parallel.
@@ -79,6 +148,12 @@ public:
 
     /**
      * @brief Create a retry composition for a strategy.
+     *
+     * The result is an IAsyncAlignmentStrategy. Its verifyAsync() runs each
+     * attempt on the executor and schedules the next on the timer service, so
+     * no thread sleeps through a backoff; verify() retries on the calling
+     * thread and blocks through it.
+     *
      * @param strategy Strategy to retry.
      * @param config Retry configuration.
      * @return Composed strategy that retries on failure.
@@ -87,9 +162,13 @@ public:
         std::shared_ptr<IAlignmentStrategy> strategy,
         RetryConfig config);
 
-private:
     /**
      * @brief Combine multiple AlignmentResult objects using a specified strategy.
+     *
+     * An aligned verdict averages the confidence of the aligned results; a
+     * misaligned one takes the lowest confidence among the misaligned and lists
+     * all their misalignments. No results combine to aligned.
+     *
      * @param results List of results to combine.
      * @param strategy Combination strategy.
      * @return Combined AlignmentResult.
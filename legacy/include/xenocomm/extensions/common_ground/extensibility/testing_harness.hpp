@@ -8,6 +8,11 @@
  * results, and reporting. It can be used to test any strategy registered with the
  * framework's StrategyRegistry.
  *
+ * It also has a benchmark mode, which runs a strategy over a corpus of generated
+ * or recorded contexts and reports latency percentiles, allocations per call and
+ * throughput for each thread count. strategy_benchmark.hpp runs the same
+ * measurement under Google Benchmark.
+ *
  * @see StrategyRegistry
  * @see StrategyBuilder
  * @see StrategyComposer
@@ -15,14 +20,150 @@
  */
 #pragma once
 
+#include <any>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <string>
 #include <vector>
 #include "interfaces.hpp"
+#include "context.hpp"
+#include "result.hpp"
 
 namespace xenocomm {
 namespace common_ground {
 
+/**
+ * @brief Outcome of one test case.
+ */
+struct TestResult {
+    std::string name;
+    bool passed = false;
+    std::string message;                   ///< Why the case failed; empty when it passed
+    std::optional<AlignmentResult> actual; ///< Unset if the strategy threw
+    std::chrono::nanoseconds duration{0};
+};
+
+/**
+ * @brief One context to verify and, optionally, the result it should produce.
+ */
+struct TestCase {
+    std::string name;
+    AlignmentContext context;
+    std::optional<AlignmentResult> expected;
+};
+
+/**
+ * @brief Named collection of test cases run against one strategy.
+ */
+struct TestSuite {
+    std::string name;
+    std::vector<TestCase> cases;
+};
+
+/**
+ * @brief What runTest() verifies: the configured context, with any mock data
+ *        overriding its parameters, and the expected result.
+ */
+struct TestConfig {
+    std::optional<AlignmentContext> context;
+    std::map<std::string, std::any> mockData;
+    std::optional<AlignmentResult> expected;
+};
+
+/**
+ * @brief Contexts a benchmark cycles through.
+ */
+using ContextCorpus = std::vector<AlignmentContext>;
+
+/**
+ * @brief Builds the context at the given index of a generated corpus.
+ */
+using ContextGenerator = std::function<AlignmentContext(size_t index, std::mt19937& rng)>;
+
+/**
+ * @brief Builds a corpus of count contexts; the same seed gives the same corpus.
+ */
+ContextCorpus generateCorpus(size_t count, const ContextGenerator& generator, uint32_t seed = 42);
+
+/**
+ * @brief Wraps a strategy and keeps a copy of every context it verifies, so real
+ *        traffic can be replayed later as a benchmark corpus.
+ */
+class ContextRecorder : public IAlignmentStrategy {
+public:
+    /**
+     * @param strategy Strategy that does the verification.
+     * @param capacity Contexts kept; later ones are not recorded.
+     */
+    explicit ContextRecorder(std::shared_ptr<IAlignmentStrategy> strategy, size_t capacity = 10000);
+
+    std::string getId() const override;
+    bool isApplicable(const AlignmentContext& context) const override;
+    AlignmentResult verify(const AlignmentContext& context) override;
+
+    /**
+     * @brief The contexts recorded so far.
+     */
+    ContextCorpus corpus() const;
+
+private:
+    std::shared_ptr<IAlignmentStrategy> strategy_;
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    ContextCorpus recorded_;
+};
+
+/**
+ * @brief How a benchmark runs.
+ */
+struct BenchmarkConfig {
+    size_t iterations = 10000;        ///< Calls each thread makes, cycling through the corpus
+    size_t warmupIterations = 100;    ///< Calls each thread makes before measuring
+    std::vector<size_t> threadCounts{1};
+};
+
+/**
+ * @brief Measurements for one thread count.
+ */
+struct BenchmarkResult {
+    size_t threads = 0;
+    uint64_t calls = 0;
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p90{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds max{0};
+    double callsPerSecond = 0.0;              ///< Across all threads
+    std::optional<double> allocationsPerCall; ///< Unset unless the program tracks allocations
+};
+
+/**
+ * @brief Limits checkPerformance() holds the strategy to; a zero limit is not checked.
+ */
+struct PerformanceCriteria {
+    std::chrono::nanoseconds maxP99{0};
+    double minCallsPerSecond = 0.0;
+    std::optional<double> maxAllocationsPerCall;
+    BenchmarkConfig benchmark;
+};
+
+/**
+ * @brief Summary of everything the harness has run.
+ */
+struct TestReport {
+    std::string strategyId;
+    size_t passed = 0;
+    size_t failed = 0;
+    std::vector<TestResult> results;
+    std::vector<BenchmarkResult> benchmarks;
+};
+
 /**
  * @class StrategyTestHarness
  * @brief Testing harness for validating custom alignment strategies.
@@ -84,6 +225,21 @@ public:
      */
     void checkPerformance(const PerformanceCriteria& criteria);
 
+    /**
+     * @brief Set the contexts benchmarks cycle through.
+     * @param corpus Generated or recorded contexts; must not be empty.
+     */
+    void withCorpus(ContextCorpus corpus);
+    /**
+     * @brief Benchmark the strategy over the corpus, once per thread count.
+     *
+     * Without a corpus, the configured context is used on its own. Allocations
+     * are only counted in programs that expand XENOCOMM_TRACK_ALLOCATIONS().
+     * @param config Iterations and thread counts to run.
+     * @return One result per thread count, also kept for the report.
+     */
+    std::vector<BenchmarkResult> runBenchmark(const BenchmarkConfig& config = {});
+
     /**
      * @brief Generate a test report.
      * @return TestReport object summarizing the test results.
@@ -98,12 +254,19 @@ public:
 private:
     std::shared_ptr<IAlignmentStrategy> strategy_;
     TestConfig config_;
+    ContextCorpus corpus_;
     std::vector<TestResult> results_;
+    std::vector<BenchmarkResult> benchmarks_;
 
     /**
      * @brief Validate the test configuration (internal use).
      */
     void validateTestConfig() const;
+    /**
+     * @brief Verify one case and compare against its expected result (internal use).
+     */
+    TestResult runCase(const std::string& name, const AlignmentContext& context,
+                       const std::optional<AlignmentResult>& expected);
     /**
      * @brief Record a test result (internal use).
      * @param result TestResult to record.
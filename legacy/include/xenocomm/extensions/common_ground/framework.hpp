@@ -3,6 +3,8 @@
 #include "context.hpp"
 #include "result.hpp"
 #include "types.hpp"
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <future>
 #include <string>
@@ -11,6 +13,10 @@
 #include "strategy_chain.hpp"
 #include "strategy_invoker.hpp"
 #include "strategy_hooks.hpp"
+#include "strategy_executor.hpp"
+#include "xenocomm/utils/awaitable.hpp"
+#include "strategy_scheduler.hpp"
+#include "alignment_cache.hpp"
 #include "strategies/knowledge_verification.hpp"
 #include "strategies/goal_alignment.hpp"
 #include "strategies/terminology_alignment.hpp"
@@ -30,6 +36,9 @@
  *  - StrategyHooks: Pre- and post-invocation hooks for extensibility and monitoring.
  *  - StrategyInvoker: Synchronous and asynchronous invocation of strategies.
  *  - StrategyChain: Chaining and conditional execution of multiple strategies.
+ *  - StrategyExecutor: Bounded work-stealing pool the invoker and chain share.
+ *  - StrategyScheduler: Orders strategies by measured cost and failure likelihood.
+ *  - AlignmentCache: Recent results per agent pair, strategy and parameters.
  *
  *  The method registerStandardStrategies() is the recommended way to enable all
  *  standard alignment strategies in the framework.
@@ -48,6 +57,23 @@ public:
 // Stub FrameworkConfig struct
 struct FrameworkConfig {
     std::string name;
+    /**
+     * @brief Stop verifyAlignment at the first decisive misalignment.
+     */
+    bool shortCircuit = true;
+    /**
+     * @brief A misaligned result scoring at or below this confidence is decisive.
+     */
+    double decisiveConfidence = 0.5;
+    /**
+     * @brief How long a strategy result is reused for the same agent pair and
+     *        parameters; zero disables the cache.
+     */
+    std::chrono::milliseconds resultCacheTtl = std::chrono::seconds(30);
+    /**
+     * @brief Most strategy results cached at once.
+     */
+    size_t resultCacheCapacity = 1024;
     // Add more configuration fields as needed
 };
 
@@ -73,7 +99,16 @@ public:
           registry_(std::make_unique<StrategyRegistry>()),
           hooks_(std::make_shared<StrategyHooks>()),
           invoker_(hooks_),
-          chain_() {}
+          chain_(),
+          scheduler_(std::make_shared<StrategyScheduler>()),
+          cache_(std::make_unique<AlignmentCache>(config.resultCacheTtl, config.resultCacheCapacity)) {
+        // Shared, so the observer stays valid if the framework is moved
+        invoker_.addExecutionObserver(
+            [scheduler = scheduler_](const IAlignmentStrategy& strategy, const AlignmentResult& result,
+                                     std::chrono::microseconds elapsed) {
+                scheduler->recordExecution(strategy.getId(), elapsed, result.isAligned());
+            });
+    }
     ~CommonGroundFramework() = default;
 
     /**
@@ -92,6 +127,7 @@ public:
      */
     void registerStrategy(std::shared_ptr<IAlignmentStrategy> strategy, int priority = 0) {
         registry_->registerStrategy(strategy, priority);
+        cache_->invalidateStrategy(strategy->getId());
     }
     /**
      * @brief Unregister an alignment strategy by ID.
@@ -99,39 +135,127 @@ public:
      */
     void unregisterStrategy(const std::string& strategyId) {
         registry_->unregisterStrategy(strategyId);
+        cache_->invalidateStrategy(strategyId);
     }
 
     /**
-     * @brief Run all applicable strategies for a given context.
+     * @brief Run all applicable strategies for a given context, in parallel.
      * @param context The alignment context.
-     * @return Results from all applicable strategies.
+     * @param cancel Stops strategies that have not started yet once set.
+     * @return Results from all applicable strategies that ran, cheapest expected failure first.
      */
-    std::vector<AlignmentResult> runApplicableStrategies(const AlignmentContext& context) {
-        auto strategies = registry_->getApplicableStrategies(context);
-        return invoker_.invokeBatch(strategies, context);
+    std::vector<AlignmentResult> runApplicableStrategies(const AlignmentContext& context,
+                                                         const CancellationToken& cancel = CancellationToken()) {
+        return runScheduled(context, cancel, nullptr);
     }
 
     /**
      * @brief Verify alignment by running all applicable strategies and aggregating results.
+     *
+     * Strategies start in the scheduler's order. With shortCircuit set, the
+     * first decisive misalignment cancels those not yet started, since the
+     * verdict can no longer change. Results cached for the same agent pair
+     * and parameters are reused without running their strategies again.
      * @param context The alignment context.
-     * @return Aggregated alignment result (currently returns first result or default).
+     * @param cancel Stops strategies that have not started yet once set.
+     * @return Aggregated result; aligned when no strategy applies.
+     */
+    AlignmentResult verifyAlignment(const AlignmentContext& context,
+                                    const CancellationToken& cancel = CancellationToken()) {
+        std::function<bool(const AlignmentResult&)> decisive;
+        if (config_.shortCircuit) {
+            decisive = [threshold = config_.decisiveConfidence](const AlignmentResult& result) {
+                return !result.isAligned() && result.getConfidenceScore() <= threshold;
+            };
+        }
+        return aggregateResults(runScheduled(context, cancel, decisive));
+    }
+
+    /**
+     * @brief Combine per-strategy results into one verdict.
+     *
+     * Aligned only if every result is. The confidence of an aligned verdict is
+     * the mean score; a misaligned one takes the lowest score, since the
+     * weakest check decides it. Misalignments are concatenated in order.
+     */
+    static AlignmentResult aggregateResults(const std::vector<AlignmentResult>& results) {
+        if (results.empty()) return AlignmentResult(true, {}, 1.0);
+        bool aligned = true;
+        double sum = 0.0;
+        double lowest = 1.0;
+        std::vector<std::string> misalignments;
+        for (const auto& result : results) {
+            aligned = aligned && result.isAligned();
+            sum += result.getConfidenceScore();
+            lowest = std::min(lowest, result.getConfidenceScore());
+            const auto& found = result.getMisalignments();
+            misalignments.insert(misalignments.end(), found.begin(), found.end());
+        }
+        return AlignmentResult(aligned, std::move(misalignments), aligned ? sum / results.size() : lowest);
+    }
+
+    /**
+     * @brief Cost and failure estimates that order the strategies.
+     *
+     * Seed it with AlignmentMetrics history through recordExecution().
+     */
+    StrategyScheduler& strategyScheduler() { return *scheduler_; }
+
+    /**
+     * @brief Cached strategy results.
+     *
+     * Re-registering a strategy invalidates its results; a strategy
+     * reconfigured in place needs invalidateStrategy() here.
+     */
+    AlignmentCache& alignmentCache() { return *cache_; }
+
+    /**
+     * @brief Observe every strategy execution, e.g. to forward it to
+     *        AlignmentMetrics::recordStrategyExecution. Add before verifying.
      */
-    AlignmentResult verifyAlignment(const AlignmentContext& context) {
-        auto results = runApplicableStrategies(context);
-        // TODO: Aggregate results (for now, return first or default)
-        if (!results.empty()) return results.front();
-        return AlignmentResult(true, {}, 1.0);
+    void addExecutionObserver(StrategyInvoker::ExecutionObserver observer) {
+        invoker_.addExecutionObserver(std::move(observer));
     }
     /**
-     * @brief Asynchronously verify alignment (stub).
+     * @brief Asynchronously verify alignment on the shared executor.
+     *
+     * The context is copied, so the caller's may go away before the run; the
+     * framework must outlive the future.
      * @param context The alignment context.
      * @return Future for the aggregated alignment result.
      */
     std::future<AlignmentResult> verifyAlignmentAsync(const AlignmentContext& context) {
-        // TODO: Implement async aggregation
-        return std::async(std::launch::async, [this, &context]() {
-            return this->verifyAlignment(context);
+        auto shared = std::make_shared<const AlignmentContext>(context);
+        auto promise = std::make_shared<std::promise<AlignmentResult>>();
+        auto future = promise->get_future();
+        invoker_.executor().submit([this, shared, promise]() {
+            try {
+                promise->set_value(this->verifyAlignment(*shared));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
         });
+        return future;
+    }
+
+    /**
+     * @brief verifyAlignmentAsync() for callers that must not block on the result.
+     *
+     * The continuation, or the coroutine awaiting it, resumes on the executor
+     * worker that verified unless scheduler sends it elsewhere.
+     */
+    utils::Awaitable<AlignmentResult> verifyAlignmentAwaitable(const AlignmentContext& context,
+                                                               utils::ContinuationScheduler scheduler = nullptr) {
+        auto shared = std::make_shared<const AlignmentContext>(context);
+        utils::AwaitableResolver<AlignmentResult> resolver(std::move(scheduler));
+        invoker_.executor().submit([this, shared, resolver]() {
+            try {
+                resolver.resolve(this->verifyAlignment(*shared));
+            } catch (...) {
+                resolver.fail(std::current_exception());
+            }
+        });
+        return resolver.awaitable();
     }
 
     /**
@@ -186,6 +310,47 @@ public:
     }
 
 private:
+    // Applicable strategies in the scheduler's order, served from the cache where possible
+    std::vector<AlignmentResult> runScheduled(const AlignmentContext& context, const CancellationToken& cancel,
+                                              const std::function<bool(const AlignmentResult&)>& stopWhen) {
+        auto strategies = scheduler_->order(registry_->getApplicableStrategies(context));
+        std::vector<std::optional<AlignmentResult>> slots(strategies.size());
+        std::vector<std::shared_ptr<IAlignmentStrategy>> misses;
+        std::vector<size_t> missSlots;
+        std::vector<uint64_t> generations;
+        bool decided = false;
+        for (size_t i = 0; i < strategies.size(); ++i) {
+            const std::string id = strategies[i]->getId();
+            if (auto cached = cache_->find(id, context)) {
+                decided = decided || (stopWhen && stopWhen(*cached));
+                slots[i] = std::move(cached);
+            } else {
+                misses.push_back(strategies[i]);
+                missSlots.push_back(i);
+                generations.push_back(cache_->generation(id));
+            }
+        }
+
+        if (!decided && !misses.empty()) {
+            auto ran = invoker_.invokeEach(misses, context, cancel, stopWhen);
+            for (size_t j = 0; j < ran.size(); ++j) {
+                if (ran[j]) {
+                    cache_->store(misses[j]->getId(), context, *ran[j], generations[j]);
+                    slots[missSlots[j]] = std::move(ran[j]);
+                }
+            }
+        }
+
+        std::vector<AlignmentResult> results;
+        results.reserve(slots.size());
+        for (auto& slot : slots) {
+            if (slot) {
+                results.push_back(std::move(*slot));
+            }
+        }
+        return results;
+    }
+
     /**
      * @brief Thread-safe registry for alignment strategies.
      */
@@ -202,6 +367,14 @@ private:
      * @brief Chain for composing and conditionally executing strategies.
      */
     StrategyChain chain_;
+    /**
+     * @brief Learned strategy costs; shared with the invoker's observer.
+     */
+    std::shared_ptr<StrategyScheduler> scheduler_;
+    /**
+     * @brief Recent strategy results, reused across reconnects.
+     */
+    std::unique_ptr<AlignmentCache> cache_;
     /**
      * @brief Framework configuration.
      */
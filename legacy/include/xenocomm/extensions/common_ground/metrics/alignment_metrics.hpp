@@ -1,6 +1,7 @@
 #ifndef XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_ALIGNMENT_METRICS_HPP
 #define XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_ALIGNMENT_METRICS_HPP
 
+#include <atomic>
 #include <memory>
 #include <chrono>
 #include <vector>
@@ -15,6 +16,7 @@ namespace common_ground {
 namespace metrics {
 
 struct MetricsConfig; // Forward declaration
+class MetricsAggregator; // Forward declaration
 
 // Forward declarations for negotiation integration
 namespace xenocomm { namespace core {
@@ -22,9 +24,25 @@ namespace xenocomm { namespace core {
     enum class NegotiationState;
 }}
 
+/**
+ * @brief Records alignment, strategy and negotiation events and answers rate
+ *        and trend queries from pre-aggregated rollups.
+ *
+ * Recording only pushes a small descriptor onto a lock-free ring. A background
+ * thread drains the rings every MetricsConfig::flushInterval into per-minute
+ * and per-hour rollups, overall and per strategy, and hands the raw metrics of
+ * sampled events to storage. Queries aggregate whatever is still queued first
+ * and resolve ranges to whole minutes: a minute counts when it starts inside
+ * the range. Minute rollups are kept for a day and hour rollups for 90 days.
+ *
+ * Sampling is head-based: whether an event's raw metrics are kept is decided
+ * once per session from MetricsConfig::samplingRate, so a sampled session is
+ * kept whole. Rollups count every event regardless.
+ */
 class AlignmentMetrics {
 public:
     AlignmentMetrics(const MetricsConfig& config);
+    ~AlignmentMetrics();
     // Core metrics collection
     void recordAlignmentAttempt(const AlignmentContext& context, const AlignmentResult& result, const AlignmentMetadata& metadata);
     void recordStrategyExecution(const std::string& strategyId, const ExecutionStats& stats);
@@ -34,8 +52,12 @@ public:
     double getStrategyEffectiveness(const std::string& strategyId, const TimeRange& range = {}) const;
     // Analysis
     AlignmentTrends analyzeTrends(const TimeRange& range = {}) const;
+    // As above with every series downsampled (LTTB) to at most maxPoints, e.g. a chart's width
+    AlignmentTrends analyzeTrends(const TimeRange& range, size_t maxPoints) const;
+    // Metrics recorded after query.since, for refreshing a live view without re-reading its range
+    struct MetricPage getMetricsSince(const struct MetricQuery& query) const;
     StrategyComparison compareStrategies(const std::vector<std::string>& strategyIds) const;
-    // Integration
+    // Integration: pushes each completed minute's rollups to feedbackLoop in one batch
     void syncWithFeedbackLoop(std::shared_ptr<class FeedbackLoop> feedbackLoop);
     // Record a negotiation event for metrics
     void recordNegotiationEvent(const std::string& sessionId,
@@ -45,30 +67,26 @@ public:
                                bool success);
 private:
     MetricsConfig config_;
+    // Time-partitioned and indexed, so range queries read only what they match
     std::unique_ptr<class MetricStorage> storage_;
-    std::shared_ptr<class FeedbackLoop> feedbackLoop_;
+    // Owns the ingestion rings, the rollups and the thread aggregating them; declared
+    // after storage_, which it writes to until it is destroyed
+    std::unique_ptr<MetricsAggregator> aggregator_;
 
-    // In-memory metric storage for fast access
-    std::vector<MetricData> inMemoryMetrics_;
     // Counters for quick success rate calculation
-    size_t totalAlignmentAttempts_ = 0;
-    size_t successfulAlignments_ = 0;
+    std::atomic<size_t> totalAlignmentAttempts_{0};
+    std::atomic<size_t> successfulAlignments_{0};
     // Mutex for thread safety
     mutable std::mutex metricsMutex_;
     // Registered metric categories
     std::set<std::string> registeredCategories_;
-    // Background aggregation thread (future implementation)
-    // std::thread backgroundThread_;
-    // bool stopBackgroundThread_ = false;
 
-    void persistMetrics(const class MetricData& data);
-    void updateFeedbackLoop(const class MetricData& data);
     // Helper for registering metric categories
     void registerMetricCategory(const std::string& category);
     // Helper for generating unique metric IDs
     std::string generateMetricId();
-    // Helper for sampling
-    bool shouldSampleMetric(double samplingRate);
+    // Head-based sampling: the same session always gets the same answer
+    bool shouldSampleMetric(const std::string& sessionId) const;
     // Helper for outcome to string
     std::string outcomeToString(AlignmentOutcome outcome);
 };
@@ -0,0 +1,60 @@
+#ifndef XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_DOWNSAMPLING_HPP
+#define XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_DOWNSAMPLING_HPP
+
+#include <cstddef>
+#include <vector>
+#include "metric_types.hpp"
+
+namespace xenocomm {
+namespace extensions {
+namespace common_ground {
+namespace metrics {
+
+using TimeSeriesPoint = AlignmentTrends::TimeSeriesPoint;
+
+/**
+ * @brief How a series is reduced to display resolution.
+ */
+enum class DownsampleMethod {
+    LTTB,    // Largest-Triangle-Three-Buckets: keeps the shape a line chart draws
+    MIN_MAX  // Lowest and highest point of each bucket: keeps every spike a bar or dot plot draws
+};
+
+/**
+ * @brief Largest-Triangle-Three-Buckets downsampling to at most threshold points.
+ *
+ * Keeps the first and last point and, from each of threshold - 2 equal-count
+ * buckets between them, the point forming the largest triangle with the
+ * point kept before it and the average of the next bucket. series must be in
+ * time order; it is returned unchanged if it already fits, or if threshold
+ * is below 3.
+ */
+std::vector<TimeSeriesPoint> lttb(const std::vector<TimeSeriesPoint>& series, size_t threshold);
+
+/**
+ * @brief The lowest and highest point of each of buckets equal-width time buckets.
+ *
+ * Returns at most 2 * buckets points in time order, one for a bucket whose
+ * extremes coincide; empty buckets contribute none. series must be in time
+ * order; it is returned unchanged if it already fits.
+ */
+std::vector<TimeSeriesPoint> minMaxPerBucket(const std::vector<TimeSeriesPoint>& series, size_t buckets);
+
+/**
+ * @brief Reduces series to about points points with method (MIN_MAX uses points / 2 buckets).
+ */
+std::vector<TimeSeriesPoint> downsample(const std::vector<TimeSeriesPoint>& series, size_t points,
+                                        DownsampleMethod method = DownsampleMethod::LTTB);
+
+/**
+ * @brief Every series of trends reduced with downsample(); 0 points leaves them whole.
+ */
+AlignmentTrends downsample(const AlignmentTrends& trends, size_t points,
+                           DownsampleMethod method = DownsampleMethod::LTTB);
+
+} // namespace metrics
+} // namespace common_ground
+} // namespace extensions
+} // namespace xenocomm
+
+#endif // XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_DOWNSAMPLING_HPP
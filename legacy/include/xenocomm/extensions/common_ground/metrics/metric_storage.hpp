@@ -1,7 +1,11 @@
 #ifndef XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_METRIC_STORAGE_HPP
 #define XENOCOMM_EXTENSIONS_COMMON_GROUND_METRICS_METRIC_STORAGE_HPP
 
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 #include "metric_types.hpp"
@@ -14,12 +18,91 @@ namespace metrics {
 class MetricData; // Forward declaration
 class MetricStorageImpl; // Forward declaration
 
+/**
+ * @brief Which metrics a storage query returns; unset fields match everything.
+ */
+struct MetricQuery {
+    std::optional<std::string> category;
+    std::optional<std::string> strategyId;      // The "strategy_id" label
+    TimeRange range;                            // Inclusive at both ends
+    std::map<std::string, std::string> labels;  // Every one must match
+    size_t limit = 0;                           // Most metrics returned; 0 for all
+    uint64_t since = 0;                         // Only metrics saved after this cursor (see MetricPage)
+
+    /**
+     * @brief Parses a loadMetrics() filter: comma-separated key=value terms.
+     *
+     * "category" and "strategy_id" select the indexed fields; any other key
+     * matches a label. A term without '=' is a category. Empty matches all.
+     */
+    static MetricQuery parse(const std::string& filter);
+};
+
+/**
+ * @brief Metrics saved after a cursor, and the cursor to ask from next time.
+ */
+struct MetricPage {
+    std::vector<MetricData> metrics;  // In the order they were saved
+    uint64_t cursor = 0;              // MetricQuery::since for the next page
+};
+
+/**
+ * @brief Bounded, time-partitioned metric store.
+ *
+ * Metrics are grouped into partitions of MetricsConfig::aggregationInterval by
+ * timestamp, and each partition indexes its metrics by category and strategy
+ * ID. Queries skip partitions outside their time range and read only the
+ * indexed metrics of those inside, so a query over a recent window costs in
+ * proportion to what it matches rather than to the whole history.
+ *
+ * At most MetricsConfig::maxInMemoryEntries metrics are kept in memory; beyond
+ * that the oldest partition is evicted. With enablePersistence it is first
+ * spilled to storageLocation as JSON lines, and queries whose range reaches it
+ * read it back. Spilled partitions found there at construction are queried
+ * too. Safe to use from any thread.
+ */
 class MetricStorage {
 public:
+    /**
+     * @brief In-memory storage with the default bounds and no spilling.
+     */
     MetricStorage();
+    explicit MetricStorage(const MetricsConfig& config);
     ~MetricStorage();
     void saveMetric(const MetricData& data);
+    /**
+     * @brief Metrics matching filter (see MetricQuery::parse), oldest partition first.
+     */
     std::vector<MetricData> loadMetrics(const std::string& filter = "") const;
+    std::vector<MetricData> query(const MetricQuery& query) const;
+    /**
+     * @brief Matches saved after query.since, oldest saved first, for polling a live view.
+     *
+     * Every saved metric gets the next cursor; with persistence enabled the
+     * count carries on across restarts. Partitions with nothing saved after query.since are
+     * skipped whole, so a poll costs what arrived since the last one. When
+     * query.limit cuts the page short, its cursor is that of the last metric
+     * returned and the next page resumes after it; otherwise it is the latest
+     * cursor at the time of the query.
+     */
+    MetricPage page(const MetricQuery& query) const;
+    /**
+     * @brief Calls visit for every match without copying it. visit must not
+     *        call back into the storage.
+     * @return Number of metrics visited
+     */
+    size_t forEach(const MetricQuery& query, const std::function<void(const MetricData&)>& visit) const;
+    /**
+     * @brief Number of metrics held in memory.
+     */
+    size_t size() const;
+    /**
+     * @brief Number of metrics spilled to disk.
+     */
+    size_t spilledCount() const;
+    /**
+     * @brief Removes every metric, including spilled ones.
+     */
     void clear();
 
 private:
@@ -19,7 +19,9 @@ struct MetricsConfig {
     std::chrono::seconds aggregationInterval = std::chrono::seconds(300); // 5 minutes
     size_t maxInMemoryEntries = 10000;
     bool enableRealTimeAnalysis = false;
-    double samplingRate = 1.0; // 1.0 = 100% of events
+    double samplingRate = 1.0; // Share of sessions whose raw metrics are kept; 1.0 = all
+    std::chrono::milliseconds flushInterval = std::chrono::milliseconds(50); // How often recorded events are aggregated
+    size_t ingestQueueCapacity = 4096; // Events buffered per recording shard before a writer aggregates inline
 };
 
 struct TimeRange {
@@ -21,6 +21,10 @@ struct ContextData {
  */
 class ContextSynchronizationStrategy : public BaseAlignmentStrategy {
 public:
+    // Context parameters this strategy reads
+    inline static const ParameterKey<ContextData> LOCAL_CONTEXT{"local_context"};
+    inline static const ParameterKey<ContextData> REMOTE_CONTEXT{"remote_context"};
+
     ContextSynchronizationStrategy()
         : BaseAlignmentStrategy("context_synchronization") {}
 
@@ -34,26 +38,20 @@ public:
 protected:
     AlignmentResult doVerification(const AlignmentContext& context) override {
         // For demonstration, assume context parameters are in parameters as "local_context" and "remote_context" (ContextData)
-        auto params = context.getParameters();
         std::vector<std::string> misalignments;
-        auto itLocal = params.find("local_context");
-        auto itRemote = params.find("remote_context");
-        if (itLocal == params.end() || itRemote == params.end() ||
-            itLocal->second.type() != typeid(ContextData) ||
-            itRemote->second.type() != typeid(ContextData)) {
+        const ContextData* localContext = context.get(LOCAL_CONTEXT);
+        const ContextData* remoteContext = context.get(REMOTE_CONTEXT);
+        if (!localContext || !remoteContext) {
             misalignments.push_back("Missing or invalid context parameters");
             return AlignmentResult(false, misalignments, 0.0);
         }
-        const auto& localContext = std::any_cast<const ContextData&>(itLocal->second);
-        const auto& remoteContext = std::any_cast<const ContextData&>(itRemote->second);
-        bool synced = synchronizeContext(localContext, remoteContext, misalignments);
+        bool synced = synchronizeContext(*localContext, *remoteContext, misalignments);
         double confidence = synced ? 1.0 : 0.0;
         return AlignmentResult(synced, misalignments, confidence);
     }
     
     bool isApplicable(const AlignmentContext& context) const override {
-        auto params = context.getParameters();
-        return params.count("local_context") && params.count("remote_context");
+        return context.has(LOCAL_CONTEXT) && context.has(REMOTE_CONTEXT);
     }
 
 private:
@@ -23,6 +23,10 @@ struct Goal {
  */
 class GoalAlignmentStrategy : public BaseAlignmentStrategy {
 public:
+    // Context parameters this strategy reads
+    inline static const ParameterKey<std::string> REMOTE_GOAL{"remote_goal"};
+    inline static const ParameterKey<std::string> REMOTE_INTENTION{"remote_intention"};
+
     GoalAlignmentStrategy()
         : BaseAlignmentStrategy("goal_alignment") {}
 
@@ -41,26 +45,19 @@ protected:
         std::vector<std::string> misalignments;
         
         // Get remote goals from context (assume they're stored as parameters)
-        auto params = context.getParameters();
-        auto itGoal = params.find("remote_goal");
-        auto itIntention = params.find("remote_intention");
-        
-        bool hasRemoteGoal = (itGoal != params.end() && itGoal->second.type() == typeid(std::string));
-        bool hasRemoteIntention = (itIntention != params.end() && itIntention->second.type() == typeid(std::string));
+        const std::string* remoteGoal = context.get(REMOTE_GOAL);
+        const std::string* remoteIntention = context.get(REMOTE_INTENTION);
         
-        if (!hasRemoteGoal) {
+        if (!remoteGoal) {
             misalignments.push_back("Remote goal not provided");
         }
-        if (!hasRemoteIntention) {
+        if (!remoteIntention) {
             misalignments.push_back("Remote intention not provided");
         }
         
         if (misalignments.empty()) {
-            const auto& remoteGoal = std::any_cast<const std::string&>(itGoal->second);
-            const auto& remoteIntention = std::any_cast<const std::string&>(itIntention->second);
-            
-            bool goalsAligned = validateGoals(localGoal_, remoteGoal, misalignments);
-            bool intentionsAligned = validateIntentions(localIntention_, remoteIntention, misalignments);
+            bool goalsAligned = validateGoals(localGoal_, *remoteGoal, misalignments);
+            bool intentionsAligned = validateIntentions(localIntention_, *remoteIntention, misalignments);
             
             bool aligned = goalsAligned && intentionsAligned;
             double confidence = aligned ? 1.0 : 0.5; // Partial alignment might be enough
@@ -71,9 +68,8 @@ protected:
     }
     
     bool isApplicable(const AlignmentContext& context) const override {
-        auto params = context.getParameters();
         return !localGoal_.empty() && !localIntention_.empty() && 
-               params.count("remote_goal") && params.count("remote_intention");
+               context.has(REMOTE_GOAL) && context.has(REMOTE_INTENTION);
     }
 
 private:
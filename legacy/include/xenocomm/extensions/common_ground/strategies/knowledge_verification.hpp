@@ -22,6 +22,9 @@ struct KnowledgeConcept {
  */
 class KnowledgeVerificationStrategy : public BaseAlignmentStrategy {
 public:
+    // Context parameters this strategy reads
+    inline static const ParameterKey<std::vector<std::string>> AGENT_KNOWLEDGE{"agent_knowledge"};
+
     KnowledgeVerificationStrategy()
         : BaseAlignmentStrategy("knowledge_verification") {}
 
@@ -35,15 +38,13 @@ public:
 protected:
     AlignmentResult doVerification(const AlignmentContext& context) override {
         // For demonstration, assume context parameters are in params as "agent_knowledge"
-        auto params = context.getParameters();
         std::vector<std::string> misalignments;
-        auto it = params.find("agent_knowledge");
-        if (it == params.end() || it->second.type() != typeid(std::vector<std::string>)) {
+        const auto* agentKnowledge = context.get(AGENT_KNOWLEDGE);
+        if (!agentKnowledge) {
             misalignments.push_back("Missing or invalid knowledge parameters");
             return AlignmentResult(false, misalignments, 0.0);
         }
-        const auto& agentKnowledge = std::any_cast<const std::vector<std::string>&>(it->second);
-        bool verified = verifyKnowledge(agentKnowledge, misalignments);
+        bool verified = verifyKnowledge(*agentKnowledge, misalignments);
         double confidence = verified ? 1.0 : 0.5;  // Partial knowledge might still work
         return AlignmentResult(verified, misalignments, confidence);
     }
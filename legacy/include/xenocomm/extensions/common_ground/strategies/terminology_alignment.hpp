@@ -2,6 +2,12 @@
 #include "base_strategy.hpp"
 #include "../context.hpp"
 #include "../result.hpp"
+#include "xenocomm/core/data_transcoder.h"
+#include "xenocomm/utils/vector_similarity.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -16,17 +22,79 @@ struct TermDefinition {
     std::string definition;
 };
 
+/**
+ * @brief Embeddings of term definitions, one row per term.
+ */
+struct TermEmbeddings {
+    size_t dimension = 0;
+    std::unordered_map<std::string, uint32_t> rows;  // Term to its row in values
+    std::vector<float> values;                       // Row-major, dimension floats per row
+
+    /**
+     * @brief Sets the embedding of term to the dimension floats at embedding.
+     */
+    void add(const std::string& term, const float* embedding) {
+        auto [it, inserted] = rows.emplace(term, static_cast<uint32_t>(rows.size()));
+        if (inserted) {
+            values.resize(values.size() + dimension);
+        }
+        std::copy(embedding, embedding + dimension, values.begin() + static_cast<size_t>(it->second) * dimension);
+    }
+
+    /**
+     * @brief Decodes a matrix sent through the transcoder layer, e.g. as
+     *        VECTOR_FLOAT32 or VECTOR_INT8; row i belongs to terms[i].
+     * @throws core::TranscodingError if it does not hold terms.size() rows of dimension floats
+     */
+    static TermEmbeddings decode(const std::vector<std::string>& terms, size_t dimension,
+                                 core::DataTranscoder& transcoder, const std::vector<uint8_t>& encoded,
+                                 core::DataFormat format) {
+        std::vector<uint8_t> decoded = transcoder.decode(encoded, format);
+        if (dimension == 0 || decoded.size() != terms.size() * dimension * sizeof(float)) {
+            throw core::TranscodingError("Term embeddings do not match the term count and dimension");
+        }
+        TermEmbeddings embeddings;
+        embeddings.dimension = dimension;
+        embeddings.values.resize(terms.size() * dimension);
+        std::memcpy(embeddings.values.data(), decoded.data(), decoded.size());
+        embeddings.rows.reserve(terms.size());
+        for (size_t i = 0; i < terms.size(); ++i) {
+            embeddings.rows[terms[i]] = static_cast<uint32_t>(i);
+        }
+        return embeddings;
+    }
+};
+
 /**
  * @class TerminologyAlignmentStrategy
  * @brief Strategy for ensuring shared terminology understanding between agents.
+ *
+ * Without a custom checker, a remote definition that equals the local one
+ * after normalization (case, surrounding and repeated whitespace) scores 1;
+ * local definitions are normalized and hashed once, when added. Other terms
+ * are scored by the cosine similarity of their definition embeddings, when
+ * both sides have them (setLocalEmbeddings() and the REMOTE_TERM_EMBEDDINGS
+ * parameter): all such terms in one batched SIMD pass. Anything else scores 0.
  */
 class TerminologyAlignmentStrategy : public BaseAlignmentStrategy {
 public:
+    // Context parameters this strategy reads
+    inline static const ParameterKey<std::unordered_map<std::string, std::string>> REMOTE_TERMINOLOGY{"remote_terminology"};
+    inline static const ParameterKey<TermEmbeddings> REMOTE_TERM_EMBEDDINGS{"remote_term_embeddings"};
+
     TerminologyAlignmentStrategy()
         : BaseAlignmentStrategy("terminology_alignment") {}
 
     void addCriticalTerm(const std::string& term, const std::string& definition) {
-        criticalTerms_[term] = definition;
+        CriticalTerm entry{term, definition, normalize(definition), 0, NO_ROW};
+        entry.hash = hashOf(entry.normalized);
+        entry.embeddingRow = embeddingRowOf(term);
+        auto [it, inserted] = termIndex_.emplace(term, criticalTerms_.size());
+        if (inserted) {
+            criticalTerms_.push_back(std::move(entry));
+        } else {
+            criticalTerms_[it->second] = std::move(entry);
+        }
     }
     void setTermAlignmentChecker(std::function<double(const std::string&, const std::string&)> checker) {
         termChecker_ = std::move(checker);
@@ -34,54 +102,144 @@ public:
     void setMinimumAlignmentThreshold(double threshold) {
         minimumAlignmentThreshold_ = threshold;
     }
+    /**
+     * @brief Embeddings of the local definitions, keyed by term.
+     */
+    void setLocalEmbeddings(TermEmbeddings embeddings) {
+        localEmbeddings_ = std::move(embeddings);
+        for (auto& term : criticalTerms_) {
+            term.embeddingRow = embeddingRowOf(term.id);
+        }
+    }
 
 protected:
     AlignmentResult doVerification(const AlignmentContext& context) override {
         // For demonstration, assume remote terminology definitions are in context params
-        auto params = context.getParameters();
         std::vector<std::string> misalignments;
-        auto it = params.find("remote_terminology");
-        if (it == params.end() || it->second.type() != typeid(std::unordered_map<std::string, std::string>)) {
+        const auto* remoteTerms = context.get(REMOTE_TERMINOLOGY);
+        if (!remoteTerms) {
             misalignments.push_back("Missing or invalid terminology definitions");
             return AlignmentResult(false, misalignments, 0.0);
         }
-        const auto& remoteTerms = std::any_cast<const std::unordered_map<std::string, std::string>&>(it->second);
-        double overallScore = checkTerminologyAlignment(remoteTerms, misalignments);
+        double overallScore = checkTerminologyAlignment(*remoteTerms, context.get(REMOTE_TERM_EMBEDDINGS), misalignments);
         bool aligned = overallScore >= minimumAlignmentThreshold_;
         return AlignmentResult(aligned, misalignments, overallScore);
     }
     
     bool isApplicable(const AlignmentContext& context) const override {
-        auto params = context.getParameters();
-        return !criticalTerms_.empty() && params.count("remote_terminology") > 0;
+        return !criticalTerms_.empty() && context.has(REMOTE_TERMINOLOGY);
     }
 
 private:
-    std::unordered_map<std::string, std::string> criticalTerms_;
+    static constexpr uint32_t NO_ROW = UINT32_MAX;
+
+    struct CriticalTerm {
+        std::string id;
+        std::string definition;
+        std::string normalized;
+        uint64_t hash;
+        uint32_t embeddingRow;  // Row in localEmbeddings_, or NO_ROW
+    };
+
+    std::vector<CriticalTerm> criticalTerms_;              // In the order they were added
+    std::unordered_map<std::string, size_t> termIndex_;    // Term to its entry in criticalTerms_
     std::function<double(const std::string&, const std::string&)> termChecker_;
     double minimumAlignmentThreshold_ = 0.8;
+    TermEmbeddings localEmbeddings_;
+
+    uint32_t embeddingRowOf(const std::string& term) const {
+        auto it = localEmbeddings_.rows.find(term);
+        return it == localEmbeddings_.rows.end() ? NO_ROW : it->second;
+    }
+
+    // Lower-cased, trimmed, with whitespace runs collapsed to one space
+    static std::string normalize(const std::string& text) {
+        std::string normalized;
+        normalized.reserve(text.size());
+        bool space = false;
+        for (unsigned char c : text) {
+            if (std::isspace(c)) {
+                space = !normalized.empty();
+                continue;
+            }
+            if (space) {
+                normalized.push_back(' ');
+                space = false;
+            }
+            normalized.push_back(static_cast<char>(std::tolower(c)));
+        }
+        return normalized;
+    }
+
+    // FNV-1a
+    static uint64_t hashOf(const std::string& text) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
 
     double checkTerminologyAlignment(
         const std::unordered_map<std::string, std::string>& remoteTerms,
+        const TermEmbeddings* remoteEmbeddings,
         std::vector<std::string>& misalignments) const {
-        
+
+        const bool embeddings = !termChecker_ && remoteEmbeddings && localEmbeddings_.dimension > 0 &&
+                                remoteEmbeddings->dimension == localEmbeddings_.dimension;
+        std::vector<double> similarity(criticalTerms_.size(), 0.0);
+        std::vector<bool> defined(criticalTerms_.size(), false);  // The remote side defines the term
+        std::vector<uint32_t> localRows, remoteRows;
+        std::vector<size_t> embedded;  // Terms scored by embedding, in localRows order
+
+        for (size_t i = 0; i < criticalTerms_.size(); ++i) {
+            const CriticalTerm& term = criticalTerms_[i];
+            auto it = remoteTerms.find(term.id);
+            if (it == remoteTerms.end()) {
+                continue;
+            }
+            defined[i] = true;
+            if (termChecker_) {
+                similarity[i] = termChecker_(term.definition, it->second);
+                continue;
+            }
+            std::string remote = normalize(it->second);
+            if (hashOf(remote) == term.hash && remote == term.normalized) {
+                similarity[i] = 1.0;
+                continue;
+            }
+            if (embeddings && term.embeddingRow != NO_ROW) {
+                auto row = remoteEmbeddings->rows.find(term.id);
+                if (row != remoteEmbeddings->rows.end()) {
+                    localRows.push_back(term.embeddingRow);
+                    remoteRows.push_back(row->second);
+                    embedded.push_back(i);
+                }
+            }
+        }
+
+        if (!embedded.empty()) {
+            std::vector<float> scores(embedded.size());
+            utils::cosineSimilarityRows(localEmbeddings_.values.data(), localRows.data(),
+                                        remoteEmbeddings->values.data(), remoteRows.data(),
+                                        embedded.size(), localEmbeddings_.dimension, scores.data());
+            for (size_t j = 0; j < embedded.size(); ++j) {
+                similarity[embedded[j]] = std::max(0.0, static_cast<double>(scores[j]));
+            }
+        }
+
         int matched = 0;
         int total = criticalTerms_.size();
-        
-        for (const auto& [term, definition] : criticalTerms_) {
-            auto it = remoteTerms.find(term);
-            if (it == remoteTerms.end()) {
+
+        for (size_t i = 0; i < criticalTerms_.size(); ++i) {
+            const std::string& term = criticalTerms_[i].id;
+            if (!defined[i]) {
                 misalignments.push_back("Missing term definition: " + term);
                 continue;
             }
-            
-            double similarity = termChecker_ ? 
-                termChecker_(definition, it->second) : 
-                (definition == it->second ? 1.0 : 0.0);
-                
-            if (similarity < minimumAlignmentThreshold_) {
+            if (similarity[i] < minimumAlignmentThreshold_) {
                 misalignments.push_back("Term definition mismatch for '" + term + "': similarity score " + 
-                                       std::to_string(similarity));
+                                       std::to_string(similarity[i]));
                 continue;
             }
             
@@ -1,5 +1,8 @@
 #pragma once
 #include "interfaces.hpp"
+#include "context.hpp"
+#include "result.hpp"
+#include "strategy_executor.hpp"
 #include <vector>
 #include <memory>
 #include <functional>
@@ -10,7 +13,7 @@ namespace common_ground {
 
 class StrategyChain {
 public:
-    StrategyChain() = default;
+    explicit StrategyChain(StrategyExecutor& executor = StrategyExecutor::shared()) : executor_(&executor) {}
 
     // Add a strategy to the chain
     StrategyChain& add(std::shared_ptr<IAlignmentStrategy> strategy) {
@@ -31,12 +34,20 @@ public:
         return AlignmentResult(true, {}, 1.0);
     }
 
-    // Execute the chain asynchronously (stub)
+    // Execute the chain asynchronously on the executor. The context is
+    // copied for the run; the chain itself must outlive the future.
     std::future<AlignmentResult> executeAsync(const AlignmentContext& context) {
-        // TODO: Implement async execution logic
-        return std::async(std::launch::async, [this, &context]() {
-            return this->execute(context);
+        auto shared = std::make_shared<const AlignmentContext>(context);
+        auto promise = std::make_shared<std::promise<AlignmentResult>>();
+        auto future = promise->get_future();
+        executor_->submit([this, shared, promise]() {
+            try {
+                promise->set_value(this->execute(*shared));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
         });
+        return future;
     }
 
 private:
@@ -45,6 +56,7 @@ private:
         std::function<bool(const AlignmentContext&)> condition;
     };
     std::vector<ChainEntry> chain_;
+    StrategyExecutor* executor_;
 };
 
 } // namespace common_ground
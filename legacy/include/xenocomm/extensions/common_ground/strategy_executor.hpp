@@ -0,0 +1,164 @@
+#pragma once
+#include "xenocomm/utils/work_stealing_executor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace xenocomm {
+namespace common_ground {
+
+/**
+ * @brief Flag a caller shares with the strategy runs it may want to stop early.
+ *
+ * Copies share one flag. Cancelling never interrupts a strategy that is
+ * already verifying; runs check the flag before starting each strategy.
+ */
+class CancellationToken {
+public:
+    CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { cancelled_->store(true); }
+    bool isCancelled() const { return cancelled_->load(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/**
+ * @brief Runs independent strategies in parallel on a work-stealing pool.
+ *
+ * Tasks go to a utils::WorkStealingExecutor: the process-wide one, which
+ * transports and crypto offload share, unless the executor is given threads
+ * of its own. A task a worker submits stays on that worker's deque unless
+ * an idle worker steals it.
+ *
+ * parallelFor() makes the calling thread work through the indices alongside
+ * the workers, so a task that runs a batch of its own never waits for a free
+ * worker and nesting cannot deadlock the pool.
+ *
+ * shared() is the pool the framework, its invoker and its chains use unless
+ * they are given another.
+ */
+class StrategyExecutor {
+public:
+    /**
+     * @param workers Number of threads of its own, which run every task
+     *        still queued before the executor is destroyed; 0 runs on
+     *        utils::WorkStealingExecutor::shared().
+     */
+    explicit StrategyExecutor(size_t workers = 0)
+        : owned_(workers > 0 ? std::make_unique<utils::WorkStealingExecutor>(workers) : nullptr),
+          executor_(owned_ ? owned_.get() : &utils::WorkStealingExecutor::shared()) {}
+
+    StrategyExecutor(const StrategyExecutor&) = delete;
+    StrategyExecutor& operator=(const StrategyExecutor&) = delete;
+
+    /**
+     * @brief Process-wide pool shared by every framework that does not bring its own.
+     */
+    static StrategyExecutor& shared() {
+        static StrategyExecutor executor;
+        return executor;
+    }
+
+    size_t workerCount() const { return executor_->workerCount(); }
+
+    /**
+     * @brief Queues task to run on a worker. Exceptions it throws are discarded.
+     */
+    void submit(std::function<void()> task) { executor_->submit(std::move(task)); }
+
+    /**
+     * @brief Runs body(i) for every i below count, in parallel, before returning.
+     *
+     * Indices are claimed in order by the caller and up to workerCount()
+     * workers, or maxParallelism threads in all if that is lower and nonzero.
+     * Once cancel is set, or a body throws, no further index is started; the
+     * first exception is rethrown here after every started body has returned.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body,
+                     const CancellationToken& cancel = CancellationToken(), size_t maxParallelism = 0) {
+        if (count == 0) {
+            return;
+        }
+        auto batch = std::make_shared<Batch>(count, body, cancel);
+        size_t helpers = std::min(count - 1, workerCount());
+        if (maxParallelism > 0) {
+            helpers = std::min(helpers, maxParallelism - 1);
+        }
+        for (size_t i = 0; i < helpers; ++i) {
+            submit([batch] { batch->participate(); });
+        }
+        batch->participate();
+        {
+            std::unique_lock<std::mutex> lock(batch->mutex);
+            // Helpers that have not started yet find the batch closed
+            batch->closed = true;
+            batch->cv.wait(lock, [&] { return batch->active == 0; });
+        }
+        if (batch->error) {
+            std::rethrow_exception(batch->error);
+        }
+    }
+
+private:
+    struct Batch {
+        Batch(size_t n, const std::function<void(size_t)>& b, const CancellationToken& c)
+            : count(n), body(&b), cancel(c) {}
+
+        void participate() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (closed) {
+                    return;  // body may no longer exist
+                }
+                ++active;
+            }
+            for (;;) {
+                if (cancel.isCancelled()) {
+                    break;
+                }
+                size_t index = next.fetch_add(1);
+                if (index >= count) {
+                    break;
+                }
+                try {
+                    (*body)(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    next.store(count);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --active;
+            }
+            cv.notify_all();
+        }
+
+        const size_t count;
+        const std::function<void(size_t)>* body;
+        CancellationToken cancel;
+        std::atomic<size_t> next{0};  // Next unclaimed index
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t active = 0;            // Threads that may still call body
+        bool closed = false;          // Set once the caller stops claiming; no helper joins after
+        std::exception_ptr error;
+    };
+
+    std::unique_ptr<utils::WorkStealingExecutor> owned_;
+    utils::WorkStealingExecutor* executor_;
+};
+
+} // namespace common_ground
+} // namespace xenocomm
@@ -1,6 +1,12 @@
 #pragma once
 #include "interfaces.hpp"
+#include "context.hpp"
+#include "result.hpp"
+#include "strategy_executor.hpp"
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <vector>
 #include <future>
 #include <functional>
@@ -12,35 +18,95 @@ class StrategyHooks; // Forward declaration
 
 class StrategyInvoker {
 public:
-    StrategyInvoker(std::shared_ptr<StrategyHooks> hooks = nullptr) : hooks_(hooks) {}
+    // Called after every successful verify with its result and how long it took
+    using ExecutionObserver = std::function<void(const IAlignmentStrategy&, const AlignmentResult&, std::chrono::microseconds)>;
+
+    StrategyInvoker(std::shared_ptr<StrategyHooks> hooks = nullptr,
+                    StrategyExecutor& executor = StrategyExecutor::shared())
+        : hooks_(hooks), executor_(&executor) {}
 
     // Synchronous invocation (stub)
     AlignmentResult invoke(std::shared_ptr<IAlignmentStrategy> strategy, const AlignmentContext& context) {
         // TODO: Add pre/post hook logic
-        return strategy->verify(context);
+        if (observers_.empty()) {
+            return strategy->verify(context);
+        }
+        auto start = std::chrono::steady_clock::now();
+        AlignmentResult result = strategy->verify(context);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        for (const auto& observer : observers_) {
+            observer(*strategy, result, elapsed);
+        }
+        return result;
     }
 
-    // Asynchronous invocation (stub)
-    std::future<AlignmentResult> invokeAsync(std::shared_ptr<IAlignmentStrategy> strategy, const AlignmentContext& context) {
-        // TODO: Add async logic and hooks
-        return std::async(std::launch::async, [strategy, &context]() {
-            return strategy->verify(context);
+    // Observers run on whichever thread verified, so they must be thread-safe;
+    // add them before strategies are invoked.
+    void addExecutionObserver(ExecutionObserver observer) {
+        observers_.push_back(std::move(observer));
+    }
+
+    // Asynchronous invocation on the executor. The context is copied, so the
+    // caller's may go away before the strategy runs, but the invoker must
+    // outlive the future; a strategy cancelled before it starts fails the
+    // future with std::runtime_error.
+    std::future<AlignmentResult> invokeAsync(std::shared_ptr<IAlignmentStrategy> strategy, const AlignmentContext& context,
+                                             const CancellationToken& cancel = CancellationToken()) {
+        auto shared = std::make_shared<const AlignmentContext>(context);
+        auto promise = std::make_shared<std::promise<AlignmentResult>>();
+        auto future = promise->get_future();
+        executor_->submit([this, strategy, shared, promise, cancel]() {
+            try {
+                if (cancel.isCancelled()) {
+                    throw std::runtime_error("Strategy " + strategy->getId() + " cancelled");
+                }
+                promise->set_value(invoke(strategy, *shared));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
         });
+        return future;
     }
 
-    // Batch invocation (stub)
-    std::vector<AlignmentResult> invokeBatch(const std::vector<std::shared_ptr<IAlignmentStrategy>>& strategies, const AlignmentContext& context) {
+    // Batch invocation: the strategies are independent, so they verify in
+    // parallel on the executor, started in the order given. Results keep that
+    // order, less any skipped because cancel was set first; the first result
+    // stopWhen accepts cancels the strategies not yet started.
+    std::vector<AlignmentResult> invokeBatch(const std::vector<std::shared_ptr<IAlignmentStrategy>>& strategies, const AlignmentContext& context,
+                                             const CancellationToken& cancel = CancellationToken(),
+                                             const std::function<bool(const AlignmentResult&)>& stopWhen = nullptr) {
+        auto slots = invokeEach(strategies, context, cancel, stopWhen);
         std::vector<AlignmentResult> results;
-        for (const auto& strategy : strategies) {
-            results.push_back(invoke(strategy, context));
+        results.reserve(slots.size());
+        for (auto& slot : slots) {
+            if (slot) {
+                results.push_back(std::move(*slot));
+            }
         }
         return results;
     }
 
+    // Like invokeBatch, but with one slot per strategy, empty where it was skipped
+    std::vector<std::optional<AlignmentResult>> invokeEach(const std::vector<std::shared_ptr<IAlignmentStrategy>>& strategies, const AlignmentContext& context,
+                                                           const CancellationToken& cancel = CancellationToken(),
+                                                           const std::function<bool(const AlignmentResult&)>& stopWhen = nullptr) {
+        std::vector<std::optional<AlignmentResult>> slots(strategies.size());
+        executor_->parallelFor(strategies.size(), [&](size_t i) {
+            slots[i] = invoke(strategies[i], context);
+            if (stopWhen && stopWhen(*slots[i])) {
+                cancel.cancel();
+            }
+        }, cancel);
+        return slots;
+    }
+
+    StrategyExecutor& executor() const { return *executor_; }
+
 private:
     std::shared_ptr<StrategyHooks> hooks_;
-    // TODO: Add thread pool for async execution
+    StrategyExecutor* executor_;
+    std::vector<ExecutionObserver> observers_;
 };
 
 } // namespace common_ground
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm 
@@ -22,6 +22,13 @@ public:
     void registerStrategy(std::shared_ptr<IAlignmentStrategy> strategy, int priority = 0) {
         std::lock_guard<std::mutex> lock(mutex_);
         const std::string id = strategy->getId();
+        if (strategies_.count(id) > 0) {
+            // Re-registration replaces the entry; drop its old priority
+            for (auto pit = priorityMap_.begin(); pit != priorityMap_.end(); ) {
+                if (pit->second == id) pit = priorityMap_.erase(pit);
+                else ++pit;
+            }
+        }
         strategies_[id] = {strategy, priority};
         priorityMap_.emplace(priority, id);
     }
@@ -50,12 +57,14 @@ public:
         return (it != strategies_.end()) ? it->second.strategy : nullptr;
     }
 
+    // In priority order, like getStrategiesByPriority
     std::vector<std::shared_ptr<IAlignmentStrategy>> getApplicableStrategies(const AlignmentContext& context) const {
         std::lock_guard<std::mutex> lock(mutex_);
         std::vector<std::shared_ptr<IAlignmentStrategy>> result;
-        for (const auto& [id, entry] : strategies_) {
-            if (entry.strategy->isApplicable(context)) {
-                result.push_back(entry.strategy);
+        for (const auto& [priority, id] : priorityMap_) {
+            auto it = strategies_.find(id);
+            if (it != strategies_.end() && it->second.strategy->isApplicable(context)) {
+                result.push_back(it->second.strategy);
             }
         }
         return result;
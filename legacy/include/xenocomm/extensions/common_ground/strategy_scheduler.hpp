@@ -0,0 +1,129 @@
+#pragma once
+#include "interfaces.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace common_ground {
+
+/**
+ * @brief Orders strategies so a failing alignment is detected as cheaply as possible.
+ *
+ * The scheduler learns each strategy's cost (a moving average of its
+ * verification time) and how often it reports misalignment. Verification can
+ * stop at the first decisive misalignment, so the expected cost of a run is
+ * lowest when strategies go in ascending order of cost over failure
+ * likelihood: a cheap check that often fails runs before an expensive one
+ * that rarely does.
+ *
+ * Strategies it has not measured yet are assumed to cost the average of those
+ * it has and to fail half the time. The sort is stable, so the incoming order
+ * (the registry's priority order) breaks ties and decides until anything is
+ * measured.
+ *
+ * Executions are fed in by the framework's invoker; recordExecution() also
+ * accepts the ExecutionStats an AlignmentMetrics instance was given, so a new
+ * framework can start from history. Safe to use from any thread.
+ */
+class StrategyScheduler {
+public:
+    struct Estimate {
+        std::chrono::microseconds cost;  // Moving average of the verification time
+        double failureRate;              // Smoothed share of runs that were misaligned
+        size_t runs;
+    };
+
+    /**
+     * @brief Weight of the newest execution in the moving average of cost.
+     */
+    static constexpr double COST_SMOOTHING = 0.2;
+
+    /**
+     * @brief Accounts one execution of strategyId.
+     * @param successful Whether the strategy found the agents aligned.
+     */
+    void recordExecution(const std::string& strategyId, std::chrono::microseconds duration, bool successful) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats& stats = stats_[strategyId];
+        double micros = static_cast<double>(duration.count());
+        stats.costMicros = stats.runs == 0 ? micros : stats.costMicros + COST_SMOOTHING * (micros - stats.costMicros);
+        ++stats.runs;
+        if (!successful) {
+            ++stats.failures;
+        }
+    }
+
+    /**
+     * @brief What the scheduler has learned about strategyId, if it ran before.
+     */
+    std::optional<Estimate> estimate(const std::string& strategyId) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = stats_.find(strategyId);
+        if (it == stats_.end()) {
+            return std::nullopt;
+        }
+        return Estimate{std::chrono::microseconds(static_cast<int64_t>(it->second.costMicros)),
+                        failureRate(it->second), it->second.runs};
+    }
+
+    /**
+     * @brief Returns strategies in ascending order of expected cost per detected failure.
+     */
+    std::vector<std::shared_ptr<IAlignmentStrategy>> order(std::vector<std::shared_ptr<IAlignmentStrategy>> strategies) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double knownCost = 0.0;
+        for (const auto& [id, stats] : stats_) {
+            knownCost += stats.costMicros;
+        }
+        const double defaultCost = stats_.empty() ? 1.0 : std::max(knownCost / stats_.size(), 1.0);
+
+        std::vector<std::pair<double, std::shared_ptr<IAlignmentStrategy>>> ranked;
+        ranked.reserve(strategies.size());
+        for (auto& strategy : strategies) {
+            auto it = stats_.find(strategy->getId());
+            double rank = it == stats_.end()
+                ? defaultCost / 0.5
+                : std::max(it->second.costMicros, 1.0) / failureRate(it->second);
+            ranked.emplace_back(rank, std::move(strategy));
+        }
+        std::stable_sort(ranked.begin(), ranked.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<std::shared_ptr<IAlignmentStrategy>> ordered;
+        ordered.reserve(ranked.size());
+        for (auto& entry : ranked) {
+            ordered.push_back(std::move(entry.second));
+        }
+        return ordered;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.clear();
+    }
+
+private:
+    struct Stats {
+        double costMicros = 0.0;
+        size_t runs = 0;
+        size_t failures = 0;
+    };
+
+    // Laplace-smoothed, so one lucky run does not push a strategy to the back for good
+    static double failureRate(const Stats& stats) {
+        return (stats.failures + 1.0) / (stats.runs + 2.0);
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Stats> stats_;
+};
+
+} // namespace common_ground
+} // namespace xenocomm
@@ -5,6 +5,8 @@
 #include <map>
 #include <memory>
 #include <chrono>
+#include <mutex>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include "xenocomm/core/protocol_variant.hpp"
 
@@ -55,6 +57,9 @@ public:
     /**
      * @brief Validate that a set of variants can coexist
      * 
+     * Stops at the first incompatible pair. Sets that change a few variants at
+     * a time are cheaper to keep in the tracked matrix (see addVariant()).
+     * 
      * @param variants Set of variants to validate for mutual compatibility
      * @return true if all variants are mutually compatible, false otherwise
      */
@@ -63,18 +68,85 @@ public:
     /**
      * @brief Configure compatibility checking rules
      * 
+     * Rules are read once here, not on every check. Tracked variants are
+     * re-evaluated under the new rules.
+     * 
      * @param config JSON configuration for compatibility rules
      */
     void configure(const nlohmann::json& config);
 
+    /**
+     * @brief Add a variant to the tracked set, checking it against every tracked variant
+     * 
+     * The tracked set keeps a pairwise compatibility matrix, so a change costs
+     * one row of checks rather than the whole set's. Large rows are evaluated
+     * in parallel. A variant whose id is already tracked replaces it.
+     * 
+     * @param variant The variant to track
+     * @return true if it is compatible with every other tracked variant
+     */
+    bool addVariant(const ProtocolVariant& variant);
+
+    /**
+     * @brief Remove a variant from the tracked set
+     * 
+     * @param variantId Id of the variant to remove
+     * @return false if no variant with that id is tracked
+     */
+    bool retireVariant(const std::string& variantId);
+
+    /**
+     * @brief Whether every pair of tracked variants is compatible, without checking any
+     */
+    bool isTrackedSetCompatible() const;
+
+    /**
+     * @brief Number of incompatible pairs among the tracked variants
+     */
+    size_t incompatiblePairCount() const;
+
+    /**
+     * @brief Number of tracked variants
+     */
+    size_t trackedVariantCount() const;
+
 private:
+    /**
+     * @brief Rules compiled from the JSON configuration
+     */
+    struct Rules {
+        bool versionCheck = true;
+        bool messageFormatCheck = true;
+        bool stateTransitionCheck = true;
+        int minVersionGap = 1;
+        int maxVersionGap = 3;
+    };
+
+    /**
+     * @brief Whether v1 passes every enabled check against v2, building no messages
+     */
+    bool isPairCompatible(const ProtocolVariant& v1, const ProtocolVariant& v2) const;
+
+    /**
+     * @brief isPairCompatible() of variant against each of others, split across threads when there are many
+     */
+    std::vector<uint8_t> evaluateRow(
+        const ProtocolVariant& variant,
+        const ProtocolVariant* others,
+        size_t count
+    ) const;
+
+    // Requires mutex_
+    void removeTracked(size_t index);
+    void rebuildMatrix();
+
     /**
      * @brief Check compatibility of message formats between variants
      */
     bool checkMessageFormatCompatibility(
         const ProtocolVariant& v1,
         const ProtocolVariant& v2
-    );
+    ) const;
 
     /**
      * @brief Check compatibility of state transitions between variants
@@ -82,7 +154,7 @@ private:
     bool checkStateTransitionCompatibility(
         const ProtocolVariant& v1,
         const ProtocolVariant& v2
-    );
+    ) const;
 
     /**
      * @brief Check version compatibility between variants
@@ -90,7 +162,7 @@ private:
     bool checkVersionCompatibility(
         const ProtocolVariant& v1,
         const ProtocolVariant& v2
-    );
+    ) const;
 
     /**
      * @brief Check if changes in one variant conflict with another
@@ -98,7 +170,7 @@ private:
     std::vector<std::string> findConflicts(
         const ProtocolVariant& v1,
         const ProtocolVariant& v2
-    );
+    ) const;
 
     /**
      * @brief Identify potential compatibility warnings
@@ -106,10 +178,17 @@ private:
     std::vector<std::string> findWarnings(
         const ProtocolVariant& v1,
         const ProtocolVariant& v2
-    );
+    ) const;
+
+    Rules rules_;
 
-    // Configuration for compatibility rules
-    nlohmann::json config_;
+    // Tracked variants and their pairwise matrix: compatible_[i][j] is 1 when the later
+    // added of i and j passed its checks against the other. Guarded by mutex_
+    mutable std::mutex mutex_;
+    std::vector<ProtocolVariant> tracked_;
+    std::unordered_map<std::string, size_t> trackedIndex_;
+    std::vector<std::vector<uint8_t>> compatible_;
+    size_t incompatiblePairs_ = 0;
 };
 
 } // namespace extensions
@@ -9,29 +9,52 @@
 #include <nlohmann/json.hpp>
 #include "xenocomm/core/protocol_variant.hpp"
 #include "xenocomm/extensions/compatibility_checker.hpp"
-#include <array>
+#include "xenocomm/utils/event_log.hpp"
+#include <set>
 #include <unordered_map>
-#include <list>
+#include <cstdint>
+#include <functional>
 
 namespace xenocomm {
 namespace extensions {
 
+/**
+ * @brief Leading bytes ("XRB1") of a rollback point file
+ */
+constexpr uint32_t ROLLBACK_POINT_MAGIC = 0x31425258;
+
+/**
+ * @brief Leading bytes ("XRI1") of the rollback point index file
+ */
+constexpr uint32_t ROLLBACK_INDEX_MAGIC = 0x31495258;
+
+/**
+ * @brief A content-defined piece of a serialized state
+ *
+ * Chunks are stored once under their digest, so rollback points that share
+ * content share its chunks. Manifest entries leave data empty.
+ */
 struct StateChunk {
-    std::string id;                    // Chunk identifier
+    std::string id;                    // SHA-256 of the chunk content, also its storage key
     size_t offset;                     // Offset in the complete state
-    std::vector<uint8_t> data;        // Chunk data
+    std::vector<uint8_t> data;        // Chunk data, only set when loaded or being written
     std::string checksum;             // Chunk-level checksum
+    size_t size = 0;                  // Uncompressed length
+    bool compressed = false;          // Whether data holds the zlib-compressed content
 };
 
 /**
  * @brief Represents a snapshot of protocol state for rollback purposes
+ *
+ * Small states are kept inline in state; larger ones are kept as a manifest
+ * of chunk references in stateChunks.
  */
 struct RollbackPoint {
     std::string id;                                    // Unique identifier for this rollback point
     std::chrono::system_clock::time_point timestamp;   // When the rollback point was created
     std::string variantId;                            // ID of the protocol variant
     nlohmann::json state;                             // Protocol state snapshot (for small states)
-    std::vector<StateChunk> stateChunks;             // Chunked state data for large states
+    std::vector<StateChunk> stateChunks;             // Chunk manifest for large states
     std::string checksum;                             // Integrity checksum of the state
     std::map<std::string, std::string> metadata;      // Additional metadata
     bool isChunked;                                   // Whether the state is stored in chunks
@@ -46,9 +69,48 @@ struct RollbackConfig {
     bool enableIncrementalSnapshots = true;           // Whether to use incremental snapshots
     size_t maxSnapshotSizeBytes = 1024 * 1024 * 100; // Maximum size of a snapshot (100MB)
     std::string storagePath = "rollbacks/";           // Where to store rollback data
-    size_t chunkSize = 1024 * 1024;                  // Size of each chunk (1MB)
+    size_t chunkSize = 1024 * 1024;                  // Average chunk size; states larger than this are chunked (1MB)
     size_t maxMemoryCache = 1024 * 1024 * 512;       // Maximum memory for caching (512MB)
     bool enableCompression = true;                    // Whether to compress chunks
+    std::string eventLogPath;                         // Log of point creation, restores and cleanups; empty for none
+};
+
+class RollbackManager;
+
+/**
+ * @brief Random access to the serialized state of a rollback point
+ *
+ * Only the chunks covering a read are loaded, verified and decompressed, and
+ * the last one is kept for sequential reads, so a large state never has to
+ * be in memory at once. Inline states are held whole. A reader is valid
+ * while its manager lives and the point has not been cleaned up.
+ */
+class RollbackStateReader {
+public:
+    /**
+     * @brief Length of the serialized state
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Copies up to length bytes starting at offset into out
+     *
+     * @return Number of bytes copied; 0 at or past the end
+     * @throws std::runtime_error if a chunk is missing or corrupt
+     */
+    size_t read(size_t offset, uint8_t* out, size_t length);
+
+private:
+    friend class RollbackManager;
+
+    RollbackStateReader(const RollbackManager& manager, std::vector<StateChunk> chunks, std::string inlineState);
+
+    const RollbackManager& manager_;
+    std::vector<StateChunk> chunks_;
+    std::string inline_;
+    size_t size_;
+    size_t cachedIndex_ = SIZE_MAX;
+    StateChunk cached_;
 };
 
 /**
@@ -57,6 +119,13 @@ struct RollbackConfig {
  * The RollbackManager ensures system stability by maintaining safe rollback points
  * that can be used to restore the system to a known good state if issues are
  * detected with a protocol variant.
+ *
+ * Each rollback point is a binary <id>.rbp file: a fixed header (magic,
+ * summary size and CRC-32, state size and CRC-32), then a summary holding
+ * everything but the state, including the chunk manifest, and last the
+ * inline state. index.rbi gathers every summary, so startup and listing
+ * read neither states nor point files; states are read on demand.
+ * Points in the older <id>.json format are converted at startup.
  */
 class RollbackManager {
 public:
@@ -78,6 +147,7 @@ public:
      * @param state Current protocol state
      * @param metadata Additional metadata for the rollback point
      * @return std::string ID of the created rollback point
+     * @throws std::runtime_error if the serialized state exceeds maxSnapshotSizeBytes or cannot be persisted
      */
     std::string createRollbackPoint(
         const std::string& variantId,
@@ -93,6 +163,30 @@ public:
      */
     bool restoreToPoint(const std::string& rollbackId);
 
+    /**
+     * @brief Receives consecutive pieces of a serialized state; returning false stops the stream
+     */
+    using StateSink = std::function<bool(const uint8_t* data, size_t size)>;
+
+    /**
+     * @brief Deliver the serialized state of a rollback point to sink as its chunks are read
+     *
+     * Chunks are loaded and verified on the shared worker pool a few at a
+     * time and handed to sink in order, so memory holds only those few. The
+     * point's checksum can only be checked at the end: a false result after
+     * sink has been called means the delivered state must be discarded.
+     *
+     * @return bool True if the whole state was delivered and matched the checksum
+     */
+    bool streamRollbackState(const std::string& rollbackId, const StateSink& sink) const;
+
+    /**
+     * @brief Open a rollback point's serialized state for reads of parts of it
+     *
+     * @return Reader, or nullptr if the point or its base points are missing
+     */
+    std::unique_ptr<RollbackStateReader> openRollbackState(const std::string& rollbackId) const;
+
     /**
      * @brief Get information about a specific rollback point
      * 
@@ -103,6 +197,8 @@ public:
 
     /**
      * @brief List all available rollback points
+     *
+     * Points are listed from the index without their state; getRollbackPoint() reads it.
      * 
      * @param variantId Optional variant ID to filter by
      * @return std::vector<RollbackPoint> List of rollback points
@@ -134,91 +230,50 @@ public:
     const RollbackConfig& getConfig() const { return config_; }
 
 private:
+    friend class RollbackStateReader;
+
     RollbackConfig config_;
     std::shared_ptr<CompatibilityChecker> compatibilityChecker_;
     std::map<std::string, RollbackPoint> rollbackPoints_;
     
-    // Enhanced B-tree structures
-    struct BTreeNode {
-        static constexpr size_t ORDER = 128;  // Increased order for better branching
-        std::array<std::string, 2 * ORDER - 1> keys;
-        std::array<std::string, 2 * ORDER - 1> values;
-        std::array<std::shared_ptr<BTreeNode>, 2 * ORDER> children;
-        size_t keyCount;
-        bool isLeaf;
-        
-        BTreeNode() : keyCount(0), isLeaf(true) {}
-    };
-    
-    // LRU Cache for B-tree nodes
-    class NodeCache {
-    public:
-        static constexpr size_t MAX_CACHE_SIZE = 1000;  // Adjust based on memory constraints
-        
-        std::shared_ptr<BTreeNode> get(const std::string& nodeId) {
-            auto it = cache_.find(nodeId);
-            if (it != cache_.end()) {
-                // Move to front of LRU list
-                lruList_.splice(lruList_.begin(), lruList_, it->second.second);
-                return it->second.first;
-            }
-            return nullptr;
-        }
-        
-        void put(const std::string& nodeId, std::shared_ptr<BTreeNode> node) {
-            if (cache_.size() >= MAX_CACHE_SIZE) {
-                // Remove least recently used
-                auto last = lruList_.back();
-                cache_.erase(last);
-                lruList_.pop_back();
-            }
-            
-            lruList_.push_front(nodeId);
-            cache_[nodeId] = {node, lruList_.begin()};
-        }
-        
-        void clear() {
-            cache_.clear();
-            lruList_.clear();
-        }
-        
-    private:
-        std::unordered_map<std::string, 
-            std::pair<std::shared_ptr<BTreeNode>, 
-                     std::list<std::string>::iterator>> cache_;
-        std::list<std::string> lruList_;
-    };
-    
-    std::shared_ptr<BTreeNode> btreeRoot_;
-    mutable NodeCache nodeCache_;
-    
-    // Enhanced B-tree methods
-    void insertIntoBTree(const std::string& key, const std::string& value);
-    std::string searchBTree(const std::string& key);
-    void optimizeBTree();
-    void splitChild(std::shared_ptr<BTreeNode> parent, size_t index);
-    void insertNonFull(std::shared_ptr<BTreeNode> node, const std::string& key, const std::string& value);
-    void mergeNodes(std::shared_ptr<BTreeNode> parent, size_t index);
-    std::string generateNodeId(const std::shared_ptr<BTreeNode>& node) const;
-    void persistNode(const std::shared_ptr<BTreeNode>& node, const std::string& nodeId);
-    std::shared_ptr<BTreeNode> loadNode(const std::string& nodeId);
-    void rebalanceTree();
-    size_t calculateOptimalOrder() const;
-    
-    // Bulk loading optimization
-    void bulkLoadBTree(const std::vector<std::pair<std::string, std::string>>& sortedEntries);
-    std::vector<std::shared_ptr<BTreeNode>> createLeafNodes(
-        const std::vector<std::pair<std::string, std::string>>& sortedEntries);
-    std::vector<std::shared_ptr<BTreeNode>> createInternalNodes(
-        const std::vector<std::shared_ptr<BTreeNode>>& children);
-    
-    // New private methods for optimized storage
-    std::vector<StateChunk> chunkifyState(const nlohmann::json& state) const;
-    nlohmann::json reassembleState(const std::vector<StateChunk>& chunks) const;
+    std::unordered_map<std::string, size_t> chunkRefs_;  // Manifest entries referencing each stored chunk
+    std::shared_ptr<utils::EventLog> eventLog_;          // Null when config_.eventLogPath is empty
+
+    void logEvent(std::string message) const;
+
+    /**
+     * @brief Split a serialized state at content-defined boundaries into manifest entries without ids
+     */
+    std::vector<StateChunk> chunkifyState(const std::string& serialized) const;
+
+    /**
+     * @brief Digest the chunks of a serialized state and write those not yet stored
+     *
+     * Chunks are hashed and compressed on the shared worker pool and written
+     * in order by the calling thread as they complete.
+     */
+    void storeChunks(const std::string& serialized, std::vector<StateChunk>& chunks) const;
+
+    /**
+     * @brief Load a chunk and check it against its manifest entry
+     */
+    StateChunk loadVerifiedChunk(const StateChunk& entry) const;
+
+    /**
+     * @brief Full state of an inline point, applying its chain of incremental snapshots
+     */
+    std::optional<nlohmann::json> inlineState(const RollbackPoint& point) const;
     void compressChunk(StateChunk& chunk) const;
     void decompressChunk(StateChunk& chunk) const;
+    std::string chunkPath(const std::string& chunkId) const;
     std::string persistChunk(const StateChunk& chunk) const;
     StateChunk loadChunk(const std::string& chunkId) const;
+
+    /**
+     * @brief Count a point's references to its chunks, or drop them and delete unreferenced chunks
+     */
+    void retainChunks(const RollbackPoint& point);
+    void releaseChunks(const RollbackPoint& point);
     
     /**
      * @brief Calculate checksum for state data
@@ -234,6 +289,19 @@ private:
      * @brief Load rollback point from persistent storage
      */
     std::optional<RollbackPoint> loadRollbackPoint(const std::string& id) const;
+    std::optional<RollbackPoint> readPointFile(const std::string& id, bool withState) const;
+    std::optional<RollbackPoint> loadLegacyRollbackPoint(const std::string& id) const;
+    std::string pointPath(const std::string& id) const;
+
+    /**
+     * @brief Rewrite the index of every rollback point summary
+     */
+    bool persistIndex() const;
+
+    /**
+     * @brief Load the index if it lists exactly the given point files
+     */
+    bool loadIndex(const std::set<std::string>& pointIds);
 
     /**
      * @brief Generate a unique ID for a new rollback point
@@ -260,9 +328,6 @@ private:
         const nlohmann::json& baseState,
         const nlohmann::json& incrementalState
     ) const;
-
-    // Add declaration for collectEntries
-    void collectEntries(std::shared_ptr<BTreeNode> node, std::vector<std::pair<std::string, std::string>>& entries);
 };
 
 } // namespace extensions
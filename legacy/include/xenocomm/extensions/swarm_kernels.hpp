@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace extensions {
+
+/**
+ * @brief How well two agents' values of one parameter fit together
+ *
+ * Ordered from least to most in the way of an agreement.
+ */
+enum class ParamCompatibility : uint8_t {
+    COMPATIBLE,
+    UPGRADEABLE,  // One side can fall back to the other's value
+    NEGOTIABLE,   // Both differ; needs another round
+    INCOMPATIBLE
+};
+
+/**
+ * @brief Text form used by the agents' own negotiation engine ("compatible", ...)
+ */
+const char* toString(ParamCompatibility compatibility);
+
+/**
+ * @brief String-valued parameters agents negotiate among themselves
+ *
+ * Mirrors the agent coordination server's NegotiableParams field for field,
+ * except custom_params, which stay with the caller; unlike the enum-typed
+ * core::NegotiableParams, values are free-form names, so unknown formats and
+ * ciphers pass through unchanged.
+ */
+struct AgentParams {
+    std::string protocolVersion = "2.0";
+    std::string dataFormat = "json";
+    std::optional<std::string> compression;  // nullopt for none
+    std::string errorCorrection = "checksum";
+    int64_t maxMessageSize = 1024 * 1024;
+    int64_t timeoutMs = 30000;
+    std::string encryption = "tls";
+    bool streamingEnabled = false;
+    int64_t batchSize = 1;
+    std::string retryPolicy = "exponential";
+    int64_t maxRetries = 3;
+    int64_t priority = 5;
+};
+
+/**
+ * @brief Compatibility of the parameters two agents can disagree on
+ */
+struct ParamCompatibilityReport {
+    ParamCompatibility dataFormat = ParamCompatibility::COMPATIBLE;
+    ParamCompatibility compression = ParamCompatibility::COMPATIBLE;
+    ParamCompatibility encryption = ParamCompatibility::COMPATIBLE;
+    ParamCompatibility maxMessageSize = ParamCompatibility::COMPATIBLE;
+
+    /**
+     * @brief The entry most in the way of an agreement.
+     */
+    ParamCompatibility worst() const;
+};
+
+/**
+ * @brief Compares two agents' parameters.
+ *
+ * json is every agent's fallback format and no compression every agent's
+ * fallback codec, so either differing from the other side is upgradeable;
+ * encryption against none is incompatible, as security is never downgraded.
+ */
+ParamCompatibilityReport checkParamCompatibility(const AgentParams& self, const AgentParams& other);
+
+/**
+ * @brief A parameter set both agents can run with.
+ *
+ * Takes the tighter limit of each bound, the stronger cipher, compression
+ * only if both compress, and the preferred side's choices elsewhere.
+ */
+AgentParams mergeParams(const AgentParams& self, const AgentParams& other, bool preferSelf = true);
+
+/**
+ * @brief checkParamCompatibility(proposal, peer) for every peer, in order.
+ */
+std::vector<ParamCompatibilityReport> checkParamCompatibility(const AgentParams& proposal,
+                                                              const std::vector<AgentParams>& peers);
+
+/**
+ * @brief Worst compatibility of every pair of agents, row-major, n by n.
+ *
+ * Entry (i, j) is checkParamCompatibility(agents[i], agents[j]).worst(); the
+ * diagonal is COMPATIBLE. Only one triangle is computed, as the check is
+ * symmetric.
+ */
+std::vector<ParamCompatibility> compatibilityMatrix(const std::vector<AgentParams>& agents);
+
+/**
+ * @brief Direction of a metric over a window of samples, oldest first
+ */
+enum class MetricTrend : uint8_t {
+    IMPROVING,
+    STABLE,
+    DEGRADING,
+    VOLATILE,
+    INSUFFICIENT_DATA
+};
+
+const char* toString(MetricTrend trend);
+
+/**
+ * @brief Classifies a window of samples by the least-squares slope relative to their mean.
+ *
+ * A coefficient of variation above 0.3 is volatile whatever the slope; a
+ * relative slope beyond 5% either way is a trend, read upside down when
+ * lower values are better (latencies).
+ */
+MetricTrend analyzeMetricTrend(const std::vector<double>& window, bool lowerIsBetter = false);
+
+/**
+ * @brief Whether the last sample lies more than three standard deviations from those before it.
+ */
+bool isMetricAnomalous(const std::vector<double>& samples);
+
+} // namespace extensions
+} // namespace xenocomm
@@ -0,0 +1,252 @@
+#ifndef XENOCOMM_UTILS_AWAITABLE_HPP
+#define XENOCOMM_UTILS_AWAITABLE_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define XENOCOMM_HAVE_COROUTINES 1
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+template <typename T>
+class Awaitable;
+
+/**
+ * @brief Runs a continuation somewhere else, e.g. by posting it to EventReactor.
+ */
+using ContinuationScheduler = std::function<void(std::function<void()>)>;
+
+namespace detail {
+
+template <typename T>
+struct AwaitableState {
+    std::mutex mutex;
+    std::condition_variable settledCv;
+    std::optional<T> value;
+    std::exception_ptr error;
+    bool settled = false;
+    std::function<void()> continuation;  // Runs once, after settling
+    ContinuationScheduler scheduler;     // Empty to run it on the settling thread
+
+    template <typename Fill>
+    void settle(Fill fill) {
+        std::function<void()> next;
+        ContinuationScheduler via;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (settled) {
+                return;  // The first result wins
+            }
+            fill();
+            settled = true;
+            next = std::move(continuation);
+            via = scheduler;
+        }
+        settledCv.notify_all();
+        if (next) {
+            via ? via(std::move(next)) : next();
+        }
+    }
+
+    // false if already settled, in which case the caller continues itself
+    bool setContinuation(std::function<void()> next) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (settled) {
+            return false;
+        }
+        continuation = std::move(next);
+        return true;
+    }
+};
+
+template <typename T>
+struct UnwrapAwaitable {
+    using type = T;
+};
+
+template <typename T>
+struct UnwrapAwaitable<Awaitable<T>> {
+    using type = T;
+};
+
+} // namespace detail
+
+/**
+ * @brief Producer side of an Awaitable: settles it once with a value or an error.
+ *
+ * Copies share the result; settling again is ignored.
+ */
+template <typename T>
+class AwaitableResolver {
+public:
+    AwaitableResolver() : state_(std::make_shared<detail::AwaitableState<T>>()) {}
+
+    /**
+     * @param scheduler Where the consumer's continuation runs; empty runs it
+     *        on the thread that settles
+     */
+    explicit AwaitableResolver(ContinuationScheduler scheduler) : AwaitableResolver() {
+        state_->scheduler = std::move(scheduler);
+    }
+
+    Awaitable<T> awaitable() const { return Awaitable<T>(state_); }
+
+    void resolve(T value) const {
+        state_->settle([&] { state_->value.emplace(std::move(value)); });
+    }
+
+    void fail(std::exception_ptr error) const {
+        state_->settle([&] { state_->error = std::move(error); });
+    }
+
+private:
+    std::shared_ptr<detail::AwaitableState<T>> state_;
+};
+
+/**
+ * @brief A result that arrives later, consumed without blocking a thread.
+ *
+ * The asynchronous APIs that hand these out settle them from whatever
+ * thread finishes the work. A consumer chains then() onto it, or, built as
+ * C++20, co_awaits it from a coroutine that itself returns an Awaitable, so
+ * a conversation spanning several round trips reads as straight-line code
+ * while no thread waits in between. get() is the bridge for callers that
+ * are not asynchronous themselves.
+ *
+ * Each Awaitable has one consumer: call then(), co_await or get() once.
+ */
+template <typename T>
+class Awaitable {
+public:
+    /**
+     * @brief An Awaitable that is already settled with value.
+     */
+    static Awaitable ready(T value) {
+        AwaitableResolver<T> resolver;
+        resolver.resolve(std::move(value));
+        return resolver.awaitable();
+    }
+
+    static Awaitable failed(std::exception_ptr error) {
+        AwaitableResolver<T> resolver;
+        resolver.fail(std::move(error));
+        return resolver.awaitable();
+    }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->settled;
+    }
+
+    /**
+     * @brief Calls fn(value) once settled; its result, or the Awaitable it returns, settles the one returned.
+     *
+     * An error, upstream or thrown by fn, skips fn and settles the returned
+     * Awaitable with that error.
+     */
+    template <typename Fn>
+    auto then(Fn fn) -> Awaitable<typename detail::UnwrapAwaitable<std::invoke_result_t<Fn, T>>::type> {
+        using Result = std::invoke_result_t<Fn, T>;
+        using Value = typename detail::UnwrapAwaitable<Result>::type;
+        AwaitableResolver<Value> next;
+        auto state = state_;
+        onSettled([state, next, fn = std::move(fn)]() mutable {
+            if (state->error) {
+                next.fail(state->error);
+                return;
+            }
+            try {
+                if constexpr (std::is_same_v<Result, Awaitable<Value>>) {
+                    fn(std::move(*state->value)).forward(next);
+                } else {
+                    next.resolve(fn(std::move(*state->value)));
+                }
+            } catch (...) {
+                next.fail(std::current_exception());
+            }
+        });
+        return next.awaitable();
+    }
+
+    /**
+     * @brief Blocks until settled; returns the value or rethrows the error.
+     */
+    T get() {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->settledCv.wait(lock, [this] { return state_->settled; });
+        return take();
+    }
+
+#ifdef XENOCOMM_HAVE_COROUTINES
+    bool await_ready() const { return isReady(); }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        return state_->setContinuation([handle] { handle.resume(); });
+    }
+
+    T await_resume() {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return take();
+    }
+
+    /**
+     * @brief Lets a coroutine return Awaitable<T>; it starts eagerly and settles on co_return.
+     */
+    struct promise_type {
+        AwaitableResolver<T> resolver;
+
+        Awaitable get_return_object() { return resolver.awaitable(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_value(T value) { resolver.resolve(std::move(value)); }
+        void unhandled_exception() { resolver.fail(std::current_exception()); }
+    };
+#endif
+
+private:
+    template <typename>
+    friend class AwaitableResolver;
+    template <typename>
+    friend class Awaitable;
+
+    explicit Awaitable(std::shared_ptr<detail::AwaitableState<T>> state) : state_(std::move(state)) {}
+
+    // Runs fn once settled, right away if it already is
+    void onSettled(std::function<void()> fn) {
+        if (!state_->setContinuation(fn)) {
+            fn();
+        }
+    }
+
+    void forward(const AwaitableResolver<T>& to) {
+        auto state = state_;
+        onSettled([state, to] {
+            state->error ? to.fail(state->error) : to.resolve(std::move(*state->value));
+        });
+    }
+
+    // Caller holds state_->mutex and the result is settled
+    T take() {
+        if (state_->error) {
+            std::rethrow_exception(state_->error);
+        }
+        return std::move(*state_->value);
+    }
+
+    std::shared_ptr<detail::AwaitableState<T>> state_;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_AWAITABLE_HPP
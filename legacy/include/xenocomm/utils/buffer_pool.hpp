@@ -0,0 +1,185 @@
+#ifndef XENOCOMM_UTILS_BUFFER_POOL_HPP
+#define XENOCOMM_UTILS_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace utils {
+
+class BufferPool;
+
+namespace detail {
+struct BufferBlock;
+struct BufferPoolState;
+} // namespace detail
+
+/**
+ * @brief Reference-counted handle to a buffer drawn from a BufferPool.
+ *
+ * Copies share the same storage, so a received datagram can be handed from
+ * the socket to reassembly to the caller without being copied; slice()
+ * narrows a handle to a sub-range, again without copying. The storage goes
+ * back to the pool when the last handle is released. The count is atomic,
+ * but the bytes are not synchronized: write only while unique().
+ */
+class PooledBuffer {
+public:
+    /**
+     * @brief A handle's fields as plain data, for lock-free queues of trivially copyable descriptors.
+     *
+     * Holds the reference that release() took out of the handle; exactly one
+     * adopt() must give it back.
+     */
+    struct Raw {
+        detail::BufferBlock* block;
+        uint8_t* data;
+        size_t size;
+        size_t capacity;
+    };
+
+    PooledBuffer() = default;
+    PooledBuffer(const PooledBuffer& other) noexcept;
+    PooledBuffer(PooledBuffer&& other) noexcept;
+    PooledBuffer& operator=(const PooledBuffer& other) noexcept;
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+    ~PooledBuffer() { reset(); }
+
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    explicit operator bool() const { return block_ != nullptr; }
+
+    /**
+     * @brief Bytes available from data() to the end of the storage.
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Changes size() within capacity(), e.g. to the length actually received.
+     */
+    void resize(size_t size);
+
+    ByteSpan span() const { return ByteSpan(data_, size_); }
+
+    /**
+     * @brief The whole capacity, for reading into.
+     */
+    MutableByteSpan writable() { return MutableByteSpan(data_, capacity_); }
+
+    /**
+     * @brief Shares a sub-range of this buffer; length is clamped to size().
+     */
+    PooledBuffer slice(size_t offset, size_t length = SIZE_MAX) const;
+
+    bool unique() const;
+    void reset();
+    std::vector<uint8_t> to_vector() const { return std::vector<uint8_t>(data_, data_ + size_); }
+
+    /**
+     * @brief Empties this handle without dropping its reference, which moves into the result.
+     */
+    Raw release() {
+        Raw raw{block_, data_, size_, capacity_};
+        block_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        return raw;
+    }
+
+    /**
+     * @brief Rebuilds the handle that release() emptied.
+     */
+    static PooledBuffer adopt(const Raw& raw) {
+        PooledBuffer buffer;
+        buffer.block_ = raw.block;
+        buffer.data_ = raw.data;
+        buffer.size_ = raw.size;
+        buffer.capacity_ = raw.capacity;
+        return buffer;
+    }
+
+private:
+    friend class BufferPool;
+
+    explicit PooledBuffer(detail::BufferBlock* block);
+
+    detail::BufferBlock* block_ = nullptr;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+/**
+ * @brief Slab allocator for receive buffers.
+ *
+ * Buffers come in power-of-two size classes from MIN_POOLED_SIZE to
+ * MAX_POOLED_SIZE, carved out of slabs that are never returned to the heap
+ * while the pool lives. Each thread keeps a small cache per class, so both
+ * acquire() and the final release of a handle are a pointer pop or push
+ * with no atomics shared between cores. A buffer released on a different
+ * thread from the one that acquired it lands in the releasing thread's
+ * cache; only when a cache over- or underflows does a batch move to or from
+ * the pool's shared depot under a lock. Larger requests are served from the
+ * heap.
+ *
+ * Buffers must be released before their pool is destroyed; shared() lives
+ * for the whole process.
+ */
+class BufferPool {
+public:
+    static constexpr size_t MIN_POOLED_SIZE = 256;
+    static constexpr size_t MAX_POOLED_SIZE = 64 * 1024;
+
+    struct Config {
+        size_t slab_size = 256 * 1024;           ///< Bytes carved per slab (at least 8 buffers)
+        size_t thread_cache_bytes = 512 * 1024;  ///< Per thread and size class
+    };
+
+    struct Stats {
+        size_t slabs = 0;
+        size_t reserved_bytes = 0;          ///< Slab memory held by the pool
+        uint64_t depot_refills = 0;         ///< Thread caches refilled from the depot
+        uint64_t depot_returns = 0;         ///< Thread caches drained to the depot
+        uint64_t oversize_allocations = 0;  ///< Requests above MAX_POOLED_SIZE
+    };
+
+    BufferPool();
+    explicit BufferPool(const Config& config);
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Process-wide pool used by the transports.
+     */
+    static BufferPool& shared();
+
+    /**
+     * @brief Returns a buffer whose size() is size and capacity() at least size.
+     *
+     * The contents are uninitialized.
+     */
+    PooledBuffer acquire(size_t size);
+
+    /**
+     * @brief Carves slabs up front so the first count buffers of size need no allocation.
+     */
+    void reserve(size_t size, size_t count);
+
+    Stats get_stats() const;
+
+private:
+    std::shared_ptr<detail::BufferPoolState> state_;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_BUFFER_POOL_HPP
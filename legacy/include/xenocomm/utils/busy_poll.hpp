@@ -0,0 +1,42 @@
+#ifndef XENOCOMM_UTILS_BUSY_POLL_HPP
+#define XENOCOMM_UTILS_BUSY_POLL_HPP
+
+#include <chrono>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Has the kernel busy-poll the device queue for a socket's blocking reads.
+ *
+ * Sets SO_BUSY_POLL, and SO_PREFER_BUSY_POLL where the kernel has it, so a
+ * read spins on the NIC for up to budget before sleeping on an interrupt.
+ * Raising the budget above net.core.busy_read needs CAP_NET_ADMIN; without
+ * it the socket keeps the system default.
+ *
+ * @return false if the platform or the kernel refused
+ */
+bool enableBusyPoll(int fd, std::chrono::microseconds budget);
+
+/**
+ * @brief Spins on a socket until it is readable or budget runs out.
+ *
+ * The first half of spin-then-park: a caller about to block on the socket
+ * spins here first, so data arriving within the budget is picked up without
+ * a wakeup. Burns a core for as long as it spins.
+ *
+ * @return true if the socket is readable (or has an error to report)
+ */
+bool spinUntilReadable(int fd, std::chrono::microseconds budget);
+
+/**
+ * @brief Pins the calling thread to one CPU.
+ *
+ * @return false if the CPU is not one the process may run on, or the platform has no affinity calls
+ */
+bool pinCurrentThread(int cpu);
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_BUSY_POLL_HPP
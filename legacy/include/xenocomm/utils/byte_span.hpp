@@ -0,0 +1,68 @@
+#ifndef XENOCOMM_UTILS_BYTE_SPAN_HPP
+#define XENOCOMM_UTILS_BYTE_SPAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Non-owning view over a contiguous range of elements.
+ *
+ * A minimal stand-in for C++20 std::span so hot paths can pass slices of
+ * caller-owned buffers around without copying them into new vectors. The
+ * viewed memory must outlive the span.
+ */
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using iterator = T*;
+
+    constexpr Span() noexcept : data_(nullptr), size_(0) {}
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    template <typename U, typename Alloc>
+    Span(std::vector<U, Alloc>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    template <typename U, typename Alloc>
+    Span(const std::vector<U, Alloc>& vec) noexcept : data_(vec.data()), size_(vec.size()) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+    constexpr T& operator[](size_t index) const noexcept { return data_[index]; }
+
+    /**
+     * @brief Returns a view of count elements starting at offset, clamped to the span.
+     */
+    constexpr Span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const noexcept {
+        if (offset > size_) {
+            return Span();
+        }
+        size_t remaining = size_ - offset;
+        return Span(data_ + offset, count < remaining ? count : remaining);
+    }
+
+    std::vector<typename std::remove_const<T>::type> to_vector() const {
+        return std::vector<typename std::remove_const<T>::type>(begin(), end());
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+using ByteSpan = Span<const uint8_t>;
+using MutableByteSpan = Span<uint8_t>;
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_BYTE_SPAN_HPP
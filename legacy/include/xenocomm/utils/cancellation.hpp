@@ -0,0 +1,157 @@
+#ifndef XENOCOMM_UTILS_CANCELLATION_HPP
+#define XENOCOMM_UTILS_CANCELLATION_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Lets a caller give up on work it started: by calling cancel() or by a deadline.
+ *
+ * Copies share one state. A child token gives up with its parent and, if it
+ * has one, at its own earlier deadline, so a request's budget narrows as it
+ * passes down the layers. Waits that take a token (waitForSocket(),
+ * sleepFor()) end as soon as it is cancelled, and onCancel() callbacks let
+ * other blocking operations, such as in-flight io_uring requests, be
+ * aborted too.
+ *
+ * Layers that cannot take a parameter read the thread's token instead:
+ * CancellationScope installs one, and current() returns it. none() never
+ * gives up and costs nothing to check.
+ */
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+    using CallbackId = uint64_t;
+
+    /**
+     * @brief A token nothing has cancelled yet, without a deadline.
+     */
+    CancellationToken();
+
+    /**
+     * @brief A token that also gives up at deadline.
+     */
+    explicit CancellationToken(Clock::time_point deadline);
+
+    static CancellationToken afterTimeout(std::chrono::milliseconds timeout) {
+        return CancellationToken(Clock::now() + timeout);
+    }
+
+    /**
+     * @brief A token that is never cancelled; cancel() on it does nothing.
+     */
+    static CancellationToken none() { return CancellationToken(nullptr); }
+
+    /**
+     * @brief The token installed by the innermost CancellationScope on this thread, else none().
+     */
+    static CancellationToken current();
+
+    /**
+     * @brief A token cancelled along with this one, or at deadline if that comes first.
+     */
+    CancellationToken child(Clock::time_point deadline = Clock::time_point::max()) const;
+
+    /**
+     * @brief Cancels the token and its children, running their callbacks on this thread.
+     */
+    void cancel() const;
+
+    /**
+     * @brief Whether cancel() was called or the deadline has passed.
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief false only for none(), whose checks can be skipped.
+     */
+    bool isCancellable() const { return state_ != nullptr; }
+
+    /**
+     * @return The deadline, or Clock::time_point::max() if there is none
+     */
+    Clock::time_point deadline() const;
+
+    /**
+     * @brief limit, shortened to the time left before the deadline; zero once cancelled.
+     */
+    std::chrono::milliseconds remaining(std::chrono::milliseconds limit) const;
+
+    /**
+     * @brief Waits for duration unless the token gives up first.
+     *
+     * @return false if it was cancelled or the deadline came first
+     */
+    bool sleepFor(std::chrono::milliseconds duration) const;
+
+    /**
+     * @brief Runs callback when cancel() is called, right away if it already was.
+     *
+     * Deadlines do not fire callbacks; waits bound themselves by deadline().
+     *
+     * @return Id for removeCallback(), or 0 if callback already ran or never can
+     */
+    CallbackId onCancel(std::function<void()> callback) const;
+
+    /**
+     * @brief Forgets a callback. Once this returns it is not running and will not run.
+     *
+     * Called from the callback itself it returns immediately.
+     */
+    void removeCallback(CallbackId id) const;
+
+private:
+    struct State;
+
+    explicit CancellationToken(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Makes token the thread's CancellationToken::current() until destroyed.
+ *
+ * Scopes nest; the previous token returns when this one ends. Work handed to
+ * another thread takes the token with it and opens a scope there.
+ */
+class CancellationScope {
+public:
+    explicit CancellationScope(CancellationToken token);
+    ~CancellationScope();
+
+    CancellationScope(const CancellationScope&) = delete;
+    CancellationScope& operator=(const CancellationScope&) = delete;
+
+private:
+    CancellationToken token_;
+    const CancellationToken* previous_;
+};
+
+/**
+ * @brief Outcome of waitForSocket().
+ */
+enum class SocketWait {
+    READY,
+    TIMED_OUT,   ///< timeout ran out; the token's deadline counts as cancellation
+    CANCELLED,
+    FAILED       ///< errno is set
+};
+
+/**
+ * @brief Waits for poll() events on a socket, timeout, or the token giving up.
+ *
+ * cancel() wakes the wait at once rather than at the next timeout. A
+ * negative timeout waits for the token alone.
+ */
+SocketWait waitForSocket(int fd, short events, std::chrono::milliseconds timeout,
+                         const CancellationToken& token = CancellationToken::current());
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_CANCELLATION_HPP
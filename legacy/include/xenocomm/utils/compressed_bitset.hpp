@@ -0,0 +1,94 @@
+#ifndef XENOCOMM_UTILS_COMPRESSED_BITSET_HPP
+#define XENOCOMM_UTILS_COMPRESSED_BITSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Set of 32-bit integers stored roaring-style, for posting lists of dense IDs.
+ *
+ * Values are split by their high 16 bits into chunks. A chunk holding up to
+ * 4096 values is a sorted array of the low halves; a fuller one is a 65536-bit
+ * bitmap. Sparse sets therefore cost two bytes per value, dense ones an eighth
+ * of a byte, and intersecting two dense chunks is a straight AND over 1024
+ * words that the compiler vectorizes. Not thread-safe.
+ */
+class CompressedBitset {
+public:
+    static constexpr size_t ARRAY_LIMIT = 4096;
+    static constexpr size_t BITMAP_WORDS = 65536 / 64;
+
+    /**
+     * @return true if value was not already present
+     */
+    bool add(uint32_t value);
+
+    /**
+     * @return true if value was present
+     */
+    bool remove(uint32_t value);
+
+    bool contains(uint32_t value) const;
+    size_t cardinality() const;
+    bool empty() const { return chunks_.empty(); }
+    void clear() { chunks_.clear(); }
+
+    /**
+     * @brief Keeps only the values also in other.
+     */
+    void intersect_with(const CompressedBitset& other);
+
+    /**
+     * @brief Adds every value in other.
+     */
+    void union_with(const CompressedBitset& other);
+
+    /**
+     * @brief Calls fn with each value in ascending order.
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& chunk : chunks_) {
+            uint32_t high = static_cast<uint32_t>(chunk.key) << 16;
+            if (chunk.bitmap.empty()) {
+                for (uint16_t low : chunk.array) {
+                    fn(high | low);
+                }
+            } else {
+                for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                    for (uint64_t word = chunk.bitmap[w]; word != 0; word &= word - 1) {
+                        fn(high | static_cast<uint32_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(word))));
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> to_vector() const;
+
+private:
+    struct Chunk {
+        uint16_t key{0};
+        uint32_t cardinality{0};
+        std::vector<uint16_t> array;    // Sorted; used while bitmap is empty
+        std::vector<uint64_t> bitmap;   // BITMAP_WORDS long once the chunk outgrows the array
+    };
+
+    Chunk* find_chunk(uint16_t key);
+    const Chunk* find_chunk(uint16_t key) const;
+    static void to_bitmap(Chunk& chunk);
+    static void to_array(Chunk& chunk);
+    static void intersect_chunk(Chunk& chunk, const Chunk& other);
+    static void union_chunk(Chunk& chunk, const Chunk& other);
+
+    std::vector<Chunk> chunks_;  // Sorted by key, never empty chunks
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_COMPRESSED_BITSET_HPP
@@ -0,0 +1,177 @@
+#ifndef XENOCOMM_UTILS_CONFIG_SNAPSHOT_HPP
+#define XENOCOMM_UTILS_CONFIG_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Configuration readers can take on every call without locking.
+ *
+ * Each publish() makes an immutable copy and swaps it in as a shared_ptr;
+ * the copy a reader holds never changes under it, so a configuration can be
+ * retuned while sends and receives are running. read() returns a pin on the
+ * current copy that is served from a cache kept by the calling thread: while
+ * nothing has been published since the thread last looked, a read is one
+ * acquire load of the version and a few thread-local operations, with no
+ * lock and no shared reference count touched.
+ *
+ * A thread moves on to a newer copy only once it holds no pins on this
+ * snapshot, so everything read under one pin, including pins taken by the
+ * functions it calls, sees the same configuration, and references into the
+ * configuration stay valid while the outermost pin is held. The one
+ * exception is the publishing thread, which reads what it published at once;
+ * the copies its pins were taken on are kept until those pins are released.
+ * Pins belong to the thread that took them and must not outlive the snapshot.
+ *
+ * publish() is thread-safe; concurrent publishers are serialized.
+ */
+template <typename T>
+class ConfigSnapshot {
+    struct Entry;
+
+public:
+    /**
+     * @brief A pinned, immutable view of one published configuration.
+     */
+    class Ref {
+    public:
+        Ref(Ref&& other) noexcept : value_(other.value_), entry_(other.entry_) { other.entry_ = nullptr; }
+        Ref(const Ref&) = delete;
+        Ref& operator=(const Ref&) = delete;
+        Ref& operator=(Ref&&) = delete;
+        ~Ref() {
+            if (entry_ && --entry_->pins == 0) {
+                entry_->retired.clear();
+            }
+        }
+
+        const T& operator*() const { return *value_; }
+        const T* operator->() const { return value_; }
+        const T& get() const { return *value_; }
+
+    private:
+        friend class ConfigSnapshot;
+        Ref(const T* value, Entry* entry) : value_(value), entry_(entry) { ++entry_->pins; }
+
+        const T* value_;
+        Entry* entry_;
+    };
+
+    explicit ConfigSnapshot(T value = T()) : state_(std::make_shared<State>()) {
+        state_->current = std::make_shared<const T>(std::move(value));
+    }
+
+    ConfigSnapshot(const ConfigSnapshot& other) : ConfigSnapshot(*other.load()) {}
+
+    ConfigSnapshot& operator=(const ConfigSnapshot& other) {
+        if (this != &other) {
+            publish(*other.load());
+        }
+        return *this;
+    }
+
+    ConfigSnapshot& operator=(const T& value) {
+        publish(value);
+        return *this;
+    }
+
+    /**
+     * @brief Makes value the configuration every later read() sees.
+     */
+    void publish(T value) {
+        auto next = std::make_shared<const T>(std::move(value));
+        Entry& entry = entryFor();
+        std::lock_guard<std::mutex> lock(state_->publishMutex);
+        std::atomic_store(&state_->current, next);
+        const uint64_t version = state_->version.fetch_add(1, std::memory_order_release) + 1;
+        if (entry.pins > 0) {
+            entry.retired.push_back(std::move(entry.value));
+        }
+        entry.value = std::move(next);
+        entry.version = version;
+    }
+
+    /**
+     * @brief The configuration in effect, pinned for the calling thread.
+     */
+    Ref read() const {
+        Entry& entry = entryFor();
+        const uint64_t version = state_->version.load(std::memory_order_acquire);
+        if (entry.version != version && entry.pins == 0) {
+            // The version is read first, so the copy loaded is at least that new
+            entry.value = std::atomic_load(&state_->current);
+            entry.version = version;
+        }
+        return Ref(entry.value.get(), &entry);
+    }
+
+    /**
+     * @brief A shared reference to the current configuration, for keeping beyond a call.
+     */
+    std::shared_ptr<const T> load() const { return std::atomic_load(&state_->current); }
+
+    uint64_t version() const { return state_->version.load(std::memory_order_acquire); }
+
+private:
+    struct State {
+        const uint64_t id = nextId().fetch_add(1, std::memory_order_relaxed);
+        std::atomic<uint64_t> version{0};
+        std::shared_ptr<const T> current;
+        std::mutex publishMutex;
+    };
+
+    // One per snapshot a thread has read; the thread's cache owns it
+    struct Entry {
+        uint64_t owner = 0;
+        uint64_t version = UINT64_MAX;
+        uint32_t pins = 0;
+        std::shared_ptr<const T> value;
+        std::vector<std::shared_ptr<const T>> retired;  // Still pinned after this thread published
+        std::weak_ptr<State> alive;  // Lets a thread drop entries for snapshots since destroyed
+    };
+
+    static std::atomic<uint64_t>& nextId() {
+        static std::atomic<uint64_t> id{1};
+        return id;
+    }
+
+    Entry& entryFor() const {
+        thread_local std::vector<std::unique_ptr<Entry>> cache;
+        thread_local Entry* last = nullptr;
+        const uint64_t id = state_->id;
+        if (last && last->owner == id) {
+            return *last;
+        }
+        for (const auto& entry : cache) {
+            if (entry->owner == id) {
+                return *(last = entry.get());
+            }
+        }
+        // First read of this snapshot on this thread; make room by forgetting dead snapshots
+        cache.erase(std::remove_if(cache.begin(), cache.end(),
+                                   [](const std::unique_ptr<Entry>& entry) {
+                                       return entry->pins == 0 && entry->alive.expired();
+                                   }),
+                    cache.end());
+        auto entry = std::make_unique<Entry>();
+        entry->owner = id;
+        entry->alive = state_;
+        cache.push_back(std::move(entry));
+        return *(last = cache.back().get());
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_CONFIG_SNAPSHOT_HPP
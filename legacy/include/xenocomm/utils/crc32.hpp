@@ -0,0 +1,53 @@
+#ifndef XENOCOMM_UTILS_CRC32_HPP
+#define XENOCOMM_UTILS_CRC32_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief CRC32 kernels the engine can dispatch to.
+ */
+enum class Crc32Implementation {
+    SLICING_BY_8,   ///< Portable table-driven kernel, 8 bytes per step
+    PCLMUL,         ///< x86 carry-less multiply folding (PCLMULQDQ + SSE4.1)
+    ARMV8_CRC       ///< ARMv8 CRC32 instructions
+};
+
+/**
+ * @brief Computes the IEEE 802.3 CRC32 (reflected polynomial 0xEDB88320).
+ *
+ * This is the single CRC engine shared by transmission, error detection and
+ * compression checksums. The fastest kernel the CPU supports is selected once
+ * at first use. Results are identical across kernels and match zlib's crc32(),
+ * including continuation: passing a previous result as crc extends it over
+ * the next chunk.
+ *
+ * @param data Bytes to checksum.
+ * @param size Number of bytes.
+ * @param crc Result of a previous call to continue from, or 0 to start.
+ * @return The CRC32 of the data.
+ */
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+inline uint32_t crc32(ByteSpan data, uint32_t crc = 0) {
+    return crc32(data.data(), data.size(), crc);
+}
+
+/**
+ * @brief Portable slicing-by-8 reference kernel, regardless of CPU features.
+ */
+uint32_t crc32Portable(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+/**
+ * @brief Returns the kernel crc32() dispatches to on this machine.
+ */
+Crc32Implementation activeCrc32Implementation();
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_CRC32_HPP
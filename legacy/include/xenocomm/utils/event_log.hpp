@@ -0,0 +1,119 @@
+#ifndef XENOCOMM_UTILS_EVENT_LOG_HPP
+#define XENOCOMM_UTILS_EVENT_LOG_HPP
+
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include "xenocomm/utils/task_scheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Magic leading each record of a binary event log ("XEV1").
+ */
+constexpr uint32_t EVENT_RECORD_MAGIC = 0x31564558;
+
+/**
+ * @brief Append-only event log file shared by every writer of the same path.
+ *
+ * write() only timestamps the message and hands it to a lock-free queue; a
+ * TaskScheduler task drains the queue shortly after and appends the whole
+ * batch through one long-lived file handle. A writer that finds the queue
+ * full drains it itself, so events are never dropped.
+ *
+ * Text logs keep one "<ctime timestamp>\n: <message>" entry per event, as
+ * the components' logs always had. Binary logs frame each event as magic,
+ * payload size, CRC-32 of the payload, microseconds since the epoch and the
+ * message bytes (all little-endian); readBinary() parses them back.
+ *
+ * If the file cannot be opened, the batch is dropped and opening is retried
+ * with the next one, so a log path whose directory appears later still works.
+ */
+class EventLog {
+public:
+    using Clock = std::chrono::system_clock;
+
+    enum class Format { Text, Binary };
+
+    struct Event {
+        Clock::time_point time;
+        std::string message;
+    };
+
+    /**
+     * @brief Returns the log of path, opening it on first use.
+     *
+     * The format is fixed by whoever opens the path first.
+     */
+    static std::shared_ptr<EventLog> open(const std::string& path, Format format = Format::Text);
+
+    /**
+     * @brief Writes what is queued and closes the file.
+     */
+    ~EventLog();
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    /**
+     * @brief Queues message, stamped with the current time. Safe from any thread.
+     */
+    void write(std::string message);
+
+    /**
+     * @brief Writes everything queued so far before returning.
+     */
+    void flush();
+
+    /**
+     * @brief Rotates the file once a batch takes it past maxBytes; 0 never rotates.
+     *
+     * The full file becomes path.1, path.1 becomes path.2 and so on, keeping
+     * maxFiles files in all counting the one being written; writing goes on
+     * in a new file. Shared by every writer of the path.
+     */
+    void setRotation(size_t maxBytes, size_t maxFiles);
+
+    const std::string& path() const { return path_; }
+    Format format() const { return format_; }
+
+    /**
+     * @brief Events of a binary log, stopping at the first truncated or corrupt record.
+     */
+    static std::vector<Event> readBinary(const std::string& path);
+
+    /**
+     * @brief How long a queued event may wait for its batch to be written.
+     */
+    static constexpr std::chrono::milliseconds FLUSH_DELAY{20};
+
+private:
+    EventLog(std::string path, Format format);
+
+    void drain();
+    void append(const Event& event);
+    void rotate();  // Requires drainMutex_
+
+    const std::string path_;
+    const Format format_;
+    MpscRing<Event*> queue_;
+    std::atomic<bool> scheduled_{false};  // A drain is pending on the scheduler
+    std::mutex drainMutex_;               // Makes whoever drains the queue's single consumer
+    std::FILE* file_ = nullptr;           // Guarded by drainMutex_
+    std::string buffer_;                  // Batch being written; guarded by drainMutex_
+    TaskScheduler::TaskId drainTask_ = TaskScheduler::INVALID_TASK;
+    std::atomic<size_t> rotateBytes_{0};
+    std::atomic<size_t> rotateFiles_{1};
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_EVENT_LOG_HPP
@@ -0,0 +1,91 @@
+#ifndef XENOCOMM_UTILS_FRAME_CODEC_HPP
+#define XENOCOMM_UTILS_FRAME_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief How a frame's payload length is written in front of it.
+ */
+enum class FrameLengthEncoding {
+    FIXED32,  ///< 4-byte big-endian length
+    VARINT    ///< LEB128 length: 1 byte up to 127, 2 bytes up to 16383, at most 5
+};
+
+/// Largest prefix encodeFramePrefix() writes
+constexpr size_t MAX_FRAME_PREFIX = 5;
+
+/**
+ * @brief Writes the length prefix for a payload of length bytes.
+ *
+ * @param out At least MAX_FRAME_PREFIX bytes
+ * @return Number of prefix bytes written
+ */
+size_t encodeFramePrefix(uint32_t length, FrameLengthEncoding encoding, uint8_t* out);
+
+/**
+ * @brief Splits a byte stream back into length-prefixed frames.
+ *
+ * Bytes are read straight into the decoder's buffer: prepare() returns free
+ * space at its tail, sized to the rest of the frame being assembled when that
+ * is larger, and commit() publishes what was written. next() then yields
+ * complete frames as views into the buffer, valid until the following
+ * prepare(). Any number of frames may arrive in one read.
+ */
+class FrameDecoder {
+public:
+    enum class Status {
+        FRAME,      ///< frame holds the next complete payload
+        NEED_MORE,  ///< The buffered bytes end mid-frame
+        TOO_LARGE,  ///< The next frame exceeds max_frame_size; the stream cannot be resynchronized
+        MALFORMED   ///< The length prefix is invalid
+    };
+
+    explicit FrameDecoder(FrameLengthEncoding encoding = FrameLengthEncoding::VARINT,
+                          size_t max_frame_size = 16 * 1024 * 1024);
+
+    /**
+     * @brief Returns at least min_space writable bytes after the buffered data.
+     */
+    MutableByteSpan prepare(size_t min_space);
+
+    /**
+     * @brief Marks count bytes of the last prepare() region as received.
+     */
+    void commit(size_t count);
+
+    /**
+     * @brief Copies data in; for callers that already hold the bytes elsewhere.
+     */
+    void feed(ByteSpan data);
+
+    Status next(ByteSpan& frame);
+
+    /**
+     * @brief Bytes still missing from the frame being assembled, 0 if unknown.
+     */
+    size_t missing() const;
+
+    size_t buffered() const { return end_ - begin_; }
+    void reset();
+
+private:
+    // Parses the prefix at begin_; returns its size, or 0 if incomplete
+    size_t parse_prefix(uint64_t& length, bool& malformed) const;
+
+    FrameLengthEncoding encoding_;
+    size_t max_frame_size_;
+    std::vector<uint8_t> buffer_;
+    size_t begin_ = 0;  // First unconsumed byte
+    size_t end_ = 0;    // One past the last received byte
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_FRAME_CODEC_HPP
@@ -0,0 +1,54 @@
+#ifndef XENOCOMM_UTILS_GF256_HPP
+#define XENOCOMM_UTILS_GF256_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Region kernels the GF(2^8) engine can dispatch to.
+ */
+enum class Gf256Implementation {
+    SCALAR,  ///< Portable per-byte table lookup
+    SSSE3,   ///< x86 split-nibble PSHUFB, 16 bytes per step
+    AVX2,    ///< x86 split-nibble VPSHUFB, 32 bytes per step
+    NEON     ///< ARM split-nibble TBL, 16 bytes per step
+};
+
+/**
+ * @brief Multiplies two elements of GF(2^8) with the polynomial x^8+x^4+x^3+x^2+1 (0x11D).
+ */
+uint8_t gf256Mul(uint8_t a, uint8_t b);
+
+/**
+ * @brief Multiplicative inverse in GF(2^8). The inverse of 0 is defined as 0.
+ */
+uint8_t gf256Inv(uint8_t a);
+
+/**
+ * @brief Computes dst[i] = coefficient * src[i] over a byte region.
+ *
+ * The fastest kernel the CPU supports is selected once at first use.
+ * src and dst may be the same buffer but must not otherwise overlap.
+ */
+void gf256MulRegion(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size);
+
+/**
+ * @brief Computes dst[i] ^= coefficient * src[i] over a byte region.
+ *
+ * This multiply-accumulate is the inner loop of Reed-Solomon encoding and
+ * reconstruction. src and dst must not overlap.
+ */
+void gf256MulAddRegion(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size);
+
+/**
+ * @brief Returns the kernel the region functions dispatch to on this machine.
+ */
+Gf256Implementation activeGf256Implementation();
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_GF256_HPP
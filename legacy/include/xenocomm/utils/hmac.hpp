@@ -0,0 +1,63 @@
+#ifndef XENOCOMM_UTILS_HMAC_HPP
+#define XENOCOMM_UTILS_HMAC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include "xenocomm/utils/byte_span.hpp"
+
+struct evp_mac_ctx_st;
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief HMAC-SHA256 with the key absorbed once.
+ *
+ * The key is scheduled into an OpenSSL EVP_MAC context at construction; the
+ * key itself is not retained. Each thread duplicates that context the first
+ * time it MACs under the key and restarts its duplicate for every later MAC,
+ * so steady-state MACs neither re-key nor copy contexts. (OpenSSL 3.0 still
+ * allocates a little inside the restart.) Copies share the keyed context,
+ * and mac() may be called concurrently on one instance.
+ */
+class HmacSha256 {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+
+    /**
+     * @brief An unkeyed instance; mac() fails until one is assigned.
+     */
+    HmacSha256() = default;
+
+    /**
+     * @brief Keys the MAC. Throws std::runtime_error if OpenSSL cannot.
+     */
+    explicit HmacSha256(ByteSpan key);
+
+    HmacSha256(const HmacSha256& other) = default;
+    HmacSha256& operator=(const HmacSha256& other) = default;
+    HmacSha256(HmacSha256&& other) noexcept;
+    HmacSha256& operator=(HmacSha256&& other) noexcept;
+
+    bool keyed() const { return ctx_ != nullptr; }
+
+    /**
+     * @brief Writes DIGEST_SIZE bytes of MAC over the concatenated parts.
+     *
+     * @return false if unkeyed or OpenSSL fails.
+     */
+    bool mac(std::initializer_list<ByteSpan> parts, uint8_t* out) const;
+
+    bool mac(ByteSpan data, uint8_t* out) const { return mac({data}, out); }
+
+private:
+    std::shared_ptr<evp_mac_ctx_st> ctx_;  // Keyed, never updated; threads MAC on duplicates
+    uint64_t id_ = 0;                      // Names the key in each thread's duplicates
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_HMAC_HPP
@@ -0,0 +1,63 @@
+#ifndef XENOCOMM_UTILS_LATENCY_HISTOGRAM_HPP
+#define XENOCOMM_UTILS_LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Fixed-size log-linear histogram of latencies, recordable from any thread.
+ *
+ * Values below 8 have a bucket each; above that every power of two is split
+ * into 8 linear sub-buckets, as in HdrHistogram, so any reported percentile
+ * is within 12.5% of the true value over the whole range. Recording is one
+ * relaxed increment with no allocation. Values beyond 2^40 are clamped.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_MAGNITUDE = 40;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS * (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2);
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t value);
+
+    /**
+     * @brief Adds another histogram's counts into this one.
+     */
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    uint64_t bucket_count(size_t bucket) const { return buckets_[bucket].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Upper bound of the bucket holding the given percentile (0-100), capped at max().
+     */
+    uint64_t value_at_percentile(double percentile) const;
+
+    void reset();
+
+    static size_t bucket_for(uint64_t value);
+    static uint64_t bucket_upper_bound(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_LATENCY_HISTOGRAM_HPP
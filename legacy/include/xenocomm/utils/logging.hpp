@@ -1,47 +1,231 @@
 #ifndef XENOCOMM_UTILS_LOGGING_HPP
 #define XENOCOMM_UTILS_LOGGING_HPP
 
-#include <iostream> // For a very basic placeholder
-
-// Placeholder logging macro - does nothing for now
-// TODO: Replace with a proper logging solution (e.g., spdlog, glog)
-#define XLOG_DEBUG(message) 
-#define XLOG_INFO(message)  
-#define XLOG_WARN(message)  
-#define XLOG_ERROR(message) 
-#define XLOG_CRITICAL(message)
-
-// Example of a slightly more functional placeholder if needed immediately:
-/*
-#define XLOG_LEVEL_DEBUG 0
-#define XLOG_LEVEL_INFO  1
-#define XLOG_LEVEL_WARN  2
-#define XLOG_LEVEL_ERROR 3
-#define XLOG_CURRENT_LEVEL XLOG_LEVEL_INFO // Set default logging level
-
-#define XLOG(level, message) \
-    do { \
-        if (level >= XLOG_CURRENT_LEVEL) { \
-            std::cout << "[" #level "] " << message << std::endl; \
-        } \
-    } while (false)
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include "xenocomm/utils/task_scheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
 
-#define XLOG_DEBUG(message)    XLOG(XLOG_LEVEL_DEBUG, message)
-#define XLOG_INFO(message)     XLOG(XLOG_LEVEL_INFO, message)
-#define XLOG_WARN(message)     XLOG(XLOG_LEVEL_WARN, message)
-#define XLOG_ERROR(message)    XLOG(XLOG_LEVEL_ERROR, message)
-#define XLOG_CRITICAL(message) XLOG(XLOG_LEVEL_ERROR, message) // Map critical to error for now
-*/
+// Numeric levels, so the compile-time floor can be compared in #if
+#define XENOCOMM_LOG_LEVEL_TRACE 0
+#define XENOCOMM_LOG_LEVEL_DEBUG 1
+#define XENOCOMM_LOG_LEVEL_INFO 2
+#define XENOCOMM_LOG_LEVEL_WARN 3
+#define XENOCOMM_LOG_LEVEL_ERROR 4
+#define XENOCOMM_LOG_LEVEL_CRITICAL 5
+#define XENOCOMM_LOG_LEVEL_OFF 6
+
+// Log sites below this level are removed by the preprocessor (the XENOCOMM_LOG_LEVEL CMake cache entry)
+#ifndef XENOCOMM_LOG_LEVEL
+#define XENOCOMM_LOG_LEVEL XENOCOMM_LOG_LEVEL_INFO
+#endif
 
 namespace xenocomm {
 namespace utils {
 
-// If logging functions are preferred over macros, declare them here.
-// For example:
-// void LogInfo(const std::string& message);
-// void LogError(const std::string& message);
+enum class LogLevel : int {
+    Trace = XENOCOMM_LOG_LEVEL_TRACE,
+    Debug = XENOCOMM_LOG_LEVEL_DEBUG,
+    Info = XENOCOMM_LOG_LEVEL_INFO,
+    Warn = XENOCOMM_LOG_LEVEL_WARN,
+    Error = XENOCOMM_LOG_LEVEL_ERROR,
+    Critical = XENOCOMM_LOG_LEVEL_CRITICAL,
+    Off = XENOCOMM_LOG_LEVEL_OFF
+};
+
+const char* logLevelName(LogLevel level);
+
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    std::chrono::system_clock::time_point time;
+    const char* file = "";  ///< Source file of the log site; a string literal
+    int line = 0;
+    std::string message;
+};
+
+/**
+ * @brief Destination of log records. write() may be called from any thread.
+ */
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const LogRecord& record) = 0;
+    virtual void flush() {}
+};
+
+/**
+ * @brief Writes one "<time> [LEVEL] file:line: message" line per record to a stdio stream.
+ */
+class StreamLogSink : public LogSink {
+public:
+    explicit StreamLogSink(std::FILE* stream = stderr) : stream_(stream) {}
+
+    void write(const LogRecord& record) override;
+    void flush() override;
+
+private:
+    std::FILE* stream_;
+    std::mutex mutex_;
+};
+
+/**
+ * @brief Hands records to another sink off the logging thread.
+ *
+ * write() only moves the record into a lock-free queue; a TaskScheduler task
+ * passes the queued records to the wrapped sink shortly after, in order. A
+ * writer that finds the queue full drains it itself, so records are never
+ * dropped, only written on the caller's thread. Destruction writes whatever
+ * is still queued.
+ */
+class AsyncLogSink : public LogSink {
+public:
+    explicit AsyncLogSink(std::shared_ptr<LogSink> target, size_t capacity = 4096);
+    ~AsyncLogSink() override;
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    void write(const LogRecord& record) override;
+
+    /**
+     * @brief Passes everything queued so far to the wrapped sink and flushes it.
+     */
+    void flush() override;
+
+    /**
+     * @brief How long a queued record may wait before it reaches the wrapped sink.
+     */
+    static constexpr std::chrono::milliseconds FLUSH_DELAY{20};
+
+private:
+    void drain();
+
+    const std::shared_ptr<LogSink> target_;
+    MpscRing<LogRecord*> queue_;
+    std::atomic<bool> scheduled_{false};  // A drain is pending on the scheduler
+    std::mutex drainMutex_;               // Makes whoever drains the queue's single consumer
+    TaskScheduler::TaskId drainTask_ = TaskScheduler::INVALID_TASK;
+};
+
+/**
+ * @brief Process-wide log level and sink used by the XLOG_* macros.
+ *
+ * A log site is compiled in only if its level is at least XENOCOMM_LOG_LEVEL;
+ * a compiled-in site whose level is below the runtime level() costs one relaxed
+ * load, and its arguments are neither evaluated nor formatted. The runtime level
+ * starts at Warn and the sink at a StreamLogSink on stderr; wrap a sink in an
+ * AsyncLogSink to keep the writes off hot paths.
+ */
+class Logger {
+public:
+    static LogLevel level() { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+    static void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    static bool enabled(LogLevel level) { return static_cast<int>(level) >= level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Replaces the sink; nullptr discards every record.
+     */
+    static void setSink(std::shared_ptr<LogSink> sink);
+    static std::shared_ptr<LogSink> sink();
+
+    static void write(LogLevel level, const char* file, int line, std::string message);
+    static void flush();
+
+private:
+    static std::atomic<int> level_;
+};
+
+namespace detail {
+
+inline void appendLogArgs(std::ostringstream& out, std::string_view format) {
+    out << format;
+}
+
+template <typename Arg, typename... Args>
+void appendLogArgs(std::ostringstream& out, std::string_view format, const Arg& arg, const Args&... args) {
+    for (size_t i = 0; i < format.size(); ++i) {
+        const char c = format[i];
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+            out << c;  // "{{" and "}}" are literal braces
+            ++i;
+        } else if (c == '{' && i + 1 < format.size() && format[i + 1] == '}') {
+            out << arg;
+            appendLogArgs(out, format.substr(i + 2), args...);
+            return;
+        } else {
+            out << c;
+        }
+    }
+    // More arguments than placeholders: the rest are dropped
+}
+
+} // namespace detail
+
+/**
+ * @brief Formats a log message, replacing each "{}" in format with the next argument's operator<<.
+ */
+template <typename... Args>
+std::string formatLog(std::string_view format, const Args&... args) {
+    if constexpr (sizeof...(Args) == 0) {
+        return std::string(format);
+    } else {
+        std::ostringstream out;
+        detail::appendLogArgs(out, format, args...);
+        return out.str();
+    }
+}
 
 } // namespace utils
 } // namespace xenocomm
 
-#endif // XENOCOMM_UTILS_LOGGING_HPP 
\ No newline at end of file
+// Formats and writes only when level is enabled at runtime; the arguments are evaluated only then
+#define XLOG_AT(level, ...) \
+    do { \
+        if (::xenocomm::utils::Logger::enabled(level)) { \
+            ::xenocomm::utils::Logger::write(level, __FILE__, __LINE__, ::xenocomm::utils::formatLog(__VA_ARGS__)); \
+        } \
+    } while (false)
+
+#if XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_TRACE
+#define XLOG_TRACE(...) XLOG_AT(::xenocomm::utils::LogLevel::Trace, __VA_ARGS__)
+#else
+#define XLOG_TRACE(...) static_cast<void>(0)
+#endif
+
+#if XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_DEBUG
+#define XLOG_DEBUG(...) XLOG_AT(::xenocomm::utils::LogLevel::Debug, __VA_ARGS__)
+#else
+#define XLOG_DEBUG(...) static_cast<void>(0)
+#endif
+
+#if XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_INFO
+#define XLOG_INFO(...) XLOG_AT(::xenocomm::utils::LogLevel::Info, __VA_ARGS__)
+#else
+#define XLOG_INFO(...) static_cast<void>(0)
+#endif
+
+#if XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_WARN
+#define XLOG_WARN(...) XLOG_AT(::xenocomm::utils::LogLevel::Warn, __VA_ARGS__)
+#else
+#define XLOG_WARN(...) static_cast<void>(0)
+#endif
+
+#if XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_ERROR
+#define XLOG_ERROR(...) XLOG_AT(::xenocomm::utils::LogLevel::Error, __VA_ARGS__)
+#else
+#define XLOG_ERROR(...) static_cast<void>(0)
+#endif
+
+#if XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_CRITICAL
+#define XLOG_CRITICAL(...) XLOG_AT(::xenocomm::utils::LogLevel::Critical, __VA_ARGS__)
+#else
+#define XLOG_CRITICAL(...) static_cast<void>(0)
+#endif
+
+#endif // XENOCOMM_UTILS_LOGGING_HPP
@@ -0,0 +1,66 @@
+#ifndef XENOCOMM_UTILS_MAPPED_FILE_HPP
+#define XENOCOMM_UTILS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "xenocomm/utils/byte_span.hpp"
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief A read-only memory mapping of part of an open file.
+ *
+ * Lets a file region be handed to anything that takes a ByteSpan without
+ * reading it into a buffer first; pages are faulted in from the page cache
+ * as they are touched. The mapping is private, so later writes to the file
+ * may or may not show through: map a region nobody is writing. The file
+ * descriptor need not stay open once the region is mapped.
+ */
+class MappedRegion {
+public:
+    MappedRegion() = default;
+
+    /**
+     * @brief Maps size bytes of fd starting at offset; valid() reports whether it worked.
+     *
+     * The offset need not be page aligned. Fails unless fd is a regular file
+     * at least offset + size bytes long.
+     */
+    MappedRegion(int fd, int64_t offset, size_t size);
+    ~MappedRegion();
+
+    MappedRegion(MappedRegion&& other) noexcept;
+    MappedRegion& operator=(MappedRegion&& other) noexcept;
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion& operator=(const MappedRegion&) = delete;
+
+    /**
+     * @brief Whether the region is mapped; an empty region always is.
+     */
+    bool valid() const { return valid_; }
+
+    /**
+     * @brief errno from the failed mapping, or 0.
+     */
+    int error() const { return error_; }
+
+    ByteSpan span() const { return ByteSpan(data_, size_); }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void unmap();
+
+    void* base_ = nullptr;        // Page-aligned start of the mapping
+    size_t mappedSize_ = 0;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool valid_ = true;
+    int error_ = 0;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_MAPPED_FILE_HPP
@@ -0,0 +1,107 @@
+#ifndef XENOCOMM_UTILS_MEMORY_BUDGET_HPP
+#define XENOCOMM_UTILS_MEMORY_BUDGET_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief A byte budget that buffers are charged against before they are allocated.
+ *
+ * tryAcquire() never blocks: it either charges the bytes or refuses, leaving
+ * the caller to push back (refuse a send, leave a fragment unacknowledged)
+ * rather than buffer without bound. Limits may change at any time; bytes
+ * already charged stay charged.
+ *
+ * Watermarks say early that the budget is running out. Once usage reaches
+ * the high watermark, watermark callbacks are told pressure is on; once it
+ * falls back to the low watermark they are told it is off. Callbacks run on
+ * the thread whose acquire or release crossed the mark, one at a time and in
+ * order, and may acquire or release themselves; a transition overtaken by a
+ * later one can be skipped, so treat each call as the current state.
+ */
+class MemoryBudget {
+public:
+    using WatermarkCallback = std::function<void(bool high, size_t usedBytes)>;
+    using CallbackId = uint64_t;
+
+    /**
+     * @param limitBytes 0 for no limit
+     * @param highWatermark Fraction of the limit at which pressure turns on
+     * @param lowWatermark Fraction at which it turns off again, at most highWatermark
+     */
+    explicit MemoryBudget(size_t limitBytes = 0, double highWatermark = 0.8, double lowWatermark = 0.5);
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    /**
+     * @brief Process-wide budget, unlimited until setLimit() is called.
+     */
+    static MemoryBudget& shared();
+
+    /**
+     * @brief Charges bytes if they fit under the limit.
+     */
+    bool tryAcquire(size_t bytes);
+
+    /**
+     * @brief Returns bytes charged by an earlier tryAcquire().
+     */
+    void release(size_t bytes);
+
+    /**
+     * @brief Whether bytes could ever be charged, i.e. they are within the limit.
+     */
+    bool fits(size_t bytes) const {
+        size_t limit = limit_.load(std::memory_order_relaxed);
+        return limit == 0 || bytes <= limit;
+    }
+
+    void setLimit(size_t limitBytes, double highWatermark = 0.8, double lowWatermark = 0.5);
+
+    size_t limit() const { return limit_.load(std::memory_order_relaxed); }
+    size_t used() const { return used_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether pressure is on: usage reached the high watermark and has not fallen to the low one.
+     */
+    bool underPressure() const { return high_.load(std::memory_order_acquire); }
+
+    CallbackId addWatermarkCallback(WatermarkCallback callback);
+
+    /**
+     * @brief Once this returns the callback is not running and will not run.
+     */
+    void removeWatermarkCallback(CallbackId id);
+
+private:
+    void updateWatermark(size_t used);
+
+    std::atomic<size_t> limit_{0};
+    std::atomic<size_t> used_{0};
+    std::atomic<size_t> highBytes_{0};  // Thresholds in bytes; 0 while unlimited
+    std::atomic<size_t> lowBytes_{0};
+    std::atomic<bool> high_{false};
+
+    std::mutex stateMutex_;    // Decides transitions of high_
+    uint64_t transitions_ = 0;
+
+    // Held while callbacks run, so they are delivered one at a time and removal can wait one out
+    std::recursive_mutex callbackMutex_;
+    uint64_t delivered_ = 0;   // Last transition passed to the callbacks
+    std::vector<std::pair<CallbackId, WatermarkCallback>> callbacks_;
+    CallbackId nextCallbackId_ = 1;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_MEMORY_BUDGET_HPP
@@ -0,0 +1,73 @@
+#ifndef XENOCOMM_UTILS_MESSAGE_ARENA_HPP
+#define XENOCOMM_UTILS_MESSAGE_ARENA_HPP
+
+#include "xenocomm/utils/contention_profile.hpp"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief std::pmr memory for the transient objects of one message, released all at once.
+ *
+ * Allocation is a pointer bump into one block and deallocation does nothing;
+ * owners that free and reallocate within a message (ciphertexts of
+ * acknowledged fragments) recycle those objects themselves. Destroying the
+ * arena returns its block to a small per-thread cache for the next message.
+ * A message that outgrows the block takes the extra from the heap, and the
+ * block it returns is enlarged so the next message fits.
+ *
+ * Not thread-safe: an arena is used by whichever thread holds its message's lock.
+ */
+class MessageArena {
+public:
+    static constexpr size_t DEFAULT_SIZE = 16 * 1024;
+    static constexpr size_t MAX_CACHED_SIZE = 1024 * 1024;  // Larger blocks are freed rather than cached
+
+    explicit MessageArena(size_t initial_size = DEFAULT_SIZE);
+    ~MessageArena();
+
+    MessageArena(const MessageArena&) = delete;
+    MessageArena& operator=(const MessageArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &monotonic_; }
+
+    /**
+     * @brief Bytes taken from the heap because the block was full.
+     */
+    size_t overflow_bytes() const { return upstream_.allocated; }
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+private:
+    // Counts what the block could not hold, to size the next one
+    struct OverflowResource : std::pmr::memory_resource {
+        size_t allocated = 0;
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            allocated += bytes;
+            XPROFILE_ALLOCATION("message_arena", bytes);
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    Block block_;
+    OverflowResource upstream_;
+    std::pmr::monotonic_buffer_resource monotonic_;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_MESSAGE_ARENA_HPP
@@ -0,0 +1,231 @@
+#ifndef XENOCOMM_UTILS_METRICS_REGISTRY_HPP
+#define XENOCOMM_UTILS_METRICS_REGISTRY_HPP
+
+#include "xenocomm/utils/latency_histogram.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/// Label name/value pairs identifying one series of a metric family
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/// Number of cache-line aligned shards a counter or histogram spreads its threads over
+constexpr size_t METRIC_SHARDS = 16;
+
+/**
+ * @brief Monotonic counter; each thread adds to its own cache line.
+ */
+class MetricCounter {
+public:
+    MetricCounter() = default;
+    MetricCounter(const MetricCounter&) = delete;
+    MetricCounter& operator=(const MetricCounter&) = delete;
+
+    void add(uint64_t amount = 1);
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, METRIC_SHARDS> shards_;
+};
+
+/**
+ * @brief Value that can go up and down, such as a queue depth or a window size.
+ */
+class MetricGauge {
+public:
+    MetricGauge() = default;
+    MetricGauge(const MetricGauge&) = delete;
+    MetricGauge& operator=(const MetricGauge&) = delete;
+
+    void set(double value);
+    void add(double amount);
+    double value() const;
+
+private:
+    std::atomic<uint64_t> bits_{0};  // The double's bit pattern, so add() can compare-and-swap it
+};
+
+/**
+ * @brief Distribution of integer samples, such as latencies in microseconds.
+ *
+ * Each thread records into its own LatencyHistogram, allocated on first use,
+ * so recording is wait-free and never contended. Exported bucket bounds are
+ * one below each power of two (0, 1, 3, 7, ...), where counts are exact.
+ */
+class MetricHistogram {
+public:
+    MetricHistogram() = default;
+    ~MetricHistogram();
+    MetricHistogram(const MetricHistogram&) = delete;
+    MetricHistogram& operator=(const MetricHistogram&) = delete;
+
+    void record(uint64_t value);
+
+    /**
+     * @brief Adds every shard's samples into out.
+     */
+    void collect(LatencyHistogram& out) const;
+
+private:
+    std::array<std::atomic<LatencyHistogram*>, METRIC_SHARDS> shards_{};
+};
+
+/**
+ * @brief Sink a collector reports values into while the registry is being exported.
+ *
+ * Collectors adapt statistics a subsystem already keeps (TransmissionStats,
+ * PoolStats and the like) without moving them into registry metrics. A
+ * counter's name omits the _total suffix, which the exposition adds.
+ */
+class MetricsWriter {
+public:
+    struct Sample {
+        std::string suffix;  // Appended to the family name, e.g. "_bucket"
+        MetricLabels labels;
+        double value;
+    };
+
+    struct Family {
+        std::string type;  // "counter", "gauge", "histogram" or "summary"
+        std::string help;
+        std::vector<Sample> samples;
+    };
+
+    void counter(const std::string& name, const std::string& help, double value, const MetricLabels& labels = {});
+    void gauge(const std::string& name, const std::string& help, double value, const MetricLabels& labels = {});
+    void histogram(const std::string& name, const std::string& help, const LatencyHistogram& histogram,
+                   const MetricLabels& labels = {});
+
+    /**
+     * @brief A distribution reported as precomputed quantiles (0-1) with its count and sum.
+     */
+    void summary(const std::string& name, const std::string& help, uint64_t count, double sum,
+                 const std::vector<std::pair<double, double>>& quantiles, const MetricLabels& labels = {});
+
+    const std::map<std::string, Family>& families() const { return families_; }
+
+private:
+    Family& family(const std::string& name, const char* type, const std::string& help);
+
+    std::map<std::string, Family> families_;
+};
+
+class MetricsRegistry;
+
+/**
+ * @brief Keeps a collector registered until it is destroyed or reset.
+ *
+ * A subsystem holds one as its last member, so the collector is removed
+ * before any of the state it reads is torn down.
+ */
+class MetricsRegistration {
+public:
+    MetricsRegistration() = default;
+    MetricsRegistration(MetricsRegistry* registry, uint64_t id) : registry_(registry), id_(id) {}
+    ~MetricsRegistration() { reset(); }
+
+    MetricsRegistration(MetricsRegistration&& other) noexcept;
+    MetricsRegistration& operator=(MetricsRegistration&& other) noexcept;
+    MetricsRegistration(const MetricsRegistration&) = delete;
+    MetricsRegistration& operator=(const MetricsRegistration&) = delete;
+
+    void reset();
+    bool active() const { return registry_ != nullptr; }
+
+private:
+    MetricsRegistry* registry_ = nullptr;
+    uint64_t id_ = 0;
+};
+
+enum class ExpositionFormat {
+    PROMETHEUS,   ///< Prometheus text format 0.0.4
+    OPENMETRICS   ///< OpenMetrics 1.0 text format
+};
+
+/**
+ * @brief The one place every subsystem's metrics are registered and exported from.
+ *
+ * Metrics are created on first request and live as long as the registry;
+ * asking again for the same name and labels returns the same object, so hot
+ * paths look a metric up once and keep the reference. Names must match
+ * [a-zA-Z_:][a-zA-Z0-9_:]* and keep one type across all label sets, or
+ * std::invalid_argument is thrown.
+ *
+ * Collectors run on the exporting thread each time the registry is exported.
+ * A collector must not register or remove collectors itself.
+ */
+class MetricsRegistry {
+public:
+    using Collector = std::function<void(MetricsWriter& writer)>;
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief The process-wide registry that subsystems register into by default.
+     */
+    static MetricsRegistry& shared();
+
+    MetricCounter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    MetricGauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    MetricHistogram& histogram(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    MetricsRegistration addCollector(Collector collector);
+
+    /**
+     * @brief Every metric and collector value, in the text format scrapers read.
+     */
+    std::string exposition(ExpositionFormat format = ExpositionFormat::PROMETHEUS) const;
+
+    /**
+     * @brief Every metric and collector value, grouped by family name.
+     */
+    MetricsWriter collect() const;
+
+    static bool validName(const std::string& name);
+
+private:
+    friend class MetricsRegistration;
+
+    struct Series {
+        MetricLabels labels;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    struct Entry {
+        std::string type;
+        std::string help;
+        std::map<MetricLabels, Series> series;
+    };
+
+    Series& series(const std::string& name, const char* type, const std::string& help, const MetricLabels& labels);
+    void removeCollector(uint64_t id);
+
+    mutable std::mutex metrics_mutex_;
+    std::map<std::string, Entry> metrics_;
+    mutable std::mutex collectors_mutex_;  // Held while collectors run, so removal waits for them
+    std::map<uint64_t, Collector> collectors_;
+    uint64_t next_collector_id_ = 1;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_METRICS_REGISTRY_HPP
@@ -0,0 +1,112 @@
+#ifndef XENOCOMM_UTILS_MPSC_RING_HPP
+#define XENOCOMM_UTILS_MPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Bounded lock-free queue for many producers and one consumer.
+ *
+ * Each cell carries a sequence number that tells producers whether it is
+ * free and the consumer whether it has been published (Vyukov's bounded
+ * queue). Producers claim a cell with a single CAS on the tail; the consumer
+ * never contends with them except through the cell it is reading. No memory
+ * is allocated after construction, so T should be a small trivially
+ * copyable descriptor rather than an owning object.
+ *
+ * try_push() may be called from any thread; try_pop() and empty() only from
+ * the single consumer.
+ */
+template <typename T>
+class MpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "MpscRing stores plain descriptors");
+
+public:
+    /**
+     * @param capacity Number of cells, rounded up to a power of two
+     */
+    explicit MpscRing(size_t capacity = 1024) : mask_(round_up(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Appends value; returns false if the ring is full.
+     */
+    bool try_push(const T& value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (lag == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;  // The consumer has not freed this cell yet
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest published value; returns false if none is ready.
+     */
+    bool try_pop(T& value) {
+        Cell& cell = cells_[head_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    /**
+     * @brief Whether the next cell is unpublished. A push may still be in progress.
+     */
+    bool empty() const {
+        return cells_[head_ & mask_].sequence.load(std::memory_order_acquire) != head_ + 1;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t round_up(size_t value) {
+        size_t capacity = 2;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0;  // Consumer-owned
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_MPSC_RING_HPP
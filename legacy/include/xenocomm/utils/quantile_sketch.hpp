@@ -0,0 +1,80 @@
+#ifndef XENOCOMM_UTILS_QUANTILE_SKETCH_HPP
+#define XENOCOMM_UTILS_QUANTILE_SKETCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Quantiles of a sliding window of non-negative values, DDSketch-style.
+ *
+ * Each positive value is counted in the bucket ceil(log_gamma(value)) with
+ * gamma = (1 + a) / (1 - a) for relative accuracy a, so every reported
+ * quantile, minimum and maximum is within a of a value actually in the set.
+ * Values up to 1e-9 share a zero bucket. Because buckets are plain counts,
+ * values can be removed as they leave a window and sketches merge by adding
+ * counts. The mean and standard deviation are kept exactly.
+ *
+ * Adding and removing are O(1); buckets are only allocated when a value
+ * falls outside the range seen so far. Reading a quantile walks the buckets,
+ * a few hundred per decade of range, independent of the number of values.
+ * Not thread-safe.
+ */
+class QuantileSketch {
+public:
+    explicit QuantileSketch(double relativeAccuracy = 0.01);
+
+    /**
+     * @brief Counts value. NaN and infinite values are ignored; negatives count as zero.
+     */
+    void add(double value);
+
+    /**
+     * @brief Uncounts a value previously passed to add().
+     */
+    void remove(double value);
+
+    /**
+     * @brief Adds another sketch's counts into this one; both must have the same accuracy.
+     */
+    void merge(const QuantileSketch& other);
+
+    void clear();
+
+    uint64_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    double mean() const;
+    double standardDeviation() const;
+
+    /**
+     * @brief The value of rank floor(q * count()) + 1 in sorted order, for q in [0, 1]; 0 if empty.
+     */
+    double quantile(double q) const;
+
+    double min() const { return quantile(0.0); }
+    double max() const { return quantile(1.0); }
+
+    double relativeAccuracy() const { return relativeAccuracy_; }
+
+private:
+    bool bucketFor(double value, int& index) const;  // False for the zero bucket
+    double bucketValue(int index) const;
+    void grow(int index);
+
+    double relativeAccuracy_;
+    double logGamma_;
+    std::vector<uint64_t> buckets_;  // buckets_[i] counts values in bucket offset_ + i
+    int offset_ = 0;
+    uint64_t zeroCount_ = 0;
+    uint64_t count_ = 0;
+    long double sum_ = 0;
+    long double sumSquares_ = 0;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_QUANTILE_SKETCH_HPP
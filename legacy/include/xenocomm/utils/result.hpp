@@ -4,12 +4,79 @@
 #include <optional>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 namespace xenocomm {
 namespace utils {
 
+// Failures common enough on hot paths to be worth a code; anything else is Unknown with a free-form message
+enum class ErrorCode : uint16_t {
+    None = 0,
+    Unknown,
+    IncompleteTransmission,
+    NoAcknowledgmentPending,
+    AcknowledgmentTimeout,
+    ReceiveTimeout,
+    ReceiveFailed,
+    NoTransport,
+    SecurityRequirementsNotMet,
+    ErrorCheckMismatch,
+    InvalidFragmentHeader,
+    Cancelled,
+    BufferFull,
+    DeadlineExceeded
+};
+
+// Fixed text of a code, built once per process
+inline const std::string& error_code_message(ErrorCode code) {
+    static const std::string messages[] = {
+        "",
+        "Unknown error",
+        "Incomplete transmission",
+        "No acknowledgment pending",
+        "Acknowledgment timeout",
+        "Failed to receive fragment: timed out",
+        "Failed to receive fragment",
+        "No transport attached",
+        "Security requirements not met",
+        "Error check mismatch",
+        "Invalid fragment header",
+        "Operation cancelled",
+        "Buffer full",
+        "Deadline exceeded",
+    };
+    const auto index = static_cast<size_t>(code);
+    return index < sizeof(messages) / sizeof(messages[0]) ? messages[index] : messages[1];
+}
+
+// An error code plus, only when there is one, a message of its own. A bare
+// code allocates nothing; its text is the shared error_code_message().
+class Error {
+public:
+    Error() = default;
+    Error(ErrorCode code) : code_(code) {}
+    // "<code text>: <context>"
+    Error(ErrorCode code, const std::string& context)
+        : code_(code), message_(error_code_message(code) + ": " + context) {}
+    // Free-form message, as Result has always carried
+    Error(const std::string& message) : message_(message) {}
+    Error(std::string&& message) : message_(std::move(message)) {}
+
+    ErrorCode code() const { return code_; }
+    const std::string& message() const {
+        return code_ == ErrorCode::Unknown || !message_.empty() ? message_ : error_code_message(code_);
+    }
+
+    bool operator==(ErrorCode code) const { return code_ == code; }
+    bool operator!=(ErrorCode code) const { return code_ != code; }
+
+private:
+    ErrorCode code_ = ErrorCode::Unknown;
+    std::string message_;
+};
+
 // Generic Result<T> template
-// Holds either a value of type T or an error message
+// Holds either a value of type T or an Error
 
 template <typename T>
 class Result {
@@ -18,18 +85,24 @@ public:
     Result(const T& value) : data_(value) {}
     Result(T&& value) : data_(std::move(value)) {}
     // Error constructor
-    Result(const std::string& error) : data_(error) {}
-    Result(std::string&& error) : data_(std::move(error)) {}
+    Result(const std::string& error) : data_(Error(error)) {}
+    Result(std::string&& error) : data_(Error(std::move(error))) {}
+    Result(ErrorCode code) : data_(Error(code)) {}
+    Result(const Error& error) : data_(error) {}
+    Result(Error&& error) : data_(std::move(error)) {}
 
     bool has_value() const { return std::holds_alternative<T>(data_); }
-    bool has_error() const { return std::holds_alternative<std::string>(data_); }
+    bool has_error() const { return std::holds_alternative<Error>(data_); }
 
     const T& value() const { return std::get<T>(data_); }
     T& value() { return std::get<T>(data_); }
-    const std::string& error() const { return std::get<std::string>(data_); }
+    const std::string& error() const { return std::get<Error>(data_).message(); }
+    // ErrorCode::None on success; compare this rather than error() text
+    ErrorCode error_code() const { return has_error() ? std::get<Error>(data_).code() : ErrorCode::None; }
+    const Error& error_info() const { return std::get<Error>(data_); }
 
 private:
-    std::variant<T, std::string> data_;
+    std::variant<T, Error> data_;
 };
 
 // Specialization for void
@@ -42,14 +115,19 @@ public:
     // Error constructor
     Result(const std::string& error) : success_(false), error_(error) {}
     Result(std::string&& error) : success_(false), error_(std::move(error)) {}
+    Result(ErrorCode code) : success_(false), error_(code) {}
+    Result(const Error& error) : success_(false), error_(error) {}
+    Result(Error&& error) : success_(false), error_(std::move(error)) {}
 
     bool has_value() const { return success_; }
     bool has_error() const { return !success_; }
-    const std::string& error() const { return error_; }
+    const std::string& error() const { return error_.message(); }
+    ErrorCode error_code() const { return success_ ? ErrorCode::None : error_.code(); }
+    const Error& error_info() const { return error_; }
 
 private:
     bool success_ = false;
-    std::string error_;
+    Error error_;
 };
 
 } // namespace utils
@@ -58,4 +136,4 @@ private:
 // For convenience, provide a top-level alias in the global namespace
 namespace xenocomm {
 using utils::Result;
-} 
\ No newline at end of file
+}
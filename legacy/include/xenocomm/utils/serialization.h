@@ -3,20 +3,47 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string_view>
 #include <xenocomm/core/capability_signaler.h> // For Capability struct
 
 namespace xenocomm {
 namespace utils {
 
+/**
+ * @brief Leading byte of a single encoded capability (format version 1).
+ */
+constexpr uint8_t CAPABILITY_FORMAT_V1 = 0xC1;
+
+/**
+ * @brief Leading byte of an encoded capability set (format version 1).
+ */
+constexpr uint8_t CAPABILITY_SET_FORMAT_V1 = 0xC2;
+
+/**
+ * @brief Appends value as an unsigned LEB128 varint, as used by the capability formats.
+ */
+void appendVarint(uint64_t value, std::vector<uint8_t>& outBuffer);
+
+/**
+ * @brief Reads an unsigned LEB128 varint with bounds checking.
+ *
+ * @param[out] bytesRead Optional pointer to store the number of bytes consumed.
+ * @return False if the data ends first or the value does not fit in 64 bits.
+ */
+bool readVarint(const uint8_t* data, size_t size, uint64_t& value, size_t* bytesRead = nullptr);
+
 /**
  * @brief Serializes a Capability object into a binary format.
  *
  * The format is:
- * - name: Length (uint32_t) followed by the string bytes.
- * - version: major (uint16_t), minor (uint16_t), patch (uint16_t).
- * - parameters: Count (uint32_t), followed by Key Length (uint32_t), Key Bytes,
- *   Value Length (uint32_t), Value Bytes for each parameter.
- * All multi-byte integers are stored in network byte order (big-endian).
+ * - format: one byte, CAPABILITY_FORMAT_V1.
+ * - name: Length (varint) followed by the string bytes.
+ * - version: major (uint16_t), minor (uint16_t), patch (uint16_t), big-endian.
+ * - parameters: Count (varint), followed by Key Length (varint), Key Bytes,
+ *   Value Length (varint), Value Bytes for each parameter, in key order.
+ * Varints are unsigned LEB128: seven bits per byte, low bits first.
  *
  * @param cap The Capability object to serialize.
  * @param outBuffer The vector to append the serialized bytes to. Existing contents are preserved.
@@ -37,11 +64,125 @@ void serializeCapability(const core::Capability& cap, std::vector<uint8_t>& outB
  */
 bool deserializeCapability(const uint8_t* data, size_t size, core::Capability& outCap, size_t* bytesRead = nullptr);
 
-// TODO: Consider adding functions for serializing/deserializing multiple capabilities into a single blob.
-// e.g., serializeCapabilities(const std::vector<core::Capability>&, std::vector<uint8_t>&)
-//       deserializeCapabilities(const uint8_t*, size_t, std::vector<core::Capability>&) -> bool
+/**
+ * @brief Serializes a set of capabilities, such as everything one agent offers.
+ *
+ * The format is:
+ * - format: one byte, CAPABILITY_SET_FORMAT_V1.
+ * - string table: Count (varint), then Length (varint) and bytes of each
+ *   distinct name, parameter key and parameter value, each stored once.
+ * - capabilities: Count (varint), then for each the name's table index
+ *   (varint), the version triple as in serializeCapability, and a parameter
+ *   count (varint) followed by key index and value index (varints) per parameter.
+ *
+ * @param caps The capabilities to serialize.
+ * @param outBuffer The vector to append the serialized bytes to. Existing contents are preserved.
+ */
+void serializeCapabilitySet(const std::vector<core::Capability>& caps, std::vector<uint8_t>& outBuffer);
+
+/**
+ * @brief Deserializes a capability set written by serializeCapabilitySet.
+ *
+ * @return True if the whole buffer was a valid set, false otherwise.
+ */
+bool deserializeCapabilitySet(const uint8_t* data, size_t size, std::vector<core::Capability>& outCaps);
+
+/**
+ * @brief Read-only view of one encoded capability, decoded in place.
+ *
+ * Strings are views into the encoded buffer, which must outlive the view,
+ * and parameters are scanned on demand, so checking an advertised capability
+ * against a requirement allocates nothing. Views are produced by
+ * CapabilityView::parse for a single capability and by CapabilitySetView
+ * for the entries of a set.
+ */
+class CapabilityView {
+public:
+    /**
+     * @brief Parses a single capability written by serializeCapability.
+     *
+     * @param[out] bytesRead Optional pointer to store the number of bytes consumed.
+     * @return The view, or std::nullopt if the bytes are not a valid encoding.
+     */
+    static std::optional<CapabilityView> parse(const uint8_t* data, size_t size, size_t* bytesRead = nullptr);
+
+    std::string_view name() const { return name_; }
+    const core::Version& version() const { return version_; }
+    size_t parameterCount() const { return parameterCount_; }
+
+    /**
+     * @brief The value of a parameter, if the capability has it.
+     */
+    std::optional<std::string_view> parameter(std::string_view key) const;
+
+    /**
+     * @brief Same result as core::Capability::matches, evaluated on the encoded bytes.
+     */
+    bool matches(const core::Capability& required, bool allowPartial = false) const;
+
+    /**
+     * @brief Copies the capability out of the buffer.
+     */
+    core::Capability toCapability() const;
+
+    /**
+     * @brief Calls fn(key, value) with each parameter in key order.
+     */
+    template <typename Fn>
+    void forEachParameter(Fn&& fn) const {
+        const uint8_t* p = parameters_;
+        for (size_t i = 0; i < parameterCount_; ++i) {
+            std::string_view key = nextString(p);
+            std::string_view value = nextString(p);
+            fn(key, value);
+        }
+    }
+
+private:
+    friend class CapabilitySetView;
+
+    // Reads a string already validated by parse(), advancing p past it
+    std::string_view nextString(const uint8_t*& p) const;
+
+    std::string_view name_;
+    core::Version version_;
+    size_t parameterCount_{0};
+    const uint8_t* parameters_{nullptr};
+    // Set for entries of a capability set, whose strings are table indices
+    const std::vector<std::string_view>* table_{nullptr};
+};
+
+/**
+ * @brief Read-only view of an encoded capability set, decoded in place.
+ *
+ * parse() validates the whole buffer once and indexes the string table;
+ * after that entries are decoded on demand without copying any string.
+ * The buffer must outlive the view, and the view the entries taken from it.
+ */
+class CapabilitySetView {
+public:
+    /**
+     * @return The view, or std::nullopt if the bytes are not a valid set encoding.
+     */
+    static std::optional<CapabilitySetView> parse(const uint8_t* data, size_t size);
+
+    size_t size() const { return entries_.size(); }
+
+    CapabilityView operator[](size_t index) const;
+
+    /**
+     * @brief Whether any capability in the set satisfies required.
+     */
+    bool anyMatches(const core::Capability& required, bool allowPartial = false) const;
+
+    std::vector<core::Capability> toCapabilities() const;
+
+private:
+    std::vector<std::string_view> table_;
+    std::vector<const uint8_t*> entries_;  // Start of each capability's name index
+};
 
 } // namespace utils
 } // namespace xenocomm
 
-#endif // XENOCOMM_UTILS_SERIALIZATION_H 
\ No newline at end of file
+#endif // XENOCOMM_UTILS_SERIALIZATION_H
@@ -0,0 +1,117 @@
+#ifndef XENOCOMM_UTILS_TASK_SCHEDULER_HPP
+#define XENOCOMM_UTILS_TASK_SCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief A few worker threads running the recurring work of many components.
+ *
+ * Components with background work that may block (strategy updates, flushing
+ * batched records, key maintenance) register it here instead of each running
+ * a thread that mostly sleeps, so the thread count no longer grows with the
+ * number of channels. Work that never blocks belongs on EventReactor or
+ * TimerService timers instead.
+ *
+ * A task runs periodically, when asked to, or both. It never runs on two
+ * workers at once: requests made while it runs take effect after it returns.
+ * Exceptions it throws are caught and dropped.
+ *
+ * cancel() guarantees the task is not running and will not run once it
+ * returns. Called from the task itself it returns immediately.
+ */
+class TaskScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TaskId = uint64_t;
+    using Task = std::function<void()>;
+
+    static constexpr TaskId INVALID_TASK = 0;
+
+    /**
+     * @brief Starts the worker threads.
+     */
+    explicit TaskScheduler(size_t threads = 2);
+
+    /**
+     * @brief Stops and joins the workers, after any running tasks return. Pending runs are dropped.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Process-wide scheduler for components that do not bring their own.
+     */
+    static TaskScheduler& shared();
+
+    /**
+     * @brief Registers task without running it; it runs when runBy() or runNow() asks.
+     */
+    TaskId add(Task task);
+
+    /**
+     * @brief Runs task every interval, counted from the end of one run to the start of the next.
+     */
+    TaskId scheduleEvery(std::chrono::milliseconds interval, Task task);
+
+    /**
+     * @brief Runs the task no later than deadline; an earlier pending run stands.
+     */
+    void runBy(TaskId id, Clock::time_point deadline);
+
+    /**
+     * @brief Runs the task as soon as a worker is free.
+     */
+    void runNow(TaskId id);
+
+    /**
+     * @brief Removes a task. Unknown ids are ignored.
+     */
+    void cancel(TaskId id);
+
+    /**
+     * @brief Number of registered tasks.
+     */
+    size_t size() const;
+
+private:
+    struct Entry {
+        Task task;
+        std::chrono::milliseconds interval{0};     // 0 when not periodic
+        Clock::time_point due = Clock::time_point::max();  // max when not queued
+        Clock::time_point rerun = Clock::time_point::max(); // Requested while running
+        bool running = false;
+        bool cancelled = false;
+    };
+
+    void queue(TaskId id, Entry& entry, Clock::time_point deadline);
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // Signals workers
+    std::condition_variable finished_;  // Signals cancel() that a task returned
+    std::unordered_map<TaskId, Entry> tasks_;
+    std::set<std::pair<Clock::time_point, TaskId>> queue_;  // Queued runs, earliest first
+    TaskId nextId_ = 1;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_TASK_SCHEDULER_HPP
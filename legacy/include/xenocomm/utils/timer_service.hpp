@@ -0,0 +1,103 @@
+#ifndef XENOCOMM_UTILS_TIMER_SERVICE_HPP
+#define XENOCOMM_UTILS_TIMER_SERVICE_HPP
+
+#include "xenocomm/utils/timer_wheel.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief One thread running callbacks from a HierarchicalTimerWheel.
+ *
+ * Components with deadlines (session expiry, response timeouts) schedule a
+ * callback per deadline instead of running their own sweep thread, so the
+ * cost of expiry is proportional to the timers that actually fire. The
+ * thread sleeps until the wheel's next wakeup rather than polling.
+ *
+ * Callbacks run on the service thread, one at a time, without the service
+ * lock held, so they may schedule, reschedule or cancel timers. They must be
+ * short; anything slow belongs on another thread.
+ *
+ * cancel() guarantees the callback is not running and will not run once it
+ * returns. Called from the callback itself it returns immediately.
+ */
+class TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    /**
+     * @brief Starts the service thread.
+     *
+     * @param resolution Granularity of deadlines
+     */
+    explicit TimerService(std::chrono::milliseconds resolution = std::chrono::milliseconds(1));
+
+    /**
+     * @brief Stops and joins the service thread. Pending timers are dropped.
+     */
+    ~TimerService();
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * @brief Process-wide service for components that do not bring their own.
+     */
+    static TimerService& shared();
+
+    /**
+     * @brief Runs callback once at deadline.
+     */
+    TimerId scheduleAt(Clock::time_point deadline, Callback callback);
+
+    /**
+     * @brief Runs callback once after delay.
+     */
+    TimerId scheduleAfter(std::chrono::milliseconds delay, Callback callback);
+
+    /**
+     * @brief Moves a pending timer to a new deadline.
+     *
+     * @return false if the timer already fired, is firing, or was cancelled
+     */
+    bool reschedule(TimerId id, Clock::time_point deadline);
+
+    /**
+     * @brief Cancels a timer. Unknown or already fired ids are ignored.
+     *
+     * @return true if the timer was pending and now will never run
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Number of timers waiting to fire.
+     */
+    size_t pending() const;
+
+private:
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // Signals the service thread
+    std::condition_variable finished_;  // Signals cancel() that a callback returned
+    HierarchicalTimerWheel<Callback> wheel_;
+    TimerId running_ = INVALID_TIMER;   // Timer whose callback is executing
+    Clock::time_point sleep_until_ = Clock::time_point::max();  // When the thread next wakes by itself
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_TIMER_SERVICE_HPP
@@ -0,0 +1,448 @@
+#ifndef XENOCOMM_UTILS_TIMER_WHEEL_HPP
+#define XENOCOMM_UTILS_TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Hashed timing wheel for deadlines that are polled from hot paths.
+ *
+ * Deadlines are bucketed into slots of a fixed resolution, so scheduling is
+ * O(1) and expire() only touches the slots that elapsed since the previous
+ * call rather than every pending timer. Deadlines further out than one
+ * revolution share a slot with nearer ones and are simply kept until their
+ * time comes.
+ *
+ * Cancellation is lazy: the wheel never removes a timer early. Owners that
+ * move or drop a deadline just schedule the new one (or nothing) and ignore
+ * keys that expire() reports but that no longer refer to anything due.
+ *
+ * The slots are allocated from resource, so an owner with its own arena can
+ * keep the wheel's storage there too.
+ */
+template <typename Key>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(1),
+                        size_t slot_count = 256,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : resolution_(std::max(resolution, std::chrono::milliseconds(1))),
+          slots_(std::max<size_t>(slot_count, 1), resource),
+          current_tick_(to_tick(Clock::now())) {}
+
+    /**
+     * @brief Schedules key to expire at deadline. Past deadlines fire on the next expire().
+     */
+    void schedule(const Key& key, Clock::time_point deadline) {
+        uint64_t tick = std::max(to_tick(deadline), current_tick_);
+        slots_[tick % slots_.size()].push_back(Entry{key, deadline});
+        ++size_;
+    }
+
+    /**
+     * @brief Removes and returns every key whose deadline is at or before now.
+     *
+     * Keys are returned rather than passed to a callback so the caller may
+     * reschedule from the handling code.
+     */
+    std::vector<Key> expire(Clock::time_point now) {
+        std::vector<Key> expired;
+        uint64_t now_tick = to_tick(now);
+        if (size_ == 0 || now_tick < current_tick_) {
+            current_tick_ = std::max(current_tick_, now_tick);
+            return expired;
+        }
+
+        uint64_t steps = std::min<uint64_t>(now_tick - current_tick_ + 1, slots_.size());
+        for (uint64_t i = 0; i < steps; ++i) {
+            auto& slot = slots_[(current_tick_ + i) % slots_.size()];
+            for (size_t j = 0; j < slot.size();) {
+                if (slot[j].deadline <= now) {
+                    expired.push_back(std::move(slot[j].key));
+                    slot[j] = std::move(slot.back());
+                    slot.pop_back();
+                    --size_;
+                } else {
+                    ++j;
+                }
+            }
+        }
+
+        // The current slot stays live: later deadlines in this tick are picked up next call
+        current_tick_ = now_tick;
+        return expired;
+    }
+
+    /**
+     * @brief Number of scheduled timers, including lazily cancelled ones not yet reached.
+     */
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        for (auto& slot : slots_) {
+            slot.clear();
+        }
+        size_ = 0;
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Clock::time_point deadline;
+    };
+
+    uint64_t to_tick(Clock::time_point time) const {
+        auto since_epoch = time.time_since_epoch();
+        if (since_epoch.count() < 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(since_epoch / resolution_);
+    }
+
+    std::chrono::milliseconds resolution_;
+    std::pmr::vector<std::pmr::vector<Entry>> slots_;
+    uint64_t current_tick_;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Hierarchical timing wheel with O(1) schedule, reschedule and cancel.
+ *
+ * Four levels of slots cover 2^26 ticks (about 18 hours at 1 ms): the first
+ * level holds the next 256 ticks one per slot, and each further level holds
+ * 64 slots of its predecessor's whole span. A timer is filed at the coarsest
+ * level that separates it from the present, and moves one level down each
+ * time the finer level wraps round, so every timer is touched at most once
+ * per level. Deadlines beyond the span wait in the last level until they come
+ * within range.
+ *
+ * Unlike TimerWheel, timers are cancelled eagerly through the Handle that
+ * schedule() returns: the entry is unlinked at once, so a cancelled timer
+ * costs nothing later. Handles are generation-checked and stay safe to use
+ * after their timer fired or was cancelled.
+ *
+ * Not thread-safe; see TimerService for a shared, threaded front end.
+ */
+template <typename Key>
+class HierarchicalTimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Handle = uint64_t;
+
+    static constexpr Handle INVALID_HANDLE = 0;
+    static constexpr size_t LEVELS = 4;
+
+    explicit HierarchicalTimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(1))
+        : resolution_(std::max(resolution, std::chrono::milliseconds(1))),
+          current_tick_(to_tick(Clock::now())) {
+        heads_.fill(NIL);
+    }
+
+    /**
+     * @brief Schedules key to expire at deadline. Past deadlines fire on the next expire().
+     */
+    Handle schedule(Key key, Clock::time_point deadline) {
+        uint32_t index;
+        if (free_.empty()) {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        } else {
+            index = free_.back();
+            free_.pop_back();
+        }
+        Node& node = nodes_[index];
+        node.key = std::move(key);
+        node.live = true;
+        setDeadline(node, deadline);
+        link(index);
+        ++size_;
+        return handleOf(index);
+    }
+
+    /**
+     * @brief Moves a pending timer to a new deadline, keeping its handle.
+     * @return false if the timer already fired or was cancelled
+     */
+    bool reschedule(Handle handle, Clock::time_point deadline) {
+        uint32_t index;
+        if (!resolve(handle, index)) {
+            return false;
+        }
+        unlink(index);
+        setDeadline(nodes_[index], deadline);
+        link(index);
+        return true;
+    }
+
+    /**
+     * @brief Cancels a pending timer.
+     * @return false if the timer already fired or was cancelled
+     */
+    bool cancel(Handle handle) {
+        uint32_t index;
+        if (!resolve(handle, index)) {
+            return false;
+        }
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    /**
+     * @brief Removes and returns every timer whose deadline is at or before now.
+     *
+     * Timers are returned rather than passed to a callback so the caller may
+     * schedule from the handling code. Idle stretches are skipped a whole
+     * level span at a time, so a long gap costs little more than a short one.
+     */
+    std::vector<std::pair<Handle, Key>> expire(Clock::time_point now) {
+        std::vector<std::pair<Handle, Key>> expired;
+        uint64_t now_tick = to_tick(now);
+        for (;;) {
+            if (size_ == 0) {
+                current_tick_ = std::max(current_tick_, now_tick);
+                break;
+            }
+            if (level_counts_[0] > 0) {
+                collect(slotIndex(0, current_tick_), now, expired);
+                if (current_tick_ >= now_tick) {
+                    break;
+                }
+                ++current_tick_;
+                if ((current_tick_ & LEVEL0_MASK) == 0) {
+                    cascade();
+                }
+                continue;
+            }
+            // Nothing in the first level: jump to the next time a non-empty level moves down
+            size_t level = 1;
+            while (level_counts_[level] == 0) {
+                ++level;
+            }
+            unsigned shift = levelShift(level);
+            uint64_t next = ((current_tick_ >> shift) + 1) << shift;
+            if (next > now_tick) {
+                current_tick_ = std::max(current_tick_, now_tick);
+                break;
+            }
+            current_tick_ = next;
+            cascade();
+        }
+        return expired;
+    }
+
+    /**
+     * @brief The earliest time expire() can have anything to return, or Clock::time_point::max() if empty.
+     *
+     * Exact for timers within the next 256 ticks of the first level; otherwise
+     * the time the next level moves down, which is never later than the
+     * earliest deadline.
+     */
+    Clock::time_point nextWakeup() const {
+        if (size_ == 0) {
+            return Clock::time_point::max();
+        }
+        uint64_t wake = std::numeric_limits<uint64_t>::max();
+        if (level_counts_[0] > 0) {
+            for (uint64_t tick = current_tick_; tick < current_tick_ + LEVEL0_SLOTS; ++tick) {
+                uint32_t head = heads_[slotIndex(0, tick)];
+                if (head == NIL) {
+                    continue;
+                }
+                if (tick == current_tick_) {
+                    // Deadlines in the current tick may lie ahead of the tick's start
+                    Clock::time_point earliest = Clock::time_point::max();
+                    for (uint32_t i = head; i != NIL; i = nodes_[i].next) {
+                        earliest = std::min(earliest, nodes_[i].deadline);
+                    }
+                    return earliest;
+                }
+                wake = tick;
+                break;
+            }
+        }
+        if (size_ > level_counts_[0]) {
+            wake = std::min(wake, ((current_tick_ >> LEVEL0_BITS) + 1) << LEVEL0_BITS);
+        }
+        return Clock::time_point(std::chrono::duration_cast<Clock::duration>(resolution_ * wake));
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        for (uint32_t i = 0; i < nodes_.size(); ++i) {
+            if (nodes_[i].live) {
+                release(i);
+            }
+        }
+        heads_.fill(NIL);
+        level_counts_.fill(0);
+    }
+
+private:
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+    static constexpr unsigned LEVEL0_BITS = 8;
+    static constexpr unsigned LEVELN_BITS = 6;
+    static constexpr uint64_t LEVEL0_SLOTS = uint64_t(1) << LEVEL0_BITS;
+    static constexpr uint64_t LEVELN_SLOTS = uint64_t(1) << LEVELN_BITS;
+    static constexpr uint64_t LEVEL0_MASK = LEVEL0_SLOTS - 1;
+    static constexpr uint64_t LEVELN_MASK = LEVELN_SLOTS - 1;
+    static constexpr uint64_t SPAN = uint64_t(1) << (LEVEL0_BITS + (LEVELS - 1) * LEVELN_BITS);
+    static constexpr size_t SLOT_COUNT = LEVEL0_SLOTS + (LEVELS - 1) * LEVELN_SLOTS;
+
+    struct Node {
+        Key key{};
+        Clock::time_point deadline;
+        uint64_t tick = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t generation = 1;
+        uint16_t slot = 0;
+        uint8_t level = 0;
+        bool live = false;
+    };
+
+    static unsigned levelShift(size_t level) {
+        return level == 0 ? 0 : LEVEL0_BITS + static_cast<unsigned>(level - 1) * LEVELN_BITS;
+    }
+
+    static size_t slotIndex(size_t level, uint64_t tick) {
+        if (level == 0) {
+            return static_cast<size_t>(tick & LEVEL0_MASK);
+        }
+        return static_cast<size_t>(LEVEL0_SLOTS + (level - 1) * LEVELN_SLOTS + ((tick >> levelShift(level)) & LEVELN_MASK));
+    }
+
+    uint64_t to_tick(Clock::time_point time) const {
+        auto since_epoch = time.time_since_epoch();
+        if (since_epoch.count() < 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(since_epoch / resolution_);
+    }
+
+    Handle handleOf(uint32_t index) const {
+        return (static_cast<Handle>(nodes_[index].generation) << 32) | index;
+    }
+
+    bool resolve(Handle handle, uint32_t& index) const {
+        index = static_cast<uint32_t>(handle & 0xFFFFFFFFu);
+        return index < nodes_.size() && nodes_[index].live &&
+               nodes_[index].generation == static_cast<uint32_t>(handle >> 32);
+    }
+
+    void setDeadline(Node& node, Clock::time_point deadline) {
+        node.deadline = deadline;
+        node.tick = deadline == Clock::time_point::max() ? std::numeric_limits<uint64_t>::max()
+                                                         : std::max(to_tick(deadline), current_tick_);
+    }
+
+    // Files a node at the coarsest level that separates it from the current tick
+    void link(uint32_t index) {
+        Node& node = nodes_[index];
+        uint64_t delta = node.tick - current_tick_;
+        size_t level = 0;
+        uint64_t tick = node.tick;
+        if (delta >= SPAN) {
+            level = LEVELS - 1;
+            tick = current_tick_ + SPAN - 1;
+        } else {
+            while (level + 1 < LEVELS && delta >= (uint64_t(1) << levelShift(level + 1))) {
+                ++level;
+            }
+        }
+        size_t slot = slotIndex(level, tick);
+        node.level = static_cast<uint8_t>(level);
+        node.slot = static_cast<uint16_t>(slot);
+        node.prev = NIL;
+        node.next = heads_[slot];
+        if (node.next != NIL) {
+            nodes_[node.next].prev = index;
+        }
+        heads_[slot] = index;
+        ++level_counts_[level];
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != NIL) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            heads_[node.slot] = node.next;
+        }
+        if (node.next != NIL) {
+            nodes_[node.next].prev = node.prev;
+        }
+        --level_counts_[node.level];
+    }
+
+    void release(uint32_t index) {
+        Node& node = nodes_[index];
+        node.key = Key{};
+        node.live = false;
+        ++node.generation;
+        if (node.generation == 0) {
+            node.generation = 1;  // Keep handles distinct from INVALID_HANDLE
+        }
+        free_.push_back(index);
+        --size_;
+    }
+
+    void collect(size_t slot, Clock::time_point now, std::vector<std::pair<Handle, Key>>& expired) {
+        for (uint32_t i = heads_[slot]; i != NIL;) {
+            uint32_t next = nodes_[i].next;
+            if (nodes_[i].deadline <= now) {
+                Handle handle = handleOf(i);
+                unlink(i);
+                expired.emplace_back(handle, std::move(nodes_[i].key));
+                release(i);
+            }
+            i = next;
+        }
+    }
+
+    // Called when the current tick has just crossed a first-level revolution
+    void cascade() {
+        for (size_t level = 1; level < LEVELS; ++level) {
+            size_t slot = slotIndex(level, current_tick_);
+            uint32_t i = heads_[slot];
+            heads_[slot] = NIL;
+            while (i != NIL) {
+                uint32_t next = nodes_[i].next;
+                --level_counts_[level];
+                link(i);
+                i = next;
+            }
+            if (((current_tick_ >> levelShift(level)) & LEVELN_MASK) != 0) {
+                break;
+            }
+        }
+    }
+
+    std::chrono::milliseconds resolution_;
+    uint64_t current_tick_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, SLOT_COUNT> heads_;
+    std::array<size_t, LEVELS> level_counts_{};
+    size_t size_ = 0;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_TIMER_WHEEL_HPP
@@ -0,0 +1,136 @@
+#ifndef XENOCOMM_UTILS_TRACE_HPP
+#define XENOCOMM_UTILS_TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief One completed span: a named stage of the pipeline and how long it took.
+ */
+struct TraceEvent {
+    const char* name = nullptr;   ///< Stage name; a string literal
+    uint64_t correlation_id = 0;  ///< Message the work belonged to, or 0 if none
+    uint64_t start_ns = 0;        ///< steady_clock time the span began
+    uint64_t duration_ns = 0;
+    uint32_t thread_id = 0;       ///< Small per-process number of the recording thread
+};
+
+/**
+ * @brief Collects spans from every thread into per-thread rings and exports them.
+ *
+ * Each thread writes only its own fixed-size ring, so recording a span is a
+ * clock read and a few relaxed stores with no lock and no allocation after the
+ * thread's first span. Once a ring is full its oldest spans are overwritten.
+ * Recording is off until setEnabled(true); spans started while it is off cost
+ * one relaxed load. The trace points in the library are compiled in only when
+ * XENOCOMM_ENABLE_TRACING is defined (the ENABLE_TRACING CMake option), and
+ * cost nothing otherwise.
+ *
+ * The exports are Chrome trace event JSON, which chrome://tracing and Perfetto
+ * open directly, and OTLP/JSON for OpenTelemetry collectors. Spans sharing a
+ * correlation ID share an OpenTelemetry trace ID, so the sender's and the
+ * receiver's spans for one message land in the same trace.
+ */
+class Tracer {
+public:
+    static constexpr size_t RING_CAPACITY = 16384;  ///< Spans kept per thread
+
+    static Tracer& shared();
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records a completed span on the calling thread's ring.
+     */
+    void record(const char* name, uint64_t correlation_id, uint64_t start_ns, uint64_t end_ns);
+
+    /**
+     * @brief Spans recorded since the last clear(), oldest first within each thread.
+     *
+     * Safe to call while other threads record; a span being overwritten as it
+     * is read is skipped.
+     */
+    std::vector<TraceEvent> snapshot() const;
+
+    /**
+     * @brief Forgets every span recorded so far.
+     */
+    void clear();
+
+    std::string exportChromeTrace() const;
+    std::string exportOtlpJson(const std::string& service_name = "xenocomm") const;
+
+    static uint64_t nowNs();
+
+    /**
+     * @brief The message the calling thread is working on, attached to spans as they end.
+     */
+    static uint64_t currentCorrelation();
+    static void setCurrentCorrelation(uint64_t correlation_id);
+
+private:
+    struct Ring;
+
+    Tracer();
+    Ring& threadRing();
+
+    std::atomic<bool> enabled_{false};
+    const int64_t unix_offset_ns_;  // system_clock minus steady_clock, for OTLP timestamps
+    mutable std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;  // Kept after their threads exit, until clear()
+};
+
+/**
+ * @brief Records the enclosing scope as a span when tracing is enabled.
+ *
+ * The span takes the thread's current correlation ID as it ends, so a stage
+ * that learns which message it handled (a receive, once the header is parsed)
+ * is still attributed to it. A message span starts its thread with no current
+ * correlation and restores the previous one when it ends, so nested messages
+ * and unrelated later spans are never mislabelled.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, bool message = false);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_ns_ = 0;
+    uint64_t outer_correlation_ = 0;
+    bool active_ = false;
+    bool message_ = false;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#define XTRACE_CONCAT_INNER(a, b) a##b
+#define XTRACE_CONCAT(a, b) XTRACE_CONCAT_INNER(a, b)
+
+#ifdef XENOCOMM_ENABLE_TRACING
+/// Traces the rest of the enclosing scope as one pipeline stage
+#define XTRACE_SPAN(name) ::xenocomm::utils::TraceSpan XTRACE_CONCAT(xtrace_span_, __LINE__)(name)
+/// Traces the rest of the enclosing scope as the handling of one message
+#define XTRACE_MESSAGE_SPAN(name) ::xenocomm::utils::TraceSpan XTRACE_CONCAT(xtrace_span_, __LINE__)(name, true)
+/// Attributes the calling thread's open spans to message id
+#define XTRACE_CORRELATE(id) ::xenocomm::utils::Tracer::setCurrentCorrelation(static_cast<uint64_t>(id))
+#else
+#define XTRACE_SPAN(name) static_cast<void>(0)
+#define XTRACE_MESSAGE_SPAN(name) static_cast<void>(0)
+#define XTRACE_CORRELATE(id) static_cast<void>(0)
+#endif
+
+#endif // XENOCOMM_UTILS_TRACE_HPP
@@ -0,0 +1,73 @@
+#ifndef XENOCOMM_UTILS_VECTOR_QUANTIZE_HPP
+#define XENOCOMM_UTILS_VECTOR_QUANTIZE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Kernels the float quantizers and converters can dispatch to.
+ */
+enum class QuantizeImplementation {
+    SCALAR,  ///< Portable per-element loop
+    AVX2,    ///< x86 256-bit with F16C, 32 elements per step
+    AVX512,  ///< x86 AVX-512F, 64 elements per step
+    NEON     ///< ARM 128-bit, 16 elements per step
+};
+
+/**
+ * @brief Computes dst[i] = clamp(src[i] * scale + bias, 0, 255), truncated toward zero.
+ *
+ * NaN inputs quantize to 255. The fastest kernel the CPU supports is selected
+ * once at first use; kernels agree with the scalar loop to within one step.
+ */
+void quantizeToUint8(const float* src, uint8_t* dst, size_t count, float scale, float bias = 0.0f);
+
+/**
+ * @brief Computes dst[i] = src[i] * step + offset.
+ */
+void dequantizeFromUint8(const uint8_t* src, float* dst, size_t count, float step, float offset = 0.0f);
+
+/**
+ * @brief Smallest and largest of count values, ignoring NaNs.
+ *
+ * If there are no non-NaN values, min is +infinity and max is -infinity.
+ */
+void floatRange(const float* src, size_t count, float& min, float& max);
+
+/**
+ * @brief Converts floats to IEEE 754 binary16, rounding to nearest even.
+ *
+ * Values beyond the half range become infinities and NaNs stay NaN. The x86
+ * kernels use the F16C and AVX-512F conversion instructions.
+ */
+void floatToHalf(const float* src, uint16_t* dst, size_t count);
+
+/**
+ * @brief Converts IEEE 754 binary16 values to floats; exact.
+ */
+void halfToFloat(const uint16_t* src, float* dst, size_t count);
+
+/**
+ * @brief Converts floats to bfloat16 (their upper 16 bits), rounding to nearest even.
+ *
+ * NaNs stay NaN.
+ */
+void floatToBfloat16(const float* src, uint16_t* dst, size_t count);
+
+/**
+ * @brief Converts bfloat16 values to floats; exact.
+ */
+void bfloat16ToFloat(const uint16_t* src, float* dst, size_t count);
+
+/**
+ * @brief Returns the kernel the quantize and conversion functions dispatch to on this machine.
+ */
+QuantizeImplementation activeQuantizeImplementation();
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_VECTOR_QUANTIZE_HPP
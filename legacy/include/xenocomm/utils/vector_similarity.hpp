@@ -0,0 +1,40 @@
+#ifndef XENOCOMM_UTILS_VECTOR_SIMILARITY_HPP
+#define XENOCOMM_UTILS_VECTOR_SIMILARITY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Kernels the similarity functions can dispatch to.
+ */
+enum class SimilarityImplementation {
+    SCALAR,  ///< Portable per-element loop
+    AVX2,    ///< x86 256-bit with FMA, 16 elements per step
+    AVX512,  ///< x86 AVX-512F, 32 elements per step
+    NEON     ///< ARM 128-bit, 8 elements per step
+};
+
+/**
+ * @brief Cosine similarity of count pairs of rows from two row-major matrices.
+ *
+ * Pair i compares row aRows[i] of a with row bRows[i] of b, each dimension
+ * floats long; a null index array means row i. Dot product and both norms
+ * are accumulated in one pass over each pair. A pair with a zero-norm row
+ * scores 0. The fastest kernel the CPU supports is selected once at first
+ * use; kernels agree with the scalar loop to within float rounding.
+ */
+void cosineSimilarityRows(const float* a, const uint32_t* aRows, const float* b, const uint32_t* bRows,
+                          size_t count, size_t dimension, float* out);
+
+/**
+ * @brief Returns the kernel cosineSimilarityRows dispatches to on this machine.
+ */
+SimilarityImplementation activeSimilarityImplementation();
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_VECTOR_SIMILARITY_HPP
@@ -0,0 +1,124 @@
+#ifndef XENOCOMM_UTILS_WORK_STEALING_EXECUTOR_HPP
+#define XENOCOMM_UTILS_WORK_STEALING_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+/**
+ * @brief Where WorkStealingExecutor workers may run.
+ */
+enum class ThreadPinning {
+    NONE,       ///< Wherever the OS schedules them
+    CORE,       ///< Worker i on the i-th allowed CPU, numbered node by node
+    NUMA_NODE   ///< Worker i on any CPU of the node that CORE would pick
+};
+
+/**
+ * @brief Process-wide pool of worker threads with one deque per worker.
+ *
+ * Transports, strategy execution and crypto offload queue their short jobs
+ * here instead of each keeping threads of their own, so the thread count
+ * follows the cores rather than the number of connections.
+ *
+ * Tasks a worker submits go to the back of its own deque and it takes them
+ * back from there, so follow-up work stays on the core that produced it; a
+ * worker whose deque is empty steals the oldest task from the front of
+ * another's, trying workers on its own NUMA node first when pinned. Tasks
+ * submitted from outside are dealt to the deques round-robin.
+ *
+ * resize() adds or retires workers while tasks keep flowing: a retired
+ * worker finishes its current task and its queue moves to the others.
+ * Exceptions tasks throw are caught and dropped.
+ */
+class WorkStealingExecutor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param workers Number of threads; 0 uses one less than the hardware
+     *        concurrency, but at least one so submitted tasks always run.
+     */
+    explicit WorkStealingExecutor(size_t workers = 0, ThreadPinning pinning = ThreadPinning::NONE);
+
+    /**
+     * @brief Runs every task still queued, then stops the workers.
+     */
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    /**
+     * @brief Process-wide executor for components that do not bring their own.
+     */
+    static WorkStealingExecutor& shared();
+
+    size_t workerCount() const { return workerCount_.load(); }
+
+    /**
+     * @brief Queues task to run on a worker.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Starts or retires workers until there are the given number; 0 picks as the constructor does.
+     *
+     * Returns once every retired worker has finished its current task, unless
+     * called from one of them. Concurrent calls apply one after the other.
+     */
+    void resize(size_t workers);
+
+    /**
+     * @brief Re-pins the running workers and the ones resize() starts later.
+     *
+     * Where the platform has no affinity calls this only changes which
+     * workers a thief tries first.
+     */
+    void setPinning(ThreadPinning pinning);
+
+    ThreadPinning pinning() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;             // Guards tasks
+        std::deque<Task> tasks;
+        std::thread thread;
+        size_t index = 0;             // Position in workers_; only resize() changes the vector
+        size_t node = 0;              // NUMA node its pinning places it on; 0 when unpinned
+        std::atomic<bool> retiring{false};
+    };
+
+    static size_t defaultWorkers();
+
+    void start(size_t count);
+    void pin(Worker& worker) const;
+    bool tryTake(Worker& self, Task& task);
+    void workerLoop(std::shared_ptr<Worker> self);
+
+    mutable std::shared_mutex workersMutex_;          // Shared to queue or steal, exclusive to resize or re-pin
+    std::vector<std::shared_ptr<Worker>> workers_;    // Thread functions keep retired ones alive
+    std::atomic<size_t> workerCount_{0};
+    ThreadPinning pinning_;                           // Guarded by workersMutex_
+    std::mutex resizeMutex_;                          // Serializes resize() from start to join
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<size_t> pending_{0};                  // Tasks queued and not yet taken
+    std::mutex mutex_;                                // Guards sleeping; pairs with cv_
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+} // namespace utils
+} // namespace xenocomm
+
+#endif // XENOCOMM_UTILS_WORK_STEALING_EXECUTOR_HPP
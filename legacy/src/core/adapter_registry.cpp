@@ -4,6 +4,27 @@
 namespace xenocomm {
 namespace core {
 
+namespace {
+
+// This thread's per-thread adapters, tagged with the generation they were made for
+struct ThreadSlot {
+    uint64_t generation = 0;
+    std::shared_ptr<DataTranscoder> adapter;
+};
+
+thread_local std::array<ThreadSlot, DATA_FORMAT_COUNT> thread_adapters;
+
+size_t formatIndex(DataFormat format) {
+    return static_cast<size_t>(format);
+}
+
+} // namespace
+
+AdapterRegistry::AdapterRegistry() {
+    tables_.push_back(std::make_unique<Table>());
+    table_.store(tables_.back().get(), std::memory_order_release);
+}
+
 AdapterRegistry& AdapterRegistry::getInstance() {
     static AdapterRegistry instance;
     return instance;
@@ -12,81 +33,105 @@ AdapterRegistry& AdapterRegistry::getInstance() {
 void AdapterRegistry::registerAdapter(
     DataFormat format,
     TranscoderFactory factory,
-    const std::string& description) {
+    const std::string& description,
+    AdapterSharing sharing) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (registry_.find(format) != registry_.end()) {
+    size_t index = formatIndex(format);
+    if (index >= DATA_FORMAT_COUNT) {
+        throw std::runtime_error("Data format out of range");
+    }
+    const Table& current = *table_.load(std::memory_order_relaxed);
+    if (current[index]) {
         throw std::runtime_error("Adapter already registered for format");
     }
 
-    registry_[format] = AdapterInfo{
+    auto info = std::make_shared<AdapterInfo>(AdapterInfo{
         std::move(factory),
-        description
-    };
-}
+        description,
+        sharing,
+        nullptr,
+        next_generation_++
+    });
+    if (sharing == AdapterSharing::SHARED) {
+        info->shared = std::shared_ptr<DataTranscoder>(info->factory());
+    }
 
-std::shared_ptr<DataTranscoder> AdapterRegistry::getAdapter(DataFormat format) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto table = std::make_unique<Table>(current);
+    (*table)[index] = std::move(info);
+    publish(std::move(table));
+}
 
-    // Check if format is registered
-    auto it = registry_.find(format);
-    if (it == registry_.end()) {
+const AdapterRegistry::AdapterInfo& AdapterRegistry::entry(DataFormat format) const {
+    size_t index = formatIndex(format);
+    const Table& table = *table_.load(std::memory_order_acquire);
+    if (index >= DATA_FORMAT_COUNT || !table[index]) {
         throw std::runtime_error("No adapter registered for format");
     }
+    return *table[index];
+}
 
-    // Clean expired cache entries
-    cleanCache();
+DataTranscoder& AdapterRegistry::lookup(DataFormat format) {
+    const AdapterInfo& info = entry(format);
+    if (info.sharing == AdapterSharing::SHARED) {
+        return *info.shared;
+    }
 
-    // Check cache for existing instance
-    auto cache_it = cache_.find(format);
-    if (cache_it != cache_.end()) {
-        if (auto adapter = cache_it->second.lock()) {
-            return adapter;  // Return cached instance
-        }
-        cache_.erase(cache_it);  // Remove expired entry
+    // Create this thread's instance on first use, or after clearCache()
+    ThreadSlot& slot = thread_adapters[formatIndex(format)];
+    if (slot.generation != info.generation || !slot.adapter) {
+        slot.adapter = std::shared_ptr<DataTranscoder>(info.factory());
+        slot.generation = info.generation;
     }
+    return *slot.adapter;
+}
 
-    // Create new instance
-    auto adapter = std::shared_ptr<DataTranscoder>(
-        it->second.factory());
-    
-    // Cache the instance
-    cache_[format] = adapter;
-    
-    return adapter;
+std::shared_ptr<DataTranscoder> AdapterRegistry::getAdapter(DataFormat format) {
+    const AdapterInfo& info = entry(format);
+    if (info.sharing == AdapterSharing::SHARED) {
+        return info.shared;
+    }
+    lookup(format);
+    return thread_adapters[formatIndex(format)].adapter;
 }
 
 bool AdapterRegistry::hasAdapter(DataFormat format) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return registry_.find(format) != registry_.end();
+    size_t index = formatIndex(format);
+    return index < DATA_FORMAT_COUNT && (*table_.load(std::memory_order_acquire))[index] != nullptr;
 }
 
 std::string AdapterRegistry::getAdapterDescription(DataFormat format) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = registry_.find(format);
-    if (it == registry_.end()) {
-        throw std::runtime_error("No adapter registered for format");
-    }
-    
-    return it->second.description;
+    return entry(format).description;
 }
 
 void AdapterRegistry::clearCache() {
     std::lock_guard<std::mutex> lock(mutex_);
-    cache_.clear();
-}
 
-void AdapterRegistry::cleanCache() {
-    // Remove all expired weak pointers
-    for (auto it = cache_.begin(); it != cache_.end();) {
-        if (it->second.expired()) {
-            it = cache_.erase(it);
-        } else {
-            ++it;
+    auto table = std::make_unique<Table>(*table_.load(std::memory_order_relaxed));
+    for (auto& slot : *table) {
+        if (!slot) {
+            continue;
         }
+        auto info = std::make_shared<AdapterInfo>(AdapterInfo{
+            slot->factory,
+            slot->description,
+            slot->sharing,
+            nullptr,
+            next_generation_++
+        });
+        if (info->sharing == AdapterSharing::SHARED) {
+            info->shared = std::shared_ptr<DataTranscoder>(info->factory());
+        }
+        slot = std::move(info);
     }
+    publish(std::move(table));
+}
+
+void AdapterRegistry::publish(std::unique_ptr<Table> table) {
+    // The old table stays alive: a reader may still be inside it
+    table_.store(table.get(), std::memory_order_release);
+    tables_.push_back(std::move(table));
 }
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
@@ -0,0 +1,263 @@
+#include "xenocomm/core/address_resolver.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using LookupResult = std::pair<AddressResolver::AddressList, int>;
+
+LookupResult lookup(const std::string& host, uint16_t port) {
+    struct addrinfo hints = {}, *result = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    std::string portStr = std::to_string(port);
+    int status = getaddrinfo(host.c_str(), portStr.c_str(), &hints, &result);
+    if (status != 0) {
+        return {nullptr, status};
+    }
+    std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> resultPtr(result, freeaddrinfo);
+
+    std::vector<AddressResolver::Address> addresses;
+    for (const addrinfo* info = result; info; info = info->ai_next) {
+        if (info->ai_addrlen > sizeof(sockaddr_storage)) {
+            continue;
+        }
+        AddressResolver::Address address{};
+        std::memcpy(&address.storage, info->ai_addr, info->ai_addrlen);
+        address.length = static_cast<socklen_t>(info->ai_addrlen);
+        address.family = info->ai_family;
+        address.socktype = info->ai_socktype;
+        address.protocol = info->ai_protocol;
+        addresses.push_back(address);
+    }
+    if (addresses.empty()) {
+        return {nullptr, EAI_NONAME};
+    }
+    return {std::make_shared<const std::vector<AddressResolver::Address>>(
+                AddressResolver::interleaveFamilies(addresses)), 0};
+}
+
+std::string makeKey(const std::string& host, uint16_t port) {
+    return host + ":" + std::to_string(port);
+}
+
+} // namespace
+
+struct AddressResolver::State {
+    struct Entry {
+        AddressList addresses;  // nullptr for a remembered failure
+        int error = 0;
+        Clock::time_point expires;
+        std::shared_future<LookupResult> pending;  // Valid while the first lookup runs
+        bool refreshing = false;
+    };
+
+    explicit State(const Config& c) : config(c) {}
+
+    void store(Entry& entry, const LookupResult& result) {
+        entry.addresses = result.first;
+        entry.error = result.second;
+        entry.expires = Clock::now() + (result.first ? config.ttl : config.negativeTtl);
+    }
+
+    // Makes room for one more entry; entries with a lookup in flight are never evicted
+    void evict() {
+        if (entries.size() < config.maxEntries) {
+            return;
+        }
+        auto now = Clock::now();
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (!it->second.pending.valid() && !it->second.refreshing && now >= it->second.expires) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = entries.begin(); entries.size() >= config.maxEntries && it != entries.end();) {
+            if (!it->second.pending.valid() && !it->second.refreshing) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    const Config config;
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    Stats stats;
+};
+
+AddressResolver& AddressResolver::shared() {
+    static AddressResolver resolver;
+    return resolver;
+}
+
+AddressResolver::AddressResolver() : AddressResolver(Config()) {}
+
+AddressResolver::AddressResolver(const Config& config) : state_(std::make_shared<State>(config)) {}
+
+AddressResolver::AddressList AddressResolver::resolve(const std::string& host, uint16_t port, int* error) {
+    return resolveWith(state_, host, port, error);
+}
+
+std::future<AddressResolver::AddressList> AddressResolver::resolveAsync(const std::string& host, uint16_t port) {
+    return std::async(std::launch::async, [state = state_, host, port]() {
+        return resolveWith(state, host, port, nullptr);
+    });
+}
+
+AddressResolver::AddressList AddressResolver::resolveWith(const std::shared_ptr<State>& state,
+                                                          const std::string& host, uint16_t port, int* error) {
+    std::string key = makeKey(host, port);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    auto now = Clock::now();
+
+    auto it = state->entries.find(key);
+    if (it != state->entries.end()) {
+        State::Entry& entry = it->second;
+        if (entry.pending.valid()) {
+            // Someone is already looking this name up; wait for their answer
+            auto pending = entry.pending;
+            ++state->stats.misses;
+            lock.unlock();
+            const LookupResult& result = pending.get();
+            if (error) {
+                *error = result.second;
+            }
+            return result.first;
+        }
+        if (now < entry.expires) {
+            ++state->stats.hits;
+            if (error) {
+                *error = entry.error;
+            }
+            return entry.addresses;
+        }
+        if (entry.addresses && now < entry.expires + state->config.staleTtl) {
+            ++state->stats.staleHits;
+            if (!entry.refreshing) {
+                entry.refreshing = true;
+                ++state->stats.lookups;
+                try {
+                    std::thread(&AddressResolver::refresh, state, key, host, port).detach();
+                } catch (const std::system_error&) {
+                    entry.refreshing = false;  // Retried by the next caller
+                }
+            }
+            if (error) {
+                *error = 0;
+            }
+            return entry.addresses;
+        }
+    } else {
+        state->evict();
+        it = state->entries.emplace(key, State::Entry()).first;
+    }
+
+    std::promise<LookupResult> promise;
+    it->second.pending = promise.get_future().share();
+    ++state->stats.misses;
+    ++state->stats.lookups;
+    lock.unlock();
+
+    LookupResult result = lookup(host, port);
+
+    lock.lock();
+    it = state->entries.find(key);  // The table may have rehashed meanwhile
+    if (it != state->entries.end()) {
+        state->store(it->second, result);
+        it->second.pending = std::shared_future<LookupResult>();
+    }
+    lock.unlock();
+    promise.set_value(result);
+
+    if (error) {
+        *error = result.second;
+    }
+    return result.first;
+}
+
+void AddressResolver::refresh(const std::shared_ptr<State>& state, const std::string& key,
+                              const std::string& host, uint16_t port) {
+    LookupResult result = lookup(host, port);
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto it = state->entries.find(key);
+    if (it == state->entries.end()) {
+        return;  // Invalidated while refreshing
+    }
+    it->second.refreshing = false;
+    if (result.first) {
+        state->store(it->second, result);
+    } else {
+        // Keep serving the stale addresses, but do not retry on every call
+        it->second.expires = Clock::now() + state->config.negativeTtl;
+    }
+}
+
+void AddressResolver::invalidate(const std::string& host, uint16_t port) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto it = state_->entries.find(makeKey(host, port));
+    if (it != state_->entries.end() && !it->second.pending.valid()) {
+        state_->entries.erase(it);
+    }
+}
+
+void AddressResolver::clear() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    for (auto it = state_->entries.begin(); it != state_->entries.end();) {
+        if (it->second.pending.valid()) {
+            ++it;
+        } else {
+            it = state_->entries.erase(it);
+        }
+    }
+}
+
+AddressResolver::Stats AddressResolver::getStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+std::vector<AddressResolver::Address> AddressResolver::interleaveFamilies(const std::vector<Address>& addresses) {
+    if (addresses.empty()) {
+        return {};
+    }
+    int preferred = addresses.front().family;
+    std::vector<Address> first, second;
+    for (const auto& address : addresses) {
+        (address.family == preferred ? first : second).push_back(address);
+    }
+
+    std::vector<Address> ordered;
+    ordered.reserve(addresses.size());
+    for (size_t i = 0; i < first.size() || i < second.size(); ++i) {
+        if (i < first.size()) {
+            ordered.push_back(first[i]);
+        }
+        if (i < second.size()) {
+            ordered.push_back(second[i]);
+        }
+    }
+    return ordered;
+}
+
+} // namespace core
+} // namespace xenocomm
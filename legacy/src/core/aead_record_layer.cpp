@@ -0,0 +1,199 @@
+#include "xenocomm/core/aead_record_layer.hpp"
+#include "xenocomm/core/security_manager.h"
+#include <openssl/evp.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// Exporter label for the record keys; both peers must use the same one
+constexpr char RECORD_KEY_LABEL[] = "EXPORTER-xenocomm-aead-record";
+
+const EVP_CIPHER* cipherFor(CipherSuite suite) {
+    switch (suite) {
+        case CipherSuite::AES_128_GCM_SHA256:
+            return EVP_aes_128_gcm();
+        case CipherSuite::AES_256_GCM_SHA384:
+            return EVP_aes_256_gcm();
+        case CipherSuite::CHACHA20_POLY1305_SHA256:
+            return EVP_chacha20_poly1305();
+    }
+    return EVP_aes_256_gcm();
+}
+
+} // namespace
+
+AeadRecordLayer::AeadRecordLayer(CipherSuite suite, const DirectionKeys& send, const DirectionKeys& receive)
+    : suite_(suite) {
+    try {
+        initDirection(send_, suite, send, true);
+        initDirection(receive_, suite, receive, false);
+    } catch (...) {
+        EVP_CIPHER_CTX_free(send_.context);
+        EVP_CIPHER_CTX_free(receive_.context);
+        throw;
+    }
+}
+
+AeadRecordLayer::~AeadRecordLayer() {
+    EVP_CIPHER_CTX_free(send_.context);
+    EVP_CIPHER_CTX_free(receive_.context);
+}
+
+size_t AeadRecordLayer::keyLength(CipherSuite suite) {
+    return suite == CipherSuite::AES_128_GCM_SHA256 ? 16 : 32;
+}
+
+void AeadRecordLayer::initDirection(Direction& direction, CipherSuite suite, const DirectionKeys& keys, bool encrypt) {
+    if (keys.key.size() != keyLength(suite)) {
+        throw std::runtime_error("AEAD key has the wrong length for the cipher suite");
+    }
+    direction.context = EVP_CIPHER_CTX_new();
+    if (!direction.context) {
+        throw std::runtime_error("Failed to allocate AEAD cipher context");
+    }
+    // The key schedule is expanded here once; records only supply a nonce
+    const EVP_CIPHER* cipher = cipherFor(suite);
+    int ok = encrypt ? EVP_EncryptInit_ex(direction.context, cipher, nullptr, nullptr, nullptr)
+                     : EVP_DecryptInit_ex(direction.context, cipher, nullptr, nullptr, nullptr);
+    ok = ok && EVP_CIPHER_CTX_ctrl(direction.context, EVP_CTRL_AEAD_SET_IVLEN, static_cast<int>(NONCE_SIZE), nullptr);
+    ok = ok && (encrypt ? EVP_EncryptInit_ex(direction.context, nullptr, nullptr, keys.key.data(), nullptr)
+                        : EVP_DecryptInit_ex(direction.context, nullptr, nullptr, keys.key.data(), nullptr));
+    if (!ok) {
+        throw std::runtime_error("Failed to initialize AEAD cipher");
+    }
+    direction.iv = keys.iv;
+}
+
+std::array<uint8_t, AeadRecordLayer::NONCE_SIZE> AeadRecordLayer::nonceFor(const std::array<uint8_t, NONCE_SIZE>& iv,
+                                                                           uint64_t sequence) {
+    std::array<uint8_t, NONCE_SIZE> nonce = iv;
+    for (size_t i = 0; i < 8; ++i) {
+        nonce[NONCE_SIZE - 1 - i] ^= static_cast<uint8_t>(sequence >> (8 * i));
+    }
+    return nonce;
+}
+
+Result<std::shared_ptr<AeadRecordLayer>> AeadRecordLayer::fromContext(SecureContext& context) {
+    if (!context.isHandshakeComplete()) {
+        return Result<std::shared_ptr<AeadRecordLayer>>(std::string("Handshake not complete"));
+    }
+    const CipherSuite suite = context.getNegotiatedCipherSuite();
+    const size_t keyLen = keyLength(suite);
+    auto material = context.exportKeyingMaterial(RECORD_KEY_LABEL, 2 * (keyLen + NONCE_SIZE));
+    if (!material.has_value()) {
+        return Result<std::shared_ptr<AeadRecordLayer>>(material.error());
+    }
+
+    // Layout: client key, server key, client IV, server IV
+    const uint8_t* bytes = material.value().data();
+    DirectionKeys client;
+    DirectionKeys server;
+    client.key.assign(bytes, bytes + keyLen);
+    server.key.assign(bytes + keyLen, bytes + 2 * keyLen);
+    std::memcpy(client.iv.data(), bytes + 2 * keyLen, NONCE_SIZE);
+    std::memcpy(server.iv.data(), bytes + 2 * keyLen + NONCE_SIZE, NONCE_SIZE);
+    std::memset(material.value().data(), 0, material.value().size());
+
+    try {
+        return context.isServerSide()
+            ? Result<std::shared_ptr<AeadRecordLayer>>(std::make_shared<AeadRecordLayer>(suite, server, client))
+            : Result<std::shared_ptr<AeadRecordLayer>>(std::make_shared<AeadRecordLayer>(suite, client, server));
+    } catch (const std::exception& e) {
+        return Result<std::shared_ptr<AeadRecordLayer>>(std::string(e.what()));
+    }
+}
+
+bool AeadRecordLayer::sealWith(EVP_CIPHER_CTX* context, const std::array<uint8_t, NONCE_SIZE>& nonce,
+                               utils::ByteSpan aad, utils::ByteSpan plaintext, uint8_t* out, uint8_t* tag) {
+    int length = 0;
+    if (EVP_EncryptInit_ex(context, nullptr, nullptr, nullptr, nonce.data()) != 1) {
+        return false;
+    }
+    if (!aad.empty() && EVP_EncryptUpdate(context, nullptr, &length, aad.data(), static_cast<int>(aad.size())) != 1) {
+        return false;
+    }
+    if (!plaintext.empty() &&
+        EVP_EncryptUpdate(context, out, &length, plaintext.data(), static_cast<int>(plaintext.size())) != 1) {
+        return false;
+    }
+    // GCM and ChaCha20-Poly1305 are stream modes, so the final step emits no bytes
+    return EVP_EncryptFinal_ex(context, out + plaintext.size(), &length) == 1 &&
+           EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_AEAD_GET_TAG, static_cast<int>(TAG_SIZE), tag) == 1;
+}
+
+bool AeadRecordLayer::seal(uint64_t sequence, utils::ByteSpan aad, utils::MutableByteSpan data, uint8_t* tag) {
+    auto nonce = nonceFor(send_.iv, sequence);
+    std::lock_guard<std::mutex> lock(send_.mutex);
+    return sealWith(send_.context, nonce, aad, utils::ByteSpan(data.data(), data.size()), data.data(), tag);
+}
+
+std::unique_ptr<AeadRecordLayer::Sealer> AeadRecordLayer::makeSealer() {
+    EVP_CIPHER_CTX* context = EVP_CIPHER_CTX_new();
+    if (!context) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(send_.mutex);
+    if (EVP_CIPHER_CTX_copy(context, send_.context) != 1) {
+        EVP_CIPHER_CTX_free(context);
+        return nullptr;
+    }
+    return std::unique_ptr<Sealer>(new Sealer(context, send_.iv));
+}
+
+AeadRecordLayer::Sealer::~Sealer() {
+    EVP_CIPHER_CTX_free(context_);
+}
+
+bool AeadRecordLayer::Sealer::seal(uint64_t sequence, utils::ByteSpan aad, utils::ByteSpan plaintext,
+                                   uint8_t* out, uint8_t* tag) {
+    return sealWith(context_, nonceFor(iv_, sequence), aad, plaintext, out, tag);
+}
+
+bool AeadRecordLayer::Sealer::begin(uint64_t sequence, utils::ByteSpan aad) {
+    auto nonce = nonceFor(iv_, sequence);
+    int length = 0;
+    return EVP_EncryptInit_ex(context_, nullptr, nullptr, nullptr, nonce.data()) == 1 &&
+           (aad.empty() ||
+            EVP_EncryptUpdate(context_, nullptr, &length, aad.data(), static_cast<int>(aad.size())) == 1);
+}
+
+bool AeadRecordLayer::Sealer::update(utils::ByteSpan plaintext, uint8_t* out) {
+    int length = 0;
+    return plaintext.empty() ||
+           EVP_EncryptUpdate(context_, out, &length, plaintext.data(), static_cast<int>(plaintext.size())) == 1;
+}
+
+bool AeadRecordLayer::Sealer::finish(uint8_t* tag) {
+    uint8_t none[1];
+    int length = 0;
+    return EVP_EncryptFinal_ex(context_, none, &length) == 1 &&
+           EVP_CIPHER_CTX_ctrl(context_, EVP_CTRL_AEAD_GET_TAG, static_cast<int>(TAG_SIZE), tag) == 1;
+}
+
+bool AeadRecordLayer::open(uint64_t sequence, utils::ByteSpan aad, utils::MutableByteSpan data, const uint8_t* tag) {
+    auto nonce = nonceFor(receive_.iv, sequence);
+    uint8_t expected[TAG_SIZE];
+    std::memcpy(expected, tag, TAG_SIZE);
+    std::lock_guard<std::mutex> lock(receive_.mutex);
+    int length = 0;
+    if (EVP_DecryptInit_ex(receive_.context, nullptr, nullptr, nullptr, nonce.data()) != 1 ||
+        EVP_CIPHER_CTX_ctrl(receive_.context, EVP_CTRL_AEAD_SET_TAG, static_cast<int>(TAG_SIZE), expected) != 1) {
+        return false;
+    }
+    if (!aad.empty() &&
+        EVP_DecryptUpdate(receive_.context, nullptr, &length, aad.data(), static_cast<int>(aad.size())) != 1) {
+        return false;
+    }
+    if (!data.empty() &&
+        EVP_DecryptUpdate(receive_.context, data.data(), &length, data.data(), static_cast<int>(data.size())) != 1) {
+        return false;
+    }
+    return EVP_DecryptFinal_ex(receive_.context, data.data() + data.size(), &length) == 1;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,143 @@
+#include "xenocomm/core/auth_cache.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace xenocomm {
+namespace core {
+
+AuthCache::AuthCache(size_t maxEntries, std::chrono::seconds ttl)
+    : shardCapacity_((maxEntries + SHARD_COUNT - 1) / SHARD_COUNT), ttl_(ttl) {}
+
+AuthCache::Shard& AuthCache::shardFor(const std::string& key) {
+    return shards_[std::hash<std::string>{}(key) % SHARD_COUNT];
+}
+
+void AuthCache::eraseLocked(Shard& shard, Order::iterator entry) {
+    shard.index.erase(entry->key);
+    shard.order.erase(entry);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t AuthCache::expireLocked(Shard& shard, Clock::time_point now) {
+    size_t expired = 0;
+    while (!shard.order.empty() && shard.order.front().expires <= now) {
+        eraseLocked(shard, shard.order.begin());
+        ++expired;
+    }
+    if (expired > 0) {
+        expirations_.fetch_add(expired, std::memory_order_relaxed);
+    }
+    return expired;
+}
+
+std::optional<std::string> AuthCache::lookup(const std::string& key) {
+    const auto now = Clock::now();
+    Shard& shard = shardFor(key);
+    std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    if (found->second->expires <= now) {
+        // Everything ahead of it has expired too
+        expireLocked(shard, now);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return found->second->value;
+}
+
+bool AuthCache::contains(const std::string& key) {
+    const auto now = Clock::now();
+    Shard& shard = shardFor(key);
+    std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    return found != shard.index.end() && found->second->expires > now;
+}
+
+void AuthCache::insert(const std::string& key, std::string value) {
+    insert(key, std::move(value), ttl_);
+}
+
+void AuthCache::insert(const std::string& key, std::string value, std::chrono::seconds ttl) {
+    if (shardCapacity_ == 0) {
+        return;
+    }
+    const auto now = Clock::now();
+    const auto expires = now + std::min(ttl, ttl_);
+    Shard& shard = shardFor(key);
+    std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+    expireLocked(shard, now);
+
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        // Refreshed entries move to their new place so the order stays the expiry order
+        auto position = expiryPosition(shard, expires);
+        found->second->value = std::move(value);
+        found->second->expires = expires;
+        shard.order.splice(position, shard.order, found->second);
+        return;
+    }
+    if (shard.order.size() >= shardCapacity_) {
+        eraseLocked(shard, shard.order.begin());
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto entry = shard.order.insert(expiryPosition(shard, expires), Entry{key, std::move(value), expires});
+    shard.index.emplace(key, entry);
+    size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Searched from the back, where entries with the full TTL belong straight away
+AuthCache::Order::iterator AuthCache::expiryPosition(Shard& shard, Clock::time_point expires) {
+    auto position = shard.order.end();
+    while (position != shard.order.begin() && std::prev(position)->expires > expires) {
+        --position;
+    }
+    return position;
+}
+
+bool AuthCache::erase(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        return false;
+    }
+    eraseLocked(shard, found->second);
+    return true;
+}
+
+size_t AuthCache::cleanupExpired() {
+    const auto now = Clock::now();
+    size_t expired = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+        expired += expireLocked(shard, now);
+    }
+    return expired;
+}
+
+void AuthCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<utils::ProfiledMutex<>> lock(shard.mutex);
+        size_.fetch_sub(shard.order.size(), std::memory_order_relaxed);
+        shard.index.clear();
+        shard.order.clear();
+    }
+}
+
+AuthCache::Stats AuthCache::getStats() const {
+    Stats stats;
+    stats.entries = size_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.expirations = expirations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace core
+} // namespace xenocomm
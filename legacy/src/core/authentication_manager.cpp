@@ -6,6 +6,16 @@
 namespace xenocomm {
 namespace core {
 
+std::vector<AuthResult> AuthenticationProvider::authenticateBatch(
+    const std::vector<AuthenticationContext>& contexts) {
+    std::vector<AuthResult> results;
+    results.reserve(contexts.size());
+    for (const auto& context : contexts) {
+        results.push_back(authenticate(context));
+    }
+    return results;
+}
+
 class AuthenticationManager::Impl {
 public:
     Impl() = default;
@@ -88,6 +98,41 @@ public:
         return result;
     }
 
+    std::vector<AuthResult> authenticateBatch(const std::string& methodName,
+                                              const std::vector<AuthenticationContext>& contexts) {
+        std::shared_ptr<AuthenticationProvider> provider;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = providers_.find(methodName);
+            if (it == providers_.end()) {
+                return std::vector<AuthResult>(contexts.size(),
+                                               AuthResult::Failure("Authentication method not found"));
+            }
+            provider = it->second;
+        }
+
+        auto results = provider->authenticateBatch(contexts);
+
+        // Recorded under one lock; the callback runs outside it
+        AuthenticationCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto now = std::chrono::steady_clock::now();
+            for (const auto& result : results) {
+                if (result.success) {
+                    authenticatedAgents_[result.agentId] = now;
+                }
+            }
+            callback = callback_;
+        }
+        if (callback) {
+            for (const auto& result : results) {
+                callback(result);
+            }
+        }
+        return results;
+    }
+
     void setAuthenticationCallback(AuthenticationCallback callback) {
         std::lock_guard<std::mutex> lock(mutex_);
         callback_ = std::move(callback);
@@ -127,6 +172,11 @@ AuthResult AuthenticationManager::authenticate(const std::string& methodName,
     return impl_->authenticate(methodName, context);
 }
 
+std::vector<AuthResult> AuthenticationManager::authenticateBatch(
+    const std::string& methodName, const std::vector<AuthenticationContext>& contexts) {
+    return impl_->authenticateBatch(methodName, contexts);
+}
+
 void AuthenticationManager::setAuthenticationCallback(AuthenticationCallback callback) {
     impl_->setAuthenticationCallback(std::move(callback));
 }
@@ -0,0 +1,429 @@
+#include "xenocomm/core/batch_negotiation.h"
+#include "xenocomm/core/parameter_performance.h"
+#include "xenocomm/core/preference_table.h"
+#include "xenocomm/utils/timer_service.hpp"
+#include "xenocomm/utils/work_stealing_executor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// Releases a session that is no longer wanted; one already gone needs nothing
+void closeQuietly(NegotiationProtocol& protocol, NegotiationProtocol::SessionId sessionId) {
+    try {
+        protocol.closeSession(sessionId);
+    } catch (const std::exception&) {
+    }
+}
+
+// The option of a dimension ranked first; ties go to the earliest listed
+template <typename T>
+const RankedOption<T>* best(const std::vector<RankedOption<T>>& options) {
+    auto it = std::min_element(options.begin(), options.end(),
+        [](const RankedOption<T>& a, const RankedOption<T>& b) { return a.rank < b.rank; });
+    return it == options.end() ? nullptr : &*it;
+}
+
+// Replaces value with the measured favourite, if measurements displaced the static one
+template <typename T>
+void adopt(T& value, const std::vector<RankedOption<T>>& measured, const std::vector<RankedOption<T>>& configured) {
+    const auto* winner = best(measured);
+    const auto* favourite = best(configured);
+    if (winner && favourite && winner->value != favourite->value) {
+        value = winner->value;
+    }
+}
+
+// Sessions that were started and have not failed yet
+std::vector<PeerNegotiationOutcome*> started(const std::vector<PeerNegotiationOutcome*>& peers) {
+    std::vector<PeerNegotiationOutcome*> pending;
+    for (auto* peer : peers) {
+        if (peer->sessionId != 0 && !peer->error) {
+            pending.push_back(peer);
+        }
+    }
+    return pending;
+}
+
+} // namespace
+
+/**
+ * @brief A negotiateAwaitable() batch between its steps, shared by the tasks and timers that drive it.
+ *
+ * Steps run one after another, except the initiations of a round, which
+ * each touch only their own peer.
+ */
+struct BatchNegotiator::AsyncBatch {
+    BatchNegotiationResult result;
+    std::optional<CompiledPreference> preferences;
+    utils::AwaitableResolver<BatchNegotiationResult> resolver;
+
+    // The round in progress
+    std::vector<PeerNegotiationOutcome*> peers;
+    std::vector<NegotiableParams> proposals;
+    std::optional<NegotiableParams> only;                 // Set in the converging round
+    std::vector<PeerNegotiationOutcome*> pending;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<size_t> initiating{0};
+
+    // The converging round's peers, and where in result each belongs
+    std::vector<PeerNegotiationOutcome> retries;
+    std::vector<size_t> retried;
+
+    explicit AsyncBatch(utils::ContinuationScheduler scheduler) : resolver(std::move(scheduler)) {}
+
+    const CompiledPreference* judge() const { return preferences ? &*preferences : nullptr; }
+};
+
+size_t BatchNegotiationResult::succeeded() const {
+    return static_cast<size_t>(std::count_if(peers.begin(), peers.end(),
+        [](const PeerNegotiationOutcome& peer) { return peer.params.has_value(); }));
+}
+
+size_t BatchNegotiationResult::inGroup() const {
+    return static_cast<size_t>(std::count_if(peers.begin(), peers.end(),
+        [](const PeerNegotiationOutcome& peer) { return peer.inGroup; }));
+}
+
+BatchNegotiator::BatchNegotiator(NegotiationProtocol& protocol, BatchNegotiationConfig config,
+                                 std::shared_ptr<const ParameterPerformanceModel> performance)
+    : protocol_(protocol)
+    , config_(config)
+    , performance_(std::move(performance)) {
+    config_.maxParallelInitiations = std::max<size_t>(config_.maxParallelInitiations, 1);
+}
+
+BatchNegotiationResult BatchNegotiator::negotiate(const std::vector<std::string>& peerIds,
+                                                  const NegotiableParams& proposal) {
+    return run(peerIds, std::vector<NegotiableParams>(peerIds.size(), proposal), nullptr);
+}
+
+BatchNegotiationResult BatchNegotiator::negotiate(const std::vector<std::string>& peerIds,
+                                                  const NegotiableParams& proposal,
+                                                  const ParameterPreference& preferences) {
+    std::vector<NegotiableParams> proposals(peerIds.size(), proposal);
+    CompiledPreference compiled = prepare(peerIds, preferences, proposals);
+    return run(peerIds, proposals, &compiled);
+}
+
+utils::Awaitable<BatchNegotiationResult> BatchNegotiator::negotiateAwaitable(
+    const std::vector<std::string>& peerIds, const NegotiableParams& proposal,
+    utils::ContinuationScheduler scheduler) {
+    auto batch = std::make_shared<AsyncBatch>(std::move(scheduler));
+    batch->proposals.assign(peerIds.size(), proposal);
+    return start(batch, peerIds);
+}
+
+utils::Awaitable<BatchNegotiationResult> BatchNegotiator::negotiateAwaitable(
+    const std::vector<std::string>& peerIds, const NegotiableParams& proposal,
+    const ParameterPreference& preferences, utils::ContinuationScheduler scheduler) {
+    auto batch = std::make_shared<AsyncBatch>(std::move(scheduler));
+    batch->proposals.assign(peerIds.size(), proposal);
+    batch->preferences.emplace(prepare(peerIds, preferences, batch->proposals));
+    return start(batch, peerIds);
+}
+
+CompiledPreference BatchNegotiator::prepare(const std::vector<std::string>& peerIds,
+                                            const ParameterPreference& preferences,
+                                            std::vector<NegotiableParams>& proposals) const {
+    if (!performance_) {
+        return CompiledPreference(preferences);
+    }
+    for (size_t i = 0; i < peerIds.size(); ++i) {
+        ParameterPreference measured = performance_->rankByPerformance(preferences, peerIds[i]);
+        adopt(proposals[i].dataFormat, measured.dataFormats, preferences.dataFormats);
+        adopt(proposals[i].compressionAlgorithm, measured.compressionAlgorithms, preferences.compressionAlgorithms);
+        adopt(proposals[i].errorCorrection, measured.errorCorrectionSchemes, preferences.errorCorrectionSchemes);
+    }
+    return CompiledPreference(performance_->rankByPerformance(preferences, ""));
+}
+
+BatchNegotiationResult BatchNegotiator::run(const std::vector<std::string>& peerIds,
+                                            const std::vector<NegotiableParams>& proposals,
+                                            const CompiledPreference* preferences) {
+    BatchNegotiationResult result;
+    result.peers.resize(peerIds.size());
+    std::vector<PeerNegotiationOutcome*> peers;
+    for (size_t i = 0; i < peerIds.size(); ++i) {
+        result.peers[i].peerId = peerIds[i];
+        peers.push_back(&result.peers[i]);
+    }
+
+    round(peers, proposals, preferences, std::nullopt);
+    if (config_.convergeOnGroupParams) {
+        converge(result, preferences);
+    }
+    return result;
+}
+
+void BatchNegotiator::round(std::vector<PeerNegotiationOutcome*>& peers,
+                            const std::vector<NegotiableParams>& proposals,
+                            const CompiledPreference* preferences,
+                            const std::optional<NegotiableParams>& only) {
+    auto deadline = std::chrono::steady_clock::now() + config_.timeout;
+
+    // Send every proposal first, so the peers work on them in parallel
+    std::atomic<size_t> next{0};
+    auto initiateAll = [&] {
+        for (size_t i = next++; i < peers.size(); i = next++) {
+            initiate(*peers[i], proposals[i]);
+        }
+    };
+    std::vector<std::thread> workers;
+    size_t workerCount = std::min(config_.maxParallelInitiations, peers.size());
+    for (size_t i = 1; i < workerCount; ++i) {
+        workers.emplace_back(initiateAll);
+    }
+    initiateAll();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Then sweep the sessions still in progress until each one settles
+    std::vector<PeerNegotiationOutcome*> pending = started(peers);
+    while (!sweep(pending, preferences, only, deadline)) {
+        std::this_thread::sleep_for(config_.pollInterval);
+    }
+}
+
+void BatchNegotiator::initiate(PeerNegotiationOutcome& peer, const NegotiableParams& proposal) {
+    try {
+        peer.sessionId = protocol_.initiateSession(peer.peerId, proposal);
+        peer.state = NegotiationState::AWAITING_RESPONSE;
+    } catch (const std::exception& e) {
+        peer.state = NegotiationState::FAILED;
+        peer.error = e.what();
+    }
+}
+
+bool BatchNegotiator::sweep(std::vector<PeerNegotiationOutcome*>& pending,
+                            const CompiledPreference* preferences,
+                            const std::optional<NegotiableParams>& only,
+                            std::chrono::steady_clock::time_point deadline) {
+    auto settled = [&](PeerNegotiationOutcome* peer) {
+        try {
+            peer->state = protocol_.getSessionState(peer->sessionId);
+            switch (peer->state) {
+                case NegotiationState::FINALIZED:
+                    peer->params = protocol_.getNegotiatedParams(peer->sessionId);
+                    if (!peer->params) {
+                        peer->error = "Finalized without parameters";
+                    }
+                    return true;
+                case NegotiationState::FAILED:
+                    peer->error = "Negotiation failed";
+                    return true;
+                case NegotiationState::CLOSED:
+                    peer->error = "Session closed";
+                    return true;
+                case NegotiationState::COUNTER_RECEIVED:
+                    if (acceptsCounter(peer->sessionId, preferences, only)) {
+                        protocol_.acceptCounterProposal(peer->sessionId);
+                    } else {
+                        protocol_.rejectCounterProposal(peer->sessionId, std::string("Counter-proposal not acceptable"));
+                    }
+                    return false;
+                default:
+                    return false;
+            }
+        } catch (const std::exception& e) {
+            peer->state = NegotiationState::FAILED;
+            peer->error = e.what();
+            return true;
+        }
+    };
+    pending.erase(std::remove_if(pending.begin(), pending.end(), settled), pending.end());
+    if (pending.empty()) {
+        return true;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+        for (auto* peer : pending) {
+            peer->error = "Timed out";
+            closeQuietly(protocol_, peer->sessionId);
+        }
+        pending.clear();
+        return true;
+    }
+    return false;
+}
+
+bool BatchNegotiator::acceptsCounter(NegotiationProtocol::SessionId sessionId,
+                                     const CompiledPreference* preferences,
+                                     const std::optional<NegotiableParams>& only) const {
+    if (!config_.acceptCounterProposals && !only) {
+        return false;
+    }
+    if (!preferences && !only) {
+        return true;
+    }
+    // Judging the counter needs its parameters; without them, play safe
+    auto counter = protocol_.getCounterProposal(sessionId);
+    if (!counter) {
+        return false;
+    }
+    if (only) {
+        return *counter == *only;
+    }
+    return preferences->isCompatibleWithRequirements(*counter);
+}
+
+void BatchNegotiator::converge(BatchNegotiationResult& result, const CompiledPreference* preferences) {
+    std::vector<size_t> retried = chooseGroup(result, preferences);
+    if (retried.empty()) {
+        return;
+    }
+
+    std::vector<PeerNegotiationOutcome> retries(retried.size());
+    std::vector<PeerNegotiationOutcome*> pointers;
+    for (size_t i = 0; i < retried.size(); ++i) {
+        retries[i].peerId = result.peers[retried[i]].peerId;
+        pointers.push_back(&retries[i]);
+    }
+    const NegotiableParams group = *result.groupParams;
+    round(pointers, std::vector<NegotiableParams>(pointers.size(), group), preferences, group);
+    adoptRetries(result, retried, retries);
+}
+
+std::vector<size_t> BatchNegotiator::chooseGroup(BatchNegotiationResult& result,
+                                                 const CompiledPreference* preferences) const {
+    // Tally the distinct parameter sets agreed; a swarm agrees on few, so a linear tally will do
+    std::vector<std::pair<NegotiableParams, size_t>> tally;
+    for (const auto& peer : result.peers) {
+        if (!peer.params) {
+            continue;
+        }
+        auto it = std::find_if(tally.begin(), tally.end(),
+            [&](const auto& entry) { return entry.first == *peer.params; });
+        if (it == tally.end()) {
+            tally.emplace_back(*peer.params, 1);
+        } else {
+            ++it->second;
+        }
+    }
+    if (tally.empty()) {
+        return {};
+    }
+
+    auto better = [&](const auto& a, const auto& b) {
+        if (a.second != b.second) {
+            return a.second > b.second;
+        }
+        return preferences &&
+               preferences->calculateCompatibilityScore(a.first) < preferences->calculateCompatibilityScore(b.first);
+    };
+    const NegotiableParams group = std::min_element(tally.begin(), tally.end(), better)->first;
+    result.groupParams = group;
+
+    // Ask only the peers that agreed on something else
+    std::vector<size_t> retried;
+    for (size_t i = 0; i < result.peers.size(); ++i) {
+        auto& peer = result.peers[i];
+        peer.inGroup = peer.params && *peer.params == group;
+        if (peer.params && !peer.inGroup) {
+            retried.push_back(i);
+        }
+    }
+    return retried;
+}
+
+void BatchNegotiator::adoptRetries(BatchNegotiationResult& result, const std::vector<size_t>& retried,
+                                   std::vector<PeerNegotiationOutcome>& retries) {
+    const NegotiableParams& group = *result.groupParams;
+    for (size_t i = 0; i < retries.size(); ++i) {
+        auto& retry = retries[i];
+        auto& peer = result.peers[retried[i]];
+        if (retry.params && *retry.params == group) {
+            // The original agreement is superseded
+            closeQuietly(protocol_, peer.sessionId);
+            peer = std::move(retry);
+            peer.inGroup = true;
+        } else if (retry.sessionId != 0 && retry.params) {
+            closeQuietly(protocol_, retry.sessionId);
+        }
+    }
+}
+
+utils::Awaitable<BatchNegotiationResult> BatchNegotiator::start(std::shared_ptr<AsyncBatch> batch,
+                                                                const std::vector<std::string>& peerIds) {
+    auto awaitable = batch->resolver.awaitable();
+    batch->result.peers.resize(peerIds.size());
+    for (size_t i = 0; i < peerIds.size(); ++i) {
+        batch->result.peers[i].peerId = peerIds[i];
+        batch->peers.push_back(&batch->result.peers[i]);
+    }
+    startRound(std::move(batch));
+    return awaitable;
+}
+
+void BatchNegotiator::startRound(std::shared_ptr<AsyncBatch> batch) {
+    batch->deadline = std::chrono::steady_clock::now() + config_.timeout;
+    if (batch->peers.empty()) {
+        finishRound(std::move(batch));
+        return;
+    }
+
+    // initiateSession may block on the network, so each runs as its own task;
+    // the last to finish starts the sweeps
+    batch->initiating = batch->peers.size();
+    for (size_t i = 0; i < batch->peers.size(); ++i) {
+        utils::WorkStealingExecutor::shared().submit([this, batch, i] {
+            initiate(*batch->peers[i], batch->proposals[i]);
+            if (batch->initiating.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                batch->pending = started(batch->peers);
+                sweepLater(batch, std::chrono::milliseconds(0));
+            }
+        });
+    }
+}
+
+void BatchNegotiator::sweepLater(std::shared_ptr<AsyncBatch> batch, std::chrono::milliseconds delay) {
+    auto step = [this, batch] {
+        if (sweep(batch->pending, batch->judge(), batch->only, batch->deadline)) {
+            finishRound(batch);
+        } else {
+            sweepLater(batch, config_.pollInterval);
+        }
+    };
+    if (delay.count() == 0) {
+        step();
+        return;
+    }
+    // Sweeps call into the protocol, too slow for the timer thread
+    utils::TimerService::shared().scheduleAfter(delay, [step] {
+        utils::WorkStealingExecutor::shared().submit(step);
+    });
+}
+
+void BatchNegotiator::finishRound(std::shared_ptr<AsyncBatch> batch) {
+    try {
+        if (batch->only) {
+            adoptRetries(batch->result, batch->retried, batch->retries);
+        } else if (config_.convergeOnGroupParams) {
+            batch->retried = chooseGroup(batch->result, batch->judge());
+            if (!batch->retried.empty()) {
+                const NegotiableParams group = *batch->result.groupParams;
+                batch->retries.resize(batch->retried.size());
+                batch->peers.clear();
+                for (size_t i = 0; i < batch->retried.size(); ++i) {
+                    batch->retries[i].peerId = batch->result.peers[batch->retried[i]].peerId;
+                    batch->peers.push_back(&batch->retries[i]);
+                }
+                batch->proposals.assign(batch->peers.size(), group);
+                batch->only = group;
+                startRound(std::move(batch));
+                return;
+            }
+        }
+        batch->resolver.resolve(std::move(batch->result));
+    } catch (...) {
+        batch->resolver.fail(std::current_exception());
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,226 @@
+#include "xenocomm/core/capability_columns.h"
+#include <algorithm>
+#include <future>
+#include <thread>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define XENOCOMM_COLUMNS_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+struct ColumnView {
+    const uint32_t* names;
+    const uint64_t* versions;
+    const uint64_t* masks;
+};
+
+// Sets bit (row % 64) of words[row / 64] for each matching row in [begin, end)
+using MatchKernel = void (*)(const ColumnView&, const CompiledCapabilityQuery&, size_t, size_t, uint64_t*);
+
+void matchScalar(const ColumnView& columns, const CompiledCapabilityQuery& query, size_t begin, size_t end,
+                 uint64_t* words) {
+    for (size_t i = begin; i < end; ++i) {
+        const bool ok = columns.names[i] == query.name && columns.versions[i] >= query.minVersion &&
+                        columns.versions[i] <= query.maxVersion &&
+                        (columns.masks[i] & query.parameterMask) == query.parameterMask;
+        words[i / 64] |= static_cast<uint64_t>(ok) << (i % 64);
+    }
+}
+
+#ifdef XENOCOMM_COLUMNS_HAVE_X86
+__attribute__((target("avx2")))
+void matchAvx2(const ColumnView& columns, const CompiledCapabilityQuery& query, size_t begin, size_t end,
+               uint64_t* words) {
+    // Packed versions fit in 48 bits, so AVX2's signed 64-bit compares order them correctly
+    const __m256i name = _mm256_set1_epi64x(query.name);
+    const __m256i minVersion = _mm256_set1_epi64x(static_cast<long long>(query.minVersion));
+    const __m256i maxVersion = _mm256_set1_epi64x(static_cast<long long>(query.maxVersion));
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(query.parameterMask));
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m256i names =
+            _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.names + i)));
+        const __m256i versions = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.versions + i));
+        const __m256i masks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.masks + i));
+        const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(minVersion, versions),
+                                                _mm256_cmpgt_epi64(versions, maxVersion));
+        const __m256i wanted = _mm256_and_si256(_mm256_cmpeq_epi64(names, name),
+                                                _mm256_cmpeq_epi64(_mm256_and_si256(masks, mask), mask));
+        const int bits = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(outside, wanted)));
+        words[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+    }
+    matchScalar(columns, query, i, end, words);
+}
+#endif
+
+MatchKernel selectKernel() {
+#ifdef XENOCOMM_COLUMNS_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return matchAvx2;
+    }
+#endif
+    return matchScalar;
+}
+
+MatchKernel kernel() {
+    static const MatchKernel selected = selectKernel();
+    return selected;
+}
+
+} // namespace
+
+uint64_t CapabilityColumns::maskBit(uint64_t pair) {
+    return uint64_t(1) << ((pair * 0x9e3779b97f4a7c15ULL) >> 58);
+}
+
+void CapabilityColumns::add(uint32_t agent, uint32_t name, const Capability& capability) {
+    std::vector<uint64_t> pairs;
+    pairs.reserve(capability.parameters.size());
+    uint64_t mask = 0;
+    for (const auto& [key, value] : capability.parameters) {
+        const uint64_t keyId = strings_.emplace(key, static_cast<uint32_t>(strings_.size())).first->second;
+        const uint64_t valueId = strings_.emplace(value, static_cast<uint32_t>(strings_.size())).first->second;
+        pairs.push_back(keyId << 32 | valueId);
+        mask |= maskBit(pairs.back());
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    if (agent >= agentRows_.size()) {
+        agentRows_.resize(static_cast<size_t>(agent) + 1);
+    }
+    agentRows_[agent].push_back(static_cast<uint32_t>(names_.size()));
+    names_.push_back(name);
+    versions_.push_back(capability.version.packed());
+    masks_.push_back(mask);
+    agents_.push_back(agent);
+    parameters_.push_back(std::move(pairs));
+}
+
+bool CapabilityColumns::remove(uint32_t agent, uint32_t name, uint64_t version) {
+    if (agent >= agentRows_.size()) {
+        return false;
+    }
+    auto& rows = agentRows_[agent];
+    auto it = std::find_if(rows.begin(), rows.end(),
+                           [&](uint32_t row) { return names_[row] == name && versions_[row] == version; });
+    if (it == rows.end()) {
+        return false;
+    }
+    const uint32_t row = *it;
+    *it = rows.back();
+    rows.pop_back();
+
+    // The last row fills the gap, and its agent is told where it went
+    const uint32_t last = static_cast<uint32_t>(names_.size() - 1);
+    if (row < last) {
+        names_[row] = names_[last];
+        versions_[row] = versions_[last];
+        masks_[row] = masks_[last];
+        agents_[row] = agents_[last];
+        parameters_[row] = std::move(parameters_[last]);
+        auto& moved = agentRows_[agents_[row]];
+        *std::find(moved.begin(), moved.end(), last) = row;
+    }
+    names_.pop_back();
+    versions_.pop_back();
+    masks_.pop_back();
+    agents_.pop_back();
+    parameters_.pop_back();
+    return true;
+}
+
+void CapabilityColumns::clear() {
+    names_.clear();
+    versions_.clear();
+    masks_.clear();
+    agents_.clear();
+    parameters_.clear();
+    agentRows_.clear();
+    strings_.clear();
+}
+
+CompiledCapabilityQuery CapabilityColumns::compile(uint32_t name, const Capability& required,
+                                                   bool partialMatch) const {
+    const uint64_t minVersion = required.version.packed();
+    // Exact matching stops at the last version sharing the major
+    const uint64_t maxVersion =
+        partialMatch ? MAX_VERSION : (static_cast<uint64_t>(required.version.major) << 32) | 0xffffffffULL;
+    return compile(name, minVersion, maxVersion, required.parameters);
+}
+
+CompiledCapabilityQuery CapabilityColumns::compile(uint32_t name, uint64_t minVersion, uint64_t maxVersion,
+                                                   const std::map<std::string, std::string>& parameters) const {
+    CompiledCapabilityQuery query;
+    query.name = name;
+    query.minVersion = minVersion;
+    query.maxVersion = std::min(maxVersion, MAX_VERSION);
+    query.parameters.reserve(parameters.size());
+    for (const auto& [key, value] : parameters) {
+        auto keyIt = strings_.find(key);
+        auto valueIt = strings_.find(value);
+        if (keyIt == strings_.end() || valueIt == strings_.end()) {
+            query.satisfiable = false;  // No row can hold a pair that was never interned
+            query.parameters.clear();
+            return query;
+        }
+        query.parameters.push_back(static_cast<uint64_t>(keyIt->second) << 32 | valueIt->second);
+        query.parameterMask |= maskBit(query.parameters.back());
+    }
+    std::sort(query.parameters.begin(), query.parameters.end());
+    return query;
+}
+
+void CapabilityColumns::matchSlice(const CompiledCapabilityQuery& query, size_t begin, size_t end,
+                                   uint64_t* words) const {
+    kernel()(ColumnView{names_.data(), versions_.data(), masks_.data()}, query, begin, end, words);
+}
+
+utils::CompressedBitset CapabilityColumns::match(const CompiledCapabilityQuery& query) const {
+    utils::CompressedBitset agents;
+    const size_t count = names_.size();
+    if (!query.satisfiable || query.minVersion > query.maxVersion || count == 0) {
+        return agents;
+    }
+
+    // Slices cover whole words, so no two threads write the same one
+    std::vector<uint64_t> words((count + 63) / 64);
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const size_t workers = std::min(hardware, std::max<size_t>(1, count / PARALLEL_ROW_THRESHOLD));
+    if (workers == 1) {
+        matchSlice(query, 0, count, words.data());
+    } else {
+        const size_t slice = ((count + workers - 1) / workers + 63) / 64 * 64;
+        std::vector<std::future<void>> pending;
+        for (size_t begin = 0; begin + slice < count; begin += slice) {
+            pending.push_back(std::async(std::launch::async, [&, begin] {
+                matchSlice(query, begin, begin + slice, words.data());
+            }));
+        }
+        matchSlice(query, pending.size() * slice, count, words.data());
+        for (auto& future : pending) {
+            future.get();
+        }
+    }
+
+    // The Bloom mask can pass rows that lack a pair; those are ruled out exactly
+    for (size_t w = 0; w < words.size(); ++w) {
+        for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+            const size_t row = w * 64 + static_cast<size_t>(__builtin_ctzll(word));
+            const auto& pairs = parameters_[row];
+            if (query.parameters.empty() ||
+                std::includes(pairs.begin(), pairs.end(), query.parameters.begin(), query.parameters.end())) {
+                agents.add(agents_[row]);
+            }
+        }
+    }
+    return agents;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -1,97 +1,324 @@
 #include "xenocomm/core/capability_index.h"
 #include <algorithm>
+#include <deque>
 #include <stdexcept>
 
 namespace xenocomm {
 namespace core {
 
-bool CapabilityIndex::addCapability(const std::string& agentId, const Capability& capability) {
-    // Add to agent index
-    auto [agentIt, agentInserted] = agentIndex_[agentId].insert(capability);
-    if (!agentInserted) {
-        // Capability was already registered for this agent
-        return false;
+std::unique_lock<std::shared_mutex> CapabilityIndex::writeLock() const {
+    return synchronized_ ? std::unique_lock<std::shared_mutex>(mutex_) : std::unique_lock<std::shared_mutex>();
+}
+
+std::shared_lock<std::shared_mutex> CapabilityIndex::readLock() const {
+    return synchronized_ ? std::shared_lock<std::shared_mutex>(mutex_) : std::shared_lock<std::shared_mutex>();
+}
+
+uint32_t CapabilityIndex::internAgent(const std::string& agentId) {
+    auto [it, inserted] = agentIds_.emplace(agentId, 0);
+    if (inserted) {
+        std::optional<uint32_t> known = snapshot_ ? snapshot_->findAgent(agentId) : std::nullopt;
+        if (known) {
+            it->second = *known;
+            snapshotAgentEntries_[*known].id = agentId;
+        } else if (!freeAgentIds_.empty()) {
+            it->second = freeAgentIds_.back();
+            freeAgentIds_.pop_back();
+            agentEntry(it->second).id = agentId;
+        } else {
+            it->second = snapshotAgents_ + static_cast<uint32_t>(agents_.size());
+            agents_.push_back(AgentEntry{agentId, {}});
+        }
     }
+    return it->second;
+}
 
-    // Add to capability index
-    auto& versionMap = capabilityIndex_[capability.name];
-    auto& agentSet = versionMap[capability.version];
-    agentSet.insert(agentId);
+CapabilityIndex::AgentEntry& CapabilityIndex::agentEntry(uint32_t agent) {
+    return agent < snapshotAgents_ ? snapshotAgentEntries_[agent] : agents_[agent - snapshotAgents_];
+}
 
-    return true;
+const CapabilityIndex::AgentEntry& CapabilityIndex::agentEntry(uint32_t agent) const {
+    return agent < snapshotAgents_ ? snapshotAgentEntries_.at(agent) : agents_[agent - snapshotAgents_];
 }
 
-bool CapabilityIndex::removeCapability(const std::string& agentId, const Capability& capability) {
-    // Remove from agent index
-    auto agentIt = agentIndex_.find(agentId);
-    if (agentIt == agentIndex_.end()) {
+void CapabilityIndex::releaseAgent(uint32_t agent) {
+    agentIds_.erase(agentEntry(agent).id);
+    if (agent < snapshotAgents_) {
+        // The ID stays with the snapshot, which may still list the agent's other rows
+        snapshotAgentEntries_.erase(agent);
+        return;
+    }
+    agents_[agent - snapshotAgents_] = AgentEntry{};
+    freeAgentIds_.push_back(agent);
+}
+
+std::optional<uint32_t> CapabilityIndex::liveSnapshotRow(const std::string& agentId,
+                                                         const Capability& capability) const {
+    if (!snapshot_) {
+        return std::nullopt;
+    }
+    auto agent = snapshot_->findAgent(agentId);
+    if (!agent) {
+        return std::nullopt;
+    }
+    auto row = snapshot_->findRow(*agent, capability.name, capability.version.packed());
+    if (!row || removedRows_.count(*row)) {
+        return std::nullopt;
+    }
+    return row;
+}
+
+bool CapabilityIndex::removeSnapshotRow(uint32_t row) {
+    if (!removedRows_.insert(row).second) {
         return false;
     }
+    generations_[internCapability(std::string(snapshot_->rowName(row)))] = ++lastGeneration_;
+    --mappings_;
+    return true;
+}
+
+void CapabilityIndex::addSnapshotProviders(const Capability& required, bool partialMatch,
+                                           utils::CompressedBitset& out) const {
+    auto name = snapshot_->findName(required.name);
+    if (!name) {
+        return;
+    }
+    const bool checkParameters = partialMatch && !required.parameters.empty();
+    snapshot_->forEachRowAtOrAbove(*name, required.version.packed(), [&](uint32_t row) {
+        if (removedRows_.count(row) || (checkParameters && !snapshot_->rowHasParameters(row, required.parameters))) {
+            return;
+        }
+        out.add(snapshot_->rowAgent(row));
+    });
+}
+
+CapabilityIndex::VersionPostings::const_iterator CapabilityIndex::firstAtOrAbove(
+    VersionPostings::const_iterator first, const VersionPostings& versions, uint64_t version) {
+    return std::lower_bound(first, versions.end(), version,
+                            [](const VersionEntry& entry, uint64_t v) { return entry.version < v; });
+}
+
+uint32_t CapabilityIndex::internCapability(const std::string& name) {
+    auto [nameIt, nameInserted] = capabilityIds_.emplace(name, static_cast<uint32_t>(postings_.size()));
+    if (nameInserted) {
+        postings_.emplace_back();
+        columns_.emplace_back();
+        generations_.push_back(0);
+    }
+    return nameIt->second;
+}
+
+void CapabilityIndex::addPosting(uint32_t agent, const Capability& capability) {
+    uint32_t name = internCapability(capability.name);
+    auto& versions = postings_[name];
+    const uint64_t version = capability.version.packed();
+    auto pos = static_cast<size_t>(firstAtOrAbove(versions.begin(), versions, version) - versions.cbegin());
+    if (pos == versions.size() || versions[pos].version != version) {
+        versions.insert(versions.begin() + static_cast<std::ptrdiff_t>(pos), VersionEntry{});
+        versions[pos].version = version;
+        if (pos + 1 < versions.size()) {
+            versions[pos].atOrAbove = versions[pos + 1].atOrAbove;
+        }
+    }
 
-    auto& agentCaps = agentIt->second;
-    if (!agentCaps.erase(capability)) {
+    auto& entry = versions[pos];
+    if (!entry.agents.add(agent)) {
+        return;
+    }
+    columns_[name].add(agent, name, capability);
+    for (size_t i = 0; i <= pos; ++i) {
+        versions[i].atOrAbove.add(agent);
+    }
+    generations_[name] = ++lastGeneration_;
+    ++mappings_;
+}
+
+bool CapabilityIndex::erasePosting(uint32_t agent, const Capability& stored) {
+    auto nameIt = capabilityIds_.find(stored.name);
+    if (nameIt == capabilityIds_.end()) {
+        return false;
+    }
+    auto& versions = postings_[nameIt->second];
+    const uint64_t version = stored.version.packed();
+    auto pos = static_cast<size_t>(firstAtOrAbove(versions.begin(), versions, version) - versions.cbegin());
+    if (pos == versions.size() || versions[pos].version != version ||
+        !versions[pos].agents.remove(agent)) {
         return false;
     }
 
-    // Remove from capability index
-    auto capIt = capabilityIndex_.find(capability.name);
-    if (capIt != capabilityIndex_.end()) {
-        auto& versionMap = capIt->second;
-        auto verIt = versionMap.find(capability.version);
-        if (verIt != versionMap.end()) {
-            verIt->second.erase(agentId);
+    auto& entry = versions[pos];
+    columns_[nameIt->second].remove(agent, nameIt->second, version);
 
-            // Clean up empty sets
-            if (verIt->second.empty()) {
-                versionMap.erase(verIt);
-                if (versionMap.empty()) {
-                    capabilityIndex_.erase(capIt);
-                }
+    // The agent leaves the unions down to the next lower version it still provides
+    bool providesLater = pos + 1 < versions.size() && versions[pos + 1].atOrAbove.contains(agent);
+    if (!providesLater) {
+        for (size_t i = pos + 1; i-- > 0;) {
+            versions[i].atOrAbove.remove(agent);
+            if (i > 0 && versions[i - 1].agents.contains(agent)) {
+                break;
             }
         }
     }
 
-    // Clean up empty agent entry
-    if (agentCaps.empty()) {
-        agentIndex_.erase(agentIt);
+    // Clean up empty versions; the interned name is kept for when it comes back
+    if (entry.agents.empty()) {
+        versions.erase(versions.begin() + static_cast<std::ptrdiff_t>(pos));
     }
+    generations_[nameIt->second] = ++lastGeneration_;
+    --mappings_;
+    return true;
+}
+
+bool CapabilityIndex::addCapability(const std::string& agentId, const Capability& capability) {
+    auto lock = writeLock();
+    if (liveSnapshotRow(agentId, capability)) {
+        return false;  // Registered in the snapshot
+    }
+
+    // Add to agent index
+    uint32_t agent = internAgent(agentId);
+    auto [capIt, capInserted] = agentEntry(agent).capabilities.insert(capability);
+    if (!capInserted) {
+        // Capability was already registered for this agent
+        return false;
+    }
+
+    // Add to capability index
+    addPosting(agent, capability);
 
     return true;
 }
 
-size_t CapabilityIndex::removeAgent(const std::string& agentId) {
-    auto agentIt = agentIndex_.find(agentId);
-    if (agentIt == agentIndex_.end()) {
-        return 0;
+bool CapabilityIndex::removeCapability(const std::string& agentId, const Capability& capability) {
+    auto lock = writeLock();
+
+    // Remove from agent index
+    auto agentIt = agentIds_.find(agentId);
+    if (agentIt != agentIds_.end()) {
+        uint32_t agent = agentIt->second;
+        auto& agentCaps = agentEntry(agent).capabilities;
+        auto capIt = agentCaps.find(capability);
+        if (capIt != agentCaps.end()) {
+            // Remove from capability index, by the parameters that were indexed
+            erasePosting(agent, *capIt);
+            agentCaps.erase(capIt);
+
+            // Clean up empty agent entry
+            if (agentCaps.empty()) {
+                releaseAgent(agent);
+            }
+            return true;
+        }
     }
 
+    // Otherwise it may have come from the snapshot
+    auto row = liveSnapshotRow(agentId, capability);
+    return row && removeSnapshotRow(*row);
+}
+
+size_t CapabilityIndex::addCapabilities(std::vector<std::pair<std::string, Capability>> registrations) {
+    auto lock = writeLock();
+
+    // Grouped by name and ordered by version, each name's versions are filled
+    // in one pass and their unions rebuilt once, rather than per capability
+    std::stable_sort(registrations.begin(), registrations.end(), [](const auto& a, const auto& b) {
+        if (a.second.name != b.second.name) return a.second.name < b.second.name;
+        return a.second.version < b.second.version;
+    });
+
+    size_t added = 0;
+    for (size_t begin = 0; begin < registrations.size();) {
+        const std::string& nameText = registrations[begin].second.name;
+        size_t end = begin;
+        while (end < registrations.size() && registrations[end].second.name == nameText) {
+            ++end;
+        }
+
+        uint32_t name = internCapability(nameText);
+        auto& versions = postings_[name];
+        size_t addedForName = 0;
+        size_t pos = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& [agentId, capability] = registrations[i];
+            if (liveSnapshotRow(agentId, capability)) {
+                continue;  // Registered in the snapshot
+            }
+            uint32_t agent = internAgent(agentId);
+            if (!agentEntry(agent).capabilities.insert(capability).second) {
+                continue;  // Already registered for this agent
+            }
+
+            // Versions only increase within the group, so the search starts where the last one ended
+            const uint64_t version = capability.version.packed();
+            pos = static_cast<size_t>(firstAtOrAbove(versions.begin() + static_cast<std::ptrdiff_t>(pos), versions,
+                                                     version) -
+                                      versions.cbegin());
+            if (pos == versions.size() || versions[pos].version != version) {
+                versions.insert(versions.begin() + static_cast<std::ptrdiff_t>(pos), VersionEntry{});
+                versions[pos].version = version;
+            }
+            auto& entry = versions[pos];
+            entry.agents.add(agent);
+            columns_[name].add(agent, name, capability);
+            ++mappings_;
+            ++addedForName;
+        }
+
+        if (addedForName > 0) {
+            for (size_t i = versions.size(); i-- > 0;) {
+                versions[i].atOrAbove = versions[i].agents;
+                if (i + 1 < versions.size()) {
+                    versions[i].atOrAbove.union_with(versions[i + 1].atOrAbove);
+                }
+            }
+            generations_[name] = ++lastGeneration_;
+            added += addedForName;
+        }
+        begin = end;
+    }
+    return added;
+}
+
+size_t CapabilityIndex::removeAgentLocked(const std::string& agentId) {
     size_t removedCount = 0;
-    const auto& capabilities = agentIt->second;
+    auto agentIt = agentIds_.find(agentId);
+    if (agentIt != agentIds_.end()) {
+        uint32_t agent = agentIt->second;
 
-    // Remove agent from all capability entries
-    for (const auto& cap : capabilities) {
-        auto capIt = capabilityIndex_.find(cap.name);
-        if (capIt != capabilityIndex_.end()) {
-            auto& versionMap = capIt->second;
-            auto verIt = versionMap.find(cap.version);
-            if (verIt != versionMap.end()) {
-                verIt->second.erase(agentId);
+        // Remove agent from all capability entries
+        for (const auto& cap : agentEntry(agent).capabilities) {
+            if (erasePosting(agent, cap)) {
                 removedCount++;
+            }
+        }
 
-                // Clean up empty sets
-                if (verIt->second.empty()) {
-                    versionMap.erase(verIt);
-                    if (versionMap.empty()) {
-                        capabilityIndex_.erase(capIt);
-                    }
-                }
+        // Remove agent entry
+        releaseAgent(agent);
+    }
+
+    // And every snapshot row it still has
+    if (auto agent = snapshot_ ? snapshot_->findAgent(agentId) : std::nullopt) {
+        auto [first, count] = snapshot_->agentRows(*agent);
+        for (uint32_t row = first; row < first + count; ++row) {
+            if (removeSnapshotRow(row)) {
+                removedCount++;
             }
         }
     }
+    return removedCount;
+}
 
-    // Remove agent entry
-    agentIndex_.erase(agentIt);
+size_t CapabilityIndex::removeAgent(const std::string& agentId) {
+    auto lock = writeLock();
+    return removeAgentLocked(agentId);
+}
 
+size_t CapabilityIndex::removeAgents(const std::vector<std::string>& agentIds) {
+    auto lock = writeLock();
+    size_t removedCount = 0;
+    for (const auto& agentId : agentIds) {
+        removedCount += removeAgentLocked(agentId);
+    }
     return removedCount;
 }
 
@@ -103,97 +330,205 @@ std::vector<std::string> CapabilityIndex::findAgents(
         return {};
     }
 
-    // Start with agents matching the first capability
-    std::unordered_set<std::string> result;
-    bool firstCapability = true;
+    auto lock = readLock();
 
+    // Agents providing each capability at a compatible version. Without
+    // parameters to check that is a precomputed union, used in place.
+    std::vector<const utils::CompressedBitset*> candidates;
+    std::deque<utils::CompressedBitset> merged;
+    candidates.reserve(capabilities.size());
     for (const auto& cap : capabilities) {
-        auto capIt = capabilityIndex_.find(cap.name);
-        if (capIt == capabilityIndex_.end()) {
+        const utils::CompressedBitset* providers = nullptr;
+        auto nameIt = capabilityIds_.find(cap.name);
+        if (nameIt != capabilityIds_.end()) {
+            const auto& versions = postings_[nameIt->second];
+            auto first = firstAtOrAbove(versions.begin(), versions, cap.version.packed());  // Version compatibility check
+            if (first == versions.end()) {
+                // No agents with compatible version
+            } else if (!partialMatch || cap.parameters.empty()) {
+                providers = &first->atOrAbove;
+            } else {
+                // For partial matching, one capability must carry every required parameter
+                const auto& columns = columns_[nameIt->second];
+                merged.push_back(columns.match(columns.compile(nameIt->second, cap, true)));
+                providers = &merged.back();
+            }
+        }
+        if (snapshot_) {
+            // The snapshot's remaining rows join whatever was registered since
+            merged.push_back(providers ? *providers : utils::CompressedBitset());
+            addSnapshotProviders(cap, partialMatch, merged.back());
+            providers = &merged.back();
+        }
+        if (!providers || providers->empty()) {
             return {};  // Required capability not found
         }
+        candidates.push_back(providers);
+    }
 
-        const auto& versionMap = capIt->second;
-        std::unordered_set<std::string> matchingAgents;
+    // Intersect smallest first so every later step only shrinks a small set
+    std::sort(candidates.begin(), candidates.end(),
+              [](const utils::CompressedBitset* a, const utils::CompressedBitset* b) {
+                  return a->cardinality() < b->cardinality();
+              });
+    utils::CompressedBitset result = *candidates.front();
+    for (size_t i = 1; i < candidates.size() && !result.empty(); ++i) {
+        result.intersect_with(*candidates[i]);
+    }
 
-        // Find agents with compatible versions
-        for (const auto& [version, agents] : versionMap) {
-            if (version >= cap.version) {  // Version compatibility check
-                matchingAgents.insert(agents.begin(), agents.end());
-            }
-        }
+    std::vector<std::string> agentIds;
+    agentIds.reserve(result.cardinality());
+    result.for_each([&](uint32_t agent) {
+        agentIds.push_back(agent < snapshotAgents_ ? std::string(snapshot_->agentId(agent)) : agentEntry(agent).id);
+    });
+    return agentIds;
+}
 
-        if (matchingAgents.empty()) {
-            return {};  // No agents with compatible version
-        }
-
-        // For partial matching, verify parameters
-        if (partialMatch) {
-            std::unordered_set<std::string> validAgents;
-            for (const auto& agentId : matchingAgents) {
-                auto agentIt = agentIndex_.find(agentId);
-                if (agentIt != agentIndex_.end()) {
-                    // Check if agent has a capability that includes all required parameters
-                    for (const auto& agentCap : agentIt->second) {
-                        if (agentCap.name == cap.name && 
-                            agentCap.version >= cap.version &&
-                            std::includes(
-                                agentCap.parameters.begin(), agentCap.parameters.end(),
-                                cap.parameters.begin(), cap.parameters.end())) {
-                            validAgents.insert(agentId);
-                            break;
-                        }
+bool CapabilityIndex::matchesAgent(const std::string& agentId,
+                                   const std::vector<Capability>& capabilities,
+                                   bool partialMatch) const {
+    if (capabilities.empty()) {
+        return false;
+    }
+
+    auto lock = readLock();
+    auto agentIt = agentIds_.find(agentId);
+    std::optional<uint32_t> snapshotAgent = snapshot_ ? snapshot_->findAgent(agentId) : std::nullopt;
+    if (agentIt == agentIds_.end() && !snapshotAgent) {
+        return false;
+    }
+
+    for (const auto& cap : capabilities) {
+        const uint64_t version = cap.version.packed();
+        const bool checkParameters = partialMatch && !cap.parameters.empty();
+        bool provided = false;
+        auto nameIt = capabilityIds_.find(cap.name);
+        if (agentIt != agentIds_.end() && nameIt != capabilityIds_.end()) {
+            const auto& versions = postings_[nameIt->second];
+            auto first = firstAtOrAbove(versions.begin(), versions, version);
+            if (first != versions.end() && first->atOrAbove.contains(agentIt->second)) {
+                // Same rules as findAgents(): parameters only count for partial matching
+                provided = !checkParameters;
+                for (const auto& own : agentEntry(agentIt->second).capabilities) {
+                    if (provided) {
+                        break;
                     }
+                    provided = own.name == cap.name && own.version.packed() >= version &&
+                               std::all_of(cap.parameters.begin(), cap.parameters.end(), [&](const auto& parameter) {
+                                   auto it = own.parameters.find(parameter.first);
+                                   return it != own.parameters.end() && it->second == parameter.second;
+                               });
                 }
             }
-            matchingAgents = std::move(validAgents);
         }
+        if (!provided && snapshotAgent) {
+            auto [first, count] = snapshot_->agentRows(*snapshotAgent);
+            for (uint32_t row = first; row < first + count && !provided; ++row) {
+                provided = !removedRows_.count(row) && snapshot_->rowVersion(row) >= version &&
+                           snapshot_->rowName(row) == cap.name &&
+                           (!checkParameters || snapshot_->rowHasParameters(row, cap.parameters));
+            }
+        }
+        if (!provided) {
+            return false;
+        }
+    }
+    return true;
+}
 
-        if (firstCapability) {
-            result = std::move(matchingAgents);
-            firstCapability = false;
-        } else {
-            // Intersect with previous results
-            std::unordered_set<std::string> intersection;
-            for (const auto& agentId : matchingAgents) {
-                if (result.find(agentId) != result.end()) {
-                    intersection.insert(agentId);
-                }
+std::vector<Capability> CapabilityIndex::getAgentCapabilities(const std::string& agentId) const {
+    auto lock = readLock();
+
+    std::vector<Capability> result;
+    auto it = agentIds_.find(agentId);
+    if (it != agentIds_.end()) {
+        const auto& capabilities = agentEntry(it->second).capabilities;
+        result.assign(capabilities.begin(), capabilities.end());
+    }
+    if (auto agent = snapshot_ ? snapshot_->findAgent(agentId) : std::nullopt) {
+        auto [first, count] = snapshot_->agentRows(*agent);
+        for (uint32_t row = first; row < first + count; ++row) {
+            if (!removedRows_.count(row)) {
+                result.push_back(snapshot_->capability(row));
             }
-            result = std::move(intersection);
         }
+    }
+    return result;
+}
 
-        if (result.empty()) {
-            return {};  // No agents match all capabilities so far
+std::vector<CapabilityRegistration> CapabilityIndex::registrations() const {
+    auto lock = readLock();
+    std::vector<CapabilityRegistration> registrations;
+    registrations.reserve(mappings_);
+    auto addEntry = [&](const AgentEntry& entry) {
+        for (const auto& capability : entry.capabilities) {
+            registrations.emplace_back(entry.id, capability);
         }
+    };
+    for (const auto& entry : agents_) {
+        addEntry(entry);
     }
+    for (const auto& [agent, entry] : snapshotAgentEntries_) {
+        addEntry(entry);
+    }
+    for (uint32_t row = 0; snapshot_ && row < snapshot_->rowCount(); ++row) {
+        if (!removedRows_.count(row)) {
+            registrations.emplace_back(std::string(snapshot_->agentId(snapshot_->rowAgent(row))),
+                                       snapshot_->capability(row));
+        }
+    }
+    return registrations;
+}
 
-    return std::vector<std::string>(result.begin(), result.end());
+Result<void> CapabilityIndex::saveSnapshot(const std::string& path) const {
+    return CapabilitySnapshot::write(path, registrations());
 }
 
-std::vector<Capability> CapabilityIndex::getAgentCapabilities(const std::string& agentId) const {
-    auto it = agentIndex_.find(agentId);
-    if (it == agentIndex_.end()) {
-        return {};
+void CapabilityIndex::loadSnapshot(std::shared_ptr<const CapabilitySnapshot> snapshot) {
+    auto lock = writeLock();
+    clearLocked();
+    snapshot_ = std::move(snapshot);
+    if (snapshot_) {
+        snapshotAgents_ = snapshot_->agentCount();
+        mappings_ = snapshot_->rowCount();
+        snapshotGeneration_ = ++lastGeneration_;
     }
-
-    return std::vector<Capability>(it->second.begin(), it->second.end());
 }
 
 void CapabilityIndex::clear() {
-    capabilityIndex_.clear();
-    agentIndex_.clear();
+    auto lock = writeLock();
+    clearLocked();
 }
 
-size_t CapabilityIndex::size() const {
-    size_t total = 0;
-    for (const auto& [_, versionMap] : capabilityIndex_) {
-        for (const auto& [_, agents] : versionMap) {
-            total += agents.size();
-        }
+void CapabilityIndex::clearLocked() {
+    agentIds_.clear();
+    agents_.clear();
+    snapshotAgentEntries_.clear();
+    freeAgentIds_.clear();
+    capabilityIds_.clear();
+    postings_.clear();
+    columns_.clear();
+    generations_.clear();
+    snapshot_.reset();
+    snapshotAgents_ = 0;
+    removedRows_.clear();
+    mappings_ = 0;
+}
+
+uint64_t CapabilityIndex::generation(const std::string& name) const {
+    auto lock = readLock();
+    auto it = capabilityIds_.find(name);
+    if (it != capabilityIds_.end() && generations_[it->second] != 0) {
+        return generations_[it->second];
     }
-    return total;
+    // Names nothing has changed since loading share the snapshot's stamp
+    return snapshot_ && snapshot_->findName(name) ? snapshotGeneration_ : 0;
+}
+
+size_t CapabilityIndex::size() const {
+    auto lock = readLock();
+    return mappings_;
 }
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
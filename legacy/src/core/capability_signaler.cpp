@@ -2,6 +2,7 @@
 #include "xenocomm/core/capability_signaler.h"
 #include "xenocomm/core/capability_index.h"
 #include "xenocomm/utils/serialization.h" // Added for binary serialization
+#include "xenocomm/utils/contention_profile.hpp"
 #include "xenocomm/core/capability_cache.h" // Added
 
 #include <unordered_map>
@@ -15,8 +16,8 @@
 #include <stdexcept>
 #include <sstream>
 #include <memory>
-#include <cstring> // For memcpy
-#include <arpa/inet.h> // For htonl, ntohl - Assuming Linux/macOS
+#include <atomic>
+#include <thread>
 
 namespace xenocomm {
 namespace core {
@@ -36,64 +37,91 @@ std::vector<std::string> splitCapabilityName(const std::string& name) {
     return terms;
 }
 
-// Simple stringification for cache key
-std::string capabilitiesKey(const std::vector<Capability>& caps) {
-    std::string key;
+/**
+ * @brief 128-bit digest of a discovery query, used as its cache key.
+ */
+struct QueryKey {
+    uint64_t high{0};
+    uint64_t low{0};
+
+    bool operator==(const QueryKey& other) const { return high == other.high && low == other.low; }
+};
+
+struct QueryKeyHash {
+    size_t operator()(const QueryKey& key) const {
+        return static_cast<size_t>(key.low ^ (key.high * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+// Two independently mixed 64-bit lanes over a byte stream
+class QueryHasher {
+public:
+    void bytes(const void* data, size_t size) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            high_ = (high_ ^ p[i]) * 0x100000001B3ULL;
+            low_ = ((low_ << 5) | (low_ >> 59)) ^ p[i];
+            low_ *= 0x9E3779B97F4A7C15ULL;
+        }
+    }
+
+    void word(uint64_t value) { bytes(&value, sizeof(value)); }
+
+    // Length-prefixed so adjacent fields cannot run into each other
+    void text(const std::string& value) {
+        word(value.size());
+        bytes(value.data(), value.size());
+    }
+
+    uint64_t high() const { return finish(high_); }
+    uint64_t low() const { return finish(low_); }
+
+private:
+    static uint64_t finish(uint64_t h) {
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+    uint64_t high_{0xCBF29CE484222325ULL};
+    uint64_t low_{0x84222325CBF29CE4ULL};
+};
+
+// Hashes each requirement in one pass and sums the digests, so the key is the
+// same for any order of the same requirements and nothing is allocated
+QueryKey capabilitiesKey(const std::vector<Capability>& caps) {
+    QueryKey key;
     for (const auto& cap : caps) {
-        key += cap.name + ":" + cap.version.toString() + ";"; // Use Version::toString()
+        QueryHasher hasher;
+        hasher.text(cap.name);
+        hasher.word((uint64_t(cap.version.major) << 32) | (uint64_t(cap.version.minor) << 16) | cap.version.patch);
+        hasher.word(cap.parameters.size());
         for (const auto& [k, v] : cap.parameters) {
-            key += k + "=" + v + ",";
+            hasher.text(k);
+            hasher.text(v);
         }
-        key += "|";
+        key.high += hasher.high();
+        key.low += hasher.low();
     }
     return key;
 }
 
-// Serialize a vector of Capability into a buffer
-std::vector<uint8_t> serializeCapabilities(const std::vector<Capability>& caps) {
-    std::vector<uint8_t> out;
-    uint32_t count = static_cast<uint32_t>(caps.size());
-    uint32_t count_be = htonl(count);
-    out.insert(out.end(), reinterpret_cast<uint8_t*>(&count_be), reinterpret_cast<uint8_t*>(&count_be) + sizeof(count_be));
-    for (const auto& cap : caps) {
-        std::vector<uint8_t> capBuf;
-        // Assuming serializeCapability exists in utils and returns void or throws
-        xenocomm::utils::serializeCapability(cap, capBuf); 
-        // Remove the 'if' check, assume success if no exception
-        uint32_t sz = static_cast<uint32_t>(capBuf.size());
-        uint32_t sz_be = htonl(sz);
-        out.insert(out.end(), reinterpret_cast<uint8_t*>(&sz_be), reinterpret_cast<uint8_t*>(&sz_be) + sizeof(sz_be));
-        out.insert(out.end(), capBuf.begin(), capBuf.end());
-    }
-    return out;
+bool sameRequirement(const Capability& a, const Capability& b) {
+    return a.name == b.name && a.version == b.version && a.parameters == b.parameters;
 }
 
-// Deserialize a vector of Capability from a buffer
-bool deserializeCapabilities(const uint8_t* data, size_t size, std::vector<Capability>& outCaps) {
-    if (size < 4) return false;
-    uint32_t count = 0;
-    std::memcpy(&count, data, 4);
-    count = ntohl(count);
-    size_t offset = 4;
-    outCaps.clear();
-    outCaps.reserve(count);
-    for (uint32_t i = 0; i < count; ++i) {
-        if (offset + 4 > size) return false;
-        uint32_t sz = 0;
-        std::memcpy(&sz, data + offset, 4);
-        sz = ntohl(sz);
-        offset += 4;
-        if (offset + sz > size) return false;
-        Capability cap;
-        size_t capBytes = 0;
-        // Assuming deserializeCapability exists in utils
-        if (!xenocomm::utils::deserializeCapability(data + offset, sz, cap, &capBytes) || capBytes != sz) { 
-             return false;
-        }
-        outCaps.push_back(cap);
-        offset += sz;
-    }
-    return offset == size; // Ensure all data was consumed
+// Discovery ANDs its requirements, so queries with the same set of them, in
+// any order or multiplicity, have the same answer
+bool sameQuery(const std::vector<Capability>& a, const std::vector<Capability>& b) {
+    auto covers = [](const std::vector<Capability>& from, const std::vector<Capability>& to) {
+        return std::all_of(from.begin(), from.end(), [&to](const Capability& cap) {
+            return std::any_of(to.begin(), to.end(),
+                               [&cap](const Capability& other) { return sameRequirement(cap, other); });
+        });
+    };
+    return covers(a, b) && covers(b, a);
 }
 
 } // anonymous namespace
@@ -101,8 +129,24 @@ bool deserializeCapabilities(const uint8_t* data, size_t size, std::vector<Capab
 /**
  * @brief A concrete in-memory implementation of the CapabilitySignaler interface.
  *
- * This implementation uses unordered maps for efficient storage and retrieval.
- * It is designed to be thread-safe using shared mutexes for read/write locking.
+ * Discovery never locks. The index is kept twice, left-right style: readers
+ * use whichever copy is published, announcing themselves on a per-thread
+ * counter, while a writer updates the other copy, publishes it, waits for
+ * the readers still on the old one to leave and then replays the update
+ * there. Writers are serialized; registerCapabilities() publishes a whole
+ * batch at once.
+ *
+ * Cached exact lookups are never flushed. Each entry records the index
+ * generation of every capability name in its query and is treated as a miss
+ * once any of them has moved, so churn on one capability leaves the cached
+ * results for all others intact.
+ *
+ * Standing queries from subscribe() are indexed by the capability names they
+ * require. A write looks up the queries naming a capability it touched and
+ * rechecks only the agents it touched against them, so each change costs a
+ * few single-agent checks however many queries stand and however many agents
+ * they match. Events are collected under the write lock and delivered in
+ * write order once it is released.
  */
 class InMemoryCapabilitySignaler : public CapabilitySignaler {
 public:
@@ -110,7 +154,7 @@ public:
      * @brief Constructor with cache configuration.
      */
     explicit InMemoryCapabilitySignaler(const CacheConfig& cacheConfig)
-        : cache_(cacheConfig) {}
+        : indexes_{CapabilityIndex(false), CapabilityIndex(false)}, cache_(cacheConfig) {}
 
     /**
      * @brief Destructor.
@@ -129,30 +173,57 @@ public:
         if (agentId.empty() || capability.name.empty()) {
             return false;
         }
+        return update([&](CapabilityIndex& index) { return index.addCapability(agentId, capability); },
+                      [&](const CapabilityIndex&) { return ChangeSet{{agentId}, {capability.name}}; });
+    }
 
-        std::lock_guard<std::mutex> lock(mutex_);
-        bool success = index_.addCapability(agentId, capability);
-        if (success) {
-            cache_.clear();
+    size_t registerCapabilities(const std::string& agentId, const std::vector<Capability>& capabilities) override {
+        if (agentId.empty()) {
+            return 0;
+        }
+        std::vector<CapabilityRegistration> registrations;
+        registrations.reserve(capabilities.size());
+        for (const auto& capability : capabilities) {
+            registrations.emplace_back(agentId, capability);
         }
-        return success;
+        return registerCapabilities(registrations);
     }
 
-    bool unregisterCapability(const std::string& agentId, const Capability& capability) override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        bool success = index_.removeCapability(agentId, capability);
-        if (success) {
-            cache_.clear();
+    size_t registerCapabilities(const std::vector<CapabilityRegistration>& registrations) override {
+        std::vector<CapabilityRegistration> valid;
+        valid.reserve(registrations.size());
+        for (const auto& registration : registrations) {
+            if (!registration.first.empty() && !registration.second.name.empty()) {
+                valid.push_back(registration);
+            }
         }
-        return success;
+        if (valid.empty()) {
+            return 0;
+        }
+        return update([&](CapabilityIndex& index) { return index.addCapabilities(valid); },
+                      [&](const CapabilityIndex&) {
+                          ChangeSet changes;
+                          for (const auto& [agentId, capability] : valid) {
+                              changes.agents.push_back(agentId);
+                              changes.names.push_back(capability.name);
+                          }
+                          return changes;
+                      });
+    }
+
+    bool unregisterCapability(const std::string& agentId, const Capability& capability) override {
+        return update([&](CapabilityIndex& index) { return index.removeCapability(agentId, capability); },
+                      [&](const CapabilityIndex&) { return ChangeSet{{agentId}, {capability.name}}; });
     }
 
     void unregisterAgent(const std::string& agentId) /*override*/ {
-        std::lock_guard<std::mutex> lock(mutex_);
-        size_t removed = index_.removeAgent(agentId);
-        if (removed > 0) {
-            cache_.clear();
-        }
+        update([&](CapabilityIndex& index) { return index.removeAgent(agentId); },
+               [&](const CapabilityIndex& index) { return agentsChange(index, {agentId}); });
+    }
+
+    size_t unregisterAgentBatch(const std::vector<std::string>& agentIds) override {
+        return update([&](CapabilityIndex& index) { return index.removeAgents(agentIds); },
+                      [&](const CapabilityIndex& index) { return agentsChange(index, agentIds); });
     }
 
     /**
@@ -175,42 +246,51 @@ public:
         if (requiredCapabilities.empty()) {
             return {};
         }
-        std::string key = capabilitiesKey(requiredCapabilities);
-        // Only check cache for exact matches
-        if (!partialMatch) {
-            // Use get for cache lookup, which returns optional<string>
-            if (auto cached = cache_.get(key)) { 
-                std::vector<std::string> result;
-                std::stringstream ss(*cached);
-                std::string id;
-                while (std::getline(ss, id, ',')) {
-                    if (!id.empty()) result.push_back(id);
-                }
-                return result;
-            }
+        ReadGuard guard(*this);
+        const CapabilityIndex& index = guard.index();
+        // Only exact matches are cached
+        if (partialMatch) {
+            return index.findAgents(requiredCapabilities, true);
         }
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto result = index_.findAgents(requiredCapabilities, partialMatch);
-        // Only cache results for exact matches
-        if (!partialMatch) {
-            std::string value;
-            for (const auto& id : result) {
-                if (!value.empty()) value += ",";
-                value += id;
+
+        QueryKey key = capabilitiesKey(requiredCapabilities);
+        if (auto cached = cache_.get(key)) {
+            const CachedDiscovery& entry = **cached;
+            // The digest only selects the entry; the stored query decides
+            if (sameQuery(entry.query, requiredCapabilities) && isCurrent(index, entry)) {
+                return entry.agents;
             }
-            cache_.put(key, value); // Use cache_.put()
         }
+        auto entry = std::make_shared<CachedDiscovery>();
+        entry->query = requiredCapabilities;
+        entry->agents = index.findAgents(requiredCapabilities, false);
+        entry->generations.reserve(requiredCapabilities.size());
+        for (const auto& capability : requiredCapabilities) {
+            entry->generations.push_back(index.generation(capability.name));
+        }
+        std::vector<std::string> result = entry->agents;
+        cache_.put(key, std::move(entry));
         return result;
     }
 
     std::vector<Capability> getAgentCapabilities(const std::string& agentId) override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return index_.getAgentCapabilities(agentId);
+        ReadGuard guard(*this);
+        return guard.index().getAgentCapabilities(agentId);
     }
 
+    /**
+     * @brief Registers one capability, or a whole set written by serializeCapabilitySet as one batch.
+     */
     bool registerCapabilityBinary(
         const std::string& agentId,
         const std::vector<uint8_t>& capabilityData) override {
+        if (!capabilityData.empty() && capabilityData[0] == xenocomm::utils::CAPABILITY_SET_FORMAT_V1) {
+            std::vector<Capability> caps;
+            if (!xenocomm::utils::deserializeCapabilitySet(capabilityData.data(), capabilityData.size(), caps)) {
+                return false;
+            }
+            return registerCapabilities(agentId, caps) > 0;
+        }
         Capability cap;
         size_t bytesRead = 0;
         if (!xenocomm::utils::deserializeCapability(capabilityData.data(), capabilityData.size(), cap, &bytesRead)) {
@@ -219,9 +299,94 @@ public:
         return registerCapability(agentId, cap);
     }
 
+    /**
+     * @brief Encodes all of the agent's capabilities as one set, sharing repeated strings.
+     */
     std::vector<uint8_t> getAgentCapabilitiesBinary(const std::string& agentId) override {
+        std::vector<uint8_t> out;
         auto caps = getAgentCapabilities(agentId);
-        return serializeCapabilities(caps);
+        if (!caps.empty()) {
+            xenocomm::utils::serializeCapabilitySet(caps, out);
+        }
+        return out;
+    }
+
+    bool saveSnapshot(const std::string& path) override {
+        std::vector<CapabilityRegistration> registrations;
+        {
+            ReadGuard guard(*this);
+            registrations = guard.index().registrations();
+        }
+        return CapabilitySnapshot::write(path, std::move(registrations)).has_value();
+    }
+
+    /**
+     * @brief Maps the snapshot once and serves it from both index copies.
+     */
+    bool loadSnapshot(const std::string& path) override {
+        auto snapshot = CapabilitySnapshot::open(path);
+        if (snapshot.has_error()) {
+            return false;
+        }
+        return update(
+            [&](CapabilityIndex& index) {
+                index.loadSnapshot(snapshot.value());
+                return true;
+            },
+            [](const CapabilityIndex&) {
+                ChangeSet changes;
+                changes.everything = true;
+                return changes;
+            });
+    }
+
+    uint64_t subscribe(const std::vector<Capability>& requiredCapabilities, bool partialMatch,
+                       DiscoveryCallback callback) override {
+        if (requiredCapabilities.empty() || !callback) {
+            return 0;
+        }
+        auto subscription = std::make_shared<Subscription>();
+        subscription->query = requiredCapabilities;
+        subscription->partialMatch = partialMatch;
+        subscription->callback = std::move(callback);
+
+        std::unique_lock<utils::ProfiledMutex<>> lock(writeMutex_);
+        // Writers are held off, so the published copy is the current one
+        const CapabilityIndex& index = indexes_[active_.load(std::memory_order_relaxed)];
+        DiscoveryEvent initial;
+        initial.subscription = ++lastSubscription_;
+        initial.added = index.findAgents(requiredCapabilities, partialMatch);
+        subscription->agents.insert(initial.added.begin(), initial.added.end());
+
+        subscriptions_.emplace(initial.subscription, subscription);
+        for (const auto& name : queryNames(requiredCapabilities)) {
+            subscriptionsByName_[name].push_back(initial.subscription);
+        }
+        const uint64_t id = initial.subscription;
+        std::vector<PendingEvent> events;
+        if (!initial.added.empty()) {
+            events.push_back({subscription, std::move(initial)});
+        }
+        deliver(lock, std::move(events));
+        return id;
+    }
+
+    bool unsubscribe(uint64_t subscription) override {
+        std::lock_guard<utils::ProfiledMutex<>> lock(writeMutex_);
+        auto it = subscriptions_.find(subscription);
+        if (it == subscriptions_.end()) {
+            return false;
+        }
+        it->second->active.store(false, std::memory_order_relaxed);
+        for (const auto& name : queryNames(it->second->query)) {
+            auto& ids = subscriptionsByName_[name];
+            ids.erase(std::remove(ids.begin(), ids.end(), subscription), ids.end());
+            if (ids.empty()) {
+                subscriptionsByName_.erase(name);
+            }
+        }
+        subscriptions_.erase(it);
+        return true;
     }
 
     // Public method to access cache stats (if needed for testing)
@@ -230,9 +395,218 @@ public:
     }
 
 private:
-    CapabilityIndex index_;
-    CapabilityCache cache_;
-    std::mutex mutex_;
+    static constexpr size_t READER_SLOTS = 16;
+
+    struct alignas(64) ReaderCount {
+        std::atomic<uint64_t> value{0};
+    };
+
+    static size_t readerSlot() {
+        // Threads are spread round-robin so concurrent readers rarely share a counter
+        static std::atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+        return slot;
+    }
+
+    /**
+     * @brief Pins the published index for the guard's lifetime.
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(InMemoryCapabilitySignaler& owner) : owner_(owner), slot_(readerSlot()) {
+            for (;;) {
+                side_ = owner_.active_.load(std::memory_order_seq_cst);
+                owner_.readers_[side_][slot_].value.fetch_add(1, std::memory_order_seq_cst);
+                // Confirms the writer had not switched sides before it could see us
+                if (owner_.active_.load(std::memory_order_seq_cst) == side_) {
+                    break;
+                }
+                owner_.readers_[side_][slot_].value.fetch_sub(1, std::memory_order_release);
+            }
+        }
+        ~ReadGuard() { owner_.readers_[side_][slot_].value.fetch_sub(1, std::memory_order_release); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const CapabilityIndex& index() const { return owner_.indexes_[side_]; }
+
+    private:
+        InMemoryCapabilitySignaler& owner_;
+        size_t slot_;
+        int side_{0};
+    };
+
+    /**
+     * @brief An exact discovery result, its query and the generations of the names it queried.
+     */
+    struct CachedDiscovery {
+        std::vector<Capability> query;
+        std::vector<uint64_t> generations;  // One per entry of query
+        std::vector<std::string> agents;
+    };
+
+    static bool isCurrent(const CapabilityIndex& index, const CachedDiscovery& entry) {
+        for (size_t i = 0; i < entry.query.size(); ++i) {
+            if (index.generation(entry.query[i].name) != entry.generations[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief The agents a write touches and the capability names it touches them under.
+     */
+    struct ChangeSet {
+        std::vector<std::string> agents;
+        std::vector<std::string> names;
+        bool everything = false;  // Recheck every subscription in full
+    };
+
+    struct Subscription {
+        std::vector<Capability> query;
+        bool partialMatch = false;
+        DiscoveryCallback callback;
+        std::unordered_set<std::string> agents;  // The current result
+        std::atomic<bool> active{true};
+    };
+
+    using PendingEvent = std::pair<std::shared_ptr<Subscription>, DiscoveryEvent>;
+
+    static std::set<std::string> queryNames(const std::vector<Capability>& query) {
+        std::set<std::string> names;
+        for (const auto& capability : query) {
+            names.insert(capability.name);
+        }
+        return names;
+    }
+
+    // Removing agents touches every name they hold, read before the removal
+    static ChangeSet agentsChange(const CapabilityIndex& index, const std::vector<std::string>& agentIds) {
+        ChangeSet changes{agentIds, {}};
+        for (const auto& agentId : agentIds) {
+            for (const auto& capability : index.getAgentCapabilities(agentId)) {
+                changes.names.push_back(capability.name);
+            }
+        }
+        return changes;
+    }
+
+    // Called with writeMutex_ held, after the change reached the published copy
+    std::vector<PendingEvent> collectEvents(const ChangeSet& changes) {
+        const CapabilityIndex& index = indexes_[active_.load(std::memory_order_relaxed)];
+        std::vector<PendingEvent> events;
+        auto diff = [&](uint64_t id, Subscription& subscription, const std::vector<std::string>& agents,
+                        auto&& matches) {
+            DiscoveryEvent event;
+            event.subscription = id;
+            for (const auto& agentId : agents) {
+                const bool now = matches(agentId);
+                const bool before = subscription.agents.count(agentId) > 0;
+                if (now && !before) {
+                    subscription.agents.insert(agentId);
+                    event.added.push_back(agentId);
+                } else if (before && !now) {
+                    subscription.agents.erase(agentId);
+                    event.removed.push_back(agentId);
+                }
+            }
+            if (!event.added.empty() || !event.removed.empty()) {
+                events.push_back({subscriptions_.at(id), std::move(event)});
+            }
+        };
+
+        if (changes.everything) {
+            for (auto& [id, subscription] : subscriptions_) {
+                auto found = index.findAgents(subscription->query, subscription->partialMatch);
+                std::unordered_set<std::string> now(found.begin(), found.end());
+                std::vector<std::string> agents(subscription->agents.begin(), subscription->agents.end());
+                agents.insert(agents.end(), found.begin(), found.end());
+                std::sort(agents.begin(), agents.end());
+                agents.erase(std::unique(agents.begin(), agents.end()), agents.end());
+                diff(id, *subscription, agents, [&](const std::string& agentId) { return now.count(agentId) > 0; });
+            }
+            return events;
+        }
+
+        // Only queries naming a touched capability can change, and only for touched agents
+        std::set<uint64_t> affected;
+        for (const auto& name : changes.names) {
+            auto it = subscriptionsByName_.find(name);
+            if (it != subscriptionsByName_.end()) {
+                affected.insert(it->second.begin(), it->second.end());
+            }
+        }
+        if (affected.empty()) {
+            return events;
+        }
+        std::vector<std::string> agents = changes.agents;
+        std::sort(agents.begin(), agents.end());
+        agents.erase(std::unique(agents.begin(), agents.end()), agents.end());
+        for (uint64_t id : affected) {
+            Subscription& subscription = *subscriptions_.at(id);
+            diff(id, subscription, agents, [&](const std::string& agentId) {
+                return index.matchesAgent(agentId, subscription.query, subscription.partialMatch);
+            });
+        }
+        return events;
+    }
+
+    // Hands the write lock over to the delivery lock, so events keep write order
+    // while the next write proceeds
+    void deliver(std::unique_lock<utils::ProfiledMutex<>>& writeLock, std::vector<PendingEvent> events) {
+        if (events.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> delivering(deliveryMutex_);
+        writeLock.unlock();
+        for (const auto& [subscription, event] : events) {
+            if (subscription->active.load(std::memory_order_relaxed)) {
+                subscription->callback(event);
+            }
+        }
+    }
+
+    template <typename Apply, typename Describe>
+    auto update(Apply apply, Describe describe) -> decltype(apply(std::declval<CapabilityIndex&>())) {
+        std::unique_lock<utils::ProfiledMutex<>> lock(writeMutex_);
+        int published = active_.load(std::memory_order_relaxed);
+        int standby = 1 - published;
+        ChangeSet changes;
+        if (!subscriptions_.empty()) {
+            changes = describe(indexes_[published]);
+        }
+
+        auto result = apply(indexes_[standby]);
+        if (!result) {
+            // Nothing changed, so the copies are still identical
+            return result;
+        }
+        active_.store(standby, std::memory_order_seq_cst);
+
+        for (auto& count : readers_[published]) {
+            while (count.value.load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
+        }
+        apply(indexes_[published]);
+        if (!subscriptions_.empty()) {
+            deliver(lock, collectEvents(changes));
+        }
+        return result;
+    }
+
+    CapabilityIndex indexes_[2];
+    std::atomic<int> active_{0};
+    ReaderCount readers_[2][READER_SLOTS];
+    utils::ProfiledMutex<> writeMutex_{"capability_signaler.write"};
+    std::mutex deliveryMutex_;  // Held while events are delivered, taken before writeMutex_ is released
+    std::unordered_map<uint64_t, std::shared_ptr<Subscription>> subscriptions_;
+    std::unordered_map<std::string, std::vector<uint64_t>> subscriptionsByName_;  // Queries by required name
+    uint64_t lastSubscription_{0};
+    // Entries are shared so a hit copies a pointer rather than the stored query
+    BasicCapabilityCache<std::shared_ptr<const CachedDiscovery>, QueryKey, QueryKeyHash> cache_;
 };
 
 // Factory function implementation
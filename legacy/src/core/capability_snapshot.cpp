@@ -0,0 +1,431 @@
+#include "xenocomm/core/capability_snapshot.h"
+#include "xenocomm/utils/crc32.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// magic, agents, names, versions, rows, parameters, string bytes, crc, reserved
+constexpr size_t HEADER_SIZE = 64;
+constexpr size_t CRC_OFFSET = 28;
+
+constexpr size_t STRING_REF_SIZE = 8;                    // offset, length
+constexpr size_t AGENT_SIZE = STRING_REF_SIZE + 8;       // id, first row, row count
+constexpr size_t NAME_SIZE = STRING_REF_SIZE + 8;        // name, first version, version count
+constexpr size_t VERSION_SIZE = 8 + 8;                   // packed version, first posting, posting count
+constexpr size_t POSTING_SIZE = 4;                       // row index
+constexpr size_t PARAMETER_SIZE = 2 * STRING_REF_SIZE;  // key, value
+// agent, name, version, first parameter, parameter count, flags, deprecated since, removal, replacement
+constexpr size_t ROW_SIZE = 4 + 4 + 8 + 4 + 4 + 4 + 8 + 8 + STRING_REF_SIZE;
+
+enum RowFlags : uint32_t {
+    ROW_DEPRECATED = 1,
+    ROW_HAS_DEPRECATED_SINCE = 2,
+    ROW_HAS_REMOVAL = 4,
+    ROW_HAS_REPLACEMENT = 8,
+};
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t getU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Each distinct string stored once
+class StringTable {
+public:
+    void put(std::vector<uint8_t>& out, const std::string& text) {
+        auto [it, inserted] = offsets_.emplace(text, static_cast<uint32_t>(bytes_.size()));
+        if (inserted) {
+            bytes_.insert(bytes_.end(), text.begin(), text.end());
+        }
+        putU32(out, it->second);
+        putU32(out, static_cast<uint32_t>(text.size()));
+    }
+
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    std::unordered_map<std::string, uint32_t> offsets_;
+    std::vector<uint8_t> bytes_;
+};
+
+} // namespace
+
+Result<void> CapabilitySnapshot::write(const std::string& path, std::vector<CapabilityRegistration> registrations) {
+    auto key = [](const CapabilityRegistration& r) {
+        return std::tie(r.first, r.second.name, r.second.version);
+    };
+    std::sort(registrations.begin(), registrations.end(),
+              [&](const auto& a, const auto& b) { return key(a) < key(b); });
+    registrations.erase(std::unique(registrations.begin(), registrations.end(),
+                                    [&](const auto& a, const auto& b) { return key(a) == key(b); }),
+                        registrations.end());
+    if (registrations.size() > std::numeric_limits<uint32_t>::max()) {
+        return Result<void>(std::string("Too many registrations for a capability snapshot"));
+    }
+
+    std::map<std::string, uint32_t> nameIds;
+    for (const auto& registration : registrations) {
+        nameIds.emplace(registration.second.name, 0);
+    }
+    uint32_t nextName = 0;
+    for (auto& entry : nameIds) {
+        entry.second = nextName++;
+    }
+
+    StringTable strings;
+    std::vector<uint8_t> agents, names, versions, postings, rows, parameters;
+    std::vector<std::map<uint64_t, std::vector<uint32_t>>> rowsByVersion(nameIds.size());
+    uint32_t agentCount = 0;
+    uint32_t parameterCount = 0;
+    for (size_t begin = 0; begin < registrations.size();) {
+        size_t end = begin;
+        while (end < registrations.size() && registrations[end].first == registrations[begin].first) {
+            ++end;
+        }
+        strings.put(agents, registrations[begin].first);
+        putU32(agents, static_cast<uint32_t>(begin));
+        putU32(agents, static_cast<uint32_t>(end - begin));
+
+        for (size_t i = begin; i < end; ++i) {
+            const Capability& cap = registrations[i].second;
+            const uint32_t name = nameIds[cap.name];
+            rowsByVersion[name][cap.version.packed()].push_back(static_cast<uint32_t>(i));
+
+            uint32_t flags = 0;
+            flags |= cap.is_deprecated ? uint32_t(ROW_DEPRECATED) : 0;
+            flags |= cap.deprecated_since ? uint32_t(ROW_HAS_DEPRECATED_SINCE) : 0;
+            flags |= cap.removal_version ? uint32_t(ROW_HAS_REMOVAL) : 0;
+            flags |= cap.replacement_capability ? uint32_t(ROW_HAS_REPLACEMENT) : 0;
+            putU32(rows, agentCount);
+            putU32(rows, name);
+            putU64(rows, cap.version.packed());
+            putU32(rows, parameterCount);
+            putU32(rows, static_cast<uint32_t>(cap.parameters.size()));
+            putU32(rows, flags);
+            putU64(rows, cap.deprecated_since ? cap.deprecated_since->packed() : 0);
+            putU64(rows, cap.removal_version ? cap.removal_version->packed() : 0);
+            strings.put(rows, cap.replacement_capability.value_or(std::string()));
+            for (const auto& [paramKey, paramValue] : cap.parameters) {
+                strings.put(parameters, paramKey);
+                strings.put(parameters, paramValue);
+            }
+            parameterCount += static_cast<uint32_t>(cap.parameters.size());
+        }
+        ++agentCount;
+        begin = end;
+    }
+
+    uint32_t versionCount = 0;
+    uint32_t postingCount = 0;
+    for (const auto& [nameText, name] : nameIds) {
+        strings.put(names, nameText);
+        putU32(names, versionCount);
+        putU32(names, static_cast<uint32_t>(rowsByVersion[name].size()));
+        for (const auto& [version, versionRows] : rowsByVersion[name]) {
+            putU64(versions, version);
+            putU32(versions, postingCount);
+            putU32(versions, static_cast<uint32_t>(versionRows.size()));
+            for (uint32_t row : versionRows) {
+                putU32(postings, row);
+            }
+            postingCount += static_cast<uint32_t>(versionRows.size());
+            ++versionCount;
+        }
+    }
+    if (strings.bytes().size() > std::numeric_limits<uint32_t>::max()) {
+        return Result<void>(std::string("Too many string bytes for a capability snapshot"));
+    }
+
+    std::vector<uint8_t> body;
+    for (const auto* table : {&agents, &names, &versions, &postings, &rows, &parameters}) {
+        body.insert(body.end(), table->begin(), table->end());
+    }
+    body.insert(body.end(), strings.bytes().begin(), strings.bytes().end());
+    std::vector<uint8_t> header;
+    putU32(header, CAPABILITY_SNAPSHOT_MAGIC);
+    putU32(header, agentCount);
+    putU32(header, static_cast<uint32_t>(nameIds.size()));
+    putU32(header, versionCount);
+    putU32(header, static_cast<uint32_t>(registrations.size()));
+    putU32(header, parameterCount);
+    putU32(header, static_cast<uint32_t>(strings.bytes().size()));
+    putU32(header, utils::crc32(body.data(), body.size()));
+    header.resize(HEADER_SIZE, 0);
+
+    std::filesystem::path temporary(path);
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size())) ||
+            !file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()))) {
+            return Result<void>(std::string("Failed to write capability snapshot: " + temporary.string()));
+        }
+    }
+    // Readers only ever map a whole snapshot
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return Result<void>(std::string("Failed to publish capability snapshot: " + path));
+    }
+    return Result<void>();
+}
+
+Result<std::shared_ptr<const CapabilitySnapshot>> CapabilitySnapshot::open(const std::string& path, bool verify) {
+    using OpenResult = Result<std::shared_ptr<const CapabilitySnapshot>>;
+    std::shared_ptr<CapabilitySnapshot> snapshot(new CapabilitySnapshot());
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return OpenResult(std::string("Failed to open capability snapshot: " + path));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= HEADER_SIZE) {
+        void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            snapshot->data_ = static_cast<const uint8_t*>(mapped);
+            snapshot->size_ = static_cast<size_t>(st.st_size);
+        }
+    }
+    ::close(fd);
+
+    const uint8_t* data = snapshot->data_;
+    if (!data || getU32(data) != CAPABILITY_SNAPSHOT_MAGIC) {
+        return OpenResult(std::string("Not a capability snapshot: " + path));
+    }
+    snapshot->agentCount_ = getU32(data + 4);
+    snapshot->nameCount_ = getU32(data + 8);
+    snapshot->versionCount_ = getU32(data + 12);
+    snapshot->rowCount_ = getU32(data + 16);
+    snapshot->parameterCount_ = getU32(data + 20);
+    snapshot->stringBytes_ = getU32(data + 24);
+
+    // The counts alone locate every table, so the file must be exactly their size
+    uint64_t expected = HEADER_SIZE;
+    auto table = [&](const uint8_t*& start, uint64_t bytes) {
+        start = data + std::min<uint64_t>(expected, snapshot->size_);
+        expected += bytes;
+    };
+    table(snapshot->agents_, uint64_t(snapshot->agentCount_) * AGENT_SIZE);
+    table(snapshot->names_, uint64_t(snapshot->nameCount_) * NAME_SIZE);
+    table(snapshot->versions_, uint64_t(snapshot->versionCount_) * VERSION_SIZE);
+    table(snapshot->postings_, uint64_t(snapshot->rowCount_) * POSTING_SIZE);
+    table(snapshot->rows_, uint64_t(snapshot->rowCount_) * ROW_SIZE);
+    table(snapshot->parameters_, uint64_t(snapshot->parameterCount_) * PARAMETER_SIZE);
+    table(snapshot->strings_, snapshot->stringBytes_);
+    if (expected != snapshot->size_) {
+        return OpenResult(std::string("Truncated capability snapshot: " + path));
+    }
+    if (verify && utils::crc32(data + HEADER_SIZE, snapshot->size_ - HEADER_SIZE) != getU32(data + CRC_OFFSET)) {
+        return OpenResult(std::string("Corrupt capability snapshot: " + path));
+    }
+    return OpenResult(std::shared_ptr<const CapabilitySnapshot>(std::move(snapshot)));
+}
+
+CapabilitySnapshot::~CapabilitySnapshot() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+std::string_view CapabilitySnapshot::string(const uint8_t* reference) const {
+    const uint32_t offset = getU32(reference);
+    const uint32_t length = getU32(reference + 4);
+    if (offset > stringBytes_ || length > stringBytes_ - offset) {
+        return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(strings_ + offset), length);
+}
+
+std::string_view CapabilitySnapshot::agentId(uint32_t agent) const {
+    return agent < agentCount_ ? string(agents_ + size_t(agent) * AGENT_SIZE) : std::string_view();
+}
+
+std::optional<uint32_t> CapabilitySnapshot::findAgent(std::string_view agentId) const {
+    uint32_t low = 0, high = agentCount_;
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+        const int order = string(agents_ + size_t(mid) * AGENT_SIZE).compare(agentId);
+        if (order == 0) {
+            return mid;
+        }
+        order < 0 ? low = mid + 1 : high = mid;
+    }
+    return std::nullopt;
+}
+
+std::optional<uint32_t> CapabilitySnapshot::findName(std::string_view name) const {
+    uint32_t low = 0, high = nameCount_;
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+        const int order = string(names_ + size_t(mid) * NAME_SIZE).compare(name);
+        if (order == 0) {
+            return mid;
+        }
+        order < 0 ? low = mid + 1 : high = mid;
+    }
+    return std::nullopt;
+}
+
+std::pair<uint32_t, uint32_t> CapabilitySnapshot::agentRows(uint32_t agent) const {
+    if (agent >= agentCount_) {
+        return {0, 0};
+    }
+    const uint8_t* record = agents_ + size_t(agent) * AGENT_SIZE;
+    const uint32_t first = getU32(record + 8);
+    const uint32_t count = getU32(record + 12);
+    if (first > rowCount_ || count > rowCount_ - first) {
+        return {0, 0};
+    }
+    return {first, count};
+}
+
+std::pair<uint32_t, uint32_t> CapabilitySnapshot::nameVersions(uint32_t name) const {
+    if (name >= nameCount_) {
+        return {0, 0};
+    }
+    const uint8_t* record = names_ + size_t(name) * NAME_SIZE;
+    const uint32_t first = getU32(record + 8);
+    const uint32_t count = getU32(record + 12);
+    if (first > versionCount_ || count > versionCount_ - first) {
+        return {0, 0};
+    }
+    return {first, count};
+}
+
+uint32_t CapabilitySnapshot::firstVersionAtOrAbove(uint32_t first, uint32_t count, uint64_t version) const {
+    uint32_t low = first, high = first + count;
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+        if (getU64(versions_ + size_t(mid) * VERSION_SIZE) < version) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+std::pair<uint32_t, uint32_t> CapabilitySnapshot::versionPostings(uint32_t version) const {
+    const uint8_t* record = versions_ + size_t(version) * VERSION_SIZE;
+    const uint32_t first = getU32(record + 8);
+    const uint32_t count = getU32(record + 12);
+    if (first > rowCount_ || count > rowCount_ - first) {
+        return {0, 0};
+    }
+    return {first, count};
+}
+
+uint32_t CapabilitySnapshot::postingRow(uint32_t posting) const {
+    return getU32(postings_ + size_t(posting) * POSTING_SIZE);
+}
+
+const uint8_t* CapabilitySnapshot::row(uint32_t row) const {
+    return rows_ + size_t(row) * ROW_SIZE;
+}
+
+uint32_t CapabilitySnapshot::rowAgent(uint32_t row) const {
+    return getU32(this->row(row));
+}
+
+std::string_view CapabilitySnapshot::rowName(uint32_t row) const {
+    const uint32_t name = getU32(this->row(row) + 4);
+    return name < nameCount_ ? string(names_ + size_t(name) * NAME_SIZE) : std::string_view();
+}
+
+uint64_t CapabilitySnapshot::rowVersion(uint32_t row) const {
+    return getU64(this->row(row) + 8);
+}
+
+std::optional<uint32_t> CapabilitySnapshot::findRow(uint32_t agent, std::string_view name, uint64_t version) const {
+    auto [first, count] = agentRows(agent);
+    for (uint32_t r = first; r < first + count; ++r) {
+        if (rowVersion(r) == version && rowName(r) == name) {
+            return r;
+        }
+    }
+    return std::nullopt;
+}
+
+bool CapabilitySnapshot::rowHasParameters(uint32_t row, const std::map<std::string, std::string>& required) const {
+    const uint8_t* record = this->row(row);
+    const uint32_t first = getU32(record + 16);
+    uint32_t count = getU32(record + 20);
+    if (first > parameterCount_ || count > parameterCount_ - first) {
+        count = 0;
+    }
+    for (const auto& [key, value] : required) {
+        bool found = false;
+        for (uint32_t p = first; p < first + count && !found; ++p) {
+            const uint8_t* parameter = parameters_ + size_t(p) * PARAMETER_SIZE;
+            found = string(parameter) == key && string(parameter + STRING_REF_SIZE) == value;
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Capability CapabilitySnapshot::capability(uint32_t row) const {
+    const uint8_t* record = this->row(row);
+    Capability cap(std::string(rowName(row)), Version::fromPacked(getU64(record + 8)));
+    const uint32_t first = getU32(record + 16);
+    const uint32_t count = getU32(record + 20);
+    if (first <= parameterCount_ && count <= parameterCount_ - first) {
+        for (uint32_t p = first; p < first + count; ++p) {
+            const uint8_t* parameter = parameters_ + size_t(p) * PARAMETER_SIZE;
+            cap.parameters.emplace(std::string(string(parameter)), std::string(string(parameter + STRING_REF_SIZE)));
+        }
+    }
+    const uint32_t flags = getU32(record + 24);
+    cap.is_deprecated = (flags & ROW_DEPRECATED) != 0;
+    if (flags & ROW_HAS_DEPRECATED_SINCE) {
+        cap.deprecated_since = Version::fromPacked(getU64(record + 28));
+    }
+    if (flags & ROW_HAS_REMOVAL) {
+        cap.removal_version = Version::fromPacked(getU64(record + 36));
+    }
+    if (flags & ROW_HAS_REPLACEMENT) {
+        cap.replacement_capability = std::string(string(record + 44));
+    }
+    return cap;
+}
+
+} // namespace core
+} // namespace xenocomm
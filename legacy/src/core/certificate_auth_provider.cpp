@@ -1,10 +1,15 @@
 #include "xenocomm/core/certificate_auth_provider.hpp"
+#include "xenocomm/core/crypto_worker_pool.hpp"
 #include <openssl/pem.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
 #include <openssl/x509_vfy.h>
+#include <atomic>
 #include <chrono>
 #include <fstream>
+#include <limits>
 #include <sstream>
+#include <unordered_map>
 
 namespace xenocomm {
 namespace core {
@@ -87,7 +92,11 @@ namespace {
 class CertificateAuthProvider::Impl {
 public:
     explicit Impl(CertificateAuthConfig config) 
-        : config_(std::move(config)), store_(nullptr) {}
+        : config_(std::move(config)), store_(nullptr) {
+        if (config_.maxCachedChains > 0) {
+            cache_ = std::make_unique<AuthCache>(config_.maxCachedChains, config_.chainCacheTTL);
+        }
+    }
     
     ~Impl() {
         if (store_) {
@@ -118,9 +127,79 @@ public:
     }
 
     AuthResult authenticate(const AuthenticationContext& context) {
+        const std::string key = cacheKey(context.credentials);
+        if (cache_) {
+            if (auto agentId = cache_->lookup(key)) {
+                return AuthResult::Success(*agentId);
+            }
+        }
+        return verify(context.credentials, key);
+    }
+
+    std::vector<AuthResult> authenticateBatch(const std::vector<AuthenticationContext>& contexts) {
+        constexpr size_t CACHED = std::numeric_limits<size_t>::max();
+        std::vector<AuthResult> results(contexts.size());
+        std::vector<std::string> keys(contexts.size());
+        std::vector<size_t> verification(contexts.size(), CACHED);  // Index into pending
+        std::vector<size_t> pending;  // First context presenting each distinct uncached certificate
+        std::unordered_map<std::string, size_t> pendingByKey;
+
+        for (size_t i = 0; i < contexts.size(); ++i) {
+            keys[i] = cacheKey(contexts[i].credentials);
+            if (cache_) {
+                if (auto agentId = cache_->lookup(keys[i])) {
+                    results[i] = AuthResult::Success(*agentId);
+                    continue;
+                }
+            }
+            auto inserted = pendingByKey.emplace(keys[i], pending.size());
+            if (inserted.second) {
+                pending.push_back(i);
+            }
+            verification[i] = inserted.first->second;
+        }
+
+        std::vector<AuthResult> verified(pending.size());
+        CryptoWorkerPool::shared().runOrdered(pending.size(),
+            [&](size_t j) {
+                verified[j] = verify(contexts[pending[j]].credentials, keys[pending[j]]);
+                return true;
+            },
+            [](size_t) { return true; });
+
+        for (size_t i = 0; i < contexts.size(); ++i) {
+            if (verification[i] != CACHED) {
+                results[i] = verified[verification[i]];
+            }
+        }
+        return results;
+    }
+
+    bool reloadCRL() {
+        bool loaded = !config_.crlPath.empty() && loadCRL();
+        // Verifications still running key their results by the old generation, so none survive
+        ++generation_;
+        if (cache_) {
+            cache_->clear();
+        }
+        return loaded;
+    }
+
+    void invalidate(const std::vector<uint8_t>& certificate) {
+        if (cache_) {
+            cache_->erase(cacheKey(certificate));
+        }
+    }
+
+    AuthCache::Stats getCacheStats() const {
+        return cache_ ? cache_->getStats() : AuthCache::Stats();
+    }
+
+    // Parses and verifies a DER certificate; a success is cached under key
+    AuthResult verify(const std::vector<uint8_t>& credentials, const std::string& key) {
         // Parse certificate from credentials
-        const unsigned char* data = context.credentials.data();
-        X509* cert = d2i_X509(nullptr, &data, context.credentials.size());
+        const unsigned char* data = credentials.data();
+        X509* cert = d2i_X509(nullptr, &data, static_cast<long>(credentials.size()));
         if (!cert) {
             return AuthResult::Failure("Invalid certificate format: " + getOpenSSLError());
         }
@@ -141,8 +220,8 @@ public:
             return AuthResult::Failure("Failed to initialize verification context: " + getOpenSSLError());
         }
 
-        // Set verification flags
-        unsigned long flags = X509_V_FLAG_CRL_CHECK;
+        // Set verification flags; without a loaded CRL every check would fail for want of one
+        unsigned long flags = crlLoaded_ ? X509_V_FLAG_CRL_CHECK : 0;
         if (!config_.allowSelfSigned) {
             flags |= X509_V_FLAG_X509_STRICT;
         }
@@ -169,8 +248,16 @@ public:
         X509_NAME* subject = X509_get_subject_name(cert);
         char commonName[256];
         X509_NAME_get_text_by_NID(subject, NID_commonName, commonName, sizeof(commonName));
+        std::string agentId(commonName);
+
+        // A cached verification must not outlive the certificate
+        auto cachedUntil = std::chrono::system_clock::now() +
+            (cache_ ? cache_->ttl() : std::chrono::seconds(0));
+        if (cache_ && asn1TimeToTimeT(X509_get0_notAfter(cert)) > std::chrono::system_clock::to_time_t(cachedUntil)) {
+            cache_->insert(key, agentId);
+        }
 
-        return AuthResult::Success(std::string(commonName));
+        return AuthResult::Success(agentId);
     }
 
     std::string getMethodName() const {
@@ -219,11 +306,25 @@ private:
             return false;
         }
         
+        crlLoaded_ = true;
         return true;
     }
 
+    // Fingerprint of the DER certificate, scoped to the current CRL generation
+    std::string cacheKey(const std::vector<uint8_t>& certificate) const {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_Digest(certificate.data(), certificate.size(), digest, &length, EVP_sha256(), nullptr);
+        std::string key = std::to_string(generation_.load()) + ":";
+        key.append(reinterpret_cast<const char*>(digest), length);
+        return key;
+    }
+
     CertificateAuthConfig config_;
     X509_STORE* store_;
+    std::unique_ptr<AuthCache> cache_;
+    std::atomic<uint64_t> generation_{0};  // Bumped by reloadCRL
+    std::atomic<bool> crlLoaded_{false};
 };
 
 // CertificateAuthProvider implementation
@@ -244,5 +345,22 @@ std::string CertificateAuthProvider::getMethodName() const {
     return impl_->getMethodName();
 }
 
+std::vector<AuthResult> CertificateAuthProvider::authenticateBatch(
+    const std::vector<AuthenticationContext>& contexts) {
+    return impl_->authenticateBatch(contexts);
+}
+
+bool CertificateAuthProvider::reloadCRL() {
+    return impl_->reloadCRL();
+}
+
+void CertificateAuthProvider::invalidate(const std::vector<uint8_t>& certificate) {
+    impl_->invalidate(certificate);
+}
+
+AuthCache::Stats CertificateAuthProvider::getCacheStats() const {
+    return impl_->getCacheStats();
+}
+
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
@@ -4,23 +4,49 @@
 #include <iomanip>
 #include <chrono>
 #include <stdexcept>
+#include <algorithm>
 
 namespace xenocomm {
 namespace core {
 
-CompressedStateAdapter::CompressedStateAdapter(std::unique_ptr<CompressionAlgorithm> algorithm)
-    : compression_algorithm_(std::move(algorithm)) {
-    if (!compression_algorithm_) {
-        throw TranscodingError("Compression algorithm cannot be null");
+namespace {
+
+// Unchanged bytes shorter than this between two changed ones are sent inside one run
+constexpr size_t MIN_DIFF_GAP = 8;
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
     }
+    out.push_back(static_cast<uint8_t>(value));
 }
 
+uint64_t getVarint(const std::vector<uint8_t>& in, size_t& pos) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw CompressionError("Invalid delta: truncated length", CompressionErrorCode::INVALID_FORMAT);
+}
+
+} // namespace
+
+CompressedStateAdapter::CompressedStateAdapter(std::unique_ptr<CompressionAlgorithm> algorithm,
+                                               const CompressionSelectorConfig& selector_config)
+    : compression_algorithm_(std::move(algorithm)), selector_(selector_config) {}
+
 std::vector<uint8_t> CompressedStateAdapter::createHeader(
     const std::vector<uint8_t>& original_data,
+    const CompressionAlgorithm& algorithm,
     float compression_ratio) const {
     
     // Create JSON metadata
-    std::string metadata = createMetadataJson(compression_ratio);
+    std::string metadata = createMetadataJson(algorithm, compression_ratio);
     
     // Calculate total header size
     size_t header_size = sizeof(CompressedHeader) + metadata.length();
@@ -29,7 +55,7 @@ std::vector<uint8_t> CompressedStateAdapter::createHeader(
     // Fill header structure
     CompressedHeader* h = reinterpret_cast<CompressedHeader*>(header.data());
     std::memcpy(h->magic, MAGIC_HEADER, sizeof(MAGIC_HEADER));
-    h->algorithm_id = getAlgorithmId(*compression_algorithm_);
+    h->algorithm_id = getAlgorithmId(algorithm);
     h->original_size = static_cast<uint32_t>(original_data.size());
     h->checksum = CompressionAlgorithm::calculateChecksum(original_data);
     h->metadata_length = static_cast<uint16_t>(metadata.length());
@@ -72,7 +98,8 @@ CompressedStateAdapter::CompressedHeader CompressedStateAdapter::parseHeader(
     return header;
 }
 
-std::string CompressedStateAdapter::createMetadataJson(float compression_ratio) const {
+std::string CompressedStateAdapter::createMetadataJson(const CompressionAlgorithm& algorithm,
+                                                       float compression_ratio) const {
     auto now = std::chrono::system_clock::now();
     auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
@@ -80,43 +107,43 @@ std::string CompressedStateAdapter::createMetadataJson(float compression_ratio)
     std::ostringstream json;
     json << "{\"compression_ratio\":" << std::fixed << std::setprecision(2) << compression_ratio
          << ",\"timestamp\":" << timestamp
-         << ",\"algorithm\":\"" << compression_algorithm_->getAlgorithmId() << "\"}";
+         << ",\"algorithm\":\"" << algorithm.getAlgorithmId() << "\"}";
     
     return json.str();
 }
 
-std::shared_ptr<CompressionAlgorithm> CompressedStateAdapter::selectBestAlgorithm(
-    const std::vector<uint8_t>& data) const {
-    
-    // Create instances of available algorithms
-    auto rle = std::make_shared<RunLengthEncoding>();
-    auto delta = std::make_shared<DeltaEncoding>();
-    
-    // Check suitability for each algorithm
-    if (rle->isSuitableFor(data)) {
-        return rle;
-    } else if (delta->isSuitableFor(data)) {
-        return delta;
-    }
-    
-    // Default to RLE for general cases
-    return rle;
-}
-
 uint8_t CompressedStateAdapter::getAlgorithmId(const CompressionAlgorithm& algorithm) const {
     std::string id = algorithm.getAlgorithmId();
+    if (id == "NONE") return ALGORITHM_NONE;
     if (id == "RLE") return ALGORITHM_RLE;
     if (id == "DELTA") return ALGORITHM_DELTA;
+    if (id == "LZ4") return ALGORITHM_LZ4;
+    if (id == "ZSTD") return ALGORITHM_ZSTD;
+    if (id == "PACKED_DELTA") return ALGORITHM_PACKED_DELTA;
     throw CompressionError("Unknown compression algorithm",
                           CompressionErrorCode::UNSUPPORTED_ALGORITHM);
 }
 
 std::unique_ptr<CompressionAlgorithm> CompressedStateAdapter::createAlgorithm(uint8_t algorithm_id) const {
+    // Data made by the configured algorithm is decoded by a copy of it, so
+    // settings such as a Zstd dictionary carry over
+    if (compression_algorithm_ && getAlgorithmId(*compression_algorithm_) == algorithm_id) {
+        return compression_algorithm_->clone();
+    }
     switch (algorithm_id) {
+        case ALGORITHM_NONE:
+            return std::make_unique<NoCompression>();
         case ALGORITHM_RLE:
             return std::make_unique<RunLengthEncoding>();
         case ALGORITHM_DELTA:
             return std::make_unique<DeltaEncoding>();
+        case ALGORITHM_LZ4:
+            return std::make_unique<LZ4Compression>();
+        case ALGORITHM_ZSTD:
+            return std::make_unique<ZstdCompression>();
+        case ALGORITHM_PACKED_DELTA:
+            // Width and order are recorded in the compressed data itself
+            return std::make_unique<PackedDeltaEncoding>();
         default:
             throw CompressionError("Unsupported compression algorithm ID",
                                  CompressionErrorCode::UNSUPPORTED_ALGORITHM);
@@ -124,6 +151,11 @@ std::unique_ptr<CompressionAlgorithm> CompressedStateAdapter::createAlgorithm(ui
 }
 
 std::vector<uint8_t> CompressedStateAdapter::encode(const void* data, size_t size, DataFormat format) {
+    return encode(data, size, format, std::string());
+}
+
+std::vector<uint8_t> CompressedStateAdapter::encode(const void* data, size_t size, DataFormat format,
+                                                    const std::string& message_type) {
     if (!data || size == 0) {
         throw TranscodingError("Invalid input data");
     }
@@ -136,19 +168,31 @@ std::vector<uint8_t> CompressedStateAdapter::encode(const void* data, size_t siz
     const uint8_t* bytes = static_cast<const uint8_t*>(data);
     std::vector<uint8_t> input_data(bytes, bytes + size);
     
-    // Select best algorithm if none is set
-    if (!compression_algorithm_) {
-        compression_algorithm_ = selectBestAlgorithm(input_data)->clone();
+    // Without a configured algorithm the selector picks one for this payload
+    // and learns from how it does
+    std::unique_ptr<CompressionAlgorithm> selected;
+    CompressionChoice choice;
+    CompressionAlgorithm* algorithm = compression_algorithm_.get();
+    if (!algorithm) {
+        choice = selector_.select(input_data, message_type);
+        selected = CompressionSelector::createAlgorithm(choice);
+        algorithm = selected.get();
     }
     
     // Compress the data
-    auto compressed = compression_algorithm_->compress(input_data);
+    auto started = std::chrono::steady_clock::now();
+    auto compressed = algorithm->compress(input_data);
+    if (selected) {
+        selector_.observe(message_type, choice, size, compressed.size(),
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - started));
+    }
     
     // Calculate compression ratio
     float compression_ratio = static_cast<float>(compressed.size()) / size;
     
     // Create header
-    std::vector<uint8_t> result = createHeader(input_data, compression_ratio);
+    std::vector<uint8_t> result = createHeader(input_data, *algorithm, compression_ratio);
     
     // Combine header and compressed data
     result.insert(result.end(), compressed.begin(), compressed.end());
@@ -190,17 +234,216 @@ std::vector<uint8_t> CompressedStateAdapter::decode(
     return decompressed;
 }
 
+CompressedStateAdapter::DeltaFrame CompressedStateAdapter::encodeDelta(const std::string& peer, const void* data,
+                                                                       size_t size, const std::string& message_type) {
+    if (!data || size == 0) {
+        throw TranscodingError("Invalid input data");
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::vector<uint8_t> state(bytes, bytes + size);
+
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    auto& sent = sent_states_[peer];
+    DeltaHeader header;
+    std::memcpy(header.magic, DELTA_MAGIC, sizeof(DELTA_MAGIC));
+    header.base_version = 0;
+    header.version = sent.next_version++;
+    header.state_size = static_cast<uint32_t>(size);
+    header.state_checksum = CompressionAlgorithm::calculateChecksum(state);
+
+    // Diffs get their own selector entry, as they compress nothing like the states themselves
+    std::vector<uint8_t> payload;
+    if (sent.baseline_version != 0) {
+        auto diff = diffStates(sent.baseline, state);
+        if (diff.size() < state.size()) {
+            payload = encode(diff.data(), diff.size(), DataFormat::COMPRESSED_STATE, message_type + ".delta");
+            header.base_version = sent.baseline_version;
+        }
+    }
+    if (header.base_version == 0) {
+        payload = encode(state.data(), state.size(), DataFormat::COMPRESSED_STATE, message_type);
+    }
+
+    DeltaFrame frame;
+    frame.data.resize(sizeof(DeltaHeader));
+    std::memcpy(frame.data.data(), &header, sizeof(DeltaHeader));
+    frame.data.insert(frame.data.end(), payload.begin(), payload.end());
+    frame.version = header.version;
+    frame.snapshot = header.base_version == 0;
+
+    sent.unacknowledged.emplace_back(header.version, std::move(state));
+    if (sent.unacknowledged.size() > MAX_DELTA_HISTORY) {
+        sent.unacknowledged.pop_front();  // Its acknowledgment will be ignored
+    }
+    return frame;
+}
+
+void CompressedStateAdapter::acknowledgeDelta(const std::string& peer, uint32_t version) {
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    auto it = sent_states_.find(peer);
+    if (it == sent_states_.end()) {
+        return;
+    }
+    auto& sent = it->second;
+    auto acked = std::find_if(sent.unacknowledged.begin(), sent.unacknowledged.end(),
+                              [version](const auto& entry) { return entry.first == version; });
+    if (acked == sent.unacknowledged.end()) {
+        return;
+    }
+    sent.baseline_version = version;
+    sent.baseline = std::move(acked->second);
+    // Older states can no longer become the baseline
+    sent.unacknowledged.erase(sent.unacknowledged.begin(), acked + 1);
+}
+
+CompressedStateAdapter::DecodedState CompressedStateAdapter::decodeDelta(const std::string& peer,
+                                                                         const std::vector<uint8_t>& frame) {
+    if (frame.size() < sizeof(DeltaHeader)) {
+        throw CompressionError("Invalid delta: header too small", CompressionErrorCode::INVALID_FORMAT);
+    }
+    DeltaHeader header;
+    std::memcpy(&header, frame.data(), sizeof(DeltaHeader));
+    if (std::memcmp(header.magic, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0) {
+        throw CompressionError("Invalid delta: wrong magic number", CompressionErrorCode::INVALID_FORMAT);
+    }
+    auto payload = decode(std::vector<uint8_t>(frame.begin() + sizeof(DeltaHeader), frame.end()),
+                          DataFormat::COMPRESSED_STATE);
+
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    auto& received = received_states_[peer];
+    DecodedState decoded;
+    decoded.version = header.version;
+    if (header.base_version == 0) {
+        decoded.state = std::move(payload);
+    } else {
+        auto base = std::find_if(received.begin(), received.end(),
+                                 [&header](const auto& entry) { return entry.first == header.base_version; });
+        if (base == received.end()) {
+            throw CompressionError("Delta baseline " + std::to_string(header.base_version) + " is not held",
+                                   CompressionErrorCode::BASELINE_MISSING);
+        }
+        decoded.state = applyDiff(base->second, payload, header.state_size);
+        // The sender has its acknowledgment, so nothing older will be a baseline again
+        received.erase(received.begin(), base);
+    }
+    if (decoded.state.size() != header.state_size ||
+        CompressionAlgorithm::calculateChecksum(decoded.state) != header.state_checksum) {
+        throw CompressionError("Checksum mismatch in rebuilt state", CompressionErrorCode::CHECKSUM_MISMATCH);
+    }
+
+    // A sender that restarted numbers from 1 again; its state replaces ours
+    received.erase(std::remove_if(received.begin(), received.end(),
+                                  [&header](const auto& entry) { return entry.first == header.version; }),
+                   received.end());
+    received.emplace_back(decoded.version, decoded.state);
+    if (received.size() > MAX_DELTA_HISTORY + 1) {
+        received.pop_front();
+    }
+    return decoded;
+}
+
+void CompressedStateAdapter::forgetPeer(const std::string& peer) {
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    auto it = sent_states_.find(peer);
+    if (it != sent_states_.end()) {
+        it->second.baseline_version = 0;
+        it->second.baseline.clear();
+        it->second.unacknowledged.clear();
+    }
+    received_states_.erase(peer);
+}
+
+std::vector<uint8_t> CompressedStateAdapter::diffStates(const std::vector<uint8_t>& base,
+                                                        const std::vector<uint8_t>& state) {
+    // Runs of bytes that differ, as (offset, length); bytes past the end of base count as zero
+    std::vector<std::pair<size_t, size_t>> runs;
+    const size_t common = std::min(base.size(), state.size());
+    size_t i = 0;
+    while (i < state.size()) {
+        // Equal stretches are skipped a word at a time
+        while (i + sizeof(uint64_t) <= common && std::memcmp(&base[i], &state[i], sizeof(uint64_t)) == 0) {
+            i += sizeof(uint64_t);
+        }
+        if (i < common && base[i] == state[i]) {
+            ++i;
+            continue;
+        }
+        if (i >= state.size()) {
+            break;
+        }
+        if (i >= common && state[i] == 0) {
+            ++i;
+            continue;
+        }
+        if (!runs.empty() && i - (runs.back().first + runs.back().second) < MIN_DIFF_GAP) {
+            runs.back().second = i + 1 - runs.back().first;
+        } else {
+            runs.emplace_back(i, 1);
+        }
+        ++i;
+    }
+
+    std::vector<uint8_t> diff;
+    putVarint(diff, runs.size());
+    size_t position = 0;
+    for (const auto& [offset, length] : runs) {
+        putVarint(diff, offset - position);
+        putVarint(diff, length);
+        for (size_t j = offset; j < offset + length; ++j) {
+            diff.push_back(state[j] ^ (j < base.size() ? base[j] : 0));
+        }
+        position = offset + length;
+    }
+    return diff;
+}
+
+std::vector<uint8_t> CompressedStateAdapter::applyDiff(const std::vector<uint8_t>& base,
+                                                       const std::vector<uint8_t>& diff, size_t state_size) {
+    std::vector<uint8_t> state(base.begin(), base.begin() + std::min(base.size(), state_size));
+    state.resize(state_size, 0);
+    size_t pos = 0;
+    const uint64_t count = getVarint(diff, pos);
+    uint64_t position = 0;
+    for (uint64_t run = 0; run < count; ++run) {
+        const uint64_t skip = getVarint(diff, pos);
+        const uint64_t length = getVarint(diff, pos);
+        if (skip > state_size - position || length > state_size - position - skip || length > diff.size() - pos) {
+            throw CompressionError("Invalid delta: run out of bounds", CompressionErrorCode::INVALID_FORMAT);
+        }
+        position += skip;
+        for (uint64_t j = 0; j < length; ++j) {
+            state[position + j] ^= diff[pos++];
+        }
+        position += length;
+    }
+    return state;
+}
+
 bool CompressedStateAdapter::isValidFormat(const void* data, size_t size, DataFormat format) const {
     if (!data || size == 0) return false;
     if (format != DataFormat::COMPRESSED_STATE) return false;
     
-    // Check if data starts with our magic number
+    // Check if data starts with our magic number, or that of a delta frame
     const uint8_t* bytes = static_cast<const uint8_t*>(data);
     return (size >= sizeof(MAGIC_HEADER) && 
-            std::memcmp(bytes, MAGIC_HEADER, sizeof(MAGIC_HEADER)) == 0);
+            (std::memcmp(bytes, MAGIC_HEADER, sizeof(MAGIC_HEADER)) == 0 ||
+             std::memcmp(bytes, DELTA_MAGIC, sizeof(DELTA_MAGIC)) == 0));
 }
 
 TranscodingMetadata CompressedStateAdapter::getMetadata(const std::vector<uint8_t>& encoded_data) const {
+    // A delta frame reports on its payload, measured against the state it rebuilds
+    if (encoded_data.size() >= sizeof(DeltaHeader) &&
+        std::memcmp(encoded_data.data(), DELTA_MAGIC, sizeof(DELTA_MAGIC)) == 0) {
+        DeltaHeader delta;
+        std::memcpy(&delta, encoded_data.data(), sizeof(DeltaHeader));
+        TranscodingMetadata metadata =
+            getMetadata(std::vector<uint8_t>(encoded_data.begin() + sizeof(DeltaHeader), encoded_data.end()));
+        metadata.uncompressed_data_size = delta.state_size;
+        metadata.encoded_data_size = encoded_data.size();
+        metadata.compression_ratio_value = static_cast<float>(encoded_data.size()) / delta.state_size;
+        return metadata;
+    }
+
     size_t header_size;
     CompressedHeader header = parseHeader(encoded_data, header_size);
     
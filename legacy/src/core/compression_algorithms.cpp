@@ -2,6 +2,27 @@
 #include <algorithm>
 #include <cstring>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#define XENOCOMM_COMPRESSION_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define XENOCOMM_COMPRESSION_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifdef XENOCOMM_HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef XENOCOMM_HAVE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
 
 namespace xenocomm {
 namespace core {
@@ -51,6 +72,240 @@ bool hasSequentialPattern(const std::vector<uint8_t>& data, int max_delta = 3) {
     return sequential_count >= (data.size() - 1) * 7 / 10;
 }
 
+// Number of leading bytes of data[0, limit) equal to value; limit is at least 1 and data[0] == value
+size_t runLength(const uint8_t* data, size_t limit, uint8_t value) {
+    size_t i = 0;
+#if defined(XENOCOMM_COMPRESSION_HAVE_SSE2)
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    for (; i + 16 <= limit; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned differs = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle))) & 0xFFFFu;
+        if (differs != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(differs));
+        }
+    }
+#elif defined(XENOCOMM_COMPRESSION_HAVE_NEON)
+    const uint8x16_t needle = vdupq_n_u8(value);
+    for (; i + 16 <= limit; i += 16) {
+        uint8x16_t equal = vceqq_u8(vld1q_u8(data + i), needle);
+        // Narrow to four bits per byte so the comparison fits one 64-bit mask
+        uint64_t differs = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+        if (differs != 0) {
+            return i + static_cast<size_t>(__builtin_ctzll(differs)) / 4;
+        }
+    }
+#endif
+    while (i < limit && data[i] == value) {
+        ++i;
+    }
+    return i;
+}
+
+// Integers of the element type, read and written little-endian
+template <typename T>
+T loadLittleEndian(const uint8_t* bytes) {
+    T value = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<T>(bytes[i]) << (8 * i));
+    }
+#else
+    std::memcpy(&value, bytes, sizeof(T));
+#endif
+    return value;
+}
+
+template <typename T>
+void storeLittleEndian(uint8_t* bytes, T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+#else
+    std::memcpy(bytes, &value, sizeof(T));
+#endif
+}
+
+template <typename T>
+T zigzag(T delta) {
+    using Signed = typename std::make_signed<T>::type;
+    return static_cast<T>(static_cast<T>(delta << 1) ^
+                          static_cast<T>(static_cast<Signed>(delta) >> (sizeof(T) * 8 - 1)));
+}
+
+template <typename T>
+T unzigzag(T coded) {
+    return static_cast<T>((coded >> 1) ^ static_cast<T>(T(0) - (coded & 1)));
+}
+
+unsigned bitWidth(uint64_t value) {
+    return value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(value));
+}
+
+// Little-endian bit stream for residual blocks; each block starts on a byte boundary
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void put(uint64_t value, unsigned bits) {
+        while (bits > 0) {
+            unsigned take = std::min(bits, 64 - fill_);
+            uint64_t part = take == 64 ? value : value & ((uint64_t{1} << take) - 1);
+            accumulator_ |= part << fill_;
+            fill_ += take;
+            bits -= take;
+            value = take == 64 ? 0 : value >> take;
+            if (fill_ == 64) {
+                flush(8);
+            }
+        }
+    }
+
+    void align() { flush((fill_ + 7) / 8); }
+
+private:
+    void flush(unsigned bytes) {
+        for (unsigned i = 0; i < bytes; ++i) {
+            out_.push_back(static_cast<uint8_t>(accumulator_ >> (8 * i)));
+        }
+        accumulator_ = 0;
+        fill_ = 0;
+    }
+
+    std::vector<uint8_t>& out_;
+    uint64_t accumulator_ = 0;
+    unsigned fill_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint64_t get(unsigned bits) {
+        uint64_t value = 0;
+        unsigned filled = 0;
+        while (filled < bits) {
+            if (available_ == 0) {
+                accumulator_ = data_[position_++];
+                available_ = 8;
+            }
+            unsigned take = std::min(bits - filled, available_);
+            value |= (accumulator_ & ((uint64_t{1} << take) - 1)) << filled;
+            accumulator_ >>= take;
+            available_ -= take;
+            filled += take;
+        }
+        return value;
+    }
+
+    void align() { available_ = 0; }
+    size_t position() const { return position_; }
+    bool canRead(size_t bytes) const { return bytes <= size_ - position_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t position_ = 0;
+    uint64_t accumulator_ = 0;
+    unsigned available_ = 0;
+};
+
+// Compressed form of PackedDeltaEncoding: width, order, element count, then the first
+// element (and first delta for DELTA_OF_DELTA) verbatim before the residual blocks
+constexpr size_t PACKED_DELTA_HEADER = 2 + sizeof(uint32_t);
+
+template <typename T>
+void packDeltas(const uint8_t* data, size_t count, PackedDeltaEncoding::Order order, std::vector<uint8_t>& out) {
+    const bool second_order = order == PackedDeltaEncoding::Order::DELTA_OF_DELTA;
+    T previous = loadLittleEndian<T>(data);
+    T previous_delta = 0;
+    size_t start = 1;
+    out.resize(out.size() + sizeof(T));
+    storeLittleEndian(out.data() + out.size() - sizeof(T), previous);
+    if (second_order && count > 1) {
+        T value = loadLittleEndian<T>(data + sizeof(T));
+        previous_delta = static_cast<T>(value - previous);
+        previous = value;
+        out.resize(out.size() + sizeof(T));
+        storeLittleEndian(out.data() + out.size() - sizeof(T), previous_delta);
+        start = 2;
+    }
+
+    T residuals[PackedDeltaEncoding::BLOCK_SIZE];
+    BitWriter writer(out);
+    for (size_t block = start; block < count; block += PackedDeltaEncoding::BLOCK_SIZE) {
+        const size_t n = std::min(PackedDeltaEncoding::BLOCK_SIZE, count - block);
+        T used = 0;
+        for (size_t i = 0; i < n; ++i) {
+            T value = loadLittleEndian<T>(data + (block + i) * sizeof(T));
+            T delta = static_cast<T>(value - previous);
+            T residual = second_order ? static_cast<T>(delta - previous_delta) : delta;
+            previous = value;
+            previous_delta = delta;
+            residuals[i] = zigzag(residual);
+            used |= residuals[i];
+        }
+
+        const unsigned bits = bitWidth(used);
+        out.push_back(static_cast<uint8_t>(bits));
+        for (size_t i = 0; i < n; ++i) {
+            writer.put(residuals[i], bits);
+        }
+        writer.align();
+    }
+}
+
+template <typename T>
+bool unpackDeltas(const uint8_t* data, size_t size, size_t count, PackedDeltaEncoding::Order order,
+                  uint8_t* out, size_t& consumed) {
+    const bool second_order = order == PackedDeltaEncoding::Order::DELTA_OF_DELTA;
+    const size_t verbatim = second_order && count > 1 ? 2 : 1;
+    if (size < verbatim * sizeof(T)) {
+        return false;
+    }
+    T previous = loadLittleEndian<T>(data);
+    T previous_delta = 0;
+    storeLittleEndian(out, previous);
+    if (verbatim == 2) {
+        previous_delta = loadLittleEndian<T>(data + sizeof(T));
+        previous = static_cast<T>(previous + previous_delta);
+        storeLittleEndian(out + sizeof(T), previous);
+    }
+
+    BitReader reader(data + verbatim * sizeof(T), size - verbatim * sizeof(T));
+    for (size_t block = verbatim; block < count; block += PackedDeltaEncoding::BLOCK_SIZE) {
+        const size_t n = std::min(PackedDeltaEncoding::BLOCK_SIZE, count - block);
+        if (!reader.canRead(1)) {
+            return false;
+        }
+        const unsigned bits = reader.get(8);
+        reader.align();
+        if (bits > sizeof(T) * 8 || !reader.canRead((n * bits + 7) / 8)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            T residual = unzigzag(static_cast<T>(reader.get(bits)));
+            T delta = second_order ? static_cast<T>(previous_delta + residual) : residual;
+            previous = static_cast<T>(previous + delta);
+            previous_delta = delta;
+            storeLittleEndian(out + (block + i) * sizeof(T), previous);
+        }
+        reader.align();
+    }
+    consumed = verbatim * sizeof(T) + reader.position();
+    return true;
+}
+
+// Below this the fixed framing of the general-purpose codecs outweighs what they save
+constexpr size_t MIN_GENERAL_PURPOSE_SIZE = 64;
+
+#if !defined(XENOCOMM_HAVE_LZ4) || !defined(XENOCOMM_HAVE_ZSTD)
+[[noreturn]] void throwUnavailable(const char* algorithm) {
+    throw CompressionError(std::string(algorithm) + " support is not built in",
+                           CompressionErrorCode::UNSUPPORTED_ALGORITHM);
+}
+#endif
+
 } // namespace
 
 // RunLengthEncoding implementation
@@ -58,27 +313,18 @@ std::vector<uint8_t> RunLengthEncoding::compress(const std::vector<uint8_t>& dat
     if (data.empty()) return {};
 
     std::vector<uint8_t> compressed;
-    compressed.reserve(data.size()); // Reserve space for worst case
-
-    uint8_t current = data[0];
-    uint8_t count = 1;
-
-    for (size_t i = 1; i < data.size(); ++i) {
-        if (data[i] == current && count < std::numeric_limits<uint8_t>::max()) {
-            count++;
-        } else {
-            // Store the count and value
-            compressed.push_back(count);
-            compressed.push_back(current);
-            current = data[i];
-            count = 1;
-        }
+    compressed.reserve(data.size()); // Reserve space for the common case
+
+    // Store each run as a count and value, splitting runs longer than a count can hold
+    constexpr size_t MAX_RUN = std::numeric_limits<uint8_t>::max();
+    for (size_t i = 0; i < data.size();) {
+        uint8_t current = data[i];
+        size_t count = runLength(data.data() + i, std::min(MAX_RUN, data.size() - i), current);
+        compressed.push_back(static_cast<uint8_t>(count));
+        compressed.push_back(current);
+        i += count;
     }
 
-    // Store the last run
-    compressed.push_back(count);
-    compressed.push_back(current);
-
     return compressed;
 }
 
@@ -178,5 +424,335 @@ bool DeltaEncoding::isSuitableFor(const std::vector<uint8_t>& data) const {
     return hasSequentialPattern(data);
 }
 
+// PackedDeltaEncoding implementation
+PackedDeltaEncoding::PackedDeltaEncoding(size_t element_width, Order order)
+    : element_width_(element_width), order_(order) {
+    if (element_width_ != 2 && element_width_ != 4 && element_width_ != 8) {
+        throw CompressionError("Packed delta element width must be 2, 4 or 8 bytes",
+                               CompressionErrorCode::UNSUPPORTED_ALGORITHM);
+    }
+    if (order_ != Order::DELTA && order_ != Order::DELTA_OF_DELTA) {
+        throw CompressionError("Unknown packed delta order", CompressionErrorCode::UNSUPPORTED_ALGORITHM);
+    }
+}
+
+std::vector<uint8_t> PackedDeltaEncoding::compress(const std::vector<uint8_t>& data) {
+    if (data.empty()) return {};
+    const size_t count = data.size() / element_width_;
+    if (count > std::numeric_limits<uint32_t>::max()) {
+        throw CompressionError("Input too large for packed delta encoding", CompressionErrorCode::BUFFER_OVERFLOW);
+    }
+
+    std::vector<uint8_t> compressed(PACKED_DELTA_HEADER);
+    compressed.reserve(data.size() / 2);
+    compressed[0] = static_cast<uint8_t>(element_width_);
+    compressed[1] = static_cast<uint8_t>(order_);
+    storeLittleEndian(compressed.data() + 2, static_cast<uint32_t>(count));
+
+    if (count > 0) {
+        switch (element_width_) {
+            case 2: packDeltas<uint16_t>(data.data(), count, order_, compressed); break;
+            case 4: packDeltas<uint32_t>(data.data(), count, order_, compressed); break;
+            default: packDeltas<uint64_t>(data.data(), count, order_, compressed); break;
+        }
+    }
+    compressed.insert(compressed.end(), data.begin() + count * element_width_, data.end());
+    return compressed;
+}
+
+std::vector<uint8_t> PackedDeltaEncoding::decompress(const std::vector<uint8_t>& compressed_data) {
+    if (compressed_data.empty()) return {};
+    if (compressed_data.size() < PACKED_DELTA_HEADER) {
+        throw CompressionError("Invalid packed delta data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+    const size_t width = compressed_data[0];
+    const auto order = static_cast<Order>(compressed_data[1]);
+    const size_t count = loadLittleEndian<uint32_t>(compressed_data.data() + 2);
+    if ((width != 2 && width != 4 && width != 8) || (order != Order::DELTA && order != Order::DELTA_OF_DELTA)) {
+        throw CompressionError("Invalid packed delta data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+
+    // Every element costs at least one bit-width byte per block, which bounds a plausible count
+    const size_t body_size = compressed_data.size() - PACKED_DELTA_HEADER;
+    if (count > 0 && (count - 1) / BLOCK_SIZE >= body_size) {
+        throw CompressionError("Invalid packed delta data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+
+    std::vector<uint8_t> decompressed(count * width);
+    size_t consumed = 0;
+    if (count > 0) {
+        const uint8_t* body = compressed_data.data() + PACKED_DELTA_HEADER;
+        bool ok = width == 2 ? unpackDeltas<uint16_t>(body, body_size, count, order, decompressed.data(), consumed)
+                : width == 4 ? unpackDeltas<uint32_t>(body, body_size, count, order, decompressed.data(), consumed)
+                             : unpackDeltas<uint64_t>(body, body_size, count, order, decompressed.data(), consumed);
+        if (!ok) {
+            throw CompressionError("Truncated packed delta data", CompressionErrorCode::DECOMPRESSION_FAILURE);
+        }
+    }
+
+    // Whatever follows the blocks is the tail that did not fill an element
+    const size_t tail = body_size - consumed;
+    if (tail >= width) {
+        throw CompressionError("Invalid packed delta data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+    decompressed.insert(decompressed.end(), compressed_data.end() - static_cast<std::ptrdiff_t>(tail),
+                        compressed_data.end());
+    return decompressed;
+}
+
+bool PackedDeltaEncoding::isSuitableFor(const std::vector<uint8_t>& data) const {
+    // Estimate from a prefix: worthwhile if the packed residuals take at most half the space
+    constexpr size_t SAMPLE_ELEMENTS = 4096;
+    const size_t count = std::min(data.size() / element_width_, SAMPLE_ELEMENTS);
+    if (count < 2 * BLOCK_SIZE / 8) {
+        return false;
+    }
+    std::vector<uint8_t> sample(data.begin(), data.begin() + count * element_width_);
+    PackedDeltaEncoding estimator(element_width_, order_);
+    return estimator.compress(sample).size() * 2 <= sample.size();
+}
+
+// LZ4Compression implementation
+LZ4Compression::LZ4Compression(int acceleration) : acceleration_(std::max(acceleration, 1)) {}
+
+bool LZ4Compression::isAvailable() {
+#ifdef XENOCOMM_HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<uint8_t> LZ4Compression::compress(const std::vector<uint8_t>& data) {
+    if (data.empty()) return {};
+#ifdef XENOCOMM_HAVE_LZ4
+    if (data.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        throw CompressionError("Input too large for LZ4", CompressionErrorCode::BUFFER_OVERFLOW);
+    }
+    const int size = static_cast<int>(data.size());
+    std::vector<uint8_t> compressed(sizeof(uint32_t) + static_cast<size_t>(LZ4_compressBound(size)));
+    const uint32_t original_size = static_cast<uint32_t>(data.size());
+    std::memcpy(compressed.data(), &original_size, sizeof(original_size));
+
+    int written = LZ4_compress_fast(reinterpret_cast<const char*>(data.data()),
+                                    reinterpret_cast<char*>(compressed.data() + sizeof(uint32_t)),
+                                    size, static_cast<int>(compressed.size() - sizeof(uint32_t)), acceleration_);
+    if (written <= 0) {
+        throw CompressionError("LZ4 compression failed", CompressionErrorCode::BUFFER_OVERFLOW);
+    }
+    compressed.resize(sizeof(uint32_t) + static_cast<size_t>(written));
+    return compressed;
+#else
+    throwUnavailable("LZ4");
+#endif
+}
+
+std::vector<uint8_t> LZ4Compression::decompress(const std::vector<uint8_t>& compressed_data) {
+    if (compressed_data.empty()) return {};
+#ifdef XENOCOMM_HAVE_LZ4
+    if (compressed_data.size() <= sizeof(uint32_t)) {
+        throw CompressionError("Invalid LZ4 compressed data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+    uint32_t original_size;
+    std::memcpy(&original_size, compressed_data.data(), sizeof(original_size));
+
+    // An LZ4 block expands at most 255-fold, so a larger claimed size is corrupt
+    const size_t block_size = compressed_data.size() - sizeof(uint32_t);
+    if (original_size > static_cast<uint64_t>(block_size) * 255 || original_size > static_cast<uint32_t>(LZ4_MAX_INPUT_SIZE)) {
+        throw CompressionError("Invalid LZ4 compressed data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+
+    std::vector<uint8_t> decompressed(original_size);
+    int read = LZ4_decompress_safe(reinterpret_cast<const char*>(compressed_data.data() + sizeof(uint32_t)),
+                                   reinterpret_cast<char*>(decompressed.data()),
+                                   static_cast<int>(block_size), static_cast<int>(original_size));
+    if (read < 0 || static_cast<uint32_t>(read) != original_size) {
+        throw CompressionError("Failed to decompress LZ4 data", CompressionErrorCode::DECOMPRESSION_FAILURE);
+    }
+    return decompressed;
+#else
+    throwUnavailable("LZ4");
+#endif
+}
+
+bool LZ4Compression::isSuitableFor(const std::vector<uint8_t>& data) const {
+    return isAvailable() && data.size() >= MIN_GENERAL_PURPOSE_SIZE;
+}
+
+// ZstdDictionary implementation
+struct ZstdDictionary::Digested {
+#ifdef XENOCOMM_HAVE_ZSTD
+    ZSTD_DDict* ddict = nullptr;
+    std::mutex mutex;
+    std::map<int, ZSTD_CDict*> cdicts;  // Built on first use of each level
+
+    ~Digested() {
+        ZSTD_freeDDict(ddict);
+        for (auto& entry : cdicts) {
+            ZSTD_freeCDict(entry.second);
+        }
+    }
+#endif
+};
+
+ZstdDictionary::ZstdDictionary(std::vector<uint8_t> content)
+    : content_(std::move(content)), digested_(std::make_unique<Digested>()) {
+#ifdef XENOCOMM_HAVE_ZSTD
+    if (content_.empty()) {
+        throw CompressionError("Zstd dictionary is empty", CompressionErrorCode::INVALID_FORMAT);
+    }
+    id_ = ZDICT_getDictID(content_.data(), content_.size());
+    digested_->ddict = ZSTD_createDDict(content_.data(), content_.size());
+    if (!digested_->ddict) {
+        throw CompressionError("Invalid Zstd dictionary", CompressionErrorCode::INVALID_FORMAT);
+    }
+#else
+    throwUnavailable("Zstd");
+#endif
+}
+
+ZstdDictionary::~ZstdDictionary() = default;
+
+std::shared_ptr<const ZstdDictionary> ZstdDictionary::train(const std::vector<std::vector<uint8_t>>& samples,
+                                                            size_t capacity) {
+#ifdef XENOCOMM_HAVE_ZSTD
+    std::vector<uint8_t> joined;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        joined.insert(joined.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    std::vector<uint8_t> content(capacity);
+    size_t size = ZDICT_trainFromBuffer(content.data(), content.size(), joined.data(), sizes.data(),
+                                        static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        throw CompressionError(std::string("Zstd dictionary training failed: ") + ZDICT_getErrorName(size),
+                               CompressionErrorCode::INVALID_FORMAT);
+    }
+    content.resize(size);
+    return std::make_shared<const ZstdDictionary>(std::move(content));
+#else
+    (void)samples;
+    (void)capacity;
+    throwUnavailable("Zstd");
+#endif
+}
+
+// ZstdCompression implementation
+struct ZstdCompression::Contexts {
+#ifdef XENOCOMM_HAVE_ZSTD
+    ZSTD_CCtx* cctx = nullptr;
+    ZSTD_DCtx* dctx = nullptr;
+    const ZSTD_CDict* cdict = nullptr;  // Owned by the dictionary
+
+    ~Contexts() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+#endif
+};
+
+ZstdCompression::ZstdCompression(int level, std::shared_ptr<const ZstdDictionary> dictionary)
+    : level_(level), dictionary_(std::move(dictionary)), contexts_(std::make_unique<Contexts>()) {
+#ifdef XENOCOMM_HAVE_ZSTD
+    level_ = std::clamp(level_, ZSTD_minCLevel(), ZSTD_maxCLevel());
+    if (dictionary_) {
+        auto& digested = *dictionary_->digested_;
+        std::lock_guard<std::mutex> lock(digested.mutex);
+        auto& cdict = digested.cdicts[level_];
+        if (!cdict) {
+            cdict = ZSTD_createCDict(dictionary_->content_.data(), dictionary_->content_.size(), level_);
+            if (!cdict) {
+                digested.cdicts.erase(level_);
+                throw CompressionError("Invalid Zstd dictionary", CompressionErrorCode::INVALID_FORMAT);
+            }
+        }
+        contexts_->cdict = cdict;
+    }
+#endif
+}
+
+ZstdCompression::~ZstdCompression() = default;
+
+bool ZstdCompression::isAvailable() {
+#ifdef XENOCOMM_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<uint8_t> ZstdCompression::compress(const std::vector<uint8_t>& data) {
+    if (data.empty()) return {};
+#ifdef XENOCOMM_HAVE_ZSTD
+    if (!contexts_->cctx && !(contexts_->cctx = ZSTD_createCCtx())) {
+        throw CompressionError("Failed to create Zstd context", CompressionErrorCode::BUFFER_OVERFLOW);
+    }
+    std::vector<uint8_t> compressed(ZSTD_compressBound(data.size()));
+    size_t written = contexts_->cdict
+        ? ZSTD_compress_usingCDict(contexts_->cctx, compressed.data(), compressed.size(),
+                                   data.data(), data.size(), contexts_->cdict)
+        : ZSTD_compressCCtx(contexts_->cctx, compressed.data(), compressed.size(),
+                            data.data(), data.size(), level_);
+    if (ZSTD_isError(written)) {
+        throw CompressionError(std::string("Zstd compression failed: ") + ZSTD_getErrorName(written),
+                               CompressionErrorCode::BUFFER_OVERFLOW);
+    }
+    compressed.resize(written);
+    return compressed;
+#else
+    throwUnavailable("Zstd");
+#endif
+}
+
+std::vector<uint8_t> ZstdCompression::decompress(const std::vector<uint8_t>& compressed_data) {
+    if (compressed_data.empty()) return {};
+#ifdef XENOCOMM_HAVE_ZSTD
+    unsigned long long original_size = ZSTD_getFrameContentSize(compressed_data.data(), compressed_data.size());
+    if (original_size == ZSTD_CONTENTSIZE_ERROR || original_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        original_size > std::numeric_limits<uint32_t>::max()) {
+        throw CompressionError("Invalid Zstd compressed data format", CompressionErrorCode::INVALID_FORMAT);
+    }
+    unsigned frame_dictionary = ZSTD_getDictID_fromFrame(compressed_data.data(), compressed_data.size());
+    if (frame_dictionary != (dictionary_ ? dictionary_->id() : 0)) {
+        throw CompressionError("Zstd frame was compressed with dictionary " + std::to_string(frame_dictionary),
+                               CompressionErrorCode::DECOMPRESSION_FAILURE);
+    }
+    if (!contexts_->dctx && !(contexts_->dctx = ZSTD_createDCtx())) {
+        throw CompressionError("Failed to create Zstd context", CompressionErrorCode::BUFFER_OVERFLOW);
+    }
+
+    std::vector<uint8_t> decompressed(static_cast<size_t>(original_size));
+    size_t read = dictionary_
+        ? ZSTD_decompress_usingDDict(contexts_->dctx, decompressed.data(), decompressed.size(),
+                                     compressed_data.data(), compressed_data.size(), dictionary_->digested_->ddict)
+        : ZSTD_decompressDCtx(contexts_->dctx, decompressed.data(), decompressed.size(),
+                              compressed_data.data(), compressed_data.size());
+    if (ZSTD_isError(read) || read != decompressed.size()) {
+        throw CompressionError("Failed to decompress Zstd data", CompressionErrorCode::DECOMPRESSION_FAILURE);
+    }
+    return decompressed;
+#else
+    throwUnavailable("Zstd");
+#endif
+}
+
+bool ZstdCompression::isSuitableFor(const std::vector<uint8_t>& data) const {
+    // A dictionary carries the redundancy small messages lack on their own
+    return isAvailable() && !data.empty() && (dictionary_ || data.size() >= MIN_GENERAL_PURPOSE_SIZE);
+}
+
+std::unique_ptr<CompressionAlgorithm> createCompressionAlgorithm(const std::string& algorithm_id) {
+    if (algorithm_id == "NONE") return std::make_unique<NoCompression>();
+    if (algorithm_id == "RLE") return std::make_unique<RunLengthEncoding>();
+    if (algorithm_id == "DELTA") return std::make_unique<DeltaEncoding>();
+    if (algorithm_id == "PACKED_DELTA") return std::make_unique<PackedDeltaEncoding>();
+    if (algorithm_id == "LZ4" && LZ4Compression::isAvailable()) return std::make_unique<LZ4Compression>();
+    if (algorithm_id == "ZSTD" && ZstdCompression::isAvailable()) return std::make_unique<ZstdCompression>();
+    return nullptr;
+}
+
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
@@ -0,0 +1,247 @@
+#include "xenocomm/core/compression_context.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <zlib.h>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr uint8_t FRAME_RESET = 0x01;       // Opens an epoch; its sequence is 0
+constexpr uint8_t FRAME_STANDALONE = 0x02;  // Compressed on its own, outside any epoch
+constexpr int RAW_DEFLATE_WINDOW_BITS = -15;
+// Z_SYNC_FLUSH ends every frame with this empty stored block, so it is left off the wire
+constexpr uint8_t SYNC_TAIL[] = {0x00, 0x00, 0xFF, 0xFF};
+
+void putLe32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t getLe32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void deflateInto(z_stream& stream, utils::ByteSpan message, std::vector<uint8_t>& out) {
+    size_t produced = out.size();
+    out.resize(produced + deflateBound(&stream, static_cast<uLong>(message.size())) + 16);
+    const uint8_t* input = message.data();
+    size_t remaining = message.size();
+    while (true) {
+        const uInt chunk = static_cast<uInt>(std::min<size_t>(remaining, UINT_MAX));
+        stream.next_in = const_cast<Bytef*>(input);
+        stream.avail_in = chunk;
+        const bool last = chunk == remaining;
+        do {
+            if (out.size() - produced < 64) {
+                out.resize(out.size() * 2);
+            }
+            stream.next_out = out.data() + produced;
+            stream.avail_out = static_cast<uInt>(std::min<size_t>(out.size() - produced, UINT_MAX));
+            if (deflate(&stream, last ? Z_SYNC_FLUSH : Z_NO_FLUSH) == Z_STREAM_ERROR) {
+                throw CompressionError("Deflate failed", CompressionErrorCode::BUFFER_OVERFLOW);
+            }
+            produced = static_cast<size_t>(stream.next_out - out.data());
+        } while (stream.avail_in > 0 || stream.avail_out == 0);
+        input += chunk;
+        remaining -= chunk;
+        if (last) {
+            break;
+        }
+    }
+    out.resize(produced);
+    if (out.size() >= sizeof(SYNC_TAIL) &&
+        std::memcmp(out.data() + out.size() - sizeof(SYNC_TAIL), SYNC_TAIL, sizeof(SYNC_TAIL)) == 0) {
+        out.resize(out.size() - sizeof(SYNC_TAIL));
+    }
+}
+
+void inflateInto(z_stream& stream, utils::ByteSpan payload, size_t max_size, std::vector<uint8_t>& out) {
+    size_t produced = 0;
+    out.resize(std::min(std::max<size_t>(payload.size() * 4, 256), max_size));
+    auto feed = [&](const uint8_t* input, size_t size) {
+        stream.next_in = const_cast<Bytef*>(input);
+        stream.avail_in = static_cast<uInt>(size);
+        do {
+            if (out.size() == produced) {
+                if (out.size() >= max_size) {
+                    throw CompressionError("Decompressed message exceeds the size limit",
+                                           CompressionErrorCode::BUFFER_OVERFLOW);
+                }
+                out.resize(std::min(out.size() * 2, max_size));
+            }
+            stream.next_out = out.data() + produced;
+            stream.avail_out = static_cast<uInt>(std::min<size_t>(out.size() - produced, UINT_MAX));
+            int result = inflate(&stream, Z_SYNC_FLUSH);
+            produced = static_cast<size_t>(stream.next_out - out.data());
+            if (result == Z_BUF_ERROR && stream.avail_in == 0) {
+                break;  // Everything given has been consumed
+            }
+            if (result != Z_OK) {
+                throw CompressionError("Corrupt compressed frame", CompressionErrorCode::DECOMPRESSION_FAILURE);
+            }
+        } while (stream.avail_in > 0 || stream.avail_out == 0);
+    };
+    for (size_t offset = 0; offset < payload.size(); offset += UINT_MAX) {
+        feed(payload.data() + offset, std::min<size_t>(payload.size() - offset, UINT_MAX));
+    }
+    feed(SYNC_TAIL, sizeof(SYNC_TAIL));
+    out.resize(produced);
+}
+
+} // namespace
+
+struct CompressionContext::Deflater {
+    z_stream stream{};
+
+    explicit Deflater(int level) {
+        if (deflateInit2(&stream, level, Z_DEFLATED, RAW_DEFLATE_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw CompressionError("Failed to create deflate stream", CompressionErrorCode::BUFFER_OVERFLOW);
+        }
+    }
+    ~Deflater() { deflateEnd(&stream); }
+};
+
+struct CompressionContext::Inflater {
+    z_stream stream{};
+
+    Inflater() {
+        if (inflateInit2(&stream, RAW_DEFLATE_WINDOW_BITS) != Z_OK) {
+            throw CompressionError("Failed to create inflate stream", CompressionErrorCode::BUFFER_OVERFLOW);
+        }
+    }
+    ~Inflater() { inflateEnd(&stream); }
+};
+
+CompressionContext::CompressionContext(int level, size_t max_message_size)
+    : max_message_size_(max_message_size), level_(std::clamp(level, 1, 9)) {}
+
+CompressionContext::~CompressionContext() = default;
+
+std::vector<uint8_t> CompressionContext::compress(utils::ByteSpan message, bool standalone) {
+    std::vector<uint8_t> frame(HEADER_SIZE);
+    if (standalone) {
+        int level;
+        {
+            std::lock_guard<std::mutex> lock(compress_mutex_);
+            level = level_;
+        }
+        Deflater alone(level);
+        frame[0] = FRAME_STANDALONE;
+        deflateInto(alone.stream, message, frame);
+        return frame;
+    }
+
+    std::lock_guard<std::mutex> lock(compress_mutex_);
+    if (reset_pending_) {
+        deflater_ = std::make_unique<Deflater>(level_);
+        epoch_ = epoch_ == UINT32_MAX ? 1 : epoch_ + 1;
+        sequence_ = 0;
+        reset_pending_ = false;
+        frame[0] = FRAME_RESET;
+    }
+    putLe32(frame.data() + 1, epoch_);
+    putLe32(frame.data() + 5, sequence_);
+    try {
+        deflateInto(deflater_->stream, message, frame);
+    } catch (...) {
+        reset_pending_ = true;  // The history is no longer what the peer will hold
+        throw;
+    }
+    ++sequence_;
+    return frame;
+}
+
+std::vector<uint8_t> CompressionContext::decompress(utils::ByteSpan frame, std::chrono::milliseconds wait_for_gap) {
+    if (frame.size() < HEADER_SIZE) {
+        throw CompressionError("Compressed frame shorter than its header", CompressionErrorCode::INVALID_FORMAT);
+    }
+    const uint8_t flags = frame[0];
+    const uint32_t epoch = getLe32(frame.data() + 1);
+    const uint32_t sequence = getLe32(frame.data() + 5);
+    const utils::ByteSpan payload = frame.subspan(HEADER_SIZE);
+    std::vector<uint8_t> message;
+
+    if (flags & FRAME_STANDALONE) {
+        Inflater alone;
+        inflateInto(alone.stream, payload, max_message_size_, message);
+        return message;
+    }
+
+    std::unique_lock<std::mutex> lock(decompress_mutex_);
+    if (flags & FRAME_RESET) {
+        if (sequence != 0) {
+            throw CompressionError("Epoch opened at a nonzero sequence", CompressionErrorCode::INVALID_FORMAT);
+        }
+        inflater_ = std::make_unique<Inflater>();
+        synced_ = true;
+        expected_epoch_ = epoch;
+        expected_sequence_ = 0;
+    } else {
+        // Ahead of the frame before it, or of the frame opening its epoch
+        auto ahead = [&] {
+            return epoch > expected_epoch_ || (synced_ && epoch == expected_epoch_ && sequence > expected_sequence_);
+        };
+        const auto deadline = std::chrono::steady_clock::now() + wait_for_gap;
+        while (ahead()) {
+            if (decompress_cv_.wait_until(lock, deadline) == std::cv_status::timeout && ahead()) {
+                break;  // What it follows on from is not coming
+            }
+        }
+        if (!synced_ || epoch != expected_epoch_ || sequence != expected_sequence_) {
+            if (epoch == expected_epoch_) {
+                synced_ = false;
+            }
+            decompress_cv_.notify_all();
+            throw CompressionError("Compressed frame out of sync", CompressionErrorCode::DECOMPRESSION_FAILURE);
+        }
+    }
+
+    try {
+        inflateInto(inflater_->stream, payload, max_message_size_, message);
+    } catch (...) {
+        synced_ = false;
+        decompress_cv_.notify_all();
+        throw;
+    }
+    ++expected_sequence_;
+    decompress_cv_.notify_all();
+    return message;
+}
+
+void CompressionContext::resetCompressor() {
+    std::lock_guard<std::mutex> lock(compress_mutex_);
+    reset_pending_ = true;
+}
+
+void CompressionContext::resetCompressor(int level) {
+    std::lock_guard<std::mutex> lock(compress_mutex_);
+    level_ = std::clamp(level, 1, 9);
+    reset_pending_ = true;
+}
+
+void CompressionContext::resetDecompressor() {
+    std::lock_guard<std::mutex> lock(decompress_mutex_);
+    inflater_.reset();
+    synced_ = false;
+    decompress_cv_.notify_all();
+}
+
+uint32_t CompressionContext::compressorEpoch() const {
+    std::lock_guard<std::mutex> lock(compress_mutex_);
+    return epoch_;
+}
+
+uint32_t CompressionContext::frameEpoch(utils::ByteSpan frame) {
+    return frame.size() < HEADER_SIZE ? 0 : getLe32(frame.data() + 1);
+}
+
+} // namespace core
+} // namespace xenocomm
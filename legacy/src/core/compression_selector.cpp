@@ -0,0 +1,362 @@
+#include "xenocomm/core/compression_selector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr size_t PROFILE_WINDOWS = 4;
+constexpr size_t MATCH_TABLE_BITS = 12;
+constexpr size_t DELTA_BLOCK = 128;         // Matches PackedDeltaEncoding::BLOCK_SIZE
+constexpr size_t MIN_TIMED_INPUT = 1024;    // Shorter compressions time too coarsely to learn from
+
+uint32_t zigzag32(uint32_t delta) {
+    return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+}
+
+unsigned bitWidth32(uint32_t value) {
+    return value == 0 ? 0 : 32 - static_cast<unsigned>(__builtin_clz(value));
+}
+
+// Packed delta bytes for one block of n residuals whose bits are OR-ed in used
+size_t packedBlockBytes(size_t n, uint32_t used) {
+    return 1 + (n * bitWidth32(used) + 7) / 8;
+}
+
+double lerp(double from, double to, double weight) {
+    return from + (to - from) * weight;
+}
+
+} // namespace
+
+PayloadProfile profilePayload(const uint8_t* data, size_t size, size_t sample_bytes) {
+    PayloadProfile profile;
+    profile.size = size;
+    if (!data || size == 0) {
+        return profile;
+    }
+
+    // A short payload is profiled whole, a long one through evenly spaced
+    // word-aligned windows, so a header or trailer does not dominate
+    size_t window = size;
+    size_t windows = 1;
+    if (size > sample_bytes) {
+        window = std::max<size_t>((sample_bytes / PROFILE_WINDOWS) & ~size_t{3}, 64);
+        windows = std::max<size_t>(std::min(PROFILE_WINDOWS, size / window), 1);
+    }
+    const size_t stride = windows > 1 ? ((size - window) / (windows - 1)) & ~size_t{3} : 0;
+
+    uint32_t histogram[256] = {};
+    std::vector<const uint8_t*> matches(size_t{1} << MATCH_TABLE_BITS, nullptr);
+    size_t repeats = 0;
+    size_t matched = 0;
+    size_t sequences = 0;
+    size_t word_bytes = 0;
+    size_t delta_bytes = 0;
+    size_t delta_of_delta_bytes = 0;
+
+    for (size_t w = 0; w < windows; ++w) {
+        const uint8_t* p = data + w * stride;
+        const size_t n = std::min(window, size - w * stride);
+
+        uint32_t previous_word = 0;
+        uint32_t previous_delta = 0;
+        uint32_t delta_used = 0;
+        uint32_t delta_of_delta_used = 0;
+        size_t in_block = 0;
+        for (size_t i = 0; i < n; ++i) {
+            ++histogram[p[i]];
+            if (i > 0 && p[i] == p[i - 1]) {
+                ++repeats;
+            }
+
+            if (i + 4 <= n) {
+                uint32_t sequence;
+                std::memcpy(&sequence, p + i, sizeof(sequence));
+                const uint8_t*& slot = matches[(sequence * 2654435761u) >> (32 - MATCH_TABLE_BITS)];
+                if (slot && std::memcmp(slot, p + i, 4) == 0) {
+                    ++matched;
+                }
+                slot = p + i;
+                ++sequences;
+
+                // Word deltas as PackedDeltaEncoding with 32-bit elements sees them
+                if (i % 4 == 0) {
+                    const size_t word = i / 4;
+                    uint32_t delta = sequence - previous_word;
+                    if (word >= 2) {
+                        delta_used |= zigzag32(delta);
+                        delta_of_delta_used |= zigzag32(delta - previous_delta);
+                        if (++in_block == DELTA_BLOCK) {
+                            delta_bytes += packedBlockBytes(in_block, delta_used);
+                            delta_of_delta_bytes += packedBlockBytes(in_block, delta_of_delta_used);
+                            delta_used = delta_of_delta_used = 0;
+                            in_block = 0;
+                        }
+                    }
+                    if (word >= 1) {
+                        previous_delta = delta;
+                    }
+                    previous_word = sequence;
+                    word_bytes += 4;
+                }
+            }
+        }
+        if (in_block > 0) {
+            delta_bytes += packedBlockBytes(in_block, delta_used);
+            delta_of_delta_bytes += packedBlockBytes(in_block, delta_of_delta_used);
+        }
+        // The first word, and for deltas of deltas the first delta, are stored raw
+        delta_bytes += std::min<size_t>(8, word_bytes);
+        delta_of_delta_bytes += std::min<size_t>(8, word_bytes);
+        profile.sampled += n;
+    }
+
+    double entropy = 0.0;
+    for (uint32_t count : histogram) {
+        if (count > 0) {
+            double p = static_cast<double>(count) / profile.sampled;
+            entropy -= p * std::log2(p);
+        }
+    }
+    profile.entropy = entropy;
+    profile.run_fraction = static_cast<double>(repeats) / profile.sampled;
+    profile.match_fraction = sequences > 0 ? static_cast<double>(matched) / sequences : 0.0;
+    if (word_bytes > 0) {
+        profile.packed_delta_ratio = std::min(1.0, static_cast<double>(delta_bytes) / word_bytes);
+        profile.packed_delta_of_delta_ratio = std::min(1.0, static_cast<double>(delta_of_delta_bytes) / word_bytes);
+    }
+    return profile;
+}
+
+CompressionSelector::CompressionSelector(const CompressionSelectorConfig& config) : config_(config) {
+    config_.link_bandwidth = std::max(config_.link_bandwidth, 1.0);
+    config_.sample_bytes = std::max<size_t>(config_.sample_bytes, 256);
+    config_.cache_capacity = std::max<size_t>(config_.cache_capacity, 1);
+    config_.learning_rate = std::min(std::max(config_.learning_rate, 0.0), 1.0);
+
+    // Starting speeds are typical single-core figures; observe() refines them
+    codecs_.push_back({"NONE", 0, 0.0, 0.0, 0});
+    codecs_.push_back({"RLE", 0, 1.5e9, 3.0e9, 0});
+    codecs_.push_back({"PACKED_DELTA", 1, 1.0e9, 1.5e9, 10});
+    codecs_.push_back({"PACKED_DELTA", 2, 9.0e8, 1.3e9, 14});
+    if (LZ4Compression::isAvailable()) {
+        codecs_.push_back({"LZ4", 0, 6.0e8, 3.0e9, 4});
+    }
+    if (ZstdCompression::isAvailable()) {
+        codecs_.push_back({"ZSTD", 1, 4.0e8, 1.1e9, 9});
+        codecs_.push_back({"ZSTD", 3, 2.5e8, 1.1e9, 9});
+        codecs_.push_back({"ZSTD", 9, 6.0e7, 1.1e9, 9});
+        codecs_.push_back({"ZSTD", 19, 4.0e6, 1.0e9, 9});
+    }
+}
+
+double CompressionSelector::baseRatio(const Codec& codec, const PayloadProfile& profile) const {
+    const double literals = 1.0 - profile.match_fraction;
+    double ratio = 1.0;
+    if (codec.algorithm_id == "RLE") {
+        // A (count, value) pair for every byte that starts a run
+        ratio = 2.0 * (1.0 - profile.run_fraction);
+    } else if (codec.algorithm_id == "PACKED_DELTA") {
+        ratio = codec.level == 2 ? profile.packed_delta_of_delta_ratio : profile.packed_delta_ratio;
+    } else if (codec.algorithm_id == "LZ4") {
+        // Literals are copied, matches cost a few bytes each
+        ratio = literals * 1.004 + profile.match_fraction * 0.15;
+    } else if (codec.algorithm_id == "ZSTD") {
+        // Literals are also entropy coded; higher levels find longer matches
+        ratio = literals * std::max(profile.entropy / 8.0, 0.05) + profile.match_fraction * 0.08;
+        ratio *= codec.level <= 1 ? 1.1 : codec.level <= 3 ? 1.0 : codec.level <= 9 ? 0.92 : 0.85;
+    }
+    return std::min(std::max(ratio, 0.002), 2.0);
+}
+
+double CompressionSelector::cost(const Codec& codec, double ratio, size_t size) const {
+    double seconds = (static_cast<double>(size) * ratio + codec.overhead) / config_.link_bandwidth;
+    if (codec.compress_rate > 0) {
+        seconds += size / codec.compress_rate;
+    }
+    if (config_.count_decompression && codec.decompress_rate > 0) {
+        seconds += size / codec.decompress_rate;
+    }
+    return seconds;
+}
+
+void CompressionSelector::learnRatio(TypeEntry& entry, size_t codec, double observed_ratio) const {
+    if (entry.base_ratio[codec] <= 0) {
+        return;
+    }
+    double target = std::min(std::max(observed_ratio / entry.base_ratio[codec], 0.05), 20.0);
+    entry.correction[codec] = lerp(entry.correction[codec], target, config_.learning_rate);
+}
+
+size_t CompressionSelector::rank(const TypeEntry& entry, size_t size, size_t* runner_up) const {
+    size_t best = 0;
+    size_t second = 0;
+    double best_cost = 0;
+    double second_cost = 0;
+    for (size_t i = 0; i < codecs_.size(); ++i) {
+        double c = cost(codecs_[i], entry.base_ratio[i] * entry.correction[i], size);
+        if (i == 0 || c < best_cost) {
+            second = best;
+            second_cost = best_cost;
+            best = i;
+            best_cost = c;
+        } else if (second == best || c < second_cost) {
+            second = i;
+            second_cost = c;
+        }
+    }
+    if (runner_up) {
+        *runner_up = second;
+    }
+    return best;
+}
+
+CompressionChoice CompressionSelector::choiceFor(const TypeEntry& entry, size_t size) const {
+    const Codec& codec = codecs_[entry.choice];
+    CompressionChoice choice;
+    choice.algorithm_id = codec.algorithm_id;
+    choice.level = codec.level;
+    choice.predicted_ratio = entry.base_ratio[entry.choice] * entry.correction[entry.choice];
+    choice.predicted_seconds = cost(codec, choice.predicted_ratio, size);
+    return choice;
+}
+
+size_t CompressionSelector::codecIndex(const CompressionChoice& choice) const {
+    for (size_t i = 0; i < codecs_.size(); ++i) {
+        if (codecs_[i].algorithm_id == choice.algorithm_id && codecs_[i].level == choice.level) {
+            return i;
+        }
+    }
+    return codecs_.size();
+}
+
+CompressionSelector::TypeEntry& CompressionSelector::entryFor(const std::string& message_type) {
+    auto it = types_.find(message_type);
+    if (it != types_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.order);
+        return it->second;
+    }
+
+    if (types_.size() >= config_.cache_capacity) {
+        types_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    lru_.push_front(message_type);
+    TypeEntry& entry = types_[message_type];
+    entry.order = lru_.begin();
+    entry.correction.assign(codecs_.size(), 1.0);
+    return entry;
+}
+
+CompressionChoice CompressionSelector::select(const std::vector<uint8_t>& data, const std::string& message_type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.selections;
+    TypeEntry& entry = entryFor(message_type);
+
+    const bool stale = entry.base_ratio.empty() || entry.uses >= config_.revalidate_interval ||
+                       data.size() * 2 < entry.profiled_size || data.size() * 2 > entry.profiled_size * 3;
+    if (!stale) {
+        ++stats_.cache_hits;
+        ++entry.uses;
+        return choiceFor(entry, data.size());
+    }
+
+    ++stats_.profiles;
+    PayloadProfile profile = profilePayload(data.data(), data.size(), config_.sample_bytes);
+    entry.base_ratio.resize(codecs_.size());
+    for (size_t i = 0; i < codecs_.size(); ++i) {
+        entry.base_ratio[i] = baseRatio(codecs_[i], profile);
+    }
+
+    // Check the runner-up's prediction on the sample so a pessimistic
+    // estimate cannot keep it from ever being chosen
+    size_t runner_up = 0;
+    entry.choice = rank(entry, data.size(), &runner_up);
+    if (runner_up != entry.choice && codecs_[runner_up].compress_rate > 0) {
+        std::vector<uint8_t> sample(data.begin(), data.begin() + std::min(data.size(), config_.sample_bytes));
+        CompressionChoice trial;
+        trial.algorithm_id = codecs_[runner_up].algorithm_id;
+        trial.level = codecs_[runner_up].level;
+        try {
+            auto algorithm = createAlgorithm(trial);
+            double observed = static_cast<double>(algorithm->compress(sample).size()) / sample.size();
+            learnRatio(entry, runner_up, observed);
+        } catch (const CompressionError&) {
+            learnRatio(entry, runner_up, 2.0);
+        }
+        entry.choice = rank(entry, data.size(), nullptr);
+    }
+
+    entry.profiled_size = data.size();
+    entry.uses = 1;
+    return choiceFor(entry, data.size());
+}
+
+std::unique_ptr<CompressionAlgorithm> CompressionSelector::createAlgorithm(const CompressionChoice& choice) {
+    if (choice.algorithm_id == "PACKED_DELTA") {
+        return std::make_unique<PackedDeltaEncoding>(4, static_cast<PackedDeltaEncoding::Order>(choice.level));
+    }
+    if (choice.algorithm_id == "ZSTD" && ZstdCompression::isAvailable()) {
+        return std::make_unique<ZstdCompression>(choice.level);
+    }
+    auto algorithm = createCompressionAlgorithm(choice.algorithm_id);
+    if (!algorithm) {
+        throw CompressionError("Unsupported compression algorithm: " + choice.algorithm_id,
+                               CompressionErrorCode::UNSUPPORTED_ALGORITHM);
+    }
+    return algorithm;
+}
+
+void CompressionSelector::observe(const std::string& message_type, const CompressionChoice& choice,
+                                  size_t input_size, size_t output_size, std::chrono::nanoseconds elapsed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t index = codecIndex(choice);
+    if (index == codecs_.size() || input_size == 0) {
+        return;
+    }
+
+    Codec& codec = codecs_[index];
+    if (codec.compress_rate > 0 && input_size >= MIN_TIMED_INPUT && elapsed.count() > 0) {
+        double rate = input_size / (static_cast<double>(elapsed.count()) * 1e-9);
+        codec.compress_rate = lerp(codec.compress_rate, rate, config_.learning_rate);
+    }
+
+    // A worse ratio than predicted may hand the type to another codec right away
+    auto it = types_.find(message_type);
+    if (it != types_.end() && !it->second.base_ratio.empty()) {
+        learnRatio(it->second, index, static_cast<double>(output_size) / input_size);
+        it->second.choice = rank(it->second, it->second.profiled_size, nullptr);
+    }
+}
+
+void CompressionSelector::setLinkBandwidth(double bytes_per_second) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bytes_per_second <= 0 || std::abs(bytes_per_second - config_.link_bandwidth) < config_.link_bandwidth * 0.1) {
+        return;
+    }
+    config_.link_bandwidth = bytes_per_second;
+    for (auto& type : types_) {
+        if (!type.second.base_ratio.empty()) {
+            type.second.choice = rank(type.second, type.second.profiled_size, nullptr);
+        }
+    }
+}
+
+double CompressionSelector::linkBandwidth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.link_bandwidth;
+}
+
+CompressionSelector::Stats CompressionSelector::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.cached_types = types_.size();
+    return stats;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,395 @@
+#include "xenocomm/core/congestion_controller.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+double toSeconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+uint32_t clampWindow(double bytes, const CongestionControlConfig& config) {
+    double clamped = std::min(std::max(bytes, static_cast<double>(config.min_window)),
+                              static_cast<double>(config.max_window));
+    return static_cast<uint32_t>(clamped);
+}
+
+uint32_t segmentSize(const CongestionControlConfig& config) {
+    return std::max<uint32_t>(config.segment_size, 1);
+}
+
+} // namespace
+
+// AimdCongestionController implementation
+
+AimdCongestionController::AimdCongestionController(const CongestionControlConfig& config)
+    : config_(config), cwnd_(clampWindow(config.initial_window, config)) {}
+
+void AimdCongestionController::onAck(uint32_t /*bytes_acked*/, std::chrono::microseconds rtt,
+                                     uint32_t /*bytes_in_flight*/, Clock::time_point now) {
+    if (rtt.count() > 0) {
+        double sample = static_cast<double>(rtt.count());
+        srtt_us_ = srtt_us_ == 0 ? sample : (srtt_us_ * 7 + sample) / 8;
+        min_rtt_us_ = min_rtt_us_ == 0 ? sample : std::min(min_rtt_us_, sample);
+    }
+
+    // Only adjust once per smoothed RTT
+    if (std::chrono::duration<double, std::micro>(now - last_adjustment_).count() < srtt_us_) {
+        return;
+    }
+
+    bool congested = min_rtt_us_ > 0 &&
+                     srtt_us_ > min_rtt_us_ * (100.0 + config_.congestion_threshold) / 100.0;
+    if (congested) {
+        backoff(now);
+        return;
+    }
+
+    double grown = in_congestion_avoidance_
+        ? static_cast<double>(cwnd_) + segmentSize(config_)
+        : static_cast<double>(cwnd_) * std::max<uint32_t>(config_.recovery_multiplier, 1);
+    cwnd_ = clampWindow(grown, config_);
+    last_adjustment_ = now;
+}
+
+void AimdCongestionController::onLoss(uint32_t /*bytes_lost*/, Clock::time_point now) {
+    if (std::chrono::duration<double, std::micro>(now - last_adjustment_).count() >= srtt_us_) {
+        backoff(now);
+    }
+}
+
+void AimdCongestionController::reset() {
+    cwnd_ = clampWindow(config_.initial_window, config_);
+    in_congestion_avoidance_ = false;
+    srtt_us_ = 0;
+    min_rtt_us_ = 0;
+    last_adjustment_ = Clock::time_point{};
+}
+
+void AimdCongestionController::backoff(Clock::time_point now) {
+    cwnd_ = clampWindow(static_cast<double>(cwnd_) / std::max<uint32_t>(config_.backoff_multiplier, 1), config_);
+    in_congestion_avoidance_ = true;
+    last_adjustment_ = now;
+}
+
+// CubicCongestionController implementation
+
+CubicCongestionController::CubicCongestionController(const CongestionControlConfig& config)
+    : config_(config) {
+    reset();
+}
+
+void CubicCongestionController::onAck(uint32_t bytes_acked, std::chrono::microseconds rtt,
+                                      uint32_t /*bytes_in_flight*/, Clock::time_point now) {
+    if (rtt.count() > 0) {
+        double sample = std::chrono::duration<double>(rtt).count();
+        srtt_s_ = srtt_s_ == 0 ? sample : (srtt_s_ * 7 + sample) / 8;
+        min_rtt_s_ = min_rtt_s_ == 0 ? sample : std::min(min_rtt_s_, sample);
+    }
+
+    double acked = static_cast<double>(bytes_acked) / segmentSize(config_);
+    if (cwnd_ < ssthresh_) {
+        // Slow start
+        cwnd_ += acked;
+    } else {
+        if (!epoch_started_) {
+            epoch_started_ = true;
+            epoch_start_ = now;
+            if (cwnd_ < w_max_) {
+                k_ = std::cbrt((w_max_ - cwnd_) / config_.cubic_c);
+            } else {
+                k_ = 0;
+                w_max_ = cwnd_;
+            }
+        }
+
+        // Aim for where the cubic curve will be one RTT from now
+        double t = toSeconds(now - epoch_start_) + min_rtt_s_;
+        double target = config_.cubic_c * std::pow(t - k_, 3) + w_max_;
+        if (target > cwnd_) {
+            cwnd_ += (target - cwnd_) / cwnd_ * acked;
+        } else {
+            cwnd_ += 0.01 * acked / cwnd_;
+        }
+
+        // Never grow slower than standard TCP would in the same conditions
+        if (srtt_s_ > 0) {
+            double beta = config_.cubic_beta;
+            double w_est = w_max_ * beta + (3 * (1 - beta) / (1 + beta)) * (toSeconds(now - epoch_start_) / srtt_s_);
+            cwnd_ = std::max(cwnd_, w_est);
+        }
+    }
+
+    cwnd_ = std::min(cwnd_, static_cast<double>(config_.max_window) / segmentSize(config_));
+}
+
+void CubicCongestionController::onLoss(uint32_t /*bytes_lost*/, Clock::time_point now) {
+    // Every loss inside one RTT of the last reduction belongs to the same congestion event
+    if (reduced_once_ && toSeconds(now - last_reduction_) < srtt_s_) {
+        return;
+    }
+
+    // Fast convergence: release bandwidth sooner when the saturation point is falling
+    if (cwnd_ < w_max_) {
+        w_max_ = cwnd_ * (1 + config_.cubic_beta) / 2;
+    } else {
+        w_max_ = cwnd_;
+    }
+
+    double min_segments = static_cast<double>(config_.min_window) / segmentSize(config_);
+    cwnd_ = std::max(cwnd_ * config_.cubic_beta, min_segments);
+    ssthresh_ = cwnd_;
+    epoch_started_ = false;
+    last_reduction_ = now;
+    reduced_once_ = true;
+}
+
+uint32_t CubicCongestionController::congestionWindow() const {
+    return clampWindow(cwnd_ * segmentSize(config_), config_);
+}
+
+void CubicCongestionController::reset() {
+    cwnd_ = static_cast<double>(clampWindow(config_.initial_window, config_)) / segmentSize(config_);
+    ssthresh_ = static_cast<double>(config_.max_window) / segmentSize(config_);
+    w_max_ = 0;
+    k_ = 0;
+    epoch_started_ = false;
+    reduced_once_ = false;
+    srtt_s_ = 0;
+    min_rtt_s_ = 0;
+}
+
+// BbrCongestionController implementation
+
+namespace {
+
+constexpr double BBR_STARTUP_GAIN = 2.885;  // 2/ln(2): doubles the delivery rate every round
+constexpr double BBR_CWND_GAIN = 2.0;       // Headroom for delayed and aggregated acknowledgments
+constexpr std::array<double, 8> BBR_PROBE_GAINS = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+constexpr auto BBR_PROBE_RTT_DURATION = std::chrono::milliseconds(200);
+constexpr uint32_t BBR_MIN_SEGMENTS = 4;
+
+} // namespace
+
+BbrCongestionController::BbrCongestionController(const CongestionControlConfig& config)
+    : config_(config) {
+    reset();
+}
+
+void BbrCongestionController::onAck(uint32_t bytes_acked, std::chrono::microseconds rtt,
+                                    uint32_t bytes_in_flight, Clock::time_point now) {
+    if (!started_) {
+        started_ = true;
+        round_start_ = now;
+        min_rtt_stamp_ = now;
+    }
+
+    bool min_rtt_expired = now - min_rtt_stamp_ > std::chrono::milliseconds(config_.bbr_min_rtt_window_ms);
+    if (rtt.count() > 0 && (min_rtt_.count() == 0 || rtt <= min_rtt_ || min_rtt_expired)) {
+        min_rtt_ = rtt;
+        min_rtt_stamp_ = now;
+    }
+
+    round_delivered_ += bytes_acked;
+    auto round_length = std::max<std::chrono::steady_clock::duration>(min_rtt_, std::chrono::milliseconds(1));
+    if (now - round_start_ >= round_length) {
+        endRound(now);
+    }
+
+    if (min_rtt_expired && mode_ != Mode::PROBE_RTT) {
+        mode_ = Mode::PROBE_RTT;
+        probe_rtt_done_ = now + BBR_PROBE_RTT_DURATION;
+    }
+    updateMode(bytes_in_flight, now);
+
+    if (mode_ == Mode::STARTUP) {
+        cwnd_ += bytes_acked;
+    }
+}
+
+void BbrCongestionController::onLoss(uint32_t /*bytes_lost*/, Clock::time_point /*now*/) {
+    // The model, not individual losses, drives the window; persistent loss shows up
+    // as a lower delivery rate and the window follows it down
+}
+
+uint32_t BbrCongestionController::congestionWindow() const {
+    double floor = static_cast<double>(BBR_MIN_SEGMENTS) * segmentSize(config_);
+    return clampWindow(std::max(cwnd_, floor), config_);
+}
+
+double BbrCongestionController::pacingRate() const {
+    double bandwidth = bottleneckBandwidth();
+    if (bandwidth <= 0) {
+        return 0;
+    }
+    switch (mode_) {
+        case Mode::STARTUP:
+            return BBR_STARTUP_GAIN * bandwidth;
+        case Mode::DRAIN:
+            return bandwidth / BBR_STARTUP_GAIN;
+        case Mode::PROBE_BW:
+            return BBR_PROBE_GAINS[cycle_index_] * bandwidth;
+        case Mode::PROBE_RTT:
+            break;
+    }
+    return bandwidth;
+}
+
+void BbrCongestionController::reset() {
+    mode_ = Mode::STARTUP;
+    cwnd_ = clampWindow(config_.initial_window, config_);
+    round_ = 0;
+    round_start_ = Clock::time_point{};
+    round_delivered_ = 0;
+    started_ = false;
+    bandwidth_samples_.clear();
+    min_rtt_ = std::chrono::microseconds(0);
+    min_rtt_stamp_ = Clock::time_point{};
+    full_bandwidth_ = 0;
+    full_bandwidth_rounds_ = 0;
+    cycle_index_ = 0;
+    probe_rtt_done_ = Clock::time_point{};
+}
+
+double BbrCongestionController::bottleneckBandwidth() const {
+    return bandwidth_samples_.empty() ? 0 : bandwidth_samples_.front().bytes_per_second;
+}
+
+void BbrCongestionController::endRound(Clock::time_point now) {
+    double elapsed = toSeconds(now - round_start_);
+    double rate = elapsed > 0 ? static_cast<double>(round_delivered_) / elapsed : 0;
+
+    // Windowed max filter: newer samples evict smaller older ones, old rounds age out
+    while (!bandwidth_samples_.empty() && bandwidth_samples_.back().bytes_per_second <= rate) {
+        bandwidth_samples_.pop_back();
+    }
+    bandwidth_samples_.push_back({round_, rate});
+    while (bandwidth_samples_.front().round + config_.bbr_bandwidth_window_rounds <= round_) {
+        bandwidth_samples_.pop_front();
+    }
+
+    if (mode_ == Mode::STARTUP) {
+        double bandwidth = bottleneckBandwidth();
+        if (bandwidth >= full_bandwidth_ * 1.25) {
+            full_bandwidth_ = bandwidth;
+            full_bandwidth_rounds_ = 0;
+        } else {
+            ++full_bandwidth_rounds_;
+        }
+    } else if (mode_ == Mode::PROBE_BW) {
+        cycle_index_ = (cycle_index_ + 1) % BBR_PROBE_GAINS.size();
+    }
+
+    ++round_;
+    round_start_ = now;
+    round_delivered_ = 0;
+}
+
+void BbrCongestionController::updateMode(uint32_t bytes_in_flight, Clock::time_point now) {
+    switch (mode_) {
+        case Mode::STARTUP:
+            if (full_bandwidth_rounds_ >= 3) {
+                mode_ = Mode::DRAIN;
+            }
+            break;
+        case Mode::DRAIN:
+            // Let the queue built up during STARTUP empty before probing
+            cwnd_ = bdp(1.0);
+            if (bytes_in_flight <= bdp(1.0)) {
+                mode_ = Mode::PROBE_BW;
+                cycle_index_ = 0;
+            }
+            break;
+        case Mode::PROBE_BW:
+            cwnd_ = bdp(BBR_CWND_GAIN * BBR_PROBE_GAINS[cycle_index_]);
+            break;
+        case Mode::PROBE_RTT:
+            cwnd_ = static_cast<double>(BBR_MIN_SEGMENTS) * segmentSize(config_);
+            if (now >= probe_rtt_done_) {
+                min_rtt_stamp_ = now;
+                mode_ = full_bandwidth_rounds_ >= 3 ? Mode::PROBE_BW : Mode::STARTUP;
+            }
+            break;
+    }
+}
+
+uint32_t BbrCongestionController::bdp(double gain) const {
+    double bandwidth = bottleneckBandwidth();
+    if (bandwidth <= 0 || min_rtt_.count() == 0) {
+        return config_.initial_window;
+    }
+    double bytes = gain * bandwidth * std::chrono::duration<double>(min_rtt_).count();
+    return clampWindow(bytes, config_);
+}
+
+// TokenBucketPacer implementation
+
+void TokenBucketPacer::setRate(double bytes_per_second, uint32_t burst_bytes, Clock::time_point now) {
+    refill(now);
+    if (rate_ <= 0) {
+        // Pacing starts with a full bucket so the first burst is not held back
+        tokens_ = burst_bytes;
+        last_refill_ = now;
+    }
+    rate_ = std::max(bytes_per_second, 0.0);
+    burst_ = burst_bytes;
+    tokens_ = std::min(tokens_, burst_);
+}
+
+TokenBucketPacer::Clock::duration TokenBucketPacer::delay(uint32_t bytes, Clock::time_point now) {
+    if (rate_ <= 0) {
+        return Clock::duration::zero();
+    }
+    refill(now);
+    // A send larger than the burst goes once the bucket is full
+    double needed = std::min<double>(bytes, burst_) - tokens_;
+    if (needed <= 0) {
+        return Clock::duration::zero();
+    }
+    auto wait = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(needed / rate_));
+    return std::max(wait, Clock::duration(1));
+}
+
+void TokenBucketPacer::consume(uint32_t bytes, Clock::time_point now) {
+    if (rate_ <= 0) {
+        return;
+    }
+    refill(now);
+    tokens_ -= bytes;
+}
+
+void TokenBucketPacer::reset() {
+    rate_ = 0;
+    burst_ = 0;
+    tokens_ = 0;
+    last_refill_ = Clock::time_point{};
+}
+
+void TokenBucketPacer::refill(Clock::time_point now) {
+    if (now > last_refill_) {
+        tokens_ = std::min(burst_, tokens_ + rate_ * toSeconds(now - last_refill_));
+        last_refill_ = now;
+    }
+}
+
+// CongestionControllerFactory implementation
+
+std::unique_ptr<ICongestionController> CongestionControllerFactory::create(const CongestionControlConfig& config) {
+    switch (config.algorithm) {
+        case CongestionControlAlgorithm::AIMD:
+            return std::make_unique<AimdCongestionController>(config);
+        case CongestionControlAlgorithm::CUBIC:
+            return std::make_unique<CubicCongestionController>(config);
+        case CongestionControlAlgorithm::BBR:
+            return std::make_unique<BbrCongestionController>(config);
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
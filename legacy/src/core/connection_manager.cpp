@@ -1,76 +1,334 @@
 #include "xenocomm/core/connection_manager.hpp"
-#include <stdexcept>
+#include "xenocomm/core/shared_memory_transport.hpp"
+#include <mutex>
 
 namespace xenocomm {
 namespace core {
 
-class ConnectionError : public std::runtime_error {
-public:
-    explicit ConnectionError(const std::string& message) : std::runtime_error(message) {}
-};
+ConnectionStatus Connection::getStatus() const {
+    if (!transport_) {
+        return status_;
+    }
+    switch (transport_->getState()) {
+        case ConnectionState::CONNECTED:
+            return ConnectionStatus::Connected;
+        case ConnectionState::CONNECTING:
+        case ConnectionState::RECONNECTING:
+            return ConnectionStatus::Connecting;
+        case ConnectionState::ERROR:
+            return ConnectionStatus::Error;
+        default:
+            return ConnectionStatus::Disconnected;
+    }
+}
+
+namespace {
+
+constexpr unsigned GENERATION_SHIFT = 32;
+
+} // namespace
 
 ConnectionManager::ConnectionManager() = default;
 
+ConnectionManager::~ConnectionManager() {
+    // Streams first, so nothing is still reading a transport when it is disconnected
+    for (const auto& [_, multiplexer] : multiplexers_) {
+        multiplexer->shutdown();
+    }
+    for (auto& shard : shards_) {
+        for (const auto& [_, connection] : shard.connections) {
+            if (const auto& transport = connection->getTransport()) {
+                transport->disconnect();
+            }
+        }
+    }
+    for (auto& chunk : chunks_) {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+ConnectionManager::Shard& ConnectionManager::shardFor(const Connection::ConnectionId& connectionId) const {
+    return shards_[std::hash<Connection::ConnectionId>{}(connectionId) % SHARD_COUNT];
+}
+
+bool ConnectionManager::insert(const ConnectionPtr& connection) {
+    Shard& shard = shardFor(connection->getId());
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (shard.connections.count(connection->getId())) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> handles(handleMutex_);
+        uint32_t slot;
+        if (!freeSlots_.empty()) {
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slotsInUse_.load(std::memory_order_relaxed));
+            if (slot >= SLOTS_PER_CHUNK * MAX_CHUNKS) {
+                throw ConnectionError("Too many open connections");
+            }
+            if (slot % SLOTS_PER_CHUNK == 0) {
+                chunks_[slot / SLOTS_PER_CHUNK].store(new Chunk(), std::memory_order_release);
+            }
+            slotsInUse_.store(slot + 1, std::memory_order_release);
+        }
+        Chunk* chunk = chunks_[slot / SLOTS_PER_CHUNK].load(std::memory_order_relaxed);
+        const uint32_t generation = ++chunk->generations[slot % SLOTS_PER_CHUNK];
+        // Slot numbers start at 1 in the handle so that no handle is INVALID_HANDLE
+        connection->handle_ = (static_cast<Connection::Handle>(generation) << GENERATION_SHIFT) | (slot + 1);
+        std::atomic_store(&chunk->slots[slot % SLOTS_PER_CHUNK], connection);
+    }
+    shard.connections.emplace(connection->getId(), connection);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::erase(const Connection::ConnectionId& connectionId) {
+    Shard& shard = shardFor(connectionId);
+    ConnectionPtr connection;
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.connections.find(connectionId);
+    if (it == shard.connections.end()) {
+        return nullptr;
+    }
+    connection = std::move(it->second);
+    shard.connections.erase(it);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+
+    const uint32_t slot = static_cast<uint32_t>(connection->handle_ & 0xffffffffu) - 1;
+    Chunk* chunk = chunks_[slot / SLOTS_PER_CHUNK].load(std::memory_order_relaxed);
+    std::atomic_store(&chunk->slots[slot % SLOTS_PER_CHUNK], ConnectionPtr());
+    std::lock_guard<std::mutex> handles(handleMutex_);
+    freeSlots_.push_back(slot);
+    return connection;
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::findConnection(
+    const Connection::ConnectionId& connectionId) const {
+    Shard& shard = shardFor(connectionId);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.connections.find(connectionId);
+    return it == shard.connections.end() ? nullptr : it->second;
+}
+
 ConnectionManager::ConnectionPtr ConnectionManager::establish(
     const Connection::ConnectionId& connectionId,
     const ConnectionConfig& config) {
-    // Check if connection already exists
-    auto it = connections_.find(connectionId);
-    if (it != connections_.end()) {
+    auto connection = std::make_shared<Connection>(connectionId, config);
+    if (!insert(connection)) {
+        throw ConnectionError("Connection with ID " + connectionId + " already exists");
+    }
+    return connection;
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::establish(const Connection::ConnectionId& connectionId,
+                                                              const std::string& endpoint,
+                                                              std::shared_ptr<TransportProtocol> transport,
+                                                              const ConnectionConfig& config) {
+    if (!transport) {
+        throw ConnectionError("Connection " + connectionId + " needs a transport");
+    }
+    if (findConnection(connectionId)) {
+        throw ConnectionError("Connection with ID " + connectionId + " already exists");
+    }
+
+    // Connecting can take a while, so it happens outside the lock
+    if (config.preferSharedMemory && !transport->isConnected() && SharedMemoryTransport::isLocalEndpoint(endpoint)) {
+        auto shared = std::make_shared<SharedMemoryTransport>();
+        if (shared->connect(endpoint, config)) {
+            transport = std::move(shared);
+        }
+    }
+    if (!transport->isConnected()) {
+        if (config.localPort != 0 && !transport->setLocalPort(config.localPort)) {
+            throw ConnectionError("Connection " + connectionId + " cannot bind local port " +
+                                  std::to_string(config.localPort) + ": " + transport->getErrorDetails());
+        }
+        if (!transport->connect(endpoint, config)) {
+            throw ConnectionError("Connection " + connectionId + " to " + endpoint +
+                                  " failed: " + transport->getErrorDetails());
+        }
+    }
+
+    auto connection = std::make_shared<Connection>(connectionId, config, transport);
+    if (!insert(connection)) {
+        transport->disconnect();
         throw ConnectionError("Connection with ID " + connectionId + " already exists");
     }
-    
-    // Create new connection
-    auto connection = std::make_shared<Connection>(connectionId, config);
-    connections_[connectionId] = connection;
-    
     return connection;
 }
 
 bool ConnectionManager::close(const Connection::ConnectionId& connectionId) {
-    auto it = connections_.find(connectionId);
-    if (it == connections_.end()) {
+    ConnectionPtr connection = erase(connectionId);
+    if (!connection) {
         return false;
     }
-    
-    connections_.erase(it);
+    std::shared_ptr<StreamMultiplexer> multiplexer;
+    {
+        std::lock_guard<std::mutex> lock(multiplexerMutex_);
+        auto it = multiplexers_.find(connectionId);
+        if (it != multiplexers_.end()) {
+            multiplexer = std::move(it->second);
+            multiplexers_.erase(it);
+        }
+    }
+
+    // Its stream connections stay registered but report Disconnected
+    if (multiplexer) {
+        multiplexer->shutdown();
+    }
+
+    // Users still holding the transport keep it alive, but it no longer carries data
+    if (const auto& transport = connection->getTransport()) {
+        transport->disconnect();
+    }
     return true;
 }
 
 ConnectionStatus ConnectionManager::checkStatus(const Connection::ConnectionId& connectionId) const {
-    auto it = connections_.find(connectionId);
-    if (it == connections_.end()) {
-        throw ConnectionError("Connection with ID " + connectionId + " not found");
-    }
-    
-    return it->second->getStatus();
+    return getConnection(connectionId)->getStatus();
 }
 
 ConnectionManager::ConnectionPtr ConnectionManager::getConnection(
     const Connection::ConnectionId& connectionId) const {
-    auto it = connections_.find(connectionId);
-    if (it == connections_.end()) {
+    auto connection = findConnection(connectionId);
+    if (!connection) {
         throw ConnectionError("Connection with ID " + connectionId + " not found");
     }
-    
-    return it->second;
+
+    return connection;
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::getConnection(Connection::Handle handle) const {
+    const uint64_t slot = (handle & 0xffffffffu) - 1;  // INVALID_HANDLE wraps and fails the bound
+    if (slot >= slotsInUse_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    const Chunk* chunk = chunks_[slot / SLOTS_PER_CHUNK].load(std::memory_order_acquire);
+    auto connection = std::atomic_load(&chunk->slots[slot % SLOTS_PER_CHUNK]);
+    return connection && connection->handle_ == handle ? connection : nullptr;
+}
+
+Connection::Handle ConnectionManager::getHandle(const Connection::ConnectionId& connectionId) const {
+    return getConnection(connectionId)->getHandle();
 }
 
 std::vector<ConnectionManager::ConnectionPtr> ConnectionManager::getActiveConnections() const {
     std::vector<ConnectionPtr> activeConnections;
-    activeConnections.reserve(connections_.size());
-    
-    for (const auto& [_, connection] : connections_) {
-        if (connection->getStatus() == ConnectionStatus::Connected) {
-            activeConnections.push_back(connection);
+    activeConnections.reserve(size());
+    forEachActiveConnection([&activeConnections](const ConnectionPtr& connection) {
+        activeConnections.push_back(connection);
+    });
+    return activeConnections;
+}
+
+void ConnectionManager::forEachActiveConnection(const std::function<void(const ConnectionPtr&)>& visit) const {
+    const size_t slots = slotsInUse_.load(std::memory_order_acquire);
+    for (size_t slot = 0; slot < slots; ++slot) {
+        const Chunk* chunk = chunks_[slot / SLOTS_PER_CHUNK].load(std::memory_order_acquire);
+        auto connection = std::atomic_load(&chunk->slots[slot % SLOTS_PER_CHUNK]);
+        if (connection && connection->getStatus() == ConnectionStatus::Connected) {
+            visit(connection);
         }
     }
-    
-    return activeConnections;
 }
 
-// Placeholder implementation
-// TODO: Implement actual connection management functionality
+std::shared_ptr<TransportProtocol> ConnectionManager::getTransport(
+    const Connection::ConnectionId& connectionId) const {
+    auto transport = getConnection(connectionId)->getTransport();
+    if (!transport) {
+        throw ConnectionError("Connection " + connectionId + " has no transport");
+    }
+    return transport;
+}
+
+ssize_t ConnectionManager::sendv(const Connection::ConnectionId& connectionId, const utils::ByteSpan* buffers,
+                                 size_t count) {
+    auto transport = findTransport(connectionId);
+    return transport ? transport->sendv(buffers, count) : -1;
+}
+
+ssize_t ConnectionManager::sendv(Connection::Handle handle, const utils::ByteSpan* buffers, size_t count) {
+    auto connection = getConnection(handle);
+    return connection && connection->getTransport() ? connection->getTransport()->sendv(buffers, count) : -1;
+}
+
+ssize_t ConnectionManager::receiveBuffer(const Connection::ConnectionId& connectionId, utils::PooledBuffer& buffer,
+                                         size_t maxSize) {
+    auto transport = findTransport(connectionId);
+    return transport ? transport->receiveBuffer(buffer, maxSize) : -1;
+}
+
+ssize_t ConnectionManager::receiveBuffer(Connection::Handle handle, utils::PooledBuffer& buffer, size_t maxSize) {
+    auto connection = getConnection(handle);
+    return connection && connection->getTransport() ? connection->getTransport()->receiveBuffer(buffer, maxSize)
+                                                    : -1;
+}
+
+std::shared_ptr<StreamMultiplexer> ConnectionManager::multiplex(const Connection::ConnectionId& connectionId,
+                                                                StreamMultiplexer::Role role,
+                                                                const MultiplexerConfig& config) {
+    auto connection = getConnection(connectionId);
+    std::lock_guard<std::mutex> lock(multiplexerMutex_);
+    if (multiplexers_.count(connectionId)) {
+        throw ConnectionError("Connection " + connectionId + " is already multiplexed");
+    }
+    const auto& transport = connection->getTransport();
+    if (!transport || !transport->isConnected() || !transport->isReliableStream()) {
+        throw ConnectionError("Connection " + connectionId + " needs a connected reliable transport to multiplex");
+    }
+    auto multiplexer = StreamMultiplexer::create(transport, role, config);
+    multiplexers_.emplace(connectionId, multiplexer);
+    return multiplexer;
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::openStream(const Connection::ConnectionId& parentId,
+                                                               const Connection::ConnectionId& streamConnectionId) {
+    auto stream = findMultiplexer(parentId)->openStream();
+    if (!stream) {
+        throw ConnectionError("Connection " + parentId + " cannot open another stream");
+    }
+    return addStream(parentId, streamConnectionId, std::move(stream));
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::acceptStream(const Connection::ConnectionId& parentId,
+                                                                 const Connection::ConnectionId& streamConnectionId,
+                                                                 std::chrono::milliseconds timeout) {
+    if (findConnection(streamConnectionId)) {
+        throw ConnectionError("Connection with ID " + streamConnectionId + " already exists");
+    }
+    auto stream = findMultiplexer(parentId)->acceptStream(timeout);
+    return stream ? addStream(parentId, streamConnectionId, std::move(stream)) : nullptr;
+}
+
+std::shared_ptr<StreamMultiplexer> ConnectionManager::findMultiplexer(
+    const Connection::ConnectionId& connectionId) const {
+    std::lock_guard<std::mutex> lock(multiplexerMutex_);
+    auto it = multiplexers_.find(connectionId);
+    if (it == multiplexers_.end()) {
+        throw ConnectionError("Connection " + connectionId + " is not multiplexed");
+    }
+    return it->second;
+}
+
+ConnectionManager::ConnectionPtr ConnectionManager::addStream(const Connection::ConnectionId& parentId,
+                                                              const Connection::ConnectionId& streamConnectionId,
+                                                              std::shared_ptr<MultiplexedStream> stream) {
+    auto connection = std::make_shared<Connection>(streamConnectionId, getConnection(parentId)->getConfig(), stream);
+    if (!insert(connection)) {
+        stream->disconnect();
+        throw ConnectionError("Connection with ID " + streamConnectionId + " already exists");
+    }
+    return connection;
+}
+
+std::shared_ptr<TransportProtocol> ConnectionManager::findTransport(
+    const Connection::ConnectionId& connectionId) const {
+    auto connection = findConnection(connectionId);
+    return connection ? connection->getTransport() : nullptr;
+}
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
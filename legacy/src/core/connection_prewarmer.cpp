@@ -0,0 +1,225 @@
+#include "xenocomm/core/connection_prewarmer.h"
+#include "xenocomm/core/feedback_loop.h"
+#include "xenocomm/core/tcp_transport.hpp"
+#include <algorithm>
+
+namespace xenocomm {
+namespace core {
+
+ConnectionPrewarmer::ConnectionPrewarmer(TCPTransport* transport, PrewarmActions actions,
+                                         const FeedbackLoop* feedback, const PrewarmConfig& config)
+    : transport_(transport), actions_(std::move(actions)), feedback_(feedback), config_(config) {}
+
+ConnectionPrewarmer::~ConnectionPrewarmer() {
+    stop();
+}
+
+void ConnectionPrewarmer::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (task_ != utils::TaskScheduler::INVALID_TASK) {
+        return;
+    }
+    auto& scheduler = utils::TaskScheduler::shared();
+    auto pass = [this] { prewarmNow(); };
+    task_ = config_.interval.count() > 0 ? scheduler.scheduleEvery(config_.interval, pass) : scheduler.add(pass);
+}
+
+void ConnectionPrewarmer::stop() {
+    utils::TaskScheduler::TaskId task;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task = task_;
+        task_ = utils::TaskScheduler::INVALID_TASK;
+    }
+    // Outside the lock: cancel() waits for a running pass, which takes it
+    if (task != utils::TaskScheduler::INVALID_TASK) {
+        utils::TaskScheduler::shared().cancel(task);
+    }
+}
+
+void ConnectionPrewarmer::hintPeer(const std::string& peerId, double weight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hints_[peerId].push_back(Hint{weight, std::chrono::steady_clock::now()});
+    if (task_ != utils::TaskScheduler::INVALID_TASK) {
+        utils::TaskScheduler::shared().runNow(task_);
+    }
+}
+
+void ConnectionPrewarmer::onDiscovery(const std::vector<RankedAgent>& agents) {
+    if (agents.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < agents.size(); ++i) {
+        hints_[agents[i].agentId].push_back(Hint{1.0 / static_cast<double>(i + 1), now});
+    }
+    if (task_ != utils::TaskScheduler::INVALID_TASK) {
+        utils::TaskScheduler::shared().runNow(task_);
+    }
+}
+
+void ConnectionPrewarmer::forgetPeer(const std::string& peerId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hints_.erase(peerId);
+    lastWarmed_.erase(peerId);
+}
+
+std::vector<PrewarmPrediction> ConnectionPrewarmer::predict() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshHistory();
+
+    std::unordered_map<std::string, double> scores;
+    for (const auto& [peerId, share] : history_) {
+        scores[peerId] += config_.historyWeight * share;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    const double ttl = static_cast<double>(std::max<int64_t>(config_.hintTtl.count(), 1));
+    for (const auto& [peerId, hints] : hints_) {
+        for (const auto& hint : hints) {
+            double age = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - hint.at).count());
+            if (age < ttl) {
+                scores[peerId] += hint.weight * (1.0 - age / ttl);
+            }
+        }
+    }
+
+    std::vector<PrewarmPrediction> predictions;
+    for (auto& [peerId, score] : scores) {
+        if (score >= config_.minScore) {
+            predictions.push_back(PrewarmPrediction{peerId, score});
+        }
+    }
+    std::sort(predictions.begin(), predictions.end(), [](const PrewarmPrediction& a, const PrewarmPrediction& b) {
+        return a.score > b.score || (a.score == b.score && a.peerId < b.peerId);
+    });
+    return predictions;
+}
+
+size_t ConnectionPrewarmer::prewarmNow() {
+    std::lock_guard<std::mutex> pass(passMutex_);
+    std::vector<PrewarmPrediction> predictions = predict();
+
+    // Pick the peers under the lock, warm them without it: warming blocks on the network
+    std::vector<std::string> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.passes;
+        const auto now = std::chrono::steady_clock::now();
+        for (auto hint = hints_.begin(); hint != hints_.end();) {
+            auto& list = hint->second;
+            list.erase(std::remove_if(list.begin(), list.end(),
+                                      [&](const Hint& h) { return now - h.at >= config_.hintTtl; }),
+                       list.end());
+            hint = list.empty() ? hints_.erase(hint) : std::next(hint);
+        }
+        for (const auto& prediction : predictions) {
+            if (due.size() >= config_.maxPeers) {
+                break;
+            }
+            auto warmed = lastWarmed_.find(prediction.peerId);
+            if (warmed != lastWarmed_.end() && now - warmed->second < config_.rewarmAfter) {
+                continue;
+            }
+            // Claimed now, whatever the outcome, so a failing peer is retried only after rewarmAfter
+            lastWarmed_[prediction.peerId] = now;
+            due.push_back(prediction.peerId);
+        }
+    }
+
+    size_t warmed = 0;
+    for (const auto& peerId : due) {
+        if (warm(peerId)) {
+            ++warmed;
+        }
+    }
+    return warmed;
+}
+
+bool ConnectionPrewarmer::warm(const std::string& peerId) {
+    std::optional<std::string> endpoint;
+    if (actions_.resolveEndpoint) {
+        endpoint = actions_.resolveEndpoint(peerId);
+    }
+    size_t connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections = config_.connectionsPerPeer;
+    }
+
+    bool ok = endpoint.has_value();
+    bool handshook = false;
+    bool negotiated = false;
+    if (ok && transport_ && connections > 0) {
+        ok = transport_->warmupConnections(*endpoint, connections);
+    }
+    if (ok && actions_.handshake) {
+        ok = handshook = actions_.handshake(peerId, *endpoint);
+    }
+    if (ok && actions_.negotiate) {
+        ok = negotiated = actions_.negotiate(peerId);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.handshakes += handshook ? 1 : 0;
+    stats_.negotiations += negotiated ? 1 : 0;
+    if (ok) {
+        ++stats_.peersWarmed;
+    } else {
+        ++stats_.failures;
+    }
+    return ok;
+}
+
+ConnectionPrewarmer::Stats ConnectionPrewarmer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ConnectionPrewarmer::setConfig(const PrewarmConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+}
+
+PrewarmConfig ConnectionPrewarmer::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+void ConnectionPrewarmer::refreshHistory() const {
+    if (!feedback_) {
+        return;
+    }
+    const uint64_t generation = feedback_->getWindowGeneration();
+    if (historyLoaded_ && generation == historyGeneration_) {
+        return;
+    }
+    auto labeled = feedback_->getLabeledMetrics();
+    if (!labeled.has_value()) {
+        return;
+    }
+
+    // A peer's outcomes may be spread over several label sets, one per transport or encoding
+    std::unordered_map<std::string, double> totals;
+    double busiest = 0;
+    for (const auto& entry : labeled.value()) {
+        if (entry.labels.peerId.empty() || entry.labels.peerId == OVERFLOW_LABEL) {
+            continue;
+        }
+        double& total = totals[entry.labels.peerId];
+        total += static_cast<double>(entry.metrics.totalTransactions);
+        busiest = std::max(busiest, total);
+    }
+    history_.clear();
+    for (const auto& [peerId, total] : totals) {
+        if (total > 0) {
+            history_[peerId] = total / busiest;
+        }
+    }
+    historyGeneration_ = generation;
+    historyLoaded_ = true;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,117 @@
+#include "xenocomm/core/crypto_worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+struct CryptoWorkerPool::Job {
+    enum : uint8_t { PENDING, DONE, FAILED };
+
+    Job(size_t n, const std::function<bool(size_t)>& t) : task(&t), count(n), states(n, PENDING) {}
+
+    const std::function<bool(size_t)>* task;
+    const size_t count;
+    std::atomic<size_t> next{0};  // Next unclaimed index
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint8_t> states;
+    size_t active{0};     // Workers that may still call task
+    bool closed{false};   // Set once the run is over or has failed; no worker joins after
+};
+
+CryptoWorkerPool::CryptoWorkerPool(size_t workers)
+    : ownedExecutor_(workers > 0 ? std::make_unique<utils::WorkStealingExecutor>(workers) : nullptr),
+      executor_(ownedExecutor_ ? ownedExecutor_.get() : &utils::WorkStealingExecutor::shared()) {}
+
+CryptoWorkerPool& CryptoWorkerPool::shared() {
+    static CryptoWorkerPool pool;
+    return pool;
+}
+
+void CryptoWorkerPool::participate(Job& job) {
+    {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (job.closed) {
+            return;
+        }
+        ++job.active;
+    }
+    for (;;) {
+        size_t index = job.next.fetch_add(1);
+        if (index >= job.count) {
+            break;
+        }
+        bool ok = (*job.task)(index);
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.states[index] = ok ? Job::DONE : Job::FAILED;
+        job.closed = job.closed || !ok;
+        job.cv.notify_all();
+        if (job.closed) {
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lock(job.mutex);
+    --job.active;
+    job.cv.notify_all();
+}
+
+bool CryptoWorkerPool::runOrdered(size_t count, const std::function<bool(size_t)>& task,
+                                  const std::function<bool(size_t)>& complete) {
+    if (count == 0) {
+        return true;
+    }
+    auto job = std::make_shared<Job>(count, task);
+    // Helpers that start after the run is over find the job closed and leave
+    const size_t helpers = std::min(count - 1, executor_->workerCount());
+    for (size_t i = 0; i < helpers; ++i) {
+        executor_->submit([job] { participate(*job); });
+    }
+
+    bool ok = true;
+    size_t completed = 0;
+    while (ok && completed < count) {
+        uint8_t state;
+        bool abandoned;
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            state = job->states[completed];
+            abandoned = job->closed;
+        }
+        if (state == Job::FAILED) {
+            ok = false;
+            break;
+        }
+        if (state == Job::DONE) {
+            ok = complete(completed++);
+            continue;
+        }
+
+        // The next record in order is still being sealed elsewhere; seal another meanwhile
+        size_t index = abandoned ? count : job->next.fetch_add(1);
+        if (index < count) {
+            bool sealed = task(index);
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->states[index] = sealed ? Job::DONE : Job::FAILED;
+            job->closed = job->closed || !sealed;
+            continue;
+        }
+        // Indices are claimed in order, so whoever holds this one will finish it
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->cv.wait(lock, [&] { return job->states[completed] != Job::PENDING; });
+    }
+
+    {
+        // Tasks may reference the caller's stack, so wait until no worker can still be running one
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->closed = true;
+        job->cv.wait(lock, [&] { return job->active == 0; });
+    }
+    return ok;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -1,4 +1,6 @@
 #include "xenocomm/core/data_adapters.h"
+#include "xenocomm/core/adapter_registrar.h"
+#include "xenocomm/utils/vector_quantize.hpp"
 #include <algorithm>
 #include <cstring>
 
@@ -7,23 +9,55 @@ namespace core {
 
 // VectorFloat32Adapter implementation
 std::vector<uint8_t> VectorFloat32Adapter::encode(const void* data, size_t size, DataFormat format) {
-    validateInput(data, size);
-    
+    return encodeToVector(data, size, format);
+}
+
+std::vector<uint8_t> VectorFloat32Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+    return decodeToVector(encoded_data, source_format);
+}
+
+size_t VectorFloat32Adapter::maxEncodedSize(size_t size, DataFormat format) const {
     if (format != DataFormat::VECTOR_FLOAT32) {
         throw TranscodingError("VectorFloat32Adapter only supports VECTOR_FLOAT32 format");
     }
-
-    vector_size_ = size / sizeof(float);
-    std::vector<uint8_t> encoded_data(size);
-    std::memcpy(encoded_data.data(), data, size);
-    return encoded_data;
+    return size;
 }
 
-std::vector<uint8_t> VectorFloat32Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+size_t VectorFloat32Adapter::maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const {
     if (source_format != DataFormat::VECTOR_FLOAT32) {
         throw TranscodingError("VectorFloat32Adapter only supports VECTOR_FLOAT32 format");
     }
+    return encoded_data.size();
+}
+
+size_t VectorFloat32Adapter::encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) {
+    validateInput(data.data(), data.size());
+    requireCapacity(out, maxEncodedSize(data.size(), format));
+    std::memcpy(out.data(), data.data(), data.size());
+    return data.size();
+}
+
+size_t VectorFloat32Adapter::decodeInto(utils::ByteSpan encoded_data, DataFormat source_format,
+                                        utils::MutableByteSpan out) {
+    requireCapacity(out, maxDecodedSize(encoded_data, source_format));
+    if (!encoded_data.empty()) {
+        std::memcpy(out.data(), encoded_data.data(), encoded_data.size());
+    }
+    return encoded_data.size();
+}
 
+std::optional<utils::ByteSpan> VectorFloat32Adapter::encodeView(utils::ByteSpan data, DataFormat format) const {
+    if (format != DataFormat::VECTOR_FLOAT32) {
+        return std::nullopt;
+    }
+    return data;
+}
+
+std::optional<utils::ByteSpan> VectorFloat32Adapter::decodeView(utils::ByteSpan encoded_data,
+                                                                DataFormat source_format) const {
+    if (source_format != DataFormat::VECTOR_FLOAT32) {
+        return std::nullopt;
+    }
     return encoded_data;
 }
 
@@ -40,47 +74,135 @@ TranscodingMetadata VectorFloat32Adapter::getMetadata(const std::vector<uint8_t>
 }
 
 // VectorInt8Adapter implementation
+namespace {
+
+constexpr size_t BLOCK_HEADER_SIZE = 2 * sizeof(float);  // offset, step
+
+} // namespace
+
+VectorInt8Adapter VectorInt8Adapter::perBlock(size_t block_size) {
+    if (block_size == 0) {
+        throw TranscodingError("VectorInt8Adapter block size must be positive");
+    }
+    VectorInt8Adapter adapter;
+    adapter.block_size_ = block_size;
+    return adapter;
+}
+
+bool VectorInt8Adapter::blockLayout(size_t encoded_size, size_t& blocks, size_t& elements) const {
+    // Every block but the last is full, and the last holds at least one code
+    const size_t stride = BLOCK_HEADER_SIZE + block_size_;
+    blocks = (encoded_size + stride - 1) / stride;
+    if (blocks == 0 || encoded_size - (blocks - 1) * stride <= BLOCK_HEADER_SIZE) {
+        return false;
+    }
+    elements = encoded_size - blocks * BLOCK_HEADER_SIZE;
+    return true;
+}
+
 std::vector<uint8_t> VectorInt8Adapter::encode(const void* data, size_t size, DataFormat format) {
-    validateInput(data, size);
-    
+    return encodeToVector(data, size, format);
+}
+
+std::vector<uint8_t> VectorInt8Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+    return decodeToVector(encoded_data, source_format);
+}
+
+size_t VectorInt8Adapter::maxEncodedSize(size_t size, DataFormat format) const {
     if (format != DataFormat::VECTOR_FLOAT32) {
         throw TranscodingError("VectorInt8Adapter requires VECTOR_FLOAT32 input format");
     }
-
-    const float* float_data = static_cast<const float*>(data);
     size_t num_elements = size / sizeof(float);
-    std::vector<uint8_t> encoded_data(num_elements);
-
-    // Quantize each float to int8 using the scale factor
-    for (size_t i = 0; i < num_elements; ++i) {
-        float scaled = float_data[i] * scale_factor_;
-        encoded_data[i] = static_cast<uint8_t>(std::max(0.0f, std::min(255.0f, scaled)));
+    if (block_size_ == 0) {
+        return num_elements;
     }
-
-    return encoded_data;
+    return (num_elements + block_size_ - 1) / block_size_ * BLOCK_HEADER_SIZE + num_elements;
 }
 
-std::vector<uint8_t> VectorInt8Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+size_t VectorInt8Adapter::maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const {
     if (source_format != DataFormat::VECTOR_INT8) {
         throw TranscodingError("VectorInt8Adapter only supports decoding from VECTOR_INT8 format");
     }
+    if (block_size_ == 0) {
+        return encoded_data.size() * sizeof(float);
+    }
+    size_t blocks = 0;
+    size_t num_elements = 0;
+    if (!blockLayout(encoded_data.size(), blocks, num_elements)) {
+        throw TranscodingError("VectorInt8Adapter received a truncated block encoding");
+    }
+    return num_elements * sizeof(float);
+}
+
+size_t VectorInt8Adapter::encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) {
+    validateInput(data.data(), data.size());
+    size_t encoded_size = maxEncodedSize(data.size(), format);
+    requireCapacity(out, encoded_size);
+
+    const float* float_data = reinterpret_cast<const float*>(data.data());
+    size_t num_elements = data.size() / sizeof(float);
+
+    if (block_size_ == 0) {
+        utils::quantizeToUint8(float_data, out.data(), num_elements, scale_factor_);
+        return encoded_size;
+    }
 
-    std::vector<uint8_t> decoded_data(encoded_data.size() * sizeof(float));
-    float* float_data = reinterpret_cast<float*>(decoded_data.data());
+    uint8_t* block_out = out.data();
+    for (size_t first = 0; first < num_elements; first += block_size_) {
+        size_t count = std::min(block_size_, num_elements - first);
+        float min = 0.0f;
+        float max = 0.0f;
+        utils::floatRange(float_data + first, count, min, max);
+        if (min > max) {  // All NaN
+            min = max = 0.0f;
+        }
 
-    // Dequantize each int8 back to float
-    for (size_t i = 0; i < encoded_data.size(); ++i) {
-        float_data[i] = static_cast<float>(encoded_data[i]) / scale_factor_;
+        // Codes 0 and 255 decode to the block's minimum and maximum; the
+        // 0.5 bias rounds to the nearest code
+        float step = (max - min) / 255.0f;
+        float scale = step > 0.0f ? 1.0f / step : 0.0f;
+        std::memcpy(block_out, &min, sizeof(float));
+        std::memcpy(block_out + sizeof(float), &step, sizeof(float));
+        utils::quantizeToUint8(float_data + first, block_out + BLOCK_HEADER_SIZE, count, scale, 0.5f - min * scale);
+        block_out += BLOCK_HEADER_SIZE + count;
     }
 
-    return decoded_data;
+    return encoded_size;
+}
+
+size_t VectorInt8Adapter::decodeInto(utils::ByteSpan encoded_data, DataFormat source_format,
+                                     utils::MutableByteSpan out) {
+    size_t decoded_size = maxDecodedSize(encoded_data, source_format);
+    requireCapacity(out, decoded_size);
+    float* float_data = reinterpret_cast<float*>(out.data());
+
+    if (block_size_ == 0) {
+        utils::dequantizeFromUint8(encoded_data.data(), float_data, encoded_data.size(), 1.0f / scale_factor_);
+        return decoded_size;
+    }
+
+    size_t num_elements = decoded_size / sizeof(float);
+    const uint8_t* in = encoded_data.data();
+    for (size_t first = 0; first < num_elements; first += block_size_) {
+        size_t count = std::min(block_size_, num_elements - first);
+        float offset;
+        float step;
+        std::memcpy(&offset, in, sizeof(float));
+        std::memcpy(&step, in + sizeof(float), sizeof(float));
+        utils::dequantizeFromUint8(in + BLOCK_HEADER_SIZE, float_data + first, count, step, offset);
+        in += BLOCK_HEADER_SIZE + count;
+    }
+
+    return decoded_size;
 }
 
 bool VectorInt8Adapter::isValidFormat(const void* data, size_t size, DataFormat format) const {
     if (format == DataFormat::VECTOR_FLOAT32) {
         return data != nullptr && size % sizeof(float) == 0;
     } else if (format == DataFormat::VECTOR_INT8) {
-        return data != nullptr && size > 0;
+        size_t blocks = 0;
+        size_t elements = 0;
+        return data != nullptr && size > 0 && (block_size_ == 0 || blockLayout(size, blocks, elements));
     }
     return false;
 }
@@ -88,10 +210,356 @@ bool VectorInt8Adapter::isValidFormat(const void* data, size_t size, DataFormat
 TranscodingMetadata VectorInt8Adapter::getMetadata(const std::vector<uint8_t>& encoded_data) const {
     TranscodingMetadata metadata;
     metadata.format = DataFormat::VECTOR_INT8;
-    metadata.element_count = encoded_data.size();
     metadata.element_size = sizeof(uint8_t);
+    metadata.encoded_data_size = encoded_data.size();
+
+    if (block_size_ == 0) {
+        metadata.element_count = encoded_data.size();
+        metadata.scale_factor = scale_factor_;
+        return metadata;
+    }
+
+    size_t blocks = 0;
+    if (!blockLayout(encoded_data.size(), blocks, metadata.element_count)) {
+        throw TranscodingError("VectorInt8Adapter received a truncated block encoding");
+    }
+    metadata.block_size = block_size_;
+    metadata.block_offsets.resize(blocks);
+    metadata.block_scales.resize(blocks);
+    const uint8_t* in = encoded_data.data();
+    for (size_t block = 0; block < blocks; ++block) {
+        std::memcpy(&metadata.block_offsets[block], in, sizeof(float));
+        std::memcpy(&metadata.block_scales[block], in + sizeof(float), sizeof(float));
+        in += BLOCK_HEADER_SIZE + block_size_;
+    }
+    return metadata;
+}
+
+// VectorFloat16Adapter and VectorBFloat16Adapter implementation
+namespace {
+
+using NarrowKernel = void (*)(const float*, uint16_t*, size_t);
+using WidenKernel = void (*)(const uint16_t*, float*, size_t);
+
+size_t narrowFloats(utils::ByteSpan data, utils::MutableByteSpan out, NarrowKernel narrow) {
+    size_t num_elements = data.size() / sizeof(float);
+    narrow(reinterpret_cast<const float*>(data.data()), reinterpret_cast<uint16_t*>(out.data()), num_elements);
+    return num_elements * sizeof(uint16_t);
+}
+
+size_t widenToFloats(utils::ByteSpan encoded_data, utils::MutableByteSpan out, WidenKernel widen) {
+    size_t num_elements = encoded_data.size() / sizeof(uint16_t);
+    widen(reinterpret_cast<const uint16_t*>(encoded_data.data()), reinterpret_cast<float*>(out.data()), num_elements);
+    return num_elements * sizeof(float);
+}
+
+bool isValidHalfWidth(const void* data, size_t size, DataFormat format, DataFormat encoded_format) {
+    if (format == DataFormat::VECTOR_FLOAT32) {
+        return data != nullptr && size % sizeof(float) == 0;
+    } else if (format == encoded_format) {
+        return data != nullptr && size > 0 && size % sizeof(uint16_t) == 0;
+    }
+    return false;
+}
+
+TranscodingMetadata halfWidthMetadata(const std::vector<uint8_t>& encoded_data, DataFormat encoded_format) {
+    TranscodingMetadata metadata;
+    metadata.format = encoded_format;
+    metadata.element_count = encoded_data.size() / sizeof(uint16_t);
+    metadata.element_size = sizeof(uint16_t);
+    metadata.encoded_data_size = encoded_data.size();
+    return metadata;
+}
+
+} // namespace
+
+std::vector<uint8_t> VectorFloat16Adapter::encode(const void* data, size_t size, DataFormat format) {
+    return encodeToVector(data, size, format);
+}
+
+std::vector<uint8_t> VectorFloat16Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+    return decodeToVector(encoded_data, source_format);
+}
+
+size_t VectorFloat16Adapter::maxEncodedSize(size_t size, DataFormat format) const {
+    if (format != DataFormat::VECTOR_FLOAT32) {
+        throw TranscodingError("VectorFloat16Adapter requires VECTOR_FLOAT32 input format");
+    }
+    return size / sizeof(float) * sizeof(uint16_t);
+}
+
+size_t VectorFloat16Adapter::maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const {
+    if (source_format != DataFormat::VECTOR_FLOAT16) {
+        throw TranscodingError("VectorFloat16Adapter only supports decoding from VECTOR_FLOAT16 format");
+    }
+    if (encoded_data.size() % sizeof(uint16_t) != 0) {
+        throw TranscodingError("VectorFloat16Adapter received a truncated encoding");
+    }
+    return encoded_data.size() / sizeof(uint16_t) * sizeof(float);
+}
+
+size_t VectorFloat16Adapter::encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) {
+    validateInput(data.data(), data.size());
+    requireCapacity(out, maxEncodedSize(data.size(), format));
+    return narrowFloats(data, out, utils::floatToHalf);
+}
+
+size_t VectorFloat16Adapter::decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) {
+    requireCapacity(out, maxDecodedSize(encoded_data, source_format));
+    return widenToFloats(encoded_data, out, utils::halfToFloat);
+}
+
+bool VectorFloat16Adapter::isValidFormat(const void* data, size_t size, DataFormat format) const {
+    return isValidHalfWidth(data, size, format, DataFormat::VECTOR_FLOAT16);
+}
+
+TranscodingMetadata VectorFloat16Adapter::getMetadata(const std::vector<uint8_t>& encoded_data) const {
+    return halfWidthMetadata(encoded_data, DataFormat::VECTOR_FLOAT16);
+}
+
+std::vector<uint8_t> VectorBFloat16Adapter::encode(const void* data, size_t size, DataFormat format) {
+    return encodeToVector(data, size, format);
+}
+
+std::vector<uint8_t> VectorBFloat16Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+    return decodeToVector(encoded_data, source_format);
+}
+
+size_t VectorBFloat16Adapter::maxEncodedSize(size_t size, DataFormat format) const {
+    if (format != DataFormat::VECTOR_FLOAT32) {
+        throw TranscodingError("VectorBFloat16Adapter requires VECTOR_FLOAT32 input format");
+    }
+    return size / sizeof(float) * sizeof(uint16_t);
+}
+
+size_t VectorBFloat16Adapter::maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const {
+    if (source_format != DataFormat::VECTOR_BFLOAT16) {
+        throw TranscodingError("VectorBFloat16Adapter only supports decoding from VECTOR_BFLOAT16 format");
+    }
+    if (encoded_data.size() % sizeof(uint16_t) != 0) {
+        throw TranscodingError("VectorBFloat16Adapter received a truncated encoding");
+    }
+    return encoded_data.size() / sizeof(uint16_t) * sizeof(float);
+}
+
+size_t VectorBFloat16Adapter::encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) {
+    validateInput(data.data(), data.size());
+    requireCapacity(out, maxEncodedSize(data.size(), format));
+    return narrowFloats(data, out, utils::floatToBfloat16);
+}
+
+size_t VectorBFloat16Adapter::decodeInto(utils::ByteSpan encoded_data, DataFormat source_format, utils::MutableByteSpan out) {
+    requireCapacity(out, maxDecodedSize(encoded_data, source_format));
+    return widenToFloats(encoded_data, out, utils::bfloat16ToFloat);
+}
+
+bool VectorBFloat16Adapter::isValidFormat(const void* data, size_t size, DataFormat format) const {
+    return isValidHalfWidth(data, size, format, DataFormat::VECTOR_BFLOAT16);
+}
+
+TranscodingMetadata VectorBFloat16Adapter::getMetadata(const std::vector<uint8_t>& encoded_data) const {
+    return halfWidthMetadata(encoded_data, DataFormat::VECTOR_BFLOAT16);
+}
+
+// VectorInt4Adapter implementation
+namespace {
+
+constexpr size_t INT4_HEADER_SIZE = 2 * sizeof(uint32_t);  // element count, group size
+constexpr size_t INT4_GROUP_HEADER_SIZE = 2 * sizeof(float);  // offset, step
+
+struct Int4Layout {
+    size_t elements{0};
+    size_t group_size{0};
+    size_t groups{0};
+};
+
+// Reads the header and checks the rest of the encoding has exactly the size it implies
+bool readInt4Layout(const uint8_t* data, size_t size, Int4Layout& layout) {
+    if (data == nullptr || size < INT4_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t elements;
+    uint32_t group_size;
+    std::memcpy(&elements, data, sizeof(uint32_t));
+    std::memcpy(&group_size, data + sizeof(uint32_t), sizeof(uint32_t));
+    if (group_size == 0) {
+        return false;
+    }
+
+    size_t full = elements / group_size;
+    size_t rest = elements % group_size;
+    layout.elements = elements;
+    layout.group_size = group_size;
+    layout.groups = full + (rest > 0 ? 1 : 0);
+    size_t expected = INT4_HEADER_SIZE + layout.groups * INT4_GROUP_HEADER_SIZE +
+                      full * ((group_size + 1) / 2) + (rest + 1) / 2;
+    return size == expected;
+}
+
+} // namespace
+
+VectorInt4Adapter::VectorInt4Adapter(size_t group_size) : group_size_(group_size) {
+    if (group_size == 0 || group_size > UINT32_MAX) {
+        throw TranscodingError("VectorInt4Adapter group size must be between 1 and 2^32 - 1");
+    }
+}
+
+std::vector<uint8_t> VectorInt4Adapter::encode(const void* data, size_t size, DataFormat format) {
+    return encodeToVector(data, size, format);
+}
+
+std::vector<uint8_t> VectorInt4Adapter::decode(const std::vector<uint8_t>& encoded_data, DataFormat source_format) {
+    return decodeToVector(encoded_data, source_format);
+}
+
+size_t VectorInt4Adapter::maxEncodedSize(size_t size, DataFormat format) const {
+    if (format != DataFormat::VECTOR_FLOAT32) {
+        throw TranscodingError("VectorInt4Adapter requires VECTOR_FLOAT32 input format");
+    }
+    size_t num_elements = size / sizeof(float);
+    size_t groups = (num_elements + group_size_ - 1) / group_size_;
+    size_t full = num_elements / group_size_;
+    return INT4_HEADER_SIZE + groups * INT4_GROUP_HEADER_SIZE + full * ((group_size_ + 1) / 2) +
+           (num_elements % group_size_ + 1) / 2;
+}
+
+size_t VectorInt4Adapter::maxDecodedSize(utils::ByteSpan encoded_data, DataFormat source_format) const {
+    if (source_format != DataFormat::VECTOR_INT4) {
+        throw TranscodingError("VectorInt4Adapter only supports decoding from VECTOR_INT4 format");
+    }
+    Int4Layout layout;
+    if (!readInt4Layout(encoded_data.data(), encoded_data.size(), layout)) {
+        throw TranscodingError("VectorInt4Adapter received a malformed encoding");
+    }
+    return layout.elements * sizeof(float);
+}
+
+size_t VectorInt4Adapter::encodeInto(utils::ByteSpan data, DataFormat format, utils::MutableByteSpan out) {
+    validateInput(data.data(), data.size());
+    size_t encoded_size = maxEncodedSize(data.size(), format);
+    requireCapacity(out, encoded_size);
+
+    const float* float_data = reinterpret_cast<const float*>(data.data());
+    size_t num_elements = data.size() / sizeof(float);
+    if (num_elements > UINT32_MAX) {
+        throw TranscodingError("VectorInt4Adapter supports at most 2^32 - 1 elements");
+    }
+
+    uint32_t header[2] = {static_cast<uint32_t>(num_elements), static_cast<uint32_t>(group_size_)};
+    std::memcpy(out.data(), header, sizeof(header));
+
+    std::vector<uint8_t> codes(std::min(group_size_, num_elements));
+    uint8_t* group_out = out.data() + INT4_HEADER_SIZE;
+    for (size_t first = 0; first < num_elements; first += group_size_) {
+        size_t count = std::min(group_size_, num_elements - first);
+        float min = 0.0f;
+        float max = 0.0f;
+        utils::floatRange(float_data + first, count, min, max);
+        if (min > max) {  // All NaN
+            min = max = 0.0f;
+        }
+
+        float step = (max - min) / 15.0f;
+        float scale = step > 0.0f ? 1.0f / step : 0.0f;
+        std::memcpy(group_out, &min, sizeof(float));
+        std::memcpy(group_out + sizeof(float), &step, sizeof(float));
+        group_out += INT4_GROUP_HEADER_SIZE;
+
+        // Codes come out in 0-15, except NaNs at 255, which the mask turns into 15
+        utils::quantizeToUint8(float_data + first, codes.data(), count, scale, 0.5f - min * scale);
+        for (size_t i = 0; i + 1 < count; i += 2) {
+            *group_out++ = static_cast<uint8_t>((codes[i] & 0x0F) | (codes[i + 1] << 4));
+        }
+        if (count % 2 != 0) {
+            *group_out++ = static_cast<uint8_t>(codes[count - 1] & 0x0F);
+        }
+    }
+
+    return encoded_size;
+}
+
+size_t VectorInt4Adapter::decodeInto(utils::ByteSpan encoded_data, DataFormat source_format,
+                                     utils::MutableByteSpan out) {
+    size_t decoded_size = maxDecodedSize(encoded_data, source_format);
+    requireCapacity(out, decoded_size);
+
+    Int4Layout layout;
+    readInt4Layout(encoded_data.data(), encoded_data.size(), layout);
+    float* float_data = reinterpret_cast<float*>(out.data());
+    std::vector<uint8_t> codes(std::min(layout.group_size, layout.elements));
+    const uint8_t* in = encoded_data.data() + INT4_HEADER_SIZE;
+    for (size_t first = 0; first < layout.elements; first += layout.group_size) {
+        size_t count = std::min(layout.group_size, layout.elements - first);
+        float offset;
+        float step;
+        std::memcpy(&offset, in, sizeof(float));
+        std::memcpy(&step, in + sizeof(float), sizeof(float));
+        in += INT4_GROUP_HEADER_SIZE;
+
+        for (size_t i = 0; i < count; i += 2) {
+            codes[i] = *in & 0x0F;
+            if (i + 1 < count) {
+                codes[i + 1] = *in >> 4;
+            }
+            ++in;
+        }
+        utils::dequantizeFromUint8(codes.data(), float_data + first, count, step, offset);
+    }
+
+    return decoded_size;
+}
+
+bool VectorInt4Adapter::isValidFormat(const void* data, size_t size, DataFormat format) const {
+    if (format == DataFormat::VECTOR_FLOAT32) {
+        return data != nullptr && size % sizeof(float) == 0;
+    } else if (format == DataFormat::VECTOR_INT4) {
+        Int4Layout layout;
+        return readInt4Layout(static_cast<const uint8_t*>(data), size, layout) && layout.elements > 0;
+    }
+    return false;
+}
+
+TranscodingMetadata VectorInt4Adapter::getMetadata(const std::vector<uint8_t>& encoded_data) const {
+    Int4Layout layout;
+    if (!readInt4Layout(encoded_data.data(), encoded_data.size(), layout)) {
+        throw TranscodingError("VectorInt4Adapter received a malformed encoding");
+    }
+
+    TranscodingMetadata metadata;
+    metadata.format = DataFormat::VECTOR_INT4;
+    metadata.element_count = layout.elements;
+    metadata.element_size = 0;  // Codes are half a byte each
+    metadata.encoded_data_size = encoded_data.size();
+    metadata.block_size = layout.group_size;
+    metadata.block_offsets.resize(layout.groups);
+    metadata.block_scales.resize(layout.groups);
+    const uint8_t* in = encoded_data.data() + INT4_HEADER_SIZE;
+    for (size_t group = 0; group < layout.groups; ++group) {
+        size_t count = std::min(layout.group_size, layout.elements - group * layout.group_size);
+        std::memcpy(&metadata.block_offsets[group], in, sizeof(float));
+        std::memcpy(&metadata.block_scales[group], in + sizeof(float), sizeof(float));
+        in += INT4_GROUP_HEADER_SIZE + (count + 1) / 2;
+    }
     return metadata;
 }
 
+namespace {
+
+// The reduced-precision formats are selectable by negotiation, so make them
+// available through the registry without callers constructing them. They keep
+// no state between calls, so every thread shares one instance; the float32
+// adapter remembers the last vector size and gets one per thread.
+const AdapterRegistrar<VectorFloat32Adapter> float32Registrar(
+    DataFormat::VECTOR_FLOAT32, "float32 vectors", AdapterSharing::PER_THREAD);
+const AdapterRegistrar<VectorFloat16Adapter> float16Registrar(
+    DataFormat::VECTOR_FLOAT16, "float32 vectors as IEEE half-precision", AdapterSharing::SHARED);
+const AdapterRegistrar<VectorBFloat16Adapter> bfloat16Registrar(
+    DataFormat::VECTOR_BFLOAT16, "float32 vectors as bfloat16", AdapterSharing::SHARED);
+const AdapterRegistrar<VectorInt4Adapter> int4Registrar(
+    DataFormat::VECTOR_INT4, "float32 vectors as packed 4-bit codes with per-group scales",
+    AdapterSharing::SHARED);
+
+} // namespace
+
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
@@ -1,9 +1,107 @@
 #include "xenocomm/core/data_transcoder.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace xenocomm {
 namespace core {
 
-// Implementation will be added in concrete derived classes
+namespace {
+
+// Below this much input per thread, starting a thread costs more than it saves
+constexpr size_t MIN_BATCH_BYTES_PER_THREAD = 256 * 1024;
+
+// Runs body(first, last) over consecutive slices of [0, count) and rethrows the first
+// exception any slice raised. The calling thread takes the first slice itself
+template <typename Body>
+void forEachSlice(size_t count, size_t bytes_per_row, size_t threads, const Body& body) {
+    const size_t total = count * std::max<size_t>(bytes_per_row, 1);
+    threads = std::min({threads, count, total / MIN_BATCH_BYTES_PER_THREAD});
+    if (threads <= 1) {
+        body(0, count);
+        return;
+    }
+
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto run = [&](size_t first, size_t last) {
+        try {
+            body(first, last);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    const size_t per_thread = (count + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t first = per_thread; first < count; first += per_thread) {
+        workers.emplace_back(run, first, std::min(count, first + per_thread));
+    }
+    run(0, std::min(count, per_thread));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+size_t batchThreads(const DataTranscoder& transcoder, size_t max_threads) {
+    if (!transcoder.isReentrant()) {
+        return 1;
+    }
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    return max_threads == 0 ? cores : std::min(cores, max_threads);
+}
+
+} // namespace
+
+std::vector<size_t> DataTranscoder::encodeBatch(utils::ByteSpan data, size_t row_size, DataFormat format,
+                                                utils::MutableByteSpan out, size_t max_threads) {
+    if (row_size == 0 || data.size() % row_size != 0) {
+        throw TranscodingError("Batch input is not a whole number of rows");
+    }
+    const size_t count = data.size() / row_size;
+    const size_t stride = maxEncodedSize(row_size, format);
+    requireCapacity(out, count * stride);
+
+    std::vector<size_t> sizes(count);
+    forEachSlice(count, row_size, batchThreads(*this, max_threads), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            sizes[i] = encodeInto(data.subspan(i * row_size, row_size), format, out.subspan(i * stride, stride));
+        }
+    });
+    return sizes;
+}
+
+void DataTranscoder::decodeBatch(utils::ByteSpan encoded, size_t stride, const std::vector<size_t>& rows,
+                                 DataFormat source_format, utils::MutableByteSpan out, size_t row_size,
+                                 size_t max_threads) {
+    const size_t count = rows.size();
+    if (count > 0 && (stride == 0 || encoded.size() / stride < count - 1 ||
+                      encoded.size() - (count - 1) * stride < rows.back())) {
+        throw TranscodingError("Batch input is shorter than its rows");
+    }
+    requireCapacity(out, count * row_size);
+
+    forEachSlice(count, stride, batchThreads(*this, max_threads), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            if (rows[i] > stride) {
+                throw TranscodingError("Batch row is longer than the stride");
+            }
+            utils::ByteSpan row = encoded.subspan(i * stride, rows[i]);
+            if (maxDecodedSize(row, source_format) != row_size ||
+                decodeInto(row, source_format, out.subspan(i * row_size, row_size)) != row_size) {
+                throw TranscodingError("Batch row does not decode to the row size");
+            }
+        }
+    });
+}
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
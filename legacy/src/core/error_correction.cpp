@@ -1,6 +1,9 @@
 #include "xenocomm/core/error_correction.h"
+#include "xenocomm/core/fountain_code.h"
 // #include "xenocomm/utils/logging.h" // Commented out - Header file not found
 #include "xenocomm/core/transmission_manager.h" // Added include
+#include "xenocomm/utils/crc32.hpp"
+#include "xenocomm/utils/gf256.hpp"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -16,35 +19,10 @@ namespace core {
 
 // CRC32ErrorDetection implementation
 
-CRC32ErrorDetection::CRC32ErrorDetection() : crc_table_(256, 0) {
-    initCRCTable();
-}
-
-void CRC32ErrorDetection::initCRCTable() {
-    // Generate CRC lookup table
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (uint32_t j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ CRC32_POLYNOMIAL;
-            } else {
-                crc = crc >> 1;
-            }
-        }
-        crc_table_[i] = crc;
-    }
-}
+CRC32ErrorDetection::CRC32ErrorDetection() = default;
 
 uint32_t CRC32ErrorDetection::computeCRC32(const uint8_t* data, size_t length) const {
-    uint32_t crc = 0xFFFFFFFF;
-    
-    // Process each byte using the lookup table
-    for (size_t i = 0; i < length; i++) {
-        uint8_t index = (crc ^ data[i]) & 0xFF;
-        crc = (crc >> 8) ^ crc_table_[index];
-    }
-    
-    return ~crc; // Final XOR
+    return utils::crc32(data, length);
 }
 
 bool CRC32ErrorDetection::verifyCRC32(const uint8_t* data, size_t length) const {
@@ -96,65 +74,130 @@ std::optional<std::vector<uint8_t>> CRC32ErrorDetection::decode(const std::vecto
 // ReedSolomonCorrection implementation
 
 namespace {
-    // Helper function to calculate shard size
-    size_t calculateShardSize(size_t dataSize, uint8_t dataShards) {
-        return (dataSize + dataShards - 1) / dataShards;
-    }
-
-    // Helper function to store original data size
-    void storeOriginalSize(std::vector<uint8_t>& data, size_t originalSize) {
-        uint8_t sizeBytes[sizeof(size_t)];
-        std::memcpy(sizeBytes, &originalSize, sizeof(size_t));
-        
-        auto insertPos = data.end() - sizeof(size_t);
-        std::copy(sizeBytes, sizeBytes + sizeof(size_t), insertPos);
-    }
-
-    // Helper function to retrieve original data size
-    size_t retrieveOriginalSize(const std::vector<uint8_t>& data) {
-        size_t originalSize;
-        std::memcpy(&originalSize, data.data() + data.size() - sizeof(size_t), sizeof(size_t));
-        return originalSize;
-    }
-
-    // Helper function to interleave data
-    std::vector<uint8_t> interleave(const std::vector<uint8_t>& data, uint16_t depth) {
-        if (depth <= 1 || data.empty()) return data;
-        
-        std::vector<uint8_t> result(data.size());
-        size_t rows = depth;
-        size_t cols = (data.size() + depth - 1) / depth;
-        
-        for (size_t i = 0; i < data.size(); i++) {
-            size_t row = i % rows;
-            size_t col = i / rows;
-            size_t new_pos = row * cols + col;
-            
-            if (new_pos < result.size()) {
-                result[new_pos] = data[i];
+    constexpr size_t LENGTH_PREFIX_SIZE = 4;
+    constexpr size_t SHARD_CRC_SIZE = 4;
+    constexpr size_t INTERLEAVE_DEPTH = 16;
+
+    void writeLE32(uint8_t* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint32_t readLE32(const uint8_t* in) {
+        return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+               (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+    }
+
+    size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // Inverts a k x k matrix over GF(256) by Gauss-Jordan elimination. The
+    // input is destroyed; inverse receives the result.
+    bool invertMatrix(uint8_t* matrix, uint8_t* inverse, size_t k) {
+        std::memset(inverse, 0, k * k);
+        for (size_t i = 0; i < k; ++i) {
+            inverse[i * k + i] = 1;
+        }
+
+        for (size_t col = 0; col < k; ++col) {
+            size_t pivot = col;
+            while (pivot < k && matrix[pivot * k + col] == 0) {
+                ++pivot;
+            }
+            if (pivot == k) {
+                return false;
+            }
+            if (pivot != col) {
+                std::swap_ranges(matrix + pivot * k, matrix + (pivot + 1) * k, matrix + col * k);
+                std::swap_ranges(inverse + pivot * k, inverse + (pivot + 1) * k, inverse + col * k);
+            }
+
+            uint8_t scale = utils::gf256Inv(matrix[col * k + col]);
+            utils::gf256MulRegion(scale, matrix + col * k, matrix + col * k, k);
+            utils::gf256MulRegion(scale, inverse + col * k, inverse + col * k, k);
+
+            for (size_t row = 0; row < k; ++row) {
+                uint8_t factor = matrix[row * k + col];
+                if (row == col || factor == 0) {
+                    continue;
+                }
+                utils::gf256MulAddRegion(factor, matrix + col * k, matrix + row * k, k);
+                utils::gf256MulAddRegion(factor, inverse + col * k, inverse + row * k, k);
             }
         }
-        return result;
-    }
-
-    // Helper function to deinterleave data
-    std::vector<uint8_t> deinterleave(const std::vector<uint8_t>& data, uint16_t depth) {
-        if (depth <= 1 || data.empty()) return data;
-        
-        std::vector<uint8_t> result(data.size());
-        size_t rows = depth;
-        size_t cols = (data.size() + depth - 1) / depth;
-        
-        for (size_t i = 0; i < data.size(); i++) {
-            size_t row = i / cols;
-            size_t col = i % cols;
-            size_t new_pos = col * rows + row;
-            
-            if (new_pos < result.size()) {
-                result[new_pos] = data[i];
+        return true;
+    }
+
+    // Interleaving views the zero-padded payload as a column-major matrix with
+    // INTERLEAVE_DEPTH rows and writes it out row-major, so consecutive input
+    // bytes land INTERLEAVE_DEPTH rows apart. The transpose runs on square
+    // tiles that fit in L1 instead of scattering byte by byte.
+    constexpr size_t TILE = INTERLEAVE_DEPTH;
+
+    // Writes roundUp(size, INTERLEAVE_DEPTH) bytes to dst
+    void interleaveInto(const uint8_t* src, size_t size, uint8_t* dst) {
+        const size_t cols = roundUp(size, INTERLEAVE_DEPTH) / INTERLEAVE_DEPTH;
+        uint8_t tile[INTERLEAVE_DEPTH][TILE];
+
+        for (size_t col0 = 0; col0 < cols; col0 += TILE) {
+            const size_t width = std::min(TILE, cols - col0);
+            const uint8_t* in = src + col0 * INTERLEAVE_DEPTH;
+            const size_t available = size - col0 * INTERLEAVE_DEPTH;
+
+            if (available >= width * INTERLEAVE_DEPTH) {
+                for (size_t c = 0; c < width; ++c) {
+                    for (size_t row = 0; row < INTERLEAVE_DEPTH; ++row) {
+                        tile[row][c] = in[c * INTERLEAVE_DEPTH + row];
+                    }
+                }
+            } else {
+                for (size_t c = 0; c < width; ++c) {
+                    for (size_t row = 0; row < INTERLEAVE_DEPTH; ++row) {
+                        size_t index = c * INTERLEAVE_DEPTH + row;
+                        tile[row][c] = index < available ? in[index] : 0;
+                    }
+                }
+            }
+
+            for (size_t row = 0; row < INTERLEAVE_DEPTH; ++row) {
+                std::memcpy(dst + row * cols + col0, tile[row], width);
+            }
+        }
+    }
+
+    // Inverse of interleaveInto(), keeping only the first size bytes
+    void deinterleaveInto(const uint8_t* src, size_t size, uint8_t* dst) {
+        const size_t cols = roundUp(size, INTERLEAVE_DEPTH) / INTERLEAVE_DEPTH;
+        uint8_t tile[INTERLEAVE_DEPTH][TILE];
+
+        for (size_t col0 = 0; col0 < cols; col0 += TILE) {
+            const size_t width = std::min(TILE, cols - col0);
+            uint8_t* out = dst + col0 * INTERLEAVE_DEPTH;
+            const size_t remaining = size - col0 * INTERLEAVE_DEPTH;
+
+            for (size_t row = 0; row < INTERLEAVE_DEPTH; ++row) {
+                std::memcpy(tile[row], src + row * cols + col0, width);
+            }
+
+            if (remaining >= width * INTERLEAVE_DEPTH) {
+                for (size_t c = 0; c < width; ++c) {
+                    for (size_t row = 0; row < INTERLEAVE_DEPTH; ++row) {
+                        out[c * INTERLEAVE_DEPTH + row] = tile[row][c];
+                    }
+                }
+            } else {
+                for (size_t c = 0; c < width; ++c) {
+                    for (size_t row = 0; row < INTERLEAVE_DEPTH; ++row) {
+                        size_t index = c * INTERLEAVE_DEPTH + row;
+                        if (index < remaining) {
+                            out[index] = tile[row][c];
+                        }
+                    }
+                }
             }
         }
-        return result;
     }
 }
 
@@ -162,127 +205,215 @@ ReedSolomonCorrection::ReedSolomonCorrection(const Config& config) : config_(con
     // LOG_INFO("Initializing Reed-Solomon correction with " +  // Commented out
     //          std::to_string(config_.data_shards) + " data shards and " + 
     //          std::to_string(config_.parity_shards) + " parity shards.");
+    buildParityMatrix();
 }
 
-std::vector<uint8_t> ReedSolomonCorrection::encode(const std::vector<uint8_t>& data) {
-    if (data.empty()) {
-        return data;
+bool ReedSolomonCorrection::isValidConfig() const {
+    return config_.data_shards > 0 && config_.data_shards + config_.parity_shards <= 256;
+}
+
+void ReedSolomonCorrection::buildParityMatrix() {
+    parity_matrix_.clear();
+    if (!isValidConfig()) {
+        return;
     }
 
-    // Calculate shard size and pad data if necessary
-    size_t shardSize = calculateShardSize(data.size(), config_.data_shards);
-    size_t totalShards = config_.data_shards + config_.parity_shards;
-    
-    // Prepare data with padding
-    std::vector<uint8_t> paddedData = data;
-    size_t paddedSize = shardSize * config_.data_shards;
-    if (paddedData.size() < paddedSize) {
-        paddedData.resize(paddedSize, 0);
-        storeOriginalSize(paddedData, data.size());
+    // Parity row i over data column j is 1 / (x_i + y_j) with x_i = K + i and
+    // y_j = j. The x and y values are disjoint, so every square submatrix of
+    // the systematic generator [I; C] is invertible and any K shards recover
+    // the data.
+    const size_t dataShards = config_.data_shards;
+    parity_matrix_.resize(config_.parity_shards * dataShards);
+    for (size_t p = 0; p < config_.parity_shards; ++p) {
+        for (size_t d = 0; d < dataShards; ++d) {
+            parity_matrix_[p * dataShards + d] =
+                utils::gf256Inv(static_cast<uint8_t>((dataShards + p) ^ d));
+        }
     }
+}
 
-    // Apply interleaving if enabled
+size_t ReedSolomonCorrection::encodedSize(size_t data_size) const {
+    if (data_size == 0 || !isValidConfig()) {
+        return 0;
+    }
+    const size_t bodySize = config_.enable_interleaving ? roundUp(data_size, INTERLEAVE_DEPTH) : data_size;
+    const size_t shardSize = (LENGTH_PREFIX_SIZE + bodySize + config_.data_shards - 1) / config_.data_shards;
+    return (config_.data_shards + config_.parity_shards) * (shardSize + SHARD_CRC_SIZE);
+}
+
+size_t ReedSolomonCorrection::encodeInto(const uint8_t* data, size_t size, uint8_t* out, size_t capacity) {
+    const size_t total = encodedSize(size);
+    if (total == 0 || capacity < total) {
+        return 0;
+    }
+
+    const size_t dataShards = config_.data_shards;
+    const size_t totalShards = dataShards + config_.parity_shards;
+    const size_t shardSize = total / totalShards - SHARD_CRC_SIZE;
+
+    // Shard matrix: [length][body][zero padding] across the data shards, then
+    // the parity shards, then one CRC per shard
+    writeLE32(out, static_cast<uint32_t>(size));
+    size_t bodySize = size;
     if (config_.enable_interleaving) {
-        paddedData = interleave(paddedData, 16); // Use fixed depth of 16 for now
+        interleaveInto(data, size, out + LENGTH_PREFIX_SIZE);
+        bodySize = roundUp(size, INTERLEAVE_DEPTH);
+    } else {
+        std::memcpy(out + LENGTH_PREFIX_SIZE, data, size);
     }
+    const size_t used = LENGTH_PREFIX_SIZE + bodySize;
+    std::memset(out + used, 0, dataShards * shardSize - used);
 
-    // Initialize Reed-Solomon encoder
-    // reed_solomon_erasure::ReedSolomon rs(config_.data_shards, config_.parity_shards);
-    
-    // Prepare shard pointers
-    std::vector<std::vector<uint8_t>> shards(totalShards);
-    std::vector<uint8_t*> shardPtrs(totalShards);
-    
-    // Split data into data shards
-    for (uint8_t i = 0; i < config_.data_shards; i++) {
-        shards[i].resize(shardSize);
-        std::copy(
-            paddedData.begin() + i * shardSize,
-            paddedData.begin() + (i + 1) * shardSize,
-            shards[i].begin()
-        );
-        shardPtrs[i] = shards[i].data();
+    for (size_t p = 0; p < config_.parity_shards; ++p) {
+        const uint8_t* row = &parity_matrix_[p * dataShards];
+        uint8_t* parity = out + (dataShards + p) * shardSize;
+        utils::gf256MulRegion(row[0], out, parity, shardSize);
+        for (size_t d = 1; d < dataShards; ++d) {
+            utils::gf256MulAddRegion(row[d], out + d * shardSize, parity, shardSize);
+        }
     }
-    
-    // Initialize parity shards
-    for (uint8_t i = config_.data_shards; i < totalShards; i++) {
-        shards[i].resize(shardSize, 0);
-        shardPtrs[i] = shards[i].data();
+
+    uint8_t* trailer = out + totalShards * shardSize;
+    for (size_t s = 0; s < totalShards; ++s) {
+        writeLE32(trailer + s * SHARD_CRC_SIZE, utils::crc32(out + s * shardSize, shardSize));
     }
-    
-    // Encode data
-    // if (!rs.encode(shardPtrs.data(), shardSize)) {
-    //     LOG_ERROR("Reed-Solomon encoding failed");
-    //     return data;
-    // }
-    
-    // Combine all shards into final output
-    std::vector<uint8_t> encoded;
-    encoded.reserve(totalShards * shardSize);
-    
-    for (const auto& shard : shards) {
-        encoded.insert(encoded.end(), shard.begin(), shard.end());
+    return total;
+}
+
+std::vector<uint8_t> ReedSolomonCorrection::encode(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> encoded(encodedSize(data.size()));
+    if (!encoded.empty()) {
+        encodeInto(data.data(), data.size(), encoded.data(), encoded.size());
     }
-    
     return encoded;
 }
 
-std::optional<std::vector<uint8_t>> ReedSolomonCorrection::decode(const std::vector<uint8_t>& data) {
-    if (data.empty()) {
-        return data;
+std::optional<ReedSolomonCorrection::DecodedView> ReedSolomonCorrection::reconstruct(const uint8_t* data,
+                                                                                     size_t size) {
+    if (!isValidConfig()) {
+        return std::nullopt;
     }
 
-    size_t totalShards = config_.data_shards + config_.parity_shards;
-    size_t shardSize = data.size() / totalShards;
-    
-    if (data.size() % totalShards != 0) {
+    const size_t dataShards = config_.data_shards;
+    const size_t totalShards = dataShards + config_.parity_shards;
+    if (size % totalShards != 0 || size / totalShards <= SHARD_CRC_SIZE) {
         // LOG_ERROR("Invalid data size for Reed-Solomon decoding"); // Commented out
         return std::nullopt;
     }
-    
-    // Initialize Reed-Solomon decoder
-    // reed_solomon_erasure::ReedSolomon rs(config_.data_shards, config_.parity_shards); // Commented out
-    
-    // Prepare shard pointers
-    std::vector<std::vector<uint8_t>> shards(totalShards);
-    std::vector<uint8_t*> shardPtrs(totalShards);
-    
-    // Split data into shards
-    for (size_t i = 0; i < totalShards; i++) {
-        shards[i].resize(shardSize);
-        std::copy(
-            data.begin() + i * shardSize,
-            data.begin() + (i + 1) * shardSize,
-            shards[i].begin()
-        );
-        shardPtrs[i] = shards[i].data();
+    const size_t shardSize = size / totalShards - SHARD_CRC_SIZE;
+
+    // Corrupted shards are located by their CRC and treated as erasures
+    const uint8_t* trailer = data + totalShards * shardSize;
+    shard_intact_.resize(totalShards);
+    survivors_.clear();
+    size_t erasures = 0;
+    for (size_t s = 0; s < totalShards; ++s) {
+        shard_intact_[s] = utils::crc32(data + s * shardSize, shardSize) == readLE32(trailer + s * SHARD_CRC_SIZE);
+        if (!shard_intact_[s]) {
+            ++erasures;
+        } else if (survivors_.size() < dataShards) {
+            survivors_.push_back(s);  // K intact shards, data shards first
+        }
     }
-    
-    // Decode data
-    // if (!rs.decode(shardPtrs.data(), nullptr, shardSize)) { // Commented out
-    //     LOG_ERROR("Reed-Solomon decoding failed"); // Commented out
-    //     return std::nullopt;
-    // }
-    
-    // Combine data shards
-    std::vector<uint8_t> decoded;
-    decoded.reserve(config_.data_shards * shardSize);
-    
-    for (uint8_t i = 0; i < config_.data_shards; i++) {
-        decoded.insert(decoded.end(), shards[i].begin(), shards[i].end());
+
+    // Half the parity is reserved to cross-check the reconstruction below
+    if (erasures > static_cast<size_t>(maxCorrectableErrors())) {
+        return std::nullopt;
     }
-    
-    // Deinterleave if necessary
+
+    // Only a missing data shard needs rebuilding; lost parity is simply ignored
+    const uint8_t* shards = data;
+    if (survivors_.back() != dataShards - 1) {
+        scratch_.resize(dataShards * shardSize);
+        std::memcpy(scratch_.data(), data, scratch_.size());
+
+        // Rows of the generator for the surviving shards, then their inverse
+        matrix_scratch_.resize(2 * dataShards * dataShards);
+        uint8_t* matrix = matrix_scratch_.data();
+        uint8_t* inverse = matrix + dataShards * dataShards;
+        for (size_t row = 0; row < dataShards; ++row) {
+            size_t s = survivors_[row];
+            if (s < dataShards) {
+                std::memset(matrix + row * dataShards, 0, dataShards);
+                matrix[row * dataShards + s] = 1;
+            } else {
+                std::memcpy(matrix + row * dataShards, &parity_matrix_[(s - dataShards) * dataShards], dataShards);
+            }
+        }
+        if (!invertMatrix(matrix, inverse, dataShards)) {
+            return std::nullopt;
+        }
+
+        for (size_t d = 0; d < dataShards; ++d) {
+            if (shard_intact_[d]) {
+                continue;
+            }
+            uint8_t* rebuilt = scratch_.data() + d * shardSize;
+            utils::gf256MulRegion(inverse[d * dataShards], data + survivors_[0] * shardSize, rebuilt, shardSize);
+            for (size_t row = 1; row < dataShards; ++row) {
+                utils::gf256MulAddRegion(inverse[d * dataShards + row],
+                                         data + survivors_[row] * shardSize, rebuilt, shardSize);
+            }
+        }
+
+        // Intact parity not used for reconstruction must agree with the rebuilt data
+        check_scratch_.resize(shardSize);
+        for (size_t s = survivors_.back() + 1; s < totalShards; ++s) {
+            if (!shard_intact_[s]) {
+                continue;
+            }
+            const uint8_t* row = &parity_matrix_[(s - dataShards) * dataShards];
+            utils::gf256MulRegion(row[0], scratch_.data(), check_scratch_.data(), shardSize);
+            for (size_t d = 1; d < dataShards; ++d) {
+                utils::gf256MulAddRegion(row[d], scratch_.data() + d * shardSize, check_scratch_.data(), shardSize);
+            }
+            if (std::memcmp(check_scratch_.data(), data + s * shardSize, shardSize) != 0) {
+                return std::nullopt;
+            }
+        }
+        shards = scratch_.data();
+    }
+
+    const size_t originalSize = readLE32(shards);
+    const size_t bodySize = config_.enable_interleaving ? roundUp(originalSize, INTERLEAVE_DEPTH)
+                                                        : originalSize;
+    if (LENGTH_PREFIX_SIZE + bodySize > dataShards * shardSize) {
+        return std::nullopt;
+    }
+    return DecodedView{shards + LENGTH_PREFIX_SIZE, originalSize};
+}
+
+void ReedSolomonCorrection::writePayload(const DecodedView& view, uint8_t* out) const {
     if (config_.enable_interleaving) {
-        decoded = deinterleave(decoded, 16);
+        deinterleaveInto(view.body, view.original_size, out);
+    } else {
+        std::memcpy(out, view.body, view.original_size);
     }
-    
-    // Retrieve original size and truncate if necessary
-    size_t originalSize = retrieveOriginalSize(decoded);
-    if (originalSize < decoded.size()) {
-        decoded.resize(originalSize);
+}
+
+std::optional<size_t> ReedSolomonCorrection::decodeInto(const uint8_t* data, size_t size,
+                                                        uint8_t* out, size_t capacity) {
+    if (size == 0) {
+        return 0;
     }
-    
+    auto view = reconstruct(data, size);
+    if (!view || view->original_size > capacity) {
+        return std::nullopt;
+    }
+    writePayload(*view, out);
+    return view->original_size;
+}
+
+std::optional<std::vector<uint8_t>> ReedSolomonCorrection::decode(const std::vector<uint8_t>& data) {
+    if (data.empty()) {
+        return data;
+    }
+    auto view = reconstruct(data.data(), data.size());
+    if (!view) {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> decoded(view->original_size);
+    writePayload(*view, decoded.data());
     return decoded;
 }
 
@@ -292,11 +423,98 @@ int ReedSolomonCorrection::maxCorrectableErrors() const {
 
 void ReedSolomonCorrection::configure(const Config& config) {
     config_ = config;
+    buildParityMatrix();
     // LOG_INFO("Reconfigured Reed-Solomon correction with " + // Commented out
     //          std::to_string(config_.data_shards) + " data shards and " + 
     //          std::to_string(config_.parity_shards) + " parity shards.");
 }
 
+// FountainCorrection implementation
+
+FountainCorrection::FountainCorrection(const Config& config) : config_(config) {}
+
+bool FountainCorrection::isValidConfig() const {
+    return FountainLayout{1, config_.symbol_size, config_.block_symbols}.valid();
+}
+
+std::vector<uint8_t> FountainCorrection::encode(const std::vector<uint8_t>& data) {
+    if (data.empty()) {
+        return {};
+    }
+    if (!isValidConfig() || data.size() > UINT32_MAX) {
+        return {};
+    }
+    std::vector<uint8_t> payload(LENGTH_PREFIX_SIZE + data.size());
+    writeLE32(payload.data(), static_cast<uint32_t>(data.size()));
+    std::memcpy(payload.data() + LENGTH_PREFIX_SIZE, data.data(), data.size());
+
+    FountainEncoder encoder(utils::ByteSpan(payload), config_.symbol_size, config_.block_symbols);
+    const FountainLayout& layout = encoder.layout();
+    const size_t record = SHARD_CRC_SIZE + layout.symbol_size;
+    const size_t count = layout.total_symbols() + static_cast<size_t>(layout.block_count()) * config_.repair_symbols;
+
+    std::vector<uint8_t> encoded(count * record);
+    uint8_t* out = encoded.data();
+    for (uint32_t block = 0; block < layout.block_count(); ++block) {
+        const uint32_t symbols = layout.source_symbols(block) + config_.repair_symbols;
+        for (uint32_t esi = 0; esi < symbols; ++esi, out += record) {
+            encoder.encode(block, esi, out + SHARD_CRC_SIZE);
+            writeLE32(out, utils::crc32(out + SHARD_CRC_SIZE, layout.symbol_size));
+        }
+    }
+    return encoded;
+}
+
+std::optional<std::vector<uint8_t>> FountainCorrection::decode(const std::vector<uint8_t>& data) {
+    if (data.empty()) {
+        return data;
+    }
+    if (!isValidConfig()) {
+        return std::nullopt;
+    }
+    const size_t record = SHARD_CRC_SIZE + config_.symbol_size;
+    if (data.size() % record != 0) {
+        return std::nullopt;
+    }
+    // Every block but the last is block_symbols + repair_symbols long, which
+    // fixes the layout without sending it
+    const size_t count = data.size() / record;
+    const size_t stride = static_cast<size_t>(config_.block_symbols) + config_.repair_symbols;
+    const size_t blocks = (count + stride - 1) / stride;
+    if (count - (blocks - 1) * stride <= config_.repair_symbols) {
+        return std::nullopt;
+    }
+    const uint64_t source_symbols = count - blocks * config_.repair_symbols;
+    FountainDecoder decoder(FountainLayout{source_symbols * config_.symbol_size, config_.symbol_size,
+                                           config_.block_symbols});
+
+    const uint8_t* in = data.data();
+    for (uint32_t block = 0; block < blocks; ++block) {
+        const uint32_t symbols = decoder.layout().source_symbols(block) + config_.repair_symbols;
+        for (uint32_t esi = 0; esi < symbols; ++esi, in += record) {
+            if (decoder.block_complete(block) ||
+                readLE32(in) != utils::crc32(in + SHARD_CRC_SIZE, config_.symbol_size)) {
+                continue;
+            }
+            decoder.add_symbol(block, esi, utils::ByteSpan(in + SHARD_CRC_SIZE, config_.symbol_size));
+        }
+    }
+    if (!decoder.complete()) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> payload = decoder.take_payload();
+    const uint32_t original_size = readLE32(payload.data());
+    // The length must account for the padding exactly, ruling out a prefix that passed its CRC by chance
+    const size_t padded = LENGTH_PREFIX_SIZE + static_cast<size_t>(original_size);
+    if (padded > payload.size() || payload.size() - padded >= config_.symbol_size) {
+        return std::nullopt;
+    }
+    payload.erase(payload.begin(), payload.begin() + LENGTH_PREFIX_SIZE);
+    payload.resize(original_size);
+    return payload;
+}
+
 // ErrorCorrectionFactory implementation
 
 std::unique_ptr<IErrorCorrection> ErrorCorrectionFactory::create(ErrorCorrectionMode mode) {
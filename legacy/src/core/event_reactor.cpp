@@ -0,0 +1,583 @@
+#include "xenocomm/core/event_reactor.hpp"
+#include "xenocomm/utils/timer_wheel.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#define XENOCOMM_REACTOR_EPOLL 1
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#define XENOCOMM_REACTOR_KQUEUE 1
+#include <sys/event.h>
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define XENOCOMM_REACTOR_POLL 1
+#include <winsock2.h>
+#else
+#define XENOCOMM_REACTOR_POLL 1
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Timers are polled at this granularity; transport timers are seconds apart
+constexpr std::chrono::milliseconds TIMER_RESOLUTION(10);
+constexpr int MAX_EVENTS_PER_WAIT = 256;
+
+struct Handler {
+    EventReactor::EventCallback callback;
+    uint32_t events;
+    std::mutex running;
+    std::atomic<bool> active{true};
+};
+
+struct Timer {
+    EventReactor::TimerCallback callback;
+    std::chrono::milliseconds interval;
+    std::mutex running;
+    std::atomic<bool> active{true};
+};
+
+// Waits for an in-flight callback to finish unless we are that callback
+template <typename Entry>
+void deactivate(Entry& entry, bool onOwnLoop) {
+    entry.active = false;
+    if (!onOwnLoop) {
+        std::lock_guard<std::mutex> wait(entry.running);
+    }
+}
+
+#ifdef XENOCOMM_REACTOR_EPOLL
+uint32_t toNative(uint32_t events) {
+    uint32_t native = EPOLLRDHUP;
+    if (events & EventReactor::READABLE) native |= EPOLLIN;
+    if (events & EventReactor::WRITABLE) native |= EPOLLOUT;
+    return native;
+}
+
+uint32_t fromNative(uint32_t native) {
+    uint32_t events = 0;
+    if (native & EPOLLIN) events |= EventReactor::READABLE;
+    if (native & EPOLLOUT) events |= EventReactor::WRITABLE;
+    if (native & (EPOLLHUP | EPOLLRDHUP)) events |= EventReactor::CLOSED;
+    if (native & EPOLLERR) events |= EventReactor::FAILED;
+    return events;
+}
+#endif
+
+#ifdef XENOCOMM_REACTOR_POLL
+#ifdef _WIN32
+using PollFd = WSAPOLLFD;
+int pollFds(PollFd* fds, size_t count, int timeoutMs) { return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs); }
+#else
+using PollFd = pollfd;
+int pollFds(PollFd* fds, size_t count, int timeoutMs) { return ::poll(fds, count, timeoutMs); }
+#endif
+
+short toNative(uint32_t events) {
+    short native = 0;
+    if (events & EventReactor::READABLE) native |= POLLIN;
+    if (events & EventReactor::WRITABLE) native |= POLLOUT;
+    return native;
+}
+
+uint32_t fromNative(short native) {
+    uint32_t events = 0;
+    if (native & POLLIN) events |= EventReactor::READABLE;
+    if (native & POLLOUT) events |= EventReactor::WRITABLE;
+    if (native & POLLHUP) events |= EventReactor::CLOSED;
+    if (native & (POLLERR | POLLNVAL)) events |= EventReactor::FAILED;
+    return events;
+}
+#endif
+
+} // namespace
+
+struct EventReactor::Loop {
+    int poller = -1;     // epoll or kqueue descriptor
+    int wakeRead = -1;   // eventfd on Linux, pipe elsewhere
+    int wakeWrite = -1;
+    std::thread thread;
+    std::atomic<std::thread::id> threadId{};
+
+    mutable std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers;
+    std::unordered_map<TimerId, std::shared_ptr<Timer>> timers;
+    utils::TimerWheel<TimerId> wheel{TIMER_RESOLUTION};
+    std::vector<std::function<void()>> tasks;
+
+    bool onThisThread() const { return threadId.load() == std::this_thread::get_id(); }
+
+    bool open() {
+#if defined(XENOCOMM_REACTOR_EPOLL)
+        poller = epoll_create1(EPOLL_CLOEXEC);
+        wakeRead = wakeWrite = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (poller < 0 || wakeRead < 0) {
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = wakeRead;
+        return epoll_ctl(poller, EPOLL_CTL_ADD, wakeRead, &ev) == 0;
+#elif defined(XENOCOMM_REACTOR_KQUEUE)
+        poller = kqueue();
+        int fds[2];
+        if (poller < 0 || pipe(fds) != 0) {
+            return false;
+        }
+        wakeRead = fds[0];
+        wakeWrite = fds[1];
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        struct kevent ev;
+        EV_SET(&ev, wakeRead, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+        return kevent(poller, &ev, 1, nullptr, 0, nullptr) == 0;
+#elif defined(_WIN32)
+        return true;  // No wake descriptor; the wait is capped at the timer resolution instead
+#else
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return false;
+        }
+        wakeRead = fds[0];
+        wakeWrite = fds[1];
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        return true;
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (wakeWrite >= 0 && wakeWrite != wakeRead) ::close(wakeWrite);
+        if (wakeRead >= 0) ::close(wakeRead);
+        if (poller >= 0) ::close(poller);
+#endif
+        poller = wakeRead = wakeWrite = -1;
+    }
+
+    void wake() const {
+#if defined(XENOCOMM_REACTOR_EPOLL)
+        uint64_t one = 1;
+        (void)!::write(wakeWrite, &one, sizeof(one));
+#elif !defined(_WIN32)
+        char byte = 0;
+        (void)!::write(wakeWrite, &byte, 1);
+#endif
+    }
+
+    void drainWake() const {
+#if defined(XENOCOMM_REACTOR_EPOLL)
+        uint64_t count;
+        (void)!::read(wakeRead, &count, sizeof(count));
+#elif !defined(_WIN32)
+        char buffer[64];
+        while (::read(wakeRead, buffer, sizeof(buffer)) > 0) {
+        }
+#endif
+    }
+
+    // Applies an interest set to the kernel poller
+    bool registerFd(int fd, uint32_t events, bool isNew) {
+#if defined(XENOCOMM_REACTOR_EPOLL)
+        epoll_event ev{};
+        ev.events = toNative(events);
+        ev.data.fd = fd;
+        return epoll_ctl(poller, isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev) == 0;
+#elif defined(XENOCOMM_REACTOR_KQUEUE)
+        (void)isNew;
+        struct kevent changes[2];
+        EV_SET(&changes[0], fd, EVFILT_READ, (events & READABLE) ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+        EV_SET(&changes[1], fd, EVFILT_WRITE, (events & WRITABLE) ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+        // Deleting a filter that was never added fails with ENOENT, which is harmless
+        for (auto& change : changes) {
+            if (kevent(poller, &change, 1, nullptr, 0, nullptr) != 0 && (change.flags & EV_ADD)) {
+                return false;
+            }
+        }
+        return true;
+#else
+        (void)fd;
+        (void)events;
+        (void)isNew;
+        return true;  // The poll set is rebuilt from handlers on every wait
+#endif
+    }
+
+    void unregisterFd(int fd, uint32_t events) {
+#if defined(XENOCOMM_REACTOR_EPOLL)
+        (void)events;
+        epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+#elif defined(XENOCOMM_REACTOR_KQUEUE)
+        struct kevent changes[2];
+        EV_SET(&changes[0], fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+        EV_SET(&changes[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+        for (int i = 0; i < ((events & WRITABLE) ? 2 : 1); ++i) {
+            kevent(poller, &changes[i], 1, nullptr, 0, nullptr);
+        }
+#else
+        (void)fd;
+        (void)events;
+#endif
+    }
+
+    // Blocks until descriptors are ready, the loop is woken, or the timeout passes
+    void wait(int timeoutMs, std::vector<std::pair<int, uint32_t>>& ready) {
+        ready.clear();
+#if defined(XENOCOMM_REACTOR_EPOLL)
+        epoll_event events[MAX_EVENTS_PER_WAIT];
+        int count = epoll_wait(poller, events, MAX_EVENTS_PER_WAIT, timeoutMs);
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == wakeRead) {
+                drainWake();
+            } else {
+                int fd = events[i].data.fd;
+                ready.emplace_back(fd, fromNative(events[i].events));
+            }
+        }
+#elif defined(XENOCOMM_REACTOR_KQUEUE)
+        struct kevent events[MAX_EVENTS_PER_WAIT];
+        timespec timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000000L};
+        int count = kevent(poller, nullptr, 0, events, MAX_EVENTS_PER_WAIT, timeoutMs < 0 ? nullptr : &timeout);
+        for (int i = 0; i < count; ++i) {
+            int fd = static_cast<int>(events[i].ident);
+            if (fd == wakeRead) {
+                drainWake();
+                continue;
+            }
+            uint32_t flags = events[i].filter == EVFILT_WRITE ? WRITABLE : READABLE;
+            if (events[i].flags & EV_EOF) flags |= CLOSED;
+            if (events[i].flags & EV_ERROR) flags |= FAILED;
+            ready.emplace_back(fd, flags);
+        }
+#else
+        std::vector<PollFd> fds;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fds.reserve(handlers.size() + 1);
+            for (const auto& entry : handlers) {
+                PollFd pfd{};
+                pfd.fd = entry.first;
+                pfd.events = toNative(entry.second->events);
+                fds.push_back(pfd);
+            }
+        }
+        if (wakeRead >= 0) {
+            PollFd pfd{};
+            pfd.fd = wakeRead;
+            pfd.events = POLLIN;
+            fds.push_back(pfd);
+        } else if (timeoutMs < 0 || timeoutMs > TIMER_RESOLUTION.count()) {
+            timeoutMs = static_cast<int>(TIMER_RESOLUTION.count());
+        }
+        if (pollFds(fds.data(), fds.size(), timeoutMs) <= 0) {
+            return;
+        }
+        for (const auto& pfd : fds) {
+            if (pfd.revents == 0) {
+                continue;
+            }
+            if (static_cast<int>(pfd.fd) == wakeRead) {
+                drainWake();
+            } else {
+                ready.emplace_back(static_cast<int>(pfd.fd), fromNative(pfd.revents));
+            }
+        }
+#endif
+    }
+};
+
+EventReactor::EventReactor(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    loops_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        auto loop = std::make_unique<Loop>();
+        if (!loop->open()) {
+            loop->close();
+        }
+        loops_.push_back(std::move(loop));
+    }
+    for (auto& loop : loops_) {
+        Loop* raw = loop.get();
+        raw->thread = std::thread([this, raw]() { run(*raw); });
+    }
+}
+
+EventReactor::~EventReactor() {
+    stopping_ = true;
+    for (auto& loop : loops_) {
+        loop->wake();
+    }
+    for (auto& loop : loops_) {
+        if (loop->thread.joinable()) {
+            if (loop->onThisThread()) {
+                loop->thread.detach();
+            } else {
+                loop->thread.join();
+            }
+        }
+        loop->close();
+    }
+}
+
+EventReactor& EventReactor::shared() {
+    static EventReactor reactor(std::min<size_t>(std::max(std::thread::hardware_concurrency() / 2, 1u), 4));
+    return reactor;
+}
+
+bool EventReactor::isValid() const {
+    for (const auto& loop : loops_) {
+#ifdef XENOCOMM_REACTOR_POLL
+        (void)loop;
+#else
+        if (loop->poller < 0) {
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+EventReactor::Loop& EventReactor::loopForFd(int fd) const {
+    return *loops_[static_cast<size_t>(fd) % loops_.size()];
+}
+
+EventReactor::Loop& EventReactor::loopForTimer(TimerId id) const {
+    return *loops_[id % loops_.size()];
+}
+
+bool EventReactor::add(int fd, uint32_t events, EventCallback callback) {
+    if (fd < 0 || !callback) {
+        return false;
+    }
+    Loop& loop = loopForFd(fd);
+    auto handler = std::make_shared<Handler>();
+    handler->callback = std::move(callback);
+    handler->events = events & (READABLE | WRITABLE);
+
+    std::lock_guard<std::mutex> lock(loop.mutex);
+    if (loop.handlers.count(fd) || !loop.registerFd(fd, handler->events, true)) {
+        return false;
+    }
+    loop.handlers.emplace(fd, std::move(handler));
+#ifdef XENOCOMM_REACTOR_POLL
+    loop.wake();  // Rebuild the poll set
+#endif
+    return true;
+}
+
+bool EventReactor::modify(int fd, uint32_t events) {
+    Loop& loop = loopForFd(fd);
+    std::lock_guard<std::mutex> lock(loop.mutex);
+    auto it = loop.handlers.find(fd);
+    if (it == loop.handlers.end()) {
+        return false;
+    }
+    events &= (READABLE | WRITABLE);
+    if (!loop.registerFd(fd, events, false)) {
+        return false;
+    }
+    it->second->events = events;
+#ifdef XENOCOMM_REACTOR_POLL
+    loop.wake();
+#endif
+    return true;
+}
+
+bool EventReactor::remove(int fd) {
+    Loop& loop = loopForFd(fd);
+    std::shared_ptr<Handler> handler;
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        auto it = loop.handlers.find(fd);
+        if (it == loop.handlers.end()) {
+            return false;
+        }
+        handler = std::move(it->second);
+        loop.handlers.erase(it);
+        loop.unregisterFd(fd, handler->events);
+    }
+#ifdef XENOCOMM_REACTOR_POLL
+    loop.wake();
+#endif
+    deactivate(*handler, loop.onThisThread());
+    return true;
+}
+
+EventReactor::TimerId EventReactor::addTimer(std::chrono::milliseconds delay, std::chrono::milliseconds interval,
+                                             TimerCallback callback) {
+    if (!callback) {
+        return 0;
+    }
+    TimerId id = nextTimerId_.fetch_add(1);
+    auto timer = std::make_shared<Timer>();
+    timer->callback = std::move(callback);
+    timer->interval = interval;
+
+    Loop& loop = loopForTimer(id);
+    bool wasIdle;
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        wasIdle = loop.timers.empty();
+        loop.timers.emplace(id, std::move(timer));
+        loop.wheel.schedule(id, Clock::now() + delay);
+    }
+    if (wasIdle) {
+        loop.wake();  // The loop may be sleeping without a timeout
+    }
+    return id;
+}
+
+EventReactor::TimerId EventReactor::scheduleAfter(std::chrono::milliseconds delay, TimerCallback callback) {
+    return addTimer(delay, std::chrono::milliseconds(0), std::move(callback));
+}
+
+EventReactor::TimerId EventReactor::scheduleEvery(std::chrono::milliseconds interval, TimerCallback callback) {
+    interval = std::max(interval, std::chrono::milliseconds(1));
+    return addTimer(interval, interval, std::move(callback));
+}
+
+void EventReactor::cancelTimer(TimerId id) {
+    if (id == 0) {
+        return;
+    }
+    Loop& loop = loopForTimer(id);
+    std::shared_ptr<Timer> timer;
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        auto it = loop.timers.find(id);
+        if (it == loop.timers.end()) {
+            return;
+        }
+        // The wheel entry is cancelled lazily: run() ignores ids no longer in timers
+        timer = std::move(it->second);
+        loop.timers.erase(it);
+    }
+    deactivate(*timer, loop.onThisThread());
+}
+
+void EventReactor::post(std::function<void()> task) {
+    if (!task) {
+        return;
+    }
+    Loop& loop = *loops_[nextPostLoop_.fetch_add(1) % loops_.size()];
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        loop.tasks.push_back(std::move(task));
+    }
+    loop.wake();
+}
+
+bool EventReactor::inLoopThread() const {
+    for (const auto& loop : loops_) {
+        if (loop->onThisThread()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t EventReactor::watchedCount() const {
+    size_t count = 0;
+    for (const auto& loop : loops_) {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        count += loop->handlers.size();
+    }
+    return count;
+}
+
+void EventReactor::run(Loop& loop) {
+    loop.threadId = std::this_thread::get_id();
+    std::vector<std::pair<int, uint32_t>> ready;
+    std::vector<std::function<void()>> tasks;
+    std::vector<std::shared_ptr<Timer>> dueTimers;
+
+    while (!stopping_) {
+        int timeoutMs;
+        {
+            std::lock_guard<std::mutex> lock(loop.mutex);
+            timeoutMs = !loop.tasks.empty() ? 0
+                      : loop.timers.empty() ? -1
+                      : static_cast<int>(TIMER_RESOLUTION.count());
+        }
+        if (loop.poller < 0 && loop.wakeRead < 0) {
+#ifndef _WIN32
+            // Poller creation failed; keep servicing timers and tasks
+            std::this_thread::sleep_for(TIMER_RESOLUTION);
+            timeoutMs = 0;
+#endif
+        }
+
+        loop.wait(timeoutMs, ready);
+        if (stopping_) {
+            break;
+        }
+
+        for (const auto& event : ready) {
+            std::shared_ptr<Handler> handler;
+            {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                auto it = loop.handlers.find(event.first);
+                if (it == loop.handlers.end()) {
+                    continue;
+                }
+                handler = it->second;
+            }
+            std::lock_guard<std::mutex> running(handler->running);
+            if (handler->active) {
+                handler->callback(event.first, event.second);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(loop.mutex);
+            auto now = Clock::now();
+            for (TimerId id : loop.wheel.expire(now)) {
+                auto it = loop.timers.find(id);
+                if (it == loop.timers.end()) {
+                    continue;
+                }
+                dueTimers.push_back(it->second);
+                if (it->second->interval.count() > 0) {
+                    loop.wheel.schedule(id, now + it->second->interval);
+                } else {
+                    loop.timers.erase(it);
+                }
+            }
+            tasks.swap(loop.tasks);
+        }
+
+        for (auto& timer : dueTimers) {
+            std::lock_guard<std::mutex> running(timer->running);
+            if (timer->active) {
+                timer->callback();
+            }
+        }
+        dueTimers.clear();
+
+        for (auto& task : tasks) {
+            task();
+        }
+        tasks.clear();
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -1,18 +1,13 @@
 #include "xenocomm/core/feedback_integration.h"
 #include "xenocomm/core/error_correction_mode.h"
-#include <thread>
+#include "xenocomm/utils/logging.hpp"
 #include <chrono>
 #include <stdexcept>
 #include <string>
 #include <cmath>
-#include <iostream>
 
 namespace xenocomm {
 
-// Simple logging implementation
-#define LOG_INFO(msg) std::cout << "[INFO] " << msg << std::endl
-#define LOG_ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl
-
 namespace {
     double calculate_change(double current, double previous) {
         if (previous == 0) return 0;
@@ -28,6 +23,10 @@ namespace {
 
 // Constructor is already defined in the header file
 
+FeedbackIntegration::~FeedbackIntegration() {
+    stop();
+}
+
 Result<void> FeedbackIntegration::start() {
     if (running_) {
         return Result<void>("FeedbackIntegration already running");
@@ -42,16 +41,14 @@ Result<void> FeedbackIntegration::start() {
 
         running_ = true;
 
-        // Start update thread if auto-updates are enabled
+        // Schedule periodic updates if auto-updates are enabled
         if (config_.enable_auto_updates) {
-            update_thread_ = std::make_unique<std::thread>([this]() {
-                while (running_) {
-                    std::this_thread::sleep_for(config_.strategy_update_interval);
-                    if (running_) {  // Check again after sleep
+            update_task_ = utils::TaskScheduler::shared().scheduleEvery(
+                config_.strategy_update_interval, [this]() {
+                    if (running_) {
                         analyze_and_update_strategy();
                     }
-                }
-            });
+                });
         }
 
         return Result<void>();
@@ -63,9 +60,10 @@ Result<void> FeedbackIntegration::start() {
 
 void FeedbackIntegration::stop() {
     running_ = false;
-    
-    if (update_thread_ && update_thread_->joinable()) {
-        update_thread_->join();
+
+    if (update_task_ != utils::TaskScheduler::INVALID_TASK) {
+        utils::TaskScheduler::shared().cancel(update_task_);
+        update_task_ = utils::TaskScheduler::INVALID_TASK;
     }
 }
 
@@ -130,7 +128,7 @@ void FeedbackIntegration::analyze_and_update_strategy() {
         // Get detailed metrics from FeedbackLoop
         auto metrics_result = feedback_loop_.getDetailedMetrics();
         if (metrics_result.has_error()) {
-            LOG_ERROR("Failed to get detailed metrics: " + metrics_result.error());
+            XLOG_ERROR("Failed to get detailed metrics: {}", metrics_result.error());
             return;
         }
 
@@ -176,7 +174,7 @@ void FeedbackIntegration::analyze_and_update_strategy() {
         }
 
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to analyze and update strategy: " + std::string(e.what()));
+        XLOG_ERROR("Failed to analyze and update strategy: {}", e.what());
     }
 }
 
@@ -272,7 +270,7 @@ void FeedbackIntegration::apply_recommendation(const StrategyRecommendation& rec
     // Update last update time
     last_update_ = std::chrono::steady_clock::now();
     
-    LOG_INFO("Applied new transmission strategy: " + recommendation.explanation);
+    XLOG_INFO("Applied new transmission strategy: {}", recommendation.explanation);
 }
 
 } // namespace xenocomm 
\ No newline at end of file
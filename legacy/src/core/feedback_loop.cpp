@@ -1,53 +1,177 @@
 // #include "xenocomm/utils/logging.h"
 #include "xenocomm/core/feedback_loop.h"
+#include "xenocomm/core/outcome_segment_store.h"
+#include "xenocomm/utils/contention_profile.hpp"
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include "xenocomm/utils/quantile_sketch.hpp"
 #include "feedback_data.pb.h"
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <complex>
+#include <condition_variable>
 #include <deque>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
 #include <numeric>
-#include <zlib.h>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace xenocomm {
 
 namespace {
     constexpr uint32_t CURRENT_VERSION = 1;
     constexpr size_t CHUNK_SIZE = 16384;  // 16KB chunks for compression
+    constexpr size_t INGEST_SHARDS = 8;   // Rings reporting threads are spread over
+    constexpr const char* MAIN_DATA_FILE = "feedback_main.dat";    // Metrics; outcomes live in segments
+    constexpr const char* LEGACY_DATA_FILE = "feedback_data.pb";   // Metrics and outcomes in one message
+    constexpr const char* SEGMENT_DIRECTORY = "segments";
+
+    // A reported outcome as it waits in an ingestion ring
+    struct OutcomeRecord {
+        std::chrono::system_clock::rep timestamp;
+        std::chrono::microseconds::rep latency;
+        uint32_t bytesTransferred;
+        uint32_t retryCount;
+        uint32_t errorCount;
+        uint32_t errorType;  // Index into Impl::errorTypes; 0 is no error type
+        uint32_t labelSet;   // Index into Impl::labelSets; 0 is unlabeled
+        bool success;
+    };
 
-    // Helper function to compress data using zlib
-    std::vector<uint8_t> compressData(const std::vector<uint8_t>& input) {
-        std::vector<uint8_t> output;
-        output.resize(compressBound(input.size()));
-        
-        uLongf destLen = output.size();
-        int result = compress2(output.data(), &destLen,
-                             input.data(), input.size(),
-                             Z_BEST_COMPRESSION);
-        
-        if (result != Z_OK) {
-            throw std::runtime_error("Data compression failed");
+    // Spreads reporting threads round-robin over the ingestion rings
+    size_t ingestShard() {
+        static std::atomic<size_t> nextShard{0};
+        thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % INGEST_SHARDS;
+        return shard;
+    }
+
+    // In-place radix-2 FFT; the size must be a power of two. The inverse is left unscaled.
+    void fft(std::vector<std::complex<double>>& data, bool inverse) {
+        const size_t n = data.size();
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(data[i], data[j]);
+            }
+        }
+        const double turn = (inverse ? 2.0 : -2.0) * std::acos(-1.0) / static_cast<double>(n);
+        std::vector<std::complex<double>> twiddles(n / 2);
+        for (size_t k = 0; k < twiddles.size(); ++k) {
+            twiddles[k] = std::polar(1.0, turn * static_cast<double>(k));
+        }
+        for (size_t half = 1, stride = n / 2; half < n; half <<= 1, stride >>= 1) {
+            for (size_t start = 0; start < n; start += 2 * half) {
+                for (size_t k = 0; k < half; ++k) {
+                    auto odd = data[start + half + k] * twiddles[k * stride];
+                    data[start + half + k] = data[start + k] - odd;
+                    data[start + k] += odd;
+                }
+            }
         }
-        
-        output.resize(destLen);
-        return output;
     }
 
-    // Helper function to decompress data using zlib
-    std::vector<uint8_t> decompressData(const std::vector<uint8_t>& input, size_t originalSize) {
-        std::vector<uint8_t> output;
-        output.resize(originalSize);
-        
-        uLongf destLen = output.size();
-        int result = uncompress(output.data(), &destLen,
-                              input.data(), input.size());
-        
-        if (result != Z_OK) {
-            throw std::runtime_error("Data decompression failed");
+    // Strongest periodic pattern in residuals: the highest peak of their autocorrelation past lag 1,
+    // found for every lag at once through the power spectrum
+    double seasonalityOf(const std::vector<double>& residuals) {
+        const size_t n = residuals.size();
+        if (n < 4) {
+            return 0.0;
         }
-        
-        return output;
+        size_t size = 1;
+        while (size < 2 * n) {
+            size <<= 1;  // Zero padding keeps the correlation from wrapping around
+        }
+        std::vector<std::complex<double>> spectrum(size);
+        std::copy(residuals.begin(), residuals.end(), spectrum.begin());
+        fft(spectrum, false);
+        for (auto& bin : spectrum) {
+            bin = std::norm(bin);
+        }
+        fft(spectrum, true);
+
+        const double energy = spectrum[0].real();
+        if (energy <= 0) {
+            return 0.0;
+        }
+        double strongest = 0.0;
+        for (size_t lag = 2; lag + 1 <= n / 2; ++lag) {
+            double r = spectrum[lag].real();
+            if (r > spectrum[lag - 1].real() && r >= spectrum[lag + 1].real()) {
+                strongest = std::max(strongest, r / energy);
+            }
+        }
+        return std::min(strongest, 1.0);
+    }
+
+    // Trend, autocorrelation and seasonality of values sampled at times, both in time order
+    TimeSeriesAnalysis analyzeSeries(const std::vector<double>& times, const std::vector<double>& values,
+                                     uint32_t forecastHorizon) {
+        TimeSeriesAnalysis analysis{};
+        const size_t n = values.size();
+        if (n < 2) {
+            return analysis;
+        }
+
+        // Least squares fit in one pass over running means and co-moments, which
+        // stay accurate where the raw sums of squares would cancel
+        double meanT = 0, meanY = 0, varianceT = 0, covariance = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const double weight = 1.0 / static_cast<double>(i + 1);
+            const double dt = times[i] - meanT;
+            meanT += dt * weight;
+            meanY += (values[i] - meanY) * weight;
+            varianceT += dt * (times[i] - meanT);
+            covariance += dt * (values[i] - meanY);
+        }
+        analysis.trendSlope = varianceT > 0 ? covariance / varianceT : 0.0;
+
+        // Lag-1 autocorrelation, and the residuals of the fit for seasonality
+        std::vector<double> residuals(n);
+        double energy = 0, lagged = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const double centered = values[i] - meanY;
+            energy += centered * centered;
+            lagged += i > 0 ? centered * (values[i - 1] - meanY) : 0.0;
+            residuals[i] = centered - analysis.trendSlope * (times[i] - meanT);
+        }
+        analysis.autocorrelation = energy > 0 ? lagged / energy : 0.0;
+        analysis.seasonalityStrength = seasonalityOf(residuals);
+
+        // Determine stationarity (simple test based on trend strength)
+        analysis.isStationary = std::abs(analysis.trendSlope) < 0.1;
+
+        // Simple forecast using linear trend
+        analysis.forecast.resize(forecastHorizon);
+        for (uint32_t i = 0; i < forecastHorizon; ++i) {
+            analysis.forecast[i] = values.back() + analysis.trendSlope * (i + 1);
+        }
+        return analysis;
+    }
+
+    // Whether bytes open a zlib stream: 32K window, header check bits a multiple of 31
+    bool isZlibHeader(unsigned char first, unsigned char second) {
+        return first == 0x78 && ((first << 8) | second) % 31 == 0;
+    }
+
+    // Writes message as a length-delimited field, as it would be serialized inside its parent
+    template <typename Message>
+    void writeField(google::protobuf::io::CodedOutputStream& out, int fieldNumber, const Message& message) {
+        constexpr uint32_t LENGTH_DELIMITED = 2;
+        out.WriteTag((static_cast<uint32_t>(fieldNumber) << 3) | LENGTH_DELIMITED);
+        out.WriteVarint32(static_cast<uint32_t>(message.ByteSizeLong()));
+        message.SerializeWithCachedSizes(&out);
     }
 
     // Convert system_clock::time_point to Timestamp proto
@@ -69,9 +193,8 @@ namespace {
         return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(duration));
     }
 
-    // Convert CommunicationOutcome to proto
-    CommunicationOutcomeProto outcomeToProto(const CommunicationOutcome& outcome) {
-        CommunicationOutcomeProto proto;
+    // Convert CommunicationOutcome to proto. Sets every field, so proto can be reused without Clear()
+    void outcomeToProto(const CommunicationOutcome& outcome, CommunicationOutcomeProto& proto) {
         proto.set_success(outcome.success);
         proto.set_latency_micros(outcome.latency.count());
         proto.set_bytes_transferred(outcome.bytesTransferred);
@@ -79,7 +202,6 @@ namespace {
         proto.set_error_count(outcome.errorCount);
         proto.set_error_type(outcome.errorType);
         *proto.mutable_timestamp() = timePointToProto(outcome.timestamp);
-        return proto;
     }
 
     // Convert proto to CommunicationOutcome
@@ -96,216 +218,536 @@ namespace {
     }
 }
 
+bool OutcomeLabels::operator==(const OutcomeLabels& other) const {
+    return peerId == other.peerId && transport == other.transport &&
+           dataFormat == other.dataFormat && compression == other.compression;
+}
+
+bool OutcomeLabels::matches(const OutcomeLabels& labels) const {
+    auto fieldMatches = [](const std::string& wanted, const std::string& value) {
+        return wanted.empty() || wanted == value;
+    };
+    return fieldMatches(peerId, labels.peerId) && fieldMatches(transport, labels.transport) &&
+           fieldMatches(dataFormat, labels.dataFormat) && fieldMatches(compression, labels.compression);
+}
+
 struct FeedbackLoop::Impl {
     FeedbackLoopConfig config;
     std::deque<CommunicationOutcome> outcomes;
     std::map<std::string, std::deque<std::pair<std::chrono::system_clock::time_point, double>>> metrics;
-    mutable std::mutex mutex;
+    mutable utils::ProfiledMutex<> mutex{"feedback_loop"};
+
+    // Distributions over outcomes, kept in step with it as outcomes enter and leave
+    utils::QuantileSketch latencySketch;     // Microseconds
+    utils::QuantileSketch throughputSketch;  // Bytes per second, outcomes with nonzero latency
+    utils::QuantileSketch retrySketch;
+
+    // Changes whenever outcomes or config do; the analyses below are cached against it
+    uint64_t generation = 0;
+    uint64_t detailedGeneration = UINT64_MAX;
+    DetailedMetrics detailedMetrics;
+    uint64_t latencyTrendGeneration = UINT64_MAX;
+    TimeSeriesAnalysis latencyTrend;
+    std::vector<std::pair<uint64_t, WindowListener>> windowListeners;
+    uint64_t nextSubscription = 1;
+    uint64_t notifiedGeneration = 0;
+
+    // Running sums of the outcomes stamped within one second
+    struct SecondBucket {
+        int64_t second = -1;  // Seconds since the epoch; -1 when unused
+        uint32_t count = 0;
+        uint32_t successes = 0;
+        uint64_t errors = 0;
+        uint64_t bytes = 0;
+        int64_t latencyMicros = 0;
+        std::chrono::system_clock::time_point first;
+        std::chrono::system_clock::time_point last;
+    };
+    // Ring indexed by second, spanning metricsWindowSize. Holds the stored outcomes, except
+    // any more than a window older than the newest, which the next prune drops anyway
+    std::vector<SecondBucket> secondBuckets;
+
+    // Outcomes reported but not yet aggregated; whoever holds mutex consumes them
+    std::array<std::unique_ptr<utils::MpscRing<OutcomeRecord>>, INGEST_SHARDS> ingestRings;
+    std::vector<OutcomeRecord> drained;  // Reused by drainIngested()
+    std::shared_mutex errorTypesMutex;
+    std::unordered_map<std::string, uint32_t> errorTypeIds;
+    std::vector<std::string> errorTypes{""};
+    std::unordered_map<std::string, uint32_t> labelSetIds;  // Keyed by labelSetKey(); under errorTypesMutex
+    std::vector<OutcomeLabels> labelSets{OutcomeLabels{}};
+    const uint32_t labelSetLimit;  // config.maxLabelSets at construction
+    // Seconds with labeled outcomes in the window, oldest first, per label set
+    std::vector<std::deque<SecondBucket>> labeledBuckets;
+    // Persisted history, when persistence is enabled, and the outcomes not yet in it
+    std::unique_ptr<OutcomeSegmentStore> segmentStore;
+    std::deque<CommunicationOutcome> unsaved;
+    std::mutex saveMutex;  // Serializes saves; taken before mutex
+
+    std::condition_variable_any aggregatorWake;  // Waits on mutex whether or not it is profiled
+    bool stopping = false;
+    std::thread aggregator;
+
+    explicit Impl(const FeedbackLoopConfig& initialConfig)
+        : config(initialConfig), labelSetLimit(initialConfig.maxLabelSets) {
+        secondBuckets.resize(bucketCount());
+        for (auto& ring : ingestRings) {
+            ring = std::make_unique<utils::MpscRing<OutcomeRecord>>(config.ingestQueueCapacity);
+        }
+        aggregator = std::thread([this] {
+            std::unique_lock<utils::ProfiledMutex<>> lock(mutex);
+            while (!stopping) {
+                aggregatorWake.wait_for(lock, config.ingestFlushInterval);
+                drainIngested();
+            }
+        });
+    }
 
-    // New persistence-related members
-    std::chrono::system_clock::time_point lastBackupTime;
-    std::string currentDataFile;
-    TimeIndex timeIndex;
+    ~Impl() {
+        {
+            std::lock_guard<utils::ProfiledMutex<>> lock(mutex);
+            stopping = true;
+        }
+        aggregatorWake.notify_one();
+        aggregator.join();
+    }
 
-    void pruneOldData() {
-        auto now = std::chrono::system_clock::now();
-        auto cutoff = now - config.metricsWindowSize;
+    uint32_t internErrorType(const std::string& errorType) {
+        if (errorType.empty()) {
+            return 0;
+        }
+        {
+            std::shared_lock<std::shared_mutex> lock(errorTypesMutex);
+            auto it = errorTypeIds.find(errorType);
+            if (it != errorTypeIds.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(errorTypesMutex);
+        auto [it, inserted] = errorTypeIds.emplace(errorType, static_cast<uint32_t>(errorTypes.size()));
+        if (inserted) {
+            errorTypes.push_back(errorType);
+        }
+        return it->second;
+    }
 
-        // Prune outcomes
-        while (!outcomes.empty() && outcomes.front().timestamp < cutoff) {
-            outcomes.pop_front();
+    static std::string labelSetKey(const OutcomeLabels& labels) {
+        std::string key;
+        for (const auto* field : {&labels.peerId, &labels.transport, &labels.dataFormat, &labels.compression}) {
+            key += *field;
+            key += '\x1f';
         }
+        return key;
+    }
 
-        // Prune metrics
-        for (auto& [name, values] : metrics) {
-            while (!values.empty() && values.front().first < cutoff) {
-                values.pop_front();
+    uint32_t internLabelSet(const OutcomeLabels& labels) {
+        if (labels == OutcomeLabels{}) {
+            return 0;
+        }
+        auto key = labelSetKey(labels);
+        {
+            std::shared_lock<std::shared_mutex> lock(errorTypesMutex);
+            auto it = labelSetIds.find(key);
+            if (it != labelSetIds.end()) {
+                return it->second;
             }
         }
-
-        // Enforce maximum storage limit
-        if (outcomes.size() > config.maxStoredOutcomes) {
-            outcomes.erase(outcomes.begin(), 
-                         outcomes.begin() + (outcomes.size() - config.maxStoredOutcomes));
+        std::unique_lock<std::shared_mutex> lock(errorTypesMutex);
+        auto it = labelSetIds.find(key);
+        if (it != labelSetIds.end()) {
+            return it->second;
         }
+        if (labelSetIds.size() >= labelSetLimit) {
+            // Past the limit, new sets are counted together; the overflow set itself is always admitted
+            static const OutcomeLabels overflow{OVERFLOW_LABEL, OVERFLOW_LABEL, OVERFLOW_LABEL, OVERFLOW_LABEL};
+            key = labelSetKey(overflow);
+            it = labelSetIds.find(key);
+            if (it != labelSetIds.end()) {
+                return it->second;
+            }
+            labelSets.push_back(overflow);
+        } else {
+            labelSets.push_back(labels);
+        }
+        auto id = static_cast<uint32_t>(labelSets.size() - 1);
+        labelSetIds.emplace(std::move(key), id);
+        return id;
     }
 
-    MetricsSummary calculateMetrics(const std::vector<CommunicationOutcome>& windowOutcomes) const {
-        MetricsSummary summary{};
-        if (windowOutcomes.empty()) {
-            return summary;
+    void ingest(const OutcomeRecord& record) {
+        auto& ring = *ingestRings[ingestShard()];
+        if (ring.try_push(record)) {
+            return;
         }
+        // Full: aggregate everything so far, which frees the ring for this record
+        std::lock_guard<utils::ProfiledMutex<>> lock(mutex);
+        do {
+            drainIngested();
+        } while (!ring.try_push(record));
+    }
 
-        summary.windowStart = windowOutcomes.front().timestamp;
-        summary.windowEnd = windowOutcomes.back().timestamp;
-        summary.totalTransactions = windowOutcomes.size();
+    void keepUnsaved(const CommunicationOutcome& outcome) {
+        if (!segmentStore) {
+            return;
+        }
+        unsaved.push_back(outcome);
+        if (unsaved.size() > config.maxStoredOutcomes) {
+            unsaved.pop_front();  // Also gone from memory by now
+        }
+    }
 
-        // Calculate metrics
-        uint32_t successCount = 0;
-        uint32_t errorCount = 0;
-        double totalLatency = 0;
-        uint64_t totalBytes = 0;
+    // Tells listeners about a generation they have not seen yet. Requires mutex.
+    void notifyWindowListeners() {
+        if (notifiedGeneration == generation) {
+            return;
+        }
+        notifiedGeneration = generation;
+        for (const auto& [subscription, listener] : windowListeners) {
+            listener(generation);
+        }
+    }
 
-        for (const auto& outcome : windowOutcomes) {
-            if (outcome.success) {
-                successCount++;
+    // Moves ingested outcomes into outcomes in timestamp order. Requires mutex.
+    void drainIngested() {
+        drained.clear();
+        OutcomeRecord record;
+        for (auto& ring : ingestRings) {
+            while (ring->try_pop(record)) {
+                drained.push_back(record);
+            }
+        }
+        if (drained.empty()) {
+            notifyWindowListeners();  // For changes made other than by ingestion
+            return;
+        }
+        std::stable_sort(drained.begin(), drained.end(), [](const OutcomeRecord& a, const OutcomeRecord& b) {
+            return a.timestamp < b.timestamp;
+        });
+
+        std::shared_lock<std::shared_mutex> lock(errorTypesMutex);
+        auto toOutcome = [this](const OutcomeRecord& r) {
+            return CommunicationOutcome{
+                r.success,
+                std::chrono::microseconds(r.latency),
+                r.bytesTransferred,
+                r.retryCount,
+                r.errorCount,
+                errorTypes[r.errorType],
+                std::chrono::system_clock::time_point(std::chrono::system_clock::duration(r.timestamp))
+            };
+        };
+        const auto firstTimestamp = std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(drained.front().timestamp));
+        if (outcomes.empty() || outcomes.back().timestamp <= firstTimestamp) {
+            for (const auto& r : drained) {
+                outcomes.push_back(toOutcome(r));
+                account(outcomes.back(), true);
+                accountLabeled(r.labelSet, outcomes.back());
+                keepUnsaved(outcomes.back());
+            }
+        } else {
+            // Rings are drained one after another, so merge with what is already stored
+            std::deque<CommunicationOutcome> merged;
+            auto stored = outcomes.begin();
+            for (const auto& r : drained) {
+                auto outcome = toOutcome(r);
+                account(outcome, true);
+                accountLabeled(r.labelSet, outcome);
+                keepUnsaved(outcome);
+                while (stored != outcomes.end() && stored->timestamp <= outcome.timestamp) {
+                    merged.push_back(std::move(*stored++));
+                }
+                merged.push_back(std::move(outcome));
             }
-            errorCount += outcome.errorCount;
-            totalLatency += outcome.latency.count();
-            totalBytes += outcome.bytesTransferred;
+            std::move(stored, outcomes.end(), std::back_inserter(merged));
+            outcomes.swap(merged);
         }
+        lock.unlock();
+        pruneOldData();
+        notifyWindowListeners();
+    }
 
-        summary.successRate = static_cast<double>(successCount) / windowOutcomes.size();
-        summary.averageLatency = totalLatency / windowOutcomes.size();
-        
-        // Calculate throughput (bytes per second)
-        auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-            summary.windowEnd - summary.windowStart).count();
-        summary.throughputBytesPerSecond = duration > 0 ? 
-            static_cast<double>(totalBytes) / duration : 0;
+    // New persistence-related members
+    std::chrono::system_clock::time_point lastBackupTime;
+    std::string currentDataFile;
+    TimeIndex timeIndex;
 
-        summary.errorRate = static_cast<double>(errorCount) / windowOutcomes.size();
+    size_t bucketCount() const {
+        // One more for the partial second at either end of the window
+        return static_cast<size_t>(std::max<std::chrono::seconds::rep>(config.metricsWindowSize.count(), 0)) + 2;
+    }
 
-        return summary;
+    static int64_t secondOf(std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
     }
 
-    DistributionStats calculateDistributionStats(const std::vector<double>& values) const {
-        if (values.empty()) {
-            return DistributionStats{};
+    void accountBucket(const CommunicationOutcome& outcome, bool entering) {
+        int64_t second = secondOf(outcome.timestamp);
+        if (second < 0) {
+            return;
         }
+        auto& bucket = secondBuckets[static_cast<size_t>(second) % secondBuckets.size()];
+        if (!entering) {
+            if (bucket.second != second || bucket.count == 0) {
+                return;  // Never counted: it was older than the window when it arrived
+            }
+            if (--bucket.count == 0) {
+                bucket = SecondBucket{};
+                return;
+            }
+            bucket.successes -= outcome.success ? 1 : 0;
+            bucket.errors -= outcome.errorCount;
+            bucket.bytes -= outcome.bytesTransferred;
+            bucket.latencyMicros -= outcome.latency.count();
+            return;
+        }
+        if (bucket.second > second) {
+            return;  // The ring has moved a whole window past it
+        }
+        if (bucket.second < second) {
+            bucket = SecondBucket{};
+            bucket.second = second;
+            bucket.first = outcome.timestamp;
+            bucket.last = outcome.timestamp;
+        }
+        addToBucket(bucket, outcome);
+    }
 
-        std::vector<double> sortedValues = values;
-        std::sort(sortedValues.begin(), sortedValues.end());
-
-        double sum = std::accumulate(values.begin(), values.end(), 0.0);
-        double mean = sum / values.size();
+    void account(const CommunicationOutcome& outcome, bool entering) {
+        ++generation;
+        accountBucket(outcome, entering);
+        auto latency = static_cast<double>(outcome.latency.count());
+        auto retries = static_cast<double>(outcome.retryCount);
+        if (entering) {
+            latencySketch.add(latency);
+            retrySketch.add(retries);
+        } else {
+            latencySketch.remove(latency);
+            retrySketch.remove(retries);
+        }
+        if (outcome.latency.count() > 0) {
+            double throughput = outcome.bytesTransferred / (latency / 1e6);
+            if (entering) {
+                throughputSketch.add(throughput);
+            } else {
+                throughputSketch.remove(throughput);
+            }
+        }
+    }
 
-        double sqSum = std::accumulate(values.begin(), values.end(), 0.0,
-            [mean](double acc, double val) {
-                double diff = val - mean;
-                return acc + (diff * diff);
-            });
+    static void addToBucket(SecondBucket& bucket, const CommunicationOutcome& outcome) {
+        ++bucket.count;
+        bucket.successes += outcome.success ? 1 : 0;
+        bucket.errors += outcome.errorCount;
+        bucket.bytes += outcome.bytesTransferred;
+        bucket.latencyMicros += outcome.latency.count();
+        bucket.first = std::min(bucket.first, outcome.timestamp);
+        bucket.last = std::max(bucket.last, outcome.timestamp);
+    }
 
-        size_t size = values.size();
-        size_t p90Idx = static_cast<size_t>(size * 0.90);
-        size_t p95Idx = static_cast<size_t>(size * 0.95);
-        size_t p99Idx = static_cast<size_t>(size * 0.99);
+    void accountLabeled(uint32_t labelSet, const CommunicationOutcome& outcome) {
+        if (labelSet == 0) {
+            return;
+        }
+        if (labelSet >= labeledBuckets.size()) {
+            labeledBuckets.resize(labelSet + 1);
+        }
+        auto& buckets = labeledBuckets[labelSet];
+        const int64_t second = secondOf(outcome.timestamp);
+        // Outcomes arrive nearly in order, so their second is at or close to the back
+        auto it = buckets.end();
+        while (it != buckets.begin() && std::prev(it)->second > second) {
+            --it;
+        }
+        if (it == buckets.begin() || std::prev(it)->second != second) {
+            SecondBucket bucket;
+            bucket.second = second;
+            bucket.first = outcome.timestamp;
+            bucket.last = outcome.timestamp;
+            it = buckets.insert(it, bucket);
+        } else {
+            --it;
+        }
+        addToBucket(*it, outcome);
+    }
 
-        return DistributionStats{
-            sortedValues.front(),                    // min
-            sortedValues.back(),                     // max
-            mean,                                    // mean
-            size % 2 == 0 ?                         // median
-                (sortedValues[size/2 - 1] + sortedValues[size/2]) / 2 :
-                sortedValues[size/2],
-            std::sqrt(sqSum / size),                // standardDeviation
-            sortedValues[p90Idx],                   // percentile90
-            sortedValues[p95Idx],                   // percentile95
-            sortedValues[p99Idx]                    // percentile99
-        };
+    // After outcomes was replaced or filtered wholesale, or the window resized
+    void rebuildAggregates() {
+        ++generation;
+        secondBuckets.assign(bucketCount(), SecondBucket{});
+        latencySketch.clear();
+        throughputSketch.clear();
+        retrySketch.clear();
+        for (const auto& outcome : outcomes) {
+            account(outcome, true);
+        }
     }
 
-    TimeSeriesAnalysis analyzeTimeSeries(const std::vector<std::pair<double, double>>& timeValuePairs) const {
-        TimeSeriesAnalysis analysis{};
-        if (timeValuePairs.size() < 2) {
-            return analysis;
+    void pruneOldData() {
+        auto now = std::chrono::system_clock::now();
+        auto cutoff = now - config.metricsWindowSize;
+
+        // Prune outcomes
+        while (!outcomes.empty() && outcomes.front().timestamp < cutoff) {
+            account(outcomes.front(), false);
+            outcomes.pop_front();
         }
 
-        // Calculate trend (linear regression)
-        double sumX = 0, sumY = 0, sumXY = 0, sumX2 = 0;
-        double n = static_cast<double>(timeValuePairs.size());
+        // Labeled seconds go once their newest outcome is out of the window
+        for (auto& buckets : labeledBuckets) {
+            while (!buckets.empty() && buckets.front().last < cutoff) {
+                buckets.pop_front();
+            }
+        }
 
-        for (const auto& [time, value] : timeValuePairs) {
-            sumX += time;
-            sumY += value;
-            sumXY += time * value;
-            sumX2 += time * time;
+        // Prune metrics
+        for (auto& [name, values] : metrics) {
+            while (!values.empty() && values.front().first < cutoff) {
+                values.pop_front();
+            }
         }
 
-        analysis.trendSlope = (n * sumXY - sumX * sumY) / (n * sumX2 - sumX * sumX);
+        // Enforce maximum storage limit
+        if (outcomes.size() > config.maxStoredOutcomes) {
+            auto excess = outcomes.begin() + (outcomes.size() - config.maxStoredOutcomes);
+            for (auto it = outcomes.begin(); it != excess; ++it) {
+                account(*it, false);
+            }
+            outcomes.erase(outcomes.begin(), excess);
+        }
 
-        // Calculate autocorrelation (lag-1)
-        std::vector<double> values;
-        values.reserve(timeValuePairs.size());
-        for (const auto& [_, value] : timeValuePairs) {
-            values.push_back(value);
+        // Outcomes leave from the front, so the oldest remaining one starts its bucket
+        if (!outcomes.empty()) {
+            auto& bucket = secondBuckets[static_cast<size_t>(std::max<int64_t>(secondOf(outcomes.front().timestamp), 0)) %
+                                         secondBuckets.size()];
+            if (bucket.second == secondOf(outcomes.front().timestamp)) {
+                bucket.first = outcomes.front().timestamp;
+            }
         }
+    }
 
-        double meanY = sumY / n;
-        double numerator = 0, denominator = 0;
+    // Adds up buckets into a MetricsSummary
+    struct BucketTotals {
+        MetricsSummary summary{};
+        uint32_t successCount = 0;
+        uint64_t errorCount = 0;
+        int64_t totalLatency = 0;
+        uint64_t totalBytes = 0;
 
-        for (size_t i = 1; i < values.size(); ++i) {
-            double diff1 = values[i] - meanY;
-            double diff2 = values[i-1] - meanY;
-            numerator += diff1 * diff2;
-            denominator += diff1 * diff1;
+        void add(const SecondBucket& bucket) {
+            if (summary.totalTransactions == 0 || bucket.first < summary.windowStart) {
+                summary.windowStart = bucket.first;
+            }
+            if (summary.totalTransactions == 0 || bucket.last > summary.windowEnd) {
+                summary.windowEnd = bucket.last;
+            }
+            summary.totalTransactions += bucket.count;
+            successCount += bucket.successes;
+            errorCount += bucket.errors;
+            totalLatency += bucket.latencyMicros;
+            totalBytes += bucket.bytes;
         }
 
-        analysis.autocorrelation = denominator != 0 ? numerator / denominator : 0;
+        MetricsSummary finish() const {
+            MetricsSummary result = summary;
+            if (result.totalTransactions == 0) {
+                return result;
+            }
 
-        // Determine stationarity (simple test based on trend strength)
-        analysis.isStationary = std::abs(analysis.trendSlope) < 0.1;
+            result.successRate = static_cast<double>(successCount) / result.totalTransactions;
+            result.averageLatency = static_cast<double>(totalLatency) / result.totalTransactions;
 
-        // Simple forecast using linear trend
-        analysis.forecast.reserve(config.forecastHorizon);
-        double lastTime = timeValuePairs.back().first;
-        double lastValue = timeValuePairs.back().second;
+            // Calculate throughput (bytes per second)
+            auto duration = std::chrono::duration_cast<std::chrono::seconds>(
+                result.windowEnd - result.windowStart).count();
+            result.throughputBytesPerSecond = duration > 0 ?
+                static_cast<double>(totalBytes) / duration : 0;
+
+            result.errorRate = static_cast<double>(errorCount) / result.totalTransactions;
+            return result;
+        }
+    };
 
-        for (uint32_t i = 0; i < config.forecastHorizon; ++i) {
-            double nextValue = lastValue + analysis.trendSlope;
-            analysis.forecast.push_back(nextValue);
-            lastValue = nextValue;
+    // Summary of the buckets from fromSecond on; every stored outcome when fromSecond is 0
+    MetricsSummary summarizeBuckets(int64_t fromSecond = 0) const {
+        BucketTotals totals;
+        for (const auto& bucket : secondBuckets) {
+            if (bucket.count > 0 && bucket.second >= fromSecond) {
+                totals.add(bucket);
+            }
         }
+        return totals.finish();
+    }
 
-        return analysis;
+    // Summary of the labeled outcomes of every label set selector matches
+    MetricsSummary summarizeLabeled(const OutcomeLabels& selector) {
+        std::shared_lock<std::shared_mutex> lock(errorTypesMutex);
+        BucketTotals totals;
+        for (size_t id = 1; id < labeledBuckets.size(); ++id) {
+            if (!selector.matches(labelSets[id])) {
+                continue;
+            }
+            for (const auto& bucket : labeledBuckets[id]) {
+                totals.add(bucket);
+            }
+        }
+        return totals.finish();
+    }
+
+    // scale converts the sketch's unit, e.g. 1e-3 for microseconds to milliseconds
+    DistributionStats distributionStats(const utils::QuantileSketch& sketch, double scale = 1.0) const {
+        if (sketch.empty()) {
+            return DistributionStats{};
+        }
+        return DistributionStats{
+            sketch.min() * scale,
+            sketch.max() * scale,
+            sketch.mean() * scale,
+            sketch.quantile(0.50) * scale,
+            sketch.standardDeviation() * scale,
+            sketch.quantile(0.90) * scale,
+            sketch.quantile(0.95) * scale,
+            sketch.quantile(0.99) * scale
+        };
     }
 
-    DetailedMetrics calculateDetailedMetrics(const std::vector<CommunicationOutcome>& windowOutcomes) const {
+    DetailedMetrics calculateDetailedMetrics(const std::deque<CommunicationOutcome>& windowOutcomes) const {
         DetailedMetrics metrics{};
         if (windowOutcomes.empty()) {
             return metrics;
         }
 
         // Calculate basic metrics
-        metrics.basic = calculateMetrics(windowOutcomes);
+        metrics.basic = summarizeBuckets();
 
-        // Extract latency values
-        std::vector<double> latencies;
-        std::vector<double> throughputs;
-        std::vector<double> retries;
         std::map<std::string, uint32_t> errorTypes;
-        std::vector<std::pair<double, double>> latencyTimeSeries;
-        std::vector<std::pair<double, double>> throughputTimeSeries;
-
-        double baseTime = std::chrono::duration<double>(
-            windowOutcomes.front().timestamp.time_since_epoch()).count();
+        // Series laid out column by column for the analysis kernels
+        std::vector<double> times, latencies, throughputTimes, throughputs;
+        times.reserve(windowOutcomes.size());
+        latencies.reserve(windowOutcomes.size());
+        throughputTimes.reserve(windowOutcomes.size());
+        throughputs.reserve(windowOutcomes.size());
 
+        const auto baseTime = windowOutcomes.front().timestamp;
         for (const auto& outcome : windowOutcomes) {
-            // Latency analysis
+            double timeSinceStart = std::chrono::duration<double>(outcome.timestamp - baseTime).count();
             double latencyMs = outcome.latency.count() / 1000.0;
+            times.push_back(timeSinceStart);
             latencies.push_back(latencyMs);
-
-            // Throughput analysis
-            double timeSinceStart = std::chrono::duration<double>(
-                outcome.timestamp.time_since_epoch()).count() - baseTime;
-            double throughput = outcome.bytesTransferred / (latencyMs / 1000.0);
-            throughputs.push_back(throughput);
+            if (outcome.latency.count() > 0) {
+                throughputTimes.push_back(timeSinceStart);
+                throughputs.push_back(outcome.bytesTransferred / (latencyMs / 1000.0));
+            }
 
             // Error analysis
             if (!outcome.errorType.empty()) {
                 errorTypes[outcome.errorType]++;
             }
-            retries.push_back(static_cast<double>(outcome.retryCount));
-
-            // Time series data
-            latencyTimeSeries.emplace_back(timeSinceStart, latencyMs);
-            throughputTimeSeries.emplace_back(timeSinceStart, throughput);
         }
 
         // Calculate distribution statistics
-        metrics.latencyStats = calculateDistributionStats(latencies);
-        metrics.throughputStats = calculateDistributionStats(throughputs);
-        metrics.retryStats = calculateDistributionStats(retries);
+        metrics.latencyStats = distributionStats(latencySketch, 1e-3);  // Milliseconds
+        metrics.throughputStats = distributionStats(throughputSketch);
+        metrics.retryStats = distributionStats(retrySketch);
         metrics.errorTypeFrequency = std::move(errorTypes);
 
         // Calculate peak and sustained throughput
@@ -313,91 +755,107 @@ struct FeedbackLoop::Impl {
         metrics.sustainedThroughput = metrics.throughputStats.percentile90;
 
         // Time series analysis
-        metrics.latencyTrend = analyzeTimeSeries(latencyTimeSeries);
-        metrics.throughputTrend = analyzeTimeSeries(throughputTimeSeries);
+        metrics.latencyTrend = analyzeSeries(times, latencies, config.forecastHorizon);
+        metrics.throughputTrend = analyzeSeries(throughputTimes, throughputs, config.forecastHorizon);
 
         return metrics;
     }
 
     std::vector<CommunicationOutcome> findOutliers(
-        const std::vector<CommunicationOutcome>& windowOutcomes) const {
+        const std::deque<CommunicationOutcome>& windowOutcomes) const {
         if (windowOutcomes.empty()) {
             return {};
         }
 
-        std::vector<double> latencies;
-        latencies.reserve(windowOutcomes.size());
-        for (const auto& outcome : windowOutcomes) {
-            latencies.push_back(outcome.latency.count());
-        }
-
-        // Calculate mean and standard deviation
-        double sum = std::accumulate(latencies.begin(), latencies.end(), 0.0);
-        double mean = sum / latencies.size();
-        double sqSum = std::accumulate(latencies.begin(), latencies.end(), 0.0,
-            [mean](double acc, double val) {
-                double diff = val - mean;
-                return acc + (diff * diff);
-            });
-        double stdDev = std::sqrt(sqSum / latencies.size());
+        double mean = latencySketch.mean();
+        double stdDev = latencySketch.standardDeviation();
 
         // Find outliers
         std::vector<CommunicationOutcome> outliers;
-        for (size_t i = 0; i < windowOutcomes.size(); ++i) {
-            double zScore = std::abs(latencies[i] - mean) / stdDev;
+        for (const auto& outcome : windowOutcomes) {
+            double zScore = std::abs(outcome.latency.count() - mean) / stdDev;
             if (zScore > config.outlierThreshold) {
-                outliers.push_back(windowOutcomes[i]);
+                outliers.push_back(outcome);
             }
         }
 
         return outliers;
     }
 
-    Result<void> saveDataToFile(const std::string& filename) const {
-        try {
-            FeedbackData data;
-            data.set_version(CURRENT_VERSION);
-            *data.mutable_last_update() = timePointToProto(std::chrono::system_clock::now());
-
-            // Save outcomes
-            for (const auto& outcome : outcomes) {
-                *data.add_outcomes() = outcomeToProto(outcome);
-            }
-
-            // Save metrics
-            for (const auto& [name, values] : metrics) {
-                auto* series = data.add_metrics();
-                series->set_metric_name(name);
-                for (const auto& [time, value] : values) {
-                    auto* point = series->add_data_points();
-                    *point->mutable_timestamp() = timePointToProto(time);
-                    point->set_value(value);
-                }
-            }
+    using MetricSeriesMap = decltype(metrics);
 
-            // Serialize to binary
-            std::vector<uint8_t> serialized(data.ByteSizeLong());
-            if (!data.SerializeToArray(serialized.data(), serialized.size())) {
-                return Result<void>(std::string("Failed to serialize feedback data"));
-            }
-
-            // Compress if enabled
-            if (config.persistence.enableCompression) {
-                serialized = compressData(serialized);
-            }
+    Result<void> saveDataToFile(const std::string& filename) const {
+        return writeDataFile(filename, outcomes, metrics, config.persistence.enableCompression);
+    }
 
+    // Streams a FeedbackData message to filename field by field, through zlib when compress is
+    // set, so no more than one metric series is held in message form at a time
+    Result<void> writeDataFile(const std::string& filename, const std::deque<CommunicationOutcome>& outcomesToSave,
+                               const MetricSeriesMap& metricsToSave, bool compress) const {
+        namespace pbio = google::protobuf::io;
+        try {
             // Create directory if it doesn't exist
             std::filesystem::create_directories(
                 std::filesystem::path(filename).parent_path());
 
-            // Write to file
-            std::ofstream file(filename, std::ios::binary);
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
             if (!file) {
                 return Result<void>(std::string("Failed to open file for writing: " + filename));
             }
+            bool written;
+            {
+                pbio::OstreamOutputStream fileStream(&file);
+                std::unique_ptr<pbio::GzipOutputStream> zlibStream;
+                pbio::ZeroCopyOutputStream* sink = &fileStream;
+                if (compress) {
+                    // ZLIB framing, as compress2 wrote, so files from either path load the same way
+                    pbio::GzipOutputStream::Options options;
+                    options.format = pbio::GzipOutputStream::ZLIB;
+                    options.compression_level = std::clamp(config.persistence.compressionLevel, 1, 9);
+                    zlibStream = std::make_unique<pbio::GzipOutputStream>(&fileStream, options);
+                    sink = zlibStream.get();
+                }
 
-            file.write(reinterpret_cast<const char*>(serialized.data()), serialized.size());
-            
+                {
+                    pbio::CodedOutputStream out(sink);
+
+                    // Fields in number order, byte for byte what FeedbackData::SerializeToArray wrote
+                    CommunicationOutcomeProto outcomeProto;
+                    for (const auto& outcome : outcomesToSave) {
+                        outcomeToProto(outcome, outcomeProto);
+                        writeField(out, FeedbackData::kOutcomesFieldNumber, outcomeProto);
+                    }
+
+                    // A series' points go on an arena, released in one step before the next series
+                    google::protobuf::Arena arena;
+                    for (const auto& [name, values] : metricsToSave) {
+                        auto* series = google::protobuf::Arena::CreateMessage<MetricSeries>(&arena);
+                        series->set_metric_name(name);
+                        series->mutable_data_points()->Reserve(static_cast<int>(values.size()));
+                        for (const auto& [time, value] : values) {
+                            auto* point = series->add_data_points();
+                            *point->mutable_timestamp() = timePointToProto(time);
+                            point->set_value(value);
+                        }
+                        writeField(out, FeedbackData::kMetricsFieldNumber, *series);
+                        arena.Reset();
+                    }
+
+                    writeField(out, FeedbackData::kLastUpdateFieldNumber,
+                               timePointToProto(std::chrono::system_clock::now()));
+                    constexpr uint32_t VARINT = 0;
+                    out.WriteTag((static_cast<uint32_t>(FeedbackData::kVersionFieldNumber) << 3) | VARINT);
+                    out.WriteVarint32(CURRENT_VERSION);
+                    written = !out.HadError();
+                }  // The coded stream hands back its buffer here, before zlib is finished
+
+                if (zlibStream && !zlibStream->Close()) {
+                    written = false;
+                }
+            }  // fileStream passes its last buffer to file here
+            if (!written || !file.flush()) {
+                return Result<void>(std::string("Failed to write feedback data to " + filename));
+            }
             return Result<void>();
         } catch (const std::exception& e) {
             return Result<void>(std::string("Failed to save data: " + std::string(e.what())));
@@ -405,29 +863,32 @@ struct FeedbackLoop::Impl {
     }
 
     Result<void> loadDataFromFile(const std::string& filename) {
+        namespace pbio = google::protobuf::io;
         try {
-            // Read file
-            std::ifstream file(filename, std::ios::binary | std::ios::ate);
+            std::ifstream file(filename, std::ios::binary);
             if (!file) {
                 return Result<void>(std::string("Failed to open file for reading: " + filename));
             }
 
-            auto size = file.tellg();
+            // Decompress if needed (check the zlib header)
+            unsigned char header[2] = {};
+            file.read(reinterpret_cast<char*>(header), sizeof(header));
+            const bool compressed = config.persistence.enableCompression && file.gcount() == 2 &&
+                                    isZlibHeader(header[0], header[1]);
+            file.clear();
             file.seekg(0);
-            std::vector<uint8_t> data(size);
-            file.read(reinterpret_cast<char*>(data.data()), size);
 
-            // Decompress if needed (check magic bytes for zlib compression)
-            if (config.persistence.enableCompression && size >= 2 &&
-                (data[0] == 0x78 && (data[1] == 0x01 || data[1] == 0x9C || data[1] == 0xDA))) {
-                // Estimate original size (this is a heuristic)
-                size_t estimatedSize = size * 4;  // Assume 4:1 compression ratio
-                data = decompressData(data, estimatedSize);
+            // Parsed straight from the file, inflating as it goes, onto an arena freed in one step
+            pbio::IstreamInputStream fileStream(&file);
+            std::unique_ptr<pbio::GzipInputStream> zlibStream;
+            pbio::ZeroCopyInputStream* source = &fileStream;
+            if (compressed) {
+                zlibStream = std::make_unique<pbio::GzipInputStream>(&fileStream, pbio::GzipInputStream::ZLIB);
+                source = zlibStream.get();
             }
-
-            // Parse protobuf
-            FeedbackData feedbackData;
-            if (!feedbackData.ParseFromArray(data.data(), data.size())) {
+            google::protobuf::Arena arena;
+            auto& feedbackData = *google::protobuf::Arena::CreateMessage<FeedbackData>(&arena);
+            if (!feedbackData.ParseFromZeroCopyStream(source)) {
                 return Result<void>(std::string("Failed to parse feedback data"));
             }
 
@@ -444,6 +905,7 @@ struct FeedbackLoop::Impl {
             for (const auto& outcomeProto : feedbackData.outcomes()) {
                 outcomes.push_back(protoToOutcome(outcomeProto));
             }
+            rebuildAggregates();
 
             // Load metrics
             for (const auto& seriesProto : feedbackData.metrics()) {
@@ -483,11 +945,70 @@ struct FeedbackLoop::Impl {
         }
     }
 
+    // Appends the outcomes reported since the last save as a segment and
+    // rewrites the metrics file. Only the hand-over holds mutex.
+    Result<void> saveIncremental(bool compress) {
+        std::lock_guard<std::mutex> saveLock(saveMutex);
+        std::unique_lock<utils::ProfiledMutex<>> lock(mutex);
+        drainIngested();
+        std::vector<CommunicationOutcome> pending(unsaved.begin(), unsaved.end());
+        unsaved.clear();
+        MetricSeriesMap metricsSnapshot = metrics;
+        auto mainFile = std::filesystem::path(config.persistence.dataDirectory) / MAIN_DATA_FILE;
+        lock.unlock();
+
+        if (segmentStore) {
+            auto appended = segmentStore->append(pending);
+            if (!appended.has_value()) {
+                lock.lock();
+                unsaved.insert(unsaved.begin(), pending.begin(), pending.end());
+                return appended;
+            }
+        }
+        return writeDataFile(mainFile.string(), {}, metricsSnapshot, compress);
+    }
+
+    // Restores metrics and the outcomes of the current window. Requires mutex.
+    Result<void> loadPersisted() {
+        auto directory = std::filesystem::path(config.persistence.dataDirectory);
+        auto mainFile = directory / MAIN_DATA_FILE;
+        bool legacy = !std::filesystem::exists(mainFile) && std::filesystem::exists(directory / LEGACY_DATA_FILE);
+        auto result = loadDataFromFile((legacy ? directory / LEGACY_DATA_FILE : mainFile).string());
+        if (!result.has_value()) {
+            return result;
+        }
+
+        unsaved.clear();
+        if (legacy) {
+            // Moves into segments with the next save
+            unsaved.assign(outcomes.begin(), outcomes.end());
+        }
+        if (segmentStore) {
+            auto recent = segmentStore->query(std::chrono::system_clock::now() - config.metricsWindowSize,
+                                              std::chrono::system_clock::time_point::max());
+            if (!recent.has_value()) {
+                return Result<void>(recent.error());
+            }
+            outcomes.insert(outcomes.end(), recent.value().begin(), recent.value().end());
+            std::stable_sort(outcomes.begin(), outcomes.end(),
+                             [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
+        }
+        rebuildAggregates();
+        return Result<void>();
+    }
+
     Result<void> cleanupOldData() {
         try {
             auto now = std::chrono::system_clock::now();
             auto cutoff = now - config.persistence.retentionPeriod;
 
+            if (segmentStore) {
+                auto dropped = segmentStore->dropBefore(cutoff);
+                if (!dropped.has_value()) {
+                    return dropped;
+                }
+            }
+
             // Remove old outcomes
             outcomes.erase(
                 std::remove_if(outcomes.begin(), outcomes.end(),
@@ -496,6 +1017,7 @@ struct FeedbackLoop::Impl {
                     }),
                 outcomes.end()
             );
+            rebuildAggregates();
 
             // Remove old metrics
             for (auto& [name, values] : metrics) {
@@ -542,11 +1064,13 @@ struct FeedbackLoop::Impl {
 };
 
 FeedbackLoop::FeedbackLoop(const FeedbackLoopConfig& config)
-    : impl_(std::make_unique<Impl>()) {
-    impl_->config = config;
-
+    : impl_(std::make_unique<Impl>(config)) {
     if (config.enablePersistence) {
         std::filesystem::create_directories(config.persistence.dataDirectory);
+        auto segments = std::filesystem::path(config.persistence.dataDirectory) / SEGMENT_DIRECTORY;
+        auto store = std::make_unique<OutcomeSegmentStore>(segments.string());
+        std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+        impl_->segmentStore = std::move(store);
     }
 
     // LOG_INFO("FeedbackLoop initialized with window size: " + 
@@ -556,11 +1080,17 @@ FeedbackLoop::FeedbackLoop(const FeedbackLoopConfig& config)
 FeedbackLoop::~FeedbackLoop() = default;
 
 Result<void> FeedbackLoop::reportOutcome(const CommunicationOutcome& outcome) {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    
     try {
-        impl_->outcomes.push_back(outcome);
-        impl_->pruneOldData();
+        impl_->ingest(OutcomeRecord{
+            outcome.timestamp.time_since_epoch().count(),
+            outcome.latency.count(),
+            outcome.bytesTransferred,
+            outcome.retryCount,
+            outcome.errorCount,
+            impl_->internErrorType(outcome.errorType),
+            0,
+            outcome.success
+        });
         return Result<void>();
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to report outcome: " + std::string(e.what()));
@@ -568,12 +1098,30 @@ Result<void> FeedbackLoop::reportOutcome(const CommunicationOutcome& outcome) {
     }
 }
 
+Result<void> FeedbackLoop::reportOutcome(const CommunicationOutcome& outcome, const OutcomeLabels& labels) {
+    try {
+        impl_->ingest(OutcomeRecord{
+            outcome.timestamp.time_since_epoch().count(),
+            outcome.latency.count(),
+            outcome.bytesTransferred,
+            outcome.retryCount,
+            outcome.errorCount,
+            impl_->internErrorType(outcome.errorType),
+            impl_->internLabelSet(labels),
+            outcome.success
+        });
+        return Result<void>();
+    } catch (const std::exception& e) {
+        return Result<void>(std::string("Failed to report outcome: " + std::string(e.what())));
+    }
+}
+
 Result<void> FeedbackLoop::recordMetric(const std::string& metricName, double value) {
     if (metricName.empty()) {
         return Result<void>(std::string("Metric name cannot be empty"));
     }
 
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
     
     try {
         impl_->metrics[metricName].push_back(
@@ -590,36 +1138,77 @@ Result<void> FeedbackLoop::addCommunicationResult(
     bool success, std::chrono::microseconds latency,
     uint32_t bytesTransferred, uint32_t retryCount,
     uint32_t errorCount, const std::string& errorType) {
-    
-    CommunicationOutcome outcome{
-        success,
-        latency,
-        bytesTransferred,
-        retryCount,
-        errorCount,
-        errorType,
-        std::chrono::system_clock::now()
-    };
-
-    return reportOutcome(outcome);
+    // Straight to a record, without building a CommunicationOutcome and its string
+    try {
+        impl_->ingest(OutcomeRecord{
+            std::chrono::system_clock::now().time_since_epoch().count(),
+            latency.count(),
+            bytesTransferred,
+            retryCount,
+            errorCount,
+            impl_->internErrorType(errorType),
+            0,
+            success
+        });
+        return Result<void>();
+    } catch (const std::exception& e) {
+        return Result<void>(std::string("Failed to report outcome: " + std::string(e.what())));
+    }
 }
 
 Result<MetricsSummary> FeedbackLoop::getCurrentMetrics() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
-        std::vector<CommunicationOutcome> windowOutcomes(
-            impl_->outcomes.begin(), impl_->outcomes.end());
-        return Result<MetricsSummary>(impl_->calculateMetrics(windowOutcomes));
+        return Result<MetricsSummary>(impl_->summarizeBuckets());
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to get current metrics: " + std::string(e.what()));
         return Result<MetricsSummary>(std::string("Failed to get current metrics: " + std::string(e.what())));
     }
 }
 
+Result<MetricsSummary> FeedbackLoop::getMetricsForWindow(std::chrono::seconds window) const {
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
+
+    if (window.count() <= 0 || window > impl_->config.metricsWindowSize) {
+        return Result<MetricsSummary>(std::string("Window must be positive and at most metricsWindowSize"));
+    }
+    auto from = Impl::secondOf(std::chrono::system_clock::now() - window);
+    return Result<MetricsSummary>(impl_->summarizeBuckets(std::max<int64_t>(from, 0)));
+}
+
+Result<MetricsSummary> FeedbackLoop::getMetricsForLabels(const OutcomeLabels& selector) const {
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
+    return Result<MetricsSummary>(impl_->summarizeLabeled(selector));
+}
+
+Result<std::vector<LabeledMetrics>> FeedbackLoop::getLabeledMetrics() const {
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
+
+    std::shared_lock<std::shared_mutex> labelsLock(impl_->errorTypesMutex);
+    std::vector<LabeledMetrics> result;
+    for (size_t id = 1; id < impl_->labeledBuckets.size(); ++id) {
+        const auto& buckets = impl_->labeledBuckets[id];
+        if (buckets.empty()) {
+            continue;
+        }
+        Impl::BucketTotals totals;
+        for (const auto& bucket : buckets) {
+            totals.add(bucket);
+        }
+        result.push_back(LabeledMetrics{impl_->labelSets[id], totals.finish()});
+    }
+    return Result<std::vector<LabeledMetrics>>(std::move(result));
+}
+
 Result<std::vector<CommunicationOutcome>> FeedbackLoop::getRecentOutcomes(
     uint32_t limit) const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
         std::vector<CommunicationOutcome> recent;
@@ -634,7 +1223,8 @@ Result<std::vector<CommunicationOutcome>> FeedbackLoop::getRecentOutcomes(
 }
 
 Result<double> FeedbackLoop::getMetricValue(const std::string& metricName) const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
         auto it = impl_->metrics.find(metricName);
@@ -648,10 +1238,77 @@ Result<double> FeedbackLoop::getMetricValue(const std::string& metricName) const
     }
 }
 
+uint64_t FeedbackLoop::getWindowGeneration() const {
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
+    return impl_->generation;
+}
+
+uint64_t FeedbackLoop::subscribeWindowUpdates(WindowListener listener) {
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    auto subscription = impl_->nextSubscription++;
+    impl_->windowListeners.emplace_back(subscription, std::move(listener));
+    return subscription;
+}
+
+void FeedbackLoop::unsubscribeWindowUpdates(uint64_t subscription) {
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    auto& listeners = impl_->windowListeners;
+    listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                   [subscription](const auto& entry) { return entry.first == subscription; }),
+                    listeners.end());
+}
+
+void FeedbackLoop::registerMetrics(utils::MetricsRegistry& registry, const std::string& instance) {
+    metricsRegistration_ = registry.addCollector([this, instance](utils::MetricsWriter& writer) {
+        auto write = [&writer](const MetricsSummary& summary, const utils::MetricLabels& labels) {
+            writer.gauge("xenocomm_feedback_transactions", "Outcomes in the metrics window",
+                         summary.totalTransactions, labels);
+            writer.gauge("xenocomm_feedback_success_ratio", "Share of outcomes in the window that succeeded",
+                         summary.successRate, labels);
+            writer.gauge("xenocomm_feedback_error_ratio", "Share of outcomes in the window that failed",
+                         summary.errorRate, labels);
+            writer.gauge("xenocomm_feedback_latency_avg_us", "Mean latency in the window, in microseconds",
+                         summary.averageLatency, labels);
+            writer.gauge("xenocomm_feedback_throughput_bytes_per_second", "Throughput over the window",
+                         summary.throughputBytesPerSecond, labels);
+        };
+
+        auto current = getCurrentMetrics();
+        if (current.has_value()) {
+            write(current.value(), {{"instance", instance}});
+        }
+        auto labeled = getLabeledMetrics();
+        if (!labeled.has_value()) {
+            return;
+        }
+        for (const auto& entry : labeled.value()) {
+            utils::MetricLabels labels{{"instance", instance}};
+            const std::pair<const char*, const std::string*> fields[] = {
+                {"peer", &entry.labels.peerId}, {"transport", &entry.labels.transport},
+                {"data_format", &entry.labels.dataFormat}, {"compression", &entry.labels.compression}};
+            for (const auto& [name, value] : fields) {
+                if (!value->empty()) {
+                    labels.emplace_back(name, *value);
+                }
+            }
+            if (labels.size() > 1) {  // An empty label set is already counted in the overall series
+                write(entry.metrics, labels);
+            }
+        }
+    });
+}
+
 void FeedbackLoop::setConfig(const FeedbackLoopConfig& config) {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
+    bool resized = config.metricsWindowSize != impl_->config.metricsWindowSize;
     impl_->config = config;
+    ++impl_->generation;  // The forecast horizon may have changed
     impl_->pruneOldData();
+    if (resized) {
+        impl_->rebuildAggregates();
+    }
 }
 
 const FeedbackLoopConfig& FeedbackLoop::getConfig() const {
@@ -659,16 +1316,19 @@ const FeedbackLoopConfig& FeedbackLoop::getConfig() const {
 }
 
 Result<DetailedMetrics> FeedbackLoop::getDetailedMetrics() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
         if (!impl_->config.enableDetailedAnalysis) {
             return Result<DetailedMetrics>(std::string("Detailed analysis is disabled in configuration"));
         }
 
-        std::vector<CommunicationOutcome> windowOutcomes(
-            impl_->outcomes.begin(), impl_->outcomes.end());
-        return Result<DetailedMetrics>(impl_->calculateDetailedMetrics(windowOutcomes));
+        if (impl_->detailedGeneration != impl_->generation) {
+            impl_->detailedMetrics = impl_->calculateDetailedMetrics(impl_->outcomes);
+            impl_->detailedGeneration = impl_->generation;
+        }
+        return Result<DetailedMetrics>(impl_->detailedMetrics);
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to calculate detailed metrics: " + std::string(e.what()));
         return Result<DetailedMetrics>(std::string("Failed to calculate detailed metrics: " + std::string(e.what())));
@@ -676,15 +1336,11 @@ Result<DetailedMetrics> FeedbackLoop::getDetailedMetrics() const {
 }
 
 Result<DistributionStats> FeedbackLoop::analyzeLatencyDistribution() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
-        std::vector<double> latencies;
-        latencies.reserve(impl_->outcomes.size());
-        for (const auto& outcome : impl_->outcomes) {
-            latencies.push_back(outcome.latency.count());
-        }
-        return Result<DistributionStats>(impl_->calculateDistributionStats(latencies));
+        return Result<DistributionStats>(impl_->distributionStats(impl_->latencySketch));
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to analyze latency distribution: " + std::string(e.what()));
         return Result<DistributionStats>(std::string("Failed to analyze latency distribution: " + std::string(e.what())));
@@ -692,18 +1348,11 @@ Result<DistributionStats> FeedbackLoop::analyzeLatencyDistribution() const {
 }
 
 Result<DistributionStats> FeedbackLoop::analyzeThroughputDistribution() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
-        std::vector<double> throughputs;
-        throughputs.reserve(impl_->outcomes.size());
-        for (const auto& outcome : impl_->outcomes) {
-            double seconds = outcome.latency.count() / 1e6;
-            if (seconds > 0) {
-                throughputs.push_back(outcome.bytesTransferred / seconds);
-            }
-        }
-        return Result<DistributionStats>(impl_->calculateDistributionStats(throughputs));
+        return Result<DistributionStats>(impl_->distributionStats(impl_->throughputSketch));
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to analyze throughput distribution: " + std::string(e.what()));
         return Result<DistributionStats>(std::string("Failed to analyze throughput distribution: " + std::string(e.what())));
@@ -711,24 +1360,25 @@ Result<DistributionStats> FeedbackLoop::analyzeThroughputDistribution() const {
 }
 
 Result<TimeSeriesAnalysis> FeedbackLoop::analyzeLatencyTrend() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
-        std::vector<std::pair<double, double>> timeValuePairs;
-        if (impl_->outcomes.empty()) {
-            return Result<TimeSeriesAnalysis>(TimeSeriesAnalysis{});
-        }
-
-        double baseTime = std::chrono::duration<double>(
-            impl_->outcomes.front().timestamp.time_since_epoch()).count();
-
-        for (const auto& outcome : impl_->outcomes) {
-            double time = std::chrono::duration<double>(
-                outcome.timestamp.time_since_epoch()).count() - baseTime;
-            timeValuePairs.emplace_back(time, outcome.latency.count());
+        if (impl_->latencyTrendGeneration != impl_->generation) {
+            std::vector<double> times, latencies;
+            times.reserve(impl_->outcomes.size());
+            latencies.reserve(impl_->outcomes.size());
+            if (!impl_->outcomes.empty()) {
+                const auto baseTime = impl_->outcomes.front().timestamp;
+                for (const auto& outcome : impl_->outcomes) {
+                    times.push_back(std::chrono::duration<double>(outcome.timestamp - baseTime).count());
+                    latencies.push_back(static_cast<double>(outcome.latency.count()));
+                }
+            }
+            impl_->latencyTrend = analyzeSeries(times, latencies, impl_->config.forecastHorizon);
+            impl_->latencyTrendGeneration = impl_->generation;
         }
-
-        return Result<TimeSeriesAnalysis>(impl_->analyzeTimeSeries(timeValuePairs));
+        return Result<TimeSeriesAnalysis>(impl_->latencyTrend);
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to analyze latency trend: " + std::string(e.what()));
         return Result<TimeSeriesAnalysis>(std::string("Failed to analyze latency trend: " + std::string(e.what())));
@@ -736,7 +1386,8 @@ Result<TimeSeriesAnalysis> FeedbackLoop::analyzeLatencyTrend() const {
 }
 
 Result<std::map<std::string, uint32_t>> FeedbackLoop::getErrorTypeDistribution() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
         std::map<std::string, uint32_t> distribution;
@@ -753,13 +1404,12 @@ Result<std::map<std::string, uint32_t>> FeedbackLoop::getErrorTypeDistribution()
 }
 
 Result<std::vector<CommunicationOutcome>> FeedbackLoop::getOutliers() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     
     try {
-        std::vector<CommunicationOutcome> windowOutcomes(
-            impl_->outcomes.begin(), impl_->outcomes.end());
         return Result<std::vector<CommunicationOutcome>>(
-            impl_->findOutliers(windowOutcomes));
+            impl_->findOutliers(impl_->outcomes));
     } catch (const std::exception& e) {
         // LOG_ERROR("Failed to find outliers: " + std::string(e.what()));
         return Result<std::vector<CommunicationOutcome>>(std::string("Failed to find outliers: " + std::string(e.what())));
@@ -767,19 +1417,26 @@ Result<std::vector<CommunicationOutcome>> FeedbackLoop::getOutliers() const {
 }
 
 Result<void> FeedbackLoop::saveData() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    auto dataFile = std::filesystem::path(impl_->config.persistence.dataDirectory) / "feedback_data.pb";
-    return impl_->saveDataToFile(dataFile.string());
+    try {
+        return impl_->saveIncremental(impl_->config.persistence.enableCompression);
+    } catch (const std::exception& e) {
+        return Result<void>(std::string("Failed to save data: " + std::string(e.what())));
+    }
 }
 
 Result<void> FeedbackLoop::loadData() {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    auto dataFile = std::filesystem::path(impl_->config.persistence.dataDirectory) / "feedback_data.pb";
-    return impl_->loadDataFromFile(dataFile.string());
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
+    try {
+        return impl_->loadPersisted();
+    } catch (const std::exception& e) {
+        return Result<void>(std::string("Failed to load data: " + std::string(e.what())));
+    }
 }
 
 Result<void> FeedbackLoop::createBackup() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     try {
         auto now = std::chrono::system_clock::now();
         auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
@@ -802,12 +1459,14 @@ Result<void> FeedbackLoop::createBackup() const {
 }
 
 Result<void> FeedbackLoop::restoreFromBackup(const std::string& backupFile) {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     return impl_->loadDataFromFile(backupFile);
 }
 
 Result<std::vector<std::string>> FeedbackLoop::listBackups() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     try {
         std::vector<std::string> backups;
         auto backupDir = std::filesystem::path(impl_->config.persistence.dataDirectory) / "backups";
@@ -827,33 +1486,39 @@ Result<std::vector<std::string>> FeedbackLoop::listBackups() const {
 }
 
 Result<void> FeedbackLoop::pruneOldBackups() {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     return impl_->cleanupOldData();
 }
 
 Result<void> FeedbackLoop::compactStorage() {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
     try {
-        // Update time index
-        auto result = impl_->updateTimeIndex();
-        if (!result.has_value()) {
-            return result;
+        std::chrono::system_clock::time_point retainFrom;
+        {
+            std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+            impl_->drainIngested();
+            // Update time index
+            auto result = impl_->updateTimeIndex();
+            if (!result.has_value()) {
+                return result;
+            }
+            retainFrom = std::chrono::system_clock::now() - impl_->config.persistence.retentionPeriod;
         }
 
-        // Save current data with compression
-        bool wasCompressed = impl_->config.persistence.enableCompression;
-        impl_->config.persistence.enableCompression = true;
-        result = saveData();
-        impl_->config.persistence.enableCompression = wasCompressed;
-
-        return result;
+        // Save current data with compression, then merge the segments
+        auto result = impl_->saveIncremental(true);
+        if (!result.has_value() || !impl_->segmentStore) {
+            return result;
+        }
+        return impl_->segmentStore->compact(retainFrom);
     } catch (const std::exception& e) {
         return Result<void>(std::string("Failed to compact storage: " + std::string(e.what())));
     }
 }
 
 Result<uint64_t> FeedbackLoop::getStorageSize() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     try {
         uint64_t totalSize = 0;
         auto dataDir = std::filesystem::path(impl_->config.persistence.dataDirectory);
@@ -873,18 +1538,27 @@ Result<uint64_t> FeedbackLoop::getStorageSize() const {
 }
 
 Result<std::chrono::system_clock::time_point> FeedbackLoop::getLastBackupTime() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     return Result<std::chrono::system_clock::time_point>(impl_->lastBackupTime);
 }
 
 Result<std::chrono::system_clock::time_point> FeedbackLoop::getOldestDataTime() const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     try {
-        if (impl_->outcomes.empty()) {
+        std::optional<std::chrono::system_clock::time_point> persisted;
+        if (impl_->segmentStore) {
+            persisted = impl_->segmentStore->oldest();
+        }
+        if (impl_->outcomes.empty() && !persisted) {
             return Result<std::chrono::system_clock::time_point>(std::string("No data available"));
         }
         
-        auto oldestTime = impl_->outcomes.front().timestamp;
+        auto oldestTime = impl_->outcomes.empty() ? *persisted : impl_->outcomes.front().timestamp;
+        if (persisted && *persisted < oldestTime) {
+            oldestTime = *persisted;
+        }
         for (const auto& [_, values] : impl_->metrics) {
             if (!values.empty() && values.front().first < oldestTime) {
                 oldestTime = values.front().first;
@@ -900,15 +1574,34 @@ Result<std::chrono::system_clock::time_point> FeedbackLoop::getOldestDataTime()
 Result<std::vector<CommunicationOutcome>> FeedbackLoop::getOutcomesByTimeRange(
     std::chrono::system_clock::time_point start,
     std::chrono::system_clock::time_point end) const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
     try {
-        std::vector<CommunicationOutcome> results;
-        for (const auto& outcome : impl_->outcomes) {
-            if (outcome.timestamp >= start && outcome.timestamp <= end) {
-                results.push_back(outcome);
+        std::vector<CommunicationOutcome> recent;
+        auto inMemoryFrom = std::chrono::system_clock::time_point::max();
+        {
+            std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+            impl_->drainIngested();
+            for (const auto& outcome : impl_->outcomes) {
+                if (outcome.timestamp >= start && outcome.timestamp <= end) {
+                    recent.push_back(outcome);
+                }
             }
+            if (!impl_->outcomes.empty()) {
+                inMemoryFrom = impl_->outcomes.front().timestamp;
+            }
+        }
+        if (!impl_->segmentStore || start >= inMemoryFrom) {
+            return Result<std::vector<CommunicationOutcome>>(std::move(recent));
+        }
+
+        // Older outcomes come from the segments, up to where memory takes over
+        auto persistedEnd = inMemoryFrom == std::chrono::system_clock::time_point::max()
+            ? end : std::min(end, inMemoryFrom - std::chrono::system_clock::duration(1));
+        auto results = impl_->segmentStore->query(start, persistedEnd);
+        if (!results.has_value()) {
+            return results;
         }
-        return Result<std::vector<CommunicationOutcome>>(std::move(results));
+        results.value().insert(results.value().end(), recent.begin(), recent.end());
+        return results;
     } catch (const std::exception& e) {
         return Result<std::vector<CommunicationOutcome>>(std::string("Failed to get outcomes by time range: " + std::string(e.what())));
     }
@@ -919,7 +1612,8 @@ FeedbackLoop::getMetricHistory(
     const std::string& metricName,
     std::chrono::system_clock::time_point start,
     std::chrono::system_clock::time_point end) const {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::lock_guard<utils::ProfiledMutex<>> lock(impl_->mutex);
+    impl_->drainIngested();
     try {
         auto it = impl_->metrics.find(metricName);
         if (it == impl_->metrics.end()) {
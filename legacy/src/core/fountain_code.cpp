@@ -0,0 +1,213 @@
+#include "xenocomm/core/fountain_code.h"
+#include "xenocomm/utils/gf256.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr int32_t NO_PIVOT = -1;
+constexpr int32_t SOURCE_PIVOT = -2;  // The source symbol itself, already in the output
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+void fountain_coefficients(uint32_t block, uint32_t esi, uint8_t* out, uint32_t count) {
+    uint64_t state = (static_cast<uint64_t>(block) << 32) | esi;
+    for (uint32_t i = 0; i < count; i += 8) {
+        uint64_t bits = splitmix64(state);
+        for (uint32_t j = i; j < std::min(count, i + 8); ++j, bits >>= 8) {
+            out[j] = static_cast<uint8_t>(1 + (bits & 0xFF) % 255);
+        }
+    }
+}
+
+uint64_t FountainLayout::total_symbols() const {
+    return symbol_size == 0 ? 0 : (payload_size + symbol_size - 1) / symbol_size;
+}
+
+uint32_t FountainLayout::block_count() const {
+    return block_symbols == 0 ? 0 : static_cast<uint32_t>((total_symbols() + block_symbols - 1) / block_symbols);
+}
+
+uint32_t FountainLayout::source_symbols(uint32_t block) const {
+    const uint64_t first = static_cast<uint64_t>(block) * block_symbols;
+    const uint64_t total = total_symbols();
+    return first >= total ? 0 : static_cast<uint32_t>(std::min<uint64_t>(block_symbols, total - first));
+}
+
+bool FountainLayout::valid() const {
+    if (symbol_size == 0 || block_symbols == 0 || block_symbols > MAX_BLOCK_SYMBOLS) {
+        return false;
+    }
+    return (total_symbols() + block_symbols - 1) / block_symbols <= std::numeric_limits<uint32_t>::max();
+}
+
+FountainEncoder::FountainEncoder(utils::ByteSpan data, uint32_t symbol_size, uint32_t block_symbols)
+    : data_(data), layout_{data.size(), symbol_size, block_symbols} {
+    if (layout_.valid() && data.size() % symbol_size != 0) {
+        const size_t tail = data.size() % symbol_size;
+        padded_tail_.assign(symbol_size, 0);
+        std::memcpy(padded_tail_.data(), data.data() + data.size() - tail, tail);
+    }
+}
+
+const uint8_t* FountainEncoder::source_symbol(uint32_t block, uint32_t index) const {
+    const uint64_t offset = (static_cast<uint64_t>(block) * layout_.block_symbols + index) * layout_.symbol_size;
+    return offset + layout_.symbol_size <= data_.size() ? data_.data() + offset : padded_tail_.data();
+}
+
+void FountainEncoder::encode(uint32_t block, uint32_t esi, uint8_t* out) const {
+    const uint32_t k = layout_.source_symbols(block);
+    if (esi < k) {
+        std::memcpy(out, source_symbol(block, esi), layout_.symbol_size);
+        return;
+    }
+    std::array<uint8_t, FountainLayout::MAX_BLOCK_SYMBOLS> coefficients;
+    fountain_coefficients(block, esi, coefficients.data(), k);
+    std::memset(out, 0, layout_.symbol_size);
+    for (uint32_t i = 0; i < k; ++i) {
+        utils::gf256MulAddRegion(coefficients[i], source_symbol(block, i), out, layout_.symbol_size);
+    }
+}
+
+// Rows are upper triangular: the row pivoting on column p has a 1 there and
+// zeros before it, so a new row is reduced in one left-to-right pass
+struct FountainDecoder::BlockState {
+    uint32_t k;
+    uint32_t rank = 0;
+    std::vector<int32_t> pivot;              // Per column: NO_PIVOT, SOURCE_PIVOT or an index into rows
+    std::vector<std::vector<uint8_t>> rows;  // k coefficients, then the symbol
+    std::vector<uint8_t> spare;              // A row found redundant, reused for the next
+
+    explicit BlockState(uint32_t source_symbols) : k(source_symbols), pivot(source_symbols, NO_PIVOT) {}
+};
+
+FountainDecoder::FountainDecoder(const FountainLayout& layout)
+    : layout_(layout), blocks_remaining_(0) {
+    if (!layout_.valid()) {
+        return;
+    }
+    output_.resize(layout_.total_symbols() * layout_.symbol_size);
+    blocks_remaining_ = layout_.block_count();
+    blocks_.reserve(blocks_remaining_);
+    for (uint32_t block = 0; block < blocks_remaining_; ++block) {
+        blocks_.push_back(std::make_unique<BlockState>(layout_.source_symbols(block)));
+    }
+}
+
+FountainDecoder::~FountainDecoder() = default;
+
+uint8_t* FountainDecoder::output_symbol(uint32_t block, uint32_t index) {
+    return output_.data() + (static_cast<uint64_t>(block) * layout_.block_symbols + index) * layout_.symbol_size;
+}
+
+bool FountainDecoder::block_complete(uint32_t block) const {
+    return block < blocks_.size() && !blocks_[block];
+}
+
+bool FountainDecoder::add_symbol(uint32_t block, uint32_t esi, utils::ByteSpan symbol) {
+    if (block >= blocks_.size() || !blocks_[block] || symbol.size() != layout_.symbol_size) {
+        return false;
+    }
+    BlockState& state = *blocks_[block];
+    const uint32_t k = state.k;
+    const uint32_t size = layout_.symbol_size;
+
+    if (esi < k && state.pivot[esi] == NO_PIVOT) {
+        // The common case on a good link: nothing to eliminate
+        std::memcpy(output_symbol(block, esi), symbol.data(), size);
+        state.pivot[esi] = SOURCE_PIVOT;
+    } else {
+        if (esi < k && state.pivot[esi] == SOURCE_PIVOT) {
+            return false;
+        }
+        std::vector<uint8_t> row = std::move(state.spare);
+        row.assign(k + size, 0);
+        if (esi < k) {
+            row[esi] = 1;  // A source symbol whose column a repair symbol took first
+        } else {
+            fountain_coefficients(block, esi, row.data(), k);
+        }
+        std::memcpy(row.data() + k, symbol.data(), size);
+        uint8_t* coefficients = row.data();
+        uint8_t* data = row.data() + k;
+
+        uint32_t lead = k;
+        for (uint32_t col = 0; col < k; ++col) {
+            const uint8_t factor = coefficients[col];
+            if (factor == 0) {
+                continue;
+            }
+            const int32_t pivot = state.pivot[col];
+            if (pivot == SOURCE_PIVOT) {
+                utils::gf256MulAddRegion(factor, output_symbol(block, col), data, size);
+                coefficients[col] = 0;
+            } else if (pivot != NO_PIVOT) {
+                const auto& other = state.rows[pivot];
+                utils::gf256MulAddRegion(factor, other.data() + col, coefficients + col, k - col);
+                utils::gf256MulAddRegion(factor, other.data() + k, data, size);
+            } else {
+                lead = col;
+                break;
+            }
+        }
+        if (lead == k) {
+            state.spare = std::move(row);
+            return false;
+        }
+        const uint8_t inverse = utils::gf256Inv(coefficients[lead]);
+        utils::gf256MulRegion(inverse, coefficients + lead, coefficients + lead, k - lead);
+        utils::gf256MulRegion(inverse, data, data, size);
+        state.pivot[lead] = static_cast<int32_t>(state.rows.size());
+        state.rows.push_back(std::move(row));
+    }
+
+    if (++state.rank == k) {
+        finish_block(block, state);
+    }
+    return true;
+}
+
+void FountainDecoder::finish_block(uint32_t block, BlockState& state) {
+    // Back substitution, last column first, so every later symbol is already in the output
+    const uint32_t k = state.k;
+    const uint32_t size = layout_.symbol_size;
+    for (uint32_t col = k; col-- > 0;) {
+        const int32_t pivot = state.pivot[col];
+        if (pivot < 0) {
+            continue;
+        }
+        auto& row = state.rows[pivot];
+        uint8_t* data = row.data() + k;
+        for (uint32_t later = col + 1; later < k; ++later) {
+            if (row[later] != 0) {
+                utils::gf256MulAddRegion(row[later], output_symbol(block, later), data, size);
+            }
+        }
+        std::memcpy(output_symbol(block, col), data, size);
+    }
+    blocks_[block].reset();
+    --blocks_remaining_;
+}
+
+std::vector<uint8_t> FountainDecoder::take_payload() {
+    if (!complete()) {
+        return {};
+    }
+    output_.resize(layout_.payload_size);
+    return std::move(output_);
+}
+
+} // namespace core
+} // namespace xenocomm
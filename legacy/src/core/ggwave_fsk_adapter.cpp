@@ -3,15 +3,112 @@
 #include <cstring>
 #include <algorithm>
 
+#if defined(__SSE2__)
+#define XENOCOMM_FSK_HAVE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define XENOCOMM_FSK_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace xenocomm {
 namespace core {
 
 namespace {
-constexpr float PI = 3.14159265358979323846f;
+constexpr double PI = 3.14159265358979323846;
+constexpr size_t SYMBOL_COUNT = 256;
+constexpr unsigned SINE_TABLE_BITS = 12;
+constexpr size_t BINS_PER_PASS = 16;  // Goertzel filters run side by side, four vectors of four
+constexpr size_t TONES_PER_BAND = 16;  // One nibble per band, so a band is one Goertzel pass
+constexpr size_t MAX_BANDS = SYMBOL_COUNT / TONES_PER_BAND;
+
+// One cycle of sin, indexed by the top bits of a 32-bit phase
+const float* sineTable() {
+    static const std::vector<float> table = [] {
+        std::vector<float> values(size_t{1} << SINE_TABLE_BITS);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<float>(std::sin(2.0 * PI * static_cast<double>(i) / values.size()));
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+inline float toSample(uint8_t value) {
+    return (static_cast<float>(value) / 127.5f) - 1.0f;
+}
+
+// Signal power at the first bins symbol frequencies, a multiple of
+// BINS_PER_PASS, over one window. Each filter runs q0 = c*q1 + (x - q2);
+// BINS_PER_PASS of them advance together per sample.
+void goertzelPowers(const float* window, size_t count, const float* coefficients, float* powers,
+                    size_t bins = SYMBOL_COUNT) {
+    for (size_t bin = 0; bin < bins; bin += BINS_PER_PASS) {
+#if defined(XENOCOMM_FSK_HAVE_SSE2)
+        __m128 c[4], q1[4], q2[4];
+        for (int j = 0; j < 4; ++j) {
+            c[j] = _mm_loadu_ps(coefficients + bin + 4 * j);
+            q1[j] = q2[j] = _mm_setzero_ps();
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const __m128 x = _mm_set1_ps(window[i]);
+            for (int j = 0; j < 4; ++j) {
+                // x - q2 does not wait on q1, leaving a multiply and an add on the chain
+                __m128 q0 = _mm_add_ps(_mm_mul_ps(c[j], q1[j]), _mm_sub_ps(x, q2[j]));
+                q2[j] = q1[j];
+                q1[j] = q0;
+            }
+        }
+        for (int j = 0; j < 4; ++j) {
+            __m128 power = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(q1[j], q1[j]), _mm_mul_ps(q2[j], q2[j])),
+                                      _mm_mul_ps(c[j], _mm_mul_ps(q1[j], q2[j])));
+            _mm_storeu_ps(powers + bin + 4 * j, power);
+        }
+#elif defined(XENOCOMM_FSK_HAVE_NEON)
+        float32x4_t c[4], q1[4], q2[4];
+        for (int j = 0; j < 4; ++j) {
+            c[j] = vld1q_f32(coefficients + bin + 4 * j);
+            q1[j] = q2[j] = vdupq_n_f32(0.0f);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const float32x4_t x = vdupq_n_f32(window[i]);
+            for (int j = 0; j < 4; ++j) {
+                float32x4_t q0 = vmlaq_f32(vsubq_f32(x, q2[j]), c[j], q1[j]);
+                q2[j] = q1[j];
+                q1[j] = q0;
+            }
+        }
+        for (int j = 0; j < 4; ++j) {
+            float32x4_t power = vmlsq_f32(vmlaq_f32(vmulq_f32(q1[j], q1[j]), q2[j], q2[j]),
+                                          c[j], vmulq_f32(q1[j], q2[j]));
+            vst1q_f32(powers + bin + 4 * j, power);
+        }
+#else
+        float c[BINS_PER_PASS], q1[BINS_PER_PASS] = {}, q2[BINS_PER_PASS] = {};
+        std::memcpy(c, coefficients + bin, sizeof(c));
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < BINS_PER_PASS; ++j) {
+                float q0 = c[j] * q1[j] + (window[i] - q2[j]);
+                q2[j] = q1[j];
+                q1[j] = q0;
+            }
+        }
+        for (size_t j = 0; j < BINS_PER_PASS; ++j) {
+            powers[bin + j] = q1[j] * q1[j] + q2[j] * q2[j] - c[j] * q1[j] * q2[j];
+        }
+#endif
+    }
+}
+
+bool isFskFormat(DataFormat format) {
+    return format == DataFormat::GGWAVE_FSK || format == DataFormat::GGWAVE_FSK_MULTIBAND;
+}
 } // namespace
 
 GgwaveFskAdapter::GgwaveFskAdapter(const GgwaveFskConfig& config)
-    : config_(config) {}
+    : config_(config) {
+    buildTables();
+}
 
 std::vector<uint8_t> GgwaveFskAdapter::encode(
     const void* data,
@@ -19,13 +116,18 @@ std::vector<uint8_t> GgwaveFskAdapter::encode(
     DataFormat format) {
     // Validate input parameters
     validateInput(data, size);
-    if (format != DataFormat::GGWAVE_FSK) {
+    if (!isFskFormat(format)) {
         throw TranscodingError("Invalid format for GgwaveFskAdapter::encode");
     }
+    const bool multiband = format == DataFormat::GGWAVE_FSK_MULTIBAND;
+    if (multiband) {
+        validateBands();
+    }
+    const size_t bands = multiband ? config_.bands : 1;
 
     // Create header
     FskHeader header{
-        MAGIC_NUMBER,
+        multiband ? MULTIBAND_MAGIC_NUMBER : MAGIC_NUMBER,
         static_cast<uint32_t>(size),
         config_.sample_rate,
         config_.base_frequency,
@@ -33,31 +135,43 @@ std::vector<uint8_t> GgwaveFskAdapter::encode(
         static_cast<uint32_t>(config_.samples_per_symbol)
     };
 
-    // Calculate total samples needed
-    size_t total_samples = config_.samples_per_symbol * (size + sizeof(FskHeader));
-    std::vector<float> audio_samples;
-    audio_samples.reserve(total_samples);
+    // Samples are written straight out as 8-bit values (normalized to 0-255)
+    const size_t sps = config_.samples_per_symbol;
+    std::vector<uint8_t> encoded(sps * (headerSymbols(bands) + dataSymbols(size, bands)));
+    uint8_t* out = encoded.data();
 
     // Encode header
     const uint8_t* header_bytes = reinterpret_cast<const uint8_t*>(&header);
-    for (size_t i = 0; i < sizeof(FskHeader); ++i) {
-        generateSymbolSamples(header_bytes[i], audio_samples);
-    }
-
-    // Encode data
     const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
-    for (size_t i = 0; i < size; ++i) {
-        generateSymbolSamples(data_bytes[i], audio_samples);
+    if (!multiband) {
+        for (size_t i = 0; i < sizeof(FskHeader); ++i, out += sps) {
+            modulateSymbol(header_bytes[i], out);
+        }
+        for (size_t i = 0; i < size; ++i, out += sps) {
+            modulateSymbol(data_bytes[i], out);
+        }
+        return encoded;
     }
 
-    // Convert float samples to uint8_t (normalized to 0-255)
-    std::vector<uint8_t> encoded;
-    encoded.reserve(audio_samples.size());
-    std::transform(audio_samples.begin(), audio_samples.end(), 
-        std::back_inserter(encoded),
-        [](float sample) {
-            return static_cast<uint8_t>((sample + 1.0f) * 127.5f);
-        });
+    // All 256 tones rarely fit below Nyquist at an orthogonal spacing, so the
+    // header and band count go out a byte per symbol as a pair of nibbles in
+    // the two lowest bands
+    std::vector<float> mix(sps);
+    uint8_t tones[MAX_BANDS];
+    for (size_t i = 0; i <= sizeof(FskHeader); ++i, out += sps) {
+        const uint8_t byte = i < sizeof(FskHeader) ? header_bytes[i] : static_cast<uint8_t>(bands);
+        tones[0] = byte & 0x0F;
+        tones[1] = byte >> 4;
+        modulateBands(tones, 2, mix.data(), out);
+    }
+    size_t nibble = 0;
+    for (size_t s = dataSymbols(size, bands); s > 0; --s, out += sps) {
+        for (size_t b = 0; b < bands; ++b, ++nibble) {
+            // The last symbol is padded with tone 0
+            tones[b] = nibble / 2 < size ? (data_bytes[nibble / 2] >> (4 * (nibble % 2))) & 0x0F : 0;
+        }
+        modulateBands(tones, bands, mix.data(), out);
+    }
 
     return encoded;
 }
@@ -65,55 +179,46 @@ std::vector<uint8_t> GgwaveFskAdapter::encode(
 std::vector<uint8_t> GgwaveFskAdapter::decode(
     const std::vector<uint8_t>& encoded_data,
     DataFormat source_format) {
-    if (source_format != DataFormat::GGWAVE_FSK) {
+    if (!isFskFormat(source_format)) {
         throw TranscodingError("Invalid format for GgwaveFskAdapter::decode");
     }
 
-    // Convert uint8_t samples back to float (-1.0 to 1.0)
-    std::vector<float> audio_samples;
-    audio_samples.reserve(encoded_data.size());
-    std::transform(encoded_data.begin(), encoded_data.end(),
-        std::back_inserter(audio_samples),
-        [](uint8_t sample) {
-            return (static_cast<float>(sample) / 127.5f) - 1.0f;
-        });
-
     // Need enough samples for at least a header
-    if (audio_samples.size() < config_.samples_per_symbol * sizeof(FskHeader)) {
+    if (encoded_data.size() < config_.samples_per_symbol * sizeof(FskHeader)) {
         throw TranscodingError("Not enough samples to decode header");
     }
 
     // Decode header
-    std::vector<uint8_t> header_bytes(sizeof(FskHeader));
-    for (size_t i = 0; i < sizeof(FskHeader); ++i) {
-        header_bytes[i] = detectSymbol(audio_samples, i * config_.samples_per_symbol);
+    size_t bands = 1;
+    FskHeader header = readHeader(encoded_data.data(), encoded_data.size(), bands);
+    if ((bands > 1) != (source_format == DataFormat::GGWAVE_FSK_MULTIBAND)) {
+        throw TranscodingError("FSK header does not match the requested format");
     }
-    const FskHeader* header = reinterpret_cast<const FskHeader*>(header_bytes.data());
 
     // Validate header
-    validateHeader(*header, (audio_samples.size() / config_.samples_per_symbol) - sizeof(FskHeader));
+    validateHeader(header, bands, encoded_data.size() / config_.samples_per_symbol);
 
     // Update config from header if needed
-    if (header->sample_rate != config_.sample_rate ||
-        header->base_freq != config_.base_frequency ||
-        header->freq_spacing != config_.frequency_spacing ||
-        header->samples_per_symbol != config_.samples_per_symbol) {
+    if (header.sample_rate != config_.sample_rate ||
+        header.base_freq != config_.base_frequency ||
+        header.freq_spacing != config_.frequency_spacing ||
+        header.samples_per_symbol != config_.samples_per_symbol ||
+        (bands > 1 && bands != config_.bands)) {
         GgwaveFskConfig new_config = config_;
-        new_config.sample_rate = header->sample_rate;
-        new_config.base_frequency = header->base_freq;
-        new_config.frequency_spacing = header->freq_spacing;
-        new_config.samples_per_symbol = header->samples_per_symbol;
+        new_config.sample_rate = header.sample_rate;
+        new_config.base_frequency = header.base_freq;
+        new_config.frequency_spacing = header.freq_spacing;
+        new_config.samples_per_symbol = header.samples_per_symbol;
+        if (bands > 1) {
+            new_config.bands = bands;
+        }
         setConfig(new_config);
     }
 
     // Decode data
-    std::vector<uint8_t> decoded;
-    decoded.reserve(header->data_size);
-    size_t data_start = sizeof(FskHeader) * config_.samples_per_symbol;
-    
-    for (size_t i = 0; i < header->data_size; ++i) {
-        decoded.push_back(detectSymbol(audio_samples, data_start + i * config_.samples_per_symbol));
-    }
+    std::vector<uint8_t> decoded(header.data_size);
+    demodulate(encoded_data.data(), encoded_data.size(), headerSymbols(bands), bands,
+               decoded.data(), decoded.size());
 
     return decoded;
 }
@@ -122,30 +227,17 @@ bool GgwaveFskAdapter::isValidFormat(
     const void* data,
     size_t size,
     DataFormat format) const {
-    if (format != DataFormat::GGWAVE_FSK || !data || 
+    if (!isFskFormat(format) || !data || 
         size < config_.samples_per_symbol * sizeof(FskHeader)) {
         return false;
     }
 
     try {
-        // Convert first chunk of samples to get header
-        const uint8_t* samples = static_cast<const uint8_t*>(data);
-        std::vector<float> audio_samples;
-        audio_samples.reserve(config_.samples_per_symbol * sizeof(FskHeader));
-        
-        for (size_t i = 0; i < config_.samples_per_symbol * sizeof(FskHeader); ++i) {
-            audio_samples.push_back((static_cast<float>(samples[i]) / 127.5f) - 1.0f);
-        }
-
         // Decode and validate header
-        std::vector<uint8_t> header_bytes(sizeof(FskHeader));
-        for (size_t i = 0; i < sizeof(FskHeader); ++i) {
-            header_bytes[i] = detectSymbol(audio_samples, i * config_.samples_per_symbol);
-        }
-        const FskHeader* header = reinterpret_cast<const FskHeader*>(header_bytes.data());
-        
-        validateHeader(*header, (size / config_.samples_per_symbol) - sizeof(FskHeader));
-        return true;
+        size_t bands = 1;
+        FskHeader header = readHeader(static_cast<const uint8_t*>(data), size, bands);
+        validateHeader(header, bands, size / config_.samples_per_symbol);
+        return (bands > 1) == (format == DataFormat::GGWAVE_FSK_MULTIBAND);
     } catch (const TranscodingError&) {
         return false;
     }
@@ -157,38 +249,32 @@ TranscodingMetadata GgwaveFskAdapter::getMetadata(
         throw TranscodingError("Not enough samples to extract metadata");
     }
 
-    // Convert and decode header
-    std::vector<float> audio_samples;
-    audio_samples.reserve(config_.samples_per_symbol * sizeof(FskHeader));
-    
-    for (size_t i = 0; i < config_.samples_per_symbol * sizeof(FskHeader); ++i) {
-        audio_samples.push_back((static_cast<float>(encoded_data[i]) / 127.5f) - 1.0f);
-    }
-
-    std::vector<uint8_t> header_bytes(sizeof(FskHeader));
-    for (size_t i = 0; i < sizeof(FskHeader); ++i) {
-        header_bytes[i] = detectSymbol(audio_samples, i * config_.samples_per_symbol);
-    }
-    const FskHeader* header = reinterpret_cast<const FskHeader*>(header_bytes.data());
+    // Decode header
+    size_t bands = 1;
+    FskHeader header = readHeader(encoded_data.data(), encoded_data.size(), bands);
 
-    if (header->magic != MAGIC_NUMBER) {
+    if (header.magic != MAGIC_NUMBER && header.magic != MULTIBAND_MAGIC_NUMBER) {
         throw TranscodingError("Invalid magic number in FSK header");
     }
 
     TranscodingMetadata metadata;
-    metadata.format = DataFormat::GGWAVE_FSK;
-    metadata.element_count = header->data_size;
+    metadata.format = bands > 1 ? DataFormat::GGWAVE_FSK_MULTIBAND : DataFormat::GGWAVE_FSK;
+    metadata.element_count = header.data_size;
     metadata.element_size = 1;  // Raw bytes
     metadata.dimensions = {
-        static_cast<size_t>(header->sample_rate),
-        static_cast<size_t>(header->samples_per_symbol)
+        static_cast<size_t>(header.sample_rate),
+        static_cast<size_t>(header.samples_per_symbol)
     };
+    if (bands > 1) {
+        metadata.dimensions.push_back(bands);
+    }
 
     return metadata;
 }
 
 void GgwaveFskAdapter::setConfig(const GgwaveFskConfig& config) {
     config_ = config;
+    buildTables();
 }
 
 const GgwaveFskConfig& GgwaveFskAdapter::getConfig() const {
@@ -199,60 +285,264 @@ float GgwaveFskAdapter::getSymbolFrequency(uint8_t symbol) const {
     return config_.base_frequency + (symbol * config_.frequency_spacing);
 }
 
-void GgwaveFskAdapter::generateSymbolSamples(
-    uint8_t symbol,
-    std::vector<float>& samples) const {
-    float frequency = getSymbolFrequency(symbol);
-    float angular_freq = 2.0f * PI * frequency;
-    
-    for (size_t i = 0; i < config_.samples_per_symbol; ++i) {
-        float t = static_cast<float>(i) / config_.sample_rate;
-        samples.push_back(config_.amplitude * std::sin(angular_freq * t));
+void GgwaveFskAdapter::buildTables() {
+    phase_steps_.resize(SYMBOL_COUNT);
+    goertzel_coefficients_.resize(SYMBOL_COUNT);
+    for (size_t symbol = 0; symbol < SYMBOL_COUNT; ++symbol) {
+        double cycles = static_cast<double>(getSymbolFrequency(static_cast<uint8_t>(symbol))) / config_.sample_rate;
+        double fraction = cycles - std::floor(cycles);
+        phase_steps_[symbol] = static_cast<uint32_t>(static_cast<uint64_t>(fraction * 4294967296.0));
+        goertzel_coefficients_[symbol] = static_cast<float>(2.0 * std::cos(2.0 * PI * cycles));
     }
 }
 
-uint8_t GgwaveFskAdapter::detectSymbol(
-    const std::vector<float>& samples,
-    size_t offset) const {
-    // Simple frequency detection using Goertzel algorithm
-    float max_magnitude = 0.0f;
-    uint8_t detected_symbol = 0;
-
-    for (uint8_t symbol = 0; symbol < 256; ++symbol) {
-        float frequency = getSymbolFrequency(symbol);
-        float omega = 2.0f * PI * frequency / config_.sample_rate;
-        float cos_omega = std::cos(omega);
-        float sin_omega = std::sin(omega);
-
-        float q0 = 0.0f, q1 = 0.0f, q2 = 0.0f;
-        
-        // Process samples
-        for (size_t i = 0; i < config_.samples_per_symbol && (offset + i) < samples.size(); ++i) {
-            q0 = 2.0f * cos_omega * q1 - q2 + samples[offset + i];
-            q2 = q1;
-            q1 = q0;
+void GgwaveFskAdapter::modulateSymbol(uint8_t symbol, uint8_t* out) const {
+    // Phase restarts at zero for every symbol, as a sine starting at t = 0 would
+    const float* sine = sineTable();
+    const uint32_t step = phase_steps_[symbol];
+    uint32_t phase = 0;
+    for (size_t i = 0; i < config_.samples_per_symbol; ++i, phase += step) {
+        float sample = config_.amplitude * sine[phase >> (32 - SINE_TABLE_BITS)];
+        out[i] = static_cast<uint8_t>((sample + 1.0f) * 127.5f);
+    }
+}
+
+void GgwaveFskAdapter::modulateBands(const uint8_t* tones, size_t bands, float* mix, uint8_t* out) const {
+    // One band at a time over the whole symbol, so the sums stay in simple
+    // loops; the tones are scaled down together to keep the mix in range
+    const float* sine = sineTable();
+    const size_t sps = config_.samples_per_symbol;
+    std::fill(mix, mix + sps, 0.0f);
+    for (size_t b = 0; b < bands; ++b) {
+        const uint32_t step = phase_steps_[b * TONES_PER_BAND + tones[b]];
+        uint32_t phase = 0;
+        for (size_t i = 0; i < sps; ++i, phase += step) {
+            mix[i] += sine[phase >> (32 - SINE_TABLE_BITS)];
         }
+    }
+    const float scale = config_.amplitude / static_cast<float>(bands);
+    for (size_t i = 0; i < sps; ++i) {
+        out[i] = static_cast<uint8_t>((mix[i] * scale + 1.0f) * 127.5f);
+    }
+}
+
+uint8_t GgwaveFskAdapter::detectSymbol(const float* window, size_t count) const {
+    float powers[SYMBOL_COUNT];
+    goertzelPowers(window, count, goertzel_coefficients_.data(), powers);
+    return static_cast<uint8_t>(std::max_element(powers, powers + SYMBOL_COUNT) - powers);
+}
+
+void GgwaveFskAdapter::detectData(
+    const float* window,
+    size_t count,
+    size_t bands,
+    size_t symbol,
+    uint8_t* out,
+    size_t out_size) const {
+    if (bands <= 1) {
+        if (symbol < out_size) {
+            out[symbol] = detectSymbol(window, count);
+        }
+        return;
+    }
+
+    // Only the bins of the bands in use are evaluated, one pass per band
+    float powers[SYMBOL_COUNT];
+    goertzelPowers(window, count, goertzel_coefficients_.data(), powers, bands * TONES_PER_BAND);
+    size_t nibble = symbol * bands;
+    for (size_t b = 0; b < bands && nibble / 2 < out_size; ++b, ++nibble) {
+        const float* band = powers + b * TONES_PER_BAND;
+        auto tone = static_cast<uint8_t>(std::max_element(band, band + TONES_PER_BAND) - band);
+        out[nibble / 2] |= static_cast<uint8_t>(tone << (4 * (nibble % 2)));
+    }
+}
+
+void GgwaveFskAdapter::demodulate(
+    const uint8_t* samples,
+    size_t sample_count,
+    size_t first_symbol,
+    size_t bands,
+    uint8_t* out,
+    size_t out_size) const {
+    const size_t sps = config_.samples_per_symbol;
+    std::vector<float> window(sps);
+    const size_t symbol_count = dataSymbols(out_size, bands);
+    for (size_t s = 0; s < symbol_count; ++s) {
+        size_t offset = (first_symbol + s) * sps;
+        size_t count = offset < sample_count ? std::min(sps, sample_count - offset) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            window[i] = toSample(samples[offset + i]);
+        }
+        detectData(window.data(), count, bands, s, out, out_size);
+    }
+}
+
+void GgwaveFskAdapter::detectHeaderSymbol(
+    const float* window,
+    size_t count,
+    uint8_t& single,
+    uint8_t& paired) const {
+    float powers[SYMBOL_COUNT];
+    goertzelPowers(window, count, goertzel_coefficients_.data(), powers);
+    single = static_cast<uint8_t>(std::max_element(powers, powers + SYMBOL_COUNT) - powers);
+    float* high = powers + TONES_PER_BAND;
+    paired = static_cast<uint8_t>((std::max_element(powers, high) - powers) |
+                                  (std::max_element(high, high + TONES_PER_BAND) - high) << 4);
+}
 
-        // Calculate magnitude
-        float magnitude = std::sqrt(q1 * q1 + q2 * q2 - q1 * q2 * cos_omega);
-        
-        if (magnitude > max_magnitude) {
-            max_magnitude = magnitude;
-            detected_symbol = symbol;
+GgwaveFskAdapter::FskHeader GgwaveFskAdapter::readHeader(
+    const uint8_t* samples,
+    size_t sample_count,
+    size_t& bands) const {
+    // The magic is read both ways from one filter pass per symbol; it tells
+    // which way to read the rest
+    constexpr size_t MAGIC_SYMBOLS = sizeof(uint32_t);
+    const size_t sps = config_.samples_per_symbol;
+    std::vector<float> window(sps);
+    uint8_t single[sizeof(FskHeader)] = {};
+    uint8_t paired[sizeof(FskHeader) + 1] = {};
+    for (size_t s = 0; s < MAGIC_SYMBOLS; ++s) {
+        size_t offset = s * sps;
+        size_t count = offset < sample_count ? std::min(sps, sample_count - offset) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            window[i] = toSample(samples[offset + i]);
         }
+        detectHeaderSymbol(window.data(), count, single[s], paired[s]);
+    }
+
+    FskHeader header;
+    uint32_t magic;
+    std::memcpy(&magic, paired, sizeof(magic));
+    if (magic == MULTIBAND_MAGIC_NUMBER) {
+        // The rest of the header and the band count, as nibble pairs
+        demodulate(samples, sample_count, MAGIC_SYMBOLS, 2, paired + MAGIC_SYMBOLS,
+                   sizeof(paired) - MAGIC_SYMBOLS);
+        std::memcpy(&header, paired, sizeof(FskHeader));
+        bands = paired[sizeof(FskHeader)];
+        return header;
     }
+    demodulate(samples, sample_count, MAGIC_SYMBOLS, 1, single + MAGIC_SYMBOLS,
+               sizeof(single) - MAGIC_SYMBOLS);
+    std::memcpy(&header, single, sizeof(FskHeader));
+    bands = 1;
+    return header;
+}
+
+size_t GgwaveFskAdapter::headerSymbols(size_t bands) {
+    return sizeof(FskHeader) + (bands > 1 ? 1 : 0);
+}
+
+size_t GgwaveFskAdapter::dataSymbols(size_t size, size_t bands) {
+    return bands <= 1 ? size : (2 * size + bands - 1) / bands;
+}
 
-    return detected_symbol;
+GgwaveFskAdapter::StreamDecoder::StreamDecoder(const GgwaveFskAdapter& adapter, size_t ring_symbols)
+    : adapter_(adapter),
+      ring_(std::max<size_t>(ring_symbols, 1) * adapter.config_.samples_per_symbol),
+      window_(adapter.config_.samples_per_symbol) {
+    symbols_.reserve(sizeof(FskHeader));
+    paired_.reserve(sizeof(FskHeader) + 1);
+}
+
+size_t GgwaveFskAdapter::StreamDecoder::push(const uint8_t* samples, size_t count) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    count = std::min(count, ring_.size() - (head - tail));
+
+    // Copy in at most two pieces, around the end of the ring
+    const size_t start = head % ring_.size();
+    const size_t first = std::min(count, ring_.size() - start);
+    std::memcpy(ring_.data() + start, samples, first);
+    std::memcpy(ring_.data(), samples + first, count - first);
+    head_.store(head + count, std::memory_order_release);
+    return count;
+}
+
+bool GgwaveFskAdapter::StreamDecoder::poll(std::vector<uint8_t>& message) {
+    const size_t sps = adapter_.config_.samples_per_symbol;
+    const size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_relaxed);
+
+    while (head - tail >= sps) {
+        for (size_t i = 0; i < sps; ++i) {
+            window_[i] = toSample(ring_[(tail + i) % ring_.size()]);
+        }
+        tail += sps;
+        tail_.store(tail, std::memory_order_release);
+
+        if (bands_ != 0) {
+            adapter_.detectData(window_.data(), sps, bands_, received_++, data_.data(), data_.size());
+        } else {
+            uint8_t single, paired;
+            adapter_.detectHeaderSymbol(window_.data(), sps, single, paired);
+            symbols_.push_back(single);
+            paired_.push_back(paired);
+            if (symbols_.size() < sizeof(FskHeader)) {
+                continue;
+            }
+            FskHeader header;
+            std::memcpy(&header, paired_.data(), sizeof(FskHeader));
+            const bool multiband = header.magic == MULTIBAND_MAGIC_NUMBER;
+            if (multiband && paired_.size() == sizeof(FskHeader)) {
+                continue;  // The band count is still to come
+            }
+            if (!multiband) {
+                std::memcpy(&header, symbols_.data(), sizeof(FskHeader));
+            }
+            const size_t bands = multiband ? paired_.back() : 1;
+            const GgwaveFskConfig& config = adapter_.config_;
+            if ((header.magic != MAGIC_NUMBER && !multiband) ||
+                (multiband && (bands < 2 || bands > MAX_BANDS)) ||
+                header.sample_rate != config.sample_rate ||
+                header.base_freq != config.base_frequency || header.freq_spacing != config.frequency_spacing ||
+                header.samples_per_symbol != config.samples_per_symbol) {
+                reset();
+                throw TranscodingError("Invalid FSK header in stream");
+            }
+            bands_ = bands;
+            data_.assign(header.data_size, 0);
+            received_ = 0;
+            expected_ = dataSymbols(header.data_size, bands);
+        }
+
+        if (bands_ != 0 && received_ == expected_) {
+            message.swap(data_);
+            symbols_.clear();
+            paired_.clear();
+            data_.clear();
+            bands_ = received_ = expected_ = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void GgwaveFskAdapter::StreamDecoder::reset() {
+    tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    symbols_.clear();
+    paired_.clear();
+    data_.clear();
+    bands_ = received_ = expected_ = 0;
+}
+
+size_t GgwaveFskAdapter::StreamDecoder::buffered() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
 }
 
 void GgwaveFskAdapter::validateHeader(
     const FskHeader& header,
-    size_t data_size) const {
-    if (header.magic != MAGIC_NUMBER) {
+    size_t bands,
+    size_t symbol_count) const {
+    if (header.magic != MAGIC_NUMBER && header.magic != MULTIBAND_MAGIC_NUMBER) {
         throw TranscodingError("Invalid magic number in FSK header");
     }
 
-    if (header.data_size != data_size) {
+    if (header.magic == MULTIBAND_MAGIC_NUMBER && (bands < 2 || bands > MAX_BANDS)) {
+        throw TranscodingError("Invalid band count in FSK header");
+    }
+
+    if (symbol_count < headerSymbols(bands) ||
+        dataSymbols(header.data_size, bands) != symbol_count - headerSymbols(bands)) {
         throw TranscodingError("Data size mismatch in FSK header");
     }
 
@@ -262,5 +552,19 @@ void GgwaveFskAdapter::validateHeader(
     }
 }
 
+void GgwaveFskAdapter::validateBands() const {
+    if (config_.bands < 2 || config_.bands > MAX_BANDS) {
+        throw TranscodingError("Multi-band FSK needs 2 to 16 bands");
+    }
+    // Tones a whole number of cycles per symbol apart do not leak into each other's filters
+    if (config_.frequency_spacing * config_.samples_per_symbol < config_.sample_rate) {
+        throw TranscodingError("Multi-band FSK needs frequency_spacing of at least sample_rate / samples_per_symbol");
+    }
+    const float top = getSymbolFrequency(static_cast<uint8_t>(config_.bands * TONES_PER_BAND - 1));
+    if (top >= config_.sample_rate / 2.0f) {
+        throw TranscodingError("Multi-band FSK tones reach the Nyquist limit");
+    }
+}
+
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
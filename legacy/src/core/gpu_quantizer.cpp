@@ -0,0 +1,239 @@
+#include "xenocomm/core/gpu_quantizer.h"
+#include <string>
+#include <utility>
+
+#ifdef XENOCOMM_HAVE_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+#ifdef XENOCOMM_HAVE_CUDA
+
+namespace gpu {
+// Kernel launchers, in gpu_quantizer_kernels.cu
+cudaError_t quantizeInt8Global(const float* src, size_t count, float scale, uint8_t* dst, cudaStream_t stream);
+cudaError_t quantizeInt8Blocks(const float* src, size_t count, size_t block_size, uint8_t* dst,
+                               cudaStream_t stream);
+cudaError_t quantizeInt4Groups(const float* src, size_t count, size_t group_size, uint8_t* dst,
+                               cudaStream_t stream);
+cudaError_t convertToHalf(const float* src, size_t count, uint16_t* dst, cudaStream_t stream);
+cudaError_t convertToBfloat16(const float* src, size_t count, uint16_t* dst, cudaStream_t stream);
+} // namespace gpu
+
+namespace {
+
+void check(cudaError_t status, const char* what) {
+    if (status != cudaSuccess) {
+        throw TranscodingError(std::string("GpuQuantizer: ") + what + ": " + cudaGetErrorString(status));
+    }
+}
+
+// Device allocation that only grows
+struct DeviceArray {
+    void* data = nullptr;
+    size_t capacity = 0;
+
+    ~DeviceArray() {
+        if (data) {
+            cudaFree(data);
+        }
+    }
+
+    void reserve(size_t size) {
+        if (size <= capacity) {
+            return;
+        }
+        if (data) {
+            cudaFree(data);
+            data = nullptr;
+            capacity = 0;
+        }
+        check(cudaMalloc(&data, size), "cudaMalloc");
+        capacity = size;
+    }
+};
+
+} // namespace
+
+struct GpuQuantizer::Device {
+    cudaStream_t stream = nullptr;
+    DeviceArray output;
+    DeviceArray staging;
+
+    ~Device() {
+        if (stream) {
+            cudaStreamDestroy(stream);
+        }
+    }
+};
+
+#else
+
+struct GpuQuantizer::Device {};
+
+#endif // XENOCOMM_HAVE_CUDA
+
+GpuQuantizer::PinnedBuffer::~PinnedBuffer() {
+    release();
+}
+
+GpuQuantizer::PinnedBuffer::PinnedBuffer(PinnedBuffer&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+GpuQuantizer::PinnedBuffer& GpuQuantizer::PinnedBuffer::operator=(PinnedBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+    }
+    return *this;
+}
+
+void GpuQuantizer::PinnedBuffer::resize(size_t size) {
+    if (size > capacity_) {
+        release();
+#ifdef XENOCOMM_HAVE_CUDA
+        void* memory = nullptr;
+        check(cudaMallocHost(&memory, size), "cudaMallocHost");
+        data_ = static_cast<uint8_t*>(memory);
+#else
+        data_ = new uint8_t[size];
+#endif
+        capacity_ = size;
+    }
+    size_ = size;
+}
+
+void GpuQuantizer::PinnedBuffer::release() {
+    if (data_) {
+#ifdef XENOCOMM_HAVE_CUDA
+        cudaFreeHost(data_);
+#else
+        delete[] data_;
+#endif
+    }
+    data_ = nullptr;
+    size_ = capacity_ = 0;
+}
+
+GpuQuantizer::GpuQuantizer(const GpuQuantizerConfig& config) : config_(config) {
+    if (config_.int4_group_size == 0) {
+        throw TranscodingError("GpuQuantizer INT4 group size must be positive");
+    }
+    if (config_.int8_block_size == 0 && config_.int8_scale == 0.0f) {
+        throw TranscodingError("GpuQuantizer INT8 scale must be non-zero");
+    }
+#ifdef XENOCOMM_HAVE_CUDA
+    int devices = 0;
+    if (cudaGetDeviceCount(&devices) != cudaSuccess || config_.device < 0 || config_.device >= devices) {
+        throw TranscodingError("GpuQuantizer: no CUDA device " + std::to_string(config_.device));
+    }
+    device_ = std::make_unique<Device>();
+    check(cudaSetDevice(config_.device), "cudaSetDevice");
+    check(cudaStreamCreateWithFlags(&device_->stream, cudaStreamNonBlocking), "cudaStreamCreate");
+#else
+    throw TranscodingError("GpuQuantizer: built without CUDA support");
+#endif
+}
+
+GpuQuantizer::~GpuQuantizer() = default;
+
+bool GpuQuantizer::available() {
+#ifdef XENOCOMM_HAVE_CUDA
+    int devices = 0;
+    return cudaGetDeviceCount(&devices) == cudaSuccess && devices > 0;
+#else
+    return false;
+#endif
+}
+
+size_t GpuQuantizer::encodedSize(size_t count, DataFormat format) const {
+    // The CPU adapters define the layouts, so they also define the sizes
+    const size_t bytes = count * sizeof(float);
+    switch (format) {
+        case DataFormat::VECTOR_INT8:
+            if (config_.int8_block_size == 0) {
+                return VectorInt8Adapter(config_.int8_scale).maxEncodedSize(bytes, DataFormat::VECTOR_FLOAT32);
+            }
+            return VectorInt8Adapter::perBlock(config_.int8_block_size).maxEncodedSize(bytes, DataFormat::VECTOR_FLOAT32);
+        case DataFormat::VECTOR_FLOAT16:
+        case DataFormat::VECTOR_BFLOAT16:
+            return count * sizeof(uint16_t);
+        case DataFormat::VECTOR_INT4:
+            return VectorInt4Adapter(config_.int4_group_size).maxEncodedSize(bytes, DataFormat::VECTOR_FLOAT32);
+        default:
+            throw TranscodingError("GpuQuantizer does not produce this format");
+    }
+}
+
+utils::ByteSpan GpuQuantizer::encode(const float* device_data, size_t count, DataFormat format, PinnedBuffer& out) {
+    utils::ByteSpan encoded = encodeOnDevice(device_data, count, format);
+    out.resize(encoded.size());
+#ifdef XENOCOMM_HAVE_CUDA
+    check(cudaMemcpyAsync(out.data(), encoded.data(), encoded.size(), cudaMemcpyDeviceToHost, device_->stream),
+          "cudaMemcpyAsync");
+    check(cudaStreamSynchronize(device_->stream), "cudaStreamSynchronize");
+#endif
+    return out.span();
+}
+
+utils::ByteSpan GpuQuantizer::encodeOnDevice(const float* device_data, size_t count, DataFormat format) {
+    if (!device_data || count == 0) {
+        throw TranscodingError("GpuQuantizer needs a non-empty input");
+    }
+    const size_t size = encodedSize(count, format);
+#ifdef XENOCOMM_HAVE_CUDA
+    check(cudaSetDevice(config_.device), "cudaSetDevice");
+    device_->output.reserve(size);
+    auto* dst = static_cast<uint8_t*>(device_->output.data);
+    cudaStream_t stream = device_->stream;
+    switch (format) {
+        case DataFormat::VECTOR_INT8:
+            check(config_.int8_block_size == 0
+                      ? gpu::quantizeInt8Global(device_data, count, config_.int8_scale, dst, stream)
+                      : gpu::quantizeInt8Blocks(device_data, count, config_.int8_block_size, dst, stream),
+                  "INT8 kernel");
+            break;
+        case DataFormat::VECTOR_FLOAT16:
+            check(gpu::convertToHalf(device_data, count, reinterpret_cast<uint16_t*>(dst), stream), "FP16 kernel");
+            break;
+        case DataFormat::VECTOR_BFLOAT16:
+            check(gpu::convertToBfloat16(device_data, count, reinterpret_cast<uint16_t*>(dst), stream),
+                  "BF16 kernel");
+            break;
+        default:
+            if (count > UINT32_MAX) {
+                throw TranscodingError("VectorInt4Adapter supports at most 2^32 - 1 elements");
+            }
+            check(gpu::quantizeInt4Groups(device_data, count, config_.int4_group_size, dst, stream), "INT4 kernel");
+            break;
+    }
+    return utils::ByteSpan(dst, size);
+#else
+    (void)size;
+    throw TranscodingError("GpuQuantizer: built without CUDA support");
+#endif
+}
+
+const float* GpuQuantizer::upload(const float* host_data, size_t count) {
+#ifdef XENOCOMM_HAVE_CUDA
+    check(cudaSetDevice(config_.device), "cudaSetDevice");
+    device_->staging.reserve(count * sizeof(float));
+    check(cudaMemcpyAsync(device_->staging.data, host_data, count * sizeof(float), cudaMemcpyHostToDevice,
+                          device_->stream),
+          "cudaMemcpyAsync");
+    return static_cast<const float*>(device_->staging.data);
+#else
+    (void)host_data;
+    (void)count;
+    throw TranscodingError("GpuQuantizer: built without CUDA support");
+#endif
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,174 @@
+// Device kernels behind GpuQuantizer. Each writes the layout of the matching
+// CPU adapter in data_adapters.cpp; keep them in step.
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <cuda_runtime.h>
+#include <cstdint>
+#include <cstring>
+
+namespace xenocomm {
+namespace core {
+namespace gpu {
+
+namespace {
+
+constexpr int THREADS = 256;
+constexpr int MAX_BLOCKS = 65535;  // Grid-stride loops cover the rest
+constexpr size_t SCALE_HEADER_SIZE = 2 * sizeof(float);  // offset, step
+constexpr size_t INT4_HEADER_SIZE = 2 * sizeof(uint32_t);  // element count, group size
+
+int gridFor(size_t items) {
+    size_t blocks = (items + THREADS - 1) / THREADS;
+    return static_cast<int>(blocks < MAX_BLOCKS ? blocks : MAX_BLOCKS);
+}
+
+// As utils::quantizeToUint8: clamp(v * scale + bias, 0, 255) truncated, NaN
+// to 255. The explicit roundings keep nvcc from fusing into an FMA, which
+// would round differently from the CPU loop.
+__device__ uint8_t quantize(float v, float scale, float bias) {
+    if (isnan(v)) {
+        return 255;
+    }
+    float q = __fadd_rn(__fmul_rn(v, scale), bias);
+    q = fminf(fmaxf(q, 0.0f), 255.0f);
+    return static_cast<uint8_t>(q);
+}
+
+// Range of count values ignoring NaNs, reduced across the thread block; the
+// same in every thread on return. +inf/-inf if all are NaN.
+__device__ void blockRange(const float* src, size_t count, float& min, float& max) {
+    __shared__ float lows[THREADS];
+    __shared__ float highs[THREADS];
+    float lo = INFINITY;
+    float hi = -INFINITY;
+    for (size_t i = threadIdx.x; i < count; i += blockDim.x) {
+        // fminf/fmaxf return the other operand for a NaN
+        lo = fminf(lo, src[i]);
+        hi = fmaxf(hi, src[i]);
+    }
+    lows[threadIdx.x] = lo;
+    highs[threadIdx.x] = hi;
+    __syncthreads();
+    for (unsigned stride = blockDim.x / 2; stride > 0; stride /= 2) {
+        if (threadIdx.x < stride) {
+            lows[threadIdx.x] = fminf(lows[threadIdx.x], lows[threadIdx.x + stride]);
+            highs[threadIdx.x] = fmaxf(highs[threadIdx.x], highs[threadIdx.x + stride]);
+        }
+        __syncthreads();
+    }
+    min = lows[0];
+    max = highs[0];
+    __syncthreads();  // The arrays are reused by the next group
+}
+
+// Offset and step mapping [min, max] onto codes 0..levels, written as the
+// group header; returns the scale and bias that quantize onto them
+__device__ void groupScale(float min, float max, float levels, uint8_t* header, float& scale, float& bias) {
+    if (min > max) {  // All NaN
+        min = max = 0.0f;
+    }
+    float step = (max - min) / levels;
+    scale = step > 0.0f ? 1.0f / step : 0.0f;
+    bias = __fsub_rn(0.5f, __fmul_rn(min, scale));
+    if (threadIdx.x == 0) {
+        memcpy(header, &min, sizeof(float));
+        memcpy(header + sizeof(float), &step, sizeof(float));
+    }
+}
+
+__global__ void int8GlobalKernel(const float* src, size_t count, float scale, uint8_t* dst) {
+    for (size_t i = blockIdx.x * size_t(blockDim.x) + threadIdx.x; i < count; i += size_t(gridDim.x) * blockDim.x) {
+        dst[i] = quantize(src[i], scale, 0.0f);
+    }
+}
+
+// One thread block per scale block: [offset, step, codes]
+__global__ void int8BlocksKernel(const float* src, size_t count, size_t block_size, uint8_t* dst) {
+    const size_t blocks = (count + block_size - 1) / block_size;
+    for (size_t block = blockIdx.x; block < blocks; block += gridDim.x) {
+        const size_t first = block * block_size;
+        const size_t n = count - first < block_size ? count - first : block_size;
+        uint8_t* out = dst + block * (SCALE_HEADER_SIZE + block_size);
+        float min, max, scale, bias;
+        blockRange(src + first, n, min, max);
+        groupScale(min, max, 255.0f, out, scale, bias);
+        for (size_t i = threadIdx.x; i < n; i += blockDim.x) {
+            out[SCALE_HEADER_SIZE + i] = quantize(src[first + i], scale, bias);
+        }
+    }
+}
+
+// One thread block per group: [offset, step, codes two per byte, low nibble first]
+__global__ void int4GroupsKernel(const float* src, size_t count, size_t group_size, uint8_t* dst) {
+    if (blockIdx.x == 0 && threadIdx.x == 0) {
+        uint32_t header[2] = {static_cast<uint32_t>(count), static_cast<uint32_t>(group_size)};
+        memcpy(dst, header, sizeof(header));
+    }
+    const size_t groups = (count + group_size - 1) / group_size;
+    const size_t stride = SCALE_HEADER_SIZE + (group_size + 1) / 2;
+    for (size_t group = blockIdx.x; group < groups; group += gridDim.x) {
+        const size_t first = group * group_size;
+        const size_t n = count - first < group_size ? count - first : group_size;
+        uint8_t* out = dst + INT4_HEADER_SIZE + group * stride;
+        float min, max, scale, bias;
+        blockRange(src + first, n, min, max);
+        groupScale(min, max, 15.0f, out, scale, bias);
+        // NaN codes are 255, which the masks turn into 15, as on the CPU
+        for (size_t pair = threadIdx.x; 2 * pair < n; pair += blockDim.x) {
+            const size_t i = first + 2 * pair;
+            uint8_t low = quantize(src[i], scale, bias) & 0x0F;
+            uint8_t high = 2 * pair + 1 < n ? quantize(src[i + 1], scale, bias) & 0x0F : 0;
+            out[SCALE_HEADER_SIZE + pair] = static_cast<uint8_t>(low | (high << 4));
+        }
+    }
+}
+
+__global__ void halfKernel(const float* src, size_t count, uint16_t* dst) {
+    for (size_t i = blockIdx.x * size_t(blockDim.x) + threadIdx.x; i < count; i += size_t(gridDim.x) * blockDim.x) {
+        dst[i] = __half_as_ushort(__float2half_rn(src[i]));
+    }
+}
+
+__global__ void bfloat16Kernel(const float* src, size_t count, uint16_t* dst) {
+    for (size_t i = blockIdx.x * size_t(blockDim.x) + threadIdx.x; i < count; i += size_t(gridDim.x) * blockDim.x) {
+        dst[i] = __bfloat16_as_ushort(__float2bfloat16_rn(src[i]));
+    }
+}
+
+int gridForGroups(size_t count, size_t group_size) {
+    size_t groups = (count + group_size - 1) / group_size;
+    return static_cast<int>(groups < MAX_BLOCKS ? groups : MAX_BLOCKS);
+}
+
+} // namespace
+
+cudaError_t quantizeInt8Global(const float* src, size_t count, float scale, uint8_t* dst, cudaStream_t stream) {
+    int8GlobalKernel<<<gridFor(count), THREADS, 0, stream>>>(src, count, scale, dst);
+    return cudaGetLastError();
+}
+
+cudaError_t quantizeInt8Blocks(const float* src, size_t count, size_t block_size, uint8_t* dst,
+                               cudaStream_t stream) {
+    int8BlocksKernel<<<gridForGroups(count, block_size), THREADS, 0, stream>>>(src, count, block_size, dst);
+    return cudaGetLastError();
+}
+
+cudaError_t quantizeInt4Groups(const float* src, size_t count, size_t group_size, uint8_t* dst,
+                               cudaStream_t stream) {
+    int4GroupsKernel<<<gridForGroups(count, group_size), THREADS, 0, stream>>>(src, count, group_size, dst);
+    return cudaGetLastError();
+}
+
+cudaError_t convertToHalf(const float* src, size_t count, uint16_t* dst, cudaStream_t stream) {
+    halfKernel<<<gridFor(count), THREADS, 0, stream>>>(src, count, dst);
+    return cudaGetLastError();
+}
+
+cudaError_t convertToBfloat16(const float* src, size_t count, uint16_t* dst, cudaStream_t stream) {
+    bfloat16Kernel<<<gridFor(count), THREADS, 0, stream>>>(src, count, dst);
+    return cudaGetLastError();
+}
+
+} // namespace gpu
+} // namespace core
+} // namespace xenocomm
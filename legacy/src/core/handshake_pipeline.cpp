@@ -0,0 +1,187 @@
+#include "xenocomm/core/handshake_pipeline.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+struct HandshakePipeline::Impl : std::enable_shared_from_this<HandshakePipeline::Impl> {
+    struct Handshake {
+        std::shared_ptr<SecureContext> context;
+        Completion done;
+        std::mutex mutex;  // Serializes steps with each other and with finishing
+        EventReactor::TimerId timer{0};
+        uint32_t interest{0};
+        bool registered{false};
+        bool finished{false};
+    };
+
+    Impl(EventReactor& r, std::chrono::milliseconds t) : reactor(r), timeout(t) {}
+
+    void step(int fd, uint32_t events);
+    bool finish(int fd, const Result<void>* result);
+
+    EventReactor& reactor;
+    const std::chrono::milliseconds timeout;
+    mutable std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<Handshake>> handshakes;
+    bool closed{false};
+};
+
+void HandshakePipeline::Impl::step(int fd, uint32_t events) {
+    std::shared_ptr<Handshake> handshake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = handshakes.find(fd);
+        if (found == handshakes.end()) {
+            return;
+        }
+        handshake = found->second;
+    }
+
+    Result<void> outcome;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(handshake->mutex);
+        if (handshake->finished) {
+            return;
+        }
+        auto result = handshake->context->doHandshakeStep();
+        if (!result.has_value()) {
+            outcome = result;
+            done = true;
+        } else if (handshake->context->isHandshakeComplete()) {
+            done = true;
+        } else if (events & (EventReactor::CLOSED | EventReactor::FAILED)) {
+            // Anything the peer sent before going away has been consumed above
+            outcome = Result<void>(std::string("Connection closed during handshake"));
+            done = true;
+        } else {
+            uint32_t interest = handshake->context->handshakeWantsWrite() ? EventReactor::WRITABLE
+                                                                          : EventReactor::READABLE;
+            if (!handshake->registered) {
+                std::weak_ptr<Impl> weak = shared_from_this();
+                handshake->registered = reactor.add(fd, interest, [weak](int readyFd, uint32_t readyEvents) {
+                    if (auto impl = weak.lock()) {
+                        impl->step(readyFd, readyEvents);
+                    }
+                });
+                if (!handshake->registered) {
+                    outcome = Result<void>(std::string("Failed to watch socket for handshake"));
+                    done = true;
+                }
+            } else if (interest != handshake->interest) {
+                reactor.modify(fd, interest);
+            }
+            handshake->interest = interest;
+        }
+    }
+    if (done) {
+        finish(fd, &outcome);
+    }
+}
+
+bool HandshakePipeline::Impl::finish(int fd, const Result<void>* result) {
+    std::shared_ptr<Handshake> handshake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = handshakes.find(fd);
+        if (found == handshakes.end()) {
+            return false;
+        }
+        handshake = std::move(found->second);
+        handshakes.erase(found);
+    }
+
+    bool registered;
+    EventReactor::TimerId timer;
+    {
+        // Waits out a step in progress; later ones see finished and return
+        std::lock_guard<std::mutex> lock(handshake->mutex);
+        handshake->finished = true;
+        registered = handshake->registered;
+        timer = handshake->timer;
+    }
+    if (registered) {
+        reactor.remove(fd);
+    }
+    reactor.cancelTimer(timer);
+
+    if (result && handshake->done) {
+        handshake->done(*result);
+    }
+    return true;
+}
+
+HandshakePipeline::HandshakePipeline(EventReactor& reactor, std::chrono::milliseconds timeout)
+    : impl_(std::make_shared<Impl>(reactor, timeout)) {}
+
+HandshakePipeline::~HandshakePipeline() {
+    std::vector<int> fds;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->closed = true;
+        for (const auto& entry : impl_->handshakes) {
+            fds.push_back(entry.first);
+        }
+    }
+    for (int fd : fds) {
+        impl_->finish(fd, nullptr);
+    }
+}
+
+bool HandshakePipeline::start(int fd, std::shared_ptr<SecureContext> context, Completion done) {
+    if (fd < 0 || !context) {
+        return false;
+    }
+    auto handshake = std::make_shared<Impl::Handshake>();
+    handshake->context = std::move(context);
+    handshake->done = std::move(done);
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (impl_->closed || impl_->handshakes.count(fd) > 0) {
+            return false;
+        }
+        if (!handshake->context->attachSocket(fd)) {
+            return false;
+        }
+        impl_->handshakes.emplace(fd, handshake);
+    }
+
+    std::weak_ptr<Impl> weak = impl_;
+    auto timer = impl_->reactor.scheduleAfter(impl_->timeout, [weak, fd] {
+        if (auto impl = weak.lock()) {
+            Result<void> timedOut(std::string("Handshake timed out"));
+            impl->finish(fd, &timedOut);
+        }
+    });
+    {
+        std::lock_guard<std::mutex> lock(handshake->mutex);
+        if (handshake->finished) {
+            impl_->reactor.cancelTimer(timer);
+        } else {
+            handshake->timer = timer;
+        }
+    }
+
+    // The first flight is written without waiting for readiness
+    impl_->reactor.post([weak, fd] {
+        if (auto impl = weak.lock()) {
+            impl->step(fd, 0);
+        }
+    });
+    return true;
+}
+
+bool HandshakePipeline::cancel(int fd) {
+    return impl_->finish(fd, nullptr);
+}
+
+size_t HandshakePipeline::inFlight() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->handshakes.size();
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,607 @@
+#include "xenocomm/core/io_uring_engine.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define XENOCOMM_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace xenocomm {
+namespace core {
+
+#ifdef XENOCOMM_HAVE_IO_URING
+
+namespace {
+
+// user_data values outside the operation id space; ids start at 1
+constexpr uint64_t WAKE_TAG = 0;
+constexpr uint64_t TIMEOUT_TAG = ~uint64_t(0);
+constexpr uint64_t CANCEL_TAG = ~uint64_t(0) - 1;
+constexpr uint16_t BUFFER_GROUP = 0;
+
+int ringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ringEnter(int fd, unsigned submit, unsigned wait, unsigned flags) {
+    int result;
+    do {
+        result = static_cast<int>(::syscall(__NR_io_uring_enter, fd, submit, wait, flags, nullptr, 0));
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+
+int ringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+bool opcodesSupported(int fd) {
+    constexpr unsigned PROBE_OPS = 256;
+    std::unique_ptr<uint8_t[]> storage(
+        new uint8_t[sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op)]());
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.get());
+    if (ringRegister(fd, IORING_REGISTER_PROBE, probe, PROBE_OPS) < 0) {
+        return false;
+    }
+    for (unsigned op : {IORING_OP_SEND, IORING_OP_RECV, IORING_OP_LINK_TIMEOUT, IORING_OP_ASYNC_CANCEL}) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Multishot recv has no probe or feature bit; it landed in 6.0
+bool kernelHasMultishotRecv() {
+    utsname info{};
+    if (::uname(&info) != 0) {
+        return false;
+    }
+    int major = 0;
+    if (std::sscanf(info.release, "%d", &major) != 1) {
+        return false;
+    }
+    return major >= 6;
+}
+
+bool isPowerOfTwo(unsigned value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+} // namespace
+
+struct IoUringEngine::Operation {
+    uint8_t opcode = IORING_OP_NOP;
+    int fd = -1;
+    void* buffer = nullptr;
+    size_t size = 0;
+    bool multishot = false;
+    Completion completion;
+    StreamCallback stream;
+    uint64_t id = 0;
+    __kernel_timespec timeout{};
+    std::mutex running;
+    std::atomic<bool> active{true};
+};
+
+struct IoUringEngine::Ring {
+    void* sqMap = MAP_FAILED;
+    size_t sqMapSize = 0;
+    void* cqMap = MAP_FAILED;
+    size_t cqMapSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    std::mutex submitLock;
+    uint64_t nextId = 1;
+
+    std::mutex opsLock;
+    std::unordered_map<uint64_t, std::shared_ptr<Operation>> operations;
+
+    unsigned short bufferTail = 0;  // Only touched by the completion thread after setup
+    std::thread completionThread;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) ::munmap(sqes, sqesSize);
+        if (cqMap != MAP_FAILED && cqMap != sqMap) ::munmap(cqMap, cqMapSize);
+        if (sqMap != MAP_FAILED) ::munmap(sqMap, sqMapSize);
+    }
+
+    // Caller holds submitLock
+    bool reserve(unsigned count, unsigned& tail) {
+        tail = *sqTail;
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        return sqEntries - (tail - head) >= count;
+    }
+
+    io_uring_sqe* slot(unsigned index) {
+        unsigned masked = index & sqMask;
+        sqArray[masked] = masked;
+        io_uring_sqe* sqe = &sqes[masked];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void publish(int ringFd, unsigned tail, unsigned count) {
+        __atomic_store_n(sqTail, tail + count, __ATOMIC_RELEASE);
+        ringEnter(ringFd, count, 0, 0);
+    }
+};
+
+IoUringEngine::IoUringEngine(const Config& config) : config_(config) {
+    if (std::getenv("XENOCOMM_DISABLE_IO_URING") != nullptr) {
+        return;
+    }
+
+    io_uring_params params{};
+    int fd = ringSetup(config_.entries, &params);
+    if (fd < 0) {
+        return;  // ENOSYS on old kernels, EPERM under restrictive seccomp profiles
+    }
+
+    auto ring = std::make_unique<Ring>();
+    ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        ring->sqMapSize = ring->cqMapSize = std::max(ring->sqMapSize, ring->cqMapSize);
+    }
+
+    ring->sqMap = ::mmap(nullptr, ring->sqMapSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sqMap != MAP_FAILED) {
+        ring->cqMap = singleMap ? ring->sqMap
+                                : ::mmap(nullptr, ring->cqMapSize, PROT_READ | PROT_WRITE,
+                                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    }
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    if (ring->cqMap != MAP_FAILED) {
+        ring->sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    }
+    if (ring->sqes == MAP_FAILED || !(params.features & IORING_FEAT_NODROP) || !opcodesSupported(fd)) {
+        ring.reset();
+        ::close(fd);
+        return;
+    }
+
+    auto* sq = static_cast<uint8_t*>(ring->sqMap);
+    auto* cq = static_cast<uint8_t*>(ring->cqMap);
+    ring->sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->sqEntries = params.sq_entries;
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+#ifdef IORING_RECV_MULTISHOT
+    // Provided buffer ring for multishot receive; streams stay disabled if any step fails
+    if (kernelHasMultishotRecv() && isPowerOfTwo(config_.buffer_count) &&
+        config_.buffer_count <= 32768 && config_.buffer_size > 0) {
+        bufferRingBytes_ = config_.buffer_count * sizeof(io_uring_buf);
+        void* memory = ::mmap(nullptr, bufferRingBytes_, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory != MAP_FAILED) {
+            io_uring_buf_reg reg{};
+            reg.ring_addr = reinterpret_cast<uint64_t>(memory);
+            reg.ring_entries = config_.buffer_count;
+            reg.bgid = BUFFER_GROUP;
+            if (ringRegister(fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0) {
+                bufferRing_ = memory;
+                buffers_.reset(new uint8_t[config_.buffer_count * config_.buffer_size]);
+            } else {
+                ::munmap(memory, bufferRingBytes_);
+            }
+        }
+    }
+#endif
+
+    ringFd_ = fd;
+    ring_ = std::move(ring);
+    if (bufferRing_) {
+        for (unsigned i = 0; i < config_.buffer_count; ++i) {
+            recycleBuffer(static_cast<uint16_t>(i));
+        }
+    }
+    ring_->completionThread = std::thread([this] { completionLoop(); });
+}
+
+IoUringEngine::~IoUringEngine() {
+    if (ringFd_ < 0) {
+        return;
+    }
+
+    stopping_ = true;
+    {
+        // Cancel whatever is still in flight, then wake the completion thread
+        std::lock_guard<std::mutex> lock(ring_->submitLock);
+        unsigned tail;
+        unsigned count = 0;
+        if (ring_->reserve(2, tail)) {
+#ifdef IORING_ASYNC_CANCEL_ANY
+            io_uring_sqe* cancel = ring_->slot(tail + count++);
+            cancel->opcode = IORING_OP_ASYNC_CANCEL;
+            cancel->fd = -1;
+            cancel->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            cancel->user_data = CANCEL_TAG;
+#endif
+            io_uring_sqe* wake = ring_->slot(tail + count++);
+            wake->opcode = IORING_OP_NOP;
+            wake->user_data = WAKE_TAG;
+            ring_->publish(ringFd_, tail, count);
+        }
+    }
+    if (ring_->completionThread.joinable()) {
+        ring_->completionThread.join();
+    }
+
+    ::close(ringFd_);
+    if (bufferRing_) {
+        ::munmap(bufferRing_, bufferRingBytes_);
+    }
+
+    // Anything the kernel did not complete before shutdown is reported as cancelled
+    for (auto& entry : ring_->operations) {
+        auto& operation = entry.second;
+        if (operation->multishot) {
+            if (operation->active) operation->stream(nullptr, -ECANCELED);
+        } else if (operation->completion) {
+            operation->completion(-ECANCELED);
+        }
+    }
+}
+
+IoUringEngine* IoUringEngine::shared() {
+    // Leaked on purpose: transports may still complete I/O during static destruction
+    static IoUringEngine* engine = [] {
+        auto* created = new IoUringEngine();
+        if (!created->isValid()) {
+            delete created;
+            return static_cast<IoUringEngine*>(nullptr);
+        }
+        return created;
+    }();
+    return engine;
+}
+
+bool IoUringEngine::submitSend(int fd, const uint8_t* data, size_t size, Completion completion,
+                               std::chrono::milliseconds timeout, OperationId* id) {
+    auto operation = std::make_shared<Operation>();
+    operation->opcode = IORING_OP_SEND;
+    operation->fd = fd;
+    operation->buffer = const_cast<uint8_t*>(data);
+    operation->size = size;
+    operation->completion = std::move(completion);
+    if (!submit(operation, timeout)) {
+        return false;
+    }
+    if (id) {
+        *id = operation->id;
+    }
+    return true;
+}
+
+bool IoUringEngine::submitRecv(int fd, uint8_t* buffer, size_t size, Completion completion,
+                               std::chrono::milliseconds timeout, OperationId* id) {
+    auto operation = std::make_shared<Operation>();
+    operation->opcode = IORING_OP_RECV;
+    operation->fd = fd;
+    operation->buffer = buffer;
+    operation->size = size;
+    operation->completion = std::move(completion);
+    if (!submit(operation, timeout)) {
+        return false;
+    }
+    if (id) {
+        *id = operation->id;
+    }
+    return true;
+}
+
+IoUringEngine::StreamId IoUringEngine::startRecvStream(int fd, StreamCallback callback) {
+    if (!supportsStreams()) {
+        return 0;
+    }
+    auto operation = std::make_shared<Operation>();
+    operation->opcode = IORING_OP_RECV;
+    operation->fd = fd;
+    operation->multishot = true;
+    operation->stream = std::move(callback);
+    return submit(operation, std::chrono::milliseconds(0)) ? operation->id : 0;
+}
+
+void IoUringEngine::stopRecvStream(StreamId id) {
+    if (ringFd_ < 0) {
+        return;
+    }
+    std::shared_ptr<Operation> operation;
+    {
+        std::lock_guard<std::mutex> lock(ring_->opsLock);
+        auto it = ring_->operations.find(id);
+        if (it == ring_->operations.end()) {
+            return;
+        }
+        operation = it->second;
+    }
+    operation->active = false;
+    cancel(id);
+    if (ring_->completionThread.get_id() != std::this_thread::get_id()) {
+        std::lock_guard<std::mutex> wait(operation->running);
+    }
+}
+
+void IoUringEngine::cancel(OperationId id) {
+    if (ringFd_ < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(ring_->submitLock);
+    unsigned tail;
+    if (ring_->reserve(1, tail)) {
+        io_uring_sqe* sqe = ring_->slot(tail);
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = id;
+        sqe->user_data = CANCEL_TAG;
+        ring_->publish(ringFd_, tail, 1);
+    }
+}
+
+void IoUringEngine::cancelFd(int fd) {
+#ifdef IORING_ASYNC_CANCEL_FD
+    if (ringFd_ < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(ring_->submitLock);
+    unsigned tail;
+    if (ring_->reserve(1, tail)) {
+        io_uring_sqe* sqe = ring_->slot(tail);
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = fd;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = CANCEL_TAG;
+        ring_->publish(ringFd_, tail, 1);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+bool IoUringEngine::submit(const std::shared_ptr<Operation>& operation, std::chrono::milliseconds timeout) {
+    if (ringFd_ < 0 || stopping_) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(ring_->submitLock);
+    unsigned count = timeout.count() > 0 ? 2 : 1;
+    unsigned tail;
+    if (!ring_->reserve(count, tail)) {
+        return false;
+    }
+
+    bool rearm = operation->id != 0;
+    if (!rearm) {
+        operation->id = ring_->nextId++;
+        std::lock_guard<std::mutex> opsLock(ring_->opsLock);
+        ring_->operations.emplace(operation->id, operation);
+    }
+
+    io_uring_sqe* sqe = ring_->slot(tail);
+    sqe->opcode = operation->opcode;
+    sqe->fd = operation->fd;
+    sqe->user_data = operation->id;
+    if (operation->multishot) {
+#ifdef IORING_RECV_MULTISHOT
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+#endif
+    } else {
+        sqe->addr = reinterpret_cast<uint64_t>(operation->buffer);
+        sqe->len = static_cast<uint32_t>(std::min<size_t>(operation->size, UINT32_MAX));
+        if (operation->opcode == IORING_OP_SEND) {
+            sqe->msg_flags = MSG_NOSIGNAL;
+        }
+    }
+
+    if (count == 2) {
+        sqe->flags |= IOSQE_IO_LINK;
+        operation->timeout.tv_sec = timeout.count() / 1000;
+        operation->timeout.tv_nsec = (timeout.count() % 1000) * 1000000;
+        io_uring_sqe* link = ring_->slot(tail + 1);
+        link->opcode = IORING_OP_LINK_TIMEOUT;
+        link->fd = -1;
+        link->addr = reinterpret_cast<uint64_t>(&operation->timeout);
+        link->len = 1;
+        link->user_data = TIMEOUT_TAG;
+    }
+
+    if (!rearm) {
+        ++pending_;
+    }
+    ring_->publish(ringFd_, tail, count);
+    return true;
+}
+
+void IoUringEngine::recycleBuffer(uint16_t bufferId) {
+#ifdef IORING_RECV_MULTISHOT
+    // Index the entries by hand: in C++ the header's flexible-array wrapper shifts
+    // io_uring_buf_ring::bufs by the size of an empty struct. The tail overlays bufs[0].resv.
+    auto* entries = static_cast<io_uring_buf*>(bufferRing_);
+    io_uring_buf& entry = entries[ring_->bufferTail & (config_.buffer_count - 1)];
+    entry.addr = reinterpret_cast<uint64_t>(buffers_.get() + size_t(bufferId) * config_.buffer_size);
+    entry.len = static_cast<uint32_t>(config_.buffer_size);
+    entry.bid = bufferId;
+    ++ring_->bufferTail;
+    __atomic_store_n(&entries[0].resv, ring_->bufferTail, __ATOMIC_RELEASE);
+#else
+    (void)bufferId;
+#endif
+}
+
+void IoUringEngine::completionLoop() {
+    // On shutdown, cancelled operations get a bounded window to report back
+    constexpr auto DRAIN_TIMEOUT = std::chrono::milliseconds(500);
+    std::chrono::steady_clock::time_point drainDeadline{};
+
+    while (true) {
+        unsigned head = *ring_->cqHead;
+        unsigned tail = __atomic_load_n(ring_->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            if (stopping_) {
+                auto now = std::chrono::steady_clock::now();
+                if (drainDeadline == std::chrono::steady_clock::time_point{}) {
+                    drainDeadline = now + DRAIN_TIMEOUT;
+                }
+                if (pending_ == 0 || now > drainDeadline) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } else if (ringEnter(ringFd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+                       errno != EAGAIN && errno != EBUSY) {
+                return;
+            }
+            continue;
+        }
+
+        for (; head != tail; ++head) {
+            io_uring_cqe cqe = ring_->cqes[head & ring_->cqMask];
+            __atomic_store_n(ring_->cqHead, head + 1, __ATOMIC_RELEASE);
+            if (cqe.user_data == WAKE_TAG || cqe.user_data == TIMEOUT_TAG || cqe.user_data == CANCEL_TAG) {
+                continue;
+            }
+
+            std::shared_ptr<Operation> operation;
+            {
+                std::lock_guard<std::mutex> lock(ring_->opsLock);
+                auto it = ring_->operations.find(cqe.user_data);
+                if (it != ring_->operations.end()) {
+                    operation = it->second;
+                }
+            }
+
+#ifdef IORING_RECV_MULTISHOT
+            bool hasBuffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+            uint16_t bufferId = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+#else
+            bool hasBuffer = false;
+            uint16_t bufferId = 0;
+            bool more = false;
+#endif
+            if (!operation) {
+                if (hasBuffer) recycleBuffer(bufferId);
+                continue;
+            }
+
+            if (!operation->multishot) {
+                {
+                    std::lock_guard<std::mutex> lock(ring_->opsLock);
+                    ring_->operations.erase(cqe.user_data);
+                }
+                --pending_;
+                if (operation->completion) {
+                    operation->completion(cqe.res);
+                }
+                continue;
+            }
+
+            if (cqe.res > 0 && hasBuffer) {
+                std::lock_guard<std::mutex> running(operation->running);
+                if (operation->active) {
+                    operation->stream(buffers_.get() + size_t(bufferId) * config_.buffer_size, cqe.res);
+                }
+            }
+            if (hasBuffer) {
+                recycleBuffer(bufferId);
+            }
+            if (more) {
+                continue;
+            }
+
+            // The kernel also ends a multishot recv when the buffer ring runs dry; that is not end of stream
+            bool rearm = operation->active && !stopping_ && (cqe.res > 0 || cqe.res == -ENOBUFS);
+            if (rearm && submit(operation, std::chrono::milliseconds(0))) {
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> running(operation->running);
+                if (operation->active) {
+                    operation->stream(nullptr, cqe.res > 0 ? -ENOBUFS : cqe.res);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(ring_->opsLock);
+                ring_->operations.erase(cqe.user_data);
+            }
+            --pending_;
+        }
+    }
+}
+
+#else // !XENOCOMM_HAVE_IO_URING
+
+struct IoUringEngine::Ring {};
+struct IoUringEngine::Operation {};
+
+IoUringEngine::IoUringEngine(const Config& config) : config_(config) {}
+IoUringEngine::~IoUringEngine() = default;
+
+IoUringEngine* IoUringEngine::shared() {
+    return nullptr;
+}
+
+bool IoUringEngine::submitSend(int, const uint8_t*, size_t, Completion, std::chrono::milliseconds, OperationId*) {
+    return false;
+}
+
+bool IoUringEngine::submitRecv(int, uint8_t*, size_t, Completion, std::chrono::milliseconds, OperationId*) {
+    return false;
+}
+
+IoUringEngine::StreamId IoUringEngine::startRecvStream(int, StreamCallback) {
+    return 0;
+}
+
+void IoUringEngine::stopRecvStream(StreamId) {}
+void IoUringEngine::cancel(OperationId) {}
+void IoUringEngine::cancelFd(int) {}
+
+bool IoUringEngine::submit(const std::shared_ptr<Operation>&, std::chrono::milliseconds) {
+    return false;
+}
+
+void IoUringEngine::completionLoop() {}
+void IoUringEngine::recycleBuffer(uint16_t) {}
+
+#endif // XENOCOMM_HAVE_IO_URING
+
+} // namespace core
+} // namespace xenocomm
@@ -5,6 +5,7 @@
 #include <openssl/dh.h>
 #include <openssl/ec.h>
 #include <openssl/bio.h>
+#include <openssl/objects.h>
 #include <openssl/pem.h>
 #include <openssl/x509.h>
 #include <openssl/ssl.h>
@@ -12,15 +13,95 @@
 #include <iomanip>
 #include <mutex>
 #include <ctime>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
+#include <utility>
 #include <uuid/uuid.h>
 
 namespace xenocomm {
 namespace core {
 
+namespace {
+
+struct EvpPkeyDeleter {
+    void operator()(EVP_PKEY* key) const { EVP_PKEY_free(key); }
+};
+using EvpPkeyPtr = std::unique_ptr<EVP_PKEY, EvpPkeyDeleter>;
+
+// Curves the key pool keeps ephemeral key pairs for, indexing KeyManagerImpl::ephemeralPool_
+enum PooledCurve : size_t { CURVE_P256, CURVE_X25519, POOLED_CURVES };
+
+template <typename T>
+struct PoolSlot {
+    std::deque<T> ready;   // Oldest first
+    bool inUse = false;    // Refilled once anything has been taken
+    size_t taken = 0;      // In the current demand window
+    size_t lastTaken = 0;  // In the previous one
+
+    size_t target(const KeyPoolConfig& config) const {
+        if (!inUse) {
+            return 0;
+        }
+        return std::clamp(std::max(taken, lastTaken), config.minPooled, config.maxPooled);
+    }
+};
+
+EvpPkeyPtr generateEphemeralKey(PooledCurve curve) {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(curve == CURVE_X25519 ? EVP_PKEY_X25519 : EVP_PKEY_EC, nullptr);
+    EVP_PKEY* key = nullptr;
+    if (ctx && EVP_PKEY_keygen_init(ctx) > 0 &&
+        (curve == CURVE_X25519 || EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx, NID_X9_62_prime256v1) > 0) &&
+        EVP_PKEY_keygen(ctx, &key) <= 0) {
+        key = nullptr;
+    }
+    EVP_PKEY_CTX_free(ctx);
+    return EvpPkeyPtr(key);
+}
+
+// An ephemeral key on the same curve as a peer key the pool has no curve for
+EvpPkeyPtr generateKeyLike(EVP_PKEY* peerKey) {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new(peerKey, nullptr);
+    EVP_PKEY* key = nullptr;
+    if (ctx && EVP_PKEY_keygen_init(ctx) > 0 && EVP_PKEY_keygen(ctx, &key) <= 0) {
+        key = nullptr;
+    }
+    EVP_PKEY_CTX_free(ctx);
+    return EvpPkeyPtr(key);
+}
+
+std::optional<PooledCurve> pooledCurveOf(EVP_PKEY* key) {
+    switch (EVP_PKEY_base_id(key)) {
+        case EVP_PKEY_X25519:
+            return CURVE_X25519;
+        case EVP_PKEY_EC: {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+            char group[80];
+            size_t length = 0;
+            if (EVP_PKEY_get_group_name(key, group, sizeof(group), &length) == 1 &&
+                OBJ_sn2nid(group) == NID_X9_62_prime256v1) {
+                return CURVE_P256;
+            }
+#else
+            const EC_KEY* ec = EVP_PKEY_get0_EC_KEY(key);
+            if (ec && EC_GROUP_get_curve_name(EC_KEY_get0_group(ec)) == NID_X9_62_prime256v1) {
+                return CURVE_P256;
+            }
+#endif
+            return std::nullopt;
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+} // namespace
+
 // Forward declaration of implementation class
 class KeyManagerImpl {
 public:
-    explicit KeyManagerImpl(const SecurityConfig& config);
+    KeyManagerImpl(const SecurityConfig& config, std::function<void()> onPoolLow);
     ~KeyManagerImpl();
 
     Result<std::vector<uint8_t>> generateSymmetricKey(size_t keySize);
@@ -28,6 +109,9 @@ public:
     Result<std::vector<uint8_t>> performDHKeyExchange(const std::vector<uint8_t>& peerPublicKey);
     Result<std::vector<uint8_t>> performECDHKeyExchange(const std::vector<uint8_t>& peerPublicKey);
 
+    void refillPool();
+    KeyPoolStats poolStats() const;
+
 private:
     const SecurityConfig& config_;
     EVP_PKEY_CTX* dhCtx_;
@@ -35,14 +119,34 @@ private:
     
     void initializeOpenSSL();
     void cleanupOpenSSL();
+
+    std::optional<std::vector<uint8_t>> takePooledSymmetricKey(size_t bytes);
+    EvpPkeyPtr takeEphemeralKey(PooledCurve curve);
+    template <typename T>
+    std::optional<T> takeLocked(PoolSlot<T>& slot, bool& low);
+    void rollDemandWindow(std::chrono::steady_clock::time_point now);
+
+    std::function<void()> onPoolLow_;  // Asks for refillPool() to run soon
+    mutable std::mutex poolMutex_;
+    std::map<size_t, PoolSlot<std::vector<uint8_t>>> symmetricPool_;  // By key length in bytes
+    std::array<PoolSlot<EvpPkeyPtr>, POOLED_CURVES> ephemeralPool_;
+    std::chrono::steady_clock::time_point windowStart_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
 };
 
-KeyManagerImpl::KeyManagerImpl(const SecurityConfig& config) 
-    : config_(config), dhCtx_(nullptr), ecdhCtx_(nullptr) {
+KeyManagerImpl::KeyManagerImpl(const SecurityConfig& config, std::function<void()> onPoolLow)
+    : config_(config), dhCtx_(nullptr), ecdhCtx_(nullptr), onPoolLow_(std::move(onPoolLow)),
+      windowStart_(std::chrono::steady_clock::now()) {
     initializeOpenSSL();
 }
 
 KeyManagerImpl::~KeyManagerImpl() {
+    for (auto& [bytes, slot] : symmetricPool_) {
+        for (auto& key : slot.ready) {
+            OPENSSL_cleanse(key.data(), key.size());
+        }
+    }
     cleanupOpenSSL();
 }
 
@@ -66,6 +170,9 @@ void KeyManagerImpl::cleanupOpenSSL() {
 }
 
 Result<std::vector<uint8_t>> KeyManagerImpl::generateSymmetricKey(size_t keySize) {
+    if (auto pooled = takePooledSymmetricKey(keySize / 8)) {
+        return Result<std::vector<uint8_t>>(std::move(*pooled));
+    }
     std::vector<uint8_t> key(keySize / 8);
     if (RAND_bytes(key.data(), key.size()) != 1) {
         return Result<std::vector<uint8_t>>(std::string("Failed to generate symmetric key"));
@@ -77,21 +184,8 @@ Result<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>
 KeyManagerImpl::generateAsymmetricKeyPair(size_t keySize) {
     (void)keySize; // Suppress unused parameter warning
     
-    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
-    if (!ctx) {
-        return Result<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>(
-            std::string("Failed to create key generation context"));
-    }
-
-    if (EVP_PKEY_keygen_init(ctx) <= 0) {
-        EVP_PKEY_CTX_free(ctx);
-        return Result<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>(
-            std::string("Failed to initialize key generation"));
-    }
-
-    EVP_PKEY* key = nullptr;
-    if (EVP_PKEY_keygen(ctx, &key) <= 0) {
-        EVP_PKEY_CTX_free(ctx);
+    EvpPkeyPtr key = takeEphemeralKey(CURVE_P256);
+    if (!key) {
         return Result<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>(
             std::string("Failed to generate key pair"));
     }
@@ -100,8 +194,8 @@ KeyManagerImpl::generateAsymmetricKeyPair(size_t keySize) {
     BIO* pubBio = BIO_new(BIO_s_mem());
     BIO* privBio = BIO_new(BIO_s_mem());
     
-    PEM_write_bio_PUBKEY(pubBio, key);
-    PEM_write_bio_PrivateKey(privBio, key, nullptr, nullptr, 0, nullptr, nullptr);
+    PEM_write_bio_PUBKEY(pubBio, key.get());
+    PEM_write_bio_PrivateKey(privBio, key.get(), nullptr, nullptr, 0, nullptr, nullptr);
 
     char* pubData;
     char* privData;
@@ -113,8 +207,6 @@ KeyManagerImpl::generateAsymmetricKeyPair(size_t keySize) {
 
     BIO_free(pubBio);
     BIO_free(privBio);
-    EVP_PKEY_free(key);
-    EVP_PKEY_CTX_free(ctx);
 
     return Result<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>(
         std::make_pair(std::move(publicKey), std::move(privateKey)));
@@ -185,36 +277,30 @@ Result<std::vector<uint8_t>> KeyManagerImpl::performDHKeyExchange(
 Result<std::vector<uint8_t>> KeyManagerImpl::performECDHKeyExchange(
     const std::vector<uint8_t>& peerPublicKey) {
     // Implementation of ECDH key exchange
-    EVP_PKEY* privKey = nullptr;
-    EVP_PKEY* peerKey = nullptr;
+    EvpPkeyPtr privKey;
+    EvpPkeyPtr peerKey;
     EVP_PKEY_CTX* ctx = nullptr;
     unsigned char* secret = nullptr;
     size_t secretLen;
     Result<std::vector<uint8_t>> result(std::string("ECDH key exchange failed"));
 
     do {
-        // Generate EC key pair
-        if (!(ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr))) break;
-        if (EVP_PKEY_paramgen_init(ctx) <= 0) break;
-        if (EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx, NID_X9_62_prime256v1) <= 0) break;
-        if (EVP_PKEY_keygen_init(ctx) <= 0) break;
-        if (EVP_PKEY_keygen(ctx, &privKey) <= 0) break;
-
         // Load peer's public key
         BIO* peerBio = BIO_new_mem_buf(peerPublicKey.data(), static_cast<int>(peerPublicKey.size()));
         if (!peerBio) break;
-        
-        // The correct way to use PEM_read_bio_* functions is to pass NULL for the second arg if we want a new object
-        peerKey = nullptr;
-        peerKey = PEM_read_bio_PUBKEY(peerBio, &peerKey, nullptr, nullptr);
+        peerKey.reset(PEM_read_bio_PUBKEY(peerBio, nullptr, nullptr, nullptr));
         BIO_free(peerBio);
         if (!peerKey) break;
 
+        // Ephemeral key pair on the peer's curve, pre-generated where the pool covers it
+        auto curve = pooledCurveOf(peerKey.get());
+        privKey = curve ? takeEphemeralKey(*curve) : generateKeyLike(peerKey.get());
+        if (!privKey) break;
+
         // Derive shared secret
-        EVP_PKEY_CTX_free(ctx);
-        if (!(ctx = EVP_PKEY_CTX_new(privKey, nullptr))) break;
+        if (!(ctx = EVP_PKEY_CTX_new(privKey.get(), nullptr))) break;
         if (EVP_PKEY_derive_init(ctx) <= 0) break;
-        if (EVP_PKEY_derive_set_peer(ctx, peerKey) <= 0) break;
+        if (EVP_PKEY_derive_set_peer(ctx, peerKey.get()) <= 0) break;
         if (EVP_PKEY_derive(ctx, nullptr, &secretLen) <= 0) break;
         
         secret = static_cast<unsigned char*>(OPENSSL_malloc(secretLen));
@@ -229,18 +315,197 @@ Result<std::vector<uint8_t>> KeyManagerImpl::performECDHKeyExchange(
     } while (false);
 
     // Cleanup
-    if (secret) OPENSSL_free(secret);
+    if (secret) OPENSSL_clear_free(secret, secretLen);
     if (ctx) EVP_PKEY_CTX_free(ctx);
-    if (privKey) EVP_PKEY_free(privKey);
-    if (peerKey) EVP_PKEY_free(peerKey);
 
     return result;
 }
 
+std::optional<std::vector<uint8_t>> KeyManagerImpl::takePooledSymmetricKey(size_t bytes) {
+    if (!config_.keyPool.enabled) {
+        return std::nullopt;
+    }
+    bool low = false;
+    std::optional<std::vector<uint8_t>> key;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        key = takeLocked(symmetricPool_[bytes], low);
+    }
+    if (low) {
+        onPoolLow_();
+    }
+    return key;
+}
+
+EvpPkeyPtr KeyManagerImpl::takeEphemeralKey(PooledCurve curve) {
+    if (config_.keyPool.enabled) {
+        bool low = false;
+        std::optional<EvpPkeyPtr> key;
+        {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            key = takeLocked(ephemeralPool_[curve], low);
+        }
+        if (low) {
+            onPoolLow_();
+        }
+        if (key) {
+            return std::move(*key);
+        }
+    }
+    return generateEphemeralKey(curve);
+}
+
+// Requires poolMutex_. low is set once the slot is below half its target, so refills come in batches.
+template <typename T>
+std::optional<T> KeyManagerImpl::takeLocked(PoolSlot<T>& slot, bool& low) {
+    slot.inUse = true;
+    ++slot.taken;
+    std::optional<T> item;
+    if (slot.ready.empty()) {
+        ++misses_;
+    } else {
+        item.emplace(std::move(slot.ready.front()));
+        slot.ready.pop_front();
+        ++hits_;
+    }
+    low = slot.ready.size() * 2 < slot.target(config_.keyPool);
+    return item;
+}
+
+// Requires poolMutex_
+void KeyManagerImpl::rollDemandWindow(std::chrono::steady_clock::time_point now) {
+    const auto window = config_.keyPool.demandWindow;
+    if (now - windowStart_ < window) {
+        return;
+    }
+    // A whole window without a refill run means nothing was taken in the last one either
+    bool skipped = now - windowStart_ >= 2 * window;
+    auto roll = [skipped](auto& slot) {
+        slot.lastTaken = skipped ? 0 : slot.taken;
+        slot.taken = 0;
+    };
+    for (auto& [bytes, slot] : symmetricPool_) {
+        roll(slot);
+    }
+    for (auto& slot : ephemeralPool_) {
+        roll(slot);
+    }
+    windowStart_ = now;
+}
+
+void KeyManagerImpl::refillPool() {
+    std::vector<std::pair<size_t, size_t>> symmetric;  // Key length in bytes, keys to add
+    std::array<size_t, POOLED_CURVES> ephemeral{};
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        rollDemandWindow(std::chrono::steady_clock::now());
+        for (auto& [bytes, slot] : symmetricPool_) {
+            size_t target = slot.target(config_.keyPool);
+            if (slot.ready.size() < target) {
+                symmetric.emplace_back(bytes, target - slot.ready.size());
+            }
+            // Keys left over from a burst that has passed; the newest go first
+            while (slot.ready.size() > target) {
+                OPENSSL_cleanse(slot.ready.back().data(), slot.ready.back().size());
+                slot.ready.pop_back();
+            }
+        }
+        for (size_t curve = 0; curve < POOLED_CURVES; ++curve) {
+            auto& slot = ephemeralPool_[curve];
+            size_t target = slot.target(config_.keyPool);
+            if (slot.ready.size() < target) {
+                ephemeral[curve] = target - slot.ready.size();
+            }
+            while (slot.ready.size() > target) {
+                slot.ready.pop_back();
+            }
+        }
+    }
+
+    // Generated without the lock and published one at a time, so takers neither wait nor miss for long
+    for (const auto& [bytes, count] : symmetric) {
+        for (size_t n = 0; n < count; ++n) {
+            std::vector<uint8_t> key(bytes);
+            if (RAND_bytes(key.data(), static_cast<int>(key.size())) != 1) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            symmetricPool_[bytes].ready.push_back(std::move(key));
+        }
+    }
+    for (size_t curve = 0; curve < POOLED_CURVES; ++curve) {
+        for (size_t n = 0; n < ephemeral[curve]; ++n) {
+            EvpPkeyPtr key = generateEphemeralKey(static_cast<PooledCurve>(curve));
+            if (!key) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            ephemeralPool_[curve].ready.push_back(std::move(key));
+        }
+    }
+}
+
+KeyPoolStats KeyManagerImpl::poolStats() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    KeyPoolStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    for (const auto& [bytes, slot] : symmetricPool_) {
+        stats.pooledSymmetric += slot.ready.size();
+    }
+    for (const auto& slot : ephemeralPool_) {
+        stats.pooledEphemeral += slot.ready.size();
+    }
+    return stats;
+}
+
 // KeyManager implementation
 
+namespace {
+
+bool isUsable(const KeyData& key, std::chrono::system_clock::time_point now) {
+    return !key.isRevoked && key.expiryTime > now;
+}
+
+} // namespace
+
 KeyManager::KeyManager(const SecurityConfig& config)
-    : config_(config), impl_(std::make_unique<KeyManagerImpl>(config)) {
+    : config_(config),
+      keyStore_(std::make_shared<const KeyStore>()),
+      impl_(std::make_unique<KeyManagerImpl>(config_, [this] { requestPoolRefill(); })) {
+    maintenanceTask_ = utils::TaskScheduler::shared().add([this] { runMaintenance(); });
+    if (config_.keyPool.enabled) {
+        poolTask_ = utils::TaskScheduler::shared().scheduleEvery(config_.keyPool.demandWindow,
+                                                                 [this] { impl_->refillPool(); });
+    }
+}
+
+KeyManager::~KeyManager() {
+    stopMaintenance();
+}
+
+void KeyManager::stopMaintenance() {
+    utils::TaskScheduler::TaskId task;
+    utils::TaskScheduler::TaskId poolTask;
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex_);
+        stopping_ = true;
+        task = std::exchange(maintenanceTask_, utils::TaskScheduler::INVALID_TASK);
+        poolTask = std::exchange(poolTask_, utils::TaskScheduler::INVALID_TASK);
+    }
+    utils::TaskScheduler::shared().cancel(task);
+    utils::TaskScheduler::shared().cancel(poolTask);
+}
+
+KeyPoolStats KeyManager::getKeyPoolStats() const {
+    return impl_->poolStats();
+}
+
+void KeyManager::requestPoolRefill() {
+    std::lock_guard<std::mutex> lock(scheduleMutex_);
+    if (poolTask_ != utils::TaskScheduler::INVALID_TASK) {
+        utils::TaskScheduler::shared().runNow(poolTask_);
+    }
 }
 
 Result<KeyData> KeyManager::generateKey(const KeyGenParams& params) {
@@ -371,70 +636,164 @@ Result<KeyExchangeResult> KeyManager::respondToKeyExchange(
 }
 
 Result<KeyData> KeyManager::rotateKey(const std::string& keyId, const KeyGenParams& params) {
-    std::lock_guard<std::mutex> lock(keyStoreMutex_);
-    
-    auto it = keyStore_.find(keyId);
-    if (it == keyStore_.end()) {
+    auto current = snapshot();
+    if (current->find(keyId) == current->end()) {
         return Result<KeyData>(std::string("Key not found"));
     }
 
-    // Generate new key
+    // Generated before taking the writer lock; lookups keep using the old key meanwhile
     auto newKeyResult = generateKey(params);
     if (!newKeyResult.has_value()) {
         return newKeyResult;
     }
+    const KeyData& replacement = newKeyResult.value();
 
-    // Mark old key for expiry
-    it->second.expiryTime = std::chrono::system_clock::now() + std::chrono::hours(24);
+    std::optional<KeyRotationPolicy> policy;
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex_);
+        auto found = rotationPolicies_.find(keyId);
+        if (found != rotationPolicies_.end()) {
+            policy = found->second;
+            rotationPolicies_.erase(found);
+            rotationPolicies_.emplace(replacement.keyId, *policy);
+        }
+    }
+
+    std::chrono::system_clock::time_point retiredExpiry;
+    {
+        std::lock_guard<std::mutex> lock(keyStoreMutex_);
+        current = snapshot();
+        auto it = current->find(keyId);
+        if (it == current->end()) {
+            return Result<KeyData>(std::string("Key not found"));
+        }
+        auto grace = policy ? policy->gracePeriod : std::chrono::seconds(std::chrono::hours(24));
+        auto retired = std::make_shared<KeyData>(*it->second);
+        retired->successorId = replacement.keyId;
+        retired->expiryTime = std::min(retired->expiryTime, std::chrono::system_clock::now() + grace);
+        retiredExpiry = retired->expiryTime;
 
+        auto next = std::make_shared<KeyStore>(*current);
+        (*next)[keyId] = std::move(retired);
+        publish(std::move(next));
+    }
+
+    scheduleDeadline(retiredExpiry, keyId, false);
+    if (policy) {
+        scheduleDeadline(replacement.expiryTime - policy->lead, replacement.keyId, true);
+    }
     return newKeyResult;
 }
 
 Result<void> KeyManager::revokeKey(const std::string& keyId, 
     const std::optional<std::string>& reason) {
-    std::lock_guard<std::mutex> lock(keyStoreMutex_);
-    
-    auto it = keyStore_.find(keyId);
-    if (it == keyStore_.end()) {
-        return Result<void>(std::string("Key not found"));
-    }
+    auto now = std::chrono::system_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(keyStoreMutex_);
+        auto current = snapshot();
+        auto it = current->find(keyId);
+        if (it == current->end()) {
+            return Result<void>(std::string("Key not found"));
+        }
 
-    it->second.isRevoked = true;
-    it->second.expiryTime = std::chrono::system_clock::now();
-    if (reason) {
-        it->second.purpose = *reason;
+        auto revoked = std::make_shared<KeyData>(*it->second);
+        revoked->isRevoked = true;
+        revoked->expiryTime = now;
+        if (reason) {
+            revoked->purpose = *reason;
+        }
+        auto next = std::make_shared<KeyStore>(*current);
+        (*next)[keyId] = std::move(revoked);
+        publish(std::move(next));
     }
-
-    return Result<void>(std::string("Key revoked"));
+    cancelRotation(keyId);
+    scheduleDeadline(now, keyId, false);
+    return Result<void>();
 }
 
 Result<KeyData> KeyManager::getKey(const std::string& keyId) const {
-    std::lock_guard<std::mutex> lock(keyStoreMutex_);
-    
-    auto it = keyStore_.find(keyId);
-    if (it == keyStore_.end()) {
+    auto current = snapshot();
+    auto it = current->find(keyId);
+    if (it == current->end()) {
         return Result<KeyData>(std::string("Key not found"));
     }
 
-    if (it->second.isRevoked) {
+    if (it->second->isRevoked) {
         return Result<KeyData>(std::string("Key is revoked"));
     }
 
-    if (it->second.expiryTime <= std::chrono::system_clock::now()) {
+    if (it->second->expiryTime <= std::chrono::system_clock::now()) {
         return Result<KeyData>(std::string("Key is expired"));
     }
 
-    return Result<KeyData>(it->second);
+    return Result<KeyData>(*it->second);
+}
+
+std::shared_ptr<const KeyData> KeyManager::findKey(const std::string& keyId) const {
+    auto current = snapshot();
+    auto it = current->find(keyId);
+    if (it == current->end() || !isUsable(*it->second, std::chrono::system_clock::now())) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::shared_ptr<const KeyData> KeyManager::findCurrentKey(const std::string& keyId) const {
+    auto current = snapshot();
+    auto now = std::chrono::system_clock::now();
+    std::shared_ptr<const KeyData> newest;
+    const std::string* id = &keyId;
+    // Bounded by the store size in case a chain ever loops
+    for (size_t hops = 0; hops <= current->size(); ++hops) {
+        auto it = current->find(*id);
+        if (it == current->end()) {
+            break;
+        }
+        if (isUsable(*it->second, now)) {
+            newest = it->second;
+        }
+        if (it->second->successorId.empty()) {
+            break;
+        }
+        id = &it->second->successorId;
+    }
+    return newest;
+}
+
+Result<void> KeyManager::scheduleRotation(const std::string& keyId, const KeyRotationPolicy& policy) {
+    auto key = findKey(keyId);
+    if (!key) {
+        return Result<void>(std::string("Key not found"));
+    }
+    if (!key->successorId.empty()) {
+        return Result<void>(std::string("Key has already been rotated"));
+    }
+    auto validation = validateKeyParams(policy.params);
+    if (!validation.has_value()) {
+        return validation;
+    }
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex_);
+        rotationPolicies_[keyId] = policy;
+    }
+    scheduleDeadline(key->expiryTime - policy.lead, keyId, true);
+    return Result<void>();
+}
+
+void KeyManager::cancelRotation(const std::string& keyId) {
+    // Its pending deadline finds no policy and is dropped
+    std::lock_guard<std::mutex> lock(scheduleMutex_);
+    rotationPolicies_.erase(keyId);
 }
 
 std::vector<KeyData> KeyManager::listActiveKeys() const {
-    std::lock_guard<std::mutex> lock(keyStoreMutex_);
+    auto current = snapshot();
     std::vector<KeyData> activeKeys;
     auto now = std::chrono::system_clock::now();
 
-    for (const auto& pair : keyStore_) {
-        if (!pair.second.isRevoked && pair.second.expiryTime > now) {
-            activeKeys.push_back(pair.second);
+    for (const auto& pair : *current) {
+        if (isUsable(*pair.second, now)) {
+            activeKeys.push_back(*pair.second);
         }
     }
 
@@ -516,25 +875,126 @@ Result<void> KeyManager::validateKeyParams(const KeyGenParams& params) const {
             break;
     }
 
-    return Result<void>(std::string("Key parameters are valid"));
+    return Result<void>();
 }
 
 Result<void> KeyManager::storeKey(const KeyData& keyData) {
-    std::lock_guard<std::mutex> lock(keyStoreMutex_);
-    keyStore_[keyData.keyId] = keyData;
-    return Result<void>(std::string("Key stored successfully"));
+    auto stored = std::make_shared<const KeyData>(keyData);
+    {
+        std::lock_guard<std::mutex> lock(keyStoreMutex_);
+        auto next = std::make_shared<KeyStore>(*snapshot());
+        (*next)[keyData.keyId] = std::move(stored);
+        publish(std::move(next));
+    }
+    scheduleDeadline(keyData.expiryTime, keyData.keyId, false);
+    return Result<void>();
 }
 
 void KeyManager::cleanupKeys() {
-    std::lock_guard<std::mutex> lock(keyStoreMutex_);
+    removeExpiredKeys(takeDueDeadlines(false));
+}
+
+void KeyManager::scheduleDeadline(std::chrono::system_clock::time_point when, const std::string& keyId,
+                                  bool rotate) {
+    std::lock_guard<std::mutex> lock(scheduleMutex_);
+    auto it = deadlines_.emplace(when, Deadline{keyId, rotate});
+    if (it == deadlines_.begin()) {
+        runMaintenanceBy(when);
+    }
+}
+
+std::vector<KeyManager::Deadline> KeyManager::takeDueDeadlines(bool includeRotations) {
+    std::vector<Deadline> due;
     auto now = std::chrono::system_clock::now();
-    
-    for (auto it = keyStore_.begin(); it != keyStore_.end();) {
-        if (it->second.isRevoked || it->second.expiryTime <= now) {
-            it = keyStore_.erase(it);
-        } else {
+    std::lock_guard<std::mutex> lock(scheduleMutex_);
+    for (auto it = deadlines_.begin(); it != deadlines_.end() && it->first <= now;) {
+        if (it->second.rotate && !includeRotations) {
             ++it;
+            continue;
         }
+        due.push_back(std::move(it->second));
+        it = deadlines_.erase(it);
+    }
+    return due;
+}
+
+void KeyManager::removeExpiredKeys(const std::vector<Deadline>& due) {
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(keyStoreMutex_);
+        auto current = snapshot();
+        auto now = std::chrono::system_clock::now();
+        std::shared_ptr<KeyStore> next;
+        for (const auto& deadline : due) {
+            if (deadline.rotate) {
+                continue;
+            }
+            auto it = current->find(deadline.keyId);
+            // A key stored again under the same ID since this deadline was set is left alone
+            if (it == current->end() || isUsable(*it->second, now)) {
+                continue;
+            }
+            if (!next) {
+                next = std::make_shared<KeyStore>(*current);
+            }
+            next->erase(deadline.keyId);
+            removed.push_back(deadline.keyId);
+        }
+        if (next) {
+            publish(std::move(next));
+        }
+    }
+    if (!removed.empty()) {
+        std::lock_guard<std::mutex> lock(scheduleMutex_);
+        for (const auto& keyId : removed) {
+            rotationPolicies_.erase(keyId);
+        }
+    }
+}
+
+void KeyManager::rotateDueKeys(const std::vector<Deadline>& due) {
+    for (const auto& deadline : due) {
+        if (!deadline.rotate) {
+            continue;
+        }
+        std::optional<KeyRotationPolicy> policy;
+        {
+            std::lock_guard<std::mutex> lock(scheduleMutex_);
+            auto found = rotationPolicies_.find(deadline.keyId);
+            if (found != rotationPolicies_.end()) {
+                policy = found->second;
+            }
+        }
+        auto key = findKey(deadline.keyId);
+        if (!policy || !key || !key->successorId.empty()) {
+            continue;
+        }
+        if (!rotateKey(deadline.keyId, policy->params).has_value()) {
+            // Try again shortly while the key is still valid
+            scheduleDeadline(std::chrono::system_clock::now() + std::chrono::seconds(1), deadline.keyId, true);
+        }
+    }
+}
+
+// The scheduler runs on the steady clock; deadlines are wall-clock times. Requires scheduleMutex_.
+void KeyManager::runMaintenanceBy(std::chrono::system_clock::time_point when) {
+    if (stopping_) {
+        return;
+    }
+    auto delay = std::max(when - std::chrono::system_clock::now(), std::chrono::system_clock::duration::zero());
+    utils::TaskScheduler::shared().runBy(
+        maintenanceTask_,
+        utils::TaskScheduler::Clock::now() + std::chrono::duration_cast<utils::TaskScheduler::Clock::duration>(delay));
+}
+
+void KeyManager::runMaintenance() {
+    auto due = takeDueDeadlines(true);
+    removeExpiredKeys(due);
+    rotateDueKeys(due);
+
+    std::lock_guard<std::mutex> lock(scheduleMutex_);
+    if (!deadlines_.empty()) {
+        runMaintenanceBy(deadlines_.begin()->first);
     }
 }
 
@@ -0,0 +1,237 @@
+#include "xenocomm/core/link_health.hpp"
+#include <algorithm>
+
+namespace xenocomm {
+namespace core {
+
+int64_t LinkHealth::steadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LinkHealth::recordSent() {
+    lastSentMs_.store(steadyMs(), std::memory_order_relaxed);
+    unansweredSends_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LinkHealth::recordHeard() {
+    lastHeardMs_.store(steadyMs(), std::memory_order_relaxed);
+    unansweredSends_.store(0, std::memory_order_relaxed);
+    consecutiveErrors_.store(0, std::memory_order_relaxed);
+}
+
+void LinkHealth::recordError() {
+    consecutiveErrors_.fetch_add(1, std::memory_order_relaxed);
+    totalErrors_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LinkHealth::recordProbe(bool ok) {
+    if (!ok) {
+        recordError();
+        return;
+    }
+    lastProbeMs_.store(steadyMs(), std::memory_order_relaxed);
+    consecutiveErrors_.store(0, std::memory_order_relaxed);
+}
+
+void LinkHealth::reset() {
+    lastHeardMs_.store(steadyMs(), std::memory_order_relaxed);
+    lastSentMs_.store(0, std::memory_order_relaxed);
+    lastProbeMs_.store(0, std::memory_order_relaxed);
+    unansweredSends_.store(0, std::memory_order_relaxed);
+    consecutiveErrors_.store(0, std::memory_order_relaxed);
+}
+
+LinkVerdict LinkHealth::assess(const LinkHealthPolicy& policy) const {
+    if (consecutiveErrors_.load(std::memory_order_relaxed) >= std::max<uint32_t>(policy.maxConsecutiveErrors, 1)) {
+        return LinkVerdict::FAILING;
+    }
+    const int64_t now = steadyMs();
+    const int64_t heard = lastHeardMs_.load(std::memory_order_relaxed);
+    if (policy.maxUnansweredSends != 0 &&
+        unansweredSends_.load(std::memory_order_relaxed) >= policy.maxUnansweredSends &&
+        now - heard > policy.responseTimeout.count()) {
+        return LinkVerdict::FAILING;
+    }
+    // Sends the kernel accepted without error say as much as a probe would
+    const int64_t latest = std::max({heard, lastSentMs_.load(std::memory_order_relaxed),
+                                     lastProbeMs_.load(std::memory_order_relaxed)});
+    return now - latest >= policy.idleAfter.count() ? LinkVerdict::IDLE : LinkVerdict::HEALTHY;
+}
+
+LinkHealth::Snapshot LinkHealth::snapshot() const {
+    Snapshot snapshot;
+    snapshot.lastHeardMs = lastHeardMs_.load(std::memory_order_relaxed);
+    snapshot.lastSentMs = lastSentMs_.load(std::memory_order_relaxed);
+    snapshot.lastProbeMs = lastProbeMs_.load(std::memory_order_relaxed);
+    snapshot.unansweredSends = unansweredSends_.load(std::memory_order_relaxed);
+    snapshot.consecutiveErrors = consecutiveErrors_.load(std::memory_order_relaxed);
+    snapshot.totalErrors = totalErrors_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+bool isLinkError(TransportError error) {
+    switch (error) {
+        case TransportError::CONNECTION_REFUSED:
+        case TransportError::CONNECTION_RESET:
+        case TransportError::CONNECTION_CLOSED:
+        case TransportError::CONNECTION_FAILED:
+        case TransportError::NETWORK_UNREACHABLE:
+        case TransportError::HOST_UNREACHABLE:
+        case TransportError::SOCKET_ERROR:
+        case TransportError::SEND_ERROR:
+        case TransportError::RECEIVE_ERROR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+HeartbeatScheduler::HeartbeatScheduler(std::chrono::milliseconds tick, EventReactor& reactor) : reactor_(reactor) {
+    timer_ = reactor_.scheduleEvery(std::max(tick, std::chrono::milliseconds(1)), [this]() { runOnce(); });
+}
+
+HeartbeatScheduler::~HeartbeatScheduler() {
+    reactor_.cancelTimer(timer_);
+}
+
+HeartbeatScheduler& HeartbeatScheduler::shared() {
+    static HeartbeatScheduler scheduler;
+    return scheduler;
+}
+
+HeartbeatScheduler::Registration HeartbeatScheduler::add(const std::string& host, LinkHealth& health,
+                                                         const LinkHealthPolicy& policy, Probe probe,
+                                                         FailureHandler onFailure) {
+    auto link = std::make_shared<Link>();
+    link->health = &health;
+    link->policy = policy;
+    link->probe = std::move(probe);
+    link->onFailure = std::move(onFailure);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    link->id = nextId_++;
+    hosts_[host].links.push_back(link);
+    hostOf_.emplace(link->id, host);
+    return link->id;
+}
+
+void HeartbeatScheduler::remove(Registration id) {
+    // From a probe or handler the round is already ours; elsewhere, wait for it to finish
+    std::unique_lock<std::mutex> round(roundMutex_, std::defer_lock);
+    if (roundThread_.load() != std::this_thread::get_id()) {
+        round.lock();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto hostIt = hostOf_.find(id);
+    if (hostIt == hostOf_.end()) {
+        return;
+    }
+    auto entry = hosts_.find(hostIt->second);
+    if (entry != hosts_.end()) {
+        auto& links = entry->second.links;
+        auto link = std::find_if(links.begin(), links.end(),
+                                 [id](const std::shared_ptr<Link>& candidate) { return candidate->id == id; });
+        if (link != links.end()) {
+            (*link)->removed = true;  // The round may still hold it, but must not call back
+            links.erase(link);
+        }
+        if (links.empty()) {
+            hosts_.erase(entry);
+        }
+    }
+    hostOf_.erase(hostIt);
+}
+
+void HeartbeatScheduler::runOnce() {
+    std::lock_guard<std::mutex> round(roundMutex_);
+    roundThread_.store(std::this_thread::get_id());
+
+    struct HostRound {
+        std::vector<std::shared_ptr<Link>> idle;
+        std::shared_ptr<Link> probed;
+    };
+    std::vector<std::shared_ptr<Link>> failing;
+    std::vector<HostRound> probes;
+    {
+        // Assessing reads a few atomics per link, so the whole registry is judged under the lock
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.rounds;
+        for (auto& [host, entry] : hosts_) {
+            HostRound hostRound;
+            for (const auto& link : entry.links) {
+                ++stats_.assessments;
+                switch (link->health->assess(link->policy)) {
+                    case LinkVerdict::FAILING:
+                        if (!link->failureReported) {
+                            link->failureReported = true;
+                            failing.push_back(link);
+                        }
+                        break;
+                    case LinkVerdict::IDLE:
+                        link->failureReported = false;
+                        hostRound.idle.push_back(link);
+                        break;
+                    case LinkVerdict::HEALTHY:
+                        link->failureReported = false;
+                        break;
+                }
+            }
+            if (!hostRound.idle.empty()) {
+                hostRound.probed = hostRound.idle[entry.nextProbe++ % hostRound.idle.size()];
+                probes.push_back(std::move(hostRound));
+            }
+        }
+    }
+
+    // Handlers and probes run unlocked so they may add or remove links
+    uint64_t failures = 0;
+    uint64_t probed = 0;
+    uint64_t coalesced = 0;
+    for (const auto& link : failing) {
+        if (!link->removed && link->onFailure) {
+            ++failures;
+            link->onFailure();
+        }
+    }
+    for (const auto& hostRound : probes) {
+        if (hostRound.probed->removed || !hostRound.probed->probe) {
+            continue;
+        }
+        ++probed;
+        bool ok = hostRound.probed->probe();
+        if (!hostRound.probed->removed) {
+            hostRound.probed->health->recordProbe(ok);
+        }
+        if (!ok) {
+            continue;  // The next round tries another of the host's idle links
+        }
+        for (const auto& link : hostRound.idle) {
+            // A link removed by a handler this round may already be gone
+            if (link != hostRound.probed && !link->removed) {
+                link->health->recordProbe(true);
+                ++coalesced;
+            }
+        }
+    }
+
+    roundThread_.store(std::thread::id());
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.failures += failures;
+    stats_.probes += probed;
+    stats_.coalesced += coalesced;
+}
+
+size_t HeartbeatScheduler::linkCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hostOf_.size();
+}
+
+HeartbeatScheduler::Stats HeartbeatScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,183 @@
+#include "xenocomm/core/metrics_http_server.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// The server closes every connection after one response, so only the request head is ever read
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+constexpr int POLL_INTERVAL_MS = 100;
+constexpr int REQUEST_TIMEOUT_MS = 2000;
+
+#ifdef _WIN32
+constexpr int SEND_FLAGS = 0;
+using PollFd = WSAPOLLFD;
+int pollSocket(PollFd* fd, int timeoutMs) { return WSAPoll(fd, 1, timeoutMs); }
+void closeSocket(socket_t socket) { closesocket(socket); }
+#else
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;  // A scraper hanging up early must not raise SIGPIPE
+using PollFd = pollfd;
+int pollSocket(PollFd* fd, int timeoutMs) { return ::poll(fd, 1, timeoutMs); }
+void closeSocket(socket_t socket) { ::close(socket); }
+#endif
+
+bool waitReadable(socket_t socket, int timeoutMs) {
+    PollFd fd{};
+    fd.fd = socket;
+    fd.events = POLLIN;
+    return pollSocket(&fd, timeoutMs) > 0;
+}
+
+void sendAll(socket_t socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const auto n = ::send(socket, data.data() + sent, static_cast<int>(data.size() - sent), SEND_FLAGS);
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string response(const char* status, const char* content_type, const std::string& body) {
+    return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + content_type +
+           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+} // namespace
+
+MetricsHttpServer::MetricsHttpServer(utils::MetricsRegistry& registry) : registry_(registry) {}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    stop();
+}
+
+bool MetricsHttpServer::start(uint16_t port, const std::string& bind_address) {
+    if (running()) {
+        return false;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_address.c_str(), &address.sin_addr) != 1) {
+        return false;
+    }
+
+    listener_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener_ == INVALID_SOCKET_VALUE) {
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    socklen_t length = sizeof(address);
+    if (::bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener_, 16) != 0 ||
+        ::getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        closeSocket(listener_);
+        listener_ = INVALID_SOCKET_VALUE;
+        return false;
+    }
+    port_ = ntohs(address.sin_port);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] { serve(); });
+    return true;
+}
+
+void MetricsHttpServer::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    closeSocket(listener_);
+    listener_ = INVALID_SOCKET_VALUE;
+}
+
+void MetricsHttpServer::serve() {
+    // The listener is polled with a short timeout so stop() never waits long for the thread
+    while (running_.load(std::memory_order_acquire)) {
+        if (!waitReadable(listener_, POLL_INTERVAL_MS)) {
+            continue;
+        }
+        socket_t client = ::accept(listener_, nullptr, nullptr);
+        if (client == INVALID_SOCKET_VALUE) {
+            continue;
+        }
+        handle(client);
+        closeSocket(client);
+    }
+}
+
+void MetricsHttpServer::handle(socket_t client) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        if (!waitReadable(client, REQUEST_TIMEOUT_MS)) {
+            return;
+        }
+        const auto n = ::recv(client, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    const size_t line_end = request.find("\r\n");
+    const std::string request_line = request.substr(0, line_end);
+    const size_t method_end = request_line.find(' ');
+    const size_t path_end = request_line.find(' ', method_end + 1);
+    if (method_end == std::string::npos || path_end == std::string::npos) {
+        sendAll(client, response("400 Bad Request", "text/plain", "Bad request\n"));
+        return;
+    }
+    const std::string method = request_line.substr(0, method_end);
+    std::string path = request_line.substr(method_end + 1, path_end - method_end - 1);
+    path = path.substr(0, path.find('?'));
+    if (method != "GET") {
+        sendAll(client, response("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+        return;
+    }
+    if (path != "/metrics") {
+        sendAll(client, response("404 Not Found", "text/plain", "Not found\n"));
+        return;
+    }
+
+    const std::string head = lowercase(request);
+    const size_t accept = head.find("\r\naccept:");
+    const bool openmetrics = accept != std::string::npos &&
+        head.substr(accept, head.find("\r\n", accept + 2) - accept).find("application/openmetrics-text") !=
+            std::string::npos;
+    if (openmetrics) {
+        sendAll(client, response("200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8",
+                                 registry_.exposition(utils::ExpositionFormat::OPENMETRICS)));
+    } else {
+        sendAll(client, response("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                                 registry_.exposition(utils::ExpositionFormat::PROMETHEUS)));
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
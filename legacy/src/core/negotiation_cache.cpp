@@ -0,0 +1,143 @@
+#include "xenocomm/core/negotiation_cache.h"
+#include <algorithm>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t h = 0xCBF29CE484222325ULL) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ p[i]) * 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// Hashes the big-endian bytes so digests agree between hosts of either byte order
+uint64_t hashWord(uint64_t value, uint64_t h) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+    }
+    return fnv1a(bytes, sizeof(bytes), h);
+}
+
+uint64_t hashText(const std::string& text, uint64_t h) {
+    return fnv1a(text.data(), text.size(), hashWord(text.size(), h));
+}
+
+template <typename T>
+uint64_t hashValue(const T& value, uint64_t h) {
+    return hashWord(static_cast<uint64_t>(value), h);
+}
+
+uint64_t hashValue(const std::string& value, uint64_t h) {
+    return hashText(value, h);
+}
+
+template <typename T>
+uint64_t hashOptions(const std::vector<RankedOption<T>>& options, uint64_t h) {
+    h = hashWord(options.size(), h);
+    for (const auto& option : options) {
+        h = hashValue(option.value, h);
+        h = hashWord((static_cast<uint64_t>(option.rank) << 1) | (option.required ? 1 : 0), h);
+        h = hashWord(option.fallbacks.size(), h);
+        for (const auto& fallback : option.fallbacks) {
+            h = hashValue(fallback, h);
+        }
+    }
+    return h;
+}
+
+template <typename T>
+uint64_t hashValues(const std::vector<T>& values, uint64_t h) {
+    h = hashWord(values.size(), h);
+    for (const auto& value : values) {
+        h = hashValue(value, h);
+    }
+    return h;
+}
+
+// A required option pins the parameter to one of the required values
+template <typename T>
+bool satisfiesRequired(const std::vector<RankedOption<T>>& options, const T& value) {
+    bool anyRequired = false;
+    for (const auto& option : options) {
+        if (option.required) {
+            if (option.value == value) {
+                return true;
+            }
+            anyRequired = true;
+        }
+    }
+    return !anyRequired;
+}
+
+} // namespace
+
+size_t NegotiationCacheKeyHash::operator()(const NegotiationCacheKey& key) const {
+    uint64_t h = hashText(key.peerId, 0xCBF29CE484222325ULL);
+    h = hashWord(key.preferenceHash, h);
+    h = hashWord(key.capabilityHash, h);
+    return static_cast<size_t>(h);
+}
+
+uint64_t hashPreference(const ParameterPreference& preferences) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = hashOptions(preferences.dataFormats, h);
+    h = hashOptions(preferences.compressionAlgorithms, h);
+    h = hashOptions(preferences.errorCorrectionSchemes, h);
+    h = hashOptions(preferences.encryptionAlgorithms, h);
+    h = hashOptions(preferences.keyExchangeMethods, h);
+    h = hashOptions(preferences.authenticationMethods, h);
+    h = hashOptions(preferences.keySizes, h);
+    h = hashWord(preferences.customParameters.size(), h);
+    for (const auto& [name, options] : preferences.customParameters) {
+        h = hashOptions(options, hashText(name, h));
+    }
+    return h;
+}
+
+uint64_t hashPeerCapabilities(const NegotiationSessionData& session) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = hashValues(session.remoteFormats, h);
+    h = hashValues(session.remoteCompression, h);
+    h = hashValues(session.remoteErrorCorrection, h);
+    h = hashValues(session.remoteEncryption, h);
+    h = hashValues(session.remoteKeyExchange, h);
+    h = hashValues(session.remoteAuth, h);
+    h = hashValues(session.remoteKeySizes, h);
+    return h;
+}
+
+bool acceptsResume(const ParameterPreference& preferences, const NegotiableParams& cachedParams) {
+    if (!preferences.isCompatibleWithRequirements(cachedParams)) {
+        return false;
+    }
+    if (!satisfiesRequired(preferences.dataFormats, cachedParams.dataFormat) ||
+        !satisfiesRequired(preferences.compressionAlgorithms, cachedParams.compressionAlgorithm) ||
+        !satisfiesRequired(preferences.errorCorrectionSchemes, cachedParams.errorCorrection) ||
+        !satisfiesRequired(preferences.encryptionAlgorithms, cachedParams.encryptionAlgorithm) ||
+        !satisfiesRequired(preferences.keyExchangeMethods, cachedParams.keyExchangeMethod) ||
+        !satisfiesRequired(preferences.authenticationMethods, cachedParams.authenticationMethod) ||
+        !satisfiesRequired(preferences.keySizes, cachedParams.keySize)) {
+        return false;
+    }
+    for (const auto& [name, options] : preferences.customParameters) {
+        auto it = cachedParams.customParameters.find(name);
+        if (it == cachedParams.customParameters.end()) {
+            if (std::any_of(options.begin(), options.end(), [](const auto& opt) { return opt.required; })) {
+                return false;
+            }
+        } else if (!satisfiesRequired(options, it->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template class BasicCapabilityCache<NegotiableParams, NegotiationCacheKey, NegotiationCacheKeyHash>;
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,351 @@
+#include "xenocomm/core/negotiation_codec.h"
+#include <algorithm>
+#include <optional>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// Wire types, in the top three bits of a tag
+constexpr uint8_t WIRE_BYTE = 0;
+constexpr uint8_t WIRE_VARINT = 1;
+constexpr uint8_t WIRE_BYTES = 2;
+
+// Field numbers, in the low five bits; never renumbered
+constexpr uint8_t FIELD_PROTOCOL_VERSION = 1;
+constexpr uint8_t FIELD_SECURITY_VERSION = 2;
+constexpr uint8_t FIELD_DATA_FORMAT = 3;
+constexpr uint8_t FIELD_COMPRESSION = 4;
+constexpr uint8_t FIELD_ERROR_CORRECTION = 5;
+constexpr uint8_t FIELD_ENCRYPTION = 6;
+constexpr uint8_t FIELD_KEY_EXCHANGE = 7;
+constexpr uint8_t FIELD_AUTHENTICATION = 8;
+constexpr uint8_t FIELD_KEY_SIZE = 9;
+constexpr uint8_t FIELD_CUSTOM_PARAMETER = 10;
+
+constexpr uint32_t VERSION_PART_BITS = 10;
+constexpr uint32_t VERSION_PART_LIMIT = 1u << VERSION_PART_BITS;
+
+// Highest valid value of each enum
+constexpr uint8_t MAX_DATA_FORMAT = static_cast<uint8_t>(DataFormat::GGWAVE_FSK_MULTIBAND);
+constexpr uint8_t MAX_COMPRESSION = static_cast<uint8_t>(CompressionAlgorithm::ZSTD);
+constexpr uint8_t MAX_ERROR_CORRECTION = static_cast<uint8_t>(ErrorCorrectionScheme::REED_SOLOMON);
+constexpr uint8_t MAX_ENCRYPTION = static_cast<uint8_t>(EncryptionAlgorithm::XCHACHA20_POLY1305);
+constexpr uint8_t MAX_KEY_EXCHANGE = static_cast<uint8_t>(KeyExchangeMethod::ECDH_X25519);
+constexpr uint8_t MAX_AUTHENTICATION = static_cast<uint8_t>(AuthenticationMethod::ED25519_SIGNATURE);
+constexpr uint8_t MAX_KEY_SIZE = static_cast<uint8_t>(KeySize::BITS_512);
+
+constexpr uint8_t tag(uint8_t field, uint8_t wireType) {
+    return static_cast<uint8_t>(wireType << 5 | field);
+}
+
+size_t varintSize(uint64_t value) {
+    size_t bytes = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++bytes;
+    }
+    return bytes;
+}
+
+/**
+ * Packs "major.minor.patch" into one integer, if it has exactly that form and
+ * unpacking gives the same string back (so no leading zeros or signs).
+ */
+std::optional<uint64_t> packVersion(const std::string& version) {
+    uint64_t packed = 0;
+    size_t parts = 0;
+    size_t i = 0;
+    while (parts < 3) {
+        size_t start = i;
+        uint32_t part = 0;
+        while (i < version.size() && version[i] >= '0' && version[i] <= '9' && i - start < 4) {
+            part = part * 10 + static_cast<uint32_t>(version[i] - '0');
+            ++i;
+        }
+        if (i == start || part >= VERSION_PART_LIMIT || (version[start] == '0' && i - start > 1)) {
+            return std::nullopt;
+        }
+        packed = packed << VERSION_PART_BITS | part;
+        if (++parts < 3) {
+            if (i == version.size() || version[i] != '.') {
+                return std::nullopt;
+            }
+            ++i;
+        }
+    }
+    if (i != version.size()) {
+        return std::nullopt;
+    }
+    return packed;
+}
+
+std::string unpackVersion(uint64_t packed) {
+    const uint64_t mask = VERSION_PART_LIMIT - 1;
+    return std::to_string(packed >> (2 * VERSION_PART_BITS)) + "." +
+           std::to_string((packed >> VERSION_PART_BITS) & mask) + "." +
+           std::to_string(packed & mask);
+}
+
+// Tallies the bytes a Writer would produce
+class Counter {
+public:
+    void byte(uint8_t) { ++size_; }
+    void varint(uint64_t value) { size_ += varintSize(value); }
+    void bytes(const std::string& value) { size_ += value.size(); }
+    size_t size() const { return size_; }
+
+private:
+    size_t size_ = 0;
+};
+
+// Writes into space the caller has already sized, so encoding never reallocates midway
+class Writer {
+public:
+    explicit Writer(uint8_t* out) : out_(out) {}
+
+    void byte(uint8_t value) { *out_++ = value; }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            *out_++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out_++ = static_cast<uint8_t>(value);
+    }
+
+    void bytes(const std::string& value) { out_ = std::copy(value.begin(), value.end(), out_); }
+
+private:
+    uint8_t* out_;
+};
+
+// Bounds-checked cursor; every read fails once the input is exhausted or malformed
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool byte(uint8_t& value) {
+        if (p_ == end_) return false;
+        value = *p_++;
+        return true;
+    }
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (p_ == end_) return false;
+            uint8_t b = *p_++;
+            value |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // A length-prefixed run of bytes, returned in place
+    bool bytes(const uint8_t*& data, size_t& size) {
+        uint64_t length;
+        if (!varint(length) || length > remaining()) return false;
+        data = p_;
+        size = static_cast<size_t>(length);
+        p_ += size;
+        return true;
+    }
+
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+    const uint8_t* position() const { return p_; }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+template <typename Sink>
+void writeVersion(Sink& sink, uint8_t field, const std::string& version) {
+    if (auto packed = packVersion(version)) {
+        sink.byte(tag(field, WIRE_VARINT));
+        sink.varint(*packed);
+    } else {
+        sink.byte(tag(field, WIRE_BYTES));
+        sink.varint(version.size());
+        sink.bytes(version);
+    }
+}
+
+template <typename Sink, typename T>
+void writeEnum(Sink& sink, uint8_t field, T value, T defaultValue) {
+    if (value != defaultValue) {
+        sink.byte(tag(field, WIRE_BYTE));
+        sink.byte(static_cast<uint8_t>(value));
+    }
+}
+
+template <typename T>
+bool readEnum(uint8_t value, uint8_t max, T& out) {
+    if (value > max) return false;
+    out = static_cast<T>(value);
+    return true;
+}
+
+} // namespace
+
+NegotiationParamsCodec::NegotiationParamsCodec(std::vector<std::string> keys)
+    : keys_(std::move(keys)) {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        keyIndex_.emplace(keys_[i], static_cast<uint32_t>(i));
+    }
+}
+
+const std::vector<std::string>& NegotiationParamsCodec::defaultKeys() {
+    // Append only: a key's position is its wire reference
+    static const std::vector<std::string> keys = {
+        "fragment.max_size",
+        "window",
+        "quality",
+        "secure",
+    };
+    return keys;
+}
+
+template <typename Sink>
+void NegotiationParamsCodec::writeFields(const NegotiableParams& params, Sink& sink) const {
+    static const NegotiableParams defaults;
+
+    if (params.protocolVersion != defaults.protocolVersion) {
+        writeVersion(sink, FIELD_PROTOCOL_VERSION, params.protocolVersion);
+    }
+    if (params.securityVersion != defaults.securityVersion) {
+        writeVersion(sink, FIELD_SECURITY_VERSION, params.securityVersion);
+    }
+    writeEnum(sink, FIELD_DATA_FORMAT, params.dataFormat, defaults.dataFormat);
+    writeEnum(sink, FIELD_COMPRESSION, params.compressionAlgorithm, defaults.compressionAlgorithm);
+    writeEnum(sink, FIELD_ERROR_CORRECTION, params.errorCorrection, defaults.errorCorrection);
+    writeEnum(sink, FIELD_ENCRYPTION, params.encryptionAlgorithm, defaults.encryptionAlgorithm);
+    writeEnum(sink, FIELD_KEY_EXCHANGE, params.keyExchangeMethod, defaults.keyExchangeMethod);
+    writeEnum(sink, FIELD_AUTHENTICATION, params.authenticationMethod, defaults.authenticationMethod);
+    writeEnum(sink, FIELD_KEY_SIZE, params.keySize, defaults.keySize);
+
+    for (const auto& [key, value] : params.customParameters) {
+        auto interned = keyIndex_.find(key);
+        size_t keySize = interned != keyIndex_.end()
+            ? varintSize(interned->second + 1)
+            : 1 + varintSize(key.size()) + key.size();
+        sink.byte(tag(FIELD_CUSTOM_PARAMETER, WIRE_BYTES));
+        sink.varint(keySize + value.size());
+        if (interned != keyIndex_.end()) {
+            sink.varint(interned->second + 1);
+        } else {
+            sink.varint(0);
+            sink.varint(key.size());
+            sink.bytes(key);
+        }
+        sink.bytes(value);
+    }
+}
+
+size_t NegotiationParamsCodec::encodedSize(const NegotiableParams& params) const {
+    Counter counter;
+    writeFields(params, counter);
+    return 1 + varintSize(counter.size()) + counter.size();
+}
+
+void NegotiationParamsCodec::encode(const NegotiableParams& params, std::vector<uint8_t>& out) const {
+    Counter counter;
+    writeFields(params, counter);
+    const size_t start = out.size();
+    out.resize(start + 1 + varintSize(counter.size()) + counter.size());
+
+    Writer writer(out.data() + start);
+    writer.byte(NEGOTIATION_PARAMS_FORMAT_V1);
+    writer.varint(counter.size());
+    writeFields(params, writer);
+}
+
+bool NegotiationParamsCodec::readCustomParameter(const uint8_t* data, size_t size, NegotiableParams& out) const {
+    Reader reader(data, size);
+    uint64_t reference;
+    if (!reader.varint(reference)) return false;
+
+    std::string key;
+    if (reference == 0) {
+        const uint8_t* keyData;
+        size_t keySize;
+        if (!reader.bytes(keyData, keySize)) return false;
+        key.assign(reinterpret_cast<const char*>(keyData), keySize);
+    } else if (reference <= keys_.size()) {
+        key = keys_[static_cast<size_t>(reference - 1)];
+    } else {
+        return false;  // Key table differs from the sender's
+    }
+    const char* value = reinterpret_cast<const char*>(reader.position());
+    out.customParameters[std::move(key)].assign(value, reader.remaining());
+    return true;
+}
+
+bool NegotiationParamsCodec::decode(const uint8_t* data, size_t size, NegotiableParams& out,
+                                    size_t* bytesRead) const {
+    Reader reader(data, size);
+    uint8_t format;
+    uint64_t length;
+    if (!reader.byte(format) || format != NEGOTIATION_PARAMS_FORMAT_V1 ||
+        !reader.varint(length) || length > reader.remaining()) {
+        return false;
+    }
+    const size_t headerSize = size - reader.remaining();
+
+    NegotiableParams params;
+    Reader fields(reader.position(), static_cast<size_t>(length));
+    while (fields.remaining() > 0) {
+        uint8_t fieldTag;
+        fields.byte(fieldTag);
+        const uint8_t field = fieldTag & 0x1F;
+        const uint8_t wireType = fieldTag >> 5;
+
+        if (wireType == WIRE_BYTE) {
+            uint8_t value;
+            if (!fields.byte(value)) return false;
+            bool valid = true;
+            switch (field) {
+                case FIELD_DATA_FORMAT: valid = readEnum(value, MAX_DATA_FORMAT, params.dataFormat); break;
+                case FIELD_COMPRESSION: valid = readEnum(value, MAX_COMPRESSION, params.compressionAlgorithm); break;
+                case FIELD_ERROR_CORRECTION: valid = readEnum(value, MAX_ERROR_CORRECTION, params.errorCorrection); break;
+                case FIELD_ENCRYPTION: valid = readEnum(value, MAX_ENCRYPTION, params.encryptionAlgorithm); break;
+                case FIELD_KEY_EXCHANGE: valid = readEnum(value, MAX_KEY_EXCHANGE, params.keyExchangeMethod); break;
+                case FIELD_AUTHENTICATION: valid = readEnum(value, MAX_AUTHENTICATION, params.authenticationMethod); break;
+                case FIELD_KEY_SIZE: valid = readEnum(value, MAX_KEY_SIZE, params.keySize); break;
+                default: break;  // Unknown field, skipped
+            }
+            if (!valid) return false;
+        } else if (wireType == WIRE_VARINT) {
+            uint64_t value;
+            if (!fields.varint(value)) return false;
+            if (field == FIELD_PROTOCOL_VERSION || field == FIELD_SECURITY_VERSION) {
+                if (value >> (3 * VERSION_PART_BITS)) return false;
+                (field == FIELD_PROTOCOL_VERSION ? params.protocolVersion : params.securityVersion) =
+                    unpackVersion(value);
+            }
+        } else if (wireType == WIRE_BYTES) {
+            const uint8_t* value;
+            size_t valueSize;
+            if (!fields.bytes(value, valueSize)) return false;
+            if (field == FIELD_PROTOCOL_VERSION || field == FIELD_SECURITY_VERSION) {
+                (field == FIELD_PROTOCOL_VERSION ? params.protocolVersion : params.securityVersion)
+                    .assign(reinterpret_cast<const char*>(value), valueSize);
+            } else if (field == FIELD_CUSTOM_PARAMETER && !readCustomParameter(value, valueSize, params)) {
+                return false;
+            }
+        } else {
+            return false;  // Unknown wire type; the rest cannot be delimited
+        }
+    }
+
+    out = std::move(params);
+    if (bytesRead) {
+        *bytesRead = headerSize + static_cast<size_t>(length);
+    }
+    return true;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -1,4 +1,5 @@
 #include "xenocomm/core/negotiation_protocol.h" // Include the header for definitions
+#include "xenocomm/core/preference_table.h"
 #include "xenocomm/core/security_manager.h" 
 #include "xenocomm/utils/serialization.h"
 
@@ -7,6 +8,7 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <random>
 #include <algorithm>
@@ -17,6 +19,8 @@
 #include <variant> // For std::variant
 #include <optional> // Added missing include
 #include <memory> // Added missing include
+#include <array>
+#include <atomic>
 
 namespace xenocomm {
 namespace core {
@@ -52,6 +56,10 @@ namespace validation {
             case DataFormat::COMPRESSED_STATE:
             case DataFormat::BINARY_CUSTOM:
             case DataFormat::GGWAVE_FSK:
+            case DataFormat::VECTOR_FLOAT16:
+            case DataFormat::VECTOR_BFLOAT16:
+            case DataFormat::VECTOR_INT4:
+            case DataFormat::GGWAVE_FSK_MULTIBAND:
                 return true;
             default:
                 return false;
@@ -151,7 +159,8 @@ namespace validation {
     bool areCompatible(DataFormat format, ErrorCorrectionScheme scheme) {
         // Some data formats might have built-in error correction or be incompatible with certain schemes
         // For example, GGWAVE_FSK might include its own error correction
-        if (format == DataFormat::GGWAVE_FSK && scheme != ErrorCorrectionScheme::NONE) {
+        if ((format == DataFormat::GGWAVE_FSK || format == DataFormat::GGWAVE_FSK_MULTIBAND) &&
+            scheme != ErrorCorrectionScheme::NONE) {
             return false;
         }
         return true;
@@ -366,6 +375,7 @@ private:
             {NegotiationState::AWAITING_RESPONSE, {
                 NegotiationState::COUNTER_RECEIVED,   // Received counter-proposal
                 NegotiationState::FINALIZING,         // Received acceptance
+                NegotiationState::FINALIZED,          // Peer confirmed resumed parameters
                 NegotiationState::FAILED,             // Received rejection or timeout
                 NegotiationState::CLOSED              // Explicit close
             }},
@@ -420,19 +430,27 @@ enum class MessageType {
     COUNTER,
     REJECT,
     FINALIZE,
-    CLOSE
+    CLOSE,
+    RESUME,         // Initiator offers parameters cached from an earlier session
+    RESUME_ACK,     // Responder confirms them; both sides are finalized
+    RESUME_REJECT,  // Responder refuses them; the initiator negotiates afresh
+    RENEGOTIATE,        // Either side offers new transmission parameters for a finalized session
+    RENEGOTIATE_ACK,    // The peer switches to them from its next message
+    RENEGOTIATE_REJECT  // The peer keeps the agreed parameters
 };
 
-struct ProposePayload { NegotiableParams params; };
+struct ProposePayload { NegotiableParams params; std::vector<uint8_t> earlyData; }; // earlyData is empty unless sent speculatively
 struct AcceptPayload { std::optional<NegotiableParams> params; }; // Optional echo
 struct CounterPayload { NegotiableParams params; };
 struct RejectPayload { std::optional<std::string> reason; };
 struct FinalizePayload { NegotiableParams params; };
 struct ClosePayload { std::optional<std::string> reason; };
+struct ResumePayload { NegotiableParams params; }; // RESUME carries the cached parameters; the replies carry none
+struct RenegotiatePayload { NegotiableParams params; }; // RENEGOTIATE carries the updated parameters; the replies carry none
 
 // --- Internal Message Representation (Placeholder) ---
 // This simulates what the network layer might provide.
-using MessagePayload = std::variant<std::monostate, ProposePayload, AcceptPayload, CounterPayload, RejectPayload, FinalizePayload, ClosePayload>;
+using MessagePayload = std::variant<std::monostate, ProposePayload, AcceptPayload, CounterPayload, RejectPayload, FinalizePayload, ClosePayload, ResumePayload, RenegotiatePayload>;
 
 // --- Negotiation Message Definition ---
 
@@ -447,7 +465,9 @@ struct NegotiationMessage {
         CounterPayload,
         RejectPayload,
         FinalizePayload,
-        ClosePayload
+        ClosePayload,
+        ResumePayload,
+        RenegotiatePayload
     > payload;
     
     // Timestamp for timeout tracking
@@ -487,9 +507,16 @@ public:
     NegotiableParams finalizeSession(SessionId sessionId) override;
     NegotiationState getSessionState(SessionId sessionId) const override;
     std::optional<NegotiableParams> getNegotiatedParams(SessionId sessionId) const override;
+    std::optional<NegotiableParams> getCounterProposal(SessionId sessionId) const override;
     bool acceptCounterProposal(SessionId sessionId) override;
     bool closeSession(SessionId sessionId) override;
     bool rejectCounterProposal(SessionId sessionId, const std::optional<std::string>& reason) override;
+    SessionId resumeSession(const std::string& targetAgentId, const NegotiableParams& cachedParams) override;
+    bool renegotiateSession(SessionId sessionId, const NegotiableParams& updatedParams) override;
+    SessionId initiateSessionWithEarlyData(const std::string& targetAgentId, const NegotiableParams& proposedParams,
+                                           const std::vector<uint8_t>& earlyData) override;
+    EarlyDataStatus getEarlyDataStatus(SessionId sessionId) const override;
+    std::optional<std::vector<uint8_t>> takeEarlyData(SessionId sessionId) override;
 
     // Event registration methods
     void registerStateChangeHandler(StateChangeHandler handler) {
@@ -507,22 +534,51 @@ public:
     bool autoProcessProposal(SessionId sessionId, const ParameterPreference& preferences);
 
 private:
+    // A session and the lock serializing negotiation steps on it. The state is
+    // mirrored into an atomic so polling never waits for a step in progress.
+    struct SessionEntry {
+        std::mutex mutex;
+        std::atomic<NegotiationState> state{NegotiationState::IDLE};
+        std::atomic<std::chrono::steady_clock::rep> stateSince{0};  // When state was entered
+        NegotiationSessionData data;
+    };
+
+    // Shard locks guard only the maps, and are held just long enough to find a session
+    struct alignas(64) SessionShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<NegotiationProtocol::SessionId, std::shared_ptr<SessionEntry>> sessions;
+    };
+
+    // Session IDs are sequential, so taking them modulo a power of two spreads sessions evenly
+    static constexpr size_t SESSION_SHARD_COUNT = 64;
+
     // Member variables
-    mutable std::mutex sessionsMutex_;
-    std::unordered_map<NegotiationProtocol::SessionId, NegotiationSessionData> sessions_;
+    std::array<SessionShard, SESSION_SHARD_COUNT> shards_;
     std::atomic<NegotiationProtocol::SessionId> nextSessionId_;
     Logger logger_;
     std::vector<StateChangeHandler> stateChangeHandlers_;
 
     // --- Private helper method Declarations --- 
-    NegotiationSessionData& getSessionData(NegotiationProtocol::SessionId sessionId);
-    const NegotiationSessionData& getSessionData(NegotiationProtocol::SessionId sessionId) const;
+    static size_t shardIndex(NegotiationProtocol::SessionId sessionId) { return sessionId & (SESSION_SHARD_COUNT - 1); }
+    void insertSession(NegotiationProtocol::SessionId sessionId, NegotiationSessionData sessionData);
+    std::shared_ptr<SessionEntry> findSession(NegotiationProtocol::SessionId sessionId) const;
     bool transitionState(NegotiationProtocol::SessionId sessionId, NegotiationState newState, const std::string& reason = "");
-    bool isStateTimedOut(const NegotiationSessionData& session, std::chrono::milliseconds timeout = DEFAULT_NEGOTIATION_TIMEOUT) const;
-    bool sendProposal(const std::string& targetAgentId, NegotiationProtocol::SessionId sessionId, const NegotiableParams& params);
+    bool transitionStateLocked(NegotiationProtocol::SessionId sessionId, SessionEntry& entry, NegotiationState newState, const std::string& reason = "");
+    bool isStateTimedOut(const SessionEntry& entry, std::chrono::milliseconds timeout = DEFAULT_NEGOTIATION_TIMEOUT) const;
+    SessionId initiate(const std::string& targetAgentId, const NegotiableParams& proposedParams,
+                       const std::vector<uint8_t>* earlyData);
+    bool sendProposal(const std::string& targetAgentId, NegotiationProtocol::SessionId sessionId, const NegotiableParams& params,
+                      const std::vector<uint8_t>* earlyData = nullptr);
+    void settleEarlyData(NegotiationSessionData& session, bool acceptedUnchanged);
     bool sendResponse(NegotiationProtocol::SessionId sessionId, NegotiationResponse responseType, const std::optional<NegotiableParams>& params);
     bool sendFinalization(NegotiationProtocol::SessionId sessionId, const NegotiableParams& finalParams);
     bool sendReject(NegotiationProtocol::SessionId sessionId, const std::optional<std::string>& reason);
+    bool sendResume(const std::string& targetAgentId, NegotiationProtocol::SessionId sessionId, const NegotiableParams& params);
+    void handleResumeReply(NegotiationProtocol::SessionId sessionId, SessionEntry& entry, MessageType type);
+    bool sendRenegotiate(NegotiationProtocol::SessionId sessionId, const NegotiableParams& params);
+    bool sendRenegotiateReply(NegotiationProtocol::SessionId sessionId, bool accepted);
+    void handleRenegotiation(NegotiationProtocol::SessionId sessionId, SessionEntry& entry, MessageType type,
+                             const MessagePayload& payload);
     void handleIncomingMessage(NegotiationProtocol::SessionId sessionId, MessageType type, const MessagePayload& payload);
     NegotiableParams createProposal(const ParameterPreference& preferences);
     std::optional<NegotiableParams> createCounterProposal(
@@ -544,6 +600,33 @@ private:
 // --- Definitions of PUBLIC methods --- 
 // (These remain outside the class definition)
 NegotiationProtocol::SessionId ConcreteNegotiationProtocol::initiateSession(const std::string& targetAgentId, const NegotiableParams& proposedParams) {
+    return initiate(targetAgentId, proposedParams, nullptr);
+}
+
+NegotiationProtocol::SessionId ConcreteNegotiationProtocol::initiateSessionWithEarlyData(
+    const std::string& targetAgentId, const NegotiableParams& proposedParams, const std::vector<uint8_t>& earlyData) {
+    return initiate(targetAgentId, proposedParams, &earlyData);
+}
+
+EarlyDataStatus ConcreteNegotiationProtocol::getEarlyDataStatus(SessionId sessionId) const {
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    return entry->data.earlyDataStatus;
+}
+
+std::optional<std::vector<uint8_t>> ConcreteNegotiationProtocol::takeEarlyData(SessionId sessionId) {
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
+    if (session.earlyDataStatus != EarlyDataStatus::ACCEPTED || session.earlyData.empty()) {
+        return std::nullopt;
+    }
+    return std::move(session.earlyData);
+}
+
+NegotiationProtocol::SessionId ConcreteNegotiationProtocol::initiate(const std::string& targetAgentId,
+                                                                     const NegotiableParams& proposedParams,
+                                                                     const std::vector<uint8_t>* earlyData) {
     // Validate params before proceeding
     auto validationResult = validation::validateParameterSet(proposedParams);
     if (validationResult != validation::ValidationResult::VALID) {
@@ -558,12 +641,13 @@ NegotiationProtocol::SessionId ConcreteNegotiationProtocol::initiateSession(cons
     sessionData.initiatorAgentId = ""; // TODO: Get current agent ID
     sessionData.targetAgentId = targetAgentId;
     sessionData.initialProposal = proposedParams;
+    // The initiator keeps no copy: if the data is refused, the caller resends it re-encoded
+    if (earlyData && !earlyData->empty()) {
+        sessionData.earlyDataStatus = EarlyDataStatus::PENDING;
+    }
     
     // Add to sessions map
-    {
-        std::lock_guard<std::mutex> lock(sessionsMutex_);
-        sessions_[sessionId] = std::move(sessionData);
-    }
+    insertSession(sessionId, std::move(sessionData));
     
     // Transition to INITIATING state
     if (!transitionState(sessionId, NegotiationState::INITIATING, "Initiating negotiation with " + targetAgentId)) {
@@ -571,7 +655,7 @@ NegotiationProtocol::SessionId ConcreteNegotiationProtocol::initiateSession(cons
     }
 
     // Send the proposal over the network (MSG_PROPOSE)
-    bool sentOk = sendProposal(targetAgentId, sessionId, proposedParams);
+    bool sentOk = sendProposal(targetAgentId, sessionId, proposedParams, earlyData);
 
     if (sentOk) {
         // Transition to AWAITING_RESPONSE state
@@ -585,9 +669,73 @@ NegotiationProtocol::SessionId ConcreteNegotiationProtocol::initiateSession(cons
     return sessionId;
 }
 
+NegotiationProtocol::SessionId ConcreteNegotiationProtocol::resumeSession(const std::string& targetAgentId, const NegotiableParams& cachedParams) {
+    // Cached parameters were valid when agreed, but the rules may have changed since
+    auto validationResult = validation::validateParameterSet(cachedParams);
+    if (validationResult != validation::ValidationResult::VALID) {
+        throw std::runtime_error("Invalid cached negotiation parameters: " + 
+                                validation::validationResultToString(validationResult));
+    }
+
+    SessionId sessionId = nextSessionId_.fetch_add(1);
+
+    NegotiationSessionData sessionData;
+    sessionData.targetAgentId = targetAgentId;
+    sessionData.initialProposal = cachedParams;
+    sessionData.resumed = true;
+
+    insertSession(sessionId, std::move(sessionData));
+
+    if (!transitionState(sessionId, NegotiationState::INITIATING, "Resuming cached parameters with " + targetAgentId)) {
+        throw std::runtime_error("Failed to transition to INITIATING state");
+    }
+
+    // One message and one reply: RESUME, then RESUME_ACK or RESUME_REJECT
+    if (sendResume(targetAgentId, sessionId, cachedParams)) {
+        transitionState(sessionId, NegotiationState::AWAITING_RESPONSE, "Resume sent, awaiting confirmation");
+        return sessionId;
+    }
+
+    // The cached parameters are still the best first offer, so propose them in full
+    transitionState(sessionId, NegotiationState::FAILED, "Failed to send resume request");
+    logger_.warning("Could not resume with " + targetAgentId + ", negotiating in full");
+    return initiateSession(targetAgentId, cachedParams);
+}
+
+bool ConcreteNegotiationProtocol::renegotiateSession(SessionId sessionId, const NegotiableParams& updatedParams) {
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
+
+    if (session.state != NegotiationState::FINALIZED || !session.finalParams) {
+        throw std::runtime_error("Cannot renegotiate session in state " +
+                                 StateTransitionValidator::stateToString(session.state));
+    }
+    if (session.pendingParams) {
+        throw std::runtime_error("Renegotiation already in progress for session " + std::to_string(sessionId));
+    }
+    if (!isRenegotiable(*session.finalParams, updatedParams)) {
+        throw std::runtime_error("Renegotiation may only change compression, error correction and custom parameters");
+    }
+    auto validationResult = validation::validateParameterSet(updatedParams);
+    if (validationResult != validation::ValidationResult::VALID) {
+        throw std::runtime_error("Invalid renegotiated parameters: " +
+                                validation::validationResultToString(validationResult));
+    }
+
+    // The session stays FINALIZED on the agreed parameters until the peer answers
+    if (!sendRenegotiate(sessionId, updatedParams)) {
+        throw std::runtime_error("Failed to send renegotiation for session " + std::to_string(sessionId));
+    }
+    session.pendingParams = updatedParams;
+    logger_.info("Renegotiation offered for session " + std::to_string(sessionId));
+    return true;
+}
+
 bool ConcreteNegotiationProtocol::respondToNegotiation(SessionId sessionId, NegotiationResponse responseType, const std::optional<NegotiableParams>& responseParams) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId); // Throws if not found
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
 
     // Validate state - Only Responder in PROPOSAL_RECEIVED state can call this
     if (session.state != NegotiationState::PROPOSAL_RECEIVED) {
@@ -608,7 +756,7 @@ bool ConcreteNegotiationProtocol::respondToNegotiation(SessionId sessionId, Nego
     }
 
     // Transition to RESPONDING state
-    if (!transitionState(sessionId, NegotiationState::RESPONDING, "Preparing response")) {
+    if (!transitionStateLocked(sessionId, *entry, NegotiationState::RESPONDING, "Preparing response")) {
         return false;
     }
 
@@ -616,28 +764,31 @@ bool ConcreteNegotiationProtocol::respondToNegotiation(SessionId sessionId, Nego
     bool sentOk = sendResponse(sessionId, responseType, responseParams);
     
     if (sentOk) {
+        // Early data was encoded with the proposal, so only an unchanged acceptance can process it
+        settleEarlyData(session, responseType == NegotiationResponse::ACCEPTED &&
+                                 (!responseParams || *responseParams == session.initialProposal));
         switch (responseType) {
             case NegotiationResponse::ACCEPTED:
                 // Record the final parameters
                 session.finalParams = responseParams.value_or(session.initialProposal);
                 // Transition to AWAITING_FINALIZATION state
-                return transitionState(sessionId, NegotiationState::AWAITING_FINALIZATION, 
+                return transitionStateLocked(sessionId, *entry, NegotiationState::AWAITING_FINALIZATION, 
                                     "Acceptance sent, awaiting finalization");
             
             case NegotiationResponse::COUNTER_PROPOSAL:
                 if (!responseParams) {
                     logger_.error("Counter proposal requires parameters");
-                    transitionState(sessionId, NegotiationState::FAILED, "Invalid counter-proposal: missing parameters");
+                    transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, "Invalid counter-proposal: missing parameters");
                     return false;
                 }
                 session.counterProposal = *responseParams;
                 // Transition to AWAITING_FINALIZATION state
-                return transitionState(sessionId, NegotiationState::AWAITING_FINALIZATION, 
+                return transitionStateLocked(sessionId, *entry, NegotiationState::AWAITING_FINALIZATION, 
                                     "Counter-proposal sent, awaiting response");
             
             case NegotiationResponse::REJECTED:
                 // Transition to FAILED state
-                return transitionState(sessionId, NegotiationState::FAILED, "Proposal rejected by local agent");
+                return transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, "Proposal rejected by local agent");
             
             default:
                 logger_.error("Unknown response type");
@@ -645,14 +796,15 @@ bool ConcreteNegotiationProtocol::respondToNegotiation(SessionId sessionId, Nego
         }
     } else {
         // Failed to send response
-        transitionState(sessionId, NegotiationState::FAILED, "Failed to send response");
+        transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, "Failed to send response");
         return false;
     }
 }
 
 bool ConcreteNegotiationProtocol::acceptCounterProposal(SessionId sessionId) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId);
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
 
     // Validate state - Only Initiator in COUNTER_RECEIVED state can call this
     if (session.state != NegotiationState::COUNTER_RECEIVED) {
@@ -665,19 +817,20 @@ bool ConcreteNegotiationProtocol::acceptCounterProposal(SessionId sessionId) {
     if (!session.counterProposal.has_value()) {
         // Should not happen if state is COUNTER_RECEIVED, but check anyway
         logger_.error("Cannot accept counter-proposal: No counter-proposal parameters available");
-        return transitionState(sessionId, NegotiationState::FAILED, "No counter-proposal available");
+        return transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, "No counter-proposal available");
     }
 
     // Mark the counter-proposal parameters as the final ones
     session.finalParams = session.counterProposal;
     
     // Transition state - ready to finalize based on the accepted counter
-    return transitionState(sessionId, NegotiationState::FINALIZING, "Counter-proposal accepted, ready to finalize");
+    return transitionStateLocked(sessionId, *entry, NegotiationState::FINALIZING, "Counter-proposal accepted, ready to finalize");
 }
 
 NegotiableParams ConcreteNegotiationProtocol::finalizeSession(SessionId sessionId) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId); // Throws if not found
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
 
     // Enhanced state validation with detailed error messages
     if (session.state != NegotiationState::FINALIZING) {
@@ -708,7 +861,7 @@ NegotiableParams ConcreteNegotiationProtocol::finalizeSession(SessionId sessionI
     bool sentOk = sendFinalization(sessionId, *session.finalParams);
 
     if (sentOk) {
-        if (transitionState(sessionId, NegotiationState::FINALIZED, "Negotiation successful")) {
+        if (transitionStateLocked(sessionId, *entry, NegotiationState::FINALIZED, "Negotiation successful")) {
             // Log successful finalization with parameter details
             logger_.info("Session " + std::to_string(sessionId) + " finalized successfully with parameters: " +
                         "DataFormat=" + std::to_string(static_cast<int>(session.finalParams->dataFormat)) + ", " +
@@ -735,44 +888,55 @@ NegotiableParams ConcreteNegotiationProtocol::finalizeSession(SessionId sessionI
     } else {
         std::string errorMsg = "Failed to send finalization message";
         logger_.error(errorMsg + " for session " + std::to_string(sessionId));
-        transitionState(sessionId, NegotiationState::FAILED, errorMsg);
-        transitionState(sessionId, NegotiationState::FAILED, "Failed to send finalization"); // Duplicate transition?
+        transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, errorMsg);
+        transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, "Failed to send finalization"); // Duplicate transition?
         throw std::runtime_error("Failed to send finalization message for session");
     }
 }
 
 NegotiationState ConcreteNegotiationProtocol::getSessionState(SessionId sessionId) const {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    const auto& session = getSessionData(sessionId); // Throws if not found
+    auto entry = findSession(sessionId); // Throws if not found
+    NegotiationState state = entry->state.load(std::memory_order_acquire);
     
     // Check for timeout in non-terminal states
-    if (session.state != NegotiationState::FINALIZED && 
-        session.state != NegotiationState::FAILED && 
-        session.state != NegotiationState::CLOSED &&
-        isStateTimedOut(session)) {
+    if (state != NegotiationState::FINALIZED && 
+        state != NegotiationState::FAILED && 
+        state != NegotiationState::CLOSED &&
+        isStateTimedOut(*entry)) {
         // Can't transition state in a const method, but we can log the timeout
         logger_.warning("Session " + std::to_string(sessionId) + " has timed out in state " + 
-                       StateTransitionValidator::stateToString(session.state));
+                       StateTransitionValidator::stateToString(state));
     }
     
-    return session.state;
+    return state;
 }
 
 std::optional<NegotiableParams> ConcreteNegotiationProtocol::getNegotiatedParams(SessionId sessionId) const {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    const auto& session = getSessionData(sessionId); // Throws if not found
+    auto entry = findSession(sessionId); // Throws if not found
     
-    // Only return params if the negotiation was successful
-    if (session.state == NegotiationState::FINALIZED) {
-        return session.finalParams;
+    // Only return params if the negotiation was successful. finalParams is
+    // written before the session is published as FINALIZED and never after,
+    // so the acquire load makes it safe to read without the session lock.
+    if (entry->state.load(std::memory_order_acquire) == NegotiationState::FINALIZED) {
+        return entry->data.finalParams;
     }
     
     return std::nullopt;
 }
 
+std::optional<NegotiableParams> ConcreteNegotiationProtocol::getCounterProposal(SessionId sessionId) const {
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (entry->data.state == NegotiationState::COUNTER_RECEIVED) {
+        return entry->data.counterProposal;
+    }
+    return std::nullopt;
+}
+
 bool ConcreteNegotiationProtocol::closeSession(SessionId sessionId) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId); // Throws if not found
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
     
     // Can't close a session that's already closed
     if (session.state == NegotiationState::CLOSED) {
@@ -789,12 +953,13 @@ bool ConcreteNegotiationProtocol::closeSession(SessionId sessionId) {
     }
     
     // Transition to CLOSED state
-    return transitionState(sessionId, NegotiationState::CLOSED, "Session closed by local agent");
+    return transitionStateLocked(sessionId, *entry, NegotiationState::CLOSED, "Session closed by local agent");
 }
 
 bool ConcreteNegotiationProtocol::rejectCounterProposal(SessionId sessionId, const std::optional<std::string>& reason) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId);
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
 
     // Validate state - Only Initiator in COUNTER_RECEIVED state can call this
     if (session.state != NegotiationState::COUNTER_RECEIVED) {
@@ -811,7 +976,7 @@ bool ConcreteNegotiationProtocol::rejectCounterProposal(SessionId sessionId, con
     std::string rejectionReason = reason.value_or("Counter-proposal rejected");
 
     // Update state regardless of send success
-    if (transitionState(sessionId, NegotiationState::FAILED, rejectionReason)) {
+    if (transitionStateLocked(sessionId, *entry, NegotiationState::FAILED, rejectionReason)) {
         if (!sentOk) {
             logger_.warning("Failed to send REJECT message, but session marked as FAILED locally");
         }
@@ -826,25 +991,35 @@ bool ConcreteNegotiationProtocol::rejectCounterProposal(SessionId sessionId, con
 // --- Definitions of PRIVATE helper methods --- 
 // (Must be qualified with class name)
 
-NegotiationSessionData& ConcreteNegotiationProtocol::getSessionData(NegotiationProtocol::SessionId sessionId) {
-    auto it = sessions_.find(sessionId);
-    if (it == sessions_.end()) {
-        throw std::runtime_error("Invalid or unknown session ID: " + std::to_string(sessionId));
-    }
-    return it->second;
+void ConcreteNegotiationProtocol::insertSession(NegotiationProtocol::SessionId sessionId, NegotiationSessionData sessionData) {
+    auto entry = std::make_shared<SessionEntry>();
+    entry->state.store(sessionData.state, std::memory_order_relaxed);
+    entry->stateSince.store(sessionData.createdTime.time_since_epoch().count(), std::memory_order_relaxed);
+    entry->data = std::move(sessionData);
+
+    SessionShard& shard = shards_[shardIndex(sessionId)];
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.sessions[sessionId] = std::move(entry);
 }
 
-const NegotiationSessionData& ConcreteNegotiationProtocol::getSessionData(NegotiationProtocol::SessionId sessionId) const {
-    auto it = sessions_.find(sessionId);
-    if (it == sessions_.end()) {
+std::shared_ptr<ConcreteNegotiationProtocol::SessionEntry> ConcreteNegotiationProtocol::findSession(NegotiationProtocol::SessionId sessionId) const {
+    const SessionShard& shard = shards_[shardIndex(sessionId)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.sessions.find(sessionId);
+    if (it == shard.sessions.end()) {
         throw std::runtime_error("Invalid or unknown session ID: " + std::to_string(sessionId));
     }
     return it->second;
 }
 
 bool ConcreteNegotiationProtocol::transitionState(NegotiationProtocol::SessionId sessionId, NegotiationState newState, const std::string& reason) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId); // Calls the member function getSessionData
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    return transitionStateLocked(sessionId, *entry, newState, reason);
+}
+
+bool ConcreteNegotiationProtocol::transitionStateLocked(NegotiationProtocol::SessionId sessionId, SessionEntry& entry, NegotiationState newState, const std::string& reason) {
+    auto& session = entry.data;
     NegotiationState currentState = session.state;
     
     if (!StateTransitionValidator::isValidTransition(currentState, newState)) {
@@ -855,11 +1030,15 @@ bool ConcreteNegotiationProtocol::transitionState(NegotiationProtocol::SessionId
         return false;
     }
     
+    auto now = std::chrono::steady_clock::now();
     session.state = newState;
-    session.stateTimestamps[newState] = std::chrono::steady_clock::now();
+    session.stateTimestamps[newState] = now;
     if (currentState != newState) {
         session.retryCount = 0;
     }
+    // Publish last, so a reader that sees the new state also sees the data written for it
+    entry.stateSince.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    entry.state.store(newState, std::memory_order_release);
     
     logger_.info("Session " + std::to_string(sessionId) + " state transition: " + 
                 StateTransitionValidator::stateToString(currentState) + " -> " + 
@@ -876,20 +1055,29 @@ bool ConcreteNegotiationProtocol::transitionState(NegotiationProtocol::SessionId
     return true;
 }
 
-bool ConcreteNegotiationProtocol::isStateTimedOut(const NegotiationSessionData& session, std::chrono::milliseconds timeout) const {
-    auto currentState = session.state;
-    auto it = session.stateTimestamps.find(currentState);
-    if (it == session.stateTimestamps.end()) {
-        return (std::chrono::steady_clock::now() - session.createdTime) > timeout;
-    }
-    return (std::chrono::steady_clock::now() - it->second) > timeout;
+bool ConcreteNegotiationProtocol::isStateTimedOut(const SessionEntry& entry, std::chrono::milliseconds timeout) const {
+    std::chrono::steady_clock::time_point since(
+        std::chrono::steady_clock::duration(entry.stateSince.load(std::memory_order_relaxed)));
+    return (std::chrono::steady_clock::now() - since) > timeout;
 }
 
-bool ConcreteNegotiationProtocol::sendProposal(const std::string& targetAgentId, NegotiationProtocol::SessionId sessionId, const NegotiableParams& params) {
-    (void)targetAgentId; (void)sessionId; (void)params;
+bool ConcreteNegotiationProtocol::sendProposal(const std::string& targetAgentId, NegotiationProtocol::SessionId sessionId, const NegotiableParams& params,
+                                               const std::vector<uint8_t>* earlyData) {
+    (void)targetAgentId; (void)sessionId; (void)params; (void)earlyData;
     return true; // Placeholder
 }
 
+void ConcreteNegotiationProtocol::settleEarlyData(NegotiationSessionData& session, bool acceptedUnchanged) {
+    if (session.earlyDataStatus != EarlyDataStatus::PENDING) {
+        return;
+    }
+    session.earlyDataStatus = acceptedUnchanged ? EarlyDataStatus::ACCEPTED : EarlyDataStatus::REJECTED;
+    if (!acceptedUnchanged) {
+        session.earlyData.clear();
+        session.earlyData.shrink_to_fit();
+    }
+}
+
 bool ConcreteNegotiationProtocol::sendResponse(NegotiationProtocol::SessionId sessionId, NegotiationResponse responseType, const std::optional<NegotiableParams>& params) {
     (void)sessionId; (void)responseType; (void)params;
     return true; // Placeholder
@@ -905,10 +1093,78 @@ bool ConcreteNegotiationProtocol::sendReject(NegotiationProtocol::SessionId sess
     return true; // Placeholder
 }
 
+bool ConcreteNegotiationProtocol::sendResume(const std::string& targetAgentId, NegotiationProtocol::SessionId sessionId, const NegotiableParams& params) {
+    (void)targetAgentId; (void)sessionId; (void)params;
+    return true; // Placeholder
+}
+
+void ConcreteNegotiationProtocol::handleResumeReply(NegotiationProtocol::SessionId sessionId, SessionEntry& entry, MessageType type) {
+    auto& session = entry.data;
+    if (!session.resumed || session.state != NegotiationState::AWAITING_RESPONSE) {
+        logger_.warning("Ignoring resume reply for session " + std::to_string(sessionId) + 
+                       " in state " + StateTransitionValidator::stateToString(session.state));
+        return;
+    }
+
+    if (type == MessageType::RESUME_ACK) {
+        // The peer already holds these parameters, so there is nothing left to finalize
+        session.finalParams = session.initialProposal;
+        transitionStateLocked(sessionId, entry, NegotiationState::FINALIZED, "Peer confirmed resumed parameters");
+    } else {
+        session.failureReason = "Peer refused resumed parameters";
+        transitionStateLocked(sessionId, entry, NegotiationState::FAILED, *session.failureReason);
+    }
+}
+
+bool ConcreteNegotiationProtocol::sendRenegotiate(NegotiationProtocol::SessionId sessionId, const NegotiableParams& params) {
+    (void)sessionId; (void)params;
+    return true; // Placeholder
+}
+
+bool ConcreteNegotiationProtocol::sendRenegotiateReply(NegotiationProtocol::SessionId sessionId, bool accepted) {
+    (void)sessionId; (void)accepted;
+    return true; // Placeholder
+}
+
+void ConcreteNegotiationProtocol::handleRenegotiation(NegotiationProtocol::SessionId sessionId, SessionEntry& entry,
+                                                      MessageType type, const MessagePayload& payload) {
+    auto& session = entry.data;
+    if (session.state != NegotiationState::FINALIZED || !session.finalParams) {
+        logger_.warning("Ignoring renegotiation for session " + std::to_string(sessionId) + 
+                       " in state " + StateTransitionValidator::stateToString(session.state));
+        return;
+    }
+
+    if (type == MessageType::RENEGOTIATE) {
+        // An offer crossing one of ours is refused, so both sides never switch to different sets
+        const auto& params = std::get<RenegotiatePayload>(payload).params;
+        bool accepted = !session.pendingParams && isRenegotiable(*session.finalParams, params) &&
+                        validation::validateParameterSet(params) == validation::ValidationResult::VALID;
+        if (sendRenegotiateReply(sessionId, accepted) && accepted) {
+            session.finalParams = params;
+            logger_.info("Switched session " + std::to_string(sessionId) + " to renegotiated parameters");
+        }
+        return;
+    }
+
+    if (!session.pendingParams) {
+        logger_.warning("Ignoring unsolicited renegotiation reply for session " + std::to_string(sessionId));
+        return;
+    }
+    if (type == MessageType::RENEGOTIATE_ACK) {
+        session.finalParams = std::move(session.pendingParams);
+        logger_.info("Peer confirmed renegotiated parameters for session " + std::to_string(sessionId));
+    } else {
+        logger_.info("Peer kept the agreed parameters for session " + std::to_string(sessionId));
+    }
+    session.pendingParams.reset();
+}
+
 void ConcreteNegotiationProtocol::handleIncomingMessage(NegotiationProtocol::SessionId sessionId, MessageType type, const MessagePayload& payload) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
     try {
-        auto& session = getSessionData(sessionId);
+        auto entry = findSession(sessionId);
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        auto& session = entry->data;
         std::string messageTypeStr;
         switch (type) {
             case MessageType::PROPOSE: messageTypeStr = "PROPOSE"; break;
@@ -917,12 +1173,42 @@ void ConcreteNegotiationProtocol::handleIncomingMessage(NegotiationProtocol::Ses
             case MessageType::REJECT: messageTypeStr = "REJECT"; break;
             case MessageType::FINALIZE: messageTypeStr = "FINALIZE"; break;
             case MessageType::CLOSE: messageTypeStr = "CLOSE"; break;
+            case MessageType::RESUME: messageTypeStr = "RESUME"; break;
+            case MessageType::RESUME_ACK: messageTypeStr = "RESUME_ACK"; break;
+            case MessageType::RESUME_REJECT: messageTypeStr = "RESUME_REJECT"; break;
+            case MessageType::RENEGOTIATE: messageTypeStr = "RENEGOTIATE"; break;
+            case MessageType::RENEGOTIATE_ACK: messageTypeStr = "RENEGOTIATE_ACK"; break;
+            case MessageType::RENEGOTIATE_REJECT: messageTypeStr = "RENEGOTIATE_REJECT"; break;
             default: messageTypeStr = "UNKNOWN"; break;
         }
 
         logger_.info("Received " + messageTypeStr + " message for session " + std::to_string(sessionId) + 
                     " in state " + StateTransitionValidator::stateToString(session.state));
 
+        if (type == MessageType::RESUME_ACK || type == MessageType::RESUME_REJECT) {
+            handleResumeReply(sessionId, *entry, type);
+            return;
+        }
+        // Responder: hold back early data until the proposal is answered.
+        // Initiator: the answer tells whether the responder processed it.
+        if (type == MessageType::PROPOSE) {
+            if (const auto* propose = std::get_if<ProposePayload>(&payload); propose && !propose->earlyData.empty()) {
+                session.earlyData = propose->earlyData;
+                session.earlyDataStatus = EarlyDataStatus::PENDING;
+            }
+        } else if (type == MessageType::ACCEPT) {
+            const auto* accept = std::get_if<AcceptPayload>(&payload);
+            settleEarlyData(session, !accept || !accept->params || *accept->params == session.initialProposal);
+        } else if (type == MessageType::COUNTER || type == MessageType::REJECT) {
+            settleEarlyData(session, false);
+        }
+
+        if (type == MessageType::RENEGOTIATE || type == MessageType::RENEGOTIATE_ACK ||
+            type == MessageType::RENEGOTIATE_REJECT) {
+            handleRenegotiation(sessionId, *entry, type, payload);
+            return;
+        }
+
         // Process message based on current state and message type
         switch (session.state) {
             // ... cases for different states ...
@@ -987,8 +1273,9 @@ NegotiationResponse ConcreteNegotiationProtocol::evaluateProposal(
 }
 
 bool ConcreteNegotiationProtocol::handleProposal(NegotiationProtocol::SessionId sessionId, const NegotiableParams& proposedParams) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId);
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
     ParameterPreference preferences; // Placeholder
     auto response = evaluateProposal(proposedParams, preferences, session);
     // ... switch statement based on response ...
@@ -996,19 +1283,31 @@ bool ConcreteNegotiationProtocol::handleProposal(NegotiationProtocol::SessionId
 }
 
 bool ConcreteNegotiationProtocol::acceptProposal(NegotiationProtocol::SessionId sessionId, const std::optional<NegotiableParams>& finalParams) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId);
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
     // ... state validation, send response, transition state ...
     return false; // Placeholder return
 }
 
 bool ConcreteNegotiationProtocol::rejectProposal(NegotiationProtocol::SessionId sessionId, const std::optional<std::string>& reason) {
-    std::lock_guard<std::mutex> lock(sessionsMutex_);
-    auto& session = getSessionData(sessionId);
+    auto entry = findSession(sessionId); // Throws if not found
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    auto& session = entry->data;
     // ... state validation, send response, transition state ...
     return false; // Placeholder return
 }
 
+bool isRenegotiable(const NegotiableParams& current, const NegotiableParams& updated) {
+    return current.protocolVersion == updated.protocolVersion &&
+           current.securityVersion == updated.securityVersion &&
+           current.dataFormat == updated.dataFormat &&
+           current.encryptionAlgorithm == updated.encryptionAlgorithm &&
+           current.keyExchangeMethod == updated.keyExchangeMethod &&
+           current.authenticationMethod == updated.authenticationMethod &&
+           current.keySize == updated.keySize;
+}
+
 // --- Definitions for ParameterPreference methods (declared in header) ---
 
 // Placeholder definition - Replace with actual logic
@@ -1033,26 +1332,50 @@ NegotiableParams ParameterPreference::createOptimalParameters() const {
     return optimalParams; 
 }
 
-// Placeholder definition - Replace with actual logic
 NegotiableParams ParameterPreference::buildCompatibleParamsWithFallbacks(
-    [[maybe_unused]] const std::vector<DataFormat>& remoteFormats,
-    [[maybe_unused]] const std::vector<CompressionAlgorithm>& remoteCompression,
-    [[maybe_unused]] const std::vector<ErrorCorrectionScheme>& remoteErrorCorrection,
-    [[maybe_unused]] const std::vector<EncryptionAlgorithm>& remoteEncryption,
-    [[maybe_unused]] const std::vector<KeyExchangeMethod>& remoteKeyExchange,
-    [[maybe_unused]] const std::vector<AuthenticationMethod>& remoteAuth,
-    [[maybe_unused]] const std::vector<KeySize>& remoteKeySizes) const 
+    const std::vector<DataFormat>& remoteFormats,
+    const std::vector<CompressionAlgorithm>& remoteCompression,
+    const std::vector<ErrorCorrectionScheme>& remoteErrorCorrection,
+    const std::vector<EncryptionAlgorithm>& remoteEncryption,
+    const std::vector<KeyExchangeMethod>& remoteKeyExchange,
+    const std::vector<AuthenticationMethod>& remoteAuth,
+    const std::vector<KeySize>& remoteKeySizes) const 
 {
-    // TODO: Implement logic to find the best intersection between local preferences
-    // (including fallbacks) and remote capabilities. Prioritize higher-ranked local options.
-    // Start with optimal, then iterate through fallbacks if no match found.
-    
-    NegotiableParams compatibleParams = createOptimalParameters(); // Start with local optimal
-    
-    // Example simplified logic: Just return the locally optimal for now
-    // A real implementation would involve matching against remote capabilities.
+    // The best-ranked set both sides support, falling back where the remote lacks an option
+    AlternativeProposals proposals(CompiledPreference(*this), createOptimalParameters(),
+                                   remoteFormats, remoteCompression, remoteErrorCorrection,
+                                   remoteEncryption, remoteKeyExchange, remoteAuth, remoteKeySizes);
+    auto compatibleParams = proposals.next();
+    if (!compatibleParams) {
+        throw std::runtime_error("No parameter set is supported by both peers");
+    }
+    return *compatibleParams;
+}
 
-    return compatibleParams;
+std::vector<NegotiableParams> ParameterPreference::generateAlternativeProposals(
+    const NegotiableParams& rejectedProposal,
+    const std::vector<DataFormat>& remoteFormats,
+    const std::vector<CompressionAlgorithm>& remoteCompression,
+    const std::vector<ErrorCorrectionScheme>& remoteErrorCorrection,
+    const std::vector<EncryptionAlgorithm>& remoteEncryption,
+    const std::vector<KeyExchangeMethod>& remoteKeyExchange,
+    const std::vector<AuthenticationMethod>& remoteAuth,
+    const std::vector<KeySize>& remoteKeySizes,
+    size_t maxAlternatives) const
+{
+    AlternativeProposals proposals(CompiledPreference(*this), rejectedProposal,
+                                   remoteFormats, remoteCompression, remoteErrorCorrection,
+                                   remoteEncryption, remoteKeyExchange, remoteAuth, remoteKeySizes,
+                                   rejectedProposal);
+    std::vector<NegotiableParams> alternatives;
+    while (alternatives.size() < maxAlternatives) {
+        auto next = proposals.next();
+        if (!next) {
+            break;
+        }
+        alternatives.push_back(std::move(*next));
+    }
+    return alternatives;
 }
 
 // Factory function remains outside
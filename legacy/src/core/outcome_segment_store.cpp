@@ -0,0 +1,536 @@
+#include "xenocomm/core/outcome_segment_store.h"
+#include "xenocomm/utils/crc32.hpp"
+#include "xenocomm/utils/serialization.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xenocomm {
+
+namespace {
+
+enum Column : size_t { TIMESTAMPS, LATENCY, BYTES, RETRIES, ERRORS, FLAGS, DICTIONARY, INDEX, COLUMN_COUNT };
+constexpr size_t DATA_COLUMNS = DICTIONARY;  // The columns with one value per outcome
+
+// Index entry after each block: its last timestamp, the decoder state and
+// where the next block starts in each data column
+constexpr size_t INDEX_ENTRY_SIZE = 8 + 8 + 8 + 4 * DATA_COLUMNS;
+
+constexpr size_t HEADER_SIZE = 4 + 4 + 8 + 8 + 4 * COLUMN_COUNT + 4;
+constexpr size_t CRC_OFFSET = HEADER_SIZE - 4;
+constexpr const char* SEGMENT_EXTENSION = ".xsg";
+
+struct SegmentHeader {
+    uint32_t count = 0;
+    int64_t first = 0;
+    int64_t last = 0;
+    std::array<uint32_t, COLUMN_COUNT> columnSizes{};
+    uint32_t crc = 0;
+};
+
+void putU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void putU64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t getU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int64_t toNanos(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromNanos(int64_t nanos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+}
+
+bool parseHeader(const uint8_t* data, size_t size, SegmentHeader& header) {
+    if (size < HEADER_SIZE || getU32(data) != OUTCOME_SEGMENT_MAGIC) {
+        return false;
+    }
+    header.count = getU32(data + 4);
+    header.first = static_cast<int64_t>(getU64(data + 8));
+    header.last = static_cast<int64_t>(getU64(data + 16));
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        header.columnSizes[i] = getU32(data + 24 + 4 * i);
+    }
+    header.crc = getU32(data + CRC_OFFSET);
+    return true;
+}
+
+// Sequential reader of one column
+class ColumnReader {
+public:
+    ColumnReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool next(uint64_t& value) {
+        size_t used = 0;
+        if (!utils::readVarint(data_ + offset_, size_ - offset_, value, &used)) {
+            return false;
+        }
+        offset_ += used;
+        return true;
+    }
+
+    size_t offset() const { return offset_; }
+
+    bool seek(size_t offset) {
+        if (offset > size_) {
+            return false;
+        }
+        offset_ = offset;
+        return true;
+    }
+
+    bool bytes(size_t count, const uint8_t*& out) {
+        if (count > size_ - offset_) {
+            return false;
+        }
+        out = data_ + offset_;
+        offset_ += count;
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+// Read-only mapping of a whole file, unmapped on destruction
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                data_ = static_cast<const uint8_t*>(mapped);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace
+
+OutcomeSegmentStore::OutcomeSegmentStore(std::string directory) : directory_(std::move(directory)) {
+    std::filesystem::create_directories(directory_);
+    scan();
+}
+
+void OutcomeSegmentStore::scan() {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+        if (entry.is_regular_file() && entry.path().extension() == SEGMENT_EXTENSION) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& file : files) {
+        std::ifstream in(file, std::ios::binary);
+        std::array<uint8_t, HEADER_SIZE> bytes{};
+        SegmentHeader header;
+        if (!in.read(reinterpret_cast<char*>(bytes.data()), bytes.size()) ||
+            !parseHeader(bytes.data(), bytes.size(), header)) {
+            continue;  // Not a segment, or cut short; left for inspection
+        }
+        segments_.push_back({file.string(), header.count, fromNanos(header.first), fromNanos(header.last)});
+        try {
+            nextSequence_ = std::max<uint64_t>(nextSequence_, std::stoull(file.stem().string().substr(8)) + 1);
+        } catch (const std::exception&) {
+            // Foreign name; sequence numbers still come from the others
+        }
+    }
+}
+
+std::vector<uint8_t> OutcomeSegmentStore::encodeSegment(const std::vector<CommunicationOutcome>& sorted) {
+    std::array<std::vector<uint8_t>, COLUMN_COUNT> columns;
+    std::unordered_map<std::string, uint64_t> dictionary;
+    std::vector<const std::string*> dictionaryOrder;
+
+    int64_t previousTime = 0;
+    int64_t previousDelta = 0;
+    int64_t previousLatency = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const auto& outcome = sorted[i];
+        int64_t time = toNanos(outcome.timestamp);
+        if (i == 0) {
+            utils::appendVarint(zigzag(time), columns[TIMESTAMPS]);
+        } else {
+            int64_t delta = time - previousTime;
+            utils::appendVarint(zigzag(delta - previousDelta), columns[TIMESTAMPS]);
+            previousDelta = delta;
+        }
+        previousTime = time;
+
+        int64_t latency = outcome.latency.count();
+        utils::appendVarint(zigzag(latency - previousLatency), columns[LATENCY]);
+        previousLatency = latency;
+
+        utils::appendVarint(outcome.bytesTransferred, columns[BYTES]);
+        utils::appendVarint(outcome.retryCount, columns[RETRIES]);
+        utils::appendVarint(outcome.errorCount, columns[ERRORS]);
+
+        uint64_t errorType = 0;
+        if (!outcome.errorType.empty()) {
+            auto [it, inserted] = dictionary.emplace(outcome.errorType, dictionary.size() + 1);
+            if (inserted) {
+                dictionaryOrder.push_back(&it->first);
+            }
+            errorType = it->second;
+        }
+        utils::appendVarint((errorType << 1) | (outcome.success ? 1 : 0), columns[FLAGS]);
+
+        if ((i + 1) % OutcomeSegmentStore::INDEX_BLOCK == 0 && i + 1 < sorted.size()) {
+            auto& index = columns[INDEX];
+            size_t at = index.size();
+            index.resize(at + INDEX_ENTRY_SIZE);
+            putU64(index.data() + at, static_cast<uint64_t>(time));
+            putU64(index.data() + at + 8, static_cast<uint64_t>(previousDelta));
+            putU64(index.data() + at + 16, static_cast<uint64_t>(latency));
+            for (size_t c = 0; c < DATA_COLUMNS; ++c) {
+                putU32(index.data() + at + 24 + 4 * c, static_cast<uint32_t>(columns[c].size()));
+            }
+        }
+    }
+
+    utils::appendVarint(dictionaryOrder.size(), columns[DICTIONARY]);
+    for (const auto* name : dictionaryOrder) {
+        utils::appendVarint(name->size(), columns[DICTIONARY]);
+        columns[DICTIONARY].insert(columns[DICTIONARY].end(), name->begin(), name->end());
+    }
+
+    size_t total = HEADER_SIZE;
+    for (const auto& column : columns) {
+        total += column.size();
+    }
+    std::vector<uint8_t> out(HEADER_SIZE);
+    out.reserve(total);
+    for (const auto& column : columns) {
+        out.insert(out.end(), column.begin(), column.end());
+    }
+
+    putU32(out.data(), OUTCOME_SEGMENT_MAGIC);
+    putU32(out.data() + 4, static_cast<uint32_t>(sorted.size()));
+    putU64(out.data() + 8, static_cast<uint64_t>(sorted.empty() ? 0 : toNanos(sorted.front().timestamp)));
+    putU64(out.data() + 16, static_cast<uint64_t>(sorted.empty() ? 0 : toNanos(sorted.back().timestamp)));
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        putU32(out.data() + 24 + 4 * i, static_cast<uint32_t>(columns[i].size()));
+    }
+    putU32(out.data() + CRC_OFFSET, utils::crc32(out.data() + HEADER_SIZE, out.size() - HEADER_SIZE));
+    return out;
+}
+
+bool OutcomeSegmentStore::decodeSegment(const uint8_t* data, size_t size, std::chrono::system_clock::time_point start,
+                                        std::chrono::system_clock::time_point end,
+                                        std::vector<CommunicationOutcome>& out, bool verify) {
+    SegmentHeader header;
+    if (!parseHeader(data, size, header)) {
+        return false;
+    }
+    uint64_t payload = 0;
+    for (auto columnSize : header.columnSizes) {
+        payload += columnSize;
+    }
+    if (payload != size - HEADER_SIZE || (verify && utils::crc32(data + HEADER_SIZE, payload) != header.crc)) {
+        return false;
+    }
+    if (header.columnSizes[INDEX] % INDEX_ENTRY_SIZE != 0) {
+        return false;
+    }
+
+    std::array<ColumnReader, COLUMN_COUNT> readers{{
+        {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {nullptr, 0}}};
+    const uint8_t* column = data + HEADER_SIZE;
+    for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+        readers[i] = ColumnReader(column, header.columnSizes[i]);
+        column += header.columnSizes[i];
+    }
+
+    std::vector<std::string> dictionary{""};
+    uint64_t entries = 0;
+    if (!readers[DICTIONARY].next(entries) || entries > header.columnSizes[DICTIONARY]) {
+        return false;
+    }
+    for (uint64_t i = 0; i < entries; ++i) {
+        uint64_t length = 0;
+        const uint8_t* bytes = nullptr;
+        if (!readers[DICTIONARY].next(length) || !readers[DICTIONARY].bytes(length, bytes)) {
+            return false;
+        }
+        dictionary.emplace_back(reinterpret_cast<const char*>(bytes), length);
+    }
+
+    const int64_t startNanos = toNanos(start);
+    const int64_t endNanos = toNanos(end);
+    int64_t time = 0;
+    int64_t delta = 0;
+    int64_t latency = 0;
+    uint32_t first = 0;
+
+    // Resume after the last block that ends before start
+    const uint8_t* index = data + HEADER_SIZE + payload - header.columnSizes[INDEX];
+    size_t blocks = header.columnSizes[INDEX] / INDEX_ENTRY_SIZE;
+    size_t low = 0;
+    size_t high = blocks;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (static_cast<int64_t>(getU64(index + mid * INDEX_ENTRY_SIZE)) < startNanos) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low > 0) {
+        const uint8_t* entry = index + (low - 1) * INDEX_ENTRY_SIZE;
+        first = static_cast<uint32_t>(low * INDEX_BLOCK);
+        if (first >= header.count) {
+            return false;
+        }
+        time = static_cast<int64_t>(getU64(entry));
+        delta = static_cast<int64_t>(getU64(entry + 8));
+        latency = static_cast<int64_t>(getU64(entry + 16));
+        for (size_t c = 0; c < DATA_COLUMNS; ++c) {
+            if (!readers[c].seek(getU32(entry + 24 + 4 * c))) {
+                return false;
+            }
+        }
+    }
+
+    for (uint32_t i = first; i < header.count; ++i) {
+        uint64_t raw[DATA_COLUMNS];
+        for (size_t c = 0; c < DATA_COLUMNS; ++c) {
+            if (!readers[c].next(raw[c])) {
+                return false;
+            }
+        }
+        if (i == 0) {
+            time = unzigzag(raw[TIMESTAMPS]);
+        } else {
+            delta += unzigzag(raw[TIMESTAMPS]);
+            time += delta;
+        }
+        latency += unzigzag(raw[LATENCY]);
+        uint64_t errorType = raw[FLAGS] >> 1;
+        if (errorType >= dictionary.size()) {
+            return false;
+        }
+        if (time > endNanos) {
+            break;  // Sorted, so nothing later matches
+        }
+        if (time < startNanos) {
+            continue;
+        }
+        out.push_back(CommunicationOutcome{
+            (raw[FLAGS] & 1) != 0,
+            std::chrono::microseconds(latency),
+            static_cast<uint32_t>(raw[BYTES]),
+            static_cast<uint32_t>(raw[RETRIES]),
+            static_cast<uint32_t>(raw[ERRORS]),
+            dictionary[errorType],
+            fromNanos(time)
+        });
+    }
+    return true;
+}
+
+Result<void> OutcomeSegmentStore::writeSegment(const std::vector<uint8_t>& bytes, OutcomeSegmentInfo info) {
+    std::ostringstream name;
+    name << "segment_" << std::setw(16) << std::setfill('0') << nextSequence_ << SEGMENT_EXTENSION;
+    auto path = std::filesystem::path(directory_) / name.str();
+    auto temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+            return Result<void>(std::string("Failed to write segment: " + temporary.string()));
+        }
+    }
+    // Readers only ever see whole segments
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return Result<void>(std::string("Failed to publish segment: " + path.string()));
+    }
+    ++nextSequence_;
+    info.path = path.string();
+    segments_.push_back(std::move(info));
+    return Result<void>();
+}
+
+Result<void> OutcomeSegmentStore::append(const std::vector<CommunicationOutcome>& outcomes) {
+    if (outcomes.empty()) {
+        return Result<void>();
+    }
+    std::vector<CommunicationOutcome> sorted = outcomes;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
+    auto bytes = encodeSegment(sorted);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writeSegment(bytes, {"", static_cast<uint32_t>(sorted.size()), sorted.front().timestamp, sorted.back().timestamp});
+}
+
+Result<std::vector<CommunicationOutcome>> OutcomeSegmentStore::query(std::chrono::system_clock::time_point start,
+                                                                     std::chrono::system_clock::time_point end) const {
+    if (end < start) {
+        return Result<std::vector<CommunicationOutcome>>(std::vector<CommunicationOutcome>{});
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<CommunicationOutcome> results;
+    bool ordered = true;  // Segments rarely overlap; only sort if they do
+    std::chrono::system_clock::time_point previousLast = std::chrono::system_clock::time_point::min();
+    for (auto& segment : segments_) {
+        if (segment.last < start || segment.first > end) {
+            continue;
+        }
+        MappedFile file(segment.path);
+        if (!file.data() || !decodeSegment(file.data(), file.size(), start, end, results, !segment.verified)) {
+            return Result<std::vector<CommunicationOutcome>>(std::string("Corrupt outcome segment: " + segment.path));
+        }
+        segment.verified = true;
+        ordered = ordered && segment.first >= previousLast;
+        previousLast = std::max(previousLast, segment.last);
+    }
+    if (!ordered) {
+        std::stable_sort(results.begin(), results.end(),
+                         [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
+    }
+    return Result<std::vector<CommunicationOutcome>>(std::move(results));
+}
+
+Result<void> OutcomeSegmentStore::compact(std::chrono::system_clock::time_point retainFrom) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (segments_.empty()) {
+        return Result<void>();
+    }
+
+    std::vector<CommunicationOutcome> merged;
+    for (const auto& segment : segments_) {
+        if (segment.last < retainFrom) {
+            continue;
+        }
+        MappedFile file(segment.path);
+        if (!file.data() || !decodeSegment(file.data(), file.size(), retainFrom,
+                                           std::chrono::system_clock::time_point::max(), merged)) {
+            return Result<void>(std::string("Corrupt outcome segment: " + segment.path));
+        }
+    }
+    std::stable_sort(merged.begin(), merged.end(),
+                     [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
+
+    auto previous = std::move(segments_);
+    segments_.clear();
+    if (!merged.empty()) {
+        auto result = writeSegment(encodeSegment(merged),
+                                   {"", static_cast<uint32_t>(merged.size()), merged.front().timestamp, merged.back().timestamp});
+        if (!result.has_value()) {
+            segments_ = std::move(previous);
+            return result;
+        }
+    }
+    // The merged segment is in place before the old ones go
+    for (const auto& segment : previous) {
+        std::error_code ec;
+        std::filesystem::remove(segment.path, ec);
+    }
+    return Result<void>();
+}
+
+Result<void> OutcomeSegmentStore::dropBefore(std::chrono::system_clock::time_point cutoff) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<OutcomeSegmentInfo> kept;
+    for (auto& segment : segments_) {
+        if (segment.last < cutoff) {
+            std::error_code ec;
+            std::filesystem::remove(segment.path, ec);
+            if (!ec) {
+                continue;
+            }
+        }
+        kept.push_back(std::move(segment));
+    }
+    segments_ = std::move(kept);
+    return Result<void>();
+}
+
+std::optional<std::chrono::system_clock::time_point> OutcomeSegmentStore::oldest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::optional<std::chrono::system_clock::time_point> oldest;
+    for (const auto& segment : segments_) {
+        if (segment.count > 0 && (!oldest || segment.first < *oldest)) {
+            oldest = segment.first;
+        }
+    }
+    return oldest;
+}
+
+std::vector<OutcomeSegmentInfo> OutcomeSegmentStore::segments() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_;
+}
+
+} // namespace xenocomm
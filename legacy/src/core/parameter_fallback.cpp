@@ -148,7 +148,7 @@ bool isFormatCompatibleWithCompression(DataFormat format, CompressionAlgorithm c
 
 bool isFormatCompatibleWithErrorCorrection(DataFormat format, ErrorCorrectionScheme scheme) {
     // Some formats might have built-in error correction
-    if (format == DataFormat::GGWAVE_FSK) {
+    if (format == DataFormat::GGWAVE_FSK || format == DataFormat::GGWAVE_FSK_MULTIBAND) {
         // GGWAVE_FSK has built-in error correction, so additional schemes might conflict
         return scheme == ErrorCorrectionScheme::NONE ||
                scheme == ErrorCorrectionScheme::CHECKSUM_ONLY;
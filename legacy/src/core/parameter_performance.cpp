@@ -0,0 +1,166 @@
+#include "xenocomm/core/parameter_performance.h"
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// Aggregate across all peers, used for peers without enough history
+const std::string ALL_PEERS;
+
+// Below this a link is effectively down; avoids dividing by zero
+constexpr double MIN_SUCCESS_RATE = 0.01;
+
+} // namespace
+
+double ParameterStats::expectedCost() const {
+    return latencySeconds / std::max(successRate, MIN_SUCCESS_RATE);
+}
+
+ParameterPerformanceModel::ParameterPerformanceModel(const ParameterPerformanceConfig& config,
+                                                     std::shared_ptr<FeedbackLoop> feedback)
+    : config_(config)
+    , feedback_(std::move(feedback)) {
+    config_.learningRate = std::clamp(config_.learningRate, 0.01, 1.0);
+    config_.minSamples = std::max<uint32_t>(config_.minSamples, 1);
+}
+
+void ParameterPerformanceModel::observe(const std::string& peerId, const NegotiableParams& params,
+                                        const CommunicationOutcome& outcome) {
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const std::string* key : {&peerId, &ALL_PEERS}) {
+            PeerStats& stats = peers_[*key];
+            update(stats.formats[RankTable<DataFormat>::slot(params.dataFormat)], outcome);
+            update(stats.compression[RankTable<CompressionAlgorithm>::slot(params.compressionAlgorithm)], outcome);
+            update(stats.errorCorrection[RankTable<ErrorCorrectionScheme>::slot(params.errorCorrection)], outcome);
+            if (peerId.empty()) {
+                break;
+            }
+        }
+    }
+    if (feedback_) {
+        // Enums as their numeric values, which stay stable across releases
+        OutcomeLabels labels;
+        labels.peerId = peerId;
+        labels.dataFormat = std::to_string(static_cast<int>(params.dataFormat));
+        labels.compression = std::to_string(static_cast<int>(params.compressionAlgorithm));
+        feedback_->reportOutcome(outcome, labels);
+    }
+}
+
+void ParameterPerformanceModel::update(ParameterStats& stats, const CommunicationOutcome& outcome) const {
+    double latency = std::chrono::duration<double>(outcome.latency).count();
+    double retries = outcome.retryCount;
+    double success = outcome.success ? 1.0 : 0.0;
+    if (stats.samples == 0) {
+        stats.latencySeconds = latency;
+        stats.retries = retries;
+        stats.successRate = success;
+    } else {
+        double rate = config_.learningRate;
+        stats.latencySeconds += rate * (latency - stats.latencySeconds);
+        stats.retries += rate * (retries - stats.retries);
+        stats.successRate += rate * (success - stats.successRate);
+    }
+    ++stats.samples;
+}
+
+template <typename T>
+std::optional<ParameterStats> ParameterPerformanceModel::lookup(const std::string& peerId, T value,
+                                                                Slots PeerStats::*dimension) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = peers_.find(peerId);
+    if (it == peers_.end()) {
+        return std::nullopt;
+    }
+    const ParameterStats& stats = (it->second.*dimension)[RankTable<T>::slot(value)];
+    if (stats.samples == 0) {
+        return std::nullopt;
+    }
+    return stats;
+}
+
+std::optional<ParameterStats> ParameterPerformanceModel::stats(const std::string& peerId, DataFormat value) const {
+    return lookup(peerId, value, &PeerStats::formats);
+}
+
+std::optional<ParameterStats> ParameterPerformanceModel::stats(const std::string& peerId, CompressionAlgorithm value) const {
+    return lookup(peerId, value, &PeerStats::compression);
+}
+
+std::optional<ParameterStats> ParameterPerformanceModel::stats(const std::string& peerId, ErrorCorrectionScheme value) const {
+    return lookup(peerId, value, &PeerStats::errorCorrection);
+}
+
+template <typename T>
+void ParameterPerformanceModel::rerank(std::vector<RankedOption<T>>& options,
+                                       const Slots* peer, const Slots& all) const {
+    // The measured options trade places by cost within the ranks they
+    // already hold, so unmeasured options stay exactly where they were
+    std::vector<size_t> measured;
+    std::vector<double> cost(options.size());
+    for (size_t i = 0; i < options.size(); ++i) {
+        size_t slot = RankTable<T>::slot(options[i].value);
+        const ParameterStats* stats = nullptr;
+        if (peer && (*peer)[slot].samples >= config_.minSamples) {
+            stats = &(*peer)[slot];
+        } else if (all[slot].samples >= config_.minSamples) {
+            stats = &all[slot];
+        }
+        if (stats) {
+            measured.push_back(i);
+            cost[i] = stats->expectedCost();
+        }
+    }
+    if (measured.size() < 2) {
+        return;
+    }
+
+    std::vector<uint8_t> ranks;
+    for (size_t i : measured) {
+        ranks.push_back(options[i].rank);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    std::vector<size_t> byCost = measured;
+    std::stable_sort(byCost.begin(), byCost.end(), [&](size_t a, size_t b) { return cost[a] < cost[b]; });
+    for (size_t i = 0; i < byCost.size(); ++i) {
+        options[byCost[i]].rank = ranks[i];
+    }
+}
+
+ParameterPreference ParameterPerformanceModel::rankByPerformance(const ParameterPreference& preferences,
+                                                                 const std::string& peerId) const {
+    ParameterPreference ranked = preferences;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto all = peers_.find(ALL_PEERS);
+    if (all == peers_.end()) {
+        return ranked;
+    }
+    auto it = peerId.empty() ? peers_.end() : peers_.find(peerId);
+    const PeerStats* peer = it == peers_.end() ? nullptr : &it->second;
+
+    rerank(ranked.dataFormats, peer ? &peer->formats : nullptr, all->second.formats);
+    rerank(ranked.compressionAlgorithms, peer ? &peer->compression : nullptr, all->second.compression);
+    rerank(ranked.errorCorrectionSchemes, peer ? &peer->errorCorrection : nullptr, all->second.errorCorrection);
+
+    // Callers may take the first option as the most preferred
+    auto byRank = [](auto& options) { std::stable_sort(options.begin(), options.end()); };
+    byRank(ranked.dataFormats);
+    byRank(ranked.compressionAlgorithms);
+    byRank(ranked.errorCorrectionSchemes);
+    return ranked;
+}
+
+void ParameterPerformanceModel::resetPeer(const std::string& peerId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    peers_.erase(peerId);
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,691 @@
+#include "xenocomm/core/peer_connection.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr size_t RECEIVE_BUFFER = 64 * 1024;  // One per loop thread, shared by every connection it serves
+constexpr int MAX_READS_PER_EVENT = 16;       // Then yield to the loop's other connections
+constexpr int MAX_ACCEPTS_PER_EVENT = 256;
+
+uint32_t slotOf(PeerConnectionEngine::ConnectionId id) {
+    return static_cast<uint32_t>(id);
+}
+
+uint32_t generationOf(PeerConnectionEngine::ConnectionId id) {
+    return static_cast<uint32_t>(id >> 32);
+}
+
+PeerConnectionEngine::ConnectionId makeId(uint32_t slot, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | slot;
+}
+
+// Adds one byte to a partial length prefix: 1 once complete, 0 for more, -1 if malformed
+int parsePrefix(const uint8_t* prefix, size_t length, utils::FrameLengthEncoding encoding, uint64_t& value) {
+    if (encoding == utils::FrameLengthEncoding::FIXED32) {
+        if (length < 4) {
+            return 0;
+        }
+        value = (uint64_t{prefix[0]} << 24) | (uint64_t{prefix[1]} << 16) | (uint64_t{prefix[2]} << 8) | prefix[3];
+        return 1;
+    }
+    if (prefix[length - 1] & 0x80) {
+        return length == utils::MAX_FRAME_PREFIX ? -1 : 0;
+    }
+    value = 0;
+    for (size_t i = 0; i < length; ++i) {
+        value |= uint64_t{prefix[i] & 0x7Fu} << (7 * i);
+    }
+    return value > UINT32_MAX ? -1 : 1;
+}
+
+#ifndef _WIN32
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Writes as much of the spans as the kernel takes; bytes written, or -1 on a socket error
+ssize_t writeSome(int fd, const uint8_t* first, size_t firstSize, const uint8_t* second, size_t secondSize) {
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<uint8_t*>(first);
+    iov[0].iov_len = firstSize;
+    iov[1].iov_base = const_cast<uint8_t*>(second);
+    iov[1].iov_len = secondSize;
+    struct msghdr message{};
+    message.msg_iov = iov;
+    message.msg_iovlen = secondSize > 0 ? 2 : 1;
+    ssize_t written;
+    do {
+        written = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+    } while (written < 0 && errno == EINTR);
+    if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return 0;
+    }
+    return written;
+}
+#endif
+
+void closeFd(int fd) {
+#ifdef _WIN32
+    ::closesocket(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+struct PeerConnectionEngine::Handle {
+    std::vector<uint8_t> inbound;   // Payload of a frame split across reads
+    std::vector<uint8_t> outbound;  // Framed bytes the kernel has not taken yet
+    int fd = -1;
+    uint32_t generation = 1;
+    uint32_t outboundOffset = 0;    // Bytes of outbound already written
+    uint32_t frameLength = 0;       // Payload length, once the prefix is complete
+    uint32_t lastActive = 0;        // nowTick() of the last read or write
+    uint32_t nextFree = NO_SLOT;
+    ConnectionState state = ConnectionState::DISCONNECTED;
+    uint8_t prefixLength = 0;       // Prefix bytes received for the frame being read
+    bool prefixDone = false;
+    bool writeInterest = false;     // Whether the reactor is watching for WRITABLE
+    uint8_t prefix[utils::MAX_FRAME_PREFIX];
+
+    void nextFrame() {
+        prefixLength = 0;
+        prefixDone = false;
+        frameLength = 0;
+    }
+};
+
+struct PeerConnectionEngine::Chunk {
+    Handle handles[CHUNK_HANDLES];
+};
+
+PeerConnectionEngine::PeerConnectionEngine(const PeerEngineConfig& config, EventReactor& reactor)
+    : config_(config), reactor_(reactor), epoch_(std::chrono::steady_clock::now()) {
+    config_.maxConnections = std::min<size_t>(std::max<size_t>(config_.maxConnections, 1), NO_SLOT);
+    chunkCount_ = (config_.maxConnections + CHUNK_HANDLES - 1) / CHUNK_HANDLES;
+    chunks_.reset(new std::atomic<Chunk*>[chunkCount_]());
+    if (config_.idleTimeout.count() > 0) {
+        sweepTimer_ = reactor_.scheduleEvery(std::max(config_.idleTimeout / 2, std::chrono::milliseconds(1)),
+                                             [this]() { sweepIdle(); });
+    }
+}
+
+PeerConnectionEngine::~PeerConnectionEngine() {
+    if (sweepTimer_) {
+        reactor_.cancelTimer(sweepTimer_);
+    }
+    if (listenFd_ >= 0) {
+        reactor_.remove(listenFd_);
+        closeFd(listenFd_);
+    }
+    uint32_t slots = slotsInUse_.load(std::memory_order_acquire);
+    for (uint32_t slot = 0; slot < slots; ++slot) {
+        ConnectionId id = 0;
+        {
+            std::lock_guard<std::mutex> lock(lockFor(slot));
+            Handle* handle = handleAt(slot);
+            if (handle->fd >= 0) {
+                id = makeId(slot, handle->generation);
+            }
+        }
+        if (id) {
+            closeConnection(id, false);
+        }
+    }
+    for (size_t chunk = 0; chunk < chunkCount_; ++chunk) {
+        delete chunks_[chunk].load(std::memory_order_relaxed);
+    }
+}
+
+PeerConnectionEngine::Handle* PeerConnectionEngine::handleAt(uint32_t slot) const {
+    if (slot >= slotsInUse_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    Chunk* chunk = chunks_[slot >> CHUNK_SHIFT].load(std::memory_order_acquire);
+    return &chunk->handles[slot & (CHUNK_HANDLES - 1)];
+}
+
+uint32_t PeerConnectionEngine::allocateSlot() {
+    std::lock_guard<std::mutex> lock(slotMutex_);
+    if (freeHead_ != NO_SLOT) {
+        uint32_t slot = freeHead_;
+        freeHead_ = handleAt(slot)->nextFree;
+        return slot;
+    }
+    uint32_t slot = slotsInUse_.load(std::memory_order_relaxed);
+    if (slot >= config_.maxConnections) {
+        return NO_SLOT;
+    }
+    auto& chunk = chunks_[slot >> CHUNK_SHIFT];
+    if (!chunk.load(std::memory_order_relaxed)) {
+        chunk.store(new Chunk(), std::memory_order_release);
+    }
+    slotsInUse_.store(slot + 1, std::memory_order_release);
+    return slot;
+}
+
+void PeerConnectionEngine::releaseSlot(uint32_t slot) {
+    Handle* handle = handleAt(slot);
+    {
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        std::vector<uint8_t>().swap(handle->inbound);
+        std::vector<uint8_t>().swap(handle->outbound);
+        handle->outboundOffset = 0;
+        handle->writeInterest = false;
+        handle->nextFrame();
+        // Ids handed out for the old connection no longer match
+        if (++handle->generation == 0) {
+            handle->generation = 1;
+        }
+    }
+    std::lock_guard<std::mutex> lock(slotMutex_);
+    handle->nextFree = freeHead_;
+    freeHead_ = slot;
+}
+
+uint32_t PeerConnectionEngine::nowTick() const {
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch_).count());
+}
+
+void PeerConnectionEngine::setError(const std::string& message) const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = message;
+}
+
+std::string PeerConnectionEngine::getLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+size_t PeerConnectionEngine::handleSize() {
+    return sizeof(Handle);
+}
+
+bool PeerConnectionEngine::listen(uint16_t port, const std::string& address) {
+#ifdef _WIN32
+    setError("Peer connections are not supported on Windows");
+    return false;
+#else
+    if (listenFd_ >= 0) {
+        setError("Already listening");
+        return false;
+    }
+    struct sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1) {
+        setError("Invalid listen address: " + address);
+        return false;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        setError(std::string("Failed to create listener: ") + std::strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    socklen_t length = sizeof(local);
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::listen(fd, config_.listenBacklog) != 0 || !setNonBlocking(fd) ||
+        ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&local), &length) != 0) {
+        setError(std::string("Failed to listen: ") + std::strerror(errno));
+        closeFd(fd);
+        return false;
+    }
+    if (!reactor_.add(fd, EventReactor::READABLE, [this](int, uint32_t) { onListenerReadable(); })) {
+        setError("Failed to watch the listener");
+        closeFd(fd);
+        return false;
+    }
+    listenFd_ = fd;
+    listenPort_ = ntohs(local.sin_port);
+    return true;
+#endif
+}
+
+void PeerConnectionEngine::onListenerReadable() {
+#ifndef _WIN32
+    for (int accepted = 0; accepted < MAX_ACCEPTS_PER_EVENT; ++accepted) {
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                setError(std::string("Accept failed: ") + std::strerror(errno));
+            }
+            return;
+        }
+        ConnectionId id = registerSocket(fd, ConnectionState::CONNECTED);
+        if (id && stateCallback_) {
+            stateCallback_(id, ConnectionState::CONNECTED);
+        }
+    }
+#endif
+}
+
+PeerConnectionEngine::ConnectionId PeerConnectionEngine::connect(const std::string& address, uint16_t port) {
+#ifdef _WIN32
+    setError("Peer connections are not supported on Windows");
+    return 0;
+#else
+    struct sockaddr_in remote{};
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &remote.sin_addr) != 1) {
+        setError("Invalid peer address: " + address);
+        return 0;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || !setNonBlocking(fd)) {
+        setError(std::string("Failed to create socket: ") + std::strerror(errno));
+        if (fd >= 0) {
+            closeFd(fd);
+        }
+        return 0;
+    }
+    if (::connect(fd, reinterpret_cast<struct sockaddr*>(&remote), sizeof(remote)) != 0 && errno != EINPROGRESS) {
+        setError(std::string("Failed to connect: ") + std::strerror(errno));
+        closeFd(fd);
+        return 0;
+    }
+    // Even a connect that finished at once is reported from the loop, once the socket shows writable
+    return registerSocket(fd, ConnectionState::CONNECTING);
+#endif
+}
+
+PeerConnectionEngine::ConnectionId PeerConnectionEngine::adopt(int fd) {
+#ifdef _WIN32
+    setError("Peer connections are not supported on Windows");
+    closeFd(fd);
+    return 0;
+#else
+    if (fd < 0 || !setNonBlocking(fd)) {
+        setError("Cannot adopt an invalid socket");
+        if (fd >= 0) {
+            closeFd(fd);
+        }
+        return 0;
+    }
+    return registerSocket(fd, ConnectionState::CONNECTED);
+#endif
+}
+
+PeerConnectionEngine::ConnectionId PeerConnectionEngine::registerSocket(int fd, ConnectionState initial) {
+#ifdef _WIN32
+    closeFd(fd);
+    return 0;
+#else
+    uint32_t slot = allocateSlot();
+    if (slot == NO_SLOT) {
+        setError("Connection limit reached");
+        closeFd(fd);
+        return 0;
+    }
+    if (!setNonBlocking(fd)) {
+        setError(std::string("Failed to configure socket: ") + std::strerror(errno));
+        closeFd(fd);
+        releaseSlot(slot);
+        return 0;
+    }
+    int noDelay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    const bool connecting = initial == ConnectionState::CONNECTING;
+    Handle* handle = handleAt(slot);
+    ConnectionId id;
+    {
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        handle->fd = fd;
+        handle->state = initial;
+        handle->lastActive = nowTick();
+        handle->writeInterest = connecting;
+        id = makeId(slot, handle->generation);
+    }
+    connectionCount_.fetch_add(1, std::memory_order_relaxed);
+    // The callback captures just the engine and the id, which fits std::function's inline storage
+    if (!reactor_.add(fd, connecting ? EventReactor::WRITABLE : EventReactor::READABLE,
+                      [this, id](int, uint32_t events) { onEvents(id, events); })) {
+        setError("Failed to watch the connection");
+        closeConnection(id, false);
+        return 0;
+    }
+    return id;
+#endif
+}
+
+void PeerConnectionEngine::onEvents(ConnectionId id, uint32_t events) {
+#ifndef _WIN32
+    const uint32_t slot = slotOf(id);
+    Handle* handle = handleAt(slot);
+    if (!handle) {
+        return;
+    }
+    if (events & EventReactor::FAILED) {
+        closeConnection(id, true);
+        return;
+    }
+
+    bool connected = false;
+    bool failed = false;
+    if (events & EventReactor::WRITABLE) {
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        if (handle->generation != generationOf(id) || handle->fd < 0) {
+            return;
+        }
+        if (handle->state == ConnectionState::CONNECTING) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if (::getsockopt(handle->fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+                failed = true;
+            } else {
+                handle->state = ConnectionState::CONNECTED;
+                connected = true;
+            }
+        }
+        if (!failed) {
+            failed = !flushLocked(*handle);
+        }
+        if (!failed && handle->outbound.empty()) {
+            handle->writeInterest = false;
+            reactor_.modify(handle->fd, EventReactor::READABLE);
+        }
+    } else if (events & EventReactor::CLOSED) {
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        failed = handle->generation == generationOf(id) && handle->state == ConnectionState::CONNECTING;
+    }
+    if (failed) {
+        closeConnection(id, true);
+        return;
+    }
+    if (connected && stateCallback_) {
+        stateCallback_(id, ConnectionState::CONNECTED);
+    }
+    if ((events & (EventReactor::READABLE | EventReactor::CLOSED)) && !readAvailable(id)) {
+        closeConnection(id, true);
+    }
+#endif
+}
+
+bool PeerConnectionEngine::readAvailable(ConnectionId id) {
+#ifdef _WIN32
+    return false;
+#else
+    thread_local std::vector<uint8_t> buffer(RECEIVE_BUFFER);
+    thread_local std::vector<utils::ByteSpan> frames;
+
+    const uint32_t slot = slotOf(id);
+    Handle* handle = handleAt(slot);
+    std::mutex& mutex = lockFor(slot);
+    for (int reads = 0; reads < MAX_READS_PER_EVENT; ++reads) {
+        // At most one frame per read was assembled across reads: the one the read completes
+        std::vector<uint8_t> assembled;
+        bool drained;
+        frames.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (handle->generation != generationOf(id) || handle->state != ConnectionState::CONNECTED) {
+                return true;  // Closed meanwhile, by whoever closed it
+            }
+            ssize_t received;
+            do {
+                received = ::recv(handle->fd, buffer.data(), buffer.size(), 0);
+            } while (received < 0 && errno == EINTR);
+            if (received < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            if (received == 0) {
+                return false;  // Orderly shutdown by the peer
+            }
+            handle->lastActive = nowTick();
+
+            const uint8_t* data = buffer.data();
+            size_t size = static_cast<size_t>(received);
+            size_t position = 0;
+            while (position < size) {
+                if (!handle->prefixDone) {
+                    handle->prefix[handle->prefixLength++] = data[position++];
+                    uint64_t length = 0;
+                    int parsed = parsePrefix(handle->prefix, handle->prefixLength, config_.encoding, length);
+                    if (parsed < 0 || length > config_.maxFrameSize) {
+                        setError(parsed < 0 ? "Malformed frame prefix" : "Frame exceeds the maximum size");
+                        return false;
+                    }
+                    if (parsed > 0) {
+                        handle->prefixDone = true;
+                        handle->frameLength = static_cast<uint32_t>(length);
+                        if (length == 0) {
+                            frames.emplace_back();
+                            handle->nextFrame();
+                        }
+                    }
+                    continue;
+                }
+                size_t missing = handle->frameLength - handle->inbound.size();
+                size_t take = std::min(missing, size - position);
+                if (handle->inbound.empty() && take == missing) {
+                    // Arrived whole: deliver straight from the receive buffer
+                    frames.emplace_back(data + position, take);
+                    handle->nextFrame();
+                } else {
+                    handle->inbound.insert(handle->inbound.end(), data + position, data + position + take);
+                    if (handle->inbound.size() == handle->frameLength) {
+                        // Moved out, so the idle connection holds no buffer between frames
+                        assembled = std::move(handle->inbound);
+                        handle->inbound = std::vector<uint8_t>();
+                        frames.emplace_back(assembled.data(), assembled.size());
+                        handle->nextFrame();
+                    }
+                }
+                position += take;
+            }
+            drained = size < buffer.size();
+        }
+
+        // Delivered unlocked so the callback may send on, or close, this connection
+        if (messageCallback_) {
+            for (const auto& frame : frames) {
+                messageCallback_(id, frame);
+            }
+        }
+        if (drained) {
+            break;  // A short read emptied the socket; the reactor reports the next data
+        }
+    }
+    return true;
+#endif
+}
+
+bool PeerConnectionEngine::flushLocked(Handle& handle) {
+#ifdef _WIN32
+    return false;
+#else
+    if (handle.outbound.empty() || handle.state != ConnectionState::CONNECTED) {
+        return true;
+    }
+    size_t remaining = handle.outbound.size() - handle.outboundOffset;
+    ssize_t written = writeSome(handle.fd, handle.outbound.data() + handle.outboundOffset, remaining, nullptr, 0);
+    if (written < 0) {
+        return false;
+    }
+    handle.lastActive = nowTick();
+    handle.outboundOffset += static_cast<uint32_t>(written);
+    if (handle.outboundOffset == handle.outbound.size()) {
+        std::vector<uint8_t>().swap(handle.outbound);
+        handle.outboundOffset = 0;
+    }
+    return true;
+#endif
+}
+
+bool PeerConnectionEngine::send(ConnectionId id, utils::ByteSpan payload) {
+#ifdef _WIN32
+    setError("Peer connections are not supported on Windows");
+    return false;
+#else
+    if (payload.size() > UINT32_MAX) {
+        setError("Frame too large");
+        return false;
+    }
+    uint8_t prefix[utils::MAX_FRAME_PREFIX];
+    size_t prefixSize = utils::encodeFramePrefix(static_cast<uint32_t>(payload.size()), config_.encoding, prefix);
+    size_t total = prefixSize + payload.size();
+
+    const uint32_t slot = slotOf(id);
+    Handle* handle = handleAt(slot);
+    if (!handle) {
+        setError("Unknown connection");
+        return false;
+    }
+    bool failed = false;
+    {
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        if (handle->generation != generationOf(id) || handle->fd < 0) {
+            setError("Connection is closed");
+            return false;
+        }
+        size_t pending = handle->outbound.size() - handle->outboundOffset;
+        // Checked before writing, so a refused frame never leaves part of itself on the wire
+        if (pending > 0 && pending + total > config_.maxPendingBytes) {
+            setError("Send buffer is full");
+            return false;
+        }
+
+        size_t written = 0;
+        if (handle->state == ConnectionState::CONNECTED && pending == 0) {
+            ssize_t result = writeSome(handle->fd, prefix, prefixSize, payload.data(), payload.size());
+            if (result < 0) {
+                failed = true;
+            } else {
+                written = static_cast<size_t>(result);
+                handle->lastActive = nowTick();
+            }
+        }
+        if (!failed && written < total) {
+            if (written < prefixSize) {
+                handle->outbound.insert(handle->outbound.end(), prefix + written, prefix + prefixSize);
+                written = prefixSize;
+            }
+            handle->outbound.insert(handle->outbound.end(), payload.data() + (written - prefixSize),
+                                    payload.data() + payload.size());
+            if (!handle->writeInterest) {
+                handle->writeInterest = true;
+                reactor_.modify(handle->fd, EventReactor::READABLE | EventReactor::WRITABLE);
+            }
+        }
+    }
+    if (failed) {
+        setError(std::string("Send failed: ") + std::strerror(errno));
+        closeConnection(id, true);
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool PeerConnectionEngine::close(ConnectionId id) {
+    return closeConnection(id, true);
+}
+
+bool PeerConnectionEngine::closeConnection(ConnectionId id, bool notify) {
+    const uint32_t slot = slotOf(id);
+    Handle* handle = handleAt(slot);
+    if (!handle) {
+        return false;
+    }
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        if (handle->generation != generationOf(id) || handle->fd < 0) {
+            return false;
+        }
+        fd = handle->fd;
+        handle->fd = -1;
+        handle->state = ConnectionState::DISCONNECTED;
+    }
+    // Unlocked: remove() waits for a running callback, which may be waiting for the lock
+    reactor_.remove(fd);
+    closeFd(fd);
+    releaseSlot(slot);
+    connectionCount_.fetch_sub(1, std::memory_order_relaxed);
+    if (notify && stateCallback_) {
+        stateCallback_(id, ConnectionState::DISCONNECTED);
+    }
+    return true;
+}
+
+ConnectionState PeerConnectionEngine::state(ConnectionId id) const {
+    const uint32_t slot = slotOf(id);
+    Handle* handle = handleAt(slot);
+    if (!handle) {
+        return ConnectionState::DISCONNECTED;
+    }
+    std::lock_guard<std::mutex> lock(lockFor(slot));
+    return handle->generation == generationOf(id) ? handle->state : ConnectionState::DISCONNECTED;
+}
+
+size_t PeerConnectionEngine::pendingBytes(ConnectionId id) const {
+    const uint32_t slot = slotOf(id);
+    Handle* handle = handleAt(slot);
+    if (!handle) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(lockFor(slot));
+    return handle->generation == generationOf(id) ? handle->outbound.size() - handle->outboundOffset : 0;
+}
+
+void PeerConnectionEngine::sweepIdle() {
+    const uint32_t now = nowTick();
+    const auto timeout = static_cast<uint32_t>(config_.idleTimeout.count());
+    std::vector<ConnectionId> idle;
+    uint32_t slots = slotsInUse_.load(std::memory_order_acquire);
+    for (uint32_t slot = 0; slot < slots; ++slot) {
+        Handle* handle = handleAt(slot);
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        // Unsigned difference, so the tick wrapping after 49 days does not matter
+        if (handle->fd >= 0 && handle->state == ConnectionState::CONNECTED &&
+            now - handle->lastActive >= timeout) {
+            idle.push_back(makeId(slot, handle->generation));
+        }
+    }
+    for (ConnectionId id : idle) {
+        closeConnection(id, true);
+    }
+}
+
+PeerConnectionEngine::MemoryStats PeerConnectionEngine::memoryStats() const {
+    MemoryStats stats;
+    stats.connections = connectionCount();
+    uint32_t slots = slotsInUse_.load(std::memory_order_acquire);
+    stats.handleBytes = ((slots + CHUNK_HANDLES - 1) / CHUNK_HANDLES) * sizeof(Chunk);
+    for (uint32_t slot = 0; slot < slots; ++slot) {
+        Handle* handle = handleAt(slot);
+        std::lock_guard<std::mutex> lock(lockFor(slot));
+        stats.bufferBytes += handle->inbound.capacity() + handle->outbound.capacity();
+    }
+    stats.engineBytes = sizeof(*this) + chunkCount_ * sizeof(std::atomic<Chunk*>) +
+                        reactor_.threadCount() * RECEIVE_BUFFER;
+    return stats;
+}
+
+} // namespace core
+} // namespace xenocomm
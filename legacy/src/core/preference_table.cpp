@@ -0,0 +1,169 @@
+#include "xenocomm/core/preference_table.h"
+#include <bitset>
+#include <functional>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr size_t SLOTS = 16;
+
+size_t securityIndex(EncryptionAlgorithm encryption, KeyExchangeMethod keyExchange, KeySize keySize) {
+    return (RankTable<EncryptionAlgorithm>::slot(encryption) * SLOTS +
+            RankTable<KeyExchangeMethod>::slot(keyExchange)) * SLOTS +
+           RankTable<KeySize>::slot(keySize);
+}
+
+std::bitset<SLOTS * SLOTS * SLOTS> buildSecurityTable() {
+    std::bitset<SLOTS * SLOTS * SLOTS> table;
+    const ParameterPreference rules;
+    NegotiableParams params;
+    for (int e = 0; e <= static_cast<int>(EncryptionAlgorithm::XCHACHA20_POLY1305); ++e) {
+        for (int k = 0; k <= static_cast<int>(KeyExchangeMethod::ECDH_X25519); ++k) {
+            for (int s = 0; s <= static_cast<int>(KeySize::BITS_512); ++s) {
+                params.encryptionAlgorithm = static_cast<EncryptionAlgorithm>(e);
+                params.keyExchangeMethod = static_cast<KeyExchangeMethod>(k);
+                params.keySize = static_cast<KeySize>(s);
+                table[securityIndex(params.encryptionAlgorithm, params.keyExchangeMethod, params.keySize)] =
+                    rules.validateSecurityParameters(params);
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+bool isSecurityCombinationValid(EncryptionAlgorithm encryption,
+                                KeyExchangeMethod keyExchange,
+                                KeySize keySize) {
+    static const auto table = buildSecurityTable();
+    return table[securityIndex(encryption, keyExchange, keySize)];
+}
+
+CompiledPreference::CompiledPreference(const ParameterPreference& preferences)
+    : tables_(RankTable<DataFormat>(preferences.dataFormats),
+              RankTable<CompressionAlgorithm>(preferences.compressionAlgorithms),
+              RankTable<ErrorCorrectionScheme>(preferences.errorCorrectionSchemes),
+              RankTable<EncryptionAlgorithm>(preferences.encryptionAlgorithms),
+              RankTable<KeyExchangeMethod>(preferences.keyExchangeMethods),
+              RankTable<AuthenticationMethod>(preferences.authenticationMethods),
+              RankTable<KeySize>(preferences.keySizes)) {}
+
+bool CompiledPreference::isCompatibleWithRequirements(const NegotiableParams& proposal) const {
+    // Non-short-circuiting & keeps this a straight line of loads
+    return table<DataFormat>().allows(proposal.dataFormat) &
+           table<CompressionAlgorithm>().allows(proposal.compressionAlgorithm) &
+           table<ErrorCorrectionScheme>().allows(proposal.errorCorrection) &
+           table<EncryptionAlgorithm>().allows(proposal.encryptionAlgorithm) &
+           table<KeyExchangeMethod>().allows(proposal.keyExchangeMethod) &
+           table<AuthenticationMethod>().allows(proposal.authenticationMethod) &
+           table<KeySize>().allows(proposal.keySize) &
+           isSecurityCombinationValid(proposal.encryptionAlgorithm, proposal.keyExchangeMethod, proposal.keySize);
+}
+
+uint32_t CompiledPreference::calculateCompatibilityScore(const NegotiableParams& proposal) const {
+    return uint32_t{table<DataFormat>().rank(proposal.dataFormat)} +
+           table<CompressionAlgorithm>().rank(proposal.compressionAlgorithm) +
+           table<ErrorCorrectionScheme>().rank(proposal.errorCorrection) +
+           table<EncryptionAlgorithm>().rank(proposal.encryptionAlgorithm) +
+           table<KeyExchangeMethod>().rank(proposal.keyExchangeMethod) +
+           table<AuthenticationMethod>().rank(proposal.authenticationMethod) +
+           table<KeySize>().rank(proposal.keySize);
+}
+
+AlternativeProposals::AlternativeProposals(const CompiledPreference& preferences,
+                                           const NegotiableParams& base,
+                                           const std::vector<DataFormat>& remoteFormats,
+                                           const std::vector<CompressionAlgorithm>& remoteCompression,
+                                           const std::vector<ErrorCorrectionScheme>& remoteErrorCorrection,
+                                           const std::vector<EncryptionAlgorithm>& remoteEncryption,
+                                           const std::vector<KeyExchangeMethod>& remoteKeyExchange,
+                                           const std::vector<AuthenticationMethod>& remoteAuth,
+                                           const std::vector<KeySize>& remoteKeySizes,
+                                           std::optional<NegotiableParams> rejected)
+    : base_(base),
+      rejected_(std::move(rejected)) {
+    select(0, preferences.table<DataFormat>(), remoteFormats, base.dataFormat);
+    select(1, preferences.table<CompressionAlgorithm>(), remoteCompression, base.compressionAlgorithm);
+    select(2, preferences.table<ErrorCorrectionScheme>(), remoteErrorCorrection, base.errorCorrection);
+    select(3, preferences.table<EncryptionAlgorithm>(), remoteEncryption, base.encryptionAlgorithm);
+    select(4, preferences.table<KeyExchangeMethod>(), remoteKeyExchange, base.keyExchangeMethod);
+    select(5, preferences.table<AuthenticationMethod>(), remoteAuth, base.authenticationMethod);
+    select(6, preferences.table<KeySize>(), remoteKeySizes, base.keySize);
+
+    Node first{0, {}, 0};
+    for (size_t d = 0; d < DIMENSIONS; ++d) {
+        if (ranks_[d].empty()) {
+            return;  // Nothing both peers support in this dimension
+        }
+        first.cost += ranks_[d][0];
+    }
+    queue_.push(first);
+}
+
+template <typename T>
+void AlternativeProposals::select(size_t dimension, const RankTable<T>& table,
+                                  const std::vector<T>& remote, T baseValue) {
+    auto& out = std::get<Candidates<T>>(candidates_);
+    if (!table.constrained()) {
+        out.push_back({baseValue, 0});
+    } else {
+        auto mask = RankTable<T>::maskOf(remote);
+        for (const auto& candidate : table.candidates()) {
+            if (mask & RankTable<T>::bit(candidate.value)) {
+                out.push_back(candidate);
+            }
+        }
+    }
+    for (const auto& candidate : out) {
+        ranks_[dimension].push_back(candidate.rank);
+    }
+}
+
+std::optional<NegotiableParams> AlternativeProposals::next() {
+    while (!queue_.empty()) {
+        Node node = queue_.top();
+        queue_.pop();
+
+        // Candidate ranks never decrease along a dimension, so a successor
+        // never costs less than its parent; advancing only from lastDimension
+        // on reaches every combination exactly once
+        for (size_t d = node.lastDimension; d < DIMENSIONS; ++d) {
+            size_t index = node.index[d];
+            if (index + 1 < ranks_[d].size()) {
+                Node successor = node;
+                successor.index[d] = static_cast<uint8_t>(index + 1);
+                successor.cost += ranks_[d][index + 1] - ranks_[d][index];
+                successor.lastDimension = static_cast<uint8_t>(d);
+                queue_.push(successor);
+            }
+        }
+
+        NegotiableParams params = build(node);
+        if (!isSecurityCombinationValid(params.encryptionAlgorithm, params.keyExchangeMethod, params.keySize)) {
+            continue;
+        }
+        if (rejected_ && params == *rejected_) {
+            continue;
+        }
+        return params;
+    }
+    return std::nullopt;
+}
+
+NegotiableParams AlternativeProposals::build(const Node& node) const {
+    NegotiableParams params = base_;
+    params.dataFormat = std::get<Candidates<DataFormat>>(candidates_)[node.index[0]].value;
+    params.compressionAlgorithm = std::get<Candidates<CompressionAlgorithm>>(candidates_)[node.index[1]].value;
+    params.errorCorrection = std::get<Candidates<ErrorCorrectionScheme>>(candidates_)[node.index[2]].value;
+    params.encryptionAlgorithm = std::get<Candidates<EncryptionAlgorithm>>(candidates_)[node.index[3]].value;
+    params.keyExchangeMethod = std::get<Candidates<KeyExchangeMethod>>(candidates_)[node.index[4]].value;
+    params.authenticationMethod = std::get<Candidates<AuthenticationMethod>>(candidates_)[node.index[5]].value;
+    params.keySize = std::get<Candidates<KeySize>>(candidates_)[node.index[6]].value;
+    return params;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,1384 @@
+#include "xenocomm/core/quic_transport.hpp"
+#include <openssl/rand.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr size_t MAX_DATAGRAM = 65536;
+constexpr size_t STREAM_FRAME_OVERHEAD = 1 + 4 + 8 + 2;  // type, stream, offset, length
+constexpr size_t MAX_RECEIVED_RANGES = 64;               // Older packet ranges are forgotten
+constexpr size_t PACKETS_PER_FLUSH = 256;                // Lets the I/O thread get back to receiving
+constexpr uint32_t PACKET_THRESHOLD = 3;
+constexpr uint32_t PACING_BURST_PACKETS = 10;
+constexpr auto MAX_POLL = std::chrono::milliseconds(50);
+constexpr auto GRANULARITY = std::chrono::milliseconds(1);
+
+void putU16(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value >> 8);
+    out[1] = static_cast<uint8_t>(value);
+}
+
+void putU32(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+void putU64(uint8_t* out, uint64_t value) {
+    putU32(out, static_cast<uint32_t>(value >> 32));
+    putU32(out + 4, static_cast<uint32_t>(value));
+}
+
+uint16_t getU16(const uint8_t* in) {
+    return static_cast<uint16_t>((uint16_t(in[0]) << 8) | uint16_t(in[1]));
+}
+
+uint32_t getU32(const uint8_t* in) {
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+}
+
+uint64_t getU64(const uint8_t* in) {
+    return (uint64_t(getU32(in)) << 32) | getU32(in + 4);
+}
+
+template <typename Ranges>
+void addRange(Ranges& ranges, uint64_t start, uint64_t end) {
+    if (start >= end) {
+        return;
+    }
+    auto it = ranges.upper_bound(start);
+    if (it != ranges.begin()) {
+        auto previous = std::prev(it);
+        if (previous->second >= start) {
+            start = previous->first;
+            end = std::max(end, previous->second);
+            it = ranges.erase(previous);
+        }
+    }
+    while (it != ranges.end() && it->first <= end) {
+        end = std::max(end, it->second);
+        it = ranges.erase(it);
+    }
+    ranges.emplace(start, end);
+}
+
+template <typename Ranges>
+void removeRange(Ranges& ranges, uint64_t start, uint64_t end) {
+    if (start >= end) {
+        return;
+    }
+    auto it = ranges.upper_bound(start);
+    if (it != ranges.begin()) {
+        --it;
+    }
+    while (it != ranges.end() && it->first < end) {
+        const uint64_t first = it->first;
+        const uint64_t second = it->second;
+        if (second <= start) {
+            ++it;
+            continue;
+        }
+        it = ranges.erase(it);
+        if (first < start) {
+            ranges.emplace(first, start);
+        }
+        if (second > end) {
+            ranges.emplace(end, second);
+            break;
+        }
+    }
+}
+
+template <typename Ranges>
+bool containsValue(const Ranges& ranges, uint64_t value) {
+    auto it = ranges.upper_bound(value);
+    return it != ranges.begin() && std::prev(it)->second > value;
+}
+
+bool transientReceiveError(TransportError code) {
+    switch (code) {
+        case TransportError::WOULD_BLOCK:
+        case TransportError::TIMEOUT:
+        case TransportError::CONNECTION_REFUSED:  // ICMP from a port the peer has left
+        case TransportError::CONNECTION_RESET:
+        case TransportError::HOST_UNREACHABLE:
+        case TransportError::NETWORK_UNREACHABLE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+QuicTransport::QuicTransport(std::shared_ptr<SecurityManager> securityManager, const QuicTransportConfig& config)
+    : securityManager_(std::move(securityManager)), config_(config) {
+    if (!securityManager_) {
+        throw std::invalid_argument("QuicTransport needs a security manager");
+    }
+    init();
+}
+
+QuicTransport::QuicTransport(std::shared_ptr<AeadRecordLayer> keys, const QuicTransportConfig& config)
+    : presharedKeys_(std::move(keys)), config_(config) {
+    if (!presharedKeys_) {
+        throw std::invalid_argument("QuicTransport needs a record layer");
+    }
+    init();
+}
+
+QuicTransport::~QuicTransport() {
+    disconnect();
+}
+
+void QuicTransport::init() {
+    // Room for the header, the tag and at least one stream frame with data
+    config_.maxPacketSize = std::clamp<size_t>(config_.maxPacketSize,
+                                               HEADER_SIZE + AeadRecordLayer::TAG_SIZE + STREAM_FRAME_OVERHEAD + 64,
+                                               MAX_DATAGRAM - 64);
+    config_.streamReceiveWindow = std::max<uint32_t>(config_.streamReceiveWindow, 2 * MESSAGE_PREFIX);
+    config_.maxStreams = std::max<size_t>(config_.maxStreams, 1);
+    config_.congestion.segment_size = static_cast<uint32_t>(config_.maxPacketSize);
+    // A window under two packets could never let one out
+    config_.congestion.min_window =
+        std::max<uint32_t>(config_.congestion.min_window, 2 * config_.congestion.segment_size);
+    config_.congestion.initial_window = std::max(config_.congestion.initial_window, config_.congestion.min_window);
+    localPort_ = config_.connectionConfig.localPort;
+}
+
+bool QuicTransport::openSocket(uint16_t localPort, std::shared_ptr<UDPTransport>& udp) {
+    udp = std::make_shared<UDPTransport>();
+    if (localPort != 0 && !udp->setLocalPort(localPort)) {
+        setError(udp->getLastErrorCode(), "Failed to set local port: " + udp->getErrorDetails());
+        return false;
+    }
+    ConnectionConfig connectionConfig = config_.connectionConfig;
+    connectionConfig.localPort = localPort;
+    if (!udp->connect(endpoint_, connectionConfig)) {
+        setError(udp->getLastErrorCode(), "Failed to open UDP socket: " + udp->getErrorDetails());
+        return false;
+    }
+    return true;
+}
+
+bool QuicTransport::connect(const std::string& endpoint, const ConnectionConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            setError(TransportError::ALREADY_CONNECTED, "Already connected");
+            return false;
+        }
+        if (presharedKeys_ && presharedUsed_) {
+            setError(TransportError::INVALID_STATE, "Pre-shared keys cannot be used for a second connection");
+            return false;
+        }
+        endpoint_ = endpoint;
+        config_.connectionConfig = config;
+        if (config.localPort != 0) {
+            localPort_ = config.localPort;
+        }
+    }
+    updateState(ConnectionState::CONNECTING);
+
+    std::shared_ptr<UDPTransport> udp;
+    if (!openSocket(localPort_, udp)) {
+        updateState(ConnectionState::ERROR);
+        return false;
+    }
+
+    std::shared_ptr<SecureTransportWrapper> handshake;
+    std::shared_ptr<AeadRecordLayer> keys = presharedKeys_;
+    if (!keys) {
+        try {
+            // The wrapper runs the handshake over the socket as it is constructed
+            handshake = std::make_shared<SecureTransportWrapper>(udp, securityManager_, config_.secure);
+        } catch (const std::exception& e) {
+            udp->disconnect();
+            setError(TransportError::CONNECTION_FAILED, e.what());
+            updateState(ConnectionState::ERROR);
+            return false;
+        }
+        auto exported = handshake->exportRecordLayer();
+        if (!exported.has_value()) {
+            handshake.reset();
+            udp->disconnect();
+            setError(TransportError::CONNECTION_FAILED, "No packet keys from the handshake: " + exported.error());
+            updateState(ConnectionState::ERROR);
+            return false;
+        }
+        keys = exported.value();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        presharedUsed_ = presharedKeys_ != nullptr;
+        udp_ = udp;
+        handshake_ = std::move(handshake);
+        keys_ = std::move(keys);
+        congestion_ = CongestionControllerFactory::create(config_.congestion);
+
+        const auto now = Clock::now();
+        nextPacketNumber_ = 0;
+        sent_.clear();
+        largestAcked_ = 0;
+        anyAcked_ = false;
+        bytesInFlight_ = 0;
+        elicitingInFlight_ = 0;
+        receivedPackets_.clear();
+        largestReceived_ = 0;
+        unackedElicitingPackets_ = 0;
+        ackDeadline_ = Clock::time_point::max();
+        smoothedRtt_ = std::chrono::microseconds(333000);
+        rttVariance_ = std::chrono::microseconds(166500);
+        rttSampled_ = false;
+        probeCount_ = 0;
+        probePending_ = false;
+        pacerNext_ = now;
+        pacerBlocked_ = false;
+        lastReceived_ = now;
+        lastSent_ = now;
+        sendStreams_.clear();
+        receiveStreams_.clear();
+        sendOrder_.clear();
+        completed_.clear();
+        responses_.clear();
+        challenging_ = false;
+        partial_.reset();
+        partialOffset_ = 0;
+        stats_ = Stats{};
+        udp_->getPeerAddress(peerAddress_, peerPort_);
+
+        running_ = true;
+        io_ = std::thread(&QuicTransport::ioLoop, this);
+    }
+    updateState(ConnectionState::CONNECTED);
+    return true;
+}
+
+bool QuicTransport::disconnect() {
+    std::thread io;
+    std::shared_ptr<UDPTransport> udp;
+    std::shared_ptr<SecureTransportWrapper> handshake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            // Best effort: a lost CONNECTION_CLOSE leaves the peer to its idle timeout
+            uint8_t close = CONNECTION_CLOSE;
+            sendPacket(&close, 1, SentPacket{}, Clock::now());
+        }
+        running_ = false;
+        cv_.notify_all();
+        io = std::move(io_);
+        udp = std::move(udp_);
+        handshake = std::move(handshake_);
+    }
+    if (!io.joinable() && !udp && !handshake) {
+        return true;
+    }
+    if (io.joinable()) {
+        io.join();
+    }
+    handshake.reset();  // Closes the DTLS session on the socket
+    if (udp) {
+        udp->disconnect();
+    }
+    updateState(ConnectionState::DISCONNECTED);
+    return true;
+}
+
+bool QuicTransport::isConnected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void QuicTransport::ioLoop() {
+    std::vector<uint8_t> datagram(MAX_DATAGRAM);
+    std::string address;
+    uint16_t port = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        auto now = Clock::now();
+        if (now - lastReceived_ >= std::chrono::milliseconds(config_.idleTimeoutMs)) {
+            fail(TransportError::TIMEOUT, "Nothing heard from the peer within the idle timeout");
+            break;
+        }
+        detectLosses(now);
+        if (elicitingInFlight_ > 0 && now >= lastElicitingSent_ + probeTimeout() * (1u << std::min(probeCount_, 16u))) {
+            onProbeTimeout(now);
+        }
+        if (keepAlive_ && now - lastSent_ >= std::chrono::milliseconds(config_.idleTimeoutMs / 3)) {
+            probePending_ = true;
+        }
+        flush(now);
+
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextTimer(now) - now);
+        wait = std::clamp<std::chrono::milliseconds>(wait, GRANULARITY, MAX_POLL);
+        auto udp = udp_;
+        lock.unlock();
+        udp->setReceiveTimeout(wait);
+        const ssize_t received = udp->receiveFrom(datagram.data(), datagram.size(), address, port);
+        const TransportError code = received < 0 ? udp->getLastErrorCode() : TransportError::NONE;
+        lock.lock();
+        if (!running_) {
+            break;
+        }
+        if (received > 0) {
+            handleDatagram(datagram.data(), static_cast<size_t>(received), address, port, Clock::now());
+        }
+        if (udp != udp_) {
+            // migrate() swapped sockets; the old one is ours to close now nobody reads it
+            lock.unlock();
+            udp->disconnect();
+            lock.lock();
+            continue;
+        }
+        if (received < 0 && !transientReceiveError(code)) {
+            fail(code, "Receive failed: " + udp->getErrorDetails());
+        }
+    }
+    const bool failed = state_.load() == ConnectionState::ERROR;
+    lock.unlock();
+    if (failed) {
+        if (errorCallback_) {
+            errorCallback_(getLastErrorCode(), getErrorDetails());
+        }
+        if (stateCallback_) {
+            stateCallback_(ConnectionState::ERROR);
+        }
+    }
+}
+
+void QuicTransport::fail(TransportError code, const std::string& reason) {
+    running_ = false;
+    setError(code, reason);
+    state_.store(ConnectionState::ERROR);
+    cv_.notify_all();
+}
+
+void QuicTransport::handleDatagram(uint8_t* data, size_t size, const std::string& address, uint16_t port,
+                                   Clock::time_point now) {
+    if (size < HEADER_SIZE + AeadRecordLayer::TAG_SIZE || data[0] != HEADER_FLAGS) {
+        ++stats_.packetsDropped;
+        return;
+    }
+    const uint64_t number = getU64(data + 1);
+    if (containsValue(receivedPackets_, number)) {
+        ++stats_.packetsDropped;
+        return;
+    }
+    uint8_t* payload = data + HEADER_SIZE;
+    const size_t length = size - HEADER_SIZE - AeadRecordLayer::TAG_SIZE;
+    if (!keys_->open(number, utils::ByteSpan(data, HEADER_SIZE), utils::MutableByteSpan(payload, length),
+                     payload + length)) {
+        // Forged, corrupted or from another connection; it says nothing about this one
+        ++stats_.packetsDropped;
+        return;
+    }
+    ++stats_.packetsReceived;
+    lastReceived_ = now;
+
+    const bool newest = receivedPackets_.empty() || number > largestReceived_;
+    bool ackEliciting = false;
+    if (!handleFrames(payload, length, address, port, now, ackEliciting)) {
+        if (running_) {
+            fail(TransportError::RECEIVE_ERROR, "Peer violated the protocol");
+        }
+        return;
+    }
+
+    addRange(receivedPackets_, number, number + 1);
+    while (receivedPackets_.size() > MAX_RECEIVED_RANGES) {
+        receivedPackets_.erase(receivedPackets_.begin());
+    }
+    if (newest) {
+        largestReceived_ = number;
+        largestReceivedTime_ = now;
+        // Only the newest packets can move the path; reordered stragglers from an old address cannot
+        if ((address != peerAddress_ || port != peerPort_) &&
+            !(challenging_ && address == challengeAddress_ && port == challengePort_)) {
+            challenging_ = true;
+            challengeAddress_ = address;
+            challengePort_ = port;
+            challengeSent_ = Clock::time_point{};
+            RAND_bytes(challenge_.data(), static_cast<int>(challenge_.size()));
+        }
+    }
+    if (ackEliciting) {
+        ++unackedElicitingPackets_;
+        ackDeadline_ = unackedElicitingPackets_ >= 2
+                           ? now
+                           : std::min(ackDeadline_, now + std::chrono::milliseconds(config_.maxAckDelayMs));
+    }
+    flush(now);
+}
+
+bool QuicTransport::handleFrames(const uint8_t* data, size_t size, const std::string& address, uint16_t port,
+                                 Clock::time_point now, bool& ackEliciting) {
+    size_t pos = 0;
+    while (pos < size) {
+        const uint8_t type = data[pos++];
+        switch (type) {
+            case PADDING:
+                break;
+            case PING:
+                ackEliciting = true;
+                break;
+            case ACK:
+                if (!handleAck(data, pos, size, now)) {
+                    return false;
+                }
+                break;
+            case STREAM: {
+                if (size - pos < STREAM_FRAME_OVERHEAD - 1) {
+                    return false;
+                }
+                const uint32_t id = getU32(data + pos);
+                const uint64_t offset = getU64(data + pos + 4);
+                const uint16_t length = getU16(data + pos + 12);
+                pos += STREAM_FRAME_OVERHEAD - 1;
+                if (size - pos < length) {
+                    return false;
+                }
+                ackEliciting = true;
+                if (ReceiveStream* stream = receiveStream(id)) {
+                    if (offset + length > stream->advertised) {
+                        return false;  // Beyond the credit we granted
+                    }
+                    handleStream(*stream, id, offset, data + pos, length);
+                }
+                pos += length;
+                break;
+            }
+            case MAX_STREAM_DATA: {
+                if (size - pos < 12) {
+                    return false;
+                }
+                const uint32_t id = getU32(data + pos);
+                const uint64_t limit = getU64(data + pos + 4);
+                pos += 12;
+                ackEliciting = true;
+                if (SendStream* stream = sendStream(id)) {
+                    if (limit > stream->peerLimit) {
+                        stream->peerLimit = limit;
+                        if (!stream->queued && stream->nextOffset < stream->base + stream->buffer.size()) {
+                            stream->queued = true;
+                            sendOrder_.push_back(id);
+                        }
+                    }
+                }
+                break;
+            }
+            case PATH_CHALLENGE: {
+                if (size - pos < 8) {
+                    return false;
+                }
+                std::array<uint8_t, 8> token;
+                std::memcpy(token.data(), data + pos, token.size());
+                pos += token.size();
+                ackEliciting = true;
+                responses_.emplace_back(token, std::make_pair(address, port));
+                break;
+            }
+            case PATH_RESPONSE: {
+                if (size - pos < 8) {
+                    return false;
+                }
+                ackEliciting = true;
+                if (challenging_ && address == challengeAddress_ && port == challengePort_ &&
+                    std::memcmp(data + pos, challenge_.data(), challenge_.size()) == 0) {
+                    challenging_ = false;
+                    if (udp_->setPeerAddress(address, port)) {
+                        peerAddress_ = address;
+                        peerPort_ = port;
+                        ++stats_.pathMigrations;
+                        // The new path's capacity is unknown
+                        congestion_->reset();
+                    }
+                }
+                pos += 8;
+                break;
+            }
+            case CONNECTION_CLOSE:
+                fail(TransportError::CONNECTION_CLOSED, "Peer closed the connection");
+                return true;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool QuicTransport::handleAck(const uint8_t* data, size_t& pos, size_t size, Clock::time_point now) {
+    if (size - pos < 13) {
+        return false;
+    }
+    const uint64_t largest = getU64(data + pos);
+    const auto ackDelay = std::min(std::chrono::microseconds(getU32(data + pos + 8)),
+                                   std::chrono::microseconds(config_.maxAckDelayMs * 1000));
+    const size_t count = data[pos + 12];
+    pos += 13;
+    if (count == 0 || size - pos < count * 16) {
+        return false;
+    }
+
+    uint32_t ackedBytes = 0;
+    bool largestNewlyAcked = false;
+    bool largestEliciting = false;
+    Clock::time_point largestSent{};
+    for (size_t i = 0; i < count; ++i, pos += 16) {
+        const uint64_t start = getU64(data + pos);
+        const uint64_t end = getU64(data + pos + 8);
+        if (start > end || end > largest || end >= nextPacketNumber_) {
+            return false;
+        }
+        for (auto it = sent_.lower_bound(start); it != sent_.end() && it->first <= end;) {
+            if (it->first == largest) {
+                largestNewlyAcked = true;
+                largestEliciting = it->second.ackEliciting;
+                largestSent = it->second.sent;
+            }
+            if (it->second.inFlight) {
+                ackedBytes += it->second.size;
+            }
+            onPacketAcked(it->first, it->second);
+            it = sent_.erase(it);
+        }
+    }
+    if (!anyAcked_ || largest > largestAcked_) {
+        largestAcked_ = largest;
+        anyAcked_ = true;
+    }
+    if (ackedBytes == 0 && !largestNewlyAcked) {
+        return true;
+    }
+
+    std::chrono::microseconds rttSample{0};
+    if (largestNewlyAcked && largestEliciting) {
+        latestRtt_ = std::max(std::chrono::duration_cast<std::chrono::microseconds>(now - largestSent),
+                              std::chrono::microseconds(1));
+        rttSample = latestRtt_;
+        if (!rttSampled_) {
+            rttSampled_ = true;
+            minRtt_ = latestRtt_;
+            smoothedRtt_ = latestRtt_;
+            rttVariance_ = latestRtt_ / 2;
+        } else {
+            minRtt_ = std::min(minRtt_, latestRtt_);
+            auto adjusted = latestRtt_;
+            if (latestRtt_ >= minRtt_ + ackDelay) {
+                adjusted -= ackDelay;
+            }
+            const auto deviation = smoothedRtt_ > adjusted ? smoothedRtt_ - adjusted : adjusted - smoothedRtt_;
+            rttVariance_ = (rttVariance_ * 3 + deviation) / 4;
+            smoothedRtt_ = (smoothedRtt_ * 7 + adjusted) / 8;
+        }
+    }
+    if (ackedBytes > 0) {
+        congestion_->onAck(ackedBytes, rttSample, bytesInFlight_, now);
+    }
+    probeCount_ = 0;
+    detectLosses(now);
+    cv_.notify_all();
+    return true;
+}
+
+void QuicTransport::handleStream(ReceiveStream& stream, uint32_t id, uint64_t offset, const uint8_t* data,
+                                 size_t length) {
+    const uint64_t end = offset + length;
+    if (end <= stream.contiguous) {
+        return;  // Already have it
+    }
+    if (offset > stream.contiguous) {
+        auto& segment = stream.pending[offset];
+        if (segment.size() < length) {
+            segment.assign(data, data + length);
+        }
+        return;
+    }
+    const size_t skip = static_cast<size_t>(stream.contiguous - offset);
+    stream.assembling.insert(stream.assembling.end(), data + skip, data + length);
+    stream.contiguous = end;
+    while (!stream.pending.empty() && stream.pending.begin()->first <= stream.contiguous) {
+        auto node = stream.pending.extract(stream.pending.begin());
+        const uint64_t segmentEnd = node.key() + node.mapped().size();
+        if (segmentEnd > stream.contiguous) {
+            const auto& bytes = node.mapped();
+            stream.assembling.insert(stream.assembling.end(),
+                                     bytes.begin() + static_cast<std::ptrdiff_t>(stream.contiguous - node.key()),
+                                     bytes.end());
+            stream.contiguous = segmentEnd;
+        }
+    }
+
+    // Cut whole messages out of the in-order bytes
+    bool delivered = false;
+    while (stream.assembling.size() - stream.parsed >= MESSAGE_PREFIX) {
+        const uint32_t length = getU32(stream.assembling.data() + stream.parsed);
+        const size_t total = MESSAGE_PREFIX + static_cast<size_t>(length);
+        if (stream.assembling.size() - stream.parsed < total) {
+            break;
+        }
+        utils::PooledBuffer message = utils::BufferPool::shared().acquire(std::max<size_t>(length, 1));
+        message.resize(length);
+        if (length) {
+            std::memcpy(message.data(), stream.assembling.data() + stream.parsed + MESSAGE_PREFIX, length);
+        }
+        // Bytes of a message still arriving were credited as they came, so it could never
+        // stall on a window smaller than itself; the rest waits for the application's read
+        const size_t already = std::min(total, stream.creditedAhead);
+        stream.creditedAhead -= already;
+        stream.messages.push_back(Message{std::move(message), static_cast<uint32_t>(total - already)});
+        completed_.push_back(id);
+        stream.parsed += total;
+        delivered = true;
+    }
+    if (stream.parsed > 0 && stream.parsed * 2 >= stream.assembling.size()) {
+        stream.assembling.erase(stream.assembling.begin(),
+                                stream.assembling.begin() + static_cast<std::ptrdiff_t>(stream.parsed));
+        stream.parsed = 0;
+    }
+    const size_t unparsed = stream.assembling.size() - stream.parsed;
+    if (unparsed > stream.creditedAhead) {
+        credit(stream, unparsed - stream.creditedAhead);
+        stream.creditedAhead = unparsed;
+    }
+    if (delivered) {
+        cv_.notify_all();
+    }
+}
+
+void QuicTransport::credit(ReceiveStream& stream, size_t bytes) {
+    stream.credited += bytes;
+    const uint64_t window = config_.streamReceiveWindow;
+    if (stream.credited + window - stream.advertised >= window / 2) {
+        stream.advertised = stream.credited + window;
+        stream.creditPending = true;
+    }
+}
+
+void QuicTransport::onPacketAcked(uint64_t, SentPacket& packet) {
+    if (packet.inFlight) {
+        bytesInFlight_ -= packet.size;
+        --elicitingInFlight_;
+    }
+    for (const auto& chunk : packet.chunks) {
+        auto it = sendStreams_.find(chunk.stream);
+        if (it == sendStreams_.end()) {
+            continue;
+        }
+        SendStream& stream = it->second;
+        const uint64_t end = chunk.offset + chunk.length;
+        addRange(stream.acked, chunk.offset, end);
+        removeRange(stream.lost, chunk.offset, end);  // A late ack for something already declared lost
+        while (!stream.acked.empty() && stream.acked.begin()->first <= stream.base) {
+            const uint64_t ackedEnd = stream.acked.begin()->second;
+            stream.acked.erase(stream.acked.begin());
+            if (ackedEnd > stream.base) {
+                const size_t drop = static_cast<size_t>(std::min<uint64_t>(ackedEnd - stream.base,
+                                                                           stream.buffer.size()));
+                stream.buffer.erase(stream.buffer.begin(),
+                                    stream.buffer.begin() + static_cast<std::ptrdiff_t>(drop));
+                stream.base += drop;
+            }
+        }
+    }
+}
+
+void QuicTransport::onPacketLost(SentPacket& packet) {
+    ++stats_.packetsLost;
+    if (packet.inFlight) {
+        bytesInFlight_ -= packet.size;
+        --elicitingInFlight_;
+        congestion_->onLoss(packet.size, Clock::now());
+    }
+    for (const auto& chunk : packet.chunks) {
+        auto it = sendStreams_.find(chunk.stream);
+        if (it == sendStreams_.end()) {
+            continue;
+        }
+        SendStream& stream = it->second;
+        const uint64_t start = std::max(chunk.offset, stream.base);
+        const uint64_t end = chunk.offset + chunk.length;
+        if (start >= end) {
+            continue;
+        }
+        addRange(stream.lost, start, end);
+        for (auto acked = stream.acked.lower_bound(0); acked != stream.acked.end() && acked->first < end; ++acked) {
+            removeRange(stream.lost, acked->first, acked->second);
+        }
+        if (!stream.queued && !stream.lost.empty()) {
+            stream.queued = true;
+            sendOrder_.push_back(chunk.stream);
+        }
+    }
+    for (uint32_t id : packet.credits) {
+        auto it = receiveStreams_.find(id);
+        if (it != receiveStreams_.end()) {
+            it->second.creditPending = true;  // Resent with whatever the limit is by then
+        }
+    }
+}
+
+void QuicTransport::detectLosses(Clock::time_point now) {
+    if (!anyAcked_) {
+        return;
+    }
+    const auto lossDelay = std::max<std::chrono::microseconds>(std::max(smoothedRtt_, latestRtt_) * 9 / 8,
+                                                               GRANULARITY);
+    bool lost = false;
+    for (auto it = sent_.begin(); it != sent_.end() && it->first < largestAcked_;) {
+        // Both thresholds only get harder to meet for later packets
+        if (largestAcked_ - it->first < PACKET_THRESHOLD && it->second.sent + lossDelay > now) {
+            break;
+        }
+        onPacketLost(it->second);
+        it = sent_.erase(it);
+        lost = true;
+    }
+    if (lost) {
+        cv_.notify_all();
+    }
+}
+
+void QuicTransport::onProbeTimeout(Clock::time_point now) {
+    ++stats_.probeTimeouts;
+    ++probeCount_;
+    probePending_ = true;
+    lastElicitingSent_ = now;
+    // Resend what the oldest unacknowledged packet carried, without treating it as a loss:
+    // a tail loss has no later packets to reveal it, and the silence may just be a slow ack
+    for (auto& [number, packet] : sent_) {
+        if (packet.chunks.empty()) {
+            continue;
+        }
+        for (const auto& chunk : packet.chunks) {
+            auto it = sendStreams_.find(chunk.stream);
+            if (it == sendStreams_.end()) {
+                continue;
+            }
+            SendStream& stream = it->second;
+            const uint64_t start = std::max(chunk.offset, stream.base);
+            addRange(stream.lost, start, std::max(start, chunk.offset + chunk.length));
+            if (!stream.queued && !stream.lost.empty()) {
+                stream.queued = true;
+                sendOrder_.push_back(chunk.stream);
+            }
+        }
+        break;
+    }
+}
+
+std::chrono::microseconds QuicTransport::probeTimeout() const {
+    return smoothedRtt_ + std::max<std::chrono::microseconds>(rttVariance_ * 4, GRANULARITY) +
+           std::chrono::milliseconds(config_.maxAckDelayMs);
+}
+
+QuicTransport::Clock::time_point QuicTransport::nextTimer(Clock::time_point now) const {
+    auto next = now + MAX_POLL;
+    if (unackedElicitingPackets_ > 0) {
+        next = std::min(next, ackDeadline_);
+    }
+    if (anyAcked_ && !sent_.empty() && sent_.begin()->first < largestAcked_) {
+        const auto lossDelay = std::max<std::chrono::microseconds>(std::max(smoothedRtt_, latestRtt_) * 9 / 8,
+                                                                   GRANULARITY);
+        next = std::min(next, sent_.begin()->second.sent + lossDelay);
+    }
+    if (elicitingInFlight_ > 0) {
+        next = std::min(next, lastElicitingSent_ + probeTimeout() * (1u << std::min(probeCount_, 16u)));
+    }
+    if (pacerBlocked_) {
+        next = std::min(next, pacerNext_);
+    }
+    if (challenging_) {
+        next = std::min(next, challengeSent_ + probeTimeout() * 3);
+    }
+    next = std::min(next, lastReceived_ + std::chrono::milliseconds(config_.idleTimeoutMs));
+    return next;
+}
+
+size_t QuicTransport::writeAck(uint8_t* out, size_t room, Clock::time_point now) {
+    if (receivedPackets_.empty() || room < 14 + 16) {
+        return 0;
+    }
+    const size_t count = std::min({receivedPackets_.size(), MAX_ACK_RANGES, (room - 14) / 16});
+    out[0] = ACK;
+    putU64(out + 1, largestReceived_);
+    const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(now - largestReceivedTime_).count();
+    putU32(out + 9, static_cast<uint32_t>(std::clamp<int64_t>(delay, 0, UINT32_MAX)));
+    out[13] = static_cast<uint8_t>(count);
+    size_t pos = 14;
+    auto it = receivedPackets_.rbegin();
+    for (size_t i = 0; i < count; ++i, ++it, pos += 16) {
+        putU64(out + pos, it->first);
+        putU64(out + pos + 8, it->second - 1);
+    }
+    return pos;
+}
+
+size_t QuicTransport::writeStreamData(uint8_t* out, size_t room, SentPacket& record) {
+    size_t pos = 0;
+    // Each stream gets at most one frame per packet, so every stream with data moves forward
+    for (size_t visited = 0, queued = sendOrder_.size();
+         visited < queued && !sendOrder_.empty() && room - pos > STREAM_FRAME_OVERHEAD; ++visited) {
+        const uint32_t id = sendOrder_.front();
+        sendOrder_.pop_front();
+        auto found = sendStreams_.find(id);
+        if (found == sendStreams_.end()) {
+            continue;
+        }
+        SendStream& stream = found->second;
+        const size_t space = std::min<size_t>(room - pos - STREAM_FRAME_OVERHEAD, UINT16_MAX);
+        uint64_t offset = 0;
+        size_t length = 0;
+        bool retransmit = false;
+        while (!stream.lost.empty()) {
+            auto lost = stream.lost.begin();
+            offset = std::max(lost->first, stream.base);
+            if (offset >= lost->second) {
+                stream.lost.erase(lost);
+                continue;
+            }
+            length = static_cast<size_t>(std::min<uint64_t>(lost->second - offset, space));
+            removeRange(stream.lost, offset, offset + length);
+            retransmit = true;
+            break;
+        }
+        if (!retransmit) {
+            offset = stream.nextOffset;
+            const uint64_t available = stream.base + stream.buffer.size() - offset;
+            const uint64_t allowed = stream.peerLimit > offset ? stream.peerLimit - offset : 0;
+            length = static_cast<size_t>(std::min<uint64_t>({available, allowed, space}));
+            stream.nextOffset += length;
+        }
+        if (length > 0) {
+            out[pos] = STREAM;
+            putU32(out + pos + 1, id);
+            putU64(out + pos + 5, offset);
+            putU16(out + pos + 13, static_cast<uint16_t>(length));
+            auto from = stream.buffer.begin() + static_cast<std::ptrdiff_t>(offset - stream.base);
+            std::copy(from, from + static_cast<std::ptrdiff_t>(length), out + pos + STREAM_FRAME_OVERHEAD);
+            pos += STREAM_FRAME_OVERHEAD + length;
+            record.chunks.push_back(StreamChunk{id, offset, static_cast<uint32_t>(length)});
+            if (retransmit) {
+                stats_.bytesRetransmitted += length;
+            }
+        }
+        // Streams waiting only for credit leave the rotation until MAX_STREAM_DATA arrives
+        const bool more = !stream.lost.empty() ||
+                          (stream.nextOffset < stream.base + stream.buffer.size() &&
+                           stream.nextOffset < stream.peerLimit);
+        stream.queued = more;
+        if (more) {
+            sendOrder_.push_back(id);
+        }
+    }
+    return pos;
+}
+
+void QuicTransport::flush(Clock::time_point now) {
+    if (!running_ || !udp_) {
+        return;
+    }
+    std::vector<uint8_t> frames(config_.maxPacketSize);
+    const size_t room = config_.maxPacketSize - HEADER_SIZE - AeadRecordLayer::TAG_SIZE;
+
+    // Path responses go back to whoever asked; a challenge goes to the address being validated
+    for (auto it = responses_.begin(); it != responses_.end();) {
+        const auto& [token, to] = *it;
+        if (to.first == peerAddress_ && to.second == peerPort_) {
+            ++it;
+            continue;
+        }
+        frames[0] = PATH_RESPONSE;
+        std::memcpy(frames.data() + 1, token.data(), token.size());
+        sendPacket(frames.data(), 1 + token.size(), SentPacket{}, now, &to.first, to.second);
+        it = responses_.erase(it);
+    }
+    if (challenging_ && (challengeSent_ == Clock::time_point{} || now >= challengeSent_ + probeTimeout() * 3)) {
+        frames[0] = PATH_CHALLENGE;
+        std::memcpy(frames.data() + 1, challenge_.data(), challenge_.size());
+        sendPacket(frames.data(), 1 + challenge_.size(), SentPacket{}, now, &challengeAddress_, challengePort_);
+        challengeSent_ = now;
+    }
+
+    pacerBlocked_ = false;
+    for (size_t packets = 0; packets < PACKETS_PER_FLUSH; ++packets) {
+        const uint32_t window = congestion_->congestionWindow();
+        const bool windowOpen = probePending_ || bytesInFlight_ + config_.maxPacketSize <= window;
+        const bool paced = !probePending_ && rttSampled_ && pacerNext_ > now;
+        const bool creditDue = std::any_of(receiveStreams_.begin(), receiveStreams_.end(),
+                                           [](const auto& entry) { return entry.second.creditPending; });
+        const bool dataReady = windowOpen && !paced && !sendOrder_.empty();
+        const bool elicitingDue = creditDue || !responses_.empty() || probePending_ || dataReady;
+        const bool ackDue = unackedElicitingPackets_ > 0 && now >= ackDeadline_;
+        if (!elicitingDue && !ackDue) {
+            pacerBlocked_ = windowOpen && paced && !sendOrder_.empty();
+            break;
+        }
+
+        SentPacket record;
+        size_t pos = 0;
+        bool ackWritten = false;
+        if (unackedElicitingPackets_ > 0) {
+            pos += writeAck(frames.data(), std::min<size_t>(room, 14 + 16 * 4), now);
+            ackWritten = pos > 0;
+        }
+        for (auto it = responses_.begin(); it != responses_.end() && room - pos >= 9;) {
+            frames[pos] = PATH_RESPONSE;
+            std::memcpy(frames.data() + pos + 1, it->first.data(), it->first.size());
+            pos += 9;
+            record.ackEliciting = true;
+            it = responses_.erase(it);
+        }
+        for (auto& [id, stream] : receiveStreams_) {
+            if (!stream.creditPending || room - pos < 13) {
+                continue;
+            }
+            frames[pos] = MAX_STREAM_DATA;
+            putU32(frames.data() + pos + 1, id);
+            putU64(frames.data() + pos + 5, stream.advertised);
+            pos += 13;
+            stream.creditPending = false;
+            record.credits.push_back(id);
+            record.ackEliciting = true;
+        }
+        if (dataReady || probePending_) {
+            const size_t written = writeStreamData(frames.data() + pos, room - pos, record);
+            pos += written;
+            record.ackEliciting = record.ackEliciting || written > 0;
+        }
+        if (probePending_ && !record.ackEliciting) {
+            frames[pos++] = PING;
+            record.ackEliciting = true;
+        }
+        if (pos == 0) {
+            break;
+        }
+        if (ackWritten) {
+            unackedElicitingPackets_ = 0;
+            ackDeadline_ = Clock::time_point::max();
+        }
+        probePending_ = false;
+
+        const bool paceThis = record.ackEliciting;
+        const size_t packetSize = HEADER_SIZE + pos + AeadRecordLayer::TAG_SIZE;
+        sendPacket(frames.data(), pos, std::move(record), now);
+        if (paceThis && rttSampled_) {
+            // Tokens refill at pacingGain * cwnd / srtt, with a few packets of burst allowance
+            const double rate = config_.pacingGain * std::max<uint32_t>(window, config_.maxPacketSize) /
+                                static_cast<double>(std::max<int64_t>(smoothedRtt_.count(), 1));
+            const auto interval = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::micro>(static_cast<double>(packetSize) / rate));
+            pacerNext_ = std::max(pacerNext_, now - interval * PACING_BURST_PACKETS) + interval;
+        }
+    }
+}
+
+bool QuicTransport::sendPacket(const uint8_t* frames, size_t length, SentPacket&& record, Clock::time_point now,
+                               const std::string* address, uint16_t port) {
+    if (!udp_ || !keys_) {
+        return false;
+    }
+    uint8_t datagram[MAX_DATAGRAM];
+    const uint64_t number = nextPacketNumber_++;
+    datagram[0] = HEADER_FLAGS;
+    putU64(datagram + 1, number);
+    uint8_t* payload = datagram + HEADER_SIZE;
+    std::memcpy(payload, frames, length);
+    if (!keys_->seal(number, utils::ByteSpan(datagram, HEADER_SIZE), utils::MutableByteSpan(payload, length),
+                     payload + length)) {
+        return false;
+    }
+    const size_t size = HEADER_SIZE + length + AeadRecordLayer::TAG_SIZE;
+    const ssize_t sent = address ? udp_->sendTo(datagram, size, *address, port) : udp_->send(datagram, size);
+    ++stats_.packetsSent;
+    lastSent_ = now;
+    if (record.ackEliciting && !address) {
+        // Tracked even if the socket refused it: the loss detector resends it like any other
+        record.sent = now;
+        record.size = static_cast<uint32_t>(size);
+        record.inFlight = true;
+        bytesInFlight_ += record.size;
+        ++elicitingInFlight_;
+        lastElicitingSent_ = now;
+        sent_.emplace(number, std::move(record));
+    }
+    return sent == static_cast<ssize_t>(size);
+}
+
+QuicTransport::SendStream* QuicTransport::sendStream(uint32_t id) {
+    auto it = sendStreams_.find(id);
+    if (it != sendStreams_.end()) {
+        return &it->second;
+    }
+    if (sendStreams_.size() >= config_.maxStreams) {
+        return nullptr;
+    }
+    SendStream& stream = sendStreams_[id];
+    // Peers are configured alike, so the first window is known without asking
+    stream.peerLimit = config_.streamReceiveWindow;
+    return &stream;
+}
+
+QuicTransport::ReceiveStream* QuicTransport::receiveStream(uint32_t id) {
+    auto it = receiveStreams_.find(id);
+    if (it != receiveStreams_.end()) {
+        return &it->second;
+    }
+    if (receiveStreams_.size() >= config_.maxStreams) {
+        return nullptr;
+    }
+    ReceiveStream& stream = receiveStreams_[id];
+    stream.advertised = config_.streamReceiveWindow;
+    return &stream;
+}
+
+ssize_t QuicTransport::sendOnStream(uint32_t streamId, const utils::ByteSpan* parts, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += parts[i].size();
+    }
+    if (total > UINT32_MAX) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Message larger than 4 GiB");
+        return -1;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        setError(TransportError::NOT_CONNECTED, "Not connected");
+        return -1;
+    }
+    SendStream* stream = sendStream(streamId);
+    if (!stream) {
+        setError(TransportError::RESOURCE_ERROR, "Too many streams");
+        return -1;
+    }
+    // An empty stream always takes the message, so one larger than the buffer still goes out
+    auto hasRoom = [&] {
+        return !running_ || stream->buffer.empty() ||
+               stream->buffer.size() + MESSAGE_PREFIX + total <= config_.streamSendBuffer;
+    };
+    if (!hasRoom()) {
+        if (nonBlocking_.load()) {
+            setError(TransportError::WOULD_BLOCK, "Send buffer full");
+            return -1;
+        }
+        const int64_t timeoutMs = sendTimeoutMs_.load();
+        if (timeoutMs > 0) {
+            if (!cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), hasRoom)) {
+                setError(TransportError::TIMEOUT, "Send buffer still full at the send timeout");
+                return -1;
+            }
+        } else {
+            cv_.wait(lock, hasRoom);
+        }
+    }
+    if (!running_) {
+        setError(TransportError::CONNECTION_CLOSED, "Connection closed");
+        return -1;
+    }
+
+    uint8_t prefix[MESSAGE_PREFIX];
+    putU32(prefix, static_cast<uint32_t>(total));
+    stream->buffer.insert(stream->buffer.end(), prefix, prefix + MESSAGE_PREFIX);
+    for (size_t i = 0; i < count; ++i) {
+        stream->buffer.insert(stream->buffer.end(), parts[i].data(), parts[i].data() + parts[i].size());
+    }
+    if (!stream->queued && stream->nextOffset < stream->peerLimit) {
+        stream->queued = true;
+        sendOrder_.push_back(streamId);
+    }
+    flush(Clock::now());
+    return static_cast<ssize_t>(total);
+}
+
+ssize_t QuicTransport::waitForMessage(std::unique_lock<std::mutex>& lock, uint32_t* streamId, bool any,
+                                      utils::PooledBuffer& message) {
+    ReceiveStream* stream = nullptr;
+    if (!any) {
+        stream = receiveStream(*streamId);
+        if (!stream) {
+            setError(TransportError::RESOURCE_ERROR, "Too many streams");
+            return -1;
+        }
+    }
+    auto available = [&] { return !running_ || (any ? !completed_.empty() : !stream->messages.empty()); };
+    if (!available() && !nonBlocking_.load()) {
+        const int64_t timeoutMs = receiveTimeoutMs_.load();
+        if (timeoutMs > 0) {
+            cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), available);
+        } else {
+            cv_.wait(lock, available);
+        }
+    }
+    uint32_t id = any ? 0 : *streamId;
+    if (any && !completed_.empty()) {
+        id = completed_.front();
+        stream = &receiveStreams_[id];
+    }
+    if (!stream || stream->messages.empty()) {
+        if (!running_) {
+            if (getLastErrorCode() != TransportError::CONNECTION_CLOSED && state_.load() != ConnectionState::ERROR) {
+                setError(TransportError::NOT_CONNECTED, "Not connected");
+            }
+        } else if (nonBlocking_.load()) {
+            setError(TransportError::WOULD_BLOCK, "No message available");
+        } else {
+            setError(TransportError::TIMEOUT, "No message within the receive timeout");
+        }
+        return -1;
+    }
+
+    auto found = std::find(completed_.begin(), completed_.end(), id);
+    if (found != completed_.end()) {
+        completed_.erase(found);
+    }
+    Message next = std::move(stream->messages.front());
+    stream->messages.pop_front();
+    credit(*stream, next.windowBytes);
+    if (stream->creditPending) {
+        flush(Clock::now());
+    }
+    if (streamId) {
+        *streamId = id;
+    }
+    message = std::move(next.data);
+    return static_cast<ssize_t>(message.size());
+}
+
+ssize_t QuicTransport::receiveFromStream(uint32_t streamId, utils::PooledBuffer& message) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return waitForMessage(lock, &streamId, false, message);
+}
+
+ssize_t QuicTransport::receiveAny(uint32_t& streamId, utils::PooledBuffer& message) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return waitForMessage(lock, &streamId, true, message);
+}
+
+ssize_t QuicTransport::send(const uint8_t* data, size_t size) {
+    if (!data && size > 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+    const utils::ByteSpan part(data, size);
+    return sendOnStream(0, &part, 1);
+}
+
+ssize_t QuicTransport::sendv(const utils::ByteSpan* buffers, size_t count) {
+    return sendOnStream(0, buffers, count);
+}
+
+ssize_t QuicTransport::sendFrame(const utils::ByteSpan* parts, size_t count) {
+    return sendOnStream(0, parts, count);
+}
+
+ssize_t QuicTransport::receiveFrame(utils::PooledBuffer& frame) {
+    return receiveFromStream(0, frame);
+}
+
+ssize_t QuicTransport::receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) {
+    utils::PooledBuffer message;
+    const ssize_t received = receiveFromStream(0, message);
+    if (received < 0) {
+        return -1;
+    }
+    if (message.size() > maxSize) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Message larger than the receive buffer");
+        return -1;
+    }
+    buffer = std::move(message);
+    return received;
+}
+
+ssize_t QuicTransport::receive(uint8_t* buffer, size_t size) {
+    if (!buffer || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid receive parameters");
+        return -1;
+    }
+    // Only one reader at a time may use receive(); the rest of a message waits for the next call
+    if (partialOffset_ >= partial_.size()) {
+        partial_.reset();
+        partialOffset_ = 0;
+        if (receiveFrame(partial_) < 0) {
+            return getLastErrorCode() == TransportError::TIMEOUT ? 0 : -1;
+        }
+    }
+    const size_t n = std::min(size, partial_.size() - partialOffset_);
+    if (n) {
+        std::memcpy(buffer, partial_.data() + partialOffset_, n);
+    }
+    partialOffset_ += n;
+    return static_cast<ssize_t>(n);
+}
+
+bool QuicTransport::migrate(uint16_t localPort) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        setError(TransportError::NOT_CONNECTED, "Not connected");
+        return false;
+    }
+    std::shared_ptr<UDPTransport> fresh;
+    if (!openSocket(localPort, fresh)) {
+        return false;
+    }
+    if (!fresh->setPeerAddress(peerAddress_, peerPort_)) {
+        fresh->disconnect();
+        setError(TransportError::INVALID_ADDRESS, "Cannot reach the peer from the new socket");
+        return false;
+    }
+    // The I/O thread closes the old socket once its pending receive returns
+    udp_ = std::move(fresh);
+    localPort_ = localPort;
+    // Something must arrive from the new address for the peer to start validating it
+    probePending_ = true;
+    flush(Clock::now());
+    return true;
+}
+
+QuicTransport::Stats QuicTransport::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.smoothedRtt = smoothedRtt_;
+    stats.congestionWindow = congestion_ ? congestion_->congestionWindow() : 0;
+    return stats;
+}
+
+bool QuicTransport::getPeerAddress(std::string& address, uint16_t& port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        return false;
+    }
+    address = peerAddress_;
+    port = peerPort_;
+    return true;
+}
+
+int QuicTransport::getSocketFd() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return udp_ ? udp_->getSocketFd() : -1;
+}
+
+bool QuicTransport::setNonBlocking(bool nonBlocking) {
+    nonBlocking_.store(nonBlocking);
+    return true;
+}
+
+bool QuicTransport::setReceiveTimeout(const std::chrono::milliseconds& timeout) {
+    receiveTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+bool QuicTransport::setSendTimeout(const std::chrono::milliseconds& timeout) {
+    sendTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+bool QuicTransport::setKeepAlive(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    keepAlive_ = enable;
+    return true;
+}
+
+bool QuicTransport::setReuseAddress(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return udp_ && udp_->setReuseAddress(enable);
+}
+
+bool QuicTransport::setReceiveBufferSize(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return udp_ && udp_->setReceiveBufferSize(size);
+}
+
+bool QuicTransport::setSendBufferSize(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return udp_ && udp_->setSendBufferSize(size);
+}
+
+std::string QuicTransport::getLastError() const {
+    return getErrorDetails();
+}
+
+bool QuicTransport::setLocalPort(uint16_t port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return false;  // Use migrate() to move a live connection
+    }
+    localPort_ = port;
+    return true;
+}
+
+ConnectionState QuicTransport::getState() const {
+    return state_.load();
+}
+
+TransportError QuicTransport::getLastErrorCode() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+std::string QuicTransport::getErrorDetails() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return errorDetails_;
+}
+
+bool QuicTransport::reconnect(uint32_t maxAttempts, uint32_t delayMs) {
+    if (presharedKeys_) {
+        setError(TransportError::RECONNECTION_FAILED, "Pre-shared keys cannot be used for a second connection");
+        return false;
+    }
+    std::string endpoint;
+    ConnectionConfig config;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        endpoint = endpoint_;
+        config = config_.connectionConfig;
+    }
+    disconnect();
+    for (uint32_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        }
+        if (connect(endpoint, config)) {
+            return true;
+        }
+    }
+    setError(TransportError::RECONNECTION_FAILED, "Reconnection failed after " + std::to_string(maxAttempts) +
+                                                      " attempts");
+    return false;
+}
+
+void QuicTransport::setStateCallback(std::function<void(ConnectionState)> callback) {
+    stateCallback_ = std::move(callback);
+}
+
+void QuicTransport::setErrorCallback(std::function<void(TransportError, const std::string&)> callback) {
+    errorCallback_ = std::move(callback);
+}
+
+bool QuicTransport::checkHealth() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ && Clock::now() - lastReceived_ < std::chrono::milliseconds(config_.idleTimeoutMs);
+}
+
+void QuicTransport::setError(TransportError code, const std::string& details) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = code;
+    errorDetails_ = details;
+}
+
+void QuicTransport::updateState(ConnectionState state) {
+    state_.store(state);
+    if (stateCallback_) {
+        stateCallback_(state);
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,153 @@
+#include "xenocomm/core/ranked_discovery.h"
+#include "xenocomm/core/feedback_loop.h"
+#include <algorithm>
+#include <random>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+std::mt19937_64& randomEngine() {
+    thread_local std::mt19937_64 engine{std::random_device{}()};
+    return engine;
+}
+
+} // namespace
+
+RankedDiscovery::RankedDiscovery(CapabilitySignaler& signaler, const FeedbackLoop* feedback,
+                                 const RankingConfig& config)
+    : signaler_(signaler), feedback_(feedback), config_(config) {}
+
+void RankedDiscovery::reportLoad(const std::string& agentId, double load) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loads_[agentId] = LoadReport{std::max(load, 0.0), std::chrono::steady_clock::now()};
+}
+
+void RankedDiscovery::forgetAgent(const std::string& agentId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loads_.erase(agentId);
+}
+
+void RankedDiscovery::setConfig(const RankingConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+}
+
+RankingConfig RankedDiscovery::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+std::vector<RankedAgent> RankedDiscovery::rank(const std::vector<Capability>& requiredCapabilities,
+                                               bool partialMatch, size_t limit) {
+    std::vector<RankedAgent> ranked = score(signaler_.discoverAgents(requiredCapabilities, partialMatch));
+
+    // Shuffled first so agents with equal scores come out in a different order for each caller
+    std::shuffle(ranked.begin(), ranked.end(), randomEngine());
+    auto better = [](const RankedAgent& a, const RankedAgent& b) { return a.score < b.score; };
+    if (limit != 0 && limit < ranked.size()) {
+        std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(limit), ranked.end(), better);
+        ranked.resize(limit);
+    } else {
+        std::stable_sort(ranked.begin(), ranked.end(), better);
+    }
+    return ranked;
+}
+
+std::optional<RankedAgent> RankedDiscovery::choose(const std::vector<Capability>& requiredCapabilities,
+                                                   bool partialMatch) {
+    std::vector<std::string> agents = signaler_.discoverAgents(requiredCapabilities, partialMatch);
+    if (agents.empty()) {
+        return std::nullopt;
+    }
+
+    // Only the two candidates are scored, so choosing costs the same however many agents match
+    auto& engine = randomEngine();
+    std::uniform_int_distribution<size_t> pick(0, agents.size() - 1);
+    size_t first = pick(engine);
+    std::vector<std::string> candidates{agents[first]};
+    if (agents.size() > 1) {
+        size_t second = std::uniform_int_distribution<size_t>(0, agents.size() - 2)(engine);
+        candidates.push_back(agents[second >= first ? second + 1 : second]);
+    }
+    std::vector<RankedAgent> scored = score(candidates);
+    if (scored.size() == 2 && scored[1].score < scored[0].score) {
+        return std::move(scored[1]);
+    }
+    return std::move(scored[0]);
+}
+
+std::vector<RankedAgent> RankedDiscovery::score(const std::vector<std::string>& agents) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refreshLatencies();
+
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<RankedAgent> ranked;
+    ranked.reserve(agents.size());
+    double latencySum = 0;
+    size_t measured = 0;
+    for (const auto& agentId : agents) {
+        RankedAgent agent;
+        agent.agentId = agentId;
+        agent.load = config_.unknownLoad;
+        auto load = loads_.find(agentId);
+        if (load != loads_.end() && now - load->second.reportedAt <= config_.loadTtl) {
+            agent.load = load->second.load;
+            agent.loadReported = true;
+        }
+        auto latency = latencies_.find(agentId);
+        if (latency != latencies_.end()) {
+            agent.latencyMs = latency->second;
+            agent.latencyMeasured = true;
+            latencySum += latency->second;
+            ++measured;
+        }
+        ranked.push_back(std::move(agent));
+    }
+
+    // An agent nobody has talked to yet is neither favoured nor avoided for its latency
+    const double meanLatency = measured > 0 ? latencySum / static_cast<double>(measured) : 0;
+    const double scaleMs = std::max<double>(static_cast<double>(config_.latencyScale.count()), 1e-3);
+    for (auto& agent : ranked) {
+        if (!agent.latencyMeasured) {
+            agent.latencyMs = meanLatency;
+        }
+        agent.score = config_.loadWeight * agent.load + config_.latencyWeight * agent.latencyMs / scaleMs;
+    }
+    return ranked;
+}
+
+void RankedDiscovery::refreshLatencies() {
+    if (!feedback_) {
+        return;
+    }
+    const uint64_t generation = feedback_->getWindowGeneration();
+    if (latenciesLoaded_ && generation == latencyGeneration_) {
+        return;
+    }
+    auto labeled = feedback_->getLabeledMetrics();
+    if (!labeled.has_value()) {
+        return;
+    }
+
+    // A peer's outcomes may be spread over several label sets, one per transport or encoding
+    std::unordered_map<std::string, std::pair<double, uint64_t>> totals;
+    for (const auto& entry : labeled.value()) {
+        if (entry.labels.peerId.empty() || entry.metrics.totalTransactions == 0) {
+            continue;
+        }
+        auto& total = totals[entry.labels.peerId];
+        total.first += entry.metrics.averageLatency * entry.metrics.totalTransactions;
+        total.second += entry.metrics.totalTransactions;
+    }
+    latencies_.clear();
+    for (const auto& [peerId, total] : totals) {
+        latencies_[peerId] = total.first / static_cast<double>(total.second) / 1000.0;
+    }
+    latencyGeneration_ = generation;
+    latenciesLoaded_ = true;
+}
+
+} // namespace core
+} // namespace xenocomm
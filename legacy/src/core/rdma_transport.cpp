@@ -0,0 +1,1047 @@
+#include "xenocomm/core/rdma_transport.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iterator>
+
+#ifdef XENOCOMM_HAVE_IBVERBS
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <infiniband/verbs.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <random>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// Every eager SEND starts with this header; the payload, if any, follows it
+constexpr size_t HEADER_SIZE = 32;
+
+enum : uint8_t {
+    MSG_EAGER = 1,   // a = payload length
+    MSG_RTS = 2,     // a = rendezvous id, b = message length
+    MSG_CTS = 3,     // a = rendezvous id, b = landing address, c = landing key
+    MSG_CREDIT = 4,  // Only returns credits
+    MSG_CLOSE = 5,
+};
+
+} // namespace
+
+#ifdef XENOCOMM_HAVE_IBVERBS
+
+namespace {
+
+void put32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void put64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t get32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= uint32_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t get64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= uint64_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Work request ids carry what completed in the top two bits
+constexpr uint64_t KIND_SHIFT = 62;
+constexpr uint64_t KIND_RECEIVE = 1;
+constexpr uint64_t KIND_SEND = 2;
+constexpr uint64_t KIND_WRITE = 3;
+constexpr uint64_t ID_MASK = (uint64_t(1) << KIND_SHIFT) - 1;
+
+constexpr size_t MAX_WRITE_CHUNK = size_t(1) << 30;  // Well under the 2 GiB a work request may carry
+constexpr uint32_t WRITE_BATCH = 32;                  // Writes posted before waiting on one to complete
+constexpr uint32_t EXCHANGE_MAGIC = 0x58525131;       // "XRQ1"
+constexpr size_t EXCHANGE_SIZE = 44;
+
+uint64_t wrId(uint64_t kind, uint64_t id) {
+    return (kind << KIND_SHIFT) | (id & ID_MASK);
+}
+
+struct PeerInfo {
+    uint32_t qpn = 0;
+    uint32_t psn = 0;
+    uint16_t lid = 0;
+    uint8_t mtu = 0;
+    uint8_t gid[16] = {};
+    uint32_t receiveDepth = 0;
+    uint64_t eagerLimit = 0;
+};
+
+void encodeInfo(const PeerInfo& info, uint8_t* out) {
+    put32(out, EXCHANGE_MAGIC);
+    put32(out + 4, info.qpn);
+    put32(out + 8, info.psn);
+    out[12] = static_cast<uint8_t>(info.lid);
+    out[13] = static_cast<uint8_t>(info.lid >> 8);
+    out[14] = info.mtu;
+    out[15] = 0;
+    std::memcpy(out + 16, info.gid, 16);
+    put32(out + 32, info.receiveDepth);
+    put64(out + 36, info.eagerLimit);
+}
+
+bool decodeInfo(const uint8_t* in, size_t size, PeerInfo& info) {
+    if (size != EXCHANGE_SIZE || get32(in) != EXCHANGE_MAGIC) {
+        return false;
+    }
+    info.qpn = get32(in + 4);
+    info.psn = get32(in + 8) & 0xFFFFFF;
+    info.lid = static_cast<uint16_t>(in[12] | (in[13] << 8));
+    info.mtu = in[14];
+    std::memcpy(info.gid, in + 16, 16);
+    info.receiveDepth = get32(in + 32);
+    info.eagerLimit = get64(in + 36);
+    return info.receiveDepth > 1 && info.eagerLimit > 0;
+}
+
+ibv_device* findDevice(ibv_device** devices, int count, const std::string& name) {
+    for (int i = 0; i < count; ++i) {
+        if (name.empty() || name == ibv_get_device_name(devices[i])) {
+            return devices[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+struct RdmaTransport::Verbs {
+    ibv_context* context = nullptr;
+    ibv_pd* pd = nullptr;
+    ibv_comp_channel* channel = nullptr;
+    ibv_cq* cq = nullptr;
+    ibv_qp* qp = nullptr;
+
+    // Receive and send slots, each a header plus up to eagerLimit bytes
+    size_t slotSize = 0;
+    std::vector<uint8_t> receiveArea;
+    std::vector<uint8_t> sendArea;
+    ibv_mr* receiveMr = nullptr;
+    ibv_mr* sendMr = nullptr;
+    std::vector<uint32_t> freeSendSlots;
+
+    ~Verbs() {
+        if (qp) {
+            ibv_destroy_qp(qp);
+        }
+        if (cq) {
+            ibv_destroy_cq(cq);
+        }
+        if (channel) {
+            ibv_destroy_comp_channel(channel);
+        }
+        if (receiveMr) {
+            ibv_dereg_mr(receiveMr);
+        }
+        if (sendMr) {
+            ibv_dereg_mr(sendMr);
+        }
+        if (pd) {
+            ibv_dealloc_pd(pd);
+        }
+        if (context) {
+            ibv_close_device(context);
+        }
+    }
+
+    uint8_t* receiveSlot(uint64_t slot) { return receiveArea.data() + slot * slotSize; }
+    uint8_t* sendSlot(uint64_t slot) { return sendArea.data() + slot * slotSize; }
+
+    bool postReceive(uint64_t slot) {
+        ibv_sge sge{};
+        sge.addr = reinterpret_cast<uintptr_t>(receiveSlot(slot));
+        sge.length = static_cast<uint32_t>(slotSize);
+        sge.lkey = receiveMr->lkey;
+        ibv_recv_wr wr{};
+        wr.wr_id = wrId(KIND_RECEIVE, slot);
+        wr.sg_list = &sge;
+        wr.num_sge = 1;
+        ibv_recv_wr* bad = nullptr;
+        return ibv_post_recv(qp, &wr, &bad) == 0;
+    }
+};
+
+struct RdmaTransport::Landing {
+    utils::PooledBuffer buffer;
+    ibv_mr* mr = nullptr;
+
+    ~Landing() {
+        if (mr) {
+            ibv_dereg_mr(mr);
+        }
+    }
+};
+
+#else
+
+struct RdmaTransport::Verbs {};
+struct RdmaTransport::Landing {};
+
+#endif // XENOCOMM_HAVE_IBVERBS
+
+RdmaTransport::RdmaTransport(std::shared_ptr<TransportProtocol> control, const RdmaConfig& config)
+    : control_(std::move(control)), config_(config) {}
+
+RdmaTransport::~RdmaTransport() {
+    disconnect();
+}
+
+bool RdmaTransport::available() {
+#ifdef XENOCOMM_HAVE_IBVERBS
+    int count = 0;
+    ibv_device** devices = ibv_get_device_list(&count);
+    if (!devices) {
+        return false;
+    }
+    ibv_free_device_list(devices);
+    return count > 0;
+#else
+    return false;
+#endif
+}
+
+bool RdmaTransport::connect(const std::string& endpoint, const ConnectionConfig& config) {
+    if (isConnected()) {
+        setError(TransportError::ALREADY_CONNECTED, "Already connected");
+        return false;
+    }
+    if (!control_) {
+        setError(TransportError::INVALID_PARAMETER, "RDMA needs a control transport");
+        return false;
+    }
+    if (config_.receiveDepth < 2 || config_.sendDepth < 1 || config_.eagerLimit == 0 ||
+        config_.eagerLimit > UINT32_MAX - HEADER_SIZE) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid RDMA queue settings");
+        return false;
+    }
+    updateState(ConnectionState::CONNECTING);
+    if (!control_->isConnected() && !control_->connect(endpoint, config)) {
+        setError(TransportError::CONNECTION_FAILED, "Control transport: " + control_->getErrorDetails());
+        updateState(ConnectionState::ERROR);
+        return false;
+    }
+
+    std::string error;
+    if (!setUp(error)) {
+        tearDown();
+        setError(TransportError::CONNECTION_FAILED, error);
+        updateState(ConnectionState::ERROR);
+        return false;
+    }
+    endpoint_ = endpoint;
+    connectionConfig_ = config;
+    partial_.reset();
+    partialOffset_ = 0;
+    poller_ = std::thread([this] { pollLoop(); });
+    updateState(ConnectionState::CONNECTED);
+    return true;
+}
+
+#ifdef XENOCOMM_HAVE_IBVERBS
+
+bool RdmaTransport::setUp(std::string& error) {
+    auto verbs = std::make_unique<Verbs>();
+    int count = 0;
+    ibv_device** devices = ibv_get_device_list(&count);
+    if (!devices) {
+        error = "No RDMA devices: " + std::string(std::strerror(errno));
+        return false;
+    }
+    ibv_device* device = findDevice(devices, count, config_.deviceName);
+    if (device) {
+        verbs->context = ibv_open_device(device);
+    }
+    ibv_free_device_list(devices);
+    if (!device) {
+        error = config_.deviceName.empty() ? "No RDMA devices" : "No RDMA device named " + config_.deviceName;
+        return false;
+    }
+    if (!verbs->context) {
+        error = "Cannot open RDMA device: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    ibv_port_attr port{};
+    if (ibv_query_port(verbs->context, config_.port, &port) != 0 || port.state != IBV_PORT_ACTIVE) {
+        error = "RDMA port " + std::to_string(config_.port) + " is not active";
+        return false;
+    }
+    ibv_gid gid{};
+    if (ibv_query_gid(verbs->context, config_.port, config_.gidIndex, &gid) != 0) {
+        error = "Cannot read GID " + std::to_string(config_.gidIndex);
+        return false;
+    }
+
+    verbs->pd = ibv_alloc_pd(verbs->context);
+    verbs->channel = verbs->pd ? ibv_create_comp_channel(verbs->context) : nullptr;
+    if (!verbs->channel) {
+        error = "Cannot allocate RDMA protection domain: " + std::string(std::strerror(errno));
+        return false;
+    }
+    // The poller waits on the channel with poll(), so reading an event must never block
+    const int flags = fcntl(verbs->channel->fd, F_GETFL);
+    fcntl(verbs->channel->fd, F_SETFL, flags | O_NONBLOCK);
+
+    const uint32_t maxSend = config_.sendDepth + WRITE_BATCH + 1;
+    verbs->cq = ibv_create_cq(verbs->context, static_cast<int>(maxSend + config_.receiveDepth), nullptr,
+                              verbs->channel, 0);
+    if (!verbs->cq || ibv_req_notify_cq(verbs->cq, 0) != 0) {
+        error = "Cannot create RDMA completion queue: " + std::string(std::strerror(errno));
+        return false;
+    }
+    ibv_qp_init_attr init{};
+    init.send_cq = verbs->cq;
+    init.recv_cq = verbs->cq;
+    init.qp_type = IBV_QPT_RC;
+    init.cap.max_send_wr = maxSend;
+    init.cap.max_recv_wr = config_.receiveDepth;
+    init.cap.max_send_sge = 1;
+    init.cap.max_recv_sge = 1;
+    verbs->qp = ibv_create_qp(verbs->pd, &init);
+    if (!verbs->qp) {
+        error = "Cannot create RDMA queue pair: " + std::string(std::strerror(errno));
+        return false;
+    }
+
+    verbs->slotSize = HEADER_SIZE + config_.eagerLimit;
+    verbs->receiveArea.resize(verbs->slotSize * config_.receiveDepth);
+    verbs->sendArea.resize(verbs->slotSize * config_.sendDepth);
+    verbs->receiveMr = ibv_reg_mr(verbs->pd, verbs->receiveArea.data(), verbs->receiveArea.size(),
+                                  IBV_ACCESS_LOCAL_WRITE);
+    verbs->sendMr = ibv_reg_mr(verbs->pd, verbs->sendArea.data(), verbs->sendArea.size(), 0);
+    if (!verbs->receiveMr || !verbs->sendMr) {
+        error = "Cannot register RDMA buffers: " + std::string(std::strerror(errno));
+        return false;
+    }
+    for (uint32_t slot = config_.sendDepth; slot > 0; --slot) {
+        verbs->freeSendSlots.push_back(slot - 1);
+    }
+
+    ibv_qp_attr attr{};
+    attr.qp_state = IBV_QPS_INIT;
+    attr.pkey_index = 0;
+    attr.port_num = config_.port;
+    attr.qp_access_flags = IBV_ACCESS_REMOTE_WRITE;
+    if (ibv_modify_qp(verbs->qp, &attr, IBV_QP_STATE | IBV_QP_PKEY_INDEX | IBV_QP_PORT | IBV_QP_ACCESS_FLAGS) != 0) {
+        error = "Cannot initialize RDMA queue pair";
+        return false;
+    }
+    // Receives may be posted from INIT, and must be before the peer can send
+    for (uint32_t slot = 0; slot < config_.receiveDepth; ++slot) {
+        if (!verbs->postReceive(slot)) {
+            error = "Cannot post RDMA receives";
+            return false;
+        }
+    }
+
+    PeerInfo local;
+    local.qpn = verbs->qp->qp_num;
+    local.psn = std::random_device{}() & 0xFFFFFF;
+    local.lid = port.lid;
+    local.mtu = static_cast<uint8_t>(port.active_mtu);
+    std::memcpy(local.gid, gid.raw, 16);
+    local.receiveDepth = config_.receiveDepth;
+    local.eagerLimit = config_.eagerLimit;
+    uint8_t encoded[EXCHANGE_SIZE];
+    encodeInfo(local, encoded);
+    const utils::ByteSpan part(encoded, sizeof(encoded));
+    utils::PooledBuffer frame;
+    PeerInfo peer;
+    if (control_->sendFrame(&part, 1) < 0 || control_->receiveFrame(frame) < 0 ||
+        !decodeInfo(frame.data(), frame.size(), peer)) {
+        error = "RDMA queue pair exchange failed: " + control_->getErrorDetails();
+        return false;
+    }
+
+    attr = ibv_qp_attr{};
+    attr.qp_state = IBV_QPS_RTR;
+    attr.path_mtu = static_cast<ibv_mtu>(std::min(local.mtu, peer.mtu));
+    attr.dest_qp_num = peer.qpn;
+    attr.rq_psn = peer.psn;
+    attr.max_dest_rd_atomic = 1;
+    attr.min_rnr_timer = 12;
+    attr.ah_attr.dlid = peer.lid;
+    attr.ah_attr.port_num = config_.port;
+    if (std::any_of(std::begin(peer.gid), std::end(peer.gid), [](uint8_t b) { return b != 0; })) {
+        attr.ah_attr.is_global = 1;
+        std::memcpy(attr.ah_attr.grh.dgid.raw, peer.gid, 16);
+        attr.ah_attr.grh.sgid_index = static_cast<uint8_t>(config_.gidIndex);
+        attr.ah_attr.grh.hop_limit = 64;
+    }
+    if (ibv_modify_qp(verbs->qp, &attr,
+                      IBV_QP_STATE | IBV_QP_AV | IBV_QP_PATH_MTU | IBV_QP_DEST_QPN | IBV_QP_RQ_PSN |
+                          IBV_QP_MAX_DEST_RD_ATOMIC | IBV_QP_MIN_RNR_TIMER) != 0) {
+        error = "Cannot move RDMA queue pair to RTR";
+        return false;
+    }
+    attr = ibv_qp_attr{};
+    attr.qp_state = IBV_QPS_RTS;
+    attr.sq_psn = local.psn;
+    attr.timeout = 14;
+    attr.retry_cnt = 7;
+    attr.rnr_retry = 7;
+    attr.max_rd_atomic = 1;
+    if (ibv_modify_qp(verbs->qp, &attr,
+                      IBV_QP_STATE | IBV_QP_SQ_PSN | IBV_QP_TIMEOUT | IBV_QP_RETRY_CNT | IBV_QP_RNR_RETRY |
+                          IBV_QP_MAX_QP_RD_ATOMIC) != 0) {
+        error = "Cannot move RDMA queue pair to RTS";
+        return false;
+    }
+
+    // Neither side sends until both are in RTS, or the first SEND could find the peer in INIT
+    const uint8_t ready = 1;
+    const utils::ByteSpan readyPart(&ready, 1);
+    if (control_->sendFrame(&readyPart, 1) < 0 || control_->receiveFrame(frame) != 1) {
+        error = "RDMA ready handshake failed: " + control_->getErrorDetails();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    verbs_ = std::move(verbs);
+    running_ = true;
+    failed_ = false;
+    error_.clear();
+    sendCredits_ = peer.receiveDepth;
+    creditsToReturn_ = 0;
+    peerEagerLimit_ = static_cast<size_t>(std::min<uint64_t>(peer.eagerLimit, config_.eagerLimit));
+    return true;
+}
+
+void RdmaTransport::tearDown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Landings hold memory regions in our protection domain, so they go first
+    inbound_.clear();
+    outbound_.clear();
+    pendingControl_.clear();
+    verbs_.reset();
+}
+
+void RdmaTransport::pollLoop() {
+    const int fd = verbs_->channel->fd;
+    for (;;) {
+        pollfd pfd{fd, POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, static_cast<int>(config_.pollIntervalMs));
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        if (ready > 0) {
+            ibv_cq* cq = nullptr;
+            void* context = nullptr;
+            if (ibv_get_cq_event(verbs_->channel, &cq, &context) == 0) {
+                ibv_ack_cq_events(cq, 1);
+                ibv_req_notify_cq(cq, 0);
+            }
+        }
+        // Draining after rearming catches whatever completed in between
+        handleCompletions();
+    }
+}
+
+void RdmaTransport::handleCompletions() {
+    ibv_wc completions[32];
+    int n = 0;
+    while (running_ && (n = ibv_poll_cq(verbs_->cq, 32, completions)) > 0) {
+        for (int i = 0; i < n && running_; ++i) {
+            const ibv_wc& wc = completions[i];
+            const uint64_t kind = wc.wr_id >> KIND_SHIFT;
+            const uint64_t id = wc.wr_id & ID_MASK;
+            if (wc.status != IBV_WC_SUCCESS) {
+                fail(std::string("RDMA work request failed: ") + ibv_wc_status_str(wc.status));
+                break;
+            }
+            if (kind == KIND_SEND) {
+                verbs_->freeSendSlots.push_back(static_cast<uint32_t>(id));
+                continue;
+            }
+            if (kind == KIND_WRITE) {
+                auto it = outbound_.find(id);
+                if (it != outbound_.end() && it->second.outstanding > 0) {
+                    --it->second.outstanding;
+                }
+                continue;
+            }
+
+            // A receive: either a bulk message finishing, or an eager message with a header
+            if (wc.opcode == IBV_WC_RECV_RDMA_WITH_IMM) {
+                auto it = inbound_.find(ntohl(wc.imm_data));
+                if (it == inbound_.end()) {
+                    fail("RDMA write for an unknown rendezvous");
+                    break;
+                }
+                std::unique_ptr<Landing> landing = std::move(it->second);
+                inbound_.erase(it);
+                ibv_dereg_mr(landing->mr);
+                landing->mr = nullptr;
+                messages_.push_back(std::move(landing->buffer));
+            } else {
+                const uint8_t* header = verbs_->receiveSlot(id);
+                if (wc.byte_len < HEADER_SIZE) {
+                    fail("Truncated RDMA message");
+                    break;
+                }
+                sendCredits_ += get32(header + 4);
+                const uint64_t a = get64(header + 8);
+                const uint64_t b = get64(header + 16);
+                const uint32_t c = get32(header + 24);
+                switch (header[0]) {
+                case MSG_EAGER: {
+                    if (a > wc.byte_len - HEADER_SIZE) {
+                        fail("Truncated RDMA message");
+                        break;
+                    }
+                    utils::PooledBuffer message = utils::BufferPool::shared().acquire(std::max<size_t>(a, 1));
+                    message.resize(a);
+                    if (a) {
+                        std::memcpy(message.data(), header + HEADER_SIZE, a);
+                    }
+                    messages_.push_back(std::move(message));
+                    break;
+                }
+                case MSG_RTS: {
+                    if (b > config_.maxMessageSize) {
+                        fail("Incoming RDMA message of " + std::to_string(b) + " bytes exceeds the limit");
+                        break;
+                    }
+                    auto landing = std::make_unique<Landing>();
+                    landing->buffer = utils::BufferPool::shared().acquire(b);
+                    landing->buffer.resize(b);
+                    landing->mr = ibv_reg_mr(verbs_->pd, landing->buffer.data(), b,
+                                             IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_WRITE);
+                    if (!landing->mr) {
+                        fail("Cannot register RDMA landing buffer: " + std::string(std::strerror(errno)));
+                        break;
+                    }
+                    const uint64_t address = reinterpret_cast<uintptr_t>(landing->buffer.data());
+                    const uint32_t key = landing->mr->rkey;
+                    inbound_[a] = std::move(landing);
+                    queueControl(MSG_CTS, a, address, key);
+                    break;
+                }
+                case MSG_CTS: {
+                    auto it = outbound_.find(a);
+                    if (it != outbound_.end()) {
+                        it->second.remoteAddress = b;
+                        it->second.remoteKey = c;
+                        it->second.cleared = true;
+                    }
+                    break;
+                }
+                case MSG_CREDIT:
+                    break;
+                case MSG_CLOSE:
+                    running_ = false;
+                    setError(TransportError::CONNECTION_CLOSED, "Peer closed the RDMA connection");
+                    break;
+                default:
+                    fail("Unknown RDMA message type");
+                    break;
+                }
+            }
+            if (running_) {
+                if (!verbs_->postReceive(id)) {
+                    fail("Cannot repost RDMA receive");
+                    break;
+                }
+                ++creditsToReturn_;
+            }
+        }
+    }
+    if (n < 0 && running_) {
+        fail("Cannot poll RDMA completion queue");
+    }
+    // A receiver that never sends still has to hand credit back before the sender runs dry
+    if (running_ && creditsToReturn_ >= config_.receiveDepth / 2 &&
+        std::none_of(pendingControl_.begin(), pendingControl_.end(),
+                     [](const PendingControl& p) { return p.type == MSG_CREDIT; })) {
+        queueControl(MSG_CREDIT, 0, 0, 0);
+    }
+    flushControl();
+    cv_.notify_all();
+}
+
+bool RdmaTransport::canPost(bool credit) const {
+    // The peer's last receive is kept for credit returns, so neither side can run the other dry
+    return !verbs_->freeSendSlots.empty() && sendCredits_ > (credit ? 0u : 1u);
+}
+
+bool RdmaTransport::post(uint8_t type, uint64_t a, uint64_t b, uint32_t c, const utils::ByteSpan* parts,
+                         size_t count) {
+    const uint32_t slot = verbs_->freeSendSlots.back();
+    uint8_t* out = verbs_->sendSlot(slot);
+    std::memset(out, 0, HEADER_SIZE);
+    out[0] = type;
+    put32(out + 4, creditsToReturn_);
+    put64(out + 8, a);
+    put64(out + 16, b);
+    put32(out + 24, c);
+    size_t length = HEADER_SIZE;
+    for (size_t i = 0; i < count; ++i) {
+        if (parts[i].size()) {
+            std::memcpy(out + length, parts[i].data(), parts[i].size());
+            length += parts[i].size();
+        }
+    }
+    ibv_sge sge{};
+    sge.addr = reinterpret_cast<uintptr_t>(out);
+    sge.length = static_cast<uint32_t>(length);
+    sge.lkey = verbs_->sendMr->lkey;
+    ibv_send_wr wr{};
+    wr.wr_id = wrId(KIND_SEND, slot);
+    wr.sg_list = &sge;
+    wr.num_sge = 1;
+    wr.opcode = IBV_WR_SEND;
+    wr.send_flags = IBV_SEND_SIGNALED;
+    ibv_send_wr* bad = nullptr;
+    if (ibv_post_send(verbs_->qp, &wr, &bad) != 0) {
+        fail("Cannot post RDMA send: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    verbs_->freeSendSlots.pop_back();
+    --sendCredits_;
+    creditsToReturn_ = 0;
+    return true;
+}
+
+void RdmaTransport::queueControl(uint8_t type, uint64_t a, uint64_t b, uint32_t c) {
+    pendingControl_.push_back(PendingControl{type, a, b, c});
+}
+
+void RdmaTransport::flushControl() {
+    while (running_ && !pendingControl_.empty() && canPost(pendingControl_.front().type == MSG_CREDIT)) {
+        const PendingControl next = pendingControl_.front();
+        pendingControl_.pop_front();
+        if (next.type == MSG_CREDIT && creditsToReturn_ == 0) {
+            continue;  // Some other message already carried them
+        }
+        if (!post(next.type, next.a, next.b, next.c, nullptr, 0)) {
+            return;
+        }
+    }
+}
+
+ssize_t RdmaTransport::sendBulk(const utils::ByteSpan* parts, size_t count, size_t total,
+                                std::unique_lock<std::mutex>& lock) {
+    const int64_t timeoutMs = sendTimeoutMs_.load();
+    const uint64_t id = nextRendezvousId_++ & 0xFFFFFFFF;  // Fits the immediate data
+    outbound_[id] = Rendezvous{};
+    ibv_pd* pd = verbs_->pd;
+
+    // Registration pins the caller's pages, which can take a while for large buffers
+    lock.unlock();
+    std::vector<ibv_mr*> regions(count, nullptr);
+    bool registered = true;
+    for (size_t i = 0; i < count && registered; ++i) {
+        if (parts[i].size()) {
+            regions[i] = ibv_reg_mr(pd, const_cast<uint8_t*>(parts[i].data()), parts[i].size(), 0);
+            registered = regions[i] != nullptr;
+        }
+    }
+    auto release = [&] {
+        lock.unlock();
+        for (ibv_mr* region : regions) {
+            if (region) {
+                ibv_dereg_mr(region);
+            }
+        }
+        lock.lock();
+    };
+    lock.lock();
+    if (!registered) {
+        outbound_.erase(id);
+        release();
+        setError(TransportError::SEND_ERROR, "Cannot register RDMA send buffer: " + std::string(std::strerror(errno)));
+        return -1;
+    }
+
+    auto abandon = [&]() -> ssize_t {
+        outbound_.erase(id);
+        release();
+        return -1;
+    };
+    if (!waitFor(lock, [&] { return canPost(false); }, timeoutMs) ||
+        !post(MSG_RTS, id, total, 0, nullptr, 0)) {
+        return abandon();
+    }
+    if (!waitFor(lock, [&] { return outbound_[id].cleared; }, timeoutMs)) {
+        return abandon();
+    }
+
+    // One-sided writes, in batches small enough for the send queue; the last carries the id
+    const Rendezvous target = outbound_[id];
+    size_t part = 0;
+    size_t offset = 0;
+    size_t written = 0;
+    while (written < total) {
+        // The final write consumes one of the peer's receives
+        if (!waitFor(lock, [&] { return outbound_[id].outstanding == 0 && sendCredits_ > 1; }, timeoutMs)) {
+            return abandon();
+        }
+        ibv_sge sges[WRITE_BATCH];
+        ibv_send_wr wrs[WRITE_BATCH];
+        uint32_t batch = 0;
+        while (batch < WRITE_BATCH && written < total) {
+            while (parts[part].size() == offset) {
+                ++part;
+                offset = 0;
+            }
+            const size_t length = std::min(parts[part].size() - offset, MAX_WRITE_CHUNK);
+            sges[batch] = ibv_sge{};
+            sges[batch].addr = reinterpret_cast<uintptr_t>(parts[part].data() + offset);
+            sges[batch].length = static_cast<uint32_t>(length);
+            sges[batch].lkey = regions[part]->lkey;
+            wrs[batch] = ibv_send_wr{};
+            wrs[batch].sg_list = &sges[batch];
+            wrs[batch].num_sge = 1;
+            wrs[batch].opcode = IBV_WR_RDMA_WRITE;
+            wrs[batch].wr.rdma.remote_addr = target.remoteAddress + written;
+            wrs[batch].wr.rdma.rkey = target.remoteKey;
+            if (batch > 0) {
+                wrs[batch - 1].next = &wrs[batch];
+            }
+            offset += length;
+            written += length;
+            ++batch;
+        }
+        ibv_send_wr& last = wrs[batch - 1];
+        last.wr_id = wrId(KIND_WRITE, id);
+        last.send_flags = IBV_SEND_SIGNALED;
+        if (written == total) {
+            last.opcode = IBV_WR_RDMA_WRITE_WITH_IMM;
+            last.imm_data = htonl(static_cast<uint32_t>(id));
+            --sendCredits_;
+        }
+        ibv_send_wr* bad = nullptr;
+        if (ibv_post_send(verbs_->qp, &wrs[0], &bad) != 0) {
+            fail("Cannot post RDMA write: " + std::string(std::strerror(errno)));
+            return abandon();
+        }
+        outbound_[id].outstanding = 1;
+    }
+    if (!waitFor(lock, [&] { return outbound_[id].outstanding == 0; }, timeoutMs)) {
+        return abandon();
+    }
+    outbound_.erase(id);
+    release();
+    return static_cast<ssize_t>(total);
+}
+
+#else
+
+bool RdmaTransport::setUp(std::string& error) {
+    error = "RDMA support was not built (libibverbs not found)";
+    return false;
+}
+
+void RdmaTransport::tearDown() {}
+void RdmaTransport::pollLoop() {}
+void RdmaTransport::handleCompletions() {}
+bool RdmaTransport::canPost(bool) const { return false; }
+
+bool RdmaTransport::post(uint8_t, uint64_t, uint64_t, uint32_t, const utils::ByteSpan*, size_t) {
+    return false;
+}
+
+void RdmaTransport::queueControl(uint8_t, uint64_t, uint64_t, uint32_t) {}
+void RdmaTransport::flushControl() {}
+
+ssize_t RdmaTransport::sendBulk(const utils::ByteSpan*, size_t, size_t, std::unique_lock<std::mutex>&) {
+    setError(TransportError::NOT_CONNECTED, "Not connected");
+    return -1;
+}
+
+#endif // XENOCOMM_HAVE_IBVERBS
+
+void RdmaTransport::fail(const std::string& reason) {
+    failed_ = true;
+    running_ = false;
+    error_ = reason;
+    setError(TransportError::CONNECTION_RESET, reason);
+    updateState(ConnectionState::ERROR);
+    cv_.notify_all();
+}
+
+bool RdmaTransport::waitFor(std::unique_lock<std::mutex>& lock, const std::function<bool()>& ready,
+                            int64_t timeoutMs) {
+    auto stop = [&] { return !running_ || ready(); };
+    if (timeoutMs > 0) {
+        if (!cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), stop)) {
+            setError(TransportError::TIMEOUT, "RDMA send timed out");
+            return false;
+        }
+    } else {
+        cv_.wait(lock, stop);
+    }
+    if (!running_) {
+        if (failed_) {
+            setError(TransportError::CONNECTION_RESET, error_);
+        } else {
+            setError(TransportError::CONNECTION_CLOSED, "RDMA connection closed");
+        }
+        return false;
+    }
+    return true;
+}
+
+bool RdmaTransport::disconnect() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!verbs_) {
+        return true;
+    }
+#ifdef XENOCOMM_HAVE_IBVERBS
+    if (running_) {
+        // Best effort: give the CLOSE a moment to leave before the queue pair goes
+        queueControl(MSG_CLOSE, 0, 0, 0);
+        flushControl();
+        cv_.wait_for(lock, std::chrono::milliseconds(100), [&] {
+            return !running_ || (pendingControl_.empty() && verbs_->freeSendSlots.size() == config_.sendDepth);
+        });
+    }
+#endif
+    running_ = false;
+    cv_.notify_all();
+    lock.unlock();
+    if (poller_.joinable()) {
+        poller_.join();
+    }
+    tearDown();
+    if (control_) {
+        control_->disconnect();
+    }
+    updateState(ConnectionState::DISCONNECTED);
+    return true;
+}
+
+bool RdmaTransport::isConnected() const {
+    return state_.load() == ConnectionState::CONNECTED;
+}
+
+ssize_t RdmaTransport::sendv(const utils::ByteSpan* buffers, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += buffers[i].size();
+    }
+    std::unique_lock<std::mutex> bulkLock(bulkMutex_, std::defer_lock);
+    if (total > peerEagerLimit_) {
+        bulkLock.lock();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!verbs_ || !running_) {
+        setError(failed_ ? TransportError::CONNECTION_RESET : TransportError::NOT_CONNECTED,
+                 failed_ ? error_ : "Not connected");
+        return -1;
+    }
+    if (total > peerEagerLimit_) {
+        return sendBulk(buffers, count, total, lock);
+    }
+    if (!canPost(false)) {
+        if (nonBlocking_.load()) {
+            setError(TransportError::WOULD_BLOCK, "No RDMA send credit");
+            return -1;
+        }
+        if (!waitFor(lock, [&] { return pendingControl_.empty() && canPost(false); }, sendTimeoutMs_.load())) {
+            return -1;
+        }
+    }
+    if (!post(MSG_EAGER, total, 0, 0, buffers, count)) {
+        return -1;
+    }
+    return static_cast<ssize_t>(total);
+}
+
+ssize_t RdmaTransport::send(const uint8_t* data, size_t size) {
+    if (!data && size > 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+    const utils::ByteSpan part(data, size);
+    return sendv(&part, 1);
+}
+
+ssize_t RdmaTransport::sendFrame(const utils::ByteSpan* parts, size_t count) {
+    return sendv(parts, count);
+}
+
+ssize_t RdmaTransport::receiveMessage(utils::PooledBuffer& message, size_t maxSize) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!verbs_) {
+        setError(TransportError::NOT_CONNECTED, "Not connected");
+        return -1;
+    }
+    if (messages_.empty()) {
+        if (!running_) {
+            setError(failed_ ? TransportError::CONNECTION_RESET : TransportError::CONNECTION_CLOSED,
+                     failed_ ? error_ : "RDMA connection closed");
+            return -1;
+        }
+        if (nonBlocking_.load()) {
+            setError(TransportError::WOULD_BLOCK, "No message available");
+            return -1;
+        }
+        const int64_t timeoutMs = receiveTimeoutMs_.load();
+        auto ready = [&] { return !messages_.empty() || !running_; };
+        if (timeoutMs > 0) {
+            if (!cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready)) {
+                setError(TransportError::TIMEOUT, "No message within the receive timeout");
+                return -1;
+            }
+        } else {
+            cv_.wait(lock, ready);
+        }
+        if (messages_.empty()) {
+            setError(failed_ ? TransportError::CONNECTION_RESET : TransportError::CONNECTION_CLOSED,
+                     failed_ ? error_ : "RDMA connection closed");
+            return -1;
+        }
+    }
+    if (messages_.front().size() > maxSize) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Message larger than the receive buffer");
+        messages_.pop_front();
+        return -1;
+    }
+    message = std::move(messages_.front());
+    messages_.pop_front();
+    return static_cast<ssize_t>(message.size());
+}
+
+ssize_t RdmaTransport::receiveFrame(utils::PooledBuffer& frame) {
+    return receiveMessage(frame, SIZE_MAX);
+}
+
+ssize_t RdmaTransport::receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) {
+    return receiveMessage(buffer, maxSize);
+}
+
+ssize_t RdmaTransport::receive(uint8_t* buffer, size_t size) {
+    if (!buffer || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid receive parameters");
+        return -1;
+    }
+    // Only one reader at a time may use receive(); the rest of a message waits for the next call
+    if (partialOffset_ >= partial_.size()) {
+        partial_.reset();
+        partialOffset_ = 0;
+        if (receiveFrame(partial_) < 0) {
+            return getLastErrorCode() == TransportError::TIMEOUT ? 0 : -1;
+        }
+    }
+    const size_t n = std::min(size, partial_.size() - partialOffset_);
+    if (n) {
+        std::memcpy(buffer, partial_.data() + partialOffset_, n);
+    }
+    partialOffset_ += n;
+    return static_cast<ssize_t>(n);
+}
+
+bool RdmaTransport::getPeerAddress(std::string& address, uint16_t& port) {
+    return isConnected() && control_->getPeerAddress(address, port);
+}
+
+bool RdmaTransport::setNonBlocking(bool nonBlocking) {
+    nonBlocking_.store(nonBlocking);
+    return true;
+}
+
+bool RdmaTransport::setReceiveTimeout(const std::chrono::milliseconds& timeout) {
+    receiveTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+bool RdmaTransport::setSendTimeout(const std::chrono::milliseconds& timeout) {
+    sendTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+std::string RdmaTransport::getLastError() const {
+    return getErrorDetails();
+}
+
+bool RdmaTransport::setLocalPort(uint16_t port) {
+    return !isConnected() && control_ && control_->setLocalPort(port);
+}
+
+ConnectionState RdmaTransport::getState() const {
+    return state_.load();
+}
+
+TransportError RdmaTransport::getLastErrorCode() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+std::string RdmaTransport::getErrorDetails() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return errorDetails_;
+}
+
+bool RdmaTransport::reconnect(uint32_t maxAttempts, uint32_t delayMs) {
+    const std::string endpoint = endpoint_;
+    if (endpoint.empty()) {
+        setError(TransportError::RECONNECTION_FAILED, "Never connected");
+        return false;
+    }
+    disconnect();
+    for (uint32_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        }
+        if (connect(endpoint, connectionConfig_)) {
+            return true;
+        }
+    }
+    setError(TransportError::RECONNECTION_FAILED, "Reconnection failed after " + std::to_string(maxAttempts) +
+                                                      " attempts");
+    return false;
+}
+
+void RdmaTransport::setStateCallback(std::function<void(ConnectionState)> callback) {
+    stateCallback_ = std::move(callback);
+}
+
+void RdmaTransport::setErrorCallback(std::function<void(TransportError, const std::string&)> callback) {
+    errorCallback_ = std::move(callback);
+}
+
+void RdmaTransport::setError(TransportError code, const std::string& details) {
+    {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        lastError_ = code;
+        errorDetails_ = details;
+    }
+    if (errorCallback_) {
+        errorCallback_(code, details);
+    }
+}
+
+void RdmaTransport::updateState(ConnectionState state) {
+    state_.store(state);
+    if (stateCallback_) {
+        stateCallback_(state);
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
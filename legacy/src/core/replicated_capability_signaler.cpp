@@ -0,0 +1,404 @@
+#include "xenocomm/core/replicated_capability_signaler.h"
+#include "xenocomm/utils/serialization.h"
+#include <algorithm>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr uint8_t DELTA_FORMAT_V1 = 0xC3;
+constexpr uint8_t DIGEST_FORMAT_V1 = 0xC4;
+constexpr size_t DIGEST_SIZE = 1 + 8 * (ReplicatedCapabilitySignaler::BUCKET_COUNT + 1);
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t h = 0xCBF29CE484222325ULL) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ p[i]) * 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// Hashes the big-endian bytes so digests agree between hosts of either byte order
+uint64_t hashWord(uint64_t value, uint64_t h) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+    }
+    return fnv1a(bytes, sizeof(bytes), h);
+}
+
+uint64_t hashText(const std::string& text, uint64_t h) {
+    return fnv1a(text.data(), text.size(), hashWord(text.size(), h));
+}
+
+uint64_t mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+void appendString(const std::string& text, std::vector<uint8_t>& out) {
+    utils::appendVarint(text.size(), out);
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+void appendWord(uint64_t value, std::vector<uint8_t>& out) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+uint64_t readWord(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+// Bounds-checked reads over a delta; each advances offset past what it read
+bool readVarint(const std::vector<uint8_t>& data, size_t& offset, uint64_t& value) {
+    size_t used = 0;
+    if (!utils::readVarint(data.data() + offset, data.size() - offset, value, &used)) {
+        return false;
+    }
+    offset += used;
+    return true;
+}
+
+bool readString(const std::vector<uint8_t>& data, size_t& offset, std::string& text) {
+    uint64_t length = 0;
+    if (!readVarint(data, offset, length) || length > data.size() - offset) {
+        return false;
+    }
+    text.assign(reinterpret_cast<const char*>(data.data() + offset), static_cast<size_t>(length));
+    offset += static_cast<size_t>(length);
+    return true;
+}
+
+} // namespace
+
+ReplicatedCapabilitySignaler::ReplicatedCapabilitySignaler(std::string nodeId, DeltaSink sink)
+    : nodeId_(std::move(nodeId)), sink_(std::move(sink)), local_(createInMemoryCapabilitySignaler()) {}
+
+ReplicatedCapabilitySignaler::~ReplicatedCapabilitySignaler() = default;
+
+ReplicatedCapabilitySignaler::ElementKey ReplicatedCapabilitySignaler::keyFor(
+    const std::string& agentId, const Capability& capability) {
+    ElementKey key;
+    key.reserve(agentId.size() + capability.name.size() + 16);
+    key += agentId;
+    key += '\0';
+    key += capability.name;
+    key += '\0';
+    key += capability.version.toString();
+    return key;
+}
+
+size_t ReplicatedCapabilitySignaler::bucketFor(const ElementKey& key) {
+    return static_cast<size_t>(mix(fnv1a(key.data(), key.size())) % BUCKET_COUNT);
+}
+
+uint64_t ReplicatedCapabilitySignaler::elementHash(const ElementKey& key, const Element& element) {
+    uint64_t h = hashText(key, 0xCBF29CE484222325ULL);
+    h = hashWord(element.present ? 1 : 0, h);
+    h = hashWord(element.stamp.time, h);
+    h = hashText(element.stamp.node, h);
+    for (const auto& [k, v] : element.capability.parameters) {
+        h = hashText(v, hashText(k, h));
+    }
+    return mix(h);
+}
+
+ReplicatedCapabilitySignaler::Element ReplicatedCapabilitySignaler::stampLocked(
+    const std::string& agentId, const Capability& capability, bool present) {
+    Element element;
+    element.agentId = agentId;
+    element.capability.name = capability.name;
+    element.capability.version = capability.version;
+    if (present) {
+        element.capability.parameters = capability.parameters;
+    }
+    element.present = present;
+    element.stamp = Stamp{++clock_, nodeId_};
+    return element;
+}
+
+bool ReplicatedCapabilitySignaler::mergeLocked(const ElementKey& key, Element element,
+                                               std::vector<LocalChange>& changes) {
+    clock_ = std::max(clock_, element.stamp.time);
+
+    Bucket& bucket = buckets_[bucketFor(key)];
+    auto it = bucket.elements.find(key);
+    const Element* previous = nullptr;
+    if (it != bucket.elements.end()) {
+        if (!(it->second.stamp < element.stamp)) {
+            return false;  // Already seen, or superseded
+        }
+        previous = &it->second;
+        bucket.hash ^= elementHash(key, *previous);
+    }
+
+    // Bring the local index in line with the winning state
+    bool wasPresent = previous && previous->present;
+    bool sameParameters = wasPresent && element.present &&
+                          previous->capability.parameters == element.capability.parameters;
+    if (wasPresent && !sameParameters) {
+        changes.push_back(LocalChange{false, {previous->agentId, previous->capability}});
+    }
+    if (element.present && !sameParameters) {
+        changes.push_back(LocalChange{true, {element.agentId, element.capability}});
+    }
+
+    bucket.hash ^= elementHash(key, element);
+    bucket.elements[key] = std::move(element);
+    return true;
+}
+
+void ReplicatedCapabilitySignaler::applyLocked(std::vector<LocalChange>& changes) {
+    // Runs of additions go to the local index as one batch; removals keep their place in the order
+    std::vector<CapabilityRegistration> additions;
+    for (auto& change : changes) {
+        if (change.add) {
+            additions.push_back(std::move(change.registration));
+            continue;
+        }
+        if (!additions.empty()) {
+            local_->registerCapabilities(additions);
+            additions.clear();
+        }
+        local_->unregisterCapability(change.registration.first, change.registration.second);
+    }
+    if (!additions.empty()) {
+        local_->registerCapabilities(additions);
+    }
+    changes.clear();
+}
+
+void ReplicatedCapabilitySignaler::encodeElement(const Element& element, std::vector<uint8_t>& out) {
+    appendString(element.agentId, out);
+    out.push_back(element.present ? 1 : 0);
+    utils::appendVarint(element.stamp.time, out);
+    appendString(element.stamp.node, out);
+    utils::serializeCapability(element.capability, out);
+}
+
+void ReplicatedCapabilitySignaler::publish(const std::vector<Element>& elements) {
+    if (!sink_ || elements.empty()) {
+        return;
+    }
+    std::vector<uint8_t> delta;
+    delta.push_back(DELTA_FORMAT_V1);
+    utils::appendVarint(elements.size(), delta);
+    for (const auto& element : elements) {
+        encodeElement(element, delta);
+    }
+    sink_(delta);
+}
+
+bool ReplicatedCapabilitySignaler::registerCapability(const std::string& agentId, const Capability& capability) {
+    return registerCapabilities(agentId, {capability}) == 1;
+}
+
+size_t ReplicatedCapabilitySignaler::registerCapabilities(const std::string& agentId,
+                                                          const std::vector<Capability>& capabilities) {
+    std::vector<CapabilityRegistration> registrations;
+    registrations.reserve(capabilities.size());
+    for (const auto& capability : capabilities) {
+        registrations.emplace_back(agentId, capability);
+    }
+    return registerCapabilities(registrations);
+}
+
+size_t ReplicatedCapabilitySignaler::registerCapabilities(const std::vector<CapabilityRegistration>& registrations) {
+    std::vector<Element> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<LocalChange> changes;
+        for (const auto& [agentId, capability] : registrations) {
+            if (agentId.empty() || capability.name.empty()) {
+                continue;
+            }
+            ElementKey key = keyFor(agentId, capability);
+            const auto& elements = buckets_[bucketFor(key)].elements;
+            auto it = elements.find(key);
+            if (it != elements.end() && it->second.present &&
+                it->second.capability.parameters == capability.parameters) {
+                continue;
+            }
+            Element element = stampLocked(agentId, capability, true);
+            mergeLocked(key, element, changes);
+            changed.push_back(std::move(element));
+        }
+        applyLocked(changes);
+    }
+    publish(changed);
+    return changed.size();
+}
+
+bool ReplicatedCapabilitySignaler::unregisterCapability(const std::string& agentId, const Capability& capability) {
+    std::vector<Element> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ElementKey key = keyFor(agentId, capability);
+        const auto& elements = buckets_[bucketFor(key)].elements;
+        auto it = elements.find(key);
+        if (it == elements.end() || !it->second.present) {
+            return false;
+        }
+        std::vector<LocalChange> changes;
+        Element element = stampLocked(agentId, capability, false);
+        mergeLocked(key, element, changes);
+        applyLocked(changes);
+        changed.push_back(std::move(element));
+    }
+    publish(changed);
+    return true;
+}
+
+size_t ReplicatedCapabilitySignaler::unregisterAgentBatch(const std::vector<std::string>& agentIds) {
+    std::vector<Element> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<LocalChange> changes;
+        for (const auto& agentId : agentIds) {
+            for (const auto& capability : local_->getAgentCapabilities(agentId)) {
+                ElementKey key = keyFor(agentId, capability);
+                Element element = stampLocked(agentId, capability, false);
+                mergeLocked(key, element, changes);
+                changed.push_back(std::move(element));
+            }
+        }
+        // The agents leave the local index in one update
+        changes.clear();
+        local_->unregisterAgentBatch(agentIds);
+    }
+    publish(changed);
+    return changed.size();
+}
+
+std::vector<std::string> ReplicatedCapabilitySignaler::discoverAgents(
+    const std::vector<Capability>& requiredCapabilities) {
+    return local_->discoverAgents(requiredCapabilities);
+}
+
+std::vector<std::string> ReplicatedCapabilitySignaler::discoverAgents(
+    const std::vector<Capability>& requiredCapabilities, bool partialMatch) {
+    return local_->discoverAgents(requiredCapabilities, partialMatch);
+}
+
+std::vector<Capability> ReplicatedCapabilitySignaler::getAgentCapabilities(const std::string& agentId) {
+    return local_->getAgentCapabilities(agentId);
+}
+
+bool ReplicatedCapabilitySignaler::registerCapabilityBinary(const std::string& agentId,
+                                                            const std::vector<uint8_t>& capabilityData) {
+    if (!capabilityData.empty() && capabilityData[0] == utils::CAPABILITY_SET_FORMAT_V1) {
+        std::vector<Capability> caps;
+        if (!utils::deserializeCapabilitySet(capabilityData.data(), capabilityData.size(), caps)) {
+            return false;
+        }
+        return registerCapabilities(agentId, caps) > 0;
+    }
+    Capability cap;
+    if (!utils::deserializeCapability(capabilityData.data(), capabilityData.size(), cap)) {
+        return false;
+    }
+    return registerCapability(agentId, cap);
+}
+
+std::vector<uint8_t> ReplicatedCapabilitySignaler::getAgentCapabilitiesBinary(const std::string& agentId) {
+    return local_->getAgentCapabilitiesBinary(agentId);
+}
+
+bool ReplicatedCapabilitySignaler::applyDelta(const std::vector<uint8_t>& delta) {
+    // Decode everything first so a malformed delta leaves no partial update
+    size_t offset = 1;
+    uint64_t count = 0;
+    if (delta.empty() || delta[0] != DELTA_FORMAT_V1 || !readVarint(delta, offset, count) ||
+        count > delta.size() - offset) {
+        return false;
+    }
+    std::vector<Element> elements(static_cast<size_t>(count));
+    for (auto& element : elements) {
+        uint64_t time = 0;
+        size_t used = 0;
+        if (!readString(delta, offset, element.agentId) || offset >= delta.size() || delta[offset] > 1) {
+            return false;
+        }
+        element.present = delta[offset++] == 1;
+        if (!readVarint(delta, offset, time) || !readString(delta, offset, element.stamp.node) ||
+            !utils::deserializeCapability(delta.data() + offset, delta.size() - offset, element.capability, &used) ||
+            element.agentId.empty() || element.capability.name.empty()) {
+            return false;
+        }
+        element.stamp.time = time;
+        offset += used;
+    }
+    if (offset != delta.size()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<LocalChange> changes;
+    for (auto& element : elements) {
+        ElementKey key = keyFor(element.agentId, element.capability);
+        mergeLocked(key, std::move(element), changes);
+    }
+    applyLocked(changes);
+    return true;
+}
+
+std::vector<uint8_t> ReplicatedCapabilitySignaler::digest() const {
+    std::vector<uint8_t> out;
+    out.reserve(DIGEST_SIZE);
+    out.push_back(DIGEST_FORMAT_V1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t root = 0xCBF29CE484222325ULL;
+    for (const auto& bucket : buckets_) {
+        root = hashWord(bucket.hash, root);
+    }
+    appendWord(mix(root), out);
+    for (const auto& bucket : buckets_) {
+        appendWord(bucket.hash, out);
+    }
+    return out;
+}
+
+std::vector<uint8_t> ReplicatedCapabilitySignaler::deltaForDigest(const std::vector<uint8_t>& peerDigest) const {
+    if (peerDigest.size() != DIGEST_SIZE || peerDigest[0] != DIGEST_FORMAT_V1 || peerDigest == digest()) {
+        return {};
+    }
+
+    std::vector<uint8_t> body;
+    uint64_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            if (readWord(peerDigest.data() + 9 + 8 * i) == buckets_[i].hash) {
+                continue;
+            }
+            for (const auto& entry : buckets_[i].elements) {
+                encodeElement(entry.second, body);
+                ++count;
+            }
+        }
+    }
+    if (count == 0) {
+        return {};
+    }
+
+    std::vector<uint8_t> delta;
+    delta.reserve(body.size() + 11);
+    delta.push_back(DELTA_FORMAT_V1);
+    utils::appendVarint(count, delta);
+    delta.insert(delta.end(), body.begin(), body.end());
+    return delta;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -4,10 +4,15 @@
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 #include <openssl/x509v3.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <thread>
 #include <stdexcept>
 #include <iostream>
+#include <sstream>
 
 namespace xenocomm {
 namespace core {
@@ -56,6 +61,26 @@ namespace {
         return static_cast<int>(read);
     }
 
+    void writeRecordHeader(uint8_t* out, uint64_t sequence, uint32_t length) {
+        for (int i = 0; i < 8; ++i) {
+            out[i] = static_cast<uint8_t>(sequence >> (56 - 8 * i));
+        }
+        for (int i = 0; i < 4; ++i) {
+            out[8 + i] = static_cast<uint8_t>(length >> (24 - 8 * i));
+        }
+    }
+
+    void readRecordHeader(const uint8_t* in, uint64_t& sequence, uint32_t& length) {
+        sequence = 0;
+        for (int i = 0; i < 8; ++i) {
+            sequence = (sequence << 8) | in[i];
+        }
+        length = 0;
+        for (int i = 0; i < 4; ++i) {
+            length = (length << 8) | in[8 + i];
+        }
+    }
+
     long bio_ctrl(BIO* bio, int cmd, long num, void* ptr) {
         switch (cmd) {
             case BIO_CTRL_FLUSH:
@@ -161,8 +186,9 @@ SecureTransportWrapper::SecureTransportWrapper(
       state_(ConnectionState::DISCONNECTED),
       last_error_(TransportError::NONE),
       is_handshake_complete_(false),
-      is_server_mode_(config_.expectedHostname.empty()),
-      bio_data_(std::make_unique<BIOData>()) {
+      is_server_mode_(config.expectedHostname.empty()),
+      bio_data_(std::make_unique<BIOData>()),
+      vectoredContext_(std::make_unique<VectoredIOContext>()) {
     
     BIO_set_data(bio_data_->bio, this);
     // SSL_set_app_data(security_manager_->getSSLHandleForContext(secure_context_.get()), this); // REMOVED: Incorrect call
@@ -179,12 +205,12 @@ SecureTransportWrapper::SecureTransportWrapper(
         throw std::runtime_error("Handshake failed during SecureTransportWrapper construction: " + handshakeResult.error());
     }
 
-    if (config_.securityConfig.recordBatching.enabled) {
+    if (config.securityConfig.recordBatching.enabled) {
         if (!initializeBatching().has_value()) {
             XLOG_WARN("Failed to initialize record batching.");
         }
     }
-    if (config_.securityConfig.adaptiveRecord.enabled) {
+    if (config.securityConfig.adaptiveRecord.enabled) {
         if (!initializeAdaptiveRecordSizing().has_value()) {
             XLOG_WARN("Failed to initialize adaptive record sizing.");
         }
@@ -198,14 +224,11 @@ SecureTransportWrapper::~SecureTransportWrapper() {
         BIO_free_all(bio_data_->bio);
         bio_data_->bio = nullptr;
     }
-    if (batchContext_ && batchContext_->batchThread.joinable()) {
-        batchContext_->shouldStop = true;
-        batchContext_->cv.notify_all();
-        batchContext_->batchThread.join();
-    }
+    stopBatching();
 }
 
 bool SecureTransportWrapper::connect(const std::string& endpoint, const ConnectionConfig& /* DONT USE: outerConfig */) {
+    const auto config = config_.read();
     if (state_ == ConnectionState::CONNECTED && is_handshake_complete_) {
         return true;
     }
@@ -214,8 +237,9 @@ bool SecureTransportWrapper::connect(const std::string& endpoint, const Connecti
     }
 
     updateConnectionState(ConnectionState::CONNECTING);
+    endpoint_ = endpoint;
 
-    if (!transport_->connect(endpoint, config_.connectionConfig)) {
+    if (!transport_->connect(endpoint, config->connectionConfig)) {
         handleSecurityError("Underlying transport failed to connect: " + transport_->getLastError());
         updateConnectionState(ConnectionState::ERROR);
         return false;
@@ -243,6 +267,23 @@ bool SecureTransportWrapper::connect(const std::string& endpoint, const Connecti
     return true;
 }
 
+bool SecureTransportWrapper::connectWithEarlyData(const std::string& endpoint, utils::ByteSpan request) {
+    const auto config = config_.read();
+    if (isConnected()) {
+        return send(request.data(), request.size()) == static_cast<ssize_t>(request.size());
+    }
+    early_data_out_.assign(request.begin(), request.end());
+    early_data_written_ = 0;
+    // The handshake sends whatever the server did not take as early data, or fails the connect
+    bool connected = connect(endpoint, config->connectionConfig);
+    early_data_out_.clear();
+    return connected;
+}
+
+bool SecureTransportWrapper::isSessionResumed() const {
+    return is_handshake_complete_ && secure_context_ && secure_context_->isSessionResumed();
+}
+
 bool SecureTransportWrapper::disconnect() {
     if (!isConnected() && state_ != ConnectionState::CONNECTING) {
         return true; // Already disconnected or not even trying to connect
@@ -251,16 +292,8 @@ bool SecureTransportWrapper::disconnect() {
     updateConnectionState(ConnectionState::DISCONNECTING);
     bool disconnect_success = true;
 
-    if (batchContext_ && batchContext_->batchThread.joinable()) {
-        batchContext_->shouldStop = true;
-        batchContext_->cv.notify_one();
-        try {
-            if(batchContext_->batchThread.joinable()) batchContext_->batchThread.join();
-        } catch (const std::system_error& e) {
-            // Log error if needed, but continue disconnecting
-            // Consider this a non-fatal issue for the disconnect process itself
-        }
-    }
+    // The batching thread sends whatever is still queued before it exits
+    stopBatching();
 
     if (secure_context_) {
         Result<void> shutdown_result = secure_context_->shutdown();
@@ -303,6 +336,31 @@ ssize_t SecureTransportWrapper::send(const uint8_t* data, size_t size) {
         handleSecurityError("Send attempt before handshake or no context");
         return -1;
     }
+    if (batchContext_) {
+        if (shouldBatchMessage(size) && enqueueBatched(data, size)) {
+            return static_cast<ssize_t>(size);
+        }
+        // Anything still queued was sent first, so it must reach the wire first
+        std::lock_guard<std::mutex> lock(batchContext_->flushMutex);
+        auto flushResult = processBatch(true);
+        if (!flushResult.has_value()) {
+            handleSecurityError(flushResult.error());
+            return -1;
+        }
+        return sendRecord(data, size);
+    }
+    return sendRecord(data, size);
+}
+
+ssize_t SecureTransportWrapper::sendRecord(const uint8_t* data, size_t size) {
+    if (offloadContext_) {
+        utils::ByteSpan part(data, size);
+        return sendOffloaded(&part, 1, true);
+    }
+    if (socket_attached_) {
+        utils::ByteSpan part(data, size);
+        return sendGathered(&part, 1);
+    }
     std::vector<uint8_t> plaintext(data, data + size);
     auto result = secure_context_->encrypt(plaintext);
     if (!result.has_value()) {
@@ -318,23 +376,39 @@ ssize_t SecureTransportWrapper::receive(uint8_t* buffer, size_t size) {
         handleSecurityError("Receive attempt before handshake or no context");
         return -1;
     }
-    std::vector<uint8_t> encrypted_data_buffer(size);
-    ssize_t bytes_read_from_transport = transport_->receive(encrypted_data_buffer.data(), encrypted_data_buffer.size());
+    if (!early_data_in_.empty()) {
+        // The client sent this ahead of the handshake, so it precedes the stream
+        size_t n = std::min(size, early_data_in_.size());
+        std::memcpy(buffer, early_data_in_.data(), n);
+        early_data_in_.erase(early_data_in_.begin(), early_data_in_.begin() + static_cast<std::ptrdiff_t>(n));
+        return static_cast<ssize_t>(n);
+    }
+    if (offloadContext_) {
+        return receiveOffloaded(buffer, size);
+    }
+    if (socket_attached_) {
+        // With kernel TLS receiving, the kernel has already decrypted what this reads
+        auto result = secure_context_->readFromSocket(utils::MutableByteSpan(buffer, size));
+        if (!result.has_value()) {
+            handleSecurityError("Receive failed: " + result.error());
+            return -1;
+        }
+        return static_cast<ssize_t>(result.value());
+    }
+    // Ciphertext lands in a pooled buffer and is decrypted straight into the caller's
+    utils::PooledBuffer ciphertext;
+    ssize_t bytes_read_from_transport = transport_->receiveBuffer(ciphertext, size);
     if (bytes_read_from_transport <= 0) {
         if (bytes_read_from_transport < 0) last_error_message_ = transport_->getLastError();
         return bytes_read_from_transport;
     }
-    encrypted_data_buffer.resize(bytes_read_from_transport);
 
-    auto result = secure_context_->decrypt(encrypted_data_buffer);
+    auto result = secure_context_->decryptInto(ciphertext.span(), utils::MutableByteSpan(buffer, size));
     if (!result.has_value()) {
         handleSecurityError("Decryption failed: " + result.error());
         return -1;
     }
-    const auto& plaintext = result.value();
-    size_t to_copy = std::min(size, plaintext.size());
-    std::memcpy(buffer, plaintext.data(), to_copy);
-    return static_cast<ssize_t>(to_copy);
+    return static_cast<ssize_t>(result.value());
 }
 
 bool SecureTransportWrapper::getPeerAddress(std::string& address, uint16_t& port) {
@@ -491,6 +565,7 @@ std::string SecureTransportWrapper::getSecurityLevel() const {
 }
 
 Result<void> SecureTransportWrapper::performHandshake() {
+    const auto config = config_.read();
     if (!secure_context_ || !transport_) {
         return Result<void>("Context or transport not initialized for handshake");
     }
@@ -498,13 +573,30 @@ Result<void> SecureTransportWrapper::performHandshake() {
         return Result<void>();
     }
 
-    if (config_.securityConfig.protocol == EncryptionProtocol::DTLS_1_2 || 
-        config_.securityConfig.protocol == EncryptionProtocol::DTLS_1_3) {
+    if (config->securityConfig.protocol == EncryptionProtocol::DTLS_1_2 || 
+        config->securityConfig.protocol == EncryptionProtocol::DTLS_1_3) {
         if (is_server_mode_) {
         } else {
         }
     }
 
+    const bool resuming = !is_server_mode_ && config->enableSessionResumption &&
+                          secure_context_->resumeSession(sessionKey());
+    if (resuming && !early_data_out_.empty() && config->securityConfig.enableEarlyData) {
+        auto written = secure_context_->writeEarlyData(utils::ByteSpan(early_data_out_.data(), early_data_out_.size()));
+        early_data_written_ = written.has_value() ? written.value() : 0;
+    }
+
+    if (config->securityConfig.kernelTls.enabled) {
+        auto attachResult = attachKernelTls();
+        if (!attachResult.has_value()) {
+            if (config->securityConfig.kernelTls.required) {
+                return attachResult;
+            }
+            XLOG_WARN("Kernel TLS unavailable, records stay in user space: {}", attachResult.error());
+        }
+    }
+
     is_handshake_complete_ = false;
     while (!is_handshake_complete_) {
         auto stepResult = secure_context_->doHandshakeStep();
@@ -518,11 +610,66 @@ Result<void> SecureTransportWrapper::performHandshake() {
     }
 
     negotiated_protocol_ = secure_context_->getNegotiatedProtocol();
-    XLOG_INFO("Handshake complete. Negotiated protocol: " + negotiated_protocol_);
+    XLOG_INFO("Handshake complete. Negotiated protocol: {}{}", negotiated_protocol_,
+              secure_context_->isSessionResumed() ? " (resumed)" : "");
+    if (is_server_mode_) {
+        early_data_in_ = secure_context_->takeEarlyData();
+    }
+    if (socket_attached_) {
+        auto kernelResult = checkKernelTls();
+        if (!kernelResult.has_value()) {
+            handleSecurityError(kernelResult.error());
+            return kernelResult;
+        }
+    }
+
+    if (config->securityConfig.cryptoOffload.enabled) {
+        // The peer expects offloaded records from here on, so there is no falling back
+        auto offloadResult = initializeCryptoOffload();
+        if (!offloadResult.has_value()) {
+            handleSecurityError("Crypto offload setup failed: " + offloadResult.error());
+            return Result<void>("Crypto offload setup failed: " + offloadResult.error());
+        }
+    }
     updateConnectionState(ConnectionState::CONNECTED);
+    return sendPendingEarlyData();
+}
+
+Result<std::shared_ptr<AeadRecordLayer>> SecureTransportWrapper::exportRecordLayer() {
+    if (!is_handshake_complete_ || !secure_context_) {
+        return Result<std::shared_ptr<AeadRecordLayer>>(std::string("Handshake not complete"));
+    }
+    return AeadRecordLayer::fromContext(*secure_context_);
+}
+
+Result<void> SecureTransportWrapper::sendPendingEarlyData() {
+    if (early_data_out_.empty()) {
+        return Result<void>();
+    }
+    // A rejected server discarded the early data, so all of it goes again; an accepting one wants the rest
+    size_t sent = secure_context_->isEarlyDataAccepted() ? early_data_written_ : 0;
+    std::vector<uint8_t> request = std::move(early_data_out_);
+    early_data_out_.clear();
+    early_data_written_ = 0;
+    if (sent < request.size() &&
+        send(request.data() + sent, request.size() - sent) != static_cast<ssize_t>(request.size() - sent)) {
+        return Result<void>("Failed to send request after handshake: " + last_error_message_);
+    }
     return Result<void>();
 }
 
+std::string SecureTransportWrapper::sessionKey() {
+    if (!endpoint_.empty()) {
+        return endpoint_;
+    }
+    std::string address;
+    uint16_t port = 0;
+    if (transport_->getPeerAddress(address, port)) {
+        return address + ":" + std::to_string(port);
+    }
+    return "";
+}
+
 Result<void> SecureTransportWrapper::setupSecureContext(bool isServer) {
     auto contextResult = security_manager_->createContext(isServer);
     if (!contextResult.has_value()) {
@@ -594,7 +741,8 @@ void SecureTransportWrapper::handleSecurityError(const std::string& operation) {
 }
 
 bool SecureTransportWrapper::verifyCertificateHostname(X509* cert) {
-    if (!config_.verifyHostname || config_.expectedHostname.empty()) {
+    const auto config = config_.read();
+    if (!config->verifyHostname || config->expectedHostname.empty()) {
         return true;
     }
     if (!cert) return false;
@@ -609,7 +757,7 @@ bool SecureTransportWrapper::verifyCertificateHostname(X509* cert) {
             if (name->type == GEN_DNS) {
                 const char* dns_name = reinterpret_cast<const char*>(
                     ASN1_STRING_get0_data(name->d.dNSName));
-                if (dns_name && config_.expectedHostname == dns_name) {
+                if (dns_name && config->expectedHostname == dns_name) {
                     result = true;
                     break;
                 }
@@ -624,7 +772,7 @@ bool SecureTransportWrapper::verifyCertificateHostname(X509* cert) {
             char common_name[256];
             if (X509_NAME_get_text_by_NID(subject_name, NID_commonName, 
                                         common_name, sizeof(common_name)) > 0) {
-                if (config_.expectedHostname == common_name) {
+                if (config->expectedHostname == common_name) {
                     result = true;
                 }
             }
@@ -635,7 +783,8 @@ bool SecureTransportWrapper::verifyCertificateHostname(X509* cert) {
 }
 
 Result<void> SecureTransportWrapper::handleSessionResumption() {
-    if (!config_.enableSessionResumption || !secure_context_) {
+    const auto config = config_.read();
+    if (!config->enableSessionResumption || !secure_context_) {
         return Result<void>();
     }
 
@@ -656,121 +805,381 @@ void SecureTransportWrapper::cleanupSecureContext() {
         handleSessionResumption();
         secure_context_.reset();
     }
+    offloadContext_.reset();
+    socket_attached_ = false;
+    kernel_tls_send_ = false;
+    kernel_tls_receive_ = false;
     is_handshake_complete_ = false;
     negotiated_protocol_.clear();
 }
 
 Result<void> SecureTransportWrapper::initializeBatching() {
-    if (!config_.securityConfig.recordBatching.enabled) {
+    const auto config = config_.read();
+    if (!config->securityConfig.recordBatching.enabled) {
         return Result<void>();
     }
 
-    batchContext_ = std::make_unique<BatchContext>();
-    batchContext_->batchThread = std::thread(&SecureTransportWrapper::batchingThread, this);
+    batchContext_ = std::make_unique<BatchContext>(config->securityConfig.recordBatching);
+    batchContext_->flushTask = utils::TaskScheduler::shared().add([this] { runBatchFlush(); });
     return Result<void>();
 }
 
-void SecureTransportWrapper::batchingThread() {
-    while (!batchContext_->shouldStop) {
-        bool shouldProcess = false;
-        {
-            std::unique_lock<std::mutex> lock(batchContext_->mutex);
-            if (batchContext_->messages.empty()) {
-                batchContext_->cv.wait_for(lock, 
-                    config_.securityConfig.recordBatching.maxDelay,
-                    [this] { return !batchContext_->messages.empty() || batchContext_->shouldStop; });
-                if (batchContext_->shouldStop) break;
-            }
-            
-            if (!batchContext_->messages.empty()) {
-                auto oldestMessage = batchContext_->messages.front().timestamp;
-                auto now = std::chrono::steady_clock::now();
-                shouldProcess = batchContext_->currentBatchSize >= config_.securityConfig.recordBatching.maxBatchSize ||
-                              batchContext_->messages.size() >= config_.securityConfig.recordBatching.maxMessagesPerBatch ||
-                              (now - oldestMessage) >= config_.securityConfig.recordBatching.maxDelay;
-            }
-        }
+void SecureTransportWrapper::stopBatching() {
+    if (!batchContext_ || batchContext_->flushTask == utils::TaskScheduler::INVALID_TASK) {
+        return;
+    }
+    utils::TaskScheduler::shared().cancel(batchContext_->flushTask);
+    batchContext_->flushTask = utils::TaskScheduler::INVALID_TASK;
 
-        if (shouldProcess) {
-            auto result = processBatch();
-            if (!result.has_value()) {
-                XLOG_ERROR("Error processing batch: " + result.error());
-            }
-        }
+    auto result = flushBatch();
+    if (!result.has_value()) {
+        XLOG_ERROR("Error flushing batch: {}", result.error());
     }
+}
+
+bool SecureTransportWrapper::enqueueBatched(const uint8_t* data, size_t size) {
+    const auto config = config_.read();
+    const auto& batching = config->securityConfig.recordBatching;
+    BatchContext& batch = *batchContext_;
 
-    flushBatch();
+    auto payload = utils::BufferPool::shared().acquire(size);
+    std::memcpy(payload.data(), data, size);
+    BatchDescriptor descriptor{payload.release(), std::chrono::steady_clock::now() + batching.maxDelay};
+    if (!batch.messages.try_push(descriptor)) {
+        utils::PooledBuffer::adopt(descriptor.payload);  // Ring full: the caller sends it directly
+        return false;
+    }
+    const size_t messages = batch.queuedMessages.fetch_add(1) + 1;
+    const size_t bytes = batch.queuedBytes.fetch_add(size) + size;
+
+    // The flush task publishes its state before re-checking these counters, so no wakeup is lost
+    const int state = batch.sleepState.load();
+    const bool wake = (state == BatchContext::IDLE) ||
+        (state == BatchContext::TIMED &&
+         (batch.sleepingBytes.load() + bytes >= batching.maxBatchSize ||
+          batch.sleepingMessages.load() + messages >= batching.maxMessagesPerBatch));
+    if (wake) {
+        utils::TaskScheduler::shared().runNow(batch.flushTask);
+    }
+    return true;
 }
 
-Result<void> SecureTransportWrapper::processBatch() {
-    std::vector<uint8_t> batchedData;
-    size_t totalSize = 0;
-    std::queue<BatchedMessage> currentBatch;
+void SecureTransportWrapper::runBatchFlush() {
+    const auto config = config_.read();
+    const auto& batching = config->securityConfig.recordBatching;
+    BatchContext& batch = *batchContext_;
+    auto& scheduler = utils::TaskScheduler::shared();
 
+    batch.sleepState = BatchContext::RUNNING;
+    size_t pendingBytes = 0;
+    size_t pendingMessages = 0;
+    std::chrono::steady_clock::time_point deadline;
     {
-        std::lock_guard<std::mutex> lock(batchContext_->mutex);
-        while (!batchContext_->messages.empty() && 
-               (totalSize + batchContext_->messages.front().data.size() <= config_.securityConfig.recordBatching.maxBatchSize) &&
-               currentBatch.size() < config_.securityConfig.recordBatching.maxMessagesPerBatch) {
-            
-            auto& msg = batchContext_->messages.front();
-            totalSize += msg.data.size();
-            currentBatch.push(std::move(msg));
-            batchContext_->messages.pop();
+        std::lock_guard<std::mutex> lock(batch.flushMutex);
+        auto result = processBatch(false);
+        if (!result.has_value()) {
+            XLOG_ERROR("Error processing batch: {}", result.error());
         }
-        batchContext_->currentBatchSize = 0;
+        pendingBytes = batch.record.size();
+        pendingMessages = batch.recordMessages;
+        deadline = batch.recordDeadline;
     }
 
-    if (currentBatch.empty()) {
-        return Result<void>();
+    if (pendingMessages == 0) {
+        batch.sleepState = BatchContext::IDLE;
+        if (batch.queuedMessages.load() > 0) {
+            scheduler.runNow(batch.flushTask);
+        }
+        return;
     }
-
-    batchedData.reserve(totalSize);
-    while (!currentBatch.empty()) {
-        auto& msg = currentBatch.front();
-        batchedData.insert(batchedData.end(), msg.data.begin(), msg.data.end());
-        currentBatch.pop();
+    // Run again exactly when the oldest message is due unless the record fills up first
+    batch.sleepingBytes = pendingBytes;
+    batch.sleepingMessages = pendingMessages;
+    batch.sleepState = BatchContext::TIMED;
+    if (pendingBytes + batch.queuedBytes.load() >= batching.maxBatchSize ||
+        pendingMessages + batch.queuedMessages.load() >= batching.maxMessagesPerBatch) {
+        scheduler.runNow(batch.flushTask);
+    } else {
+        scheduler.runBy(batch.flushTask, deadline);
     }
+}
 
-    if (batchedData.empty()) {
-        return Result<void>(); // Success, nothing to send
+Result<void> SecureTransportWrapper::processBatch(bool force) {
+    const auto config = config_.read();
+    const auto& batching = config->securityConfig.recordBatching;
+    BatchContext& batch = *batchContext_;
+    Result<void> result;
+
+    BatchDescriptor descriptor;
+    while (batch.messages.try_pop(descriptor)) {
+        auto payload = utils::PooledBuffer::adopt(descriptor.payload);
+        batch.queuedMessages.fetch_sub(1);
+        batch.queuedBytes.fetch_sub(payload.size());
+
+        if (!batch.record.empty() &&
+            (batch.record.size() + payload.size() > batching.maxBatchSize ||
+             batch.recordMessages >= batching.maxMessagesPerBatch)) {
+            auto sent = sendBatchRecord();
+            if (!sent.has_value() && result.has_value()) {
+                result = sent;
+            }
+        }
+        if (batch.recordMessages == 0) {
+            batch.recordDeadline = descriptor.deadline;
+        }
+        // Messages never exceed maxBatchSize, so the reserved record only grows after setConfig() changes it
+        batch.record.insert(batch.record.end(), payload.data(), payload.data() + payload.size());
+        ++batch.recordMessages;
+    }
+
+    const bool due = force ||
+        batch.record.size() >= batching.maxBatchSize ||
+        batch.recordMessages >= batching.maxMessagesPerBatch ||
+        std::chrono::steady_clock::now() >= batch.recordDeadline;
+    if (batch.recordMessages > 0 && due) {
+        auto sent = sendBatchRecord();
+        if (!sent.has_value() && result.has_value()) {
+            result = sent;
+        }
     }
+    return result;
+}
 
-    ssize_t bytes_sent = this->send(batchedData.data(), batchedData.size());
+Result<void> SecureTransportWrapper::sendBatchRecord() {
+    BatchContext& batch = *batchContext_;
+    ssize_t bytes_sent = sendRecord(batch.record.data(), batch.record.size());
+    const size_t expected = batch.record.size();
+    batch.record.clear();
+    batch.recordMessages = 0;
 
     if (bytes_sent < 0) {
-        // Error occurred
         return Result<void>(std::string("Failed to send batched data: ") + getLastError());
     }
-    if (static_cast<size_t>(bytes_sent) != batchedData.size()) {
-        // Not all data was sent
+    if (static_cast<size_t>(bytes_sent) != expected) {
         return Result<void>(std::string("Failed to send complete batched data: partial send"));
     }
-
-    // TODO: Update RTT samples if necessary
-
-    return Result<void>(); // Success
+    return Result<void>();
 }
 
 Result<void> SecureTransportWrapper::flushBatch() {
-    return processBatch();
+    std::lock_guard<std::mutex> lock(batchContext_->flushMutex);
+    return processBatch(true);
 }
 
 bool SecureTransportWrapper::shouldBatchMessage(size_t messageSize) const {
-    return config_.securityConfig.recordBatching.enabled &&
-           messageSize >= config_.securityConfig.recordBatching.minMessageSize;
+    const auto config = config_.read();
+    return config->securityConfig.recordBatching.enabled &&
+           messageSize >= config->securityConfig.recordBatching.minMessageSize &&
+           messageSize <= config->securityConfig.recordBatching.maxBatchSize;
+}
+
+Result<void> SecureTransportWrapper::initializeCryptoOffload() {
+    const auto config = config_.read();
+    auto layerResult = AeadRecordLayer::fromContext(*secure_context_);
+    if (!layerResult.has_value()) {
+        return Result<void>(layerResult.error());
+    }
+
+    auto offload = std::make_unique<OffloadContext>();
+    offload->layer = std::move(layerResult.value());
+    const size_t workers = config->securityConfig.cryptoOffload.workerThreads;
+    if (workers > 0) {
+        offload->ownedPool = std::make_unique<CryptoWorkerPool>(workers);
+        offload->pool = offload->ownedPool.get();
+    } else {
+        offload->pool = &CryptoWorkerPool::shared();
+    }
+    offloadContext_ = std::move(offload);
+    return Result<void>();
+}
+
+Result<void> SecureTransportWrapper::attachKernelTls() {
+    const auto config = config_.read();
+    // The kernel only takes over records on a socket the TLS engine writes itself
+    const bool datagram = config->securityConfig.protocol == EncryptionProtocol::DTLS_1_2 ||
+                          config->securityConfig.protocol == EncryptionProtocol::DTLS_1_3;
+    const int fd = transport_->getSocketFd();
+    if (datagram || fd < 0 || !transport_->isReliableStream()) {
+        return Result<void>(std::string("Kernel TLS needs a TLS stream socket"));
+    }
+    if (!secure_context_->attachSocket(fd)) {
+        return Result<void>(std::string("Secure context cannot run over a socket"));
+    }
+    socket_attached_ = true;
+    if (!secure_context_->enableKernelTls()) {
+        return Result<void>(std::string("TLS library was built without kernel TLS"));
+    }
+    return Result<void>();
+}
+
+Result<void> SecureTransportWrapper::checkKernelTls() {
+    const auto config = config_.read();
+    kernel_tls_send_ = secure_context_->kernelTlsSend();
+    kernel_tls_receive_ = secure_context_->kernelTlsReceive();
+    XLOG_INFO("Kernel TLS: send {}, receive {}", kernel_tls_send_ ? "on" : "off",
+              kernel_tls_receive_ ? "on" : "off");
+    if (config->securityConfig.kernelTls.required && !(kernel_tls_send_ && kernel_tls_receive_)) {
+        return Result<void>(std::string("Kernel declined TLS for ") +
+                            (kernel_tls_send_ ? "receiving" : kernel_tls_receive_ ? "sending" : "both directions"));
+    }
+    return Result<void>();
+}
+
+ssize_t SecureTransportWrapper::sendOffloaded(const utils::ByteSpan* parts, size_t count, bool pipelined) {
+    const auto config = config_.read();
+    size_t size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size += parts[i].size();
+    }
+    if (size == 0) {
+        return 0;
+    }
+    OffloadContext& offload = *offloadContext_;
+    const auto& offloadConfig = config->securityConfig.cryptoOffload;
+    const size_t recordSize = offloadConfig.recordSize;
+    const size_t recordCount = (size + recordSize - 1) / recordSize;
+
+    std::lock_guard<std::mutex> lock(offload.sendMutex);
+    // Sequence numbers are fixed before sealing starts, so records may finish in any order
+    const uint64_t firstSequence = offload.sendSequence;
+    offload.sendSequence += recordCount;
+
+    // Locate each record's first byte so records can be sealed independently
+    offload.recordStarts.resize(recordCount);
+    size_t part = 0;
+    size_t offset = 0;
+    for (size_t i = 0; i < recordCount; ++i) {
+        while (offset == parts[part].size()) {
+            ++part;
+            offset = 0;
+        }
+        offload.recordStarts[i] = {part, offset};
+        size_t remaining = std::min(recordSize, size - i * recordSize);
+        while (remaining > 0) {
+            size_t taken = std::min(remaining, parts[part].size() - offset);
+            remaining -= taken;
+            offset += taken;
+            if (remaining > 0) {
+                ++part;
+                offset = 0;
+            }
+        }
+    }
+    offload.records.clear();
+    offload.records.resize(recordCount);
+
+    std::function<bool(size_t)> seal = [&](size_t i) {
+        const size_t length = std::min(recordSize, size - i * recordSize);
+        auto record = utils::BufferPool::shared().acquire(OffloadContext::OVERHEAD + length);
+        writeRecordHeader(record.data(), firstSequence + i, static_cast<uint32_t>(length));
+        uint8_t* body = record.data() + OffloadContext::HEADER_SIZE;
+
+        // Each piece is encrypted straight from the caller's buffer into the record
+        auto sealer = offload.takeSealer();
+        bool sealed = sealer &&
+            sealer->begin(firstSequence + i, utils::ByteSpan(record.data(), OffloadContext::HEADER_SIZE));
+        size_t piece = offload.recordStarts[i].first;
+        size_t pieceOffset = offload.recordStarts[i].second;
+        for (size_t written = 0; sealed && written < length; ++piece, pieceOffset = 0) {
+            size_t taken = std::min(length - written, parts[piece].size() - pieceOffset);
+            sealed = sealer->update(utils::ByteSpan(parts[piece].data() + pieceOffset, taken), body + written);
+            written += taken;
+        }
+        sealed = sealed && sealer->finish(body + length);
+        offload.returnSealer(std::move(sealer));
+        offload.records[i] = std::move(record);
+        return sealed;
+    };
+    std::function<bool(size_t)> transmit = [&](size_t i) {
+        if (!pipelined) {
+            return true;  // Sent together below
+        }
+        utils::ByteSpan record = offload.records[i].span();
+        bool sent = transport_->sendFrame(&record, 1) >= 0;
+        offload.records[i].reset();
+        return sent;
+    };
+
+    bool ok = true;
+    if (size < offloadConfig.minParallelSize) {
+        for (size_t i = 0; ok && i < recordCount; ++i) {
+            ok = seal(i) && transmit(i);
+        }
+    } else {
+        ok = offload.pool->runOrdered(recordCount, seal, transmit);
+    }
+    if (ok && !pipelined) {
+        offload.frames.clear();
+        for (const auto& record : offload.records) {
+            offload.frames.push_back(record.span());
+        }
+        ok = transport_->sendFrames(offload.frames.data(), offload.frames.size()) >= 0;
+    }
+    offload.records.clear();
+    if (!ok) {
+        // Part of the write may be on the wire and its sequence numbers are spent
+        handleSecurityError("Failed to seal or send records: " + transport_->getLastError());
+        return -1;
+    }
+    return static_cast<ssize_t>(size);
+}
+
+ssize_t SecureTransportWrapper::receiveOffloaded(uint8_t* buffer, size_t size) {
+    OffloadContext& offload = *offloadContext_;
+    std::lock_guard<std::mutex> lock(offload.receiveMutex);
+
+    if (offload.pending.empty()) {
+        utils::PooledBuffer record;
+        ssize_t received = transport_->receiveFrame(record);
+        if (received <= 0) {
+            if (received < 0) last_error_message_ = transport_->getLastError();
+            return received;
+        }
+
+        uint64_t sequence = 0;
+        uint32_t length = 0;
+        if (record.size() < OffloadContext::OVERHEAD) {
+            handleSecurityError("Received a truncated record");
+            return -1;
+        }
+        readRecordHeader(record.data(), sequence, length);
+        if (length != record.size() - OffloadContext::OVERHEAD || sequence != offload.receiveSequence) {
+            handleSecurityError("Received a record out of sequence or with a bad length");
+            return -1;
+        }
+        uint8_t* body = record.data() + OffloadContext::HEADER_SIZE;
+        if (!offload.layer->open(sequence, utils::ByteSpan(record.data(), OffloadContext::HEADER_SIZE),
+                                 utils::MutableByteSpan(body, length), body + length)) {
+            handleSecurityError("Record failed authentication");
+            return -1;
+        }
+        ++offload.receiveSequence;
+        offload.pending = record.slice(OffloadContext::HEADER_SIZE, length);
+    }
+
+    // A record larger than the caller's buffer is handed out over several calls
+    const size_t copied = std::min(size, offload.pending.size());
+    std::memcpy(buffer, offload.pending.data(), copied);
+    if (copied == offload.pending.size()) {
+        offload.pending.reset();
+    } else {
+        offload.pending = offload.pending.slice(copied);
+    }
+    return static_cast<ssize_t>(copied);
 }
 
 Result<void> SecureTransportWrapper::initializeAdaptiveRecordSizing() {
-    if (!config_.securityConfig.adaptiveRecord.enabled) {
+    const auto config = config_.read();
+    if (!config->securityConfig.adaptiveRecord.enabled) {
         return Result<void>();
     }
 
-    adaptiveContext_ = std::make_unique<AdaptiveRecordContext>(config_.securityConfig.adaptiveRecord);
+    adaptiveContext_ = std::make_unique<AdaptiveRecordContext>(config->securityConfig.adaptiveRecord);
     return Result<void>();
 }
 
 std::chrono::microseconds SecureTransportWrapper::calculateAverageRTT() const {
+    const auto config = config_.read();
     if (!adaptiveContext_ || adaptiveContext_->rttSamples.empty()) {
         return std::chrono::microseconds(0);
     }
@@ -781,7 +1190,7 @@ std::chrono::microseconds SecureTransportWrapper::calculateAverageRTT() const {
     size_t count = 0;
     
     auto now = std::chrono::steady_clock::now();
-    auto windowStart = now - config_.securityConfig.adaptiveRecord.rttWindow;
+    auto windowStart = now - config->securityConfig.adaptiveRecord.rttWindow;
     
     for (const auto& sample : adaptiveContext_->rttSamples) {
         if (sample.sendTime >= windowStart) {
@@ -794,6 +1203,7 @@ std::chrono::microseconds SecureTransportWrapper::calculateAverageRTT() const {
 }
 
 bool SecureTransportWrapper::shouldAdjustRecordSize() const {
+    const auto config = config_.read();
     if (!adaptiveContext_) {
         return false;
     }
@@ -802,10 +1212,11 @@ bool SecureTransportWrapper::shouldAdjustRecordSize() const {
     
     return !adaptiveContext_->rttSamples.empty() &&
            (std::chrono::steady_clock::now() - adaptiveContext_->lastAdjustment) >= 
-           config_.securityConfig.adaptiveRecord.rttWindow;
+           config->securityConfig.adaptiveRecord.rttWindow;
 }
 
 void SecureTransportWrapper::adjustRecordSize(std::chrono::microseconds avgRTT) {
+    const auto config = config_.read();
     if (!adaptiveContext_) {
         return;
     }
@@ -823,13 +1234,13 @@ void SecureTransportWrapper::adjustRecordSize(std::chrono::microseconds avgRTT)
     size_t newSize = adaptiveContext_->currentRecordSize;
     
     if (rttRatio < 1.1f) {
-        newSize = static_cast<size_t>(newSize * config_.securityConfig.adaptiveRecord.growthFactor);
+        newSize = static_cast<size_t>(newSize * config->securityConfig.adaptiveRecord.growthFactor);
     } else if (rttRatio > 1.5f) {
-        newSize = static_cast<size_t>(newSize * config_.securityConfig.adaptiveRecord.shrinkFactor);
+        newSize = static_cast<size_t>(newSize * config->securityConfig.adaptiveRecord.shrinkFactor);
     }
     
-    newSize = std::max(config_.securityConfig.adaptiveRecord.minSize,
-                      std::min(newSize, config_.securityConfig.adaptiveRecord.maxSize));
+    newSize = std::max(config->securityConfig.adaptiveRecord.minSize,
+                      std::min(newSize, config->securityConfig.adaptiveRecord.maxSize));
     
     adaptiveContext_->currentRecordSize = newSize;
     adaptiveContext_->lastAdjustment = std::chrono::steady_clock::now();
@@ -844,100 +1255,146 @@ void SecureTransportWrapper::updateRecordSize() {
     }
 }
 
-Result<void> SecureTransportWrapper::sendv(const std::vector<std::vector<uint8_t>>& buffers) {
-    if (buffers.empty()) {
-        return Result<void>(); // Success with default constructor
-    }
-
-    // Check if we should use optimized vectored I/O
-    if (shouldUseVectoredIO(buffers)) {
-        return processVectoredIO(buffers);
+ssize_t SecureTransportWrapper::sendv(const utils::ByteSpan* buffers, size_t count) {
+    if (!is_handshake_complete_ || !secure_context_) {
+        handleSecurityError("Send attempt before handshake or no context");
+        return -1;
     }
-
-    // Fall back to regular send for small or single buffers
-    for (const auto& buffer : buffers) {
-        if (!buffer.empty()) {
-            ssize_t sent = send(buffer.data(), buffer.size());
-            if (sent < 0 || static_cast<size_t>(sent) != buffer.size()) {
-                return Result<void>("Failed to send buffer data: " + getLastError());
-            }
+    if (batchContext_) {
+        // Anything still queued was sent first, so it must reach the wire first
+        std::lock_guard<std::mutex> lock(batchContext_->flushMutex);
+        auto flushResult = processBatch(true);
+        if (!flushResult.has_value()) {
+            handleSecurityError(flushResult.error());
+            return -1;
         }
+        return sendGathered(buffers, count);
     }
+    return sendGathered(buffers, count);
+}
 
+Result<void> SecureTransportWrapper::sendv(const std::vector<std::vector<uint8_t>>& buffers) {
+    std::vector<utils::ByteSpan> spans(buffers.begin(), buffers.end());
+    if (sendv(spans.data(), spans.size()) < 0) {
+        return Result<void>("Failed to send buffer data: " + getLastError());
+    }
     return Result<void>(); // Success with default constructor
 }
 
-bool SecureTransportWrapper::shouldUseVectoredIO(const std::vector<std::vector<uint8_t>>& buffers) const {
-    // Use vectored I/O if we have multiple buffers and total size is significant
-    if (buffers.size() <= 1) {
-        return false;
+ssize_t SecureTransportWrapper::sendFile(int fd, int64_t offset, size_t size) {
+    if (!is_handshake_complete_ || !secure_context_) {
+        handleSecurityError("Send attempt before handshake or no context");
+        return -1;
     }
-
-    // Calculate total size
-    size_t totalSize = 0;
-    for (const auto& buffer : buffers) {
-        totalSize += buffer.size();
+    std::unique_lock<std::mutex> batchLock;
+    if (batchContext_) {
+        // Anything still queued was sent first, so it must reach the wire first
+        batchLock = std::unique_lock<std::mutex>(batchContext_->flushMutex);
+        auto flushResult = processBatch(true);
+        if (!flushResult.has_value()) {
+            handleSecurityError(flushResult.error());
+            return -1;
+        }
     }
-
-    // Only use vectored I/O for larger transfers
-    return totalSize > 8192;  // Threshold for using optimized path (8KB)
-}
-
-Result<void> SecureTransportWrapper::processVectoredIO(const std::vector<std::vector<uint8_t>>& buffers) {
-    // Encrypt each buffer
-    std::vector<std::vector<uint8_t>> encryptedBuffers;
-    encryptedBuffers.reserve(buffers.size());
-
-    for (const auto& buffer : buffers) {
-        if (buffer.empty()) {
-            continue;
+    if (kernel_tls_send_) {
+        auto result = secure_context_->sendFile(fd, offset, size);
+        if (!result.has_value()) {
+            handleSecurityError("Failed to send file: " + result.error());
+            return -1;
         }
-
-        // TODO: Implement actual encryption of each buffer
-        // For now, just copy the buffer as a placeholder
-        encryptedBuffers.push_back(buffer);
+        return static_cast<ssize_t>(result.value());
     }
 
-    // Send using vectored I/O
-    return sendEncryptedv(encryptedBuffers);
+    std::vector<uint8_t> chunk(std::min<size_t>(size, 4 * VectoredIOContext::MAX_RECORD_PLAINTEXT));
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = ::pread(fd, chunk.data(), std::min(chunk.size(), size - sent),
+                            static_cast<off_t>(offset + static_cast<int64_t>(sent)));
+        if (n < 0) {
+            handleSecurityError(std::string("Failed to read file: ") + std::strerror(errno));
+            return -1;
+        }
+        if (n == 0) {
+            break;  // The file ends before size bytes
+        }
+        if (sendRecord(chunk.data(), static_cast<size_t>(n)) != n) {
+            return -1;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(sent);
 }
 
-Result<void> SecureTransportWrapper::sendEncryptedv(const std::vector<std::vector<uint8_t>>& buffers) {
-    // Lazy initialize vectored I/O context if needed
-    if (!vectoredContext_) {
-        vectoredContext_ = std::make_unique<VectoredIOContext>();
+ssize_t SecureTransportWrapper::sendGathered(const utils::ByteSpan* buffers, size_t count) {
+    if (offloadContext_) {
+        return sendOffloaded(buffers, count, false);
     }
-
-    vectoredContext_->reset();
-    vectoredContext_->encryptedBuffers = buffers;
-
-    // Prepare iovec structures
-    size_t iovCount = std::min(buffers.size(), vectoredContext_->iovecs.size());
-    for (size_t i = 0; i < iovCount; i++) {
-        auto& buffer = buffers[i];
-        if (!buffer.empty()) {
-            vectoredContext_->iovecs[i].iov_base = const_cast<uint8_t*>(buffer.data());
-            vectoredContext_->iovecs[i].iov_len = buffer.size();
+    if (kernel_tls_send_) {
+        // The kernel cuts what is written to the socket into records, so the buffers go out as they are
+        ssize_t sent = transport_->sendv(buffers, count);
+        if (sent < 0) {
+            handleSecurityError("Failed to send: " + transport_->getLastError());
         }
-    }
-
-    // Call writev on the underlying transport
-    // Since we don't have direct access to writev in the Transport interface,
-    // we'll use individual sends for now
-    for (size_t i = 0; i < iovCount; i++) {
-        auto& iov = vectoredContext_->iovecs[i];
-        if (iov.iov_base && iov.iov_len > 0) {
-            ssize_t sent = transport_->send(
-                static_cast<const uint8_t*>(iov.iov_base), 
-                iov.iov_len);
-                
-            if (sent < 0 || static_cast<size_t>(sent) != iov.iov_len) {
-                return Result<void>("Failed to send in vectored I/O: " + transport_->getLastError());
+        return sent;
+    }
+
+    // SSL_write takes one buffer per record, so small buffers are packed into full records
+    VectoredIOContext& vectored = *vectoredContext_;
+    std::lock_guard<std::mutex> lock(vectored.mutex);
+    vectored.reset();
+    size_t total = 0;
+    auto sealRecord = [&]() {
+        if (socket_attached_) {
+            // The TLS engine seals and sends in one go
+            auto written = secure_context_->writeToSocket(utils::ByteSpan(vectored.plaintext));
+            if (!written.has_value()) {
+                handleSecurityError("Send failed: " + written.error());
+                return false;
             }
+            vectored.plaintext.clear();
+            return true;
         }
+        auto result = secure_context_->encrypt(vectored.plaintext);
+        if (!result.has_value()) {
+            handleSecurityError("Encryption failed: " + result.error());
+            return false;
+        }
+        vectored.encryptedBuffers.push_back(std::move(result.value()));
+        vectored.plaintext.clear();
+        return true;
+    };
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* data = buffers[i].data();
+        size_t remaining = buffers[i].size();
+        total += remaining;
+        while (remaining > 0) {
+            size_t taken = std::min(remaining, VectoredIOContext::MAX_RECORD_PLAINTEXT - vectored.plaintext.size());
+            vectored.plaintext.insert(vectored.plaintext.end(), data, data + taken);
+            data += taken;
+            remaining -= taken;
+            if (vectored.plaintext.size() == VectoredIOContext::MAX_RECORD_PLAINTEXT && !sealRecord()) {
+                return -1;
+            }
+        }
+    }
+    if (!vectored.plaintext.empty() && !sealRecord()) {
+        return -1;
+    }
+    if (socket_attached_) {
+        return static_cast<ssize_t>(total);
+    }
+    if (vectored.encryptedBuffers.empty()) {
+        return 0;
     }
 
-    return Result<void>(); // Success with default constructor
+    for (const auto& ciphertext : vectored.encryptedBuffers) {
+        vectored.spans.emplace_back(ciphertext);
+    }
+    if (transport_->sendv(vectored.spans.data(), vectored.spans.size()) < 0) {
+        handleSecurityError("Failed to send in vectored I/O: " + transport_->getLastError());
+        return -1;
+    }
+    return static_cast<ssize_t>(total);
 }
 
 } // namespace core
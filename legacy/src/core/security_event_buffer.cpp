@@ -0,0 +1,80 @@
+#include "xenocomm/core/security_event_buffer.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace xenocomm {
+namespace core {
+
+SecurityEventBuffer::SecurityEventBuffer(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)), slots_(new Slot[capacity_]) {
+    for (auto& index : typeIndex_) {
+        index.reset(new std::atomic<uint64_t>[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i) {
+            index[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void SecurityEventBuffer::record(const SecurityEvent& event) {
+    // The copy is made, and the overwritten event freed, outside the slot's lock
+    SecurityEvent copy = event;
+    const uint64_t sequence = next_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[sequence % capacity_];
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        // Unless lapped by a writer a whole buffer ahead, whose newer event stays
+        if (slot.sequence < sequence + 1) {
+            slot.sequence = sequence + 1;
+            std::swap(slot.event, copy);
+        }
+    }
+    const size_t type = static_cast<size_t>(event.type);
+    const uint64_t position = typeCounts_[type].fetch_add(1, std::memory_order_relaxed);
+    typeIndex_[type][position % capacity_].store(sequence + 1, std::memory_order_release);
+}
+
+std::vector<SecurityEvent> SecurityEventBuffer::recent(size_t maxEvents,
+                                                       std::optional<SecurityEventType> type) const {
+    std::vector<SecurityEvent> events;
+    const uint64_t end = next_.load(std::memory_order_acquire);
+    const uint64_t oldest = end > capacity_ ? end - capacity_ : 0;  // Older events are overwritten
+    events.reserve(std::min<uint64_t>(maxEvents, end - oldest));
+
+    if (!type) {
+        for (uint64_t sequence = end; sequence > oldest && events.size() < maxEvents; --sequence) {
+            read(sequence - 1, type, events);
+        }
+        return events;
+    }
+
+    const size_t index = static_cast<size_t>(*type);
+    const uint64_t count = typeCounts_[index].load(std::memory_order_acquire);
+    const uint64_t first = count > capacity_ ? count - capacity_ : 0;
+    uint64_t previous = UINT64_MAX;
+    for (uint64_t position = count; position > first && events.size() < maxEvents; --position) {
+        const uint64_t entry = typeIndex_[index][(position - 1) % capacity_].load(std::memory_order_acquire);
+        if (entry == 0 || entry - 1 >= previous) {
+            continue;  // Not written yet, or overwritten by a later position since count was read
+        }
+        if (entry - 1 < oldest) {
+            break;
+        }
+        previous = entry - 1;
+        read(entry - 1, type, events);
+    }
+    return events;
+}
+
+bool SecurityEventBuffer::read(uint64_t sequence, std::optional<SecurityEventType> type,
+                               std::vector<SecurityEvent>& out) const {
+    const Slot& slot = slots_[sequence % capacity_];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.sequence != sequence + 1 || (type && slot.event.type != *type)) {
+        return false;
+    }
+    out.push_back(slot.event);
+    return true;
+}
+
+} // namespace core
+} // namespace xenocomm
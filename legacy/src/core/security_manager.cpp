@@ -17,7 +17,9 @@
 // ============================================================================
 
 #include "xenocomm/core/security_manager.h"
+#include "xenocomm/core/session_cache.hpp"
 #include "xenocomm/utils/logging.hpp"
+#include "xenocomm/utils/hmac.hpp"
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <openssl/x509.h>
@@ -25,14 +27,16 @@
 #include <openssl/rand.h>
 #include <openssl/hmac.h>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <openssl/evp.h>
 #include <openssl/dh.h>
 #include <openssl/ec.h>
-#include <iomanip>
-#include <fstream>
-#include <filesystem>
 #include <thread>
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <unordered_map>
 
 namespace xenocomm {
 namespace core {
@@ -89,6 +93,12 @@ namespace {
         }
     }
 
+    // SSL ex_data slot pointing each SSL back to its OpenSSLContext
+    int contextIndex() {
+        static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        return index;
+    }
+
     // Convert our cipher suite enum to OpenSSL cipher string
     const char* getCipherString(CipherSuite suite) {
         switch (suite) {
@@ -106,7 +116,9 @@ namespace {
 
 // Pimpl struct for OpenSSL data
 struct SecurityManager::SSLData {
-    SSL_CTX* ctx = nullptr;
+    // Shared with other managers of the same settings; null until the first connection needs it.
+    // Pooled and leased contexts hold their own references to it.
+    std::shared_ptr<SSL_CTX> ctx;
     std::mutex mutex;
     std::vector<SSL*> sslPool;
     EVP_PKEY* privateKey = nullptr;
@@ -114,6 +126,91 @@ struct SecurityManager::SSLData {
     X509_STORE* trustStore = nullptr;
 };
 
+// Idle contexts ready for handshakes. Leased contexts hold a weak reference
+// and come back here when their last owner lets go.
+struct SecurityManager::ContextPool {
+    std::mutex mutex;
+    std::deque<std::unique_ptr<SecureContext>> idle[2];  // Indexed by isServer
+    size_t maxIdle{0};
+    uint64_t generation{0};  // Bumped whenever the SSL_CTX is rebuilt; older contexts are dropped
+    std::atomic<size_t> leased{0};
+};
+
+namespace {
+
+struct CookieKey {
+    uint32_t bucket = 0;
+    bool live = false;
+    utils::HmacSha256 mac;
+};
+
+constexpr size_t COOKIE_TAG_OFFSET = 4;
+
+uint32_t cookieBucket(std::chrono::seconds lifetime) {
+    const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+    return static_cast<uint32_t>(now.count() / std::max<int64_t>(lifetime.count(), 1));
+}
+
+bool makeCookieKey(uint32_t bucket, CookieKey& key) {
+    uint8_t secret[utils::HmacSha256::DIGEST_SIZE];
+    if (RAND_bytes(secret, sizeof(secret)) != 1) {
+        return false;
+    }
+    try {
+        key.mac = utils::HmacSha256(utils::ByteSpan(secret, sizeof(secret)));
+    } catch (const std::runtime_error&) {
+        OPENSSL_cleanse(secret, sizeof(secret));
+        return false;
+    }
+    OPENSSL_cleanse(secret, sizeof(secret));
+    key.bucket = bucket;
+    key.live = true;
+    return true;
+}
+
+// Writes the cookie's MAC over its bucket and the client's address, in binary where it parses
+bool cookieTag(const CookieKey& key, uint32_t bucket, const NetworkAddress& client, uint8_t* tag) {
+    uint8_t header[6] = {static_cast<uint8_t>(bucket), static_cast<uint8_t>(bucket >> 8),
+                         static_cast<uint8_t>(bucket >> 16), static_cast<uint8_t>(bucket >> 24),
+                         static_cast<uint8_t>(client.port >> 8), static_cast<uint8_t>(client.port)};
+    uint8_t binary[16];
+    utils::ByteSpan address(reinterpret_cast<const uint8_t*>(client.ip.data()), client.ip.size());
+    if (inet_pton(AF_INET, client.ip.c_str(), binary) == 1) {
+        address = utils::ByteSpan(binary, 4);
+    } else if (inet_pton(AF_INET6, client.ip.c_str(), binary) == 1) {
+        address = utils::ByteSpan(binary, 16);
+    }
+
+    uint8_t digest[utils::HmacSha256::DIGEST_SIZE];
+    if (!key.mac.mac({utils::ByteSpan(header, sizeof(header)), address}, digest)) {
+        return false;
+    }
+    std::memcpy(tag, digest, SecurityManager::DTLS_COOKIE_SIZE - COOKIE_TAG_OFFSET);
+    return true;
+}
+
+} // namespace
+
+// Keys of the current cookie bucket and the one before, indexed by bucket parity
+struct SecurityManager::CookieKeys {
+    mutable std::shared_mutex mutex;
+    CookieKey keys[2];
+    std::atomic<int64_t> lifetimeSeconds{300};
+
+    // The key of bucket if it is live; the caller holds mutex while using it
+    const CookieKey* find(uint32_t bucket) const {
+        const CookieKey& candidate = keys[bucket & 1];
+        return candidate.live && candidate.bucket == bucket ? &candidate : nullptr;
+    }
+
+    void clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        keys[0].live = false;
+        keys[1].live = false;
+    }
+};
+
 // Concrete implementation of SecureContext using OpenSSL
 class OpenSSLContext : public SecureContext {
 public:
@@ -122,6 +219,12 @@ public:
         if (!ssl_) {
             throw std::runtime_error("Failed to create SSL object: " + getOpenSSLError());
         }
+        SSL_set_ex_data(ssl_, contextIndex(), this);
+        if (isServer_) {
+            SSL_set_accept_state(ssl_);
+        } else {
+            SSL_set_connect_state(ssl_);
+        }
     }
 
     ~OpenSSLContext() {
@@ -130,6 +233,165 @@ public:
         }
     }
 
+    // Called by OpenSSL for every session or ticket the server issues on this connection
+    static int onNewSession(SSL* ssl, SSL_SESSION* session) {
+        auto* self = static_cast<OpenSSLContext*>(SSL_get_ex_data(ssl, contextIndex()));
+        if (!self || self->isServer_ || self->sessionKey_.empty()) {
+            return 0;
+        }
+        SessionCache::shared().store(self->sessionKey_, session);
+        return 1;  // The cache now holds OpenSSL's reference
+    }
+
+    bool resumeSession(const std::string& endpoint) override {
+        if (!ssl_ || isServer_ || endpoint.empty()) {
+            return false;
+        }
+        sessionKey_ = endpoint;
+        SSL_SESSION* session = SessionCache::shared().take(endpoint);
+        if (!session) {
+            return false;
+        }
+        bool offered = SSL_set_session(ssl_, session) == 1;
+        SSL_SESSION_free(session);
+        return offered;
+    }
+
+    bool isSessionResumed() const override {
+        return ssl_ && SSL_is_init_finished(ssl_) && SSL_session_reused(ssl_) == 1;
+    }
+
+    Result<size_t> writeEarlyData(utils::ByteSpan data) override {
+        if (!ssl_ || isServer_) {
+            return Result<size_t>(std::string("Early data is written by clients only"));
+        }
+        SSL_SESSION* session = SSL_get_session(ssl_);
+        if (!session || SSL_SESSION_get_max_early_data(session) == 0) {
+            return Result<size_t>(std::string("Session does not allow early data"));
+        }
+        size_t limit = std::min<size_t>(data.size(), SSL_SESSION_get_max_early_data(session));
+        size_t written = 0;
+        if (SSL_write_early_data(ssl_, data.data(), limit, &written) != 1) {
+            int err = SSL_get_error(ssl_, 0);
+            if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+                return Result<size_t>(static_cast<size_t>(0));
+            }
+            return Result<size_t>(std::string("Failed to write early data: ") + getOpenSSLError());
+        }
+        return Result<size_t>(written);
+    }
+
+    bool isEarlyDataAccepted() const override {
+        return ssl_ && SSL_get_early_data_status(ssl_) == SSL_EARLY_DATA_ACCEPTED;
+    }
+
+    std::vector<uint8_t> takeEarlyData() override {
+        return std::move(earlyData_);
+    }
+
+    bool attachSocket(int fd) override {
+        return ssl_ && SSL_set_fd(ssl_, fd) == 1;
+    }
+
+    bool handshakeWantsWrite() const override {
+        return wantsWrite_;
+    }
+
+    bool enableKernelTls() override {
+#ifdef SSL_OP_ENABLE_KTLS
+        if (!ssl_ || SSL_is_init_finished(ssl_)) {
+            return false;
+        }
+        SSL_set_options(ssl_, SSL_OP_ENABLE_KTLS);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool kernelTlsSend() const override {
+        BIO* bio = ssl_ ? SSL_get_wbio(ssl_) : nullptr;
+        return bio && BIO_get_ktls_send(bio);
+    }
+
+    bool kernelTlsReceive() const override {
+        BIO* bio = ssl_ ? SSL_get_rbio(ssl_) : nullptr;
+        return bio && BIO_get_ktls_recv(bio);
+    }
+
+    Result<size_t> writeToSocket(utils::ByteSpan data) override {
+        if (!ssl_ || !SSL_is_init_finished(ssl_)) {
+            return Result<size_t>(std::string("SSL not ready for writing"));
+        }
+        size_t written = 0;
+        while (written < data.size()) {
+            size_t n = 0;
+            if (SSL_write_ex(ssl_, data.data() + written, data.size() - written, &n) != 1) {
+                return Result<size_t>(std::string("SSL_write failed: ") + getOpenSSLError());
+            }
+            written += n;
+        }
+        return Result<size_t>(written);
+    }
+
+    Result<size_t> readFromSocket(utils::MutableByteSpan out) override {
+        if (!ssl_ || !SSL_is_init_finished(ssl_)) {
+            return Result<size_t>(std::string("SSL not ready for reading"));
+        }
+        size_t read = 0;
+        if (SSL_read_ex(ssl_, out.data(), out.size(), &read) != 1) {
+            if (SSL_get_error(ssl_, 0) == SSL_ERROR_ZERO_RETURN) {
+                return Result<size_t>(static_cast<size_t>(0));
+            }
+            return Result<size_t>(std::string("SSL_read failed: ") + getOpenSSLError());
+        }
+        return Result<size_t>(read);
+    }
+
+    Result<size_t> sendFile(int fd, int64_t offset, size_t size) override {
+#ifdef SSL_OP_ENABLE_KTLS
+        if (!kernelTlsSend()) {
+            return Result<size_t>(std::string("sendfile needs kernel TLS"));
+        }
+        size_t sent = 0;
+        while (sent < size) {
+            ossl_ssize_t n = SSL_sendfile(ssl_, fd, static_cast<off_t>(offset + static_cast<int64_t>(sent)),
+                                          size - sent, 0);
+            if (n <= 0) {
+                return Result<size_t>(std::string("SSL_sendfile failed: ") + getOpenSSLError());
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return Result<size_t>(sent);
+#else
+        return SecureContext::sendFile(fd, offset, size);
+#endif
+    }
+
+    bool reset() override {
+        if (!ssl_) {
+            return false;
+        }
+        SSL_set_bio(ssl_, nullptr, nullptr);  // Frees the socket BIO; the socket itself stays open
+        SSL_set_session(ssl_, nullptr);       // The next connection may go to another endpoint
+#ifdef SSL_OP_ENABLE_KTLS
+        SSL_clear_options(ssl_, SSL_OP_ENABLE_KTLS);  // Each connection asks for kernel TLS anew
+#endif
+        if (SSL_clear(ssl_) != 1) {
+            return false;
+        }
+        if (isServer_) {
+            SSL_set_accept_state(ssl_);
+        } else {
+            SSL_set_connect_state(ssl_);
+        }
+        sessionKey_.clear();
+        earlyData_.clear();
+        earlyDataDone_ = false;
+        wantsWrite_ = false;
+        return true;
+    }
+
     Result<void> handshake() override {
         if (!ssl_) {
             return Result<void>(std::string("SSL object not initialized"));
@@ -208,10 +470,40 @@ public:
         return Result<std::vector<uint8_t>>(std::move(decrypted));
     }
 
+    Result<size_t> decryptInto(utils::ByteSpan data, utils::MutableByteSpan out) override {
+        if (!ssl_ || !SSL_is_init_finished(ssl_)) {
+            return Result<size_t>(std::string("SSL not ready for decryption"));
+        }
+
+        int read_len = SSL_read(ssl_, out.data(), static_cast<int>(std::min(data.size(), out.size())));
+        if (read_len <= 0) {
+            int err = SSL_get_error(ssl_, read_len);
+            return Result<size_t>(
+                std::string("Decryption failed (SSL_read): ") + std::to_string(err) + " - " + getOpenSSLError());
+        }
+        return Result<size_t>(static_cast<size_t>(read_len));
+    }
+
     bool isHandshakeComplete() const override {
         return ssl_ && SSL_is_init_finished(ssl_);
     }
 
+    Result<std::vector<uint8_t>> exportKeyingMaterial(const std::string& label, size_t length) override {
+        if (!ssl_ || !SSL_is_init_finished(ssl_)) {
+            return Result<std::vector<uint8_t>>(std::string("SSL not ready for keying material export"));
+        }
+        std::vector<uint8_t> material(length);
+        if (SSL_export_keying_material(ssl_, material.data(), material.size(), label.data(), label.size(),
+                                       nullptr, 0, 0) != 1) {
+            return Result<std::vector<uint8_t>>(std::string("Keying material export failed: ") + getOpenSSLError());
+        }
+        return Result<std::vector<uint8_t>>(std::move(material));
+    }
+
+    bool isServerSide() const override {
+        return isServer_;
+    }
+
     std::string getPeerCertificateInfo() const override {
         if (!ssl_) return "";
 
@@ -263,13 +555,37 @@ public:
             return Result<void>();
         }
 
+        if (isServer_ && !earlyDataDone_ && SSL_get_max_early_data(ssl_) > 0) {
+            // Early data has to be drained before the handshake can finish
+            uint8_t buffer[4096];
+            for (;;) {
+                size_t read = 0;
+                int status = SSL_read_early_data(ssl_, buffer, sizeof(buffer), &read);
+                if (status == SSL_READ_EARLY_DATA_ERROR) {
+                    int err = SSL_get_error(ssl_, 0);
+                    if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+                        wantsWrite_ = err == SSL_ERROR_WANT_WRITE;
+                        return Result<void>();
+                    }
+                    return Result<void>(std::string("Reading early data failed: ") + getOpenSSLError());
+                }
+                earlyData_.insert(earlyData_.end(), buffer, buffer + read);
+                if (status == SSL_READ_EARLY_DATA_FINISH) {
+                    earlyDataDone_ = true;
+                    break;
+                }
+            }
+        }
+
         int ret = SSL_do_handshake(ssl_);
         if (ret == 1) {
+            wantsWrite_ = false;
             return Result<void>();
         }
 
         int err = SSL_get_error(ssl_, ret);
         if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+            wantsWrite_ = err == SSL_ERROR_WANT_WRITE;
             return Result<void>();
         } else {
             return Result<void>(std::string("Handshake step failed: ") + getOpenSSLError());
@@ -349,24 +665,215 @@ private:
     SSL* ssl_;
     bool isServer_;
     bool selective_encryption_enabled_ = false;
+    std::string sessionKey_;          // Endpoint new sessions are cached under; clients only
+    std::vector<uint8_t> earlyData_;  // Received before the handshake finished; servers only
+    bool earlyDataDone_ = false;
+    bool wantsWrite_ = false;
     SecurityMetrics metrics_;
 };
 
+namespace {
+
+// Files named by the configuration are read when a context is built; a rewritten file changes its stamp
+std::string fileStamp(const std::string& path) {
+    if (path.empty()) {
+        return "";
+    }
+    std::error_code error;
+    auto written = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return "missing";
+    }
+    auto size = std::filesystem::file_size(path, error);
+    return std::to_string(written.time_since_epoch().count()) + "/" + std::to_string(error ? 0 : size);
+}
+
+// Everything buildSslContext() reads, so managers with equal keys can share one context
+std::string sslContextKey(const SecurityConfig& config) {
+    std::ostringstream key;
+    key << static_cast<int>(config.protocol) << '\n';
+    for (auto suite : config.allowedCipherSuites) {
+        key << static_cast<int>(suite) << ',';
+    }
+    for (const auto* path : {&config.certificatePath, &config.privateKeyPath, &config.trustedCAsPath}) {
+        key << '\n' << *path << '\n' << fileStamp(*path);
+    }
+    key << '\n' << config.verifyPeer << config.allowSelfSigned << config.enableSessionTickets
+        << config.enableEarlyData << '\n' << config.maxSessionCacheSize << '\n' << config.sessionTimeout.count()
+        << '\n' << config.maxEarlyDataSize;
+    return key.str();
+}
+
+Result<std::shared_ptr<SSL_CTX>> buildSslContext(const SecurityConfig& config) {
+    ensureSSLInitialized();
+
+    // Create new context
+    const SSL_METHOD* method = getSSLMethod(config.protocol, true);
+    if (!method) {
+        return Result<std::shared_ptr<SSL_CTX>>(std::string("Unsupported protocol"));
+    }
+
+    std::shared_ptr<SSL_CTX> ctx(SSL_CTX_new(method), SSL_CTX_free);
+    if (!ctx) {
+        return Result<std::shared_ptr<SSL_CTX>>(std::string("Failed to create SSL context: ") + getOpenSSLError());
+    }
+
+    // Set minimum protocol version
+    switch (config.protocol) {
+        case EncryptionProtocol::TLS_1_2:
+            SSL_CTX_set_min_proto_version(ctx.get(), TLS1_2_VERSION);
+            break;
+        case EncryptionProtocol::TLS_1_3:
+            SSL_CTX_set_min_proto_version(ctx.get(), TLS1_3_VERSION);
+            break;
+        case EncryptionProtocol::DTLS_1_2:
+            SSL_CTX_set_min_proto_version(ctx.get(), DTLS1_2_VERSION);
+            break;
+        case EncryptionProtocol::DTLS_1_3:
+            SSL_CTX_set_min_proto_version(ctx.get(), DTLS1_2_VERSION); // DTLS 1.3 not yet widely supported
+            break;
+    }
+
+    // Set cipher suites
+    std::string cipherList;
+    for (const auto& suite : config.allowedCipherSuites) {
+        const char* cipherStr = getCipherString(suite);
+        if (cipherStr) {
+            if (!cipherList.empty()) cipherList += ":";
+            cipherList += cipherStr;
+        }
+    }
+    
+    if (!SSL_CTX_set_cipher_list(ctx.get(), cipherList.c_str())) {
+        return Result<std::shared_ptr<SSL_CTX>>(std::string("Failed to set cipher list: ") + getOpenSSLError());
+    }
+
+    // Load certificates if paths are provided
+    if (!config.certificatePath.empty() && !config.privateKeyPath.empty()) {
+        if (SSL_CTX_use_certificate_file(ctx.get(), config.certificatePath.c_str(), 
+                                       SSL_FILETYPE_PEM) != 1) {
+            return Result<std::shared_ptr<SSL_CTX>>(std::string("Failed to load certificate: ") + getOpenSSLError());
+        }
+
+        if (SSL_CTX_use_PrivateKey_file(ctx.get(), config.privateKeyPath.c_str(), 
+                                       SSL_FILETYPE_PEM) != 1) {
+            return Result<std::shared_ptr<SSL_CTX>>(std::string("Failed to load private key: ") + getOpenSSLError());
+        }
+
+        if (SSL_CTX_check_private_key(ctx.get()) != 1) {
+            return Result<std::shared_ptr<SSL_CTX>>(std::string("Private key does not match certificate: ") + getOpenSSLError());
+        }
+    }
+
+    // Load CA certificate if provided
+    if (!config.trustedCAsPath.empty()) {
+        if (SSL_CTX_load_verify_locations(ctx.get(), config.trustedCAsPath.c_str(), nullptr) != 1) {
+            return Result<std::shared_ptr<SSL_CTX>>(std::string("Failed to load CA certificate: ") + getOpenSSLError());
+        }
+    }
+
+    // Configure peer verification
+    SSL_CTX_set_verify(ctx.get(), 
+        config.verifyPeer ? SSL_VERIFY_PEER : SSL_VERIFY_NONE, 
+        nullptr);
+
+    if (config.allowSelfSigned) {
+        SSL_CTX_set_verify_depth(ctx.get(), 1);
+    }
+
+    // Session resumption: clients keep sessions in the process-wide cache, servers in OpenSSL's.
+    // Whether a connection offers a cached session is up to its SecureContext::resumeSession caller.
+    static const unsigned char SESSION_ID_CONTEXT[] = "xenocomm";
+    SSL_CTX_set_session_id_context(ctx.get(), SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_set_session_cache_mode(ctx.get(), SSL_SESS_CACHE_BOTH);
+    SSL_CTX_sess_set_new_cb(ctx.get(), &OpenSSLContext::onNewSession);
+    SSL_CTX_sess_set_cache_size(ctx.get(), config.maxSessionCacheSize);
+    SSL_CTX_set_timeout(ctx.get(), static_cast<long>(config.sessionTimeout.count()));
+    SessionCache::shared().configure(config.maxSessionCacheSize, config.sessionTimeout);
+    if (!config.enableSessionTickets) {
+        SSL_CTX_set_options(ctx.get(), SSL_OP_NO_TICKET);
+    }
+    if (config.enableEarlyData) {
+        SSL_CTX_set_max_early_data(ctx.get(), config.maxEarlyDataSize);
+    }
+
+    return Result<std::shared_ptr<SSL_CTX>>(std::move(ctx));
+}
+
+// Contexts shared by every SecurityManager in the process, by sslContextKey(). Entries are
+// weak, so a context is freed once the last manager using it lets go or is reconfigured.
+class SharedSslContexts {
+public:
+    static SharedSslContexts& instance() {
+        static SharedSslContexts contexts;
+        return contexts;
+    }
+
+    Result<std::shared_ptr<SSL_CTX>> acquire(const SecurityConfig& config) {
+        const std::string key = sslContextKey(config);
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& slot = entries_[key];
+            if (!slot) {
+                // New keys are rare, so this is where entries whose context has gone are dropped
+                for (auto it = entries_.begin(); it != entries_.end();) {
+                    if (it->second && it->second.use_count() == 1 && it->second->ctx.expired()) {
+                        it = entries_.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                slot = std::make_shared<Entry>();
+            }
+            entry = slot;
+        }
+
+        // Built under this entry's lock only: managers of other settings are not held up, and
+        // those of the same settings wait for this one instead of reading the same files again
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (auto ctx = entry->ctx.lock()) {
+            return Result<std::shared_ptr<SSL_CTX>>(std::move(ctx));
+        }
+        auto built = buildSslContext(config);
+        if (built.has_value()) {
+            entry->ctx = built.value();
+        }
+        return built;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return static_cast<size_t>(std::count_if(entries_.begin(), entries_.end(),
+                                                 [](const auto& entry) { return !entry.second->ctx.expired(); }));
+    }
+
+private:
+    struct Entry {
+        std::mutex mutex;
+        std::weak_ptr<SSL_CTX> ctx;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+};
+
+} // namespace
+
 SecurityManager::SecurityManager(const SecurityConfig& config)
-    : config_(config), sslData_(std::make_unique<SSLData>()) {
+    : config_(config), sslData_(std::make_unique<SSLData>()), contextPool_(std::make_shared<ContextPool>()),
+      cookieKeys_(std::make_unique<CookieKeys>()) {
     auto configValidation = config.validate();
     if (configValidation) {
         throw std::runtime_error("Invalid security configuration: " + *configValidation);
     }
-    
-    if (auto result = initializeSSL(); result.has_error()) {
-        throw std::runtime_error("Failed to initialize SSL: " + result.error());
-    }
-    
-    if (auto result = loadCertificates(); result.has_error()) {
-        throw std::runtime_error("Failed to load certificates: " + result.error());
+    if (config_.authCache.enabled) {
+        authCache_ = std::make_shared<AuthCache>(config_.authCache);
     }
+    contextPool_->maxIdle = config_.connectionPool.enabled ? config_.connectionPool.maxPoolSize : 0;
+    cookieKeys_->lifetimeSeconds = config_.cookieLifetime.count();
     
+    // The SSL_CTX is acquired when the first connection needs it, so a manager per channel stays cheap
     initializeMonitoring();
     
     // Log configuration change event
@@ -403,23 +910,39 @@ Result<void> SecurityManager::updateConfig(const SecurityConfig& newConfig) {
     // Store old config for comparison
     auto oldConfig = config_;
     config_ = newConfig;
+
+    // Buckets of another length are numbered differently, so the old keys cannot be found again
+    if (oldConfig.cookieLifetime != newConfig.cookieLifetime) {
+        cookieKeys_->lifetimeSeconds = newConfig.cookieLifetime.count();
+        cookieKeys_->clear();
+    }
     
-    // Reinitialize SSL if necessary security parameters changed
-    if (oldConfig.protocol != newConfig.protocol ||
-        oldConfig.allowedCipherSuites != newConfig.allowedCipherSuites ||
-        oldConfig.certificatePath != newConfig.certificatePath ||
-        oldConfig.privateKeyPath != newConfig.privateKeyPath ||
-        oldConfig.trustedCAsPath != newConfig.trustedCAsPath) {
-        
-        cleanupSSL();
+    // Move to the context for the new settings if they would build a different one. A manager
+    // already serving connections checks the new settings now; others do on their first.
+    if (sslContextKey(oldConfig) != sslContextKey(newConfig) && cleanupSSL()) {
         if (auto result = initializeSSL(); result.has_error()) {
             return result;
         }
-        if (auto result = loadCertificates(); result.has_error()) {
-            return result;
-        }
     }
     
+    {
+        std::lock_guard<std::mutex> poolLock(contextPool_->mutex);
+        contextPool_->maxIdle = newConfig.connectionPool.enabled ? newConfig.connectionPool.maxPoolSize : 0;
+        for (auto& idle : contextPool_->idle) {
+            while (idle.size() > contextPool_->maxIdle) {
+                idle.pop_back();
+            }
+        }
+    }
+
+    // Providers holding the old cache keep using it until they are reconfigured
+    if (oldConfig.authCache.enabled != newConfig.authCache.enabled ||
+        oldConfig.authCache.maxCacheSize != newConfig.authCache.maxCacheSize ||
+        oldConfig.authCache.cacheTimeout != newConfig.authCache.cacheTimeout) {
+        std::atomic_store(&authCache_, newConfig.authCache.enabled
+            ? std::make_shared<AuthCache>(newConfig.authCache) : std::shared_ptr<AuthCache>());
+    }
+
     // Update monitoring configuration if changed
     if (oldConfig.monitoring != newConfig.monitoring) {
         cleanupMonitoring();
@@ -441,169 +964,168 @@ Result<void> SecurityManager::updateConfig(const SecurityConfig& newConfig) {
 }
 
 Result<std::shared_ptr<SecureContext>> SecurityManager::createContext(bool isServer) {
-    std::lock_guard<std::mutex> lock(sslData_->mutex);
-    if (!sslData_ || !sslData_->ctx) {
-        return Result<std::shared_ptr<SecureContext>>("SSL context not initialized in SecurityManager");
+    std::unique_ptr<SecureContext> context;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(contextPool_->mutex);
+        auto& idle = contextPool_->idle[isServer ? 1 : 0];
+        if (!idle.empty()) {
+            context = std::move(idle.front());
+            idle.pop_front();
+        }
+        generation = contextPool_->generation;
     }
-    try {
-        auto context = std::make_shared<OpenSSLContext>(sslData_->ctx, isServer);
-        // Add to connection pool if pooling is enabled & configured
-        if (config_.connectionPool.enabled) {
-            std::lock_guard<std::mutex> pool_lock(poolMutex_);
-            if (connectionPool_.size() < config_.connectionPool.maxPoolSize) {
-                connectionPool_.push_back(context);
-                 // Update metrics accordingly
-                metrics_.currentConnections++;
-                if (metrics_.currentConnections > metrics_.peakConnections) {
-                    metrics_.peakConnections = metrics_.currentConnections.load();
-                }
-            } else {
-                // Pool is full, perhaps log or return a specific error if strict
-                // For now, just don't add to pool but still return the context
+    if (!context) {
+        std::string error;
+        context = newContext(isServer, error);
+        if (!context) {
+            return Result<std::shared_ptr<SecureContext>>(error);
+        }
+    }
+    return Result<std::shared_ptr<SecureContext>>(leaseContext(std::move(context), generation));
+}
+
+size_t SecurityManager::prewarmContexts(bool isServer, size_t count) {
+    auto& pool = *contextPool_;
+    for (;;) {
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            auto& idle = pool.idle[isServer ? 1 : 0];
+            if (idle.size() >= std::min(count, pool.maxIdle)) {
+                return idle.size();
             }
+            generation = pool.generation;
+        }
+        std::string error;
+        auto context = newContext(isServer, error);
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        auto& idle = pool.idle[isServer ? 1 : 0];
+        if (!context) {
+            XLOG_WARN("Failed to prewarm secure context: {}", error);
+            return idle.size();
         }
-        return Result<std::shared_ptr<SecureContext>>(context);
+        if (generation == pool.generation && idle.size() < pool.maxIdle) {
+            idle.push_back(std::move(context));
+        }
+    }
+}
+
+std::unique_ptr<SecureContext> SecurityManager::newContext(bool isServer, std::string& error) {
+    if (auto ready = initializeSSL(); ready.has_error()) {
+        error = "Failed to initialize SSL: " + ready.error();
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(sslData_->mutex);
+    if (!sslData_->ctx) {
+        error = "SSL context not initialized in SecurityManager";
+        return nullptr;
+    }
+    try {
+        return std::make_unique<OpenSSLContext>(sslData_->ctx.get(), isServer);
     } catch (const std::exception& e) {
-        return Result<std::shared_ptr<SecureContext>>(std::string("Failed to create OpenSSLContext: ") + e.what());
+        error = std::string("Failed to create OpenSSLContext: ") + e.what();
+        return nullptr;
+    }
+}
+
+std::shared_ptr<SecureContext> SecurityManager::leaseContext(std::unique_ptr<SecureContext> context,
+                                                             uint64_t generation) {
+    size_t leased = ++contextPool_->leased;
+    metrics_.setConnections(leased);
+    std::weak_ptr<ContextPool> pool = contextPool_;
+    return std::shared_ptr<SecureContext>(context.release(), [pool, generation](SecureContext* released) {
+        recycleContext(pool, released, generation);
+    });
+}
+
+void SecurityManager::recycleContext(const std::weak_ptr<ContextPool>& pool, SecureContext* context,
+                                     uint64_t generation) {
+    std::unique_ptr<SecureContext> owned(context);
+    auto alive = pool.lock();
+    if (!alive) {
+        return;
+    }
+    --alive->leased;
+    std::lock_guard<std::mutex> lock(alive->mutex);
+    auto& idle = alive->idle[owned->isServerSide() ? 1 : 0];
+    if (generation == alive->generation && idle.size() < alive->maxIdle && owned->reset()) {
+        // Most recently used first; its memory is the most likely to still be cached
+        idle.push_front(std::move(owned));
     }
 }
 
 void SecurityManager::resetMetrics() {
-    metrics_.totalEncryptionOps = 0;
-    metrics_.totalDecryptionOps = 0;
-    metrics_.totalHandshakes = 0;
-    metrics_.totalAuthAttempts = 0;
-    metrics_.totalAuthCacheHits = 0;
-    metrics_.totalBytesEncrypted = 0;
-    metrics_.totalBytesDecrypted = 0;
-    metrics_.totalHandshakeTime = 0;
-    metrics_.totalEncryptionTime = 0;
-    metrics_.totalDecryptionTime = 0;
-    metrics_.peakEncryptionLatency = 0;
-    metrics_.peakDecryptionLatency = 0;
-    // currentConnections should naturally go to 0 as contexts are destroyed or removed from pool
-    // peakConnections remains as a high-water mark, not typically reset by a simple metrics reset.
-    // If peakConnections should also be reset, add: metrics_.peakConnections = metrics_.currentConnections.load();
+    // currentConnections follows the pool and peakConnections stays a high-water mark
+    metrics_.reset();
 }
 
 std::pair<size_t, size_t> SecurityManager::getConnectionPoolStatus() const {
-    std::lock_guard<std::mutex> lock(poolMutex_);
-    return {connectionPool_.size(), config_.connectionPool.maxPoolSize};
+    std::lock_guard<std::mutex> lock(contextPool_->mutex);
+    return {contextPool_->leased.load(), contextPool_->idle[0].size() + contextPool_->idle[1].size()};
 }
 
 std::pair<size_t, float> SecurityManager::getAuthCacheStats() const {
-    std::lock_guard<std::mutex> lock(authCacheMutex_);
-    float hitRate = metrics_.totalAuthAttempts.load() > 0
-        ? static_cast<float>(metrics_.totalAuthCacheHits.load()) / metrics_.totalAuthAttempts.load()
-        : 0.0f;
-    return {authCache_.size(), hitRate};
+    auto cache = getAuthCache();
+    if (!cache) {
+        return {0, 0.0f};
+    }
+    auto stats = cache->getStats();
+    return {stats.entries, stats.hitRate()};
 }
 
 std::vector<SecurityEvent> SecurityManager::getSecurityEvents(
     size_t maxEvents,
     std::optional<SecurityEventType> filterType) const {
-    std::lock_guard<std::mutex> lock(eventsMutex_);
-    
-    std::vector<SecurityEvent> events;
-    events.reserve(std::min(maxEvents, securityEvents_.size()));
-    
-    for (auto it = securityEvents_.rbegin(); 
-         it != securityEvents_.rend() && events.size() < maxEvents; 
-         ++it) {
-        if (!filterType || it->type == *filterType) {
-            events.push_back(*it);
-        }
-    }
-    
-    return events;
+    auto events = std::atomic_load(&events_);
+    return events ? events->recent(maxEvents, filterType) : std::vector<SecurityEvent>();
+}
+
+uint64_t SecurityManager::getSecurityEventCount(SecurityEventType type) const {
+    auto events = std::atomic_load(&events_);
+    return events ? events->count(type) : 0;
 }
 
 void SecurityManager::logSecurityEvent(const SecurityEvent& event) {
     if (!config_.monitoring.enableSecurityEvents) {
         return;
     }
-    
-    std::lock_guard<std::mutex> lock(eventsMutex_);
-    
-    // Add event to in-memory buffer
-    securityEvents_.push_back(event);
-    
-    // Trim buffer if it gets too large
-    while (securityEvents_.size() > 1000) {
-        securityEvents_.erase(securityEvents_.begin());
+    if (auto events = std::atomic_load(&events_)) {
+        events->record(event);
     }
-    
-    // Write to log file if enabled
-    if (config_.monitoring.enableAuditLog) {
-        static std::mutex logMutex;
-        std::lock_guard<std::mutex> logLock(logMutex);
-        
-        std::filesystem::path logPath = "security.log";
-        std::ofstream logFile(logPath, std::ios::app);
-        
-        if (logFile) {
-            auto now = std::chrono::system_clock::to_time_t(event.timestamp);
-            logFile << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S") << " | ";
-            logFile << std::setw(20) << std::left;
-            
-            switch (event.type) {
-                case SecurityEventType::HANDSHAKE_START: logFile << "HANDSHAKE_START"; break;
-                case SecurityEventType::HANDSHAKE_COMPLETE: logFile << "HANDSHAKE_COMPLETE"; break;
-                case SecurityEventType::HANDSHAKE_FAILED: logFile << "HANDSHAKE_FAILED"; break;
-                case SecurityEventType::AUTH_SUCCESS: logFile << "AUTH_SUCCESS"; break;
-                case SecurityEventType::AUTH_FAILURE: logFile << "AUTH_FAILURE"; break;
-                case SecurityEventType::CERT_VALIDATION_SUCCESS: logFile << "CERT_VALIDATION_SUCCESS"; break;
-                case SecurityEventType::CERT_VALIDATION_FAILURE: logFile << "CERT_VALIDATION_FAILURE"; break;
-                case SecurityEventType::KEY_ROTATION: logFile << "KEY_ROTATION"; break;
-                case SecurityEventType::CONFIG_CHANGE: logFile << "CONFIG_CHANGE"; break;
-                case SecurityEventType::SECURITY_VIOLATION: logFile << "SECURITY_VIOLATION"; break;
-            }
-            
-            logFile << " | ";
-            
-            // Mask sensitive data if configured
-            std::string description = event.description;
-            if (config_.monitoring.maskSensitiveData && event.isSensitive) {
-                description = "[REDACTED]";
-            }
-            
-            logFile << description;
-            
-            if (event.sourceIp) {
-                logFile << " | IP: " << *event.sourceIp;
-            }
-            if (event.username) {
-                logFile << " | User: " << *event.username;
-            }
-            if (event.certificateSubject) {
-                logFile << " | Cert: " << *event.certificateSubject;
-            }
-            
-            logFile << std::endl;
-        }
-        
-        // Rotate log file if needed
-        if (std::filesystem::exists(logPath) && 
-            std::filesystem::file_size(logPath) > config_.monitoring.maxLogSize) {
-            
-            // Rotate existing log files
-            for (size_t i = config_.monitoring.maxLogFiles - 1; i >= 1; --i) {
-                std::filesystem::path oldPath = logPath.string() + "." + std::to_string(i);
-                std::filesystem::path newPath = logPath.string() + "." + std::to_string(i + 1);
-                
-                if (std::filesystem::exists(oldPath)) {
-                    if (i == config_.monitoring.maxLogFiles - 1) {
-                        std::filesystem::remove(oldPath);
-                    } else {
-                        std::filesystem::rename(oldPath, newPath);
-                    }
-                }
-            }
-            
-            // Rename current log file
-            std::filesystem::rename(logPath, logPath.string() + ".1");
-        }
+    auto audit = std::atomic_load(&auditLog_);
+    if (!audit) {
+        return;
     }
+
+    const char* type = "";
+    switch (event.type) {
+        case SecurityEventType::HANDSHAKE_START: type = "HANDSHAKE_START"; break;
+        case SecurityEventType::HANDSHAKE_COMPLETE: type = "HANDSHAKE_COMPLETE"; break;
+        case SecurityEventType::HANDSHAKE_FAILED: type = "HANDSHAKE_FAILED"; break;
+        case SecurityEventType::AUTH_SUCCESS: type = "AUTH_SUCCESS"; break;
+        case SecurityEventType::AUTH_FAILURE: type = "AUTH_FAILURE"; break;
+        case SecurityEventType::CERT_VALIDATION_SUCCESS: type = "CERT_VALIDATION_SUCCESS"; break;
+        case SecurityEventType::CERT_VALIDATION_FAILURE: type = "CERT_VALIDATION_FAILURE"; break;
+        case SecurityEventType::KEY_ROTATION: type = "KEY_ROTATION"; break;
+        case SecurityEventType::CONFIG_CHANGE: type = "CONFIG_CHANGE"; break;
+        case SecurityEventType::SECURITY_VIOLATION: type = "SECURITY_VIOLATION"; break;
+    }
+    std::string line = type;
+    line.resize(std::max<size_t>(line.size(), 20), ' ');
+    line += " | ";
+    // Mask sensitive data if configured
+    line += config_.monitoring.maskSensitiveData && event.isSensitive ? "[REDACTED]" : event.description;
+    if (event.sourceIp) {
+        line += " | IP: " + *event.sourceIp;
+    }
+    if (event.username) {
+        line += " | User: " + *event.username;
+    }
+    if (event.certificateSubject) {
+        line += " | Cert: " + *event.certificateSubject;
+    }
+    audit->write(std::move(line));
 }
 
 void SecurityManager::updateMetrics(
@@ -616,20 +1138,13 @@ void SecurityManager::updateMetrics(
     }
     
     if (operation == "encrypt") {
-        metrics_.totalEncryptionOps++;
-        metrics_.totalBytesEncrypted += bytes;
-        metrics_.totalEncryptionTime += duration.count();
-        metrics_.peakEncryptionLatency = std::max(
-            metrics_.peakEncryptionLatency.load(),
-            static_cast<uint64_t>(duration.count()));
+        metrics_.recordEncryption(bytes, duration);
     }
     else if (operation == "decrypt") {
-        metrics_.totalDecryptionOps++;
-        metrics_.totalBytesDecrypted += bytes;
-        metrics_.totalDecryptionTime += duration.count();
-        metrics_.peakDecryptionLatency = std::max(
-            metrics_.peakDecryptionLatency.load(),
-            static_cast<uint64_t>(duration.count()));
+        metrics_.recordDecryption(bytes, duration);
+    }
+    else if (operation == "handshake") {
+        metrics_.recordHandshake(duration);
     }
 }
 
@@ -641,32 +1156,22 @@ void SecurityManager::initializeMonitoring() {
     
     // Clear existing metrics and events
     resetMetrics();
-    securityEvents_.clear();
+    std::atomic_store(&events_, std::make_shared<SecurityEventBuffer>(config_.monitoring.eventBufferSize));
     
     // Initialize log file if needed
     if (config_.monitoring.enableAuditLog) {
-        std::filesystem::path logPath = "security.log";
-        std::ofstream logFile(logPath, std::ios::app);
-        if (logFile) {
-            auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-            logFile << "\n--- Security log initialized at " 
-                   << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S")
-                   << " ---\n\n";
-        }
+        auto audit = utils::EventLog::open("security.log");
+        audit->setRotation(config_.monitoring.maxLogSize, config_.monitoring.maxLogFiles);
+        audit->write("--- Security log initialized ---");
+        std::atomic_store(&auditLog_, std::move(audit));
     }
 }
 
 void SecurityManager::cleanupMonitoring() {
     // Flush any remaining events to log
-    if (config_.monitoring.enableAuditLog && !securityEvents_.empty()) {
-        std::filesystem::path logPath = "security.log";
-        std::ofstream logFile(logPath, std::ios::app);
-        if (logFile) {
-            auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-            logFile << "\n--- Security log closed at "
-                   << std::put_time(std::localtime(&now), "%Y-%m-%d %H:%M:%S")
-                   << " ---\n\n";
-        }
+    if (auto audit = std::atomic_exchange(&auditLog_, std::shared_ptr<utils::EventLog>())) {
+        audit->write("--- Security log closed ---");
+        audit->flush();
     }
 }
 
@@ -679,8 +1184,15 @@ Result<void> SecurityManager::validateConfig(const SecurityConfig& config_to_val
 }
 
 Result<void> SecurityManager::validatePeerCertificate(const std::vector<uint8_t>& certData) {
-    ensureSSLInitialized();
-    if (!sslData_ || !sslData_->ctx) {
+    if (auto ready = initializeSSL(); ready.has_error()) {
+        return Result<void>("SSL context not initialized for certificate validation: " + ready.error());
+    }
+    std::shared_ptr<SSL_CTX> ctx;
+    {
+        std::lock_guard<std::mutex> lock(sslData_->mutex);
+        ctx = sslData_->ctx;
+    }
+    if (!ctx) {
         return Result<void>("SSL context not initialized for certificate validation");
     }
 
@@ -704,7 +1216,7 @@ Result<void> SecurityManager::validatePeerCertificate(const std::vector<uint8_t>
     // Auto-free X509
     std::unique_ptr<X509, decltype(&X509_free)> cert_ptr(cert, X509_free);
 
-    X509_STORE* store = SSL_CTX_get_cert_store(sslData_->ctx);
+    X509_STORE* store = SSL_CTX_get_cert_store(ctx.get());
     if (!store) {
         return Result<void>("No certificate store available in SSL_CTX");
     }
@@ -809,164 +1321,103 @@ Result<void> SecurityManager::generateSelfSignedCert(
     EVP_PKEY_free(pkey);
     X509_free(x509);
 
+    // Connections from now on use the new certificate
+    cleanupSSL();
+
     return Result<void>();
 }
 
 Result<void> SecurityManager::initializeSSL() {
-    ensureSSLInitialized();
-
     std::lock_guard<std::mutex> lock(sslData_->mutex);
-
-    // Clean up existing context if any
     if (sslData_->ctx) {
-        SSL_CTX_free(sslData_->ctx);
-        sslData_->ctx = nullptr;
-    }
-
-    // Create new context
-    const SSL_METHOD* method = getSSLMethod(config_.protocol, true);
-    if (!method) {
-        return Result<void>(std::string("Unsupported protocol"));
-    }
-
-    sslData_->ctx = SSL_CTX_new(method);
-    if (!sslData_->ctx) {
-        return Result<void>(std::string("Failed to create SSL context: ") + getOpenSSLError());
-    }
-
-    // Set minimum protocol version
-    switch (config_.protocol) {
-        case EncryptionProtocol::TLS_1_2:
-            SSL_CTX_set_min_proto_version(sslData_->ctx, TLS1_2_VERSION);
-            break;
-        case EncryptionProtocol::TLS_1_3:
-            SSL_CTX_set_min_proto_version(sslData_->ctx, TLS1_3_VERSION);
-            break;
-        case EncryptionProtocol::DTLS_1_2:
-            SSL_CTX_set_min_proto_version(sslData_->ctx, DTLS1_2_VERSION);
-            break;
-        case EncryptionProtocol::DTLS_1_3:
-            SSL_CTX_set_min_proto_version(sslData_->ctx, DTLS1_2_VERSION); // DTLS 1.3 not yet widely supported
-            break;
-    }
-
-    // Set cipher suites
-    std::string cipherList;
-    for (const auto& suite : config_.allowedCipherSuites) {
-        const char* cipherStr = getCipherString(suite);
-        if (cipherStr) {
-            if (!cipherList.empty()) cipherList += ":";
-            cipherList += cipherStr;
-        }
-    }
-    
-    if (!SSL_CTX_set_cipher_list(sslData_->ctx, cipherList.c_str())) {
-        return Result<void>(std::string("Failed to set cipher list: ") + getOpenSSLError());
-    }
-
-    // Load certificates if paths are provided
-    if (!config_.certificatePath.empty() && !config_.privateKeyPath.empty()) {
-        if (SSL_CTX_use_certificate_file(sslData_->ctx, config_.certificatePath.c_str(), 
-                                       SSL_FILETYPE_PEM) != 1) {
-            return Result<void>(std::string("Failed to load certificate: ") + getOpenSSLError());
-        }
-
-        if (SSL_CTX_use_PrivateKey_file(sslData_->ctx, config_.privateKeyPath.c_str(), 
-                                       SSL_FILETYPE_PEM) != 1) {
-            return Result<void>(std::string("Failed to load private key: ") + getOpenSSLError());
-        }
-
-        if (SSL_CTX_check_private_key(sslData_->ctx) != 1) {
-            return Result<void>(std::string("Private key does not match certificate: ") + getOpenSSLError());
-        }
-    }
-
-    // Load CA certificate if provided
-    if (!config_.trustedCAsPath.empty()) {
-        if (SSL_CTX_load_verify_locations(sslData_->ctx, config_.trustedCAsPath.c_str(), nullptr) != 1) {
-            return Result<void>(std::string("Failed to load CA certificate: ") + getOpenSSLError());
-        }
+        return Result<void>();
     }
-
-    // Configure peer verification
-    SSL_CTX_set_verify(sslData_->ctx, 
-        config_.verifyPeer ? SSL_VERIFY_PEER : SSL_VERIFY_NONE, 
-        nullptr);
-
-    if (config_.allowSelfSigned) {
-        SSL_CTX_set_verify_depth(sslData_->ctx, 1);
+    auto ctx = SharedSslContexts::instance().acquire(config_);
+    if (ctx.has_error()) {
+        return Result<void>(ctx.error());
     }
-
+    sslData_->ctx = std::move(ctx.value());
     return Result<void>();
 }
 
-Result<void> SecurityManager::loadCertificates() {
-    return initializeSSL();
-}
-
-void SecurityManager::cleanupSSL() {
-    std::lock_guard<std::mutex> lock(sslData_->mutex);
-    if (sslData_->ctx) {
-        SSL_CTX_free(sslData_->ctx);
-        sslData_->ctx = nullptr;
+bool SecurityManager::cleanupSSL() {
+    bool held;
+    {
+        std::lock_guard<std::mutex> lock(sslData_->mutex);
+        held = sslData_->ctx != nullptr;
+        sslData_->ctx.reset();
+    }
+    // Pooled contexts were made from the old SSL_CTX and its settings
+    std::lock_guard<std::mutex> poolLock(contextPool_->mutex);
+    ++contextPool_->generation;
+    for (auto& idle : contextPool_->idle) {
+        idle.clear();
     }
+    return held;
 }
 
-Result<std::vector<uint8_t>> SecurityManager::generateHmac(const std::vector<uint8_t>& data) {
-    if (hmac_key_.empty()) {
-        // Simplified key generation for example, should be more robust
-        hmac_key_.resize(32); // SHA256_DIGEST_LENGTH or similar
-        if (RAND_bytes(hmac_key_.data(), static_cast<int>(hmac_key_.size())) != 1) {
-            return Result<std::vector<uint8_t>>(std::string("Failed to generate HMAC key: ") + getOpenSSLError());
-        }
-    }
-    std::vector<uint8_t> hmac_result(EVP_MAX_MD_SIZE);
-    unsigned int hmac_len;
-    if (!HMAC(EVP_sha256(), hmac_key_.data(), static_cast<int>(hmac_key_.size()),
-              data.data(), data.size(), hmac_result.data(), &hmac_len)) {
-        return Result<std::vector<uint8_t>>(std::string("Failed to generate HMAC: ") + getOpenSSLError());
-    }
-    hmac_result.resize(hmac_len);
-    return Result<std::vector<uint8_t>>(hmac_result);
+size_t SecurityManager::sharedContextCount() {
+    return SharedSslContexts::instance().size();
 }
 
 Result<std::vector<uint8_t>> SecurityManager::generateDtlsCookie(const NetworkAddress& client) {
-    std::vector<uint8_t> client_data;
-    // Serialize client address and potentially other info into client_data
-    // Example: append IP and port
-    uint32_t ip_addr_net = inet_addr(client.ip.c_str());
-    client_data.insert(client_data.end(), reinterpret_cast<uint8_t*>(&ip_addr_net), reinterpret_cast<uint8_t*>(&ip_addr_net) + sizeof(ip_addr_net));
-    uint16_t port_net = htons(client.port);
-    client_data.insert(client_data.end(), reinterpret_cast<uint8_t*>(&port_net), reinterpret_cast<uint8_t*>(&port_net) + sizeof(port_net));
-
-    auto hmacResult = generateHmac(client_data);
-    if (hmacResult.has_error()) {
-        return Result<std::vector<uint8_t>>(hmacResult.error());
+    const uint32_t bucket = cookieBucket(std::chrono::seconds(cookieKeys_->lifetimeSeconds.load()));
+    std::vector<uint8_t> cookie(DTLS_COOKIE_SIZE);
+    for (size_t i = 0; i < COOKIE_TAG_OFFSET; ++i) {
+        cookie[i] = static_cast<uint8_t>(bucket >> (8 * i));
+    }
+    bool tagged = false;
+    {
+        std::shared_lock<std::shared_mutex> lock(cookieKeys_->mutex);
+        if (const CookieKey* key = cookieKeys_->find(bucket)) {
+            tagged = cookieTag(*key, bucket, client, cookie.data() + COOKIE_TAG_OFFSET);
+        } else {
+            lock.unlock();
+            std::unique_lock<std::shared_mutex> writeLock(cookieKeys_->mutex);
+            CookieKey& slot = cookieKeys_->keys[bucket & 1];
+            if (!slot.live || slot.bucket != bucket) {
+                // The slot held the bucket before last, whose cookies have expired
+                if (!makeCookieKey(bucket, slot)) {
+                    slot.live = false;
+                    return Result<std::vector<uint8_t>>(std::string("Failed to generate DTLS cookie key: ") +
+                                                        getOpenSSLError());
+                }
+                CookieKey& other = cookieKeys_->keys[(bucket + 1) & 1];
+                other.live = other.live && other.bucket + 1 == bucket;
+            }
+            tagged = cookieTag(slot, bucket, client, cookie.data() + COOKIE_TAG_OFFSET);
+        }
     }
-
-    std::vector<uint8_t> cookie = hmacResult.value(); // The HMAC itself can serve as the cookie
-    // Or prepend a timestamp or other data to the cookie if needed before HMACing.
-    // For DTLS 1.2, SSL_generate_cookie is an option if SSL object is available.
-    // For a manager-level cookie, HMAC is a common approach.
-    return Result<std::vector<uint8_t>>(cookie);
+    if (!tagged) {
+        return Result<std::vector<uint8_t>>(std::string("Failed to generate DTLS cookie: ") + getOpenSSLError());
+    }
+    return Result<std::vector<uint8_t>>(std::move(cookie));
 }
 
 Result<void> SecurityManager::verifyDtlsCookie(const std::vector<uint8_t>& cookie, const NetworkAddress& source) {
-     // This verification must match how generateDtlsCookie created it.
-     // If generateDtlsCookie just returns HMAC of client data:
-    std::vector<uint8_t> client_data;
-    uint32_t ip_addr_net = inet_addr(source.ip.c_str());
-    client_data.insert(client_data.end(), reinterpret_cast<uint8_t*>(&ip_addr_net), reinterpret_cast<uint8_t*>(&ip_addr_net) + sizeof(ip_addr_net));
-    uint16_t port_net = htons(source.port);
-    client_data.insert(client_data.end(), reinterpret_cast<uint8_t*>(&port_net), reinterpret_cast<uint8_t*>(&port_net) + sizeof(port_net));
-
-    auto expectedHmacResult = generateHmac(client_data);
-    if (expectedHmacResult.has_error()) {
-        return Result<void>("Failed to generate expected HMAC for cookie verification: " + expectedHmacResult.error());
+    if (cookie.size() != DTLS_COOKIE_SIZE) {
+        return Result<void>("DTLS cookie verification failed (wrong size)");
+    }
+    uint32_t bucket = 0;
+    for (size_t i = 0; i < COOKIE_TAG_OFFSET; ++i) {
+        bucket |= static_cast<uint32_t>(cookie[i]) << (8 * i);
+    }
+    const uint32_t now = cookieBucket(std::chrono::seconds(cookieKeys_->lifetimeSeconds.load()));
+    if (bucket != now && bucket + 1 != now) {
+        return Result<void>("DTLS cookie verification failed (expired)");
     }
 
-    if (cookie.size() != expectedHmacResult.value().size() ||
-        CRYPTO_memcmp(cookie.data(), expectedHmacResult.value().data(), cookie.size()) != 0) {
+    uint8_t expected[DTLS_COOKIE_SIZE - COOKIE_TAG_OFFSET];
+    bool tagged = false;
+    {
+        std::shared_lock<std::shared_mutex> lock(cookieKeys_->mutex);
+        const CookieKey* key = cookieKeys_->find(bucket);
+        if (!key) {
+            return Result<void>("DTLS cookie verification failed (expired)");
+        }
+        tagged = cookieTag(*key, bucket, source, expected);
+    }
+    if (!tagged || CRYPTO_memcmp(cookie.data() + COOKIE_TAG_OFFSET, expected, sizeof(expected)) != 0) {
         return Result<void>("DTLS cookie verification failed (HMAC mismatch)");
     }
     return Result<void>();
@@ -0,0 +1,173 @@
+#include "xenocomm/core/security_metrics.hpp"
+#include <algorithm>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+size_t threadSlotIndex() {
+    // Threads are spread round-robin, so up to SLOT_COUNT threads never share a slot
+    static std::atomic<size_t> nextIndex{0};
+    thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SecurityMetrics::SLOT_COUNT;
+    return index;
+}
+
+LatencySummary summarize(const utils::LatencyHistogram& histogram) {
+    LatencySummary summary;
+    summary.count = histogram.count();
+    summary.p50 = histogram.value_at_percentile(50.0);
+    summary.p99 = histogram.value_at_percentile(99.0);
+    summary.p999 = histogram.value_at_percentile(99.9);
+    summary.max = histogram.max();
+    return summary;
+}
+
+void writeLatency(utils::MetricsWriter& writer, const std::string& name, const std::string& help,
+                  const LatencySummary& latency, uint64_t sum, const utils::MetricLabels& labels) {
+    writer.summary(name, help, latency.count, static_cast<double>(sum),
+                   {{0.5, static_cast<double>(latency.p50)},
+                    {0.99, static_cast<double>(latency.p99)},
+                    {0.999, static_cast<double>(latency.p999)},
+                    {1.0, static_cast<double>(latency.max)}},
+                   labels);
+}
+
+} // namespace
+
+SecurityMetrics::~SecurityMetrics() {
+    metricsRegistration_.reset();
+    for (auto& slot : slots_) {
+        delete slot.load(std::memory_order_relaxed);
+    }
+}
+
+SecurityMetrics::Slot& SecurityMetrics::localSlot() {
+    auto& entry = slots_[threadSlotIndex()];
+    Slot* slot = entry.load(std::memory_order_acquire);
+    if (!slot) {
+        auto* fresh = new Slot();
+        if (entry.compare_exchange_strong(slot, fresh, std::memory_order_acq_rel)) {
+            slot = fresh;
+        } else {
+            delete fresh;
+        }
+    }
+    return *slot;
+}
+
+void SecurityMetrics::recordEncryption(size_t bytes, std::chrono::microseconds duration) {
+    Slot& slot = localSlot();
+    slot.encryptionOps.fetch_add(1, std::memory_order_relaxed);
+    slot.bytesEncrypted.fetch_add(bytes, std::memory_order_relaxed);
+    slot.encryptionLatency.record(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+}
+
+void SecurityMetrics::recordDecryption(size_t bytes, std::chrono::microseconds duration) {
+    Slot& slot = localSlot();
+    slot.decryptionOps.fetch_add(1, std::memory_order_relaxed);
+    slot.bytesDecrypted.fetch_add(bytes, std::memory_order_relaxed);
+    slot.decryptionLatency.record(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+}
+
+void SecurityMetrics::recordHandshake(std::chrono::microseconds duration) {
+    Slot& slot = localSlot();
+    slot.handshakes.fetch_add(1, std::memory_order_relaxed);
+    slot.handshakeLatency.record(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+}
+
+void SecurityMetrics::recordAuthAttempt(bool cacheHit) {
+    Slot& slot = localSlot();
+    slot.authAttempts.fetch_add(1, std::memory_order_relaxed);
+    if (cacheHit) {
+        slot.authCacheHits.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SecurityMetrics::setConnections(uint64_t current) {
+    currentConnections_.store(current, std::memory_order_relaxed);
+    uint64_t peak = peakConnections_.load(std::memory_order_relaxed);
+    while (current > peak && !peakConnections_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+SecurityMetrics::Snapshot SecurityMetrics::snapshot() const {
+    Snapshot result;
+    utils::LatencyHistogram encryption;
+    utils::LatencyHistogram decryption;
+    utils::LatencyHistogram handshake;
+    for (const auto& entry : slots_) {
+        const Slot* slot = entry.load(std::memory_order_acquire);
+        if (!slot) {
+            continue;
+        }
+        result.totalEncryptionOps += slot->encryptionOps.load(std::memory_order_relaxed);
+        result.totalDecryptionOps += slot->decryptionOps.load(std::memory_order_relaxed);
+        result.totalHandshakes += slot->handshakes.load(std::memory_order_relaxed);
+        result.totalAuthAttempts += slot->authAttempts.load(std::memory_order_relaxed);
+        result.totalAuthCacheHits += slot->authCacheHits.load(std::memory_order_relaxed);
+        result.totalBytesEncrypted += slot->bytesEncrypted.load(std::memory_order_relaxed);
+        result.totalBytesDecrypted += slot->bytesDecrypted.load(std::memory_order_relaxed);
+        encryption.merge(slot->encryptionLatency);
+        decryption.merge(slot->decryptionLatency);
+        handshake.merge(slot->handshakeLatency);
+    }
+
+    result.totalEncryptionTime = encryption.sum();
+    result.totalDecryptionTime = decryption.sum();
+    result.totalHandshakeTime = handshake.sum() / 1000;
+    result.peakEncryptionLatency = encryption.max();
+    result.peakDecryptionLatency = decryption.max();
+    result.encryptionLatency = summarize(encryption);
+    result.decryptionLatency = summarize(decryption);
+    result.handshakeLatency = summarize(handshake);
+    result.currentConnections = currentConnections_.load(std::memory_order_relaxed);
+    result.peakConnections = peakConnections_.load(std::memory_order_relaxed);
+    return result;
+}
+
+void SecurityMetrics::reset() {
+    for (auto& entry : slots_) {
+        Slot* slot = entry.load(std::memory_order_acquire);
+        if (!slot) {
+            continue;
+        }
+        slot->encryptionOps.store(0, std::memory_order_relaxed);
+        slot->decryptionOps.store(0, std::memory_order_relaxed);
+        slot->handshakes.store(0, std::memory_order_relaxed);
+        slot->authAttempts.store(0, std::memory_order_relaxed);
+        slot->authCacheHits.store(0, std::memory_order_relaxed);
+        slot->bytesEncrypted.store(0, std::memory_order_relaxed);
+        slot->bytesDecrypted.store(0, std::memory_order_relaxed);
+        slot->encryptionLatency.reset();
+        slot->decryptionLatency.reset();
+        slot->handshakeLatency.reset();
+    }
+}
+
+void SecurityMetrics::registerMetrics(utils::MetricsRegistry& registry, const std::string& instance) const {
+    metricsRegistration_ = registry.addCollector([this, instance](utils::MetricsWriter& writer) {
+        const utils::MetricLabels labels{{"instance", instance}};
+        const Snapshot totals = snapshot();
+        writer.counter("xenocomm_security_encryptions", "Encryption operations", totals.totalEncryptionOps, labels);
+        writer.counter("xenocomm_security_decryptions", "Decryption operations", totals.totalDecryptionOps, labels);
+        writer.counter("xenocomm_security_bytes_encrypted", "Bytes encrypted", totals.totalBytesEncrypted, labels);
+        writer.counter("xenocomm_security_bytes_decrypted", "Bytes decrypted", totals.totalBytesDecrypted, labels);
+        writer.counter("xenocomm_security_handshakes", "Completed handshakes", totals.totalHandshakes, labels);
+        writer.counter("xenocomm_security_auth_attempts", "Authentication attempts", totals.totalAuthAttempts, labels);
+        writer.counter("xenocomm_security_auth_cache_hits", "Authentications answered from the cache",
+                       totals.totalAuthCacheHits, labels);
+        writer.gauge("xenocomm_security_connections", "Open secure connections", totals.currentConnections, labels);
+        writer.gauge("xenocomm_security_connections_peak", "Most secure connections open at once",
+                     totals.peakConnections, labels);
+        writeLatency(writer, "xenocomm_security_encryption_latency_us", "Encryption latency in microseconds",
+                     totals.encryptionLatency, totals.totalEncryptionTime, labels);
+        writeLatency(writer, "xenocomm_security_decryption_latency_us", "Decryption latency in microseconds",
+                     totals.decryptionLatency, totals.totalDecryptionTime, labels);
+        writeLatency(writer, "xenocomm_security_handshake_latency_us", "Handshake latency in microseconds",
+                     totals.handshakeLatency, totals.totalHandshakeTime * 1000, labels);
+    });
+}
+
+} // namespace core
+} // namespace xenocomm
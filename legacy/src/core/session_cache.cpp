@@ -0,0 +1,139 @@
+#include "xenocomm/core/session_cache.hpp"
+#include <openssl/ssl.h>
+#include <algorithm>
+#include <ctime>
+
+namespace xenocomm {
+namespace core {
+
+SessionCache::SessionCache(size_t maxSessions, std::chrono::seconds lifetime)
+    : maxSessions_(maxSessions), lifetime_(lifetime) {}
+
+SessionCache::~SessionCache() {
+    clear();
+}
+
+SessionCache& SessionCache::shared() {
+    // Defaults match SecurityConfig; each SecurityManager applies its own limits.
+    // Leaked so no session is freed after OpenSSL's own exit-time cleanup.
+    static SessionCache* cache = new SessionCache(1000, std::chrono::seconds(3600));
+    return *cache;
+}
+
+void SessionCache::configure(size_t maxSessions, std::chrono::seconds lifetime) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxSessions_ = maxSessions;
+    lifetime_ = lifetime;
+    evictLocked(std::chrono::steady_clock::now());
+}
+
+bool SessionCache::usable(const Entry& entry, std::chrono::steady_clock::time_point now) const {
+    return now < entry.expires && SSL_SESSION_is_resumable(entry.session) == 1;
+}
+
+void SessionCache::erase(Order::iterator entry) {
+    auto found = byEndpoint_.find(entry->endpoint);
+    if (found != byEndpoint_.end()) {
+        auto& entries = found->second;
+        entries.erase(std::find(entries.begin(), entries.end(), entry));
+        if (entries.empty()) {
+            byEndpoint_.erase(found);
+        }
+    }
+    SSL_SESSION_free(entry->session);
+    order_.erase(entry);
+}
+
+void SessionCache::evictLocked(std::chrono::steady_clock::time_point now) {
+    while (!order_.empty() && (order_.size() > maxSessions_ || order_.front().expires <= now)) {
+        erase(order_.begin());
+        ++stats_.evictions;
+    }
+}
+
+void SessionCache::store(const std::string& endpoint, SSL_SESSION* session) {
+    if (!session) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+
+    // The session's own timeout can be shorter than the configured lifetime
+    const long issuedAge = static_cast<long>(std::time(nullptr)) - static_cast<long>(SSL_SESSION_get_time(session));
+    const long remaining = static_cast<long>(SSL_SESSION_get_timeout(session)) - std::max(0L, issuedAge);
+    const auto lifetime = std::min<std::chrono::seconds>(lifetime_, std::chrono::seconds(std::max(0L, remaining)));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (maxSessions_ == 0) {
+        SSL_SESSION_free(session);
+        return;
+    }
+    auto found = byEndpoint_.find(endpoint);
+    if (found != byEndpoint_.end() && found->second.size() >= MAX_SESSIONS_PER_ENDPOINT) {
+        erase(found->second.front());
+        ++stats_.evictions;
+    }
+    order_.push_back(Entry{endpoint, session, now + lifetime});
+    byEndpoint_[endpoint].push_back(std::prev(order_.end()));
+    evictLocked(now);
+}
+
+SSL_SESSION* SessionCache::take(const std::string& endpoint) {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    evictLocked(now);
+
+    auto found = byEndpoint_.find(endpoint);
+    while (found != byEndpoint_.end()) {
+        Order::iterator newest = found->second.back();
+        if (!usable(*newest, now)) {
+            erase(newest);
+            ++stats_.evictions;
+            found = byEndpoint_.find(endpoint);
+            continue;
+        }
+
+        ++stats_.hits;
+        SSL_SESSION* session = newest->session;
+        if (SSL_SESSION_get_protocol_version(session) == TLS1_3_VERSION) {
+            // Single use: the cache's reference goes to the caller
+            newest->session = nullptr;
+            erase(newest);
+        } else {
+            SSL_SESSION_up_ref(session);
+        }
+        return session;
+    }
+    ++stats_.misses;
+    return nullptr;
+}
+
+void SessionCache::remove(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = byEndpoint_.find(endpoint);
+    if (found == byEndpoint_.end()) {
+        return;
+    }
+    auto entries = found->second;
+    for (auto entry : entries) {
+        erase(entry);
+    }
+}
+
+void SessionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : order_) {
+        SSL_SESSION_free(entry.session);
+    }
+    order_.clear();
+    byEndpoint_.clear();
+}
+
+SessionCache::Stats SessionCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.sessions = order_.size();
+    return stats;
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,669 @@
+#include "xenocomm/core/shared_memory_transport.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+// Each word is written by one side only, on its own cache line where both sides poll
+struct SharedMemoryTransport::Ring {
+    alignas(64) std::atomic<uint64_t> head{0};  // Producer's write position, in bytes ever written
+    alignas(64) std::atomic<uint64_t> tail{0};  // Consumer's read position
+    alignas(64) std::atomic<uint32_t> dataSeq{0};  // Futex the consumer sleeps on
+    std::atomic<uint32_t> consumerWaiting{0};
+    alignas(64) std::atomic<uint32_t> spaceSeq{0};  // Futex the producer sleeps on
+    std::atomic<uint32_t> producerWaiting{0};
+};
+
+struct SharedMemoryTransport::Segment {
+    std::atomic<uint32_t> magic{0};  // Set last by the creator, once the rest is initialized
+    uint32_t capacity = 0;
+    std::atomic<uint32_t> attached[2] = {};  // Per side: 0 not yet, 1 attached, 2 left
+    Ring rings[2];
+    // The two rings' bytes follow, capacity each
+
+    uint8_t* data(int ring) { return reinterpret_cast<uint8_t*>(this + 1) + static_cast<size_t>(ring) * capacity; }
+};
+
+namespace {
+
+constexpr uint32_t SEGMENT_MAGIC = 0x58434D31;  // "XCM1"
+constexpr size_t PREFIX_SIZE = 4;                // Length before each message in a ring
+constexpr int SPIN_ITERATIONS = 64;
+constexpr auto LIVENESS_POLL = std::chrono::milliseconds(100);  // Longest sleep before rechecking the peer
+
+enum : uint32_t { SIDE_ABSENT = 0, SIDE_ATTACHED = 1, SIDE_LEFT = 2 };
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Ring words must be lock-free to be shared between processes");
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 4096;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    // Not FUTEX_PRIVATE: the word lives in memory shared with another process
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(50)));
+#endif
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+    word.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+void copyIn(uint8_t* ring, size_t capacity, uint64_t position, const uint8_t* source, size_t size) {
+    const size_t offset = static_cast<size_t>(position & (capacity - 1));
+    const size_t first = std::min(size, capacity - offset);
+    std::memcpy(ring + offset, source, first);
+    if (first < size) {
+        std::memcpy(ring, source + first, size - first);
+    }
+}
+
+void copyOut(const uint8_t* ring, size_t capacity, uint64_t position, uint8_t* destination, size_t size) {
+    const size_t offset = static_cast<size_t>(position & (capacity - 1));
+    const size_t first = std::min(size, capacity - offset);
+    std::memcpy(destination, ring + offset, first);
+    if (first < size) {
+        std::memcpy(destination + first, ring, size - first);
+    }
+}
+
+bool splitEndpoint(const std::string& endpoint, std::string& host, uint16_t& port) {
+    const size_t colon = endpoint.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 >= endpoint.size()) {
+        return false;
+    }
+    host = endpoint.substr(0, colon);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    try {
+        const unsigned long value = std::stoul(endpoint.substr(colon + 1));
+        if (value == 0 || value > 65535) {
+            return false;
+        }
+        port = static_cast<uint16_t>(value);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+SharedMemoryTransport::SharedMemoryTransport(size_t ringCapacity) : capacity_(roundUpPowerOfTwo(ringCapacity)) {}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    disconnect();
+}
+
+bool SharedMemoryTransport::isLocalEndpoint(const std::string& endpoint) {
+    std::string host;
+    uint16_t port = 0;
+    if (!splitEndpoint(endpoint, host, port)) {
+        return false;
+    }
+    if (host == "localhost") {
+        return true;
+    }
+    in_addr v4{};
+    in6_addr v6{};
+    if (inet_pton(AF_INET, host.c_str(), &v4) == 1) {
+        if ((ntohl(v4.s_addr) >> 24) == 127) {
+            return true;
+        }
+    } else if (inet_pton(AF_INET6, host.c_str(), &v6) == 1) {
+        if (IN6_IS_ADDR_LOOPBACK(&v6)) {
+            return true;
+        }
+    } else {
+        return false;
+    }
+
+    // One of this host's own interface addresses is local too
+    ifaddrs* interfaces = nullptr;
+    if (getifaddrs(&interfaces) != 0) {
+        return false;
+    }
+    bool local = false;
+    for (ifaddrs* entry = interfaces; entry && !local; entry = entry->ifa_next) {
+        if (!entry->ifa_addr) {
+            continue;
+        }
+        if (entry->ifa_addr->sa_family == AF_INET) {
+            local = reinterpret_cast<sockaddr_in*>(entry->ifa_addr)->sin_addr.s_addr == v4.s_addr &&
+                    v4.s_addr != 0;
+        } else if (entry->ifa_addr->sa_family == AF_INET6) {
+            local = std::memcmp(&reinterpret_cast<sockaddr_in6*>(entry->ifa_addr)->sin6_addr, &v6, sizeof(v6)) == 0 &&
+                    !IN6_IS_ADDR_UNSPECIFIED(&v6);
+        }
+    }
+    freeifaddrs(interfaces);
+    return local;
+}
+
+bool SharedMemoryTransport::connect(const std::string& endpoint, const ConnectionConfig& config) {
+    if (isConnected()) {
+        setError(TransportError::ALREADY_CONNECTED, "Already connected");
+        return false;
+    }
+    std::string host;
+    uint16_t peerPort = 0;
+    if (!splitEndpoint(endpoint, host, peerPort)) {
+        setError(TransportError::INVALID_ADDRESS, "Invalid endpoint format: " + endpoint);
+        return false;
+    }
+    if (!isLocalEndpoint(endpoint)) {
+        setError(TransportError::INVALID_ADDRESS, "Shared memory needs a peer on this host: " + endpoint);
+        return false;
+    }
+    const uint16_t localPort = config.localPort ? config.localPort : localPort_;
+    if (localPort == 0 || localPort == peerPort) {
+        setError(TransportError::INVALID_PARAMETER, "Shared memory needs distinct local and peer ports");
+        return false;
+    }
+    updateState(ConnectionState::CONNECTING);
+
+    const std::string name = "/xenocomm-" + std::to_string(std::min(localPort, peerPort)) + "-" +
+                             std::to_string(std::max(localPort, peerPort));
+    const int side = localPort < peerPort ? 0 : 1;
+    const size_t size = sizeof(Segment) + 2 * capacity_;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.connectionTimeoutMs);
+    auto fail = [&](TransportError code, const std::string& details) {
+        setError(code, details);
+        updateState(ConnectionState::ERROR);
+        return false;
+    };
+
+    Segment* segment = nullptr;
+    bool created = false;
+    while (!segment) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return fail(TransportError::CONNECTION_TIMEOUT, "Timed out opening shared memory " + name);
+        }
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        created = fd >= 0;
+        if (created) {
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                ::close(fd);
+                shm_unlink(name.c_str());
+                return fail(TransportError::RESOURCE_ERROR, "Failed to size shared memory: " +
+                                                                std::string(std::strerror(errno)));
+            }
+        } else if (errno == EEXIST) {
+            fd = shm_open(name.c_str(), O_RDWR, 0);
+            struct stat st{};
+            if (fd < 0 || fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size) {
+                // Unlinked meanwhile, or the creator has not sized it yet
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+        } else {
+            return fail(TransportError::RESOURCE_ERROR, "Failed to open shared memory: " +
+                                                            std::string(std::strerror(errno)));
+        }
+
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            if (created) {
+                shm_unlink(name.c_str());
+            }
+            return fail(TransportError::RESOURCE_ERROR, "Failed to map shared memory: " +
+                                                            std::string(std::strerror(errno)));
+        }
+        Segment* candidate = static_cast<Segment*>(mapped);
+        if (created) {
+            new (candidate) Segment();
+            candidate->capacity = static_cast<uint32_t>(capacity_);
+            candidate->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+        }
+        while (candidate->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        uint32_t absent = SIDE_ABSENT;
+        if (candidate->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC || candidate->capacity != capacity_) {
+            munmap(mapped, size);
+            return fail(TransportError::CONNECTION_FAILED, "Shared memory " + name + " has a different layout");
+        }
+        if (!candidate->attached[side].compare_exchange_strong(absent, SIDE_ATTACHED)) {
+            // Left over from an earlier connection on these ports; start a fresh one
+            munmap(mapped, size);
+            shm_unlink(name.c_str());
+            continue;
+        }
+        segment = candidate;
+    }
+
+    while (segment->attached[1 - side].load(std::memory_order_acquire) != SIDE_ATTACHED) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            segment->attached[side].store(SIDE_ABSENT, std::memory_order_release);
+            munmap(segment, size);
+            if (created) {
+                shm_unlink(name.c_str());
+            }
+            return fail(TransportError::CONNECTION_TIMEOUT, "Peer did not attach to shared memory " + name);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Both are mapped, so nothing needs the name any more
+    shm_unlink(name.c_str());
+
+    {
+        std::lock_guard<std::mutex> sendLock(sendMutex_);
+        std::lock_guard<std::mutex> receiveLock(receiveMutex_);
+        segment_ = segment;
+        mappedSize_ = size;
+        side_ = side;
+        name_ = name;
+        endpoint_ = endpoint;
+        peerHost_ = host;
+        peerPort_ = peerPort;
+        localPort_ = localPort;
+        partial_.reset();
+        partialOffset_ = 0;
+        closing_.store(false);
+    }
+    updateState(ConnectionState::CONNECTED);
+    return true;
+}
+
+bool SharedMemoryTransport::disconnect() {
+    if (!segment_ || closing_.exchange(true)) {
+        return true;
+    }
+    // Tell the peer we are gone and wake everyone sleeping on either ring, then
+    // wait for our own blocked calls to notice before the memory goes away
+    segment_->attached[side_].store(SIDE_LEFT, std::memory_order_release);
+    for (Ring& ring : segment_->rings) {
+        futexWake(ring.dataSeq);
+        futexWake(ring.spaceSeq);
+    }
+    {
+        std::lock_guard<std::mutex> sendLock(sendMutex_);
+        std::lock_guard<std::mutex> receiveLock(receiveMutex_);
+        unmap();
+    }
+    updateState(ConnectionState::DISCONNECTED);
+    return true;
+}
+
+void SharedMemoryTransport::unmap() {
+    if (segment_) {
+        munmap(segment_, mappedSize_);
+        segment_ = nullptr;
+        mappedSize_ = 0;
+    }
+}
+
+bool SharedMemoryTransport::isConnected() const {
+    return state_.load() == ConnectionState::CONNECTED;
+}
+
+bool SharedMemoryTransport::waitForData(Ring& ring, uint64_t tail, std::chrono::steady_clock::time_point deadline,
+                                        bool timed) {
+    for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+        if (ring.head.load(std::memory_order_acquire) != tail) {
+            return true;
+        }
+        cpuRelax();
+    }
+    while (true) {
+        if (closing_.load() || segment_->attached[1 - side_].load(std::memory_order_acquire) != SIDE_ATTACHED) {
+            return ring.head.load(std::memory_order_acquire) != tail;
+        }
+        const uint32_t seq = ring.dataSeq.load(std::memory_order_acquire);
+        // The producer publishes head, then checks this flag; one of us sees the other
+        ring.consumerWaiting.store(1, std::memory_order_seq_cst);
+        if (ring.head.load(std::memory_order_seq_cst) != tail) {
+            ring.consumerWaiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        auto wait = std::chrono::nanoseconds(LIVENESS_POLL);
+        if (timed) {
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                ring.consumerWaiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            wait = std::min<std::chrono::nanoseconds>(wait, remaining);
+        }
+        futexWait(ring.dataSeq, seq, wait);
+        ring.consumerWaiting.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool SharedMemoryTransport::waitForSpace(Ring& ring, uint64_t head, size_t needed,
+                                         std::chrono::steady_clock::time_point deadline, bool timed) {
+    auto hasSpace = [&](std::memory_order order) {
+        return capacity_ - static_cast<size_t>(head - ring.tail.load(order)) >= needed;
+    };
+    for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+        if (hasSpace(std::memory_order_acquire)) {
+            return true;
+        }
+        cpuRelax();
+    }
+    while (true) {
+        if (closing_.load() || segment_->attached[1 - side_].load(std::memory_order_acquire) != SIDE_ATTACHED) {
+            return false;
+        }
+        const uint32_t seq = ring.spaceSeq.load(std::memory_order_acquire);
+        ring.producerWaiting.store(1, std::memory_order_seq_cst);
+        if (hasSpace(std::memory_order_seq_cst)) {
+            ring.producerWaiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        auto wait = std::chrono::nanoseconds(LIVENESS_POLL);
+        if (timed) {
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                ring.producerWaiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            wait = std::min<std::chrono::nanoseconds>(wait, remaining);
+        }
+        futexWait(ring.spaceSeq, seq, wait);
+        ring.producerWaiting.store(0, std::memory_order_relaxed);
+    }
+}
+
+ssize_t SharedMemoryTransport::sendv(const utils::ByteSpan* buffers, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += buffers[i].size();
+    }
+    if (total + PREFIX_SIZE > capacity_) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Message larger than the shared memory ring");
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (!segment_ || closing_.load()) {
+        setError(TransportError::NOT_CONNECTED, "Not connected");
+        return -1;
+    }
+    if (segment_->attached[1 - side_].load(std::memory_order_acquire) != SIDE_ATTACHED) {
+        setError(TransportError::CONNECTION_CLOSED, "Peer has disconnected");
+        return -1;
+    }
+    Ring& ring = segment_->rings[side_];
+    uint8_t* data = segment_->data(side_);
+    const size_t needed = PREFIX_SIZE + total;
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);  // Only we move it
+    if (capacity_ - static_cast<size_t>(head - ring.tail.load(std::memory_order_acquire)) < needed) {
+        if (nonBlocking_.load()) {
+            setError(TransportError::WOULD_BLOCK, "Shared memory ring is full");
+            return -1;
+        }
+        const int64_t timeoutMs = sendTimeoutMs_.load();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        if (!waitForSpace(ring, head, needed, deadline, timeoutMs > 0)) {
+            if (closing_.load() || segment_->attached[1 - side_].load() != SIDE_ATTACHED) {
+                setError(TransportError::CONNECTION_CLOSED, "Peer has disconnected");
+            } else {
+                setError(TransportError::TIMEOUT, "Shared memory ring still full at the send timeout");
+            }
+            return -1;
+        }
+    }
+
+    const uint32_t length = static_cast<uint32_t>(total);
+    const uint8_t prefix[PREFIX_SIZE] = {static_cast<uint8_t>(length >> 24), static_cast<uint8_t>(length >> 16),
+                                         static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+    uint64_t position = head;
+    copyIn(data, capacity_, position, prefix, PREFIX_SIZE);
+    position += PREFIX_SIZE;
+    for (size_t i = 0; i < count; ++i) {
+        if (buffers[i].size()) {
+            copyIn(data, capacity_, position, buffers[i].data(), buffers[i].size());
+            position += buffers[i].size();
+        }
+    }
+    ring.head.store(position, std::memory_order_seq_cst);
+    if (ring.consumerWaiting.load(std::memory_order_seq_cst)) {
+        futexWake(ring.dataSeq);
+    }
+    return static_cast<ssize_t>(total);
+}
+
+ssize_t SharedMemoryTransport::send(const uint8_t* data, size_t size) {
+    if (!data && size > 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+    const utils::ByteSpan part(data, size);
+    return sendv(&part, 1);
+}
+
+ssize_t SharedMemoryTransport::sendFrame(const utils::ByteSpan* parts, size_t count) {
+    return sendv(parts, count);
+}
+
+ssize_t SharedMemoryTransport::receiveMessage(utils::PooledBuffer& message, size_t maxSize) {
+    std::lock_guard<std::mutex> lock(receiveMutex_);
+    if (!segment_ || closing_.load()) {
+        setError(TransportError::NOT_CONNECTED, "Not connected");
+        return -1;
+    }
+    Ring& ring = segment_->rings[1 - side_];
+    const uint8_t* data = segment_->data(1 - side_);
+    const uint64_t tail = ring.tail.load(std::memory_order_relaxed);  // Only we move it
+    if (ring.head.load(std::memory_order_acquire) == tail) {
+        if (nonBlocking_.load()) {
+            setError(TransportError::WOULD_BLOCK, "No message available");
+            return -1;
+        }
+        const int64_t timeoutMs = receiveTimeoutMs_.load();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        if (!waitForData(ring, tail, deadline, timeoutMs > 0)) {
+            if (closing_.load() || segment_->attached[1 - side_].load() != SIDE_ATTACHED) {
+                setError(TransportError::CONNECTION_CLOSED, "Peer has disconnected");
+            } else {
+                setError(TransportError::TIMEOUT, "No message within the receive timeout");
+            }
+            return -1;
+        }
+    }
+
+    // The producer publishes whole messages, so all of this one is already there
+    uint8_t prefix[PREFIX_SIZE];
+    copyOut(data, capacity_, tail, prefix, PREFIX_SIZE);
+    const size_t length = (size_t(prefix[0]) << 24) | (size_t(prefix[1]) << 16) | (size_t(prefix[2]) << 8) |
+                          size_t(prefix[3]);
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    if (length + PREFIX_SIZE > head - tail) {
+        setError(TransportError::RECEIVE_ERROR, "Corrupt shared memory ring");
+        return -1;
+    }
+    ssize_t result = static_cast<ssize_t>(length);
+    if (length > maxSize) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Message larger than the receive buffer");
+        result = -1;
+    } else {
+        message = utils::BufferPool::shared().acquire(std::max<size_t>(length, 1));
+        message.resize(length);
+        if (length) {
+            copyOut(data, capacity_, tail + PREFIX_SIZE, message.data(), length);
+        }
+    }
+    ring.tail.store(tail + PREFIX_SIZE + length, std::memory_order_seq_cst);
+    if (ring.producerWaiting.load(std::memory_order_seq_cst)) {
+        futexWake(ring.spaceSeq);
+    }
+    return result;
+}
+
+ssize_t SharedMemoryTransport::receiveFrame(utils::PooledBuffer& frame) {
+    return receiveMessage(frame, SIZE_MAX);
+}
+
+ssize_t SharedMemoryTransport::receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) {
+    return receiveMessage(buffer, maxSize);
+}
+
+ssize_t SharedMemoryTransport::receive(uint8_t* buffer, size_t size) {
+    if (!buffer || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid receive parameters");
+        return -1;
+    }
+    // Only one reader at a time may use receive(); the rest of a message waits for the next call
+    if (partialOffset_ >= partial_.size()) {
+        partial_.reset();
+        partialOffset_ = 0;
+        if (receiveFrame(partial_) < 0) {
+            return getLastErrorCode() == TransportError::TIMEOUT ? 0 : -1;
+        }
+    }
+    const size_t n = std::min(size, partial_.size() - partialOffset_);
+    if (n) {
+        std::memcpy(buffer, partial_.data() + partialOffset_, n);
+    }
+    partialOffset_ += n;
+    return static_cast<ssize_t>(n);
+}
+
+bool SharedMemoryTransport::getPeerAddress(std::string& address, uint16_t& port) {
+    if (!isConnected()) {
+        return false;
+    }
+    address = peerHost_;
+    port = peerPort_;
+    return true;
+}
+
+bool SharedMemoryTransport::setNonBlocking(bool nonBlocking) {
+    nonBlocking_.store(nonBlocking);
+    return true;
+}
+
+bool SharedMemoryTransport::setReceiveTimeout(const std::chrono::milliseconds& timeout) {
+    receiveTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+bool SharedMemoryTransport::setSendTimeout(const std::chrono::milliseconds& timeout) {
+    sendTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+std::string SharedMemoryTransport::getLastError() const {
+    return getErrorDetails();
+}
+
+bool SharedMemoryTransport::setLocalPort(uint16_t port) {
+    if (isConnected()) {
+        return false;
+    }
+    localPort_ = port;
+    return true;
+}
+
+ConnectionState SharedMemoryTransport::getState() const {
+    return state_.load();
+}
+
+TransportError SharedMemoryTransport::getLastErrorCode() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+std::string SharedMemoryTransport::getErrorDetails() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return errorDetails_;
+}
+
+bool SharedMemoryTransport::reconnect(uint32_t maxAttempts, uint32_t delayMs) {
+    const std::string endpoint = endpoint_;
+    if (endpoint.empty()) {
+        setError(TransportError::RECONNECTION_FAILED, "Never connected");
+        return false;
+    }
+    disconnect();
+    ConnectionConfig config;
+    config.localPort = localPort_;
+    for (uint32_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        }
+        if (connect(endpoint, config)) {
+            return true;
+        }
+    }
+    setError(TransportError::RECONNECTION_FAILED, "Reconnection failed after " + std::to_string(maxAttempts) +
+                                                      " attempts");
+    return false;
+}
+
+void SharedMemoryTransport::setStateCallback(std::function<void(ConnectionState)> callback) {
+    stateCallback_ = std::move(callback);
+}
+
+void SharedMemoryTransport::setErrorCallback(std::function<void(TransportError, const std::string&)> callback) {
+    errorCallback_ = std::move(callback);
+}
+
+void SharedMemoryTransport::setError(TransportError code, const std::string& details) {
+    {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        lastError_ = code;
+        errorDetails_ = details;
+    }
+    if (errorCallback_) {
+        errorCallback_(code, details);
+    }
+}
+
+void SharedMemoryTransport::updateState(ConnectionState state) {
+    state_.store(state);
+    if (stateCallback_) {
+        stateCallback_(state);
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
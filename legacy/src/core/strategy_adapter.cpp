@@ -1,19 +1,20 @@
 #include "xenocomm/core/strategy_adapter.h"
+#include "xenocomm/core/strategy_tuner.h"
 #include "xenocomm/utils/logging.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
 #include <mutex>
+#include <optional>
+#include <random>
 #include <sstream>
 #include <numeric>
 #include <stdexcept>
-#include <iostream>
+#include <unordered_map>
 
 namespace xenocomm {
 
-// Simple logging implementation
-#define LOG_INFO(msg) std::cout << "[INFO] " << msg << std::endl
-#define LOG_ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl
-
 struct StrategyAdapter::Impl {
     std::shared_ptr<FeedbackLoop> feedback;
     AdaptationThresholds thresholds;
@@ -30,10 +31,92 @@ struct StrategyAdapter::Impl {
     };
     
     ABTestState abTest;
+
+    // Bandit state: a Beta(1 + successes, 1 + failures) posterior per strategy
+    struct BanditState {
+        BanditPolicy policy{BanditPolicy::THOMPSON_SAMPLING};
+        std::vector<BanditArmStats> arms;
+        std::unordered_map<std::string, size_t> armIndex;  // Strategy -> position in arms
+        uint64_t totalOutcomes{0};
+        bool isActive{false};
+    };
+
+    BanditState bandit;
+    std::shared_ptr<StrategyTuner> tuner;
+    std::mt19937_64 random{std::random_device{}()};
     mutable std::mutex mutex;
 
+    // The feedback window as last seen, and what was concluded from it
+    static constexpr uint64_t NO_GENERATION = std::numeric_limits<uint64_t>::max();
+    std::atomic<uint64_t> latestGeneration{NO_GENERATION};  // Set by the window listener
+    uint64_t subscription{0};
+    uint64_t snapshotGeneration{NO_GENERATION};
+    DetailedMetrics snapshot;
+    std::optional<StrategyRecommendation> recommendation;  // For snapshot and thresholds
+
     explicit Impl(std::shared_ptr<FeedbackLoop> fb)
-        : feedback(std::move(fb)) {}
+        : feedback(std::move(fb)) {
+        if (feedback) {
+            latestGeneration = feedback->getWindowGeneration();
+            subscription = feedback->subscribeWindowUpdates([this](uint64_t generation) {
+                latestGeneration.store(generation, std::memory_order_release);
+            });
+        }
+    }
+
+    ~Impl() {
+        if (feedback) {
+            feedback->unsubscribeWindowUpdates(subscription);
+        }
+    }
+
+    // Detailed metrics of the current window, fetched once per window generation. Requires mutex.
+    Result<const DetailedMetrics*> currentMetrics() {
+        auto generation = latestGeneration.load(std::memory_order_acquire);
+        if (generation == snapshotGeneration) {
+            return Result<const DetailedMetrics*>(&snapshot);
+        }
+        auto metricsResult = feedback->getDetailedMetrics();
+        if (metricsResult.has_error()) {
+            return Result<const DetailedMetrics*>(metricsResult.error());
+        }
+        snapshot = std::move(metricsResult.value());
+        snapshotGeneration = generation;
+        recommendation.reset();
+        return Result<const DetailedMetrics*>(&snapshot);
+    }
+
+    bool exceedsThresholds(const DetailedMetrics& metrics) const {
+        return metrics.basic.successRate < thresholds.minSuccessRate ||
+               metrics.latencyStats.mean > thresholds.maxLatencyMs ||
+               metrics.throughputStats.mean < thresholds.minThroughputBps ||
+               metrics.basic.errorRate > thresholds.maxErrorRate;
+    }
+
+    Result<StrategyRecommendation> recommend(const DetailedMetrics& metrics) const {
+        if (!meetsMinimumSamples(metrics)) {
+            return Result<StrategyRecommendation>(
+                "Insufficient samples for recommendation");
+        }
+
+        StrategyRecommendation result;
+        result.config = optimizeConfig(metrics);
+        result.confidenceScore = calculateConfidenceScore(metrics);
+        result.insights = generateInsights(metrics);
+
+        // Set recommendation validity period
+        result.validUntil = std::chrono::system_clock::now() + thresholds.evaluationWindow;
+
+        // Generate explanation
+        std::stringstream explanation;
+        explanation << "Recommendation based on: "
+                   << metrics.basic.totalTransactions << " transactions, "
+                   << "success rate: " << metrics.basic.successRate * 100 << "%, "
+                   << "avg latency: " << metrics.latencyStats.mean << "ms";
+        result.explanation = explanation.str();
+
+        return Result<StrategyRecommendation>(std::move(result));
+    }
 
     bool meetsMinimumSamples(const DetailedMetrics& metrics) const {
         return metrics.basic.totalTransactions >= thresholds.minSamplesRequired;
@@ -124,6 +207,36 @@ struct StrategyAdapter::Impl {
         return config;
     }
 
+    double sampleBeta(double alpha, double beta) {
+        double x = std::gamma_distribution<double>(alpha, 1.0)(random);
+        double y = std::gamma_distribution<double>(beta, 1.0)(random);
+        return x + y > 0 ? x / (x + y) : 0.5;
+    }
+
+    size_t selectArm() {
+        const auto& arms = bandit.arms;
+        size_t best = 0;
+        double bestScore = -1.0;
+        for (size_t i = 0; i < arms.size(); ++i) {
+            const auto& arm = arms[i];
+            double score;
+            if (bandit.policy == BanditPolicy::THOMPSON_SAMPLING) {
+                score = sampleBeta(1.0 + arm.successes, 1.0 + (arm.outcomes - arm.successes));
+            } else if (arm.outcomes == 0) {
+                return i;  // UCB1 tries every strategy once first
+            } else {
+                double n = static_cast<double>(arm.outcomes);
+                score = arm.successes / n +
+                        std::sqrt(2.0 * std::log(static_cast<double>(bandit.totalOutcomes)) / n);
+            }
+            if (score > bestScore) {
+                best = i;
+                bestScore = score;
+            }
+        }
+        return best;
+    }
+
     bool isSignificantDifference(double valueA, double valueB, 
                                 size_t samplesA, size_t samplesB) const {
         // Simple statistical significance test (t-test approximation)
@@ -142,15 +255,23 @@ Result<StrategyRecommendation> StrategyAdapter::evaluateAndRecommend() const {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
     try {
-        auto metricsResult = impl_->feedback->getDetailedMetrics();
+        auto metricsResult = impl_->currentMetrics();
         if (metricsResult.has_error()) {
             return Result<StrategyRecommendation>(
                 "Failed to get metrics: " + metricsResult.error());
         }
 
-        return getRecommendationForCondition(metricsResult.value());
+        // The same window and thresholds lead to the same recommendation
+        if (!impl_->recommendation) {
+            auto recommendation = impl_->recommend(*metricsResult.value());
+            if (recommendation.has_error()) {
+                return recommendation;
+            }
+            impl_->recommendation = std::move(recommendation.value());
+        }
+        return Result<StrategyRecommendation>(*impl_->recommendation);
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to evaluate and recommend strategy: " + std::string(e.what()));
+        XLOG_ERROR("Failed to evaluate and recommend strategy: {}", e.what());
         return Result<StrategyRecommendation>(
             "Failed to evaluate and recommend strategy: " + std::string(e.what()));
     }
@@ -161,31 +282,9 @@ Result<StrategyRecommendation> StrategyAdapter::getRecommendationForCondition(
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
     try {
-        if (!impl_->meetsMinimumSamples(metrics)) {
-            return Result<StrategyRecommendation>(
-                "Insufficient samples for recommendation");
-        }
-
-        StrategyRecommendation recommendation;
-        recommendation.config = impl_->optimizeConfig(metrics);
-        recommendation.confidenceScore = impl_->calculateConfidenceScore(metrics);
-        recommendation.insights = impl_->generateInsights(metrics);
-        
-        // Set recommendation validity period
-        recommendation.validUntil = std::chrono::system_clock::now() + 
-            impl_->thresholds.evaluationWindow;
-
-        // Generate explanation
-        std::stringstream explanation;
-        explanation << "Recommendation based on: "
-                   << metrics.basic.totalTransactions << " transactions, "
-                   << "success rate: " << metrics.basic.successRate * 100 << "%, "
-                   << "avg latency: " << metrics.latencyStats.mean << "ms";
-        recommendation.explanation = explanation.str();
-
-        return Result<StrategyRecommendation>(std::move(recommendation));
+        return impl_->recommend(metrics);
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to get recommendation: " + std::string(e.what()));
+        XLOG_ERROR("Failed to get recommendation: {}", e.what());
         return Result<StrategyRecommendation>(
             "Failed to get recommendation: " + std::string(e.what()));
     }
@@ -213,7 +312,7 @@ Result<void> StrategyAdapter::startABTest(
 
         return Result<void>();
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to start A/B test: " + std::string(e.what()));
+        XLOG_ERROR("Failed to start A/B test: {}", e.what());
         return Result<void>(
             "Failed to start A/B test: " + std::string(e.what()));
     }
@@ -244,7 +343,7 @@ Result<void> StrategyAdapter::recordABTestOutcome(
 
         return Result<void>();
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to record A/B test outcome: " + std::string(e.what()));
+        XLOG_ERROR("Failed to record A/B test outcome: {}", e.what());
         return Result<void>(
             "Failed to record A/B test outcome: " + std::string(e.what()));
     }
@@ -316,15 +415,89 @@ Result<ABTestResult> StrategyAdapter::getABTestResults() const {
 
         return Result<ABTestResult>(std::move(result));
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to get A/B test results: " + std::string(e.what()));
+        XLOG_ERROR("Failed to get A/B test results: {}", e.what());
         return Result<ABTestResult>(
             "Failed to get A/B test results: " + std::string(e.what()));
     }
 }
 
+Result<void> StrategyAdapter::startBandit(const std::vector<std::string>& strategies,
+                                         BanditPolicy policy, std::optional<uint64_t> seed) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    try {
+        if (strategies.empty()) {
+            return Result<void>("Bandit needs at least one strategy");
+        }
+
+        Impl::BanditState bandit;
+        bandit.policy = policy;
+        for (const auto& strategy : strategies) {
+            if (!bandit.armIndex.emplace(strategy, bandit.arms.size()).second) {
+                return Result<void>("Duplicate strategy: " + strategy);
+            }
+            BanditArmStats arm;
+            arm.strategy = strategy;
+            bandit.arms.push_back(std::move(arm));
+        }
+        bandit.isActive = true;
+        impl_->bandit = std::move(bandit);
+        if (seed) {
+            impl_->random.seed(*seed);
+        }
+        return Result<void>();
+    } catch (const std::exception& e) {
+        XLOG_ERROR("Failed to start bandit: {}", e.what());
+        return Result<void>("Failed to start bandit: " + std::string(e.what()));
+    }
+}
+
+std::optional<std::string> StrategyAdapter::selectStrategy() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    if (!impl_->bandit.isActive) {
+        return std::nullopt;
+    }
+    return impl_->bandit.arms[impl_->selectArm()].strategy;
+}
+
+Result<void> StrategyAdapter::recordBanditOutcome(const std::string& strategy,
+                                                  const CommunicationOutcome& outcome) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    auto& bandit = impl_->bandit;
+    if (!bandit.isActive) {
+        return Result<void>("No active bandit");
+    }
+    auto it = bandit.armIndex.find(strategy);
+    if (it == bandit.armIndex.end()) {
+        return Result<void>("Unknown strategy: " + strategy);
+    }
+
+    auto& arm = bandit.arms[it->second];
+    ++arm.outcomes;
+    ++bandit.totalOutcomes;
+    if (outcome.success) {
+        ++arm.successes;
+    }
+    arm.meanLatencyUs += (outcome.latency.count() - arm.meanLatencyUs) / arm.outcomes;
+    arm.expectedSuccessRate = (1.0 + arm.successes) / (2.0 + arm.outcomes);
+    return Result<void>();
+}
+
+Result<std::vector<BanditArmStats>> StrategyAdapter::getBanditStats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    if (!impl_->bandit.isActive) {
+        return Result<std::vector<BanditArmStats>>(std::string("No active bandit"));
+    }
+    return Result<std::vector<BanditArmStats>>(impl_->bandit.arms);
+}
+
 void StrategyAdapter::setAdaptationThresholds(const AdaptationThresholds& thresholds) {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     impl_->thresholds = thresholds;
+    impl_->recommendation.reset();
 }
 
 const AdaptationThresholds& StrategyAdapter::getAdaptationThresholds() const {
@@ -335,16 +508,16 @@ Result<std::vector<std::string>> StrategyAdapter::getPerformanceInsights() const
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
     try {
-        auto metricsResult = impl_->feedback->getDetailedMetrics();
+        auto metricsResult = impl_->currentMetrics();
         if (metricsResult.has_error()) {
             return Result<std::vector<std::string>>(
                 "Failed to get metrics: " + metricsResult.error());
         }
 
         return Result<std::vector<std::string>>(
-            impl_->generateInsights(metricsResult.value()));
+            impl_->generateInsights(*metricsResult.value()));
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to get performance insights: " + std::string(e.what()));
+        XLOG_ERROR("Failed to get performance insights: {}", e.what());
         return Result<std::vector<std::string>>(
             "Failed to get performance insights: " + std::string(e.what()));
     }
@@ -354,13 +527,13 @@ Result<std::map<std::string, double>> StrategyAdapter::getStrategyEffectiveness(
     std::lock_guard<std::mutex> lock(impl_->mutex);
     
     try {
-        auto metricsResult = impl_->feedback->getDetailedMetrics();
+        auto metricsResult = impl_->currentMetrics();
         if (metricsResult.has_error()) {
             return Result<std::map<std::string, double>>(
                 "Failed to get metrics: " + metricsResult.error());
         }
 
-        const auto& metrics = metricsResult.value();
+        const auto& metrics = *metricsResult.value();
         std::map<std::string, double> effectiveness;
         
         // Calculate effectiveness scores for different aspects
@@ -374,7 +547,7 @@ Result<std::map<std::string, double>> StrategyAdapter::getStrategyEffectiveness(
         
         return Result<std::map<std::string, double>>(std::move(effectiveness));
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to get strategy effectiveness: " + std::string(e.what()));
+        XLOG_ERROR("Failed to get strategy effectiveness: {}", e.what());
         return Result<std::map<std::string, double>>(
             "Failed to get strategy effectiveness: " + std::string(e.what()));
     }
@@ -390,15 +563,9 @@ Result<bool> StrategyAdapter::shouldAdaptStrategy(
         }
 
         // Check if any threshold is violated
-        bool shouldAdapt = 
-            currentMetrics.basic.successRate < impl_->thresholds.minSuccessRate ||
-            currentMetrics.latencyStats.mean > impl_->thresholds.maxLatencyMs ||
-            currentMetrics.throughputStats.mean < impl_->thresholds.minThroughputBps ||
-            currentMetrics.basic.errorRate > impl_->thresholds.maxErrorRate;
-
-        return Result<bool>(shouldAdapt);
+        return Result<bool>(impl_->exceedsThresholds(currentMetrics));
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to determine adaptation need: " + std::string(e.what()));
+        XLOG_ERROR("Failed to determine adaptation need: {}", e.what());
         return Result<bool>(
             "Failed to determine adaptation need: " + std::string(e.what()));
     }
@@ -413,12 +580,23 @@ Result<StrategyConfig> StrategyAdapter::getOptimalConfig(
             return Result<StrategyConfig>("Insufficient samples for optimization");
         }
 
-        return Result<StrategyConfig>(impl_->optimizeConfig(metrics));
+        StrategyConfig config = impl_->optimizeConfig(metrics);
+        if (impl_->tuner) {
+            if (auto tuned = impl_->tuner->learned(StrategyTuner::classify(metrics))) {
+                applyTuned(*tuned, config);
+            }
+        }
+        return Result<StrategyConfig>(std::move(config));
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to get optimal config: " + std::string(e.what()));
+        XLOG_ERROR("Failed to get optimal config: {}", e.what());
         return Result<StrategyConfig>(
             "Failed to get optimal config: " + std::string(e.what()));
     }
 }
 
+void StrategyAdapter::setTuner(std::shared_ptr<StrategyTuner> tuner) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->tuner = std::move(tuner);
+}
+
 } // namespace xenocomm 
\ No newline at end of file
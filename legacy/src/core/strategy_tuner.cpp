@@ -0,0 +1,415 @@
+#include "xenocomm/core/strategy_tuner.h"
+#include "xenocomm/core/strategy_adapter.h"
+#include "xenocomm/utils/logging.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace xenocomm {
+
+namespace {
+
+constexpr const char* TUNER_FILE_HEADER = "# xenocomm strategy tuner v1";
+
+// Spread assumed for a score measured only once, in log units (about 10%)
+constexpr double PRIOR_STDDEV = 0.1;
+
+double variance(uint64_t trials, double m2) {
+    return trials > 1 ? m2 / static_cast<double>(trials - 1) : PRIOR_STDDEV * PRIOR_STDDEV;
+}
+
+size_t nearestIndex(const std::vector<double>& values, double value) {
+    size_t nearest = 0;
+    for (size_t i = 1; i < values.size(); ++i) {
+        if (std::abs(values[i] - value) < std::abs(values[nearest] - value)) {
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+template <typename T>
+void set(const TunedValues& tuned, const char* name, T& field) {
+    auto it = tuned.find(name);
+    if (it != tuned.end()) {
+        field = static_cast<T>(std::llround(it->second));
+    }
+}
+
+void set(const TunedValues& tuned, const char* name, double& field) {
+    auto it = tuned.find(name);
+    if (it != tuned.end()) {
+        field = it->second;
+    }
+}
+
+void set(const TunedValues& tuned, const char* name, std::chrono::milliseconds& field) {
+    auto it = tuned.find(name);
+    if (it != tuned.end()) {
+        field = std::chrono::milliseconds(std::llround(it->second));
+    }
+}
+
+} // namespace
+
+StrategyTuner::StrategyTuner(const StrategyTunerConfig& config, std::vector<TunerParameter> parameters)
+    : config_(config), parameters_(std::move(parameters)) {
+    std::unordered_set<std::string> names;
+    for (const auto& parameter : parameters_) {
+        if (parameter.name.empty() || parameter.name.find_first_of("=\t\n") != std::string::npos) {
+            throw std::invalid_argument("Invalid tuner parameter name: " + parameter.name);
+        }
+        if (!names.insert(parameter.name).second) {
+            throw std::invalid_argument("Duplicate tuner parameter: " + parameter.name);
+        }
+        if (parameter.values.empty() || parameter.initial >= parameter.values.size() ||
+            !std::is_sorted(parameter.values.begin(), parameter.values.end())) {
+            throw std::invalid_argument("Tuner parameter " + parameter.name +
+                                        " needs ascending values and an initial index among them");
+        }
+    }
+    if (!config_.persistencePath.empty()) {
+        auto loaded = load();
+        if (loaded.has_error()) {
+            XLOG_WARN("Starting strategy tuner without learned configurations: {}", loaded.error());
+        }
+    }
+}
+
+std::vector<TunerParameter> StrategyTuner::defaultParameters() {
+    return {
+        {"fragmentSize", {256, 512, 1024, 2048, 4096, 8192}, 2},
+        {"windowSize", {4, 8, 16, 32, 64}, 2},
+        {"maxRetries", {1, 2, 3, 4, 6}, 2},
+        {"timeoutMs", {250, 500, 1000, 2000, 4000}, 2},
+        {"initialWindowBytes", {16384, 32768, 65535, 131072, 262144}, 2},
+        {"pacingGain", {1.0, 1.25, 1.5, 2.0}, 1},
+        {"pacingBurstFragments", {1, 2, 4, 8}, 1},
+        {"batchMaxDelayMs", {1, 2, 5, 10, 20}, 2},
+        {"batchMaxMessages", {8, 16, 32, 64}, 2},
+        {"recordInitialSize", {1024, 2048, 4096, 8192, 16384}, 2},
+    };
+}
+
+std::string StrategyTuner::classify(const DetailedMetrics& metrics) {
+    if (metrics.basic.errorRate > 0.05) {
+        return "lossy";
+    }
+    if (metrics.latencyStats.mean >= 300.0) {
+        return "satellite";
+    }
+    return metrics.latencyStats.mean >= 20.0 ? "wan" : "lan";
+}
+
+TunerTrial StrategyTuner::propose(const std::string& linkClass) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& current = state(linkClass);
+
+    TunerTrial trial;
+    trial.linkClass = linkClass;
+    trial.epoch = current.epoch;
+
+    // Moves are judged against the incumbent, so it is measured first and keeps being re-measured
+    bool explore = current.incumbent.trials >= config_.minTrials &&
+                   std::bernoulli_distribution(std::clamp(config_.exploreShare, 0.0, 1.0))(random_);
+    if (explore) {
+        size_t chosen = current.moves.size();
+        double bestDraw = -std::numeric_limits<double>::infinity();
+        for (size_t move = 0; move < current.moves.size(); ++move) {
+            if (!canMove(current, move)) {
+                continue;
+            }
+            const auto& arm = current.moves[move];
+            if (arm.trials == 0) {
+                chosen = move;  // Untried moves first
+                break;
+            }
+            double spread = std::sqrt(variance(arm.trials, arm.m2) / static_cast<double>(arm.trials));
+            double draw = std::normal_distribution<double>(arm.mean, spread)(random_);
+            if (draw > bestDraw) {
+                chosen = move;
+                bestDraw = draw;
+            }
+        }
+        if (chosen < current.moves.size()) {
+            trial.parameter = static_cast<int>(chosen / 2);
+            trial.direction = chosen % 2 ? 1 : -1;
+        }
+    }
+
+    auto position = current.position;
+    if (trial.parameter >= 0) {
+        position[trial.parameter] += trial.direction;
+    }
+    trial.values = valuesAt(position);
+    return trial;
+}
+
+void StrategyTuner::record(const TunerTrial& trial, double goodputBps, double p99LatencyMs) {
+    const double score = std::log(std::max(goodputBps, 1.0)) -
+                         config_.latencyWeight * std::log(std::max(p99LatencyMs, 1e-3));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& current = state(trial.linkClass);
+    ++current.trials;
+    if (trial.epoch != current.epoch) {
+        return;  // Proposed against an incumbent that has since moved
+    }
+    if (trial.parameter < 0) {
+        update(current.incumbent, score);
+        return;
+    }
+
+    const size_t move = 2 * static_cast<size_t>(trial.parameter) + (trial.direction > 0 ? 1 : 0);
+    if (move >= current.moves.size()) {
+        return;
+    }
+    auto& arm = current.moves[move];
+    update(arm, score);
+    const auto& incumbent = current.incumbent;
+    if (arm.trials == 1 && incumbent.trials > 0 &&
+        score < incumbent.mean + std::log(config_.safetyFloor)) {
+        arm.abandoned = true;
+        return;
+    }
+    if (arm.trials < config_.minTrials || incumbent.trials < config_.minTrials) {
+        return;
+    }
+    double standardError = std::sqrt(variance(arm.trials, arm.m2) / static_cast<double>(arm.trials) +
+                                     variance(incumbent.trials, incumbent.m2) /
+                                         static_cast<double>(incumbent.trials));
+    if (arm.mean - incumbent.mean - 2.0 * standardError > config_.acceptMargin) {
+        adopt(current, move);
+        if (!config_.persistencePath.empty()) {
+            auto saved = saveLocked();
+            if (saved.has_error()) {
+                XLOG_WARN("Failed to persist tuned configuration: {}", saved.error());
+            }
+        }
+    }
+}
+
+void StrategyTuner::record(const TunerTrial& trial, const DetailedMetrics& metrics) {
+    record(trial, metrics.throughputStats.mean, metrics.latencyStats.percentile99);
+}
+
+TunedValues StrategyTuner::best(const std::string& linkClass) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = classes_.find(linkClass);
+    if (it == classes_.end()) {
+        std::vector<size_t> initial;
+        for (const auto& parameter : parameters_) {
+            initial.push_back(parameter.initial);
+        }
+        return valuesAt(initial);
+    }
+    return valuesAt(it->second.position);
+}
+
+std::optional<TunedValues> StrategyTuner::learned(const std::string& linkClass) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = classes_.find(linkClass);
+    if (it == classes_.end()) {
+        return std::nullopt;
+    }
+    const auto& current = it->second;
+    if (current.incumbent.trials < config_.minTrials && current.adoptions == 0 && !current.restored) {
+        return std::nullopt;
+    }
+    return valuesAt(current.position);
+}
+
+TunerClassStats StrategyTuner::stats(const std::string& linkClass) const {
+    TunerClassStats result;
+    result.incumbent = best(linkClass);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = classes_.find(linkClass);
+    if (it != classes_.end()) {
+        result.incumbentScore = it->second.incumbent.mean;
+        result.incumbentTrials = it->second.incumbent.trials;
+        result.trials = it->second.trials;
+        result.adoptions = it->second.adoptions;
+    }
+    return result;
+}
+
+void StrategyTuner::reset(const std::string& linkClass) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    classes_.erase(linkClass);
+}
+
+Result<void> StrategyTuner::save() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return saveLocked();
+}
+
+Result<void> StrategyTuner::saveLocked() const {
+    if (config_.persistencePath.empty()) {
+        return Result<void>(std::string("No persistence path configured"));
+    }
+
+    // One line per class: its name, then name=value for every parameter
+    std::ostringstream out;
+    out.precision(17);
+    out << TUNER_FILE_HEADER << '\n';
+    for (const auto& [linkClass, current] : classes_) {
+        if (current.adoptions == 0 && !current.restored) {
+            continue;  // Nothing learned beyond the defaults
+        }
+        out << linkClass;
+        for (const auto& [name, value] : valuesAt(current.position)) {
+            out << '\t' << name << '=' << value;
+        }
+        out << '\n';
+    }
+
+    std::filesystem::path temporary(config_.persistencePath);
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!(file << out.str()) || !file.flush()) {
+            return Result<void>(std::string("Failed to write tuned configurations: " + temporary.string()));
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, config_.persistencePath, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return Result<void>(std::string("Failed to publish tuned configurations: " + config_.persistencePath));
+    }
+    return Result<void>();
+}
+
+Result<void> StrategyTuner::load() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (config_.persistencePath.empty()) {
+        return Result<void>(std::string("No persistence path configured"));
+    }
+    std::ifstream file(config_.persistencePath);
+    if (!file) {
+        std::error_code ec;
+        if (!std::filesystem::exists(config_.persistencePath, ec)) {
+            return Result<void>();  // Nothing learned yet
+        }
+        return Result<void>(std::string("Failed to open tuned configurations: " + config_.persistencePath));
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != TUNER_FILE_HEADER) {
+        return Result<void>(std::string("Not a tuned configuration file: " + config_.persistencePath));
+    }
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string linkClass;
+        if (!std::getline(fields, linkClass, '\t') || linkClass.empty()) {
+            continue;
+        }
+        TunedValues values;
+        std::string field;
+        while (std::getline(fields, field, '\t')) {
+            auto separator = field.find('=');
+            if (separator == std::string::npos) {
+                continue;
+            }
+            try {
+                values[field.substr(0, separator)] = std::stod(field.substr(separator + 1));
+            } catch (const std::exception&) {
+                continue;
+            }
+        }
+
+        // Values snap to the nearest allowed one, so an edited file or a changed grid stays in bounds
+        ClassState restored = ClassState();
+        restored.moves.resize(2 * parameters_.size());
+        for (const auto& parameter : parameters_) {
+            auto value = values.find(parameter.name);
+            restored.position.push_back(value == values.end() ? parameter.initial
+                                                              : nearestIndex(parameter.values, value->second));
+        }
+        restored.restored = true;
+        classes_[linkClass] = std::move(restored);
+    }
+    return Result<void>();
+}
+
+StrategyTuner::ClassState& StrategyTuner::state(const std::string& linkClass) {
+    auto [it, inserted] = classes_.try_emplace(linkClass);
+    if (inserted) {
+        for (const auto& parameter : parameters_) {
+            it->second.position.push_back(parameter.initial);
+        }
+        it->second.moves.resize(2 * parameters_.size());
+    }
+    return it->second;
+}
+
+TunedValues StrategyTuner::valuesAt(const std::vector<size_t>& position) const {
+    TunedValues values;
+    for (size_t i = 0; i < parameters_.size(); ++i) {
+        values[parameters_[i].name] = parameters_[i].values[position[i]];
+    }
+    return values;
+}
+
+bool StrategyTuner::canMove(const ClassState& state, size_t move) const {
+    if (state.moves[move].abandoned) {
+        return false;
+    }
+    size_t parameter = move / 2;
+    size_t index = state.position[parameter];
+    return move % 2 ? index + 1 < parameters_[parameter].values.size() : index > 0;
+}
+
+void StrategyTuner::adopt(ClassState& state, size_t move) {
+    size_t parameter = move / 2;
+    state.position[parameter] = move % 2 ? state.position[parameter] + 1 : state.position[parameter] - 1;
+    // The move's trials measured exactly the new incumbent
+    state.incumbent = state.moves[move];
+    state.incumbent.abandoned = false;
+    std::fill(state.moves.begin(), state.moves.end(), Arm());
+    ++state.epoch;
+    ++state.adoptions;
+    XLOG_INFO("Tuner adopted {}={}", parameters_[parameter].name,
+              parameters_[parameter].values[state.position[parameter]]);
+}
+
+void StrategyTuner::update(Arm& arm, double score) {
+    // Welford's running mean and variance
+    ++arm.trials;
+    double delta = score - arm.mean;
+    arm.mean += delta / static_cast<double>(arm.trials);
+    arm.m2 += delta * (score - arm.mean);
+}
+
+void applyTuned(const TunedValues& tuned, StrategyConfig& config) {
+    set(tuned, "fragmentSize", config.fragmentSize);
+    set(tuned, "windowSize", config.windowSize);
+    set(tuned, "maxRetries", config.maxRetries);
+    set(tuned, "timeoutMs", config.timeout);
+}
+
+void applyTuned(const TunedValues& tuned, core::TransmissionManager::FragmentConfig& fragment,
+                core::TransmissionManager::FlowControlConfig& flow) {
+    set(tuned, "fragmentSize", fragment.max_fragment_size);
+    fragment.min_fragment_size = std::min(fragment.min_fragment_size, fragment.max_fragment_size);
+    set(tuned, "initialWindowBytes", flow.initial_window_size);
+    flow.initial_window_size = std::clamp(flow.initial_window_size, flow.min_window_size, flow.max_window_size);
+    set(tuned, "pacingGain", flow.pacing_gain);
+    set(tuned, "pacingBurstFragments", flow.pacing_burst_fragments);
+}
+
+void applyTuned(const TunedValues& tuned, core::RecordBatchingConfig& batching,
+                core::AdaptiveRecordConfig& records) {
+    set(tuned, "batchMaxDelayMs", batching.maxDelay);
+    set(tuned, "batchMaxMessages", batching.maxMessagesPerBatch);
+    set(tuned, "recordInitialSize", records.initialSize);
+    records.initialSize = std::clamp(records.initialSize, records.minSize, records.maxSize);
+}
+
+} // namespace xenocomm
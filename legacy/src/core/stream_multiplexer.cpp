@@ -0,0 +1,707 @@
+#include "xenocomm/core/stream_multiplexer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+constexpr size_t READ_BLOCK_SIZE = 64 * 1024;
+// Smaller single-chunk messages are copied out, so they don't pin a whole read block
+constexpr size_t ZERO_COPY_MIN = 4096;
+
+void putU32(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+uint32_t getU32(const uint8_t* in) {
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+}
+
+} // namespace
+
+std::shared_ptr<StreamMultiplexer> StreamMultiplexer::create(std::shared_ptr<TransportProtocol> transport,
+                                                             Role role, const MultiplexerConfig& config) {
+    if (!transport || !transport->isConnected()) {
+        throw std::invalid_argument("StreamMultiplexer needs a connected transport");
+    }
+    std::shared_ptr<StreamMultiplexer> mux(new StreamMultiplexer(std::move(transport), role, config));
+    mux->start();
+    return mux;
+}
+
+StreamMultiplexer::StreamMultiplexer(std::shared_ptr<TransportProtocol> transport, Role role,
+                                     const MultiplexerConfig& config)
+    : transport_(std::move(transport)), role_(role), config_([&config] {
+          MultiplexerConfig clamped = config;
+          clamped.chunkSize = std::clamp<size_t>(clamped.chunkSize, 1, READ_BLOCK_SIZE - FRAME_HEADER_SIZE);
+          clamped.initialStreamWindow = std::max<uint32_t>(clamped.initialStreamWindow, 1);
+          return clamped;
+      }()),
+      nextStreamId_(role == Role::Initiator ? 1 : 2) {}
+
+void StreamMultiplexer::start() {
+    transport_->setReceiveTimeout(std::chrono::milliseconds(config_.pollIntervalMs));
+    writer_ = std::thread(&StreamMultiplexer::writerLoop, this);
+    reader_ = std::thread(&StreamMultiplexer::readerLoop, this);
+}
+
+StreamMultiplexer::~StreamMultiplexer() {
+    shutdown();
+}
+
+void StreamMultiplexer::shutdown() {
+    std::deque<std::shared_ptr<MultiplexedStream>> unaccepted;  // Released only once the lock is dropped
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_) {
+            stopping_ = true;
+            for (auto& [id, stream] : streams_) {
+                stream->localClosed_ = true;
+                failStreamSends(*stream);
+                if (!failed_ && !stream->remoteClosed_) {
+                    queueControl(FrameType::RESET, id, 0);
+                }
+                stream->cv_.notify_all();
+            }
+            streams_.clear();
+            ready_.clear();
+        }
+        unaccepted.swap(accepting_);
+        writerCv_.notify_all();
+        acceptCv_.notify_all();
+    }
+    for (std::thread* thread : {&writer_, &reader_}) {
+        if (thread->joinable() && thread->get_id() != std::this_thread::get_id()) {
+            thread->join();
+        }
+    }
+}
+
+bool StreamMultiplexer::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !stopping_ && !failed_;
+}
+
+std::string StreamMultiplexer::getErrorDetails() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+size_t StreamMultiplexer::streamCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+}
+
+std::shared_ptr<MultiplexedStream> StreamMultiplexer::openStream() {
+    std::shared_ptr<MultiplexedStream> stream;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_ || failed_ || streams_.size() >= config_.maxStreams) {
+        return nullptr;
+    }
+    makeStream(nextStreamId_, stream);
+    nextStreamId_ += 2;
+    return stream;
+}
+
+std::shared_ptr<MultiplexedStream> StreamMultiplexer::acceptStream(std::chrono::milliseconds timeout) {
+    std::shared_ptr<MultiplexedStream> stream;
+    std::unique_lock<std::mutex> lock(mutex_);
+    acceptCv_.wait_for(lock, timeout, [this] { return !accepting_.empty() || stopping_ || failed_; });
+    if (!accepting_.empty() && !stopping_) {
+        stream = std::move(accepting_.front());
+        accepting_.pop_front();
+    }
+    return stream;
+}
+
+MultiplexedStream* StreamMultiplexer::makeStream(uint32_t id, std::shared_ptr<MultiplexedStream>& owner) {
+    owner.reset(new MultiplexedStream(weak_from_this(), id, config_.initialStreamWindow));
+    streams_[id] = owner.get();
+    return owner.get();
+}
+
+void StreamMultiplexer::schedule(MultiplexedStream& stream) {
+    if (stream.scheduled_ || stream.inFlight_ || stream.outbound_.empty()) {
+        return;
+    }
+    const Outbound& next = *stream.outbound_.front();
+    // An empty message needs no credit
+    if (stream.sendCredit_ == 0 && next.offset < next.total) {
+        return;
+    }
+    stream.scheduled_ = true;
+    ready_.push_back(&stream);
+    writerCv_.notify_one();
+}
+
+void StreamMultiplexer::queueControl(FrameType type, uint32_t streamId, uint32_t value) {
+    const size_t length = type == FrameType::WINDOW_UPDATE ? 4 : 0;
+    const size_t at = control_.size();
+    control_.resize(at + FRAME_HEADER_SIZE + length);
+    uint8_t* frame = control_.data() + at;
+    frame[0] = static_cast<uint8_t>(type);
+    frame[1] = 0;
+    putU32(frame + 2, streamId);
+    putU32(frame + 6, static_cast<uint32_t>(length));
+    if (length) {
+        putU32(frame + FRAME_HEADER_SIZE, value);
+    }
+    writerCv_.notify_one();
+}
+
+void StreamMultiplexer::closeStream(MultiplexedStream& stream, bool notifyPeer) {
+    const bool wasOpen = !stream.localClosed_ && !stream.remoteClosed_;
+    if (notifyPeer) {
+        stream.localClosed_ = true;
+    } else {
+        stream.remoteClosed_ = true;
+    }
+    failStreamSends(stream);
+    if (notifyPeer && wasOpen && !stopping_ && !failed_) {
+        queueControl(FrameType::RESET, stream.id_, 0);
+    }
+    if (stream.scheduled_) {
+        ready_.erase(std::remove(ready_.begin(), ready_.end(), &stream), ready_.end());
+        stream.scheduled_ = false;
+    }
+    streams_.erase(stream.id_);
+    stream.cv_.notify_all();
+}
+
+void StreamMultiplexer::failStreamSends(MultiplexedStream& stream) {
+    // A message the writer is partway through sending is failed by the writer itself
+    Outbound* sending = stream.inFlight_ ? stream.outbound_.front() : nullptr;
+    for (Outbound* message : stream.outbound_) {
+        if (message != sending) {
+            message->failed = true;
+        }
+    }
+    stream.outbound_.clear();
+    if (sending) {
+        stream.outbound_.push_back(sending);
+    }
+    stream.cv_.notify_all();
+}
+
+void StreamMultiplexer::fail(const std::string& reason) {
+    if (failed_) {
+        return;
+    }
+    failed_ = true;
+    error_ = reason;
+    for (auto& [_, stream] : streams_) {
+        stream->remoteClosed_ = true;
+        stream->scheduled_ = false;
+        failStreamSends(*stream);
+        stream->setError(TransportError::CONNECTION_CLOSED, reason);
+    }
+    ready_.clear();
+    writerCv_.notify_all();
+    acceptCv_.notify_all();
+}
+
+void StreamMultiplexer::consumed(MultiplexedStream& stream, size_t bytes) {
+    stream.unacknowledged_ += static_cast<uint32_t>(bytes);
+    // Credit goes back in batches of half a window rather than after every message
+    if (stream.unacknowledged_ >= std::max<uint32_t>(config_.initialStreamWindow / 2, 1) &&
+        !stream.localClosed_ && !stream.remoteClosed_ && !stopping_ && !failed_) {
+        queueControl(FrameType::WINDOW_UPDATE, stream.id_, stream.unacknowledged_);
+        stream.receiveWindow_ += stream.unacknowledged_;
+        stream.unacknowledged_ = 0;
+    }
+}
+
+ssize_t StreamMultiplexer::sendMessage(MultiplexedStream& stream, const utils::ByteSpan* parts, size_t count) {
+    Outbound message;
+    message.parts.assign(parts, parts + count);
+    for (const auto& part : message.parts) {
+        message.total += part.size();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stream.localClosed_ || stream.remoteClosed_ || stopping_ || failed_) {
+        stream.setError(TransportError::NOT_CONNECTED, "Stream is closed");
+        return -1;
+    }
+    stream.outbound_.push_back(&message);
+    schedule(stream);
+
+    auto finished = [&message] { return message.done || message.failed; };
+    const int64_t timeoutMs = stream.sendTimeoutMs_.load();
+    if (timeoutMs > 0 && !stream.cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), finished)) {
+        // Only a message that hasn't started can be withdrawn; a started one must finish
+        const bool started = message.offset > 0 || (stream.inFlight_ && stream.outbound_.front() == &message);
+        if (!started) {
+            auto& queue = stream.outbound_;
+            queue.erase(std::remove(queue.begin(), queue.end(), &message), queue.end());
+            stream.setError(TransportError::TIMEOUT, "Timed out waiting for flow-control credit");
+            return -1;
+        }
+    }
+    stream.cv_.wait(lock, finished);
+    if (message.failed) {
+        stream.setError(TransportError::SEND_ERROR, failed_ ? error_ : "Stream closed before the message was sent");
+        return -1;
+    }
+    return static_cast<ssize_t>(message.total);
+}
+
+ssize_t StreamMultiplexer::receiveMessage(MultiplexedStream& stream, utils::PooledBuffer& message, size_t maxSize) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto available = [&stream] { return !stream.inbound_.empty() || stream.localClosed_ || stream.remoteClosed_; };
+    if (!stream.nonBlocking_.load()) {
+        const int64_t timeoutMs = stream.receiveTimeoutMs_.load();
+        if (timeoutMs > 0) {
+            stream.cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), available);
+        } else {
+            stream.cv_.wait(lock, available);
+        }
+    }
+    if (stream.inbound_.empty()) {
+        if (stream.localClosed_ || stream.remoteClosed_) {
+            stream.setError(TransportError::CONNECTION_CLOSED, failed_ ? error_ : "Stream closed");
+        } else {
+            stream.setError(TransportError::TIMEOUT, "No message within the receive timeout");
+        }
+        return -1;
+    }
+
+    auto inbound = std::move(stream.inbound_.front());
+    stream.inbound_.pop_front();
+    consumed(stream, inbound.windowBytes);
+    lock.unlock();
+
+    if (inbound.data.size() > maxSize) {
+        stream.setError(TransportError::MESSAGE_TOO_LARGE, "Message larger than the receive buffer");
+        return -1;
+    }
+    message = std::move(inbound.data);
+    return static_cast<ssize_t>(message.size());
+}
+
+void StreamMultiplexer::release(MultiplexedStream& stream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = streams_.find(stream.id_);
+    if (it != streams_.end() && it->second == &stream) {
+        closeStream(stream, true);
+    }
+}
+
+void StreamMultiplexer::writerLoop() {
+    std::vector<uint8_t> control;
+    std::vector<utils::ByteSpan> gather;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        writerCv_.wait(lock, [this] { return stopping_ || failed_ || !control_.empty() || !ready_.empty(); });
+        if (failed_) {
+            break;
+        }
+        // Credit updates and resets go ahead of data; on shutdown they are still flushed
+        if (!control_.empty()) {
+            control.clear();
+            control.swap(control_);
+            lock.unlock();
+            ssize_t sent = transport_->send(control.data(), control.size());
+            lock.lock();
+            if (sent < 0) {
+                fail("Connection send failed: " + transport_->getErrorDetails());
+                break;
+            }
+            continue;
+        }
+        if (stopping_) {
+            break;
+        }
+
+        MultiplexedStream* stream = ready_.front();
+        ready_.pop_front();
+        stream->scheduled_ = false;
+        if (stream->outbound_.empty() || stream->localClosed_ || stream->remoteClosed_) {
+            continue;
+        }
+        Outbound& message = *stream->outbound_.front();
+        const size_t length = std::min({config_.chunkSize, message.total - message.offset,
+                                        static_cast<size_t>(stream->sendCredit_)});
+        if (length == 0 && message.offset < message.total) {
+            continue;  // Out of credit; a WINDOW_UPDATE reschedules it
+        }
+        const bool last = message.offset + length == message.total;
+
+        uint8_t header[FRAME_HEADER_SIZE];
+        header[0] = static_cast<uint8_t>(FrameType::DATA);
+        header[1] = last ? FLAG_END_MESSAGE : 0;
+        putU32(header + 2, stream->id_);
+        putU32(header + 6, static_cast<uint32_t>(length));
+        gather.clear();
+        gather.emplace_back(header, FRAME_HEADER_SIZE);
+        // The chunk is sent straight out of the caller's buffers
+        size_t skip = message.offset;
+        size_t remaining = length;
+        for (const auto& part : message.parts) {
+            if (remaining == 0) {
+                break;
+            }
+            if (skip >= part.size()) {
+                skip -= part.size();
+                continue;
+            }
+            const size_t take = std::min(part.size() - skip, remaining);
+            gather.push_back(part.subspan(skip, take));
+            remaining -= take;
+            skip = 0;
+        }
+        stream->sendCredit_ -= static_cast<uint32_t>(length);
+        stream->inFlight_ = true;
+
+        lock.unlock();
+        ssize_t sent = transport_->sendv(gather.data(), gather.size());
+        lock.lock();
+
+        // The sender is still waiting on this message, so the stream is still alive
+        stream->inFlight_ = false;
+        message.offset += length;
+        if (sent < 0) {
+            message.failed = true;
+            stream->outbound_.pop_front();
+            stream->cv_.notify_all();
+            fail("Connection send failed: " + transport_->getErrorDetails());
+            break;
+        }
+        if (stream->localClosed_ || stream->remoteClosed_) {
+            if (!last) {
+                message.failed = true;
+            } else {
+                message.done = true;
+            }
+            stream->outbound_.clear();
+            stream->cv_.notify_all();
+            continue;
+        }
+        if (last) {
+            message.done = true;
+            stream->outbound_.pop_front();
+            stream->cv_.notify_all();
+        }
+        schedule(*stream);  // To the back of the queue, behind every other ready stream
+    }
+    writerCv_.notify_all();
+}
+
+void StreamMultiplexer::readerLoop() {
+    utils::PooledBuffer block;
+    size_t filled = 0;
+    size_t parsed = 0;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ || failed_) {
+                break;
+            }
+        }
+        // Make room: reuse the block if nothing points into it, otherwise carry the partial frame over
+        if (!block || filled == block.size()) {
+            const size_t pending = filled - parsed;
+            if (block && parsed == filled && block.unique()) {
+                filled = parsed = 0;
+            } else {
+                utils::PooledBuffer next = utils::BufferPool::shared().acquire(READ_BLOCK_SIZE);
+                if (pending) {
+                    std::memcpy(next.data(), block.data() + parsed, pending);
+                }
+                block = std::move(next);
+                filled = pending;
+                parsed = 0;
+            }
+        }
+
+        ssize_t received = transport_->receive(block.data() + filled, block.size() - filled);
+        if (received == 0) {
+            continue;  // Idle; the receive timeout lets shutdown be noticed
+        }
+        if (received < 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!stopping_) {
+                fail("Connection receive failed: " + transport_->getErrorDetails());
+            }
+            break;
+        }
+        filled += static_cast<size_t>(received);
+
+        while (filled - parsed >= FRAME_HEADER_SIZE) {
+            const uint8_t* frame = block.data() + parsed;
+            const uint32_t length = getU32(frame + 6);
+            if (length > READ_BLOCK_SIZE - FRAME_HEADER_SIZE) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                fail("Peer sent an oversized frame");
+                return;
+            }
+            if (filled - parsed < FRAME_HEADER_SIZE + length) {
+                break;
+            }
+            dispatch(static_cast<FrameType>(frame[0]), frame[1], getU32(frame + 2), block,
+                     parsed + FRAME_HEADER_SIZE, length);
+            parsed += FRAME_HEADER_SIZE + length;
+        }
+        if (parsed == filled && block.unique()) {
+            filled = parsed = 0;
+        }
+    }
+}
+
+void StreamMultiplexer::dispatch(FrameType type, uint8_t flags, uint32_t streamId, const utils::PooledBuffer& block,
+                                 size_t offset, size_t length) {
+    std::shared_ptr<MultiplexedStream> opened;  // Declared first so it is released after the lock
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_ || failed_) {
+        return;
+    }
+
+    MultiplexedStream* stream = nullptr;
+    auto it = streams_.find(streamId);
+    if (it != streams_.end()) {
+        stream = it->second;
+    } else if (type == FrameType::DATA && (streamId & 1) != (nextStreamId_ & 1) && streamId > lastPeerStreamId_) {
+        // The peer's first frame on a stream opens it
+        lastPeerStreamId_ = streamId;
+        if (streams_.size() >= config_.maxStreams || accepting_.size() >= config_.acceptBacklog) {
+            queueControl(FrameType::RESET, streamId, 0);
+            return;
+        }
+        stream = makeStream(streamId, opened);
+        accepting_.push_back(opened);
+        acceptCv_.notify_one();
+    }
+    if (!stream) {
+        return;  // A stream already closed here; frames still in flight for it are dropped
+    }
+
+    switch (type) {
+        case FrameType::DATA:
+            deliver(*stream, flags, block, offset, length);
+            break;
+        case FrameType::WINDOW_UPDATE:
+            if (length == 4) {
+                stream->sendCredit_ += getU32(block.data() + offset);
+                schedule(*stream);
+            }
+            break;
+        case FrameType::RESET:
+            closeStream(*stream, false);
+            break;
+        default:
+            break;  // Unknown frame types are ignored so the protocol can grow
+    }
+}
+
+void StreamMultiplexer::deliver(MultiplexedStream& stream, uint8_t flags, const utils::PooledBuffer& block,
+                                size_t offset, size_t length) {
+    if (length > stream.receiveWindow_ || stream.assembled_ + length > config_.maxMessageSize) {
+        // The peer ignored our window or sent too much; nothing more on this stream can be trusted
+        closeStream(stream, true);
+        return;
+    }
+    stream.receiveWindow_ -= static_cast<uint32_t>(length);
+    const bool end = (flags & FLAG_END_MESSAGE) != 0;
+
+    if (end && stream.assembled_ == 0) {
+        MultiplexedStream::Inbound message;
+        if (length >= ZERO_COPY_MIN) {
+            message.data = block.slice(offset, length);
+        } else {
+            message.data = utils::BufferPool::shared().acquire(std::max<size_t>(length, 1));
+            std::memcpy(message.data.data(), block.data() + offset, length);
+            message.data.resize(length);
+        }
+        message.windowBytes = static_cast<uint32_t>(length);
+        stream.inbound_.push_back(std::move(message));
+        stream.cv_.notify_all();
+        return;
+    }
+
+    // A message spanning several chunks is assembled in a buffer that doubles as it fills
+    if (stream.assembled_ + length > stream.assembling_.capacity()) {
+        size_t capacity = std::max<size_t>(stream.assembling_.capacity() * 2, READ_BLOCK_SIZE);
+        while (capacity < stream.assembled_ + length) {
+            capacity *= 2;
+        }
+        utils::PooledBuffer grown = utils::BufferPool::shared().acquire(capacity);
+        if (stream.assembled_) {
+            std::memcpy(grown.data(), stream.assembling_.data(), stream.assembled_);
+        }
+        stream.assembling_ = std::move(grown);
+    }
+    std::memcpy(stream.assembling_.data() + stream.assembled_, block.data() + offset, length);
+    stream.assembled_ += length;
+
+    if (!end) {
+        // Nothing can be read until the message is complete, so credit for its
+        // earlier chunks goes back now; otherwise a message larger than the window
+        // could never finish arriving
+        consumed(stream, length);
+        return;
+    }
+    MultiplexedStream::Inbound message;
+    stream.assembling_.resize(stream.assembled_);
+    message.data = std::move(stream.assembling_);
+    message.windowBytes = static_cast<uint32_t>(length);
+    stream.assembling_ = utils::PooledBuffer();
+    stream.assembled_ = 0;
+    stream.inbound_.push_back(std::move(message));
+    stream.cv_.notify_all();
+}
+
+MultiplexedStream::MultiplexedStream(std::weak_ptr<StreamMultiplexer> mux, uint32_t id, uint32_t window)
+    : mux_(std::move(mux)), id_(id), sendCredit_(window), receiveWindow_(window) {}
+
+MultiplexedStream::~MultiplexedStream() {
+    if (auto mux = mux_.lock()) {
+        mux->release(*this);
+    }
+}
+
+std::shared_ptr<StreamMultiplexer> MultiplexedStream::multiplexer() const {
+    auto mux = mux_.lock();
+    if (!mux) {
+        setError(TransportError::NOT_CONNECTED, "Stream multiplexer is gone");
+    }
+    return mux;
+}
+
+bool MultiplexedStream::connect(const std::string&, const ConnectionConfig&) {
+    // Streams are opened through their multiplexer
+    setError(isConnected() ? TransportError::ALREADY_CONNECTED : TransportError::INVALID_STATE,
+             "Streams are opened with StreamMultiplexer::openStream()");
+    return false;
+}
+
+bool MultiplexedStream::disconnect() {
+    auto mux = multiplexer();
+    if (!mux) {
+        return false;
+    }
+    mux->release(*this);
+    if (stateCallback_) {
+        stateCallback_(ConnectionState::DISCONNECTED);
+    }
+    return true;
+}
+
+bool MultiplexedStream::isConnected() const {
+    auto mux = mux_.lock();
+    if (!mux) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mux->mutex_);
+    return !localClosed_ && !remoteClosed_ && !mux->stopping_ && !mux->failed_;
+}
+
+ssize_t MultiplexedStream::send(const uint8_t* data, size_t size) {
+    const utils::ByteSpan part(data, size);
+    return sendv(&part, 1);
+}
+
+ssize_t MultiplexedStream::sendv(const utils::ByteSpan* buffers, size_t count) {
+    auto mux = multiplexer();
+    return mux ? mux->sendMessage(*this, buffers, count) : -1;
+}
+
+ssize_t MultiplexedStream::sendFrame(const utils::ByteSpan* parts, size_t count) {
+    return sendv(parts, count);
+}
+
+ssize_t MultiplexedStream::receiveFrame(utils::PooledBuffer& frame) {
+    auto mux = multiplexer();
+    return mux ? mux->receiveMessage(*this, frame, SIZE_MAX) : -1;
+}
+
+ssize_t MultiplexedStream::receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) {
+    auto mux = multiplexer();
+    return mux ? mux->receiveMessage(*this, buffer, maxSize) : -1;
+}
+
+ssize_t MultiplexedStream::receive(uint8_t* buffer, size_t size) {
+    if (!buffer || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid receive parameters");
+        return -1;
+    }
+    // Only one reader at a time may use receive(); the rest of a message waits for the next call
+    if (partialOffset_ >= partial_.size()) {
+        partial_.reset();
+        partialOffset_ = 0;
+        ssize_t received = receiveFrame(partial_);
+        if (received < 0) {
+            return getLastErrorCode() == TransportError::TIMEOUT ? 0 : -1;
+        }
+    }
+    const size_t n = std::min(size, partial_.size() - partialOffset_);
+    if (n) {
+        std::memcpy(buffer, partial_.data() + partialOffset_, n);
+    }
+    partialOffset_ += n;
+    return static_cast<ssize_t>(n);
+}
+
+bool MultiplexedStream::getPeerAddress(std::string& address, uint16_t& port) {
+    auto mux = multiplexer();
+    return mux && mux->getTransport()->getPeerAddress(address, port);
+}
+
+bool MultiplexedStream::setNonBlocking(bool nonBlocking) {
+    nonBlocking_.store(nonBlocking);
+    return true;
+}
+
+bool MultiplexedStream::setReceiveTimeout(const std::chrono::milliseconds& timeout) {
+    receiveTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+bool MultiplexedStream::setSendTimeout(const std::chrono::milliseconds& timeout) {
+    sendTimeoutMs_.store(timeout.count());
+    return true;
+}
+
+std::string MultiplexedStream::getLastError() const {
+    return getErrorDetails();
+}
+
+ConnectionState MultiplexedStream::getState() const {
+    if (isConnected()) {
+        return ConnectionState::CONNECTED;
+    }
+    return getLastErrorCode() == TransportError::CONNECTION_CLOSED ? ConnectionState::ERROR
+                                                                   : ConnectionState::DISCONNECTED;
+}
+
+TransportError MultiplexedStream::getLastErrorCode() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+std::string MultiplexedStream::getErrorDetails() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return errorDetails_;
+}
+
+void MultiplexedStream::setStateCallback(std::function<void(ConnectionState)> callback) {
+    stateCallback_ = std::move(callback);
+}
+
+void MultiplexedStream::setErrorCallback(std::function<void(TransportError, const std::string&)> callback) {
+    errorCallback_ = std::move(callback);
+}
+
+void MultiplexedStream::setError(TransportError code, const std::string& details) const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = code;
+    errorDetails_ = details;
+}
+
+} // namespace core
+} // namespace xenocomm
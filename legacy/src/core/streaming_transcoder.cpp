@@ -0,0 +1,143 @@
+#include "xenocomm/core/streaming_transcoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+constexpr size_t HEADER_SIZE = sizeof(StreamChunkHeader);
+} // namespace
+
+StreamingEncoder::StreamingEncoder(DataTranscoder& transcoder, DataFormat input_format,
+                                   DataFormat encoded_format, size_t chunk_size)
+    : transcoder_(transcoder), input_format_(input_format), encoded_format_(encoded_format),
+      chunk_size_(chunk_size) {
+    if (chunk_size_ == 0) {
+        throw TranscodingError("Stream chunk size must be positive");
+    }
+}
+
+void StreamingEncoder::push(utils::ByteSpan data) {
+    if (finished_) {
+        throw TranscodingError("Stream already finished");
+    }
+
+    // Top up a partial chunk first, then encode whole chunks straight from the input
+    if (!pending_.empty()) {
+        size_t take = std::min(chunk_size_ - pending_.size(), data.size());
+        pending_.insert(pending_.end(), data.begin(), data.begin() + take);
+        data = data.subspan(take);
+        if (pending_.size() < chunk_size_) {
+            return;
+        }
+        encodeChunk(pending_, false);
+        pending_.clear();
+    }
+    while (data.size() >= chunk_size_) {
+        encodeChunk(data.subspan(0, chunk_size_), false);
+        data = data.subspan(chunk_size_);
+    }
+    pending_.assign(data.begin(), data.end());
+}
+
+void StreamingEncoder::finish() {
+    if (finished_) {
+        return;
+    }
+    encodeChunk(pending_, true);
+    pending_.clear();
+    pending_.shrink_to_fit();
+    finished_ = true;
+}
+
+bool StreamingEncoder::pull(std::vector<uint8_t>& chunk) {
+    if (ready_.empty()) {
+        return false;
+    }
+    chunk = std::move(ready_.front());
+    ready_.pop_front();
+    return true;
+}
+
+void StreamingEncoder::encodeChunk(utils::ByteSpan data, bool last) {
+    StreamChunkHeader header{};
+    header.sequence = next_sequence_++;
+    header.flags = last ? STREAM_LAST : 0;
+    header.format = static_cast<uint8_t>(encoded_format_);
+    header.magic = STREAM_MAGIC;
+
+    std::vector<uint8_t> chunk(HEADER_SIZE);
+    std::memcpy(chunk.data(), &header, HEADER_SIZE);
+    if (!data.empty()) {
+        // Encode in place after the header when the adapter can bound its output
+        size_t bound = transcoder_.maxEncodedSize(data.size(), input_format_);
+        if (bound > 0) {
+            chunk.resize(HEADER_SIZE + bound);
+            size_t written = transcoder_.encodeInto(
+                data, input_format_, utils::MutableByteSpan(chunk.data() + HEADER_SIZE, bound));
+            chunk.resize(HEADER_SIZE + written);
+        } else {
+            auto encoded = transcoder_.encode(data.data(), data.size(), input_format_);
+            chunk.insert(chunk.end(), encoded.begin(), encoded.end());
+        }
+    }
+    ready_.push_back(std::move(chunk));
+}
+
+StreamingDecoder::StreamingDecoder(DataTranscoder& transcoder) : transcoder_(transcoder) {}
+
+void StreamingDecoder::push(utils::ByteSpan chunk) {
+    if (chunk.size() < HEADER_SIZE) {
+        throw TranscodingError("Stream chunk smaller than its header");
+    }
+    StreamChunkHeader header;
+    std::memcpy(&header, chunk.data(), HEADER_SIZE);
+    if (header.magic != STREAM_MAGIC) {
+        throw TranscodingError("Not a stream chunk");
+    }
+    if (header.sequence < next_sequence_ || decoded_.count(header.sequence) != 0) {
+        throw TranscodingError("Duplicate stream chunk");
+    }
+    const bool last = (header.flags & STREAM_LAST) != 0;
+    if ((last_sequence_ >= 0 && (last || header.sequence > last_sequence_)) ||
+        (last && !decoded_.empty() && decoded_.rbegin()->first > header.sequence)) {
+        throw TranscodingError("Stream chunk beyond the last chunk");
+    }
+    if (last) {
+        last_sequence_ = header.sequence;
+    }
+
+    decoded_.emplace(header.sequence,
+                     decodeChunk(static_cast<DataFormat>(header.format), chunk.subspan(HEADER_SIZE)));
+}
+
+bool StreamingDecoder::pull(std::vector<uint8_t>& data) {
+    auto it = decoded_.find(static_cast<uint32_t>(next_sequence_));
+    if (it == decoded_.end()) {
+        return false;
+    }
+    data = std::move(it->second);
+    decoded_.erase(it);
+    ++next_sequence_;
+    return true;
+}
+
+std::vector<uint8_t> StreamingDecoder::decodeChunk(DataFormat format, utils::ByteSpan payload) {
+    if (payload.empty()) {
+        return {};
+    }
+    if (auto view = transcoder_.decodeView(payload, format)) {
+        return view->to_vector();
+    }
+    size_t bound = transcoder_.maxDecodedSize(payload, format);
+    if (bound > 0) {
+        std::vector<uint8_t> data(bound);
+        data.resize(transcoder_.decodeInto(payload, format, data));
+        return data;
+    }
+    return transcoder_.decode(payload.to_vector(), format);
+}
+
+} // namespace core
+} // namespace xenocomm
@@ -1,4 +1,7 @@
 #include "xenocomm/core/tcp_transport.hpp"
+#include "xenocomm/core/address_resolver.hpp"
+#include "xenocomm/utils/busy_poll.hpp"
+#include "xenocomm/utils/cancellation.hpp"
 #include <stdexcept>
 #include <system_error>
 #include <thread>
@@ -23,7 +26,14 @@
 #include <errno.h>
 #include <netdb.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <climits>
 #include <poll.h>
+#include <fcntl.h>
+#endif
+
+#ifdef __linux__
+#include <sys/sendfile.h>
 #endif
 
 // Platform-specific TCP keepalive definitions
@@ -45,8 +55,7 @@ static const int INVALID_SOCKET_VALUE = -1;
 TCPTransport::TCPTransport() : 
     socket_(INVALID_SOCKET_VALUE),
     connected_(false),
-    localPort_(0),
-    asyncWorkerPool_(4)
+    localPort_(0)
 #ifdef _WIN32
     , wsaInitialized_(false)
 #endif
@@ -60,13 +69,26 @@ TCPTransport::TCPTransport() :
     wsaInitialized_ = true;
 #endif
     
-    lastCleanup_ = std::chrono::steady_clock::now();
     lastHealthCheck_ = std::chrono::steady_clock::now();
+    poolShards_.reset(new std::atomic<PoolShard*>[POOL_SHARD_BUCKETS]());
 }
 
+struct TCPTransport::PriorityQueues {
+    std::array<utils::MpscRing<QueuedSend>, PRIORITY_LEVELS> rings{{
+        utils::MpscRing<QueuedSend>(PRIORITY_QUEUE_CAPACITY),
+        utils::MpscRing<QueuedSend>(PRIORITY_QUEUE_CAPACITY),
+        utils::MpscRing<QueuedSend>(PRIORITY_QUEUE_CAPACITY)}};
+};
+
 TCPTransport::~TCPTransport() {
+    metricsRegistration_.reset();
     stopHealthMonitoring();
+    destroyPool();
+    stopReceiveStream();
     disconnect();
+    closeSocket();
+    drainAsyncOperations();
+    delete priorityQueues_.load(std::memory_order_acquire);
 #ifdef _WIN32
     if (wsaInitialized_) {
         WSACleanup();
@@ -87,17 +109,13 @@ TCPTransport::TCPTransport(TCPTransport&& other) noexcept
       errorCallback_(std::move(other.errorCallback_)),
       config_(std::move(other.config_)),
       poolConfig_(std::move(other.poolConfig_)),
-      connectionPool_(std::move(other.connectionPool_)),
-      availableConnections_(std::move(other.availableConnections_)),
-      activeConnections_(other.activeConnections_.load()),
-      totalConnectionsCreated_(other.totalConnectionsCreated_.load()),
-      failedConnectionAttempts_(other.failedConnectionAttempts_.load()),
-      lastCleanup_(other.lastCleanup_),
-      asyncWorkerPool_(other.asyncWorkerPool_.getWorkerCount()),
+      poolShards_(std::move(other.poolShards_)),
+      framingConfig_(other.framingConfig_),
+      frameDecoder_(std::move(other.frameDecoder_)),
+      executor_(other.executor_),
       asyncConfig_(std::move(other.asyncConfig_)),
-      priorityQueues_(std::move(other.priorityQueues_)),
-      pendingAsyncOperations_(other.pendingAsyncOperations_.load()),
-      avgResponseTimes_(std::move(other.avgResponseTimes_)) {
+      priorityQueues_(other.priorityQueues_.exchange(nullptr, std::memory_order_acq_rel)),
+      pendingAsyncOperations_(other.pendingAsyncOperations_.load()) {
 #ifdef _WIN32
     wsaInitialized_ = other.wsaInitialized_;
     other.wsaInitialized_ = false;
@@ -129,32 +147,16 @@ TCPTransport& TCPTransport::operator=(TCPTransport&& other) noexcept {
         errorCallback_ = std::move(other.errorCallback_);
         config_ = std::move(other.config_);
         poolConfig_ = std::move(other.poolConfig_);
+        executor_ = other.executor_;
         
-        // Create a new AsyncWorkerPool with the same number of threads
-        // Since we can't assign to asyncWorkerPool_, we need to manually destroy and create a new one
-        size_t workerCount = other.asyncWorkerPool_.getWorkerCount();
-        asyncWorkerPool_.~AsyncWorkerPool();
-        new (&asyncWorkerPool_) AsyncWorkerPool(workerCount);
-        
-        // Move connection pool
-        {
-            std::lock_guard<std::mutex> lock(poolMutex_);
-            std::lock_guard<std::mutex> otherLock(other.poolMutex_);
-            connectionPool_ = std::move(other.connectionPool_);
-            while (!availableConnections_.empty()) {
-                availableConnections_.pop();
-            }
-            while (!other.availableConnections_.empty()) {
-                availableConnections_.push(other.availableConnections_.front());
-                other.availableConnections_.pop();
-            }
-        }
+        // Move connection pool; shard reapers do not reference the transport, so they keep running
+        destroyPool();
+        poolShards_ = std::move(other.poolShards_);
+        framingConfig_ = other.framingConfig_;
+        frameDecoder_ = std::move(other.frameDecoder_);
+        delete priorityQueues_.exchange(other.priorityQueues_.exchange(nullptr, std::memory_order_acq_rel),
+                                        std::memory_order_acq_rel);
         
-        // Move metrics
-        activeConnections_.store(other.activeConnections_.load());
-        totalConnectionsCreated_.store(other.totalConnectionsCreated_.load());
-        failedConnectionAttempts_.store(other.failedConnectionAttempts_.load());
-        lastCleanup_ = other.lastCleanup_;
         lastHealthCheck_ = other.lastHealthCheck_;
         
         // Reset the moved-from object
@@ -167,9 +169,6 @@ TCPTransport& TCPTransport::operator=(TCPTransport&& other) noexcept {
         other.connected_.store(false);
         other.state_.store(xenocomm::core::ConnectionState::DISCONNECTED);
         other.lastErrorCode_.store(xenocomm::core::TransportError::NONE);
-        other.activeConnections_.store(0);
-        other.totalConnectionsCreated_.store(0);
-        other.failedConnectionAttempts_.store(0);
         
         if (poolConfig_.enableHealthMonitoring) {
             startHealthMonitoring();
@@ -180,15 +179,180 @@ TCPTransport& TCPTransport::operator=(TCPTransport&& other) noexcept {
 
 TCPTransport::TCPTransport(const PoolConfig& config) : TCPTransport() {
     poolConfig_ = config;
-    lastCleanup_ = std::chrono::steady_clock::now();
 }
 
+namespace {
+
+#ifdef _WIN32
+using RaceSocket = SOCKET;
+using RacePoll = WSAPOLLFD;
+constexpr RaceSocket RACE_INVALID = INVALID_SOCKET;
+int lastSocketError() { return WSAGetLastError(); }
+void setSocketError(int error) { WSASetLastError(error); }
+void closeRaceSocket(RaceSocket socket) { closesocket(socket); }
+bool connectInProgress(int error) { return error == WSAEWOULDBLOCK; }
+int pollRace(RacePoll* fds, size_t count, int timeoutMs) { return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs); }
+bool setRaceBlocking(RaceSocket socket, bool blocking) {
+    u_long mode = blocking ? 0 : 1;
+    return ioctlsocket(socket, FIONBIO, &mode) == 0;
+}
+#else
+using RaceSocket = int;
+using RacePoll = pollfd;
+constexpr RaceSocket RACE_INVALID = -1;
+int lastSocketError() { return errno; }
+void setSocketError(int error) { errno = error; }
+void closeRaceSocket(RaceSocket socket) { ::close(socket); }
+bool connectInProgress(int error) { return error == EINPROGRESS; }
+int pollRace(RacePoll* fds, size_t count, int timeoutMs) { return ::poll(fds, static_cast<nfds_t>(count), timeoutMs); }
+bool setRaceBlocking(RaceSocket socket, bool blocking) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags != -1 && fcntl(socket, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) != -1;
+}
+#endif
+
+bool bindLocalPort(RaceSocket socket, int family, uint16_t port) {
+    sockaddr_storage local{};
+    socklen_t length;
+    if (family == AF_INET6) {
+        auto* v6 = reinterpret_cast<sockaddr_in6*>(&local);
+        v6->sin6_family = AF_INET6;
+        v6->sin6_addr = in6addr_any;
+        v6->sin6_port = htons(port);
+        length = sizeof(sockaddr_in6);
+    } else {
+        auto* v4 = reinterpret_cast<sockaddr_in*>(&local);
+        v4->sin_family = AF_INET;
+        v4->sin_addr.s_addr = INADDR_ANY;
+        v4->sin_port = htons(port);
+        length = sizeof(sockaddr_in);
+    }
+    return ::bind(socket, reinterpret_cast<sockaddr*>(&local), length) == 0;
+}
+
+/**
+ * Happy Eyeballs (RFC 8305): attempts start in address order, each one
+ * attemptDelay after the previous or as soon as every running attempt has
+ * failed, and the first to connect wins. Returns a blocking socket, or
+ * RACE_INVALID with the last attempt's error left in errno/WSAGetLastError.
+ */
+RaceSocket raceConnect(const std::vector<AddressResolver::Address>& addresses, uint32_t timeoutMs,
+                       std::chrono::milliseconds attemptDelay, uint16_t localPort) {
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    if (localPort > 0) {
+        attemptDelay = std::chrono::milliseconds(timeoutMs);  // Attempts would contend for the same port
+    }
+
+    std::vector<RacePoll> attempts;
+    auto nextStart = Clock::now();
+    size_t started = 0;
+    int lastError =
+#ifdef _WIN32
+        WSAETIMEDOUT;
+#else
+        ETIMEDOUT;
+#endif
+    RaceSocket winner = RACE_INVALID;
+
+    while (winner == RACE_INVALID) {
+        auto now = Clock::now();
+        if (now >= deadline) {
+            break;
+        }
+
+        if (started < addresses.size() && (now >= nextStart || attempts.empty())) {
+            const auto& address = addresses[started++];
+            RaceSocket socket = ::socket(address.family, address.socktype, address.protocol);
+            if (socket == RACE_INVALID) {
+                lastError = lastSocketError();
+                continue;
+            }
+            if (!setRaceBlocking(socket, false) || (localPort > 0 && !bindLocalPort(socket, address.family, localPort))) {
+                lastError = lastSocketError();
+                closeRaceSocket(socket);
+                continue;
+            }
+            int status = ::connect(socket, reinterpret_cast<const sockaddr*>(&address.storage),
+                                   static_cast<int>(address.length));
+            if (status == 0) {
+                winner = socket;
+                break;
+            }
+            int error = lastSocketError();
+            if (!connectInProgress(error)) {
+                lastError = error;
+                closeRaceSocket(socket);
+                continue;
+            }
+            RacePoll entry{};
+            entry.fd = socket;
+            entry.events = POLLOUT;
+            attempts.push_back(entry);
+            nextStart = now + attemptDelay;
+            continue;
+        }
+        if (attempts.empty()) {
+            break;  // Every address failed outright
+        }
+
+        auto wakeAt = started < addresses.size() ? std::min(deadline, nextStart) : deadline;
+        auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - now).count() + 1;
+        int ready = pollRace(attempts.data(), attempts.size(), static_cast<int>(waitMs));
+        if (ready < 0) {
+            int error = lastSocketError();
+#ifndef _WIN32
+            if (error == EINTR) {
+                continue;
+            }
+#endif
+            lastError = error;
+            break;
+        }
+
+        for (size_t i = 0; i < attempts.size();) {
+            if (attempts[i].revents == 0) {
+                ++i;
+                continue;
+            }
+            int soError = 0;
+            socklen_t length = sizeof(soError);
+            if (getsockopt(attempts[i].fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&soError), &length) != 0) {
+                soError = lastSocketError();
+            }
+            RaceSocket socket = static_cast<RaceSocket>(attempts[i].fd);
+            attempts.erase(attempts.begin() + static_cast<std::ptrdiff_t>(i));
+            if (soError == 0 && winner == RACE_INVALID) {
+                winner = socket;
+            } else {
+                lastError = soError != 0 ? soError : lastError;
+                closeRaceSocket(socket);
+            }
+        }
+    }
+
+    for (const auto& attempt : attempts) {
+        closeRaceSocket(static_cast<RaceSocket>(attempt.fd));
+    }
+    if (winner != RACE_INVALID && !setRaceBlocking(winner, true)) {
+        lastError = lastSocketError();
+        closeRaceSocket(winner);
+        winner = RACE_INVALID;
+    }
+    if (winner == RACE_INVALID) {
+        setSocketError(lastError);
+    }
+    return winner;
+}
+
+} // namespace
+
 bool TCPTransport::connect(const std::string& endpoint, const ConnectionConfig& config) {
     if (!validateState("connect")) {
         return false;
     }
 
-    config_ = config;
+    config_.publish(config);
     currentEndpoint_ = endpoint;
     updateState(xenocomm::core::ConnectionState::CONNECTING);
 
@@ -198,28 +362,19 @@ bool TCPTransport::connect(const std::string& endpoint, const ConnectionConfig&
         return false;
     }
 
-    struct addrinfo hints = {}, *result = nullptr;
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_protocol = IPPROTO_TCP;
-
-    std::string portStr = std::to_string(port);
-    int status = getaddrinfo(host.c_str(), portStr.c_str(), &hints, &result);
-    if (status != 0) {
+    // Reconnects reuse the cached addresses instead of waiting on DNS again
+    auto addresses = AddressResolver::shared().resolve(host, port);
+    if (!addresses) {
         setError(TransportError::RESOLUTION_FAILED, "Failed to resolve hostname");
         return false;
     }
 
-    std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> resultPtr(result, freeaddrinfo);
-
-    socket_ = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
-#ifdef _WIN32
-    if (socket_ == INVALID_SOCKET)
-#else
-    if (socket_ == -1)
-#endif
-    {
-        setError(TransportError::SOCKET_ERROR, "Failed to create socket");
+    socket_ = raceConnect(*addresses, config.connectionTimeoutMs,
+                          std::chrono::milliseconds(config.connectAttemptDelayMs), localPort_);
+    if (socket_ == INVALID_SOCKET_VALUE) {
+        setError(TransportError::CONNECTION_FAILED, "Failed to connect to endpoint: " + getSystemError());
+        // The endpoint may have moved; the next attempt looks it up again
+        AddressResolver::shared().invalidate(host, port);
         return false;
     }
 
@@ -227,25 +382,13 @@ bool TCPTransport::connect(const std::string& endpoint, const ConnectionConfig&
         closeSocket();
         return false;
     }
-
-    if (localPort_ > 0 && !bindSocket()) {
-        closeSocket();
-        return false;
-    }
-
-    status = ::connect(socket_, result->ai_addr, static_cast<int>(result->ai_addrlen));
-#ifdef _WIN32
-    if (status == SOCKET_ERROR)
-#else
-    if (status == -1)
-#endif
-    {
-        setError(TransportError::CONNECTION_FAILED, "Failed to connect to endpoint");
-        closeSocket();
-        return false;
+    if (config.lowLatency) {
+        // Best effort: without CAP_NET_ADMIN the system's busy-poll default stays
+        utils::enableBusyPoll(socket_, std::chrono::microseconds(config.busyPollUs));
     }
 
     connected_ = true;
+    linkHealth_.reset();
     updateState(xenocomm::core::ConnectionState::CONNECTED);
 
     if (config.healthMonitoring) {
@@ -261,6 +404,7 @@ bool TCPTransport::disconnect() {
     }
 
     stopHealthMonitoring();
+    stopReceiveStream();
 
     if (connected_) {
         updateState(xenocomm::core::ConnectionState::DISCONNECTING);
@@ -307,19 +451,103 @@ ssize_t TCPTransport::send(const uint8_t* data, size_t size) {
         {
             xenocomm::core::TransportError error = mapSystemError();
             if (error == xenocomm::core::TransportError::WOULD_BLOCK) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if (nonBlocking_) {
+                    // Report partial progress; the caller retries once the reactor signals WRITABLE
+                    if (totalSent > 0) {
+                        return static_cast<ssize_t>(totalSent);
+                    }
+                    lastErrorCode_ = xenocomm::core::TransportError::WOULD_BLOCK;
+                    return -1;
+                }
+                if (!utils::CancellationToken::current().sleepFor(std::chrono::milliseconds(1))) {
+                    setError(xenocomm::core::TransportError::TIMEOUT, "Send cancelled");
+                    return -1;
+                }
+                continue;
+            }
+            setError(error, "Send operation failed");
+            return -1;
+        }
+        totalSent += sent;
+    }
+
+    linkHealth_.recordSent();
+    return static_cast<ssize_t>(totalSent);
+}
+
+ssize_t TCPTransport::sendv(const utils::ByteSpan* buffers, size_t count) {
+#ifdef _WIN32
+    return TransportProtocol::sendv(buffers, count);
+#else
+    if (!validateState("sendv")) {
+        return -1;
+    }
+
+    if (!buffers || count == 0) {
+        setError(xenocomm::core::TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+
+    std::vector<iovec> iov;
+    iov.reserve(count);
+    size_t totalSize = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (buffers[i].empty()) {
+            continue;
+        }
+        iov.push_back(iovec{const_cast<uint8_t*>(buffers[i].data()), buffers[i].size()});
+        totalSize += buffers[i].size();
+    }
+
+    size_t totalSent = 0;
+    size_t first = 0;
+    while (totalSent < totalSize) {
+        msghdr msg{};
+        msg.msg_iov = iov.data() + first;
+        msg.msg_iovlen = std::min<size_t>(iov.size() - first, IOV_MAX);
+
+        ssize_t sent = ::sendmsg(socket_, &msg, MSG_NOSIGNAL);
+        if (sent == -1) {
+            xenocomm::core::TransportError error = mapSystemError();
+            if (error == xenocomm::core::TransportError::WOULD_BLOCK) {
+                if (nonBlocking_) {
+                    // Report partial progress; the caller retries once the reactor signals WRITABLE
+                    if (totalSent > 0) {
+                        return static_cast<ssize_t>(totalSent);
+                    }
+                    lastErrorCode_ = xenocomm::core::TransportError::WOULD_BLOCK;
+                    return -1;
+                }
+                if (!utils::CancellationToken::current().sleepFor(std::chrono::milliseconds(1))) {
+                    setError(xenocomm::core::TransportError::TIMEOUT, "Send cancelled");
+                    return -1;
+                }
                 continue;
             }
             setError(error, "Send operation failed");
             return -1;
         }
         totalSent += sent;
+
+        // Advance past whatever the kernel accepted, splitting a partially sent iovec
+        size_t advance = static_cast<size_t>(sent);
+        while (first < iov.size() && advance >= iov[first].iov_len) {
+            advance -= iov[first].iov_len;
+            ++first;
+        }
+        if (first < iov.size() && advance > 0) {
+            iov[first].iov_base = static_cast<uint8_t*>(iov[first].iov_base) + advance;
+            iov[first].iov_len -= advance;
+        }
     }
 
+    linkHealth_.recordSent();
     return static_cast<ssize_t>(totalSent);
+#endif
 }
 
 ssize_t TCPTransport::receive(uint8_t* buffer, size_t size) {
+    const auto config = config_.read();
     if (!validateState("receive")) {
         return -1;
     }
@@ -329,6 +557,29 @@ ssize_t TCPTransport::receive(uint8_t* buffer, size_t size) {
         return -1;
     }
 
+#ifndef _WIN32
+    if (config->lowLatency && !nonBlocking_) {
+        // Spin, then park below: data arriving within the budget is read without a wakeup
+        utils::spinUntilReadable(socket_, std::chrono::microseconds(config->spinBeforeParkUs));
+    }
+
+    // A blocking recv() cannot be woken, so wait for data where the caller's token can end the wait
+    const auto token = utils::CancellationToken::current();
+    if (token.isCancellable() && !nonBlocking_) {
+        auto timeout = receiveTimeout_.load();
+        switch (utils::waitForSocket(socket_, POLLIN,
+                                     std::chrono::milliseconds(timeout > 0 ? timeout : -1), token)) {
+        case utils::SocketWait::TIMED_OUT:
+            return 0;
+        case utils::SocketWait::CANCELLED:
+            setError(xenocomm::core::TransportError::TIMEOUT, "Receive cancelled");
+            return -1;
+        default:
+            break;  // recv() below reports readiness and failures alike
+        }
+    }
+#endif
+
     ssize_t received = ::recv(socket_,
         reinterpret_cast<char*>(buffer),
         static_cast<int>(size),
@@ -355,10 +606,12 @@ ssize_t TCPTransport::receive(uint8_t* buffer, size_t size) {
         return -1;
     }
 
+    linkHealth_.recordHeard();
     return received;
 }
 
 std::string TCPTransport::getLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
     return lastError_;
 }
 
@@ -380,10 +633,12 @@ xenocomm::core::TransportError TCPTransport::getLastErrorCode() const {
 }
 
 std::string TCPTransport::getErrorDetails() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
     return lastErrorDetails_;
 }
 
 bool TCPTransport::reconnect(uint32_t maxAttempts, uint32_t delayMs) {
+    const auto config = config_.read();
     if (currentEndpoint_.empty()) {
         setError(xenocomm::core::TransportError::INVALID_STATE, "No previous endpoint to reconnect to");
         return false;
@@ -401,14 +656,14 @@ bool TCPTransport::reconnect(uint32_t maxAttempts, uint32_t delayMs) {
         if (attempt > 0) {
             std::this_thread::sleep_for(std::chrono::milliseconds(currentDelay));
             // Exponential backoff with jitter
-            currentDelay = std::min<uint32_t>(currentDelay * 2, config_.reconnectDelayMs * 10);
+            currentDelay = std::min<uint32_t>(currentDelay * 2, config->reconnectDelayMs * 10);
             std::random_device rd;
             std::mt19937 gen(rd());
             std::uniform_int_distribution<> dis(-100, 100);
             currentDelay += dis(gen);
         }
 
-        success = connect(currentEndpoint_, config_);
+        success = connect(currentEndpoint_, *config);
         if (!success) {
             attempt++;
             std::stringstream ss;
@@ -435,7 +690,20 @@ void TCPTransport::setErrorCallback(std::function<void(xenocomm::core::Transport
 }
 
 bool TCPTransport::checkHealth() {
-    return performHealthCheck();
+    if (!connected_) {
+        return false;
+    }
+    switch (linkHealth_.assess(healthPolicy())) {
+        case LinkVerdict::HEALTHY:
+            return true;
+        case LinkVerdict::FAILING:
+            return false;
+        case LinkVerdict::IDLE:
+            break;
+    }
+    bool healthy = performHealthCheck();
+    linkHealth_.recordProbe(healthy);
+    return healthy;
 }
 
 // Private methods
@@ -541,21 +809,6 @@ bool TCPTransport::setSocketOptions(uint32_t socketTimeoutMs) {
     return true;
 }
 
-bool TCPTransport::bindSocket() {
-    struct sockaddr_in addr;
-    std::memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
-    addr.sin_port = htons(localPort_);
-
-    if (bind(socket_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
-        setError(xenocomm::core::TransportError::BIND_FAILED, "Failed to bind to local port");
-        return false;
-    }
-
-    return true;
-}
-
 bool TCPTransport::setNonBlocking(bool nonBlocking) {
 #ifdef _WIN32
     u_long mode = nonBlocking ? 1 : 0;
@@ -576,18 +829,27 @@ bool TCPTransport::setNonBlocking(bool nonBlocking) {
         return false;
     }
 #endif
+    nonBlocking_ = nonBlocking;
     return true;
 }
 
 void TCPTransport::setError(xenocomm::core::TransportError code, const std::string& message) const {
+    std::string details = getSystemError();
     lastErrorCode_ = code;
-    lastError_ = message;
-    lastErrorDetails_ = getSystemError();
+    if (isLinkError(code)) {
+        linkHealth_.recordError();
+    }
+    {
+        // Queued and async sends report errors from worker threads concurrently
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        lastError_ = message;
+        lastErrorDetails_ = details;
+    }
     
     {
         std::lock_guard<std::mutex> lock(callbackMutex_);
         if (errorCallback_) {
-            errorCallback_(code, message + ": " + lastErrorDetails_);
+            errorCallback_(code, message + ": " + details);
         }
     }
 }
@@ -708,56 +970,46 @@ bool TCPTransport::performHealthCheck() {
     return true;
 }
 
+LinkHealthPolicy TCPTransport::healthPolicy() const {
+    LinkHealthPolicy policy;
+    policy.idleAfter = std::chrono::milliseconds(poolConfig_.healthCheckInterval);
+    policy.maxConsecutiveErrors = 1;  // A socket error ends a TCP connection
+    return policy;
+}
+
 void TCPTransport::startHealthMonitoring() {
     stopHealthMonitoring();
-    stopHealthMonitor_.store(false);
-    
-    healthMonitorThread_ = std::make_unique<std::thread>([this]() {
-        while (!stopHealthMonitor_.load()) {
+
+    // Judged from the traffic already flowing; the shared scheduler probes only once the connection
+    // goes quiet, and then once per remote host for all the transports connected to it
+    heartbeat_ = HeartbeatScheduler::shared().add(
+        parseEndpoint(currentEndpoint_).first, linkHealth_, healthPolicy(),
+        [this]() { return connected_.load() && performHealthCheck(); },
+        [this]() {
             if (connected_.load()) {
-                // Perform health check
-                if (!performHealthCheck()) {
-                    // Connection is unhealthy
-                    setError(xenocomm::core::TransportError::CONNECTION_RESET, "Connection lost detected by health monitor");
-                    updateState(xenocomm::core::ConnectionState::ERROR);
-                    connected_.store(false);
-                }
-            }
-            
-            auto currentTime = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                currentTime - lastCleanup_).count();
-            
-            // Clean up idle connections periodically
-            if (elapsed > poolConfig_.idleTimeout) {
-                cleanupIdleConnections();
-                lastCleanup_ = currentTime;
+                setError(xenocomm::core::TransportError::CONNECTION_RESET, "Connection lost detected by health monitor");
+                updateState(xenocomm::core::ConnectionState::ERROR);
+                connected_.store(false);
             }
-            
-            // Sleep to avoid high CPU usage
-            std::this_thread::sleep_for(std::chrono::milliseconds(poolConfig_.healthCheckInterval));
-        }
-    });
+        });
 }
 
 void TCPTransport::stopHealthMonitoring() {
-    if (healthMonitorThread_) {
-        stopHealthMonitor_ = true;
-        if (healthMonitorThread_->joinable()) {
-            healthMonitorThread_->join();
-        }
-        healthMonitorThread_.reset();
+    if (heartbeat_) {
+        HeartbeatScheduler::shared().remove(heartbeat_);
+        heartbeat_ = 0;
     }
 }
 
 bool TCPTransport::validateAndRepairConnection(std::shared_ptr<ConnectionInfo> connection) {
+    const auto config = config_.read();
     if (!connection) {
         return false;
     }
 
     if (!validateConnection(connection)) {
-        if (config_.autoReconnect) {
-            return reconnect(config_.maxReconnectAttempts, config_.reconnectDelayMs);
+        if (config->autoReconnect) {
+            return reconnect(config->maxReconnectAttempts, config->reconnectDelayMs);
         }
         return false;
     }
@@ -765,162 +1017,1350 @@ bool TCPTransport::validateAndRepairConnection(std::shared_ptr<ConnectionInfo> c
     return true;
 }
 
-void TCPTransport::processPriorityQueues() {
-    std::lock_guard<std::mutex> lock(asyncMutex_);
-    
-    for (auto& [priority, queue] : priorityQueues_) {
-        while (!queue.empty() && pendingAsyncOperations_ < asyncConfig_.maxPendingOperations) {
-            auto task = std::move(queue.front());
-            queue.pop();
-            pendingAsyncOperations_++;
-            
-            asyncWorkerPool_.enqueue([this, task = std::move(task)]() {
-                task();
-                pendingAsyncOperations_--;
-            });
-        }
+TCPTransport::PriorityQueues& TCPTransport::priorityQueues() {
+    PriorityQueues* queues = priorityQueues_.load(std::memory_order_acquire);
+    if (queues) {
+        return *queues;
+    }
+    // Racing first senders each build a set; all but the one installed are discarded
+    auto* built = new PriorityQueues();
+    if (priorityQueues_.compare_exchange_strong(queues, built, std::memory_order_acq_rel)) {
+        return *built;
     }
+    delete built;
+    return *queues;
 }
 
-void TCPTransport::updateResponseStats(const std::string& endpoint, 
-                                     std::chrono::milliseconds responseTime) {
-    std::lock_guard<std::mutex> lock(asyncMutex_);
-    
-    auto it = avgResponseTimes_.find(endpoint);
-    if (it == avgResponseTimes_.end()) {
-        avgResponseTimes_[endpoint] = responseTime;
-    } else {
-        // Exponential moving average with alpha = 0.2
-        it->second = std::chrono::milliseconds(
-            static_cast<int64_t>(0.8 * it->second.count() + 0.2 * responseTime.count())
-        );
+bool TCPTransport::queueSend(const uint8_t* data, size_t size, AsyncPriority priority,
+                             SendCompletion complete, void* context) {
+    if (!validateState("queueSend")) {
+        return false;
+    }
+    if (!data || size == 0 || !complete) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return false;
+    }
+    if (!beginAsyncOperation("queueSend")) {
+        return false;
     }
-}
 
-void TCPTransport::closeSocket() {
-#ifdef _WIN32
-    if (socket_ != INVALID_SOCKET) {
-        closesocket(socket_);
-        socket_ = INVALID_SOCKET;
+    size_t level = std::min(static_cast<size_t>(priority), PRIORITY_LEVELS - 1);
+    if (!priorityQueues().rings[level].try_push(QueuedSend{data, size, complete, context})) {
+        --pendingAsyncOperations_;
+        setError(TransportError::BUFFER_FULL, "Send queue for this priority is full");
+        return false;
     }
-#else
-    if (socket_ != -1) {
-        close(socket_);
-        socket_ = -1;
+
+    // Only the producer that takes the count off zero schedules the single drainer
+    if (queuedSends_.fetch_add(1) == 0) {
+        executor_->submit([this]() { drainPriorityQueues(); });
     }
-#endif
+    return true;
 }
 
-bool TCPTransport::gracefulShutdown() {
-    if (!connected_) {
-        return true;
+std::future<bool> TCPTransport::sendAsync(const uint8_t* data, size_t size, AsyncPriority priority) {
+    auto* promise = new std::promise<bool>();
+    auto future = promise->get_future();
+    auto complete = [](void* context, bool success) {
+        auto* owned = static_cast<std::promise<bool>*>(context);
+        owned->set_value(success);
+        delete owned;
+    };
+    if (!queueSend(data, size, priority, complete, promise)) {
+        complete(promise, false);
+    }
+    return future;
+}
+
+void TCPTransport::drainPriorityQueues() {
+    while (true) {
+        size_t completed = processPriorityQueues();
+        if (completed == 0) {
+            // A producer has published but not counted yet (or the reverse); wait for it to settle
+            if (queuedSends_.load() == 0) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        if (queuedSends_.fetch_sub(completed) == completed) {
+            return;
+        }
     }
+}
 
-#ifdef _WIN32
-    if (shutdown(socket_, SD_BOTH) == SOCKET_ERROR)
-#else
-    if (shutdown(socket_, SHUT_RDWR) == -1)
-#endif
-    {
-        setError(xenocomm::core::TransportError::SHUTDOWN_FAILED, "Failed to shutdown socket");
-        return false;
+size_t TCPTransport::processPriorityQueues() {
+    constexpr size_t MAX_BATCH = 64;
+    // Only scheduled after a push, so the rings exist
+    auto& rings = priorityQueues_.load(std::memory_order_acquire)->rings;
+
+    // Strict priority: serve the highest non-empty level...
+    size_t level = PRIORITY_LEVELS;
+    for (size_t candidate = PRIORITY_LEVELS; candidate-- > 0;) {
+        if (!rings[candidate].empty()) {
+            level = candidate;
+            break;
+        }
+    }
+    if (level == PRIORITY_LEVELS) {
+        return 0;
     }
 
-    // Wait for pending data to be sent/received
-    char buffer[1024];
-    while (true) {
-        ssize_t received = ::recv(socket_, buffer, sizeof(buffer), 0);
-#ifdef _WIN32
-        if (received == SOCKET_ERROR || received == 0)
-#else
-        if (received <= 0)
-#endif
-        {
+    // ...unless a lower level has waited behind starvationLimit picks, then serve the lowest
+    size_t lowest = level;
+    for (size_t candidate = 0; candidate < level; ++candidate) {
+        if (!rings[candidate].empty()) {
+            lowest = candidate;
             break;
         }
     }
+    if (lowest == level) {
+        starvationStreak_ = 0;
+    } else if (++starvationStreak_ > asyncConfig_.starvationLimit) {
+        level = lowest;
+        starvationStreak_ = 0;
+    }
 
-    return true;
+    size_t batchLimit = asyncConfig_.enableBatching
+        ? std::min<size_t>(std::max<size_t>(asyncConfig_.batchSize, 1), MAX_BATCH) : 1;
+    QueuedSend batch[MAX_BATCH];
+    utils::ByteSpan spans[MAX_BATCH];
+    size_t count = 0;
+    size_t bytes = 0;
+    while (count < batchLimit && (count == 0 || bytes < asyncConfig_.batchMaxBytes) &&
+           rings[level].try_pop(batch[count])) {
+        spans[count] = utils::ByteSpan(batch[count].data, batch[count].size);
+        bytes += batch[count].size;
+        ++count;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    ssize_t sent = count == 1 ? send(batch[0].data, batch[0].size) : sendv(spans, count);
+    bool success = sent == static_cast<ssize_t>(bytes);
+    for (size_t i = 0; i < count; ++i) {
+        --pendingAsyncOperations_;
+        batch[i].complete(batch[i].context, success);
+    }
+    return count;
 }
 
-void TCPTransport::cleanupIdleConnections() {
-    std::lock_guard<std::mutex> lock(poolMutex_);
-    
-    auto now = std::chrono::steady_clock::now();
-    
-    // For each endpoint in the connection pool
-    for (auto& [endpoint, connections] : connectionPool_) {
-        auto it = connections.begin();
-        while (it != connections.end()) {
-            auto& connection = *it;
-            
-            // Skip connections that are in use
-            if (connection->inUse) {
-                ++it;
-                continue;
-            }
-            
-            // Check if the connection is idle for too long
-            auto idleTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - connection->lastUsed).count();
-                
-            if (idleTime > poolConfig_.idleTimeout) {
-                // Close idle connection
-                if (connection->socket != 
-#ifdef _WIN32
-                    INVALID_SOCKET
-#else
-                    -1
-#endif
-                ) {
-#ifdef _WIN32
-                    closesocket(connection->socket);
-                    connection->socket = INVALID_SOCKET;
-#else
-                    close(connection->socket);
-                    connection->socket = -1;
-#endif
+namespace {
+
+// Drives one sendAsync through io_uring, resubmitting the tail after partial sends
+struct UringSend {
+    IoUringEngine* engine;
+    int socket;
+    const uint8_t* data;
+    size_t size;
+    size_t sent = 0;
+    std::chrono::milliseconds timeout;
+    std::promise<bool> promise;
+    std::function<void(int)> finish;
+    utils::CancellationToken token = utils::CancellationToken::none();
+    std::atomic<IoUringEngine::OperationId> inFlight{0};  // What a cancel() aborts
+};
+
+// The io_uring timeout for an operation: operationTimeoutMs (0 for none), cut to the token's deadline
+std::chrono::milliseconds uringTimeout(const utils::CancellationToken& token, uint32_t operationTimeoutMs) {
+    const auto unbounded = std::chrono::milliseconds::max();
+    auto limit = token.remaining(operationTimeoutMs > 0 ? std::chrono::milliseconds(operationTimeoutMs) : unbounded);
+    if (limit == unbounded) {
+        return std::chrono::milliseconds(0);
+    }
+    return std::max(limit, std::chrono::milliseconds(1));
+}
+
+// Records the submitted operation, aborting it if the token was cancelled before it was known
+void trackInFlight(IoUringEngine* engine, std::atomic<IoUringEngine::OperationId>& inFlight,
+                   IoUringEngine::OperationId id, const utils::CancellationToken& token) {
+    inFlight = id;
+    if (token.isCancelled()) {
+        engine->cancel(id);
+    }
+}
+
+void submitRemaining(const std::shared_ptr<UringSend>& op) {
+    IoUringEngine::OperationId id = 0;
+    bool queued = op->engine->submitSend(op->socket, op->data + op->sent, op->size - op->sent,
+        [op](int result) {
+            if (result > 0) {
+                op->sent += static_cast<size_t>(result);
+                if (op->sent < op->size) {
+                    if (op->token.isCancelled()) {
+                        op->finish(-ECANCELED);
+                        return;
+                    }
+                    submitRemaining(op);
+                    return;
                 }
-                
-                // Remove from the pool
-                it = connections.erase(it);
-                activeConnections_.fetch_sub(1);
-            } else {
-                ++it;
             }
-        }
+            op->finish(result > 0 ? static_cast<int>(std::min<size_t>(op->sent, INT_MAX)) : (result == 0 ? -EPIPE : result));
+        }, op->timeout, &id);
+    if (!queued) {
+        op->finish(-EBUSY);
+        return;
     }
+    trackInFlight(op->engine, op->inFlight, id, op->token);
 }
 
-bool TCPTransport::getPeerAddress(std::string& address, uint16_t& port) {
-    if (!isConnected()) {
-        setError(xenocomm::core::TransportError::NOT_CONNECTED, "Not connected");
+#ifndef _WIN32
+// Blocks until the socket is ready, timeoutMs passes (errno ETIMEDOUT) or the token gives up (ECANCELED)
+bool waitReady(int socket, short events, uint32_t timeoutMs,
+               const utils::CancellationToken& token = utils::CancellationToken::current()) {
+    switch (utils::waitForSocket(socket, events, std::chrono::milliseconds(timeoutMs), token)) {
+    case utils::SocketWait::READY:
+        return true;
+    case utils::SocketWait::TIMED_OUT:
+        errno = ETIMEDOUT;
         return false;
-    }
-    
-    struct sockaddr_in peerAddr;
-    socklen_t addrLen = sizeof(peerAddr);
-    
-#ifdef _WIN32
-    if (getpeername(socket_, (struct sockaddr*)&peerAddr, &addrLen) == SOCKET_ERROR) {
-        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to get peer name: " + getSystemError());
+    case utils::SocketWait::CANCELLED:
+        errno = ECANCELED;
         return false;
-    }
-#else
-    if (getpeername(socket_, (struct sockaddr*)&peerAddr, &addrLen) < 0) {
-        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to get peer name: " + getSystemError());
+    case utils::SocketWait::FAILED:
         return false;
     }
+    return false;
+}
 #endif
-    
-    char addrStr[INET_ADDRSTRLEN];
-#ifdef _WIN32
-    if (inet_ntop(AF_INET, &(peerAddr.sin_addr), addrStr, INET_ADDRSTRLEN) == NULL) {
-        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to convert address: " + getSystemError());
-        return false;
+
+} // namespace
+
+void TCPTransport::setFramingConfig(const FramingConfig& config) {
+    std::lock_guard<std::mutex> lock(frameReceiveMutex_);
+    framingConfig_ = config;
+    frameDecoder_ = utils::FrameDecoder(config.encoding, config.maxFrameSize);
+}
+
+ssize_t TCPTransport::sendFrame(const utils::ByteSpan* parts, size_t count) {
+    if (!validateState("sendFrame")) {
+        return -1;
     }
-#else
-    if (inet_ntop(AF_INET, &(peerAddr.sin_addr), addrStr, INET_ADDRSTRLEN) == NULL) {
+    if (!parts && count > 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid frame parameters");
+        return -1;
+    }
+
+    size_t payload = 0;
+    for (size_t i = 0; i < count; ++i) {
+        payload += parts[i].size();
+    }
+    if (payload > framingConfig_.maxFrameSize || payload > UINT32_MAX) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Frame exceeds the maximum frame size");
+        return -1;
+    }
+
+    uint8_t prefix[utils::MAX_FRAME_PREFIX];
+    size_t prefixSize = utils::encodeFramePrefix(static_cast<uint32_t>(payload), framingConfig_.encoding, prefix);
+    std::vector<utils::ByteSpan> buffers;
+    buffers.reserve(count + 1);
+    buffers.emplace_back(prefix, prefixSize);
+    buffers.insert(buffers.end(), parts, parts + count);
+    return writeFrames(buffers, prefixSize + payload) ? static_cast<ssize_t>(payload) : -1;
+}
+
+ssize_t TCPTransport::sendFrames(const utils::ByteSpan* frames, size_t count) {
+    if (!validateState("sendFrames")) {
+        return -1;
+    }
+    if (!frames || count == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid frame parameters");
+        return -1;
+    }
+
+    std::vector<uint8_t> prefixes(count * utils::MAX_FRAME_PREFIX);
+    std::vector<utils::ByteSpan> buffers;
+    buffers.reserve(count * 2);
+    size_t payload = 0;
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (frames[i].size() > framingConfig_.maxFrameSize || frames[i].size() > UINT32_MAX) {
+            setError(TransportError::MESSAGE_TOO_LARGE, "Frame exceeds the maximum frame size");
+            return -1;
+        }
+        uint8_t* prefix = prefixes.data() + i * utils::MAX_FRAME_PREFIX;
+        size_t prefixSize = utils::encodeFramePrefix(static_cast<uint32_t>(frames[i].size()),
+                                                     framingConfig_.encoding, prefix);
+        buffers.emplace_back(prefix, prefixSize);
+        buffers.push_back(frames[i]);
+        payload += frames[i].size();
+        total += prefixSize + frames[i].size();
+    }
+    return writeFrames(buffers, total) ? static_cast<ssize_t>(payload) : -1;
+}
+
+ssize_t TCPTransport::sendFileFrame(utils::ByteSpan header, int fd, int64_t offset, size_t size) {
+    const auto config = config_.read();
+#ifndef __linux__
+    return TransportProtocol::sendFileFrame(header, fd, offset, size);
+#else
+    if (!validateState("sendFileFrame")) {
+        return -1;
+    }
+    if (fd < 0 || offset < 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid file frame parameters");
+        return -1;
+    }
+    if (size > framingConfig_.maxFrameSize || header.size() > framingConfig_.maxFrameSize - size ||
+        header.size() + size > UINT32_MAX) {
+        setError(TransportError::MESSAGE_TOO_LARGE, "Frame exceeds the maximum frame size");
+        return -1;
+    }
+    const size_t payload = header.size() + size;
+
+    // Bounds each sendfile() so a cancelled or timed-out send is noticed between calls
+    constexpr size_t SENDFILE_CHUNK = 1 << 20;
+
+    uint8_t prefix[utils::MAX_FRAME_PREFIX];
+    size_t prefixSize = utils::encodeFramePrefix(static_cast<uint32_t>(payload), framingConfig_.encoding, prefix);
+    std::vector<utils::ByteSpan> buffers{utils::ByteSpan(prefix, prefixSize), header};
+
+    std::lock_guard<std::mutex> lock(frameSendMutex_);
+    if (!writeFramesLocked(buffers, prefixSize + header.size())) {
+        return -1;
+    }
+    off_t position = static_cast<off_t>(offset);
+    size_t remaining = size;
+    while (remaining > 0) {
+        ssize_t sent = ::sendfile(socket_, fd, &position, std::min(remaining, SENDFILE_CHUNK));
+        if (sent > 0) {
+            remaining -= static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent == 0) {
+            setError(TransportError::SEND_ERROR, "File ended partway through a frame");
+            return -1;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN && waitReady(socket_, POLLOUT, config->connectionTimeoutMs)) {
+            continue;
+        }
+        if ((errno == EINVAL || errno == ENOSYS) && remaining == size) {
+            // Not a file the kernel can splice from, so its pages are mapped and written instead
+            utils::MappedRegion region(fd, offset, size);
+            if (region.valid()) {
+                std::vector<utils::ByteSpan> body{region.span()};
+                return writeFramesLocked(body, size) ? static_cast<ssize_t>(payload) : -1;
+            }
+        }
+        setError(mapSystemError(), "Connection failed partway through a frame");
+        return -1;
+    }
+    return static_cast<ssize_t>(payload);
+#endif
+}
+
+bool TCPTransport::writeFrames(std::vector<utils::ByteSpan>& buffers, size_t totalBytes) {
+    std::lock_guard<std::mutex> lock(frameSendMutex_);
+    return writeFramesLocked(buffers, totalBytes);
+}
+
+bool TCPTransport::writeFramesLocked(std::vector<utils::ByteSpan>& buffers, size_t totalBytes) {
+    const auto config = config_.read();
+    size_t written = 0;
+    size_t first = 0;
+    while (written < totalBytes) {
+        ssize_t sent = sendv(buffers.data() + first, buffers.size() - first);
+        if (sent < 0) {
+#ifndef _WIN32
+            // A half-written frame would desynchronize the peer, so wait for space instead of returning
+            if (lastErrorCode_ == TransportError::WOULD_BLOCK && waitReady(socket_, POLLOUT, config->connectionTimeoutMs)) {
+                continue;
+            }
+#endif
+            if (written > 0) {
+                setError(TransportError::SEND_ERROR, "Connection failed partway through a frame");
+            }
+            return false;
+        }
+
+        written += static_cast<size_t>(sent);
+        size_t advance = static_cast<size_t>(sent);
+        while (first < buffers.size() && advance >= buffers[first].size()) {
+            advance -= buffers[first].size();
+            ++first;
+        }
+        if (first < buffers.size() && advance > 0) {
+            buffers[first] = buffers[first].subspan(advance);
+        }
+    }
+    return true;
+}
+
+ssize_t TCPTransport::receiveFrame(utils::PooledBuffer& frame) {
+    if (!validateState("receiveFrame")) {
+        return -1;
+    }
+
+    // Large enough that one read usually carries several small frames
+    constexpr size_t FRAME_READ_CHUNK = 65536;
+
+    std::lock_guard<std::mutex> lock(frameReceiveMutex_);
+    while (true) {
+        utils::ByteSpan next;
+        switch (frameDecoder_.next(next)) {
+            case utils::FrameDecoder::Status::FRAME:
+                // The decoder's buffer is reused by the next read, so the frame moves to a pooled one
+                frame = utils::BufferPool::shared().acquire(next.size());
+                if (!next.empty()) {
+                    std::memcpy(frame.data(), next.data(), next.size());
+                }
+                return static_cast<ssize_t>(frame.size());
+            case utils::FrameDecoder::Status::TOO_LARGE:
+                setError(TransportError::MESSAGE_TOO_LARGE, "Incoming frame exceeds the maximum frame size");
+                return -1;
+            case utils::FrameDecoder::Status::MALFORMED:
+                setError(TransportError::RECEIVE_ERROR, "Malformed frame length prefix");
+                return -1;
+            case utils::FrameDecoder::Status::NEED_MORE:
+                break;
+        }
+
+        auto space = frameDecoder_.prepare(FRAME_READ_CHUNK);
+        ssize_t received = receive(space.data(), space.size());
+        if (received < 0) {
+            return -1;
+        }
+        if (received == 0) {
+            // No data yet; a partial frame stays buffered for the next call
+            if (nonBlocking_) {
+                lastErrorCode_ = TransportError::WOULD_BLOCK;
+            } else {
+                setError(TransportError::TIMEOUT, "Timed out waiting for a frame");
+            }
+            return -1;
+        }
+        frameDecoder_.commit(static_cast<size_t>(received));
+    }
+}
+
+std::future<bool> TCPTransport::connectAsync(const std::string& endpoint, uint32_t socketTimeoutMs) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    ConnectionConfig config = *config_.read();
+    config.connectionTimeoutMs = socketTimeoutMs;
+    executor_->submit([this, endpoint, config, promise]() {
+        promise->set_value(connect(endpoint, config));
+    });
+    return future;
+}
+
+std::future<bool> TCPTransport::sendAsync(const uint8_t* data, size_t size) {
+    if (!validateState("sendAsync")) {
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    sendAsyncOn(socket_, data, size, [promise](bool sent) { promise->set_value(sent); });
+    return future;
+}
+
+std::future<bool> TCPTransport::sendAsync(const std::shared_ptr<ConnectionInfo>& connection,
+                                          const uint8_t* data, size_t size) {
+    if (!connection || connection->socket == INVALID_SOCKET_VALUE) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid connection for sendAsync");
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+    connection->lastUsed = std::chrono::steady_clock::now();
+    connection->totalBytesSent += size;
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    sendAsyncOn(connection->socket, data, size, [promise](bool sent) { promise->set_value(sent); });
+    return future;
+}
+
+std::future<size_t> TCPTransport::receiveAsync(uint8_t* buffer, size_t size) {
+    if (!validateState("receiveAsync")) {
+        std::promise<size_t> failed;
+        failed.set_value(0);
+        return failed.get_future();
+    }
+    auto promise = std::make_shared<std::promise<size_t>>();
+    auto future = promise->get_future();
+    receiveAsyncOn(socket_, buffer, size, [promise](size_t received) { promise->set_value(received); });
+    return future;
+}
+
+std::future<size_t> TCPTransport::receiveAsync(const std::shared_ptr<ConnectionInfo>& connection,
+                                               uint8_t* buffer, size_t size) {
+    if (!connection || connection->socket == INVALID_SOCKET_VALUE) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid connection for receiveAsync");
+        std::promise<size_t> failed;
+        failed.set_value(0);
+        return failed.get_future();
+    }
+    connection->lastUsed = std::chrono::steady_clock::now();
+    auto promise = std::make_shared<std::promise<size_t>>();
+    auto future = promise->get_future();
+    receiveAsyncOn(connection->socket, buffer, size, [promise](size_t received) { promise->set_value(received); });
+    return future;
+}
+
+namespace {
+
+utils::CancellationToken operationToken(std::chrono::milliseconds timeout) {
+    auto parent = utils::CancellationToken::current();
+    return timeout.count() > 0 ? parent.child(utils::CancellationToken::Clock::now() + timeout) : parent.child();
+}
+
+} // namespace
+
+TCPTransport::CancellableAsyncResult<bool> TCPTransport::sendAsyncCancellable(const uint8_t* data, size_t size,
+                                                                              std::chrono::milliseconds timeout) {
+    auto token = operationToken(timeout);
+    utils::CancellationScope scope(token);
+    return CancellableAsyncResult<bool>(sendAsync(data, size), token);
+}
+
+TCPTransport::CancellableAsyncResult<size_t> TCPTransport::receiveAsyncCancellable(uint8_t* buffer, size_t size,
+                                                                                   std::chrono::milliseconds timeout) {
+    auto token = operationToken(timeout);
+    utils::CancellationScope scope(token);
+    return CancellableAsyncResult<size_t>(receiveAsync(buffer, size), token);
+}
+
+utils::Awaitable<bool> TCPTransport::connectAwaitable(const std::string& endpoint, uint32_t socketTimeoutMs) {
+    auto resolver = reactorResolver<bool>();
+    ConnectionConfig config = *config_.read();
+    config.connectionTimeoutMs = socketTimeoutMs;
+    executor_->submit([this, endpoint, config, resolver]() {
+        resolver.resolve(connect(endpoint, config));
+    });
+    return resolver.awaitable();
+}
+
+utils::Awaitable<bool> TCPTransport::sendAwaitable(const uint8_t* data, size_t size) {
+    if (!validateState("sendAsync")) {
+        return utils::Awaitable<bool>::ready(false);
+    }
+    auto resolver = reactorResolver<bool>();
+    sendAsyncOn(socket_, data, size, [resolver](bool sent) { resolver.resolve(sent); });
+    return resolver.awaitable();
+}
+
+utils::Awaitable<bool> TCPTransport::sendAwaitable(const uint8_t* data, size_t size, AsyncPriority priority) {
+    auto* resolver = new utils::AwaitableResolver<bool>(reactorResolver<bool>());
+    auto awaitable = resolver->awaitable();
+    auto complete = [](void* context, bool success) {
+        auto* owned = static_cast<utils::AwaitableResolver<bool>*>(context);
+        owned->resolve(success);
+        delete owned;
+    };
+    if (!queueSend(data, size, priority, complete, resolver)) {
+        complete(resolver, false);
+    }
+    return awaitable;
+}
+
+utils::Awaitable<size_t> TCPTransport::receiveAwaitable(uint8_t* buffer, size_t size) {
+    if (!validateState("receiveAsync")) {
+        return utils::Awaitable<size_t>::ready(0);
+    }
+    auto resolver = reactorResolver<size_t>();
+    receiveAsyncOn(socket_, buffer, size, [resolver](size_t received) { resolver.resolve(received); });
+    return resolver.awaitable();
+}
+
+void TCPTransport::setAsyncConfig(const AsyncConfig& config) {
+    std::lock_guard<std::mutex> lock(asyncMutex_);
+    asyncConfig_ = config;
+}
+
+void TCPTransport::sendAsyncOn(NativeSocket socket, const uint8_t* data, size_t size,
+                               std::function<void(bool)> done) {
+    if (!data || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        done(false);
+        return;
+    }
+    if (!beginAsyncOperation("sendAsync")) {
+        done(false);
+        return;
+    }
+    const auto token = utils::CancellationToken::current();
+
+#ifndef _WIN32
+    if (ioEngine_) {
+        auto op = std::make_shared<UringSend>();
+        op->engine = ioEngine_;
+        op->socket = socket;
+        op->data = data;
+        op->size = size;
+        op->token = token;
+        op->timeout = uringTimeout(token, asyncConfig_.operationTimeout);
+        utils::CancellationToken::CallbackId cancelCallback = 0;
+        if (token.isCancellable()) {
+            std::weak_ptr<UringSend> weak = op;
+            cancelCallback = token.onCancel([weak] {
+                auto live = weak.lock();
+                if (live && live->inFlight != 0) {
+                    live->engine->cancel(live->inFlight);
+                }
+            });
+        }
+        op->finish = [this, socket, done, token, cancelCallback](int result) {
+            token.removeCallback(cancelCallback);
+            if (result > 0 && socket == socket_) {
+                linkHealth_.recordSent();
+            }
+            finishAsyncOperation(result, "Async send failed");
+            done(result > 0);
+        };
+        if (token.isCancelled()) {
+            op->finish(-ECANCELED);
+            return;
+        }
+        submitRemaining(op);
+        return;
+    }
+#endif
+
+    executor_->submit([this, socket, data, size, done, token]() {
+        size_t totalSent = 0;
+        int result = 0;
+        if (token.isCancelled()) {
+            // Still queued when the caller gave up; the worker moves straight on
+            finishAsyncOperation(-ECANCELED, "Async send failed");
+            done(false);
+            return;
+        }
+        while (totalSent < size) {
+            ssize_t sent = ::send(socket, reinterpret_cast<const char*>(data + totalSent),
+                                  static_cast<int>(size - totalSent),
+#ifdef _WIN32
+                                  0
+#else
+                                  MSG_NOSIGNAL
+#endif
+            );
+            if (sent > 0) {
+                totalSent += static_cast<size_t>(sent);
+                continue;
+            }
+            if (mapSystemError() == TransportError::WOULD_BLOCK) {
+#ifndef _WIN32
+                if (waitReady(socket, POLLOUT, asyncConfig_.operationTimeout, token)) {
+                    continue;
+                }
+#else
+                if (!token.isCancelled()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+                errno = ECANCELED;
+#endif
+            }
+            result = -errno;
+            break;
+        }
+        if (result == 0 && socket == socket_) {
+            linkHealth_.recordSent();
+        }
+        finishAsyncOperation(result < 0 ? result : static_cast<int>(std::min<size_t>(totalSent, INT_MAX)),
+                             "Async send failed");
+        done(result == 0);
+    });
+}
+
+void TCPTransport::receiveAsyncOn(NativeSocket socket, uint8_t* buffer, size_t size,
+                                  std::function<void(size_t)> done) {
+    if (!buffer || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid receive parameters");
+        done(0);
+        return;
+    }
+    if (!beginAsyncOperation("receiveAsync")) {
+        done(0);
+        return;
+    }
+    const auto token = utils::CancellationToken::current();
+
+#ifndef _WIN32
+    if (ioEngine_) {
+        if (token.isCancelled()) {
+            finishAsyncOperation(-ECANCELED, "Async receive failed");
+            done(0);
+            return;
+        }
+        auto inFlight = std::make_shared<std::atomic<IoUringEngine::OperationId>>(0);
+        utils::CancellationToken::CallbackId cancelCallback = 0;
+        if (token.isCancellable()) {
+            IoUringEngine* engine = ioEngine_;
+            cancelCallback = token.onCancel([engine, inFlight] {
+                if (auto id = inFlight->load()) {
+                    engine->cancel(id);
+                }
+            });
+        }
+        IoUringEngine::OperationId id = 0;
+        bool queued = ioEngine_->submitRecv(socket, buffer, size, [this, socket, done, token, cancelCallback](int result) {
+            token.removeCallback(cancelCallback);
+            if (result > 0 && socket == socket_) {
+                linkHealth_.recordHeard();
+            }
+            finishAsyncOperation(result, "Async receive failed");
+            done(result > 0 ? static_cast<size_t>(result) : 0);
+        }, uringTimeout(token, asyncConfig_.operationTimeout), &id);
+        if (!queued) {
+            token.removeCallback(cancelCallback);
+            finishAsyncOperation(-EBUSY, "Async receive failed");
+            done(0);
+            return;
+        }
+        trackInFlight(ioEngine_, *inFlight, id, token);
+        return;
+    }
+#endif
+
+    executor_->submit([this, socket, buffer, size, done, token]() {
+        if (token.isCancelled()) {
+            finishAsyncOperation(-ECANCELED, "Async receive failed");
+            done(0);
+            return;
+        }
+        ssize_t received;
+        while (true) {
+            received = ::recv(socket, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+            if (received < 0 && mapSystemError() == TransportError::WOULD_BLOCK) {
+#ifndef _WIN32
+                if (waitReady(socket, POLLIN, asyncConfig_.operationTimeout, token)) {
+                    continue;
+                }
+#else
+                if (!token.isCancelled()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+                errno = ECANCELED;
+#endif
+            }
+            break;
+        }
+        int result = received < 0 ? -errno : static_cast<int>(received);
+        if (result > 0 && socket == socket_) {
+            linkHealth_.recordHeard();
+        }
+        finishAsyncOperation(result, "Async receive failed");
+        done(received > 0 ? static_cast<size_t>(received) : 0);
+    });
+}
+
+bool TCPTransport::beginAsyncOperation(const std::string& operation) {
+    if (++pendingAsyncOperations_ > asyncConfig_.maxPendingOperations) {
+        --pendingAsyncOperations_;
+        setError(TransportError::BUFFER_FULL, operation + " rejected: too many pending operations");
+        return false;
+    }
+    return true;
+}
+
+void TCPTransport::finishAsyncOperation(int result, const std::string& operation) {
+    reportAsyncResult(result, operation);
+    --pendingAsyncOperations_;
+}
+
+void TCPTransport::reportAsyncResult(int result, const std::string& operation) {
+    if (result == 0) {
+        setError(TransportError::CONNECTION_CLOSED, operation + ": connection closed by peer");
+    } else if (result == -ECANCELED) {
+        // io_uring reports an expired linked timeout as a cancelled operation; so do cancelled tokens
+        setError(TransportError::TIMEOUT, operation + ": timed out or cancelled");
+    } else if (result < 0) {
+        errno = -result;
+        setError(mapSystemError(), operation + ": " + std::strerror(-result));
+    }
+}
+
+void TCPTransport::drainAsyncOperations() {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+    while (pendingAsyncOperations_ > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool TCPTransport::startReceiveStream(ReceiveHandler handler) {
+    if (!validateState("startReceiveStream")) {
+        return false;
+    }
+    if (!handler || receiveStream_ != 0 || reactorStream_) {
+        setError(TransportError::INVALID_PARAMETER, "Receive stream already active or no handler given");
+        return false;
+    }
+
+    if (ioEngine_ && ioEngine_->supportsStreams()) {
+        receiveStream_ = ioEngine_->startRecvStream(socket_, [this, handler](const uint8_t* data, int result) {
+            if (data) {
+                linkHealth_.recordHeard();
+                handler(data, static_cast<size_t>(result));
+                return;
+            }
+            reportAsyncResult(result, "Receive stream ended");
+            handler(nullptr, 0);
+        });
+        if (receiveStream_ != 0) {
+            return true;
+        }
+    }
+
+    // Readiness fallback: drain the socket each time the reactor reports it readable
+    reactorStream_ = attachReactor(EventReactor::shared(), EventReactor::READABLE,
+        [this, handler](uint32_t) {
+            uint8_t buffer[16384];
+            while (true) {
+                ssize_t received = ::recv(socket_, reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+                if (received > 0) {
+                    linkHealth_.recordHeard();
+                    handler(buffer, static_cast<size_t>(received));
+                    continue;
+                }
+                if (received < 0 && mapSystemError() == TransportError::WOULD_BLOCK) {
+                    return;
+                }
+                if (received == 0) {
+                    setError(TransportError::CONNECTION_CLOSED, "Connection closed by peer");
+                } else {
+                    setError(mapSystemError(), "Receive stream failed");
+                }
+                reactorStream_ = false;
+                detachReactor();
+                handler(nullptr, 0);
+                return;
+            }
+        });
+    if (!reactorStream_) {
+        setError(TransportError::SYSTEM_ERROR, "Failed to start receive stream");
+    }
+    return reactorStream_;
+}
+
+void TCPTransport::stopReceiveStream() {
+    if (auto stream = receiveStream_.exchange(0)) {
+        ioEngine_->stopRecvStream(stream);
+    }
+    if (reactorStream_.exchange(false)) {
+        detachReactor();
+    }
+}
+
+void TCPTransport::closeSocket() {
+    stopReceiveStream();
+    detachReactor();
+    nonBlocking_ = false;
+    receiveTimeout_ = 0;
+#ifndef _WIN32
+    if (ioEngine_ && socket_ != -1) {
+        // Pending io_uring operations hold their own file reference and would outlive close()
+        ioEngine_->cancelFd(socket_);
+    }
+#endif
+#ifdef _WIN32
+    if (socket_ != INVALID_SOCKET) {
+        closesocket(socket_);
+        socket_ = INVALID_SOCKET;
+    }
+#else
+    if (socket_ != -1) {
+        close(socket_);
+        socket_ = -1;
+    }
+#endif
+}
+
+bool TCPTransport::gracefulShutdown() {
+    if (!connected_) {
+        return true;
+    }
+
+#ifdef _WIN32
+    if (shutdown(socket_, SD_BOTH) == SOCKET_ERROR)
+#else
+    if (shutdown(socket_, SHUT_RDWR) == -1)
+#endif
+    {
+        setError(xenocomm::core::TransportError::SHUTDOWN_FAILED, "Failed to shutdown socket");
+        return false;
+    }
+
+    // Wait for pending data to be sent/received
+    char buffer[1024];
+    while (true) {
+        ssize_t received = ::recv(socket_, buffer, sizeof(buffer), 0);
+#ifdef _WIN32
+        if (received == SOCKET_ERROR || received == 0)
+#else
+        if (received <= 0)
+#endif
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+namespace {
+
+void closePooledSocket(TCPTransport::ConnectionInfo& connection) {
+#ifdef _WIN32
+    if (connection.socket != INVALID_SOCKET) {
+        closesocket(connection.socket);
+        connection.socket = INVALID_SOCKET;
+    }
+#else
+    if (connection.socket != -1) {
+        close(connection.socket);
+        connection.socket = -1;
+    }
+#endif
+    connection.state = TCPTransport::ConnectionState::DISCONNECTED;
+}
+
+} // namespace
+
+/**
+ * One endpoint's connections. A slot index is owned by whoever popped it off
+ * the free list; the reaper borrows IDLE slots in place by moving them to
+ * REAPING, so an acquirer that pops such an index waits for it to settle.
+ * Indices of VACANT and IDLE slots stay on the free list at all times.
+ */
+struct TCPTransport::PoolShard {
+    enum SlotState : uint8_t { VACANT, IDLE, IN_USE, REAPING };
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    PoolShard(std::string name, size_t capacity)
+        : endpoint(std::move(name)),
+          slots(capacity),
+          state(new std::atomic<uint8_t>[capacity]),
+          next(new std::atomic<uint32_t>[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) {
+            state[i].store(VACANT, std::memory_order_relaxed);
+            next[i].store(i + 1 < capacity ? static_cast<uint32_t>(i + 1) : NIL, std::memory_order_relaxed);
+        }
+        freeHead.store(capacity > 0 ? 0 : NIL, std::memory_order_relaxed);
+    }
+
+    // Treiber stack of slot indices; the upper half of freeHead is a tag that defeats ABA
+    bool pop(uint32_t& index) {
+        uint64_t head = freeHead.load(std::memory_order_acquire);
+        while (true) {
+            index = static_cast<uint32_t>(head);
+            if (index == NIL) {
+                return false;
+            }
+            uint64_t replacement = (((head >> 32) + 1) << 32) | next[index].load(std::memory_order_relaxed);
+            if (freeHead.compare_exchange_weak(head, replacement, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+
+    void push(uint32_t index) {
+        uint64_t head = freeHead.load(std::memory_order_relaxed);
+        while (true) {
+            next[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t replacement = (((head >> 32) + 1) << 32) | index;
+            if (freeHead.compare_exchange_weak(head, replacement, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // Closes connections idle for longer than idleTimeout while more than keepOpen remain
+    void reap(std::chrono::milliseconds idleTimeout, size_t keepOpen) {
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            uint8_t expected = IDLE;
+            if (!state[i].compare_exchange_strong(expected, REAPING, std::memory_order_acquire)) {
+                continue;
+            }
+            bool expired = now - slots[i]->lastUsed > idleTimeout;
+            size_t count = open.load(std::memory_order_relaxed);
+            while (expired && count > keepOpen &&
+                   !open.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {
+            }
+            if (expired && count > keepOpen) {
+                closePooledSocket(*slots[i]);
+                slots[i].reset();
+                state[i].store(VACANT, std::memory_order_release);
+            } else {
+                state[i].store(IDLE, std::memory_order_release);
+            }
+        }
+    }
+
+    const std::string endpoint;
+    std::vector<std::shared_ptr<ConnectionInfo>> slots;
+    std::unique_ptr<std::atomic<uint8_t>[]> state;
+    std::unique_ptr<std::atomic<uint32_t>[]> next;
+    std::atomic<uint64_t> freeHead{0};
+    EventReactor::TimerId reaper{0};
+
+    // Statistics are relaxed: readers only want a snapshot
+    std::atomic<size_t> open{0};
+    std::atomic<size_t> inUse{0};
+    std::atomic<size_t> created{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<size_t> errors{0};
+    std::atomic<int64_t> avgResponseUs{-1};
+    std::atomic<bool> healthy{true};
+};
+
+TCPTransport::PoolShard* TCPTransport::findShard(const std::string& endpoint) const {
+    if (!poolShards_) {
+        return nullptr;
+    }
+    size_t bucket = std::hash<std::string>{}(endpoint) % POOL_SHARD_BUCKETS;
+    for (size_t probe = 0; probe < POOL_SHARD_BUCKETS; ++probe) {
+        PoolShard* shard = poolShards_[(bucket + probe) % POOL_SHARD_BUCKETS].load(std::memory_order_acquire);
+        if (!shard) {
+            return nullptr;  // Buckets are filled in probe order and never cleared
+        }
+        if (shard->endpoint == endpoint) {
+            return shard;
+        }
+    }
+    return nullptr;
+}
+
+TCPTransport::PoolShard* TCPTransport::findOrCreateShard(const std::string& endpoint) {
+    if (PoolShard* shard = findShard(endpoint)) {
+        return shard;
+    }
+
+    std::lock_guard<utils::ProfiledMutex<>> lock(poolMutex_);
+    if (!poolShards_) {
+        return nullptr;
+    }
+    size_t bucket = std::hash<std::string>{}(endpoint) % POOL_SHARD_BUCKETS;
+    for (size_t probe = 0; probe < POOL_SHARD_BUCKETS; ++probe) {
+        auto& entry = poolShards_[(bucket + probe) % POOL_SHARD_BUCKETS];
+        PoolShard* shard = entry.load(std::memory_order_acquire);
+        if (shard) {
+            if (shard->endpoint == endpoint) {
+                return shard;
+            }
+            continue;
+        }
+
+        shard = new PoolShard(endpoint, std::max<size_t>(poolConfig_.maxConnections, 1));
+        // The reaper captures only the shard, so it survives moving the transport
+        auto idleTimeout = std::chrono::milliseconds(poolConfig_.idleTimeout);
+        size_t keepOpen = poolConfig_.initialConnections;
+        shard->reaper = EventReactor::shared().scheduleEvery(
+            std::max(idleTimeout / 2, std::chrono::milliseconds(1)),
+            [shard, idleTimeout, keepOpen]() { shard->reap(idleTimeout, keepOpen); });
+        entry.store(shard, std::memory_order_release);
+        return shard;
+    }
+    return nullptr;
+}
+
+void TCPTransport::destroyPool() {
+    if (!poolShards_) {
+        return;
+    }
+    for (size_t bucket = 0; bucket < POOL_SHARD_BUCKETS; ++bucket) {
+        PoolShard* shard = poolShards_[bucket].exchange(nullptr, std::memory_order_acq_rel);
+        if (!shard) {
+            continue;
+        }
+        if (shard->reaper) {
+            EventReactor::shared().cancelTimer(shard->reaper);
+        }
+        for (auto& connection : shard->slots) {
+            if (connection) {
+                closePooledSocket(*connection);
+            }
+        }
+        delete shard;
+    }
+}
+
+std::shared_ptr<TCPTransport::ConnectionInfo> TCPTransport::acquireConnection(const std::string& endpoint) {
+    PoolShard* shard = findOrCreateShard(endpoint);
+    if (!shard) {
+        setError(TransportError::RESOURCE_ERROR, "Connection pool cannot track more endpoints");
+        return nullptr;
+    }
+
+    uint32_t slot;
+    if (!shard->pop(slot)) {
+        setError(TransportError::RESOURCE_ERROR, "Connection pool for " + endpoint + " is exhausted");
+        return nullptr;
+    }
+
+    // VACANT is stable once popped; IDLE may briefly turn into REAPING under the reaper
+    uint8_t previous = shard->state[slot].load(std::memory_order_acquire);
+    while (true) {
+        if (previous == PoolShard::REAPING) {
+            std::this_thread::yield();
+            previous = shard->state[slot].load(std::memory_order_acquire);
+            continue;
+        }
+        if (shard->state[slot].compare_exchange_weak(previous, PoolShard::IN_USE, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    auto& connection = shard->slots[slot];
+    if (previous == PoolShard::IDLE && poolConfig_.validateOnBorrow && !validateConnection(connection)) {
+        closePooledSocket(*connection);
+        connection.reset();
+        shard->open.fetch_sub(1, std::memory_order_relaxed);
+        shard->errors.fetch_add(1, std::memory_order_relaxed);
+        previous = PoolShard::VACANT;
+    }
+    if (previous == PoolShard::VACANT) {
+        connection = createConnection(*shard);
+        if (!connection) {
+            shard->state[slot].store(PoolShard::VACANT, std::memory_order_release);
+            shard->push(slot);
+            return nullptr;
+        }
+        connection->poolSlot = slot;
+        shard->open.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    connection->inUse = true;
+    connection->lastUsed = std::chrono::steady_clock::now();
+    shard->inUse.fetch_add(1, std::memory_order_relaxed);
+    return connection;
+}
+
+void TCPTransport::releaseConnection(std::shared_ptr<ConnectionInfo> connection) {
+    if (!connection) {
+        return;
+    }
+
+    PoolShard* shard = findShard(connection->endpoint);
+    uint32_t slot = connection->poolSlot;
+    if (!shard || slot >= shard->slots.size() ||
+        shard->state[slot].load(std::memory_order_acquire) != PoolShard::IN_USE ||
+        shard->slots[slot] != connection) {
+        setError(TransportError::INVALID_PARAMETER, "Connection is not borrowed from this pool");
+        return;
+    }
+
+    connection->inUse = false;
+    shard->inUse.fetch_sub(1, std::memory_order_relaxed);
+    if (poolConfig_.validateOnReturn && !validateConnection(connection)) {
+        closePooledSocket(*connection);
+        shard->slots[slot].reset();
+        shard->open.fetch_sub(1, std::memory_order_relaxed);
+        shard->errors.fetch_add(1, std::memory_order_relaxed);
+        shard->state[slot].store(PoolShard::VACANT, std::memory_order_release);
+    } else {
+        connection->lastUsed = std::chrono::steady_clock::now();
+        shard->state[slot].store(PoolShard::IDLE, std::memory_order_release);
+    }
+    shard->push(slot);
+}
+
+std::shared_ptr<TCPTransport::ConnectionInfo> TCPTransport::createConnection(PoolShard& shard) {
+    const auto config = config_.read();
+    auto started = std::chrono::steady_clock::now();
+    auto connection = std::make_shared<ConnectionInfo>();
+    connection->endpoint = shard.endpoint;
+
+    auto fail = [&](TransportError code, const std::string& message) -> std::shared_ptr<ConnectionInfo> {
+        closePooledSocket(*connection);
+        shard.failed.fetch_add(1, std::memory_order_relaxed);
+        shard.healthy.store(false, std::memory_order_relaxed);
+        setError(code, message);
+        return nullptr;
+    };
+
+    auto [host, port] = parseEndpoint(shard.endpoint);
+    if (host.empty() || port == 0) {
+        return fail(TransportError::INVALID_PARAMETER, "Invalid endpoint format");
+    }
+
+    // warmupConnections() and refills resolve once per TTL, not once per connection
+    auto addresses = AddressResolver::shared().resolve(host, port);
+    if (!addresses) {
+        return fail(TransportError::RESOLUTION_FAILED, "Failed to resolve hostname");
+    }
+
+    connection->socket = raceConnect(*addresses, poolConfig_.connectionTimeout,
+                                     std::chrono::milliseconds(config->connectAttemptDelayMs), 0);
+    if (connection->socket == INVALID_SOCKET_VALUE) {
+        auto code = mapSystemError();
+        std::string details = "Failed to connect to " + shard.endpoint + ": " + getSystemError();
+        AddressResolver::shared().invalidate(host, port);
+        return fail(code, details);
+    }
+
+    // Keep sends to a stalled peer bounded, as the blocking connect used to be
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(poolConfig_.connectionTimeout);
+#else
+    struct timeval timeout;
+    timeout.tv_sec = poolConfig_.connectionTimeout / 1000;
+    timeout.tv_usec = (poolConfig_.connectionTimeout % 1000) * 1000;
+#endif
+    int noDelay = 1;
+    setsockopt(connection->socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    setsockopt(connection->socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    auto now = std::chrono::steady_clock::now();
+    connection->state = ConnectionState::CONNECTED;
+    connection->created = now;
+    connection->lastUsed = now;
+    shard.created.fetch_add(1, std::memory_order_relaxed);
+    shard.healthy.store(true, std::memory_order_relaxed);
+    updateResponseStats(shard, std::chrono::duration_cast<std::chrono::microseconds>(now - started));
+    return connection;
+}
+
+void TCPTransport::updateResponseStats(PoolShard& shard, std::chrono::microseconds responseTime) {
+    // Exponential moving average with alpha = 0.2; racing updaters may drop a sample, which is fine for a gauge
+    int64_t sample = responseTime.count();
+    int64_t average = shard.avgResponseUs.load(std::memory_order_relaxed);
+    shard.avgResponseUs.store(average < 0 ? sample : static_cast<int64_t>(0.8 * average + 0.2 * sample),
+                              std::memory_order_relaxed);
+}
+
+void TCPTransport::cleanupIdleConnections() {
+    if (!poolShards_) {
+        return;
+    }
+    auto idleTimeout = std::chrono::milliseconds(poolConfig_.idleTimeout);
+    for (size_t bucket = 0; bucket < POOL_SHARD_BUCKETS; ++bucket) {
+        if (PoolShard* shard = poolShards_[bucket].load(std::memory_order_acquire)) {
+            shard->reap(idleTimeout, poolConfig_.initialConnections);
+        }
+    }
+}
+
+bool TCPTransport::warmupConnections(const std::string& endpoint, size_t numConnections) {
+    std::vector<std::shared_ptr<ConnectionInfo>> warmed;
+    warmed.reserve(numConnections);
+    for (size_t i = 0; i < numConnections; ++i) {
+        auto connection = acquireConnection(endpoint);
+        if (!connection) {
+            break;
+        }
+        warmed.push_back(std::move(connection));
+    }
+    bool complete = warmed.size() == numConnections;
+    for (auto& connection : warmed) {
+        releaseConnection(std::move(connection));
+    }
+    return complete;
+}
+
+TCPTransport::PoolStats TCPTransport::getDetailedPoolStats() const {
+    PoolStats stats{};
+    double responseSum = 0.0;
+    size_t responseShards = 0;
+    if (poolShards_) {
+        for (size_t bucket = 0; bucket < POOL_SHARD_BUCKETS; ++bucket) {
+            const PoolShard* shard = poolShards_[bucket].load(std::memory_order_acquire);
+            if (!shard) {
+                continue;
+            }
+            size_t open = shard->open.load(std::memory_order_relaxed);
+            size_t inUse = shard->inUse.load(std::memory_order_relaxed);
+            stats.activeConnections += inUse;
+            stats.availableConnections += shard->slots.size() - std::min(inUse, shard->slots.size());
+            stats.idleConnections += open - std::min(inUse, open);  // Counters are read independently
+            stats.totalCreated += shard->created.load(std::memory_order_relaxed);
+            stats.failedAttempts += shard->failed.load(std::memory_order_relaxed);
+            stats.totalErrors += shard->errors.load(std::memory_order_relaxed);
+            int64_t average = shard->avgResponseUs.load(std::memory_order_relaxed);
+            if (average >= 0) {
+                responseSum += average / 1000.0;
+                ++responseShards;
+            }
+        }
+    }
+    stats.avgResponseTime = responseShards > 0 ? responseSum / responseShards : 0.0;
+    return stats;
+}
+
+std::string TCPTransport::getPoolStats() const {
+    PoolStats stats = getDetailedPoolStats();
+    std::ostringstream out;
+    out << "active=" << stats.activeConnections
+        << " idle=" << stats.idleConnections
+        << " available=" << stats.availableConnections
+        << " created=" << stats.totalCreated
+        << " failed=" << stats.failedAttempts
+        << " errors=" << stats.totalErrors
+        << " avgResponseMs=" << stats.avgResponseTime;
+    return out.str();
+}
+
+void TCPTransport::registerMetrics(utils::MetricsRegistry& registry, const std::string& instance) {
+    metricsRegistration_ = registry.addCollector([this, instance](utils::MetricsWriter& writer) {
+        const utils::MetricLabels labels{{"instance", instance}};
+        const PoolStats stats = getDetailedPoolStats();
+        writer.gauge("xenocomm_tcp_pool_active_connections", "Pooled connections in use",
+                     static_cast<double>(stats.activeConnections), labels);
+        writer.gauge("xenocomm_tcp_pool_idle_connections", "Open pooled connections not in use",
+                     static_cast<double>(stats.idleConnections), labels);
+        writer.gauge("xenocomm_tcp_pool_available_connections", "Pool slots free to acquire",
+                     static_cast<double>(stats.availableConnections), labels);
+        writer.counter("xenocomm_tcp_pool_connections_created", "Pooled connections opened",
+                       static_cast<double>(stats.totalCreated), labels);
+        writer.counter("xenocomm_tcp_pool_connect_failures", "Failed pool connection attempts",
+                       static_cast<double>(stats.failedAttempts), labels);
+        writer.counter("xenocomm_tcp_pool_errors", "Errors on pooled connections",
+                       static_cast<double>(stats.totalErrors), labels);
+        writer.gauge("xenocomm_tcp_pool_response_avg_ms", "Mean response time across endpoints",
+                     stats.avgResponseTime, labels);
+    });
+}
+
+std::map<std::string, bool> TCPTransport::checkPoolHealth() const {
+    std::map<std::string, bool> health;
+    if (poolShards_) {
+        for (size_t bucket = 0; bucket < POOL_SHARD_BUCKETS; ++bucket) {
+            if (const PoolShard* shard = poolShards_[bucket].load(std::memory_order_acquire)) {
+                health[shard->endpoint] = shard->healthy.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return health;
+}
+
+bool TCPTransport::getPeerAddress(std::string& address, uint16_t& port) {
+    if (!isConnected()) {
+        setError(xenocomm::core::TransportError::NOT_CONNECTED, "Not connected");
+        return false;
+    }
+    
+    struct sockaddr_in peerAddr;
+    socklen_t addrLen = sizeof(peerAddr);
+    
+#ifdef _WIN32
+    if (getpeername(socket_, (struct sockaddr*)&peerAddr, &addrLen) == SOCKET_ERROR) {
+        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to get peer name: " + getSystemError());
+        return false;
+    }
+#else
+    if (getpeername(socket_, (struct sockaddr*)&peerAddr, &addrLen) < 0) {
+        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to get peer name: " + getSystemError());
+        return false;
+    }
+#endif
+    
+    char addrStr[INET_ADDRSTRLEN];
+#ifdef _WIN32
+    if (inet_ntop(AF_INET, &(peerAddr.sin_addr), addrStr, INET_ADDRSTRLEN) == NULL) {
+        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to convert address: " + getSystemError());
+        return false;
+    }
+#else
+    if (inet_ntop(AF_INET, &(peerAddr.sin_addr), addrStr, INET_ADDRSTRLEN) == NULL) {
         setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to convert address: " + getSystemError());
         return false;
     }
@@ -962,7 +2402,7 @@ bool TCPTransport::setReceiveTimeout(const std::chrono::milliseconds& timeout) {
         return false;
     }
 #endif
-    
+    receiveTimeout_ = static_cast<int64_t>(timeout.count());
     return true;
 }
 
@@ -1091,6 +2531,22 @@ bool TCPTransport::setSendBufferSize(size_t size) {
     return true;
 }
 
+bool TCPTransport::setPacingRate(uint64_t bytesPerSecond) {
+#if defined(__linux__) && defined(SO_MAX_PACING_RATE)
+    // TCP paces internally once a rate is set, no fq qdisc needed
+    uint64_t rate = bytesPerSecond != 0 ? bytesPerSecond : ~0ULL;
+    if (setsockopt(socket_, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)) < 0) {
+        setError(xenocomm::core::TransportError::SOCKET_ERROR, "Failed to set pacing rate: " + getSystemError());
+        return false;
+    }
+    return true;
+#else
+    (void)bytesPerSecond;
+    setError(xenocomm::core::TransportError::INVALID_STATE, "Kernel pacing is not supported on this platform");
+    return false;
+#endif
+}
+
 bool TCPTransport::validateConnection(std::shared_ptr<ConnectionInfo> const& connection) {
     if (!connection) {
         return false;
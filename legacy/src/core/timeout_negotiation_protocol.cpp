@@ -1,24 +1,37 @@
 #include "xenocomm/core/timeout_negotiation_protocol.h"
+#include "xenocomm/utils/cancellation.hpp"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <thread>
+#include <vector>
 
 namespace xenocomm {
 namespace core {
 
-TimeoutNegotiationProtocol::TimeoutNegotiationProtocol(const TimeoutConfig& config, bool enableLogging)
+TimeoutNegotiationProtocol::TimeoutNegotiationProtocol(const TimeoutConfig& config,
+                                                       bool enableLogging,
+                                                       utils::TimerService* timers)
     : config_(config)
-    , enableLogging_(enableLogging) {
-    // Start the cleanup thread
-    cleanupThread_ = std::thread(&TimeoutNegotiationProtocol::cleanupTimedOutSessions, this);
+    , enableLogging_(enableLogging)
+    , timers_(timers ? timers : &utils::TimerService::shared()) {
 }
 
 TimeoutNegotiationProtocol::~TimeoutNegotiationProtocol() noexcept {
     try {
-        // Signal the cleanup thread to stop and wait for it
-        shouldStopCleanup_ = true;
-        if (cleanupThread_.joinable()) {
-            cleanupThread_.join();
+        // Stop callbacks from scheduling new timers, then cancel the existing ones
+        // outside the lock so a callback waiting on it can finish
+        std::vector<utils::TimerService::TimerId> timers;
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex_);
+            closing_ = true;
+            for (const auto& [id, session] : sessions_) {
+                timers.push_back(session.expiryTimer);
+            }
+        }
+        for (auto timer : timers) {
+            timers_->cancel(timer);
         }
 
         // Clean up any remaining active sessions
@@ -49,8 +62,11 @@ NegotiationProtocol::SessionId TimeoutNegotiationProtocol::initiateSession(
         sessionData.proposedParams = proposedParams;
         sessionData.isActive = true;
         sessionData.retryCount = 0;
+        sessionData.expiryTimer = timers_->scheduleAt(expiryDeadline(sessionData),
+                                                      [this, sessionId] { onSessionExpiry(sessionId); });
     }
     
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
     if (!attemptWithRetry(sessionId, [&]() {
         // Actual network communication would happen here
         // For now, just simulate success
@@ -160,6 +176,22 @@ std::optional<NegotiableParams> TimeoutNegotiationProtocol::getNegotiatedParams(
     return session.agreedParams;
 }
 
+std::optional<NegotiableParams> TimeoutNegotiationProtocol::getCounterProposal(const SessionId sessionId) const {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end()) {
+        throw std::runtime_error("Invalid session ID");
+    }
+    
+    // The counter replaces the proposal until it is accepted or rejected
+    const auto& session = it->second;
+    if (session.state != NegotiationState::COUNTER_RECEIVED) {
+        return std::nullopt;
+    }
+    return session.proposedParams;
+}
+
 bool TimeoutNegotiationProtocol::acceptCounterProposal(const SessionId sessionId) {
     std::lock_guard<std::mutex> lock(sessionsMutex_);
     
@@ -208,6 +240,34 @@ bool TimeoutNegotiationProtocol::rejectCounterProposal(
     return success;
 }
 
+bool TimeoutNegotiationProtocol::renegotiateSession(const SessionId sessionId,
+                                                   const NegotiableParams& updatedParams) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end() || hasSessionTimedOut(sessionId)) {
+        throw std::runtime_error("Invalid or timed out session ID");
+    }
+    
+    auto& session = it->second;
+    if (session.state != NegotiationState::FINALIZED) {
+        throw std::runtime_error("Only finalized sessions can be renegotiated");
+    }
+    if (!isRenegotiable(session.agreedParams.value_or(session.proposedParams), updatedParams)) {
+        throw std::runtime_error("Renegotiation may only change compression, error correction and custom parameters");
+    }
+    
+    // The session never leaves FINALIZED, so the agreed parameters are replaced only once confirmed
+    bool success = attemptWithRetry(sessionId, [&]() {
+        // Actual renegotiation exchange would go here
+        session.agreedParams = updatedParams;
+        return true;
+    });
+    
+    updateActivityTime(sessionId);
+    return success;
+}
+
 bool TimeoutNegotiationProtocol::closeSession(const SessionId sessionId) {
     std::lock_guard<std::mutex> lock(sessionsMutex_);
     
@@ -220,14 +280,24 @@ bool TimeoutNegotiationProtocol::closeSession(const SessionId sessionId) {
     session.state = NegotiationState::CLOSED;
     session.isActive = false;
     
+    // Remove it now rather than at its timeout
+    timers_->reschedule(session.expiryTimer, std::chrono::steady_clock::now());
     return true;
 }
 
 bool TimeoutNegotiationProtocol::attemptWithRetry(const SessionId sessionId,
                                                  const std::function<bool()>& operation) {
     auto& session = sessions_.at(sessionId);
+    const auto token = utils::CancellationToken::current();
     
     for (uint8_t attempt = 0; attempt <= config_.maxRetries; ++attempt) {
+        if (token.isCancelled()) {
+            if (enableLogging_) {
+                std::cerr << "Session " << sessionId << " cancelled before retry attempt "
+                         << static_cast<int>(attempt) << std::endl;
+            }
+            return false;
+        }
         if (hasSessionTimedOut(sessionId)) {
             if (enableLogging_) {
                 std::cerr << "Session " << sessionId << " timed out during retry attempt "
@@ -267,7 +337,8 @@ bool TimeoutNegotiationProtocol::attemptWithRetry(const SessionId sessionId,
                          << static_cast<int>(attempt) + 1 << ")" << std::endl;
             }
             
-            std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long>(totalDelay)));
+            // The backoff ends early if the caller gives up; the check above then stops the retries
+            token.sleepFor(std::chrono::milliseconds(static_cast<long>(totalDelay)));
             session.retryCount++;
         }
     }
@@ -312,33 +383,48 @@ bool TimeoutNegotiationProtocol::hasSessionTimedOut(const SessionId sessionId) c
 void TimeoutNegotiationProtocol::updateActivityTime(const SessionId sessionId) {
     auto it = sessions_.find(sessionId);
     if (it != sessions_.end()) {
-        it->second.lastActivityTime = std::chrono::steady_clock::now();
-        it->second.retryCount = 0; // Reset retry count on successful activity
+        auto& session = it->second;
+        session.lastActivityTime = std::chrono::steady_clock::now();
+        session.retryCount = 0; // Reset retry count on successful activity
+        if (session.isActive) {
+            // Fails only if the timer is firing; its callback will see the new time
+            timers_->reschedule(session.expiryTimer, expiryDeadline(session));
+        }
     }
 }
 
-void TimeoutNegotiationProtocol::cleanupTimedOutSessions() {
-    while (!shouldStopCleanup_) {
-        {
-            std::lock_guard<std::mutex> lock(sessionsMutex_);
-            auto it = sessions_.begin();
-            while (it != sessions_.end()) {
-                if (!it->second.isActive || hasSessionTimedOut(it->first)) {
-                    if (enableLogging_) {
-                        std::cerr << "Cleaning up " << (it->second.isActive ? "timed out" : "inactive")
-                                 << " session " << it->first << std::endl;
-                    }
-                    it = sessions_.erase(it);
-                } else {
-                    ++it;
-                }
-            }
+std::chrono::steady_clock::time_point TimeoutNegotiationProtocol::expiryDeadline(
+    const SessionData& session) const {
+    // hasSessionTimedOut() is strict, so fire just after the limit rather than on it
+    return std::min(session.startTime + config_.negotiationTimeout,
+                    session.lastActivityTime + config_.responseTimeout) +
+           std::chrono::milliseconds(1);
+}
+
+void TimeoutNegotiationProtocol::onSessionExpiry(const SessionId sessionId) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    if (closing_) {
+        return;
+    }
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end()) {
+        return;
+    }
+
+    auto& session = it->second;
+    if (!session.isActive || hasSessionTimedOut(sessionId)) {
+        if (enableLogging_) {
+            std::cerr << "Cleaning up " << (session.isActive ? "timed out" : "inactive")
+                     << " session " << sessionId << std::endl;
         }
-        
-        // Sleep for half the response timeout duration before next cleanup cycle
-        std::this_thread::sleep_for(config_.responseTimeout / 2);
+        sessions_.erase(it);
+        return;
     }
+
+    // Activity moved the deadline while this timer was firing
+    session.expiryTimer = timers_->scheduleAt(expiryDeadline(session),
+                                              [this, sessionId] { onSessionExpiry(sessionId); });
 }
 
 } // namespace core
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
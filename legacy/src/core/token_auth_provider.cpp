@@ -1,107 +1,244 @@
 #include "xenocomm/core/token_auth_provider.hpp"
+#include "xenocomm/core/auth_cache.hpp"
+#include "xenocomm/utils/hmac.hpp"
+#include <openssl/crypto.h>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <charconv>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace xenocomm {
 namespace core {
 
-struct TokenInfo {
-    std::string agentId;
-    std::chrono::steady_clock::time_point expiryTime;
-};
+namespace {
+
+constexpr size_t SIGNATURE_HEX_SIZE = 2 * SHA256_DIGEST_LENGTH;
+
+bool sign(const utils::HmacSha256& key, const char* data, size_t size, uint8_t* tag) {
+    return key.mac(utils::ByteSpan(reinterpret_cast<const uint8_t*>(data), size), tag);
+}
+
+std::string toHex(const uint8_t* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(2 * size, '0');
+    for (size_t i = 0; i < size; ++i) {
+        hex[2 * i] = digits[data[i] >> 4];
+        hex[2 * i + 1] = digits[data[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool fromHex(const char* hex, size_t bytes, uint8_t* out) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    for (size_t i = 0; i < bytes; ++i) {
+        int high = nibble(hex[2 * i]);
+        int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return true;
+}
+
+} // namespace
 
 class TokenAuthProvider::Impl {
 public:
-    explicit Impl(TokenAuthConfig config) : config_(std::move(config)) {}
+    explicit Impl(TokenAuthConfig config)
+        : config_(std::move(config)),
+          tokens_(config_.cache ? config_.cache
+                                : std::make_shared<AuthCache>(config_.maxActiveTokens, config_.tokenTTL)) {
+        if (!config_.signingKey.empty()) {
+            signingKey_.emplace(config_.signingKey);
+            OPENSSL_cleanse(config_.signingKey.data(), config_.signingKey.size());
+            config_.signingKey.clear();
+        }
+    }
 
     bool initialize() {
-        if (!config_.validator) {
-            return false;  // Validator function is required
+        if (!config_.validator && !signingKey_) {
+            return false;  // Validator function or signing key is required
         }
         return true;
     }
 
     AuthResult authenticate(const AuthenticationContext& context) {
+        std::string token = tokenOf(context);
+        if (auto invalid = checkLength(token)) {
+            return *invalid;
+        }
+        return authenticateToken(token, digestOf(token));
+    }
+
+    std::vector<AuthResult> authenticateBatch(const std::vector<AuthenticationContext>& contexts) {
+        std::vector<AuthResult> results;
+        results.reserve(contexts.size());
+        // Agents present the same token on many connections; with reuse allowed each is checked once
+        std::unordered_map<std::string, size_t> first;  // Digest to its first result
+        for (const auto& context : contexts) {
+            std::string token = tokenOf(context);
+            if (auto invalid = checkLength(token)) {
+                results.push_back(std::move(*invalid));
+                continue;
+            }
+            std::string digest = digestOf(token);
+            if (config_.allowReuse) {
+                auto [seen, inserted] = first.emplace(digest, results.size());
+                if (!inserted) {
+                    results.push_back(results[seen->second]);
+                    continue;
+                }
+            }
+            results.push_back(authenticateToken(token, digest));
+        }
+        return results;
+    }
+
+    std::string getMethodName() const {
+        return "token";
+    }
+
+    void revokeToken(const std::string& token) {
+        std::string digest = digestOf(token);
+        {
+            std::unique_lock<std::shared_mutex> lock(revokedMutex_);
+            revokedTokens_.insert(digest);
+        }
+        tokens_->erase(cacheKey(digest));
+    }
+
+    void cleanupExpiredTokens() {
+        tokens_->cleanupExpired();
+
+        // Optionally, we could also clean up old revoked tokens here
+        // but keeping them indefinitely provides better security against replay attacks
+    }
+
+private:
+    static std::string tokenOf(const AuthenticationContext& context) {
         // Convert credentials to string token
-        std::string token(reinterpret_cast<const char*>(context.credentials.data()),
-                         context.credentials.size());
+        return std::string(reinterpret_cast<const char*>(context.credentials.data()),
+                           context.credentials.size());
+    }
+
+    static std::string digestOf(const std::string& token) {
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+        SHA256(reinterpret_cast<const uint8_t*>(token.data()), token.size(), digest);
+        return std::string(reinterpret_cast<const char*>(digest), sizeof(digest));
+    }
 
+    // The cache may be shared with other providers
+    static std::string cacheKey(const std::string& digest) {
+        return "token:" + digest;
+    }
+
+    std::optional<AuthResult> checkLength(const std::string& token) const {
         // Basic token validation
         if (token.length() < config_.minTokenLength || 
             token.length() > config_.maxTokenLength) {
             return AuthResult::Failure("Invalid token length");
         }
+        return std::nullopt;
+    }
 
+    AuthResult authenticateToken(const std::string& token, const std::string& digest) {
         // Check if token is revoked
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (revokedTokens_.find(token) != revokedTokens_.end()) {
+            std::shared_lock<std::shared_mutex> lock(revokedMutex_);
+            if (revokedTokens_.find(digest) != revokedTokens_.end()) {
                 return AuthResult::Failure("Token has been revoked");
             }
         }
 
-        // Check if token is already in use (if reuse is not allowed)
+        const std::string key = cacheKey(digest);
         if (!config_.allowReuse) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (activeTokens_.find(token) != activeTokens_.end()) {
+            // Check if token is already in use
+            if (tokens_->contains(key)) {
                 return AuthResult::Failure("Token is already in use");
             }
+        } else if (auto agentId = tokens_->lookup(key)) {
+            // Validated earlier and not yet expired
+            return AuthResult::Success(*agentId);
         }
 
-        // Validate token using provided validator
         std::string agentId, error;
-        if (!config_.validator(token, agentId, error)) {
-            return AuthResult::Failure(error);
+        if (config_.validator) {
+            // Validate token using provided validator
+            if (!config_.validator(token, agentId, error)) {
+                return AuthResult::Failure(error);
+            }
+            tokens_->insert(key, agentId);
+            return AuthResult::Success(agentId);
         }
 
-        // Store token information
-        auto now = std::chrono::steady_clock::now();
-        auto expiryTime = now + config_.tokenTTL;
-
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            activeTokens_[token] = TokenInfo{
-                agentId,
-                expiryTime
-            };
+        std::chrono::system_clock::time_point expiresAt;
+        if (!verifySigned(token, agentId, expiresAt, error)) {
+            return AuthResult::Failure(error);
+        }
+        // Cached no longer than the token is good for
+        auto remaining = std::chrono::duration_cast<std::chrono::seconds>(expiresAt - std::chrono::system_clock::now());
+        if (remaining.count() > 0) {
+            tokens_->insert(key, agentId, remaining);
         }
-
         return AuthResult::Success(agentId);
     }
 
-    std::string getMethodName() const {
-        return "token";
-    }
-
-    void revokeToken(const std::string& token) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        activeTokens_.erase(token);
-        revokedTokens_.insert(token);
-    }
+    bool verifySigned(const std::string& token, std::string& agentId,
+                      std::chrono::system_clock::time_point& expiresAt, std::string& error) const {
+        const size_t signatureDot = token.rfind('.');
+        const size_t expiryDot = signatureDot == std::string::npos || signatureDot == 0
+                                     ? std::string::npos
+                                     : token.rfind('.', signatureDot - 1);
+        if (expiryDot == std::string::npos || token.size() - signatureDot - 1 != SIGNATURE_HEX_SIZE) {
+            error = "Malformed token";
+            return false;
+        }
 
-    void cleanupExpiredTokens() {
-        auto now = std::chrono::steady_clock::now();
-        std::lock_guard<std::mutex> lock(mutex_);
-
-        // Remove expired tokens
-        for (auto it = activeTokens_.begin(); it != activeTokens_.end();) {
-            if (it->second.expiryTime <= now) {
-                it = activeTokens_.erase(it);
-            } else {
-                ++it;
-            }
+        uint8_t presented[SHA256_DIGEST_LENGTH];
+        uint8_t expected[SHA256_DIGEST_LENGTH];
+        if (!fromHex(token.data() + signatureDot + 1, sizeof(presented), presented)) {
+            error = "Malformed token";
+            return false;
+        }
+        if (!sign(*signingKey_, token.data(), signatureDot, expected) ||
+            CRYPTO_memcmp(presented, expected, sizeof(expected)) != 0) {
+            error = "Invalid token signature";
+            return false;
         }
 
-        // Optionally, we could also clean up old revoked tokens here
-        // but keeping them indefinitely provides better security against replay attacks
+        int64_t expiry = 0;
+        const char* expiryBegin = token.data() + expiryDot + 1;
+        const char* expiryEnd = token.data() + signatureDot;
+        auto parsed = std::from_chars(expiryBegin, expiryEnd, expiry);
+        if (parsed.ec != std::errc() || parsed.ptr != expiryEnd) {
+            error = "Malformed token";
+            return false;
+        }
+        expiresAt = std::chrono::system_clock::time_point(std::chrono::seconds(expiry));
+        if (expiresAt <= std::chrono::system_clock::now()) {
+            error = "Token has expired";
+            return false;
+        }
+        agentId = token.substr(0, expiryDot);
+        return true;
     }
 
-private:
     TokenAuthConfig config_;
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, TokenInfo> activeTokens_;
-    std::unordered_set<std::string> revokedTokens_;
+    std::shared_ptr<AuthCache> tokens_;
+    std::optional<utils::HmacSha256> signingKey_;
+    mutable std::shared_mutex revokedMutex_;  // Read on every request, written only on revocation
+    std::unordered_set<std::string> revokedTokens_;  // Digests
 };
 
 // TokenAuthProvider implementation
@@ -118,6 +255,21 @@ AuthResult TokenAuthProvider::authenticate(const AuthenticationContext& context)
     return impl_->authenticate(context);
 }
 
+std::vector<AuthResult> TokenAuthProvider::authenticateBatch(const std::vector<AuthenticationContext>& contexts) {
+    return impl_->authenticateBatch(contexts);
+}
+
+std::string TokenAuthProvider::issueToken(const std::vector<uint8_t>& signingKey, const std::string& agentId,
+                                          std::chrono::system_clock::time_point expiresAt) {
+    const auto expiry = std::chrono::duration_cast<std::chrono::seconds>(expiresAt.time_since_epoch()).count();
+    std::string token = agentId + "." + std::to_string(expiry);
+    uint8_t tag[utils::HmacSha256::DIGEST_SIZE];
+    if (!sign(utils::HmacSha256(signingKey), token.data(), token.size(), tag)) {
+        throw std::runtime_error("Failed to sign token");
+    }
+    return token + "." + toHex(tag, sizeof(tag));
+}
+
 std::string TokenAuthProvider::getMethodName() const {
     return impl_->getMethodName();
 }
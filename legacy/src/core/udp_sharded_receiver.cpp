@@ -0,0 +1,148 @@
+#include "xenocomm/core/udp_sharded_receiver.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace xenocomm {
+namespace core {
+
+namespace {
+
+// CPUs the process may run on, in ID order
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+} // namespace
+
+UDPShardedReceiver::UDPShardedReceiver(Config config) : config_(std::move(config)) {}
+
+UDPShardedReceiver::~UDPShardedReceiver() {
+    stop();
+}
+
+bool UDPShardedReceiver::openShard(Shard& shard, uint16_t port) {
+    ConnectionConfig connection;
+    connection.healthMonitoring = false;
+    UDPTransport& transport = shard.transport;
+    // Peers are learned from what they send, so there is no default peer to connect to
+    if (!transport.setLocalPort(port) || !transport.setReusePort(true) ||
+        !transport.connect("0.0.0.0:0", connection)) {
+        lastError_ = transport.getLastError();
+        return false;
+    }
+    transport.setAcceptAnySender(true);
+    if (!transport.setReceiveTimeout(config_.pollInterval)) {
+        lastError_ = transport.getLastError();
+        return false;
+    }
+    return true;
+}
+
+bool UDPShardedReceiver::start(BatchHandler handler) {
+    if (running() || !handler) {
+        lastError_ = running() ? "Receiver is already running" : "No batch handler";
+        return false;
+    }
+
+    const std::vector<int> cpus = allowedCpus();
+    size_t count = config_.shards;
+    if (count == 0) {
+        count = !cpus.empty() ? cpus.size() : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The first shard settles the port, so a requested port of 0 is shared by all
+    uint16_t port = config_.port;
+    for (size_t i = 0; i < count; ++i) {
+        auto shard = std::make_unique<Shard>(config_.ringSlots, config_.slotSize);
+        if (!openShard(*shard, port)) {
+            closeShards();
+            return false;
+        }
+        if (i == 0) {
+            port = shard->transport.getLocalPort();
+        }
+        shards_.push_back(std::move(shard));
+    }
+    port_ = port;
+
+    // Members are numbered in bind order, which is shard order
+    if (config_.steerByPeer && !shards_.front()->transport.attachReusePortSteering(static_cast<uint32_t>(count))) {
+        lastError_ = shards_.front()->transport.getLastError();
+        closeShards();
+        return false;
+    }
+
+    handler_ = std::move(handler);
+    running_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        shards_[i]->thread = std::thread(&UDPShardedReceiver::run, this, i);
+#ifdef __linux__
+        if (config_.pinThreads && !cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[i % cpus.size()], &set);
+            // Best effort: an unpinned shard still receives
+            pthread_setaffinity_np(shards_[i]->thread.native_handle(), sizeof(set), &set);
+        }
+#endif
+    }
+    return true;
+}
+
+void UDPShardedReceiver::stop() {
+    running_.store(false, std::memory_order_release);
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+    closeShards();
+    handler_ = nullptr;
+}
+
+void UDPShardedReceiver::closeShards() {
+    for (auto& shard : shards_) {
+        shard->transport.disconnect();
+    }
+    shards_.clear();
+    port_ = 0;
+}
+
+uint64_t UDPShardedReceiver::datagramsReceived(size_t shard) const {
+    return shard < shards_.size() ? shards_[shard]->datagrams.load(std::memory_order_relaxed) : 0;
+}
+
+void UDPShardedReceiver::run(size_t index) {
+    Shard& shard = *shards_[index];
+    while (running_.load(std::memory_order_acquire)) {
+        // Times out after pollInterval when idle, so stop() is noticed
+        ssize_t received = shard.transport.receiveBatch(shard.ring);
+        if (received < 0 && shard.transport.getLastErrorCode() != TransportError::WOULD_BLOCK) {
+            std::this_thread::sleep_for(config_.pollInterval);  // Keep a failing socket from spinning
+        }
+        if (received <= 0) {
+            continue;
+        }
+        shard.datagrams.fetch_add(shard.ring.size(), std::memory_order_relaxed);
+        handler_(index, shard.transport, shard.ring);
+    }
+}
+
+} // namespace core
+} // namespace xenocomm
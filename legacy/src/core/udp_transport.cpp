@@ -1,10 +1,24 @@
 #include "xenocomm/core/udp_transport.hpp"
+#include "xenocomm/utils/busy_poll.hpp"
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
 #include <random>
 
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#include <climits>
+#endif
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#include <poll.h>
+#include <netinet/udp.h>
+#endif
+
 namespace xenocomm {
 namespace core {
 
@@ -14,6 +28,20 @@ static const SOCKET INVALID_SOCKET_VALUE = INVALID_SOCKET;
 static const int INVALID_SOCKET_VALUE = -1;
 #endif
 
+DatagramRing::DatagramRing(size_t slots, size_t slotSize)
+    : slots_(std::max<size_t>(slots, 1))
+    , slotSize_(std::max<size_t>(slotSize, 1))
+    , storage_(slots_ * slotSize_) {
+    datagrams_.reserve(slots_);
+    origins_.reserve(slots_);
+#if defined(__linux__)
+    headers_.resize(slots_);
+    iov_.resize(slots_);
+    senders_.resize(slots_);
+    control_.resize(slots_ * CMSG_SPACE(sizeof(int)));
+#endif
+}
+
 UDPTransport::UDPTransport() {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -38,6 +66,9 @@ UDPTransport::UDPTransport(UDPTransport&& other) noexcept
     : connected_(other.connected_.load())
     , lastError_(std::move(other.lastError_))
     , localPort_(other.localPort_)
+    , pathMtuDiscovery_(other.pathMtuDiscovery_)
+    , reusePort_(other.reusePort_)
+    , acceptAnySender_(other.acceptAnySender_.load())
     , timeout_(other.timeout_)
     , socket_(other.socket_)
     , remoteAddr_(other.remoteAddr_)
@@ -45,6 +76,7 @@ UDPTransport::UDPTransport(UDPTransport&& other) noexcept
     , wsaInitialized_(other.wsaInitialized_)
 #endif
 {
+    xdp_ = std::move(other.xdp_);
     other.socket_ = 
 #ifdef _WIN32
         INVALID_SOCKET;
@@ -67,9 +99,13 @@ UDPTransport& UDPTransport::operator=(UDPTransport&& other) noexcept {
         connected_ = other.connected_.load();
         lastError_ = std::move(other.lastError_);
         localPort_ = other.localPort_;
+        pathMtuDiscovery_ = other.pathMtuDiscovery_;
+        reusePort_ = other.reusePort_;
+        acceptAnySender_ = other.acceptAnySender_.load();
         timeout_ = other.timeout_;
         socket_ = other.socket_;
         remoteAddr_ = other.remoteAddr_;
+        xdp_ = std::move(other.xdp_);
 #ifdef _WIN32
         wsaInitialized_ = other.wsaInitialized_;
 #endif
@@ -96,7 +132,7 @@ bool UDPTransport::connect(const std::string& endpoint, const ConnectionConfig&
         return false;
     }
 
-    config_ = config;
+    config_.publish(config);
     std::string host;
     uint16_t port;
     
@@ -123,6 +159,10 @@ bool UDPTransport::connect(const std::string& endpoint, const ConnectionConfig&
         closeSocket();
         return false;
     }
+    if (config.lowLatency) {
+        // Best effort: without CAP_NET_ADMIN the system's busy-poll default stays
+        utils::enableBusyPoll(socket_, std::chrono::microseconds(config.busyPollUs));
+    }
 
     // Store endpoint for reconnection
     currentEndpoint_ = endpoint;
@@ -137,9 +177,10 @@ bool UDPTransport::connect(const std::string& endpoint, const ConnectionConfig&
     }
 
     connected_ = true;
+    linkHealth_.reset();
     updateState(ConnectionState::CONNECTED);
 
-    if (config_.healthMonitoring) {
+    if (config.healthMonitoring) {
         startHealthMonitor();
     }
 
@@ -188,13 +229,335 @@ ssize_t UDPTransport::send(const uint8_t* data, size_t size) {
                            sizeof(remoteAddr_));
 
     if (result < 0) {
-        setError(mapSystemError(), "Send operation failed");
+        TransportError error = mapSystemError();
+        if (error == TransportError::WOULD_BLOCK && nonBlocking_) {
+            lastErrorCode_ = error;  // Retry once the reactor reports WRITABLE
+            return -1;
+        }
+        setError(error, "Send operation failed");
+        return -1;
+    }
+
+    linkHealth_.recordSent();
+    return result;
+}
+
+ssize_t UDPTransport::sendv(const utils::ByteSpan* buffers, size_t count) {
+#ifdef _WIN32
+    return TransportProtocol::sendv(buffers, count);
+#else
+    if (!validateState("sendv")) {
+        return -1;
+    }
+
+    if (!buffers || count == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
         return -1;
     }
 
+    static const size_t MAX_DATAGRAM_SIZE = 65507; // Maximum safe UDP payload size
+    std::vector<iovec> iov;
+    iov.reserve(count);
+    size_t totalSize = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (buffers[i].empty()) {
+            continue;
+        }
+        iov.push_back(iovec{const_cast<uint8_t*>(buffers[i].data()), buffers[i].size()});
+        totalSize += buffers[i].size();
+    }
+
+    if (totalSize == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+    if (totalSize > MAX_DATAGRAM_SIZE || iov.size() > IOV_MAX) {
+        setError(TransportError::INVALID_PARAMETER, "Data size exceeds maximum UDP datagram size");
+        return -1;
+    }
+
+    msghdr msg{};
+    msg.msg_name = &remoteAddr_;
+    msg.msg_namelen = sizeof(remoteAddr_);
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = iov.size();
+
+    ssize_t result = ::sendmsg(socket_, &msg, 0);
+    if (result < 0) {
+        TransportError error = mapSystemError();
+        if (error == TransportError::WOULD_BLOCK && nonBlocking_) {
+            lastErrorCode_ = error;  // Retry once the reactor reports WRITABLE
+            return -1;
+        }
+        setError(error, "Send operation failed");
+        return -1;
+    }
+
+    linkHealth_.recordSent();
     return result;
+#endif
 }
 
+ssize_t UDPTransport::sendBatch(const utils::ByteSpan* datagrams, size_t count) {
+#if !defined(__linux__)
+    return TransportProtocol::sendBatch(datagrams, count);
+#else
+    if (!validateState("sendBatch")) {
+        return -1;
+    }
+
+    if (!datagrams || count == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+
+    static const size_t MAX_DATAGRAM_SIZE = 65507; // Maximum safe UDP payload size
+    for (size_t i = 0; i < count; ++i) {
+        if (datagrams[i].empty() || datagrams[i].size() > MAX_DATAGRAM_SIZE) {
+            setError(TransportError::INVALID_PARAMETER, "Datagram size outside valid UDP range");
+            return -1;
+        }
+    }
+
+    // One sendmmsg per round; the arrays live on the stack so a batch allocates nothing
+    constexpr size_t MAX_MESSAGES = 64;
+    constexpr size_t MAX_IOV = 256;
+    constexpr size_t MAX_GSO_SEGMENTS = 64;  // UDP_MAX_SEGMENTS
+    struct mmsghdr messages[MAX_MESSAGES];
+    struct iovec iov[MAX_IOV];
+    size_t datagramsPerMessage[MAX_MESSAGES];
+#ifdef UDP_SEGMENT
+    union {
+        char buffer[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr align;
+    } control[MAX_MESSAGES];
+#endif
+
+    size_t sent = 0;
+    while (sent < count) {
+        bool gso = gso_;
+        size_t built = 0;
+        size_t iovUsed = 0;
+        size_t next = sent;
+        while (built < MAX_MESSAGES && next < count && iovUsed < MAX_IOV) {
+            struct mmsghdr& message = messages[built];
+            std::memset(&message, 0, sizeof(message));
+            message.msg_hdr.msg_name = &remoteAddr_;
+            message.msg_hdr.msg_namelen = sizeof(remoteAddr_);
+            message.msg_hdr.msg_iov = &iov[iovUsed];
+
+            // Under GSO, gather a run of full-size segments; only the last may be shorter
+            size_t segment = datagrams[next].size();
+            size_t group = 0;
+            size_t bytes = 0;
+            while (next < count && iovUsed < MAX_IOV) {
+                size_t size = datagrams[next].size();
+                if (group > 0 && (!gso || group == MAX_GSO_SEGMENTS || size > segment ||
+                                  bytes + size > MAX_DATAGRAM_SIZE)) {
+                    break;
+                }
+                iov[iovUsed++] = iovec{const_cast<uint8_t*>(datagrams[next].data()), size};
+                bytes += size;
+                ++group;
+                ++next;
+                if (size < segment) {
+                    break;
+                }
+            }
+            message.msg_hdr.msg_iovlen = group;
+
+#ifdef UDP_SEGMENT
+            if (group > 1) {
+                message.msg_hdr.msg_control = control[built].buffer;
+                message.msg_hdr.msg_controllen = sizeof(control[built].buffer);
+                struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message.msg_hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t segmentSize = static_cast<uint16_t>(segment);
+                std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+            }
+#endif
+            datagramsPerMessage[built++] = group;
+        }
+
+        int result = ::sendmmsg(socket_, messages, static_cast<unsigned>(built), 0);
+        if (result < 0) {
+            TransportError error = mapSystemError();
+            if (gso && errno == EIO) {
+                // The egress device cannot checksum-offload segments; stop using GSO
+                gso_ = false;
+                continue;
+            }
+            if (sent > 0 || (error == TransportError::WOULD_BLOCK && nonBlocking_)) {
+                lastErrorCode_ = error;  // Report the prefix; the caller retries the rest
+                break;
+            }
+            setError(error, "Batch send failed");
+            return -1;
+        }
+        for (int i = 0; i < result; ++i) {
+            sent += datagramsPerMessage[i];
+        }
+        if (static_cast<size_t>(result) < built) {
+            break;  // Socket buffer full
+        }
+    }
+
+    if (sent == 0) {
+        return -1;
+    }
+    linkHealth_.recordSent();
+    return static_cast<ssize_t>(sent);
+#endif
+}
+
+ssize_t UDPTransport::receiveBatch(DatagramRing& ring) {
+    ring.clear();
+    if (!validateState("receiveBatch")) {
+        return -1;
+    }
+
+#if !defined(__linux__)
+    struct sockaddr_in sender;
+    socklen_t senderLen = sizeof(sender);
+    spinBeforePark();
+    ssize_t result = recvfrom(socket_, reinterpret_cast<char*>(ring.slot(0)), static_cast<int>(ring.slotSize()), 0,
+                              reinterpret_cast<struct sockaddr*>(&sender), &senderLen);
+    if (result < 0) {
+        TransportError error = mapSystemError();
+        if (error == TransportError::WOULD_BLOCK && nonBlocking_) {
+            lastErrorCode_ = error;
+            return -1;
+        }
+        setError(error, "Batch receive failed");
+        return -1;
+    }
+    if (!acceptsSender(sender)) {
+        return 0;
+    }
+    ring.datagrams_.emplace_back(ring.slot(0), static_cast<size_t>(result));
+    ring.origins_.push_back(sender);
+    linkHealth_.recordHeard();
+    return 1;
+#else
+    if (gro_ && ring.slotSize() < 65535) {
+        setError(TransportError::INVALID_PARAMETER, "GRO needs receive slots of at least 64 KB");
+        return -1;
+    }
+    ssize_t received;
+    if (xdp_) {
+        received = receiveXdpBatch(ring);
+    } else {
+        spinBeforePark();
+        // MSG_WAITFORONE blocks for the first datagram only, then takes what is already queued
+        received = receiveSocketBatch(ring, MSG_WAITFORONE);
+    }
+    if (received > 0) {
+        linkHealth_.recordHeard();
+    }
+    return received;
+#endif
+}
+
+#if defined(__linux__)
+ssize_t UDPTransport::receiveSocketBatch(DatagramRing& ring, int flags) {
+    constexpr size_t CONTROL_SPACE = CMSG_SPACE(sizeof(int));
+    for (size_t i = 0; i < ring.slots_; ++i) {
+        ring.iov_[i] = iovec{ring.slot(i), ring.slotSize_};
+        struct msghdr& header = ring.headers_[i].msg_hdr;
+        header.msg_name = &ring.senders_[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &ring.iov_[i];
+        header.msg_iovlen = 1;
+        header.msg_control = ring.control_.data() + i * CONTROL_SPACE;
+        header.msg_controllen = CONTROL_SPACE;
+        header.msg_flags = 0;
+    }
+
+    int received = ::recvmmsg(socket_, ring.headers_.data(), static_cast<unsigned>(ring.slots_), flags, nullptr);
+    if (received < 0) {
+        TransportError error = mapSystemError();
+        if (error == TransportError::WOULD_BLOCK && (flags & MSG_DONTWAIT)) {
+            return 0;
+        }
+        if (error == TransportError::WOULD_BLOCK && nonBlocking_) {
+            lastErrorCode_ = error;
+            return -1;
+        }
+        setError(error, "Batch receive failed");
+        return -1;
+    }
+
+    for (int i = 0; i < received; ++i) {
+        struct msghdr& header = ring.headers_[i].msg_hdr;
+        size_t length = ring.headers_[i].msg_len;
+        if ((header.msg_flags & MSG_TRUNC) || length > ring.slotSize_ ||
+            !acceptsSender(ring.senders_[i])) {
+            continue;
+        }
+
+        size_t segment = length;
+#ifdef UDP_GRO
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                int size = 0;
+                std::memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+                if (size > 0) {
+                    segment = static_cast<size_t>(size);
+                }
+            }
+        }
+#endif
+        const uint8_t* data = ring.slot(i);
+        for (size_t offset = 0; offset < length; offset += segment) {
+            ring.datagrams_.emplace_back(data + offset, std::min(segment, length - offset));
+            ring.origins_.push_back(ring.senders_[i]);
+        }
+    }
+
+    return static_cast<ssize_t>(ring.datagrams_.size());
+}
+
+ssize_t UDPTransport::receiveXdpBatch(DatagramRing& ring) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+    xdpDatagrams_.resize(ring.slots_);
+    while (true) {
+        const size_t taken = xdp_->receive(xdpDatagrams_.data(), xdpDatagrams_.size());
+        for (size_t i = 0; i < taken; ++i) {
+            if (acceptsSender(xdpDatagrams_[i].sender)) {
+                ring.datagrams_.push_back(xdpDatagrams_[i].payload);
+                ring.origins_.push_back(xdpDatagrams_[i].sender);
+            }
+        }
+        // What the program left to the kernel still arrives on the socket
+        if (receiveSocketBatch(ring, MSG_DONTWAIT) < 0) {
+            return -1;
+        }
+        if (!ring.empty()) {
+            return static_cast<ssize_t>(ring.datagrams_.size());
+        }
+
+        if (nonBlocking_) {
+            lastErrorCode_ = TransportError::WOULD_BLOCK;
+            return -1;
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0 && timeout_.count() > 0) {
+            setError(TransportError::WOULD_BLOCK, "Batch receive timed out");
+            return -1;
+        }
+        spinBeforePark();
+        struct pollfd fds[2] = {{xdp_->fd(), POLLIN, 0}, {socket_, POLLIN, 0}};
+        if (::poll(fds, 2, timeout_.count() > 0 ? static_cast<int>(remaining.count()) : -1) < 0 && errno != EINTR) {
+            setError(mapSystemError(), "Batch receive failed");
+            return -1;
+        }
+    }
+}
+#endif
+
 ssize_t UDPTransport::receive(uint8_t* buffer, size_t size) {
     if (!validateState("receive")) {
         return -1;
@@ -208,12 +571,19 @@ ssize_t UDPTransport::receive(uint8_t* buffer, size_t size) {
     struct sockaddr_in sender;
     socklen_t senderLen = sizeof(sender);
 
+    spinBeforePark();
     ssize_t result = recvfrom(socket_, reinterpret_cast<char*>(buffer), size, 0,
                              reinterpret_cast<struct sockaddr*>(&sender),
                              &senderLen);
 
     if (result < 0) {
-        setError(mapSystemError(), "Receive operation failed");
+        TransportError error = mapSystemError();
+        if (error == TransportError::WOULD_BLOCK && nonBlocking_) {
+            // Expected on a reactor-driven socket once the queue is drained
+            lastErrorCode_ = error;
+            return -1;
+        }
+        setError(error, "Receive operation failed");
         return -1;
     }
 
@@ -223,17 +593,100 @@ ssize_t UDPTransport::receive(uint8_t* buffer, size_t size) {
         return -1;
     }
 
-    // Verify sender matches our remote endpoint unless it's a broadcast/multicast packet
-    if (!isBroadcastOrMulticast(sender.sin_addr) &&
-        sender.sin_addr.s_addr != remoteAddr_.sin_addr.s_addr &&
-        sender.sin_port != remoteAddr_.sin_port) {
+    if (!acceptsSender(sender)) {
         setError(TransportError::INVALID_PARAMETER, "Received data from unexpected sender");
         return -1;
     }
 
+    linkHealth_.recordHeard();
+    return result;
+}
+
+ssize_t UDPTransport::receiveFrom(uint8_t* buffer, size_t size, std::string& address, uint16_t& port) {
+    if (!validateState("receive")) {
+        return -1;
+    }
+
+    if (!buffer || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid receive parameters");
+        return -1;
+    }
+
+    struct sockaddr_in sender;
+    socklen_t senderLen = sizeof(sender);
+
+    spinBeforePark();
+    ssize_t result = recvfrom(socket_, reinterpret_cast<char*>(buffer), size, 0,
+                             reinterpret_cast<struct sockaddr*>(&sender),
+                             &senderLen);
+
+    if (result < 0) {
+        TransportError error = mapSystemError();
+        if (error == TransportError::WOULD_BLOCK && nonBlocking_) {
+            lastErrorCode_ = error;
+            return -1;
+        }
+        setError(error, "Receive operation failed");
+        return -1;
+    }
+
+    char ipstr[INET_ADDRSTRLEN];
+    if (inet_ntop(AF_INET, &sender.sin_addr, ipstr, sizeof(ipstr)) == nullptr) {
+        setError(TransportError::SYSTEM_ERROR, "Failed to convert sender IP address");
+        return -1;
+    }
+    address = ipstr;
+    port = ntohs(sender.sin_port);
+    linkHealth_.recordHeard();
+    return result;
+}
+
+ssize_t UDPTransport::sendTo(const uint8_t* data, size_t size, const std::string& address, uint16_t port) {
+    if (!validateState("send")) {
+        return -1;
+    }
+
+    if (!data || size == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Invalid send parameters");
+        return -1;
+    }
+
+    struct sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &target.sin_addr) != 1) {
+        setError(TransportError::INVALID_ADDRESS, "Invalid IP address");
+        return -1;
+    }
+
+    ssize_t result = sendto(socket_, reinterpret_cast<const char*>(data), size, 0,
+                           reinterpret_cast<struct sockaddr*>(&target), sizeof(target));
+    if (result < 0) {
+        setError(mapSystemError(), "Send operation failed");
+        return -1;
+    }
+    linkHealth_.recordSent();
     return result;
 }
 
+bool UDPTransport::setPeerAddress(const std::string& address, uint16_t port) {
+    if (!connected_) {
+        setError(TransportError::NOT_CONNECTED, "Socket not connected");
+        return false;
+    }
+
+    struct sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &target.sin_addr) != 1) {
+        setError(TransportError::INVALID_ADDRESS, "Invalid IP address");
+        return false;
+    }
+    remoteAddr_ = target;
+    currentEndpoint_ = address + ":" + std::to_string(port);
+    return true;
+}
+
 bool UDPTransport::joinMulticastGroup(const std::string& groupAddr) {
     if (!connected_) {
         setError(TransportError::NOT_CONNECTED, "Socket not connected");
@@ -374,6 +827,16 @@ bool UDPTransport::isBroadcastOrMulticast(const in_addr& addr) const {
     return false;
 }
 
+bool UDPTransport::acceptsSender(const sockaddr_in& sender) const {
+    if (acceptAnySender_) {
+        return true;
+    }
+    // Verify sender matches our remote endpoint unless it's a broadcast/multicast packet
+    return isBroadcastOrMulticast(sender.sin_addr) ||
+           sender.sin_addr.s_addr == remoteAddr_.sin_addr.s_addr ||
+           sender.sin_port == remoteAddr_.sin_port;
+}
+
 std::string UDPTransport::getLastError() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return lastError_;
@@ -389,6 +852,89 @@ bool UDPTransport::setLocalPort(uint16_t port) {
     return true;
 }
 
+bool UDPTransport::setReusePort(bool enable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (connected_) {
+        setError(TransportError::ALREADY_CONNECTED, "Cannot change SO_REUSEPORT while connected");
+        return false;
+    }
+#ifndef SO_REUSEPORT
+    if (enable) {
+        setError(TransportError::INVALID_STATE, "SO_REUSEPORT is not supported on this platform");
+        return false;
+    }
+#endif
+    reusePort_ = enable;
+    return true;
+}
+
+uint32_t UDPTransport::reusePortShard(uint32_t address, uint16_t port, uint32_t groupSize) {
+    // Mirrors the steering program: the fields are loaded as big-endian words
+    uint32_t hash = (ntohl(address) ^ ntohs(port)) * 0x9E3779B1u;
+    return groupSize == 0 ? 0 : (hash >> 16) % groupSize;
+}
+
+bool UDPTransport::attachReusePortSteering(uint32_t groupSize) {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE || !connected_ || !reusePort_) {
+        setError(TransportError::INVALID_STATE, "Steering requires a connected transport bound with SO_REUSEPORT");
+        return false;
+    }
+    if (groupSize == 0) {
+        setError(TransportError::INVALID_PARAMETER, "Steering needs at least one group member");
+        return false;
+    }
+
+    // The program runs with the packet positioned at the UDP payload, so the
+    // headers are reached through the network-header offset
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, static_cast<uint32_t>(SKF_NET_OFF)),      // X = IP header length
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, static_cast<uint32_t>(SKF_NET_OFF)),       // A = source port
+        BPF_STMT(BPF_ST, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12)),  // A = source address
+        BPF_STMT(BPF_LDX | BPF_MEM, 0),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9E3779B1u),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, groupSize),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_fprog program = {static_cast<unsigned short>(sizeof(code) / sizeof(code[0])), code};
+    if (setsockopt(socket_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) != 0) {
+        setError(mapSystemError(), "Failed to attach SO_REUSEPORT steering program");
+        return false;
+    }
+    return true;
+#else
+    (void)groupSize;
+    setError(TransportError::INVALID_STATE, "SO_REUSEPORT steering is not supported on this platform");
+    return false;
+#endif
+}
+
+uint16_t UDPTransport::getLocalPort() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE) {
+        return 0;
+    }
+    struct sockaddr_in local;
+    socklen_t length = sizeof(local);
+    std::memset(&local, 0, sizeof(local));
+    if (getsockname(socket_, reinterpret_cast<struct sockaddr*>(&local), &length) != 0) {
+        return 0;
+    }
+    return ntohs(local.sin_port);
+}
+
+void UDPTransport::spinBeforePark() {
+    const auto config = config_.read();
+    if (config->lowLatency && !nonBlocking_) {
+        // The recv that follows parks; data arriving within the spin is read without a wakeup
+        utils::spinUntilReadable(static_cast<int>(socket_), std::chrono::microseconds(config->spinBeforeParkUs));
+    }
+}
+
 bool UDPTransport::parseEndpoint(const std::string& endpoint, std::string& host, uint16_t& port) {
     size_t colonPos = endpoint.find(':');
     if (colonPos == std::string::npos || colonPos == 0 || colonPos == endpoint.length() - 1) {
@@ -408,7 +954,7 @@ bool UDPTransport::parseEndpoint(const std::string& endpoint, std::string& host,
 }
 
 bool UDPTransport::bindSocket() {
-    if (localPort_ == 0) {
+    if (localPort_ == 0 && !reusePort_) {
         return true;  // System will assign port
     }
 
@@ -442,6 +988,13 @@ bool UDPTransport::setSocketOptions(uint32_t socketTimeoutMs) {
         return false;
     }
 
+#ifdef SO_REUSEPORT
+    if (reusePort_ && setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, &flag, sizeof(flag)) != 0) {
+        setError(mapSystemError(), "Failed to set SO_REUSEPORT");
+        return false;
+    }
+#endif
+
     // Enable SO_BROADCAST for broadcast support
 #ifdef _WIN32
     success = (setsockopt(socket_, SOL_SOCKET, SO_BROADCAST, reinterpret_cast<char*>(&flag), sizeof(flag)) == 0);
@@ -497,6 +1050,12 @@ void UDPTransport::setLastError(const std::string& error) {
 }
 
 void UDPTransport::closeSocket() {
+    detachReactor();
+    nonBlocking_ = false;
+    pathMtuDiscovery_ = false;
+    gso_ = false;
+    gro_ = false;
+    xdp_.reset();
 #ifdef _WIN32
     if (socket_ != INVALID_SOCKET) {
         closesocket(socket_);
@@ -584,7 +1143,7 @@ bool UDPTransport::reconnect(uint32_t maxAttempts, uint32_t delayMs) {
     uint32_t maxDelay = 30000; // Maximum delay of 30 seconds
     
     for (uint32_t attempt = 1; attempt <= maxAttempts; ++attempt) {
-        if (connect(currentEndpoint_, config_)) {
+        if (connect(currentEndpoint_, *config_.read())) {
             return true;
         }
 
@@ -617,7 +1176,20 @@ void UDPTransport::setErrorCallback(std::function<void(TransportError, const std
 }
 
 bool UDPTransport::checkHealth() {
-    return performHealthCheck();
+    if (!connected_) {
+        return false;
+    }
+    switch (linkHealth_.assess(healthPolicy())) {
+        case LinkVerdict::HEALTHY:
+            return true;
+        case LinkVerdict::FAILING:
+            return false;
+        case LinkVerdict::IDLE:
+            break;
+    }
+    bool healthy = performHealthCheck();
+    linkHealth_.recordProbe(healthy);
+    return healthy;
 }
 
 TransportError UDPTransport::mapSystemError() const {
@@ -644,6 +1216,8 @@ TransportError UDPTransport::mapSystemError() const {
             return TransportError::MESSAGE_TOO_LARGE;
         case WSAEACCES:
             return TransportError::PERMISSION_DENIED;
+        case WSAEWOULDBLOCK:
+            return TransportError::WOULD_BLOCK;
         default:
             return TransportError::UNKNOWN;
     }
@@ -669,6 +1243,11 @@ TransportError UDPTransport::mapSystemError() const {
             return TransportError::MESSAGE_TOO_LARGE;
         case EACCES:
             return TransportError::PERMISSION_DENIED;
+        case EAGAIN:
+#if EAGAIN != EWOULDBLOCK
+        case EWOULDBLOCK:
+#endif
+            return TransportError::WOULD_BLOCK;
         default:
             return TransportError::UNKNOWN;
     }
@@ -676,6 +1255,7 @@ TransportError UDPTransport::mapSystemError() const {
 }
 
 void UDPTransport::updateState(ConnectionState newState) {
+    const auto config = config_.read();
     ConnectionState oldState = state_.load();
     
     // Validate state transition
@@ -724,7 +1304,7 @@ void UDPTransport::updateState(ConnectionState newState) {
     // Additional actions based on state change
     switch (newState) {
         case ConnectionState::CONNECTED:
-            if (config_.healthMonitoring) {
+            if (config->healthMonitoring) {
                 startHealthMonitor();
             }
             break;
@@ -733,10 +1313,11 @@ void UDPTransport::updateState(ConnectionState newState) {
             break;
         case ConnectionState::ERROR:
             stopHealthMonitor();
-            if (config_.autoReconnect && oldState == ConnectionState::CONNECTED) {
+            if (config->autoReconnect && oldState == ConnectionState::CONNECTED) {
                 // Schedule reconnection attempt
                 std::thread([this]() {
-                    reconnect(config_.maxReconnectAttempts, config_.reconnectDelayMs);
+                    const auto current = config_.read();
+                    reconnect(current->maxReconnectAttempts, current->reconnectDelayMs);
                 }).detach();
             }
             break;
@@ -794,8 +1375,14 @@ bool UDPTransport::performHealthCheck() {
     struct sockaddr_in addr = remoteAddr_;
     socklen_t addrLen = sizeof(addr);
 
-    // Try to peek at incoming data without removing it from the queue
-    int result = recvfrom(socket_, reinterpret_cast<char*>(buffer), 1, MSG_PEEK,
+    // Try to peek at incoming data without removing it from the queue, and without
+    // waiting out the receive timeout on a blocking socket
+#ifdef _WIN32
+    const int peekFlags = MSG_PEEK;
+#else
+    const int peekFlags = MSG_PEEK | MSG_DONTWAIT;
+#endif
+    int result = recvfrom(socket_, reinterpret_cast<char*>(buffer), 1, peekFlags,
                          reinterpret_cast<struct sockaddr*>(&addr), &addrLen);
 
     if (result < 0) {
@@ -820,33 +1407,42 @@ bool UDPTransport::performHealthCheck() {
     return true;
 }
 
+LinkHealthPolicy UDPTransport::healthPolicy() const {
+    const auto config = config_.read();
+    LinkHealthPolicy policy;
+    policy.idleAfter = std::chrono::milliseconds(config->healthCheckIntervalMs);
+    return policy;  // ICMP errors surface on a later call, so one alone does not fail the socket
+}
+
 void UDPTransport::startHealthMonitor() {
-    if (!config_.healthMonitoring || healthMonitorThread_) {
+    const auto config = config_.read();
+    if (!config->healthMonitoring || heartbeat_) {
         return;
     }
 
-    stopHealthMonitor_ = false;
-    healthMonitorThread_ = std::make_unique<std::thread>([this]() {
-        while (!stopHealthMonitor_) {
-            if (!performHealthCheck()) {
-                // If health check fails and auto-reconnect is enabled
-                if (config_.autoReconnect) {
-                    // Try to reconnect with exponential backoff
-                    reconnect(config_.maxReconnectAttempts, config_.reconnectDelayMs);
-                }
+    char host[INET_ADDRSTRLEN] = "";
+    inet_ntop(AF_INET, &remoteAddr_.sin_addr, host, sizeof(host));
+
+    // Scheduler callbacks must not block, so reconnects run on their own thread
+    heartbeat_ = HeartbeatScheduler::shared().add(
+        host, linkHealth_, healthPolicy(),
+        [this]() { return performHealthCheck(); },
+        [this]() {
+            if (config_.read()->autoReconnect && !reconnectPending_.exchange(true)) {
+                // Try to reconnect with exponential backoff
+                std::thread([this]() {
+                    const auto current = config_.read();
+                    reconnect(current->maxReconnectAttempts, current->reconnectDelayMs);
+                    reconnectPending_ = false;
+                }).detach();
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(config_.healthCheckIntervalMs));
-        }
-    });
+        });
 }
 
 void UDPTransport::stopHealthMonitor() {
-    if (healthMonitorThread_) {
-        stopHealthMonitor_ = true;
-        if (healthMonitorThread_->joinable()) {
-            healthMonitorThread_->join();
-        }
-        healthMonitorThread_.reset();
+    if (heartbeat_) {
+        HeartbeatScheduler::shared().remove(heartbeat_);
+        heartbeat_ = 0;
     }
 }
 
@@ -878,7 +1474,9 @@ bool UDPTransport::setNonBlocking(bool nonBlocking) {
     int flags = fcntl(socket_, F_GETFL, 0);
     if (flags == -1) return false;
     flags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
-    return (fcntl(socket_, F_SETFL, flags) == 0);
+    if (fcntl(socket_, F_SETFL, flags) != 0) return false;
+    nonBlocking_ = nonBlocking;
+    return true;
 }
 
 bool UDPTransport::setReuseAddress(bool enable) {
@@ -907,7 +1505,9 @@ bool UDPTransport::setTcpNoDelay(bool enable) {
 bool UDPTransport::setNonBlocking(bool nonBlocking) {
     if (socket_ == INVALID_SOCKET_VALUE) return false;
     u_long mode = nonBlocking ? 1 : 0;
-    return (ioctlsocket(socket_, FIONBIO, &mode) == 0);
+    if (ioctlsocket(socket_, FIONBIO, &mode) != 0) return false;
+    nonBlocking_ = nonBlocking;
+    return true;
 }
 
 bool UDPTransport::setReuseAddress(bool enable) {
@@ -976,7 +1576,164 @@ bool UDPTransport::setSendBufferSize(size_t size) {
 #endif
 }
 
+bool UDPTransport::setPacingRate(uint64_t bytesPerSecond) {
+#if defined(__linux__) && defined(SO_MAX_PACING_RATE)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE) {
+        setError(TransportError::NOT_CONNECTED, "Pacing requires an open socket");
+        return false;
+    }
+    uint64_t rate = bytesPerSecond != 0 ? bytesPerSecond : ~0ULL;
+    if (setsockopt(socket_, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)) != 0) {
+        setError(mapSystemError(), "Failed to set SO_MAX_PACING_RATE");
+        return false;
+    }
+    return true;
+#else
+    (void)bytesPerSecond;
+    setError(TransportError::INVALID_STATE, "Kernel pacing is not supported on this platform");
+    return false;
+#endif
+}
+
+bool UDPTransport::enablePathMtuDiscovery(bool enable) {
+#if defined(__linux__)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE || !connected_) {
+        setError(TransportError::NOT_CONNECTED, "Path MTU discovery requires a connected transport");
+        return false;
+    }
+
+    int mode = enable ? IP_PMTUDISC_DO : IP_PMTUDISC_WANT;
+    if (setsockopt(socket_, IPPROTO_IP, IP_MTU_DISCOVER, &mode, sizeof(mode)) != 0) {
+        setError(mapSystemError(), "Failed to set IP_MTU_DISCOVER");
+        return false;
+    }
+
+    // IP_MTU is only reported for connected datagram sockets
+    if (enable && ::connect(socket_, reinterpret_cast<struct sockaddr*>(&remoteAddr_), sizeof(remoteAddr_)) != 0) {
+        setError(mapSystemError(), "Failed to associate socket with remote endpoint");
+        return false;
+    }
+
+    pathMtuDiscovery_ = enable;
+    return true;
+#else
+    (void)enable;
+    setError(TransportError::INVALID_STATE, "Path MTU discovery is not supported on this platform");
+    return false;
+#endif
+}
+
+uint32_t UDPTransport::getPathMtu() const {
+#if defined(__linux__)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pathMtuDiscovery_ || socket_ == INVALID_SOCKET_VALUE) {
+        return 0;
+    }
+    int mtu = 0;
+    socklen_t length = sizeof(mtu);
+    if (getsockopt(socket_, IPPROTO_IP, IP_MTU, &mtu, &length) != 0 || mtu <= 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>(mtu);
+#else
+    return 0;
+#endif
+}
+
+bool UDPTransport::enableGso(bool enable) {
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE || !connected_) {
+        setError(TransportError::NOT_CONNECTED, "GSO requires a connected transport");
+        return false;
+    }
+
+    // Segment sizes are passed per send; probing the option tells us the kernel knows UDP_SEGMENT
+    int segment = 0;
+    socklen_t length = sizeof(segment);
+    if (enable && getsockopt(socket_, SOL_UDP, UDP_SEGMENT, &segment, &length) != 0) {
+        setError(mapSystemError(), "UDP segmentation offload is not supported");
+        return false;
+    }
+
+    gso_ = enable;
+    return true;
+#else
+    gso_ = false;
+    if (enable) {
+        setError(TransportError::INVALID_STATE, "UDP segmentation offload is not supported on this platform");
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool UDPTransport::enableXdp(const std::string& interfaceName, uint32_t queue) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE || !connected_) {
+        setError(TransportError::NOT_CONNECTED, "AF_XDP requires a connected transport");
+        return false;
+    }
+
+    XdpSocket::Config config;
+    config.interfaceName = interfaceName;
+    config.queue = queue;
+    struct sockaddr_in local;
+    socklen_t length = sizeof(local);
+    std::memset(&local, 0, sizeof(local));
+    if (getsockname(socket_, reinterpret_cast<struct sockaddr*>(&local), &length) == 0) {
+        config.port = ntohs(local.sin_port);
+    }
+    auto xdp = std::make_unique<XdpSocket>(config);
+    if (!xdp->isValid()) {
+        setError(TransportError::INVALID_STATE, xdp->error());
+        return false;
+    }
+    xdp_ = std::move(xdp);
+    return true;
+}
+
+void UDPTransport::disableXdp() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    xdp_.reset();
+}
+
+bool UDPTransport::xdpZeroCopy() const {
+    return xdp_ && xdp_->zeroCopy();
+}
+
+bool UDPTransport::enableGro(bool enable) {
+#if defined(__linux__) && defined(UDP_GRO)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (socket_ == INVALID_SOCKET_VALUE || !connected_) {
+        setError(TransportError::NOT_CONNECTED, "GRO requires a connected transport");
+        return false;
+    }
+
+    int value = enable ? 1 : 0;
+    if (setsockopt(socket_, SOL_UDP, UDP_GRO, &value, sizeof(value)) != 0) {
+        setError(mapSystemError(), "Failed to set UDP_GRO");
+        return false;
+    }
+
+    gro_ = enable;
+    return true;
+#else
+    gro_ = false;
+    if (enable) {
+        setError(TransportError::INVALID_STATE, "UDP receive offload is not supported on this platform");
+        return false;
+    }
+    return true;
+#endif
+}
+
 void UDPTransport::setError(TransportError code, const std::string& message) {
+    if (isLinkError(code)) {
+        linkHealth_.recordError();
+    }
     std::lock_guard<std::mutex> lock(callbackMutex_);
     lastErrorCode_ = code;
     lastError_ = message;
@@ -0,0 +1,429 @@
+#include "xenocomm/core/xdp_socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/if_xdp.h>) && __has_include(<linux/bpf.h>)
+#define XENOCOMM_HAVE_AF_XDP 1
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+#endif
+#endif
+
+namespace xenocomm {
+namespace core {
+
+#ifdef XENOCOMM_HAVE_AF_XDP
+
+namespace {
+
+constexpr uint32_t MAX_QUEUES = 64;     // XSKMAP slots, indexed by receive queue
+constexpr size_t HEADERS_SIZE = 42;     // Ethernet, option-less IPv4 and UDP headers
+constexpr int16_t ETHERTYPE_IPV4 = 0x0800;
+
+std::string systemError(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+int bpf(int command, union bpf_attr& attr) {
+    return static_cast<int>(::syscall(__NR_bpf, command, &attr, sizeof(attr)));
+}
+
+uint64_t pointer(const void* p) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+}
+
+bpf_insn insn(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+    bpf_insn result{};
+    result.code = code;
+    result.dst_reg = dst & 0xf;
+    result.src_reg = src & 0xf;
+    result.off = off;
+    result.imm = imm;
+    return result;
+}
+
+// Redirects option-less, unfragmented IPv4 UDP to port into the socket registered for the
+// receive queue, and passes everything else, or anything no socket is registered for, to the stack
+std::vector<bpf_insn> redirectProgram(int mapFd, uint16_t port) {
+    constexpr int PASS = 23;
+    auto toPass = [](int pc) { return static_cast<int16_t>(PASS - (pc + 1)); };
+    auto be16 = [](uint16_t v) { return static_cast<int32_t>(htons(v)); };  // As a 16-bit load sees it
+    return {
+        insn(BPF_ALU64 | BPF_MOV | BPF_X, 6, 1, 0, 0),             // 0: r6 = ctx
+        insn(BPF_LDX | BPF_MEM | BPF_W, 2, 1, 0, 0),               // 1: r2 = data
+        insn(BPF_LDX | BPF_MEM | BPF_W, 3, 1, 4, 0),               // 2: r3 = data_end
+        insn(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0),             // 3
+        insn(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, HEADERS_SIZE),  // 4
+        insn(BPF_JMP | BPF_JGT | BPF_X, 4, 3, toPass(5), 0),       // 5: too short for the headers
+        insn(BPF_LDX | BPF_MEM | BPF_H, 5, 2, 12, 0),              // 6: ethertype
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, toPass(7), be16(ETHERTYPE_IPV4)),
+        insn(BPF_LDX | BPF_MEM | BPF_B, 5, 2, 14, 0),              // 8: version and header length
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, toPass(9), 0x45),
+        insn(BPF_LDX | BPF_MEM | BPF_B, 5, 2, 23, 0),              // 10: protocol
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, toPass(11), IPPROTO_UDP),
+        insn(BPF_LDX | BPF_MEM | BPF_H, 5, 2, 20, 0),              // 12: fragment offset and MF
+        insn(BPF_ALU64 | BPF_AND | BPF_K, 5, 0, 0, be16(0x3fff)),
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, toPass(14), 0),
+        insn(BPF_LDX | BPF_MEM | BPF_H, 5, 2, 36, 0),              // 15: destination port
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, toPass(16), be16(port)),
+        insn(BPF_LDX | BPF_MEM | BPF_W, 2, 6, 16, 0),              // 17: r2 = rx_queue_index
+        insn(BPF_LD | BPF_DW | BPF_IMM, 1, BPF_PSEUDO_MAP_FD, 0, mapFd),  // 18-19: r1 = map
+        insn(0, 0, 0, 0, 0),
+        insn(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0, XDP_PASS),      // 20: r3 = action if the slot is empty
+        insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),  // 21
+        insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),                      // 22
+        insn(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, XDP_PASS),      // 23: pass
+        insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+    };
+}
+
+} // namespace
+
+/**
+ * @brief One interface's XDP program and socket map, shared by the sockets on its queues
+ *
+ * The program stays attached for as long as a socket holds it; closing the
+ * link descriptor detaches it.
+ */
+struct XdpSocket::Program {
+    int ifindex = 0;
+    uint16_t port = 0;
+    int mapFd = -1;
+    int progFd = -1;
+    int linkFd = -1;
+
+    ~Program() {
+        for (int fd : {linkFd, progFd, mapFd}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    static std::shared_ptr<Program> acquire(int ifindex, uint16_t port, std::string& error) {
+        static std::mutex mutex;
+        static std::map<int, std::weak_ptr<Program>> programs;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto existing = programs[ifindex].lock()) {
+            if (existing->port != port) {
+                error = "The interface's XDP program redirects another port";
+                return nullptr;
+            }
+            return existing;
+        }
+        auto program = std::make_shared<Program>();
+        program->ifindex = ifindex;
+        program->port = port;
+        if (!program->load(error)) {
+            return nullptr;
+        }
+        programs[ifindex] = program;
+        return program;
+    }
+
+    bool load(std::string& error) {
+        union bpf_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.map_type = BPF_MAP_TYPE_XSKMAP;
+        attr.key_size = sizeof(uint32_t);
+        attr.value_size = sizeof(uint32_t);
+        attr.max_entries = MAX_QUEUES;
+        mapFd = bpf(BPF_MAP_CREATE, attr);
+        if (mapFd < 0) {
+            error = systemError("Failed to create the XDP socket map");
+            return false;
+        }
+
+        const std::vector<bpf_insn> code = redirectProgram(mapFd, port);
+        static const char license[] = "Dual MIT/GPL";
+        std::memset(&attr, 0, sizeof(attr));
+        attr.prog_type = BPF_PROG_TYPE_XDP;
+        attr.insns = pointer(code.data());
+        attr.insn_cnt = static_cast<uint32_t>(code.size());
+        attr.license = pointer(license);
+        progFd = bpf(BPF_PROG_LOAD, attr);
+        if (progFd < 0) {
+            error = systemError("Failed to load the XDP program");
+            return false;
+        }
+
+        // Native mode if the driver has it, else the generic hook after skb allocation
+        for (uint32_t mode : {XDP_FLAGS_DRV_MODE, XDP_FLAGS_SKB_MODE}) {
+            std::memset(&attr, 0, sizeof(attr));
+            attr.link_create.prog_fd = static_cast<uint32_t>(progFd);
+            attr.link_create.target_ifindex = static_cast<uint32_t>(ifindex);
+            attr.link_create.attach_type = BPF_XDP;
+            attr.link_create.flags = mode;
+            linkFd = bpf(BPF_LINK_CREATE, attr);
+            if (linkFd >= 0) {
+                return true;
+            }
+        }
+        error = systemError("Failed to attach the XDP program");
+        return false;
+    }
+
+    bool registerSocket(uint32_t queue, int fd, std::string& error) {
+        union bpf_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        uint32_t value = static_cast<uint32_t>(fd);
+        attr.map_fd = static_cast<uint32_t>(mapFd);
+        attr.key = pointer(&queue);
+        attr.value = pointer(&value);
+        attr.flags = BPF_ANY;
+        if (bpf(BPF_MAP_UPDATE_ELEM, attr) != 0) {
+            error = systemError("Failed to register the socket with the XDP program");
+            return false;
+        }
+        return true;
+    }
+
+    void unregisterSocket(uint32_t queue) {
+        union bpf_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.map_fd = static_cast<uint32_t>(mapFd);
+        attr.key = pointer(&queue);
+        bpf(BPF_MAP_DELETE_ELEM, attr);
+    }
+};
+
+/**
+ * @brief A single-producer, single-consumer ring shared with the kernel
+ */
+struct XdpSocket::Ring {
+    uint32_t* producer = nullptr;
+    uint32_t* consumer = nullptr;
+    uint32_t* flags = nullptr;
+    void* descriptors = nullptr;
+    uint32_t mask = 0;
+    void* mapping = MAP_FAILED;
+    size_t length = 0;
+
+    ~Ring() {
+        if (mapping != MAP_FAILED) {
+            ::munmap(mapping, length);
+        }
+    }
+
+    bool map(int fd, const xdp_ring_offset& offsets, uint32_t size, size_t entrySize, off_t pgoff) {
+        length = offsets.desc + size * entrySize;
+        mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, pgoff);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        auto* base = static_cast<uint8_t*>(mapping);
+        producer = reinterpret_cast<uint32_t*>(base + offsets.producer);
+        consumer = reinterpret_cast<uint32_t*>(base + offsets.consumer);
+        flags = reinterpret_cast<uint32_t*>(base + offsets.flags);
+        descriptors = base + offsets.desc;
+        mask = size - 1;
+        return true;
+    }
+
+    uint64_t* addresses() { return static_cast<uint64_t*>(descriptors); }
+    xdp_desc* packets() { return static_cast<xdp_desc*>(descriptors); }
+};
+
+XdpSocket::XdpSocket(const Config& config) : config_(config) {
+    if (!open()) {
+        close();
+    }
+}
+
+XdpSocket::~XdpSocket() {
+    close();
+}
+
+bool XdpSocket::open() {
+    const uint32_t frames = config_.frameCount;
+    if (frames == 0 || (frames & (frames - 1)) != 0 ||
+        (config_.frameSize != 2048 && config_.frameSize != 4096)) {
+        error_ = "UMEM needs a power-of-two frame count and 2048 or 4096 byte frames";
+        return false;
+    }
+    if (config_.queue >= MAX_QUEUES || config_.port == 0) {
+        error_ = "XDP needs a bound port and a queue below 64";
+        return false;
+    }
+    const int ifindex = static_cast<int>(::if_nametoindex(config_.interfaceName.c_str()));
+    if (ifindex == 0) {
+        error_ = systemError("Unknown interface " + config_.interfaceName);
+        return false;
+    }
+
+    int fd = ::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = systemError("Failed to create an AF_XDP socket");
+        return false;
+    }
+    fd_ = fd;
+
+    umemSize_ = static_cast<size_t>(frames) * config_.frameSize;
+    void* area = ::mmap(nullptr, umemSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (area == MAP_FAILED) {
+        error_ = systemError("Failed to allocate UMEM");
+        return false;
+    }
+    umem_ = static_cast<uint8_t*>(area);
+
+    xdp_umem_reg registration{};
+    registration.addr = pointer(umem_);
+    registration.len = umemSize_;
+    registration.chunk_size = config_.frameSize;
+    // Every frame sits in the fill ring or is held by us, so the rings never overflow.
+    // The completion ring only serves transmit, but binding requires one
+    uint32_t completionSize = 64;
+    if (::setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &registration, sizeof(registration)) != 0 ||
+        ::setsockopt(fd, SOL_XDP, XDP_UMEM_FILL_RING, &frames, sizeof(frames)) != 0 ||
+        ::setsockopt(fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &completionSize, sizeof(completionSize)) != 0 ||
+        ::setsockopt(fd, SOL_XDP, XDP_RX_RING, &frames, sizeof(frames)) != 0) {
+        error_ = systemError("Failed to set up the UMEM rings");
+        return false;
+    }
+
+    xdp_mmap_offsets offsets{};
+    socklen_t offsetsLength = sizeof(offsets);
+    if (::getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsetsLength) != 0) {
+        error_ = systemError("Failed to read the ring offsets");
+        return false;
+    }
+    fill_ = std::make_unique<Ring>();
+    rx_ = std::make_unique<Ring>();
+    if (!fill_->map(fd, offsets.fr, frames, sizeof(uint64_t), static_cast<off_t>(XDP_UMEM_PGOFF_FILL_RING)) ||
+        !rx_->map(fd, offsets.rx, frames, sizeof(xdp_desc), XDP_PGOFF_RX_RING)) {
+        error_ = systemError("Failed to map the rings");
+        return false;
+    }
+
+    // The driver may not zero-copy; copy mode still bypasses the stack
+    sockaddr_xdp address{};
+    address.sxdp_family = AF_XDP;
+    address.sxdp_ifindex = static_cast<uint32_t>(ifindex);
+    address.sxdp_queue_id = config_.queue;
+    bool bound = false;
+    if (config_.zeroCopy) {
+        address.sxdp_flags = XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP;
+        bound = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        zeroCopy_ = bound;
+    }
+    if (!bound) {
+        address.sxdp_flags = XDP_COPY | XDP_USE_NEED_WAKEUP;
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            error_ = systemError("Failed to bind the AF_XDP socket");
+            return false;
+        }
+    }
+
+    // Hand every frame to the kernel before traffic is redirected here
+    for (uint32_t i = 0; i < frames; ++i) {
+        fill_->addresses()[i] = static_cast<uint64_t>(i) * config_.frameSize;
+    }
+    __atomic_store_n(fill_->producer, frames, __ATOMIC_RELEASE);
+    held_.reserve(frames);
+
+    program_ = Program::acquire(ifindex, config_.port, error_);
+    if (!program_ || !program_->registerSocket(config_.queue, fd, error_)) {
+        program_.reset();
+        return false;
+    }
+    return true;
+}
+
+void XdpSocket::close() {
+    if (program_) {
+        program_->unregisterSocket(config_.queue);
+        program_.reset();
+    }
+    fill_.reset();
+    rx_.reset();
+    if (umem_) {
+        ::munmap(umem_, umemSize_);
+        umem_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    held_.clear();
+}
+
+size_t XdpSocket::receive(Datagram* out, size_t max) {
+    if (fd_ < 0) {
+        return 0;
+    }
+
+    // Frames behind the previous views go back to the kernel; there is always room for them
+    uint32_t fillProducer = *fill_->producer;
+    for (uint64_t frame : held_) {
+        fill_->addresses()[fillProducer++ & fill_->mask] = frame;
+    }
+    __atomic_store_n(fill_->producer, fillProducer, __ATOMIC_RELEASE);
+    held_.clear();
+    if (__atomic_load_n(fill_->flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP) {
+        ::recvfrom(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+    }
+
+    uint32_t consumer = *rx_->consumer;
+    const uint32_t available = __atomic_load_n(rx_->producer, __ATOMIC_ACQUIRE) - consumer;
+    size_t count = 0;
+    const uint64_t frameMask = ~static_cast<uint64_t>(config_.frameSize - 1);
+    for (uint32_t i = 0; i < available && count < max; ++i) {
+        const xdp_desc& descriptor = rx_->packets()[consumer++ & rx_->mask];
+        held_.push_back(descriptor.addr & frameMask);
+        const uint8_t* frame = umem_ + descriptor.addr;
+        if (descriptor.len < HEADERS_SIZE || frame[14] != 0x45 || frame[23] != IPPROTO_UDP) {
+            continue;  // The program lets nothing else through, but the frame is the wire's
+        }
+        const size_t udpLength = (static_cast<size_t>(frame[38]) << 8) | frame[39];
+        if (udpLength < 8 || 34 + udpLength > descriptor.len) {
+            continue;
+        }
+        Datagram& datagram = out[count++];
+        std::memset(&datagram.sender, 0, sizeof(datagram.sender));
+        datagram.sender.sin_family = AF_INET;
+        std::memcpy(&datagram.sender.sin_addr.s_addr, frame + 26, 4);
+        std::memcpy(&datagram.sender.sin_port, frame + 34, 2);
+        datagram.payload = utils::ByteSpan(frame + HEADERS_SIZE, udpLength - 8);
+    }
+    __atomic_store_n(rx_->consumer, consumer, __ATOMIC_RELEASE);
+    return count;
+}
+
+#else
+
+struct XdpSocket::Ring {};
+struct XdpSocket::Program {};
+
+XdpSocket::XdpSocket(const Config& config) : config_(config) {
+    error_ = "AF_XDP is not available on this platform";
+}
+
+XdpSocket::~XdpSocket() = default;
+
+bool XdpSocket::open() { return false; }
+void XdpSocket::close() {}
+
+size_t XdpSocket::receive(Datagram*, size_t) {
+    return 0;
+}
+
+#endif
+
+} // namespace core
+} // namespace xenocomm
@@ -1,10 +1,207 @@
-// #include "xenocomm/extensions/boundary_gateway.h"
+#include "xenocomm/extensions/boundary_gateway.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace xenocomm {
 namespace extensions {
 
-// Placeholder implementation
-// TODO: Implement actual boundary gateway functionality
+namespace {
+    // Bucket time a token is worth when the bucket never refills; any unit serves, as the clock stands still
+    constexpr double FIXED_BUDGET_INTERVAL_NS = 1e9;
+
+    double intervalFor(const RateLimit& limit) {
+        return limit.refillPerSecond > 0 ? 1e9 / limit.refillPerSecond : FIXED_BUDGET_INTERVAL_NS;
+    }
+
+    int64_t toBucketTime(double ns) {
+        return static_cast<int64_t>(std::llround(ns));
+    }
+}
+
+TokenBucket::TokenBucket(const RateLimit& limit)
+    : intervalNs_(intervalFor(limit)),
+      toleranceNs_(std::max(0.0, limit.capacity) * intervalFor(limit)),
+      refills_(limit.refillPerSecond > 0) {}
+
+int64_t TokenBucket::now() const {
+    // A bucket that never refills lives at time zero, so taking tokens is all that moves it
+    if (!refills_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TokenBucket::tryAcquire(double tokens) {
+    const int64_t current = now();
+    const int64_t cost = toBucketTime(tokens * intervalNs_.load(std::memory_order_relaxed));
+    const int64_t tolerance = toBucketTime(toleranceNs_.load(std::memory_order_relaxed));
+    int64_t fullAt = fullAtNs_.load(std::memory_order_relaxed);
+    for (;;) {
+        const int64_t next = std::max(fullAt, current) + cost;
+        if (next - current > tolerance) {
+            denied_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (fullAtNs_.compare_exchange_weak(fullAt, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            acquired_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+void TokenBucket::refund(double tokens) {
+    const int64_t current = now();
+    const int64_t cost = toBucketTime(tokens * intervalNs_.load(std::memory_order_relaxed));
+    int64_t fullAt = fullAtNs_.load(std::memory_order_relaxed);
+    for (;;) {
+        if (fullAt <= current) {
+            return;  // Already full
+        }
+        const int64_t next = std::max(fullAt - cost, current);
+        if (fullAtNs_.compare_exchange_weak(fullAt, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+double TokenBucket::available() const {
+    const int64_t current = now();
+    const double interval = intervalNs_.load(std::memory_order_relaxed);
+    const double tolerance = toleranceNs_.load(std::memory_order_relaxed);
+    const int64_t owed = std::max<int64_t>(0, fullAtNs_.load(std::memory_order_relaxed) - current);
+    return std::max(0.0, (tolerance - static_cast<double>(owed)) / interval);
+}
+
+void TokenBucket::setLimit(const RateLimit& limit) {
+    const double interval = intervalFor(limit);
+    const bool refills = limit.refillPerSecond > 0;
+
+    // Carry the tokens owed across the change of units, and of clock if refilling starts or stops
+    const int64_t owed = std::max<int64_t>(0, fullAtNs_.load(std::memory_order_relaxed) - now());
+    const double owedTokens = static_cast<double>(owed) / intervalNs_.load(std::memory_order_relaxed);
+
+    intervalNs_.store(interval, std::memory_order_relaxed);
+    toleranceNs_.store(std::max(0.0, limit.capacity) * interval, std::memory_order_relaxed);
+    refills_.store(refills, std::memory_order_relaxed);
+    fullAtNs_.store(now() + toBucketTime(owedTokens * interval), std::memory_order_release);
+}
+
+RateLimit TokenBucket::limit() const {
+    RateLimit limit;
+    const double interval = intervalNs_.load(std::memory_order_relaxed);
+    limit.capacity = toleranceNs_.load(std::memory_order_relaxed) / interval;
+    limit.refillPerSecond = refills_.load(std::memory_order_relaxed) ? 1e9 / interval : 0;
+    return limit;
+}
+
+TokenBucket* GatewayRateLimiter::Level::find(const std::string& key) {
+    Shard& shard = shards[std::hash<std::string>{}(key) % SHARD_COUNT];
+    {
+        std::shared_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+        auto found = shard.buckets.find(key);
+        if (found != shard.buckets.end()) {
+            return found->second.get();
+        }
+    }
+    if (!defaultLimit) {
+        return nullptr;
+    }
+    std::unique_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+    auto& bucket = shard.buckets[key];
+    if (!bucket) {
+        bucket = std::make_unique<TokenBucket>(*defaultLimit);
+    }
+    return bucket.get();
+}
+
+void GatewayRateLimiter::Level::set(const std::string& key, const RateLimit& limit) {
+    Shard& shard = shards[std::hash<std::string>{}(key) % SHARD_COUNT];
+    std::unique_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+    auto& bucket = shard.buckets[key];
+    if (bucket) {
+        bucket->setLimit(limit);
+    } else {
+        bucket = std::make_unique<TokenBucket>(limit);
+    }
+}
+
+size_t GatewayRateLimiter::Level::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<utils::ProfiledMutex<std::shared_mutex>> lock(shard.mutex);
+        total += shard.buckets.size();
+    }
+    return total;
+}
+
+GatewayRateLimiter::GatewayRateLimiter(const GatewayRateLimitConfig& config) {
+    agents_.defaultLimit = config.perAgent;
+    apis_.defaultLimit = config.perApi;
+    if (config.global) {
+        global_ = std::make_unique<TokenBucket>(*config.global);
+    }
+}
+
+GatewayRateLimiter::Decision GatewayRateLimiter::acquire(const std::string& agent, const std::string& api,
+                                                         double tokens) {
+    // Narrowest level first: a single noisy agent is turned away before it can drain the shared buckets
+    TokenBucket* agentBucket = agent.empty() ? nullptr : agents_.find(agent);
+    if (agentBucket && !agentBucket->tryAcquire(tokens)) {
+        deniedByAgent_.fetch_add(1, std::memory_order_relaxed);
+        return {false, RateLimitScope::AGENT};
+    }
+    TokenBucket* apiBucket = api.empty() ? nullptr : apis_.find(api);
+    if (apiBucket && !apiBucket->tryAcquire(tokens)) {
+        if (agentBucket) {
+            agentBucket->refund(tokens);
+        }
+        deniedByApi_.fetch_add(1, std::memory_order_relaxed);
+        return {false, RateLimitScope::API};
+    }
+    if (global_ && !global_->tryAcquire(tokens)) {
+        if (apiBucket) {
+            apiBucket->refund(tokens);
+        }
+        if (agentBucket) {
+            agentBucket->refund(tokens);
+        }
+        deniedGlobally_.fetch_add(1, std::memory_order_relaxed);
+        return {false, RateLimitScope::GLOBAL};
+    }
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+    return {};
+}
+
+void GatewayRateLimiter::setAgentLimit(const std::string& agent, const RateLimit& limit) {
+    agents_.set(agent, limit);
+}
+
+void GatewayRateLimiter::setApiLimit(const std::string& api, const RateLimit& limit) {
+    apis_.set(api, limit);
+}
+
+std::optional<double> GatewayRateLimiter::agentAvailable(const std::string& agent) {
+    TokenBucket* bucket = agents_.find(agent);
+    return bucket ? std::optional<double>(bucket->available()) : std::nullopt;
+}
+
+std::optional<double> GatewayRateLimiter::apiAvailable(const std::string& api) {
+    TokenBucket* bucket = apis_.find(api);
+    return bucket ? std::optional<double>(bucket->available()) : std::nullopt;
+}
+
+GatewayRateLimiter::Stats GatewayRateLimiter::getStats() const {
+    Stats stats;
+    stats.admitted = admitted_.load(std::memory_order_relaxed);
+    stats.deniedByAgent = deniedByAgent_.load(std::memory_order_relaxed);
+    stats.deniedByApi = deniedByApi_.load(std::memory_order_relaxed);
+    stats.deniedGlobally = deniedGlobally_.load(std::memory_order_relaxed);
+    stats.agents = agents_.size();
+    stats.apis = apis_.size();
+    return stats;
+}
 
 } // namespace extensions
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
@@ -1,53 +1,324 @@
 #include "../../../../include/xenocomm/extensions/common_ground/extensibility/plugin_loader.hpp"
+#include <dlfcn.h>
+#include <atomic>
+#include <filesystem>
 #include <iostream>
+#include <stdexcept>
+#include <unordered_set>
 
 namespace xenocomm {
 namespace common_ground {
 
-PluginLoader::PluginLoader(const std::string& pluginDir) : pluginDir_(pluginDir) {
-    std::cout << "PluginLoader created for dir: " << pluginDir << std::endl;
+struct PluginLoader::LoadedPlugin {
+    void* library = nullptr;
+    std::string copyPath;  // Private copy a reload opened, removed with it
+    PluginMetadata metadata;
+    // Indexed by the slot's dispatch index; null where this version lacks the strategy
+    std::vector<const PluginStrategyEntry*> table;
+
+    ~LoadedPlugin() {
+        if (library) dlclose(library);
+        if (!copyPath.empty()) {
+            std::error_code ignored;
+            std::filesystem::remove(copyPath, ignored);
+        }
+    }
+};
+
+struct PluginLoader::PluginSlot {
+    std::string id;
+    std::string path;
+    std::shared_ptr<const LoadedPlugin> current;  // Read and replaced with std::atomic_load/store
+
+    std::mutex mutex;  // Guards loading and everything below
+    std::unordered_map<std::string, size_t> dispatchIndex;  // Strategy ID to table index; only grows
+    bool unloaded = false;      // Set by unloadPlugin(); stops lazy loading bringing it back
+    uint64_t generation = 0;    // Versions opened, naming reload copies
+};
+
+namespace {
+
+const std::unordered_set<std::string> LIBRARY_EXTENSIONS{".so", ".dylib", ".dll"};
+
+std::string pluginIdFor(const std::filesystem::path& path) {
+    std::string stem = path.stem().string();
+    return stem.compare(0, 3, "lib") == 0 && stem.size() > 3 ? stem.substr(3) : stem;
 }
 
+// Calls straight through the dispatch table of whichever version is current
+class PluginStrategy : public IAlignmentStrategy {
+public:
+    using Slot = PluginLoader::PluginSlot;
+
+    PluginStrategy(std::shared_ptr<Slot> slot, std::string id, size_t index)
+        : slot_(std::move(slot)), id_(std::move(id)), index_(index) {}
+
+    std::string getId() const override { return id_; }
+
+    AlignmentResult verify(const AlignmentContext& context) override {
+        // Holding the version keeps its library open until this call returns
+        auto plugin = std::atomic_load(&slot_->current);
+        const PluginStrategyEntry* entry = find(plugin);
+        if (!entry) {
+            throw std::runtime_error("Plugin strategy " + id_ + " is no longer loaded");
+        }
+        return entry->verify(entry->state, context);
+    }
+
+    bool isApplicable(const AlignmentContext& context) const override {
+        auto plugin = std::atomic_load(&slot_->current);
+        const PluginStrategyEntry* entry = find(plugin);
+        return entry && entry->isApplicable(entry->state, context);
+    }
+
+private:
+    const PluginStrategyEntry* find(const std::shared_ptr<const PluginLoader::LoadedPlugin>& plugin) const {
+        return plugin && index_ < plugin->table.size() ? plugin->table[index_] : nullptr;
+    }
+
+    std::shared_ptr<Slot> slot_;
+    std::string id_;
+    size_t index_;
+};
+
+} // namespace
+
+PluginLoader::PluginLoader(const std::string& pluginDir)
+    : pluginDir_(pluginDir), plugins_(std::make_shared<const PluginMap>()) {
+    std::error_code error;
+    if (pluginDir_.empty() || !std::filesystem::is_directory(pluginDir_, error)) {
+        return;
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(pluginDir_, error)) {
+        if (!entry.is_regular_file(error) || LIBRARY_EXTENSIONS.count(entry.path().extension().string()) == 0) {
+            continue;
+        }
+        auto slot = std::make_shared<PluginSlot>();
+        slot->id = pluginIdFor(entry.path());
+        slot->path = entry.path().string();
+        addSlot(std::move(slot));
+    }
+}
+
+PluginLoader::~PluginLoader() = default;
+
 void PluginLoader::loadPlugin(const std::string& pluginPath) {
-    std::cout << "Simulating loading plugin: " << pluginPath << std::endl;
-    // Simulate plugin handle
-    loadedPlugins_[pluginPath] = PluginHandle{};
+    std::filesystem::path path(pluginPath);
+    std::error_code error;
+    if (path.is_relative() && !std::filesystem::exists(path, error) && !pluginDir_.empty()) {
+        path = std::filesystem::path(pluginDir_) / path;
+    }
+    std::string id = pluginIdFor(path);
+    auto slot = findSlot(id);
+    if (!slot || slot->path != path.string()) {
+        slot = std::make_shared<PluginSlot>();
+        slot->id = id;
+        slot->path = path.string();
+    }
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->unloaded = false;
+        if (!std::atomic_load(&slot->current)) {
+            std::atomic_store(&slot->current, std::shared_ptr<const LoadedPlugin>(openPlugin(*slot, slot->path)));
+        }
+    }
+    addSlot(std::move(slot));
 }
 
 void PluginLoader::unloadPlugin(const std::string& pluginId) {
-    std::cout << "Simulating unloading plugin: " << pluginId << std::endl;
-    loadedPlugins_.erase(pluginId);
+    std::shared_ptr<PluginSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        auto current = std::atomic_load(&plugins_);
+        auto it = current->find(pluginId);
+        if (it == current->end()) {
+            return;
+        }
+        slot = it->second;
+        auto next = std::make_shared<PluginMap>(*current);
+        next->erase(pluginId);
+        std::atomic_store(&plugins_, std::shared_ptr<const PluginMap>(std::move(next)));
+    }
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    slot->unloaded = true;
+    std::atomic_store(&slot->current, std::shared_ptr<const LoadedPlugin>());
+}
+
+void PluginLoader::reloadPlugin(const std::string& pluginId) {
+    auto slot = findSlot(pluginId);
+    if (!slot) {
+        throw std::runtime_error("Unknown plugin: " + pluginId);
+    }
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    // The loader caches libraries by path, so the new version is opened from a private copy
+    std::filesystem::path copy = std::filesystem::temp_directory_path() /
+        ("xenocomm_plugin_" + slot->id + "_" + std::to_string(reinterpret_cast<uintptr_t>(slot.get())) + "_" +
+         std::to_string(slot->generation + 1) + std::filesystem::path(slot->path).extension().string());
+    std::filesystem::copy_file(slot->path, copy, std::filesystem::copy_options::overwrite_existing);
+    std::shared_ptr<LoadedPlugin> plugin;
+    try {
+        plugin = openPlugin(*slot, copy.string());
+    } catch (...) {
+        std::error_code ignored;
+        std::filesystem::remove(copy, ignored);
+        throw;
+    }
+    plugin->copyPath = copy.string();
+    std::atomic_store(&slot->current, std::shared_ptr<const LoadedPlugin>(std::move(plugin)));
 }
 
 bool PluginLoader::isPluginLoaded(const std::string& pluginId) const {
-    return loadedPlugins_.count(pluginId) > 0;
+    auto slot = findSlot(pluginId);
+    return slot && std::atomic_load(&slot->current) != nullptr;
 }
 
 std::vector<std::shared_ptr<IAlignmentStrategy>> PluginLoader::getPluginStrategies() const {
-    std::cout << "Returning dummy plugin strategies (empty)" << std::endl;
-    return {};
+    std::vector<std::shared_ptr<IAlignmentStrategy>> strategies;
+    auto plugins = std::atomic_load(&plugins_);
+    for (const auto& [id, slot] : *plugins) {
+        std::shared_ptr<const LoadedPlugin> plugin;
+        try {
+            plugin = ensureLoaded(*slot);
+        } catch (const std::exception& e) {
+            std::cerr << "[PluginLoader] Skipping plugin '" << id << "': " << e.what() << std::endl;
+            continue;
+        }
+        if (!plugin) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        for (const auto& strategyId : plugin->metadata.strategyIds) {
+            strategies.push_back(std::make_shared<PluginStrategy>(slot, strategyId, slot->dispatchIndex.at(strategyId)));
+        }
+    }
+    return strategies;
 }
 
 std::shared_ptr<IAlignmentStrategy> PluginLoader::getStrategyFromPlugin(const std::string& pluginId, const std::string& strategyId) const {
-    std::cout << "Returning dummy strategy for plugin: " << pluginId << ", strategy: " << strategyId << std::endl;
-    return nullptr;
+    auto slot = findSlot(pluginId);
+    if (!slot || !ensureLoaded(*slot)) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    auto index = slot->dispatchIndex.find(strategyId);
+    if (index == slot->dispatchIndex.end()) {
+        return nullptr;
+    }
+    return std::make_shared<PluginStrategy>(slot, strategyId, index->second);
 }
 
 PluginMetadata PluginLoader::getPluginMetadata(const std::string& pluginId) const {
-    std::cout << "Returning dummy metadata for plugin: " << pluginId << std::endl;
-    return PluginMetadata{};
+    auto slot = findSlot(pluginId);
+    if (!slot) {
+        throw std::runtime_error("Unknown plugin: " + pluginId);
+    }
+    if (auto plugin = std::atomic_load(&slot->current)) {
+        return plugin->metadata;
+    }
+    PluginMetadata metadata;
+    metadata.id = slot->id;
+    metadata.path = slot->path;
+    return metadata;
 }
 
 std::vector<PluginMetadata> PluginLoader::getLoadedPlugins() const {
-    std::cout << "Returning dummy loaded plugin metadata (empty)" << std::endl;
-    return {};
+    std::vector<PluginMetadata> loaded;
+    auto plugins = std::atomic_load(&plugins_);
+    for (const auto& [id, slot] : *plugins) {
+        if (auto plugin = std::atomic_load(&slot->current)) {
+            loaded.push_back(plugin->metadata);
+        }
+    }
+    return loaded;
+}
+
+std::shared_ptr<PluginLoader::PluginSlot> PluginLoader::findSlot(const std::string& pluginId) const {
+    auto plugins = std::atomic_load(&plugins_);
+    auto it = plugins->find(pluginId);
+    return it == plugins->end() ? nullptr : it->second;
 }
 
-void PluginLoader::validatePlugin(const PluginHandle&) const {
-    std::cout << "Validating plugin (stub)" << std::endl;
+void PluginLoader::addSlot(std::shared_ptr<PluginSlot> slot) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto current = std::atomic_load(&plugins_);
+    auto it = current->find(slot->id);
+    if (it != current->end() && it->second == slot) {
+        return;
+    }
+    auto next = std::make_shared<PluginMap>(*current);
+    (*next)[slot->id] = std::move(slot);
+    std::atomic_store(&plugins_, std::shared_ptr<const PluginMap>(std::move(next)));
 }
-void PluginLoader::registerPluginStrategies(const PluginHandle&) {
-    std::cout << "Registering plugin strategies (stub)" << std::endl;
+
+std::shared_ptr<const PluginLoader::LoadedPlugin> PluginLoader::ensureLoaded(PluginSlot& slot) const {
+    if (auto plugin = std::atomic_load(&slot.current)) {
+        return plugin;
+    }
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    auto plugin = std::atomic_load(&slot.current);
+    if (!plugin && !slot.unloaded) {
+        plugin = openPlugin(slot, slot.path);
+        std::atomic_store(&slot.current, plugin);
+    }
+    return plugin;
+}
+
+// Requires slot.mutex
+std::shared_ptr<PluginLoader::LoadedPlugin> PluginLoader::openPlugin(PluginSlot& slot, const std::string& path) const {
+    auto plugin = std::make_shared<LoadedPlugin>();
+    plugin->library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!plugin->library) {
+        const char* error = dlerror();
+        throw std::runtime_error("Cannot open plugin " + path + ": " + (error ? error : "unknown error"));
+    }
+    auto entry = reinterpret_cast<XenocommPluginEntry>(dlsym(plugin->library, XENOCOMM_PLUGIN_ENTRY_SYMBOL));
+    if (!entry) {
+        throw std::runtime_error("Plugin " + path + " does not export " + XENOCOMM_PLUGIN_ENTRY_SYMBOL);
+    }
+    const PluginDescriptor* descriptor = entry();
+    validatePlugin(descriptor, path);
+
+    plugin->metadata.id = slot.id;
+    plugin->metadata.path = slot.path;
+    plugin->metadata.name = descriptor->name ? descriptor->name : slot.id;
+    plugin->metadata.version = descriptor->version ? descriptor->version : "";
+    plugin->metadata.loaded = true;
+    for (size_t i = 0; i < descriptor->strategyCount; ++i) {
+        const PluginStrategyEntry& strategy = descriptor->strategies[i];
+        auto [index, added] = slot.dispatchIndex.emplace(strategy.id, slot.dispatchIndex.size());
+        if (plugin->table.size() <= index->second) {
+            plugin->table.resize(index->second + 1, nullptr);
+        }
+        plugin->table[index->second] = &strategy;
+        plugin->metadata.strategyIds.push_back(strategy.id);
+    }
+    plugin->table.resize(slot.dispatchIndex.size(), nullptr);
+    ++slot.generation;
+    return plugin;
+}
+
+void PluginLoader::validatePlugin(const PluginDescriptor* descriptor, const std::string& path) const {
+    if (!descriptor) {
+        throw std::runtime_error("Plugin " + path + " returned no descriptor");
+    }
+    if (descriptor->abiVersion != PLUGIN_ABI_VERSION) {
+        throw std::runtime_error("Plugin " + path + " was built for plugin ABI " +
+                                 std::to_string(descriptor->abiVersion) + ", expected " +
+                                 std::to_string(PLUGIN_ABI_VERSION));
+    }
+    if (descriptor->strategyCount > 0 && !descriptor->strategies) {
+        throw std::runtime_error("Plugin " + path + " lists strategies it does not provide");
+    }
+    std::unordered_set<std::string> ids;
+    for (size_t i = 0; i < descriptor->strategyCount; ++i) {
+        const PluginStrategyEntry& strategy = descriptor->strategies[i];
+        if (!strategy.id || !strategy.verify || !strategy.isApplicable) {
+            throw std::runtime_error("Plugin " + path + " has an incomplete strategy entry");
+        }
+        if (!ids.insert(strategy.id).second) {
+            throw std::runtime_error("Plugin " + path + " defines strategy " + strategy.id + " twice");
+        }
+    }
 }
 
 } // namespace common_ground
@@ -1,5 +1,10 @@
 #include "../../../../include/xenocomm/extensions/common_ground/extensibility/strategy_composer.hpp"
+#include "xenocomm/utils/timer_service.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 namespace xenocomm {
 namespace common_ground {
@@ -23,6 +28,155 @@ public:
 private:
     std::vector<std::shared_ptr<IAlignmentStrategy>> strategies_;
 };
+
+class ParallelStrategy : public IAlignmentStrategy {
+public:
+    ParallelStrategy(std::vector<std::shared_ptr<IAlignmentStrategy>> s, ParallelExecutionConfig c)
+        : strategies_(std::move(s)), config_(c),
+          executor_(c.executor ? c.executor : &StrategyExecutor::shared()) {}
+    std::string getId() const override { return "parallel"; }
+    AlignmentResult verify(const AlignmentContext& ctx) override {
+        const size_t n = strategies_.size();
+        std::vector<std::optional<AlignmentResult>> results(n);
+        std::mutex mutex;
+        size_t alignedCount = 0;
+        size_t misalignedCount = 0;
+        std::optional<bool> verdict;  // Set once the outcome cannot change
+        CancellationToken settled;
+
+        executor_->parallelFor(n, [&](size_t i) {
+            AlignmentResult res = strategies_[i]->verify(ctx);
+            std::lock_guard<std::mutex> lock(mutex);
+            (res.isAligned() ? alignedCount : misalignedCount)++;
+            results[i].emplace(std::move(res));
+            if (!verdict) {
+                verdict = settledVerdict(alignedCount, misalignedCount, n);
+                if (verdict) settled.cancel();
+            }
+        }, settled, config_.maxConcurrency);
+
+        // Children still verifying when the verdict settled have finished by now
+        std::vector<AlignmentResult> finished;
+        for (auto& r : results) {
+            if (r && (!config_.quorum || !verdict || r->isAligned() == *verdict)) finished.push_back(std::move(*r));
+        }
+        auto combination = config_.quorum && verdict
+            ? (*verdict ? ResultCombinationStrategy::AnyAligned : ResultCombinationStrategy::AllMustAlign)
+            : config_.combination;
+        return StrategyComposer::combineResults(finished, combination);
+    }
+    bool isApplicable(const AlignmentContext& ctx) const override {
+        for (auto& s : strategies_) if (!s->isApplicable(ctx)) return false;
+        return true;
+    }
+private:
+    // The verdict results so far force, whatever the children left would say
+    std::optional<bool> settledVerdict(size_t aligned, size_t misaligned, size_t n) const {
+        if (config_.quorum) {
+            if (aligned >= *config_.quorum) return true;
+            if (misaligned >= *config_.quorum) return false;
+            return std::nullopt;
+        }
+        switch (config_.combination) {
+            case ResultCombinationStrategy::AllMustAlign:
+                if (misaligned > 0) return false;
+                break;
+            case ResultCombinationStrategy::AnyAligned:
+                if (aligned > 0) return true;
+                break;
+            case ResultCombinationStrategy::Majority:
+                if (aligned * 2 > n) return true;
+                if (misaligned * 2 >= n) return false;
+                break;
+        }
+        return std::nullopt;
+    }
+
+    std::vector<std::shared_ptr<IAlignmentStrategy>> strategies_;
+    ParallelExecutionConfig config_;
+    StrategyExecutor* executor_;
+};
+
+class RetryStrategy : public IAsyncAlignmentStrategy {
+public:
+    RetryStrategy(std::shared_ptr<IAlignmentStrategy> s, RetryConfig c)
+        : strategy_(std::move(s)), config_(c),
+          timers_(c.timers ? c.timers : &utils::TimerService::shared()),
+          executor_(c.executor ? c.executor : &StrategyExecutor::shared()) {
+        config_.maxAttempts = std::max<size_t>(config_.maxAttempts, 1);
+    }
+    std::string getId() const override { return "retry:" + strategy_->getId(); }
+    AlignmentResult verify(const AlignmentContext& ctx) override {
+        for (size_t attempt = 1;; ++attempt) {
+            const bool last = attempt >= config_.maxAttempts;
+            try {
+                auto res = strategy_->verify(ctx);
+                if (res.isAligned() || last) return res;
+            } catch (...) {
+                if (last) throw;
+            }
+            std::this_thread::sleep_for(backoff(attempt));
+        }
+    }
+    std::future<AlignmentResult> verifyAsync(const AlignmentContext& ctx) override {
+        auto run = std::make_shared<Run>(strategy_, ctx, config_, timers_, executor_);
+        auto future = run->promise.get_future();
+        executor_->submit([run] { Run::attempt(run); });
+        return future;
+    }
+    bool isApplicable(const AlignmentContext& ctx) const override {
+        return strategy_->isApplicable(ctx);
+    }
+private:
+    // One verifyAsync() call, kept alive by whichever task or timer runs it next
+    struct Run {
+        Run(std::shared_ptr<IAlignmentStrategy> s, const AlignmentContext& c, const RetryConfig& cfg,
+            utils::TimerService* t, StrategyExecutor* e)
+            : strategy(std::move(s)), context(c), config(cfg), timers(t), executor(e) {}
+
+        static void attempt(const std::shared_ptr<Run>& run) {
+            const bool last = ++run->attempts >= run->config.maxAttempts;
+            try {
+                auto res = run->strategy->verify(run->context);
+                if (res.isAligned() || last) {
+                    run->promise.set_value(std::move(res));
+                    return;
+                }
+            } catch (...) {
+                if (last) {
+                    run->promise.set_exception(std::current_exception());
+                    return;
+                }
+            }
+            // Timer callbacks must be short, so the attempt itself goes back to the executor
+            run->timers->scheduleAfter(backoff(run->config, run->attempts), [run] {
+                run->executor->submit([run] { attempt(run); });
+            });
+        }
+
+        std::shared_ptr<IAlignmentStrategy> strategy;
+        AlignmentContext context;
+        RetryConfig config;
+        utils::TimerService* timers;
+        StrategyExecutor* executor;
+        size_t attempts = 0;
+        std::promise<AlignmentResult> promise;
+    };
+
+    // Wait after the given failed attempt, counting from 1
+    static std::chrono::milliseconds backoff(const RetryConfig& config, size_t attempt) {
+        double ms = static_cast<double>(config.initialBackoff.count()) *
+                    std::pow(config.backoffMultiplier, static_cast<double>(attempt - 1));
+        ms = std::min(ms, static_cast<double>(config.maxBackoff.count()));
+        return std::chrono::milliseconds(static_cast<int64_t>(std::max(ms, 0.0)));
+    }
+    std::chrono::milliseconds backoff(size_t attempt) const { return backoff(config_, attempt); }
+
+    std::shared_ptr<IAlignmentStrategy> strategy_;
+    RetryConfig config_;
+    utils::TimerService* timers_;
+    StrategyExecutor* executor_;
+};
 }
 
 StrategyComposer::StrategyComposer() {}
@@ -31,9 +185,8 @@ std::shared_ptr<IAlignmentStrategy> StrategyComposer::sequence(std::vector<std::
     return std::make_shared<SequenceStrategy>(std::move(strategies));
 }
 
-std::shared_ptr<IAlignmentStrategy> StrategyComposer::parallel(std::vector<std::shared_ptr<IAlignmentStrategy>> strategies, ParallelExecutionConfig) {
-    // Minimal: run all, return first misalignment or aligned
-    return sequence(std::move(strategies));
+std::shared_ptr<IAlignmentStrategy> StrategyComposer::parallel(std::vector<std::shared_ptr<IAlignmentStrategy>> strategies, ParallelExecutionConfig config) {
+    return std::make_shared<ParallelStrategy>(std::move(strategies), config);
 }
 
 std::shared_ptr<IAlignmentStrategy> StrategyComposer::conditional(std::shared_ptr<IAlignmentStrategy> strategy, std::function<bool(const AlignmentContext&)> condition) {
@@ -78,28 +231,35 @@ std::shared_ptr<IAlignmentStrategy> StrategyComposer::fallback(std::vector<std::
     return std::make_shared<FallbackStrategy>(std::move(strategies));
 }
 
-std::shared_ptr<IAlignmentStrategy> StrategyComposer::withRetry(std::shared_ptr<IAlignmentStrategy> strategy, RetryConfig) {
-    class RetryStrategy : public IAlignmentStrategy {
-    public:
-        RetryStrategy(std::shared_ptr<IAlignmentStrategy> s) : strategy_(std::move(s)) {}
-        std::string getId() const override { return "retry:" + strategy_->getId(); }
-        AlignmentResult verify(const AlignmentContext& ctx) override {
-            // Minimal: just call once
-            return strategy_->verify(ctx);
-        }
-        bool isApplicable(const AlignmentContext& ctx) const override {
-            return strategy_->isApplicable(ctx);
-        }
-    private:
-        std::shared_ptr<IAlignmentStrategy> strategy_;
-    };
-    return std::make_shared<RetryStrategy>(std::move(strategy));
+std::shared_ptr<IAlignmentStrategy> StrategyComposer::withRetry(std::shared_ptr<IAlignmentStrategy> strategy, RetryConfig config) {
+    return std::make_shared<RetryStrategy>(std::move(strategy), config);
 }
 
-AlignmentResult StrategyComposer::combineResults(const std::vector<AlignmentResult>& results, ResultCombinationStrategy) {
-    // Minimal: return first result
-    if (!results.empty()) return results.front();
-    return AlignmentResult(true, {}, 1.0);
+AlignmentResult StrategyComposer::combineResults(const std::vector<AlignmentResult>& results, ResultCombinationStrategy strategy) {
+    if (results.empty()) return AlignmentResult(true, {}, 1.0);
+    size_t alignedCount = 0;
+    for (const auto& r : results) if (r.isAligned()) ++alignedCount;
+
+    bool aligned = false;
+    switch (strategy) {
+        case ResultCombinationStrategy::AllMustAlign: aligned = alignedCount == results.size(); break;
+        case ResultCombinationStrategy::AnyAligned: aligned = alignedCount > 0; break;
+        case ResultCombinationStrategy::Majority: aligned = alignedCount * 2 > results.size(); break;
+    }
+
+    double confidence = aligned ? 0.0 : 1.0;
+    std::vector<std::string> misalignments;
+    for (const auto& r : results) {
+        if (r.isAligned() != aligned) continue;
+        if (aligned) {
+            confidence += r.getConfidenceScore();
+        } else {
+            confidence = std::min(confidence, r.getConfidenceScore());
+            misalignments.insert(misalignments.end(), r.getMisalignments().begin(), r.getMisalignments().end());
+        }
+    }
+    if (aligned) confidence /= static_cast<double>(alignedCount);
+    return AlignmentResult(aligned, std::move(misalignments), confidence);
 }
 
 } // namespace common_ground
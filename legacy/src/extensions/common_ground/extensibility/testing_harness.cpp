@@ -1,51 +1,327 @@
 #include "../../../../include/xenocomm/extensions/common_ground/extensibility/testing_harness.hpp"
-#include <iostream>
+#include "../../../../include/xenocomm/extensions/common_ground/extensibility/allocation_tracking.hpp"
+#include "../../../../include/xenocomm/utils/latency_histogram.hpp"
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
 
 namespace xenocomm {
 namespace common_ground {
 
+namespace {
+
+constexpr double CONFIDENCE_TOLERANCE = 1e-6;
+
+std::string describe(const AlignmentResult& result) {
+    std::string text = result.isAligned() ? "aligned" : "misaligned";
+    text += " (confidence " + std::to_string(result.getConfidenceScore());
+    for (const auto& misalignment : result.getMisalignments()) {
+        text += ", " + misalignment;
+    }
+    return text + ")";
+}
+
+std::optional<std::string> mismatch(const AlignmentResult& expected, const AlignmentResult& actual) {
+    if (expected.isAligned() != actual.isAligned() || expected.getMisalignments() != actual.getMisalignments() ||
+        std::abs(expected.getConfidenceScore() - actual.getConfidenceScore()) > CONFIDENCE_TOLERANCE) {
+        return "expected " + describe(expected) + ", got " + describe(actual);
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+ContextCorpus generateCorpus(size_t count, const ContextGenerator& generator, uint32_t seed) {
+    ContextCorpus corpus;
+    corpus.reserve(count);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < count; ++i) {
+        corpus.push_back(generator(i, rng));
+    }
+    return corpus;
+}
+
+ContextRecorder::ContextRecorder(std::shared_ptr<IAlignmentStrategy> strategy, size_t capacity)
+    : strategy_(std::move(strategy)), capacity_(capacity) {
+    if (!strategy_) {
+        throw std::invalid_argument("ContextRecorder needs a strategy");
+    }
+}
+
+std::string ContextRecorder::getId() const { return strategy_->getId(); }
+
+bool ContextRecorder::isApplicable(const AlignmentContext& context) const {
+    return strategy_->isApplicable(context);
+}
+
+AlignmentResult ContextRecorder::verify(const AlignmentContext& context) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (recorded_.size() < capacity_) {
+            recorded_.push_back(context);
+        }
+    }
+    return strategy_->verify(context);
+}
+
+ContextCorpus ContextRecorder::corpus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recorded_;
+}
+
 StrategyTestHarness::StrategyTestHarness(std::shared_ptr<IAlignmentStrategy> strategy)
-    : strategy_(std::move(strategy)) {}
+    : strategy_(std::move(strategy)) {
+    if (!strategy_) {
+        throw std::invalid_argument("StrategyTestHarness needs a strategy");
+    }
+}
 
-void StrategyTestHarness::withContext(const AlignmentContext&) {
-    std::cout << "Configuring test context (stub)" << std::endl;
+void StrategyTestHarness::withContext(const AlignmentContext& context) {
+    config_.context = context;
 }
-void StrategyTestHarness::withMockData(const std::string&, const std::any&) {
-    std::cout << "Configuring mock data (stub)" << std::endl;
+void StrategyTestHarness::withMockData(const std::string& key, const std::any& value) {
+    config_.mockData[key] = value;
 }
-void StrategyTestHarness::withExpectedResult(const AlignmentResult&) {
-    std::cout << "Setting expected result (stub)" << std::endl;
+void StrategyTestHarness::withExpectedResult(const AlignmentResult& result) {
+    config_.expected = result;
+}
+void StrategyTestHarness::withCorpus(ContextCorpus corpus) {
+    if (corpus.empty()) {
+        throw std::invalid_argument("Benchmark corpus is empty");
+    }
+    corpus_ = std::move(corpus);
 }
 
 TestResult StrategyTestHarness::runTest() {
-    std::cout << "Running test (stub)" << std::endl;
-    return TestResult{};
+    validateTestConfig();
+    TestResult result = runCase(strategy_->getId(), *config_.context, config_.expected);
+    recordTestResult(result);
+    return result;
 }
-std::vector<TestResult> StrategyTestHarness::runTestSuite(const TestSuite&) {
-    std::cout << "Running test suite (stub)" << std::endl;
-    return {};
+std::vector<TestResult> StrategyTestHarness::runTestSuite(const TestSuite& suite) {
+    std::vector<TestResult> results;
+    results.reserve(suite.cases.size());
+    for (const auto& testCase : suite.cases) {
+        results.push_back(runCase(suite.name + "/" + testCase.name, testCase.context, testCase.expected));
+        recordTestResult(results.back());
+    }
+    return results;
 }
 
 void StrategyTestHarness::validateStrategy() {
-    std::cout << "Validating strategy (stub)" << std::endl;
+    if (strategy_->getId().empty()) {
+        throw std::runtime_error("Strategy has no id");
+    }
+    if (config_.context && !strategy_->isApplicable(*config_.context)) {
+        throw std::runtime_error("Strategy " + strategy_->getId() + " does not apply to the test context");
+    }
+}
+
+std::vector<BenchmarkResult> StrategyTestHarness::runBenchmark(const BenchmarkConfig& config) {
+    if (corpus_.empty()) {
+        validateTestConfig();
+    }
+    const ContextCorpus single = corpus_.empty() ? ContextCorpus{*config_.context} : ContextCorpus{};
+    const ContextCorpus& corpus = corpus_.empty() ? single : corpus_;
+    const bool countAllocations = allocation_tracking::installed().load();
+
+    std::vector<BenchmarkResult> results;
+    for (size_t threads : config.threadCounts) {
+        threads = threads ? threads : 1;
+        std::vector<std::unique_ptr<utils::LatencyHistogram>> latencies;
+        for (size_t t = 0; t < threads; ++t) {
+            latencies.push_back(std::make_unique<utils::LatencyHistogram>());
+        }
+        std::vector<uint64_t> allocations(threads, 0);
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        auto worker = [&](size_t index) {
+            // Threads start at different offsets so they don't verify the same context in lockstep
+            size_t next = index * 31;
+            try {
+                for (size_t i = 0; i < config.warmupIterations; ++i) {
+                    auto result = strategy_->verify(corpus[next++ % corpus.size()]);
+                    (void)result;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            ++ready;
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            try {
+                utils::LatencyHistogram& latency = *latencies[index];
+                const uint64_t allocationsBefore = allocation_tracking::threadAllocations();
+                for (size_t i = 0; i < config.iterations; ++i) {
+                    const AlignmentContext& context = corpus[next++ % corpus.size()];
+                    auto start = std::chrono::steady_clock::now();
+                    auto result = strategy_->verify(context);
+                    auto elapsed = std::chrono::steady_clock::now() - start;
+                    (void)result;
+                    latency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+                }
+                allocations[index] = allocation_tracking::threadAllocations() - allocationsBefore;
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            pool.emplace_back(worker, t);
+        }
+        while (ready.load() < threads) {
+            std::this_thread::yield();
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        auto wall = std::chrono::steady_clock::now() - start;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        utils::LatencyHistogram merged;
+        uint64_t totalAllocations = 0;
+        for (size_t t = 0; t < threads; ++t) {
+            merged.merge(*latencies[t]);
+            totalAllocations += allocations[t];
+        }
+
+        BenchmarkResult result;
+        result.threads = threads;
+        result.calls = merged.count();
+        result.p50 = std::chrono::nanoseconds(merged.value_at_percentile(50.0));
+        result.p90 = std::chrono::nanoseconds(merged.value_at_percentile(90.0));
+        result.p99 = std::chrono::nanoseconds(merged.value_at_percentile(99.0));
+        result.max = std::chrono::nanoseconds(merged.max());
+        const double seconds = std::chrono::duration<double>(wall).count();
+        result.callsPerSecond = seconds > 0.0 ? static_cast<double>(result.calls) / seconds : 0.0;
+        if (countAllocations && result.calls) {
+            result.allocationsPerCall = static_cast<double>(totalAllocations) / static_cast<double>(result.calls);
+        }
+        results.push_back(result);
+        benchmarks_.push_back(result);
+    }
+    return results;
 }
-void StrategyTestHarness::checkPerformance(const PerformanceCriteria&) {
-    std::cout << "Checking performance (stub)" << std::endl;
+
+void StrategyTestHarness::checkPerformance(const PerformanceCriteria& criteria) {
+    for (const auto& result : runBenchmark(criteria.benchmark)) {
+        const std::string where = strategy_->getId() + " at " + std::to_string(result.threads) + " thread(s): ";
+        if (criteria.maxP99.count() && result.p99 > criteria.maxP99) {
+            throw std::runtime_error(where + "p99 " + std::to_string(result.p99.count()) + "ns exceeds " +
+                                     std::to_string(criteria.maxP99.count()) + "ns");
+        }
+        if (criteria.minCallsPerSecond > 0.0 && result.callsPerSecond < criteria.minCallsPerSecond) {
+            throw std::runtime_error(where + std::to_string(result.callsPerSecond) + " calls/s is below " +
+                                     std::to_string(criteria.minCallsPerSecond));
+        }
+        if (criteria.maxAllocationsPerCall && result.allocationsPerCall &&
+            *result.allocationsPerCall > *criteria.maxAllocationsPerCall) {
+            throw std::runtime_error(where + std::to_string(*result.allocationsPerCall) +
+                                     " allocations per call exceeds " +
+                                     std::to_string(*criteria.maxAllocationsPerCall));
+        }
+    }
 }
 
 TestReport StrategyTestHarness::generateReport() const {
-    std::cout << "Generating test report (stub)" << std::endl;
-    return TestReport{};
+    TestReport report;
+    report.strategyId = strategy_->getId();
+    report.results = results_;
+    report.benchmarks = benchmarks_;
+    for (const auto& result : results_) {
+        ++(result.passed ? report.passed : report.failed);
+    }
+    return report;
 }
-void StrategyTestHarness::exportReport(const std::string&) const {
-    std::cout << "Exporting test report (stub)" << std::endl;
+void StrategyTestHarness::exportReport(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write test report to " + path);
+    }
+    TestReport report = generateReport();
+    out << "strategy " << report.strategyId << ": " << report.passed << " passed, " << report.failed
+        << " failed\n";
+    for (const auto& result : report.results) {
+        out << (result.passed ? "PASS " : "FAIL ") << result.name << " (" << result.duration.count() << "ns)";
+        if (!result.message.empty()) {
+            out << ": " << result.message;
+        }
+        out << "\n";
+    }
+    for (const auto& bench : report.benchmarks) {
+        out << "bench threads=" << bench.threads << " calls=" << bench.calls << " p50_ns=" << bench.p50.count()
+            << " p90_ns=" << bench.p90.count() << " p99_ns=" << bench.p99.count()
+            << " max_ns=" << bench.max.count() << " calls_per_s=" << bench.callsPerSecond;
+        if (bench.allocationsPerCall) {
+            out << " allocs_per_call=" << *bench.allocationsPerCall;
+        }
+        out << "\n";
+    }
 }
 
 void StrategyTestHarness::validateTestConfig() const {
-    std::cout << "Validating test config (stub)" << std::endl;
+    if (!config_.context) {
+        throw std::runtime_error("No test context configured; call withContext() first");
+    }
+}
+void StrategyTestHarness::recordTestResult(const TestResult& result) {
+    results_.push_back(result);
 }
-void StrategyTestHarness::recordTestResult(const TestResult&) {
-    std::cout << "Recording test result (stub)" << std::endl;
+
+TestResult StrategyTestHarness::runCase(const std::string& name, const AlignmentContext& context,
+                                        const std::optional<AlignmentResult>& expected) {
+    TestResult result;
+    result.name = name;
+
+    // Mock data overrides the context's own parameters
+    std::optional<AlignmentContext> mocked;
+    if (!config_.mockData.empty()) {
+        auto parameters = context.getParameters();
+        for (const auto& [key, value] : config_.mockData) {
+            parameters[key] = value;
+        }
+        mocked.emplace(context.getLocalAgent(), context.getRemoteAgent(), std::move(parameters));
+    }
+    const AlignmentContext& effective = mocked ? *mocked : context;
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        result.actual = strategy_->verify(effective);
+    } catch (const std::exception& e) {
+        result.duration = std::chrono::steady_clock::now() - start;
+        result.message = std::string("verify threw: ") + e.what();
+        return result;
+    }
+    result.duration = std::chrono::steady_clock::now() - start;
+
+    if (expected) {
+        if (auto difference = mismatch(*expected, *result.actual)) {
+            result.message = *difference;
+            return result;
+        }
+    }
+    result.passed = true;
+    return result;
 }
 
 } // namespace common_ground
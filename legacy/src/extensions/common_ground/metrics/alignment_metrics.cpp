@@ -1,10 +1,18 @@
 #include "xenocomm/extensions/common_ground/metrics/alignment_metrics.hpp"
 #include "xenocomm/extensions/common_ground/metrics/metric_storage.hpp"
+#include "xenocomm/extensions/common_ground/metrics/downsampling.hpp"
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include <array>
+#include <condition_variable>
+#include <map>
 #include <set>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <atomic>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 #include "xenocomm/core/negotiation_protocol.h"
 
 namespace xenocomm {
@@ -12,12 +20,326 @@ namespace extensions {
 namespace common_ground {
 namespace metrics {
 
+namespace {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+constexpr size_t INGEST_SHARDS = 8;  // Rings recording threads are spread over
+constexpr auto MINUTE_ROLLUP_RETENTION = std::chrono::hours(24);
+constexpr auto HOUR_ROLLUP_RETENTION = std::chrono::hours(24 * 90);
+
+enum class EventKind : uint8_t { AlignmentAttempt, StrategyExecution, Negotiation };
+
+// A recorded event as it waits in an ingestion ring
+struct EventRecord {
+    std::chrono::system_clock::rep timestamp;
+    std::chrono::milliseconds::rep duration;  // Convergence or execution time
+    uint32_t strategy;                        // Interned strategy ID; StrategyExecution only
+    EventKind kind;
+    bool success;
+    std::vector<MetricData>* details;  // Raw metrics if the event was sampled, owned by the record
+};
+
+// Spreads recording threads round-robin over the ingestion rings
+size_t ingestShard() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % INGEST_SHARDS;
+    return shard;
+}
+
+uint64_t hashSession(const std::string& sessionId) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : sessionId) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    // FNV-1a mixes its low bits poorly, so finish before taking the top ones
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+struct Rollup {
+    uint64_t count = 0;
+    uint64_t successes = 0;
+    double totalMs = 0.0;
+
+    void add(bool success, double ms) {
+        ++count;
+        successes += success ? 1 : 0;
+        totalMs += ms;
+    }
+    void add(const Rollup& other) {
+        count += other.count;
+        successes += other.successes;
+        totalMs += other.totalMs;
+    }
+    double successRate() const { return count > 0 ? static_cast<double>(successes) / count : 0.0; }
+    double averageMs() const { return count > 0 ? totalMs / count : 0.0; }
+};
+
+// Per-minute and per-hour rollups of one stream of events
+class RollupSeries {
+public:
+    void add(TimePoint t, bool success, double ms) {
+        minutes_[std::chrono::floor<std::chrono::minutes>(t)].add(success, ms);
+        hours_[std::chrono::floor<std::chrono::hours>(t)].add(success, ms);
+    }
+
+    // Drops rollups past their retention, measured from the newest event
+    void prune(TimePoint newest) {
+        minuteHorizon_ = std::max(minuteHorizon_,
+                                  TimePoint(std::chrono::floor<std::chrono::hours>(newest - MINUTE_ROLLUP_RETENTION)));
+        minutes_.erase(minutes_.begin(), minutes_.lower_bound(minuteHorizon_));
+        hours_.erase(hours_.begin(), hours_.lower_bound(newest - HOUR_ROLLUP_RETENTION));
+    }
+
+    // Whole hours where every minute starts in range, minutes elsewhere while they are kept
+    Rollup sum(const TimeRange& range) const {
+        Rollup total;
+        auto hour = range.start ? hours_.lower_bound(std::chrono::floor<std::chrono::hours>(*range.start))
+                                : hours_.begin();
+        for (; hour != hours_.end() && (!range.end || hour->first <= *range.end); ++hour) {
+            const TimePoint lastMinute = hour->first + std::chrono::minutes(59);
+            const bool covered = (!range.start || hour->first >= *range.start) &&
+                                 (!range.end || lastMinute <= *range.end);
+            if (covered || hour->first < minuteHorizon_) {
+                if (covered || startsIn(range, hour->first)) {
+                    total.add(hour->second);
+                }
+                continue;
+            }
+            auto minute = minutes_.lower_bound(range.start ? std::max(hour->first, *range.start) : hour->first);
+            for (; minute != minutes_.end() && minute->first <= lastMinute &&
+                   (!range.end || minute->first <= *range.end); ++minute) {
+                total.add(minute->second);
+            }
+        }
+        return total;
+    }
+
+    // Calls visit for each minute (or hour) rollup starting in range, oldest first
+    template <typename Visit>
+    void forEachBucket(const TimeRange& range, bool hourly, Visit visit) const {
+        const auto& buckets = hourly ? hours_ : minutes_;
+        auto it = range.start ? buckets.lower_bound(*range.start) : buckets.begin();
+        for (; it != buckets.end() && (!range.end || it->first <= *range.end); ++it) {
+            visit(it->first, it->second);
+        }
+    }
+
+    // Whether minute rollups still cover all of range
+    bool hasMinutesFor(const TimeRange& range) const {
+        return range.start && range.end && *range.start >= minuteHorizon_;
+    }
+
+private:
+    static bool startsIn(const TimeRange& range, TimePoint t) {
+        return (!range.start || t >= *range.start) && (!range.end || t <= *range.end);
+    }
+
+    std::map<TimePoint, Rollup> minutes_;
+    std::map<TimePoint, Rollup> hours_;
+    TimePoint minuteHorizon_ = TimePoint::min();  // Minute rollups before this were pruned
+};
+
+} // namespace
+
+class MetricsAggregator {
+public:
+    MetricsAggregator(const MetricsConfig& config, MetricStorage& storage)
+        : config_(config), storage_(storage) {
+        for (auto& ring : rings_) {
+            ring = std::make_unique<utils::MpscRing<EventRecord>>(config.ingestQueueCapacity);
+        }
+        thread_ = std::thread([this] {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_) {
+                wake_.wait_for(lock, config_.flushInterval);
+                drainLocked();
+            }
+        });
+    }
+
+    ~MetricsAggregator() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainLocked();
+    }
+
+    void ingest(const EventRecord& record) {
+        auto& ring = *rings_[ingestShard()];
+        if (ring.try_push(record)) {
+            return;
+        }
+        // Full: aggregate everything so far, which frees the ring for this record
+        std::lock_guard<std::mutex> lock(mutex_);
+        do {
+            drainLocked();
+        } while (!ring.try_push(record));
+    }
+
+    uint32_t internStrategy(const std::string& strategyId) {
+        {
+            std::shared_lock<std::shared_mutex> lock(strategyIdsMutex_);
+            auto it = strategyIds_.find(strategyId);
+            if (it != strategyIds_.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(strategyIdsMutex_);
+        auto [it, inserted] = strategyIds_.emplace(strategyId, static_cast<uint32_t>(strategyNames_.size()));
+        if (inserted) {
+            strategyNames_.push_back(strategyId);
+        }
+        return it->second;
+    }
+
+    void setFeedbackLoop(std::shared_ptr<FeedbackLoop> feedbackLoop) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        feedbackLoop_ = std::move(feedbackLoop);
+        pushedThrough_ = std::chrono::floor<std::chrono::minutes>(std::chrono::system_clock::now());
+    }
+
+    Rollup alignment(const TimeRange& range) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainLocked();
+        return alignment_.sum(range);
+    }
+
+    Rollup strategy(const std::string& strategyId, const TimeRange& range) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainLocked();
+        const RollupSeries* series = findStrategy(strategyId);
+        return series ? series->sum(range) : Rollup{};
+    }
+
+    AlignmentTrends trends(const TimeRange& range) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainLocked();
+        AlignmentTrends trends;
+        const bool hourly = !alignment_.hasMinutesFor(range) ||
+                            *range.end - *range.start > MINUTE_ROLLUP_RETENTION;
+        alignment_.forEachBucket(range, hourly, [&trends](TimePoint t, const Rollup& rollup) {
+            trends.successRate.push_back({t, rollup.successRate()});
+            trends.convergenceTime.push_back({t, rollup.averageMs()});
+        });
+        std::shared_lock<std::shared_mutex> names(strategyIdsMutex_);
+        for (size_t id = 0; id < strategies_.size(); ++id) {
+            auto& points = trends.strategyPerformance[strategyNames_[id]];
+            strategies_[id].forEachBucket(range, hourly, [&points](TimePoint t, const Rollup& rollup) {
+                points.push_back({t, rollup.successRate()});
+            });
+        }
+        return trends;
+    }
+
+    MetricPage page(const MetricQuery& query) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainLocked();
+        return storage_.page(query);
+    }
+
+private:
+    const RollupSeries* findStrategy(const std::string& strategyId) const {
+        std::shared_lock<std::shared_mutex> lock(strategyIdsMutex_);
+        auto it = strategyIds_.find(strategyId);
+        return it == strategyIds_.end() || it->second >= strategies_.size() ? nullptr : &strategies_[it->second];
+    }
+
+    // Folds queued events into the rollups and storage. Requires mutex_.
+    void drainLocked() {
+        EventRecord record;
+        TimePoint newest = TimePoint::min();
+        for (auto& ring : rings_) {
+            while (ring->try_pop(record)) {
+                const TimePoint t{std::chrono::system_clock::duration(record.timestamp)};
+                newest = std::max(newest, t);
+                const double ms = static_cast<double>(record.duration);
+                if (record.kind == EventKind::AlignmentAttempt) {
+                    alignment_.add(t, record.success, ms);
+                } else if (record.kind == EventKind::StrategyExecution) {
+                    if (record.strategy >= strategies_.size()) {
+                        strategies_.resize(record.strategy + 1);
+                    }
+                    strategies_[record.strategy].add(t, record.success, ms);
+                }
+                if (record.details) {
+                    std::unique_ptr<std::vector<MetricData>> details(record.details);
+                    for (const auto& data : *details) {
+                        storage_.saveMetric(data);
+                    }
+                }
+            }
+        }
+        if (newest != TimePoint::min()) {
+            alignment_.prune(newest);
+            for (auto& series : strategies_) {
+                series.prune(newest);
+            }
+        }
+        pushFeedbackLocked();
+    }
+
+    // Reports every minute completed since the last push, one metric per rollup
+    void pushFeedbackLocked() {
+        if (!feedbackLoop_) {
+            return;
+        }
+        const TimePoint current = std::chrono::floor<std::chrono::minutes>(std::chrono::system_clock::now());
+        if (current <= pushedThrough_) {
+            return;
+        }
+        TimeRange completed{pushedThrough_, current - std::chrono::minutes(1)};
+        pushedThrough_ = current;
+        auto report = [this](const std::string& name, double value) {
+            auto result = feedbackLoop_->recordMetric(name, value);
+            if (!result) {
+                std::cerr << "[AlignmentMetrics] Failed to update FeedbackLoop for metric '"
+                          << name << "' with value " << value << std::endl;
+            }
+        };
+        alignment_.forEachBucket(completed, false, [&report](TimePoint, const Rollup& rollup) {
+            report("alignment.success_rate", rollup.successRate());
+            report("alignment.convergence_time", rollup.averageMs());
+        });
+        std::shared_lock<std::shared_mutex> names(strategyIdsMutex_);
+        for (size_t id = 0; id < strategies_.size(); ++id) {
+            const std::string name = "strategy.effectiveness." + strategyNames_[id];
+            strategies_[id].forEachBucket(completed, false, [&](TimePoint, const Rollup& rollup) {
+                report(name, rollup.successRate());
+            });
+        }
+    }
+
+    const MetricsConfig& config_;
+    MetricStorage& storage_;
+    std::array<std::unique_ptr<utils::MpscRing<EventRecord>>, INGEST_SHARDS> rings_;
+
+    std::mutex mutex_;  // Guards everything below but the strategy IDs; whoever holds it drains
+    RollupSeries alignment_;
+    std::vector<RollupSeries> strategies_;  // By interned strategy ID
+    std::shared_ptr<FeedbackLoop> feedbackLoop_;
+    TimePoint pushedThrough_;  // Minutes before this were reported to feedbackLoop_
+
+    mutable std::shared_mutex strategyIdsMutex_;
+    std::unordered_map<std::string, uint32_t> strategyIds_;
+    std::vector<std::string> strategyNames_;
+
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
 AlignmentMetrics::AlignmentMetrics(const MetricsConfig& config)
     : config_(config),
-      storage_(std::make_unique<MetricStorage>()),
-      feedbackLoop_(nullptr),
-      totalAlignmentAttempts_(0),
-      successfulAlignments_(0) {
+      storage_(std::make_unique<MetricStorage>(config_)),
+      aggregator_(std::make_unique<MetricsAggregator>(config_, *storage_)) {
     // Register default metric categories
     registerMetricCategory("alignment.success_rate");
     registerMetricCategory("alignment.convergence_time");
@@ -26,6 +348,8 @@ AlignmentMetrics::AlignmentMetrics(const MetricsConfig& config)
     registerMetricCategory("strategy.effectiveness");
 }
 
+AlignmentMetrics::~AlignmentMetrics() = default;
+
 void AlignmentMetrics::registerMetricCategory(const std::string& category) {
     std::lock_guard<std::mutex> lock(metricsMutex_);
     registeredCategories_.insert(category);
@@ -36,153 +360,121 @@ std::string AlignmentMetrics::generateMetricId() {
     return "metric_" + std::to_string(counter++);
 }
 
+bool AlignmentMetrics::shouldSampleMetric(const std::string& sessionId) const {
+    const double rate = config_.samplingRate;
+    if (rate >= 1.0) {
+        return true;
+    }
+    if (rate <= 0.0) {
+        return false;
+    }
+    if (sessionId.empty()) {
+        // No session to decide by: keep an even share of this thread's events
+        thread_local double credit = 0.0;
+        credit += rate;
+        if (credit < 1.0) {
+            return false;
+        }
+        credit -= 1.0;
+        return true;
+    }
+    return static_cast<double>(hashSession(sessionId) >> 11) * 0x1.0p-53 < rate;
+}
+
 void AlignmentMetrics::recordAlignmentAttempt(
     const AlignmentContext& context,
     const AlignmentResult& result,
     const AlignmentMetadata& metadata) {
-    std::lock_guard<std::mutex> lock(metricsMutex_);
-    totalAlignmentAttempts_++;
-    if (result.outcome == AlignmentOutcome::Success) {
-        successfulAlignments_++;
-    }
-
-    // Create MetricData for success rate
-    MetricData successMetric;
-    successMetric.metricId = generateMetricId();
-    successMetric.category = "alignment.success_rate";
-    successMetric.timestamp = metadata.timestamp;
-    successMetric.value = (result.outcome == AlignmentOutcome::Success) ? 1.0 : 0.0;
-    successMetric.sessionId = metadata.sessionId;
-    successMetric.labels = {
-        {"agent_id", context.agentId},
-        {"target_id", context.targetId},
-        {"domain", context.domainContext},
-        {"outcome", outcomeToString(result.outcome)}
-    };
-
-    // Create MetricData for convergence time
-    MetricData timeMetric;
-    timeMetric.metricId = generateMetricId();
-    timeMetric.category = "alignment.convergence_time";
-    timeMetric.timestamp = metadata.timestamp;
-    timeMetric.value = static_cast<double>(result.convergenceTime.count());
-    timeMetric.sessionId = metadata.sessionId;
-    timeMetric.labels = successMetric.labels;
+    const bool success = result.outcome == AlignmentOutcome::Success;
+    totalAlignmentAttempts_.fetch_add(1, std::memory_order_relaxed);
+    if (success) {
+        successfulAlignments_.fetch_add(1, std::memory_order_relaxed);
+    }
+    EventRecord record{metadata.timestamp.time_since_epoch().count(),
+                       std::chrono::duration_cast<std::chrono::milliseconds>(result.convergenceTime).count(),
+                       0, EventKind::AlignmentAttempt, success, nullptr};
 
-    // Store metrics in memory
-    inMemoryMetrics_.push_back(successMetric);
-    inMemoryMetrics_.push_back(timeMetric);
+    if (shouldSampleMetric(metadata.sessionId)) {
+        // Create MetricData for success rate
+        MetricData successMetric;
+        successMetric.metricId = generateMetricId();
+        successMetric.category = "alignment.success_rate";
+        successMetric.timestamp = metadata.timestamp;
+        successMetric.value = success ? 1.0 : 0.0;
+        successMetric.sessionId = metadata.sessionId;
+        successMetric.labels = {
+            {"agent_id", context.agentId},
+            {"target_id", context.targetId},
+            {"domain", context.domainContext},
+            {"outcome", outcomeToString(result.outcome)}
+        };
 
-    // Store metrics in persistent storage
-    persistMetrics(successMetric);
-    persistMetrics(timeMetric);
+        // Create MetricData for convergence time
+        MetricData timeMetric;
+        timeMetric.metricId = generateMetricId();
+        timeMetric.category = "alignment.convergence_time";
+        timeMetric.timestamp = metadata.timestamp;
+        timeMetric.value = static_cast<double>(record.duration);
+        timeMetric.sessionId = metadata.sessionId;
+        timeMetric.labels = successMetric.labels;
 
-    // Update feedback loop if available
-    if (feedbackLoop_) {
-        updateFeedbackLoop(successMetric);
-        updateFeedbackLoop(timeMetric);
+        record.details = new std::vector<MetricData>{std::move(successMetric), std::move(timeMetric)};
     }
+    aggregator_->ingest(record);
 }
 
 void AlignmentMetrics::recordStrategyExecution(const std::string& strategyId, const ExecutionStats& stats) {
-    std::lock_guard<std::mutex> lock(metricsMutex_);
-    MetricData execMetric;
-    execMetric.metricId = generateMetricId();
-    execMetric.category = "strategy.execution_time";
-    execMetric.timestamp = std::chrono::system_clock::now();
-    execMetric.value = static_cast<double>(stats.executionTime.count());
-    execMetric.labels = {
-        {"strategy_id", strategyId},
-        {"success", stats.successful ? "true" : "false"}
-    };
-    // Store in memory
-    inMemoryMetrics_.push_back(execMetric);
-    persistMetrics(execMetric);
-    if (feedbackLoop_) {
-        updateFeedbackLoop(execMetric);
+    const auto now = std::chrono::system_clock::now();
+    EventRecord record{now.time_since_epoch().count(), stats.executionTime.count(),
+                       aggregator_->internStrategy(strategyId), EventKind::StrategyExecution,
+                       stats.successful, nullptr};
+    if (shouldSampleMetric("")) {
+        MetricData execMetric;
+        execMetric.metricId = generateMetricId();
+        execMetric.category = "strategy.execution_time";
+        execMetric.timestamp = now;
+        execMetric.value = static_cast<double>(stats.executionTime.count());
+        execMetric.labels = {
+            {"strategy_id", strategyId},
+            {"success", stats.successful ? "true" : "false"}
+        };
+        record.details = new std::vector<MetricData>{std::move(execMetric)};
     }
+    aggregator_->ingest(record);
 }
 
 double AlignmentMetrics::getAlignmentSuccessRate(const TimeRange& range) const {
-    std::lock_guard<std::mutex> lock(metricsMutex_);
-    if (inMemoryMetrics_.empty()) return 0.0;
-    size_t total = 0;
-    size_t successful = 0;
-    for (const auto& metric : inMemoryMetrics_) {
-        if (metric.category == "alignment.success_rate" &&
-            (!range.start || metric.timestamp >= *range.start) &&
-            (!range.end || metric.timestamp <= *range.end)) {
-            total++;
-            if (metric.value > 0.5) successful++;
-        }
-    }
-    return total > 0 ? static_cast<double>(successful) / total : 0.0;
+    return aggregator_->alignment(range).successRate();
 }
 
 std::chrono::milliseconds AlignmentMetrics::getAverageConvergenceTime(const TimeRange& range) const {
-    std::lock_guard<std::mutex> lock(metricsMutex_);
-    size_t count = 0;
-    double totalTime = 0.0;
-    for (const auto& metric : inMemoryMetrics_) {
-        if (metric.category == "alignment.convergence_time" &&
-            (!range.start || metric.timestamp >= *range.start) &&
-            (!range.end || metric.timestamp <= *range.end)) {
-            totalTime += metric.value;
-            count++;
-        }
-    }
-    return count > 0 ? std::chrono::milliseconds(static_cast<int64_t>(totalTime / count)) : std::chrono::milliseconds(0);
+    return std::chrono::milliseconds(static_cast<int64_t>(aggregator_->alignment(range).averageMs()));
 }
 
 double AlignmentMetrics::getStrategyEffectiveness(const std::string& strategyId, const TimeRange& range) const {
-    std::lock_guard<std::mutex> lock(metricsMutex_);
-    size_t total = 0;
-    size_t successful = 0;
-    for (const auto& metric : inMemoryMetrics_) {
-        if (metric.category == "strategy.execution_time" &&
-            metric.labels.count("strategy_id") &&
-            metric.labels.at("strategy_id") == strategyId &&
-            (!range.start || metric.timestamp >= *range.start) &&
-            (!range.end || metric.timestamp <= *range.end)) {
-            total++;
-            if (metric.labels.count("success") && metric.labels.at("success") == "true") {
-                successful++;
-            }
-        }
-    }
-    return total > 0 ? static_cast<double>(successful) / total : 0.0;
+    return aggregator_->strategy(strategyId, range).successRate();
 }
 
 AlignmentTrends AlignmentMetrics::analyzeTrends(const TimeRange& range) const {
-    // Stub: To be implemented with more advanced analysis
-    return AlignmentTrends{};
+    // resourceUtilization has no source yet
+    return aggregator_->trends(range);
 }
 
-StrategyComparison AlignmentMetrics::compareStrategies(const std::vector<std::string>& strategyIds) const {
-    // Stub: To be implemented with more advanced comparison
-    return StrategyComparison{};
+AlignmentTrends AlignmentMetrics::analyzeTrends(const TimeRange& range, size_t maxPoints) const {
+    return downsample(aggregator_->trends(range), maxPoints);
 }
 
-void AlignmentMetrics::syncWithFeedbackLoop(std::shared_ptr<class FeedbackLoop> feedbackLoop) {
-    feedbackLoop_ = feedbackLoop;
-    // TODO: Implement synchronization logic if needed
+MetricPage AlignmentMetrics::getMetricsSince(const MetricQuery& query) const {
+    return aggregator_->page(query);
 }
 
-void AlignmentMetrics::updateFeedbackLoop(const MetricData& data) {
-    if (feedbackLoop_) {
-        auto result = feedbackLoop_->recordMetric(data.category, data.value);
-        if (!result) {
-            std::cerr << "[AlignmentMetrics] Failed to update FeedbackLoop for metric '"
-                      << data.category << "' with value " << data.value << std::endl;
-        }
-        // TODO: Use reportOutcome or addCommunicationResult for richer data if available
-    }
+StrategyComparison AlignmentMetrics::compareStrategies(const std::vector<std::string>& strategyIds) const {
+    // Stub: To be implemented with more advanced comparison
+    return StrategyComparison{};
 }
 
-void AlignmentMetrics::persistMetrics(const MetricData& data) {
-    if (storage_) {
-        storage_->saveMetric(data);
-    }
+void AlignmentMetrics::syncWithFeedbackLoop(std::shared_ptr<class FeedbackLoop> feedbackLoop) {
+    aggregator_->setFeedbackLoop(std::move(feedbackLoop));
 }
 
 std::string AlignmentMetrics::outcomeToString(AlignmentOutcome outcome) {
@@ -201,12 +493,18 @@ void AlignmentMetrics::recordNegotiationEvent(const std::string& sessionId,
                                              xenocomm::core::NegotiationState state,
                                              std::chrono::milliseconds duration,
                                              bool success) {
-    std::lock_guard<std::mutex> lock(metricsMutex_);
+    const auto now = std::chrono::system_clock::now();
+    EventRecord record{now.time_since_epoch().count(), duration.count(), 0, EventKind::Negotiation, success, nullptr};
+    if (!shouldSampleMetric(sessionId)) {
+        aggregator_->ingest(record);
+        return;
+    }
+
     // Metric: negotiation outcome (success/failure)
     MetricData outcomeMetric;
     outcomeMetric.metricId = generateMetricId();
     outcomeMetric.category = "negotiation.outcome";
-    outcomeMetric.timestamp = std::chrono::system_clock::now();
+    outcomeMetric.timestamp = now;
     outcomeMetric.value = success ? 1.0 : 0.0;
     outcomeMetric.sessionId = sessionId;
     outcomeMetric.labels = {
@@ -229,19 +527,8 @@ void AlignmentMetrics::recordNegotiationEvent(const std::string& sessionId,
     durationMetric.labels["encryption_algorithm"] = std::to_string(static_cast<int>(params.encryptionAlgorithm));
     durationMetric.labels["compression_algorithm"] = std::to_string(static_cast<int>(params.compressionAlgorithm));
 
-    // Store metrics in memory
-    inMemoryMetrics_.push_back(outcomeMetric);
-    inMemoryMetrics_.push_back(durationMetric);
-
-    // Store metrics in persistent storage
-    persistMetrics(outcomeMetric);
-    persistMetrics(durationMetric);
-
-    // Update feedback loop if available
-    if (feedbackLoop_) {
-        updateFeedbackLoop(outcomeMetric);
-        updateFeedbackLoop(durationMetric);
-    }
+    record.details = new std::vector<MetricData>{std::move(outcomeMetric), std::move(durationMetric)};
+    aggregator_->ingest(record);
 }
 
 // TODO: Implement other methods
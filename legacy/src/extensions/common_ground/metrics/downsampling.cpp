@@ -0,0 +1,131 @@
+#include "xenocomm/extensions/common_ground/metrics/downsampling.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace xenocomm {
+namespace extensions {
+namespace common_ground {
+namespace metrics {
+
+namespace {
+
+// Seconds from origin, so triangle areas stay in a sane range whatever the clock's tick
+double secondsSince(const TimeSeriesPoint& point, const TimeSeriesPoint& origin) {
+    return std::chrono::duration<double>(point.timestamp - origin.timestamp).count();
+}
+
+} // namespace
+
+std::vector<TimeSeriesPoint> lttb(const std::vector<TimeSeriesPoint>& series, size_t threshold) {
+    const size_t n = series.size();
+    if (threshold >= n || threshold < 3) {
+        return series;
+    }
+
+    std::vector<TimeSeriesPoint> sampled;
+    sampled.reserve(threshold);
+    sampled.push_back(series.front());
+
+    const TimeSeriesPoint& origin = series.front();
+    // Buckets between the fixed first and last points
+    const double bucketSize = static_cast<double>(n - 2) / static_cast<double>(threshold - 2);
+    size_t kept = 0;
+    for (size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+        const size_t begin = static_cast<size_t>(std::floor(bucket * bucketSize)) + 1;
+        const size_t end = std::min(static_cast<size_t>(std::floor((bucket + 1) * bucketSize)) + 1, n - 1);
+
+        // The next bucket's average, or the last point for the final bucket
+        const size_t nextBegin = end;
+        const size_t nextEnd = std::min(static_cast<size_t>(std::floor((bucket + 2) * bucketSize)) + 1, n);
+        double nextX = 0;
+        double nextY = 0;
+        for (size_t i = nextBegin; i < nextEnd; ++i) {
+            nextX += secondsSince(series[i], origin);
+            nextY += series[i].value;
+        }
+        const double nextCount = static_cast<double>(std::max<size_t>(nextEnd - nextBegin, 1));
+        nextX /= nextCount;
+        nextY /= nextCount;
+
+        const double keptX = secondsSince(series[kept], origin);
+        const double keptY = series[kept].value;
+        double largest = -1;
+        size_t chosen = begin;
+        for (size_t i = begin; i < end; ++i) {
+            // Twice the triangle's area; the factor does not change which is largest
+            const double area = std::abs((keptX - nextX) * (series[i].value - keptY) -
+                                         (keptX - secondsSince(series[i], origin)) * (nextY - keptY));
+            if (area > largest) {
+                largest = area;
+                chosen = i;
+            }
+        }
+        sampled.push_back(series[chosen]);
+        kept = chosen;
+    }
+
+    sampled.push_back(series.back());
+    return sampled;
+}
+
+std::vector<TimeSeriesPoint> minMaxPerBucket(const std::vector<TimeSeriesPoint>& series, size_t buckets) {
+    if (buckets == 0 || series.size() <= 2 * buckets) {
+        return series;
+    }
+    const auto first = series.front().timestamp;
+    const double span = std::chrono::duration<double>(series.back().timestamp - first).count();
+
+    std::vector<TimeSeriesPoint> sampled;
+    sampled.reserve(2 * buckets);
+    size_t i = 0;
+    while (i < series.size()) {
+        const double offset = std::chrono::duration<double>(series[i].timestamp - first).count();
+        const size_t bucket = span > 0 ? std::min(static_cast<size_t>(offset / span * buckets), buckets - 1) : 0;
+        size_t lowest = i;
+        size_t highest = i;
+        size_t j = i + 1;
+        for (; j < series.size(); ++j) {
+            const double next = std::chrono::duration<double>(series[j].timestamp - first).count();
+            const size_t nextBucket = span > 0 ? std::min(static_cast<size_t>(next / span * buckets), buckets - 1) : 0;
+            if (nextBucket != bucket) {
+                break;
+            }
+            if (series[j].value < series[lowest].value) {
+                lowest = j;
+            }
+            if (series[j].value > series[highest].value) {
+                highest = j;
+            }
+        }
+        sampled.push_back(series[std::min(lowest, highest)]);
+        if (lowest != highest) {
+            sampled.push_back(series[std::max(lowest, highest)]);
+        }
+        i = j;
+    }
+    return sampled;
+}
+
+std::vector<TimeSeriesPoint> downsample(const std::vector<TimeSeriesPoint>& series, size_t points,
+                                        DownsampleMethod method) {
+    if (points == 0) {
+        return series;
+    }
+    return method == DownsampleMethod::LTTB ? lttb(series, points) : minMaxPerBucket(series, std::max<size_t>(points / 2, 1));
+}
+
+AlignmentTrends downsample(const AlignmentTrends& trends, size_t points, DownsampleMethod method) {
+    AlignmentTrends reduced;
+    reduced.successRate = downsample(trends.successRate, points, method);
+    reduced.convergenceTime = downsample(trends.convergenceTime, points, method);
+    reduced.resourceUtilization = downsample(trends.resourceUtilization, points, method);
+    for (const auto& [strategy, series] : trends.strategyPerformance) {
+        reduced.strategyPerformance[strategy] = downsample(series, points, method);
+    }
+    return reduced;
+}
+
+} // namespace metrics
+} // namespace common_ground
+} // namespace extensions
+} // namespace xenocomm
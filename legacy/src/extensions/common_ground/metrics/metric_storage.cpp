@@ -1,38 +1,527 @@
 #include "xenocomm/extensions/common_ground/metrics/metric_storage.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
 #include <mutex>
+#include <set>
+#include <unordered_map>
 
 namespace xenocomm {
 namespace extensions {
 namespace common_ground {
 namespace metrics {
 
+namespace {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+constexpr const char* STRATEGY_LABEL = "strategy_id";
+constexpr const char* SPILL_PREFIX = "metrics_";
+constexpr const char* SPILL_EXTENSION = ".jsonl";
+// Latest cursor handed out, so one taken before a restart still reads as past
+constexpr const char* CURSOR_FILE = "metrics.cursor";
+
+std::string trim(const std::string& s) {
+    auto begin = s.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    auto end = s.find_last_not_of(" \t");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool inRange(const TimeRange& range, TimePoint t) {
+    return (!range.start || t >= *range.start) && (!range.end || t <= *range.end);
+}
+
+// Checks everything but the time range, which callers test only where a partition straddles it
+bool matches(const MetricQuery& query, const MetricData& data) {
+    if (query.category && data.category != *query.category) {
+        return false;
+    }
+    if (query.strategyId) {
+        auto it = data.labels.find(STRATEGY_LABEL);
+        if (it == data.labels.end() || it->second != *query.strategyId) {
+            return false;
+        }
+    }
+    for (const auto& [key, value] : query.labels) {
+        auto it = data.labels.find(key);
+        if (it == data.labels.end() || it->second != value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+nlohmann::json toJson(const MetricData& data, uint64_t sequence) {
+    nlohmann::json j;
+    j["seq"] = sequence;
+    j["id"] = data.metricId;
+    j["category"] = data.category;
+    j["timestamp"] = static_cast<int64_t>(data.timestamp.time_since_epoch().count());
+    j["value"] = data.value;
+    j["labels"] = data.labels;
+    if (data.sessionId) {
+        j["session"] = *data.sessionId;
+    }
+    return j;
+}
+
+MetricData fromJson(const nlohmann::json& j) {
+    MetricData data;
+    data.metricId = j.at("id").get<std::string>();
+    data.category = j.at("category").get<std::string>();
+    data.timestamp = TimePoint(TimePoint::duration(j.at("timestamp").get<int64_t>()));
+    data.value = j.at("value").get<double>();
+    data.labels = j.at("labels").get<std::map<std::string, std::string>>();
+    if (j.contains("session")) {
+        data.sessionId = j.at("session").get<std::string>();
+    }
+    return data;
+}
+
+// Spills written before cursors existed read as saved before every cursor
+uint64_t sequenceFromJson(const nlohmann::json& j) {
+    return j.value("seq", uint64_t{0});
+}
+
+} // namespace
+
+MetricQuery MetricQuery::parse(const std::string& filter) {
+    MetricQuery query;
+    size_t begin = 0;
+    while (begin <= filter.size()) {
+        size_t end = filter.find(',', begin);
+        if (end == std::string::npos) {
+            end = filter.size();
+        }
+        std::string term = trim(filter.substr(begin, end - begin));
+        begin = end + 1;
+        if (term.empty()) {
+            continue;
+        }
+        auto eq = term.find('=');
+        if (eq == std::string::npos) {
+            query.category = term;
+            continue;
+        }
+        std::string key = trim(term.substr(0, eq));
+        std::string value = trim(term.substr(eq + 1));
+        if (key == "category") {
+            query.category = value;
+        } else if (key == STRATEGY_LABEL) {
+            query.strategyId = value;
+        } else {
+            query.labels[key] = value;
+        }
+    }
+    return query;
+}
+
 class MetricStorageImpl {
 public:
+    explicit MetricStorageImpl(const MetricsConfig& config)
+        : width_(std::max<int64_t>(
+              std::chrono::duration_cast<TimePoint::duration>(config.aggregationInterval).count(), 1)),
+          capacity_(std::max<size_t>(config.maxInMemoryEntries, 1)),
+          spillDirectory_(config.enablePersistence ? config.storageLocation : "") {
+        loadSpillIndex();
+    }
+
+    ~MetricStorageImpl() {
+        // Metrics still in memory are gone once this closes, but their cursors must not come back
+        if (spillDirectory_.empty() || lastSequence_ == 0) {
+            return;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(spillDirectory_, error);
+        std::ofstream out(std::filesystem::path(spillDirectory_) / CURSOR_FILE, std::ios::trunc);
+        out << lastSequence_ << '\n';
+    }
+
     void saveMetric(const MetricData& data) {
         std::lock_guard<std::mutex> lock(mutex_);
-        metrics_.push_back(data);
+        partitions_[partitionOf(data.timestamp)].add(data, ++lastSequence_);
+        ++size_;
+        enforceCapacity();
+    }
+
+    size_t forEach(const MetricQuery& query, const std::function<void(const MetricData&)>& visit) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t visited = 0;
+        auto emit = [&](const MetricData& data, uint64_t) {
+            visit(data);
+            ++visited;
+            return query.limit == 0 || visited < query.limit;
+        };
+        traverse(query, emit);
+        return visited;
+    }
+
+    MetricPage page(const MetricQuery& query) const {
+        std::vector<std::pair<uint64_t, MetricData>> matches;
+        MetricPage page;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto collect = [&matches](const MetricData& data, uint64_t sequence) {
+                matches.emplace_back(sequence, data);
+                return true;
+            };
+            traverse(query, collect);
+            page.cursor = std::max(query.since, lastSequence_);
+        }
+        // Partitions are walked in time order; a page is in the order metrics were saved
+        std::sort(matches.begin(), matches.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        if (query.limit != 0 && matches.size() > query.limit) {
+            matches.resize(query.limit);
+            page.cursor = matches.back().first;
+        }
+        page.metrics.reserve(matches.size());
+        for (auto& match : matches) {
+            page.metrics.push_back(std::move(match.second));
+        }
+        return page;
+    }
+
+    // Walks matches partition by partition in time order until emit returns false; caller holds mutex_
+    template <typename Emit>
+    void traverse(const MetricQuery& query, Emit& emit) const {
+        // A key can be both spilled and in memory when metrics arrive late, so walk the union
+        std::set<int64_t> keys;
+        auto [firstKey, lastKey] = keyBounds(query.range);
+        for (auto it = partitions_.lower_bound(firstKey); it != partitions_.end() && it->first <= lastKey; ++it) {
+            keys.insert(it->first);
+        }
+        for (auto it = spilled_.lower_bound(firstKey); it != spilled_.end() && it->first <= lastKey; ++it) {
+            keys.insert(it->first);
+        }
+
+        for (int64_t key : keys) {
+            auto spill = spilled_.find(key);
+            if (spill != spilled_.end() && !scanSpill(spill->second, query, emit)) {
+                break;
+            }
+            auto partition = partitions_.find(key);
+            if (partition != partitions_.end() && !partition->second.scan(query, emit)) {
+                break;
+            }
+        }
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
     }
-    std::vector<MetricData> loadMetrics(const std::string& /*filter*/ = "") const {
+
+    size_t spilledCount() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return metrics_;
+        size_t count = 0;
+        for (const auto& [key, spill] : spilled_) {
+            count += spill.count;
+        }
+        return count;
     }
+
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
-        metrics_.clear();
+        partitions_.clear();
+        size_ = 0;
+        for (const auto& [key, spill] : spilled_) {
+            std::error_code ignored;
+            std::filesystem::remove(spill.path, ignored);
+        }
+        spilled_.clear();
+        // Cursors carry on from lastSequence_; the destructor writes it back
+        if (!spillDirectory_.empty()) {
+            std::error_code ignored;
+            std::filesystem::remove(std::filesystem::path(spillDirectory_) / CURSOR_FILE, ignored);
+        }
     }
+
 private:
+    struct Partition {
+        std::vector<MetricData> records;
+        std::vector<uint64_t> sequences;  // Cursor of each record
+        std::unordered_map<std::string, std::vector<uint32_t>> byCategory;
+        std::unordered_map<std::string, std::vector<uint32_t>> byStrategy;
+        TimePoint minTime = TimePoint::max();
+        TimePoint maxTime = TimePoint::min();
+        uint64_t lastSequence = 0;
+
+        void add(const MetricData& data, uint64_t sequence) {
+            auto row = static_cast<uint32_t>(records.size());
+            records.push_back(data);
+            sequences.push_back(sequence);
+            lastSequence = std::max(lastSequence, sequence);
+            byCategory[data.category].push_back(row);
+            auto strategy = data.labels.find(STRATEGY_LABEL);
+            if (strategy != data.labels.end()) {
+                byStrategy[strategy->second].push_back(row);
+            }
+            minTime = std::min(minTime, data.timestamp);
+            maxTime = std::max(maxTime, data.timestamp);
+        }
+
+        // Visits matches through the narrowest index; false once emit asks to stop
+        template <typename Emit>
+        bool scan(const MetricQuery& query, Emit& emit) const {
+            if (lastSequence <= query.since) {
+                return true;
+            }
+            if (query.range.start && maxTime < *query.range.start) {
+                return true;
+            }
+            if (query.range.end && minTime > *query.range.end) {
+                return true;
+            }
+            const bool checkTime = (query.range.start && minTime < *query.range.start) ||
+                                   (query.range.end && maxTime > *query.range.end);
+            auto visitRow = [&](uint32_t row) {
+                const MetricData& data = records[row];
+                if (sequences[row] <= query.since || (checkTime && !inRange(query.range, data.timestamp)) ||
+                    !matches(query, data)) {
+                    return true;
+                }
+                return emit(data, sequences[row]);
+            };
+
+            const std::vector<uint32_t>* rows = nullptr;
+            if (query.strategyId) {
+                auto it = byStrategy.find(*query.strategyId);
+                if (it == byStrategy.end()) {
+                    return true;
+                }
+                rows = &it->second;
+            }
+            if (query.category) {
+                auto it = byCategory.find(*query.category);
+                if (it == byCategory.end()) {
+                    return true;
+                }
+                if (!rows || it->second.size() < rows->size()) {
+                    rows = &it->second;
+                }
+            }
+            if (rows) {
+                for (uint32_t row : *rows) {
+                    if (!visitRow(row)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            for (uint32_t row = 0; row < records.size(); ++row) {
+                if (!visitRow(row)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // What is known about a spilled partition without reading it
+    struct Spill {
+        std::string path;
+        size_t count = 0;
+        TimePoint minTime = TimePoint::max();
+        TimePoint maxTime = TimePoint::min();
+        std::set<std::string> categories;
+        std::set<std::string> strategies;
+        uint64_t lastSequence = 0;
+
+        void note(const MetricData& data, uint64_t sequence) {
+            ++count;
+            lastSequence = std::max(lastSequence, sequence);
+            minTime = std::min(minTime, data.timestamp);
+            maxTime = std::max(maxTime, data.timestamp);
+            categories.insert(data.category);
+            auto strategy = data.labels.find(STRATEGY_LABEL);
+            if (strategy != data.labels.end()) {
+                strategies.insert(strategy->second);
+            }
+        }
+    };
+
+    int64_t partitionOf(TimePoint t) const {
+        int64_t ticks = t.time_since_epoch().count();
+        // Floor division, so timestamps before the epoch still group by interval
+        return ticks >= 0 ? ticks / width_ : -((-ticks + width_ - 1) / width_);
+    }
+
+    std::pair<int64_t, int64_t> keyBounds(const TimeRange& range) const {
+        return {range.start ? partitionOf(*range.start) : INT64_MIN,
+                range.end ? partitionOf(*range.end) : INT64_MAX};
+    }
+
+    void enforceCapacity() {
+        while (size_ > capacity_ && !partitions_.empty()) {
+            auto oldest = partitions_.begin();
+            if (partitions_.size() == 1) {
+                // One busy interval outgrew the bound: give up its older half rather than all of it
+                trimPartition(oldest->first, oldest->second);
+                return;
+            }
+            size_ -= oldest->second.records.size();
+            evict(oldest->first, oldest->second, 0, oldest->second.records.size());
+            partitions_.erase(oldest);
+        }
+    }
+
+    void trimPartition(int64_t key, Partition& partition) {
+        size_t drop = std::max<size_t>(partition.records.size() / 2, size_ - capacity_);
+        drop = std::min(drop, partition.records.size());
+        evict(key, partition, 0, drop);
+        Partition kept;
+        for (size_t row = drop; row < partition.records.size(); ++row) {
+            kept.add(partition.records[row], partition.sequences[row]);
+        }
+        partition = std::move(kept);
+        size_ -= drop;
+    }
+
+    // Spills rows [begin, end) of partition
+    void evict(int64_t key, const Partition& partition, size_t begin, size_t end) {
+        if (spillDirectory_.empty() || begin == end) {
+            return;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(spillDirectory_, error);
+        Spill& spill = spilled_[key];
+        if (spill.path.empty()) {
+            spill.path = (std::filesystem::path(spillDirectory_) /
+                          (SPILL_PREFIX + std::to_string(key) + SPILL_EXTENSION)).string();
+        }
+        std::ofstream out(spill.path, std::ios::app);
+        for (size_t row = begin; row < end; ++row) {
+            out << toJson(partition.records[row], partition.sequences[row]).dump() << '\n';
+            spill.note(partition.records[row], partition.sequences[row]);
+        }
+        out.flush();
+        if (!out) {
+            std::cerr << "[MetricStorage] Failed to spill " << (end - begin) << " metrics to '"
+                      << spill.path << "'" << std::endl;
+        }
+    }
+
+    template <typename Emit>
+    bool scanSpill(const Spill& spill, const MetricQuery& query, Emit& emit) const {
+        if (spill.lastSequence <= query.since ||
+            (query.range.start && spill.maxTime < *query.range.start) ||
+            (query.range.end && spill.minTime > *query.range.end) ||
+            (query.category && spill.categories.count(*query.category) == 0) ||
+            (query.strategyId && spill.strategies.count(*query.strategyId) == 0)) {
+            return true;
+        }
+        std::ifstream in(spill.path);
+        std::string line;
+        while (std::getline(in, line)) {
+            auto j = nlohmann::json::parse(line, nullptr, false);
+            if (j.is_discarded()) {
+                continue;
+            }
+            MetricData data;
+            uint64_t sequence;
+            try {
+                data = fromJson(j);
+                sequence = sequenceFromJson(j);
+            } catch (const nlohmann::json::exception&) {
+                continue;
+            }
+            if (sequence > query.since && inRange(query.range, data.timestamp) && matches(query, data) &&
+                !emit(data, sequence)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Rebuilds the index of partitions a previous instance spilled
+    void loadSpillIndex() {
+        std::error_code error;
+        if (spillDirectory_.empty() || !std::filesystem::is_directory(spillDirectory_, error)) {
+            return;
+        }
+        std::ifstream cursor(std::filesystem::path(spillDirectory_) / CURSOR_FILE);
+        cursor >> lastSequence_;
+        const std::string prefix = SPILL_PREFIX;
+        const std::string extension = SPILL_EXTENSION;
+        for (const auto& entry : std::filesystem::directory_iterator(spillDirectory_, error)) {
+            std::string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() + extension.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+                continue;
+            }
+            int64_t key;
+            try {
+                key = std::stoll(name.substr(prefix.size(), name.size() - prefix.size() - extension.size()));
+            } catch (const std::exception&) {
+                continue;
+            }
+            Spill spill;
+            spill.path = entry.path().string();
+            std::ifstream in(spill.path);
+            std::string line;
+            while (std::getline(in, line)) {
+                auto j = nlohmann::json::parse(line, nullptr, false);
+                if (j.is_discarded()) {
+                    continue;
+                }
+                try {
+                    spill.note(fromJson(j), sequenceFromJson(j));
+                } catch (const nlohmann::json::exception&) {
+                }
+            }
+            // New metrics continue after the cursors this store handed out before
+            lastSequence_ = std::max(lastSequence_, spill.lastSequence);
+            spilled_[key] = std::move(spill);
+        }
+    }
+
+    const int64_t width_;  // Partition width in clock ticks
+    const size_t capacity_;
+    const std::string spillDirectory_;  // Empty when evicted metrics are dropped
     mutable std::mutex mutex_;
-    std::vector<MetricData> metrics_;
+    std::map<int64_t, Partition> partitions_;
+    std::map<int64_t, Spill> spilled_;
+    size_t size_ = 0;
+    uint64_t lastSequence_ = 0;  // Cursor of the latest saved metric
 };
 
-MetricStorage::MetricStorage() : impl_(std::make_unique<MetricStorageImpl>()) {}
+MetricStorage::MetricStorage() : MetricStorage([] {
+    MetricsConfig config;
+    config.enablePersistence = false;
+    return config;
+}()) {}
+MetricStorage::MetricStorage(const MetricsConfig& config) : impl_(std::make_unique<MetricStorageImpl>(config)) {}
 MetricStorage::~MetricStorage() = default;
 
 void MetricStorage::saveMetric(const MetricData& data) {
     impl_->saveMetric(data);
 }
 std::vector<MetricData> MetricStorage::loadMetrics(const std::string& filter) const {
-    return impl_->loadMetrics(filter);
+    return query(MetricQuery::parse(filter));
+}
+std::vector<MetricData> MetricStorage::query(const MetricQuery& query) const {
+    std::vector<MetricData> result;
+    impl_->forEach(query, [&result](const MetricData& data) { result.push_back(data); });
+    return result;
+}
+MetricPage MetricStorage::page(const MetricQuery& query) const {
+    return impl_->page(query);
+}
+size_t MetricStorage::forEach(const MetricQuery& query, const std::function<void(const MetricData&)>& visit) const {
+    return impl_->forEach(query, visit);
+}
+size_t MetricStorage::size() const {
+    return impl_->size();
+}
+size_t MetricStorage::spilledCount() const {
+    return impl_->spilledCount();
 }
 void MetricStorage::clear() {
     impl_->clear();
@@ -1,4 +1,5 @@
 #include "xenocomm/extensions/common_ground/metrics/visualization.hpp"
+#include "xenocomm/extensions/common_ground/metrics/downsampling.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -22,8 +23,11 @@ static std::string truncateString(const std::string& str, size_t maxLength) {
 }
 
 // Helper to render a time series as an ASCII plot
-static std::string renderTimeSeries(const std::vector<AlignmentTrends::TimeSeriesPoint>& series, const std::string& label, double minValue, double maxValue, int height = 10) {
-    if (series.empty()) return "  No data available\n";
+static std::string renderTimeSeries(const std::vector<AlignmentTrends::TimeSeriesPoint>& fullSeries, const std::string& label, double minValue, double maxValue, int height = 10) {
+    if (fullSeries.empty()) return "  No data available\n";
+    int width = 40;
+    // Keep each column's lowest and highest point: spikes survive, and a long range costs one pass
+    const auto series = minMaxPerBucket(fullSeries, width);
     // Find min/max time
     auto minTime = std::min_element(series.begin(), series.end(), [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; })->timestamp;
     auto maxTime = std::max_element(series.begin(), series.end(), [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; })->timestamp;
@@ -41,7 +45,6 @@ static std::string renderTimeSeries(const std::vector<AlignmentTrends::TimeSerie
             maxValue += range * 0.1;
         }
     }
-    int width = 40;
     std::vector<std::string> plot(height + 1);
     for (int i = 0; i <= height; ++i) {
         double value = maxValue - i * (maxValue - minValue) / height;
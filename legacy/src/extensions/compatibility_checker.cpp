@@ -1,21 +1,21 @@
 #include "xenocomm/extensions/compatibility_checker.hpp"
 #include <algorithm>
+#include <future>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 namespace xenocomm {
 namespace extensions {
 
-CompatibilityChecker::CompatibilityChecker() {
-    // Initialize default configuration
-    config_ = {
-        {"version_check", true},
-        {"message_format_check", true},
-        {"state_transition_check", true},
-        {"min_version_gap", 1},
-        {"max_version_gap", 3}
-    };
-}
+namespace {
+
+// Rows shorter than this are cheaper to check on the calling thread
+constexpr size_t PARALLEL_ROW_THRESHOLD = 64;
+
+} // namespace
+
+CompatibilityChecker::CompatibilityChecker() = default;
 
 CompatibilityChecker::CompatibilityResult CompatibilityChecker::checkCompatibility(
     const ProtocolVariant& newVariant,
@@ -26,8 +26,7 @@ CompatibilityChecker::CompatibilityResult CompatibilityChecker::checkCompatibili
     // Check compatibility with each active variant
     for (const auto& activeVariant : activeVariants) {
         // Check version compatibility
-        if (config_["version_check"].get<bool>() && 
-            !checkVersionCompatibility(newVariant, activeVariant)) {
+        if (rules_.versionCheck && !checkVersionCompatibility(newVariant, activeVariant)) {
             result.isCompatible = false;
             result.conflicts.push_back(
                 "Version incompatibility between " + newVariant.getId() + 
@@ -36,8 +35,7 @@ CompatibilityChecker::CompatibilityResult CompatibilityChecker::checkCompatibili
         }
 
         // Check message format compatibility
-        if (config_["message_format_check"].get<bool>() && 
-            !checkMessageFormatCompatibility(newVariant, activeVariant)) {
+        if (rules_.messageFormatCheck && !checkMessageFormatCompatibility(newVariant, activeVariant)) {
             result.isCompatible = false;
             result.conflicts.push_back(
                 "Message format incompatibility between " + newVariant.getId() + 
@@ -46,8 +44,7 @@ CompatibilityChecker::CompatibilityResult CompatibilityChecker::checkCompatibili
         }
 
         // Check state transition compatibility
-        if (config_["state_transition_check"].get<bool>() && 
-            !checkStateTransitionCompatibility(newVariant, activeVariant)) {
+        if (rules_.stateTransitionCheck && !checkStateTransitionCompatibility(newVariant, activeVariant)) {
             result.isCompatible = false;
             result.conflicts.push_back(
                 "State transition incompatibility between " + newVariant.getId() + 
@@ -55,8 +52,11 @@ CompatibilityChecker::CompatibilityResult CompatibilityChecker::checkCompatibili
             );
         }
 
-        // Find additional conflicts
+        // Find additional conflicts; conflicting changes cannot coexist either
         auto conflicts = findConflicts(newVariant, activeVariant);
+        if (!conflicts.empty()) {
+            result.isCompatible = false;
+        }
         result.conflicts.insert(
             result.conflicts.end(),
             conflicts.begin(),
@@ -78,14 +78,11 @@ CompatibilityChecker::CompatibilityResult CompatibilityChecker::checkCompatibili
 bool CompatibilityChecker::validateVariantSet(
     const std::vector<ProtocolVariant>& variants
 ) {
-    // Check each pair of variants for compatibility
-    for (size_t i = 0; i < variants.size(); ++i) {
-        for (size_t j = i + 1; j < variants.size(); ++j) {
-            std::vector<ProtocolVariant> others = {variants[j]};
-            auto result = checkCompatibility(variants[i], others);
-            if (!result.isCompatible) {
-                return false;
-            }
+    // Check each pair of variants for compatibility, a row at a time
+    for (size_t i = 0; i + 1 < variants.size(); ++i) {
+        auto row = evaluateRow(variants[i], variants.data() + i + 1, variants.size() - i - 1);
+        if (std::find(row.begin(), row.end(), 0) != row.end()) {
+            return false;
         }
     }
     return true;
@@ -94,26 +91,163 @@ bool CompatibilityChecker::validateVariantSet(
 void CompatibilityChecker::configure(const nlohmann::json& config) {
     // Validate and merge configuration
     if (config.contains("version_check")) {
-        config_["version_check"] = config["version_check"];
+        rules_.versionCheck = config["version_check"].get<bool>();
     }
     if (config.contains("message_format_check")) {
-        config_["message_format_check"] = config["message_format_check"];
+        rules_.messageFormatCheck = config["message_format_check"].get<bool>();
     }
     if (config.contains("state_transition_check")) {
-        config_["state_transition_check"] = config["state_transition_check"];
+        rules_.stateTransitionCheck = config["state_transition_check"].get<bool>();
     }
     if (config.contains("min_version_gap")) {
-        config_["min_version_gap"] = config["min_version_gap"];
+        rules_.minVersionGap = config["min_version_gap"].get<int>();
     }
     if (config.contains("max_version_gap")) {
-        config_["max_version_gap"] = config["max_version_gap"];
+        rules_.maxVersionGap = config["max_version_gap"].get<int>();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rebuildMatrix();
+}
+
+bool CompatibilityChecker::addVariant(const ProtocolVariant& variant) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = trackedIndex_.find(variant.getId());
+    if (existing != trackedIndex_.end()) {
+        removeTracked(existing->second);
+    }
+
+    // Only the new row is checked; every other column gains one entry
+    auto row = evaluateRow(variant, tracked_.data(), tracked_.size());
+    const auto failures = static_cast<size_t>(std::count(row.begin(), row.end(), 0));
+    for (size_t i = 0; i < tracked_.size(); ++i) {
+        compatible_[i].push_back(row[i]);
     }
+    row.push_back(1);
+    compatible_.push_back(std::move(row));
+    trackedIndex_[variant.getId()] = tracked_.size();
+    tracked_.push_back(variant);
+    incompatiblePairs_ += failures;
+    return failures == 0;
+}
+
+bool CompatibilityChecker::retireVariant(const std::string& variantId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = trackedIndex_.find(variantId);
+    if (it == trackedIndex_.end()) {
+        return false;
+    }
+    removeTracked(it->second);
+    return true;
+}
+
+bool CompatibilityChecker::isTrackedSetCompatible() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return incompatiblePairs_ == 0;
+}
+
+size_t CompatibilityChecker::incompatiblePairCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return incompatiblePairs_;
+}
+
+size_t CompatibilityChecker::trackedVariantCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tracked_.size();
+}
+
+void CompatibilityChecker::removeTracked(size_t index) {
+    auto& row = compatible_[index];
+    incompatiblePairs_ -= static_cast<size_t>(std::count(row.begin(), row.end(), 0));
+
+    // The last variant moves into the freed slot, in its row and in every column
+    const size_t last = tracked_.size() - 1;
+    for (auto& other : compatible_) {
+        other[index] = other[last];
+        other.pop_back();
+    }
+    trackedIndex_.erase(tracked_[index].getId());
+    if (index < last) {
+        compatible_[index] = std::move(compatible_[last]);
+        tracked_[index] = std::move(tracked_[last]);
+        trackedIndex_[tracked_[index].getId()] = index;
+    }
+    compatible_.pop_back();
+    tracked_.pop_back();
+}
+
+void CompatibilityChecker::rebuildMatrix() {
+    // Each variant is checked against those tracked before it, as when it was added
+    incompatiblePairs_ = 0;
+    for (size_t i = 0; i < tracked_.size(); ++i) {
+        auto row = evaluateRow(tracked_[i], tracked_.data(), i);
+        for (size_t j = 0; j < i; ++j) {
+            compatible_[i][j] = row[j];
+            compatible_[j][i] = row[j];
+            incompatiblePairs_ += row[j] == 0 ? 1 : 0;
+        }
+    }
+}
+
+bool CompatibilityChecker::isPairCompatible(
+    const ProtocolVariant& v1,
+    const ProtocolVariant& v2
+) const {
+    if (rules_.versionCheck && !checkVersionCompatibility(v1, v2)) {
+        return false;
+    }
+    if (rules_.messageFormatCheck && !checkMessageFormatCompatibility(v1, v2)) {
+        return false;
+    }
+    if (rules_.stateTransitionCheck && !checkStateTransitionCompatibility(v1, v2)) {
+        return false;
+    }
+    for (const auto& change1 : v1.getChanges()) {
+        for (const auto& change2 : v2.getChanges()) {
+            if (change1.conflictsWith(change2)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<uint8_t> CompatibilityChecker::evaluateRow(
+    const ProtocolVariant& variant,
+    const ProtocolVariant* others,
+    size_t count
+) const {
+    std::vector<uint8_t> row(count);
+    auto evaluate = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            row[i] = isPairCompatible(variant, others[i]) ? 1 : 0;
+        }
+    };
+
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const size_t workers = std::min(hardware, std::max<size_t>(1, count / PARALLEL_ROW_THRESHOLD));
+    if (workers == 1) {
+        evaluate(0, count);
+        return row;
+    }
+
+    // Each worker writes its own slice of the row; this thread takes the last one
+    const size_t slice = (count + workers - 1) / workers;
+    std::vector<std::future<void>> pending;
+    for (size_t begin = 0; begin + slice < count; begin += slice) {
+        pending.push_back(std::async(std::launch::async, evaluate, begin, begin + slice));
+    }
+    evaluate(pending.size() * slice, count);
+    for (auto& future : pending) {
+        future.get();
+    }
+    return row;
 }
 
 bool CompatibilityChecker::checkMessageFormatCompatibility(
     const ProtocolVariant& v1,
     const ProtocolVariant& v2
-) {
+) const {
     // Get message formats from both variants
     const auto& format1 = v1.getMessageFormat();
     const auto& format2 = v2.getMessageFormat();
@@ -126,7 +260,7 @@ bool CompatibilityChecker::checkMessageFormatCompatibility(
 bool CompatibilityChecker::checkStateTransitionCompatibility(
     const ProtocolVariant& v1,
     const ProtocolVariant& v2
-) {
+) const {
     // Get state transition rules from both variants
     const auto& transitions1 = v1.getStateTransitions();
     const auto& transitions2 = v2.getStateTransitions();
@@ -139,7 +273,7 @@ bool CompatibilityChecker::checkStateTransitionCompatibility(
 bool CompatibilityChecker::checkVersionCompatibility(
     const ProtocolVariant& v1,
     const ProtocolVariant& v2
-) {
+) const {
     // Get version information
     auto version1 = v1.getVersion();
     auto version2 = v2.getVersion();
@@ -148,14 +282,13 @@ bool CompatibilityChecker::checkVersionCompatibility(
     int versionGap = std::abs(version1 - version2);
 
     // Check if version gap is within acceptable range
-    return versionGap >= config_["min_version_gap"].get<int>() &&
-           versionGap <= config_["max_version_gap"].get<int>();
+    return versionGap >= rules_.minVersionGap && versionGap <= rules_.maxVersionGap;
 }
 
 std::vector<std::string> CompatibilityChecker::findConflicts(
     const ProtocolVariant& v1,
     const ProtocolVariant& v2
-) {
+) const {
     std::vector<std::string> conflicts;
 
     // Check for conflicting changes in protocol behavior
@@ -180,7 +313,7 @@ std::vector<std::string> CompatibilityChecker::findConflicts(
 std::vector<std::string> CompatibilityChecker::findWarnings(
     const ProtocolVariant& v1,
     const ProtocolVariant& v2
-) {
+) const {
     std::vector<std::string> warnings;
 
     // Check for potential issues that don't prevent compatibility
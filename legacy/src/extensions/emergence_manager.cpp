@@ -10,11 +10,87 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
+#include <limits>
 #include <sys/stat.h>
 
 namespace xenocomm {
 namespace extensions {
 
+namespace {
+
+// IDs of the built-in metrics among each variant's aggregates
+enum BuiltinMetric : size_t { SUCCESS_RATE, LATENCY_MS, RESOURCE_USAGE, THROUGHPUT, BUILTIN_METRIC_COUNT };
+constexpr const char* BUILTIN_METRIC_NAMES[BUILTIN_METRIC_COUNT] = {"successRate", "latencyMs", "resourceUsage", "throughput"};
+
+std::optional<size_t> builtinMetric(const std::string& name) {
+    for (size_t i = 0; i < BUILTIN_METRIC_COUNT; ++i) {
+        if (name == BUILTIN_METRIC_NAMES[i]) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+// Marks a ring slot whose record lacks a custom metric
+constexpr double MISSING_METRIC = std::numeric_limits<double>::quiet_NaN();
+
+constexpr const char* JOURNAL_PREFIX = "emergence_journal.";
+constexpr const char* JOURNAL_SUFFIX = ".jsonl";
+
+void checkRetention(const PerformanceRetention& retention) {
+    if (retention.maxRawRecords == 0 || retention.bucketWidth.count() <= 0 || retention.maxBuckets == 0) {
+        throw std::invalid_argument("Performance retention limits must be positive");
+    }
+}
+
+nlohmann::json retentionToJson(const PerformanceRetention& retention) {
+    return {
+        {"maxRawRecords", retention.maxRawRecords},
+        {"bucketSeconds", retention.bucketWidth.count()},
+        {"maxBuckets", retention.maxBuckets}
+    };
+}
+
+PerformanceRetention retentionFromJson(const nlohmann::json& j) {
+    PerformanceRetention retention;
+    retention.maxRawRecords = j["maxRawRecords"].get<size_t>();
+    retention.bucketWidth = std::chrono::seconds(j["bucketSeconds"].get<int64_t>());
+    retention.maxBuckets = j["maxBuckets"].get<size_t>();
+    checkRetention(retention);
+    return retention;
+}
+
+nlohmann::json recordToJson(const PerformanceRecord& record) {
+    nlohmann::json j;
+    j["timestamp"] = std::chrono::system_clock::to_time_t(record.timestamp);
+    j["metrics"] = {
+        {"successRate", record.metrics.successRate},
+        {"latencyMs", record.metrics.latencyMs},
+        {"resourceUsage", record.metrics.resourceUsage},
+        {"throughput", record.metrics.throughput},
+        {"customMetrics", record.metrics.customMetrics}
+    };
+    j["context"] = record.context;
+    j["sampleSize"] = record.sampleSize;
+    return j;
+}
+
+PerformanceRecord recordFromJson(const nlohmann::json& j) {
+    PerformanceRecord record;
+    record.timestamp = std::chrono::system_clock::from_time_t(j["timestamp"].get<time_t>());
+    record.metrics.successRate = j["metrics"]["successRate"].get<double>();
+    record.metrics.latencyMs = j["metrics"]["latencyMs"].get<double>();
+    record.metrics.resourceUsage = j["metrics"]["resourceUsage"].get<double>();
+    record.metrics.throughput = j["metrics"]["throughput"].get<double>();
+    record.metrics.customMetrics = j["metrics"]["customMetrics"].get<std::map<std::string, double>>();
+    record.context = j["context"].get<std::string>();
+    record.sampleSize = j["sampleSize"].get<size_t>();
+    return record;
+}
+
+} // namespace
+
 // Placeholder implementation
 // TODO: Implement actual emergence management functionality
 
@@ -33,9 +109,13 @@ ProtocolVariant ProtocolVariant::from_json(const nlohmann::json& j) {
 
 // ---- EmergenceManager Implementation ----
 
+EmergenceManager::EmergenceManager(const std::string& persistencePath, const nlohmann::json& evalMetrics, NoRestore)
+    : persistencePath_(persistencePath), evalMetrics_(evalMetrics),
+      eventLog_(utils::EventLog::open(persistencePath + "/emergence_manager.log")),
+      autosaveInterval_(std::chrono::seconds(300)), lastSaveTime_(std::chrono::system_clock::now()) {}
+
 EmergenceManager::EmergenceManager(const std::string& persistencePath, const nlohmann::json& evalMetrics)
-    : persistencePath_(persistencePath), evalMetrics_(evalMetrics), 
-      autosaveInterval_(std::chrono::seconds(300)), lastSaveTime_(std::chrono::system_clock::now()) {
+    : EmergenceManager(persistencePath, evalMetrics, NoRestore{}) {
     // Try to load existing state
     try {
         loadState();
@@ -44,6 +124,12 @@ EmergenceManager::EmergenceManager(const std::string& persistencePath, const nlo
     }
 }
 
+EmergenceManager::~EmergenceManager() {
+    if (compactionTask_ != utils::TaskScheduler::INVALID_TASK) {
+        utils::TaskScheduler::shared().cancel(compactionTask_);
+    }
+}
+
 void EmergenceManager::proposeVariant(const std::string& id, const ProtocolVariant& variant, const std::string& description, const nlohmann::json& metadata) {
     if (variants_.count(id) > 0) {
         throw std::invalid_argument("Variant with this ID already exists");
@@ -54,6 +140,7 @@ void EmergenceManager::proposeVariant(const std::string& id, const ProtocolVaria
     v.metadata = metadata;
     variants_[id] = v;
     statusMap_[id] = VariantStatus::Proposed;
+    journal({{"op", "variant"}, {"id", id}, {"variant", v.to_json()}, {"status", static_cast<int>(VariantStatus::Proposed)}});
     logEvent("Proposed variant: " + id + " - " + description);
     checkAutosave();
 }
@@ -84,18 +171,14 @@ void EmergenceManager::setVariantStatus(const std::string& id, VariantStatus sta
         throw std::out_of_range("Variant ID not found");
     }
     statusMap_[id] = status;
+    journal({{"op", "status"}, {"id", id}, {"status", static_cast<int>(status)}});
     logEvent("Status changed for variant: " + id + " to status " + std::to_string(static_cast<int>(status)));
     checkAutosave();
 }
 
 void EmergenceManager::logEvent(const std::string& message) const {
-    // Append timestamped message to log file
-    std::ofstream logFile(persistencePath_ + "/emergence_manager.log", std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-        logFile << std::ctime(&now_c) << ": " << message << std::endl;
-    }
+    // Queued; written in batches off the caller's thread
+    eventLog_->write(message);
 }
 
 // --- Performance Logging and Evaluation Implementation ---
@@ -105,7 +188,8 @@ void EmergenceManager::logPerformance(const std::string& variantId, const Perfor
     if (variants_.count(variantId) == 0) {
         throw std::out_of_range("Variant ID not found");
     }
-    performanceHistory_[variantId].push_back(record);
+    appendPerformance(variantId, record);
+    journal({{"op", "performance"}, {"id", variantId}, {"record", recordToJson(record)}});
     logEvent("Logged performance for variant: " + variantId);
     checkAutosave();
 }
@@ -117,11 +201,52 @@ std::vector<PerformanceRecord> EmergenceManager::getVariantPerformance(const std
     }
     auto it = performanceHistory_.find(variantId);
     if (it != performanceHistory_.end()) {
-        return it->second;
+        return retainedPerformance(it->second);
     }
     return {};
 }
 
+std::vector<PerformanceBucket> EmergenceManager::getPerformanceBuckets(const std::string& variantId) const {
+    if (variants_.count(variantId) == 0) {
+        throw std::out_of_range("Variant ID not found");
+    }
+    std::vector<PerformanceBucket> result;
+    auto it = performanceHistory_.find(variantId);
+    if (it == performanceHistory_.end()) {
+        return result;
+    }
+    for (const auto& bucket : it->second.buckets) {
+        PerformanceBucket summary;
+        summary.start = bucket.start;
+        summary.recordCount = bucket.recordCount;
+        summary.sampleSize = bucket.sampleSize;
+        for (size_t metric = 0; metric < bucket.metrics.size(); ++metric) {
+            if (bucket.metrics[metric].count > 0) {
+                summary.metrics[metricName(metric)] = summarize(bucket.metrics[metric]);
+            }
+        }
+        result.push_back(std::move(summary));
+    }
+    return result;
+}
+
+void EmergenceManager::setPerformanceRetention(const PerformanceRetention& retention) {
+    checkRetention(retention);
+    applyRetention(retention);
+    journal({{"op", "retention"}, {"retention", retentionToJson(retention)}});
+}
+
+void EmergenceManager::applyRetention(const PerformanceRetention& retention) {
+    retention_ = retention;
+    for (auto& [id, history] : performanceHistory_) {
+        trimHistory(history);
+    }
+}
+
+PerformanceRetention EmergenceManager::getPerformanceRetention() const {
+    return retention_;
+}
+
 void EmergenceManager::setEvaluationCriteria(const EvaluationCriteria& criteria) {
     evalCriteria_ = criteria;
 }
@@ -130,28 +255,255 @@ EvaluationCriteria EmergenceManager::getEvaluationCriteria() const {
     return evalCriteria_;
 }
 
+void EmergenceManager::MetricAggregate::add(double value) {
+    ++count;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+}
+
+MetricSummary EmergenceManager::summarize(const MetricAggregate& aggregate) {
+    MetricSummary summary;
+    summary.count = aggregate.count;
+    summary.mean = aggregate.mean;
+    summary.variance = aggregate.count > 1 ? aggregate.m2 / (aggregate.count - 1) : 0.0;
+    return summary;
+}
+
+std::optional<size_t> EmergenceManager::findMetric(const std::string& name) const {
+    if (auto builtin = builtinMetric(name)) {
+        return builtin;
+    }
+    auto it = customMetricIds_.find(name);
+    if (it == customMetricIds_.end()) {
+        return std::nullopt;
+    }
+    return BUILTIN_METRIC_COUNT + it->second;
+}
+
+size_t EmergenceManager::internMetric(const std::string& name) {
+    if (auto builtin = builtinMetric(name)) {
+        return *builtin;
+    }
+    auto [it, added] = customMetricIds_.emplace(name, customMetricNames_.size());
+    if (added) {
+        customMetricNames_.push_back(name);
+    }
+    return BUILTIN_METRIC_COUNT + it->second;
+}
+
+std::string EmergenceManager::metricName(size_t metric) const {
+    return metric < BUILTIN_METRIC_COUNT ? BUILTIN_METRIC_NAMES[metric] : customMetricNames_.at(metric - BUILTIN_METRIC_COUNT);
+}
+
+void EmergenceManager::appendPerformance(const std::string& variantId, const PerformanceRecord& record, bool account) {
+    auto& history = performanceHistory_[variantId];
+    RawRecord raw;
+    raw.timestamp = record.timestamp;
+    raw.builtin[SUCCESS_RATE] = record.metrics.successRate;
+    raw.builtin[LATENCY_MS] = record.metrics.latencyMs;
+    raw.builtin[RESOURCE_USAGE] = record.metrics.resourceUsage;
+    raw.builtin[THROUGHPUT] = record.metrics.throughput;
+    raw.context = record.context;
+    raw.sampleSize = record.sampleSize;
+
+    // Fill the ring, then overwrite its oldest slot once that is downsampled
+    size_t slot = history.ring.size();
+    if (slot < retention_.maxRawRecords) {
+        history.ring.push_back(std::move(raw));
+        for (auto& column : history.customColumns) {
+            column.push_back(MISSING_METRIC);
+        }
+    } else {
+        slot = history.head;
+        downsample(history, slot);
+        history.ring[slot] = std::move(raw);
+        for (auto& column : history.customColumns) {
+            column[slot] = MISSING_METRIC;
+        }
+        history.head = (history.head + 1) % history.ring.size();
+    }
+
+    auto& stats = history.stats;
+    if (account) {
+        stats.resize(std::max<size_t>(stats.size(), BUILTIN_METRIC_COUNT));
+        for (size_t metric = 0; metric < BUILTIN_METRIC_COUNT; ++metric) {
+            stats[metric].add(history.ring[slot].builtin[metric]);
+        }
+        ++history.totalRecords;
+    }
+    for (const auto& [name, value] : record.metrics.customMetrics) {
+        size_t id = internMetric(name);
+        if (id < BUILTIN_METRIC_COUNT) {
+            continue;  // The built-in field takes precedence
+        }
+        size_t column = id - BUILTIN_METRIC_COUNT;
+        if (column >= history.customColumns.size()) {
+            history.customColumns.resize(column + 1, std::vector<double>(history.ring.size(), MISSING_METRIC));
+        }
+        history.customColumns[column][slot] = value;
+        if (account) {
+            if (id >= stats.size()) {
+                stats.resize(id + 1);
+            }
+            stats[id].add(value);
+        }
+    }
+}
+
+void EmergenceManager::downsample(VariantHistory& history, size_t slot) {
+    const auto& raw = history.ring[slot];
+    const auto width = std::chrono::duration_cast<std::chrono::system_clock::duration>(retention_.bucketWidth);
+    const auto sinceEpoch = raw.timestamp.time_since_epoch();
+    const std::chrono::system_clock::time_point start(sinceEpoch - ((sinceEpoch % width) + width) % width);
+
+    // Records usually leave the ring in time order, so the bucket is normally the last one
+    auto it = history.buckets.end();
+    while (it != history.buckets.begin() && std::prev(it)->start > start) {
+        --it;
+    }
+    if (it != history.buckets.begin() && std::prev(it)->start == start) {
+        --it;
+    } else if (it == history.buckets.begin() && history.buckets.size() >= retention_.maxBuckets) {
+        return;  // Older than every bucket still kept
+    } else {
+        it = history.buckets.insert(it, HistoryBucket{});
+        it->start = start;
+    }
+
+    auto& bucket = *it;
+    ++bucket.recordCount;
+    bucket.sampleSize += raw.sampleSize;
+    bucket.metrics.resize(std::max(bucket.metrics.size(), BUILTIN_METRIC_COUNT + history.customColumns.size()));
+    for (size_t metric = 0; metric < BUILTIN_METRIC_COUNT; ++metric) {
+        bucket.metrics[metric].add(raw.builtin[metric]);
+    }
+    for (size_t column = 0; column < history.customColumns.size(); ++column) {
+        double value = history.customColumns[column][slot];
+        if (!std::isnan(value)) {
+            bucket.metrics[BUILTIN_METRIC_COUNT + column].add(value);
+        }
+    }
+    while (history.buckets.size() > retention_.maxBuckets) {
+        history.buckets.pop_front();
+    }
+}
+
+void EmergenceManager::trimHistory(VariantHistory& history) {
+    // Put the ring in oldest-first order, then downsample what no longer fits
+    std::rotate(history.ring.begin(), history.ring.begin() + history.head, history.ring.end());
+    for (auto& column : history.customColumns) {
+        std::rotate(column.begin(), column.begin() + history.head, column.end());
+    }
+    history.head = 0;
+    if (history.ring.size() > retention_.maxRawRecords) {
+        size_t excess = history.ring.size() - retention_.maxRawRecords;
+        for (size_t slot = 0; slot < excess; ++slot) {
+            downsample(history, slot);
+        }
+        history.ring.erase(history.ring.begin(), history.ring.begin() + excess);
+        for (auto& column : history.customColumns) {
+            column.erase(column.begin(), column.begin() + excess);
+        }
+    }
+    while (history.buckets.size() > retention_.maxBuckets) {
+        history.buckets.pop_front();
+    }
+}
+
+PerformanceRecord EmergenceManager::rawPerformance(const VariantHistory& history, size_t slot) const {
+    const auto& raw = history.ring[slot];
+    PerformanceRecord record;
+    record.timestamp = raw.timestamp;
+    record.metrics.successRate = raw.builtin[SUCCESS_RATE];
+    record.metrics.latencyMs = raw.builtin[LATENCY_MS];
+    record.metrics.resourceUsage = raw.builtin[RESOURCE_USAGE];
+    record.metrics.throughput = raw.builtin[THROUGHPUT];
+    for (size_t column = 0; column < history.customColumns.size(); ++column) {
+        double value = history.customColumns[column][slot];
+        if (!std::isnan(value)) {
+            record.metrics.customMetrics[customMetricNames_[column]] = value;
+        }
+    }
+    record.context = raw.context;
+    record.sampleSize = raw.sampleSize;
+    return record;
+}
+
+std::vector<PerformanceRecord> EmergenceManager::retainedPerformance(const VariantHistory& history) const {
+    std::vector<PerformanceRecord> records;
+    records.reserve(history.ring.size());
+    for (size_t i = 0; i < history.ring.size(); ++i) {
+        records.push_back(rawPerformance(history, (history.head + i) % history.ring.size()));
+    }
+    return records;
+}
+
+size_t EmergenceManager::recordCount(const std::string& variantId) const {
+    auto it = performanceHistory_.find(variantId);
+    return it == performanceHistory_.end() ? 0 : it->second.totalRecords;
+}
+
+double EmergenceManager::metricMean(const std::string& variantId, std::optional<size_t> metric) const {
+    auto it = performanceHistory_.find(variantId);
+    if (!metric || it == performanceHistory_.end() || *metric >= it->second.stats.size()) {
+        return 0.0;
+    }
+    return it->second.stats[*metric].mean;
+}
+
+std::optional<MetricSummary> EmergenceManager::getMetricSummary(const std::string& variantId, const std::string& metric) const {
+    if (variants_.count(variantId) == 0) {
+        throw std::out_of_range("Variant ID not found");
+    }
+    auto id = findMetric(metric);
+    auto it = performanceHistory_.find(variantId);
+    if (!id || it == performanceHistory_.end() || *id >= it->second.stats.size() || it->second.stats[*id].count == 0) {
+        return std::nullopt;
+    }
+    return summarize(it->second.stats[*id]);
+}
+
+nlohmann::json EmergenceManager::aggregatesToJson(const std::vector<MetricAggregate>& aggregates) const {
+    nlohmann::json metrics = nlohmann::json::object();
+    for (size_t metric = 0; metric < aggregates.size(); ++metric) {
+        const auto& aggregate = aggregates[metric];
+        if (aggregate.count > 0) {
+            metrics[metricName(metric)] = {aggregate.count, aggregate.mean, aggregate.m2};
+        }
+    }
+    return metrics;
+}
+
+std::vector<EmergenceManager::MetricAggregate> EmergenceManager::aggregatesFromJson(const nlohmann::json& metrics) {
+    std::vector<MetricAggregate> aggregates(BUILTIN_METRIC_COUNT);
+    for (const auto& [name, values] : metrics.items()) {
+        size_t id = internMetric(name);
+        if (id >= aggregates.size()) {
+            aggregates.resize(id + 1);
+        }
+        aggregates[id].count = values.at(0).get<size_t>();
+        aggregates[id].mean = values.at(1).get<double>();
+        aggregates[id].m2 = values.at(2).get<double>();
+    }
+    return aggregates;
+}
+
 std::optional<std::string> EmergenceManager::getBestPerformingVariant(const EvaluationCriteria& criteria) const {
+    // Resolve metric names once rather than per variant
+    std::vector<std::pair<std::optional<size_t>, double>> weights;
+    for (const auto& [metric, weight] : criteria.metricWeights) {
+        weights.emplace_back(findMetric(metric), weight);
+    }
+
     double bestScore = -1e9;
     std::optional<std::string> bestId;
-    for (const auto& [variantId, records] : performanceHistory_) {
-        if (records.size() < criteria.minSampleSize) continue;
+    for (const auto& [variantId, history] : performanceHistory_) {
+        if (history.totalRecords < criteria.minSampleSize) continue;
         double score = 0.0;
         double totalWeight = 0.0;
-        for (const auto& [metric, weight] : criteria.metricWeights) {
-            double avg = 0.0;
-            size_t count = 0;
-            for (const auto& rec : records) {
-                auto it = rec.metrics.customMetrics.find(metric);
-                if (metric == "successRate") avg += rec.metrics.successRate;
-                else if (metric == "latencyMs") avg += rec.metrics.latencyMs;
-                else if (metric == "resourceUsage") avg += rec.metrics.resourceUsage;
-                else if (metric == "throughput") avg += rec.metrics.throughput;
-                else if (it != rec.metrics.customMetrics.end()) avg += it->second;
-                else continue;
-                ++count;
-            }
-            if (count > 0) avg /= count;
-            score += avg * weight;
+        for (const auto& [metric, weight] : weights) {
+            score += metricMean(variantId, metric) * weight;
             totalWeight += weight;
         }
         if (totalWeight > 0) score /= totalWeight;
@@ -164,39 +516,19 @@ std::optional<std::string> EmergenceManager::getBestPerformingVariant(const Eval
 }
 
 bool EmergenceManager::isSignificantlyBetter(const std::string& variantId, const std::string& baselineId, const EvaluationCriteria& criteria) const {
-    auto variantData = getVariantPerformance(variantId);
-    auto baselineData = getVariantPerformance(baselineId);
-    if (variantData.size() < criteria.minSampleSize || baselineData.size() < criteria.minSampleSize) return false;
+    if (variants_.count(variantId) == 0 || variants_.count(baselineId) == 0) {
+        throw std::out_of_range("Variant ID not found");
+    }
+    if (recordCount(variantId) < criteria.minSampleSize || recordCount(baselineId) < criteria.minSampleSize) return false;
     double weightedImprovement = 0.0;
     double totalWeight = 0.0;
     for (const auto& [metric, weight] : criteria.metricWeights) {
-        double variantAvg = 0.0, baselineAvg = 0.0;
-        size_t vcount = 0, bcount = 0;
-        for (const auto& rec : variantData) {
-            auto it = rec.metrics.customMetrics.find(metric);
-            if (metric == "successRate") variantAvg += rec.metrics.successRate;
-            else if (metric == "latencyMs") variantAvg += rec.metrics.latencyMs;
-            else if (metric == "resourceUsage") variantAvg += rec.metrics.resourceUsage;
-            else if (metric == "throughput") variantAvg += rec.metrics.throughput;
-            else if (it != rec.metrics.customMetrics.end()) variantAvg += it->second;
-            else continue;
-            ++vcount;
-        }
-        for (const auto& rec : baselineData) {
-            auto it = rec.metrics.customMetrics.find(metric);
-            if (metric == "successRate") baselineAvg += rec.metrics.successRate;
-            else if (metric == "latencyMs") baselineAvg += rec.metrics.latencyMs;
-            else if (metric == "resourceUsage") baselineAvg += rec.metrics.resourceUsage;
-            else if (metric == "throughput") baselineAvg += rec.metrics.throughput;
-            else if (it != rec.metrics.customMetrics.end()) baselineAvg += it->second;
-            else continue;
-            ++bcount;
-        }
-        if (vcount > 0) variantAvg /= vcount;
-        if (bcount > 0) baselineAvg /= bcount;
+        auto id = findMetric(metric);
+        double variantAvg = metricMean(variantId, id);
+        double baselineAvg = metricMean(baselineId, id);
         // Higher is better for successRate/throughput, lower is better for latency/resourceUsage
         double improvement = 0.0;
-        if (metric == "latencyMs" || metric == "resourceUsage") {
+        if (id == LATENCY_MS || id == RESOURCE_USAGE) {
             improvement = (baselineAvg - variantAvg) / (baselineAvg == 0 ? 1 : baselineAvg);
         } else {
             improvement = (variantAvg - baselineAvg) / (baselineAvg == 0 ? 1 : baselineAvg);
@@ -222,18 +554,10 @@ std::string EmergenceManager::generatePerformanceReport(const std::vector<std::s
         if (variants_.count(id) == 0) {
             throw std::out_of_range("Variant ID not found: " + id);
         }
-        auto records = getVariantPerformance(id);
-        double sr = 0, lat = 0, ru = 0, thr = 0;
-        size_t n = records.size();
-        for (const auto& rec : records) {
-            sr += rec.metrics.successRate;
-            lat += rec.metrics.latencyMs;
-            ru += rec.metrics.resourceUsage;
-            thr += rec.metrics.throughput;
-        }
-        if (n > 0) {
-            sr /= n; lat /= n; ru /= n; thr /= n;
-        }
+        double sr = metricMean(id, SUCCESS_RATE);
+        double lat = metricMean(id, LATENCY_MS);
+        double ru = metricMean(id, RESOURCE_USAGE);
+        double thr = metricMean(id, THROUGHPUT);
         report << std::setw(20) << id;
         report << std::setw(15) << std::fixed << std::setprecision(2) << sr;
         report << std::setw(15) << std::fixed << std::setprecision(2) << lat;
@@ -265,23 +589,25 @@ nlohmann::json EmergenceManager::serializeState() const {
     
     // Serialize performance history
     state["performance"] = nlohmann::json::object();
-    for (const auto& [id, records] : performanceHistory_) {
+    state["performanceStats"] = nlohmann::json::object();
+    state["performanceBuckets"] = nlohmann::json::object();
+    for (const auto& [id, history] : performanceHistory_) {
         state["performance"][id] = nlohmann::json::array();
-        for (const auto& record : records) {
-            nlohmann::json j;
-            j["timestamp"] = std::chrono::system_clock::to_time_t(record.timestamp);
-            j["metrics"] = {
-                {"successRate", record.metrics.successRate},
-                {"latencyMs", record.metrics.latencyMs},
-                {"resourceUsage", record.metrics.resourceUsage},
-                {"throughput", record.metrics.throughput},
-                {"customMetrics", record.metrics.customMetrics}
-            };
-            j["context"] = record.context;
-            j["sampleSize"] = record.sampleSize;
-            state["performance"][id].push_back(j);
+        for (const auto& record : retainedPerformance(history)) {
+            state["performance"][id].push_back(recordToJson(record));
+        }
+        state["performanceStats"][id] = {{"records", history.totalRecords}, {"metrics", aggregatesToJson(history.stats)}};
+        state["performanceBuckets"][id] = nlohmann::json::array();
+        for (const auto& bucket : history.buckets) {
+            state["performanceBuckets"][id].push_back({
+                {"start", std::chrono::system_clock::to_time_t(bucket.start)},
+                {"records", bucket.recordCount},
+                {"sampleSize", bucket.sampleSize},
+                {"metrics", aggregatesToJson(bucket.metrics)}
+            });
         }
     }
+    state["performanceRetention"] = retentionToJson(retention_);
 
     // Serialize agent contexts
     state["agents"] = nlohmann::json::object();
@@ -310,14 +636,20 @@ nlohmann::json EmergenceManager::serializeState() const {
     return state;
 }
 
-void EmergenceManager::deserializeState(const nlohmann::json& state) {
-    // Clear existing state
+void EmergenceManager::clearState() {
     variants_.clear();
     statusMap_.clear();
     performanceHistory_.clear();
+    customMetricIds_.clear();
+    customMetricNames_.clear();
     agentContexts_.clear();
     variantVotes_.clear();
+    voteTallies_.clear();
     adoptionTimestamps_.clear();
+}
+
+void EmergenceManager::deserializeState(const nlohmann::json& state) {
+    clearState();
     
     // Deserialize variants
     for (const auto& [id, variant] : state["variants"].items()) {
@@ -329,22 +661,39 @@ void EmergenceManager::deserializeState(const nlohmann::json& state) {
         statusMap_[id] = static_cast<VariantStatus>(status.get<int>());
     }
     
-    // Deserialize performance history
+    // Deserialize performance history. Buckets go first as retained records
+    // may be downsampled into them; states saved before aggregates were kept
+    // have every record retained, so the aggregates are rebuilt from them.
+    if (state.contains("performanceRetention")) {
+        applyRetention(retentionFromJson(state["performanceRetention"]));
+    }
+    const auto noStats = nlohmann::json::object();
+    const auto& stats = state.contains("performanceStats") ? state["performanceStats"] : noStats;
+    if (state.contains("performanceBuckets")) {
+        for (const auto& [id, buckets] : state["performanceBuckets"].items()) {
+            auto& history = performanceHistory_[id];
+            for (const auto& j : buckets) {
+                HistoryBucket bucket;
+                bucket.start = std::chrono::system_clock::from_time_t(j["start"].get<time_t>());
+                bucket.recordCount = j["records"].get<size_t>();
+                bucket.sampleSize = j["sampleSize"].get<size_t>();
+                bucket.metrics = aggregatesFromJson(j["metrics"]);
+                history.buckets.push_back(std::move(bucket));
+            }
+        }
+    }
     for (const auto& [id, records] : state["performance"].items()) {
-        performanceHistory_[id] = std::vector<PerformanceRecord>();
+        performanceHistory_[id];
+        bool account = !stats.contains(id);
         for (const auto& j : records) {
-            PerformanceRecord record;
-            record.timestamp = std::chrono::system_clock::from_time_t(j["timestamp"].get<time_t>());
-            record.metrics.successRate = j["metrics"]["successRate"].get<double>();
-            record.metrics.latencyMs = j["metrics"]["latencyMs"].get<double>();
-            record.metrics.resourceUsage = j["metrics"]["resourceUsage"].get<double>();
-            record.metrics.throughput = j["metrics"]["throughput"].get<double>();
-            record.metrics.customMetrics = j["metrics"]["customMetrics"].get<std::map<std::string, double>>();
-            record.context = j["context"].get<std::string>();
-            record.sampleSize = j["sampleSize"].get<size_t>();
-            performanceHistory_[id].push_back(record);
+            appendPerformance(id, recordFromJson(j), account);
         }
     }
+    for (const auto& [id, j] : stats.items()) {
+        auto& history = performanceHistory_[id];
+        history.totalRecords = j["records"].get<size_t>();
+        history.stats = aggregatesFromJson(j["metrics"]);
+    }
 
     // Deserialize agent contexts
     if (state.contains("agents")) {
@@ -356,9 +705,8 @@ void EmergenceManager::deserializeState(const nlohmann::json& state) {
     // Deserialize voting records
     if (state.contains("votes")) {
         for (const auto& [variantId, votes] : state["votes"].items()) {
-            variantVotes_[variantId] = std::vector<VotingRecord>();
             for (const auto& vote : votes) {
-                variantVotes_[variantId].push_back(VotingRecord::from_json(vote));
+                recordVote(VotingRecord::from_json(vote));
             }
         }
     }
@@ -423,16 +771,23 @@ nlohmann::json EmergenceManager::readJsonFromFile(const std::string& filePath) c
 }
 
 void EmergenceManager::saveState() const {
-    std::string statePath = persistencePath_ + "/emergence_state.json";
-    writeJsonToFile(statePath, serializeState());
-    logEvent("Saved emergence manager state to " + statePath);
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    // The snapshot covers every segment written so far; later changes go to a new one
+    if (journal_.is_open()) {
+        rotateJournal();
+    }
+    uint64_t covered = journal_.is_open() ? journalSegment_ - 1 : journalSegment_;
+    writeSnapshot(covered);
+    removeJournalSegments(covered);
+    logEvent("Saved emergence manager state to " + persistencePath_ + "/emergence_state.json");
 }
 
 void EmergenceManager::loadState() {
     std::string statePath = persistencePath_ + "/emergence_state.json";
     try {
-        auto state = readJsonFromFile(statePath);
-        deserializeState(state);
+        if (!restore(std::numeric_limits<uint64_t>::max())) {
+            throw std::runtime_error("Failed to open file for reading: " + statePath);
+        }
         logEvent("Loaded emergence manager state from " + statePath);
     } catch (const std::exception& e) {
         logEvent("Failed to load state: " + std::string(e.what()));
@@ -440,6 +795,147 @@ void EmergenceManager::loadState() {
     }
 }
 
+std::optional<uint64_t> EmergenceManager::restore(uint64_t lastSegment) {
+    std::string statePath = persistencePath_ + "/emergence_state.json";
+    std::optional<uint64_t> covered;
+    struct stat info;
+    if (stat(statePath.c_str(), &info) == 0) {
+        auto state = readJsonFromFile(statePath);
+        deserializeState(state);
+        covered = state.value("journalSegment", uint64_t{0});
+    } else {
+        clearState();
+    }
+
+    // Segments the snapshot already covers may remain after a crash mid-compaction
+    for (uint64_t segment : journalSegments()) {
+        journalSegment_ = std::max(journalSegment_, segment);
+        if (segment > covered.value_or(0) && segment <= lastSegment) {
+            replayJournal(journalPath(segment));
+            covered = covered.value_or(0);
+        }
+    }
+    if (covered) {
+        journalSegment_ = std::max(journalSegment_, *covered);
+    }
+    return covered;
+}
+
+void EmergenceManager::writeSnapshot(uint64_t coveredSegment) const {
+    std::string statePath = persistencePath_ + "/emergence_state.json";
+    auto state = serializeState();
+    state["journalSegment"] = coveredSegment;
+    // Replace the snapshot atomically, so a crash never leaves a torn one
+    writeJsonToFile(statePath + ".tmp", state);
+    std::filesystem::rename(statePath + ".tmp", statePath);
+}
+
+std::string EmergenceManager::journalPath(uint64_t segment) const {
+    return persistencePath_ + "/" + JOURNAL_PREFIX + std::to_string(segment) + JOURNAL_SUFFIX;
+}
+
+std::vector<uint64_t> EmergenceManager::journalSegments() const {
+    std::vector<uint64_t> segments;
+    std::error_code error;
+    const std::string prefix = JOURNAL_PREFIX;
+    const std::string suffix = JOURNAL_SUFFIX;
+    for (const auto& entry : std::filesystem::directory_iterator(persistencePath_, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        std::string number = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        if (number.find_first_not_of("0123456789") == std::string::npos) {
+            segments.push_back(std::stoull(number));
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+void EmergenceManager::rotateJournal() const {
+    if (journal_.is_open()) {
+        journal_.close();
+    }
+    std::error_code error;
+    std::filesystem::create_directories(persistencePath_, error);
+    journal_.open(journalPath(++journalSegment_), std::ios::app);
+    if (!journal_.is_open()) {
+        throw std::runtime_error("Failed to open journal: " + journalPath(journalSegment_));
+    }
+}
+
+void EmergenceManager::removeJournalSegments(uint64_t lastSegment) const {
+    for (uint64_t segment : journalSegments()) {
+        if (segment <= lastSegment) {
+            std::remove(journalPath(segment).c_str());
+        }
+    }
+}
+
+void EmergenceManager::journal(const nlohmann::json& entry) {
+    if (journal_.is_open()) {
+        // Flushed per entry so a crash loses at most the entry being written
+        journal_ << entry.dump() << '\n';
+        journal_.flush();
+    }
+}
+
+void EmergenceManager::replayJournal(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        auto entry = nlohmann::json::parse(line, nullptr, false);
+        if (entry.is_discarded()) {
+            break;  // A torn final entry from a crash
+        }
+        applyJournalEntry(entry);
+    }
+}
+
+void EmergenceManager::applyJournalEntry(const nlohmann::json& entry) {
+    const auto op = entry.at("op").get<std::string>();
+    const auto id = entry.value("id", std::string());
+    if (op == "variant") {
+        variants_[id] = ProtocolVariant::from_json(entry.at("variant"));
+        statusMap_[id] = static_cast<VariantStatus>(entry.at("status").get<int>());
+    } else if (op == "status") {
+        statusMap_[id] = static_cast<VariantStatus>(entry.at("status").get<int>());
+    } else if (op == "performance") {
+        appendPerformance(id, recordFromJson(entry.at("record")));
+    } else if (op == "retention") {
+        applyRetention(retentionFromJson(entry.at("retention")));
+    } else if (op == "agent") {
+        agentContexts_[id] = AgentContext::from_json(entry.at("context"));
+    } else if (op == "vote") {
+        recordVote(VotingRecord::from_json(entry.at("vote")));
+    } else if (op == "adoption") {
+        adoptionTimestamps_[id] = std::chrono::system_clock::from_time_t(entry.at("timestamp").get<time_t>());
+    } else if (op == "consensus") {
+        consensusConfig_ = ConsensusConfig::from_json(entry.at("config"));
+    }
+    // Entries of unknown kinds come from newer versions and are skipped
+}
+
+void EmergenceManager::compactJournal() {
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    const uint64_t sealed = sealedSegment_.load();
+    try {
+        // Rebuilt from disk rather than copied from the live state, which the caller keeps changing
+        EmergenceManager scratch(persistencePath_, evalMetrics_, NoRestore{});
+        auto covered = scratch.restore(sealed);
+        if (!covered || *covered >= sealed) {
+            return;
+        }
+        scratch.writeSnapshot(sealed);
+        removeJournalSegments(sealed);
+        logEvent("Compacted journal segments up to " + std::to_string(sealed));
+    } catch (const std::exception& e) {
+        logEvent("Journal compaction failed: " + std::string(e.what()));
+    }
+}
+
 void EmergenceManager::exportVariants(const std::string& filePath, const std::vector<std::string>& variantIds) const {
     nlohmann::json exportData;
     exportData["variants"] = nlohmann::json::object();
@@ -452,7 +948,7 @@ void EmergenceManager::exportVariants(const std::string& filePath, const std::ve
             auto perfIt = performanceHistory_.find(id);
             if (perfIt != performanceHistory_.end()) {
                 exportData["performance"][id] = nlohmann::json::array();
-                for (const auto& record : perfIt->second) {
+                for (const auto& record : retainedPerformance(perfIt->second)) {
                     nlohmann::json recJson;
                     recJson["timestamp"] = std::chrono::system_clock::to_time_t(record.timestamp);
                     recJson["metrics"] = {
@@ -496,6 +992,7 @@ void EmergenceManager::importVariants(const std::string& filePath) {
         
         variants_[id] = variant;
         statusMap_[id] = VariantStatus::Proposed;
+        journal({{"op", "variant"}, {"id", id}, {"variant", variant.to_json()}, {"status", static_cast<int>(VariantStatus::Proposed)}});
         
         // Import performance history if available
         auto perfIt = importData["performance"].find(id);
@@ -510,15 +1007,23 @@ void EmergenceManager::importVariants(const std::string& filePath) {
                 record.metrics.customMetrics = recJson["metrics"]["custom"].get<std::map<std::string, double>>();
                 record.context = recJson["context"];
                 record.sampleSize = recJson["sampleSize"];
-                performanceHistory_[id].push_back(record);
+                appendPerformance(id, record);
+                journal({{"op", "performance"}, {"id", id}, {"record", recordToJson(record)}});
             }
         }
     }
     
     logEvent("Imported variants from " + filePath);
+    checkAutosave();
 }
 
 void EmergenceManager::enableAutosave(std::chrono::seconds interval) {
+    if (compactionTask_ == utils::TaskScheduler::INVALID_TASK) {
+        compactionTask_ = utils::TaskScheduler::shared().add([this] { compactJournal(); });
+    }
+    if (!journal_.is_open()) {
+        rotateJournal();
+    }
     autosaveEnabled_ = true;
     autosaveInterval_ = interval;
     lastSaveTime_ = std::chrono::system_clock::now();
@@ -528,6 +1033,7 @@ void EmergenceManager::enableAutosave(std::chrono::seconds interval) {
 void EmergenceManager::disableAutosave() {
     if (autosaveEnabled_) {
         autosaveEnabled_ = false;
+        journal_.close();
         logEvent("Disabled autosave");
     }
 }
@@ -537,7 +1043,10 @@ void EmergenceManager::checkAutosave() {
     
     auto now = std::chrono::system_clock::now();
     if (now - lastSaveTime_ >= autosaveInterval_) {
-        saveState();
+        // Seal the open segment and leave folding it into the snapshot to the scheduler
+        rotateJournal();
+        sealedSegment_ = journalSegment_ - 1;
+        utils::TaskScheduler::shared().runNow(compactionTask_);
         lastSaveTime_ = now;
     }
 }
@@ -595,6 +1104,7 @@ nlohmann::json VotingRecord::to_json() const {
     j["support"] = support;
     j["reason"] = reason;
     j["timestamp"] = std::chrono::system_clock::to_time_t(timestamp);
+    j["weight"] = weight;
     return j;
 }
 
@@ -605,6 +1115,7 @@ VotingRecord VotingRecord::from_json(const nlohmann::json& j) {
     record.support = j["support"].get<bool>();
     record.reason = j["reason"].get<std::string>();
     record.timestamp = std::chrono::system_clock::from_time_t(j["timestamp"].get<time_t>());
+    record.weight = j.value("weight", 1.0);
     return record;
 }
 
@@ -638,6 +1149,7 @@ void EmergenceManager::registerAgent(const std::string& agentId, const AgentCont
     }
     
     agentContexts_[agentId] = context;
+    journal({{"op", "agent"}, {"id", agentId}, {"context", context.to_json()}});
     logEvent("Registered new agent: " + agentId);
     checkAutosave();
 }
@@ -652,6 +1164,7 @@ void EmergenceManager::updateAgentContext(const std::string& agentId, const Agen
     }
     
     agentContexts_[agentId] = context;
+    journal({{"op", "agent"}, {"id", agentId}, {"context", context.to_json()}});
     logEvent("Updated context for agent: " + agentId);
     checkAutosave();
 }
@@ -698,7 +1211,8 @@ std::string EmergenceManager::proposeVariantAsAgent(
         "Initial proposal: " + rationale,
         std::chrono::system_clock::now()
     };
-    variantVotes_[variant.id].push_back(vote);
+    recordVote(vote);
+    journal({{"op", "vote"}, {"vote", vote.to_json()}});
 
     logEvent("Agent " + agentId + " proposed variant: " + variant.id);
     checkAutosave();
@@ -712,21 +1226,7 @@ void EmergenceManager::voteOnVariant(
     bool support,
     const std::string& reason
 ) {
-    // Verify agent exists
-    if (agentContexts_.find(agentId) == agentContexts_.end()) {
-        throw std::runtime_error("Agent not found: " + agentId);
-    }
-
-    // Verify variant exists
-    if (variants_.find(variantId) == variants_.end()) {
-        throw std::runtime_error("Variant not found: " + variantId);
-    }
-
-    // Check if variant is in a votable state
-    auto status = statusMap_[variantId];
-    if (status != VariantStatus::Proposed && status != VariantStatus::InTesting) {
-        throw std::runtime_error("Variant " + variantId + " is not in a votable state");
-    }
+    checkVotable(agentId, variantId);
 
     // Record the vote
     VotingRecord vote{
@@ -736,7 +1236,8 @@ void EmergenceManager::voteOnVariant(
         reason,
         std::chrono::system_clock::now()
     };
-    variantVotes_[variantId].push_back(vote);
+    recordVote(vote);
+    journal({{"op", "vote"}, {"vote", vote.to_json()}});
 
     // Check if this vote triggers consensus
     if (checkConsensus(variantId)) {
@@ -747,6 +1248,74 @@ void EmergenceManager::voteOnVariant(
     checkAutosave();
 }
 
+void EmergenceManager::voteOnVariants(const std::vector<VotingRecord>& votes) {
+    for (const auto& vote : votes) {
+        checkVotable(vote.agentId, vote.variantId);
+    }
+
+    const auto now = std::chrono::system_clock::now();
+    std::vector<std::string> touched;
+    for (auto vote : votes) {
+        if (vote.timestamp == std::chrono::system_clock::time_point()) {
+            vote.timestamp = now;
+        }
+        recordVote(vote);
+        journal({{"op", "vote"}, {"vote", vote.to_json()}});
+        touched.push_back(vote.variantId);
+    }
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (const auto& variantId : touched) {
+        if (checkConsensus(variantId)) {
+            processAdoption(variantId);
+        }
+    }
+
+    logEvent("Recorded " + std::to_string(votes.size()) + " votes on " + std::to_string(touched.size()) + " variants");
+    checkAutosave();
+}
+
+void EmergenceManager::checkVotable(const std::string& agentId, const std::string& variantId) const {
+    // Verify agent exists
+    if (agentContexts_.find(agentId) == agentContexts_.end()) {
+        throw std::runtime_error("Agent not found: " + agentId);
+    }
+
+    // Verify variant exists
+    if (variants_.find(variantId) == variants_.end()) {
+        throw std::runtime_error("Variant not found: " + variantId);
+    }
+
+    // Check if variant is in a votable state
+    auto status = statusMap_.at(variantId);
+    if (status != VariantStatus::Proposed && status != VariantStatus::InTesting) {
+        throw std::runtime_error("Variant " + variantId + " is not in a votable state");
+    }
+}
+
+void EmergenceManager::recordVote(const VotingRecord& vote) {
+    auto& votes = variantVotes_[vote.variantId];
+    auto& tally = voteTallies_[vote.variantId];
+    auto [it, first] = tally.byAgent.emplace(vote.agentId, votes.size());
+    if (first) {
+        votes.push_back(vote);
+    } else {
+        // The agent changed its vote: take the old one out of the tally
+        auto& previous = votes[it->second];
+        tally.totalWeight -= previous.weight;
+        if (previous.support) {
+            tally.supportWeight -= previous.weight;
+        }
+        previous = vote;
+    }
+    tally.totalWeight += vote.weight;
+    if (vote.support) {
+        tally.supportWeight += vote.weight;
+    }
+    tally.latest = std::max(tally.latest, vote.timestamp);
+}
+
 std::vector<std::string> EmergenceManager::getRecommendedVariants(
     const std::string& agentId,
     size_t maxResults
@@ -804,6 +1373,7 @@ void EmergenceManager::reportVariantExperience(
                       context.successfulVariants.end(),
                       variantId) == context.successfulVariants.end()) {
             context.successfulVariants.push_back(variantId);
+            journal({{"op", "agent"}, {"id", agentId}, {"context", context.to_json()}});
         }
     }
 
@@ -847,6 +1417,7 @@ void EmergenceManager::setConsensusConfig(const ConsensusConfig& config) {
     }
 
     consensusConfig_ = config;
+    journal({{"op", "consensus"}, {"config", config.to_json()}});
     logEvent("Updated consensus configuration");
     checkAutosave();
 }
@@ -858,41 +1429,27 @@ ConsensusConfig EmergenceManager::getConsensusConfig() const {
 // Private helper methods
 
 bool EmergenceManager::checkConsensus(const std::string& variantId) const {
-    const auto& votes = variantVotes_.at(variantId);
+    const auto& tally = voteTallies_.at(variantId);
     
     // Check if we have minimum required votes
-    if (votes.size() < consensusConfig_.minimumVotes) {
+    if (tally.byAgent.size() < consensusConfig_.minimumVotes) {
         return false;
     }
 
     // Check if voting period has elapsed
-    auto latestVote = std::max_element(votes.begin(), votes.end(),
-        [](const VotingRecord& a, const VotingRecord& b) {
-            return a.timestamp < b.timestamp;
-        });
-    
     auto now = std::chrono::system_clock::now();
-    if (now - latestVote->timestamp < consensusConfig_.votingPeriod) {
+    if (now - tally.latest < consensusConfig_.votingPeriod) {
         return false;
     }
 
-    // Count votes
-    size_t supportCount = std::count_if(votes.begin(), votes.end(),
-        [](const VotingRecord& v) { return v.support; });
-    
-    double supportRatio = static_cast<double>(supportCount) / votes.size();
-    
     // Check if we have required majority
-    if (supportRatio < consensusConfig_.requiredMajority) {
+    if (tally.totalWeight <= 0.0 || tally.supportWeight / tally.totalWeight < consensusConfig_.requiredMajority) {
         return false;
     }
 
     // If performance evidence is required, check if we have it
-    if (consensusConfig_.requirePerformanceEvidence) {
-        auto perfHistory = getVariantPerformance(variantId);
-        if (perfHistory.empty()) {
-            return false;
-        }
+    if (consensusConfig_.requirePerformanceEvidence && recordCount(variantId) == 0) {
+        return false;
     }
 
     return true;
@@ -904,15 +1461,14 @@ void EmergenceManager::processAdoption(const std::string& variantId) {
     
     // Record adoption timestamp
     adoptionTimestamps_[variantId] = std::chrono::system_clock::now();
+    journal({{"op", "adoption"}, {"id", variantId},
+             {"timestamp", std::chrono::system_clock::to_time_t(adoptionTimestamps_[variantId])}});
     
     // Log the event
+    const auto& tally = voteTallies_.at(variantId);
     std::stringstream ss;
     ss << "Variant " << variantId << " reached consensus and was adopted. "
-       << "Support ratio: " << (static_cast<double>(std::count_if(
-              variantVotes_[variantId].begin(),
-              variantVotes_[variantId].end(),
-              [](const VotingRecord& v) { return v.support; }
-          )) / variantVotes_[variantId].size());
+       << "Support ratio: " << tally.supportWeight / tally.totalWeight;
     logEvent(ss.str());
     
     checkAutosave();
@@ -6,6 +6,14 @@
 #include <vector>
 #include <chrono>
 #include <optional>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include "xenocomm/utils/event_log.hpp"
+#include "xenocomm/utils/task_scheduler.hpp"
 
 namespace xenocomm {
 namespace extensions {
@@ -59,6 +67,38 @@ struct PerformanceRecord {
     size_t sampleSize = 0;    // Number of operations this record represents
 };
 
+/**
+ * @brief Running statistics of one metric over a variant's performance records.
+ */
+struct MetricSummary {
+    size_t count = 0;        // Records carrying the metric
+    double mean = 0.0;
+    double variance = 0.0;   // Sample variance; 0 with fewer than two records
+};
+
+/**
+ * @brief Downsampled statistics of the records logged within one time bucket.
+ */
+struct PerformanceBucket {
+    std::chrono::system_clock::time_point start;  // Bucket start, a multiple of the bucket width
+    size_t recordCount = 0;
+    size_t sampleSize = 0;                        // Sum of the records' sample sizes
+    std::map<std::string, MetricSummary> metrics; // Built-in and custom metrics by name
+};
+
+/**
+ * @brief How much performance history is kept per variant.
+ *
+ * The newest maxRawRecords records are kept as logged. Older ones are folded
+ * into per-bucketWidth summaries, of which the newest maxBuckets are kept.
+ * Metric summaries and scoring always cover every record ever logged.
+ */
+struct PerformanceRetention {
+    size_t maxRawRecords = 1024;
+    std::chrono::seconds bucketWidth{3600};
+    size_t maxBuckets = 720;  // 30 days of hourly buckets
+};
+
 /**
  * @brief Criteria for evaluating and comparing variant performance.
  */
@@ -85,6 +125,8 @@ struct AgentContext {
 
 /**
  * @brief Record of an agent's vote on a protocol variant.
+ *
+ * Only an agent's latest vote on a variant counts; it replaces the earlier one.
  */
 struct VotingRecord {
     std::string variantId;
@@ -92,6 +134,7 @@ struct VotingRecord {
     bool support;  // true = support, false = oppose
     std::string reason;
     std::chrono::system_clock::time_point timestamp;
+    double weight = 1.0;  // Share of the vote this agent holds in the majority
 
     // Serialization/deserialization
     nlohmann::json to_json() const;
@@ -114,12 +157,25 @@ struct ConsensusConfig {
 
 /**
  * @brief Manages protocol variants and their lifecycle.
+ *
+ * While autosave is enabled every change is appended to a journal next to
+ * the state snapshot as it is made. Each autosave interval the journal
+ * moves on to a new segment and the sealed segments are folded into the
+ * snapshot on the shared TaskScheduler, so autosave never serializes the
+ * live state on the caller's thread. Loading reads the snapshot and replays
+ * the journal written since.
  */
 class EmergenceManager {
 public:
     EmergenceManager(const std::string& persistencePath, const nlohmann::json& evalMetrics);
+    // Waits for a running journal compaction
+    ~EmergenceManager();
+
+    EmergenceManager(const EmergenceManager&) = delete;
+    EmergenceManager& operator=(const EmergenceManager&) = delete;
 
     // --- Persistence and Sharing API ---
+    // Writes a full snapshot, superseding the journal; blocks while a compaction runs
     void saveState() const;
     void loadState();
     void exportVariants(const std::string& filePath, const std::vector<std::string>& variantIds) const;
@@ -146,11 +202,19 @@ public:
 
     // --- Performance Logging and Evaluation API ---
     void logPerformance(const std::string& variantId, const PerformanceRecord& record);
+    // The retained raw records, oldest first
     std::vector<PerformanceRecord> getVariantPerformance(const std::string& variantId) const;
+    // Downsampled summaries of records that left the raw window, oldest first
+    std::vector<PerformanceBucket> getPerformanceBuckets(const std::string& variantId) const;
+    // Throws std::invalid_argument for a zero record count, bucket width or bucket count
+    void setPerformanceRetention(const PerformanceRetention& retention);
+    PerformanceRetention getPerformanceRetention() const;
     std::optional<std::string> getBestPerformingVariant(const EvaluationCriteria& criteria) const;
     void setEvaluationCriteria(const EvaluationCriteria& criteria);
     EvaluationCriteria getEvaluationCriteria() const;
     bool isSignificantlyBetter(const std::string& variantId, const std::string& baselineId, const EvaluationCriteria& criteria) const;
+    // Statistics of a built-in or custom metric; nullopt if no record of the variant carries it
+    std::optional<MetricSummary> getMetricSummary(const std::string& variantId, const std::string& metric) const;
     std::string generatePerformanceReport(const std::vector<std::string>& variantIds) const;
 
     // --- Agent-Driven Protocol Evolution API ---
@@ -172,6 +236,10 @@ public:
         bool support,
         const std::string& reason
     );
+    // Records many votes, checking consensus once per variant afterwards.
+    // Votes without a timestamp are stamped now. Throws, recording none,
+    // if any vote names an unknown agent or a variant that cannot be voted on.
+    void voteOnVariants(const std::vector<VotingRecord>& votes);
     
     // Variant adoption and notification
     std::vector<std::string> getRecommendedVariants(
@@ -196,26 +264,115 @@ public:
 private:
     std::string persistencePath_;
     nlohmann::json evalMetrics_;
+    std::shared_ptr<utils::EventLog> eventLog_;  // persistencePath_/emergence_manager.log
     std::map<std::string, ProtocolVariant> variants_;
     std::map<std::string, VariantStatus> statusMap_;
-    std::map<std::string, std::vector<PerformanceRecord>> performanceHistory_;
     EvaluationCriteria evalCriteria_;
 
+    // Running per-metric statistics, updated as records are added, so
+    // evaluation does not rescan the history
+    struct MetricAggregate {
+        size_t count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;  // Sum of squared deviations from the mean (Welford)
+
+        void add(double value);
+    };
+    struct RawRecord {
+        std::chrono::system_clock::time_point timestamp;
+        double builtin[4] = {};  // Indexed by built-in metric ID
+        std::string context;
+        size_t sampleSize = 0;
+    };
+    struct HistoryBucket {
+        std::chrono::system_clock::time_point start;
+        size_t recordCount = 0;
+        size_t sampleSize = 0;
+        std::vector<MetricAggregate> metrics;  // Indexed by metric ID
+    };
+    // Per-variant history under the retention policy. Metrics are indexed by
+    // metric ID: the built-in metrics first, then custom metrics in the order
+    // they were first seen.
+    struct VariantHistory {
+        std::vector<RawRecord> ring;  // Newest raw records; once full, the oldest is at head
+        size_t head = 0;
+        // Custom metric values by custom metric index, then ring slot; NaN where a record lacks the metric
+        std::vector<std::vector<double>> customColumns;
+        std::deque<HistoryBucket> buckets;  // Oldest first
+        std::vector<MetricAggregate> stats;  // Over every record ever logged
+        size_t totalRecords = 0;
+    };
+    std::map<std::string, VariantHistory> performanceHistory_;
+    PerformanceRetention retention_;
+    std::unordered_map<std::string, size_t> customMetricIds_;
+    std::vector<std::string> customMetricNames_;  // By custom metric index
+
+    std::optional<size_t> findMetric(const std::string& name) const;
+    size_t internMetric(const std::string& name);
+    std::string metricName(size_t metric) const;
+    static MetricSummary summarize(const MetricAggregate& aggregate);
+    nlohmann::json aggregatesToJson(const std::vector<MetricAggregate>& aggregates) const;
+    std::vector<MetricAggregate> aggregatesFromJson(const nlohmann::json& metrics);
+    void appendPerformance(const std::string& variantId, const PerformanceRecord& record, bool account = true);
+    void downsample(VariantHistory& history, size_t slot);
+    void trimHistory(VariantHistory& history);
+    PerformanceRecord rawPerformance(const VariantHistory& history, size_t slot) const;
+    std::vector<PerformanceRecord> retainedPerformance(const VariantHistory& history) const;
+    size_t recordCount(const std::string& variantId) const;
+    double metricMean(const std::string& variantId, std::optional<size_t> metric) const;
+
     // Persistence and autosave members
     bool autosaveEnabled_ = false;
     std::chrono::seconds autosaveInterval_;
     std::chrono::system_clock::time_point lastSaveTime_;
-    
+
+    // Change journal, in numbered segments of one JSON entry per line. The
+    // snapshot records the last segment it covers.
+    mutable std::ofstream journal_;            // Open segment while autosave is enabled
+    mutable uint64_t journalSegment_ = 0;      // Highest segment opened or found on disk
+    mutable std::atomic<uint64_t> sealedSegment_{0};  // Segments up to this one may be compacted
+    mutable std::mutex snapshotMutex_;         // Serializes snapshot writers
+    utils::TaskScheduler::TaskId compactionTask_ = utils::TaskScheduler::INVALID_TASK;
+
+    struct NoRestore {};
+    EmergenceManager(const std::string& persistencePath, const nlohmann::json& evalMetrics, NoRestore);
+
     // Helper methods for persistence
     nlohmann::json serializeState() const;
     void deserializeState(const nlohmann::json& state);
+    void clearState();
+    // Loads the snapshot and the segments after it up to lastSegment; returns
+    // the segment the snapshot covers, or nullopt when nothing was found
+    std::optional<uint64_t> restore(uint64_t lastSegment);
+    void writeSnapshot(uint64_t coveredSegment) const;
+    void journal(const nlohmann::json& entry);
+    void applyJournalEntry(const nlohmann::json& entry);
+    void replayJournal(const std::string& path);
+    void rotateJournal() const;
+    void removeJournalSegments(uint64_t lastSegment) const;
+    void compactJournal();
+    std::string journalPath(uint64_t segment) const;
+    std::vector<uint64_t> journalSegments() const;
+    void applyRetention(const PerformanceRetention& retention);
     void checkAutosave();
     void writeJsonToFile(const std::string& filePath, const nlohmann::json& data) const;
     nlohmann::json readJsonFromFile(const std::string& filePath) const;
 
     // Agent-driven evolution private members
     std::map<std::string, AgentContext> agentContexts_;
-    std::map<std::string, std::vector<VotingRecord>> variantVotes_;
+    std::map<std::string, std::vector<VotingRecord>> variantVotes_;  // One vote per agent
+
+    // Kept up to date as votes arrive, so consensus checks do not rescan the votes
+    struct VoteTally {
+        std::unordered_map<std::string, size_t> byAgent;  // Index of each agent's vote in variantVotes_
+        double supportWeight = 0.0;
+        double totalWeight = 0.0;
+        std::chrono::system_clock::time_point latest;     // Latest vote received
+    };
+    std::unordered_map<std::string, VoteTally> voteTallies_;
+
+    void recordVote(const VotingRecord& vote);
+    void checkVotable(const std::string& agentId, const std::string& variantId) const;
     std::map<std::string, std::chrono::system_clock::time_point> adoptionTimestamps_;
     ConsensusConfig consensusConfig_;
     
@@ -1,7 +1,12 @@
 #include "xenocomm/extensions/rollback_manager.hpp"
+#include "xenocomm/core/crypto_worker_pool.hpp"
+#include "xenocomm/utils/crc32.hpp"
+#include "xenocomm/utils/serialization.h"
 #include <random>
 #include <filesystem>
 #include <fstream>
+#include <istream>
+#include <streambuf>
 #include <sstream>
 #include <iomanip>
 #include <openssl/sha.h>
@@ -9,31 +14,296 @@
 #include <stdexcept>
 #include <algorithm>
 #include <zlib.h>
+#include <array>
 #include <memory>
-#include <queue>
+#include <string_view>
+#include <unordered_set>
 
 namespace xenocomm {
 namespace extensions {
 
 namespace {
-    // Helper function to create a SHA-256 hash of a string
+    // Incremental hex SHA-256, for data that arrives in pieces
+    class Sha256 {
+    public:
+        Sha256() : ctx_(EVP_MD_CTX_new()) {
+            EVP_DigestInit_ex(ctx_, EVP_sha256(), nullptr);
+        }
+        ~Sha256() { EVP_MD_CTX_free(ctx_); }
+        Sha256(const Sha256&) = delete;
+        Sha256& operator=(const Sha256&) = delete;
+
+        void update(const void* data, size_t size) {
+            EVP_DigestUpdate(ctx_, data, size);
+        }
+
+        std::string hexDigest() {
+            unsigned char hash[EVP_MAX_MD_SIZE];
+            unsigned int hashLen;
+            EVP_DigestFinal_ex(ctx_, hash, &hashLen);
+
+            std::stringstream ss;
+            for(unsigned int i = 0; i < hashLen; i++) {
+                ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+            }
+            return ss.str();
+        }
+
+    private:
+        EVP_MD_CTX* ctx_;
+    };
+
+    // Helper function to create a hex SHA-256 hash of a byte range
+    std::string sha256(const void* data, size_t size) {
+        Sha256 hash;
+        hash.update(data, size);
+        return hash.hexDigest();
+    }
+
     std::string sha256(const std::string& data) {
-        unsigned char hash[EVP_MAX_MD_SIZE];
-        unsigned int hashLen;
+        return sha256(data.data(), data.size());
+    }
+
+    // Random values for the gear rolling hash. Chunk boundaries depend on
+    // them, so changing the seed stops new snapshots sharing stored chunks.
+    const std::array<uint64_t, 256>& gearTable() {
+        static const std::array<uint64_t, 256> table = [] {
+            std::array<uint64_t, 256> values{};
+            uint64_t seed = 0x5852424B43444331ULL;
+            for (auto& value : values) {
+                // splitmix64
+                uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                value = z ^ (z >> 31);
+            }
+            return values;
+        }();
+        return table;
+    }
 
-        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-        EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
-        EVP_DigestUpdate(ctx, data.c_str(), data.length());
-        EVP_DigestFinal_ex(ctx, hash, &hashLen);
-        EVP_MD_CTX_free(ctx);
+    // FastCDC: the end of the next chunk of data[0, size). Cuts are harder to
+    // hit before the average size and easier after it, which keeps chunk sizes
+    // close to the average; they depend only on the preceding 64 bytes, so an
+    // edit moves at most the boundaries around it.
+    size_t nextCutPoint(const uint8_t* data, size_t size, size_t averageSize) {
+        const size_t minSize = averageSize / 4;
+        const size_t maxSize = averageSize * 4;
+        if (size <= minSize) {
+            return size;
+        }
+        size = std::min(size, maxSize);
 
-        std::stringstream ss;
-        for(unsigned int i = 0; i < hashLen; i++) {
-            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+        int bits = 0;
+        while ((size_t{2} << bits) <= averageSize) {
+            ++bits;
+        }
+        // Masks over the high bits, which mix in the most bytes
+        const uint64_t strictMask = ~uint64_t{0} << (64 - std::min(bits + 2, 63));
+        const uint64_t looseMask = ~uint64_t{0} << (64 - std::max(bits - 2, 1));
+
+        const auto& gear = gearTable();
+        const size_t normalSize = std::min(averageSize, size);
+        uint64_t hash = 0;
+        size_t i = minSize;
+        for (; i < normalSize; ++i) {
+            hash = (hash << 1) + gear[data[i]];
+            if (!(hash & strictMask)) {
+                return i + 1;
+            }
+        }
+        for (; i < size; ++i) {
+            hash = (hash << 1) + gear[data[i]];
+            if (!(hash & looseMask)) {
+                return i + 1;
+            }
         }
-        return ss.str();
+        return size;
     }
 
+    constexpr const char* POINT_EXTENSION = ".rbp";
+    constexpr const char* LEGACY_POINT_EXTENSION = ".json";
+    constexpr const char* INDEX_FILE = "index.rbi";
+
+    // Magic, summary size, summary CRC, state CRC, state size
+    constexpr size_t POINT_HEADER_SIZE = 4 + 4 + 4 + 4 + 8;
+    // Magic, point count, body CRC
+    constexpr size_t INDEX_HEADER_SIZE = 4 + 4 + 4;
+
+    void putU32(uint8_t* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void putU64(uint8_t* out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint32_t getU32(const uint8_t* in) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t getU64(const uint8_t* in) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void appendString(const std::string& value, std::vector<uint8_t>& out) {
+        utils::appendVarint(value.size(), out);
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    // Bounds-checked reader of an encoded summary
+    class SummaryReader {
+    public:
+        SummaryReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        bool varint(uint64_t& value) {
+            size_t used = 0;
+            if (!utils::readVarint(data_ + offset_, size_ - offset_, value, &used)) {
+                return false;
+            }
+            offset_ += used;
+            return true;
+        }
+
+        bool string(std::string& value) {
+            uint64_t length;
+            if (!varint(length) || length > size_ - offset_) {
+                return false;
+            }
+            value.assign(reinterpret_cast<const char*>(data_ + offset_), length);
+            offset_ += length;
+            return true;
+        }
+
+        bool atEnd() const { return offset_ == size_; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t offset_ = 0;
+    };
+
+    // Everything but the state: id, timestamp in nanoseconds (zigzag),
+    // variant, checksum, metadata pairs, a chunked flag and the manifest
+    void encodeSummary(const RollbackPoint& point, std::vector<uint8_t>& out) {
+        appendString(point.id, out);
+        utils::appendVarint(zigzag(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            point.timestamp.time_since_epoch()).count()), out);
+        appendString(point.variantId, out);
+        appendString(point.checksum, out);
+        utils::appendVarint(point.metadata.size(), out);
+        for (const auto& [key, value] : point.metadata) {
+            appendString(key, out);
+            appendString(value, out);
+        }
+        utils::appendVarint(point.isChunked ? 1 : 0, out);
+        utils::appendVarint(point.stateChunks.size(), out);
+        for (const auto& chunk : point.stateChunks) {
+            appendString(chunk.id, out);
+            utils::appendVarint(chunk.offset, out);
+            utils::appendVarint(chunk.size, out);
+        }
+    }
+
+    bool decodeSummary(const uint8_t* data, size_t size, RollbackPoint& point) {
+        SummaryReader reader(data, size);
+        uint64_t timestamp, count, flags;
+        if (!reader.string(point.id) || !reader.varint(timestamp) ||
+            !reader.string(point.variantId) || !reader.string(point.checksum) ||
+            !reader.varint(count)) {
+            return false;
+        }
+        point.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(unzigzag(timestamp))));
+        point.metadata.clear();
+        for (uint64_t i = 0; i < count; ++i) {
+            std::string key, value;
+            if (!reader.string(key) || !reader.string(value)) {
+                return false;
+            }
+            point.metadata.emplace(std::move(key), std::move(value));
+        }
+        if (!reader.varint(flags) || !reader.varint(count)) {
+            return false;
+        }
+        point.isChunked = flags & 1;
+        point.stateChunks.clear();
+        for (uint64_t i = 0; i < count; ++i) {
+            StateChunk chunk;
+            uint64_t offset, chunkSize;
+            if (!reader.string(chunk.id) || !reader.varint(offset) || !reader.varint(chunkSize)) {
+                return false;
+            }
+            chunk.offset = offset;
+            chunk.size = chunkSize;
+            chunk.checksum = chunk.id;
+            point.stateChunks.push_back(std::move(chunk));
+        }
+        return reader.atEnd();
+    }
+
+    // Write to a temporary file and rename it, so readers never see a partial file
+    bool writeFileAtomically(const std::string& path, const std::vector<uint8_t>& header,
+                             const std::vector<uint8_t>& body, const std::string& tail = {}) {
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(header.data()), header.size());
+            file.write(reinterpret_cast<const char*>(body.data()), body.size());
+            file.write(tail.data(), tail.size());
+            if (!file) {
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        return !error;
+    }
+
+    // Sequential std::istream access to a RollbackStateReader, so the JSON
+    // parser pulls one chunk at a time
+    class StateStreamBuf : public std::streambuf {
+    public:
+        explicit StateStreamBuf(RollbackStateReader& reader) : reader_(reader) {}
+
+    protected:
+        int_type underflow() override {
+            size_t count = reader_.read(offset_, reinterpret_cast<uint8_t*>(buffer_.data()), buffer_.size());
+            if (count == 0) {
+                return traits_type::eof();
+            }
+            offset_ += count;
+            setg(buffer_.data(), buffer_.data(), buffer_.data() + count);
+            return traits_type::to_int_type(buffer_[0]);
+        }
+
+    private:
+        RollbackStateReader& reader_;
+        size_t offset_ = 0;
+        std::array<char, 64 * 1024> buffer_;
+    };
+
     // Helper function to ensure directory exists
     void ensureDirectoryExists(const std::string& path) {
         std::filesystem::create_directories(path);
@@ -71,41 +341,49 @@ namespace {
     }
 }
 
-// Define collectEntries BEFORE its first use (e.g., before searchBTree or other callers)
-// Add RollbackManager qualifier back
-void RollbackManager::collectEntries(std::shared_ptr<RollbackManager::BTreeNode> node, std::vector<std::pair<std::string, std::string>>& entries) {
-    if (!node) {
-        return;
-    }
-    if (node->isLeaf) {
-        for (size_t i = 0; i < node->keyCount; ++i) {
-            entries.emplace_back(node->keys[i], node->values[i]);
-        }
-    } else {
-        for (size_t i = 0; i < node->keyCount; ++i) {
-            collectEntries(node->children[i], entries);
-            entries.emplace_back(node->keys[i], node->values[i]);
-        }
-        collectEntries(node->children[node->keyCount], entries);
-    }
-}
-
 RollbackManager::RollbackManager(
     const RollbackConfig& config,
     std::shared_ptr<CompatibilityChecker> compatibilityChecker
 ) : config_(config), compatibilityChecker_(std::move(compatibilityChecker)) {
     ensureDirectoryExists(config_.storagePath);
+    if (!config_.eventLogPath.empty()) {
+        eventLog_ = utils::EventLog::open(config_.eventLogPath);
+    }
     
-    // Load existing rollback points from storage
+    // Listing the directory is cheap; parsing what is in it is not
+    std::set<std::string> pointIds;
+    std::vector<std::string> legacyIds;
     for (const auto& entry : std::filesystem::directory_iterator(config_.storagePath)) {
-        if (entry.path().extension() == ".json") {
-            auto id = entry.path().stem().string();
-            auto point = loadRollbackPoint(id);
-            if (point) {
-                rollbackPoints_[id] = *point;
-            }
+        if (entry.path().extension() == POINT_EXTENSION) {
+            pointIds.insert(entry.path().stem().string());
+        } else if (entry.path().extension() == LEGACY_POINT_EXTENSION) {
+            legacyIds.push_back(entry.path().stem().string());
         }
     }
+
+    if (legacyIds.empty() && loadIndex(pointIds)) {
+        return;
+    }
+
+    // The index is missing or stale: rebuild it from the point summaries
+    rollbackPoints_.clear();
+    chunkRefs_.clear();
+    for (const auto& id : pointIds) {
+        auto point = readPointFile(id, false);
+        if (point) {
+            retainChunks(*point);
+            rollbackPoints_[id] = std::move(*point);
+        }
+    }
+    for (const auto& id : legacyIds) {
+        auto point = loadLegacyRollbackPoint(id);
+        if (point && persistRollbackPoint(*point)) {
+            std::filesystem::remove(config_.storagePath + id + LEGACY_POINT_EXTENSION);
+            point->state = nlohmann::json();
+            rollbackPoints_[id] = std::move(*point);
+        }
+    }
+    persistIndex();
 }
 
 std::string RollbackManager::createRollbackPoint(
@@ -113,6 +391,12 @@ std::string RollbackManager::createRollbackPoint(
     const nlohmann::json& state,
     const std::map<std::string, std::string>& metadata
 ) {
+    // Serialize once; the checksum, the size checks and the chunks all use it
+    std::string stateStr = state.dump();
+    if (stateStr.size() > config_.maxSnapshotSizeBytes) {
+        throw std::runtime_error("State exceeds the maximum snapshot size");
+    }
+
     // Generate unique ID for the rollback point
     std::string id = generateRollbackId();
     
@@ -123,28 +407,22 @@ std::string RollbackManager::createRollbackPoint(
         variantId,
         nlohmann::json(),  // Empty state for large objects
         {},                // Empty chunks initially
-        calculateChecksum(state),
+        sha256(stateStr),
         metadata,
         false             // Not chunked initially
     };
 
-    // Determine if we need to chunk the state based on size
-    std::string stateStr = state.dump();
-    bool needsChunking = stateStr.size() > config_.maxSnapshotSizeBytes / 2;  // Use half as threshold
+    // States larger than a chunk are stored as a manifest of shared chunks,
+    // so only chunks no other rollback point holds are written
+    bool needsChunking = stateStr.size() > config_.chunkSize;
 
     if (needsChunking) {
-        // Create chunks for large state
-        point.stateChunks = chunkifyState(state);
+        point.stateChunks = chunkifyState(stateStr);
         point.isChunked = true;
         
         // Create directory for chunks if needed
         ensureDirectoryExists(config_.storagePath + "/chunks");
-        
-        // Persist each chunk and store references
-        for (const auto& chunk : point.stateChunks) {
-            std::string chunkPath = persistChunk(chunk);
-            insertIntoBTree(chunk.id, chunkPath);
-        }
+        storeChunks(stateStr, point.stateChunks);
     } else {
         // Store small state directly
         point.state = state;
@@ -161,8 +439,9 @@ std::string RollbackManager::createRollbackPoint(
             }
         );
         
-        if (it != rollbackPoints_.rend()) {
-            point.state = createIncrementalSnapshot(state, it->second.state);
+        auto base = it != rollbackPoints_.rend() ? getRollbackPoint(it->first) : std::nullopt;
+        if (base) {
+            point.state = createIncrementalSnapshot(state, base->state);
             point.metadata["base_rollback_id"] = it->first;
         }
     }
@@ -173,18 +452,24 @@ std::string RollbackManager::createRollbackPoint(
     }
 
     // Add to in-memory map
-    rollbackPoints_[id] = point;
+    retainChunks(point);
+    rollbackPoints_[id] = std::move(point);
+    if (!persistIndex()) {
+        // A point missing from the index would be lost at the next start
+        releaseChunks(rollbackPoints_[id]);
+        rollbackPoints_.erase(id);
+        std::filesystem::remove(pointPath(id));
+        throw std::runtime_error("Failed to persist rollback index");
+    }
+
+    logEvent("Created rollback point " + id + (rollbackPoints_[id].isChunked
+        ? " with " + std::to_string(rollbackPoints_[id].stateChunks.size()) + " chunks" : ""));
 
     // Clean up old rollback points if needed
     if (rollbackPoints_.size() > config_.maxRollbackPoints) {
         cleanupOldRollbackPoints();
     }
 
-    // Periodically optimize B-tree
-    if (rollbackPoints_.size() % (config_.maxRollbackPoints / 2) == 0) {
-        optimizeBTree();
-    }
-
     return id;
 }
 
@@ -196,65 +481,43 @@ bool RollbackManager::restoreToPoint(const std::string& rollbackId) {
 
     // Verify integrity
     if (!verifyRollbackPoint(rollbackId)) {
+        logEvent("Rollback point " + rollbackId + " failed verification; not restored");
         return false;
     }
 
     nlohmann::json fullState;
 
     if (point->isChunked) {
-        // Load and verify all chunks
-        std::vector<StateChunk> chunks;
-        for (const auto& chunk : point->stateChunks) {
-            std::string chunkPath = searchBTree(chunk.id);
-            if (chunkPath.empty()) {
-                throw std::runtime_error("Failed to find chunk: " + chunk.id);
-            }
-            
-            chunks.push_back(loadChunk(chunk.id));
-        }
-        
-        // Reassemble the complete state
+        // Parse straight from the chunks, holding one of them at a time
         try {
-            fullState = reassembleState(chunks);
+            RollbackStateReader reader(*this, point->stateChunks, std::string());
+            StateStreamBuf buffer(reader);
+            std::istream stream(&buffer);
+            fullState = nlohmann::json::parse(stream);
         } catch (const std::exception& e) {
             throw std::runtime_error("Failed to reassemble state: " + std::string(e.what()));
         }
     } else {
-        // Handle incremental snapshots for non-chunked state
-        fullState = point->state;
-        if (config_.enableIncrementalSnapshots) {
-            // Find the base state by walking back through the rollback points
-            std::vector<RollbackPoint> chain;
-            auto currentPoint = *point;
-            
-            while (currentPoint.metadata.count("base_rollback_id")) {
-                auto baseId = currentPoint.metadata.at("base_rollback_id");
-                auto basePoint = getRollbackPoint(baseId);
-                if (!basePoint) {
-                    return false;
-                }
-                chain.push_back(*basePoint);
-                currentPoint = *basePoint;
-            }
-
-            // Apply incremental snapshots in reverse order
-            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
-                fullState = applyIncrementalSnapshot(fullState, it->state);
-            }
+        auto state = inlineState(*point);
+        if (!state) {
+            return false;
         }
+        fullState = std::move(*state);
     }
 
     // TODO: Apply the state to the system
     // This would be implemented by the specific protocol implementation
     
+    logEvent("Restored rollback point " + rollbackId);
     return true;
 }
 
 std::optional<RollbackPoint> RollbackManager::getRollbackPoint(
     const std::string& rollbackId
 ) const {
+    // Points loaded from the index have no state until read from their file
     auto it = rollbackPoints_.find(rollbackId);
-    if (it != rollbackPoints_.end()) {
+    if (it != rollbackPoints_.end() && (it->second.isChunked || !it->second.state.is_null())) {
         return it->second;
     }
     return loadRollbackPoint(rollbackId);
@@ -266,7 +529,8 @@ std::vector<RollbackPoint> RollbackManager::listRollbackPoints(
     std::vector<RollbackPoint> result;
     for (const auto& [id, point] : rollbackPoints_) {
         if (variantId.empty() || point.variantId == variantId) {
-            result.push_back(point);
+            result.push_back(RollbackPoint{point.id, point.timestamp, point.variantId, nlohmann::json(),
+                                           point.stateChunks, point.checksum, point.metadata, point.isChunked});
         }
     }
     
@@ -286,7 +550,96 @@ bool RollbackManager::verifyRollbackPoint(const std::string& rollbackId) const {
     }
 
     // Verify checksum
-    return point->checksum == calculateChecksum(point->state);
+    if (!point->isChunked) {
+        return point->checksum == calculateChecksum(point->state);
+    }
+    return streamRollbackState(rollbackId, [](const uint8_t*, size_t) { return true; });
+}
+
+bool RollbackManager::streamRollbackState(const std::string& rollbackId, const StateSink& sink) const {
+    auto point = getRollbackPoint(rollbackId);
+    if (!point) {
+        return false;
+    }
+    if (!point->isChunked) {
+        auto state = inlineState(*point);
+        if (!state) {
+            return false;
+        }
+        std::string serialized = state->dump();
+        return sink(reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
+    }
+
+    const auto& chunks = point->stateChunks;
+    auto& pool = core::CryptoWorkerPool::shared();
+    // Each batch is loaded in parallel and then released, bounding what is in memory
+    const size_t batchSize = 2 * (pool.workerCount() + 1);
+    std::vector<StateChunk> loaded(std::min(batchSize, chunks.size()));
+    Sha256 checksum;
+
+    for (size_t first = 0; first < chunks.size(); first += batchSize) {
+        const size_t count = std::min(batchSize, chunks.size() - first);
+        auto load = [&](size_t i) {
+            try {
+                loaded[i] = loadVerifiedChunk(chunks[first + i]);
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        };
+        auto deliver = [&](size_t i) {
+            auto chunk = std::move(loaded[i]);
+            checksum.update(chunk.data.data(), chunk.data.size());
+            return sink(chunk.data.data(), chunk.data.size());
+        };
+        if (!pool.runOrdered(count, load, deliver)) {
+            return false;
+        }
+    }
+    return checksum.hexDigest() == point->checksum;
+}
+
+std::unique_ptr<RollbackStateReader> RollbackManager::openRollbackState(const std::string& rollbackId) const {
+    auto point = getRollbackPoint(rollbackId);
+    if (!point) {
+        return nullptr;
+    }
+    std::string serialized;
+    if (!point->isChunked) {
+        auto state = inlineState(*point);
+        if (!state) {
+            return nullptr;
+        }
+        serialized = state->dump();
+    }
+    return std::unique_ptr<RollbackStateReader>(
+        new RollbackStateReader(*this, std::move(point->stateChunks), std::move(serialized)));
+}
+
+std::optional<nlohmann::json> RollbackManager::inlineState(const RollbackPoint& point) const {
+    // Handle incremental snapshots for non-chunked state
+    nlohmann::json fullState = point.state;
+    if (config_.enableIncrementalSnapshots) {
+        // Find the base state by walking back through the rollback points
+        std::vector<RollbackPoint> chain;
+        auto currentPoint = point;
+        
+        while (currentPoint.metadata.count("base_rollback_id")) {
+            auto baseId = currentPoint.metadata.at("base_rollback_id");
+            auto basePoint = getRollbackPoint(baseId);
+            if (!basePoint) {
+                return std::nullopt;
+            }
+            chain.push_back(*basePoint);
+            currentPoint = *basePoint;
+        }
+
+        // Apply incremental snapshots in reverse order
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            fullState = applyIncrementalSnapshot(fullState, it->state);
+        }
+    }
+    return fullState;
 }
 
 size_t RollbackManager::cleanupOldRollbackPoints() {
@@ -303,32 +656,42 @@ size_t RollbackManager::cleanupOldRollbackPoints() {
 
     // Remove points
     for (const auto& id : toRemove) {
+        releaseChunks(rollbackPoints_.at(id));
         rollbackPoints_.erase(id);
-        std::filesystem::remove(config_.storagePath + id + ".json");
+        std::filesystem::remove(pointPath(id));
         removed++;
     }
 
+    if (removed > 0) {
+        persistIndex();
+        logEvent("Removed " + std::to_string(removed) + " expired rollback points");
+    }
     return removed;
 }
 
+void RollbackManager::logEvent(std::string message) const {
+    if (eventLog_) {
+        eventLog_->write(std::move(message));
+    }
+}
+
 std::string RollbackManager::calculateChecksum(const nlohmann::json& state) const {
     return sha256(state.dump());
 }
 
 bool RollbackManager::persistRollbackPoint(const RollbackPoint& point) const {
     try {
-        nlohmann::json j = {
-            {"id", point.id},
-            {"timestamp", std::chrono::system_clock::to_time_t(point.timestamp)},
-            {"variantId", point.variantId},
-            {"state", point.state},
-            {"checksum", point.checksum},
-            {"metadata", point.metadata}
-        };
+        std::vector<uint8_t> summary;
+        encodeSummary(point, summary);
+        std::string state = point.isChunked ? std::string() : point.state.dump();
 
-        std::ofstream file(config_.storagePath + point.id + ".json");
-        file << j.dump(4);
-        return true;
+        std::vector<uint8_t> header(POINT_HEADER_SIZE);
+        putU32(header.data(), ROLLBACK_POINT_MAGIC);
+        putU32(header.data() + 4, static_cast<uint32_t>(summary.size()));
+        putU32(header.data() + 8, utils::crc32(summary.data(), summary.size()));
+        putU32(header.data() + 12, utils::crc32(reinterpret_cast<const uint8_t*>(state.data()), state.size()));
+        putU64(header.data() + 16, state.size());
+        return writeFileAtomically(pointPath(point.id), header, summary, state);
     } catch (...) {
         return false;
     }
@@ -337,8 +700,52 @@ bool RollbackManager::persistRollbackPoint(const RollbackPoint& point) const {
 std::optional<RollbackPoint> RollbackManager::loadRollbackPoint(
     const std::string& id
 ) const {
+    auto point = readPointFile(id, true);
+    if (!point) {
+        point = loadLegacyRollbackPoint(id);
+    }
+    return point;
+}
+
+std::optional<RollbackPoint> RollbackManager::readPointFile(const std::string& id, bool withState) const {
+    std::ifstream file(pointPath(id), std::ios::binary);
+    uint8_t header[POINT_HEADER_SIZE];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        getU32(header) != ROLLBACK_POINT_MAGIC) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> summary(getU32(header + 4));
+    if (!file.read(reinterpret_cast<char*>(summary.data()), summary.size()) ||
+        utils::crc32(summary.data(), summary.size()) != getU32(header + 8)) {
+        return std::nullopt;
+    }
+    RollbackPoint point;
+    if (!decodeSummary(summary.data(), summary.size(), point) || point.id != id) {
+        return std::nullopt;
+    }
+    if (!withState || point.isChunked) {
+        return point;
+    }
+
+    // The inline state follows the summary
+    const uint64_t stateSize = getU64(header + 16);
+    std::string state(stateSize, '\0');
+    if (!file.read(&state[0], state.size()) ||
+        utils::crc32(reinterpret_cast<const uint8_t*>(state.data()), state.size()) != getU32(header + 12)) {
+        return std::nullopt;
+    }
     try {
-        std::ifstream file(config_.storagePath + id + ".json");
+        point.state = nlohmann::json::parse(state);
+    } catch (...) {
+        return std::nullopt;
+    }
+    return point;
+}
+
+std::optional<RollbackPoint> RollbackManager::loadLegacyRollbackPoint(const std::string& id) const {
+    try {
+        std::ifstream file(config_.storagePath + id + LEGACY_POINT_EXTENSION);
         nlohmann::json j;
         file >> j;
 
@@ -349,6 +756,7 @@ std::optional<RollbackPoint> RollbackManager::loadRollbackPoint(
         point.state = j["state"];
         point.checksum = j["checksum"];
         point.metadata = j["metadata"].get<std::map<std::string, std::string>>();
+        point.isChunked = false;
 
         return point;
     } catch (...) {
@@ -356,6 +764,67 @@ std::optional<RollbackPoint> RollbackManager::loadRollbackPoint(
     }
 }
 
+std::string RollbackManager::pointPath(const std::string& id) const {
+    return config_.storagePath + id + POINT_EXTENSION;
+}
+
+bool RollbackManager::persistIndex() const {
+    std::vector<uint8_t> body;
+    std::vector<uint8_t> summary;
+    for (const auto& [id, point] : rollbackPoints_) {
+        summary.clear();
+        encodeSummary(point, summary);
+        utils::appendVarint(summary.size(), body);
+        body.insert(body.end(), summary.begin(), summary.end());
+    }
+
+    std::vector<uint8_t> header(INDEX_HEADER_SIZE);
+    putU32(header.data(), ROLLBACK_INDEX_MAGIC);
+    putU32(header.data() + 4, static_cast<uint32_t>(rollbackPoints_.size()));
+    putU32(header.data() + 8, utils::crc32(body.data(), body.size()));
+    return writeFileAtomically(config_.storagePath + INDEX_FILE, header, body);
+}
+
+bool RollbackManager::loadIndex(const std::set<std::string>& pointIds) {
+    std::ifstream file(config_.storagePath + INDEX_FILE, std::ios::binary);
+    uint8_t header[INDEX_HEADER_SIZE];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        getU32(header) != ROLLBACK_INDEX_MAGIC || getU32(header + 4) != pointIds.size()) {
+        return false;
+    }
+    std::vector<uint8_t> body((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (utils::crc32(body.data(), body.size()) != getU32(header + 8)) {
+        return false;
+    }
+
+    std::map<std::string, RollbackPoint> points;
+    size_t offset = 0;
+    while (offset < body.size()) {
+        uint64_t size;
+        size_t used = 0;
+        if (!utils::readVarint(body.data() + offset, body.size() - offset, size, &used) ||
+            size > body.size() - offset - used) {
+            return false;
+        }
+        offset += used;
+        RollbackPoint point;
+        if (!decodeSummary(body.data() + offset, size, point) || !pointIds.count(point.id)) {
+            return false;
+        }
+        offset += size;
+        points[point.id] = std::move(point);
+    }
+    if (points.size() != pointIds.size()) {
+        return false;
+    }
+
+    rollbackPoints_ = std::move(points);
+    for (const auto& [id, point] : rollbackPoints_) {
+        retainChunks(point);
+    }
+    return true;
+}
+
 std::string RollbackManager::generateRollbackId() const {
     auto now = std::chrono::system_clock::now();
     auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -440,102 +909,140 @@ nlohmann::json RollbackManager::applyIncrementalSnapshot(
     return result;
 }
 
-// New method implementations for chunked storage
-std::vector<StateChunk> RollbackManager::chunkifyState(const nlohmann::json& state) const {
+// Content-addressed chunk storage
+std::vector<StateChunk> RollbackManager::chunkifyState(const std::string& serialized) const {
     std::vector<StateChunk> chunks;
-    std::string stateStr = state.dump();
-    
-    // Calculate number of chunks needed
-    size_t totalSize = stateStr.size();
-    size_t numChunks = (totalSize + config_.chunkSize - 1) / config_.chunkSize;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(serialized.data());
+    const size_t averageSize = std::max<size_t>(config_.chunkSize, 64);
     
-    for (size_t i = 0; i < numChunks; i++) {
+    size_t offset = 0;
+    while (offset < serialized.size()) {
         StateChunk chunk;
-        chunk.offset = i * config_.chunkSize;
-        
-        // Extract chunk data
-        size_t chunkSize = std::min(config_.chunkSize, totalSize - chunk.offset);
-        std::vector<uint8_t> data(stateStr.begin() + chunk.offset, 
-                                 stateStr.begin() + chunk.offset + chunkSize);
-        
-        chunk.data = data;
-        chunk.id = sha256(std::string(data.begin(), data.end()));
-        chunk.checksum = chunk.id; // Use SHA-256 hash as checksum
-        
-        if (config_.enableCompression) {
-            compressChunk(chunk);
-        }
-        
+        chunk.offset = offset;
+        chunk.size = nextCutPoint(bytes + offset, serialized.size() - offset, averageSize);
+        offset += chunk.size;
         chunks.push_back(std::move(chunk));
     }
     
     return chunks;
 }
 
-nlohmann::json RollbackManager::reassembleState(const std::vector<StateChunk>& chunks) const {
-    std::string completeState;
-    completeState.reserve(chunks.size() * config_.chunkSize); // Pre-allocate approximate size
-    
-    for (const auto& chunk : chunks) {
-        auto chunkData = chunk.data;
-        if (config_.enableCompression) {
-            StateChunk mutableChunk = chunk;
-            decompressChunk(mutableChunk);
-            chunkData = mutableChunk.data;
+void RollbackManager::storeChunks(const std::string& serialized, std::vector<StateChunk>& chunks) const {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(serialized.data());
+    std::vector<StateChunk> pending(chunks.size());
+    std::string error;
+    std::mutex errorMutex;
+
+    // Workers only read chunkRefs_; it does not change until the point is stored
+    auto prepare = [&](size_t i) {
+        auto& entry = chunks[i];
+        try {
+            entry.id = sha256(bytes + entry.offset, entry.size);
+            entry.checksum = entry.id; // Use SHA-256 hash as checksum
+            if (chunkRefs_.count(entry.id) || std::filesystem::exists(chunkPath(entry.id))) {
+                return true;
+            }
+            auto& chunk = pending[i];
+            chunk = entry;
+            chunk.data.assign(bytes + entry.offset, bytes + entry.offset + entry.size);
+            if (config_.enableCompression) {
+                compressChunk(chunk);
+            }
+            return true;
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            error = e.what();
+            return false;
         }
-        
-        // Verify chunk integrity
-        if (chunk.checksum != sha256(std::string(chunkData.begin(), chunkData.end()))) {
-            throw std::runtime_error("Chunk integrity check failed");
+    };
+    std::unordered_set<std::string> written;
+    auto write = [&](size_t i) {
+        auto chunk = std::move(pending[i]);
+        // Left empty when already stored. A chunk repeated within this state
+        // is prepared once per occurrence but written once.
+        if (chunk.size == 0 || !written.insert(chunk.id).second) {
+            return true;
         }
-        
-        completeState.append(chunkData.begin(), chunkData.end());
+        try {
+            persistChunk(chunk);
+            return true;
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            error = e.what();
+            return false;
+        }
+    };
+
+    if (!core::CryptoWorkerPool::shared().runOrdered(chunks.size(), prepare, write)) {
+        throw std::runtime_error("Failed to store state chunks: " + error);
     }
+}
+
+StateChunk RollbackManager::loadVerifiedChunk(const StateChunk& entry) const {
+    StateChunk chunk = loadChunk(entry.id);
     
-    return nlohmann::json::parse(completeState);
+    // Verify chunk integrity
+    if (chunk.data.size() != entry.size || entry.checksum != sha256(chunk.data.data(), chunk.data.size())) {
+        throw std::runtime_error("Chunk integrity check failed");
+    }
+    chunk.offset = entry.offset;
+    return chunk;
 }
 
 void RollbackManager::compressChunk(StateChunk& chunk) const {
-    auto originalSize = chunk.data.size();
-    chunk.data = compressData(chunk.data);
-    // chunk.metadata["original_size"] = std::to_string(originalSize); // Commented out as per instructions
+    auto compressed = compressData(chunk.data);
+    // Incompressible chunks are stored as they are
+    if (compressed.size() < chunk.data.size()) {
+        chunk.data = std::move(compressed);
+        chunk.compressed = true;
+    }
 }
 
 void RollbackManager::decompressChunk(StateChunk& chunk) const {
-    // size_t originalSize = std::stoul(chunk.metadata.at("original_size")); // Commented out line ~505
-    // chunk.data = decompressData(chunk.data, originalSize); // Comment out this line too as originalSize is unavailable
+    chunk.data = decompressData(chunk.data, chunk.size);
+    chunk.compressed = false;
+}
+
+std::string RollbackManager::chunkPath(const std::string& chunkId) const {
+    return config_.storagePath + "/chunks/" + chunkId + ".bin";
 }
 
 std::string RollbackManager::persistChunk(const StateChunk& chunk) const {
-    std::string chunkPath = config_.storagePath + "/chunks/" + chunk.id + ".bin";
-    std::ofstream file(chunkPath, std::ios::binary);
-    
-    if (!file) {
-        throw std::runtime_error("Failed to create chunk file");
+    // Write to a temporary file and rename it, so a chunk file under its
+    // digest is always complete
+    std::string path = chunkPath(chunk.id);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to create chunk file");
+        }
+        
+        // Write chunk metadata
+        nlohmann::json metadata = {
+            {"size", chunk.size},
+            {"compressed", chunk.compressed}
+        };
+        
+        std::string metadataStr = metadata.dump();
+        uint32_t metadataSize = static_cast<uint32_t>(metadataStr.size());
+        
+        file.write(reinterpret_cast<const char*>(&metadataSize), sizeof(metadataSize));
+        file.write(metadataStr.data(), metadataSize);
+        
+        // Write chunk data
+        file.write(reinterpret_cast<const char*>(chunk.data.data()), chunk.data.size());
+        if (!file) {
+            throw std::runtime_error("Failed to write chunk file");
+        }
     }
+    std::filesystem::rename(tempPath, path);
     
-    // Write chunk metadata
-    nlohmann::json metadata = {
-        {"offset", chunk.offset},
-        {"checksum", chunk.checksum},
-        // {"metadata", chunk.metadata}
-    };
-    
-    std::string metadataStr = metadata.dump();
-    uint32_t metadataSize = static_cast<uint32_t>(metadataStr.size());
-    
-    file.write(reinterpret_cast<const char*>(&metadataSize), sizeof(metadataSize));
-    file.write(metadataStr.data(), metadataSize);
-    
-    // Write chunk data
-    file.write(reinterpret_cast<const char*>(chunk.data.data()), chunk.data.size());
-    
-    return chunkPath;
+    return path;
 }
 
 StateChunk RollbackManager::loadChunk(const std::string& chunkId) const {
-    std::string chunkPath = config_.storagePath + "/chunks/" + chunkId + ".bin";
-    std::ifstream file(chunkPath, std::ios::binary);
+    std::ifstream file(chunkPath(chunkId), std::ios::binary);
     
     if (!file) {
         throw std::runtime_error("Failed to open chunk file");
@@ -553,9 +1060,10 @@ StateChunk RollbackManager::loadChunk(const std::string& chunkId) const {
     // Create and populate chunk
     StateChunk chunk;
     chunk.id = chunkId;
-    chunk.offset = metadata["offset"];
-    chunk.checksum = metadata["checksum"];
-    // chunk.metadata = metadata["metadata"];
+    chunk.offset = 0;
+    chunk.checksum = chunkId;
+    chunk.size = metadata["size"];
+    chunk.compressed = metadata["compressed"];
     
     // Read chunk data
     file.seekg(0, std::ios::end);
@@ -565,343 +1073,63 @@ StateChunk RollbackManager::loadChunk(const std::string& chunkId) const {
     chunk.data.resize(dataSize);
     file.read(reinterpret_cast<char*>(chunk.data.data()), dataSize);
     
-    return chunk;
-}
-
-// Enhanced B-tree implementation
-void RollbackManager::insertIntoBTree(const std::string& key, const std::string& value) {
-    if (!btreeRoot_) {
-        btreeRoot_ = std::make_shared<BTreeNode>();
-        btreeRoot_->keys[0] = key;
-        btreeRoot_->values[0] = value;
-        btreeRoot_->keyCount = 1;
-        persistNode(btreeRoot_, generateNodeId(btreeRoot_));
-        return;
-    }
-    
-    // If root is full, create new root
-    if (btreeRoot_->keyCount == 2 * BTreeNode::ORDER - 1) {
-        auto newRoot = std::make_shared<BTreeNode>();
-        newRoot->isLeaf = false;
-        newRoot->children[0] = btreeRoot_;
-        splitChild(newRoot, 0);
-        btreeRoot_ = newRoot;
-    }
-    
-    insertNonFull(btreeRoot_, key, value);
-}
-
-void RollbackManager::splitChild(std::shared_ptr<BTreeNode> parent, size_t index) {
-    auto child = parent->children[index];
-    auto newNode = std::make_shared<BTreeNode>();
-    newNode->isLeaf = child->isLeaf;
-    newNode->keyCount = BTreeNode::ORDER - 1;
-    
-    // Copy keys and values to new node
-    for (size_t i = 0; i < BTreeNode::ORDER - 1; i++) {
-        newNode->keys[i] = child->keys[i + BTreeNode::ORDER];
-        newNode->values[i] = child->values[i + BTreeNode::ORDER];
-    }
-    
-    // If not leaf, move children
-    if (!child->isLeaf) {
-        for (size_t i = 0; i < BTreeNode::ORDER; i++) {
-            newNode->children[i] = child->children[i + BTreeNode::ORDER];
-        }
-    }
-    
-    // Update child's key count
-    child->keyCount = BTreeNode::ORDER - 1;
-    
-    // Move parent's keys and children to make room
-    for (size_t i = parent->keyCount; i > index; i--) {
-        parent->children[i + 1] = parent->children[i];
-    }
-    parent->children[index + 1] = newNode;
-    
-    for (size_t i = parent->keyCount - 1; i >= index && i != SIZE_MAX; i--) {
-        parent->keys[i + 1] = parent->keys[i];
-        parent->values[i + 1] = parent->values[i];
-    }
-    
-    // Copy middle key to parent
-    parent->keys[index] = child->keys[BTreeNode::ORDER - 1];
-    parent->values[index] = child->values[BTreeNode::ORDER - 1];
-    parent->keyCount++;
-    
-    // Persist changes
-    std::string childId = generateNodeId(child);
-    std::string newNodeId = generateNodeId(newNode);
-    std::string parentId = generateNodeId(parent);
-    
-    persistNode(child, childId);
-    persistNode(newNode, newNodeId);
-    persistNode(parent, parentId);
-    
-    // Update cache
-    nodeCache_.put(childId, child);
-    nodeCache_.put(newNodeId, newNode);
-    nodeCache_.put(parentId, parent);
-}
-
-void RollbackManager::insertNonFull(std::shared_ptr<BTreeNode> node, const std::string& key, const std::string& value) {
-    int i = node->keyCount - 1;
-    
-    if (node->isLeaf) {
-        // Insert into leaf node
-        while (i >= 0 && key < node->keys[i]) {
-            node->keys[i + 1] = node->keys[i];
-            node->values[i + 1] = node->values[i];
-            i--;
-        }
-        node->keys[i + 1] = key;
-        node->values[i + 1] = value;
-        node->keyCount++;
-        
-        // Persist changes
-        std::string nodeId = generateNodeId(node);
-        persistNode(node, nodeId);
-        nodeCache_.put(nodeId, node);
-    } else {
-        // Find child to recurse on
-        while (i >= 0 && key < node->keys[i]) {
-            i--;
-        }
-        i++;
-        
-        // Load child if needed
-        std::string childId = generateNodeId(node->children[i]);
-        auto child = nodeCache_.get(childId);
-        if (!child) {
-            child = loadNode(childId);
-            nodeCache_.put(childId, child);
-        }
-        
-        // If child is full, split it
-        if (child->keyCount == 2 * BTreeNode::ORDER - 1) {
-            splitChild(node, i);
-            if (key > node->keys[i]) {
-                i++;
-            }
-        }
-        
-        insertNonFull(node->children[i], key, value);
-    }
-}
-
-std::string RollbackManager::searchBTree(const std::string& key) {
-    if (!btreeRoot_) {
-        return "";
-    }
-    
-    auto node = btreeRoot_;
-    while (true) {
-        size_t i = 0;
-        while (i < node->keyCount && key > node->keys[i]) {
-            i++;
-        }
-        
-        if (i < node->keyCount && key == node->keys[i]) {
-            return node->values[i];
-        }
-        
-        if (node->isLeaf) {
-            return "";
-        }
-        
-        // Load next node
-        std::string childId = generateNodeId(node->children[i]);
-        auto nextNode = nodeCache_.get(childId);
-        if (!nextNode) {
-            nextNode = loadNode(childId);
-            nodeCache_.put(childId, nextNode);
-        }
-        node = nextNode;
-    }
-}
-
-void RollbackManager::optimizeBTree() {
-    std::vector<std::pair<std::string, std::string>> entries;
-    collectEntries(btreeRoot_, entries);
-    
-    // Sort entries for bulk loading
-    std::sort(entries.begin(), entries.end());
-    
-    // Clear cache before rebuilding
-    nodeCache_.clear();
-    
-    // Bulk load the tree
-    bulkLoadBTree(entries);
-}
-
-void RollbackManager::bulkLoadBTree(const std::vector<std::pair<std::string, std::string>>& sortedEntries) {
-    // Create leaf nodes
-    auto leafNodes = createLeafNodes(sortedEntries);
-    
-    // Create internal nodes bottom-up
-    auto currentLevel = leafNodes;
-    while (currentLevel.size() > 1) {
-        currentLevel = createInternalNodes(currentLevel);
+    if (chunk.compressed) {
+        decompressChunk(chunk);
     }
     
-    btreeRoot_ = currentLevel[0];
-    persistNode(btreeRoot_, generateNodeId(btreeRoot_));
+    return chunk;
 }
 
-std::vector<std::shared_ptr<RollbackManager::BTreeNode>> RollbackManager::createLeafNodes(
-    const std::vector<std::pair<std::string, std::string>>& sortedEntries) {
-    std::vector<std::shared_ptr<BTreeNode>> leafNodes;
-    
-    size_t entriesPerNode = BTreeNode::ORDER * 2 - 1;
-    size_t currentEntry = 0;
-    
-    while (currentEntry < sortedEntries.size()) {
-        auto node = std::make_shared<BTreeNode>();
-        node->isLeaf = true;
-        
-        size_t entriesToCopy = std::min(entriesPerNode, 
-                                       sortedEntries.size() - currentEntry);
-        
-        for (size_t i = 0; i < entriesToCopy; i++) {
-            node->keys[i] = sortedEntries[currentEntry + i].first;
-            node->values[i] = sortedEntries[currentEntry + i].second;
-        }
-        
-        node->keyCount = entriesToCopy;
-        currentEntry += entriesToCopy;
-        
-        std::string nodeId = generateNodeId(node);
-        persistNode(node, nodeId);
-        nodeCache_.put(nodeId, node);
-        
-        leafNodes.push_back(node);
+void RollbackManager::retainChunks(const RollbackPoint& point) {
+    for (const auto& chunk : point.stateChunks) {
+        ++chunkRefs_[chunk.id];
     }
-    
-    return leafNodes;
 }
 
-std::vector<std::shared_ptr<RollbackManager::BTreeNode>> RollbackManager::createInternalNodes(
-    const std::vector<std::shared_ptr<RollbackManager::BTreeNode>>& children) {
-    std::vector<std::shared_ptr<BTreeNode>> parentNodes;
-    
-    size_t childrenPerNode = BTreeNode::ORDER * 2;
-    size_t currentChild = 0;
-    
-    while (currentChild < children.size()) {
-        auto node = std::make_shared<BTreeNode>();
-        node->isLeaf = false;
-        
-        size_t childrenToProcess = std::min(childrenPerNode, 
-                                          children.size() - currentChild);
-        
-        // Copy keys and values from children
-        for (size_t i = 0; i < childrenToProcess - 1; i++) {
-            node->keys[i] = children[currentChild + i]->keys[children[currentChild + i]->keyCount - 1];
-            node->values[i] = children[currentChild + i]->values[children[currentChild + i]->keyCount - 1];
-            node->children[i] = children[currentChild + i];
+void RollbackManager::releaseChunks(const RollbackPoint& point) {
+    for (const auto& chunk : point.stateChunks) {
+        auto it = chunkRefs_.find(chunk.id);
+        if (it == chunkRefs_.end() || --it->second > 0) {
+            continue;
         }
-        
-        node->children[childrenToProcess - 1] = children[currentChild + childrenToProcess - 1];
-        node->keyCount = childrenToProcess - 1;
-        
-        std::string nodeId = generateNodeId(node);
-        persistNode(node, nodeId);
-        nodeCache_.put(nodeId, node);
-        
-        parentNodes.push_back(node);
-        currentChild += childrenToProcess;
+        chunkRefs_.erase(it);
+        std::error_code ignored;
+        std::filesystem::remove(chunkPath(chunk.id), ignored);
     }
-    
-    return parentNodes;
 }
 
-std::string RollbackManager::generateNodeId(const std::shared_ptr<BTreeNode>& node) const {
-    // Create a unique identifier based on node content
-    std::stringstream ss;
-    for (size_t i = 0; i < node->keyCount; i++) {
-        ss << node->keys[i];
-    }
-    return sha256(ss.str());
+RollbackStateReader::RollbackStateReader(const RollbackManager& manager, std::vector<StateChunk> chunks,
+                                         std::string inlineState)
+    : manager_(manager), chunks_(std::move(chunks)), inline_(std::move(inlineState)) {
+    size_ = chunks_.empty() ? inline_.size() : chunks_.back().offset + chunks_.back().size;
 }
 
-void RollbackManager::persistNode(const std::shared_ptr<BTreeNode>& node, const std::string& nodeId) {
-    std::string nodePath = config_.storagePath + "/btree/" + nodeId + ".bin";
-    std::ofstream file(nodePath, std::ios::binary);
-    
-    if (!file) {
-        throw std::runtime_error("Failed to create B-tree node file");
+size_t RollbackStateReader::read(size_t offset, uint8_t* out, size_t length) {
+    if (offset >= size_) {
+        return 0;
     }
-    
-    // Write node metadata
-    file.write(reinterpret_cast<const char*>(&node->keyCount), sizeof(node->keyCount));
-    file.write(reinterpret_cast<const char*>(&node->isLeaf), sizeof(node->isLeaf));
-    
-    // Write keys and values
-    for (size_t i = 0; i < node->keyCount; i++) {
-        size_t keySize = node->keys[i].size();
-        size_t valueSize = node->values[i].size();
-        
-        file.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
-        file.write(node->keys[i].data(), keySize);
-        
-        file.write(reinterpret_cast<const char*>(&valueSize), sizeof(valueSize));
-        file.write(node->values[i].data(), valueSize);
+    length = std::min(length, size_ - offset);
+    if (chunks_.empty()) {
+        std::copy_n(inline_.data() + offset, length, out);
+        return length;
     }
-    
-    // Write child node IDs if not leaf
-    if (!node->isLeaf) {
-        for (size_t i = 0; i <= node->keyCount; i++) {
-            std::string childId = generateNodeId(node->children[i]);
-            size_t idSize = childId.size();
-            
-            file.write(reinterpret_cast<const char*>(&idSize), sizeof(idSize));
-            file.write(childId.data(), idSize);
-        }
-    }
-}
 
-std::shared_ptr<RollbackManager::BTreeNode> RollbackManager::loadNode(const std::string& nodeId) {
-    std::string nodePath = config_.storagePath + "/btree/" + nodeId + ".bin";
-    std::ifstream file(nodePath, std::ios::binary);
-    
-    if (!file) {
-        throw std::runtime_error("Failed to open B-tree node file");
-    }
-    
-    auto node = std::make_shared<BTreeNode>();
-    
-    // Read node metadata
-    file.read(reinterpret_cast<char*>(&node->keyCount), sizeof(node->keyCount));
-    file.read(reinterpret_cast<char*>(&node->isLeaf), sizeof(node->isLeaf));
-    
-    // Read keys and values
-    for (size_t i = 0; i < node->keyCount; i++) {
-        size_t keySize, valueSize;
-        
-        file.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
-        node->keys[i].resize(keySize);
-        file.read(&node->keys[i][0], keySize);
-        
-        file.read(reinterpret_cast<char*>(&valueSize), sizeof(valueSize));
-        node->values[i].resize(valueSize);
-        file.read(&node->values[i][0], valueSize);
-    }
-    
-    // Read child node IDs if not leaf
-    if (!node->isLeaf) {
-        for (size_t i = 0; i <= node->keyCount; i++) {
-            size_t idSize;
-            file.read(reinterpret_cast<char*>(&idSize), sizeof(idSize));
-            
-            std::string childId(idSize, '\0');
-            file.read(&childId[0], idSize);
-            
-            // Load child node
-            node->children[i] = loadNode(childId);
+    // The last chunk starting at or before offset
+    size_t index = std::upper_bound(chunks_.begin(), chunks_.end(), offset,
+        [](size_t value, const StateChunk& chunk) { return value < chunk.offset; }) - chunks_.begin() - 1;
+    size_t copied = 0;
+    while (copied < length) {
+        if (index != cachedIndex_) {
+            cached_ = manager_.loadVerifiedChunk(chunks_[index]);
+            cachedIndex_ = index;
         }
+        size_t start = offset + copied - cached_.offset;
+        size_t count = std::min(length - copied, cached_.data.size() - start);
+        std::copy_n(cached_.data.data() + start, count, out + copied);
+        copied += count;
+        ++index;
     }
-    
-    return node;
+    return copied;
 }
 
 } // namespace extensions
@@ -0,0 +1,184 @@
+#include "xenocomm/extensions/swarm_kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace xenocomm {
+namespace extensions {
+
+namespace {
+    // Ciphers weakest first; anything else ranks with none
+    constexpr std::array<const char*, 4> ENCRYPTION_STRENGTH = {"none", "tls", "aes256", "chacha20"};
+
+    size_t encryptionRank(const std::string& encryption) {
+        for (size_t i = 0; i < ENCRYPTION_STRENGTH.size(); ++i) {
+            if (encryption == ENCRYPTION_STRENGTH[i]) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    bool compresses(const std::optional<std::string>& compression) {
+        return compression && !compression->empty();
+    }
+
+    double mean(const double* values, size_t count) {
+        double sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += values[i];
+        }
+        return sum / static_cast<double>(count);
+    }
+
+    // Sample variance, the n - 1 estimator
+    double variance(const double* values, size_t count, double average) {
+        double squares = 0;
+        for (size_t i = 0; i < count; ++i) {
+            squares += (values[i] - average) * (values[i] - average);
+        }
+        return squares / static_cast<double>(count - 1);
+    }
+}
+
+const char* toString(ParamCompatibility compatibility) {
+    switch (compatibility) {
+        case ParamCompatibility::COMPATIBLE: return "compatible";
+        case ParamCompatibility::UPGRADEABLE: return "upgradeable";
+        case ParamCompatibility::NEGOTIABLE: return "negotiable";
+        case ParamCompatibility::INCOMPATIBLE: return "incompatible";
+    }
+    return "incompatible";
+}
+
+ParamCompatibility ParamCompatibilityReport::worst() const {
+    return std::max({dataFormat, compression, encryption, maxMessageSize});
+}
+
+ParamCompatibilityReport checkParamCompatibility(const AgentParams& self, const AgentParams& other) {
+    ParamCompatibilityReport report;
+
+    if (self.dataFormat != other.dataFormat) {
+        report.dataFormat = self.dataFormat == "json" || other.dataFormat == "json"
+            ? ParamCompatibility::UPGRADEABLE
+            : ParamCompatibility::NEGOTIABLE;
+    }
+    if (self.compression != other.compression) {
+        report.compression = !self.compression || !other.compression
+            ? ParamCompatibility::UPGRADEABLE
+            : ParamCompatibility::NEGOTIABLE;
+    }
+    if (self.encryption != other.encryption) {
+        report.encryption = self.encryption == "none" || other.encryption == "none"
+            ? ParamCompatibility::INCOMPATIBLE
+            : ParamCompatibility::NEGOTIABLE;
+    }
+    if (self.maxMessageSize != other.maxMessageSize) {
+        report.maxMessageSize = ParamCompatibility::NEGOTIABLE;
+    }
+    return report;
+}
+
+AgentParams mergeParams(const AgentParams& self, const AgentParams& other, bool preferSelf) {
+    const AgentParams& preferred = preferSelf ? self : other;
+    AgentParams merged;
+    merged.protocolVersion = std::max(self.protocolVersion, other.protocolVersion);
+    merged.dataFormat = preferred.dataFormat;
+    if (compresses(self.compression) && compresses(other.compression)) {
+        merged.compression = self.compression;
+    }
+    merged.errorCorrection = preferred.errorCorrection;
+    merged.maxMessageSize = std::min(self.maxMessageSize, other.maxMessageSize);
+    merged.timeoutMs = std::min(self.timeoutMs, other.timeoutMs);
+    // On equal strength self's cipher stands
+    merged.encryption = encryptionRank(other.encryption) > encryptionRank(self.encryption)
+        ? other.encryption
+        : self.encryption;
+    merged.streamingEnabled = self.streamingEnabled && other.streamingEnabled;
+    merged.batchSize = std::min(self.batchSize, other.batchSize);
+    merged.retryPolicy = preferred.retryPolicy;
+    merged.maxRetries = std::max(self.maxRetries, other.maxRetries);
+    merged.priority = std::max(self.priority, other.priority);
+    return merged;
+}
+
+std::vector<ParamCompatibilityReport> checkParamCompatibility(const AgentParams& proposal,
+                                                              const std::vector<AgentParams>& peers) {
+    std::vector<ParamCompatibilityReport> reports;
+    reports.reserve(peers.size());
+    for (const auto& peer : peers) {
+        reports.push_back(checkParamCompatibility(proposal, peer));
+    }
+    return reports;
+}
+
+std::vector<ParamCompatibility> compatibilityMatrix(const std::vector<AgentParams>& agents) {
+    const size_t n = agents.size();
+    std::vector<ParamCompatibility> matrix(n * n, ParamCompatibility::COMPATIBLE);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            const ParamCompatibility worst = checkParamCompatibility(agents[i], agents[j]).worst();
+            matrix[i * n + j] = worst;
+            matrix[j * n + i] = worst;
+        }
+    }
+    return matrix;
+}
+
+const char* toString(MetricTrend trend) {
+    switch (trend) {
+        case MetricTrend::IMPROVING: return "improving";
+        case MetricTrend::STABLE: return "stable";
+        case MetricTrend::DEGRADING: return "degrading";
+        case MetricTrend::VOLATILE: return "volatile";
+        case MetricTrend::INSUFFICIENT_DATA: return "insufficient_data";
+    }
+    return "insufficient_data";
+}
+
+MetricTrend analyzeMetricTrend(const std::vector<double>& window, bool lowerIsBetter) {
+    const size_t n = window.size();
+    if (n < 2) {
+        return MetricTrend::INSUFFICIENT_DATA;
+    }
+
+    const double xMean = static_cast<double>(n - 1) / 2;
+    const double yMean = mean(window.data(), n);
+    double numerator = 0;
+    double denominator = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double dx = static_cast<double>(i) - xMean;
+        numerator += dx * (window[i] - yMean);
+        denominator += dx * dx;
+    }
+    const double normalizedSlope = numerator / denominator / (yMean != 0 ? yMean : 1);
+    // Keeps the sign of the mean, so a negative-valued metric never reads as volatile
+    const double variation = yMean != 0 ? std::sqrt(variance(window.data(), n, yMean)) / yMean : 0;
+
+    if (variation > 0.3) {
+        return MetricTrend::VOLATILE;
+    }
+    if (normalizedSlope > 0.05) {
+        return lowerIsBetter ? MetricTrend::DEGRADING : MetricTrend::IMPROVING;
+    }
+    if (normalizedSlope < -0.05) {
+        return lowerIsBetter ? MetricTrend::IMPROVING : MetricTrend::DEGRADING;
+    }
+    return MetricTrend::STABLE;
+}
+
+bool isMetricAnomalous(const std::vector<double>& samples) {
+    if (samples.size() < 3) {
+        return false;  // A baseline of one sample has no spread
+    }
+    const size_t baseline = samples.size() - 1;
+    const double average = mean(samples.data(), baseline);
+    const double spread = std::sqrt(variance(samples.data(), baseline, average));
+    if (spread == 0) {
+        return false;
+    }
+    return std::abs(samples.back() - average) / spread > 3;
+}
+
+} // namespace extensions
+} // namespace xenocomm
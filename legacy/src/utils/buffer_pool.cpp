@@ -0,0 +1,412 @@
+#include "xenocomm/utils/buffer_pool.hpp"
+#include "xenocomm/utils/contention_profile.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+constexpr size_t CLASS_COUNT = 9;  // 256 B .. 64 KiB
+constexpr uint32_t OVERSIZE_CLASS = UINT32_MAX;
+constexpr std::align_val_t BLOCK_ALIGNMENT{64};
+
+static_assert(BufferPool::MIN_POOLED_SIZE << (CLASS_COUNT - 1) == BufferPool::MAX_POOLED_SIZE,
+              "CLASS_COUNT must span MIN_POOLED_SIZE to MAX_POOLED_SIZE");
+
+size_t class_index(size_t size) {
+    size_t index = 0;
+    while ((BufferPool::MIN_POOLED_SIZE << index) < size) {
+        ++index;
+    }
+    return index;
+}
+
+size_t class_size(size_t index) {
+    return BufferPool::MIN_POOLED_SIZE << index;
+}
+
+} // namespace
+
+namespace detail {
+
+// Header placed in front of each buffer's bytes; one cache line so the data stays aligned
+struct alignas(64) BufferBlock {
+    std::atomic<uint32_t> refs{0};
+    uint32_t size_class = 0;
+    size_t capacity = 0;
+    BufferPoolState* state = nullptr;  // nullptr for heap-allocated oversize blocks
+    BufferBlock* next = nullptr;       // Free-list link
+
+    uint8_t* bytes() { return reinterpret_cast<uint8_t*>(this) + sizeof(BufferBlock); }
+};
+
+} // namespace detail
+
+using detail::BufferPoolState;
+using Block = detail::BufferBlock;
+
+namespace {
+
+struct FreeList {
+    Block* head = nullptr;
+    size_t count = 0;
+
+    void push(Block* block) {
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    Block* pop() {
+        Block* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+struct BufferPoolState : std::enable_shared_from_this<BufferPoolState> {
+    struct Depot {
+        std::mutex mutex;
+        FreeList blocks;
+    };
+
+    explicit BufferPoolState(const BufferPool::Config& pool_config) : config(pool_config) {}
+
+    ~BufferPoolState() {
+        for (void* slab : slabs) {
+            ::operator delete(slab, BLOCK_ALIGNMENT);
+        }
+    }
+
+    size_t cache_limit(size_t index) const {
+        return std::max<size_t>(4, config.thread_cache_bytes / class_size(index));
+    }
+
+    // Allocates a slab for one size class and threads its blocks onto list
+    void carve(size_t index, FreeList& list) {
+        const size_t stride = sizeof(Block) + class_size(index);
+        const size_t count = std::max<size_t>(8, config.slab_size / stride);
+        void* slab = ::operator new(count * stride, BLOCK_ALIGNMENT);
+        XPROFILE_ALLOCATION("buffer_pool", count * stride);
+        {
+            std::lock_guard<std::mutex> lock(slab_mutex);
+            slabs.push_back(slab);
+            reserved_bytes += count * stride;
+        }
+        auto* base = static_cast<uint8_t*>(slab);
+        for (size_t i = 0; i < count; ++i) {
+            Block* block = new (base + i * stride) Block();
+            block->size_class = static_cast<uint32_t>(index);
+            block->capacity = class_size(index);
+            block->state = this;
+            list.push(block);
+        }
+    }
+
+    // Moves up to count blocks from the depot into list, carving a slab if it is empty
+    void refill(size_t index, FreeList& list, size_t count) {
+        {
+            Depot& depot = depots[index];
+            std::lock_guard<std::mutex> lock(depot.mutex);
+            while (depot.blocks.head && count-- > 0) {
+                list.push(depot.blocks.pop());
+            }
+        }
+        depot_refills.fetch_add(1, std::memory_order_relaxed);
+        if (!list.head) {
+            carve(index, list);
+        }
+    }
+
+    // Returns count blocks from list to the depot
+    void drain(size_t index, FreeList& list, size_t count) {
+        Depot& depot = depots[index];
+        std::lock_guard<std::mutex> lock(depot.mutex);
+        while (list.head && count-- > 0) {
+            depot.blocks.push(list.pop());
+        }
+        depot_returns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    BufferPool::Config config;
+    std::atomic<bool> closed{false};
+    std::array<Depot, CLASS_COUNT> depots;
+
+    mutable std::mutex slab_mutex;
+    std::vector<void*> slabs;
+    size_t reserved_bytes = 0;
+
+    std::atomic<uint64_t> depot_refills{0};
+    std::atomic<uint64_t> depot_returns{0};
+    std::atomic<uint64_t> oversize_allocations{0};
+};
+
+} // namespace detail
+
+namespace {
+
+// Per-thread free lists, one entry per pool this thread has used
+struct ThreadCache {
+    struct Entry {
+        std::shared_ptr<BufferPoolState> state;
+        std::array<FreeList, CLASS_COUNT> lists;
+    };
+
+    ~ThreadCache();
+
+    // Finds or adds the entry for state, dropping entries of destroyed pools on the way
+    Entry* find(BufferPoolState* state);
+
+    // Drops the entry for a pool being destroyed; its blocks go with the slabs
+    void forget(BufferPoolState* state);
+
+    void flush(Entry& entry);
+
+    std::vector<Entry> entries;
+};
+
+enum class CacheStatus : uint8_t { UNUSED, ALIVE, DESTROYED };
+
+// Trivially destructible, so still readable while other thread_locals are torn down
+thread_local CacheStatus thread_cache_status = CacheStatus::UNUSED;
+
+ThreadCache& thread_cache() {
+    thread_local ThreadCache cache;
+    thread_cache_status = CacheStatus::ALIVE;
+    return cache;
+}
+
+ThreadCache::~ThreadCache() {
+    thread_cache_status = CacheStatus::DESTROYED;
+    for (auto& entry : entries) {
+        flush(entry);
+    }
+}
+
+ThreadCache::Entry* ThreadCache::find(BufferPoolState* state) {
+    for (size_t i = 0; i < entries.size();) {
+        if (entries[i].state->closed.load(std::memory_order_relaxed)) {
+            // Its blocks live in the closed pool's slabs and are freed with them
+            entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        if (entries[i].state.get() == state) {
+            return &entries[i];
+        }
+        ++i;
+    }
+    entries.push_back(Entry{state->shared_from_this(), {}});
+    return &entries.back();
+}
+
+void ThreadCache::forget(BufferPoolState* state) {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [state](const Entry& entry) { return entry.state.get() == state; }),
+                  entries.end());
+}
+
+void ThreadCache::flush(Entry& entry) {
+    if (entry.state->closed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    for (size_t index = 0; index < CLASS_COUNT; ++index) {
+        if (entry.lists[index].head) {
+            entry.state->drain(index, entry.lists[index], entry.lists[index].count);
+        }
+    }
+}
+
+// Called when the last handle to block goes away
+void release_block(Block* block) {
+    BufferPoolState* state = block->state;
+    if (!state) {
+        block->~Block();
+        ::operator delete(block, BLOCK_ALIGNMENT);
+        return;
+    }
+    if (state->closed.load(std::memory_order_relaxed)) {
+        return;  // The slab goes when the last thread cache lets go of the pool
+    }
+
+    const size_t index = block->size_class;
+    if (thread_cache_status == CacheStatus::DESTROYED) {
+        // Released from a thread_local destructor after this thread's cache was torn down
+        FreeList single;
+        single.push(block);
+        state->drain(index, single, 1);
+        return;
+    }
+    FreeList& list = thread_cache().find(state)->lists[index];
+    list.push(block);
+    const size_t limit = state->cache_limit(index);
+    if (list.count > limit) {
+        state->drain(index, list, limit / 2);
+    }
+}
+
+} // namespace
+
+PooledBuffer::PooledBuffer(Block* block)
+    : block_(block), data_(block->bytes()), size_(block->capacity), capacity_(block->capacity) {}
+
+PooledBuffer::PooledBuffer(const PooledBuffer& other) noexcept
+    : block_(other.block_), data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+    if (block_) {
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+    : block_(other.block_), data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+    other.block_ = nullptr;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
+PooledBuffer& PooledBuffer::operator=(const PooledBuffer& other) noexcept {
+    if (this != &other) {
+        PooledBuffer copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(block_, other.block_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+    return *this;
+}
+
+void PooledBuffer::resize(size_t size) {
+    if (size > capacity_) {
+        throw std::length_error("PooledBuffer::resize beyond capacity");
+    }
+    size_ = size;
+}
+
+PooledBuffer PooledBuffer::slice(size_t offset, size_t length) const {
+    PooledBuffer view(*this);
+    offset = std::min(offset, size_);
+    view.data_ += offset;
+    view.size_ = std::min(length, size_ - offset);
+    view.capacity_ -= offset;
+    return view;
+}
+
+bool PooledBuffer::unique() const {
+    return block_ && block_->refs.load(std::memory_order_acquire) == 1;
+}
+
+void PooledBuffer::reset() {
+    if (block_ && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        release_block(block_);
+    }
+    block_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+}
+
+BufferPool::BufferPool() : BufferPool(Config()) {}
+
+BufferPool::BufferPool(const Config& config) : state_(std::make_shared<BufferPoolState>(config)) {}
+
+BufferPool::~BufferPool() {
+    state_->closed.store(true, std::memory_order_relaxed);
+    if (thread_cache_status == CacheStatus::ALIVE) {
+        thread_cache().forget(state_.get());
+    }
+}
+
+BufferPool& BufferPool::shared() {
+    // Never destroyed, so buffers held by other statics can still be released at exit
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+PooledBuffer BufferPool::acquire(size_t size) {
+    Block* block;
+    if (size > MAX_POOLED_SIZE) {
+        void* memory = ::operator new(sizeof(Block) + size, BLOCK_ALIGNMENT);
+        XPROFILE_ALLOCATION("buffer_pool", sizeof(Block) + size);
+        block = new (memory) Block();
+        block->size_class = OVERSIZE_CLASS;
+        block->capacity = size;
+        state_->oversize_allocations.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        const size_t index = class_index(size);
+        if (thread_cache_status == CacheStatus::DESTROYED) {
+            // Acquired from a thread_local destructor; go straight to the depot
+            FreeList local;
+            state_->refill(index, local, 1);
+            block = local.pop();
+            if (local.head) {
+                state_->drain(index, local, local.count);
+            }
+        } else {
+            FreeList& list = thread_cache().find(state_.get())->lists[index];
+            if (!list.head) {
+                state_->refill(index, list, state_->cache_limit(index) / 2);
+            }
+            block = list.pop();
+        }
+    }
+    block->refs.store(1, std::memory_order_relaxed);
+    PooledBuffer buffer(block);
+    buffer.size_ = size;
+    return buffer;
+}
+
+void BufferPool::reserve(size_t size, size_t count) {
+    if (size > MAX_POOLED_SIZE) {
+        return;
+    }
+    const size_t index = class_index(size);
+    FreeList carved;
+    while (true) {
+        {
+            BufferPoolState::Depot& depot = state_->depots[index];
+            std::lock_guard<std::mutex> lock(depot.mutex);
+            while (carved.head) {
+                depot.blocks.push(carved.pop());
+            }
+            if (depot.blocks.count >= count) {
+                return;
+            }
+        }
+        state_->carve(index, carved);
+    }
+}
+
+BufferPool::Stats BufferPool::get_stats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(state_->slab_mutex);
+        stats.slabs = state_->slabs.size();
+        stats.reserved_bytes = state_->reserved_bytes;
+    }
+    stats.depot_refills = state_->depot_refills.load(std::memory_order_relaxed);
+    stats.depot_returns = state_->depot_returns.load(std::memory_order_relaxed);
+    stats.oversize_allocations = state_->oversize_allocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace utils
+} // namespace xenocomm
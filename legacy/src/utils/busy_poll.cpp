@@ -0,0 +1,81 @@
+#include "xenocomm/utils/busy_poll.hpp"
+#include <thread>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+} // namespace
+
+bool enableBusyPoll(int fd, std::chrono::microseconds budget) {
+#if defined(__linux__) && defined(SO_BUSY_POLL)
+    int usecs = static_cast<int>(budget.count());
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) != 0) {
+        return false;
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = 1;
+    // Kernels before 5.11 lack it; busy polling still works without the preference
+    setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+#endif
+    return true;
+#else
+    (void)fd;
+    (void)budget;
+    return false;
+#endif
+}
+
+bool spinUntilReadable(int fd, std::chrono::microseconds budget) {
+#ifndef _WIN32
+    struct pollfd pfd{fd, POLLIN, 0};
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+    do {
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, 0) != 0) {
+            return true;  // Readable, or a failure the read will report
+        }
+        cpuRelax();
+    } while (std::chrono::steady_clock::now() < deadline);
+#else
+    (void)fd;
+    (void)budget;
+#endif
+    return false;
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,315 @@
+#include "xenocomm/utils/cancellation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+// Token of the innermost CancellationScope on this thread
+thread_local const CancellationToken* currentToken = nullptr;
+
+#ifndef _WIN32
+// Per-thread descriptor a cancel() writes to, so a poll() on that thread wakes up
+struct WakeFd {
+    int read = -1;
+    int write = -1;
+
+    WakeFd() {
+#ifdef __linux__
+        read = write = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+        int fds[2];
+        if (::pipe(fds) == 0) {
+            for (int fd : fds) {
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+                ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+            read = fds[0];
+            write = fds[1];
+        }
+#endif
+    }
+
+    ~WakeFd() {
+        if (read >= 0) ::close(read);
+        if (write >= 0 && write != read) ::close(write);
+    }
+
+    // Clears wakes left by cancels of earlier waits
+    void drain() const {
+        uint64_t buffer[8];
+        while (::read(read, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+};
+
+WakeFd& wakeFd() {
+    static thread_local WakeFd fd;
+    return fd;
+}
+#endif
+
+int pollTimeout(std::chrono::milliseconds wait) {
+    return wait.count() < 0 ? -1 : static_cast<int>(std::min<int64_t>(wait.count(), INT_MAX));
+}
+
+} // namespace
+
+struct CancellationToken::State {
+    explicit State(Clock::time_point d) : deadline(d) {}
+
+    ~State() {
+        if (parent && parentCallback != 0) {
+            parent->remove(parentCallback);
+        }
+    }
+
+    void cancel() {
+        std::vector<std::pair<CallbackId, std::function<void()>>> run;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (cancelled.load()) {
+                return;
+            }
+            cancelled.store(true);
+            running = true;
+            runner = std::this_thread::get_id();
+            run.swap(callbacks);
+        }
+        cv.notify_all();
+        for (auto& entry : run) {
+            try {
+                entry.second();
+            } catch (...) {
+                // One failing callback must not keep the others from aborting their work
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_all();
+    }
+
+    void remove(CallbackId id) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = std::find_if(callbacks.begin(), callbacks.end(),
+                               [id](const auto& entry) { return entry.first == id; });
+        if (it != callbacks.end()) {
+            callbacks.erase(it);
+            return;
+        }
+        if (running && runner != std::this_thread::get_id()) {
+            cv.wait(lock, [this] { return !running; });
+        }
+    }
+
+    const Clock::time_point deadline;
+    std::atomic<bool> cancelled{false};
+
+    std::mutex mutex;
+    std::condition_variable cv;  // Signals sleepers, and removers waiting for callbacks to finish
+    std::vector<std::pair<CallbackId, std::function<void()>>> callbacks;
+    CallbackId nextId = 1;
+    bool running = false;        // Callbacks are being run by runner
+    std::thread::id runner;
+
+    std::shared_ptr<State> parent;
+    CallbackId parentCallback = 0;  // Cancels this state when the parent is cancelled
+};
+
+CancellationToken::CancellationToken() : CancellationToken(Clock::time_point::max()) {}
+
+CancellationToken::CancellationToken(Clock::time_point deadline) : state_(std::make_shared<State>(deadline)) {}
+
+CancellationToken CancellationToken::current() {
+    return currentToken ? *currentToken : none();
+}
+
+CancellationToken CancellationToken::child(Clock::time_point deadline) const {
+    auto state = std::make_shared<State>(std::min(deadline, this->deadline()));
+    if (state_) {
+        std::weak_ptr<State> weak = state;
+        state->parentCallback = onCancel([weak] {
+            if (auto child = weak.lock()) {
+                child->cancel();
+            }
+        });
+        state->parent = state_;
+    }
+    return CancellationToken(std::move(state));
+}
+
+void CancellationToken::cancel() const {
+    if (state_) {
+        state_->cancel();
+    }
+}
+
+bool CancellationToken::isCancelled() const {
+    return state_ && (state_->cancelled.load() ||
+                      (state_->deadline != Clock::time_point::max() && Clock::now() >= state_->deadline));
+}
+
+CancellationToken::Clock::time_point CancellationToken::deadline() const {
+    return state_ ? state_->deadline : Clock::time_point::max();
+}
+
+std::chrono::milliseconds CancellationToken::remaining(std::chrono::milliseconds limit) const {
+    if (!state_) {
+        return limit;
+    }
+    if (isCancelled()) {
+        return std::chrono::milliseconds(0);
+    }
+    if (state_->deadline == Clock::time_point::max()) {
+        return limit;
+    }
+    // Rounded up, so a wait bounded by it does not end just short of the deadline
+    auto left = std::chrono::ceil<std::chrono::milliseconds>(state_->deadline - Clock::now());
+    return std::min(limit, left);
+}
+
+bool CancellationToken::sleepFor(std::chrono::milliseconds duration) const {
+    if (!state_) {
+        std::this_thread::sleep_for(duration);
+        return true;
+    }
+    const auto until = std::min(Clock::now() + duration, state_->deadline);
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait_until(lock, until, [this] { return state_->cancelled.load(); });
+    lock.unlock();
+    return !isCancelled();
+}
+
+CancellationToken::CallbackId CancellationToken::onCancel(std::function<void()> callback) const {
+    if (!state_) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->cancelled.load()) {
+            CallbackId id = state_->nextId++;
+            state_->callbacks.emplace_back(id, std::move(callback));
+            return id;
+        }
+    }
+    callback();
+    return 0;
+}
+
+void CancellationToken::removeCallback(CallbackId id) const {
+    if (state_ && id != 0) {
+        state_->remove(id);
+    }
+}
+
+CancellationScope::CancellationScope(CancellationToken token) : token_(std::move(token)), previous_(currentToken) {
+    currentToken = &token_;
+}
+
+CancellationScope::~CancellationScope() {
+    currentToken = previous_;
+}
+
+SocketWait waitForSocket(int fd, short events, std::chrono::milliseconds timeout, const CancellationToken& token) {
+    if (token.isCancelled()) {
+        return SocketWait::CANCELLED;
+    }
+    const bool bounded = timeout.count() >= 0;
+    const auto noLimit = std::chrono::milliseconds(std::chrono::milliseconds::max());
+    auto wait = [&] {
+        auto left = token.remaining(bounded ? timeout : noLimit);
+        return left == noLimit ? std::chrono::milliseconds(-1) : left;
+    };
+
+#ifdef _WIN32
+    // No descriptor to wake WSAPoll() with, so cancellation is noticed between short slices
+    const auto slice = std::chrono::milliseconds(10);
+    const auto start = CancellationToken::Clock::now();
+    for (;;) {
+        auto left = wait();
+        if (bounded) {
+            left -= std::chrono::duration_cast<std::chrono::milliseconds>(CancellationToken::Clock::now() - start);
+        }
+        if (bounded && left.count() <= 0) {
+            return token.isCancelled() ? SocketWait::CANCELLED : SocketWait::TIMED_OUT;
+        }
+        WSAPOLLFD pfd{static_cast<SOCKET>(fd), events, 0};
+        int result = WSAPoll(&pfd, 1, pollTimeout(left.count() < 0 ? slice : std::min(left, slice)));
+        if (result > 0) {
+            return SocketWait::READY;
+        }
+        if (result < 0) {
+            return SocketWait::FAILED;
+        }
+        if (token.isCancelled()) {
+            return SocketWait::CANCELLED;
+        }
+    }
+#else
+    pollfd pfds[2] = {{fd, events, 0}, {-1, POLLIN, 0}};
+    nfds_t count = 1;
+    CancellationToken::CallbackId callback = 0;
+    if (token.isCancellable()) {
+        const WakeFd& wake = wakeFd();
+        if (wake.read >= 0) {
+            wake.drain();
+            const int target = wake.write;
+            callback = token.onCancel([target] {
+                uint64_t one = 1;
+                ssize_t written = ::write(target, &one, sizeof(one));
+                (void)written;  // A full pipe already holds a wake
+            });
+            if (callback == 0) {
+                return SocketWait::CANCELLED;
+            }
+            pfds[1].fd = wake.read;
+            count = 2;
+        }
+    }
+
+    int result;
+    do {
+        result = ::poll(pfds, count, pollTimeout(wait()));
+    } while (result < 0 && errno == EINTR);
+    const int error = errno;
+    token.removeCallback(callback);
+
+    if (result < 0) {
+        errno = error;
+        return SocketWait::FAILED;
+    }
+    if (pfds[0].revents != 0) {
+        return SocketWait::READY;
+    }
+    if (token.isCancelled()) {
+        return SocketWait::CANCELLED;
+    }
+    errno = ETIMEDOUT;
+    return SocketWait::TIMED_OUT;
+#endif
+}
+
+} // namespace utils
+} // namespace xenocomm
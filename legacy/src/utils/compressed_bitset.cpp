@@ -0,0 +1,261 @@
+#include "xenocomm/utils/compressed_bitset.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+bool testBit(const std::vector<uint64_t>& bitmap, uint16_t low) {
+    return (bitmap[low >> 6] >> (low & 63)) & 1;
+}
+
+} // namespace
+
+CompressedBitset::Chunk* CompressedBitset::find_chunk(uint16_t key) {
+    auto it = std::lower_bound(chunks_.begin(), chunks_.end(), key,
+                               [](const Chunk& chunk, uint16_t k) { return chunk.key < k; });
+    return it != chunks_.end() && it->key == key ? &*it : nullptr;
+}
+
+const CompressedBitset::Chunk* CompressedBitset::find_chunk(uint16_t key) const {
+    return const_cast<CompressedBitset*>(this)->find_chunk(key);
+}
+
+void CompressedBitset::to_bitmap(Chunk& chunk) {
+    chunk.bitmap.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : chunk.array) {
+        chunk.bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    chunk.array.clear();
+    chunk.array.shrink_to_fit();
+}
+
+void CompressedBitset::to_array(Chunk& chunk) {
+    std::vector<uint16_t> array;
+    array.reserve(chunk.cardinality);
+    for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+        for (uint64_t word = chunk.bitmap[w]; word != 0; word &= word - 1) {
+            array.push_back(static_cast<uint16_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(word))));
+        }
+    }
+    chunk.array = std::move(array);
+    chunk.bitmap.clear();
+    chunk.bitmap.shrink_to_fit();
+}
+
+bool CompressedBitset::add(uint32_t value) {
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto low = static_cast<uint16_t>(value & 0xFFFF);
+    auto it = std::lower_bound(chunks_.begin(), chunks_.end(), key,
+                               [](const Chunk& chunk, uint16_t k) { return chunk.key < k; });
+    if (it == chunks_.end() || it->key != key) {
+        it = chunks_.insert(it, Chunk{});
+        it->key = key;
+    }
+    Chunk& chunk = *it;
+
+    if (!chunk.bitmap.empty()) {
+        uint64_t& word = chunk.bitmap[low >> 6];
+        uint64_t bit = uint64_t(1) << (low & 63);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+    } else {
+        auto pos = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+        if (pos != chunk.array.end() && *pos == low) {
+            return false;
+        }
+        chunk.array.insert(pos, low);
+        if (chunk.array.size() > ARRAY_LIMIT) {
+            to_bitmap(chunk);
+        }
+    }
+    ++chunk.cardinality;
+    return true;
+}
+
+bool CompressedBitset::remove(uint32_t value) {
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto low = static_cast<uint16_t>(value & 0xFFFF);
+    auto it = std::lower_bound(chunks_.begin(), chunks_.end(), key,
+                               [](const Chunk& chunk, uint16_t k) { return chunk.key < k; });
+    if (it == chunks_.end() || it->key != key) {
+        return false;
+    }
+    Chunk& chunk = *it;
+
+    if (!chunk.bitmap.empty()) {
+        uint64_t& word = chunk.bitmap[low >> 6];
+        uint64_t bit = uint64_t(1) << (low & 63);
+        if (!(word & bit)) {
+            return false;
+        }
+        word &= ~bit;
+        if (--chunk.cardinality <= ARRAY_LIMIT) {
+            to_array(chunk);
+        }
+    } else {
+        auto pos = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+        if (pos == chunk.array.end() || *pos != low) {
+            return false;
+        }
+        chunk.array.erase(pos);
+        --chunk.cardinality;
+    }
+    if (chunk.cardinality == 0) {
+        chunks_.erase(it);
+    }
+    return true;
+}
+
+bool CompressedBitset::contains(uint32_t value) const {
+    const Chunk* chunk = find_chunk(static_cast<uint16_t>(value >> 16));
+    if (!chunk) {
+        return false;
+    }
+    auto low = static_cast<uint16_t>(value & 0xFFFF);
+    if (!chunk->bitmap.empty()) {
+        return testBit(chunk->bitmap, low);
+    }
+    return std::binary_search(chunk->array.begin(), chunk->array.end(), low);
+}
+
+size_t CompressedBitset::cardinality() const {
+    size_t total = 0;
+    for (const auto& chunk : chunks_) {
+        total += chunk.cardinality;
+    }
+    return total;
+}
+
+void CompressedBitset::intersect_chunk(Chunk& chunk, const Chunk& other) {
+    bool mineBitmap = !chunk.bitmap.empty();
+    bool otherBitmap = !other.bitmap.empty();
+
+    if (mineBitmap && otherBitmap) {
+        uint32_t count = 0;
+        uint64_t* words = chunk.bitmap.data();
+        const uint64_t* otherWords = other.bitmap.data();
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            words[w] &= otherWords[w];
+            count += static_cast<uint32_t>(__builtin_popcountll(words[w]));
+        }
+        chunk.cardinality = count;
+        if (count <= ARRAY_LIMIT) {
+            to_array(chunk);
+        }
+    } else if (mineBitmap) {
+        std::vector<uint16_t> kept;
+        kept.reserve(other.array.size());
+        for (uint16_t low : other.array) {
+            if (testBit(chunk.bitmap, low)) {
+                kept.push_back(low);
+            }
+        }
+        chunk.bitmap.clear();
+        chunk.bitmap.shrink_to_fit();
+        chunk.array = std::move(kept);
+        chunk.cardinality = static_cast<uint32_t>(chunk.array.size());
+    } else if (otherBitmap) {
+        auto end = std::remove_if(chunk.array.begin(), chunk.array.end(),
+                                  [&other](uint16_t low) { return !testBit(other.bitmap, low); });
+        chunk.array.erase(end, chunk.array.end());
+        chunk.cardinality = static_cast<uint32_t>(chunk.array.size());
+    } else {
+        std::vector<uint16_t> kept;
+        kept.reserve(std::min(chunk.array.size(), other.array.size()));
+        std::set_intersection(chunk.array.begin(), chunk.array.end(), other.array.begin(), other.array.end(),
+                              std::back_inserter(kept));
+        chunk.array = std::move(kept);
+        chunk.cardinality = static_cast<uint32_t>(chunk.array.size());
+    }
+}
+
+void CompressedBitset::intersect_with(const CompressedBitset& other) {
+    size_t out = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < chunks_.size(); ++i) {
+        while (j < other.chunks_.size() && other.chunks_[j].key < chunks_[i].key) {
+            ++j;
+        }
+        if (j == other.chunks_.size()) {
+            break;
+        }
+        if (other.chunks_[j].key != chunks_[i].key) {
+            continue;
+        }
+        intersect_chunk(chunks_[i], other.chunks_[j]);
+        if (chunks_[i].cardinality > 0) {
+            if (out != i) {
+                chunks_[out] = std::move(chunks_[i]);
+            }
+            ++out;
+        }
+    }
+    chunks_.resize(out);
+}
+
+void CompressedBitset::union_chunk(Chunk& chunk, const Chunk& other) {
+    if (chunk.bitmap.empty() && other.bitmap.empty() &&
+        chunk.array.size() + other.array.size() <= ARRAY_LIMIT) {
+        std::vector<uint16_t> merged;
+        merged.reserve(chunk.array.size() + other.array.size());
+        std::set_union(chunk.array.begin(), chunk.array.end(), other.array.begin(), other.array.end(),
+                       std::back_inserter(merged));
+        chunk.array = std::move(merged);
+        chunk.cardinality = static_cast<uint32_t>(chunk.array.size());
+        return;
+    }
+
+    if (chunk.bitmap.empty()) {
+        to_bitmap(chunk);
+    }
+    if (!other.bitmap.empty()) {
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            chunk.bitmap[w] |= other.bitmap[w];
+        }
+    } else {
+        for (uint16_t low : other.array) {
+            chunk.bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    }
+    uint32_t count = 0;
+    for (uint64_t word : chunk.bitmap) {
+        count += static_cast<uint32_t>(__builtin_popcountll(word));
+    }
+    chunk.cardinality = count;
+    if (count <= ARRAY_LIMIT) {
+        to_array(chunk);
+    }
+}
+
+void CompressedBitset::union_with(const CompressedBitset& other) {
+    std::vector<Chunk> merged;
+    merged.reserve(chunks_.size() + other.chunks_.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < chunks_.size() || j < other.chunks_.size()) {
+        if (j == other.chunks_.size() || (i < chunks_.size() && chunks_[i].key < other.chunks_[j].key)) {
+            merged.push_back(std::move(chunks_[i++]));
+        } else if (i == chunks_.size() || other.chunks_[j].key < chunks_[i].key) {
+            merged.push_back(other.chunks_[j++]);
+        } else {
+            union_chunk(chunks_[i], other.chunks_[j++]);
+            merged.push_back(std::move(chunks_[i++]));
+        }
+    }
+    chunks_ = std::move(merged);
+}
+
+std::vector<uint32_t> CompressedBitset::to_vector() const {
+    std::vector<uint32_t> values;
+    values.reserve(cardinality());
+    for_each([&values](uint32_t value) { values.push_back(value); });
+    return values;
+}
+
+} // namespace utils
+} // namespace xenocomm
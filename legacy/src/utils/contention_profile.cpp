@@ -0,0 +1,25 @@
+#include "xenocomm/utils/contention_profile.hpp"
+
+namespace xenocomm {
+namespace utils {
+
+LockStats LockStats::named(const std::string& name, MetricsRegistry& registry) {
+    const MetricLabels labels{{"lock", name}};
+    return LockStats{
+        registry.counter("xenocomm_lock_acquisitions", "Times the lock was taken", labels),
+        registry.counter("xenocomm_lock_contended", "Times the lock was found taken and waited for", labels),
+        registry.histogram("xenocomm_lock_wait_ns", "Nanoseconds spent waiting for the lock", labels),
+        registry.histogram("xenocomm_lock_hold_ns", "Nanoseconds the lock was held exclusively", labels),
+    };
+}
+
+AllocationStats AllocationStats::named(const std::string& name, MetricsRegistry& registry) {
+    const MetricLabels labels{{"subsystem", name}};
+    return AllocationStats{
+        registry.counter("xenocomm_allocations", "Heap allocations made", labels),
+        registry.counter("xenocomm_allocated_bytes", "Bytes allocated from the heap", labels),
+    };
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,257 @@
+#include "xenocomm/utils/crc32.hpp"
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define XENOCOMM_CRC32_HAVE_PCLMUL 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define XENOCOMM_CRC32_HAVE_ARMV8 1
+#include <arm_acle.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+#define XENOCOMM_CRC32_TARGET_ARMV8
+#elif defined(__clang__)
+#define XENOCOMM_CRC32_TARGET_ARMV8 __attribute__((target("crc")))
+#else
+#define XENOCOMM_CRC32_TARGET_ARMV8 __attribute__((target("+crc")))
+#endif
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Crc32Tables makeSlicingTables() {
+    Crc32Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (CRC32_POLYNOMIAL & (0u - (crc & 1u)));
+        }
+        tables[0][i] = crc;
+    }
+    // tables[k][i] is the CRC of byte i followed by k zero bytes
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t k = 1; k < 8; ++k) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32Tables kTables = makeSlicingTables();
+
+// All kernels operate on the internal (pre-inverted) CRC state
+uint32_t crc32SlicingBy8(const uint8_t* data, size_t size, uint32_t state) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // The 8-byte step below assumes little-endian loads
+    while (size--) {
+        state = (state >> 8) ^ kTables[0][(state ^ *data++) & 0xFF];
+    }
+    return state;
+#else
+    while (size >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, data, 4);
+        std::memcpy(&high, data + 4, 4);
+        low ^= state;
+        state = kTables[7][low & 0xFF] ^ kTables[6][(low >> 8) & 0xFF] ^
+                kTables[5][(low >> 16) & 0xFF] ^ kTables[4][low >> 24] ^
+                kTables[3][high & 0xFF] ^ kTables[2][(high >> 8) & 0xFF] ^
+                kTables[1][(high >> 16) & 0xFF] ^ kTables[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size--) {
+        state = (state >> 8) ^ kTables[0][(state ^ *data++) & 0xFF];
+    }
+    return state;
+#endif
+}
+
+#ifdef XENOCOMM_CRC32_HAVE_PCLMUL
+constexpr size_t PCLMUL_MIN_LENGTH = 64;
+
+/**
+ * Folds 64-byte blocks with carry-less multiplication and finishes with a
+ * Barrett reduction, following Intel's "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ". Requires size >= 64 and a multiple of 16.
+ */
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32Pclmul(const uint8_t* data, size_t size, uint32_t state) {
+    // Bit-reflected folding constants for the IEEE polynomial
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(state)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    size -= 64;
+
+    // Fold four lanes in parallel, 64 bytes per iteration
+    while (size >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        data += 64;
+        size -= 64;
+    }
+
+    // Fold the four lanes into one 128-bit value
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Single folds for any remaining 16-byte blocks
+    while (size >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        data += 16;
+        size -= 16;
+    }
+
+    // Fold 128 bits down to 64
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+uint32_t crc32PclmulDispatch(const uint8_t* data, size_t size, uint32_t state) {
+    if (size >= PCLMUL_MIN_LENGTH) {
+        size_t chunk = size & ~static_cast<size_t>(15);
+        state = crc32Pclmul(data, chunk, state);
+        data += chunk;
+        size -= chunk;
+    }
+    return crc32SlicingBy8(data, size, state);
+}
+#endif
+
+#ifdef XENOCOMM_CRC32_HAVE_ARMV8
+XENOCOMM_CRC32_TARGET_ARMV8
+uint32_t crc32Armv8(const uint8_t* data, size_t size, uint32_t state) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        state = __crc32d(state, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size--) {
+        state = __crc32b(state, *data++);
+    }
+    return state;
+}
+#endif
+
+using Crc32Kernel = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+struct Crc32Dispatch {
+    Crc32Kernel kernel;
+    Crc32Implementation implementation;
+};
+
+Crc32Dispatch selectKernel() {
+#ifdef XENOCOMM_CRC32_HAVE_PCLMUL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+        return {crc32PclmulDispatch, Crc32Implementation::PCLMUL};
+    }
+#endif
+#ifdef XENOCOMM_CRC32_HAVE_ARMV8
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+    return {crc32Armv8, Crc32Implementation::ARMV8_CRC};
+#elif defined(__linux__) && defined(HWCAP_CRC32)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        return {crc32Armv8, Crc32Implementation::ARMV8_CRC};
+    }
+#endif
+#endif
+    return {crc32SlicingBy8, Crc32Implementation::SLICING_BY_8};
+}
+
+const Crc32Dispatch& dispatch() {
+    static const Crc32Dispatch selected = selectKernel();
+    return selected;
+}
+
+} // namespace
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    if (size == 0) {
+        return crc;
+    }
+    return ~dispatch().kernel(data, size, ~crc);
+}
+
+uint32_t crc32Portable(const uint8_t* data, size_t size, uint32_t crc) {
+    if (size == 0) {
+        return crc;
+    }
+    return ~crc32SlicingBy8(data, size, ~crc);
+}
+
+Crc32Implementation activeCrc32Implementation() {
+    return dispatch().implementation;
+}
+
+} // namespace utils
+} // namespace xenocomm
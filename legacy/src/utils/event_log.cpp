@@ -0,0 +1,198 @@
+#include "xenocomm/utils/event_log.hpp"
+#include "xenocomm/utils/crc32.hpp"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+constexpr size_t RECORD_HEADER_SIZE = 20;
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+uint32_t getU32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t getU64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+std::shared_ptr<EventLog> EventLog::open(const std::string& path, Format format) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<EventLog>> logs;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = logs[path];
+    if (auto log = entry.lock()) {
+        return log;
+    }
+    std::shared_ptr<EventLog> log(new EventLog(path, format));
+    entry = log;
+    return log;
+}
+
+EventLog::EventLog(std::string path, Format format)
+    : path_(std::move(path)), format_(format), queue_(4096) {
+    drainTask_ = TaskScheduler::shared().add([this] { drain(); });
+}
+
+EventLog::~EventLog() {
+    TaskScheduler::shared().cancel(drainTask_);
+    drain();
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+void EventLog::write(std::string message) {
+    auto* event = new Event{Clock::now(), std::move(message)};
+    while (!queue_.try_push(event)) {
+        drain();  // Full: write the backlog here rather than drop events
+    }
+    if (!scheduled_.load(std::memory_order_relaxed) && !scheduled_.exchange(true)) {
+        TaskScheduler::shared().runBy(drainTask_, TaskScheduler::Clock::now() + FLUSH_DELAY);
+    }
+}
+
+void EventLog::flush() {
+    drain();
+}
+
+void EventLog::drain() {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    // Cleared first, so an event queued while this runs schedules another drain
+    scheduled_.store(false);
+    bool more = true;
+    while (more) {
+        // One ring's worth per write, so busy writers cannot grow the batch without bound
+        more = false;
+        Event* event = nullptr;
+        for (size_t popped = 0; queue_.try_pop(event); ) {
+            std::unique_ptr<Event> owned(event);
+            append(*owned);
+            if (++popped == queue_.capacity()) {
+                more = true;
+                break;
+            }
+        }
+        if (buffer_.empty()) {
+            return;
+        }
+        if (!file_) {
+            file_ = std::fopen(path_.c_str(), "ab");
+        }
+        if (file_) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            std::fflush(file_);
+            const size_t limit = rotateBytes_.load(std::memory_order_relaxed);
+            if (limit > 0 && std::ftell(file_) > static_cast<long>(limit)) {
+                rotate();
+            }
+        }
+        buffer_.clear();
+    }
+}
+
+void EventLog::setRotation(size_t maxBytes, size_t maxFiles) {
+    rotateBytes_.store(maxBytes, std::memory_order_relaxed);
+    rotateFiles_.store(std::max<size_t>(maxFiles, 1), std::memory_order_relaxed);
+}
+
+void EventLog::rotate() {
+    std::fclose(file_);
+    file_ = nullptr;  // The next batch opens a new file
+    const size_t files = rotateFiles_.load(std::memory_order_relaxed);
+    auto numbered = [this](size_t i) { return path_ + "." + std::to_string(i); };
+    if (files == 1) {
+        std::remove(path_.c_str());
+        return;
+    }
+    std::remove(numbered(files - 1).c_str());
+    for (size_t i = files - 2; i >= 1; --i) {
+        std::rename(numbered(i).c_str(), numbered(i + 1).c_str());
+    }
+    std::rename(path_.c_str(), numbered(1).c_str());
+}
+
+void EventLog::append(const Event& event) {
+    if (format_ == Format::Binary) {
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(event.time.time_since_epoch()).count();
+        putU32(buffer_, EVENT_RECORD_MAGIC);
+        putU32(buffer_, static_cast<uint32_t>(event.message.size()));
+        putU32(buffer_, crc32(reinterpret_cast<const uint8_t*>(event.message.data()), event.message.size()));
+        putU64(buffer_, static_cast<uint64_t>(micros));
+        buffer_ += event.message;
+        return;
+    }
+
+    // ctime's format, without its shared buffer
+    std::time_t time = Clock::to_time_t(event.time);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    char stamp[32];
+    size_t length = std::strftime(stamp, sizeof(stamp), "%a %b %e %H:%M:%S %Y\n", &local);
+    buffer_.append(stamp, length);
+    buffer_ += ": ";
+    buffer_ += event.message;
+    buffer_ += '\n';
+}
+
+std::vector<EventLog::Event> EventLog::readBinary(const std::string& path) {
+    std::vector<Event> events;
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t offset = 0;
+    while (data.size() - offset >= RECORD_HEADER_SIZE) {
+        const uint8_t* header = data.data() + offset;
+        if (getU32(header) != EVENT_RECORD_MAGIC) {
+            break;
+        }
+        uint32_t size = getU32(header + 4);
+        if (data.size() - offset - RECORD_HEADER_SIZE < size) {
+            break;
+        }
+        const uint8_t* payload = header + RECORD_HEADER_SIZE;
+        if (crc32(payload, size) != getU32(header + 8)) {
+            break;
+        }
+        Event event;
+        event.time = Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+            std::chrono::microseconds(static_cast<int64_t>(getU64(header + 12)))));
+        event.message.assign(reinterpret_cast<const char*>(payload), size);
+        events.push_back(std::move(event));
+        offset += RECORD_HEADER_SIZE + size;
+    }
+    return events;
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,120 @@
+#include "xenocomm/utils/frame_codec.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace xenocomm {
+namespace utils {
+
+size_t encodeFramePrefix(uint32_t length, FrameLengthEncoding encoding, uint8_t* out) {
+    if (encoding == FrameLengthEncoding::FIXED32) {
+        out[0] = static_cast<uint8_t>(length >> 24);
+        out[1] = static_cast<uint8_t>(length >> 16);
+        out[2] = static_cast<uint8_t>(length >> 8);
+        out[3] = static_cast<uint8_t>(length);
+        return 4;
+    }
+    size_t written = 0;
+    while (length >= 0x80) {
+        out[written++] = static_cast<uint8_t>(length | 0x80);
+        length >>= 7;
+    }
+    out[written++] = static_cast<uint8_t>(length);
+    return written;
+}
+
+FrameDecoder::FrameDecoder(FrameLengthEncoding encoding, size_t max_frame_size)
+    : encoding_(encoding), max_frame_size_(max_frame_size) {}
+
+MutableByteSpan FrameDecoder::prepare(size_t min_space) {
+    min_space = std::max(min_space, missing());
+    if (buffer_.size() - end_ < min_space) {
+        // Slide the unconsumed tail to the front before growing
+        if (begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        if (buffer_.size() - end_ < min_space) {
+            buffer_.resize(end_ + min_space);
+        }
+    }
+    return MutableByteSpan(buffer_.data() + end_, buffer_.size() - end_);
+}
+
+void FrameDecoder::commit(size_t count) {
+    end_ = std::min(end_ + count, buffer_.size());
+}
+
+void FrameDecoder::feed(ByteSpan data) {
+    auto space = prepare(data.size());
+    std::memcpy(space.data(), data.data(), data.size());
+    commit(data.size());
+}
+
+size_t FrameDecoder::parse_prefix(uint64_t& length, bool& malformed) const {
+    const uint8_t* data = buffer_.data() + begin_;
+    size_t available = end_ - begin_;
+    malformed = false;
+    if (encoding_ == FrameLengthEncoding::FIXED32) {
+        if (available < 4) {
+            return 0;
+        }
+        length = (uint64_t{data[0]} << 24) | (uint64_t{data[1]} << 16) | (uint64_t{data[2]} << 8) | data[3];
+        return 4;
+    }
+    length = 0;
+    for (size_t i = 0; i < MAX_FRAME_PREFIX; ++i) {
+        if (i == available) {
+            return 0;
+        }
+        length |= uint64_t{data[i] & 0x7Fu} << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            malformed = length > UINT32_MAX;
+            return i + 1;
+        }
+    }
+    malformed = true;
+    return MAX_FRAME_PREFIX;
+}
+
+FrameDecoder::Status FrameDecoder::next(ByteSpan& frame) {
+    uint64_t length = 0;
+    bool malformed = false;
+    size_t prefix = parse_prefix(length, malformed);
+    if (malformed) {
+        return Status::MALFORMED;
+    }
+    if (prefix == 0) {
+        return Status::NEED_MORE;
+    }
+    if (length > max_frame_size_) {
+        return Status::TOO_LARGE;
+    }
+    if (end_ - begin_ - prefix < length) {
+        return Status::NEED_MORE;
+    }
+    frame = ByteSpan(buffer_.data() + begin_ + prefix, static_cast<size_t>(length));
+    begin_ += prefix + static_cast<size_t>(length);
+    if (begin_ == end_) {
+        begin_ = end_ = 0;  // Frame views stay valid: nothing is moved until the next prepare()
+    }
+    return Status::FRAME;
+}
+
+size_t FrameDecoder::missing() const {
+    uint64_t length = 0;
+    bool malformed = false;
+    size_t prefix = parse_prefix(length, malformed);
+    if (prefix == 0 || malformed || length > max_frame_size_) {
+        return 0;
+    }
+    size_t have = end_ - begin_ - prefix;
+    return have < length ? static_cast<size_t>(length) - have : 0;
+}
+
+void FrameDecoder::reset() {
+    begin_ = end_ = 0;
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,226 @@
+#include "xenocomm/utils/gf256.hpp"
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define XENOCOMM_GF256_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define XENOCOMM_GF256_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+constexpr unsigned GF256_POLYNOMIAL = 0x11D;
+
+struct Gf256Tables {
+    std::array<uint8_t, 512> exp{};  // Doubled so exp[log a + log b] needs no modulo
+    std::array<uint8_t, 256> log{};
+};
+
+constexpr Gf256Tables makeTables() {
+    Gf256Tables tables{};
+    unsigned value = 1;
+    for (unsigned i = 0; i < 255; ++i) {
+        tables.exp[i] = static_cast<uint8_t>(value);
+        tables.log[value] = static_cast<uint8_t>(i);
+        value <<= 1;
+        if (value & 0x100) {
+            value ^= GF256_POLYNOMIAL;
+        }
+    }
+    for (unsigned i = 255; i < 512; ++i) {
+        tables.exp[i] = tables.exp[i - 255];
+    }
+    return tables;
+}
+
+constexpr Gf256Tables kTables = makeTables();
+
+inline uint8_t mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    return kTables.exp[kTables.log[a] + kTables.log[b]];
+}
+
+/**
+ * Split-nibble tables: coefficient * x == low[x & 0x0F] ^ high[x >> 4], which
+ * turns a multiply by a constant into two 16-entry shuffles.
+ */
+struct NibbleTables {
+    alignas(16) uint8_t low[16];
+    alignas(16) uint8_t high[16];
+};
+
+inline NibbleTables makeNibbleTables(uint8_t coefficient) {
+    NibbleTables tables;
+    for (uint8_t i = 0; i < 16; ++i) {
+        tables.low[i] = mul(coefficient, i);
+        tables.high[i] = mul(coefficient, static_cast<uint8_t>(i << 4));
+    }
+    return tables;
+}
+
+template <bool Accumulate>
+void regionScalar(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size) {
+    uint8_t row[256];
+    for (unsigned i = 0; i < 256; ++i) {
+        row[i] = mul(coefficient, static_cast<uint8_t>(i));
+    }
+    for (size_t i = 0; i < size; ++i) {
+        dst[i] = Accumulate ? static_cast<uint8_t>(dst[i] ^ row[src[i]]) : row[src[i]];
+    }
+}
+
+#ifdef XENOCOMM_GF256_HAVE_X86
+template <bool Accumulate>
+__attribute__((target("ssse3")))
+void regionSsse3(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size) {
+    NibbleTables tables = makeNibbleTables(coefficient);
+    const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.low));
+    const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.high));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_shuffle_epi8(low, _mm_and_si128(in, mask));
+        __m128i hi = _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(in, 4), mask));
+        __m128i product = _mm_xor_si128(lo, hi);
+        if (Accumulate) {
+            product = _mm_xor_si128(product, _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), product);
+    }
+    for (; i < size; ++i) {
+        uint8_t product = tables.low[src[i] & 0x0F] ^ tables.high[src[i] >> 4];
+        dst[i] = Accumulate ? static_cast<uint8_t>(dst[i] ^ product) : product;
+    }
+}
+
+template <bool Accumulate>
+__attribute__((target("avx2")))
+void regionAvx2(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size) {
+    NibbleTables tables = makeNibbleTables(coefficient);
+    const __m256i low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.low)));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.high)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i lo = _mm256_shuffle_epi8(low, _mm256_and_si256(in, mask));
+        __m256i hi = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi64(in, 4), mask));
+        __m256i product = _mm256_xor_si256(lo, hi);
+        if (Accumulate) {
+            product = _mm256_xor_si256(product, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), product);
+    }
+    for (; i < size; ++i) {
+        uint8_t product = tables.low[src[i] & 0x0F] ^ tables.high[src[i] >> 4];
+        dst[i] = Accumulate ? static_cast<uint8_t>(dst[i] ^ product) : product;
+    }
+}
+#endif
+
+#ifdef XENOCOMM_GF256_HAVE_NEON
+template <bool Accumulate>
+void regionNeon(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size) {
+    NibbleTables tables = makeNibbleTables(coefficient);
+    const uint8x16_t low = vld1q_u8(tables.low);
+    const uint8x16_t high = vld1q_u8(tables.high);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t in = vld1q_u8(src + i);
+        uint8x16_t product = veorq_u8(vqtbl1q_u8(low, vandq_u8(in, mask)),
+                                      vqtbl1q_u8(high, vshrq_n_u8(in, 4)));
+        if (Accumulate) {
+            product = veorq_u8(product, vld1q_u8(dst + i));
+        }
+        vst1q_u8(dst + i, product);
+    }
+    for (; i < size; ++i) {
+        uint8_t product = tables.low[src[i] & 0x0F] ^ tables.high[src[i] >> 4];
+        dst[i] = Accumulate ? static_cast<uint8_t>(dst[i] ^ product) : product;
+    }
+}
+#endif
+
+using RegionKernel = void (*)(uint8_t, const uint8_t*, uint8_t*, size_t);
+
+struct Gf256Dispatch {
+    RegionKernel mul;
+    RegionKernel mulAdd;
+    Gf256Implementation implementation;
+};
+
+Gf256Dispatch selectKernels() {
+#ifdef XENOCOMM_GF256_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {regionAvx2<false>, regionAvx2<true>, Gf256Implementation::AVX2};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return {regionSsse3<false>, regionSsse3<true>, Gf256Implementation::SSSE3};
+    }
+#endif
+#ifdef XENOCOMM_GF256_HAVE_NEON
+    return {regionNeon<false>, regionNeon<true>, Gf256Implementation::NEON};
+#else
+    return {regionScalar<false>, regionScalar<true>, Gf256Implementation::SCALAR};
+#endif
+}
+
+const Gf256Dispatch& dispatch() {
+    static const Gf256Dispatch selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+uint8_t gf256Mul(uint8_t a, uint8_t b) {
+    return mul(a, b);
+}
+
+uint8_t gf256Inv(uint8_t a) {
+    if (a == 0) {
+        return 0;
+    }
+    return kTables.exp[255 - kTables.log[a]];
+}
+
+void gf256MulRegion(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size) {
+    if (coefficient == 0) {
+        std::memset(dst, 0, size);
+    } else if (coefficient == 1) {
+        if (src != dst) {
+            std::memcpy(dst, src, size);
+        }
+    } else {
+        dispatch().mul(coefficient, src, dst, size);
+    }
+}
+
+void gf256MulAddRegion(uint8_t coefficient, const uint8_t* src, uint8_t* dst, size_t size) {
+    if (coefficient == 0) {
+        return;
+    }
+    dispatch().mulAdd(coefficient, src, dst, size);
+}
+
+Gf256Implementation activeGf256Implementation() {
+    return dispatch().implementation;
+}
+
+} // namespace utils
+} // namespace xenocomm
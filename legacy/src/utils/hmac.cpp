@@ -0,0 +1,113 @@
+#include "xenocomm/utils/hmac.hpp"
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+std::atomic<uint64_t> nextKeyId{1};
+
+/**
+ * Each thread's working contexts, one per key it has recently used. A context
+ * is duplicated from the keyed one on first use and re-initialised in place
+ * afterwards; the least recently added is dropped when a thread juggles more
+ * keys than there are slots.
+ */
+class ThreadContexts {
+public:
+    ~ThreadContexts() {
+        for (Slot& slot : slots_) {
+            EVP_MAC_CTX_free(slot.ctx);
+        }
+    }
+
+    EVP_MAC_CTX* get(uint64_t id, const EVP_MAC_CTX* keyed) {
+        for (Slot& slot : slots_) {
+            if (slot.id == id) {
+                return slot.ctx;
+            }
+        }
+        EVP_MAC_CTX* ctx = EVP_MAC_CTX_dup(keyed);
+        if (!ctx) {
+            return nullptr;
+        }
+        Slot& slot = slots_[next_];
+        next_ = (next_ + 1) % SLOTS;
+        EVP_MAC_CTX_free(slot.ctx);
+        slot = {id, ctx};
+        return ctx;
+    }
+
+private:
+    static constexpr size_t SLOTS = 8;
+
+    struct Slot {
+        uint64_t id = 0;
+        EVP_MAC_CTX* ctx = nullptr;
+    };
+
+    Slot slots_[SLOTS];
+    size_t next_ = 0;
+};
+
+} // namespace
+
+HmacSha256::HmacSha256(ByteSpan key) {
+    EVP_MAC* hmac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+    if (!hmac) {
+        throw std::runtime_error("HMAC is not available from OpenSSL");
+    }
+    ctx_.reset(EVP_MAC_CTX_new(hmac), EVP_MAC_CTX_free);
+    EVP_MAC_free(hmac);  // The context holds its own reference
+
+    char digest[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+        OSSL_PARAM_construct_end(),
+    };
+    // EVP_MAC_init rejects a null key, even an empty one
+    static const uint8_t empty = 0;
+    const uint8_t* keyData = key.empty() ? &empty : key.data();
+    if (!ctx_ || EVP_MAC_init(ctx_.get(), keyData, key.size(), params) != 1) {
+        ctx_.reset();
+        throw std::runtime_error("Failed to key HMAC-SHA256");
+    }
+    id_ = nextKeyId.fetch_add(1, std::memory_order_relaxed);
+}
+
+HmacSha256::HmacSha256(HmacSha256&& other) noexcept
+    : ctx_(std::move(other.ctx_)), id_(std::exchange(other.id_, 0)) {}
+
+HmacSha256& HmacSha256::operator=(HmacSha256&& other) noexcept {
+    std::swap(ctx_, other.ctx_);
+    std::swap(id_, other.id_);
+    return *this;
+}
+
+bool HmacSha256::mac(std::initializer_list<ByteSpan> parts, uint8_t* out) const {
+    if (!ctx_) {
+        return false;
+    }
+    thread_local ThreadContexts contexts;
+    EVP_MAC_CTX* ctx = contexts.get(id_, ctx_.get());
+    // A null key restarts the MAC under the key the context already holds
+    if (!ctx || EVP_MAC_init(ctx, nullptr, 0, nullptr) != 1) {
+        return false;
+    }
+    for (const ByteSpan& part : parts) {
+        if (!part.empty() && EVP_MAC_update(ctx, part.data(), part.size()) != 1) {
+            return false;
+        }
+    }
+    size_t written = 0;
+    return EVP_MAC_final(ctx, out, &written, DIGEST_SIZE) == 1 && written == DIGEST_SIZE;
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -1,10 +1,133 @@
-// #include "xenocomm/utils/logging.h"
+#include "xenocomm/utils/logging.hpp"
+#include <ctime>
 
 namespace xenocomm {
 namespace utils {
 
-// Placeholder implementation
-// TODO: Implement actual logging functionality
+namespace {
+
+struct LoggerState {
+    std::mutex mutex;
+    std::shared_ptr<LogSink> sink = std::make_shared<StreamLogSink>(stderr);
+};
+
+// Never destroyed, so objects logging from their destructors during exit still find it
+LoggerState& state() {
+    static LoggerState* instance = new LoggerState();
+    return *instance;
+}
+
+} // namespace
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Critical: return "CRITICAL";
+        case LogLevel::Off: return "OFF";
+    }
+    return "UNKNOWN";
+}
+
+void StreamLogSink::write(const LogRecord& record) {
+    std::time_t time = std::chrono::system_clock::to_time_t(record.time);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        record.time.time_since_epoch()).count() % 1000;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fprintf(stream_, "%s.%03d [%s] %s:%d: %s\n", stamp, static_cast<int>(millis),
+                 logLevelName(record.level), record.file, record.line, record.message.c_str());
+}
+
+void StreamLogSink::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fflush(stream_);
+}
+
+AsyncLogSink::AsyncLogSink(std::shared_ptr<LogSink> target, size_t capacity)
+    : target_(std::move(target)), queue_(capacity) {
+    drainTask_ = TaskScheduler::shared().add([this] { drain(); });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    TaskScheduler::shared().cancel(drainTask_);
+    flush();
+}
+
+void AsyncLogSink::write(const LogRecord& record) {
+    auto* queued = new LogRecord(record);
+    while (!queue_.try_push(queued)) {
+        drain();  // Full: write the backlog here rather than drop records
+    }
+    if (!scheduled_.load(std::memory_order_relaxed) && !scheduled_.exchange(true)) {
+        TaskScheduler::shared().runBy(drainTask_, TaskScheduler::Clock::now() + FLUSH_DELAY);
+    }
+}
+
+void AsyncLogSink::flush() {
+    drain();
+    if (target_) {
+        target_->flush();
+    }
+}
+
+void AsyncLogSink::drain() {
+    std::lock_guard<std::mutex> lock(drainMutex_);
+    // Cleared first, so a record queued while this runs schedules another drain
+    scheduled_.store(false);
+    LogRecord* record = nullptr;
+    while (queue_.try_pop(record)) {
+        std::unique_ptr<LogRecord> owned(record);
+        if (target_) {
+            target_->write(*owned);
+        }
+    }
+}
+
+std::atomic<int> Logger::level_{static_cast<int>(LogLevel::Warn)};
+
+void Logger::setSink(std::shared_ptr<LogSink> sink) {
+    LoggerState& logger = state();
+    std::lock_guard<std::mutex> lock(logger.mutex);
+    logger.sink = std::move(sink);
+}
+
+std::shared_ptr<LogSink> Logger::sink() {
+    LoggerState& logger = state();
+    std::lock_guard<std::mutex> lock(logger.mutex);
+    return logger.sink;
+}
+
+void Logger::write(LogLevel level, const char* file, int line, std::string message) {
+    std::shared_ptr<LogSink> target = sink();
+    if (!target) {
+        return;
+    }
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.file = file;
+    record.line = line;
+    record.message = std::move(message);
+    target->write(record);
+}
+
+void Logger::flush() {
+    if (std::shared_ptr<LogSink> target = sink()) {
+        target->flush();
+    }
+}
 
 } // namespace utils
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
@@ -0,0 +1,89 @@
+#include "xenocomm/utils/mapped_file.hpp"
+#include <cerrno>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+MappedRegion::MappedRegion(int fd, int64_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    valid_ = false;
+#ifdef _WIN32
+    (void)fd;
+    (void)offset;
+    error_ = ENOSYS;
+#else
+    // Touching a page past the end of the file raises SIGBUS, so the region must lie within it
+    struct stat info;
+    if (fd < 0 || offset < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+        static_cast<uint64_t>(offset) > static_cast<uint64_t>(info.st_size) ||
+        size > static_cast<uint64_t>(info.st_size) - static_cast<uint64_t>(offset)) {
+        error_ = EINVAL;
+        return;
+    }
+    // mmap() wants a page-aligned offset, so the mapping starts at the page holding the first byte
+    static const int64_t pageSize = ::sysconf(_SC_PAGESIZE);
+    const int64_t aligned = offset - offset % pageSize;
+    const size_t lead = static_cast<size_t>(offset - aligned);
+    if (size > SIZE_MAX - lead) {
+        error_ = EOVERFLOW;
+        return;
+    }
+    void* base = ::mmap(nullptr, size + lead, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(aligned));
+    if (base == MAP_FAILED) {
+        error_ = errno;
+        return;
+    }
+    base_ = base;
+    mappedSize_ = size + lead;
+    data_ = static_cast<const uint8_t*>(base) + lead;
+    size_ = size;
+    valid_ = true;
+#endif
+}
+
+MappedRegion::~MappedRegion() {
+    unmap();
+}
+
+MappedRegion::MappedRegion(MappedRegion&& other) noexcept
+    : base_(std::exchange(other.base_, nullptr)),
+      mappedSize_(std::exchange(other.mappedSize_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      valid_(std::exchange(other.valid_, true)),
+      error_(std::exchange(other.error_, 0)) {}
+
+MappedRegion& MappedRegion::operator=(MappedRegion&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        base_ = std::exchange(other.base_, nullptr);
+        mappedSize_ = std::exchange(other.mappedSize_, 0);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        valid_ = std::exchange(other.valid_, true);
+        error_ = std::exchange(other.error_, 0);
+    }
+    return *this;
+}
+
+void MappedRegion::unmap() {
+#ifndef _WIN32
+    if (base_) {
+        ::munmap(base_, mappedSize_);
+    }
+#endif
+    base_ = nullptr;
+    mappedSize_ = 0;
+}
+
+} // namespace utils
+} // namespace xenocomm
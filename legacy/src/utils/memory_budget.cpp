@@ -0,0 +1,108 @@
+#include "xenocomm/utils/memory_budget.hpp"
+#include <algorithm>
+
+namespace xenocomm {
+namespace utils {
+
+MemoryBudget::MemoryBudget(size_t limitBytes, double highWatermark, double lowWatermark) {
+    setLimit(limitBytes, highWatermark, lowWatermark);
+}
+
+MemoryBudget& MemoryBudget::shared() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+bool MemoryBudget::tryAcquire(size_t bytes) {
+    size_t used = used_.load(std::memory_order_relaxed);
+    while (true) {
+        size_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit != 0 && (bytes > limit || used > limit - bytes)) {
+            return false;
+        }
+        if (used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    updateWatermark(used + bytes);
+    return true;
+}
+
+void MemoryBudget::release(size_t bytes) {
+    size_t used = used_.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+    updateWatermark(used);
+}
+
+void MemoryBudget::setLimit(size_t limitBytes, double highWatermark, double lowWatermark) {
+    highWatermark = std::clamp(highWatermark, 0.0, 1.0);
+    lowWatermark = std::clamp(lowWatermark, 0.0, highWatermark);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        limit_ = limitBytes;
+        // A mark that rounds to zero bytes would never turn pressure off
+        highBytes_ = limitBytes == 0 ? 0 : std::max<size_t>(1, static_cast<size_t>(limitBytes * highWatermark));
+        lowBytes_ = static_cast<size_t>(limitBytes * lowWatermark);
+    }
+    updateWatermark(used_.load(std::memory_order_relaxed));
+}
+
+void MemoryBudget::updateWatermark(size_t used) {
+    // Most calls cross nothing and leave without locking
+    const size_t high = highBytes_.load(std::memory_order_relaxed);
+    const bool on = high_.load(std::memory_order_acquire);
+    if (on ? (high != 0 && used > lowBytes_.load(std::memory_order_relaxed)) : (high == 0 || used < high)) {
+        return;
+    }
+
+    bool next;
+    size_t now;
+    uint64_t transition;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        now = used_.load(std::memory_order_relaxed);
+        const bool current = high_.load(std::memory_order_relaxed);
+        next = current;
+        if (highBytes_ == 0) {
+            next = false;
+        } else if (!current && now >= highBytes_) {
+            next = true;
+        } else if (current && now <= lowBytes_) {
+            next = false;
+        }
+        if (next == current) {
+            return;
+        }
+        high_.store(next, std::memory_order_release);
+        transition = ++transitions_;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(callbackMutex_);
+    if (transition <= delivered_) {
+        return;  // Overtaken by a later transition that has already been delivered
+    }
+    delivered_ = transition;
+    auto callbacks = callbacks_;
+    for (auto& entry : callbacks) {
+        entry.second(next, now);
+        if (delivered_ != transition) {
+            return;  // A callback caused a newer transition, delivered from inside it
+        }
+    }
+}
+
+MemoryBudget::CallbackId MemoryBudget::addWatermarkCallback(WatermarkCallback callback) {
+    std::lock_guard<std::recursive_mutex> lock(callbackMutex_);
+    CallbackId id = nextCallbackId_++;
+    callbacks_.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void MemoryBudget::removeWatermarkCallback(CallbackId id) {
+    std::lock_guard<std::recursive_mutex> lock(callbackMutex_);
+    callbacks_.erase(std::remove_if(callbacks_.begin(), callbacks_.end(),
+                                    [id](const auto& entry) { return entry.first == id; }),
+                     callbacks_.end());
+}
+
+} // namespace utils
+} // namespace xenocomm
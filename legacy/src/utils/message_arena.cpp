@@ -0,0 +1,88 @@
+#include "xenocomm/utils/message_arena.hpp"
+#include "xenocomm/utils/contention_profile.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+constexpr size_t MAX_CACHED_BLOCKS = 8;
+
+struct BlockCache {
+    std::vector<MessageArena::Block> blocks;
+    ~BlockCache();
+};
+
+// Arenas destroyed during thread exit, after the cache itself, free their blocks instead
+thread_local bool cache_destroyed = false;
+thread_local BlockCache cache;
+
+BlockCache::~BlockCache() {
+    cache_destroyed = true;
+}
+
+MessageArena::Block takeBlock(size_t size) {
+    if (!cache_destroyed) {
+        // The smallest cached block that fits
+        auto best = cache.blocks.end();
+        for (auto it = cache.blocks.begin(); it != cache.blocks.end(); ++it) {
+            if (it->size >= size && (best == cache.blocks.end() || it->size < best->size)) {
+                best = it;
+            }
+        }
+        if (best != cache.blocks.end()) {
+            MessageArena::Block block = std::move(*best);
+            *best = std::move(cache.blocks.back());
+            cache.blocks.pop_back();
+            return block;
+        }
+    }
+    XPROFILE_ALLOCATION("message_arena", size);
+    return MessageArena::Block{std::make_unique<std::byte[]>(size), size};
+}
+
+void returnBlock(MessageArena::Block block, size_t overflow) {
+    if (cache_destroyed) {
+        return;
+    }
+    if (overflow > 0 && block.size < MessageArena::MAX_CACHED_SIZE) {
+        // Replaced by one that would have held the whole message
+        size_t size = block.size;
+        while (size < block.size + overflow && size < MessageArena::MAX_CACHED_SIZE) {
+            size *= 2;
+        }
+        XPROFILE_ALLOCATION("message_arena", size);
+        block = MessageArena::Block{std::make_unique<std::byte[]>(size), size};
+    }
+    if (block.size > MessageArena::MAX_CACHED_SIZE) {
+        return;
+    }
+    if (cache.blocks.size() == MAX_CACHED_BLOCKS) {
+        // Keep the larger blocks; they serve any request the smaller ones would
+        auto smallest = std::min_element(cache.blocks.begin(), cache.blocks.end(),
+                                         [](const auto& a, const auto& b) { return a.size < b.size; });
+        if (smallest->size >= block.size) {
+            return;
+        }
+        *smallest = std::move(block);
+        return;
+    }
+    cache.blocks.push_back(std::move(block));
+}
+
+} // namespace
+
+MessageArena::MessageArena(size_t initial_size)
+    : block_(takeBlock(std::max<size_t>(initial_size, 64))),
+      monotonic_(block_.data.get(), block_.size, &upstream_) {}
+
+MessageArena::~MessageArena() {
+    // Heap overflow is freed here; the block itself is handed on
+    monotonic_.release();
+    returnBlock(std::move(block_), upstream_.allocated);
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,379 @@
+#include "xenocomm/utils/metrics_registry.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+size_t threadShardIndex() {
+    // Threads are spread round-robin, so up to METRIC_SHARDS threads never share a shard
+    static std::atomic<size_t> nextIndex{0};
+    thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return index;
+}
+
+uint64_t toBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string formatValue(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    // The shortest form that reads back as the same double, so 0.99 is not printed as 0.98999999999999999
+    char text[32];
+    for (int precision = 15; precision < 17; ++precision) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtod(text, nullptr) == value) {
+            return text;
+        }
+    }
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    return text;
+}
+
+std::string escapeLabelValue(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string escapeHelp(const std::string& help) {
+    std::string out;
+    for (char c : help) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string formatLabels(const MetricLabels& labels) {
+    if (labels.empty()) {
+        return "";
+    }
+    std::string out = "{";
+    for (size_t i = 0; i < labels.size(); ++i) {
+        out += (i ? "," : "") + labels[i].first + "=\"" + escapeLabelValue(labels[i].second) + "\"";
+    }
+    return out + "}";
+}
+
+void checkName(const std::string& name) {
+    if (!MetricsRegistry::validName(name)) {
+        throw std::invalid_argument("Invalid metric name: " + name);
+    }
+}
+
+void checkLabels(const MetricLabels& labels) {
+    for (const auto& label : labels) {
+        if (!MetricsRegistry::validName(label.first) || label.first.find(':') != std::string::npos) {
+            throw std::invalid_argument("Invalid metric label name: " + label.first);
+        }
+    }
+}
+
+} // namespace
+
+void MetricCounter::add(uint64_t amount) {
+    shards_[threadShardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t MetricCounter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void MetricGauge::set(double value) {
+    bits_.store(toBits(value), std::memory_order_relaxed);
+}
+
+void MetricGauge::add(double amount) {
+    uint64_t seen = bits_.load(std::memory_order_relaxed);
+    while (!bits_.compare_exchange_weak(seen, toBits(fromBits(seen) + amount), std::memory_order_relaxed)) {
+    }
+}
+
+double MetricGauge::value() const {
+    return fromBits(bits_.load(std::memory_order_relaxed));
+}
+
+MetricHistogram::~MetricHistogram() {
+    for (auto& shard : shards_) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::record(uint64_t value) {
+    auto& entry = shards_[threadShardIndex()];
+    LatencyHistogram* shard = entry.load(std::memory_order_acquire);
+    if (!shard) {
+        auto* fresh = new LatencyHistogram();
+        if (entry.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+            shard = fresh;
+        } else {
+            delete fresh;
+        }
+    }
+    shard->record(value);
+}
+
+void MetricHistogram::collect(LatencyHistogram& out) const {
+    for (const auto& entry : shards_) {
+        if (const LatencyHistogram* shard = entry.load(std::memory_order_acquire)) {
+            out.merge(*shard);
+        }
+    }
+}
+
+MetricsWriter::Family& MetricsWriter::family(const std::string& name, const char* type, const std::string& help) {
+    checkName(name);
+    auto [it, inserted] = families_.try_emplace(name);
+    if (inserted) {
+        it->second.type = type;
+        it->second.help = help;
+    } else if (it->second.type != type) {
+        throw std::invalid_argument("Metric " + name + " reported as both " + it->second.type + " and " + type);
+    }
+    return it->second;
+}
+
+void MetricsWriter::counter(const std::string& name, const std::string& help, double value,
+                            const MetricLabels& labels) {
+    checkLabels(labels);
+    family(name, "counter", help).samples.push_back({"_total", labels, value});
+}
+
+void MetricsWriter::gauge(const std::string& name, const std::string& help, double value,
+                          const MetricLabels& labels) {
+    checkLabels(labels);
+    family(name, "gauge", help).samples.push_back({"", labels, value});
+}
+
+void MetricsWriter::histogram(const std::string& name, const std::string& help, const LatencyHistogram& histogram,
+                              const MetricLabels& labels) {
+    checkLabels(labels);
+    Family& target = family(name, "histogram", help);
+
+    // Export bounds are one below each power of two: those are bucket edges of
+    // LatencyHistogram, so every cumulative count is exact. The total is taken
+    // from the same bucket reads so +Inf and _count always agree with them
+    std::array<uint64_t, LatencyHistogram::MAX_MAGNITUDE + 1> cumulative{};
+    uint64_t total = 0;
+    for (size_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+        const uint64_t upper = LatencyHistogram::bucket_upper_bound(bucket);
+        const unsigned power = upper == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(upper));
+        const uint64_t n = histogram.bucket_count(bucket);
+        total += n;
+        if (power < cumulative.size()) {
+            cumulative[power] += n;
+        }
+    }
+    uint64_t seen = 0;
+    for (size_t power = 0; power < cumulative.size(); ++power) {
+        seen += cumulative[power];
+        MetricLabels bucket_labels = labels;
+        bucket_labels.emplace_back("le", formatValue(static_cast<double>((uint64_t(1) << power) - 1)));
+        target.samples.push_back({"_bucket", std::move(bucket_labels), static_cast<double>(seen)});
+    }
+    MetricLabels inf_labels = labels;
+    inf_labels.emplace_back("le", "+Inf");
+    target.samples.push_back({"_bucket", std::move(inf_labels), static_cast<double>(total)});
+    target.samples.push_back({"_sum", labels, static_cast<double>(histogram.sum())});
+    target.samples.push_back({"_count", labels, static_cast<double>(total)});
+}
+
+void MetricsWriter::summary(const std::string& name, const std::string& help, uint64_t count, double sum,
+                            const std::vector<std::pair<double, double>>& quantiles, const MetricLabels& labels) {
+    checkLabels(labels);
+    Family& target = family(name, "summary", help);
+    for (const auto& [quantile, value] : quantiles) {
+        MetricLabels quantile_labels = labels;
+        quantile_labels.emplace_back("quantile", formatValue(quantile));
+        target.samples.push_back({"", std::move(quantile_labels), value});
+    }
+    target.samples.push_back({"_sum", labels, sum});
+    target.samples.push_back({"_count", labels, static_cast<double>(count)});
+}
+
+MetricsRegistration::MetricsRegistration(MetricsRegistration&& other) noexcept
+    : registry_(other.registry_), id_(other.id_) {
+    other.registry_ = nullptr;
+}
+
+MetricsRegistration& MetricsRegistration::operator=(MetricsRegistration&& other) noexcept {
+    if (this != &other) {
+        reset();
+        registry_ = other.registry_;
+        id_ = other.id_;
+        other.registry_ = nullptr;
+    }
+    return *this;
+}
+
+void MetricsRegistration::reset() {
+    if (registry_) {
+        registry_->removeCollector(id_);
+        registry_ = nullptr;
+    }
+}
+
+MetricsRegistry& MetricsRegistry::shared() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+bool MetricsRegistry::validName(const std::string& name) {
+    if (name.empty()) {
+        return false;
+    }
+    for (size_t i = 0; i < name.size(); ++i) {
+        const char c = name[i];
+        const bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        if (!letter && !(i > 0 && c >= '0' && c <= '9')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(const std::string& name, const char* type,
+                                                 const std::string& help, const MetricLabels& labels) {
+    checkName(name);
+    checkLabels(labels);
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    auto [it, inserted] = metrics_.try_emplace(name);
+    Entry& entry = it->second;
+    if (inserted) {
+        entry.type = type;
+        entry.help = help;
+    } else if (entry.type != type) {
+        throw std::invalid_argument("Metric " + name + " is already registered as a " + entry.type);
+    }
+    Series& series = entry.series[labels];
+    series.labels = labels;
+    return series;
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                        const MetricLabels& labels) {
+    Series& target = series(name, "counter", help, labels);
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    if (!target.counter) {
+        target.counter = std::make_unique<MetricCounter>();
+    }
+    return *target.counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    Series& target = series(name, "gauge", help, labels);
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    if (!target.gauge) {
+        target.gauge = std::make_unique<MetricGauge>();
+    }
+    return *target.gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                            const MetricLabels& labels) {
+    Series& target = series(name, "histogram", help, labels);
+    std::lock_guard<std::mutex> lock(metrics_mutex_);
+    if (!target.histogram) {
+        target.histogram = std::make_unique<MetricHistogram>();
+    }
+    return *target.histogram;
+}
+
+MetricsRegistration MetricsRegistry::addCollector(Collector collector) {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    const uint64_t id = next_collector_id_++;
+    collectors_.emplace(id, std::move(collector));
+    return MetricsRegistration(this, id);
+}
+
+void MetricsRegistry::removeCollector(uint64_t id) {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    collectors_.erase(id);
+}
+
+MetricsWriter MetricsRegistry::collect() const {
+    MetricsWriter writer;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        for (const auto& [name, entry] : metrics_) {
+            for (const auto& [labels, series] : entry.series) {
+                if (series.counter) {
+                    writer.counter(name, entry.help, static_cast<double>(series.counter->value()), labels);
+                } else if (series.gauge) {
+                    writer.gauge(name, entry.help, series.gauge->value(), labels);
+                } else if (series.histogram) {
+                    LatencyHistogram merged;
+                    series.histogram->collect(merged);
+                    writer.histogram(name, entry.help, merged, labels);
+                }
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (const auto& [_, collector] : collectors_) {
+        collector(writer);
+    }
+    return writer;
+}
+
+std::string MetricsRegistry::exposition(ExpositionFormat format) const {
+    const bool openmetrics = format == ExpositionFormat::OPENMETRICS;
+    const MetricsWriter writer = collect();
+    std::string out;
+    for (const auto& [name, family] : writer.families()) {
+        // Prometheus names a counter family after its samples; OpenMetrics leaves off the suffix
+        const std::string family_name = family.type == "counter" && !openmetrics ? name + "_total" : name;
+        if (!family.help.empty()) {
+            out += "# HELP " + family_name + " " + escapeHelp(family.help) + "\n";
+        }
+        out += "# TYPE " + family_name + " " + family.type + "\n";
+        for (const auto& sample : family.samples) {
+            out += name + sample.suffix + formatLabels(sample.labels) + " " + formatValue(sample.value) + "\n";
+        }
+    }
+    if (openmetrics) {
+        out += "# EOF\n";
+    }
+    return out;
+}
+
+} // namespace utils
+} // namespace xenocomm
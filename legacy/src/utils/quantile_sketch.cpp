@@ -0,0 +1,151 @@
+#include "xenocomm/utils/quantile_sketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+constexpr double ZERO_THRESHOLD = 1e-9;
+
+} // namespace
+
+QuantileSketch::QuantileSketch(double relativeAccuracy) : relativeAccuracy_(relativeAccuracy) {
+    if (!(relativeAccuracy > 0.0 && relativeAccuracy < 1.0)) {
+        throw std::invalid_argument("Relative accuracy must be between 0 and 1");
+    }
+    logGamma_ = std::log((1.0 + relativeAccuracy) / (1.0 - relativeAccuracy));
+}
+
+bool QuantileSketch::bucketFor(double value, int& index) const {
+    if (value <= ZERO_THRESHOLD) {
+        return false;
+    }
+    index = static_cast<int>(std::ceil(std::log(value) / logGamma_));
+    return true;
+}
+
+double QuantileSketch::bucketValue(int index) const {
+    // Midpoint, in relative terms, of (gamma^(index-1), gamma^index]
+    double gamma = std::exp(logGamma_);
+    return 2.0 * std::exp(logGamma_ * index) / (gamma + 1.0);
+}
+
+void QuantileSketch::grow(int index) {
+    if (buckets_.empty()) {
+        buckets_.assign(1, 0);
+        offset_ = index;
+    } else if (index < offset_) {
+        buckets_.insert(buckets_.begin(), static_cast<size_t>(offset_ - index), 0);
+        offset_ = index;
+    } else if (index >= offset_ + static_cast<int>(buckets_.size())) {
+        buckets_.resize(static_cast<size_t>(index - offset_ + 1), 0);
+    }
+}
+
+void QuantileSketch::add(double value) {
+    if (!std::isfinite(value)) {
+        return;
+    }
+    value = std::max(value, 0.0);
+    int index;
+    if (bucketFor(value, index)) {
+        grow(index);
+        ++buckets_[static_cast<size_t>(index - offset_)];
+    } else {
+        ++zeroCount_;
+    }
+    ++count_;
+    sum_ += value;
+    sumSquares_ += static_cast<long double>(value) * value;
+}
+
+void QuantileSketch::remove(double value) {
+    if (!std::isfinite(value) || count_ == 0) {
+        return;
+    }
+    value = std::max(value, 0.0);
+    int index;
+    if (bucketFor(value, index)) {
+        auto slot = index - offset_;
+        if (slot < 0 || slot >= static_cast<int>(buckets_.size()) || buckets_[static_cast<size_t>(slot)] == 0) {
+            return;  // Never added
+        }
+        --buckets_[static_cast<size_t>(slot)];
+    } else if (zeroCount_ > 0) {
+        --zeroCount_;
+    } else {
+        return;
+    }
+    if (--count_ == 0) {
+        sum_ = 0;  // Drop the rounding left over from the subtractions
+        sumSquares_ = 0;
+    } else {
+        sum_ -= value;
+        sumSquares_ -= static_cast<long double>(value) * value;
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.relativeAccuracy_ != relativeAccuracy_) {
+        throw std::invalid_argument("Cannot merge sketches of different accuracy");
+    }
+    if (!other.buckets_.empty()) {
+        grow(other.offset_);
+        grow(other.offset_ + static_cast<int>(other.buckets_.size()) - 1);
+        for (size_t i = 0; i < other.buckets_.size(); ++i) {
+            buckets_[static_cast<size_t>(other.offset_ - offset_) + i] += other.buckets_[i];
+        }
+    }
+    zeroCount_ += other.zeroCount_;
+    count_ += other.count_;
+    sum_ += other.sum_;
+    sumSquares_ += other.sumSquares_;
+}
+
+void QuantileSketch::clear() {
+    buckets_.clear();
+    offset_ = 0;
+    zeroCount_ = 0;
+    count_ = 0;
+    sum_ = 0;
+    sumSquares_ = 0;
+}
+
+double QuantileSketch::mean() const {
+    return count_ == 0 ? 0.0 : static_cast<double>(sum_ / count_);
+}
+
+double QuantileSketch::standardDeviation() const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    long double mean = sum_ / count_;
+    long double variance = sumSquares_ / count_ - mean * mean;
+    return variance > 0 ? std::sqrt(static_cast<double>(variance)) : 0.0;
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    auto rank = std::min(count_, static_cast<uint64_t>(q * static_cast<double>(count_)) + 1);
+
+    uint64_t seen = zeroCount_;
+    if (seen >= rank) {
+        return 0.0;
+    }
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return bucketValue(offset_ + static_cast<int>(i));
+        }
+    }
+    return bucketValue(offset_ + static_cast<int>(buckets_.size()) - 1);
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -1,112 +1,380 @@
 #include "xenocomm/utils/serialization.h"
 #include <xenocomm/core/capability_signaler.h> // Ensure Capability struct is known
-#include <stdexcept> // For std::runtime_error (example)
-#include <cstring>   // For memcpy
-#include <arpa/inet.h> // For htonl, ntohl, htons, ntohs
+#include <string>
+#include <unordered_map>
 
 namespace xenocomm {
 namespace utils {
 
-// Placeholder implementation
-// TODO: Implement actual serialization functionality
+namespace {
 
-// Placeholder implementation for serializeCapability
-void serializeCapability(const core::Capability& cap, std::vector<uint8_t>& outBuffer) {
-    // TODO: Implement actual serialization logic as per the header documentation.
-    // This is a very basic placeholder that doesn't follow the specified format.
+constexpr size_t VERSION_BYTES = 6;
+
+size_t varintSize(uint64_t value) {
+    size_t bytes = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++bytes;
+    }
+    return bytes;
+}
+
+size_t stringSize(const std::string& value) {
+    return varintSize(value.size()) + value.size();
+}
+
+// Writes into space the caller has already sized, so encoding never reallocates midway
+class Writer {
+public:
+    explicit Writer(uint8_t* out) : out_(out) {}
+
+    void byte(uint8_t value) { *out_++ = value; }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            *out_++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out_++ = static_cast<uint8_t>(value);
+    }
+
+    void string(const std::string& value) {
+        varint(value.size());
+        out_ = std::copy(value.begin(), value.end(), out_);
+    }
+
+    void version(const core::Version& version) {
+        for (uint16_t part : {version.major, version.minor, version.patch}) {
+            *out_++ = static_cast<uint8_t>(part >> 8);
+            *out_++ = static_cast<uint8_t>(part);
+        }
+    }
+
+private:
+    uint8_t* out_;
+};
+
+// Bounds-checked cursor; every read fails once the input is exhausted or malformed
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool byte(uint8_t& value) {
+        if (p_ == end_) return false;
+        value = *p_++;
+        return true;
+    }
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (p_ == end_) return false;
+            uint8_t b = *p_++;
+            value |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // A count of items each at least minBytes long must fit in what is left
+    bool count(uint64_t& value, size_t minBytes) {
+        return varint(value) && value <= remaining() / minBytes;
+    }
+
+    bool string(std::string_view& value) {
+        uint64_t length = 0;
+        if (!varint(length) || length > remaining()) return false;
+        value = std::string_view(reinterpret_cast<const char*>(p_), static_cast<size_t>(length));
+        p_ += length;
+        return true;
+    }
 
-    // Example: Serialize name length and name
-    uint32_t nameLen = htonl(static_cast<uint32_t>(cap.name.length()));
-    outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&nameLen), reinterpret_cast<const uint8_t*>(&nameLen) + sizeof(nameLen));
-    outBuffer.insert(outBuffer.end(), cap.name.begin(), cap.name.end());
+    bool version(core::Version& version) {
+        if (remaining() < VERSION_BYTES) return false;
+        version.major = static_cast<uint16_t>((p_[0] << 8) | p_[1]);
+        version.minor = static_cast<uint16_t>((p_[2] << 8) | p_[3]);
+        version.patch = static_cast<uint16_t>((p_[4] << 8) | p_[5]);
+        p_ += VERSION_BYTES;
+        return true;
+    }
 
-    // Example: Serialize version (highly simplified)
-    uint16_t major = htons(cap.version.major);
-    uint16_t minor = htons(cap.version.minor);
-    uint16_t patch = htons(cap.version.patch);
-    outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&major), reinterpret_cast<const uint8_t*>(&major) + sizeof(major));
-    outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&minor), reinterpret_cast<const uint8_t*>(&minor) + sizeof(minor));
-    outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&patch), reinterpret_cast<const uint8_t*>(&patch) + sizeof(patch));
+    const uint8_t* position() const { return p_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
 
-    // Example: Serialize parameter count and parameters (highly simplified)
-    uint32_t paramCount = htonl(static_cast<uint32_t>(cap.parameters.size()));
-    outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&paramCount), reinterpret_cast<const uint8_t*>(&paramCount) + sizeof(paramCount));
-    for (const auto& pair : cap.parameters) {
-        uint32_t keyLen = htonl(static_cast<uint32_t>(pair.first.length()));
-        outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&keyLen), reinterpret_cast<const uint8_t*>(&keyLen) + sizeof(keyLen));
-        outBuffer.insert(outBuffer.end(), pair.first.begin(), pair.first.end());
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
 
-        uint32_t valLen = htonl(static_cast<uint32_t>(pair.second.length()));
-        outBuffer.insert(outBuffer.end(), reinterpret_cast<const uint8_t*>(&valLen), reinterpret_cast<const uint8_t*>(&valLen) + sizeof(valLen));
-        outBuffer.insert(outBuffer.end(), pair.second.begin(), pair.second.end());
+// Reads a varint that parse() has already validated
+uint64_t readValidVarint(const uint8_t*& p) {
+    uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        uint8_t b = *p++;
+        value |= uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return value;
+    }
+}
+
+bool versionMatches(const core::Version& offered, const core::Version& required, bool allowPartial) {
+    return allowPartial ? offered.satisfies(required) : offered.isCompatibleWith(required);
+}
+
+} // namespace
+
+void appendVarint(uint64_t value, std::vector<uint8_t>& outBuffer) {
+    size_t start = outBuffer.size();
+    outBuffer.resize(start + varintSize(value));
+    Writer(outBuffer.data() + start).varint(value);
+}
+
+bool readVarint(const uint8_t* data, size_t size, uint64_t& value, size_t* bytesRead) {
+    Reader reader(data, size);
+    if (!reader.varint(value)) {
+        return false;
+    }
+    if (bytesRead) {
+        *bytesRead = size - reader.remaining();
+    }
+    return true;
+}
+
+void serializeCapability(const core::Capability& cap, std::vector<uint8_t>& outBuffer) {
+    size_t size = 1 + stringSize(cap.name) + VERSION_BYTES + varintSize(cap.parameters.size());
+    for (const auto& [key, value] : cap.parameters) {
+        size += stringSize(key) + stringSize(value);
+    }
+
+    size_t start = outBuffer.size();
+    outBuffer.resize(start + size);
+    Writer writer(outBuffer.data() + start);
+    writer.byte(CAPABILITY_FORMAT_V1);
+    writer.string(cap.name);
+    writer.version(cap.version);
+    writer.varint(cap.parameters.size());
+    for (const auto& [key, value] : cap.parameters) {
+        writer.string(key);
+        writer.string(value);
     }
 }
 
-// Placeholder implementation for deserializeCapability
 bool deserializeCapability(const uint8_t* data, size_t size, core::Capability& outCap, size_t* bytesRead) {
-    // TODO: Implement actual deserialization logic as per the header documentation.
-    // This is a very basic placeholder that doesn't follow the specified format
-    // and lacks proper error handling and bounds checking.
-
-    size_t currentOffset = 0;
-
-    // Deserialize name
-    if (size < currentOffset + sizeof(uint32_t)) return false;
-    uint32_t nameLen_n;
-    std::memcpy(&nameLen_n, data + currentOffset, sizeof(uint32_t));
-    uint32_t nameLen = ntohl(nameLen_n);
-    currentOffset += sizeof(uint32_t);
-    if (size < currentOffset + nameLen) return false;
-    outCap.name.assign(reinterpret_cast<const char*>(data + currentOffset), nameLen);
-    currentOffset += nameLen;
-
-    // Deserialize version
-    if (size < currentOffset + sizeof(uint16_t) * 3) return false;
-    uint16_t major_n, minor_n, patch_n;
-    std::memcpy(&major_n, data + currentOffset, sizeof(uint16_t));
-    outCap.version.major = ntohs(major_n);
-    currentOffset += sizeof(uint16_t);
-    std::memcpy(&minor_n, data + currentOffset, sizeof(uint16_t));
-    outCap.version.minor = ntohs(minor_n);
-    currentOffset += sizeof(uint16_t);
-    std::memcpy(&patch_n, data + currentOffset, sizeof(uint16_t));
-    outCap.version.patch = ntohs(patch_n);
-    currentOffset += sizeof(uint16_t);
-
-    // Deserialize parameters
-    if (size < currentOffset + sizeof(uint32_t)) return false;
-    uint32_t paramCount_n;
-    std::memcpy(&paramCount_n, data + currentOffset, sizeof(uint32_t));
-    uint32_t paramCount = ntohl(paramCount_n);
-    currentOffset += sizeof(uint32_t);
-
-    outCap.parameters.clear();
-    for (uint32_t i = 0; i < paramCount; ++i) {
-        if (size < currentOffset + sizeof(uint32_t)) return false;
-        uint32_t keyLen_n;
-        std::memcpy(&keyLen_n, data + currentOffset, sizeof(uint32_t));
-        uint32_t keyLen = ntohl(keyLen_n);
-        currentOffset += sizeof(uint32_t);
-        if (size < currentOffset + keyLen) return false;
-        std::string key(reinterpret_cast<const char*>(data + currentOffset), keyLen);
-        currentOffset += keyLen;
-
-        if (size < currentOffset + sizeof(uint32_t)) return false;
-        uint32_t valLen_n;
-        std::memcpy(&valLen_n, data + currentOffset, sizeof(uint32_t));
-        uint32_t valLen = ntohl(valLen_n);
-        currentOffset += sizeof(uint32_t);
-        if (size < currentOffset + valLen) return false;
-        std::string val(reinterpret_cast<const char*>(data + currentOffset), valLen);
-        currentOffset += valLen;
-        outCap.parameters[key] = val;
+    auto view = CapabilityView::parse(data, size, bytesRead);
+    if (!view) {
+        return false;
+    }
+    outCap = view->toCapability();
+    return true;
+}
+
+void serializeCapabilitySet(const std::vector<core::Capability>& caps, std::vector<uint8_t>& outBuffer) {
+    // Intern every string once; capabilities then refer to them by index
+    std::unordered_map<std::string_view, uint64_t> indices;
+    std::vector<const std::string*> table;
+    auto intern = [&](const std::string& value) {
+        auto [it, inserted] = indices.emplace(value, table.size());
+        if (inserted) {
+            table.push_back(&value);
+        }
+        return it->second;
+    };
+    for (const auto& cap : caps) {
+        intern(cap.name);
+        for (const auto& [key, value] : cap.parameters) {
+            intern(key);
+            intern(value);
+        }
+    }
+
+    size_t size = 1 + varintSize(table.size()) + varintSize(caps.size());
+    for (const std::string* value : table) {
+        size += stringSize(*value);
+    }
+    for (const auto& cap : caps) {
+        size += varintSize(indices[cap.name]) + VERSION_BYTES + varintSize(cap.parameters.size());
+        for (const auto& [key, value] : cap.parameters) {
+            size += varintSize(indices[key]) + varintSize(indices[value]);
+        }
+    }
+
+    size_t start = outBuffer.size();
+    outBuffer.resize(start + size);
+    Writer writer(outBuffer.data() + start);
+    writer.byte(CAPABILITY_SET_FORMAT_V1);
+    writer.varint(table.size());
+    for (const std::string* value : table) {
+        writer.string(*value);
+    }
+    writer.varint(caps.size());
+    for (const auto& cap : caps) {
+        writer.varint(indices[cap.name]);
+        writer.version(cap.version);
+        writer.varint(cap.parameters.size());
+        for (const auto& [key, value] : cap.parameters) {
+            writer.varint(indices[key]);
+            writer.varint(indices[value]);
+        }
+    }
+}
+
+bool deserializeCapabilitySet(const uint8_t* data, size_t size, std::vector<core::Capability>& outCaps) {
+    auto view = CapabilitySetView::parse(data, size);
+    if (!view) {
+        return false;
+    }
+    outCaps = view->toCapabilities();
+    return true;
+}
+
+std::optional<CapabilityView> CapabilityView::parse(const uint8_t* data, size_t size, size_t* bytesRead) {
+    Reader reader(data, size);
+    uint8_t format = 0;
+    if (!reader.byte(format) || format != CAPABILITY_FORMAT_V1) {
+        return std::nullopt;
+    }
+
+    CapabilityView view;
+    uint64_t count = 0;
+    if (!reader.string(view.name_) || !reader.version(view.version_) || !reader.count(count, 2)) {
+        return std::nullopt;
+    }
+    view.parameterCount_ = static_cast<size_t>(count);
+    view.parameters_ = reader.position();
+    for (uint64_t i = 0; i < count; ++i) {
+        std::string_view key;
+        std::string_view value;
+        if (!reader.string(key) || !reader.string(value)) {
+            return std::nullopt;
+        }
     }
 
     if (bytesRead) {
-        *bytesRead = currentOffset;
+        *bytesRead = size - reader.remaining();
+    }
+    return view;
+}
+
+std::string_view CapabilityView::nextString(const uint8_t*& p) const {
+    uint64_t value = readValidVarint(p);
+    if (table_) {
+        return (*table_)[static_cast<size_t>(value)];
+    }
+    std::string_view text(reinterpret_cast<const char*>(p), static_cast<size_t>(value));
+    p += value;
+    return text;
+}
+
+std::optional<std::string_view> CapabilityView::parameter(std::string_view key) const {
+    const uint8_t* p = parameters_;
+    for (size_t i = 0; i < parameterCount_; ++i) {
+        std::string_view k = nextString(p);
+        std::string_view v = nextString(p);
+        if (k == key) {
+            return v;
+        }
+    }
+    return std::nullopt;
+}
+
+bool CapabilityView::matches(const core::Capability& required, bool allowPartial) const {
+    if (name_ != required.name || !versionMatches(version_, required.version, allowPartial)) {
+        return false;
+    }
+    for (const auto& [key, value] : required.parameters) {
+        auto offered = parameter(key);
+        if (!offered || *offered != value) {
+            return false;
+        }
     }
     return true;
 }
 
+core::Capability CapabilityView::toCapability() const {
+    core::Capability cap;
+    cap.name.assign(name_.data(), name_.size());
+    cap.version = version_;
+    forEachParameter([&cap](std::string_view key, std::string_view value) {
+        cap.parameters.emplace(std::string(key), std::string(value));
+    });
+    return cap;
+}
+
+std::optional<CapabilitySetView> CapabilitySetView::parse(const uint8_t* data, size_t size) {
+    Reader reader(data, size);
+    uint8_t format = 0;
+    if (!reader.byte(format) || format != CAPABILITY_SET_FORMAT_V1) {
+        return std::nullopt;
+    }
+
+    CapabilitySetView view;
+    uint64_t strings = 0;
+    if (!reader.count(strings, 1)) {
+        return std::nullopt;
+    }
+    view.table_.resize(static_cast<size_t>(strings));
+    for (auto& value : view.table_) {
+        if (!reader.string(value)) {
+            return std::nullopt;
+        }
+    }
+
+    uint64_t caps = 0;
+    if (!reader.count(caps, 1 + VERSION_BYTES + 1)) {
+        return std::nullopt;
+    }
+    view.entries_.reserve(static_cast<size_t>(caps));
+    auto validIndex = [&](uint64_t& index) { return reader.varint(index) && index < strings; };
+    for (uint64_t i = 0; i < caps; ++i) {
+        view.entries_.push_back(reader.position());
+        uint64_t index = 0;
+        core::Version version;
+        uint64_t parameters = 0;
+        if (!validIndex(index) || !reader.version(version) || !reader.count(parameters, 2)) {
+            return std::nullopt;
+        }
+        for (uint64_t j = 0; j < 2 * parameters; ++j) {
+            if (!validIndex(index)) {
+                return std::nullopt;
+            }
+        }
+    }
+    if (reader.remaining() != 0) {
+        return std::nullopt;
+    }
+    return view;
+}
+
+CapabilityView CapabilitySetView::operator[](size_t index) const {
+    const uint8_t* p = entries_[index];
+    CapabilityView view;
+    view.table_ = &table_;
+    view.name_ = table_[static_cast<size_t>(readValidVarint(p))];
+    view.version_.major = static_cast<uint16_t>((p[0] << 8) | p[1]);
+    view.version_.minor = static_cast<uint16_t>((p[2] << 8) | p[3]);
+    view.version_.patch = static_cast<uint16_t>((p[4] << 8) | p[5]);
+    p += VERSION_BYTES;
+    view.parameterCount_ = static_cast<size_t>(readValidVarint(p));
+    view.parameters_ = p;
+    return view;
+}
+
+bool CapabilitySetView::anyMatches(const core::Capability& required, bool allowPartial) const {
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if ((*this)[i].matches(required, allowPartial)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<core::Capability> CapabilitySetView::toCapabilities() const {
+    std::vector<core::Capability> caps;
+    caps.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        caps.push_back((*this)[i].toCapability());
+    }
+    return caps;
+}
+
 } // namespace utils
-} // namespace xenocomm 
\ No newline at end of file
+} // namespace xenocomm
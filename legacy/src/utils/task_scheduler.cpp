@@ -0,0 +1,163 @@
+#include "xenocomm/utils/task_scheduler.hpp"
+#include <algorithm>
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+// Task the calling worker is running, so cancel() from inside it does not wait on itself
+thread_local const void* currentScheduler = nullptr;
+thread_local TaskScheduler::TaskId currentTask = TaskScheduler::INVALID_TASK;
+
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t threads) {
+    threads_.reserve(std::max<size_t>(threads, 1));
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+        threads_.emplace_back(&TaskScheduler::run, this);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler scheduler(std::min<size_t>(std::max(std::thread::hardware_concurrency() / 4, 2u), 4));
+    return scheduler;
+}
+
+TaskScheduler::TaskId TaskScheduler::add(Task task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TaskId id = nextId_++;
+    tasks_[id].task = std::move(task);
+    return id;
+}
+
+TaskScheduler::TaskId TaskScheduler::scheduleEvery(std::chrono::milliseconds interval, Task task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    TaskId id = nextId_++;
+    auto& entry = tasks_[id];
+    entry.task = std::move(task);
+    entry.interval = std::max(interval, std::chrono::milliseconds(1));
+    queue(id, entry, Clock::now() + entry.interval);
+    lock.unlock();
+    wake_.notify_one();
+    return id;
+}
+
+void TaskScheduler::runBy(TaskId id, Clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end() || it->second.cancelled) {
+        return;
+    }
+    auto& entry = it->second;
+    if (entry.running) {
+        entry.rerun = std::min(entry.rerun, deadline);
+        return;
+    }
+    if (deadline >= entry.due) {
+        return;
+    }
+    bool earliest = queue_.empty() || deadline < queue_.begin()->first;
+    queue(id, entry, deadline);
+    lock.unlock();
+    // Only a new earliest run changes how long the workers should sleep
+    if (earliest) {
+        wake_.notify_one();
+    }
+}
+
+void TaskScheduler::runNow(TaskId id) {
+    runBy(id, Clock::now());
+}
+
+void TaskScheduler::cancel(TaskId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) {
+        return;
+    }
+    auto& entry = it->second;
+    if (!entry.running) {
+        queue_.erase({entry.due, id});
+        tasks_.erase(it);
+        return;
+    }
+    // The worker removes it when the run ends; wait for that unless we are that run
+    entry.cancelled = true;
+    if (currentScheduler != this || currentTask != id) {
+        finished_.wait(lock, [&] { return tasks_.find(id) == tasks_.end(); });
+    }
+}
+
+size_t TaskScheduler::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void TaskScheduler::queue(TaskId id, Entry& entry, Clock::time_point deadline) {
+    if (entry.due != Clock::time_point::max()) {
+        queue_.erase({entry.due, id});
+    }
+    entry.due = deadline;
+    queue_.emplace(deadline, id);
+}
+
+void TaskScheduler::run() {
+    currentScheduler = this;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (queue_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+        auto [due, id] = *queue_.begin();
+        if (due > Clock::now()) {
+            wake_.wait_until(lock, due);
+            continue;
+        }
+        queue_.erase(queue_.begin());
+
+        // Entries are only erased while not running, so the reference stays valid
+        auto& entry = tasks_.at(id);
+        entry.due = Clock::time_point::max();
+        entry.running = true;
+        currentTask = id;
+        lock.unlock();
+        try {
+            entry.task();
+        } catch (...) {
+            // A failing task must not take the worker down with it
+        }
+        lock.lock();
+        currentTask = INVALID_TASK;
+        entry.running = false;
+
+        if (entry.cancelled) {
+            tasks_.erase(id);
+            finished_.notify_all();
+            continue;
+        }
+        auto next = entry.rerun;
+        entry.rerun = Clock::time_point::max();
+        if (entry.interval.count() > 0) {
+            next = std::min(next, Clock::now() + entry.interval);
+        }
+        if (next != Clock::time_point::max()) {
+            queue(id, entry, next);  // This worker looks at the queue again before sleeping
+        }
+    }
+}
+
+} // namespace utils
+} // namespace xenocomm
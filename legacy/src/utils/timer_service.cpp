@@ -0,0 +1,103 @@
+#include "xenocomm/utils/timer_service.hpp"
+
+namespace xenocomm {
+namespace utils {
+
+TimerService::TimerService(std::chrono::milliseconds resolution)
+    : wheel_(resolution),
+      thread_(&TimerService::run, this) {}
+
+TimerService::~TimerService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+TimerService& TimerService::shared() {
+    static TimerService service;
+    return service;
+}
+
+TimerService::TimerId TimerService::scheduleAt(Clock::time_point deadline, Callback callback) {
+    TimerId id;
+    bool earlier;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = wheel_.schedule(std::move(callback), deadline);
+        earlier = deadline < sleep_until_;
+    }
+    // Only a new earliest deadline changes how long the thread should sleep
+    if (earlier) {
+        wake_.notify_one();
+    }
+    return id;
+}
+
+TimerService::TimerId TimerService::scheduleAfter(std::chrono::milliseconds delay, Callback callback) {
+    return scheduleAt(Clock::now() + delay, std::move(callback));
+}
+
+bool TimerService::reschedule(TimerId id, Clock::time_point deadline) {
+    bool moved;
+    bool earlier;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        moved = wheel_.reschedule(id, deadline);
+        earlier = deadline < sleep_until_;
+    }
+    if (moved && earlier) {
+        wake_.notify_one();
+    }
+    return moved;
+}
+
+bool TimerService::cancel(TimerId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wheel_.cancel(id)) {
+        return true;
+    }
+    // Wait out a callback in progress, unless we are that callback
+    if (std::this_thread::get_id() != thread_.get_id()) {
+        finished_.wait(lock, [&] { return running_ != id; });
+    }
+    return false;
+}
+
+size_t TimerService::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wheel_.size();
+}
+
+void TimerService::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        sleep_until_ = wheel_.nextWakeup();
+        if (sleep_until_ == Clock::time_point::max()) {
+            wake_.wait(lock);
+            continue;
+        }
+        if (sleep_until_ > Clock::now()) {
+            wake_.wait_until(lock, sleep_until_);
+            continue;
+        }
+
+        sleep_until_ = Clock::time_point::min();  // Awake: no need to be notified
+        for (auto& [id, callback] : wheel_.expire(Clock::now())) {
+            if (stopping_) {
+                break;
+            }
+            running_ = id;
+            lock.unlock();
+            callback();
+            lock.lock();
+            running_ = INVALID_TIMER;
+            finished_.notify_all();
+        }
+    }
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,228 @@
+#include "xenocomm/utils/trace.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+namespace xenocomm {
+namespace utils {
+
+// A seqlock per slot: the writer marks a slot odd while filling it and even with its
+// index once done, so readers can tell a complete span from one being overwritten
+struct Tracer::Ring {
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> correlation_id{0};
+        std::atomic<uint64_t> start_ns{0};
+        std::atomic<uint64_t> duration_ns{0};
+    };
+
+    explicit Ring(uint32_t id) : thread_id(id) {}
+
+    const uint32_t thread_id;
+    std::atomic<uint64_t> head{0};     // Spans ever written
+    std::atomic<uint64_t> cleared{0};  // head as of the last clear()
+    std::array<Slot, RING_CAPACITY> slots;
+};
+
+namespace {
+
+thread_local uint64_t current_correlation = 0;
+
+std::string escapeJson(const char* text) {
+    std::string out;
+    for (const char* c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", *c);
+            out += code;
+        } else {
+            out += *c;
+        }
+    }
+    return out;
+}
+
+std::string hex64(uint64_t value) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+// splitmix64 finalizer, to spread span identifiers over the whole ID space
+uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+} // namespace
+
+Tracer& Tracer::shared() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+    : unix_offset_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch()).count() -
+                      static_cast<int64_t>(nowNs())) {}
+
+uint64_t Tracer::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t Tracer::currentCorrelation() {
+    return current_correlation;
+}
+
+void Tracer::setCurrentCorrelation(uint64_t correlation_id) {
+    current_correlation = correlation_id;
+}
+
+Tracer::Ring& Tracer::threadRing() {
+    thread_local std::shared_ptr<Ring> ring;
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        ring = std::make_shared<Ring>(static_cast<uint32_t>(rings_.size() + 1));
+        rings_.push_back(ring);
+    }
+    return *ring;
+}
+
+void Tracer::record(const char* name, uint64_t correlation_id, uint64_t start_ns, uint64_t end_ns) {
+    Ring& ring = threadRing();
+    const uint64_t index = ring.head.load(std::memory_order_relaxed);
+    Ring::Slot& slot = ring.slots[index % RING_CAPACITY];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.correlation_id.store(correlation_id, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.duration_ns.store(end_ns > start_ns ? end_ns - start_ns : 0, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+std::vector<TraceEvent> Tracer::snapshot() const {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+    }
+
+    std::vector<TraceEvent> events;
+    for (const auto& ring : rings) {
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t first = std::max({ring->cleared.load(std::memory_order_relaxed),
+                                         head > RING_CAPACITY ? head - RING_CAPACITY : 0});
+        for (uint64_t index = first; index < head; ++index) {
+            const Ring::Slot& slot = ring->slots[index % RING_CAPACITY];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * index + 2) {
+                continue;
+            }
+            TraceEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.correlation_id = slot.correlation_id.load(std::memory_order_relaxed);
+            event.start_ns = slot.start_ns.load(std::memory_order_relaxed);
+            event.duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+            event.thread_id = ring->thread_id;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                events.push_back(event);
+            }
+        }
+    }
+    return events;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+        ring->cleared.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+    // Rings of threads that have exited hold nothing more worth keeping
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const std::shared_ptr<Ring>& ring) { return ring.use_count() == 1; }),
+                 rings_.end());
+}
+
+std::string Tracer::exportChromeTrace() const {
+    const long pid = static_cast<long>(::getpid());
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char number[96];
+    for (const auto& event : snapshot()) {
+        out += first ? "" : ",";
+        first = false;
+        out += "{\"name\":\"" + escapeJson(event.name) + "\",\"cat\":\"xenocomm\",\"ph\":\"X\"";
+        std::snprintf(number, sizeof(number), ",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%u",
+                      event.start_ns / 1000.0, event.duration_ns / 1000.0, pid, event.thread_id);
+        out += number;
+        out += ",\"args\":{\"correlation_id\":" + std::to_string(event.correlation_id) + "}}";
+    }
+    out += "]}";
+    return out;
+}
+
+std::string Tracer::exportOtlpJson(const std::string& service_name) const {
+    const uint64_t pid = static_cast<uint64_t>(::getpid());
+    std::string out = "{\"resourceSpans\":[{\"resource\":{\"attributes\":[{\"key\":\"service.name\","
+                      "\"value\":{\"stringValue\":\"" + escapeJson(service_name.c_str()) + "\"}}]},"
+                      "\"scopeSpans\":[{\"scope\":{\"name\":\"xenocomm\"},\"spans\":[";
+    bool first = true;
+    uint64_t ordinal = 0;
+    for (const auto& event : snapshot()) {
+        // Correlated spans share a trace across processes; the rest get one of their own
+        const std::string trace_id = event.correlation_id != 0
+            ? hex64(0) + hex64(event.correlation_id)
+            : hex64(mix(pid << 32 | event.thread_id)) + hex64(mix(event.start_ns));
+        const uint64_t span_id = mix(pid ^ mix(event.start_ns ^ (static_cast<uint64_t>(event.thread_id) << 48) ^ ordinal++));
+        const int64_t start = static_cast<int64_t>(event.start_ns) + unix_offset_ns_;
+
+        out += first ? "" : ",";
+        first = false;
+        out += "{\"traceId\":\"" + trace_id + "\",\"spanId\":\"" + hex64(span_id ? span_id : 1) + "\"";
+        out += ",\"name\":\"" + escapeJson(event.name) + "\",\"kind\":1";
+        out += ",\"startTimeUnixNano\":\"" + std::to_string(start) + "\"";
+        out += ",\"endTimeUnixNano\":\"" + std::to_string(start + static_cast<int64_t>(event.duration_ns)) + "\"";
+        out += ",\"attributes\":[{\"key\":\"xenocomm.correlation_id\",\"value\":{\"intValue\":\"" +
+               std::to_string(event.correlation_id) + "\"}},{\"key\":\"thread.id\",\"value\":{\"intValue\":\"" +
+               std::to_string(event.thread_id) + "\"}}]}";
+    }
+    out += "]}]}]}";
+    return out;
+}
+
+TraceSpan::TraceSpan(const char* name, bool message) : name_(name), message_(message) {
+    if (!Tracer::shared().enabled()) {
+        return;
+    }
+    active_ = true;
+    if (message_) {
+        outer_correlation_ = Tracer::currentCorrelation();
+        Tracer::setCurrentCorrelation(0);
+    }
+    start_ns_ = Tracer::nowNs();
+}
+
+TraceSpan::~TraceSpan() {
+    if (!active_) {
+        return;
+    }
+    Tracer::shared().record(name_, Tracer::currentCorrelation(), start_ns_, Tracer::nowNs());
+    if (message_) {
+        Tracer::setCurrentCorrelation(outer_correlation_);
+    }
+}
+
+} // namespace utils
+} // namespace xenocomm
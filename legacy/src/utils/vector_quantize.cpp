@@ -0,0 +1,515 @@
+#include "xenocomm/utils/vector_quantize.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define XENOCOMM_QUANTIZE_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define XENOCOMM_QUANTIZE_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+// min first so a NaN product clamps to 255, as the vector min instructions do
+inline uint8_t quantizeOne(float value, float scale, float bias) {
+    return static_cast<uint8_t>(std::max(0.0f, std::min(255.0f, value * scale + bias)));
+}
+
+void quantizeScalar(const float* src, uint8_t* dst, size_t count, float scale, float bias) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = quantizeOne(src[i], scale, bias);
+    }
+}
+
+void dequantizeScalar(const uint8_t* src, float* dst, size_t count, float step, float offset) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * step + offset;
+    }
+}
+
+void rangeScalar(const float* src, size_t count, float& min, float& max) {
+    for (size_t i = 0; i < count; ++i) {
+        // Comparisons with NaN are false, so NaNs never replace a bound
+        if (src[i] < min) min = src[i];
+        if (src[i] > max) max = src[i];
+    }
+}
+
+inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Round-to-nearest-even narrowing without relying on F16C
+uint16_t halfFromFloat(float value) {
+    constexpr uint32_t FLOAT_INFINITY = 255u << 23;
+    constexpr uint32_t HALF_OVERFLOW = (127u + 16) << 23;  // 2^16; values from 65520 round up to infinity below
+    constexpr uint32_t HALF_MIN_NORMAL = 113u << 23;       // 2^-14
+    constexpr uint32_t SUBNORMAL_MAGIC = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits = floatBits(value);
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint16_t half;
+    if (bits >= HALF_OVERFLOW) {
+        half = bits > FLOAT_INFINITY ? 0x7E00 : 0x7C00;
+    } else if (bits < HALF_MIN_NORMAL) {
+        // Adding the magic number lets the FPU round the mantissa into place
+        half = static_cast<uint16_t>(floatBits(bitsFloat(bits) + bitsFloat(SUBNORMAL_MAGIC)) - SUBNORMAL_MAGIC);
+    } else {
+        uint32_t odd = (bits >> 13) & 1;
+        bits += ((15u - 127) << 23) + 0xFFF + odd;  // Rebias the exponent and round
+        half = static_cast<uint16_t>(bits >> 13);
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+float floatFromHalf(uint16_t half) {
+    const uint32_t sign = uint32_t(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1F;
+    const uint32_t mantissa = half & 0x3FF;
+    if (exponent == 0) {
+        float magnitude = static_cast<float>(mantissa) * bitsFloat(103u << 23);  // mantissa * 2^-24
+        return bitsFloat(floatBits(magnitude) | sign);
+    }
+    if (exponent == 0x1F) {
+        return bitsFloat(sign | 0x7F800000u | (mantissa << 13));
+    }
+    return bitsFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+inline uint16_t bfloat16FromFloat(float value) {
+    uint32_t bits = floatBits(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40);  // Keep NaNs quiet rather than rounding them to infinity
+    }
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+void toHalfScalar(const float* src, uint16_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = halfFromFloat(src[i]);
+    }
+}
+
+void fromHalfScalar(const uint16_t* src, float* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = floatFromHalf(src[i]);
+    }
+}
+
+void toBfloat16Scalar(const float* src, uint16_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = bfloat16FromFloat(src[i]);
+    }
+}
+
+void fromBfloat16Scalar(const uint16_t* src, float* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = bitsFloat(uint32_t(src[i]) << 16);
+    }
+}
+
+#ifdef XENOCOMM_QUANTIZE_HAVE_X86
+__attribute__((target("avx2")))
+inline __m256i quantizeAvx2x8(const float* src, __m256 scale, __m256 bias, __m256 low, __m256 high) {
+    __m256 scaled = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(src), scale), bias);
+    // MINPS returns its second operand when either is NaN
+    return _mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(scaled, high), low));
+}
+
+__attribute__((target("avx2")))
+void quantizeAvx2(const float* src, uint8_t* dst, size_t count, float scale, float bias) {
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vbias = _mm256_set1_ps(bias);
+    const __m256 low = _mm256_setzero_ps();
+    const __m256 high = _mm256_set1_ps(255.0f);
+    // Packing works within 128-bit lanes; this gathers the dwords back into order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i a = quantizeAvx2x8(src + i, vscale, vbias, low, high);
+        __m256i b = quantizeAvx2x8(src + i + 8, vscale, vbias, low, high);
+        __m256i c = quantizeAvx2x8(src + i + 16, vscale, vbias, low, high);
+        __m256i d = quantizeAvx2x8(src + i + 24, vscale, vbias, low, high);
+        __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permutevar8x32_epi32(bytes, order));
+    }
+    quantizeScalar(src + i, dst + i, count - i, scale, bias);
+}
+
+__attribute__((target("avx2")))
+void dequantizeAvx2(const uint8_t* src, float* dst, size_t count, float step, float offset) {
+    const __m256 vstep = _mm256_set1_ps(step);
+    const __m256 voffset = _mm256_set1_ps(offset);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i widened = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        __m256 value = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(widened), vstep), voffset);
+        _mm256_storeu_ps(dst + i, value);
+    }
+    dequantizeScalar(src + i, dst + i, count - i, step, offset);
+}
+
+__attribute__((target("avx2")))
+void rangeAvx2(const float* src, size_t count, float& min, float& max) {
+    __m256 vmin = _mm256_set1_ps(min);
+    __m256 vmax = _mm256_set1_ps(max);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_loadu_ps(src + i);
+        // Value first: a NaN loses to the running bound in the second operand
+        vmin = _mm256_min_ps(value, vmin);
+        vmax = _mm256_max_ps(value, vmax);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, vmin);
+    min = *std::min_element(lanes, lanes + 8);
+    _mm256_store_ps(lanes, vmax);
+    max = *std::max_element(lanes, lanes + 8);
+    rangeScalar(src + i, count - i, min, max);
+}
+
+__attribute__((target("avx2,f16c")))
+void toHalfAvx2(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), halves);
+    }
+    toHalfScalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2,f16c")))
+void fromHalfAvx2(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(halves));
+    }
+    fromHalfScalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+inline __m256i bfloat16Avx2x8(const float* src) {
+    __m256 value = _mm256_loadu_ps(src);
+    __m256i bits = _mm256_castps_si256(value);
+    __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF)));
+    __m256i quiet = _mm256_or_si256(bits, _mm256_set1_epi32(0x400000));
+    __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+    return _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, nan), 16);
+}
+
+__attribute__((target("avx2")))
+void toBfloat16Avx2(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        // Packing works within 128-bit lanes; the permute restores element order
+        __m256i packed = _mm256_packus_epi32(bfloat16Avx2x8(src + i), bfloat16Avx2x8(src + i + 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    toBfloat16Scalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+void fromBfloat16Avx2(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i widened = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_slli_epi32(widened, 16));
+    }
+    fromBfloat16Scalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void quantizeAvx512(const float* src, uint8_t* dst, size_t count, float scale, float bias) {
+    const __m512 vscale = _mm512_set1_ps(scale);
+    const __m512 vbias = _mm512_set1_ps(bias);
+    const __m512 low = _mm512_setzero_ps();
+    const __m512 high = _mm512_set1_ps(255.0f);
+
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        for (size_t j = 0; j < 64; j += 16) {
+            __m512 scaled = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(src + i + j), vscale), vbias);
+            __m512i ints = _mm512_cvttps_epi32(_mm512_max_ps(_mm512_min_ps(scaled, high), low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + j), _mm512_cvtusepi32_epi8(ints));
+        }
+    }
+    quantizeScalar(src + i, dst + i, count - i, scale, bias);
+}
+
+__attribute__((target("avx512f")))
+void dequantizeAvx512(const uint8_t* src, float* dst, size_t count, float step, float offset) {
+    const __m512 vstep = _mm512_set1_ps(step);
+    const __m512 voffset = _mm512_set1_ps(offset);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512i widened = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        __m512 value = _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(widened), vstep), voffset);
+        _mm512_storeu_ps(dst + i, value);
+    }
+    dequantizeScalar(src + i, dst + i, count - i, step, offset);
+}
+
+__attribute__((target("avx512f")))
+void rangeAvx512(const float* src, size_t count, float& min, float& max) {
+    __m512 vmin = _mm512_set1_ps(min);
+    __m512 vmax = _mm512_set1_ps(max);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 value = _mm512_loadu_ps(src + i);
+        vmin = _mm512_min_ps(value, vmin);
+        vmax = _mm512_max_ps(value, vmax);
+    }
+    min = _mm512_reduce_min_ps(vmin);
+    max = _mm512_reduce_max_ps(vmax);
+    rangeScalar(src + i, count - i, min, max);
+}
+__attribute__((target("avx512f")))
+void toHalfAvx512(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i halves = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), halves);
+    }
+    toHalfScalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void fromHalfAvx512(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i halves = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(halves));
+    }
+    fromHalfScalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void toBfloat16Avx512(const float* src, uint16_t* dst, size_t count) {
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i bias = _mm512_set1_epi32(0x7FFF);
+    const __m512i quietBit = _mm512_set1_epi32(0x400000);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 value = _mm512_loadu_ps(src + i);
+        __m512i bits = _mm512_castps_si512(value);
+        __m512i odd = _mm512_and_si512(_mm512_srli_epi32(bits, 16), one);
+        __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(odd, bias));
+        __mmask16 nan = _mm512_cmp_ps_mask(value, value, _CMP_UNORD_Q);
+        rounded = _mm512_mask_or_epi32(rounded, nan, bits, quietBit);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtepi32_epi16(_mm512_srli_epi32(rounded, 16)));
+    }
+    toBfloat16Scalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void fromBfloat16Avx512(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512i widened = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+        _mm512_storeu_si512(dst + i, _mm512_slli_epi32(widened, 16));
+    }
+    fromBfloat16Scalar(src + i, dst + i, count - i);
+}
+#endif
+
+#ifdef XENOCOMM_QUANTIZE_HAVE_NEON
+void quantizeNeon(const float* src, uint8_t* dst, size_t count, float scale, float bias) {
+    const float32x4_t vscale = vdupq_n_f32(scale);
+    const float32x4_t vbias = vdupq_n_f32(bias);
+    const float32x4_t low = vdupq_n_f32(0.0f);
+    const float32x4_t high = vdupq_n_f32(255.0f);
+    auto quantize4 = [&](const float* p) {
+        float32x4_t scaled = vaddq_f32(vmulq_f32(vld1q_f32(p), vscale), vbias);
+        // FMINNM returns the number when one operand is NaN, so NaN clamps to 255
+        return vmovn_u32(vcvtq_u32_f32(vmaxnmq_f32(vminnmq_f32(scaled, high), low)));
+    };
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint16x8_t first = vcombine_u16(quantize4(src + i), quantize4(src + i + 4));
+        uint16x8_t second = vcombine_u16(quantize4(src + i + 8), quantize4(src + i + 12));
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(first), vmovn_u16(second)));
+    }
+    quantizeScalar(src + i, dst + i, count - i, scale, bias);
+}
+
+void dequantizeNeon(const uint8_t* src, float* dst, size_t count, float step, float offset) {
+    const float32x4_t vstep = vdupq_n_f32(step);
+    const float32x4_t voffset = vdupq_n_f32(offset);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t widened = vmovl_u8(vld1_u8(src + i));
+        float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(widened)));
+        float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(widened)));
+        vst1q_f32(dst + i, vaddq_f32(vmulq_f32(lo, vstep), voffset));
+        vst1q_f32(dst + i + 4, vaddq_f32(vmulq_f32(hi, vstep), voffset));
+    }
+    dequantizeScalar(src + i, dst + i, count - i, step, offset);
+}
+
+void rangeNeon(const float* src, size_t count, float& min, float& max) {
+    float32x4_t vmin = vdupq_n_f32(min);
+    float32x4_t vmax = vdupq_n_f32(max);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t value = vld1q_f32(src + i);
+        vmin = vminnmq_f32(vmin, value);
+        vmax = vmaxnmq_f32(vmax, value);
+    }
+    min = vminnmvq_f32(vmin);
+    max = vmaxnmvq_f32(vmax);
+    rangeScalar(src + i, count - i, min, max);
+}
+void toHalfNeon(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    }
+    toHalfScalar(src + i, dst + i, count - i);
+}
+
+void fromHalfNeon(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+    }
+    fromHalfScalar(src + i, dst + i, count - i);
+}
+
+void toBfloat16Neon(const float* src, uint16_t* dst, size_t count) {
+    const uint32x4_t one = vdupq_n_u32(1);
+    const uint32x4_t bias = vdupq_n_u32(0x7FFF);
+    const uint32x4_t quietBit = vdupq_n_u32(0x400000);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t value = vld1q_f32(src + i);
+        uint32x4_t bits = vreinterpretq_u32_f32(value);
+        uint32x4_t odd = vandq_u32(vshrq_n_u32(bits, 16), one);
+        uint32x4_t rounded = vaddq_u32(bits, vaddq_u32(odd, bias));
+        uint32x4_t ordered = vceqq_f32(value, value);  // False only for NaN
+        uint32x4_t result = vbslq_u32(ordered, rounded, vorrq_u32(bits, quietBit));
+        vst1_u16(dst + i, vshrn_n_u32(result, 16));
+    }
+    toBfloat16Scalar(src + i, dst + i, count - i);
+}
+
+void fromBfloat16Neon(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + i), vshll_n_u16(vld1_u16(src + i), 16));
+    }
+    fromBfloat16Scalar(src + i, dst + i, count - i);
+}
+#endif
+
+using QuantizeKernel = void (*)(const float*, uint8_t*, size_t, float, float);
+using DequantizeKernel = void (*)(const uint8_t*, float*, size_t, float, float);
+using RangeKernel = void (*)(const float*, size_t, float&, float&);
+using NarrowKernel = void (*)(const float*, uint16_t*, size_t);
+using WidenKernel = void (*)(const uint16_t*, float*, size_t);
+
+struct QuantizeDispatch {
+    QuantizeKernel quantize;
+    DequantizeKernel dequantize;
+    RangeKernel range;
+    NarrowKernel toHalf;
+    WidenKernel fromHalf;
+    NarrowKernel toBfloat16;
+    WidenKernel fromBfloat16;
+    QuantizeImplementation implementation;
+};
+
+QuantizeDispatch selectKernels() {
+#ifdef XENOCOMM_QUANTIZE_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {quantizeAvx512, dequantizeAvx512, rangeAvx512, toHalfAvx512, fromHalfAvx512,
+                toBfloat16Avx512, fromBfloat16Avx512, QuantizeImplementation::AVX512};
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")) {
+        return {quantizeAvx2, dequantizeAvx2, rangeAvx2, toHalfAvx2, fromHalfAvx2,
+                toBfloat16Avx2, fromBfloat16Avx2, QuantizeImplementation::AVX2};
+    }
+#endif
+#ifdef XENOCOMM_QUANTIZE_HAVE_NEON
+    return {quantizeNeon, dequantizeNeon, rangeNeon, toHalfNeon, fromHalfNeon,
+            toBfloat16Neon, fromBfloat16Neon, QuantizeImplementation::NEON};
+#else
+    return {quantizeScalar, dequantizeScalar, rangeScalar, toHalfScalar, fromHalfScalar,
+            toBfloat16Scalar, fromBfloat16Scalar, QuantizeImplementation::SCALAR};
+#endif
+}
+
+const QuantizeDispatch& dispatch() {
+    static const QuantizeDispatch selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+void quantizeToUint8(const float* src, uint8_t* dst, size_t count, float scale, float bias) {
+    dispatch().quantize(src, dst, count, scale, bias);
+}
+
+void dequantizeFromUint8(const uint8_t* src, float* dst, size_t count, float step, float offset) {
+    dispatch().dequantize(src, dst, count, step, offset);
+}
+
+void floatRange(const float* src, size_t count, float& min, float& max) {
+    min = std::numeric_limits<float>::infinity();
+    max = -std::numeric_limits<float>::infinity();
+    dispatch().range(src, count, min, max);
+}
+
+void floatToHalf(const float* src, uint16_t* dst, size_t count) {
+    dispatch().toHalf(src, dst, count);
+}
+
+void halfToFloat(const uint16_t* src, float* dst, size_t count) {
+    dispatch().fromHalf(src, dst, count);
+}
+
+void floatToBfloat16(const float* src, uint16_t* dst, size_t count) {
+    dispatch().toBfloat16(src, dst, count);
+}
+
+void bfloat16ToFloat(const uint16_t* src, float* dst, size_t count) {
+    dispatch().fromBfloat16(src, dst, count);
+}
+
+QuantizeImplementation activeQuantizeImplementation() {
+    return dispatch().implementation;
+}
+
+} // namespace utils
+} // namespace xenocomm
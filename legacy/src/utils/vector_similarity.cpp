@@ -0,0 +1,168 @@
+#include "xenocomm/utils/vector_similarity.hpp"
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define XENOCOMM_SIMILARITY_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define XENOCOMM_SIMILARITY_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+struct Moments {
+    float dot;
+    float normA;
+    float normB;
+};
+
+inline float cosine(const Moments& m) {
+    float denominator = std::sqrt(m.normA) * std::sqrt(m.normB);
+    return denominator > 0.0f ? m.dot / denominator : 0.0f;
+}
+
+inline void accumulateScalar(const float* a, const float* b, size_t begin, size_t end, Moments& m) {
+    for (size_t i = begin; i < end; ++i) {
+        m.dot += a[i] * b[i];
+        m.normA += a[i] * a[i];
+        m.normB += b[i] * b[i];
+    }
+}
+
+Moments momentsScalar(const float* a, const float* b, size_t dimension) {
+    Moments m{0.0f, 0.0f, 0.0f};
+    accumulateScalar(a, b, 0, dimension, m);
+    return m;
+}
+
+#ifdef XENOCOMM_SIMILARITY_HAVE_X86
+__attribute__((target("avx2,fma")))
+inline float sumAvx2(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,fma")))
+Moments momentsAvx2(const float* a, const float* b, size_t dimension) {
+    // Two accumulators per moment hide the FMA latency
+    __m256 dot0 = _mm256_setzero_ps(), dot1 = _mm256_setzero_ps();
+    __m256 na0 = _mm256_setzero_ps(), na1 = _mm256_setzero_ps();
+    __m256 nb0 = _mm256_setzero_ps(), nb1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dimension; i += 16) {
+        __m256 a0 = _mm256_loadu_ps(a + i), a1 = _mm256_loadu_ps(a + i + 8);
+        __m256 b0 = _mm256_loadu_ps(b + i), b1 = _mm256_loadu_ps(b + i + 8);
+        dot0 = _mm256_fmadd_ps(a0, b0, dot0);
+        dot1 = _mm256_fmadd_ps(a1, b1, dot1);
+        na0 = _mm256_fmadd_ps(a0, a0, na0);
+        na1 = _mm256_fmadd_ps(a1, a1, na1);
+        nb0 = _mm256_fmadd_ps(b0, b0, nb0);
+        nb1 = _mm256_fmadd_ps(b1, b1, nb1);
+    }
+    Moments m{sumAvx2(_mm256_add_ps(dot0, dot1)), sumAvx2(_mm256_add_ps(na0, na1)),
+              sumAvx2(_mm256_add_ps(nb0, nb1))};
+    accumulateScalar(a, b, i, dimension, m);
+    return m;
+}
+
+__attribute__((target("avx512f")))
+Moments momentsAvx512(const float* a, const float* b, size_t dimension) {
+    __m512 dot0 = _mm512_setzero_ps(), dot1 = _mm512_setzero_ps();
+    __m512 na0 = _mm512_setzero_ps(), na1 = _mm512_setzero_ps();
+    __m512 nb0 = _mm512_setzero_ps(), nb1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= dimension; i += 32) {
+        __m512 a0 = _mm512_loadu_ps(a + i), a1 = _mm512_loadu_ps(a + i + 16);
+        __m512 b0 = _mm512_loadu_ps(b + i), b1 = _mm512_loadu_ps(b + i + 16);
+        dot0 = _mm512_fmadd_ps(a0, b0, dot0);
+        dot1 = _mm512_fmadd_ps(a1, b1, dot1);
+        na0 = _mm512_fmadd_ps(a0, a0, na0);
+        na1 = _mm512_fmadd_ps(a1, a1, na1);
+        nb0 = _mm512_fmadd_ps(b0, b0, nb0);
+        nb1 = _mm512_fmadd_ps(b1, b1, nb1);
+    }
+    Moments m{_mm512_reduce_add_ps(_mm512_add_ps(dot0, dot1)), _mm512_reduce_add_ps(_mm512_add_ps(na0, na1)),
+              _mm512_reduce_add_ps(_mm512_add_ps(nb0, nb1))};
+    accumulateScalar(a, b, i, dimension, m);
+    return m;
+}
+#endif
+
+#ifdef XENOCOMM_SIMILARITY_HAVE_NEON
+Moments momentsNeon(const float* a, const float* b, size_t dimension) {
+    float32x4_t dot0 = vdupq_n_f32(0.0f), dot1 = vdupq_n_f32(0.0f);
+    float32x4_t na0 = vdupq_n_f32(0.0f), na1 = vdupq_n_f32(0.0f);
+    float32x4_t nb0 = vdupq_n_f32(0.0f), nb1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= dimension; i += 8) {
+        float32x4_t a0 = vld1q_f32(a + i), a1 = vld1q_f32(a + i + 4);
+        float32x4_t b0 = vld1q_f32(b + i), b1 = vld1q_f32(b + i + 4);
+        dot0 = vfmaq_f32(dot0, a0, b0);
+        dot1 = vfmaq_f32(dot1, a1, b1);
+        na0 = vfmaq_f32(na0, a0, a0);
+        na1 = vfmaq_f32(na1, a1, a1);
+        nb0 = vfmaq_f32(nb0, b0, b0);
+        nb1 = vfmaq_f32(nb1, b1, b1);
+    }
+    Moments m{vaddvq_f32(vaddq_f32(dot0, dot1)), vaddvq_f32(vaddq_f32(na0, na1)),
+              vaddvq_f32(vaddq_f32(nb0, nb1))};
+    accumulateScalar(a, b, i, dimension, m);
+    return m;
+}
+#endif
+
+using MomentsKernel = Moments (*)(const float*, const float*, size_t);
+
+struct SimilarityDispatch {
+    MomentsKernel moments;
+    SimilarityImplementation implementation;
+};
+
+SimilarityDispatch selectKernels() {
+#ifdef XENOCOMM_SIMILARITY_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {momentsAvx512, SimilarityImplementation::AVX512};
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {momentsAvx2, SimilarityImplementation::AVX2};
+    }
+#endif
+#ifdef XENOCOMM_SIMILARITY_HAVE_NEON
+    return {momentsNeon, SimilarityImplementation::NEON};
+#else
+    return {momentsScalar, SimilarityImplementation::SCALAR};
+#endif
+}
+
+const SimilarityDispatch& dispatch() {
+    static const SimilarityDispatch selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+void cosineSimilarityRows(const float* a, const uint32_t* aRows, const float* b, const uint32_t* bRows,
+                          size_t count, size_t dimension, float* out) {
+    const MomentsKernel moments = dispatch().moments;
+    for (size_t i = 0; i < count; ++i) {
+        const float* rowA = a + static_cast<size_t>(aRows ? aRows[i] : i) * dimension;
+        const float* rowB = b + static_cast<size_t>(bRows ? bRows[i] : i) * dimension;
+        out[i] = cosine(moments(rowA, rowB, dimension));
+    }
+}
+
+SimilarityImplementation activeSimilarityImplementation() {
+    return dispatch().implementation;
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,295 @@
+#include "xenocomm/utils/work_stealing_executor.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace xenocomm {
+namespace utils {
+
+namespace {
+
+// Worker the calling thread is, so its own submissions stay on its deque
+thread_local const void* currentExecutor = nullptr;
+thread_local void* currentWorker = nullptr;
+
+struct Cpu {
+    int id;
+    size_t node;
+};
+
+#ifdef __linux__
+// Parses a sysfs CPU list such as "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        const int first = std::atoi(range.c_str());
+        const int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+#endif
+
+// CPUs the process may run on, ordered by NUMA node and then by ID
+std::vector<Cpu> readTopology() {
+    std::vector<Cpu> cpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return cpus;
+    }
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+            std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+            const size_t node = std::strtoul(name.c_str() + 4, nullptr, 10);
+            for (int cpu : parseCpuList(list)) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back({cpu, node});
+                }
+            }
+        }
+        closedir(dir);
+    }
+    if (cpus.empty()) {
+        // No NUMA information, so every allowed CPU is on one node
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back({cpu, 0});
+            }
+        }
+    }
+    std::sort(cpus.begin(), cpus.end(),
+              [](const Cpu& a, const Cpu& b) { return a.node != b.node ? a.node < b.node : a.id < b.id; });
+#endif
+    return cpus;
+}
+
+const std::vector<Cpu>& topology() {
+    static const std::vector<Cpu> cpus = readTopology();
+    return cpus;
+}
+
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(size_t workers, ThreadPinning pinning) : pinning_(pinning) {
+    std::unique_lock<std::shared_mutex> lock(workersMutex_);
+    start(workers == 0 ? defaultWorkers() : workers);
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    std::vector<std::shared_ptr<Worker>> workers;
+    {
+        std::shared_lock<std::shared_mutex> lock(workersMutex_);
+        workers = workers_;
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+WorkStealingExecutor& WorkStealingExecutor::shared() {
+    static WorkStealingExecutor executor;
+    return executor;
+}
+
+size_t WorkStealingExecutor::defaultWorkers() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 1;
+}
+
+void WorkStealingExecutor::start(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        auto worker = std::make_shared<Worker>();
+        worker->index = workers_.size();
+        // The thread blocks on workersMutex_, held by the caller, until the worker is listed
+        worker->thread = std::thread(&WorkStealingExecutor::workerLoop, this, worker);
+        if (pinning_ != ThreadPinning::NONE) {
+            pin(*worker);
+        }
+        workers_.push_back(std::move(worker));
+    }
+    workerCount_.store(workers_.size());
+}
+
+void WorkStealingExecutor::pin(Worker& worker) const {
+    const auto& cpus = topology();
+    if (cpus.empty()) {
+        worker.node = 0;
+        return;
+    }
+    const Cpu& home = cpus[worker.index % cpus.size()];
+    worker.node = pinning_ == ThreadPinning::NONE ? 0 : home.node;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const Cpu& cpu : cpus) {
+        if (pinning_ == ThreadPinning::NONE || (pinning_ == ThreadPinning::CORE && cpu.id == home.id) ||
+            (pinning_ == ThreadPinning::NUMA_NODE && cpu.node == home.node)) {
+            CPU_SET(cpu.id, &set);
+        }
+    }
+    // Best effort: a worker left where it is still runs its tasks
+    pthread_setaffinity_np(worker.thread.native_handle(), sizeof(set), &set);
+#endif
+}
+
+void WorkStealingExecutor::submit(Task task) {
+    {
+        std::shared_lock<std::shared_mutex> lock(workersMutex_);
+        auto* self = static_cast<Worker*>(currentWorker);
+        Worker* target = currentExecutor == this && !self->retiring.load()
+            ? self
+            : workers_[nextQueue_.fetch_add(1, std::memory_order_relaxed) % workers_.size()].get();
+        std::lock_guard<std::mutex> queueLock(target->mutex);
+        target->tasks.push_back(std::move(task));
+        // Counted under the queue lock, so a thief can never take it first
+        pending_.fetch_add(1);
+    }
+    {
+        // A worker about to sleep holds mutex_ while it checks pending_
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cv_.notify_one();
+}
+
+void WorkStealingExecutor::resize(size_t workers) {
+    if (workers == 0) {
+        workers = defaultWorkers();
+    }
+    std::lock_guard<std::mutex> resizing(resizeMutex_);
+    std::vector<std::shared_ptr<Worker>> retired;
+    {
+        std::unique_lock<std::shared_mutex> lock(workersMutex_);
+        if (workers > workers_.size()) {
+            start(workers - workers_.size());
+        }
+        // Retiring from the back keeps every remaining worker's index
+        while (workers_.size() > workers) {
+            auto worker = std::move(workers_.back());
+            workers_.pop_back();
+            worker->retiring.store(true);
+            std::lock_guard<std::mutex> queueLock(worker->mutex);
+            for (auto& task : worker->tasks) {
+                Worker& heir = *workers_[nextQueue_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+                std::lock_guard<std::mutex> heirLock(heir.mutex);
+                heir.tasks.push_back(std::move(task));
+            }
+            worker->tasks.clear();
+            retired.push_back(std::move(worker));
+        }
+        workerCount_.store(workers_.size());
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cv_.notify_all();
+
+    for (auto& worker : retired) {
+        if (worker->thread.get_id() == std::this_thread::get_id()) {
+            worker->thread.detach();  // Exits once the task calling us returns
+        } else {
+            worker->thread.join();
+        }
+    }
+}
+
+void WorkStealingExecutor::setPinning(ThreadPinning pinning) {
+    std::unique_lock<std::shared_mutex> lock(workersMutex_);
+    pinning_ = pinning;
+    for (auto& worker : workers_) {
+        pin(*worker);
+    }
+}
+
+ThreadPinning WorkStealingExecutor::pinning() const {
+    std::shared_lock<std::shared_mutex> lock(workersMutex_);
+    return pinning_;
+}
+
+bool WorkStealingExecutor::tryTake(Worker& self, Task& task) {
+    std::shared_lock<std::shared_mutex> lock(workersMutex_);
+    if (self.retiring.load()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> queueLock(self.mutex);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    // Thieves try their own node first, then the rest
+    const size_t count = workers_.size();
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t offset = 1; offset < count; ++offset) {
+            Worker& victim = *workers_[(self.index + offset) % count];
+            if ((victim.node == self.node) != (pass == 0)) {
+                continue;
+            }
+            std::lock_guard<std::mutex> queueLock(victim.mutex);
+            if (victim.tasks.empty()) {
+                continue;
+            }
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingExecutor::workerLoop(std::shared_ptr<Worker> self) {
+    currentExecutor = this;
+    currentWorker = self.get();
+    for (;;) {
+        Task task;
+        if (tryTake(*self, task)) {
+            try {
+                task();
+            } catch (...) {
+                // A failing task must not take the worker down with it
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stopping_ || self->retiring.load() || pending_.load() > 0; });
+        if (self->retiring.load() || (stopping_ && pending_.load() == 0)) {
+            return;
+        }
+    }
+}
+
+} // namespace utils
+} // namespace xenocomm
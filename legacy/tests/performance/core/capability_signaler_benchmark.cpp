@@ -1,123 +1,227 @@
 #include "xenocomm/core/capability_signaler.h"
 #include "xenocomm/core/version.h"
+#include "xenocomm/utils/latency_histogram.hpp"
 #include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <string>
+#include <tuple>
 #include <vector>
-#include <memory> // Include for std::unique_ptr
 
 using namespace xenocomm::core;
 
-// Define missing types (placeholder definitions - replace with actual ones if they exist)
-namespace xenocomm::core {
-    enum class MatchCriteria {
-        EXACT, // Assuming default is exact match
-        NAME_ONLY, 
-        VERSION_COMPATIBLE
-    };
-    
-    struct VersionFilter {
-        bool checkMinVersion = false;
-        Version minVersion;
-        // Add other filter options if needed
-    };
-} // namespace xenocomm::core
-
 namespace {
 
-// Helper to generate random capabilities
-class CapabilityGenerator {
-public:
-    CapabilityGenerator() : rng_(std::random_device{}()) {}
-
-    Capability generate() {
-        Capability cap;
-        cap.name = "capability_" + std::to_string(nameDist_(rng_));
-        cap.version = Version(
-            versionDist_(rng_),  // major
-            versionDist_(rng_),  // minor
-            versionDist_(rng_)   // patch
-        );
-        return cap;
+constexpr int NAME_COUNT = 1000;    // Distinct capability names across the population
+constexpr int QUERY_POOL = 256;     // Distinct queries issued, so the discovery cache sees a realistic mix
+constexpr int CHURN_AGENTS = 64;    // Agents each writing thread toggles a capability on
+
+// Shape of the registered population; changing any field rebuilds it.
+struct PopulationSpec {
+    int agents;
+    int capsPerAgent;
+    int queryWidth;
+    int selectivity;  // Percent of capabilities carrying the parameter value the queries ask for
+
+    bool operator==(const PopulationSpec& other) const {
+        return std::tie(agents, capsPerAgent, queryWidth, selectivity) ==
+               std::tie(other.agents, other.capsPerAgent, other.queryWidth, other.selectivity);
     }
+};
 
-private:
-    std::mt19937 rng_;
-    std::uniform_int_distribution<> nameDist_{1, 100};     // 100 different capability names
-    std::uniform_int_distribution<> versionDist_{0, 5};    // Version components 0-5
+struct Population {
+    std::unique_ptr<CapabilitySignaler> signaler;
+    std::vector<std::vector<Capability>> queries;
 };
 
-// Benchmark fixture
-class CapabilitySignalerBenchmark : public benchmark::Fixture {
-protected:
-    void SetUp(const benchmark::State& state) override {
-        signaler_ = createInMemoryCapabilitySignaler(); // Use factory
-
-        // Generate test data based on benchmark parameters
-        const int numAgents = state.range(0);
-        const int capsPerAgent = state.range(1);
-        
-        CapabilityGenerator generator;
-        
-        // Register capabilities for each agent
-        for (int i = 0; i < numAgents; ++i) {
-            std::string agentId = "agent_" + std::to_string(i);
-            for (int j = 0; j < capsPerAgent; ++j) {
-                signaler_->registerCapability(agentId, generator.generate()); // Use ->
-            }
-        }
+Capability randomCapability(std::mt19937& rng, int selectivity) {
+    std::uniform_int_distribution<> name(0, NAME_COUNT - 1);
+    std::uniform_int_distribution<> part(0, 5);
+    std::uniform_int_distribution<> percent(0, 99);
+    Capability cap;
+    cap.name = "capability_" + std::to_string(name(rng));
+    cap.version = Version(1, part(rng), part(rng));
+    cap.parameters["region"] = percent(rng) < selectivity ? "hot" : "cold";
+    return cap;
+}
 
-        // Generate some capabilities to search for
-        for (int i = 0; i < 5; ++i) {  // Always search for 5 capabilities
-            searchCapabilities_.push_back(generator.generate());
+// Builds one population at a time and shares it between threads and between
+// benchmarks with the same spec; a 1M agent registry is too slow to rebuild per run.
+std::shared_ptr<Population> populationFor(const PopulationSpec& spec) {
+    static std::mutex mutex;
+    static PopulationSpec cachedSpec{};
+    static std::shared_ptr<Population> cached;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cached && cachedSpec == spec) {
+        return cached;
+    }
+    cached.reset();  // Release the previous registry before building the next one
+
+    auto population = std::make_shared<Population>();
+    population->signaler = createInMemoryCapabilitySignaler();
+    std::mt19937 rng(42);
+
+    std::vector<std::vector<Capability>> sampled;
+    std::vector<CapabilityRegistration> batch;
+    constexpr size_t BATCH_SIZE = 4096;
+    batch.reserve(BATCH_SIZE);
+    for (int i = 0; i < spec.agents; ++i) {
+        std::string agentId = "agent_" + std::to_string(i);
+        std::vector<Capability> caps;
+        for (int j = 0; j < spec.capsPerAgent; ++j) {
+            caps.push_back(randomCapability(rng, spec.selectivity));
+            batch.emplace_back(agentId, caps.back());
         }
+        if (batch.size() >= BATCH_SIZE) {
+            population->signaler->registerCapabilities(batch);
+            batch.clear();
+        }
+        if (static_cast<int>(sampled.size()) < QUERY_POOL && i % (spec.agents / QUERY_POOL + 1) == 0) {
+            sampled.push_back(std::move(caps));
+        }
+    }
+    population->signaler->registerCapabilities(batch);
+
+    // Each query asks for capabilities some registered agent has, at a lower
+    // version, so results are non-empty and their size tracks the population
+    for (auto& caps : sampled) {
+        std::vector<Capability> query;
+        for (int k = 0; k < spec.queryWidth && k < static_cast<int>(caps.size()); ++k) {
+            Capability required(caps[k].name, Version(1, 0, 0));
+            if (spec.selectivity < 100) {
+                required.parameters["region"] = "hot";
+            }
+            query.push_back(std::move(required));
+        }
+        population->queries.push_back(std::move(query));
     }
 
-    std::unique_ptr<CapabilitySignaler> signaler_; // Use unique_ptr to base interface
-    std::vector<Capability> searchCapabilities_;
-};
+    cachedSpec = spec;
+    cached = population;
+    return cached;
+}
 
-} // namespace
+PopulationSpec specFrom(const benchmark::State& state) {
+    return PopulationSpec{static_cast<int>(state.range(0)), static_cast<int>(state.range(1)),
+                          static_cast<int>(state.range(2)), static_cast<int>(state.range(3))};
+}
 
-// --- Benchmarks --- 
-// Note: Need to call methods on the pointer: signaler_->discoverAgents(...)
-// Note: The overload discoverAgents(caps, MatchCriteria, filters) doesn't seem to exist
-//       on the base CapabilitySignaler interface. We might need to cast or use a different approach
-//       if we need to benchmark that specific overload of the InMemory implementation.
-//       For now, benchmarking the base interface methods.
+void reportLatency(benchmark::State& state, const xenocomm::utils::LatencyHistogram& latency) {
+    // Per-thread percentiles, averaged across threads
+    state.counters["p50_ns"] = benchmark::Counter(
+        static_cast<double>(latency.value_at_percentile(50.0)), benchmark::Counter::kAvgThreads);
+    state.counters["p99_ns"] = benchmark::Counter(
+        static_cast<double>(latency.value_at_percentile(99.0)), benchmark::Counter::kAvgThreads);
+}
+
+// Discovery throughput and latency over a static registry
+void discover(benchmark::State& state, bool partialMatch) {
+    auto population = populationFor(specFrom(state));
+    xenocomm::utils::LatencyHistogram latency;
+    size_t next = static_cast<size_t>(state.thread_index()) * 31;
+    size_t found = 0;
 
-// Benchmark discovery (exact match)
-BENCHMARK_DEFINE_F(CapabilitySignalerBenchmark, DiscoverAgentsExact)(benchmark::State& state) {
     for (auto _ : state) {
-        benchmark::DoNotOptimize(
-            signaler_->discoverAgents(searchCapabilities_) // Use ->
-        );
+        const auto& query = population->queries[next++ % population->queries.size()];
+        auto start = std::chrono::steady_clock::now();
+        auto agents = population->signaler->discoverAgents(query, partialMatch);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        found += agents.size();
+        benchmark::DoNotOptimize(agents);
     }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["agents_per_query"] = benchmark::Counter(
+        static_cast<double>(found) / static_cast<double>(state.iterations() ? state.iterations() : 1),
+        benchmark::Counter::kAvgThreads);
+    reportLatency(state, latency);
 }
-BENCHMARK_REGISTER_F(CapabilitySignalerBenchmark, DiscoverAgentsExact)
-    ->Args({10, 5})    
-    ->Args({100, 10})  
-    ->Args({1000, 20}) 
-    ->Unit(benchmark::kMicrosecond)
-    ->Iterations(100);
 
-// Benchmark discovery (partial match)
-BENCHMARK_DEFINE_F(CapabilitySignalerBenchmark, DiscoverAgentsPartial)(benchmark::State& state) {
+void DiscoverAgentsExact(benchmark::State& state) { discover(state, false); }
+void DiscoverAgentsPartial(benchmark::State& state) { discover(state, true); }
+
+// Args: agents, capabilities per agent, query width, parameter selectivity (%)
+void discoveryArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"agents", "caps", "width", "select"})
+        ->ArgsProduct({{10000, 100000, 1000000}, {4, 16}, {1, 4}, {10, 100}})
+        ->Unit(benchmark::kMicrosecond)
+        ->UseRealTime();
+}
+
+BENCHMARK(DiscoverAgentsExact)->Apply(discoveryArgs);
+BENCHMARK(DiscoverAgentsPartial)->Apply(discoveryArgs);
+
+// Mixed discovery and registration churn; the fifth arg is the percentage of
+// operations that are writes, each registering or unregistering a capability
+// on one of the thread's own agents
+void DiscoverAgentsUnderChurn(benchmark::State& state) {
+    auto population = populationFor(specFrom(state));
+    const int writePercent = static_cast<int>(state.range(4));
+    CapabilitySignaler& signaler = *population->signaler;
+
+    std::mt19937 rng(static_cast<unsigned>(state.thread_index()) + 1);
+    std::uniform_int_distribution<> percent(0, 99);
+    std::vector<std::pair<std::string, Capability>> churn;
+    for (int i = 0; i < CHURN_AGENTS; ++i) {
+        churn.emplace_back("churn_" + std::to_string(state.thread_index()) + "_" + std::to_string(i),
+                           randomCapability(rng, static_cast<int>(state.range(3))));
+    }
+    std::vector<bool> registered(churn.size(), false);
+
+    xenocomm::utils::LatencyHistogram readLatency;
+    xenocomm::utils::LatencyHistogram writeLatency;
+    size_t next = static_cast<size_t>(state.thread_index()) * 31;
+    size_t writes = 0;
+
     for (auto _ : state) {
-        benchmark::DoNotOptimize(
-            signaler_->discoverAgents(searchCapabilities_, true) // Use overload with bool
-        );
+        auto start = std::chrono::steady_clock::now();
+        if (percent(rng) < writePercent) {
+            size_t slot = writes++ % churn.size();
+            const auto& [agentId, capability] = churn[slot];
+            if (registered[slot]) {
+                signaler.unregisterCapability(agentId, capability);
+            } else {
+                signaler.registerCapability(agentId, capability);
+            }
+            registered[slot] = !registered[slot];
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            writeLatency.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        } else {
+            const auto& query = population->queries[next++ % population->queries.size()];
+            benchmark::DoNotOptimize(signaler.discoverAgents(query));
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            readLatency.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
     }
+
+    // Leave the shared registry as this run found it
+    for (size_t slot = 0; slot < churn.size(); ++slot) {
+        if (registered[slot]) {
+            signaler.unregisterCapability(churn[slot].first, churn[slot].second);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    reportLatency(state, readLatency);
+    state.counters["write_p99_ns"] = benchmark::Counter(
+        static_cast<double>(writeLatency.value_at_percentile(99.0)), benchmark::Counter::kAvgThreads);
 }
-BENCHMARK_REGISTER_F(CapabilitySignalerBenchmark, DiscoverAgentsPartial)
-    ->Args({10, 5})
-    ->Args({100, 10})
-    ->Args({1000, 20})
+
+// Args: agents, capabilities per agent, query width, parameter selectivity (%), writes (%)
+BENCHMARK(DiscoverAgentsUnderChurn)
+    ->ArgNames({"agents", "caps", "width", "select", "writes"})
+    ->ArgsProduct({{10000, 100000, 1000000}, {8}, {2}, {10}, {0, 1, 10, 50}})
+    ->ThreadRange(1, 16)
     ->Unit(benchmark::kMicrosecond)
-    ->Iterations(100);
+    ->UseRealTime();
 
-// --- Removed benchmarks for non-interface methods --- 
-// BENCHMARK_DEFINE_F(CapabilitySignalerBenchmark, DiscoverAgentsPartialMatch)... 
-// BENCHMARK_DEFINE_F(CapabilitySignalerBenchmark, DiscoverAgentsVersionCompatible)... 
+} // namespace
 
-BENCHMARK_MAIN(); 
\ No newline at end of file
+BENCHMARK_MAIN();
@@ -0,0 +1,145 @@
+#include "xenocomm/core/feedback_loop.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace xenocomm;
+
+namespace {
+
+constexpr size_t OUTCOME_POOL = 4096;  // Distinct outcomes cycled through, so reporting does no generation
+
+FeedbackLoopConfig benchConfig(uint32_t maxStoredOutcomes) {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    config.maxStoredOutcomes = maxStoredOutcomes;
+    return config;
+}
+
+// Outcomes with log-normal latencies, one in twenty failing with one of a few error types
+std::vector<CommunicationOutcome> makeOutcomes(unsigned seed) {
+    static const char* ERRORS[] = {"timeout", "reset", "checksum", "refused"};
+    std::mt19937 rng(seed);
+    std::lognormal_distribution<double> latency(6.0, 0.5);  // Median around 400us
+    std::uniform_int_distribution<uint32_t> bytes(64, 64 * 1024);
+    std::vector<CommunicationOutcome> outcomes;
+    outcomes.reserve(OUTCOME_POOL);
+    for (size_t i = 0; i < OUTCOME_POOL; ++i) {
+        const bool failed = rng() % 20 == 0;
+        outcomes.push_back({!failed, std::chrono::microseconds(static_cast<int64_t>(latency(rng))), bytes(rng),
+                            failed ? 1u : 0u, failed ? 1u : 0u, failed ? ERRORS[rng() % 4] : "",
+                            std::chrono::system_clock::now()});
+    }
+    return outcomes;
+}
+
+void fill(FeedbackLoop& loop, size_t count) {
+    const auto outcomes = makeOutcomes(7);
+    for (size_t i = 0; i < count; ++i) {
+        auto outcome = outcomes[i % outcomes.size()];
+        outcome.timestamp = std::chrono::system_clock::now();
+        loop.reportOutcome(outcome);
+    }
+}
+
+// Outcomes reported per second by every thread together into one loop
+void FeedbackLoopReportOutcome(benchmark::State& state) {
+    static std::unique_ptr<FeedbackLoop> loop;
+    if (state.thread_index() == 0) {
+        loop = std::make_unique<FeedbackLoop>(benchConfig(10000));
+    }
+    const auto outcomes = makeOutcomes(static_cast<unsigned>(state.thread_index()) + 1);
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(loop->reportOutcome(outcomes[next]));
+        next = (next + 1) % outcomes.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        loop.reset();
+    }
+}
+BENCHMARK(FeedbackLoopReportOutcome)->ThreadRange(1, 8)->UseRealTime();
+
+// As above, with each outcome labelled by one of range(0) peers
+void FeedbackLoopReportLabeled(benchmark::State& state) {
+    static std::unique_ptr<FeedbackLoop> loop;
+    if (state.thread_index() == 0) {
+        loop = std::make_unique<FeedbackLoop>(benchConfig(10000));
+    }
+    const auto outcomes = makeOutcomes(static_cast<unsigned>(state.thread_index()) + 1);
+    std::vector<OutcomeLabels> labels;
+    for (int64_t peer = 0; peer < state.range(0); ++peer) {
+        labels.push_back({"peer_" + std::to_string(peer), "tcp", "VECTOR_INT8", "RLE"});
+    }
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(loop->reportOutcome(outcomes[next], labels[next % labels.size()]));
+        next = (next + 1) % outcomes.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        loop.reset();
+    }
+}
+BENCHMARK(FeedbackLoopReportLabeled)->ArgName("peers")->Arg(4)->Arg(64)->ThreadRange(1, 8)->UseRealTime();
+
+// getDetailedMetrics() over range(0) stored outcomes. With range(1) set an
+// outcome arrives before every call, so nothing cached can be reused
+void FeedbackLoopDetailedMetrics(benchmark::State& state) {
+    const auto stored = static_cast<uint32_t>(state.range(0));
+    const bool changing = state.range(1) != 0;
+    FeedbackLoop loop(benchConfig(stored));
+    fill(loop, stored);
+    const auto outcomes = makeOutcomes(3);
+    size_t next = 0;
+    for (auto _ : state) {
+        if (changing) {
+            auto outcome = outcomes[next];
+            outcome.timestamp = std::chrono::system_clock::now();
+            loop.reportOutcome(outcome);
+            next = (next + 1) % outcomes.size();
+        }
+        auto metrics = loop.getDetailedMetrics();
+        benchmark::DoNotOptimize(metrics);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(FeedbackLoopDetailedMetrics)
+    ->ArgNames({"stored", "changing"})
+    ->ArgsProduct({{1000, 10000, 100000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// getDetailedMetrics() on thread 0 while the other threads report outcomes
+void FeedbackLoopQueryUnderIngest(benchmark::State& state) {
+    static std::unique_ptr<FeedbackLoop> loop;
+    if (state.thread_index() == 0) {
+        loop = std::make_unique<FeedbackLoop>(benchConfig(10000));
+        fill(*loop, 10000);
+    }
+    const auto outcomes = makeOutcomes(static_cast<unsigned>(state.thread_index()) + 1);
+    size_t next = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            auto metrics = loop->getDetailedMetrics();
+            benchmark::DoNotOptimize(metrics);
+        } else {
+            benchmark::DoNotOptimize(loop->reportOutcome(outcomes[next]));
+            next = (next + 1) % outcomes.size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        loop.reset();
+    }
+}
+BENCHMARK(FeedbackLoopQueryUnderIngest)->ThreadRange(2, 8)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+} // namespace
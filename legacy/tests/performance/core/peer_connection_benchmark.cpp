@@ -0,0 +1,125 @@
+#include "xenocomm/core/peer_connection.hpp"
+#include "xenocomm/core/tcp_transport.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace xenocomm::core;
+
+namespace {
+
+// What one idle connection may cost in user space, handle and reactor
+// registration together, for 100k peers to fit in tens of megabytes.
+// Kernel socket state comes on top and is not counted.
+constexpr double IDLE_CONNECTION_BUDGET_BYTES = 512;
+
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;  // Large blocks, like the handle slab, are mmapped
+#else
+    return 0;
+#endif
+}
+
+// Each connection takes two descriptors here, so the count is bounded by RLIMIT_NOFILE
+size_t raiseDescriptorLimit() {
+    struct rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return static_cast<size_t>(limit.rlim_cur);
+}
+
+// Heap held by N idle peer connections, per connection
+void IdlePeerConnectionFootprint(benchmark::State& state) {
+    size_t connections = static_cast<size_t>(state.range(0));
+    size_t descriptors = raiseDescriptorLimit();
+    if (connections * 2 + 64 > descriptors) {
+        state.SkipWithError("RLIMIT_NOFILE too low for this many connections");
+        return;
+    }
+
+    EventReactor reactor(2);
+    PeerEngineConfig config;
+    config.maxConnections = connections;
+    double perConnection = 0;
+    PeerConnectionEngine::MemoryStats stats;
+    for (auto _ : state) {
+        PeerConnectionEngine engine(config, reactor);
+        std::vector<int> peers;
+        peers.reserve(connections);
+
+        size_t before = heapInUse();
+        for (size_t i = 0; i < connections; ++i) {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+                state.SkipWithError("socketpair failed");
+                break;
+            }
+            engine.adopt(fds[0]);
+            peers.push_back(fds[1]);
+        }
+        size_t after = heapInUse();
+        stats = engine.memoryStats();
+        perConnection = static_cast<double>(after - before) / static_cast<double>(connections);
+
+        state.PauseTiming();
+        for (int fd : peers) {
+            ::close(fd);
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(connections));
+    state.counters["heap_per_conn"] = perConnection;
+    state.counters["handle_bytes"] = static_cast<double>(PeerConnectionEngine::handleSize());
+    state.counters["buffer_bytes"] = static_cast<double>(stats.bufferBytes);
+    state.counters["engine_bytes"] = static_cast<double>(stats.engineBytes);
+    state.counters["budget_bytes"] = IDLE_CONNECTION_BUDGET_BYTES;
+    if (heapInUse() != 0 && perConnection > IDLE_CONNECTION_BUDGET_BYTES) {
+        state.SkipWithError("Idle connections exceed the per-connection memory budget");
+    }
+}
+
+BENCHMARK(IdlePeerConnectionFootprint)
+    ->ArgName("connections")
+    ->Arg(1000)->Arg(8000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+// The same measurement for unconnected TCPTransport instances, for comparison
+void TcpTransportFootprint(benchmark::State& state) {
+    size_t transports = static_cast<size_t>(state.range(0));
+    double perTransport = 0;
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<TCPTransport>> created;
+        created.reserve(transports);
+        size_t before = heapInUse();
+        for (size_t i = 0; i < transports; ++i) {
+            created.push_back(std::make_unique<TCPTransport>());
+        }
+        perTransport = static_cast<double>(heapInUse() - before) / static_cast<double>(transports);
+    }
+    state.counters["heap_per_transport"] = perTransport;
+    state.counters["sizeof"] = static_cast<double>(sizeof(TCPTransport));
+}
+
+BENCHMARK(TcpTransportFootprint)
+    ->ArgName("transports")
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+} // namespace
+
+BENCHMARK_MAIN();
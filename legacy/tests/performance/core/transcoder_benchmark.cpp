@@ -0,0 +1,268 @@
+#include "xenocomm/core/compressed_state_adapter.h"
+#include "xenocomm/core/compression_algorithms.h"
+#include "xenocomm/core/data_adapters.h"
+#include "xenocomm/core/ggwave_fsk_adapter.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace xenocomm::core;
+
+namespace {
+
+// Shapes of payload the transcoders see in practice; the second benchmark argument
+enum Distribution : int64_t {
+    RANDOM = 0,      // Uniform bytes or floats; the worst case for every compressor
+    SPARSE = 1,      // Mostly zero, one element in twenty set
+    REPETITIVE = 2,  // Runs of 8 to 64 repeated elements
+    TELEMETRY = 3    // Slowly drifting float32 sensor readings with a little noise
+};
+
+const char* distributionName(int64_t distribution) {
+    switch (distribution) {
+        case RANDOM: return "random";
+        case SPARSE: return "sparse";
+        case REPETITIVE: return "repetitive";
+        default: return "telemetry";
+    }
+}
+
+std::vector<float> makeVector(int64_t distribution, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::uniform_int_distribution<size_t> runLength(8, 64);
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count;) {
+        switch (distribution) {
+            case RANDOM:
+                values[i++] = uniform(rng);
+                break;
+            case SPARSE:
+                values[i++] = rng() % 20 == 0 ? uniform(rng) : 0.0f;
+                break;
+            case REPETITIVE: {
+                const float value = uniform(rng);
+                for (size_t run = runLength(rng); run > 0 && i < count; --run) {
+                    values[i++] = value;
+                }
+                break;
+            }
+            default:
+                values[i] = 20.0f + 5.0f * std::sin(static_cast<float>(i) * 0.01f) + noise(rng);
+                ++i;
+                break;
+        }
+    }
+    return values;
+}
+
+// Byte payloads for the byte-oriented compressors; telemetry is float32 readings as laid out in memory
+std::vector<uint8_t> makeBytes(int64_t distribution, size_t size) {
+    if (distribution == TELEMETRY) {
+        auto values = makeVector(TELEMETRY, (size + sizeof(float) - 1) / sizeof(float));
+        std::vector<uint8_t> bytes(size);
+        std::memcpy(bytes.data(), values.data(), size);
+        return bytes;
+    }
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> runLength(8, 64);
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size;) {
+        switch (distribution) {
+            case RANDOM:
+                bytes[i++] = static_cast<uint8_t>(rng());
+                break;
+            case SPARSE:
+                bytes[i++] = rng() % 20 == 0 ? static_cast<uint8_t>(rng() | 1) : 0;
+                break;
+            default: {
+                const auto value = static_cast<uint8_t>(rng());
+                for (size_t run = runLength(rng); run > 0 && i < size; --run) {
+                    bytes[i++] = value;
+                }
+                break;
+            }
+        }
+    }
+    return bytes;
+}
+
+void reportRatio(benchmark::State& state, size_t input, size_t encoded) {
+    state.SetLabel(distributionName(state.range(1)));
+    state.counters["ratio"] = encoded == 0 ? 0.0 : static_cast<double>(input) / static_cast<double>(encoded);
+}
+
+// Payload size (bytes) by distribution
+void PayloadArgs(benchmark::internal::Benchmark* bench) {
+    for (int64_t size : {1 << 10, 1 << 14, 1 << 18, 1 << 20}) {
+        for (int64_t distribution : {RANDOM, SPARSE, REPETITIVE, TELEMETRY}) {
+            bench->Args({size, distribution});
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// VectorInt8Adapter
+// ---------------------------------------------------------------------------
+
+VectorInt8Adapter makeInt8Adapter(bool perBlock) {
+    return perBlock ? VectorInt8Adapter::perBlock() : VectorInt8Adapter(127.0f);
+}
+
+// Encodes float32 vectors to int8; range(2) selects the per-block mode. Each thread has its own adapter
+void VectorInt8Encode(benchmark::State& state) {
+    const auto values = makeVector(state.range(1), static_cast<size_t>(state.range(0)) / sizeof(float));
+    const size_t input = values.size() * sizeof(float);
+    auto adapter = makeInt8Adapter(state.range(2) != 0);
+    std::vector<uint8_t> encoded(adapter.maxEncodedSize(input, DataFormat::VECTOR_FLOAT32));
+    size_t written = 0;
+    for (auto _ : state) {
+        written = adapter.encodeInto(xenocomm::utils::ByteSpan(reinterpret_cast<const uint8_t*>(values.data()), input),
+                                     DataFormat::VECTOR_FLOAT32, xenocomm::utils::MutableByteSpan(encoded));
+        benchmark::DoNotOptimize(encoded.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input));
+    reportRatio(state, input, written);
+}
+
+void VectorInt8Decode(benchmark::State& state) {
+    const auto values = makeVector(state.range(1), static_cast<size_t>(state.range(0)) / sizeof(float));
+    const size_t input = values.size() * sizeof(float);
+    auto adapter = makeInt8Adapter(state.range(2) != 0);
+    const auto encoded = adapter.encode(values.data(), input, DataFormat::VECTOR_FLOAT32);
+    std::vector<uint8_t> decoded(adapter.maxDecodedSize(xenocomm::utils::ByteSpan(encoded), DataFormat::VECTOR_INT8));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(adapter.decodeInto(xenocomm::utils::ByteSpan(encoded), DataFormat::VECTOR_INT8,
+                                                    xenocomm::utils::MutableByteSpan(decoded)));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input));
+    reportRatio(state, input, encoded.size());
+}
+
+void Int8Args(benchmark::internal::Benchmark* bench) {
+    for (int64_t size : {1 << 12, 1 << 16, 1 << 20}) {
+        for (int64_t distribution : {RANDOM, SPARSE, REPETITIVE, TELEMETRY}) {
+            for (int64_t perBlock : {0, 1}) {
+                bench->Args({size, distribution, perBlock});
+            }
+        }
+    }
+}
+
+BENCHMARK(VectorInt8Encode)->Apply(Int8Args)->ThreadRange(1, 8);
+BENCHMARK(VectorInt8Decode)->Apply(Int8Args)->ThreadRange(1, 8);
+
+// ---------------------------------------------------------------------------
+// RunLengthEncoding and DeltaEncoding
+// ---------------------------------------------------------------------------
+
+template <typename Algorithm>
+void Compress(benchmark::State& state) {
+    const auto data = makeBytes(state.range(1), static_cast<size_t>(state.range(0)));
+    Algorithm algorithm;
+    size_t compressed = 0;
+    for (auto _ : state) {
+        auto out = algorithm.compress(data);
+        compressed = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    reportRatio(state, data.size(), compressed);
+}
+
+template <typename Algorithm>
+void Decompress(benchmark::State& state) {
+    const auto data = makeBytes(state.range(1), static_cast<size_t>(state.range(0)));
+    Algorithm algorithm;
+    const auto compressed = algorithm.compress(data);
+    for (auto _ : state) {
+        auto out = algorithm.decompress(compressed);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    reportRatio(state, data.size(), compressed.size());
+}
+
+BENCHMARK_TEMPLATE(Compress, RunLengthEncoding)->Apply(PayloadArgs)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(Decompress, RunLengthEncoding)->Apply(PayloadArgs)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(Compress, DeltaEncoding)->Apply(PayloadArgs)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(Decompress, DeltaEncoding)->Apply(PayloadArgs)->ThreadRange(1, 8);
+
+// ---------------------------------------------------------------------------
+// CompressedStateAdapter, with its header, metadata and algorithm selection
+// ---------------------------------------------------------------------------
+
+void CompressedStateEncode(benchmark::State& state) {
+    const auto data = makeBytes(state.range(1), static_cast<size_t>(state.range(0)));
+    CompressedStateAdapter adapter;
+    size_t encoded = 0;
+    for (auto _ : state) {
+        auto out = adapter.encode(data.data(), data.size(), DataFormat::COMPRESSED_STATE);
+        encoded = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    reportRatio(state, data.size(), encoded);
+}
+
+void CompressedStateDecode(benchmark::State& state) {
+    const auto data = makeBytes(state.range(1), static_cast<size_t>(state.range(0)));
+    CompressedStateAdapter adapter;
+    const auto encoded = adapter.encode(data.data(), data.size(), DataFormat::COMPRESSED_STATE);
+    for (auto _ : state) {
+        auto out = adapter.decode(encoded, DataFormat::COMPRESSED_STATE);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    reportRatio(state, data.size(), encoded.size());
+}
+
+BENCHMARK(CompressedStateEncode)->Apply(PayloadArgs)->ThreadRange(1, 8);
+BENCHMARK(CompressedStateDecode)->Apply(PayloadArgs)->ThreadRange(1, 8);
+
+// ---------------------------------------------------------------------------
+// GgwaveFskAdapter; every byte becomes samples_per_symbol audio samples, so payloads stay small
+// ---------------------------------------------------------------------------
+
+void FskArgs(benchmark::internal::Benchmark* bench) {
+    for (int64_t size : {16, 256, 4096}) {
+        for (int64_t distribution : {RANDOM, SPARSE, REPETITIVE, TELEMETRY}) {
+            bench->Args({size, distribution});
+        }
+    }
+}
+
+void GgwaveFskEncode(benchmark::State& state) {
+    const auto data = makeBytes(state.range(1), static_cast<size_t>(state.range(0)));
+    GgwaveFskAdapter adapter;
+    size_t encoded = 0;
+    for (auto _ : state) {
+        auto out = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+        encoded = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    reportRatio(state, data.size(), encoded);
+}
+
+void GgwaveFskDecode(benchmark::State& state) {
+    const auto data = makeBytes(state.range(1), static_cast<size_t>(state.range(0)));
+    GgwaveFskAdapter adapter;
+    const auto encoded = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+    for (auto _ : state) {
+        auto out = adapter.decode(encoded, DataFormat::GGWAVE_FSK);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    reportRatio(state, data.size(), encoded.size());
+}
+
+BENCHMARK(GgwaveFskEncode)->Apply(FskArgs)->ThreadRange(1, 8);
+BENCHMARK(GgwaveFskDecode)->Apply(FskArgs)->ThreadRange(1, 8);
+
+} // namespace
@@ -0,0 +1,40 @@
+#include "xenocomm/extensions/common_ground/extensibility/strategy_benchmark.hpp"
+#include "xenocomm/extensions/common_ground/extensibility/allocation_tracking.hpp"
+#include "xenocomm/extensions/common_ground/strategies/goal_alignment.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace xenocomm::common_ground;
+
+XENOCOMM_TRACK_ALLOCATIONS()
+
+namespace {
+
+constexpr size_t CORPUS_SIZE = 256;
+constexpr int GOAL_COUNT = 16;  // Distinct remote goals; one in GOAL_COUNT matches the local goal
+
+AlignmentContext goalContext(size_t, std::mt19937& rng) {
+    std::uniform_int_distribution<int> goal(0, GOAL_COUNT - 1);
+    AgentInfo local{"local", "LocalAgent", {}};
+    AgentInfo remote{"remote", "RemoteAgent", {}};
+    return AlignmentContext(local, remote,
+                            {{"remote_goal", std::string("goal") + std::to_string(goal(rng))},
+                             {"remote_intention", std::string("intention0")}});
+}
+
+const bool registered = [] {
+    auto strategy = std::make_shared<GoalAlignmentStrategy>();
+    strategy->setLocalGoal("goal0");
+    strategy->setLocalIntention("intention0");
+    auto corpus = std::make_shared<const ContextCorpus>(generateCorpus(CORPUS_SIZE, goalContext));
+    registerStrategyBenchmark("GoalAlignmentVerify", strategy, corpus)
+        ->ThreadRange(1, 8)
+        ->Unit(benchmark::kNanosecond);
+    return true;
+}();
+
+} // namespace
+
+BENCHMARK_MAIN();
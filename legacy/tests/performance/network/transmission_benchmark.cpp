@@ -0,0 +1,567 @@
+#include <benchmark/benchmark.h>
+#include "xenocomm/core/transmission_manager.h"
+#include "xenocomm/core/connection_manager.hpp"
+#include "xenocomm/core/tcp_transport.hpp"
+#include "xenocomm/core/udp_transport.hpp"
+#include "xenocomm/utils/frame_codec.hpp"
+#include "xenocomm/utils/latency_histogram.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// End-to-end TransmissionManager benchmarks: a sender and a receiver manager exchange
+// messages over an in-memory datagram link, loopback UDP and loopback TCP, with loss,
+// reordering, latency and bandwidth injected on the sending side of every endpoint.
+// Each run reports goodput (bytes_per_second, counting delivered messages only), message
+// latency from send() to the receiver's receive() (p50_us, p99_us), process CPU time per
+// delivered byte (cpu_ns_per_byte) and the sender's retransmissions per message.
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Impairments applied to everything one endpoint sends
+struct LinkProfile {
+    double loss = 0.0;                     // Fraction of datagrams dropped
+    double reorder = 0.0;                  // Fraction held back long enough for later ones to overtake
+    std::chrono::microseconds latency{0};  // One-way delay
+    uint64_t bandwidth_bps = 0;            // Serialization rate; 0 is unlimited
+};
+
+// The parts of TransportProtocol the benchmark transports have no use for
+class BenchTransportBase : public TransportProtocol {
+public:
+    bool connect(const std::string&, const ConnectionConfig&) override { return true; }
+    bool getPeerAddress(std::string& address, uint16_t& port) override {
+        address = "bench";
+        port = 0;
+        return true;
+    }
+    bool setNonBlocking(bool) override { return true; }
+    bool setSendTimeout(const std::chrono::milliseconds&) override { return true; }
+    bool setKeepAlive(bool) override { return true; }
+    bool setTcpNoDelay(bool) override { return true; }
+    bool setReuseAddress(bool) override { return true; }
+    bool setReceiveBufferSize(size_t) override { return true; }
+    bool setSendBufferSize(size_t) override { return true; }
+    std::string getLastError() const override { return "benchmark transport error"; }
+    bool setLocalPort(uint16_t) override { return false; }
+    ConnectionState getState() const override {
+        return isConnected() ? ConnectionState::CONNECTED : ConnectionState::DISCONNECTED;
+    }
+    TransportError getLastErrorCode() const override { return TransportError::NONE; }
+    std::string getErrorDetails() const override { return getLastError(); }
+    bool reconnect(uint32_t, uint32_t) override { return false; }
+    void setStateCallback(std::function<void(ConnectionState)>) override {}
+    void setErrorCallback(std::function<void(TransportError, const std::string&)>) override {}
+    bool checkHealth() override { return isConnected(); }
+};
+
+// Datagrams queued for one endpoint of a MemoryDatagramTransport pair
+struct Mailbox {
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::deque<std::vector<uint8_t>> datagrams;
+    bool closed = false;
+};
+
+// One end of an in-process datagram link; delivery is immediate and lossless, so
+// impairments come only from an ImpairedTransport in front of it
+class MemoryDatagramTransport : public BenchTransportBase {
+public:
+    MemoryDatagramTransport(std::shared_ptr<Mailbox> inbox, std::shared_ptr<Mailbox> outbox)
+        : inbox_(std::move(inbox)), outbox_(std::move(outbox)) {}
+
+    bool disconnect() override {
+        for (auto* mailbox : {inbox_.get(), outbox_.get()}) {
+            std::lock_guard<std::mutex> lock(mailbox->mutex);
+            mailbox->closed = true;
+            mailbox->arrived.notify_all();
+        }
+        return true;
+    }
+    bool isConnected() const override {
+        std::lock_guard<std::mutex> lock(inbox_->mutex);
+        return !inbox_->closed;
+    }
+
+    ssize_t send(const uint8_t* data, size_t size) override {
+        std::lock_guard<std::mutex> lock(outbox_->mutex);
+        if (outbox_->closed) {
+            return -1;
+        }
+        outbox_->datagrams.emplace_back(data, data + size);
+        outbox_->arrived.notify_one();
+        return static_cast<ssize_t>(size);
+    }
+
+    // Like UDPTransport: 0 on timeout, and a timeout of 0 waits indefinitely
+    ssize_t receive(uint8_t* buffer, size_t size) override {
+        std::unique_lock<std::mutex> lock(inbox_->mutex);
+        auto ready = [this] { return inbox_->closed || !inbox_->datagrams.empty(); };
+        const auto timeout = timeout_ms_.load();
+        if (timeout == 0) {
+            inbox_->arrived.wait(lock, ready);
+        } else if (!inbox_->arrived.wait_for(lock, std::chrono::milliseconds(timeout), ready)) {
+            return 0;
+        }
+        if (inbox_->datagrams.empty()) {
+            return -1;
+        }
+        std::vector<uint8_t> datagram = std::move(inbox_->datagrams.front());
+        inbox_->datagrams.pop_front();
+        const size_t copied = std::min(size, datagram.size());
+        std::memcpy(buffer, datagram.data(), copied);
+        return static_cast<ssize_t>(copied);
+    }
+
+    int getSocketFd() const override { return -1; }
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override {
+        timeout_ms_ = static_cast<uint32_t>(timeout.count());
+        return true;
+    }
+
+private:
+    std::shared_ptr<Mailbox> inbox_;
+    std::shared_ptr<Mailbox> outbox_;
+    std::atomic<uint32_t> timeout_ms_{0};
+};
+
+std::pair<std::unique_ptr<MemoryDatagramTransport>, std::unique_ptr<MemoryDatagramTransport>> makeMemoryLink() {
+    auto a = std::make_shared<Mailbox>();
+    auto b = std::make_shared<Mailbox>();
+    return {std::make_unique<MemoryDatagramTransport>(a, b), std::make_unique<MemoryDatagramTransport>(b, a)};
+}
+
+// The accepted end of a loopback TCP connection, reading the frames TCPTransport writes
+class AcceptedStreamTransport : public BenchTransportBase {
+public:
+    explicit AcceptedStreamTransport(int fd) : fd_(fd) {}
+    ~AcceptedStreamTransport() override { ::close(fd_); }
+
+    bool disconnect() override {
+        if (connected_.exchange(false)) {
+            ::shutdown(fd_, SHUT_RDWR);
+        }
+        return true;
+    }
+    bool isConnected() const override { return connected_; }
+    bool isReliableStream() const override { return true; }
+
+    ssize_t send(const uint8_t* data, size_t size) override {
+        return ::send(fd_, data, size, MSG_NOSIGNAL);
+    }
+    ssize_t receive(uint8_t* buffer, size_t size) override {
+        ssize_t n = ::recv(fd_, buffer, size, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return 0;
+        }
+        return n == 0 ? -1 : n;
+    }
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override {
+        utils::ByteSpan payload;
+        utils::FrameDecoder::Status status;
+        while ((status = decoder_.next(payload)) == utils::FrameDecoder::Status::NEED_MORE) {
+            utils::MutableByteSpan space = decoder_.prepare(std::max<size_t>(decoder_.missing(), 65536));
+            ssize_t n = receive(space.data(), space.size());
+            if (n <= 0) {
+                return n;
+            }
+            decoder_.commit(static_cast<size_t>(n));
+        }
+        if (status != utils::FrameDecoder::Status::FRAME) {
+            return -1;
+        }
+        frame = utils::BufferPool::shared().acquire(payload.size());
+        std::memcpy(frame.data(), payload.data(), payload.size());
+        frame.resize(payload.size());
+        return static_cast<ssize_t>(payload.size());
+    }
+
+    int getSocketFd() const override { return fd_; }
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override {
+        timeval tv{static_cast<time_t>(timeout.count() / 1000), static_cast<suseconds_t>(timeout.count() % 1000 * 1000)};
+        return ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+    }
+
+private:
+    const int fd_;
+    std::atomic<bool> connected_{true};
+    utils::FrameDecoder decoder_{utils::FrameLengthEncoding::VARINT};
+};
+
+// Applies a LinkProfile to what inner sends. Outgoing datagrams (or frames, for stream
+// transports) are queued with a delivery time and handed to inner by a forwarding thread;
+// receives pass straight through. Stream transports only see latency and bandwidth,
+// since dropping or reordering bytes of a stream would corrupt it rather than model loss
+class ImpairedTransport : public BenchTransportBase {
+public:
+    ImpairedTransport(TransportProtocol& inner, const LinkProfile& profile, uint32_t seed)
+        : inner_(inner), profile_(profile), random_(seed), forwarder_([this] { forward(); }) {}
+
+    ~ImpairedTransport() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        due_.notify_all();
+        forwarder_.join();
+    }
+
+    bool disconnect() override { return inner_.disconnect(); }
+    bool isConnected() const override { return inner_.isConnected(); }
+    bool isReliableStream() const override { return inner_.isReliableStream(); }
+
+    ssize_t send(const uint8_t* data, size_t size) override {
+        enqueue(utils::ByteSpan(data, size), false);
+        return static_cast<ssize_t>(size);
+    }
+    ssize_t sendFrame(const utils::ByteSpan* parts, size_t count) override {
+        if (!inner_.isReliableStream()) {
+            return TransportProtocol::sendFrame(parts, count);
+        }
+        std::vector<uint8_t> frame;
+        for (size_t i = 0; i < count; ++i) {
+            frame.insert(frame.end(), parts[i].begin(), parts[i].end());
+        }
+        enqueue(frame, true);
+        return static_cast<ssize_t>(frame.size());
+    }
+
+    ssize_t receive(uint8_t* buffer, size_t size) override { return inner_.receive(buffer, size); }
+    ssize_t receiveBuffer(utils::PooledBuffer& buffer, size_t maxSize) override {
+        return inner_.receiveBuffer(buffer, maxSize);
+    }
+    ssize_t receiveFrame(utils::PooledBuffer& frame) override { return inner_.receiveFrame(frame); }
+    int getSocketFd() const override { return inner_.getSocketFd(); }
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override {
+        return inner_.setReceiveTimeout(timeout);
+    }
+
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    struct Pending {
+        Clock::time_point due;
+        uint64_t sequence;  // Keeps equal delivery times in send order
+        bool frame;
+        std::vector<uint8_t> data;
+        bool operator>(const Pending& other) const {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+
+    void enqueue(utils::ByteSpan data, bool frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool datagrams = !frame;
+        if (datagrams && profile_.loss > 0 && chance_(random_) < profile_.loss) {
+            ++dropped_;
+            return;
+        }
+        // Packets leave back to back at the link rate, then spend latency in flight
+        Clock::time_point departure = std::max(Clock::now(), link_free_);
+        if (profile_.bandwidth_bps > 0) {
+            departure += std::chrono::nanoseconds(data.size() * 8 * 1000000000ull / profile_.bandwidth_bps);
+        }
+        link_free_ = departure;
+        Clock::time_point due = departure + profile_.latency;
+        if (datagrams && profile_.reorder > 0 && chance_(random_) < profile_.reorder) {
+            due += profile_.latency + std::chrono::milliseconds(1);
+        }
+        queue_.push(Pending{due, next_sequence_++, frame, data.to_vector()});
+        due_.notify_one();
+    }
+
+    void forward() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            if (stopping_) {
+                return;
+            }
+            if (queue_.empty()) {
+                due_.wait(lock);
+                continue;
+            }
+            if (Clock::now() < queue_.top().due) {
+                due_.wait_until(lock, queue_.top().due);  // A new packet may be due sooner
+                continue;
+            }
+            Pending next = std::move(const_cast<Pending&>(queue_.top()));
+            queue_.pop();
+            lock.unlock();
+            utils::ByteSpan data(next.data);
+            if (next.frame) {
+                inner_.sendFrame(&data, 1);
+            } else {
+                inner_.send(data.data(), data.size());
+            }
+            lock.lock();
+        }
+    }
+
+    TransportProtocol& inner_;
+    const LinkProfile profile_;
+    std::mutex mutex_;
+    std::condition_variable due_;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> queue_;
+    Clock::time_point link_free_{};
+    uint64_t next_sequence_ = 0;
+    bool stopping_ = false;
+    std::mt19937 random_;
+    std::uniform_real_distribution<double> chance_{0.0, 1.0};
+    std::atomic<uint64_t> dropped_{0};
+    std::thread forwarder_;
+};
+
+// TransmissionManager settings under test
+struct ManagerProfile {
+    uint32_t fragment_size = 1024;
+    uint32_t window_bytes = 65535;
+    ErrorCorrectionMode error_correction = ErrorCorrectionMode::CHECKSUM_ONLY;
+    bool fec = false;
+};
+
+// Error-correction modes the benchmarks sweep, as one argument
+enum ErrorCorrectionArg : int64_t { EC_NONE = 0, EC_CHECKSUM = 1, EC_REED_SOLOMON = 2, EC_CHECKSUM_FEC = 3 };
+
+ManagerProfile managerProfile(int64_t fragment_size, int64_t window_kb, int64_t error_correction) {
+    ManagerProfile profile;
+    profile.fragment_size = static_cast<uint32_t>(fragment_size);
+    profile.window_bytes = static_cast<uint32_t>(window_kb * 1024);
+    switch (error_correction) {
+        case EC_NONE: profile.error_correction = ErrorCorrectionMode::NONE; break;
+        case EC_REED_SOLOMON: profile.error_correction = ErrorCorrectionMode::REED_SOLOMON; break;
+        case EC_CHECKSUM_FEC: profile.fec = true; break;
+        default: break;
+    }
+    return profile;
+}
+
+LinkProfile linkProfile(int64_t loss_permille, int64_t reorder_permille, int64_t latency_us, int64_t bandwidth_mbps) {
+    LinkProfile profile;
+    profile.loss = static_cast<double>(loss_permille) / 1000.0;
+    profile.reorder = static_cast<double>(reorder_permille) / 1000.0;
+    profile.latency = std::chrono::microseconds(latency_us);
+    profile.bandwidth_bps = static_cast<uint64_t>(bandwidth_mbps) * 1000000;
+    return profile;
+}
+
+void configure(TransmissionManager& manager, const ManagerProfile& profile) {
+    auto config = manager.get_config();
+    config.security.level = SecurityLevel::LOW;
+    config.enable_logging = false;
+    config.error_correction_mode = profile.error_correction;
+    config.fragment_config.max_fragment_size = profile.fragment_size;
+    config.flow_control.initial_window_size = profile.window_bytes;
+    config.flow_control.max_window_size = profile.window_bytes;
+    config.flow_control.min_window_size = std::min(config.flow_control.min_window_size, profile.window_bytes);
+    config.fec.enabled = profile.fec;
+    manager.set_config(config);
+}
+
+double cpuSeconds() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    auto seconds = [](const timeval& tv) { return static_cast<double>(tv.tv_sec) + tv.tv_usec / 1e6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+// Sends one message per iteration from sender to receiver and waits for it to arrive.
+// The first bytes of each message carry its send time, so the receiving thread can
+// record the latency of every message it completes
+void runExchange(benchmark::State& state, TransportProtocol& sender_transport, TransportProtocol& receiver_transport,
+                 const ManagerProfile& profile, size_t message_size) {
+    ConnectionManager connections;
+    TransmissionManager sender(connections), receiver(connections);
+    configure(sender, profile);
+    configure(receiver, profile);
+    sender.set_transport(&sender_transport);
+    receiver.set_transport(&receiver_transport);
+
+    utils::LatencyHistogram latency_ns;
+    std::mutex mutex;
+    std::condition_variable arrived;
+    uint64_t delivered = 0;
+    uint64_t delivered_bytes = 0;
+    std::atomic<bool> stopping{false};
+    std::thread receiving([&] {
+        while (!stopping) {
+            auto message = receiver.receive(20);
+            if (!message.has_value() || message.value().size() < sizeof(int64_t)) {
+                continue;
+            }
+            int64_t sent_at = 0;
+            std::memcpy(&sent_at, message.value().data(), sizeof(sent_at));
+            latency_ns.record(static_cast<uint64_t>(Clock::now().time_since_epoch().count() - sent_at));
+            std::lock_guard<std::mutex> lock(mutex);
+            ++delivered;
+            delivered_bytes += message.value().size();
+            arrived.notify_one();
+        }
+    });
+
+    std::vector<uint8_t> message(std::max(message_size, sizeof(int64_t)));
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    const double cpu_start = cpuSeconds();
+    uint64_t sent = 0;
+    uint64_t failed_sends = 0;
+    for (auto _ : state) {
+        const int64_t now = Clock::now().time_since_epoch().count();
+        std::memcpy(message.data(), &now, sizeof(now));
+        if (!sender.send(message.data(), message.size()).has_value()) {
+            ++failed_sends;  // Retries ran out; the receiver may still complete it
+        }
+        ++sent;
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!arrived.wait_for(lock, std::chrono::seconds(2), [&] { return delivered >= sent; })) {
+            // Lost for good; count it as not delivered and carry on from here
+            sent = delivered;
+        }
+    }
+    const double cpu_used = cpuSeconds() - cpu_start;
+
+    stopping = true;
+    receiving.join();
+
+    const auto stats = sender.get_stats();
+    state.SetBytesProcessed(static_cast<int64_t>(delivered_bytes));
+    state.SetItemsProcessed(static_cast<int64_t>(delivered));
+    state.counters["p50_us"] = static_cast<double>(latency_ns.value_at_percentile(50)) / 1000.0;
+    state.counters["p99_us"] = static_cast<double>(latency_ns.value_at_percentile(99)) / 1000.0;
+    state.counters["cpu_ns_per_byte"] = delivered_bytes ? cpu_used * 1e9 / static_cast<double>(delivered_bytes) : 0.0;
+    state.counters["retransmits_per_msg"] =
+        benchmark::Counter(static_cast<double>(stats.retransmissions), benchmark::Counter::kAvgIterations);
+    state.counters["failed_sends"] = static_cast<double>(failed_sends);
+}
+
+// Arguments: message bytes, fragment bytes, window KB, ErrorCorrectionArg,
+// loss and reorder per mille, one-way latency in microseconds, bandwidth in Mbit/s (0: unlimited)
+void BM_TransmissionEmulatedLink(benchmark::State& state) {
+    const ManagerProfile manager = managerProfile(state.range(1), state.range(2), state.range(3));
+    const LinkProfile link = linkProfile(state.range(4), state.range(5), state.range(6), state.range(7));
+
+    auto [sender_end, receiver_end] = makeMemoryLink();
+    {
+        ImpairedTransport sender(*sender_end, link, 1);
+        ImpairedTransport receiver(*receiver_end, link, 2);
+        runExchange(state, sender, receiver, manager, static_cast<size_t>(state.range(0)));
+    }
+}
+
+// Same arguments, over two UDPTransports on loopback
+void BM_TransmissionUdpLoopback(benchmark::State& state) {
+    const ManagerProfile manager = managerProfile(state.range(1), state.range(2), state.range(3));
+    const LinkProfile link = linkProfile(state.range(4), state.range(5), state.range(6), state.range(7));
+
+    constexpr uint16_t SENDER_PORT = 39411;
+    constexpr uint16_t RECEIVER_PORT = 39412;
+    ConnectionConfig config;
+    UDPTransport sender_socket, receiver_socket;
+    sender_socket.setReuseAddress(true);
+    receiver_socket.setReuseAddress(true);
+    if (!sender_socket.setLocalPort(SENDER_PORT) || !receiver_socket.setLocalPort(RECEIVER_PORT) ||
+        !sender_socket.connect("127.0.0.1:" + std::to_string(RECEIVER_PORT), config) ||
+        !receiver_socket.connect("127.0.0.1:" + std::to_string(SENDER_PORT), config)) {
+        state.SkipWithError("Cannot open loopback UDP sockets");
+        return;
+    }
+    {
+        ImpairedTransport sender(sender_socket, link, 1);
+        ImpairedTransport receiver(receiver_socket, link, 2);
+        runExchange(state, sender, receiver, manager, static_cast<size_t>(state.range(0)));
+    }
+}
+
+// Arguments: message bytes, one-way latency in microseconds, bandwidth in Mbit/s. TCP is
+// a reliable stream, so messages are framed whole: fragment, window and error-correction
+// settings and injected loss do not apply
+void BM_TransmissionTcpLoopback(benchmark::State& state) {
+    const LinkProfile link = linkProfile(0, 0, state.range(1), state.range(2));
+
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, 1) != 0 || ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        if (listener >= 0) {
+            ::close(listener);
+        }
+        state.SkipWithError("Cannot listen on loopback TCP");
+        return;
+    }
+
+    ConnectionConfig config;
+    config.healthMonitoring = false;
+    TCPTransport client;
+    const bool connected = client.connect("127.0.0.1:" + std::to_string(ntohs(address.sin_port)), config);
+    const int peer = connected ? ::accept(listener, nullptr, nullptr) : -1;
+    ::close(listener);
+    if (peer < 0) {
+        state.SkipWithError("Cannot connect over loopback TCP");
+        return;
+    }
+
+    AcceptedStreamTransport server(peer);
+    {
+        ImpairedTransport sender(client, link, 1);
+        runExchange(state, sender, server, ManagerProfile{}, static_cast<size_t>(state.range(0)));
+    }
+    client.disconnect();
+}
+
+const std::vector<std::string> DATAGRAM_ARG_NAMES = {
+    "msg", "frag", "window_kb", "ec", "loss_pm", "reorder_pm", "latency_us", "mbps"};
+
+// Fragment and window sweeps on a clean link, error correction against loss, and
+// reordering and a constrained link on their own
+void datagramArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames(DATAGRAM_ARG_NAMES);
+    for (int64_t fragment : {512, 1400, 8192}) {
+        for (int64_t window_kb : {16, 256}) {
+            b->Args({256 * 1024, fragment, window_kb, EC_CHECKSUM, 0, 0, 0, 0});
+        }
+    }
+    for (int64_t ec : {EC_NONE, EC_CHECKSUM, EC_REED_SOLOMON, EC_CHECKSUM_FEC}) {
+        for (int64_t loss : {0, 10, 50}) {
+            b->Args({64 * 1024, 1400, 256, ec, loss, 0, 200, 0});
+        }
+    }
+    b->Args({64 * 1024, 1400, 256, EC_CHECKSUM, 0, 50, 200, 0});
+    b->Args({64 * 1024, 1400, 64, EC_CHECKSUM, 10, 10, 5000, 100});
+    b->Args({1024, 1400, 64, EC_CHECKSUM, 0, 0, 0, 0});
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+BENCHMARK(BM_TransmissionEmulatedLink)->Apply(datagramArgs);
+BENCHMARK(BM_TransmissionUdpLoopback)->Apply(datagramArgs);
+BENCHMARK(BM_TransmissionTcpLoopback)
+    ->ArgNames({"msg", "latency_us", "mbps"})
+    ->ArgsProduct({{1024, 64 * 1024, 1024 * 1024}, {0, 200}, {0, 1000}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,225 @@
+#include "xenocomm/core/negotiation_protocol.h"
+#include "xenocomm/core/preference_table.h"
+#include "xenocomm/core/timeout_negotiation_protocol.h"
+#include "xenocomm/utils/latency_histogram.hpp"
+#include "xenocomm/utils/timer_service.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace xenocomm::core;
+
+namespace {
+
+NegotiableParams proposal() {
+    NegotiableParams params;
+    params.dataFormat = DataFormat::VECTOR_FLOAT32;
+    params.compressionAlgorithm = CompressionAlgorithm::ZSTD;
+    params.errorCorrection = ErrorCorrectionScheme::CHECKSUM_ONLY;
+    params.keySize = KeySize::NONE;
+    return params;
+}
+
+// Long enough that no session expires while a benchmark holds it
+TimeoutConfig patientTimeouts() {
+    TimeoutConfig config;
+    config.negotiationTimeout = std::chrono::minutes(10);
+    config.responseTimeout = std::chrono::minutes(10);
+    return config;
+}
+
+void reportLatency(benchmark::State& state, const xenocomm::utils::LatencyHistogram& latency) {
+    // Per-thread percentiles, averaged across threads
+    state.counters["p50_ns"] = benchmark::Counter(
+        static_cast<double>(latency.value_at_percentile(50.0)), benchmark::Counter::kAvgThreads);
+    state.counters["p99_ns"] = benchmark::Counter(
+        static_cast<double>(latency.value_at_percentile(99.0)), benchmark::Counter::kAvgThreads);
+}
+
+uint64_t nanosSince(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+// Heap bytes in use, or 0 where the allocator cannot say
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// Sessions of the concrete protocol are never removed, so each iteration
+// opens a batch on a fresh instance; items_per_second is sessions per second.
+void ConcreteSessionThroughput(benchmark::State& state) {
+    const auto batch = static_cast<size_t>(state.range(0));
+    const auto params = proposal();
+    for (auto _ : state) {
+        auto protocol = createNegotiationProtocol(false);
+        for (size_t i = 0; i < batch; ++i) {
+            auto id = protocol->initiateSession("agent_" + std::to_string(i), params);
+            benchmark::DoNotOptimize(protocol->getSessionState(id));
+            protocol->closeSession(id);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch));
+}
+BENCHMARK(ConcreteSessionThroughput)->ArgName("batch")->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// Latency of a session from proposal to close while other threads
+// negotiate on the same protocol, with the given number of sessions kept open
+// in the background. Closed sessions are expired by the shared timer service.
+void TimeoutSessionLatency(benchmark::State& state) {
+    static std::unique_ptr<TimeoutNegotiationProtocol> protocol;
+    static std::vector<NegotiationProtocol::SessionId> background;
+    if (state.thread_index() == 0) {
+        protocol = std::make_unique<TimeoutNegotiationProtocol>(patientTimeouts(), false);
+        background.clear();
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            background.push_back(protocol->initiateSession("idle_" + std::to_string(i), proposal()));
+        }
+    }
+
+    const auto params = proposal();
+    const std::string peer = "agent_" + std::to_string(state.thread_index());
+    xenocomm::utils::LatencyHistogram latency;
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        auto id = protocol->initiateSession(peer, params);
+        benchmark::DoNotOptimize(protocol->getSessionState(id));
+        protocol->closeSession(id);
+        latency.record(nanosSince(start));
+    }
+    state.SetItemsProcessed(state.iterations());
+    reportLatency(state, latency);
+
+    if (state.thread_index() == 0) {
+        protocol.reset();
+    }
+}
+BENCHMARK(TimeoutSessionLatency)
+    ->ArgName("open")
+    ->Arg(0)->Arg(10000)->Arg(100000)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+// Preferences whose options the remote peer lacks, each with a chain of depth
+// fallbacks of which the remote supports only the last.
+struct FallbackScenario {
+    ParameterPreference preferences;
+    std::vector<DataFormat> remoteFormats;
+    std::vector<CompressionAlgorithm> remoteCompression;
+    std::vector<ErrorCorrectionScheme> remoteErrorCorrection;
+};
+
+template <typename T>
+std::vector<T> chainFallbacks(int first, int depth) {
+    std::vector<T> chain;
+    for (int i = 1; i <= depth; ++i) {
+        chain.push_back(static_cast<T>(first + i));
+    }
+    return chain;
+}
+
+FallbackScenario fallbackScenario(int depth) {
+    // Chains run up the enum from its first value; each enum caps the depth
+    const int formatDepth = std::min(depth, static_cast<int>(DataFormat::VECTOR_INT4));
+    const int compressionDepth = std::min(depth, static_cast<int>(CompressionAlgorithm::ZSTD));
+    const int errorDepth = std::min(depth, static_cast<int>(ErrorCorrectionScheme::REED_SOLOMON));
+
+    FallbackScenario scenario;
+    auto& prefs = scenario.preferences;
+    prefs.dataFormats.emplace_back(DataFormat::VECTOR_FLOAT32, 1, false,
+                                   chainFallbacks<DataFormat>(0, formatDepth));
+    prefs.compressionAlgorithms.emplace_back(CompressionAlgorithm::NONE, 1, false,
+                                             chainFallbacks<CompressionAlgorithm>(0, compressionDepth));
+    prefs.errorCorrectionSchemes.emplace_back(ErrorCorrectionScheme::NONE, 1, false,
+                                              chainFallbacks<ErrorCorrectionScheme>(0, errorDepth));
+    prefs.encryptionAlgorithms.emplace_back(EncryptionAlgorithm::NONE, 1);
+    prefs.keyExchangeMethods.emplace_back(KeyExchangeMethod::NONE, 1);
+    prefs.authenticationMethods.emplace_back(AuthenticationMethod::NONE, 1);
+    prefs.keySizes.emplace_back(KeySize::NONE, 1);
+
+    scenario.remoteFormats = {static_cast<DataFormat>(formatDepth)};
+    scenario.remoteCompression = {static_cast<CompressionAlgorithm>(compressionDepth)};
+    scenario.remoteErrorCorrection = {static_cast<ErrorCorrectionScheme>(errorDepth)};
+    return scenario;
+}
+
+// Cost of settling on the deepest fallback of every data dimension
+void FallbackChainDepth(benchmark::State& state) {
+    auto scenario = fallbackScenario(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        auto params = scenario.preferences.buildCompatibleParamsWithFallbacks(
+            scenario.remoteFormats, scenario.remoteCompression, scenario.remoteErrorCorrection,
+            {}, {}, {}, {});
+        benchmark::DoNotOptimize(params);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(FallbackChainDepth)->ArgName("depth")->DenseRange(0, 7);
+
+// Cost of the alternatives offered after a rejection to a peer that accepts
+// any value, which makes every option and fallback a candidate
+void AlternativeProposalsDepth(benchmark::State& state) {
+    auto scenario = fallbackScenario(static_cast<int>(state.range(0)));
+    const CompiledPreference compiled(scenario.preferences);
+    const auto rejected = proposal();
+    size_t produced = 0;
+    for (auto _ : state) {
+        AlternativeProposals alternatives(compiled, rejected, {}, {}, {}, {}, {}, {}, {}, rejected);
+        for (int i = 0; i < 8; ++i) {
+            auto next = alternatives.next();
+            if (!next) {
+                break;
+            }
+            benchmark::DoNotOptimize(*next);
+            ++produced;
+        }
+    }
+    state.counters["alternatives"] = benchmark::Counter(
+        static_cast<double>(produced), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(AlternativeProposalsDepth)->ArgName("depth")->DenseRange(0, 7);
+
+// Heap held per open session, for sizing brokers
+template <typename MakeProtocol>
+void sessionMemory(benchmark::State& state, MakeProtocol makeProtocol) {
+    const auto sessions = static_cast<size_t>(state.range(0));
+    const auto params = proposal();
+    double bytesPerSession = 0;
+    for (auto _ : state) {
+        auto protocol = makeProtocol();
+        const size_t before = heapInUse();
+        for (size_t i = 0; i < sessions; ++i) {
+            protocol->initiateSession("agent_" + std::to_string(i), params);
+        }
+        const size_t after = heapInUse();
+        bytesPerSession = after > before ? static_cast<double>(after - before) / sessions : 0;
+    }
+    state.counters["bytes_per_session"] = bytesPerSession;
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sessions));
+}
+
+void ConcreteSessionMemory(benchmark::State& state) {
+    sessionMemory(state, [] { return createNegotiationProtocol(false); });
+}
+BENCHMARK(ConcreteSessionMemory)->ArgName("sessions")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+void TimeoutSessionMemory(benchmark::State& state) {
+    sessionMemory(state, [] { return std::make_unique<TimeoutNegotiationProtocol>(patientTimeouts(), false); });
+}
+BENCHMARK(TimeoutSessionMemory)->ArgName("sessions")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/adapter_registry.h"
+#include "xenocomm/core/data_adapters.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+
+namespace {
+
+// Stand-ins for formats no built-in adapter registers, so the tests own their entries
+constexpr DataFormat SHARED_FORMAT = DataFormat::GGWAVE_FSK;
+constexpr DataFormat PER_THREAD_FORMAT = DataFormat::COMPRESSED_STATE;
+
+std::atomic<int> created{0};
+
+std::unique_ptr<DataTranscoder> countingFactory() {
+    ++created;
+    return std::make_unique<VectorFloat32Adapter>();
+}
+
+class AdapterRegistryTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        auto& registry = AdapterRegistry::getInstance();
+        registry.registerAdapter(SHARED_FORMAT, countingFactory, "shared", AdapterSharing::SHARED);
+        registry.registerAdapter(PER_THREAD_FORMAT, countingFactory, "per thread", AdapterSharing::PER_THREAD);
+    }
+};
+
+} // namespace
+
+TEST_F(AdapterRegistryTest, SharedAdapterIsOneInstance) {
+    auto& registry = AdapterRegistry::getInstance();
+    DataTranscoder* here = &registry.lookup(SHARED_FORMAT);
+    DataTranscoder* there = nullptr;
+    std::thread([&] { there = &registry.lookup(SHARED_FORMAT); }).join();
+    EXPECT_EQ(here, there);
+    EXPECT_EQ(registry.getAdapter(SHARED_FORMAT).get(), here);
+    EXPECT_EQ(registry.getAdapterDescription(SHARED_FORMAT), "shared");
+}
+
+TEST_F(AdapterRegistryTest, PerThreadAdapterIsOnePerThread) {
+    auto& registry = AdapterRegistry::getInstance();
+    DataTranscoder* here = &registry.lookup(PER_THREAD_FORMAT);
+    EXPECT_EQ(&registry.lookup(PER_THREAD_FORMAT), here);
+    EXPECT_EQ(registry.getAdapter(PER_THREAD_FORMAT).get(), here);
+
+    std::shared_ptr<DataTranscoder> there;
+    std::thread([&] { there = registry.getAdapter(PER_THREAD_FORMAT); }).join();
+    ASSERT_NE(there, nullptr) << "The instance outlives its thread while referenced";
+    EXPECT_NE(there.get(), here);
+}
+
+TEST_F(AdapterRegistryTest, RejectsDuplicateAndUnknownFormats) {
+    auto& registry = AdapterRegistry::getInstance();
+    EXPECT_THROW(registry.registerAdapter(SHARED_FORMAT, countingFactory), std::runtime_error);
+    EXPECT_THROW(registry.registerAdapter(static_cast<DataFormat>(DATA_FORMAT_COUNT), countingFactory),
+                 std::runtime_error);
+    EXPECT_FALSE(registry.hasAdapter(DataFormat::VECTOR_INT8));
+    EXPECT_THROW(registry.lookup(DataFormat::VECTOR_INT8), std::runtime_error);
+    EXPECT_THROW(registry.getAdapterDescription(static_cast<DataFormat>(DATA_FORMAT_COUNT)), std::runtime_error);
+}
+
+TEST_F(AdapterRegistryTest, ClearCacheReplacesInstances) {
+    auto& registry = AdapterRegistry::getInstance();
+    auto shared = registry.getAdapter(SHARED_FORMAT);
+    auto per_thread = registry.getAdapter(PER_THREAD_FORMAT);
+    registry.clearCache();
+    EXPECT_NE(registry.getAdapter(SHARED_FORMAT), shared);
+    EXPECT_NE(registry.getAdapter(PER_THREAD_FORMAT), per_thread);
+    EXPECT_TRUE(registry.hasAdapter(DataFormat::VECTOR_FLOAT16)) << "Registrations survive";
+}
+
+TEST_F(AdapterRegistryTest, ConcurrentLookupsWhileRegistering) {
+    auto& registry = AdapterRegistry::getInstance();
+    std::vector<float> data(32, 1.5f);
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) {
+                DataTranscoder& adapter = registry.lookup(PER_THREAD_FORMAT);
+                auto encoded = adapter.encode(data.data(), data.size() * sizeof(float), DataFormat::VECTOR_FLOAT32);
+                if (adapter.decode(encoded, DataFormat::VECTOR_FLOAT32).size() != data.size() * sizeof(float)) {
+                    failed = true;
+                }
+                registry.lookup(SHARED_FORMAT);
+            }
+        });
+    }
+    // A writer publishing new tables must not disturb the readers
+    registry.registerAdapter(DataFormat::BINARY_CUSTOM, countingFactory, "late", AdapterSharing::SHARED);
+    for (int i = 0; i < 10; ++i) {
+        registry.getAdapterDescription(DataFormat::BINARY_CUSTOM);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(registry.getAdapterDescription(DataFormat::BINARY_CUSTOM), "late");
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/address_resolver.hpp"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <netinet/in.h>
+
+using namespace xenocomm::core;
+using namespace std::chrono;
+
+namespace {
+
+AddressResolver::Address makeAddress(int family) {
+    AddressResolver::Address address{};
+    address.family = family;
+    address.storage.ss_family = static_cast<sa_family_t>(family);
+    return address;
+}
+
+template <typename Predicate>
+bool waitFor(Predicate predicate, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+TEST(AddressResolverTest, CachesSuccessfulLookups) {
+    AddressResolver resolver;
+    int error = -1;
+    auto first = resolver.resolve("127.0.0.1", 8080, &error);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(error, 0);
+    ASSERT_FALSE(first->empty());
+    EXPECT_EQ(first->front().family, AF_INET);
+    auto* v4 = reinterpret_cast<const sockaddr_in*>(&first->front().storage);
+    EXPECT_EQ(ntohs(v4->sin_port), 8080);
+
+    auto second = resolver.resolve("127.0.0.1", 8080);
+    EXPECT_EQ(second, first);  // Same shared list, no second lookup
+
+    auto stats = resolver.getStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.lookups, 1u);
+
+    resolver.invalidate("127.0.0.1", 8080);
+    auto third = resolver.resolve("127.0.0.1", 8080);
+    ASSERT_TRUE(third);
+    EXPECT_NE(third, first);
+    EXPECT_EQ(resolver.getStats().lookups, 2u);
+}
+
+TEST(AddressResolverTest, ConcurrentMissesShareOneLookup) {
+    AddressResolver resolver;
+    std::atomic<int> resolved{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            if (resolver.resolve("localhost", 9000)) {
+                ++resolved;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(resolved, 8);
+    EXPECT_EQ(resolver.getStats().lookups, 1u);
+}
+
+TEST(AddressResolverTest, ServesStaleEntryWhileRefreshing) {
+    AddressResolver::Config config;
+    config.ttl = milliseconds(1);
+    AddressResolver resolver(config);
+
+    auto first = resolver.resolve("127.0.0.1", 7000);
+    ASSERT_TRUE(first);
+    std::this_thread::sleep_for(milliseconds(5));
+
+    auto stale = resolver.resolve("127.0.0.1", 7000);
+    EXPECT_EQ(stale, first);
+    EXPECT_EQ(resolver.getStats().staleHits, 1u);
+
+    // The background refresh replaces the list without blocking the caller
+    EXPECT_TRUE(waitFor([&] { return resolver.resolve("127.0.0.1", 7000) != first; }));
+    EXPECT_GE(resolver.getStats().lookups, 2u);
+}
+
+TEST(AddressResolverTest, ResolveAsyncDeliversAddresses) {
+    AddressResolver resolver;
+    auto future = resolver.resolveAsync("127.0.0.1", 6000);
+    ASSERT_EQ(future.wait_for(seconds(2)), std::future_status::ready);
+    auto addresses = future.get();
+    ASSERT_TRUE(addresses);
+    EXPECT_EQ(resolver.resolve("127.0.0.1", 6000), addresses);
+}
+
+TEST(AddressResolverTest, InterleavesFamiliesStartingWithPreferred) {
+    std::vector<AddressResolver::Address> addresses = {
+        makeAddress(AF_INET6), makeAddress(AF_INET6), makeAddress(AF_INET6),
+        makeAddress(AF_INET), makeAddress(AF_INET)};
+    auto ordered = AddressResolver::interleaveFamilies(addresses);
+    ASSERT_EQ(ordered.size(), addresses.size());
+    std::vector<int> families;
+    for (const auto& address : ordered) {
+        families.push_back(address.family);
+    }
+    EXPECT_EQ(families, (std::vector<int>{AF_INET6, AF_INET, AF_INET6, AF_INET, AF_INET6}));
+}
+
+} // namespace
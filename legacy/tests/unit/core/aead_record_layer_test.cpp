@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/aead_record_layer.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace xenocomm;
+using namespace xenocomm::core;
+
+namespace {
+
+AeadRecordLayer::DirectionKeys makeKeys(CipherSuite suite, uint8_t seed) {
+    AeadRecordLayer::DirectionKeys keys;
+    keys.key.resize(AeadRecordLayer::keyLength(suite));
+    for (size_t i = 0; i < keys.key.size(); ++i) {
+        keys.key[i] = static_cast<uint8_t>(seed + i);
+    }
+    for (size_t i = 0; i < keys.iv.size(); ++i) {
+        keys.iv[i] = static_cast<uint8_t>(seed * 3 + i);
+    }
+    return keys;
+}
+
+class AeadRecordLayerTest : public ::testing::TestWithParam<CipherSuite> {
+protected:
+    void SetUp() override {
+        auto client = makeKeys(GetParam(), 1);
+        auto server = makeKeys(GetParam(), 100);
+        sender_ = std::make_unique<AeadRecordLayer>(GetParam(), client, server);
+        receiver_ = std::make_unique<AeadRecordLayer>(GetParam(), server, client);
+    }
+
+    std::unique_ptr<AeadRecordLayer> sender_;
+    std::unique_ptr<AeadRecordLayer> receiver_;
+};
+
+TEST_P(AeadRecordLayerTest, SealsInPlaceAndOpensOnThePeer) {
+    const std::vector<uint8_t> plaintext(1500, 0x42);
+    const uint8_t aad[] = {1, 2, 3, 4};
+    std::vector<uint8_t> record = plaintext;
+    uint8_t tag[AeadRecordLayer::TAG_SIZE];
+    ASSERT_TRUE(sender_->seal(7, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(record), tag));
+    EXPECT_NE(record, plaintext);
+
+    ASSERT_TRUE(receiver_->open(7, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(record), tag));
+    EXPECT_EQ(record, plaintext);
+}
+
+TEST_P(AeadRecordLayerTest, RejectsTamperedRecords) {
+    const uint8_t aad[] = {9, 9};
+    std::vector<uint8_t> sealed(64, 0x11);
+    uint8_t tag[AeadRecordLayer::TAG_SIZE];
+    ASSERT_TRUE(sender_->seal(1, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(sealed), tag));
+
+    auto record = sealed;
+    record[10] ^= 1;
+    EXPECT_FALSE(receiver_->open(1, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(record), tag));
+
+    record = sealed;
+    const uint8_t other_aad[] = {9, 8};
+    EXPECT_FALSE(receiver_->open(1, utils::ByteSpan(other_aad, sizeof(other_aad)), utils::MutableByteSpan(record), tag));
+
+    record = sealed;
+    EXPECT_FALSE(receiver_->open(2, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(record), tag));
+
+    // A forged record must not poison the context for the next genuine one
+    record = sealed;
+    EXPECT_TRUE(receiver_->open(1, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(record), tag));
+}
+
+TEST_P(AeadRecordLayerTest, SequenceNumbersChangeTheCiphertext) {
+    std::vector<uint8_t> first(32, 0);
+    std::vector<uint8_t> second(32, 0);
+    uint8_t tag[AeadRecordLayer::TAG_SIZE];
+    ASSERT_TRUE(sender_->seal(1, utils::ByteSpan(), utils::MutableByteSpan(first), tag));
+    ASSERT_TRUE(sender_->seal(2, utils::ByteSpan(), utils::MutableByteSpan(second), tag));
+    EXPECT_NE(first, second);
+}
+
+TEST_P(AeadRecordLayerTest, SealersMatchTheLayerAndSealOutOfPlace) {
+    auto sealer = sender_->makeSealer();
+    ASSERT_NE(sealer, nullptr);
+    const std::vector<uint8_t> plaintext(700, 0x5A);
+    const uint8_t aad[] = {4, 2};
+
+    std::vector<uint8_t> expected = plaintext;
+    uint8_t expected_tag[AeadRecordLayer::TAG_SIZE];
+    ASSERT_TRUE(sender_->seal(3, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(expected), expected_tag));
+
+    std::vector<uint8_t> record(plaintext.size());
+    uint8_t tag[AeadRecordLayer::TAG_SIZE];
+    ASSERT_TRUE(sealer->seal(3, utils::ByteSpan(aad, sizeof(aad)), utils::ByteSpan(plaintext), record.data(), tag));
+    EXPECT_EQ(record, expected);
+    EXPECT_TRUE(std::equal(tag, tag + sizeof(tag), expected_tag));
+    ASSERT_TRUE(receiver_->open(3, utils::ByteSpan(aad, sizeof(aad)), utils::MutableByteSpan(record), tag));
+    EXPECT_EQ(record, plaintext);
+}
+
+TEST_P(AeadRecordLayerTest, GatheredSealMatchesOneShotSeal) {
+    auto sealer = sender_->makeSealer();
+    ASSERT_NE(sealer, nullptr);
+    std::vector<uint8_t> plaintext(301);
+    for (size_t i = 0; i < plaintext.size(); ++i) {
+        plaintext[i] = static_cast<uint8_t>(i * 13);
+    }
+    const uint8_t aad[] = {7};
+
+    std::vector<uint8_t> expected(plaintext.size());
+    uint8_t expected_tag[AeadRecordLayer::TAG_SIZE];
+    ASSERT_TRUE(sealer->seal(11, utils::ByteSpan(aad, 1), utils::ByteSpan(plaintext), expected.data(), expected_tag));
+
+    // Odd-sized pieces, including an empty one, must not disturb the keystream
+    std::vector<uint8_t> record(plaintext.size());
+    uint8_t tag[AeadRecordLayer::TAG_SIZE];
+    const size_t cuts[] = {0, 1, 1, 17, 200, 301};
+    ASSERT_TRUE(sealer->begin(11, utils::ByteSpan(aad, 1)));
+    for (size_t i = 0; i + 1 < sizeof(cuts) / sizeof(cuts[0]); ++i) {
+        ASSERT_TRUE(sealer->update(utils::ByteSpan(plaintext.data() + cuts[i], cuts[i + 1] - cuts[i]),
+                                   record.data() + cuts[i]));
+    }
+    ASSERT_TRUE(sealer->finish(tag));
+    EXPECT_EQ(record, expected);
+    EXPECT_TRUE(std::equal(tag, tag + sizeof(tag), expected_tag));
+}
+
+INSTANTIATE_TEST_SUITE_P(Suites, AeadRecordLayerTest,
+                         ::testing::Values(CipherSuite::AES_128_GCM_SHA256, CipherSuite::AES_256_GCM_SHA384,
+                                           CipherSuite::CHACHA20_POLY1305_SHA256));
+
+TEST(AeadRecordLayerKeysTest, RejectsKeysOfTheWrongLength) {
+    auto keys = makeKeys(CipherSuite::AES_128_GCM_SHA256, 5);
+    EXPECT_THROW(AeadRecordLayer(CipherSuite::AES_256_GCM_SHA384, keys, keys), std::runtime_error);
+}
+
+} // namespace
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/auth_cache.hpp"
+#include "xenocomm/core/token_auth_provider.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+
+namespace {
+
+TEST(AuthCacheTest, CountsHitsAndMissesAndRefreshesEntries) {
+    AuthCache cache(100, std::chrono::seconds(60));
+    EXPECT_FALSE(cache.lookup("a").has_value());
+
+    cache.insert("a", "agent-1");
+    cache.insert("a", "agent-2");
+    auto value = cache.lookup("a");
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(*value, "agent-2");
+    EXPECT_TRUE(cache.contains("a"));
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_FLOAT_EQ(stats.hitRate(), 0.5f);
+
+    EXPECT_TRUE(cache.erase("a"));
+    EXPECT_FALSE(cache.erase("a"));
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(AuthCacheTest, ExpiredEntriesAreMissesAndCleanedUp) {
+    AuthCache cache(100, std::chrono::seconds(0));
+    for (int i = 0; i < 10; ++i) {
+        cache.insert("key" + std::to_string(i), "agent");
+    }
+    EXPECT_FALSE(cache.lookup("key3").has_value());
+    EXPECT_FALSE(cache.contains("key5"));
+
+    cache.cleanupExpired();
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.entries, 0u);
+    EXPECT_EQ(stats.expirations, 10u);
+}
+
+TEST(AuthCacheTest, StaysWithinItsBoundEvictingOldestFirst) {
+    AuthCache cache(AuthCache::SHARD_COUNT * 2, std::chrono::seconds(60));
+    for (int i = 0; i < 1000; ++i) {
+        cache.insert("key" + std::to_string(i), "agent");
+    }
+    auto stats = cache.getStats();
+    EXPECT_LE(stats.entries, AuthCache::SHARD_COUNT * 2);
+    EXPECT_EQ(stats.entries + stats.evictions, 1000u);
+    EXPECT_TRUE(cache.contains("key999"));
+    EXPECT_FALSE(cache.contains("key0"));
+}
+
+TEST(AuthCacheTest, ShorterLivedEntriesAreCleanedUpInExpiryOrder) {
+    AuthCache cache(1000, std::chrono::seconds(60));
+    for (int i = 0; i < 100; ++i) {
+        cache.insert("long" + std::to_string(i), "agent");
+    }
+    for (int i = 0; i < 100; ++i) {
+        cache.insert("short" + std::to_string(i), "agent", std::chrono::seconds(0));
+    }
+    EXPECT_FALSE(cache.contains("short7"));
+
+    // Behind the long-lived entries in insertion order, but ahead of them in expiry order
+    cache.cleanupExpired();
+    EXPECT_EQ(cache.getStats().expirations, 100u);
+    EXPECT_EQ(cache.size(), 100u);
+    EXPECT_TRUE(cache.contains("long7"));
+
+    // A shorter TTL never extends past the cache's own
+    cache.insert("capped", "agent", std::chrono::seconds(3600));
+    EXPECT_TRUE(cache.contains("capped"));
+}
+
+TEST(AuthCacheTest, ConcurrentLookupsAndInserts) {
+    AuthCache cache(4096, std::chrono::seconds(60));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 2000; ++i) {
+                std::string key = "key" + std::to_string((i * 7 + t) % 512);
+                if (!cache.lookup(key)) {
+                    cache.insert(key, "agent");
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits + stats.misses, 16000u);
+    EXPECT_EQ(stats.entries, 512u);
+}
+
+TEST(AuthCacheTest, ReusableTokensSkipTheValidatorWhileCached) {
+    auto cache = std::make_shared<AuthCache>(100, std::chrono::seconds(60));
+    std::atomic<int> validations{0};
+
+    TokenAuthConfig config;
+    config.allowReuse = true;
+    config.minTokenLength = 1;
+    config.cache = cache;
+    config.validator = [&](const std::string&, std::string& agentId, std::string&) {
+        ++validations;
+        agentId = "TestAgent";
+        return true;
+    };
+    TokenAuthProvider provider(config);
+    ASSERT_TRUE(provider.initialize());
+
+    AuthenticationContext context;
+    std::string token = "reusable_token";
+    context.credentials = std::vector<uint8_t>(token.begin(), token.end());
+    for (int i = 0; i < 3; ++i) {
+        auto result = provider.authenticate(context);
+        EXPECT_TRUE(result.success);
+        EXPECT_EQ(result.agentId, "TestAgent");
+    }
+    EXPECT_EQ(validations.load(), 1);
+    EXPECT_EQ(cache->getStats().hits, 2u);
+
+    provider.revokeToken(token);
+    EXPECT_FALSE(provider.authenticate(context).success);
+    EXPECT_EQ(cache->size(), 0u);
+}
+
+TEST(AuthCacheTest, SignedTokensAreCachedNoLongerThanTheyLast) {
+    auto cache = std::make_shared<AuthCache>(100, std::chrono::seconds(3600));
+    const std::vector<uint8_t> key(32, 0x5a);
+
+    TokenAuthConfig config;
+    config.allowReuse = true;
+    config.signingKey = key;
+    config.cache = cache;
+    TokenAuthProvider provider(config);
+    ASSERT_TRUE(provider.initialize());
+
+    auto contextFor = [](const std::string& token) {
+        AuthenticationContext context;
+        context.credentials = std::vector<uint8_t>(token.begin(), token.end());
+        return context;
+    };
+    const auto now = std::chrono::system_clock::now();
+    const std::string token = TokenAuthProvider::issueToken(key, "agent.7", now + std::chrono::hours(1));
+    for (int i = 0; i < 2; ++i) {
+        auto result = provider.authenticate(contextFor(token));
+        ASSERT_TRUE(result.success) << result.errorMessage;
+        EXPECT_EQ(result.agentId, "agent.7");
+    }
+    EXPECT_EQ(cache->getStats().hits, 1u);
+
+    std::string tampered = token;
+    tampered.back() = tampered.back() == '0' ? '1' : '0';
+    EXPECT_EQ(provider.authenticate(contextFor(tampered)).errorMessage, "Invalid token signature");
+
+    const std::vector<uint8_t> otherKey(32, 0x33);
+    auto forged = TokenAuthProvider::issueToken(otherKey, "agent.7", now + std::chrono::hours(1));
+    EXPECT_FALSE(provider.authenticate(contextFor(forged)).success);
+
+    auto expired = TokenAuthProvider::issueToken(key, "agent.7", now - std::chrono::seconds(1));
+    EXPECT_EQ(provider.authenticate(contextFor(expired)).errorMessage, "Token has expired");
+
+    // Valid for under a second: accepted, but not worth caching
+    auto lapsing = TokenAuthProvider::issueToken(key, "agent.8", now + std::chrono::milliseconds(1500));
+    EXPECT_TRUE(provider.authenticate(contextFor(lapsing)).success);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1600));
+    EXPECT_EQ(provider.authenticate(contextFor(lapsing)).errorMessage, "Token has expired");
+}
+
+TEST(AuthCacheTest, BatchesCheckEachDistinctTokenOnce) {
+    std::atomic<int> validations{0};
+    TokenAuthConfig config;
+    config.allowReuse = true;
+    config.minTokenLength = 4;
+    config.validator = [&](const std::string& token, std::string& agentId, std::string&) {
+        ++validations;
+        agentId = "agent-" + token;
+        return true;
+    };
+    TokenAuthProvider provider(config);
+    ASSERT_TRUE(provider.initialize());
+
+    std::vector<AuthenticationContext> contexts;
+    for (const std::string token : {"aaaa", "bbbb", "aaaa", "x", "aaaa", "bbbb"}) {
+        AuthenticationContext context;
+        context.credentials = std::vector<uint8_t>(token.begin(), token.end());
+        contexts.push_back(std::move(context));
+    }
+    auto results = provider.authenticateBatch(contexts);
+    ASSERT_EQ(results.size(), contexts.size());
+    EXPECT_EQ(results[0].agentId, "agent-aaaa");
+    EXPECT_EQ(results[1].agentId, "agent-bbbb");
+    EXPECT_EQ(results[4].agentId, "agent-aaaa");
+    EXPECT_FALSE(results[3].success);
+    EXPECT_EQ(validations.load(), 2);
+}
+
+} // namespace
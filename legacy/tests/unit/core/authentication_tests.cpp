@@ -38,6 +38,7 @@ protected:
         system("openssl x509 -req -in test_certs/client.csr -CA test_certs/ca.crt "
                "-CAkey test_certs/ca.key -CAcreateserial -out test_certs/client.crt "
                "-days 365 2>/dev/null");
+        system("openssl x509 -in test_certs/client.crt -outform DER -out test_certs/client.der 2>/dev/null");
         
         // Create a test CRL
         system("openssl ca -gencrl -keyfile test_certs/ca.key -cert test_certs/ca.crt "
@@ -217,6 +218,43 @@ TEST_F(AuthenticationTest, TokenRevocation) {
     EXPECT_FALSE(result2.success);
 }
 
+TEST_F(AuthenticationTest, BatchAuthenticationRecordsEachAgent) {
+    TokenAuthConfig tokenConfig;
+    tokenConfig.allowReuse = true;
+    tokenConfig.minTokenLength = 1;
+    tokenConfig.validator = [](const std::string& token, std::string& agentId, std::string& error) {
+        if (token.rfind("valid_", 0) == 0) {
+            agentId = token.substr(6);
+            return true;
+        }
+        error = "Invalid token";
+        return false;
+    };
+    ASSERT_TRUE(authManager->registerProvider(std::make_shared<TokenAuthProvider>(tokenConfig)));
+
+    size_t callbacks = 0;
+    authManager->setAuthenticationCallback([&](const AuthResult&) { ++callbacks; });
+
+    std::vector<AuthenticationContext> contexts;
+    for (const std::string token : {"valid_A", "bogus", "valid_B"}) {
+        AuthenticationContext context;
+        context.credentials = std::vector<uint8_t>(token.begin(), token.end());
+        contexts.push_back(std::move(context));
+    }
+    auto results = authManager->authenticateBatch("token", contexts);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_FALSE(results[1].success);
+    EXPECT_TRUE(results[2].success);
+    EXPECT_TRUE(authManager->isAuthenticated("A"));
+    EXPECT_TRUE(authManager->isAuthenticated("B"));
+    EXPECT_EQ(callbacks, 3u);
+
+    auto unknown = authManager->authenticateBatch("missing", contexts);
+    ASSERT_EQ(unknown.size(), 3u);
+    EXPECT_FALSE(unknown[0].success);
+}
+
 TEST_F(AuthenticationTest, AuthenticationCallback) {
     bool callbackCalled = false;
     std::string callbackAgentId;
@@ -261,6 +299,57 @@ TEST_F(AuthenticationTest, AuthenticationCallback) {
     EXPECT_TRUE(callbackSuccess);
 }
 
+TEST_F(AuthenticationTest, CertificateVerificationIsCached) {
+    CertificateAuthConfig certConfig;
+    certConfig.caPath = "test_certs/ca.crt";
+    certConfig.allowSelfSigned = true;  // The test CA lacks the extensions strict mode wants
+    CertificateAuthProvider provider(certConfig);
+    ASSERT_TRUE(provider.initialize());
+
+    AuthenticationContext context;
+    context.credentials = loadCertificate("test_certs/client.der");
+    for (int i = 0; i < 2; ++i) {
+        auto result = provider.authenticate(context);
+        EXPECT_TRUE(result.success) << result.errorMessage;
+        EXPECT_EQ(result.agentId, "TestAgent");
+    }
+    auto stats = provider.getCacheStats();
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+
+    provider.invalidate(context.credentials);
+    EXPECT_EQ(provider.getCacheStats().entries, 0u);
+}
+
+TEST_F(AuthenticationTest, BatchAuthenticationVerifiesEachCertificateOnce) {
+    CertificateAuthConfig certConfig;
+    certConfig.caPath = "test_certs/ca.crt";
+    certConfig.allowSelfSigned = true;  // The test CA lacks the extensions strict mode wants
+    CertificateAuthProvider provider(certConfig);
+    ASSERT_TRUE(provider.initialize());
+
+    std::vector<AuthenticationContext> contexts(6);
+    for (size_t i = 0; i < 5; ++i) {
+        contexts[i].credentials = loadCertificate("test_certs/client.der");
+    }
+    contexts[5].credentials = {0x30, 0x03, 0x02, 0x01, 0x00};  // Not a certificate
+
+    auto results = provider.authenticateBatch(contexts);
+    ASSERT_EQ(results.size(), 6u);
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(results[i].success) << results[i].errorMessage;
+        EXPECT_EQ(results[i].agentId, "TestAgent");
+    }
+    EXPECT_FALSE(results[5].success);
+    EXPECT_EQ(provider.getCacheStats().entries, 1u);
+
+    // The repeat is served from the cache, and a CRL reload forgets it
+    results = provider.authenticateBatch(std::vector<AuthenticationContext>(contexts.begin(), contexts.begin() + 5));
+    EXPECT_EQ(provider.getCacheStats().hits, 5u);
+    provider.reloadCRL();
+    EXPECT_EQ(provider.getCacheStats().entries, 0u);
+}
+
 } // namespace testing
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/batch_negotiation.h"
+#include "xenocomm/core/parameter_performance.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+using std::chrono::milliseconds;
+
+NegotiableParams plainParams(CompressionAlgorithm compression = CompressionAlgorithm::NONE) {
+    NegotiableParams params;
+    params.keySize = KeySize::NONE;
+    params.compressionAlgorithm = compression;
+    return params;
+}
+
+// Peers answer according to a script, after a short delay on another thread
+class ScriptedProtocol : public NegotiationProtocol {
+public:
+    enum class Behaviour { ACCEPT, COUNTER, REJECT, SILENT, UNREACHABLE, ACCEPT_ONLY_COUNTER };
+
+    struct Peer {
+        Behaviour behaviour = Behaviour::ACCEPT;
+        NegotiableParams counter;
+    };
+
+    std::map<std::string, Peer> peers;
+    std::atomic<int> closed{0};
+    std::atomic<int> maxConcurrentInitiations{0};
+
+    SessionId initiateSession(const std::string& targetAgentId, const NegotiableParams& proposedParams) override {
+        int now = ++initiating_;
+        for (int seen = maxConcurrentInitiations; now > seen && !maxConcurrentInitiations.compare_exchange_weak(seen, now);) {
+        }
+        std::this_thread::sleep_for(milliseconds(5));  // The proposal's network round trip
+        --initiating_;
+
+        const Peer& peer = peers.at(targetAgentId);
+        if (peer.behaviour == Behaviour::UNREACHABLE) {
+            throw std::runtime_error("unreachable");
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        SessionId id = nextId_++;
+        Session& session = sessions_[id];
+        session.proposal = proposedParams;
+        switch (peer.behaviour) {
+            case Behaviour::ACCEPT:
+                session.state = NegotiationState::FINALIZED;
+                session.params = proposedParams;
+                break;
+            case Behaviour::ACCEPT_ONLY_COUNTER:
+                if (proposedParams == peer.counter) {
+                    session.state = NegotiationState::FINALIZED;
+                    session.params = proposedParams;
+                    break;
+                }
+                [[fallthrough]];
+            case Behaviour::COUNTER:
+                session.state = NegotiationState::COUNTER_RECEIVED;
+                session.counter = peer.counter;
+                break;
+            case Behaviour::REJECT:
+                session.state = NegotiationState::FAILED;
+                break;
+            default:
+                session.state = NegotiationState::AWAITING_RESPONSE;
+                break;
+        }
+        return id;
+    }
+
+    bool respondToNegotiation(SessionId, NegotiationResponse, const std::optional<NegotiableParams>&) override {
+        return false;
+    }
+    NegotiableParams finalizeSession(SessionId) override { throw std::runtime_error("unused"); }
+
+    NegotiationState getSessionState(SessionId sessionId) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.at(sessionId).state;
+    }
+    std::optional<NegotiableParams> getNegotiatedParams(SessionId sessionId) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sessions_.at(sessionId).params;
+    }
+    std::optional<NegotiableParams> getCounterProposal(SessionId sessionId) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Session& session = sessions_.at(sessionId);
+        return session.state == NegotiationState::COUNTER_RECEIVED ? session.counter : std::nullopt;
+    }
+    bool acceptCounterProposal(SessionId sessionId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Session& session = sessions_.at(sessionId);
+        session.state = NegotiationState::FINALIZED;
+        session.params = session.counter;
+        return true;
+    }
+    bool rejectCounterProposal(SessionId sessionId, const std::optional<std::string>&) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.at(sessionId).state = NegotiationState::FAILED;
+        return true;
+    }
+    bool closeSession(SessionId sessionId) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.at(sessionId).state = NegotiationState::CLOSED;
+        ++closed;
+        return true;
+    }
+
+private:
+    struct Session {
+        NegotiationState state;
+        NegotiableParams proposal;
+        std::optional<NegotiableParams> counter;
+        std::optional<NegotiableParams> params;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<SessionId, Session> sessions_;
+    SessionId nextId_ = 1;
+    std::atomic<int> initiating_{0};
+};
+
+TEST(BatchNegotiationTest, NegotiatesWithEveryPeerConcurrently) {
+    ScriptedProtocol protocol;
+    std::vector<std::string> ids;
+    for (int i = 0; i < 64; ++i) {
+        ids.push_back("peer-" + std::to_string(i));
+        protocol.peers[ids.back()] = {};
+    }
+    BatchNegotiationConfig config;
+    config.maxParallelInitiations = 8;
+    BatchNegotiator negotiator(protocol, config);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = negotiator.negotiate(ids, plainParams());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ(result.peers.size(), ids.size());
+    EXPECT_EQ(result.succeeded(), ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(result.peers[i].peerId, ids[i]);
+        EXPECT_EQ(result.peers[i].params, plainParams());
+    }
+    EXPECT_GT(protocol.maxConcurrentInitiations.load(), 1);
+    // 64 sequential 5 ms round trips would take 320 ms
+    EXPECT_LT(elapsed, milliseconds(300));
+    EXPECT_FALSE(result.groupParams);
+}
+
+TEST(BatchNegotiationTest, ReportsEachPeersOutcome) {
+    ScriptedProtocol protocol;
+    protocol.peers["accept"] = {};
+    protocol.peers["counter"] = {ScriptedProtocol::Behaviour::COUNTER, plainParams(CompressionAlgorithm::LZ4)};
+    protocol.peers["reject"] = {ScriptedProtocol::Behaviour::REJECT, {}};
+    protocol.peers["silent"] = {ScriptedProtocol::Behaviour::SILENT, {}};
+    protocol.peers["down"] = {ScriptedProtocol::Behaviour::UNREACHABLE, {}};
+    BatchNegotiationConfig config;
+    config.timeout = milliseconds(50);
+    BatchNegotiator negotiator(protocol, config);
+
+    auto result = negotiator.negotiate({"accept", "counter", "reject", "silent", "down"}, plainParams());
+
+    EXPECT_EQ(result.peers[0].params, plainParams());
+    EXPECT_EQ(result.peers[1].params, plainParams(CompressionAlgorithm::LZ4));
+    EXPECT_EQ(result.peers[2].state, NegotiationState::FAILED);
+    EXPECT_TRUE(result.peers[3].error.has_value());
+    EXPECT_EQ(result.peers[4].sessionId, 0u);
+    EXPECT_EQ(result.peers[4].error, std::string("unreachable"));
+    EXPECT_EQ(result.succeeded(), 2u);
+    EXPECT_EQ(protocol.closed.load(), 1);  // The silent peer's session
+}
+
+TEST(BatchNegotiationTest, PreferencesDecideOnCounterProposals) {
+    ScriptedProtocol protocol;
+    protocol.peers["lz4"] = {ScriptedProtocol::Behaviour::COUNTER, plainParams(CompressionAlgorithm::LZ4)};
+    protocol.peers["zstd"] = {ScriptedProtocol::Behaviour::COUNTER, plainParams(CompressionAlgorithm::ZSTD)};
+    ParameterPreference prefs;
+    prefs.dataFormats = {{DataFormat::BINARY_CUSTOM, 0}};
+    prefs.compressionAlgorithms = {{CompressionAlgorithm::NONE, 0}, {CompressionAlgorithm::LZ4, 1}};
+    prefs.errorCorrectionSchemes = {{ErrorCorrectionScheme::NONE, 0}};
+    prefs.encryptionAlgorithms = {{EncryptionAlgorithm::NONE, 0}};
+    prefs.keyExchangeMethods = {{KeyExchangeMethod::NONE, 0}};
+    prefs.authenticationMethods = {{AuthenticationMethod::NONE, 0}};
+    prefs.keySizes = {{KeySize::NONE, 0}};
+    BatchNegotiator negotiator(protocol);
+
+    auto result = negotiator.negotiate({"lz4", "zstd"}, plainParams(), prefs);
+
+    EXPECT_EQ(result.peers[0].params, plainParams(CompressionAlgorithm::LZ4));
+    EXPECT_FALSE(result.peers[1].params);
+    EXPECT_EQ(result.peers[1].state, NegotiationState::FAILED);
+}
+
+TEST(BatchNegotiationTest, ConvergesDivergentPeersOnTheGroupSet) {
+    ScriptedProtocol protocol;
+    NegotiableParams lz4 = plainParams(CompressionAlgorithm::LZ4);
+    protocol.peers["a"] = {ScriptedProtocol::Behaviour::ACCEPT_ONLY_COUNTER, lz4};
+    protocol.peers["b"] = {ScriptedProtocol::Behaviour::ACCEPT_ONLY_COUNTER, lz4};
+    protocol.peers["c"] = {};  // Accepts whatever is proposed
+    protocol.peers["d"] = {ScriptedProtocol::Behaviour::ACCEPT_ONLY_COUNTER, plainParams(CompressionAlgorithm::ZSTD)};
+    BatchNegotiationConfig config;
+    config.convergeOnGroupParams = true;
+    BatchNegotiator negotiator(protocol, config);
+
+    auto result = negotiator.negotiate({"a", "b", "c", "d"}, plainParams());
+
+    ASSERT_TRUE(result.groupParams);
+    EXPECT_EQ(*result.groupParams, lz4);
+    EXPECT_TRUE(result.peers[0].inGroup);
+    EXPECT_TRUE(result.peers[1].inGroup);
+    EXPECT_TRUE(result.peers[2].inGroup);
+    EXPECT_EQ(result.peers[2].params, lz4);
+    // d holds out for ZSTD and keeps it
+    EXPECT_FALSE(result.peers[3].inGroup);
+    EXPECT_EQ(result.peers[3].params, plainParams(CompressionAlgorithm::ZSTD));
+    EXPECT_EQ(result.inGroup(), 3u);
+}
+
+TEST(BatchNegotiationTest, AwaitableSettlesWithoutBlockingTheCaller) {
+    ScriptedProtocol protocol;
+    NegotiableParams lz4 = plainParams(CompressionAlgorithm::LZ4);
+    protocol.peers["a"] = {ScriptedProtocol::Behaviour::ACCEPT_ONLY_COUNTER, lz4};
+    protocol.peers["b"] = {ScriptedProtocol::Behaviour::ACCEPT_ONLY_COUNTER, lz4};
+    protocol.peers["c"] = {};
+    protocol.peers["silent"] = {ScriptedProtocol::Behaviour::SILENT, {}};
+    protocol.peers["down"] = {ScriptedProtocol::Behaviour::UNREACHABLE, {}};
+    BatchNegotiationConfig config;
+    config.timeout = milliseconds(100);
+    config.convergeOnGroupParams = true;
+    BatchNegotiator negotiator(protocol, config);
+
+    std::atomic<int> scheduled{0};
+    auto pending = negotiator.negotiateAwaitable({"a", "b", "c", "silent", "down"}, plainParams(),
+        [&](std::function<void()> resume) {
+            ++scheduled;
+            resume();
+        });
+    // Proposals take a round trip each, so the batch cannot have settled yet
+    EXPECT_FALSE(pending.isReady());
+
+    std::atomic<size_t> grouped{0};
+    auto result = pending.then([&](BatchNegotiationResult batch) {
+        grouped = batch.inGroup();
+        return batch;
+    }).get();
+
+    EXPECT_EQ(scheduled.load(), 1);
+    EXPECT_EQ(grouped.load(), 3u);
+    ASSERT_TRUE(result.groupParams);
+    EXPECT_EQ(*result.groupParams, lz4);
+    EXPECT_EQ(result.peers[2].params, lz4);  // Moved onto the group set
+    EXPECT_EQ(result.peers[3].error, std::string("Timed out"));
+    EXPECT_EQ(result.peers[4].error, std::string("unreachable"));
+    EXPECT_EQ(result.succeeded(), 3u);
+}
+
+TEST(BatchNegotiationTest, ProposesWhatEachPeersLinkMeasuresBest) {
+    ScriptedProtocol protocol;
+    protocol.peers["radio"] = {};
+    protocol.peers["wired"] = {};
+    ParameterPreference prefs;
+    prefs.dataFormats = {{DataFormat::BINARY_CUSTOM, 0}};
+    prefs.compressionAlgorithms = {{CompressionAlgorithm::NONE, 0}};
+    prefs.errorCorrectionSchemes = {{ErrorCorrectionScheme::NONE, 0}, {ErrorCorrectionScheme::REED_SOLOMON, 1}};
+
+    // Plain messages are mostly lost and retried on the radio link; Reed-Solomon repairs them
+    auto model = std::make_shared<ParameterPerformanceModel>();
+    for (int i = 0; i < 20; ++i) {
+        for (const char* peer : {"radio", "wired"}) {
+            bool lossy = std::string(peer) == "radio";
+            NegotiableParams plain = plainParams();
+            plain.errorCorrection = ErrorCorrectionScheme::NONE;
+            NegotiableParams coded = plainParams();
+            coded.errorCorrection = ErrorCorrectionScheme::REED_SOLOMON;
+            CommunicationOutcome sent{};
+            sent.success = !lossy || i % 3 == 0;
+            sent.latency = std::chrono::microseconds(lossy ? 9000 : 1000);
+            sent.retryCount = lossy ? 3 : 0;
+            model->observe(peer, plain, sent);
+            sent.success = true;
+            sent.latency = std::chrono::microseconds(lossy ? 2500 : 1600);
+            sent.retryCount = 0;
+            model->observe(peer, coded, sent);
+        }
+    }
+    BatchNegotiator negotiator(protocol, BatchNegotiationConfig(), model);
+
+    NegotiableParams proposal = plainParams();
+    proposal.errorCorrection = ErrorCorrectionScheme::NONE;
+    auto result = negotiator.negotiate({"radio", "wired"}, proposal, prefs);
+
+    ASSERT_TRUE(result.peers[0].params);
+    EXPECT_EQ(result.peers[0].params->errorCorrection, ErrorCorrectionScheme::REED_SOLOMON);
+    EXPECT_EQ(result.peers[1].params, proposal);
+
+    // Without measurements the proposal goes out as given
+    BatchNegotiator unmeasured(protocol, BatchNegotiationConfig(), std::make_shared<ParameterPerformanceModel>());
+    result = unmeasured.negotiate({"radio", "wired"}, proposal, prefs);
+    EXPECT_EQ(result.peers[0].params, proposal);
+    EXPECT_EQ(result.peers[1].params, proposal);
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
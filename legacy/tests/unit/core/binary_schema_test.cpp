@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/binary_schema.h"
+#include "xenocomm/core/binary_custom_adapter.h"
+#include <vector>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+
+namespace {
+
+enum class SensorState : uint8_t { IDLE = 0, ACTIVE = 1, FAULT = 2 };
+
+using Telemetry = BinarySchema<
+    schema::Scalar<uint32_t>,
+    schema::Scalar<SensorState>,
+    schema::Optional<double>,
+    schema::Optional<int64_t>,
+    schema::Repeated<float>,
+    schema::String,
+    schema::Bytes>;
+
+enum TelemetryField { SENSOR, STATE, READING, CALIBRATED_AT, SAMPLES, LABEL, BLOB };
+
+using Heartbeat = BinarySchema<schema::Scalar<uint32_t>, schema::Scalar<uint64_t>>;
+
+} // namespace
+
+// Fixed fields sit at compile-time offsets: fingerprint, one presence byte, then the slots
+static_assert(Telemetry::FIXED_SIZE == 4 + 1 + 4 + 1 + 8 + 8 + 8 + 8 + 8, "Unexpected telemetry layout");
+static_assert(Heartbeat::FIXED_SIZE == 4 + 4 + 8, "Schemas without optionals have no presence bitmap");
+static_assert(Telemetry::FINGERPRINT != Heartbeat::FINGERPRINT, "Layouts must fingerprint differently");
+
+TEST(BinarySchemaTest, RoundTripsEveryFieldKind) {
+    std::vector<float> samples = {0.5f, -1.25f, 3.0f};
+    std::vector<uint8_t> blob = {9, 8, 7, 6};
+
+    Telemetry::Builder builder;
+    builder.set<SENSOR>(42)
+           .set<STATE>(SensorState::ACTIVE)
+           .set<READING>(21.5)
+           .set<SAMPLES>(samples)
+           .set<LABEL>("intake manifold")
+           .set<BLOB>(ByteSpan(blob));
+    auto message = builder.finish();
+    EXPECT_EQ(message.size(), Telemetry::FIXED_SIZE + samples.size() * sizeof(float) + 15 + blob.size());
+    EXPECT_EQ(builder.size(), Telemetry::FIXED_SIZE) << "finish() leaves the builder empty";
+
+    Telemetry::View view{ByteSpan(message)};
+    EXPECT_EQ(view.get<SENSOR>(), 42u);
+    EXPECT_EQ(view.get<STATE>(), SensorState::ACTIVE);
+    ASSERT_TRUE(view.get<READING>().has_value());
+    EXPECT_DOUBLE_EQ(*view.get<READING>(), 21.5);
+    EXPECT_FALSE(view.has<CALIBRATED_AT>());
+    EXPECT_FALSE(view.get<CALIBRATED_AT>().has_value());
+    EXPECT_EQ(view.get<SAMPLES>().to_vector(), samples);
+    EXPECT_EQ(view.get<LABEL>(), "intake manifold");
+    EXPECT_EQ(view.get<BLOB>().to_vector(), blob);
+}
+
+TEST(BinarySchemaTest, UnsetFieldsReadAsDefaults) {
+    auto message = Telemetry::Builder().finish();
+    ASSERT_EQ(message.size(), Telemetry::FIXED_SIZE);
+
+    Telemetry::View view{ByteSpan(message)};
+    EXPECT_EQ(view.get<SENSOR>(), 0u);
+    EXPECT_FALSE(view.get<READING>().has_value());
+    EXPECT_TRUE(view.get<SAMPLES>().empty());
+    EXPECT_TRUE(view.get<LABEL>().empty());
+    EXPECT_TRUE(view.get<BLOB>().empty());
+}
+
+TEST(BinarySchemaTest, ValuesAreStoredLittleEndian) {
+    Heartbeat::Builder builder;
+    builder.set<0>(0x01020304u).set<1>(0x1122334455667788ull);
+    auto message = builder.finish();
+    ASSERT_EQ(message.size(), Heartbeat::FIXED_SIZE);
+    EXPECT_EQ(message[4], 0x04);
+    EXPECT_EQ(message[7], 0x01);
+    EXPECT_EQ(message[8], 0x88);
+    EXPECT_EQ(message[15], 0x11);
+}
+
+TEST(BinarySchemaTest, RejectsForeignAndMalformedMessages) {
+    auto heartbeat = Heartbeat::Builder().finish();
+    heartbeat.resize(Telemetry::FIXED_SIZE);
+    EXPECT_THROW(Telemetry::View{ByteSpan(heartbeat)}, TranscodingError);
+
+    Telemetry::Builder builder;
+    builder.set<LABEL>("label");
+    auto message = builder.finish();
+    EXPECT_THROW(Telemetry::View(ByteSpan(message.data(), Telemetry::FIXED_SIZE - 1)), TranscodingError);
+    EXPECT_THROW(Telemetry::View(ByteSpan(message.data(), message.size() - 1)), TranscodingError)
+        << "A variable-length field running past the buffer is rejected up front";
+}
+
+TEST(BinarySchemaTest, AdapterViewsPayloadInPlace) {
+    Telemetry::Builder builder;
+    builder.set<SENSOR>(7).set<CALIBRATED_AT>(-5).set<LABEL>("exhaust");
+    auto message = builder.finish();
+
+    BinaryCustomAdapter adapter;
+    auto encoded = adapter.encode(message.data(), message.size(), DataFormat::BINARY_CUSTOM);
+    auto view = adapter.viewMessage<Telemetry>(encoded);
+    EXPECT_EQ(view.get<SENSOR>(), 7u);
+    EXPECT_EQ(view.get<CALIBRATED_AT>(), std::optional<int64_t>(-5));
+    EXPECT_EQ(view.get<LABEL>(), "exhaust");
+    EXPECT_EQ(view.bytes().data(), encoded.data() + (encoded.size() - message.size()));
+
+    encoded.back() ^= 0xFF;
+    EXPECT_THROW(adapter.viewMessage<Telemetry>(encoded), TranscodingError);
+    EXPECT_NO_THROW(adapter.viewMessage<Telemetry>(encoded, false));
+    EXPECT_THROW(adapter.viewMessage<Heartbeat>(encoded, false), TranscodingError);
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <string>
+#include <vector>
 #include "xenocomm/core/capability_cache.h"
 
 using namespace xenocomm::core;
@@ -156,4 +158,49 @@ TEST_F(CapabilityCacheTest, Clear) {
     // Verify eviction stats
     auto stats = cache->get_stats();
     ASSERT_EQ(stats.evictions, 5);
-} 
\ No newline at end of file
+}
+
+// Entries hit since the last sweep get a second chance before unreferenced ones
+TEST_F(CapabilityCacheTest, ClockKeepsReferencedEntries) {
+    for (int i = 0; i < 10; i++) {
+        cache->put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    ASSERT_TRUE(cache->get("key0").has_value());
+
+    cache->put("key10", "value10");
+    EXPECT_TRUE(cache->get("key0").has_value());
+    EXPECT_FALSE(cache->get("key1").has_value());
+    EXPECT_TRUE(cache->get("key10").has_value());
+}
+
+// Typed values and many shards under concurrent readers
+TEST(BasicCapabilityCacheTest, TypedValuesAcrossShards) {
+    CacheConfig config;
+    config.max_entries = 4096;
+    config.track_stats = true;
+    BasicCapabilityCache<std::vector<std::string>> agents(config);
+
+    for (int i = 0; i < 1000; i++) {
+        agents.put("query" + std::to_string(i), {"agent" + std::to_string(i), "agent_shared"});
+    }
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&agents]() {
+            for (int i = 0; i < 1000; i++) {
+                auto found = agents.get("query" + std::to_string(i));
+                ASSERT_TRUE(found.has_value());
+                ASSERT_EQ(found->size(), 2u);
+                ASSERT_EQ((*found)[0], "agent" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    auto stats = agents.get_stats();
+    EXPECT_EQ(stats.hits, 4000u);
+    EXPECT_EQ(stats.insertions, 1000u);
+    EXPECT_EQ(stats.evictions, 0u);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/capability_columns.h"
+#include <random>
+#include <set>
+
+using namespace xenocomm::core;
+
+namespace {
+
+Capability randomCapability(std::mt19937& rng) {
+    static const char* const modes[] = {"fast", "safe", "lossy"};
+    Capability cap("service" + std::to_string(rng() % 3),
+                   Version(static_cast<uint16_t>(rng() % 3), static_cast<uint16_t>(rng() % 4),
+                           static_cast<uint16_t>(rng() % 2)));
+    if (rng() % 2) {
+        cap.parameters["mode"] = modes[rng() % 3];
+    }
+    if (rng() % 3 == 0) {
+        cap.parameters["region"] = "eu";
+    }
+    return cap;
+}
+
+uint32_t nameId(const std::string& name) {
+    return static_cast<uint32_t>(name.back() - '0');
+}
+
+// Agents whose capabilities satisfy the requirement under Capability::matches()
+std::set<uint32_t> expected(const std::vector<std::vector<Capability>>& agents, const Capability& required,
+                            bool partialMatch) {
+    std::set<uint32_t> result;
+    for (uint32_t agent = 0; agent < agents.size(); ++agent) {
+        for (const auto& cap : agents[agent]) {
+            if (cap.matches(required, partialMatch)) {
+                result.insert(agent);
+            }
+        }
+    }
+    return result;
+}
+
+std::set<uint32_t> toSet(const xenocomm::utils::CompressedBitset& bits) {
+    auto values = bits.to_vector();
+    return std::set<uint32_t>(values.begin(), values.end());
+}
+
+TEST(CapabilityColumnsTest, AgreesWithCapabilityMatches) {
+    // Enough rows to split the scan across threads where there are several cores
+    std::mt19937 rng(7);
+    std::vector<std::vector<Capability>> agents(CapabilityColumns::PARALLEL_ROW_THRESHOLD / 2 + 37);
+    CapabilityColumns columns;
+    for (uint32_t agent = 0; agent < agents.size(); ++agent) {
+        for (int i = 0; i < 3; ++i) {
+            Capability cap = randomCapability(rng);
+            agents[agent].push_back(cap);
+            columns.add(agent, nameId(cap.name), cap);
+        }
+    }
+
+    const std::vector<Capability> queries = {
+        {"service1", {1, 0, 0}},
+        {"service0", {0, 2, 0}, {{"mode", "fast"}}},
+        {"service2", {1, 1, 1}, {{"mode", "safe"}, {"region", "eu"}}},
+        {"service1", {0, 0, 0}, {{"region", "eu"}}},
+    };
+    for (const auto& required : queries) {
+        for (bool partial : {false, true}) {
+            auto query = columns.compile(nameId(required.name), required, partial);
+            EXPECT_EQ(toSet(columns.match(query)), expected(agents, required, partial))
+                << required.name << " partial=" << partial;
+        }
+    }
+}
+
+TEST(CapabilityColumnsTest, UnknownParametersMatchNothing) {
+    CapabilityColumns columns;
+    columns.add(0, 0, Capability("service", Version(1, 0, 0), {{"mode", "fast"}}));
+
+    auto query = columns.compile(0, Capability("service", Version(1, 0, 0), {{"mode", "slow"}}), true);
+    EXPECT_FALSE(query.satisfiable);
+    EXPECT_TRUE(columns.match(query).empty());
+    EXPECT_EQ(columns.match(columns.compile(0, Capability("service", Version(1, 0, 0)), true)).cardinality(), 1u);
+}
+
+TEST(CapabilityColumnsTest, RemovedRowsStopMatching) {
+    CapabilityColumns columns;
+    for (uint32_t agent = 0; agent < 4; ++agent) {
+        columns.add(agent, 0, Capability("service", Version(1, 0, agent), {{"mode", "fast"}}));
+    }
+    EXPECT_TRUE(columns.remove(1, 0, Version(1, 0, 1).packed()));
+    EXPECT_FALSE(columns.remove(1, 0, Version(1, 0, 1).packed()));
+    // The last row moved into the freed slot and can still be removed
+    EXPECT_TRUE(columns.remove(3, 0, Version(1, 0, 3).packed()));
+    EXPECT_EQ(columns.size(), 2u);
+
+    auto query = columns.compile(0, Capability("service", Version(1, 0, 0), {{"mode", "fast"}}), true);
+    EXPECT_EQ(toSet(columns.match(query)), (std::set<uint32_t>{0, 2}));
+}
+
+} // namespace
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <filesystem>
 #include <thread>
 #include "xenocomm/core/capability_index.h"
 #include "xenocomm/utils/serialization.h"
@@ -279,6 +280,202 @@ TEST_F(CapabilityIndexTest, DeprecatedCapabilityHandling) {
     ASSERT_EQ(partial_match[1], agent2);
 }
 
+TEST_F(CapabilityIndexTest, IntersectsLargePostingListsAndReusesAgentSlots) {
+    Capability storage = {"storage", {1, 0, 0}};
+    Capability gpu = {"gpu", {2, 0, 0}};
+    Capability gpuNewer = {"gpu", {2, 1, 0}};
+    Capability region = {"region", {1, 0, 0}, {{"zone", "eu"}}};
+
+    // Dense, medium and sparse lists over the same agents
+    const int agentCount = 20000;
+    for (int i = 0; i < agentCount; ++i) {
+        std::string agentId = "agent_" + std::to_string(i);
+        ASSERT_TRUE(index->addCapability(agentId, storage));
+        if (i % 3 == 0) {
+            ASSERT_TRUE(index->addCapability(agentId, (i / 1000) % 2 == 0 ? gpu : gpuNewer));
+        }
+        if (i % 1000 == 0) {
+            ASSERT_TRUE(index->addCapability(agentId, region));
+        }
+    }
+    EXPECT_EQ(index->size(), 20000u + 6667u + 20u);
+
+    auto both = index->findAgents({storage, gpu, region}, false);
+    std::sort(both.begin(), both.end());
+    std::vector<std::string> expected;
+    for (int i = 0; i < agentCount; i += 3000) {
+        expected.push_back("agent_" + std::to_string(i));
+    }
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(both, expected);
+
+    // Only agents on gpu 2.1.0 satisfy the newer requirement
+    auto newer = index->findAgents({gpuNewer, region}, false);
+    std::sort(newer.begin(), newer.end());
+    EXPECT_EQ(newer, (std::vector<std::string>{"agent_15000", "agent_3000", "agent_9000"}));
+
+    // Parameters are still checked under partial matching
+    EXPECT_TRUE(index->findAgents({{"region", {1, 0, 0}, {{"zone", "us"}}}}, true).empty());
+    EXPECT_EQ(index->findAgents({region, gpu}, true).size(), 7u);
+
+    // A removed agent's slot is reused without leaking its old capabilities
+    EXPECT_EQ(index->removeAgent("agent_0"), 3u);
+    ASSERT_TRUE(index->addCapability("newcomer", storage));
+    EXPECT_EQ(index->findAgents({region, gpu, storage}, false).size(), 6u);
+    auto newcomer = index->getAgentCapabilities("newcomer");
+    ASSERT_EQ(newcomer.size(), 1u);
+    EXPECT_EQ(newcomer[0].name, "storage");
+}
+
+TEST_F(CapabilityIndexTest, VersionRangesAndParametersStayConsistentUnderRemoval) {
+    Capability v1 = {"codec", {1, 0, 0}, {{"format", "h264"}}};
+    Capability v2 = {"codec", {2, 0, 0}, {{"format", "av1"}, {"hw", "yes"}}};
+    Capability v3 = {"codec", {3, 0, 0}};
+
+    // agent1 has v1 and v3, agent2 only v2
+    ASSERT_TRUE(index->addCapability("agent1", v1));
+    ASSERT_TRUE(index->addCapability("agent1", v3));
+    ASSERT_TRUE(index->addCapability("agent2", v2));
+
+    auto sorted = [](std::vector<std::string> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    EXPECT_EQ(sorted(index->findAgents({{"codec", {1, 0, 0}}})), (std::vector<std::string>{"agent1", "agent2"}));
+    EXPECT_EQ(sorted(index->findAgents({{"codec", {2, 5, 0}}})), (std::vector<std::string>{"agent1"}));
+
+    // The parameters must come from a single capability at a compatible version
+    EXPECT_TRUE(index->findAgents({{"codec", {2, 0, 0}, {{"format", "h264"}}}}, true).empty());
+    EXPECT_EQ(index->findAgents({{"codec", {1, 0, 0}, {{"format", "h264"}}}}, true),
+              (std::vector<std::string>{"agent1"}));
+    EXPECT_EQ(index->findAgents({{"codec", {1, 0, 0}, {{"format", "av1"}, {"hw", "yes"}}}}, true),
+              (std::vector<std::string>{"agent2"}));
+    EXPECT_TRUE(index->findAgents({{"codec", {1, 0, 0}, {{"format", "av1"}, {"hw", "no"}}}}, true).empty());
+
+    // Removing v3 leaves agent1 reachable only through v1; the parameters indexed for v2 go with it
+    ASSERT_TRUE(index->removeCapability("agent1", {"codec", {3, 0, 0}}));
+    EXPECT_EQ(sorted(index->findAgents({{"codec", {1, 0, 0}}})), (std::vector<std::string>{"agent1", "agent2"}));
+    EXPECT_EQ(index->findAgents({{"codec", {2, 0, 0}}}), (std::vector<std::string>{"agent2"}));
+    ASSERT_TRUE(index->removeCapability("agent2", {"codec", {2, 0, 0}}));
+    EXPECT_TRUE(index->findAgents({{"codec", {1, 0, 0}, {{"hw", "yes"}}}}, true).empty());
+    EXPECT_TRUE(index->findAgents({{"codec", {1, 5, 0}}}).empty());
+    EXPECT_EQ(index->size(), 1u);
+}
+
+// A bulk load answers every query the same way as adding the capabilities one at a time
+TEST_F(CapabilityIndexTest, BulkLoadMatchesIncrementalAdds) {
+    std::vector<std::pair<std::string, Capability>> registrations;
+    for (int i = 0; i < 300; ++i) {
+        std::string agent = "agent_" + std::to_string(i);
+        registrations.push_back({agent, {"codec", {static_cast<uint16_t>(1 + i % 3), static_cast<uint16_t>(i % 5), 0},
+                                         {{"hw", i % 2 ? "yes" : "no"}}}});
+        if (i % 4 == 0) {
+            registrations.push_back({agent, {"storage", {1, 0, 0}}});
+        }
+    }
+    registrations.push_back(registrations.front());  // Duplicates are not counted twice
+
+    CapabilityIndex incremental;
+    size_t added = 0;
+    for (const auto& [agent, cap] : registrations) {
+        added += incremental.addCapability(agent, cap) ? 1 : 0;
+    }
+    EXPECT_EQ(index->addCapabilities(registrations), added);
+    EXPECT_EQ(index->size(), incremental.size());
+
+    auto sorted = [](std::vector<std::string> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    std::vector<std::vector<Capability>> queries = {
+        {{"codec", {1, 0, 0}}},
+        {{"codec", {2, 3, 0}}},
+        {{"codec", {1, 2, 0}, {{"hw", "yes"}}}},
+        {{"codec", {3, 0, 0}}, {"storage", {1, 0, 0}}},
+    };
+    for (const auto& query : queries) {
+        for (bool partial : {false, true}) {
+            EXPECT_EQ(sorted(index->findAgents(query, partial)), sorted(incremental.findAgents(query, partial)));
+        }
+    }
+
+    EXPECT_EQ(index->removeAgents({"agent_0", "agent_1", "missing"}), 3u);
+    EXPECT_TRUE(index->getAgentCapabilities("agent_0").empty());
+    EXPECT_EQ(index->size(), incremental.size() - 3);
+}
+
+// A loaded snapshot, and changes applied over it, answer like an index built in memory
+TEST_F(CapabilityIndexTest, SnapshotServesQueriesAndAppliesDeltas) {
+    std::vector<CapabilityRegistration> registrations;
+    for (int i = 0; i < 200; ++i) {
+        std::string agent = "agent_" + std::to_string(i);
+        registrations.push_back({agent, {"codec", {static_cast<uint16_t>(1 + i % 3), static_cast<uint16_t>(i % 4), 0},
+                                         {{"hw", i % 2 ? "yes" : "no"}}}});
+        if (i % 5 == 0) {
+            registrations.push_back({agent, {"storage", {1, 0, 0}}});
+        }
+    }
+    Capability retired("storage", {1, 0, 0});
+    retired.deprecate({1, 0, 0}, Version(2, 0, 0), "storage2");
+    registrations.push_back({"agent_retired", retired});
+    index->addCapabilities(registrations);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "capability_index_snapshot.cis").string();
+    ASSERT_TRUE(index->saveSnapshot(path).has_value());
+    auto snapshot = CapabilitySnapshot::open(path);
+    ASSERT_TRUE(snapshot.has_value()) << snapshot.error();
+    CapabilityIndex loaded;
+    loaded.loadSnapshot(snapshot.value());
+    EXPECT_EQ(loaded.size(), index->size());
+    EXPECT_NE(loaded.generation("codec"), 0u);
+
+    auto sorted = [](std::vector<std::string> ids) {
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+    auto expectSameAnswers = [&] {
+        std::vector<std::vector<Capability>> queries = {
+            {{"codec", {1, 0, 0}}},
+            {{"codec", {2, 2, 0}, {{"hw", "yes"}}}},
+            {{"codec", {1, 0, 0}}, {"storage", {1, 0, 0}}},
+            {{"cache", {1, 0, 0}}},
+        };
+        for (const auto& query : queries) {
+            for (bool partial : {false, true}) {
+                EXPECT_EQ(sorted(loaded.findAgents(query, partial)), sorted(index->findAgents(query, partial)));
+            }
+        }
+        EXPECT_EQ(loaded.size(), index->size());
+    };
+    expectSameAnswers();
+    auto restored = loaded.getAgentCapabilities("agent_retired");
+    ASSERT_EQ(restored.size(), 1u);
+    EXPECT_TRUE(restored[0].is_deprecated);
+    EXPECT_EQ(restored[0].removal_version, std::optional<Version>(Version(2, 0, 0)));
+    EXPECT_EQ(restored[0].replacement_capability, std::optional<std::string>("storage2"));
+
+    // The same changes on both sides, touching snapshot agents and new ones
+    const uint64_t before = loaded.generation("codec");
+    for (CapabilityIndex* target : {index.get(), &loaded}) {
+        EXPECT_FALSE(target->addCapability(registrations[0].first, registrations[0].second));
+        EXPECT_TRUE(target->addCapability("agent_1", {"cache", {1, 0, 0}}));
+        EXPECT_TRUE(target->addCapability("newcomer", {"codec", {3, 9, 0}, {{"hw", "yes"}}}));
+        EXPECT_TRUE(target->removeCapability(registrations[2].first, registrations[2].second));
+        EXPECT_FALSE(target->removeCapability(registrations[2].first, registrations[2].second));
+        EXPECT_EQ(target->removeAgent("agent_10"), 2u);
+    }
+    EXPECT_NE(loaded.generation("codec"), before);
+    expectSameAnswers();
+    EXPECT_EQ(loaded.getAgentCapabilities("agent_1"), std::vector<Capability>{Capability("cache", {1, 0, 0})});
+    EXPECT_TRUE(loaded.getAgentCapabilities("agent_10").empty());
+
+    // Saving again folds the deltas into the new snapshot
+    ASSERT_TRUE(loaded.saveSnapshot(path).has_value());
+    loaded.loadSnapshot(CapabilitySnapshot::open(path).value());
+    expectSameAnswers();
+    std::filesystem::remove(path);
+}
+
 // TEST_F(CapabilityIndexTest, AddAndRetrieveCapability) {
 //     index->addCapability("agent1", {"serviceA", {1, 0, 0}});
 //     Capability retrievedCap = index->getAgentCapabilities("agent1")[0];
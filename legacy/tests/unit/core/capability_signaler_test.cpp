@@ -7,6 +7,10 @@
 #include <chrono>
 #include <memory>
 #include <unordered_set>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <set>
 
 using namespace xenocomm::core;
 using namespace std::chrono_literals;
@@ -257,4 +261,216 @@ TEST_F(CapabilitySignalerTest, VersionCompatibility) {
     auto found_exact = signaler->discoverAgents({req_v1_5_exact}, false);
     ASSERT_EQ(found_exact.size(), 1);
     ASSERT_EQ(found_exact[0], agent1);
-} 
\ No newline at end of file
+} 
+// Discovery runs alongside batched registration and never sees a partial batch
+TEST_F(CapabilitySignalerTest, DiscoveryDuringBatchedRegistration) {
+    const int numAgents = 200;
+    std::vector<Capability> batch = {{"batch_a", {1, 0, 0}}, {"batch_b", {1, 0, 0}}};
+    std::atomic<bool> done{false};
+    std::atomic<bool> partialSeen{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                auto withA = signaler->discoverAgents({batch[0]});
+                auto withBoth = signaler->discoverAgents(batch);
+                for (const auto& id : withBoth) {
+                    if (signaler->getAgentCapabilities(id).size() != batch.size()) {
+                        partialSeen = true;
+                    }
+                }
+                (void)withA;
+            }
+        });
+    }
+
+    for (int i = 0; i < numAgents; ++i) {
+        EXPECT_EQ(signaler->registerCapabilities("agent_" + std::to_string(i), batch), batch.size());
+    }
+    done = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    EXPECT_FALSE(partialSeen.load());
+    EXPECT_EQ(signaler->discoverAgents(batch).size(), static_cast<size_t>(numAgents));
+    EXPECT_EQ(signaler->registerCapabilities("agent_0", batch), 0u);
+}
+
+// Cached exact lookups follow changes to the capabilities they queried
+TEST_F(CapabilitySignalerTest, CachedDiscoveryTracksQueriedCapabilities) {
+    Capability storage = {"storage", {1, 0, 0}};
+    Capability compute = {"compute", {1, 0, 0}};
+    ASSERT_TRUE(signaler->registerCapability("agent_a", storage));
+    ASSERT_TRUE(signaler->registerCapability("agent_b", compute));
+
+    EXPECT_EQ(signaler->discoverAgents({storage}), std::vector<std::string>{"agent_a"});
+    EXPECT_EQ(signaler->discoverAgents({storage}), std::vector<std::string>{"agent_a"});
+
+    // Churn on another capability leaves the storage result as it was
+    ASSERT_TRUE(signaler->unregisterCapability("agent_b", compute));
+    ASSERT_TRUE(signaler->registerCapability("agent_b", compute));
+    EXPECT_EQ(signaler->discoverAgents({storage}), std::vector<std::string>{"agent_a"});
+
+    ASSERT_TRUE(signaler->unregisterCapability("agent_a", storage));
+    EXPECT_TRUE(signaler->discoverAgents({storage}).empty());
+    ASSERT_TRUE(signaler->registerCapability("agent_b", storage));
+    EXPECT_EQ(signaler->discoverAgents({storage}), std::vector<std::string>{"agent_b"});
+    EXPECT_EQ(signaler->discoverAgents({storage, compute}), std::vector<std::string>{"agent_b"});
+}
+
+// Queries naming the same requirements in another order share a cache entry and its answer
+TEST_F(CapabilitySignalerTest, CachedDiscoveryIgnoresRequirementOrder) {
+    Capability storage = {"storage", {1, 0, 0}, {{"tier", "hot"}}};
+    Capability compute = {"compute", {2, 0, 0}};
+    ASSERT_TRUE(signaler->registerCapability("agent_a", storage));
+    ASSERT_TRUE(signaler->registerCapability("agent_a", compute));
+
+    EXPECT_EQ(signaler->discoverAgents({storage, compute}), std::vector<std::string>{"agent_a"});
+    EXPECT_EQ(signaler->discoverAgents({compute, storage}), std::vector<std::string>{"agent_a"});
+
+    // Same names at another version are a different query
+    Capability newerStorage = {"storage", {2, 0, 0}, {{"tier", "hot"}}};
+    EXPECT_TRUE(signaler->discoverAgents({compute, newerStorage}).empty());
+
+    ASSERT_TRUE(signaler->unregisterCapability("agent_a", compute));
+    EXPECT_TRUE(signaler->discoverAgents({compute, storage}).empty());
+}
+
+// An agent's capabilities travel as one set and can be registered back as one batch
+TEST_F(CapabilitySignalerTest, BinaryCapabilitySetRoundTrip) {
+    std::vector<Capability> caps = {
+        {"relay", {1, 0, 0}, {{"mode", "fast"}}},
+        {"relay", {1, 1, 0}, {{"mode", "fast"}}},
+    };
+    ASSERT_EQ(signaler->registerCapabilities("source_agent", caps), caps.size());
+
+    auto data = signaler->getAgentCapabilitiesBinary("source_agent");
+    auto view = xenocomm::utils::CapabilitySetView::parse(data.data(), data.size());
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->size(), caps.size());
+    EXPECT_TRUE(view->anyMatches({"relay", {1, 1, 0}, {{"mode", "fast"}}}));
+
+    ASSERT_TRUE(signaler->registerCapabilityBinary("copy_agent", data));
+    EXPECT_EQ(signaler->getAgentCapabilities("copy_agent").size(), caps.size());
+    EXPECT_TRUE(signaler->getAgentCapabilitiesBinary("unknown_agent").empty());
+}
+
+// Many agents come and go in single batches
+TEST_F(CapabilitySignalerTest, MultiAgentBatchRegistration) {
+    std::vector<CapabilityRegistration> registrations;
+    std::vector<std::string> agents;
+    for (int i = 0; i < 100; ++i) {
+        agents.push_back("agent_" + std::to_string(i));
+        registrations.push_back({agents.back(), {"worker", {1, static_cast<uint16_t>(i % 3), 0}}});
+        registrations.push_back({agents.back(), {"cache", {1, 0, 0}}});
+    }
+    registrations.push_back({"", {"worker", {1, 0, 0}}});
+
+    EXPECT_EQ(signaler->registerCapabilities(registrations), 200u);
+    EXPECT_EQ(signaler->discoverAgents({{"worker", {1, 0, 0}}, {"cache", {1, 0, 0}}}).size(), 100u);
+
+    std::vector<std::string> leaving(agents.begin(), agents.begin() + 40);
+    EXPECT_EQ(signaler->unregisterAgentBatch(leaving), 80u);
+    EXPECT_EQ(signaler->discoverAgents({{"cache", {1, 0, 0}}}).size(), 60u);
+    EXPECT_TRUE(signaler->getAgentCapabilities("agent_0").empty());
+}
+
+// A restarted signaler is warm as soon as it loads the previous one's snapshot
+TEST_F(CapabilitySignalerTest, SnapshotWarmStart) {
+    for (int i = 0; i < 50; ++i) {
+        signaler->registerCapability("agent_" + std::to_string(i), {"worker", {1, static_cast<uint16_t>(i % 3), 0}});
+    }
+    const std::string path = (std::filesystem::temp_directory_path() / "capability_signaler_snapshot.cis").string();
+    ASSERT_TRUE(signaler->saveSnapshot(path));
+
+    auto restarted = createInMemoryCapabilitySignaler();
+    EXPECT_FALSE(restarted->loadSnapshot(path + ".missing"));
+    ASSERT_TRUE(restarted->loadSnapshot(path));
+    EXPECT_EQ(restarted->discoverAgents({{"worker", {1, 1, 0}}}).size(), 33u);
+    EXPECT_EQ(restarted->discoverAgents({{"worker", {1, 2, 0}}}).size(), 16u);
+
+    // Later registrations land on top, and cached results follow them
+    ASSERT_TRUE(restarted->registerCapability("agent_late", {"worker", {1, 2, 0}}));
+    ASSERT_TRUE(restarted->unregisterCapability("agent_2", {"worker", {1, 2, 0}}));
+    EXPECT_EQ(restarted->discoverAgents({{"worker", {1, 1, 0}}}).size(), 33u);
+    EXPECT_EQ(restarted->discoverAgents({{"worker", {1, 2, 0}}}).size(), 16u);
+    std::filesystem::remove(path);
+}
+
+// A standing query hears about exactly the agents entering and leaving its result
+TEST_F(CapabilitySignalerTest, SubscriptionsReportResultChanges) {
+    signaler->registerCapability("early", {"worker", {1, 0, 0}});
+    std::vector<DiscoveryEvent> events;
+    auto record = [&events](const DiscoveryEvent& event) { events.push_back(event); };
+    const std::vector<Capability> query = {{"worker", {1, 0, 0}}, {"cache", {1, 0, 0}}};
+
+    signaler->registerCapability("early", {"cache", {1, 0, 0}});
+    uint64_t id = signaler->subscribe(query, false, record);
+    ASSERT_NE(id, 0u);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].subscription, id);
+    EXPECT_EQ(events[0].added, std::vector<std::string>{"early"});
+
+    // Half a match, then unrelated capabilities, say nothing
+    signaler->registerCapability("late", {"worker", {1, 2, 0}});
+    signaler->registerCapability("late", {"storage", {1, 0, 0}});
+    EXPECT_EQ(events.size(), 1u);
+    signaler->registerCapability("late", {"cache", {1, 1, 0}});
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].added, std::vector<std::string>{"late"});
+
+    signaler->unregisterCapability("early", {"cache", {1, 0, 0}});
+    signaler->unregisterAgentBatch({"late"});
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[2].removed, std::vector<std::string>{"early"});
+    EXPECT_EQ(events[3].removed, std::vector<std::string>{"late"});
+
+    // A batch is one event, and each subscription keeps to its own query
+    std::vector<DiscoveryEvent> partialEvents;
+    uint64_t partialId = signaler->subscribe({{"worker", {1, 0, 0}, {{"gpu", "yes"}}}}, true,
+                                             [&](const DiscoveryEvent& event) { partialEvents.push_back(event); });
+    EXPECT_TRUE(partialEvents.empty());
+    signaler->registerCapabilities(std::vector<CapabilityRegistration>{
+        {"a", {"worker", {2, 0, 0}, {{"gpu", "yes"}}}}, {"a", {"cache", {1, 0, 0}}},
+        {"b", {"worker", {1, 0, 0}, {{"gpu", "no"}}}}, {"b", {"cache", {1, 0, 0}}}});
+    ASSERT_EQ(events.size(), 5u);
+    EXPECT_EQ(events[4].added, (std::vector<std::string>{"a", "b"}));
+    ASSERT_EQ(partialEvents.size(), 1u);
+    EXPECT_EQ(partialEvents[0].added, std::vector<std::string>{"a"});
+
+    EXPECT_TRUE(signaler->unsubscribe(id));
+    EXPECT_FALSE(signaler->unsubscribe(id));
+    signaler->unregisterAgentBatch({"a", "b"});
+    EXPECT_EQ(events.size(), 5u);
+    ASSERT_EQ(partialEvents.size(), 2u);
+    EXPECT_EQ(partialEvents[1].removed, std::vector<std::string>{"a"});
+    EXPECT_TRUE(signaler->unsubscribe(partialId));
+}
+
+// However registrations churn, a subscription's running result equals a fresh discovery
+TEST_F(CapabilitySignalerTest, SubscriptionTracksDiscovery) {
+    const std::vector<Capability> query = {{"worker", {1, 1, 0}}, {"cache", {1, 0, 0}}};
+    std::set<std::string> tracked;
+    signaler->subscribe(query, false, [&tracked](const DiscoveryEvent& event) {
+        tracked.insert(event.added.begin(), event.added.end());
+        for (const auto& agent : event.removed) {
+            tracked.erase(agent);
+        }
+    });
+
+    std::srand(11);
+    for (int step = 0; step < 400; ++step) {
+        std::string agent = "agent_" + std::to_string(std::rand() % 20);
+        Capability cap(std::rand() % 2 ? "worker" : "cache", {1, static_cast<uint16_t>(std::rand() % 3), 0});
+        switch (std::rand() % 4) {
+            case 0:
+            case 1: signaler->registerCapability(agent, cap); break;
+            case 2: signaler->unregisterCapability(agent, cap); break;
+            default: signaler->unregisterAgentBatch({agent}); break;
+        }
+        auto found = signaler->discoverAgents(query);
+        ASSERT_EQ(tracked, std::set<std::string>(found.begin(), found.end())) << "step " << step;
+    }
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/compression_context.h"
+#include <string>
+#include <thread>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+std::vector<uint8_t> controlMessage(int i) {
+    std::string text = "{\"type\":\"heartbeat\",\"agent\":\"planner-7\",\"status\":\"ready\",\"load\":0." +
+                       std::to_string(i % 10) + ",\"seq\":" + std::to_string(i) + "}";
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+utils::ByteSpan span(const std::vector<uint8_t>& data) {
+    return utils::ByteSpan(data.data(), data.size());
+}
+
+TEST(CompressionContextTest, HistoryShrinksSimilarMessages) {
+    CompressionContext sender, receiver;
+    size_t first_size = 0;
+    size_t later_size = 0;
+    for (int i = 0; i < 20; ++i) {
+        auto message = controlMessage(i);
+        auto frame = sender.compress(span(message));
+        EXPECT_EQ(receiver.decompress(span(frame)), message);
+        if (i == 0) first_size = frame.size();
+        if (i == 19) later_size = frame.size();
+    }
+    // Once the history holds one, each message is mostly references to it
+    EXPECT_LT(later_size * 2, first_size);
+
+    // Standalone frames neither use nor disturb the history
+    auto message = controlMessage(99);
+    auto alone = sender.compress(span(message), true);
+    EXPECT_GT(alone.size(), later_size);
+    EXPECT_EQ(CompressionContext().decompress(span(alone)), message);
+    auto next = sender.compress(span(controlMessage(20)));
+    EXPECT_EQ(receiver.decompress(span(next)), controlMessage(20));
+}
+
+TEST(CompressionContextTest, LostFrameNeedsANewEpoch) {
+    CompressionContext sender, receiver;
+    auto first = sender.compress(span(controlMessage(0)));
+    auto lost = sender.compress(span(controlMessage(1)));
+    auto third = sender.compress(span(controlMessage(2)));
+    receiver.decompress(span(first));
+    (void)lost;
+
+    try {
+        receiver.decompress(span(third), std::chrono::milliseconds(5));
+        FAIL() << "Expected CompressionError";
+    } catch (const CompressionError& e) {
+        EXPECT_EQ(e.getErrorCode(), CompressionErrorCode::DECOMPRESSION_FAILURE);
+    }
+    const uint32_t epoch = CompressionContext::frameEpoch(span(third));
+    EXPECT_EQ(epoch, sender.compressorEpoch());
+
+    // The sender restarts; the frame that opens the new epoch resyncs the receiver
+    sender.resetCompressor();
+    auto restart = sender.compress(span(controlMessage(3)));
+    EXPECT_EQ(CompressionContext::frameEpoch(span(restart)), epoch + 1);
+    EXPECT_EQ(receiver.decompress(span(restart)), controlMessage(3));
+    EXPECT_EQ(receiver.decompress(span(sender.compress(span(controlMessage(4))))), controlMessage(4));
+
+    EXPECT_THROW(receiver.decompress(utils::ByteSpan(restart.data(), 4)), CompressionError);
+}
+
+TEST(CompressionContextTest, FrameAheadWaitsForItsPredecessor) {
+    CompressionContext sender, receiver;
+    auto first = sender.compress(span(controlMessage(0)));
+    auto second = sender.compress(span(controlMessage(1)));
+
+    std::vector<uint8_t> decoded;
+    std::thread late([&] { decoded = receiver.decompress(span(second), std::chrono::milliseconds(2000)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(receiver.decompress(span(first)), controlMessage(0));
+    late.join();
+    EXPECT_EQ(decoded, controlMessage(1));
+}
+
+TEST(CompressionContextTest, RefusesOversizedOutput) {
+    CompressionContext sender, receiver(CompressionContext::DEFAULT_LEVEL, 1000);
+    std::vector<uint8_t> large(5000, 'x');
+    EXPECT_THROW(receiver.decompress(span(sender.compress(span(large)))), CompressionError);
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/compression_selector.h"
+#include "xenocomm/core/compressed_state_adapter.h"
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace xenocomm::core;
+
+namespace {
+
+std::vector<uint8_t> textPayload(size_t messages) {
+    std::string text;
+    for (size_t i = 0; i < messages; ++i) {
+        text += "{\"type\":\"capability_update\",\"agent\":\"agent-" + std::to_string(i % 97) +
+                "\",\"sequence\":" + std::to_string(i) + ",\"status\":\"ready\",\"region\":\"eu-west\"}";
+    }
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+std::vector<uint8_t> counterPayload(size_t count) {
+    std::vector<uint8_t> data(count * sizeof(uint32_t));
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t value = 500000u + static_cast<uint32_t>(i * 11 + i % 3);
+        std::memcpy(data.data() + i * sizeof(value), &value, sizeof(value));
+    }
+    return data;
+}
+
+std::vector<uint8_t> randomPayload(size_t size) {
+    std::mt19937 gen(7);
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(gen());
+    }
+    return data;
+}
+
+CompressionSelectorConfig linkAt(double bytes_per_second) {
+    CompressionSelectorConfig config;
+    config.link_bandwidth = bytes_per_second;
+    return config;
+}
+
+} // namespace
+
+TEST(CompressionSelectorTest, ProfileMeasuresEntropyRunsAndDeltas) {
+    auto random = randomPayload(64 * 1024);
+    auto profile = profilePayload(random.data(), random.size(), 4096);
+    EXPECT_EQ(profile.size, random.size());
+    EXPECT_LE(profile.sampled, 4096u);
+    EXPECT_GT(profile.entropy, 7.0);
+    EXPECT_LT(profile.run_fraction, 0.05);
+    EXPECT_GT(profile.packed_delta_ratio, 0.9);
+
+    std::vector<uint8_t> runs(10000, 1);
+    std::fill(runs.begin() + 5000, runs.end(), 2);
+    profile = profilePayload(runs.data(), runs.size(), 4096);
+    EXPECT_LT(profile.entropy, 1.1);
+    EXPECT_GT(profile.run_fraction, 0.99);
+
+    auto counters = counterPayload(4096);
+    profile = profilePayload(counters.data(), counters.size(), 4096);
+    EXPECT_LT(profile.packed_delta_of_delta_ratio, 0.2);
+
+    auto text = textPayload(100);
+    profile = profilePayload(text.data(), text.size(), 4096);
+    EXPECT_GT(profile.match_fraction, 0.5);
+}
+
+TEST(CompressionSelectorTest, FastLinkSkipsCompression) {
+    CompressionSelector selector(linkAt(1e11));
+    EXPECT_EQ(selector.select(textPayload(200)).algorithm_id, "NONE");
+    EXPECT_EQ(selector.select(randomPayload(8192), "random").algorithm_id, "NONE");
+}
+
+TEST(CompressionSelectorTest, SlowLinkSpendsMoreCpu) {
+    if (!ZstdCompression::isAvailable()) {
+        GTEST_SKIP() << "Zstandard support is not built in";
+    }
+    auto text = textPayload(200);
+    CompressionSelector moderate(linkAt(1e8));
+    CompressionSelector slow(linkAt(1e4));
+    auto moderate_choice = moderate.select(text);
+    auto slow_choice = slow.select(text);
+    EXPECT_EQ(slow_choice.algorithm_id, "ZSTD");
+    if (moderate_choice.algorithm_id == "ZSTD") {
+        EXPECT_GT(slow_choice.level, moderate_choice.level);
+    }
+    EXPECT_LT(slow_choice.predicted_ratio, 0.5);
+}
+
+TEST(CompressionSelectorTest, PicksPackedDeltasForCounters) {
+    CompressionSelector selector;
+    auto choice = selector.select(counterPayload(2048));
+    EXPECT_EQ(choice.algorithm_id, "PACKED_DELTA");
+    EXPECT_EQ(choice.level, 2);
+}
+
+TEST(CompressionSelectorTest, CachesChoicePerMessageType) {
+    CompressionSelectorConfig config;
+    config.cache_capacity = 2;
+    config.revalidate_interval = 8;
+    CompressionSelector selector(config);
+    auto counters = counterPayload(1024);
+    auto text = textPayload(50);
+
+    for (int i = 0; i < 8; ++i) {
+        selector.select(counters, "telemetry");
+    }
+    auto stats = selector.getStats();
+    EXPECT_EQ(stats.profiles, 1u);
+    EXPECT_EQ(stats.cache_hits, 7u);
+
+    // Revalidation is due, and a much larger payload is profiled afresh too
+    selector.select(counters, "telemetry");
+    selector.select(counterPayload(8192), "telemetry");
+    EXPECT_EQ(selector.getStats().profiles, 3u);
+
+    selector.select(text, "control");
+    selector.select(text, "status");
+    stats = selector.getStats();
+    EXPECT_EQ(stats.cached_types, 2u);
+    selector.select(counters, "telemetry");
+    EXPECT_EQ(selector.getStats().profiles, stats.profiles + 1) << "Least recently used type is evicted";
+}
+
+TEST(CompressionSelectorTest, ObservationsCorrectPredictions) {
+    CompressionSelector selector;
+    auto counters = counterPayload(2048);
+    auto choice = selector.select(counters, "telemetry");
+    ASSERT_NE(choice.algorithm_id, "NONE");
+
+    // Report the chosen codec expanding the data; the type moves off it
+    for (int i = 0; i < 10; ++i) {
+        selector.observe("telemetry", choice, counters.size(), counters.size() * 2, std::chrono::microseconds(5));
+    }
+    auto next = selector.select(counters, "telemetry");
+    EXPECT_FALSE(next.algorithm_id == choice.algorithm_id && next.level == choice.level);
+}
+
+TEST(CompressionSelectorTest, BandwidthChangeRemakesCachedChoices) {
+    CompressionSelector selector(linkAt(1e4));
+    auto counters = counterPayload(2048);
+    EXPECT_NE(selector.select(counters, "telemetry").algorithm_id, "NONE");
+    selector.setLinkBandwidth(1e11);
+    EXPECT_DOUBLE_EQ(selector.linkBandwidth(), 1e11);
+    EXPECT_EQ(selector.select(counters, "telemetry").algorithm_id, "NONE");
+    EXPECT_EQ(selector.getStats().profiles, 1u);
+}
+
+TEST(CompressionSelectorTest, AdapterRoundTripsSelectedAlgorithms) {
+    for (double bandwidth : {1e4, 1e6, 1e11}) {
+        CompressedStateAdapter adapter(nullptr, linkAt(bandwidth));
+        for (const auto& data : {textPayload(100), counterPayload(1000), randomPayload(3000)}) {
+            auto encoded = adapter.encode(data.data(), data.size(), DataFormat::COMPRESSED_STATE, "mixed");
+            EXPECT_EQ(adapter.decode(encoded, DataFormat::COMPRESSED_STATE), data);
+        }
+    }
+
+    CompressedStateAdapter adapter(nullptr, linkAt(1e11));
+    auto text = textPayload(20);
+    auto encoded = adapter.encode(text.data(), text.size(), DataFormat::COMPRESSED_STATE);
+    EXPECT_NE(adapter.getMetadata(encoded).custom_metadata_json.find("\"NONE\""), std::string::npos);
+}
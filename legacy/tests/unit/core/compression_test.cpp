@@ -3,6 +3,8 @@
 #include "xenocomm/core/compressed_state_adapter.h"
 #include <random>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 using namespace xenocomm::core;
 
@@ -235,7 +237,7 @@ TEST_F(CompressionTest, CompressedStateCorruptedHeader) {
     }
 }
 
-/* // Commenting out Zlib and LZ4 tests due to persistent undefined identifier errors
+/* // Commenting out the Zlib test until a ZLibCompression algorithm exists
 TEST_F(CompressionTest, ZlibCompressionDecompression) {
     ZLibCompression zlib; 
     std::vector<uint8_t> data = {'H', 'e', 'l', 'l', 'o', ',', ' ', 'W', 'o', 'r', 'l', 'd', '!'};
@@ -244,13 +246,279 @@ TEST_F(CompressionTest, ZlibCompressionDecompression) {
     auto decompressed = zlib.decompress(compressed);
     EXPECT_EQ(decompressed, data) << "Decompressed data should match original";
 }
+*/
+
+// Control messages sharing one schema, as agents exchange them
+std::vector<uint8_t> controlMessage(int i) {
+    std::string message = "{\"type\":\"capability_update\",\"agent\":\"agent-" + std::to_string(i % 97) +
+                          "\",\"sequence\":" + std::to_string(i) +
+                          ",\"status\":\"" + (i % 3 ? "ready" : "busy") +
+                          "\",\"load\":0." + std::to_string(i % 10) + ",\"region\":\"eu-west\"}";
+    return std::vector<uint8_t>(message.begin(), message.end());
+}
 
 TEST_F(CompressionTest, LZ4CompressionDecompression) {
-    LZ4Compression lz4; 
-    std::vector<uint8_t> data = {'L', 'Z', '4', ' ', 'T', 'e', 's', 't', ' ', 'D', 'a', 't', 'a'};
+    if (!LZ4Compression::isAvailable()) {
+        GTEST_SKIP() << "LZ4 support is not built in";
+    }
+    LZ4Compression lz4;
+    std::vector<uint8_t> data;
+    for (int i = 0; i < 50; ++i) {
+        auto message = controlMessage(i);
+        data.insert(data.end(), message.begin(), message.end());
+    }
     auto compressed = lz4.compress(data);
-    ASSERT_FALSE(compressed.empty());
-    auto decompressed = lz4.decompress(compressed);
-    EXPECT_EQ(decompressed, data) << "Decompressed data should match original";
+    EXPECT_LT(compressed.size(), data.size() / 2);
+    EXPECT_EQ(lz4.decompress(compressed), data) << "Decompressed data should match original";
+
+    auto random = generateRandomData(1000);
+    EXPECT_EQ(lz4.decompress(lz4.compress(random)), random);
+
+    compressed.resize(compressed.size() / 2);
+    EXPECT_THROW(lz4.decompress(compressed), CompressionError);
+}
+
+TEST_F(CompressionTest, ZstdCompressionAcrossLevels) {
+    if (!ZstdCompression::isAvailable()) {
+        GTEST_SKIP() << "Zstd support is not built in";
+    }
+    std::vector<uint8_t> data;
+    for (int i = 0; i < 200; ++i) {
+        auto message = controlMessage(i);
+        data.insert(data.end(), message.begin(), message.end());
+    }
+
+    size_t fastest_size = 0;
+    for (int level : {1, ZstdCompression::DEFAULT_LEVEL, 19}) {
+        ZstdCompression zstd(level);
+        auto compressed = zstd.compress(data);
+        EXPECT_EQ(zstd.decompress(compressed), data) << "level " << level;
+        if (level == 1) {
+            fastest_size = compressed.size();
+        } else if (level == 19) {
+            EXPECT_LT(compressed.size(), fastest_size);
+        }
+    }
+}
+
+TEST_F(CompressionTest, ZstdTrainedDictionaryCompressesSmallMessages) {
+    if (!ZstdCompression::isAvailable()) {
+        GTEST_SKIP() << "Zstd support is not built in";
+    }
+    std::vector<std::vector<uint8_t>> samples;
+    for (int i = 0; i < 1000; ++i) {
+        samples.push_back(controlMessage(i));
+    }
+    auto dictionary = ZstdDictionary::train(samples, 4096);
+    ASSERT_NE(dictionary->id(), 0u);
+
+    ZstdCompression plain;
+    ZstdCompression trained(ZstdCompression::DEFAULT_LEVEL, dictionary);
+    auto message = controlMessage(123457);
+    auto with_dictionary = trained.compress(message);
+    EXPECT_LT(with_dictionary.size() * 3, plain.compress(message).size());
+    EXPECT_LT(with_dictionary.size() * 3, message.size());
+
+    auto copy = trained.clone();
+    EXPECT_EQ(copy->decompress(with_dictionary), message);
+    EXPECT_THROW(plain.decompress(with_dictionary), CompressionError);
+}
+
+TEST_F(CompressionTest, CompressedStateWithZstdDictionary) {
+    if (!ZstdCompression::isAvailable()) {
+        GTEST_SKIP() << "Zstd support is not built in";
+    }
+    std::vector<std::vector<uint8_t>> samples;
+    for (int i = 0; i < 1000; ++i) {
+        samples.push_back(controlMessage(i));
+    }
+    auto dictionary = ZstdDictionary::train(samples, 4096);
+    CompressedStateAdapter adapter(std::make_unique<ZstdCompression>(ZstdCompression::DEFAULT_LEVEL, dictionary));
+
+    auto message = controlMessage(4242);
+    auto encoded = adapter.encode(message.data(), message.size(), DataFormat::COMPRESSED_STATE);
+    EXPECT_EQ(adapter.decode(encoded, DataFormat::COMPRESSED_STATE), message);
+    EXPECT_NE(adapter.getMetadata(encoded).custom_metadata_json.find("\"ZSTD\""), std::string::npos);
+}
+
+TEST_F(CompressionTest, CompressedStateSelectsAlgorithmPerPayload) {
+    CompressedStateAdapter adapter(nullptr);
+    std::vector<uint8_t> text;
+    for (int i = 0; i < 20; ++i) {
+        auto message = controlMessage(i);
+        text.insert(text.end(), message.begin(), message.end());
+    }
+
+    auto repeating = generateRepeatingData(100);
+    for (const auto& data : {repeating, text}) {
+        auto encoded = adapter.encode(data.data(), data.size(), DataFormat::COMPRESSED_STATE);
+        EXPECT_EQ(adapter.decode(encoded, DataFormat::COMPRESSED_STATE), data);
+    }
+
+    auto encoded = adapter.encode(text.data(), text.size(), DataFormat::COMPRESSED_STATE);
+    const std::string expected = ZstdCompression::isAvailable() ? "\"ZSTD\""
+                               : LZ4Compression::isAvailable() ? "\"LZ4\"" : "\"NONE\"";
+    EXPECT_NE(adapter.getMetadata(encoded).custom_metadata_json.find(expected), std::string::npos);
+}
+
+TEST_F(CompressionTest, CreatesAlgorithmsByNegotiatedId) {
+    EXPECT_EQ(createCompressionAlgorithm("RLE")->getAlgorithmId(), "RLE");
+    EXPECT_EQ(createCompressionAlgorithm("DELTA")->getAlgorithmId(), "DELTA");
+    EXPECT_EQ(createCompressionAlgorithm("PACKED_DELTA")->getAlgorithmId(), "PACKED_DELTA");
+    EXPECT_EQ(createCompressionAlgorithm("LZ4") != nullptr, LZ4Compression::isAvailable());
+    EXPECT_EQ(createCompressionAlgorithm("ZSTD") != nullptr, ZstdCompression::isAvailable());
+    EXPECT_EQ(createCompressionAlgorithm("ZLIB"), nullptr);
+}
+
+TEST_F(CompressionTest, RLESplitsLongRunsAtCountLimit) {
+    RunLengthEncoding rle;
+    std::vector<uint8_t> data(600, 7);
+    data.insert(data.end(), 40, 9);
+    data.push_back(7);
+
+    std::vector<uint8_t> expected = {255, 7, 255, 7, 90, 7, 40, 9, 1, 7};
+    auto compressed = rle.compress(data);
+    EXPECT_EQ(compressed, expected);
+    EXPECT_EQ(rle.decompress(compressed), data);
+}
+
+// Packed delta tests
+TEST_F(CompressionTest, PackedDeltaRoundTripsEveryWidthAndOrder) {
+    std::mt19937 gen(42);
+    for (size_t width : {2u, 4u, 8u}) {
+        for (auto order : {PackedDeltaEncoding::Order::DELTA, PackedDeltaEncoding::Order::DELTA_OF_DELTA}) {
+            PackedDeltaEncoding codec(width, order);
+            // Counts below, at and across block boundaries, with and without tail bytes
+            for (size_t count : {1u, 2u, 3u, 129u, 300u}) {
+                std::vector<uint8_t> data(count * width + count % width);
+                uint64_t value = gen();
+                for (size_t i = 0; i + width <= data.size(); i += width) {
+                    value += gen() % 64 - 32;
+                    std::memcpy(data.data() + i, &value, width);
+                }
+                auto compressed = codec.compress(data);
+                EXPECT_EQ(codec.decompress(compressed), data) << "width " << width << " count " << count;
+            }
+            auto random = generateRandomData(1003);
+            EXPECT_EQ(codec.decompress(codec.compress(random)), random);
+        }
+    }
+}
+
+TEST_F(CompressionTest, PackedDeltaCompressesSlowlyChangingSensorValues) {
+    std::vector<uint32_t> counters(4096);
+    std::vector<float> readings(4096);
+    for (size_t i = 0; i < counters.size(); ++i) {
+        counters[i] = 1000000u + static_cast<uint32_t>(i) * 3u + static_cast<uint32_t>(i % 5);
+        readings[i] = 20.0f + std::sin(static_cast<float>(i) * 0.001f);
+    }
+    std::vector<uint8_t> counter_bytes(reinterpret_cast<uint8_t*>(counters.data()),
+                                       reinterpret_cast<uint8_t*>(counters.data() + counters.size()));
+    std::vector<uint8_t> reading_bytes(reinterpret_cast<uint8_t*>(readings.data()),
+                                       reinterpret_cast<uint8_t*>(readings.data() + readings.size()));
+
+    PackedDeltaEncoding delta(4, PackedDeltaEncoding::Order::DELTA);
+    PackedDeltaEncoding delta_of_delta(4, PackedDeltaEncoding::Order::DELTA_OF_DELTA);
+    auto compressed = delta_of_delta.compress(counter_bytes);
+    EXPECT_LT(compressed.size() * 6, counter_bytes.size());
+    EXPECT_EQ(delta_of_delta.decompress(compressed), counter_bytes);
+
+    compressed = delta.compress(reading_bytes);
+    EXPECT_LT(compressed.size() * 2, reading_bytes.size());
+    EXPECT_EQ(delta.decompress(compressed), reading_bytes);
+    EXPECT_TRUE(delta.isSuitableFor(reading_bytes));
+    EXPECT_FALSE(delta.isSuitableFor(generateRandomData(4096)));
+}
+
+TEST_F(CompressionTest, PackedDeltaRejectsBadWidthAndCorruptData) {
+    EXPECT_THROW(PackedDeltaEncoding(3), CompressionError);
+
+    PackedDeltaEncoding codec;
+    std::vector<uint8_t> data(4000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i / 16);
+    }
+    auto compressed = codec.compress(data);
+    auto truncated = compressed;
+    truncated.resize(compressed.size() / 2);
+    EXPECT_THROW(codec.decompress(truncated), CompressionError);
+
+    auto bad_width = compressed;
+    bad_width[0] = 3;
+    EXPECT_THROW(codec.decompress(bad_width), CompressionError);
+}
+
+TEST_F(CompressionTest, CompressedStateSelectsPackedDeltaForCounters) {
+    CompressedStateAdapter adapter(nullptr);
+    std::vector<uint32_t> counters(1024);
+    for (size_t i = 0; i < counters.size(); ++i) {
+        counters[i] = 70000u + static_cast<uint32_t>(i * 7 + i % 3);
+    }
+    auto encoded = adapter.encode(counters.data(), counters.size() * sizeof(uint32_t),
+                                  DataFormat::COMPRESSED_STATE);
+    EXPECT_NE(adapter.getMetadata(encoded).custom_metadata_json.find("\"PACKED_DELTA\""), std::string::npos);
+    auto decoded = adapter.decode(encoded, DataFormat::COMPRESSED_STATE);
+    ASSERT_EQ(decoded.size(), counters.size() * sizeof(uint32_t));
+    EXPECT_EQ(std::memcmp(decoded.data(), counters.data(), decoded.size()), 0);
+}
+
+TEST_F(CompressionTest, CompressedStateDeltasAgainstAcknowledgedBaseline) {
+    CompressedStateAdapter sender, receiver;
+    auto state = generateRandomData(20000);
+
+    // Nothing is acknowledged yet, so the first state goes out whole
+    auto first = sender.encodeDelta("peer", state.data(), state.size());
+    EXPECT_TRUE(first.snapshot);
+    auto decoded = receiver.decodeDelta("sender", first.data);
+    EXPECT_EQ(decoded.state, state);
+    EXPECT_EQ(decoded.version, first.version);
+    sender.acknowledgeDelta("peer", decoded.version);
+
+    // A few changed bytes, and a grown tail, cost a small fraction of the state
+    state[10] ^= 0xFF;
+    state[15000] ^= 0x01;
+    state.resize(20100, 0x5A);
+    auto second = sender.encodeDelta("peer", state.data(), state.size());
+    EXPECT_FALSE(second.snapshot);
+    EXPECT_LT(second.data.size(), state.size() / 20);
+    EXPECT_EQ(sender.getMetadata(second.data).uncompressed_data_size, state.size());
+
+    // Without the acknowledgment the next diff is again against the first state
+    state[500] ^= 0x10;
+    auto third = sender.encodeDelta("peer", state.data(), state.size());
+    EXPECT_FALSE(third.snapshot);
+    EXPECT_EQ(receiver.decodeDelta("sender", second.data).state.size(), 20100u);
+    EXPECT_EQ(receiver.decodeDelta("sender", third.data).state, state);
+
+    // An identical state is nearly free
+    sender.acknowledgeDelta("peer", third.version);
+    auto same = sender.encodeDelta("peer", state.data(), state.size());
+    EXPECT_EQ(receiver.decodeDelta("sender", same.data).state, state);
+    EXPECT_LT(same.data.size(), 200u);
+}
+
+TEST_F(CompressionTest, CompressedStateDeltaNeedsItsBaseline) {
+    CompressedStateAdapter sender, receiver;
+    auto state = generateRandomData(4000);
+    auto first = sender.encodeDelta("peer", state.data(), state.size());
+    sender.acknowledgeDelta("peer", first.version);
+    state[0] ^= 1;
+    auto delta = sender.encodeDelta("peer", state.data(), state.size());
+    ASSERT_FALSE(delta.snapshot);
+
+    // A receiver that never saw the baseline cannot apply the diff
+    try {
+        receiver.decodeDelta("sender", delta.data);
+        FAIL() << "Expected CompressionError";
+    } catch (const CompressionError& e) {
+        EXPECT_EQ(e.getErrorCode(), CompressionErrorCode::BASELINE_MISSING);
+    }
+
+    // Forgetting the peer starts it again from a snapshot
+    sender.forgetPeer("peer");
+    auto resync = sender.encodeDelta("peer", state.data(), state.size());
+    EXPECT_TRUE(resync.snapshot);
+    EXPECT_GT(resync.version, delta.version);
+    EXPECT_EQ(receiver.decodeDelta("sender", resync.data).state, state);
+    EXPECT_THROW(receiver.decodeDelta("sender", std::vector<uint8_t>(8, 0)), CompressionError);
 }
-*/ 
\ No newline at end of file
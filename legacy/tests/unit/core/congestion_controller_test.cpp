@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/congestion_controller.h"
+
+using namespace xenocomm::core;
+using namespace std::chrono;
+
+namespace {
+
+CongestionControlConfig makeConfig(CongestionControlAlgorithm algorithm) {
+    CongestionControlConfig config;
+    config.algorithm = algorithm;
+    config.initial_window = 16 * 1024;
+    config.min_window = 1024;
+    config.max_window = 4 * 1024 * 1024;
+    config.segment_size = 1024;
+    return config;
+}
+
+// Acknowledges one window of data per RTT, the shape of a saturated flow
+steady_clock::time_point ackRounds(ICongestionController& controller, steady_clock::time_point now,
+                                   int rounds, microseconds rtt) {
+    for (int round = 0; round < rounds; ++round) {
+        uint32_t window = controller.congestionWindow();
+        uint32_t segments = std::max<uint32_t>(window / 1024, 1);
+        for (uint32_t i = 0; i < segments; ++i) {
+            now += rtt / segments;
+            controller.onAck(1024, rtt, window - (i + 1) * 1024, now);
+        }
+    }
+    return now;
+}
+
+double micros(steady_clock::duration duration) {
+    return duration_cast<nanoseconds>(duration).count() / 1000.0;
+}
+
+} // namespace
+
+TEST(CongestionControllerTest, FactoryCreatesRequestedAlgorithm) {
+    EXPECT_EQ(CongestionControllerFactory::create(makeConfig(CongestionControlAlgorithm::AIMD))->name(), "AIMD");
+    EXPECT_EQ(CongestionControllerFactory::create(makeConfig(CongestionControlAlgorithm::CUBIC))->name(), "CUBIC");
+    EXPECT_EQ(CongestionControllerFactory::create(makeConfig(CongestionControlAlgorithm::BBR))->name(), "BBR");
+}
+
+TEST(CongestionControllerTest, AimdBacksOffOnLoss) {
+    AimdCongestionController controller(makeConfig(CongestionControlAlgorithm::AIMD));
+    uint32_t initial = controller.congestionWindow();
+    controller.onLoss(1024, steady_clock::now());
+    EXPECT_EQ(controller.congestionWindow(), initial / 2);
+}
+
+TEST(CongestionControllerTest, CubicTreatsLossBurstAsOneEvent) {
+    CubicCongestionController controller(makeConfig(CongestionControlAlgorithm::CUBIC));
+    auto now = ackRounds(controller, steady_clock::now(), 3, milliseconds(50));
+    uint32_t before = controller.congestionWindow();
+
+    // Several losses within one RTT reduce the window only once
+    for (int i = 0; i < 5; ++i) {
+        controller.onLoss(1024, now + milliseconds(i));
+    }
+    EXPECT_NEAR(controller.congestionWindow(), before * 0.7, 1024);
+}
+
+TEST(CongestionControllerTest, CubicIgnoresRttSpikes) {
+    CubicCongestionController controller(makeConfig(CongestionControlAlgorithm::CUBIC));
+    auto now = ackRounds(controller, steady_clock::now(), 3, milliseconds(20));
+    uint32_t before = controller.congestionWindow();
+
+    now += milliseconds(400);
+    controller.onAck(1024, milliseconds(400), before, now);
+    EXPECT_GE(controller.congestionWindow(), before);
+}
+
+TEST(CongestionControllerTest, CubicRegrowsTowardPreviousMaximum) {
+    CubicCongestionController controller(makeConfig(CongestionControlAlgorithm::CUBIC));
+    auto now = ackRounds(controller, steady_clock::now(), 4, milliseconds(20));
+    uint32_t peak = controller.congestionWindow();
+
+    controller.onLoss(1024, now);
+    uint32_t reduced = controller.congestionWindow();
+    ackRounds(controller, now, 200, milliseconds(20));
+    EXPECT_LT(reduced, peak);
+    EXPECT_GE(controller.congestionWindow(), peak);
+}
+
+TEST(CongestionControllerTest, BbrConvergesToBandwidthDelayProduct) {
+    BbrCongestionController controller(makeConfig(CongestionControlAlgorithm::BBR));
+    auto now = steady_clock::now();
+    const auto rtt = milliseconds(20);
+    const double bandwidth = 10.0 * 1024 * 1024;  // 10 MiB/s bottleneck
+    const uint32_t bdp = static_cast<uint32_t>(bandwidth * 0.020);
+
+    // The bottleneck delivers a fixed number of bytes per millisecond regardless of window
+    for (int ms = 0; ms < 2000; ++ms) {
+        now += milliseconds(1);
+        uint32_t in_flight = std::min(controller.congestionWindow(), bdp);
+        controller.onAck(static_cast<uint32_t>(bandwidth / 1000), rtt, in_flight, now);
+    }
+
+    EXPECT_EQ(controller.mode(), BbrCongestionController::Mode::PROBE_BW);
+    EXPECT_NEAR(controller.bottleneckBandwidth(), bandwidth, bandwidth * 0.1);
+    EXPECT_GE(controller.congestionWindow(), bdp);
+    EXPECT_LE(controller.congestionWindow(), 3 * bdp);
+    // Paced at the bottleneck rate give or take the probing gain
+    EXPECT_GE(controller.pacingRate(), 0.7 * bandwidth);
+    EXPECT_LE(controller.pacingRate(), 1.4 * bandwidth);
+}
+
+TEST(CongestionControllerTest, BbrIgnoresIsolatedLoss) {
+    BbrCongestionController controller(makeConfig(CongestionControlAlgorithm::BBR));
+    uint32_t before = controller.congestionWindow();
+    controller.onLoss(1024, steady_clock::now());
+    EXPECT_EQ(controller.congestionWindow(), before);
+}
+
+TEST(CongestionControllerTest, LossBasedControllersLeavePacingToTheCaller) {
+    AimdCongestionController aimd(makeConfig(CongestionControlAlgorithm::AIMD));
+    CubicCongestionController cubic(makeConfig(CongestionControlAlgorithm::CUBIC));
+    BbrCongestionController bbr(makeConfig(CongestionControlAlgorithm::BBR));
+    EXPECT_EQ(aimd.pacingRate(), 0);
+    EXPECT_EQ(cubic.pacingRate(), 0);
+    EXPECT_EQ(bbr.pacingRate(), 0);  // No bandwidth sample yet
+}
+
+TEST(CongestionControllerTest, PacerSpreadsSendsAtItsRate) {
+    TokenBucketPacer pacer;
+    auto now = steady_clock::now();
+    EXPECT_EQ(pacer.delay(1000, now), steady_clock::duration::zero());
+
+    // 1 MB/s with room for two 1000 byte sends back to back
+    pacer.setRate(1e6, 2000, now);
+    EXPECT_EQ(pacer.delay(1000, now), steady_clock::duration::zero());
+    pacer.consume(1000, now);
+    pacer.consume(1000, now);
+    EXPECT_NEAR(micros(pacer.delay(1000, now)), 1000, 1);
+    EXPECT_EQ(pacer.delay(1000, now + milliseconds(1)), steady_clock::duration::zero());
+
+    // Idle time earns no more than the burst
+    now += seconds(1);
+    pacer.consume(1000, now);
+    pacer.consume(1000, now);
+    EXPECT_GT(pacer.delay(1000, now), steady_clock::duration::zero());
+
+    // Unpaced sends still spend the rate, so the next paced one waits longer
+    pacer.consume(3000, now);
+    EXPECT_NEAR(micros(pacer.delay(1000, now)), 4000, 1);
+
+    pacer.setRate(0, 2000, now);
+    EXPECT_EQ(pacer.delay(1000, now), steady_clock::duration::zero());
+}
@@ -1,5 +1,14 @@
 #include <gtest/gtest.h>
 #include "xenocomm/core/connection_manager.hpp"
+#include "xenocomm/core/mock_transport.hpp"
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
 
 using namespace xenocomm::core;
 
@@ -52,4 +61,125 @@ TEST_F(ConnectionManagerTest, GetActiveConnections) {
     EXPECT_TRUE(manager.getActiveConnections().empty());
     
     // TODO: Add tests for active connections once connection state management is implemented
-} 
\ No newline at end of file
+}
+
+TEST_F(ConnectionManagerTest, EstablishConnectsAndOwnsTransport) {
+    auto transport = std::make_shared<NiceMock<MockTransport>>();
+    ConnectionConfig config;
+    config.localPort = 40001;
+    EXPECT_CALL(*transport, isConnected()).WillOnce(Return(false));
+    EXPECT_CALL(*transport, setLocalPort(40001)).WillOnce(Return(true));
+    EXPECT_CALL(*transport, connect("127.0.0.1:40002", _)).WillOnce(Return(true));
+    ON_CALL(*transport, getState()).WillByDefault(Return(ConnectionState::CONNECTED));
+
+    auto connection = manager.establish(testConnectionId, "127.0.0.1:40002", transport, config);
+    EXPECT_EQ(connection->getTransport(), transport);
+    EXPECT_EQ(manager.getTransport(testConnectionId), transport);
+    EXPECT_EQ(manager.checkStatus(testConnectionId), ConnectionStatus::Connected);
+    EXPECT_EQ(manager.getActiveConnections().size(), 1u);
+
+    // Closing disconnects the transport
+    EXPECT_CALL(*transport, disconnect()).WillOnce(Return(true));
+    EXPECT_TRUE(manager.close(testConnectionId));
+    EXPECT_THROW(manager.getTransport(testConnectionId), ConnectionError);
+}
+
+TEST_F(ConnectionManagerTest, EstablishFailsWhenTransportCannotConnect) {
+    auto transport = std::make_shared<NiceMock<MockTransport>>();
+    EXPECT_CALL(*transport, connect(_, _)).WillOnce(Return(false));
+    EXPECT_THROW(manager.establish(testConnectionId, "127.0.0.1:1", transport), ConnectionError);
+    EXPECT_THROW(manager.getConnection(testConnectionId), ConnectionError);
+
+    // Metadata-only connections have no transport to hand out
+    manager.establish(testConnectionId, defaultConfig);
+    EXPECT_THROW(manager.getTransport(testConnectionId), ConnectionError);
+}
+
+TEST_F(ConnectionManagerTest, DataPathRunsOnTheConnectionTransport) {
+    auto transport = std::make_shared<NiceMock<MockTransport>>();
+    ON_CALL(*transport, isConnected()).WillByDefault(Return(true));
+    manager.establish(testConnectionId, "", transport);
+
+    // The default sendv gathers into one send
+    const uint8_t header[] = {1, 2};
+    const uint8_t body[] = {3, 4, 5};
+    const xenocomm::utils::ByteSpan buffers[] = {xenocomm::utils::ByteSpan(header, 2),
+                                                 xenocomm::utils::ByteSpan(body, 3)};
+    EXPECT_CALL(*transport, send(_, 5)).WillOnce(Return(5));
+    EXPECT_EQ(manager.sendv(testConnectionId, buffers, 2), 5);
+    EXPECT_EQ(manager.sendv("nonexistent", buffers, 2), -1);
+
+    EXPECT_CALL(*transport, receive(_, _)).WillOnce([](uint8_t* buffer, size_t) {
+        std::memcpy(buffer, "abc", 3);
+        return ssize_t(3);
+    });
+    xenocomm::utils::PooledBuffer received;
+    EXPECT_EQ(manager.receiveBuffer(testConnectionId, received, 64), 3);
+    EXPECT_EQ(received.size(), 3u);
+    EXPECT_EQ(manager.receiveBuffer("nonexistent", received, 64), -1);
+}
+
+TEST_F(ConnectionManagerTest, HandlesFindConnectionsUntilClosed) {
+    auto first = manager.establish("first", defaultConfig);
+    auto second = manager.establish("second", defaultConfig);
+    EXPECT_NE(first->getHandle(), Connection::INVALID_HANDLE);
+    EXPECT_NE(first->getHandle(), second->getHandle());
+    EXPECT_EQ(manager.getHandle("second"), second->getHandle());
+    EXPECT_EQ(manager.getConnection(first->getHandle()), first);
+    EXPECT_EQ(manager.getConnection(Connection::INVALID_HANDLE), nullptr);
+    EXPECT_EQ(manager.size(), 2u);
+
+    // A closed connection's handle stays dead even once its slot is reused
+    const auto stale = first->getHandle();
+    manager.close("first");
+    EXPECT_EQ(manager.getConnection(stale), nullptr);
+    auto reused = manager.establish("first", defaultConfig);
+    EXPECT_NE(reused->getHandle(), stale);
+    EXPECT_EQ(manager.getConnection(stale), nullptr);
+    EXPECT_EQ(manager.getConnection(reused->getHandle()), reused);
+
+    const uint8_t byte = 0;
+    const xenocomm::utils::ByteSpan buffer(&byte, 1);
+    EXPECT_EQ(manager.sendv(stale, &buffer, 1), -1);
+}
+
+TEST_F(ConnectionManagerTest, VisitsOnlyActiveConnections) {
+    auto transport = std::make_shared<NiceMock<MockTransport>>();
+    ON_CALL(*transport, isConnected()).WillByDefault(Return(true));
+    ON_CALL(*transport, getState()).WillByDefault(Return(ConnectionState::CONNECTED));
+    manager.establish("live", "", transport);
+    manager.establish("idle", defaultConfig);
+
+    std::vector<std::string> visited;
+    manager.forEachActiveConnection([&](const ConnectionManager::ConnectionPtr& connection) {
+        visited.push_back(connection->getId());
+        // The visitor runs without locks, so it may close connections
+        manager.close("idle");
+    });
+    EXPECT_EQ(visited, std::vector<std::string>{"live"});
+    EXPECT_EQ(manager.size(), 1u);
+}
+
+TEST_F(ConnectionManagerTest, ConcurrentEstablishLookupAndClose) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([this, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                const std::string id = "c" + std::to_string(t) + "-" + std::to_string(i);
+                auto connection = manager.establish(id, defaultConfig);
+                EXPECT_EQ(manager.getConnection(connection->getHandle()), connection);
+                EXPECT_EQ(manager.getConnection(id), connection);
+                if (i % 2) {
+                    EXPECT_TRUE(manager.close(id));
+                    EXPECT_EQ(manager.getConnection(connection->getHandle()), nullptr);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(manager.size(), static_cast<size_t>(kThreads * kPerThread / 2));
+}
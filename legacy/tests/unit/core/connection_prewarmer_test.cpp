@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/connection_prewarmer.h"
+#include "xenocomm/core/feedback_loop.h"
+#include "xenocomm/core/tcp_transport.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <set>
+#include <thread>
+
+using namespace xenocomm;
+using namespace xenocomm::core;
+
+namespace {
+
+PrewarmActions recordingActions(std::set<std::string>& negotiated, std::mutex& mutex) {
+    PrewarmActions actions;
+    actions.resolveEndpoint = [](const std::string& peerId) -> std::optional<std::string> {
+        if (peerId == "unknown") {
+            return std::nullopt;
+        }
+        return peerId + ":9000";
+    };
+    actions.negotiate = [&](const std::string& peerId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        negotiated.insert(peerId);
+        return true;
+    };
+    return actions;
+}
+
+RankedAgent agent(const std::string& id) {
+    RankedAgent ranked;
+    ranked.agentId = id;
+    return ranked;
+}
+
+} // namespace
+
+TEST(ConnectionPrewarmerTest, PredictsFromHistoryAndHints) {
+    FeedbackLoopConfig feedbackConfig;
+    feedbackConfig.enablePersistence = false;
+    FeedbackLoop feedback(feedbackConfig);
+    const std::map<std::string, int> transactions{{"busy", 8}, {"quiet", 2}};
+    for (const auto& [peer, count] : transactions) {
+        for (int i = 0; i < count; ++i) {
+            CommunicationOutcome outcome{true, std::chrono::milliseconds(1), 100, 0, 0, "",
+                                         std::chrono::system_clock::now()};
+            OutcomeLabels labels;
+            labels.peerId = peer;
+            ASSERT_TRUE(feedback.reportOutcome(outcome, labels).has_value());
+        }
+    }
+
+    std::set<std::string> negotiated;
+    std::mutex mutex;
+    ConnectionPrewarmer prewarmer(nullptr, recordingActions(negotiated, mutex), &feedback);
+    auto predictions = prewarmer.predict();
+    ASSERT_EQ(predictions.size(), 2u);
+    EXPECT_EQ(predictions[0].peerId, "busy");
+    EXPECT_DOUBLE_EQ(predictions[0].score, 1.0);
+    EXPECT_NEAR(predictions[1].score, 0.25, 1e-9);
+
+    // A fresh discovery result outranks history
+    prewarmer.onDiscovery({agent("new"), agent("busy")});
+    predictions = prewarmer.predict();
+    ASSERT_EQ(predictions.size(), 3u);
+    EXPECT_EQ(predictions[0].peerId, "busy");  // Its history plus half a hint
+    EXPECT_EQ(predictions[1].peerId, "new");
+    EXPECT_EQ(predictions[2].peerId, "quiet");
+}
+
+TEST(ConnectionPrewarmerTest, WarmsWithinBudgetAndBacksOff) {
+    std::set<std::string> negotiated;
+    std::mutex mutex;
+    PrewarmConfig config;
+    config.maxPeers = 2;
+    ConnectionPrewarmer prewarmer(nullptr, recordingActions(negotiated, mutex), nullptr, config);
+    prewarmer.onDiscovery({agent("a"), agent("b"), agent("unknown"), agent("c")});
+
+    EXPECT_EQ(prewarmer.prewarmNow(), 2u);
+    EXPECT_EQ(negotiated, (std::set<std::string>{"a", "b"}));
+
+    // The next pass moves on to the peers not warmed yet; the unresolvable one fails
+    EXPECT_EQ(prewarmer.prewarmNow(), 1u);
+    EXPECT_EQ(negotiated, (std::set<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(prewarmer.prewarmNow(), 0u);
+
+    auto stats = prewarmer.stats();
+    EXPECT_EQ(stats.passes, 3u);
+    EXPECT_EQ(stats.peersWarmed, 3u);
+    EXPECT_EQ(stats.negotiations, 3u);
+    EXPECT_EQ(stats.failures, 1u);
+
+    // Forgotten peers are neither predicted nor considered warm
+    prewarmer.forgetPeer("a");
+    for (const auto& prediction : prewarmer.predict()) {
+        EXPECT_NE(prediction.peerId, "a");
+    }
+}
+
+TEST(ConnectionPrewarmerTest, HintsTriggerScheduledPasses) {
+    std::set<std::string> negotiated;
+    std::mutex mutex;
+    PrewarmConfig config;
+    config.interval = std::chrono::milliseconds(0);  // Passes only on hints
+    ConnectionPrewarmer prewarmer(nullptr, recordingActions(negotiated, mutex), nullptr, config);
+    prewarmer.start();
+    prewarmer.hintPeer("x");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (prewarmer.stats().peersWarmed == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    prewarmer.stop();
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(negotiated, (std::set<std::string>{"x"}));
+}
+
+TEST(ConnectionPrewarmerTest, FillsTheTcpPool) {
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::listen(listener, 16), 0);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length), 0);
+    const std::string endpoint = "127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+
+    TCPTransport::PoolConfig poolConfig;
+    poolConfig.validateOnBorrow = false;
+    TCPTransport transport(poolConfig);
+    PrewarmActions actions;
+    actions.resolveEndpoint = [&](const std::string&) -> std::optional<std::string> { return endpoint; };
+    PrewarmConfig config;
+    config.connectionsPerPeer = 3;
+    ConnectionPrewarmer prewarmer(&transport, actions, nullptr, config);
+    prewarmer.hintPeer("server");
+
+    EXPECT_EQ(prewarmer.prewarmNow(), 1u);
+    auto stats = transport.getDetailedPoolStats();
+    EXPECT_EQ(stats.totalCreated, 3u);
+    EXPECT_EQ(stats.idleConnections, 3u);
+    ::close(listener);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/crypto_worker_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+
+namespace {
+
+TEST(CryptoWorkerPoolTest, CompletesInIndexOrderWhileTasksRunInParallel) {
+    CryptoWorkerPool pool(4);
+    ASSERT_EQ(pool.workerCount(), 4u);
+
+    constexpr size_t COUNT = 200;
+    std::vector<int> results(COUNT, 0);
+    std::mutex threads_mutex;
+    std::set<std::thread::id> threads;
+    std::vector<size_t> order;
+
+    bool ok = pool.runOrdered(COUNT,
+        [&](size_t i) {
+            // Early indices finish last, so completion has to wait and reorder
+            if (i < 8) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            results[i] = static_cast<int>(i * i);
+            std::lock_guard<std::mutex> lock(threads_mutex);
+            threads.insert(std::this_thread::get_id());
+            return true;
+        },
+        [&](size_t i) {
+            EXPECT_EQ(results[i], static_cast<int>(i * i));
+            order.push_back(i);
+            return true;
+        });
+
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(order.size(), COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(CryptoWorkerPoolTest, FailedTaskStopsCompletionAtThatIndex) {
+    CryptoWorkerPool pool(3);
+    std::vector<size_t> order;
+    std::atomic<size_t> ran{0};
+    bool ok = pool.runOrdered(1000,
+        [&](size_t i) {
+            ++ran;
+            return i != 10;
+        },
+        [&](size_t i) {
+            order.push_back(i);
+            return true;
+        });
+
+    EXPECT_FALSE(ok);
+    ASSERT_EQ(order.size(), 10u);
+    EXPECT_EQ(order.back(), 9u);
+    EXPECT_LT(ran.load(), 1000u);  // Unstarted tasks are skipped
+}
+
+TEST(CryptoWorkerPoolTest, FailedCompletionStopsTheRun) {
+    CryptoWorkerPool pool(2);
+    size_t completions = 0;
+    EXPECT_FALSE(pool.runOrdered(50, [](size_t) { return true; },
+                                 [&](size_t i) { ++completions; return i < 4; }));
+    EXPECT_EQ(completions, 5u);
+}
+
+TEST(CryptoWorkerPoolTest, RunsInlineWithoutWorkersAndServesConcurrentCallers) {
+    CryptoWorkerPool inline_pool(1);
+    std::vector<std::thread> callers;
+    std::atomic<int> successes{0};
+    for (int c = 0; c < 4; ++c) {
+        callers.emplace_back([&] {
+            size_t next = 0;
+            bool ok = inline_pool.runOrdered(64, [](size_t) { return true; },
+                                             [&](size_t i) { return i == next++; });
+            if (ok && next == 64) {
+                ++successes;
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(successes.load(), 4);
+
+    EXPECT_TRUE(inline_pool.runOrdered(0, [](size_t) { return false; }, [](size_t) { return false; }));
+}
+
+} // namespace
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "xenocomm/core/data_adapters.h"
+#include "xenocomm/core/adapter_registry.h"
+#include <algorithm>
 #include <cmath>
 
 using namespace xenocomm::core;
@@ -97,4 +99,212 @@ TEST_F(VectorInt8AdapterTest, GetMetadata) {
     EXPECT_EQ(metadata.element_count, test_data.size());
     EXPECT_EQ(metadata.element_size, sizeof(uint8_t));
     EXPECT_FLOAT_EQ(metadata.scale_factor, 0.5f);
-} 
\ No newline at end of file
+} 
+
+TEST(VectorInt8AdapterBlockTest, RoundTripWithinHalfStepPerBlock) {
+    // Blocks of very different magnitude, negative values and a partial last block
+    std::vector<float> data(64 * 3 + 10);
+    for (size_t i = 0; i < data.size(); ++i) {
+        float magnitude = (i / 64 == 0) ? 0.01f : (i / 64 == 1) ? 1000.0f : 1.0f;
+        data[i] = magnitude * std::sin(static_cast<float>(i));
+    }
+
+    auto adapter = VectorInt8Adapter::perBlock(64);
+    auto encoded = adapter.encode(data.data(), data.size() * sizeof(float), DataFormat::VECTOR_FLOAT32);
+    EXPECT_EQ(encoded.size(), data.size() + 4 * 2 * sizeof(float));
+    ASSERT_TRUE(adapter.isValidFormat(encoded.data(), encoded.size(), DataFormat::VECTOR_INT8));
+
+    auto metadata = adapter.getMetadata(encoded);
+    EXPECT_EQ(metadata.element_count, data.size());
+    EXPECT_EQ(metadata.block_size, 64u);
+    ASSERT_EQ(metadata.block_scales.size(), 4u);
+    ASSERT_EQ(metadata.block_offsets.size(), 4u);
+
+    auto decoded = adapter.decode(encoded, DataFormat::VECTOR_INT8);
+    ASSERT_EQ(decoded.size(), data.size() * sizeof(float));
+    const float* decoded_floats = reinterpret_cast<const float*>(decoded.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        float step = metadata.block_scales[i / 64];
+        EXPECT_NEAR(decoded_floats[i], data[i], step * 0.5f + 1e-6f * std::fabs(data[i])) << i;
+    }
+}
+
+TEST(VectorInt8AdapterBlockTest, RejectsTruncatedEncoding) {
+    std::vector<float> data(100, 1.0f);
+    auto adapter = VectorInt8Adapter::perBlock(64);
+    auto encoded = adapter.encode(data.data(), data.size() * sizeof(float), DataFormat::VECTOR_FLOAT32);
+
+    // Cut inside the second block's header, leaving it without codes
+    encoded.resize(2 * sizeof(float) + 64 + 4);
+    EXPECT_FALSE(adapter.isValidFormat(encoded.data(), encoded.size(), DataFormat::VECTOR_INT8));
+    EXPECT_THROW(adapter.decode(encoded, DataFormat::VECTOR_INT8), TranscodingError);
+    EXPECT_THROW(VectorInt8Adapter::perBlock(0), TranscodingError);
+}
+
+TEST(ReducedPrecisionAdapterTest, HalfWidthFormatsRoundTrip) {
+    std::vector<float> data = {1.0f, -2.5f, 3.14159f, 0.0f, 1e-3f, 60000.0f, -1e30f, 7.0f, 0.1f};
+    size_t size = data.size() * sizeof(float);
+
+    VectorFloat16Adapter half;
+    auto encoded = half.encode(data.data(), size, DataFormat::VECTOR_FLOAT32);
+    EXPECT_EQ(encoded.size(), data.size() * 2);
+    EXPECT_EQ(half.getMetadata(encoded).element_count, data.size());
+    auto decoded = half.decode(encoded, DataFormat::VECTOR_FLOAT16);
+    const float* halves = reinterpret_cast<const float*>(decoded.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (std::fabs(data[i]) > 65504.0f) {
+            EXPECT_TRUE(std::isinf(halves[i])) << i;
+        } else {
+            EXPECT_NEAR(halves[i], data[i], std::fabs(data[i]) * 1e-3f + 1e-7f) << i;
+        }
+    }
+
+    VectorBFloat16Adapter bfloat;
+    encoded = bfloat.encode(data.data(), size, DataFormat::VECTOR_FLOAT32);
+    EXPECT_EQ(encoded.size(), data.size() * 2);
+    decoded = bfloat.decode(encoded, DataFormat::VECTOR_BFLOAT16);
+    const float* bfloats = reinterpret_cast<const float*>(decoded.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        EXPECT_NEAR(bfloats[i], data[i], std::fabs(data[i]) * 4e-3f) << i;
+    }
+
+    encoded.pop_back();
+    EXPECT_FALSE(bfloat.isValidFormat(encoded.data(), encoded.size(), DataFormat::VECTOR_BFLOAT16));
+    EXPECT_THROW(bfloat.decode(encoded, DataFormat::VECTOR_BFLOAT16), TranscodingError);
+}
+
+TEST(ReducedPrecisionAdapterTest, Int4RoundTripWithinHalfStepPerGroup) {
+    // An odd group size and a partial last group exercise the nibble padding
+    std::vector<float> data(33 * 2 + 7);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i < 33 ? 100.0f : 0.5f) * std::cos(static_cast<float>(i));
+    }
+
+    VectorInt4Adapter encoder(33);
+    auto encoded = encoder.encode(data.data(), data.size() * sizeof(float), DataFormat::VECTOR_FLOAT32);
+    EXPECT_EQ(encoded.size(), 8 + 3 * 8 + 2 * 17 + 4);
+
+    // The group size travels with the data
+    VectorInt4Adapter decoder;
+    ASSERT_TRUE(decoder.isValidFormat(encoded.data(), encoded.size(), DataFormat::VECTOR_INT4));
+    auto metadata = decoder.getMetadata(encoded);
+    EXPECT_EQ(metadata.element_count, data.size());
+    EXPECT_EQ(metadata.block_size, 33u);
+    ASSERT_EQ(metadata.block_scales.size(), 3u);
+
+    auto decoded = decoder.decode(encoded, DataFormat::VECTOR_INT4);
+    ASSERT_EQ(decoded.size(), data.size() * sizeof(float));
+    const float* values = reinterpret_cast<const float*>(decoded.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        float step = metadata.block_scales[i / 33];
+        EXPECT_NEAR(values[i], data[i], step * 0.5f + 1e-5f) << i;
+    }
+
+    encoded.pop_back();
+    EXPECT_FALSE(decoder.isValidFormat(encoded.data(), encoded.size(), DataFormat::VECTOR_INT4));
+    EXPECT_THROW(decoder.decode(encoded, DataFormat::VECTOR_INT4), TranscodingError);
+    EXPECT_THROW(VectorInt4Adapter(0), TranscodingError);
+}
+
+TEST(ReducedPrecisionAdapterTest, RegisteredWithAdapterRegistry) {
+    auto& registry = AdapterRegistry::getInstance();
+    for (DataFormat format : {DataFormat::VECTOR_FLOAT16, DataFormat::VECTOR_BFLOAT16, DataFormat::VECTOR_INT4}) {
+        ASSERT_TRUE(registry.hasAdapter(format));
+        auto adapter = registry.getAdapter(format);
+        std::vector<float> data(64, 0.25f);
+        auto encoded = adapter->encode(data.data(), data.size() * sizeof(float), DataFormat::VECTOR_FLOAT32);
+        EXPECT_EQ(adapter->getMetadata(encoded).format, format);
+    }
+}
+
+TEST(ZeroCopyTranscodingTest, EncodeIntoCallerBufferMatchesEncode) {
+    std::vector<float> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::sin(static_cast<float>(i)) * 10.0f;
+    }
+    xenocomm::utils::ByteSpan input(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(float));
+
+    struct Case {
+        std::unique_ptr<DataTranscoder> adapter;
+        DataFormat format;
+    };
+    std::vector<Case> cases;
+    cases.push_back({std::make_unique<VectorFloat32Adapter>(), DataFormat::VECTOR_FLOAT32});
+    cases.push_back({std::make_unique<VectorInt8Adapter>(2.0f), DataFormat::VECTOR_INT8});
+    cases.push_back({std::make_unique<VectorInt8Adapter>(VectorInt8Adapter::perBlock()), DataFormat::VECTOR_INT8});
+    cases.push_back({std::make_unique<VectorFloat16Adapter>(), DataFormat::VECTOR_FLOAT16});
+    cases.push_back({std::make_unique<VectorBFloat16Adapter>(), DataFormat::VECTOR_BFLOAT16});
+    cases.push_back({std::make_unique<VectorInt4Adapter>(), DataFormat::VECTOR_INT4});
+
+    for (auto& [adapter, format] : cases) {
+        auto expected = adapter->encode(data.data(), input.size(), DataFormat::VECTOR_FLOAT32);
+        size_t bound = adapter->maxEncodedSize(input.size(), DataFormat::VECTOR_FLOAT32);
+        ASSERT_GE(bound, expected.size());
+
+        std::vector<uint8_t> encoded(bound);
+        size_t written = adapter->encodeInto(input, DataFormat::VECTOR_FLOAT32, encoded);
+        ASSERT_EQ(written, expected.size());
+        encoded.resize(written);
+        EXPECT_EQ(encoded, expected);
+
+        std::vector<uint8_t> decoded(adapter->maxDecodedSize(encoded, format));
+        decoded.resize(adapter->decodeInto(encoded, format, decoded));
+        EXPECT_EQ(decoded, adapter->decode(encoded, format));
+
+        std::vector<uint8_t> small(expected.size() - 1);
+        EXPECT_THROW(adapter->encodeInto(input, DataFormat::VECTOR_FLOAT32, small), TranscodingError);
+    }
+}
+
+TEST(ZeroCopyTranscodingTest, Float32PassesThroughAsView) {
+    std::vector<float> data = {1.0f, 2.0f, 3.0f};
+    xenocomm::utils::ByteSpan input(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(float));
+
+    VectorFloat32Adapter adapter;
+    auto encoded = adapter.encodeView(input, DataFormat::VECTOR_FLOAT32);
+    ASSERT_TRUE(encoded.has_value());
+    EXPECT_EQ(encoded->data(), input.data());
+    EXPECT_EQ(encoded->size(), input.size());
+    auto decoded = adapter.decodeView(*encoded, DataFormat::VECTOR_FLOAT32);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->data(), input.data());
+
+    VectorInt8Adapter quantized;
+    EXPECT_FALSE(quantized.encodeView(input, DataFormat::VECTOR_FLOAT32).has_value());
+}
+
+TEST(BatchTranscodingTest, BatchMatchesRowByRowAcrossThreads) {
+    // 768-dim rows; enough of them that the batch is split across threads
+    const size_t dims = 768;
+    const size_t count = 512;
+    std::vector<float> data(dims * count);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::sin(static_cast<float>(i) * 0.01f) * static_cast<float>(1 + i % 7);
+    }
+    const size_t row_size = dims * sizeof(float);
+    xenocomm::utils::ByteSpan input(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(float));
+
+    VectorInt8Adapter adapter = VectorInt8Adapter::perBlock();
+    const size_t stride = adapter.maxEncodedSize(row_size, DataFormat::VECTOR_FLOAT32);
+    std::vector<uint8_t> encoded(stride * count);
+    std::vector<size_t> sizes = adapter.encodeBatch(input, row_size, DataFormat::VECTOR_FLOAT32, encoded);
+    ASSERT_EQ(sizes.size(), count);
+    for (size_t i = 0; i < count; i += 97) {
+        auto row = adapter.encode(data.data() + i * dims, row_size, DataFormat::VECTOR_FLOAT32);
+        ASSERT_EQ(sizes[i], row.size());
+        EXPECT_TRUE(std::equal(row.begin(), row.end(), encoded.begin() + i * stride));
+    }
+
+    std::vector<float> decoded(dims * count);
+    xenocomm::utils::MutableByteSpan out(reinterpret_cast<uint8_t*>(decoded.data()), decoded.size() * sizeof(float));
+    adapter.decodeBatch(encoded, stride, sizes, DataFormat::VECTOR_INT8, out, row_size);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_NEAR(decoded[i], data[i], 0.05f);
+    }
+
+    // Neither call accepts a partial row
+    EXPECT_THROW(adapter.encodeBatch(input.subspan(0, row_size + 4), row_size, DataFormat::VECTOR_FLOAT32, encoded),
+                 TranscodingError);
+    EXPECT_THROW(adapter.decodeBatch(encoded, stride, sizes, DataFormat::VECTOR_INT8, out, row_size - 4),
+                 TranscodingError);
+}
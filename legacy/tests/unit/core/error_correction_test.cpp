@@ -137,6 +137,67 @@ TEST_F(ErrorCorrectionTest, ReedSolomonMaxErrors) {
     EXPECT_FALSE(decoded.has_value());
 }
 
+TEST_F(ErrorCorrectionTest, ReedSolomonEncodeIntoMatchesEncode) {
+    ReedSolomonCorrection::Config config;
+    config.data_shards = 10;
+    config.parity_shards = 4;
+    ReedSolomonCorrection rs(config);
+
+    // Sizes around the interleaver's tile boundaries
+    for (size_t size : {1u, 15u, 16u, 17u, 255u, 256u, 257u, 1000u, 4096u, 4099u}) {
+        auto data = generateRandomData(size);
+        auto encoded = rs.encode(data);
+        ASSERT_EQ(encoded.size(), rs.encodedSize(size));
+
+        std::vector<uint8_t> buffer(rs.encodedSize(size) + 8, 0xAA);
+        ASSERT_EQ(rs.encodeInto(data.data(), size, buffer.data(), buffer.size()), encoded.size());
+        EXPECT_TRUE(std::equal(encoded.begin(), encoded.end(), buffer.begin())) << "size " << size;
+
+        std::vector<uint8_t> decoded(size);
+        auto written = rs.decodeInto(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+        ASSERT_TRUE(written.has_value()) << "size " << size;
+        EXPECT_EQ(*written, size);
+        EXPECT_EQ(decoded, data) << "size " << size;
+    }
+}
+
+TEST_F(ErrorCorrectionTest, ReedSolomonIntoRejectsSmallBuffers) {
+    ReedSolomonCorrection::Config config;
+    config.data_shards = 4;
+    config.parity_shards = 2;
+    ReedSolomonCorrection rs(config);
+    auto data = generateRandomData(100);
+
+    std::vector<uint8_t> encoded(rs.encodedSize(data.size()) - 1);
+    EXPECT_EQ(rs.encodeInto(data.data(), data.size(), encoded.data(), encoded.size()), 0u);
+
+    encoded = rs.encode(data);
+    std::vector<uint8_t> decoded(data.size() - 1);
+    EXPECT_FALSE(rs.decodeInto(encoded.data(), encoded.size(), decoded.data(), decoded.size()).has_value());
+}
+
+TEST_F(ErrorCorrectionTest, ReedSolomonRebuildsLostShards) {
+    ReedSolomonCorrection::Config config;
+    config.data_shards = 10;
+    config.parity_shards = 4;
+    ReedSolomonCorrection rs(config);
+    auto data = generateRandomData(5000);
+    auto encoded = rs.encode(data);
+    const size_t shardSize = encoded.size() / 14 - 4;
+
+    // Any two shards, data or parity, may be lost
+    for (size_t first = 0; first < 14; ++first) {
+        for (size_t second = first + 1; second < 14; ++second) {
+            auto damaged = encoded;
+            std::fill_n(damaged.begin() + first * shardSize, shardSize, 0);
+            damaged[second * shardSize] ^= 0x01;
+            auto decoded = rs.decode(damaged);
+            ASSERT_TRUE(decoded.has_value()) << first << ", " << second;
+            EXPECT_EQ(decoded.value(), data);
+        }
+    }
+}
+
 TEST_F(ErrorCorrectionTest, FactoryTest) {
     auto none = ErrorCorrectionFactory::create(ErrorCorrectionMode::NONE);
     ASSERT_NE(none, nullptr);
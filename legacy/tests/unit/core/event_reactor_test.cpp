@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/event_reactor.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace xenocomm::core;
+using namespace std::chrono;
+
+namespace {
+
+class EventReactorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds_), 0);
+        for (int fd : fds_) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+    }
+
+    void TearDown() override {
+        ::close(fds_[0]);
+        ::close(fds_[1]);
+    }
+
+    template <typename Predicate>
+    bool waitFor(Predicate predicate, milliseconds timeout = milliseconds(2000)) {
+        auto deadline = steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return true;
+    }
+
+    int fds_[2];
+};
+
+TEST_F(EventReactorTest, DispatchesReadableUntilDrained) {
+    EventReactor reactor(2);
+    ASSERT_TRUE(reactor.isValid());
+
+    std::atomic<size_t> received{0};
+    ASSERT_TRUE(reactor.add(fds_[0], EventReactor::READABLE, [&](int fd, uint32_t events) {
+        EXPECT_TRUE(events & EventReactor::READABLE);
+        char buffer[64];
+        ssize_t n;
+        while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+            received += static_cast<size_t>(n);
+        }
+    }));
+    EXPECT_FALSE(reactor.add(fds_[0], EventReactor::READABLE, [](int, uint32_t) {}));
+    EXPECT_EQ(reactor.watchedCount(), 1u);
+
+    ASSERT_EQ(::write(fds_[1], "hello world", 11), 11);
+    EXPECT_TRUE(waitFor([&] { return received == 11; }));
+    EXPECT_TRUE(reactor.remove(fds_[0]));
+    EXPECT_EQ(reactor.watchedCount(), 0u);
+}
+
+TEST_F(EventReactorTest, ModifyEnablesWritableInterest) {
+    EventReactor reactor;
+    std::atomic<int> writable{0};
+    ASSERT_TRUE(reactor.add(fds_[0], EventReactor::READABLE, [&](int, uint32_t events) {
+        if (events & EventReactor::WRITABLE) {
+            ++writable;
+        }
+    }));
+    std::this_thread::sleep_for(milliseconds(30));
+    EXPECT_EQ(writable, 0);
+
+    ASSERT_TRUE(reactor.modify(fds_[0], EventReactor::READABLE | EventReactor::WRITABLE));
+    EXPECT_TRUE(waitFor([&] { return writable > 0; }));
+    EXPECT_TRUE(reactor.remove(fds_[0]));
+}
+
+TEST_F(EventReactorTest, RemoveWaitsForRunningCallback) {
+    EventReactor reactor;
+    std::atomic<bool> inCallback{false};
+    std::atomic<bool> finished{false};
+    ASSERT_TRUE(reactor.add(fds_[0], EventReactor::READABLE, [&](int fd, uint32_t) {
+        char buffer[16];
+        while (::read(fd, buffer, sizeof(buffer)) > 0) {
+        }
+        inCallback = true;
+        std::this_thread::sleep_for(milliseconds(50));
+        finished = true;
+    }));
+
+    ASSERT_EQ(::write(fds_[1], "x", 1), 1);
+    ASSERT_TRUE(waitFor([&] { return inCallback.load(); }));
+    EXPECT_TRUE(reactor.remove(fds_[0]));
+    EXPECT_TRUE(finished);
+}
+
+TEST_F(EventReactorTest, CallbackMayRemoveItself) {
+    EventReactor reactor;
+    std::atomic<int> calls{0};
+    ASSERT_TRUE(reactor.add(fds_[0], EventReactor::READABLE, [&](int fd, uint32_t) {
+        ++calls;
+        reactor.remove(fd);
+    }));
+    ASSERT_EQ(::write(fds_[1], "x", 1), 1);
+    ASSERT_TRUE(waitFor([&] { return calls > 0; }));
+    std::this_thread::sleep_for(milliseconds(30));
+    EXPECT_EQ(calls, 1);  // Data is still unread, but the handler is gone
+}
+
+TEST_F(EventReactorTest, TimersFireAndCancel) {
+    EventReactor reactor(2);
+    std::atomic<int> once{0};
+    std::atomic<int> repeating{0};
+
+    reactor.scheduleAfter(milliseconds(20), [&] { ++once; });
+    auto id = reactor.scheduleEvery(milliseconds(10), [&] { ++repeating; });
+
+    EXPECT_TRUE(waitFor([&] { return once == 1 && repeating >= 3; }));
+    reactor.cancelTimer(id);
+    int afterCancel = repeating;
+    std::this_thread::sleep_for(milliseconds(60));
+    EXPECT_EQ(repeating, afterCancel);
+    EXPECT_EQ(once, 1);
+}
+
+TEST_F(EventReactorTest, PostRunsOnLoopThread) {
+    EventReactor reactor;
+    std::atomic<bool> ran{false};
+    std::atomic<bool> onLoop{false};
+    reactor.post([&] {
+        onLoop = reactor.inLoopThread();
+        ran = true;
+    });
+    EXPECT_TRUE(waitFor([&] { return ran.load(); }));
+    EXPECT_TRUE(onLoop);
+    EXPECT_FALSE(reactor.inLoopThread());
+}
+
+} // namespace
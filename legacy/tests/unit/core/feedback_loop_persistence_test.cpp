@@ -91,6 +91,49 @@ TEST_F(FeedbackLoopPersistenceTest, DataRetention) {
     ASSERT_TRUE(current_metrics_result.has_value());
 }
 
+TEST_F(FeedbackLoopPersistenceTest, SavesAppendHistoryBeyondTheWindow) {
+    FeedbackLoopConfig config = createConfig(testDir);
+    config.metricsWindowSize = std::chrono::seconds(5);
+    FeedbackLoop loop(config);
+
+    auto now = std::chrono::system_clock::now();
+    for (int i = 0; i < 3; ++i) {
+        // Older than the window, so only the store keeps them
+        loop.reportOutcome({false, std::chrono::milliseconds(10), 100, 0, 1, "timeout",
+                            now - std::chrono::seconds(60 - i)});
+    }
+    ASSERT_TRUE(loop.saveData().has_value());
+    loop.reportOutcome({true, std::chrono::milliseconds(20), 200, 0, 0, "", now});
+    ASSERT_TRUE(loop.saveData().has_value());
+    ASSERT_TRUE(loop.saveData().has_value());  // Nothing new: no segment
+
+    size_t segments = std::distance(std::filesystem::directory_iterator(testDir + "/segments"),
+                                    std::filesystem::directory_iterator());
+    EXPECT_EQ(segments, 2u);
+
+    auto history = loop.getOutcomesByTimeRange(now - std::chrono::minutes(2), now);
+    ASSERT_TRUE(history.has_value());
+    ASSERT_EQ(history.value().size(), 4u);
+    EXPECT_EQ(history.value().front().errorType, "timeout");
+    EXPECT_EQ(history.value().back().bytesTransferred, 200u);
+
+    ASSERT_TRUE(loop.compactStorage().has_value());
+    segments = std::distance(std::filesystem::directory_iterator(testDir + "/segments"),
+                             std::filesystem::directory_iterator());
+    EXPECT_EQ(segments, 1u);
+
+    // A new instance loads only the window into memory but still finds the rest
+    FeedbackLoop reopened(config);
+    ASSERT_TRUE(reopened.loadData().has_value());
+    EXPECT_EQ(reopened.getCurrentMetrics().value().totalTransactions, 1u);
+    history = reopened.getOutcomesByTimeRange(now - std::chrono::minutes(2), now);
+    ASSERT_TRUE(history.has_value());
+    EXPECT_EQ(history.value().size(), 4u);
+    auto oldest = reopened.getOldestDataTime();
+    ASSERT_TRUE(oldest.has_value());
+    EXPECT_EQ(oldest.value(), now - std::chrono::seconds(60));
+}
+
 TEST_F(FeedbackLoopPersistenceTest, CorruptedDataHandling) {
     CommunicationOutcome outcome = {
         true, std::chrono::milliseconds(50), 512, 0, 0, "", std::chrono::system_clock::now()
@@ -115,6 +158,36 @@ TEST_F(FeedbackLoopPersistenceTest, CorruptedDataHandling) {
     EXPECT_EQ(metrics_after_corrupt_load.value().totalTransactions, 0);
 }
 
+TEST_F(FeedbackLoopPersistenceTest, RoundTripsAtEachCompressionLevel) {
+    // Level 3 writes a zlib header the loader once took for uncompressed data
+    for (int level : {0, 1, 3, 9}) {
+        remove_directory_recursive(testDir);
+        FeedbackLoopConfig config = createConfig(testDir);
+        config.persistence.enableCompression = level > 0;
+        config.persistence.compressionLevel = level;
+        {
+            FeedbackLoop loop(config);
+            for (int i = 0; i < 200; ++i) {
+                loop.recordMetric("rtt_ms", 100.0 + i);
+                loop.recordMetric("jitter_ms", 2.5);
+            }
+            ASSERT_TRUE(loop.saveData().has_value()) << "level " << level;
+        }
+
+        std::ifstream file(testDir + "/feedback_main.dat", std::ios::binary);
+        EXPECT_EQ(file.get() == 0x78, level > 0) << "level " << level;
+
+        FeedbackLoop reloaded(config);
+        ASSERT_TRUE(reloaded.loadData().has_value()) << "level " << level;
+        auto rtt = reloaded.getMetricValue("rtt_ms");
+        ASSERT_TRUE(rtt.has_value());
+        EXPECT_DOUBLE_EQ(rtt.value(), 299.0);
+        auto jitter = reloaded.getMetricValue("jitter_ms");
+        ASSERT_TRUE(jitter.has_value());
+        EXPECT_DOUBLE_EQ(jitter.value(), 2.5);
+    }
+}
+
 } // namespace
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "xenocomm/core/feedback_loop.h"
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <random>
 
@@ -140,6 +142,204 @@ TEST_CASE("FeedbackLoop thread safety", "[feedback_loop]") {
     }
 }
 
+TEST_CASE("FeedbackLoop ingests outcomes from many threads", "[feedback_loop]") {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    config.maxStoredOutcomes = 100000;
+    config.ingestQueueCapacity = 16; // Small enough that reporters fill it
+    FeedbackLoop feedback(config);
+
+    constexpr int numThreads = 8;
+    constexpr int outcomesPerThread = 2000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&feedback]() {
+            for (int j = 0; j < outcomesPerThread; ++j) {
+                bool failed = (j % 4 == 0);
+                feedback.addCommunicationResult(!failed, std::chrono::microseconds(100), 1024,
+                                                0, failed ? 1 : 0, failed ? "connection_timeout" : "");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Nothing is lost when the rings fill, and queries see every outcome reported so far
+    auto outcomes = feedback.getRecentOutcomes(numThreads * outcomesPerThread);
+    REQUIRE(outcomes.has_value());
+    REQUIRE(outcomes.value().size() == numThreads * outcomesPerThread);
+    REQUIRE(std::is_sorted(outcomes.value().begin(), outcomes.value().end(),
+                           [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; }));
+
+    auto errors = feedback.getErrorTypeDistribution();
+    REQUIRE(errors.has_value());
+    REQUIRE(errors.value().size() == 1);
+    REQUIRE(errors.value().at("connection_timeout") == numThreads * outcomesPerThread / 4);
+}
+
+TEST_CASE("FeedbackLoop distributions follow the stored window", "[feedback_loop]") {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    config.maxStoredOutcomes = 50;
+    FeedbackLoop feedback(config);
+
+    for (int i = 0; i < 50; ++i) {
+        feedback.addCommunicationResult(true, std::chrono::microseconds(1000), 1000);
+    }
+    // Pushes every 1ms outcome out of the window
+    for (int i = 1; i <= 50; ++i) {
+        feedback.addCommunicationResult(true, std::chrono::microseconds(10000 + i), 1000);
+    }
+
+    auto latency = feedback.analyzeLatencyDistribution();
+    REQUIRE(latency.has_value());
+    REQUIRE_THAT(latency.value().min, WithinRel(10001.0, 0.01));
+    REQUIRE_THAT(latency.value().max, WithinRel(10050.0, 0.01));
+    REQUIRE_THAT(latency.value().mean, WithinRel(10025.5, 1e-9));
+
+    auto detailed = feedback.getDetailedMetrics();
+    REQUIRE(detailed.has_value());
+    REQUIRE_THAT(detailed.value().latencyStats.percentile90, WithinRel(10.045, 0.01)); // Milliseconds
+    REQUIRE_THAT(detailed.value().throughputStats.max, WithinRel(1000 / 0.010001, 0.01));
+}
+
+TEST_CASE("FeedbackLoop summarizes shorter windows", "[feedback_loop]") {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    config.metricsWindowSize = std::chrono::seconds(60);
+    FeedbackLoop feedback(config);
+
+    auto now = std::chrono::system_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        // Ten failures half a minute ago, then ten successes now
+        feedback.reportOutcome({false, std::chrono::microseconds(500), 100, 1, 1, "timeout",
+                                now - std::chrono::seconds(30)});
+    }
+    for (int i = 0; i < 10; ++i) {
+        feedback.addCommunicationResult(true, std::chrono::microseconds(100), 100);
+    }
+
+    auto all = feedback.getCurrentMetrics();
+    REQUIRE(all.has_value());
+    REQUIRE(all.value().totalTransactions == 20);
+    REQUIRE_THAT(all.value().successRate, WithinRel(0.5));
+    REQUIRE_THAT(all.value().averageLatency, WithinRel(300.0));
+    REQUIRE(all.value().throughputBytesPerSecond > 0.0);
+
+    auto recent = feedback.getMetricsForWindow(std::chrono::seconds(10));
+    REQUIRE(recent.has_value());
+    REQUIRE(recent.value().totalTransactions == 10);
+    REQUIRE_THAT(recent.value().successRate, WithinRel(1.0));
+    REQUIRE(recent.value().errorRate == 0.0);
+
+    auto whole = feedback.getMetricsForWindow(std::chrono::seconds(60));
+    REQUIRE(whole.has_value());
+    REQUIRE(whole.value().totalTransactions == 20);
+
+    REQUIRE_FALSE(feedback.getMetricsForWindow(std::chrono::seconds(0)).has_value());
+    REQUIRE_FALSE(feedback.getMetricsForWindow(std::chrono::seconds(61)).has_value());
+
+    // A shorter configured window drops the old outcomes from every summary
+    config.metricsWindowSize = std::chrono::seconds(20);
+    feedback.setConfig(config);
+    all = feedback.getCurrentMetrics();
+    REQUIRE(all.has_value());
+    REQUIRE(all.value().totalTransactions == 10);
+}
+
+TEST_CASE("FeedbackLoop analyzes latency trends", "[feedback_loop]") {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    FeedbackLoop feedback(config);
+
+    // Latency climbing 10us a second, with a spike every eighth outcome
+    auto start = std::chrono::system_clock::now() - std::chrono::seconds(200);
+    for (int i = 0; i < 200; ++i) {
+        auto latency = 1000 + 10 * i + (i % 8 == 0 ? 500 : 0);
+        feedback.reportOutcome({true, std::chrono::microseconds(latency), 1000, 0, 0, "",
+                                start + std::chrono::seconds(i)});
+    }
+
+    auto trend = feedback.analyzeLatencyTrend();
+    REQUIRE(trend.has_value());
+    REQUIRE_THAT(trend.value().trendSlope, WithinRel(10.0, 0.05));
+    REQUIRE(trend.value().seasonalityStrength > 0.5);
+    REQUIRE(trend.value().forecast.size() == config.forecastHorizon);
+    REQUIRE(trend.value().forecast[1] > trend.value().forecast[0]);
+
+    auto detailed = feedback.getDetailedMetrics();
+    REQUIRE(detailed.has_value());
+    REQUIRE_THAT(detailed.value().latencyTrend.trendSlope, WithinRel(0.01, 0.05)); // Milliseconds
+
+    // A new outcome invalidates the cached analyses
+    feedback.addCommunicationResult(true, std::chrono::microseconds(100000), 1000);
+    auto updated = feedback.analyzeLatencyTrend();
+    REQUIRE(updated.has_value());
+    REQUIRE(updated.value().trendSlope > trend.value().trendSlope);
+    REQUIRE(feedback.getDetailedMetrics().value().basic.totalTransactions == 201);
+}
+
+TEST_CASE("FeedbackLoop aggregates outcomes per label set", "[feedback_loop]") {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    config.maxLabelSets = 3;
+    FeedbackLoop feedback(config);
+
+    auto now = std::chrono::system_clock::now();
+    OutcomeLabels fast{"peer-a", "tcp", "", "zstd"};
+    OutcomeLabels slow{"peer-b", "tcp", "", "zstd"};
+    for (int i = 0; i < 10; ++i) {
+        feedback.reportOutcome({true, std::chrono::microseconds(100), 1000, 0, 0, "", now}, fast);
+        feedback.reportOutcome({i % 2 == 0, std::chrono::microseconds(5000), 1000, 1, 1, "timeout", now}, slow);
+    }
+    feedback.addCommunicationResult(true, std::chrono::microseconds(100), 1000);  // Unlabeled
+
+    REQUIRE(feedback.getCurrentMetrics().value().totalTransactions == 21);
+
+    auto slowOnly = feedback.getMetricsForLabels(OutcomeLabels{"peer-b", "", "", ""});
+    REQUIRE(slowOnly.has_value());
+    REQUIRE(slowOnly.value().totalTransactions == 10);
+    REQUIRE_THAT(slowOnly.value().averageLatency, WithinRel(5000.0, 1e-9));
+    REQUIRE_THAT(slowOnly.value().successRate, WithinRel(0.5, 1e-9));
+
+    auto tcp = feedback.getMetricsForLabels(OutcomeLabels{"", "tcp", "", ""});
+    REQUIRE(tcp.value().totalTransactions == 20);
+    REQUIRE(feedback.getMetricsForLabels(OutcomeLabels{"", "udp", "", ""}).value().totalTransactions == 0);
+
+    // Label sets past the limit are counted together
+    for (int i = 0; i < 4; ++i) {
+        feedback.reportOutcome({true, std::chrono::microseconds(100), 1000, 0, 0, "", now},
+                               OutcomeLabels{"peer-" + std::to_string(i + 10), "udp", "", ""});
+    }
+    auto labeled = feedback.getLabeledMetrics();
+    REQUIRE(labeled.has_value());
+    REQUIRE(labeled.value().size() == 4);
+    auto overflow = feedback.getMetricsForLabels(OutcomeLabels{OVERFLOW_LABEL, "", "", ""});
+    REQUIRE(overflow.value().totalTransactions == 3);
+}
+
+TEST_CASE("FeedbackLoop notifies window updates", "[feedback_loop]") {
+    FeedbackLoopConfig config;
+    config.enablePersistence = false;
+    FeedbackLoop feedback(config);
+
+    std::atomic<uint64_t> notified{0};
+    auto subscription = feedback.subscribeWindowUpdates([&](uint64_t generation) { notified = generation; });
+
+    auto before = feedback.getWindowGeneration();
+    REQUIRE(feedback.getWindowGeneration() == before);
+    feedback.addCommunicationResult(true, std::chrono::microseconds(100), 100);
+    auto after = feedback.getWindowGeneration();
+    REQUIRE(after != before);
+    REQUIRE(notified == after);
+
+    feedback.unsubscribeWindowUpdates(subscription);
+    feedback.addCommunicationResult(true, std::chrono::microseconds(100), 100);
+    REQUIRE(feedback.getWindowGeneration() != after);
+    REQUIRE(notified == after);
+}
+
 TEST_CASE("FeedbackLoop error handling", "[feedback_loop]") {
     FeedbackLoop feedback;
 
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/error_correction.h"
+#include "xenocomm/core/fountain_code.h"
+#include <algorithm>
+#include <random>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+std::vector<uint8_t> randomData(size_t size, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> dis(0, 255);
+    std::vector<uint8_t> data(size);
+    std::generate(data.begin(), data.end(), [&]() { return static_cast<uint8_t>(dis(gen)); });
+    return data;
+}
+
+// Streams every block's symbols in ESI order, dropping each with loss_rate,
+// until the decoder completes or max_esi is reached
+size_t stream(const FountainEncoder& encoder, FountainDecoder& decoder, double loss_rate, uint32_t max_esi,
+              uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution lost(loss_rate);
+    const FountainLayout& layout = encoder.layout();
+    std::vector<uint8_t> symbol(layout.symbol_size);
+    size_t received = 0;
+    for (uint32_t block = 0; block < layout.block_count(); ++block) {
+        for (uint32_t esi = 0; esi < max_esi && !decoder.block_complete(block); ++esi) {
+            if (lost(gen)) {
+                continue;
+            }
+            encoder.encode(block, esi, symbol.data());
+            decoder.add_symbol(block, esi, utils::ByteSpan(symbol));
+            ++received;
+        }
+    }
+    return received;
+}
+
+TEST(FountainCodeTest, LayoutSplitsPayloadIntoBlocks) {
+    FountainLayout layout{1000, 64, 4};
+    EXPECT_TRUE(layout.valid());
+    EXPECT_EQ(layout.total_symbols(), 16u);
+    EXPECT_EQ(layout.block_count(), 4u);
+    EXPECT_EQ(layout.source_symbols(3), 4u);
+
+    layout.payload_size = 1100;
+    EXPECT_EQ(layout.total_symbols(), 18u);
+    EXPECT_EQ(layout.block_count(), 5u);
+    EXPECT_EQ(layout.source_symbols(4), 2u);
+    EXPECT_EQ(layout.source_symbols(5), 0u);
+
+    EXPECT_FALSE((FountainLayout{1000, 0, 4}.valid()));
+    EXPECT_FALSE((FountainLayout{1000, 64, FountainLayout::MAX_BLOCK_SYMBOLS + 1}.valid()));
+}
+
+TEST(FountainCodeTest, SourceSymbolsAloneDecode) {
+    const auto data = randomData(10000, 1);
+    FountainEncoder encoder(utils::ByteSpan(data), 128, 16);
+    FountainDecoder decoder(encoder.layout());
+
+    const size_t received = stream(encoder, decoder, 0.0, UINT32_MAX, 2);
+    ASSERT_TRUE(decoder.complete());
+    EXPECT_EQ(received, encoder.layout().total_symbols());
+    EXPECT_EQ(decoder.take_payload(), data);
+}
+
+TEST(FountainCodeTest, RepairSymbolsReplaceLostOnes) {
+    const auto data = randomData(200000, 3);
+    FountainEncoder encoder(utils::ByteSpan(data), 512, 64);
+    FountainDecoder decoder(encoder.layout());
+
+    const size_t received = stream(encoder, decoder, 0.3, UINT32_MAX, 4);
+    ASSERT_TRUE(decoder.complete());
+    // Each block needs its K symbols plus, rarely, one or two more
+    EXPECT_LE(received, encoder.layout().total_symbols() + 2 * encoder.layout().block_count());
+    EXPECT_EQ(decoder.take_payload(), data);
+}
+
+TEST(FountainCodeTest, RepairSymbolsAloneDecode) {
+    const auto data = randomData(4096, 5);
+    FountainEncoder encoder(utils::ByteSpan(data), 256, 16);
+    FountainDecoder decoder(encoder.layout());
+
+    std::vector<uint8_t> symbol(256);
+    for (uint32_t esi = 1000; !decoder.complete() && esi < 1100; ++esi) {
+        encoder.encode(0, esi, symbol.data());
+        decoder.add_symbol(0, esi, utils::ByteSpan(symbol));
+    }
+    ASSERT_TRUE(decoder.complete());
+    EXPECT_EQ(decoder.take_payload(), data);
+}
+
+TEST(FountainCodeTest, RedundantSymbolsAreIgnored) {
+    const auto data = randomData(300, 6);
+    FountainEncoder encoder(utils::ByteSpan(data), 100, 8);
+    FountainDecoder decoder(encoder.layout());
+
+    std::vector<uint8_t> symbol(100);
+    encoder.encode(0, 0, symbol.data());
+    EXPECT_TRUE(decoder.add_symbol(0, 0, utils::ByteSpan(symbol)));
+    EXPECT_FALSE(decoder.add_symbol(0, 0, utils::ByteSpan(symbol)));
+    encoder.encode(0, 5, symbol.data());
+    EXPECT_TRUE(decoder.add_symbol(0, 5, utils::ByteSpan(symbol)));
+    EXPECT_FALSE(decoder.add_symbol(0, 5, utils::ByteSpan(symbol)));
+    EXPECT_FALSE(decoder.add_symbol(1, 0, utils::ByteSpan(symbol)));
+    EXPECT_FALSE(decoder.complete());
+
+    // A late source symbol whose column a repair symbol already covers still counts
+    encoder.encode(0, 1, symbol.data());
+    EXPECT_TRUE(decoder.add_symbol(0, 1, utils::ByteSpan(symbol)));
+    ASSERT_TRUE(decoder.complete());
+    EXPECT_EQ(decoder.take_payload(), data);
+}
+
+TEST(FountainCodeTest, CorrectionRecoversErasedSymbols) {
+    FountainCorrection fountain(FountainCorrection::Config{64, 8, 3});
+    const auto data = randomData(1500, 7);
+    const auto encoded = fountain.encode(data);
+    ASSERT_FALSE(encoded.empty());
+
+    auto damaged = encoded;
+    const size_t record = 4 + 64;
+    // Three symbols of the first block, one of them a repair symbol
+    for (size_t index : {0u, 4u, 9u}) {
+        damaged[index * record + 10] ^= 0x5A;
+    }
+    auto decoded = fountain.decode(damaged);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(*decoded, data);
+
+    EXPECT_EQ(fountain.maxCorrectableErrors(), 3);
+    EXPECT_EQ(fountain.name(), "Fountain");
+}
+
+TEST(FountainCodeTest, CorrectionFailsBeyondRepairBudget) {
+    FountainCorrection fountain(FountainCorrection::Config{64, 8, 2});
+    const auto data = randomData(1000, 8);
+    auto encoded = fountain.encode(data);
+    const size_t record = 4 + 64;
+    for (size_t index : {1u, 2u, 3u}) {
+        encoded[index * record + 20] ^= 0xFF;
+    }
+    EXPECT_FALSE(fountain.decode(encoded).has_value());
+}
+
+TEST(FountainCodeTest, CorrectionRejectsInvalidConfig) {
+    FountainCorrection fountain(FountainCorrection::Config{0, 8, 2});
+    EXPECT_TRUE(fountain.encode({1, 2, 3}).empty());
+    EXPECT_FALSE(fountain.decode(std::vector<uint8_t>(68)).has_value());
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/ggwave_fsk_adapter.h"
+#include <numeric>
+#include <thread>
+
+using namespace xenocomm::core;
+
+namespace {
+
+std::vector<uint8_t> everyByte() {
+    std::vector<uint8_t> data(256);
+    std::iota(data.begin(), data.end(), 0);
+    return data;
+}
+
+} // namespace
+
+TEST(GgwaveFskAdapterTest, RoundTripsEverySymbol) {
+    GgwaveFskAdapter adapter;
+    auto data = everyByte();
+    auto encoded = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+    EXPECT_EQ(encoded.size(), adapter.getConfig().samples_per_symbol * (data.size() + 24));
+    EXPECT_TRUE(adapter.isValidFormat(encoded.data(), encoded.size(), DataFormat::GGWAVE_FSK));
+    EXPECT_EQ(adapter.getMetadata(encoded).element_count, data.size());
+    EXPECT_EQ(adapter.decode(encoded, DataFormat::GGWAVE_FSK), data);
+}
+
+TEST(GgwaveFskAdapterTest, DecoderAdoptsSenderConfiguration) {
+    GgwaveFskConfig config;
+    config.sample_rate = 16000.0f;
+    config.base_frequency = 500.0f;
+    config.frequency_spacing = 25.0f;
+    config.samples_per_symbol = 640;
+    GgwaveFskAdapter sender(config);
+    std::vector<uint8_t> data = {0x00, 0x7F, 0x80, 0xFF, 0x42};
+    auto encoded = sender.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+
+    GgwaveFskAdapter receiver;
+    receiver.setConfig(config);
+    EXPECT_EQ(receiver.decode(encoded, DataFormat::GGWAVE_FSK), data);
+}
+
+TEST(GgwaveFskAdapterTest, RejectsCorruptedHeader) {
+    GgwaveFskAdapter adapter;
+    std::vector<uint8_t> data = {1, 2, 3};
+    auto encoded = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+    std::fill(encoded.begin(), encoded.begin() + adapter.getConfig().samples_per_symbol, 127);
+    EXPECT_FALSE(adapter.isValidFormat(encoded.data(), encoded.size(), DataFormat::GGWAVE_FSK));
+    EXPECT_THROW(adapter.decode(encoded, DataFormat::GGWAVE_FSK), TranscodingError);
+}
+
+TEST(GgwaveFskAdapterTest, StreamDecoderReassemblesMessagesFromFrames) {
+    GgwaveFskAdapter adapter;
+    auto first = everyByte();
+    std::vector<uint8_t> second = {9, 8, 7};
+    auto audio = adapter.encode(first.data(), first.size(), DataFormat::GGWAVE_FSK);
+    auto more = adapter.encode(second.data(), second.size(), DataFormat::GGWAVE_FSK);
+    audio.insert(audio.end(), more.begin(), more.end());
+
+    // Feed odd-sized capture frames through a ring smaller than either message
+    GgwaveFskAdapter::StreamDecoder decoder(adapter, 4);
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<uint8_t> message;
+    size_t offset = 0;
+    while (offset < audio.size()) {
+        offset += decoder.push(audio.data() + offset, std::min<size_t>(333, audio.size() - offset));
+        while (decoder.poll(message)) {
+            messages.push_back(message);
+        }
+    }
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0], first);
+    EXPECT_EQ(messages[1], second);
+    EXPECT_EQ(decoder.buffered(), 0u);
+}
+
+TEST(GgwaveFskAdapterTest, StreamDecoderRunsAcrossThreads) {
+    GgwaveFskAdapter adapter;
+    auto data = everyByte();
+    auto audio = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+
+    GgwaveFskAdapter::StreamDecoder decoder(adapter, 8);
+    std::thread capture([&] {
+        size_t offset = 0;
+        while (offset < audio.size()) {
+            size_t accepted = decoder.push(audio.data() + offset, std::min<size_t>(512, audio.size() - offset));
+            offset += accepted;
+            if (accepted == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::vector<uint8_t> message;
+    while (!decoder.poll(message)) {
+        std::this_thread::yield();
+    }
+    capture.join();
+    EXPECT_EQ(message, data);
+}
+
+TEST(GgwaveFskAdapterTest, StreamDecoderResetsOnBadHeader) {
+    GgwaveFskAdapter adapter;
+    GgwaveFskAdapter::StreamDecoder decoder(adapter, 32);
+    std::vector<uint8_t> silence(adapter.getConfig().samples_per_symbol * 24, 127);
+    ASSERT_EQ(decoder.push(silence.data(), silence.size()), silence.size());
+    std::vector<uint8_t> message;
+    EXPECT_THROW(decoder.poll(message), TranscodingError);
+    EXPECT_EQ(decoder.buffered(), 0u);
+
+    std::vector<uint8_t> data = {5};
+    auto audio = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK);
+    decoder.push(audio.data(), audio.size());
+    ASSERT_TRUE(decoder.poll(message));
+    EXPECT_EQ(message, data);
+}
+
+namespace {
+
+GgwaveFskConfig multibandConfig() {
+    GgwaveFskConfig config;
+    config.sample_rate = 48000.0f;
+    config.base_frequency = 1000.0f;
+    config.frequency_spacing = 50.0f;  // Orthogonal, and all 256 tones fit for single-band headers
+    config.samples_per_symbol = 960;
+    config.bands = 8;
+    return config;
+}
+
+} // namespace
+
+TEST(GgwaveFskAdapterTest, MultibandRoundTripsInFewerSymbols) {
+    GgwaveFskAdapter adapter(multibandConfig());
+    auto data = everyByte();
+    auto encoded = adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK_MULTIBAND);
+    // 25 header symbols, then four bytes per symbol
+    EXPECT_EQ(encoded.size(), adapter.getConfig().samples_per_symbol * (25 + data.size() / 4));
+    EXPECT_TRUE(adapter.isValidFormat(encoded.data(), encoded.size(), DataFormat::GGWAVE_FSK_MULTIBAND));
+    EXPECT_FALSE(adapter.isValidFormat(encoded.data(), encoded.size(), DataFormat::GGWAVE_FSK));
+    EXPECT_EQ(adapter.getMetadata(encoded).format, DataFormat::GGWAVE_FSK_MULTIBAND);
+    EXPECT_EQ(adapter.decode(encoded, DataFormat::GGWAVE_FSK_MULTIBAND), data);
+
+    // An odd length leaves the last symbol partly padded
+    std::vector<uint8_t> odd = {0xA5, 0x5A, 0x0F};
+    encoded = adapter.encode(odd.data(), odd.size(), DataFormat::GGWAVE_FSK_MULTIBAND);
+    EXPECT_EQ(adapter.decode(encoded, DataFormat::GGWAVE_FSK_MULTIBAND), odd);
+}
+
+TEST(GgwaveFskAdapterTest, MultibandDecoderAdoptsSenderBands) {
+    GgwaveFskConfig config = multibandConfig();
+    config.bands = 5;
+    GgwaveFskAdapter sender(config);
+    std::vector<uint8_t> data = {0x00, 0x7F, 0x80, 0xFF, 0x42, 0x13, 0x37};
+    auto encoded = sender.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK_MULTIBAND);
+
+    GgwaveFskAdapter receiver(multibandConfig());
+    EXPECT_EQ(receiver.decode(encoded, DataFormat::GGWAVE_FSK_MULTIBAND), data);
+    EXPECT_EQ(receiver.getConfig().bands, 5u);
+}
+
+TEST(GgwaveFskAdapterTest, MultibandRejectsOverlappingTones) {
+    // The default spacing is narrower than a Goertzel bin at 256 samples
+    GgwaveFskAdapter adapter;
+    std::vector<uint8_t> data = {1, 2, 3};
+    EXPECT_THROW(adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK_MULTIBAND), TranscodingError);
+
+    GgwaveFskConfig config = multibandConfig();
+    config.bands = 16;
+    config.frequency_spacing = 100.0f;  // Top tone at 26.5 kHz
+    config.samples_per_symbol = 480;
+    adapter.setConfig(config);
+    EXPECT_THROW(adapter.encode(data.data(), data.size(), DataFormat::GGWAVE_FSK_MULTIBAND), TranscodingError);
+}
+
+TEST(GgwaveFskAdapterTest, StreamDecoderHandlesMixedFormats) {
+    GgwaveFskAdapter adapter(multibandConfig());
+    auto first = everyByte();
+    std::vector<uint8_t> second = {9, 8, 7};
+    auto audio = adapter.encode(first.data(), first.size(), DataFormat::GGWAVE_FSK_MULTIBAND);
+    auto more = adapter.encode(second.data(), second.size(), DataFormat::GGWAVE_FSK);
+    audio.insert(audio.end(), more.begin(), more.end());
+
+    GgwaveFskAdapter::StreamDecoder decoder(adapter, 4);
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<uint8_t> message;
+    size_t offset = 0;
+    while (offset < audio.size()) {
+        offset += decoder.push(audio.data() + offset, std::min<size_t>(700, audio.size() - offset));
+        while (decoder.poll(message)) {
+            messages.push_back(message);
+        }
+    }
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0], first);
+    EXPECT_EQ(messages[1], second);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/gpu_quantizer.h"
+#include <cmath>
+#include <limits>
+
+using namespace xenocomm::core;
+
+namespace {
+
+std::vector<float> ramp(size_t count) {
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.37f) * static_cast<float>(i % 17);
+    }
+    return values;
+}
+
+std::vector<uint8_t> toVector(xenocomm::utils::ByteSpan span) {
+    return std::vector<uint8_t>(span.begin(), span.end());
+}
+
+} // namespace
+
+TEST(GpuQuantizerTest, PinnedBufferGrowsOnlyWhenNeeded) {
+    GpuQuantizer::PinnedBuffer buffer;
+    EXPECT_EQ(buffer.size(), 0u);
+    buffer.resize(128);
+    uint8_t* first = buffer.data();
+    buffer.resize(64);
+    EXPECT_EQ(buffer.data(), first);
+    EXPECT_EQ(buffer.size(), 64u);
+    EXPECT_EQ(buffer.capacity(), 128u);
+
+    GpuQuantizer::PinnedBuffer moved = std::move(buffer);
+    EXPECT_EQ(moved.data(), first);
+    EXPECT_EQ(buffer.data(), nullptr);
+}
+
+TEST(GpuQuantizerTest, ConstructorThrowsWithoutDevice) {
+    if (GpuQuantizer::available()) {
+        GTEST_SKIP() << "This host has a CUDA device";
+    }
+    EXPECT_THROW(GpuQuantizer(), TranscodingError);
+}
+
+TEST(GpuQuantizerTest, EncodingsMatchCpuAdapters) {
+    if (!GpuQuantizer::available()) {
+        GTEST_SKIP() << "No CUDA device";
+    }
+    auto values = ramp(1000);
+    values[10] = std::numeric_limits<float>::quiet_NaN();
+    const size_t bytes = values.size() * sizeof(float);
+
+    GpuQuantizer quantizer;
+    const float* device = quantizer.upload(values.data(), values.size());
+    GpuQuantizer::PinnedBuffer out;
+
+    auto int8 = VectorInt8Adapter::perBlock();
+    auto gpu_int8 = toVector(quantizer.encode(device, values.size(), DataFormat::VECTOR_INT8, out));
+    auto cpu_int8 = int8.encode(values.data(), bytes, DataFormat::VECTOR_FLOAT32);
+    ASSERT_EQ(gpu_int8.size(), cpu_int8.size());
+    for (size_t i = 0; i < gpu_int8.size(); ++i) {
+        EXPECT_LE(std::abs(int(gpu_int8[i]) - int(cpu_int8[i])), 1) << "at byte " << i;
+    }
+
+    VectorFloat16Adapter half;
+    EXPECT_EQ(toVector(quantizer.encode(device, values.size(), DataFormat::VECTOR_FLOAT16, out)),
+              half.encode(values.data(), bytes, DataFormat::VECTOR_FLOAT32));
+
+    VectorBFloat16Adapter bfloat;
+    EXPECT_EQ(toVector(quantizer.encode(device, values.size(), DataFormat::VECTOR_BFLOAT16, out)),
+              bfloat.encode(values.data(), bytes, DataFormat::VECTOR_FLOAT32));
+
+    // INT4 decodes through the CPU adapter to within one group step
+    VectorInt4Adapter int4;
+    auto gpu_int4 = toVector(quantizer.encode(device, values.size(), DataFormat::VECTOR_INT4, out));
+    ASSERT_EQ(gpu_int4.size(), int4.maxEncodedSize(bytes, DataFormat::VECTOR_FLOAT32));
+    auto decoded = int4.decode(gpu_int4, DataFormat::VECTOR_INT4);
+    ASSERT_EQ(decoded.size(), bytes);
+    const auto* floats = reinterpret_cast<const float*>(decoded.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!std::isnan(values[i])) {
+            EXPECT_NEAR(floats[i], values[i], 32.0f / 15.0f) << "at element " << i;
+        }
+    }
+}
+
+TEST(GpuQuantizerTest, RejectsUnsupportedFormats) {
+    if (!GpuQuantizer::available()) {
+        GTEST_SKIP() << "No CUDA device";
+    }
+    GpuQuantizer quantizer;
+    std::vector<float> values(8, 1.0f);
+    const float* device = quantizer.upload(values.data(), values.size());
+    EXPECT_THROW(quantizer.encodeOnDevice(device, values.size(), DataFormat::COMPRESSED_STATE), TranscodingError);
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/handshake_pipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace xenocomm;
+using namespace xenocomm::core;
+
+namespace {
+
+// Writes a one-byte hello, then completes once the peer has answered with four bytes
+class ScriptedContext : public SecureContext {
+public:
+    bool attachSocket(int fd) override { fd_ = fd; return true; }
+    bool handshakeWantsWrite() const override { return false; }
+
+    Result<void> doHandshakeStep() override {
+        ++steps;
+        if (!sentHello_) {
+            uint8_t hello = 'H';
+            if (::send(fd_, &hello, 1, MSG_NOSIGNAL) != 1) {
+                return Result<void>(std::string("hello failed"));
+            }
+            sentHello_ = true;
+        }
+        uint8_t buffer[4];
+        ssize_t n = ::read(fd_, buffer, sizeof(buffer) - received_);
+        if (n == 0) {
+            return Result<void>(std::string("peer closed"));
+        }
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK ? Result<void>() : Result<void>(std::string("read failed"));
+        }
+        received_ += static_cast<size_t>(n);
+        return Result<void>();
+    }
+    bool isHandshakeComplete() const override { return received_ >= 4; }
+
+    Result<void> handshake() override { return Result<void>(); }
+    Result<std::vector<uint8_t>> encrypt(const std::vector<uint8_t>& data) override { return data; }
+    Result<std::vector<uint8_t>> decrypt(const std::vector<uint8_t>& data) override { return data; }
+    std::string getPeerCertificateInfo() const override { return ""; }
+    CipherSuite getNegotiatedCipherSuite() const override { return CipherSuite::AES_256_GCM_SHA384; }
+    bool isSelectiveEncryptionEnabled() const override { return false; }
+    void setSelectiveEncryption(bool) override {}
+    const SecurityMetrics& getMetrics() const override { return metrics_; }
+    Result<void> shutdown() override { return Result<void>(); }
+    std::string getNegotiatedProtocol() const override { return ""; }
+    std::string getCipherName() const override { return ""; }
+    int getKeySize() const override { return 0; }
+    Result<std::vector<uint8_t>> generateDTLSCookie() override { return std::vector<uint8_t>(); }
+    bool verifyDTLSCookie(const std::vector<uint8_t>&) override { return false; }
+
+    std::atomic<int> steps{0};
+
+private:
+    int fd_{-1};
+    bool sentHello_{false};
+    size_t received_{0};
+    SecurityMetrics metrics_;
+};
+
+struct SocketPair {
+    int local{-1};
+    int peer{-1};
+
+    SocketPair() {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0) {
+            local = fds[0];
+            peer = fds[1];
+            ::fcntl(local, F_SETFL, ::fcntl(local, F_GETFL) | O_NONBLOCK);
+        }
+    }
+    ~SocketPair() {
+        if (local >= 0) ::close(local);
+        if (peer >= 0) ::close(peer);
+    }
+};
+
+struct Outcomes {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t succeeded{0};
+    std::vector<std::string> errors;
+
+    HandshakePipeline::Completion record() {
+        return [this](const Result<void>& result) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (result.has_value()) {
+                ++succeeded;
+            } else {
+                errors.push_back(result.error());
+            }
+            cv.notify_all();
+        };
+    }
+
+    bool waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return succeeded + errors.size() >= count; });
+    }
+};
+
+TEST(HandshakePipelineTest, RunsManyHandshakesConcurrently) {
+    EventReactor reactor(2);
+    HandshakePipeline pipeline(reactor);
+    Outcomes outcomes;
+
+    constexpr size_t COUNT = 200;
+    std::vector<SocketPair> pairs(COUNT);
+    std::vector<std::shared_ptr<ScriptedContext>> contexts;
+    for (auto& pair : pairs) {
+        ASSERT_GE(pair.local, 0);
+        contexts.push_back(std::make_shared<ScriptedContext>());
+        ASSERT_TRUE(pipeline.start(pair.local, contexts.back(), outcomes.record()));
+    }
+    EXPECT_FALSE(pipeline.start(pairs[0].local, std::make_shared<ScriptedContext>(), outcomes.record()));
+
+    // Every hello is out before any peer answers, so all handshakes are in flight together
+    for (auto& pair : pairs) {
+        uint8_t hello = 0;
+        ASSERT_EQ(::read(pair.peer, &hello, 1), 1);
+        EXPECT_EQ(hello, 'H');
+    }
+    EXPECT_EQ(pipeline.inFlight(), COUNT);
+
+    // Answer in two parts so each handshake takes more than one readiness step
+    for (auto& pair : pairs) {
+        ASSERT_EQ(::write(pair.peer, "ab", 2), 2);
+    }
+    for (auto& pair : pairs) {
+        ASSERT_EQ(::write(pair.peer, "cd", 2), 2);
+    }
+
+    ASSERT_TRUE(outcomes.waitFor(COUNT));
+    EXPECT_EQ(outcomes.succeeded, COUNT);
+    EXPECT_TRUE(outcomes.errors.empty());
+    EXPECT_EQ(pipeline.inFlight(), 0u);
+    EXPECT_EQ(reactor.watchedCount(), 0u);
+    for (auto& context : contexts) {
+        EXPECT_TRUE(context->isHandshakeComplete());
+    }
+}
+
+TEST(HandshakePipelineTest, ReportsTimeoutsAndClosedPeers) {
+    EventReactor reactor(1);
+    HandshakePipeline pipeline(reactor, std::chrono::milliseconds(50));
+    Outcomes outcomes;
+
+    SocketPair silent;
+    SocketPair closing;
+    ASSERT_TRUE(pipeline.start(silent.local, std::make_shared<ScriptedContext>(), outcomes.record()));
+    ASSERT_TRUE(pipeline.start(closing.local, std::make_shared<ScriptedContext>(), outcomes.record()));
+    ::close(closing.peer);
+    closing.peer = -1;
+
+    ASSERT_TRUE(outcomes.waitFor(2));
+    EXPECT_EQ(outcomes.succeeded, 0u);
+    ASSERT_EQ(outcomes.errors.size(), 2u);
+    EXPECT_NE(std::find(outcomes.errors.begin(), outcomes.errors.end(), "Handshake timed out"),
+              outcomes.errors.end());
+    EXPECT_EQ(reactor.watchedCount(), 0u);
+}
+
+TEST(HandshakePipelineTest, CancelledHandshakesDoNotComplete) {
+    EventReactor reactor(1);
+    Outcomes outcomes;
+    SocketPair cancelled;
+    SocketPair abandoned;
+    {
+        HandshakePipeline pipeline(reactor);
+        ASSERT_TRUE(pipeline.start(cancelled.local, std::make_shared<ScriptedContext>(), outcomes.record()));
+        ASSERT_TRUE(pipeline.start(abandoned.local, std::make_shared<ScriptedContext>(), outcomes.record()));
+        EXPECT_TRUE(pipeline.cancel(cancelled.local));
+        EXPECT_FALSE(pipeline.cancel(cancelled.local));
+        EXPECT_EQ(pipeline.inFlight(), 1u);
+    }
+    ::write(cancelled.peer, "abcd", 4);
+    ::write(abandoned.peer, "abcd", 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::lock_guard<std::mutex> lock(outcomes.mutex);
+    EXPECT_EQ(outcomes.succeeded, 0u);
+    EXPECT_TRUE(outcomes.errors.empty());
+    EXPECT_EQ(reactor.watchedCount(), 0u);
+}
+
+} // namespace
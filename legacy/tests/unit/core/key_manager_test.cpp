@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/key_manager.h"
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm;
+using namespace xenocomm::core;
+
+namespace {
+
+KeyGenParams symmetricParams(std::chrono::seconds validity = std::chrono::seconds(3600)) {
+    return KeyGenParams{KeyType::SYMMETRIC, 256, validity, std::nullopt};
+}
+
+bool isGone(const KeyManager& manager, const std::string& keyId) {
+    auto key = manager.getKey(keyId);
+    return !key.has_value() && key.error() == "Key not found";
+}
+
+std::vector<uint8_t> x25519PublicKeyPem() {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_X25519, nullptr);
+    EVP_PKEY* key = nullptr;
+    EVP_PKEY_keygen_init(ctx);
+    EVP_PKEY_keygen(ctx, &key);
+    BIO* bio = BIO_new(BIO_s_mem());
+    PEM_write_bio_PUBKEY(bio, key);
+    char* data;
+    long length = BIO_get_mem_data(bio, &data);
+    std::vector<uint8_t> pem(data, data + length);
+    BIO_free(bio);
+    EVP_PKEY_free(key);
+    EVP_PKEY_CTX_free(ctx);
+    return pem;
+}
+
+template <typename Predicate>
+bool waitUntil(Predicate done, std::chrono::milliseconds limit = std::chrono::milliseconds(5000)) {
+    auto deadline = std::chrono::steady_clock::now() + limit;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+TEST(KeyManagerTest, RotationHandsOffWithoutInvalidatingHeldKeys) {
+    KeyManager manager{SecurityConfig{}};
+    auto original = manager.generateKey(symmetricParams());
+    ASSERT_TRUE(original.has_value()) << original.error();
+    const std::string originalId = original.value().keyId;
+
+    auto held = manager.findKey(originalId);
+    ASSERT_TRUE(held);
+    EXPECT_EQ(held->keyMaterial.size(), 32u);
+
+    // Readers keep resolving keys throughout the rotation
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> misses{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                if (!manager.findCurrentKey(originalId)) {
+                    ++misses;
+                }
+            }
+        });
+    }
+
+    auto rotated = manager.rotateKey(originalId, symmetricParams());
+    ASSERT_TRUE(rotated.has_value()) << rotated.error();
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(misses.load(), 0u);
+
+    // The old key still opens in-flight traffic and points at its replacement
+    auto retired = manager.findKey(originalId);
+    ASSERT_TRUE(retired);
+    EXPECT_EQ(retired->successorId, rotated.value().keyId);
+    EXPECT_EQ(retired->keyMaterial, held->keyMaterial);
+    EXPECT_TRUE(held->successorId.empty());
+    EXPECT_EQ(manager.findCurrentKey(originalId)->keyId, rotated.value().keyId);
+    EXPECT_EQ(manager.listActiveKeys().size(), 2u);
+}
+
+TEST(KeyManagerTest, MaintenanceRemovesRevokedAndExpiredKeys) {
+    KeyManager manager{SecurityConfig{}};
+    auto revoked = manager.generateKey(symmetricParams());
+    auto expiring = manager.generateKey(symmetricParams(std::chrono::seconds(1)));
+    auto lasting = manager.generateKey(symmetricParams());
+    ASSERT_TRUE(revoked.has_value() && expiring.has_value() && lasting.has_value());
+
+    ASSERT_TRUE(manager.revokeKey(revoked.value().keyId).has_value());
+    EXPECT_FALSE(manager.findKey(revoked.value().keyId));
+
+    EXPECT_TRUE(waitUntil([&] {
+        return isGone(manager, revoked.value().keyId) && isGone(manager, expiring.value().keyId);
+    }));
+    EXPECT_TRUE(manager.findKey(lasting.value().keyId));
+}
+
+TEST(KeyManagerTest, ScheduledRotationReplacesKeysBeforeExpiry) {
+    KeyManager manager{SecurityConfig{}};
+    auto original = manager.generateKey(symmetricParams(std::chrono::seconds(2)));
+    ASSERT_TRUE(original.has_value());
+    const std::string originalId = original.value().keyId;
+
+    KeyRotationPolicy policy;
+    policy.params = symmetricParams(std::chrono::seconds(3600));
+    policy.lead = std::chrono::seconds(1);
+    ASSERT_TRUE(manager.scheduleRotation(originalId, policy).has_value());
+    EXPECT_FALSE(manager.scheduleRotation("missing", policy).has_value());
+
+    ASSERT_TRUE(waitUntil([&] {
+        auto key = manager.findKey(originalId);
+        return key && !key->successorId.empty();
+    }));
+    auto current = manager.findCurrentKey(originalId);
+    ASSERT_TRUE(current);
+    EXPECT_NE(current->keyId, originalId);
+    EXPECT_GT(current->expiryTime, original.value().expiryTime);
+
+    // The retired key lapses at its own expiry; the replacement carries on
+    ASSERT_TRUE(waitUntil([&] { return !manager.findKey(originalId); }));
+    EXPECT_TRUE(manager.findKey(current->keyId));
+}
+
+TEST(KeyManagerTest, PoolServesKeysOnceTheyAreInDemand) {
+    KeyManager manager{SecurityConfig{}};
+    EXPECT_EQ(manager.getKeyPoolStats().pooledSymmetric, 0u);
+
+    ASSERT_TRUE(manager.generateKey(symmetricParams()).has_value());
+    EXPECT_EQ(manager.getKeyPoolStats().misses, 1u);
+    ASSERT_TRUE(waitUntil([&] { return manager.getKeyPoolStats().pooledSymmetric >= 4; }));
+
+    auto pooled = manager.generateKey(symmetricParams());
+    ASSERT_TRUE(pooled.has_value());
+    EXPECT_EQ(pooled.value().keyMaterial.size(), 32u);
+    EXPECT_EQ(manager.getKeyPoolStats().hits, 1u);
+}
+
+TEST(KeyManagerTest, ExchangesTakeEphemeralKeysFromThePool) {
+    KeyManager manager{SecurityConfig{}};
+    auto p256 = manager.generateKey(KeyGenParams{KeyType::ASYMMETRIC_PUB, 2048, std::chrono::seconds(3600), std::nullopt});
+    ASSERT_TRUE(p256.has_value()) << p256.error();
+    auto x25519 = manager.importKey(x25519PublicKeyPem(), "PEM", KeyType::ASYMMETRIC_PUB);
+    ASSERT_TRUE(x25519.has_value());
+
+    for (const auto* peer : {&p256.value(), &x25519.value()}) {
+        auto first = manager.respondToKeyExchange(peer->keyId, true);
+        ASSERT_TRUE(first.has_value()) << first.error();
+        EXPECT_EQ(first.value().keyData.keyMaterial.size(), 32u);
+    }
+    ASSERT_TRUE(waitUntil([&] { return manager.getKeyPoolStats().pooledEphemeral >= 8; }));
+
+    auto before = manager.getKeyPoolStats();
+    for (const auto* peer : {&p256.value(), &x25519.value()}) {
+        auto exchanged = manager.respondToKeyExchange(peer->keyId, true);
+        ASSERT_TRUE(exchanged.has_value()) << exchanged.error();
+        EXPECT_EQ(exchanged.value().keyData.keyMaterial.size(), 32u);
+    }
+    auto after = manager.getKeyPoolStats();
+    EXPECT_EQ(after.hits, before.hits + 2);
+    EXPECT_EQ(after.misses, before.misses);
+}
+
+TEST(KeyManagerTest, DisabledPoolGeneratesOnTheRequestPath) {
+    SecurityConfig config;
+    config.keyPool.enabled = false;
+    KeyManager manager{config};
+    ASSERT_TRUE(manager.generateKey(symmetricParams()).has_value());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto stats = manager.getKeyPoolStats();
+    EXPECT_EQ(stats.hits + stats.misses, 0u);
+    EXPECT_EQ(stats.pooledSymmetric, 0u);
+}
+
+} // namespace
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/link_health.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+using namespace std::chrono;
+
+namespace {
+
+LinkHealthPolicy quickPolicy() {
+    LinkHealthPolicy policy;
+    policy.idleAfter = milliseconds(20);
+    policy.maxConsecutiveErrors = 2;
+    return policy;
+}
+
+// Long enough that the scheduler's own timer never runs a round during a test
+constexpr milliseconds MANUAL_TICK{3600 * 1000};
+
+} // namespace
+
+TEST(LinkHealthTest, JudgesLinksFromTheirTraffic) {
+    LinkHealth health;
+    LinkHealthPolicy policy = quickPolicy();
+    health.reset();
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+
+    std::this_thread::sleep_for(milliseconds(30));
+    EXPECT_EQ(health.assess(policy), LinkVerdict::IDLE);
+    health.recordSent();
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+
+    health.recordError();
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+    health.recordError();
+    EXPECT_EQ(health.assess(policy), LinkVerdict::FAILING);
+    health.recordHeard();
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+    EXPECT_EQ(health.snapshot().totalErrors, 2u);
+
+    health.recordProbe(false);
+    health.recordProbe(false);
+    EXPECT_EQ(health.assess(policy), LinkVerdict::FAILING);
+    health.recordProbe(true);
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+}
+
+TEST(LinkHealthTest, UnansweredSendsFailOnlyWhenEnabled) {
+    LinkHealth health;
+    LinkHealthPolicy policy = quickPolicy();
+    health.reset();
+    std::this_thread::sleep_for(milliseconds(10));
+    for (int i = 0; i < 5; ++i) {
+        health.recordSent();
+    }
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+
+    policy.maxUnansweredSends = 5;
+    policy.responseTimeout = milliseconds(5);
+    EXPECT_EQ(health.assess(policy), LinkVerdict::FAILING);
+    health.recordHeard();
+    EXPECT_EQ(health.assess(policy), LinkVerdict::HEALTHY);
+    EXPECT_EQ(health.snapshot().unansweredSends, 0u);
+}
+
+TEST(HeartbeatSchedulerTest, ProbesEachHostOnceForAllItsIdleLinks) {
+    HeartbeatScheduler scheduler(MANUAL_TICK);
+    constexpr int LINKS = 8;
+    std::vector<std::unique_ptr<LinkHealth>> links;
+    std::atomic<int> probes{0};
+    for (int i = 0; i < LINKS; ++i) {
+        links.push_back(std::make_unique<LinkHealth>());
+        links.back()->reset();
+        scheduler.add("10.0.0.1", *links.back(), quickPolicy(), [&]() { ++probes; return true; }, nullptr);
+    }
+    LinkHealth other;
+    other.reset();
+    scheduler.add("10.0.0.2", other, quickPolicy(), [&]() { ++probes; return true; }, nullptr);
+    EXPECT_EQ(scheduler.linkCount(), static_cast<size_t>(LINKS + 1));
+
+    // Fresh links need no probe at all
+    scheduler.runOnce();
+    EXPECT_EQ(probes, 0);
+
+    std::this_thread::sleep_for(milliseconds(30));
+    links[0]->recordHeard();  // Busy links are left out of the heartbeat
+    scheduler.runOnce();
+    EXPECT_EQ(probes, 2);
+    auto stats = scheduler.getStats();
+    EXPECT_EQ(stats.probes, 2u);
+    EXPECT_EQ(stats.coalesced, static_cast<uint64_t>(LINKS - 2));
+    EXPECT_EQ(stats.assessments, static_cast<uint64_t>(2 * (LINKS + 1)));
+    for (const auto& link : links) {
+        EXPECT_EQ(link->assess(quickPolicy()), LinkVerdict::HEALTHY);
+    }
+
+    // The heartbeat covers them until they go quiet again
+    scheduler.runOnce();
+    EXPECT_EQ(probes, 2);
+}
+
+TEST(HeartbeatSchedulerTest, ReportsAFailureOnceUntilTheLinkRecovers) {
+    HeartbeatScheduler scheduler(MANUAL_TICK);
+    LinkHealth health;
+    health.reset();
+    std::atomic<int> failures{0};
+    scheduler.add("10.0.0.1", health, quickPolicy(), []() { return true; }, [&]() { ++failures; });
+
+    health.recordError();
+    health.recordError();
+    scheduler.runOnce();
+    scheduler.runOnce();
+    EXPECT_EQ(failures, 1);
+
+    health.recordHeard();
+    scheduler.runOnce();
+    health.recordError();
+    health.recordError();
+    scheduler.runOnce();
+    EXPECT_EQ(failures, 2);
+    EXPECT_EQ(scheduler.getStats().failures, 2u);
+}
+
+TEST(HeartbeatSchedulerTest, RemovedLinksAreNotCalledBack) {
+    HeartbeatScheduler scheduler(MANUAL_TICK);
+    LinkHealth first;
+    LinkHealth second;
+    first.reset();
+    second.reset();
+    std::atomic<int> calls{0};
+    HeartbeatScheduler::Registration secondId = 0;
+    auto firstId = scheduler.add("10.0.0.1", first, quickPolicy(), [&]() {
+        ++calls;
+        scheduler.remove(secondId);  // Removing from inside a round must not deadlock
+        return true;
+    }, nullptr);
+    secondId = scheduler.add("10.0.0.1", second, quickPolicy(), [&]() { ++calls; return true; },
+                             [&]() { ++calls; });
+
+    std::this_thread::sleep_for(milliseconds(30));
+    second.recordError();
+    second.recordError();
+    scheduler.runOnce();
+    // The failing link's handler ran before the probe removed it
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(scheduler.linkCount(), 1u);
+
+    scheduler.remove(firstId);
+    std::this_thread::sleep_for(milliseconds(30));
+    scheduler.runOnce();
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(scheduler.linkCount(), 0u);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/metrics_http_server.hpp"
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string>
+
+namespace xenocomm {
+namespace core {
+namespace test {
+
+// Sends one raw request and returns everything the server wrote before closing
+std::string fetch(uint16_t port, const std::string& request) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return "";
+    }
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return response;
+}
+
+TEST(MetricsHttpServerTest, ServesTheRegistryInTheRequestedFormat) {
+    utils::MetricsRegistry registry;
+    registry.counter("scrapes_seen", "Test counter").add(7);
+    MetricsHttpServer server(registry);
+    ASSERT_TRUE(server.start(0));
+    ASSERT_NE(server.port(), 0);
+    EXPECT_FALSE(server.start(0));
+
+    std::string response = fetch(server.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+    EXPECT_NE(response.find("scrapes_seen_total 7\n"), std::string::npos);
+
+    response = fetch(server.port(), "GET /metrics HTTP/1.1\r\n"
+                                    "Accept: application/openmetrics-text; version=1.0.0\r\n\r\n");
+    EXPECT_NE(response.find("Content-Type: application/openmetrics-text"), std::string::npos);
+    EXPECT_NE(response.find("# EOF\n"), std::string::npos);
+
+    response = fetch(server.port(), "GET /other HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 404", 0), 0u);
+
+    server.stop();
+    EXPECT_FALSE(server.running());
+    EXPECT_EQ(fetch(server.port(), "GET /metrics HTTP/1.1\r\n\r\n"), "");
+}
+
+} // namespace test
+} // namespace core
+} // namespace xenocomm
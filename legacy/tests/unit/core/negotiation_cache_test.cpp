@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/negotiation_cache.h"
+
+using namespace xenocomm::core;
+
+namespace {
+
+ParameterPreference makePreferences() {
+    ParameterPreference prefs;
+    prefs.dataFormats.emplace_back(DataFormat::VECTOR_FLOAT32, 1, true);
+    prefs.dataFormats.emplace_back(DataFormat::BINARY_CUSTOM, 2);
+    prefs.compressionAlgorithms.emplace_back(CompressionAlgorithm::ZSTD, 1);
+    prefs.compressionAlgorithms.emplace_back(CompressionAlgorithm::NONE, 2);
+    prefs.errorCorrectionSchemes.emplace_back(ErrorCorrectionScheme::CHECKSUM_ONLY, 1);
+    prefs.encryptionAlgorithms.emplace_back(EncryptionAlgorithm::NONE, 1);
+    prefs.keyExchangeMethods.emplace_back(KeyExchangeMethod::NONE, 1);
+    prefs.authenticationMethods.emplace_back(AuthenticationMethod::NONE, 1);
+    prefs.keySizes.emplace_back(KeySize::NONE, 1);
+    return prefs;
+}
+
+NegotiableParams makeParams() {
+    NegotiableParams params;
+    params.dataFormat = DataFormat::VECTOR_FLOAT32;
+    params.compressionAlgorithm = CompressionAlgorithm::ZSTD;
+    params.errorCorrection = ErrorCorrectionScheme::CHECKSUM_ONLY;
+    params.keySize = KeySize::NONE;
+    return params;
+}
+
+NegotiationSessionData makeSession() {
+    NegotiationSessionData session;
+    session.remoteFormats = {DataFormat::VECTOR_FLOAT32, DataFormat::VECTOR_INT8};
+    session.remoteCompression = {CompressionAlgorithm::ZSTD, CompressionAlgorithm::LZ4};
+    session.remoteErrorCorrection = {ErrorCorrectionScheme::CHECKSUM_ONLY};
+    return session;
+}
+
+} // namespace
+
+TEST(NegotiationCacheTest, DigestsTrackPreferencesAndCapabilities) {
+    auto prefs = makePreferences();
+    EXPECT_EQ(hashPreference(prefs), hashPreference(makePreferences()));
+
+    auto reranked = makePreferences();
+    reranked.compressionAlgorithms[1].rank = 3;
+    EXPECT_NE(hashPreference(reranked), hashPreference(prefs));
+
+    auto custom = makePreferences();
+    custom.customParameters["window"].emplace_back("64", 1);
+    EXPECT_NE(hashPreference(custom), hashPreference(prefs));
+
+    auto session = makeSession();
+    EXPECT_EQ(hashPeerCapabilities(session), hashPeerCapabilities(makeSession()));
+    session.remoteCompression.pop_back();
+    EXPECT_NE(hashPeerCapabilities(session), hashPeerCapabilities(makeSession()));
+}
+
+TEST(NegotiationCacheTest, HitsOnlyForTheSamePeerPreferencesAndCapabilities) {
+    CacheConfig config;
+    config.track_stats = true;
+    NegotiationCache cache(config);
+
+    NegotiationCacheKey key{"agent-7", hashPreference(makePreferences()), hashPeerCapabilities(makeSession())};
+    cache.put(key, makeParams());
+    auto hit = cache.get(key);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(*hit, makeParams());
+
+    NegotiationCacheKey otherPeer = key;
+    otherPeer.peerId = "agent-8";
+    NegotiationCacheKey changedPeer = key;
+    changedPeer.capabilityHash ^= 1;
+    EXPECT_FALSE(cache.get(otherPeer).has_value());
+    EXPECT_FALSE(cache.get(changedPeer).has_value());
+
+    EXPECT_TRUE(cache.remove(key));
+    EXPECT_FALSE(cache.get(key).has_value());
+    auto stats = cache.get_stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+}
+
+TEST(NegotiationCacheTest, EntriesExpire) {
+    CacheConfig config;
+    config.ttl = std::chrono::seconds(0);
+    NegotiationCache cache(config);
+    NegotiationCacheKey key{"agent-7", 1, 2};
+    cache.put(key, makeParams());
+    EXPECT_FALSE(cache.get(key).has_value());
+}
+
+TEST(NegotiationCacheTest, ResponderConfirmsOnlyStillAcceptableParameters) {
+    auto prefs = makePreferences();
+    EXPECT_TRUE(acceptsResume(prefs, makeParams()));
+
+    auto unlisted = makeParams();
+    unlisted.compressionAlgorithm = CompressionAlgorithm::LZ4;
+    EXPECT_FALSE(acceptsResume(prefs, unlisted));
+
+    auto notRequired = makeParams();
+    notRequired.dataFormat = DataFormat::BINARY_CUSTOM;
+    EXPECT_FALSE(acceptsResume(prefs, notRequired)) << "The required format must be kept";
+
+    prefs.customParameters["window"].emplace_back("64", 1, true);
+    EXPECT_FALSE(acceptsResume(prefs, makeParams()));
+    auto withWindow = makeParams();
+    withWindow.customParameters["window"] = "64";
+    EXPECT_TRUE(acceptsResume(prefs, withWindow));
+}
+
+TEST(NegotiationCacheTest, ResumeSessionAwaitsOneConfirmation) {
+    auto protocol = createNegotiationProtocol(false);
+    auto sessionId = protocol->resumeSession("agent-7", makeParams());
+    EXPECT_EQ(protocol->getSessionState(sessionId), NegotiationState::AWAITING_RESPONSE);
+    EXPECT_FALSE(protocol->getNegotiatedParams(sessionId).has_value());
+
+    auto invalid = makeParams();
+    invalid.dataFormat = DataFormat::COMPRESSED_STATE;  // Already compressed, so ZSTD is rejected
+    EXPECT_THROW(protocol->resumeSession("agent-7", invalid), std::runtime_error);
+}
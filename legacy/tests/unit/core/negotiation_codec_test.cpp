@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/negotiation_codec.h"
+
+using namespace xenocomm::core;
+
+namespace {
+
+NegotiableParams makeSecureProposal() {
+    NegotiableParams params;
+    params.protocolVersion = "1.2.0";
+    params.dataFormat = DataFormat::VECTOR_FLOAT32;
+    params.compressionAlgorithm = CompressionAlgorithm::ZSTD;
+    params.errorCorrection = ErrorCorrectionScheme::REED_SOLOMON;
+    params.encryptionAlgorithm = EncryptionAlgorithm::AES_GCM;
+    params.keyExchangeMethod = KeyExchangeMethod::ECDH_X25519;
+    params.authenticationMethod = AuthenticationMethod::ED25519_SIGNATURE;
+    params.keySize = KeySize::BITS_256;
+    params.customParameters["fragment.max_size"] = "512";
+    params.customParameters["window"] = "64";
+    return params;
+}
+
+NegotiableParams roundTrip(const NegotiationParamsCodec& codec, const NegotiableParams& params) {
+    std::vector<uint8_t> encoded;
+    codec.encode(params, encoded);
+    EXPECT_EQ(encoded.size(), codec.encodedSize(params));
+
+    NegotiableParams decoded;
+    size_t bytesRead = 0;
+    EXPECT_TRUE(codec.decode(encoded.data(), encoded.size(), decoded, &bytesRead));
+    EXPECT_EQ(bytesRead, encoded.size());
+    return decoded;
+}
+
+} // namespace
+
+TEST(NegotiationCodecTest, RoundTripsAFullProposalInFewBytes) {
+    NegotiationParamsCodec codec;
+    auto params = makeSecureProposal();
+    EXPECT_EQ(roundTrip(codec, params), params);
+
+    // Six enums, a packed version and two interned keys with short values
+    EXPECT_LE(codec.encodedSize(params), 32u);
+}
+
+TEST(NegotiationCodecTest, DefaultsEncodeToTheHeaderAlone) {
+    NegotiationParamsCodec codec;
+    std::vector<uint8_t> encoded;
+    codec.encode(NegotiableParams(), encoded);
+    EXPECT_EQ(encoded, (std::vector<uint8_t>{NEGOTIATION_PARAMS_FORMAT_V1, 0}));
+    EXPECT_EQ(roundTrip(codec, NegotiableParams()), NegotiableParams());
+}
+
+TEST(NegotiationCodecTest, KeepsVersionsThatDoNotPack) {
+    NegotiationParamsCodec codec;
+    for (const char* version : {"2.0.0-beta", "01.0.0", "1.0", "1024.0.0", "0.0.0", "1023.1023.1023"}) {
+        NegotiableParams params;
+        params.securityVersion = version;
+        EXPECT_EQ(roundTrip(codec, params).securityVersion, version);
+    }
+}
+
+TEST(NegotiationCodecTest, SendsUnknownKeysLiterally) {
+    NegotiationParamsCodec codec;
+    NegotiableParams params;
+    params.customParameters["vendor.option"] = "on";
+    params.customParameters["empty"] = "";
+    EXPECT_EQ(roundTrip(codec, params), params);
+
+    // A table that knows the key sends less
+    NegotiationParamsCodec extended({"vendor.option", "empty"});
+    EXPECT_LT(extended.encodedSize(params), codec.encodedSize(params));
+    EXPECT_EQ(roundTrip(extended, params), params);
+}
+
+TEST(NegotiationCodecTest, SkipsUnknownFields) {
+    NegotiationParamsCodec codec;
+    NegotiableParams params;
+    params.compressionAlgorithm = CompressionAlgorithm::LZ4;
+
+    // A newer peer's fields of every wire type, ahead of one this decoder knows
+    std::vector<uint8_t> encoded = {NEGOTIATION_PARAMS_FORMAT_V1, 10,
+                                    0x1F, 0x07,                     // BYTE field 31
+                                    0x3E, 0x81, 0x01,               // VARINT field 30
+                                    0x5D, 0x01, 0xFF,               // BYTES field 29
+                                    0x04, static_cast<uint8_t>(CompressionAlgorithm::LZ4)};
+    NegotiableParams decoded;
+    ASSERT_TRUE(codec.decode(encoded.data(), encoded.size(), decoded));
+    EXPECT_EQ(decoded, params);
+}
+
+TEST(NegotiationCodecTest, RejectsMalformedInput) {
+    NegotiationParamsCodec codec;
+    std::vector<uint8_t> encoded;
+    codec.encode(makeSecureProposal(), encoded);
+
+    NegotiableParams decoded;
+    for (size_t size = 0; size < encoded.size(); ++size) {
+        EXPECT_FALSE(codec.decode(encoded.data(), size, decoded)) << "truncated to " << size;
+    }
+
+    std::vector<uint8_t> badFormat = {0x00, 0};
+    EXPECT_FALSE(codec.decode(badFormat.data(), badFormat.size(), decoded));
+
+    std::vector<uint8_t> badEnum = {NEGOTIATION_PARAMS_FORMAT_V1, 2, 0x03, 0xEE};
+    EXPECT_FALSE(codec.decode(badEnum.data(), badEnum.size(), decoded));
+
+    std::vector<uint8_t> badKey = {NEGOTIATION_PARAMS_FORMAT_V1, 4, 0x4A, 0x02, 0x7F, 'x'};
+    EXPECT_FALSE(codec.decode(badKey.data(), badKey.size(), decoded));
+
+    std::vector<uint8_t> badWireType = {NEGOTIATION_PARAMS_FORMAT_V1, 2, 0xE3, 0x00};
+    EXPECT_FALSE(codec.decode(badWireType.data(), badWireType.size(), decoded));
+}
+
+TEST(NegotiationCodecTest, DecodesFromTheFrontOfALargerBuffer) {
+    NegotiationParamsCodec codec;
+    std::vector<uint8_t> buffer = {0xAA};
+    codec.encode(makeSecureProposal(), buffer);
+    const size_t first = buffer.size() - 1;
+    codec.encode(NegotiableParams(), buffer);
+
+    NegotiableParams decoded;
+    size_t bytesRead = 0;
+    ASSERT_TRUE(codec.decode(buffer.data() + 1, buffer.size() - 1, decoded, &bytesRead));
+    EXPECT_EQ(bytesRead, first);
+    EXPECT_EQ(decoded, makeSecureProposal());
+    ASSERT_TRUE(codec.decode(buffer.data() + 1 + first, buffer.size() - 1 - first, decoded, &bytesRead));
+    EXPECT_EQ(decoded, NegotiableParams());
+}
@@ -327,6 +327,7 @@ TEST_F(NegotiationProtocolDataStructuresTest, EnumValidity) {
     EXPECT_TRUE(validation::isValidDataFormat(DataFormat::COMPRESSED_STATE));
     EXPECT_TRUE(validation::isValidDataFormat(DataFormat::BINARY_CUSTOM));
     EXPECT_TRUE(validation::isValidDataFormat(DataFormat::GGWAVE_FSK));
+    EXPECT_TRUE(validation::isValidDataFormat(DataFormat::GGWAVE_FSK_MULTIBAND));
     
     // Test CompressionAlgorithm validity
     EXPECT_TRUE(validation::isValidCompressionAlgorithm(CompressionAlgorithm::NONE));
@@ -345,6 +346,7 @@ TEST_F(NegotiationProtocolDataStructuresTest, ParameterCompatibility) {
     // Test incompatible combinations
     EXPECT_FALSE(validation::areCompatible(DataFormat::COMPRESSED_STATE, CompressionAlgorithm::ZLIB));
     EXPECT_FALSE(validation::areCompatible(DataFormat::GGWAVE_FSK, ErrorCorrectionScheme::REED_SOLOMON));
+    EXPECT_FALSE(validation::areCompatible(DataFormat::GGWAVE_FSK_MULTIBAND, ErrorCorrectionScheme::REED_SOLOMON));
 
     // Test compatible combinations
     EXPECT_TRUE(validation::areCompatible(DataFormat::VECTOR_FLOAT32, CompressionAlgorithm::ZLIB));
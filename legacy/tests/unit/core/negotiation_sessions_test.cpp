@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/negotiation_protocol.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+
+namespace {
+
+NegotiableParams plainParams() {
+    NegotiableParams params;
+    params.keySize = KeySize::NONE;  // No encryption, so no key
+    return params;
+}
+
+} // namespace
+
+TEST(NegotiationSessionsTest, SessionsProgressIndependently) {
+    auto protocol = createNegotiationProtocol(false);
+    auto first = protocol->initiateSession("agent-1", plainParams());
+    auto second = protocol->initiateSession("agent-2", plainParams());
+    EXPECT_NE(first, second);
+
+    EXPECT_TRUE(protocol->closeSession(first));
+    EXPECT_EQ(protocol->getSessionState(first), NegotiationState::CLOSED);
+    EXPECT_EQ(protocol->getSessionState(second), NegotiationState::AWAITING_RESPONSE);
+    EXPECT_FALSE(protocol->getNegotiatedParams(second).has_value());
+    EXPECT_THROW(protocol->getSessionState(second + 1000), std::runtime_error);
+}
+
+TEST(NegotiationSessionsTest, EarlyDataWaitsForTheAnswer) {
+    auto protocol = createNegotiationProtocol(false);
+    auto speculative = protocol->initiateSessionWithEarlyData("agent-1", plainParams(), {1, 2, 3});
+    auto plain = protocol->initiateSessionWithEarlyData("agent-2", plainParams(), {});
+
+    EXPECT_EQ(protocol->getEarlyDataStatus(speculative), EarlyDataStatus::PENDING);
+    EXPECT_EQ(protocol->getEarlyDataStatus(plain), EarlyDataStatus::NONE);
+    EXPECT_EQ(protocol->getSessionState(speculative), NegotiationState::AWAITING_RESPONSE);
+    // Nothing is handed out before the proposal is accepted
+    EXPECT_FALSE(protocol->takeEarlyData(speculative).has_value());
+    EXPECT_THROW(protocol->getEarlyDataStatus(plain + 1000), std::runtime_error);
+}
+
+TEST(NegotiationSessionsTest, PollingRunsAlongsideNegotiations) {
+    auto protocol = createNegotiationProtocol(false);
+    constexpr int WORKERS = 4;
+    constexpr int SESSIONS_PER_WORKER = 200;
+    std::vector<std::atomic<NegotiationProtocol::SessionId>> latest(WORKERS);
+    for (auto& id : latest) {
+        id = 0;
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> polls{0};
+    std::vector<std::thread> pollers;
+    for (int p = 0; p < 2; ++p) {
+        pollers.emplace_back([&] {
+            while (!done) {
+                for (auto& id : latest) {
+                    auto sessionId = id.load();
+                    if (sessionId != 0) {
+                        auto state = protocol->getSessionState(sessionId);
+                        EXPECT_TRUE(state == NegotiationState::INITIATING ||
+                                    state == NegotiationState::AWAITING_RESPONSE ||
+                                    state == NegotiationState::CLOSED);
+                        protocol->getNegotiatedParams(sessionId);
+                        ++polls;
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < WORKERS; ++w) {
+        workers.emplace_back([&, w] {
+            for (int i = 0; i < SESSIONS_PER_WORKER; ++i) {
+                auto sessionId = protocol->initiateSession("agent-" + std::to_string(w), plainParams());
+                latest[w] = sessionId;
+                protocol->closeSession(sessionId);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    done = true;
+    for (auto& poller : pollers) {
+        poller.join();
+    }
+
+    for (auto& id : latest) {
+        EXPECT_EQ(protocol->getSessionState(id), NegotiationState::CLOSED);
+    }
+    EXPECT_GT(polls.load(), 0u);
+}
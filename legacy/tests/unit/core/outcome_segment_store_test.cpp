@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/outcome_segment_store.h"
+#include <filesystem>
+#include <fstream>
+
+namespace xenocomm {
+namespace {
+
+using std::chrono::system_clock;
+
+class OutcomeSegmentStoreTest : public ::testing::Test {
+protected:
+    std::string dir = "./test_outcome_segments";
+    system_clock::time_point base = system_clock::now();
+
+    void SetUp() override { std::filesystem::remove_all(dir); }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    // One outcome every 10ms, every fourth a timeout
+    std::vector<CommunicationOutcome> outcomes(int count, int from = 0) {
+        std::vector<CommunicationOutcome> result;
+        for (int i = from; i < from + count; ++i) {
+            bool failed = i % 4 == 0;
+            result.push_back({!failed, std::chrono::microseconds(900 + i % 7), static_cast<uint32_t>(1024 + i),
+                              static_cast<uint32_t>(i % 3), failed ? 1u : 0u, failed ? "timeout" : "",
+                              base + std::chrono::milliseconds(10 * i)});
+        }
+        return result;
+    }
+
+    void expectSame(const std::vector<CommunicationOutcome>& actual, const std::vector<CommunicationOutcome>& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            EXPECT_EQ(actual[i].success, expected[i].success);
+            EXPECT_EQ(actual[i].latency, expected[i].latency);
+            EXPECT_EQ(actual[i].bytesTransferred, expected[i].bytesTransferred);
+            EXPECT_EQ(actual[i].retryCount, expected[i].retryCount);
+            EXPECT_EQ(actual[i].errorCount, expected[i].errorCount);
+            EXPECT_EQ(actual[i].errorType, expected[i].errorType);
+            EXPECT_EQ(actual[i].timestamp, expected[i].timestamp);
+        }
+    }
+};
+
+TEST_F(OutcomeSegmentStoreTest, EncodesRegularOutcomesCompactly) {
+    auto sorted = outcomes(1000);
+    auto encoded = OutcomeSegmentStore::encodeSegment(sorted);
+    // Steady timestamps and small values take a few bytes per outcome
+    EXPECT_LT(encoded.size(), 10u * sorted.size());
+
+    std::vector<CommunicationOutcome> decoded;
+    ASSERT_TRUE(OutcomeSegmentStore::decodeSegment(encoded.data(), encoded.size(), system_clock::time_point::min(),
+                                                   system_clock::time_point::max(), decoded));
+    expectSame(decoded, sorted);
+
+    encoded[encoded.size() / 2] ^= 0x40;
+    decoded.clear();
+    EXPECT_FALSE(OutcomeSegmentStore::decodeSegment(encoded.data(), encoded.size(), system_clock::time_point::min(),
+                                                    system_clock::time_point::max(), decoded));
+    EXPECT_FALSE(OutcomeSegmentStore::decodeSegment(encoded.data(), 10, system_clock::time_point::min(),
+                                                    system_clock::time_point::max(), decoded));
+}
+
+TEST_F(OutcomeSegmentStoreTest, QueriesRangesAcrossSegmentsAndReopens) {
+    {
+        OutcomeSegmentStore store(dir);
+        ASSERT_TRUE(store.append(outcomes(100)).has_value());
+        ASSERT_TRUE(store.append(outcomes(100, 100)).has_value());
+        ASSERT_TRUE(store.append({}).has_value());
+        EXPECT_EQ(store.segments().size(), 2u);
+    }
+
+    OutcomeSegmentStore reopened(dir);
+    ASSERT_EQ(reopened.segments().size(), 2u);
+    auto all = outcomes(200);
+    auto range = reopened.query(all[50].timestamp, all[149].timestamp);
+    ASSERT_TRUE(range.has_value());
+    expectSame(range.value(), std::vector<CommunicationOutcome>(all.begin() + 50, all.begin() + 150));
+
+    // New segments continue the numbering
+    ASSERT_TRUE(reopened.append(outcomes(10, 200)).has_value());
+    EXPECT_EQ(reopened.segments().size(), 3u);
+    EXPECT_EQ(reopened.query(system_clock::time_point::min(), system_clock::time_point::max()).value().size(), 210u);
+}
+
+TEST_F(OutcomeSegmentStoreTest, CompactsIntoOneSegmentWithinRetention) {
+    OutcomeSegmentStore store(dir);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(store.append(outcomes(20, 20 * i)).has_value());
+    }
+    auto all = outcomes(100);
+    ASSERT_TRUE(store.compact(all[30].timestamp).has_value());
+
+    auto segments = store.segments();
+    ASSERT_EQ(segments.size(), 1u);
+    EXPECT_EQ(segments[0].count, 70u);
+    size_t files = std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator());
+    EXPECT_EQ(files, 1u);
+    auto kept = store.query(system_clock::time_point::min(), system_clock::time_point::max());
+    ASSERT_TRUE(kept.has_value());
+    expectSame(kept.value(), std::vector<CommunicationOutcome>(all.begin() + 30, all.end()));
+
+    ASSERT_TRUE(store.dropBefore(all[99].timestamp + std::chrono::seconds(1)).has_value());
+    EXPECT_TRUE(store.segments().empty());
+}
+
+TEST_F(OutcomeSegmentStoreTest, FindsRangesThroughTheBlockIndex) {
+    // Several index blocks with irregular spacing
+    std::vector<CommunicationOutcome> sorted;
+    for (int i = 0; i < 1000; ++i) {
+        sorted.push_back({true, std::chrono::microseconds(i * 37 % 5000), 10, 0, 0, "",
+                          base + std::chrono::microseconds(i * i)});
+    }
+    auto encoded = OutcomeSegmentStore::encodeSegment(sorted);
+
+    for (auto [from, to] : std::vector<std::pair<int, int>>{
+             {0, 0}, {127, 128}, {128, 255}, {500, 501}, {998, 999}, {0, 999}, {640, 640}}) {
+        std::vector<CommunicationOutcome> decoded;
+        ASSERT_TRUE(OutcomeSegmentStore::decodeSegment(encoded.data(), encoded.size(), sorted[from].timestamp,
+                                                       sorted[to].timestamp, decoded));
+        expectSame(decoded, std::vector<CommunicationOutcome>(sorted.begin() + from, sorted.begin() + to + 1));
+    }
+
+    std::vector<CommunicationOutcome> none;
+    ASSERT_TRUE(OutcomeSegmentStore::decodeSegment(encoded.data(), encoded.size(),
+                                                   sorted.back().timestamp + std::chrono::seconds(1),
+                                                   system_clock::time_point::max(), none));
+    EXPECT_TRUE(none.empty());
+
+    OutcomeSegmentStore store(dir);
+    EXPECT_FALSE(store.oldest().has_value());
+    ASSERT_TRUE(store.append(outcomes(10, 50)).has_value());
+    ASSERT_TRUE(store.append(outcomes(10)).has_value());
+    EXPECT_EQ(store.oldest(), base);
+}
+
+TEST_F(OutcomeSegmentStoreTest, ReportsCorruptSegments) {
+    OutcomeSegmentStore store(dir);
+    ASSERT_TRUE(store.append(outcomes(50)).has_value());
+    {
+        std::fstream file(store.segments()[0].path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-3, std::ios::end);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(store.query(system_clock::time_point::min(), system_clock::time_point::max()).has_value());
+}
+
+} // namespace
+} // namespace xenocomm
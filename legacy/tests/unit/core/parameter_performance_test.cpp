@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/parameter_performance.h"
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+using std::chrono::microseconds;
+
+NegotiableParams withScheme(ErrorCorrectionScheme scheme) {
+    NegotiableParams params;
+    params.keySize = KeySize::NONE;
+    params.errorCorrection = scheme;
+    return params;
+}
+
+CommunicationOutcome outcome(bool success, microseconds latency, uint32_t retries = 0) {
+    CommunicationOutcome result{};
+    result.success = success;
+    result.latency = latency;
+    result.bytesTransferred = 1024;
+    result.retryCount = retries;
+    result.timestamp = std::chrono::system_clock::now();
+    return result;
+}
+
+ParameterPreference staticPreferences() {
+    ParameterPreference prefs;
+    prefs.dataFormats = {{DataFormat::BINARY_CUSTOM, 0}};
+    prefs.compressionAlgorithms = {{CompressionAlgorithm::NONE, 0}, {CompressionAlgorithm::LZ4, 1}};
+    // Statically, no error correction is preferred
+    prefs.errorCorrectionSchemes = {
+        {ErrorCorrectionScheme::NONE, 0},
+        {ErrorCorrectionScheme::CHECKSUM_ONLY, 1},
+        {ErrorCorrectionScheme::REED_SOLOMON, 2, true}
+    };
+    return prefs;
+}
+
+// On a lossy link plain messages are mostly lost and retried; Reed-Solomon repairs them
+void observeLossyLink(ParameterPerformanceModel& model, const std::string& peer, int messages) {
+    for (int i = 0; i < messages; ++i) {
+        model.observe(peer, withScheme(ErrorCorrectionScheme::NONE), outcome(i % 3 == 0, microseconds(9000), 3));
+        model.observe(peer, withScheme(ErrorCorrectionScheme::REED_SOLOMON), outcome(true, microseconds(2500)));
+    }
+}
+
+// On a clean link both arrive, and Reed-Solomon only adds encoding time
+void observeCleanLink(ParameterPerformanceModel& model, const std::string& peer, int messages) {
+    for (int i = 0; i < messages; ++i) {
+        model.observe(peer, withScheme(ErrorCorrectionScheme::NONE), outcome(true, microseconds(1000)));
+        model.observe(peer, withScheme(ErrorCorrectionScheme::REED_SOLOMON), outcome(true, microseconds(1600)));
+    }
+}
+
+TEST(ParameterPerformanceTest, RanksErrorCorrectionByMeasuredCost) {
+    ParameterPerformanceModel model;
+    observeLossyLink(model, "radio", 20);
+    observeCleanLink(model, "wired", 20);
+
+    auto radio = model.rankByPerformance(staticPreferences(), "radio");
+    EXPECT_EQ(radio.errorCorrectionSchemes.front().value, ErrorCorrectionScheme::REED_SOLOMON);
+    EXPECT_TRUE(radio.errorCorrectionSchemes.front().required);
+
+    auto wired = model.rankByPerformance(staticPreferences(), "wired");
+    EXPECT_EQ(wired.errorCorrectionSchemes.front().value, ErrorCorrectionScheme::NONE);
+
+    // The measured options swap ranks 0 and 2; CHECKSUM_ONLY was never used and keeps rank 1
+    for (const auto& option : radio.errorCorrectionSchemes) {
+        if (option.value == ErrorCorrectionScheme::CHECKSUM_ONLY) {
+            EXPECT_EQ(option.rank, 1);
+        }
+    }
+    EXPECT_EQ(CompiledPreference(radio).calculateCompatibilityScore(withScheme(ErrorCorrectionScheme::REED_SOLOMON)), 0u);
+}
+
+TEST(ParameterPerformanceTest, KeepsStaticRanksUntilEnoughSamples) {
+    ParameterPerformanceConfig config;
+    config.minSamples = 10;
+    ParameterPerformanceModel model(config);
+    observeLossyLink(model, "radio", 5);
+
+    auto ranked = model.rankByPerformance(staticPreferences(), "radio");
+    EXPECT_EQ(ranked.errorCorrectionSchemes.front().value, ErrorCorrectionScheme::NONE);
+    ASSERT_TRUE(model.stats("radio", ErrorCorrectionScheme::NONE));
+    EXPECT_EQ(model.stats("radio", ErrorCorrectionScheme::NONE)->samples, 5u);
+    EXPECT_FALSE(model.stats("radio", ErrorCorrectionScheme::CHECKSUM_ONLY));
+}
+
+TEST(ParameterPerformanceTest, NewPeersBorrowTheFiguresOfAllPeers) {
+    ParameterPerformanceModel model;
+    observeLossyLink(model, "radio-1", 20);
+
+    auto ranked = model.rankByPerformance(staticPreferences(), "radio-2");
+    EXPECT_EQ(ranked.errorCorrectionSchemes.front().value, ErrorCorrectionScheme::REED_SOLOMON);
+
+    model.resetPeer("radio-1");
+    EXPECT_FALSE(model.stats("radio-1", ErrorCorrectionScheme::NONE));
+    EXPECT_TRUE(model.stats("", ErrorCorrectionScheme::NONE));
+}
+
+TEST(ParameterPerformanceTest, ForwardsOutcomesToFeedbackLoop) {
+    FeedbackLoopConfig feedbackConfig;
+    feedbackConfig.enablePersistence = false;
+    auto feedback = std::make_shared<FeedbackLoop>(feedbackConfig);
+    ParameterPerformanceModel model(ParameterPerformanceConfig(), feedback);
+    observeCleanLink(model, "wired", 3);
+
+    auto recent = feedback->getRecentOutcomes();
+    ASSERT_TRUE(recent.has_value());
+    EXPECT_EQ(recent.value().size(), 6u);
+
+    OutcomeLabels wired;
+    wired.peerId = "wired";
+    auto labeled = feedback->getMetricsForLabels(wired);
+    ASSERT_TRUE(labeled.has_value());
+    EXPECT_EQ(labeled.value().totalTransactions, 6u);
+    wired.peerId = "radio-1";
+    EXPECT_EQ(feedback->getMetricsForLabels(wired).value().totalTransactions, 0u);
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/peer_connection.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace xenocomm::core;
+using namespace std::chrono;
+
+namespace {
+
+template <typename Predicate>
+bool waitFor(Predicate predicate, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+xenocomm::utils::ByteSpan bytesOf(const std::string& text) {
+    return xenocomm::utils::ByteSpan(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+} // namespace
+
+TEST(PeerConnectionEngineTest, EchoesFramesBetweenEngines) {
+    EventReactor reactor(2);
+    PeerConnectionEngine server(PeerEngineConfig{}, reactor);
+    server.setMessageCallback([&](PeerConnectionEngine::ConnectionId id, xenocomm::utils::ByteSpan frame) {
+        server.send(id, frame);
+    });
+    ASSERT_TRUE(server.listen(0, "127.0.0.1")) << server.getLastError();
+
+    PeerConnectionEngine client(PeerEngineConfig{}, reactor);
+    std::mutex mutex;
+    std::vector<std::string> echoed;
+    std::atomic<bool> connected{false};
+    client.setMessageCallback([&](PeerConnectionEngine::ConnectionId, xenocomm::utils::ByteSpan frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        echoed.emplace_back(reinterpret_cast<const char*>(frame.data()), frame.size());
+    });
+    client.setStateCallback([&](PeerConnectionEngine::ConnectionId, ConnectionState state) {
+        connected = state == ConnectionState::CONNECTED;
+    });
+
+    auto id = client.connect("127.0.0.1", server.listeningPort());
+    ASSERT_NE(id, 0u) << client.getLastError();
+    // Sent before the connect completes, so these wait in the handle's buffer
+    ASSERT_TRUE(client.send(id, bytesOf("first")));
+    ASSERT_TRUE(client.send(id, bytesOf("")));
+    std::string large(300000, 'x');
+    ASSERT_TRUE(client.send(id, bytesOf(large)));
+
+    ASSERT_TRUE(waitFor([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return echoed.size() == 3;
+    }));
+    EXPECT_TRUE(connected);
+    EXPECT_EQ(echoed[0], "first");
+    EXPECT_EQ(echoed[1], "");
+    EXPECT_EQ(echoed[2], large);
+    EXPECT_EQ(server.connectionCount(), 1u);
+
+    // Once delivered and drained, the connections hold no buffers
+    ASSERT_TRUE(waitFor([&]() { return client.pendingBytes(id) == 0; }));
+    EXPECT_EQ(client.memoryStats().bufferBytes, 0u);
+    EXPECT_TRUE(waitFor([&]() { return server.memoryStats().bufferBytes == 0; }));
+}
+
+TEST(PeerConnectionEngineTest, AssemblesFramesSplitAcrossReads) {
+    EventReactor reactor(1);
+    PeerEngineConfig config;
+    config.encoding = xenocomm::utils::FrameLengthEncoding::FIXED32;
+    PeerConnectionEngine engine(config, reactor);
+    std::mutex mutex;
+    std::vector<std::string> frames;
+    engine.setMessageCallback([&](PeerConnectionEngine::ConnectionId, xenocomm::utils::ByteSpan frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames.emplace_back(reinterpret_cast<const char*>(frame.data()), frame.size());
+    });
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_NE(engine.adopt(fds[0]), 0u);
+
+    // Prefix split in two, then the payload trickling in with the next frame
+    const uint8_t parts[][6] = {{0, 0}, {0, 5, 'h', 'e'}, {'l', 'l', 'o', 0, 0, 0}, {2, 'o', 'k'}};
+    const size_t sizes[] = {2, 4, 6, 3};
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(::write(fds[1], parts[i], sizes[i]), static_cast<ssize_t>(sizes[i]));
+        std::this_thread::sleep_for(milliseconds(20));
+    }
+    ASSERT_TRUE(waitFor([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frames.size() == 2;
+    }));
+    EXPECT_EQ(frames[0], "hello");
+    EXPECT_EQ(frames[1], "ok");
+    ::close(fds[1]);
+}
+
+TEST(PeerConnectionEngineTest, ClosedIdsDoNotReachTheHandlesNextConnection) {
+    EventReactor reactor(1);
+    PeerConnectionEngine engine(PeerEngineConfig{}, reactor);
+    std::atomic<int> disconnects{0};
+    engine.setStateCallback([&](PeerConnectionEngine::ConnectionId, ConnectionState state) {
+        disconnects += state == ConnectionState::DISCONNECTED;
+    });
+
+    int first[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, first), 0);
+    auto stale = engine.adopt(first[0]);
+    ASSERT_NE(stale, 0u);
+    EXPECT_TRUE(engine.close(stale));
+    EXPECT_FALSE(engine.close(stale));
+    EXPECT_EQ(disconnects, 1);
+
+    int second[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, second), 0);
+    auto fresh = engine.adopt(second[0]);
+    ASSERT_NE(fresh, 0u);
+    EXPECT_NE(fresh, stale);
+    EXPECT_FALSE(engine.send(stale, bytesOf("lost")));
+    EXPECT_EQ(engine.state(stale), ConnectionState::DISCONNECTED);
+    EXPECT_EQ(engine.state(fresh), ConnectionState::CONNECTED);
+    EXPECT_EQ(engine.connectionCount(), 1u);
+
+    // The peer hanging up closes the connection too
+    ::close(second[1]);
+    EXPECT_TRUE(waitFor([&]() { return engine.connectionCount() == 0; }));
+    EXPECT_EQ(disconnects, 2);
+    ::close(first[1]);
+}
+
+TEST(PeerConnectionEngineTest, ClosesIdleConnections) {
+    EventReactor reactor(1);
+    PeerEngineConfig config;
+    config.idleTimeout = milliseconds(50);
+    PeerConnectionEngine engine(config, reactor);
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    auto id = engine.adopt(fds[0]);
+    ASSERT_NE(id, 0u);
+    EXPECT_TRUE(waitFor([&]() { return engine.state(id) == ConnectionState::DISCONNECTED; }));
+    EXPECT_EQ(engine.connectionCount(), 0u);
+    ::close(fds[1]);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/preference_table.h"
+#include <random>
+#include <set>
+#include <tuple>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+ParameterPreference makePreferences() {
+    ParameterPreference prefs;
+    prefs.dataFormats = {
+        {DataFormat::VECTOR_FLOAT32, 0, false, {DataFormat::VECTOR_FLOAT16}},
+        {DataFormat::VECTOR_INT8, 2},
+        {DataFormat::BINARY_CUSTOM, 5}
+    };
+    prefs.compressionAlgorithms = {{CompressionAlgorithm::ZSTD, 0}, {CompressionAlgorithm::NONE, 3}};
+    prefs.errorCorrectionSchemes = {{ErrorCorrectionScheme::NONE, 1}, {ErrorCorrectionScheme::CHECKSUM_ONLY, 0}};
+    prefs.encryptionAlgorithms = {{EncryptionAlgorithm::AES_GCM, 0}, {EncryptionAlgorithm::NONE, 4}};
+    prefs.keyExchangeMethods = {{KeyExchangeMethod::ECDH_X25519, 0}, {KeyExchangeMethod::NONE, 4}};
+    prefs.authenticationMethods = {{AuthenticationMethod::HMAC_SHA256, 0}};
+    prefs.keySizes = {{KeySize::BITS_256, 0}, {KeySize::NONE, 4}};
+    return prefs;
+}
+
+NegotiableParams randomParams(std::mt19937& rng) {
+    auto pick = [&](int count) { return std::uniform_int_distribution<int>(0, count - 1)(rng); };
+    NegotiableParams params;
+    params.dataFormat = static_cast<DataFormat>(pick(8));
+    params.compressionAlgorithm = static_cast<CompressionAlgorithm>(pick(4));
+    params.errorCorrection = static_cast<ErrorCorrectionScheme>(pick(3));
+    params.encryptionAlgorithm = static_cast<EncryptionAlgorithm>(pick(5));
+    params.keyExchangeMethod = static_cast<KeyExchangeMethod>(pick(7));
+    params.authenticationMethod = static_cast<AuthenticationMethod>(pick(9));
+    params.keySize = static_cast<KeySize>(pick(6));
+    return params;
+}
+
+TEST(PreferenceTableTest, CompiledChecksMatchPreferences) {
+    auto prefs = makePreferences();
+    CompiledPreference compiled(prefs);
+    std::mt19937 rng(11);
+
+    int compatible = 0;
+    for (int i = 0; i < 20000; ++i) {
+        auto params = randomParams(rng);
+        ASSERT_EQ(compiled.isCompatibleWithRequirements(params), prefs.isCompatibleWithRequirements(params));
+        ASSERT_EQ(compiled.calculateCompatibilityScore(params), prefs.calculateCompatibilityScore(params));
+        compatible += prefs.isCompatibleWithRequirements(params);
+    }
+    EXPECT_GT(compatible, 0);
+}
+
+TEST(PreferenceTableTest, BestMatchUsesFallbacks) {
+    auto prefs = makePreferences();
+    CompiledPreference compiled(prefs);
+
+    EXPECT_EQ(compiled.findBestMatch(std::vector<DataFormat>{DataFormat::BINARY_CUSTOM, DataFormat::VECTOR_FLOAT16}),
+              DataFormat::VECTOR_FLOAT16);
+    EXPECT_EQ(compiled.findBestMatch(std::vector<DataFormat>{DataFormat::GGWAVE_FSK}), std::nullopt);
+    EXPECT_EQ(compiled.findBestMatch(std::vector<DataFormat>{}), DataFormat::VECTOR_FLOAT32);
+    EXPECT_EQ(prefs.findBestMatchWithFallbacks(prefs.dataFormats, std::vector<DataFormat>{DataFormat::VECTOR_INT8}),
+              DataFormat::VECTOR_INT8);
+}
+
+TEST(PreferenceTableTest, AlternativesComeBestFirstAndCoverEveryValidSet) {
+    auto prefs = makePreferences();
+    CompiledPreference compiled(prefs);
+    std::vector<DataFormat> remoteFormats{DataFormat::VECTOR_FLOAT16, DataFormat::VECTOR_INT8, DataFormat::BINARY_CUSTOM};
+    NegotiableParams rejected = prefs.buildCompatibleParamsWithFallbacks(remoteFormats, {}, {}, {}, {}, {}, {});
+    EXPECT_EQ(rejected.dataFormat, DataFormat::VECTOR_FLOAT16);
+    EXPECT_EQ(rejected.encryptionAlgorithm, EncryptionAlgorithm::AES_GCM);
+
+    AlternativeProposals alternatives(compiled, rejected, remoteFormats, {}, {}, {}, {}, {}, {}, rejected);
+    std::set<std::tuple<int, int, int, int, int, int, int>> seen;
+    uint32_t lastScore = 0;
+    while (auto params = alternatives.next()) {
+        EXPECT_NE(*params, rejected);
+        EXPECT_TRUE(isSecurityCombinationValid(params->encryptionAlgorithm, params->keyExchangeMethod, params->keySize));
+        // VECTOR_FLOAT16 falls back from a rank 0 option and scores 0, so scores follow the order
+        uint32_t score = compiled.calculateCompatibilityScore(*params);
+        EXPECT_GE(score, lastScore);
+        lastScore = score;
+        EXPECT_TRUE(seen.emplace(static_cast<int>(params->dataFormat),
+                                 static_cast<int>(params->compressionAlgorithm),
+                                 static_cast<int>(params->errorCorrection),
+                                 static_cast<int>(params->encryptionAlgorithm),
+                                 static_cast<int>(params->keyExchangeMethod),
+                                 static_cast<int>(params->authenticationMethod),
+                                 static_cast<int>(params->keySize)).second);
+    }
+
+    // 3 formats x 2 compression x 2 error correction x 1 auth, times the
+    // valid security sets: AES_GCM/X25519/256 and NONE/NONE/NONE or NONE/NONE/256
+    EXPECT_EQ(seen.size(), 3u * 2 * 2 * 1 * 3 - 1);
+}
+
+TEST(PreferenceTableTest, GenerateAlternativeProposalsStopsAtTheLimit) {
+    auto prefs = makePreferences();
+    NegotiableParams rejected = prefs.buildCompatibleParamsWithFallbacks({}, {}, {}, {}, {}, {}, {});
+    auto alternatives = prefs.generateAlternativeProposals(rejected, {}, {}, {}, {}, {}, {}, {}, 3);
+
+    ASSERT_EQ(alternatives.size(), 3u);
+    for (const auto& params : alternatives) {
+        EXPECT_NE(params, rejected);
+    }
+    EXPECT_TRUE(prefs.generateAlternativeProposals(rejected, {DataFormat::GGWAVE_FSK}, {}, {}, {}, {}, {}, {}).empty());
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
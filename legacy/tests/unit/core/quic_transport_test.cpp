@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/quic_transport.hpp"
+#include <numeric>
+#include <thread>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+using xenocomm::utils::PooledBuffer;
+
+namespace {
+
+AeadRecordLayer::DirectionKeys makeKeys(uint8_t seed) {
+    AeadRecordLayer::DirectionKeys keys;
+    keys.key.resize(AeadRecordLayer::keyLength(CipherSuite::AES_128_GCM_SHA256));
+    std::iota(keys.key.begin(), keys.key.end(), seed);
+    std::iota(keys.iv.begin(), keys.iv.end(), static_cast<uint8_t>(seed + 100));
+    return keys;
+}
+
+// Two ends over loopback, with keys agreed out of band
+class QuicTransportTest : public ::testing::Test {
+protected:
+    static constexpr uint16_t kClientPort = 39311;
+    static constexpr uint16_t kServerPort = 39312;
+
+    void SetUp() override {
+        const auto clientToServer = makeKeys(1);
+        const auto serverToClient = makeKeys(50);
+        config.idleTimeoutMs = 5000;
+        client = std::make_unique<QuicTransport>(
+            std::make_shared<AeadRecordLayer>(CipherSuite::AES_128_GCM_SHA256, clientToServer, serverToClient),
+            config);
+        server = std::make_unique<QuicTransport>(
+            std::make_shared<AeadRecordLayer>(CipherSuite::AES_128_GCM_SHA256, serverToClient, clientToServer),
+            config);
+        connect(*client, kClientPort, kServerPort);
+        connect(*server, kServerPort, kClientPort);
+        client->setReceiveTimeout(std::chrono::milliseconds(3000));
+        server->setReceiveTimeout(std::chrono::milliseconds(3000));
+    }
+
+    static void connect(QuicTransport& transport, uint16_t localPort, uint16_t peerPort) {
+        ConnectionConfig connection;
+        connection.localPort = localPort;
+        ASSERT_TRUE(transport.connect("127.0.0.1:" + std::to_string(peerPort), connection))
+            << transport.getErrorDetails();
+    }
+
+    static std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+        return data;
+    }
+
+    QuicTransportConfig config;
+    std::unique_ptr<QuicTransport> client;
+    std::unique_ptr<QuicTransport> server;
+};
+
+TEST_F(QuicTransportTest, RoundTripKeepsMessageBoundaries) {
+    const std::string hello = "hello";
+    const std::string world = "world!";
+    ASSERT_EQ(client->send(reinterpret_cast<const uint8_t*>(hello.data()), hello.size()), 5);
+    ASSERT_EQ(client->send(reinterpret_cast<const uint8_t*>(world.data()), world.size()), 6);
+
+    PooledBuffer message;
+    ASSERT_EQ(server->receiveFrame(message), 5);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(message.data()), message.size()), hello);
+    ASSERT_EQ(server->receiveFrame(message), 6);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(message.data()), message.size()), world);
+
+    ASSERT_EQ(server->send(reinterpret_cast<const uint8_t*>(hello.data()), hello.size()), 5);
+    uint8_t buffer[3];
+    EXPECT_EQ(client->receive(buffer, sizeof(buffer)), 3);
+    EXPECT_EQ(client->receive(buffer, sizeof(buffer)), 2);
+    EXPECT_EQ(buffer[0], 'l');
+}
+
+TEST_F(QuicTransportTest, LargeMessagesSpanManyPacketsAndWindows) {
+    // Larger than one stream window, so credit has to flow back mid-message
+    const auto data = pattern(3 * config.streamReceiveWindow + 123, 3);
+    std::thread sender([&] { EXPECT_EQ(client->send(data.data(), data.size()), static_cast<ssize_t>(data.size())); });
+    PooledBuffer message;
+    const ssize_t received = server->receiveFrame(message);
+    sender.join();
+    ASSERT_EQ(received, static_cast<ssize_t>(data.size())) << server->getErrorDetails();
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), message.data()));
+
+    const auto stats = client->getStats();
+    EXPECT_GT(stats.packetsSent, data.size() / config.maxPacketSize);
+    EXPECT_GT(stats.smoothedRtt.count(), 0);
+    EXPECT_GT(stats.congestionWindow, 0u);
+}
+
+TEST_F(QuicTransportTest, StreamsAreIndependent) {
+    const auto bulk = pattern(256 * 1024, 9);
+    const ByteSpan bulkPart(bulk.data(), bulk.size());
+    const uint8_t small[] = {42};
+    const ByteSpan smallPart(small, 1);
+    ASSERT_EQ(client->sendOnStream(1, &bulkPart, 1), static_cast<ssize_t>(bulk.size()));
+    ASSERT_EQ(client->sendOnStream(2, &smallPart, 1), 1);
+
+    // Nobody reads stream 1, yet stream 2 still delivers
+    PooledBuffer message;
+    ASSERT_EQ(server->receiveFromStream(2, message), 1);
+    EXPECT_EQ(message.data()[0], 42);
+
+    uint32_t stream = 0;
+    ASSERT_EQ(server->receiveAny(stream, message), static_cast<ssize_t>(bulk.size()));
+    EXPECT_EQ(stream, 1u);
+    EXPECT_TRUE(std::equal(bulk.begin(), bulk.end(), message.data()));
+
+    server->setNonBlocking(true);
+    EXPECT_EQ(server->receiveAny(stream, message), -1);
+    EXPECT_EQ(server->getLastErrorCode(), TransportError::WOULD_BLOCK);
+}
+
+TEST_F(QuicTransportTest, PeerFollowsMigration) {
+    const uint8_t before[] = {1};
+    ASSERT_EQ(client->send(before, 1), 1);
+    PooledBuffer message;
+    ASSERT_EQ(server->receiveFrame(message), 1);
+
+    ASSERT_TRUE(client->migrate(39313)) << client->getErrorDetails();
+    const uint8_t after[] = {2};
+    ASSERT_EQ(client->send(after, 1), 1);
+    ASSERT_EQ(server->receiveFrame(message), 1);
+    EXPECT_EQ(message.data()[0], 2);
+
+    // Replies reach the client once the server has validated the new path
+    for (int i = 0; i < 100 && server->getStats().pathMigrations == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(server->getStats().pathMigrations, 1u);
+    std::string address;
+    uint16_t port = 0;
+    ASSERT_TRUE(server->getPeerAddress(address, port));
+    EXPECT_EQ(port, 39313);
+    ASSERT_EQ(server->send(after, 1), 1);
+    ASSERT_EQ(client->receiveFrame(message), 1);
+    EXPECT_EQ(message.data()[0], 2);
+}
+
+TEST_F(QuicTransportTest, PacketsUnderOtherKeysAreDropped) {
+    QuicTransportConfig strangerConfig;
+    QuicTransport stranger(std::make_shared<AeadRecordLayer>(CipherSuite::AES_128_GCM_SHA256, makeKeys(7),
+                                                             makeKeys(8)),
+                           strangerConfig);
+    connect(stranger, 39314, kServerPort);
+    const uint8_t forged[] = {9, 9, 9};
+    ASSERT_EQ(stranger.send(forged, sizeof(forged)), 3);
+
+    const uint8_t genuine[] = {1, 2};
+    ASSERT_EQ(client->send(genuine, sizeof(genuine)), 2);
+    PooledBuffer message;
+    ASSERT_EQ(server->receiveFrame(message), 2);
+    for (int i = 0; i < 100 && server->getStats().packetsDropped == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(server->getStats().packetsDropped, 0u);
+    EXPECT_EQ(server->getStats().pathMigrations, 0u);
+    stranger.disconnect();
+}
+
+TEST_F(QuicTransportTest, DisconnectClosesThePeer) {
+    EXPECT_TRUE(client->isConnected());
+    client->disconnect();
+    EXPECT_FALSE(client->isConnected());
+    EXPECT_EQ(client->send(reinterpret_cast<const uint8_t*>("x"), 1), -1);
+
+    PooledBuffer message;
+    EXPECT_EQ(server->receiveFrame(message), -1);
+    EXPECT_EQ(server->getLastErrorCode(), TransportError::CONNECTION_CLOSED);
+    EXPECT_EQ(server->getState(), ConnectionState::ERROR);
+
+    // Pre-shared keys are single use
+    EXPECT_FALSE(client->reconnect(1, 0));
+}
+
+} // namespace
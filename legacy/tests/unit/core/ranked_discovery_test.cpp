@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/ranked_discovery.h"
+#include "xenocomm/core/feedback_loop.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
+
+using namespace xenocomm;
+using namespace xenocomm::core;
+
+namespace {
+
+class RankedDiscoveryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        signaler = createInMemoryCapabilitySignaler();
+        for (const char* agent : {"a", "b", "c", "d"}) {
+            signaler->registerCapability(agent, compute);
+        }
+        signaler->registerCapability("other", Capability{"storage", {1, 0, 0}});
+    }
+
+    std::unique_ptr<CapabilitySignaler> signaler;
+    const Capability compute{"compute", {1, 0, 0}};
+};
+
+TEST_F(RankedDiscoveryTest, RanksByReportedLoad) {
+    RankedDiscovery discovery(*signaler);
+    discovery.reportLoad("a", 0.9);
+    discovery.reportLoad("b", 0.1);
+    discovery.reportLoad("c", 0.3);
+
+    auto ranked = discovery.rank({compute});
+    ASSERT_EQ(ranked.size(), 4u);
+    EXPECT_EQ(ranked[0].agentId, "b");
+    EXPECT_EQ(ranked[1].agentId, "c");
+    EXPECT_EQ(ranked[2].agentId, "d");  // Unreported, so assumed half loaded
+    EXPECT_FALSE(ranked[2].loadReported);
+    EXPECT_EQ(ranked[3].agentId, "a");
+
+    auto top = discovery.rank({compute}, false, 2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].agentId, "b");
+    EXPECT_EQ(top[1].agentId, "c");
+
+    // Stale reports stop counting
+    auto config = discovery.getConfig();
+    config.loadTtl = std::chrono::milliseconds(1);
+    discovery.setConfig(config);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    for (const auto& agent : discovery.rank({compute})) {
+        EXPECT_FALSE(agent.loadReported);
+        EXPECT_DOUBLE_EQ(agent.load, config.unknownLoad);
+    }
+    EXPECT_TRUE(discovery.rank({Capability{"missing", {1, 0, 0}}}).empty());
+    EXPECT_FALSE(discovery.choose({Capability{"missing", {1, 0, 0}}}).has_value());
+}
+
+TEST_F(RankedDiscoveryTest, RanksByFeedbackLatency) {
+    FeedbackLoopConfig feedbackConfig;
+    feedbackConfig.enablePersistence = false;
+    FeedbackLoop feedback(feedbackConfig);
+    const std::map<std::string, int> latencyMs{{"a", 2}, {"b", 40}, {"c", 10}};
+    for (const auto& [agent, ms] : latencyMs) {
+        for (int i = 0; i < 5; ++i) {
+            CommunicationOutcome outcome{true, std::chrono::milliseconds(ms), 100, 0, 0, "",
+                                         std::chrono::system_clock::now()};
+            OutcomeLabels labels;
+            labels.peerId = agent;
+            labels.transport = i % 2 ? "udp" : "tcp";
+            ASSERT_TRUE(feedback.reportOutcome(outcome, labels).has_value());
+        }
+    }
+
+    RankedDiscovery discovery(*signaler, &feedback);
+    auto ranked = discovery.rank({compute});
+    ASSERT_EQ(ranked.size(), 4u);
+    EXPECT_EQ(ranked[0].agentId, "a");
+    EXPECT_NEAR(ranked[0].latencyMs, 2.0, 0.01);
+    EXPECT_EQ(ranked[1].agentId, "c");
+    EXPECT_EQ(ranked[2].agentId, "d");  // Unmeasured, so given the mean
+    EXPECT_FALSE(ranked[2].latencyMeasured);
+    EXPECT_EQ(ranked[3].agentId, "b");
+
+    // Load can outweigh latency
+    discovery.reportLoad("a", 5.0);
+    EXPECT_EQ(discovery.rank({compute}).back().agentId, "a");
+}
+
+TEST_F(RankedDiscoveryTest, ChoosesTheBetterOfTwo) {
+    RankedDiscovery discovery(*signaler);
+    discovery.reportLoad("a", 1.0);
+    for (const char* agent : {"b", "c", "d"}) {
+        discovery.reportLoad(agent, 0.2);
+    }
+
+    // The worst agent loses every pairing; the rest share the picks
+    std::map<std::string, int> picks;
+    for (int i = 0; i < 3000; ++i) {
+        auto chosen = discovery.choose({compute});
+        ASSERT_TRUE(chosen.has_value());
+        ++picks[chosen->agentId];
+    }
+    EXPECT_EQ(picks.count("a"), 0u);
+    for (const char* agent : {"b", "c", "d"}) {
+        EXPECT_GT(picks[agent], 700) << agent;
+    }
+
+    // A single match is always the choice
+    signaler->registerCapability("solo", Capability{"gpu", {1, 0, 0}});
+    auto solo = discovery.choose({Capability{"gpu", {1, 0, 0}}});
+    ASSERT_TRUE(solo.has_value());
+    EXPECT_EQ(solo->agentId, "solo");
+}
+
+} // namespace
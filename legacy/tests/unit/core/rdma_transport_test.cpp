@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/rdma_transport.hpp"
+#include "xenocomm/core/shared_memory_transport.hpp"
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+using xenocomm::utils::PooledBuffer;
+
+namespace {
+
+// Both ends in one process, exchanging queue pair details over shared memory
+class RdmaTransportTest : public ::testing::Test {
+protected:
+    static constexpr uint16_t kLeftPort = 39511;
+    static constexpr uint16_t kRightPort = 39512;
+
+    void SetUp() override {
+        leftControl = std::make_shared<SharedMemoryTransport>();
+        rightControl = std::make_shared<SharedMemoryTransport>();
+        config.eagerLimit = 4096;
+        config.receiveDepth = 8;
+        config.sendDepth = 8;
+        left = std::make_unique<RdmaTransport>(leftControl, config);
+        right = std::make_unique<RdmaTransport>(rightControl, config);
+    }
+
+    bool connectPair() {
+        ConnectionConfig leftConfig;
+        leftConfig.localPort = kLeftPort;
+        leftConfig.connectionTimeoutMs = 2000;
+        ConnectionConfig rightConfig = leftConfig;
+        rightConfig.localPort = kRightPort;
+        auto other = std::async(std::launch::async, [&] {
+            return right->connect("127.0.0.1:" + std::to_string(kLeftPort), rightConfig);
+        });
+        const bool connected = left->connect("127.0.0.1:" + std::to_string(kRightPort), leftConfig);
+        return other.get() && connected;
+    }
+
+    RdmaConfig config;
+    std::shared_ptr<SharedMemoryTransport> leftControl;
+    std::shared_ptr<SharedMemoryTransport> rightControl;
+    std::unique_ptr<RdmaTransport> left;
+    std::unique_ptr<RdmaTransport> right;
+};
+
+TEST_F(RdmaTransportTest, ConnectFailsCleanlyWithoutADevice) {
+    if (RdmaTransport::available()) {
+        GTEST_SKIP() << "This host has an RDMA device";
+    }
+    EXPECT_FALSE(connectPair());
+    EXPECT_FALSE(left->isConnected());
+    EXPECT_EQ(left->getLastErrorCode(), TransportError::CONNECTION_FAILED);
+    EXPECT_EQ(left->getState(), ConnectionState::ERROR);
+
+    const uint8_t byte = 1;
+    EXPECT_EQ(left->send(&byte, 1), -1);
+    PooledBuffer message;
+    EXPECT_EQ(left->receiveFrame(message), -1);
+    EXPECT_TRUE(left->disconnect());
+}
+
+TEST_F(RdmaTransportTest, ConnectNeedsAControlTransport) {
+    RdmaTransport orphan(nullptr);
+    EXPECT_FALSE(orphan.connect("127.0.0.1:1", ConnectionConfig{}));
+    EXPECT_EQ(orphan.getLastErrorCode(), TransportError::INVALID_PARAMETER);
+}
+
+TEST_F(RdmaTransportTest, RoundTripKeepsMessageBoundaries) {
+    if (!RdmaTransport::available()) {
+        GTEST_SKIP() << "No RDMA device";
+    }
+    ASSERT_TRUE(connectPair()) << left->getErrorDetails() << " / " << right->getErrorDetails();
+
+    // More messages than receives are posted, so credit has to come back
+    for (int i = 0; i < 50; ++i) {
+        const uint8_t header[] = {static_cast<uint8_t>(i)};
+        const uint8_t body[] = {2, 3};
+        const ByteSpan parts[] = {ByteSpan(header, 1), ByteSpan(body, 2)};
+        ASSERT_EQ(left->sendv(parts, 2), 3);
+        PooledBuffer message;
+        ASSERT_EQ(right->receiveFrame(message), 3);
+        EXPECT_EQ(message.to_vector(), (std::vector<uint8_t>{static_cast<uint8_t>(i), 2, 3}));
+    }
+    right->setNonBlocking(true);
+    PooledBuffer message;
+    EXPECT_EQ(right->receiveFrame(message), -1);
+    EXPECT_EQ(right->getLastErrorCode(), TransportError::WOULD_BLOCK);
+}
+
+TEST_F(RdmaTransportTest, BulkMessagesAreWrittenOneSided) {
+    if (!RdmaTransport::available()) {
+        GTEST_SKIP() << "No RDMA device";
+    }
+    ASSERT_TRUE(connectPair()) << left->getErrorDetails() << " / " << right->getErrorDetails();
+
+    std::vector<uint8_t> first(3 * config.eagerLimit + 17);
+    std::vector<uint8_t> second(5000);
+    for (size_t i = 0; i < first.size(); ++i) {
+        first[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::fill(second.begin(), second.end(), 0xAB);
+    const ByteSpan parts[] = {ByteSpan(first.data(), first.size()), ByteSpan(second.data(), second.size())};
+    const uint8_t small = 9;
+
+    std::thread sender([&] {
+        EXPECT_EQ(left->sendv(parts, 2), static_cast<ssize_t>(first.size() + second.size()));
+        EXPECT_EQ(left->send(&small, 1), 1);
+    });
+    PooledBuffer message;
+    const ssize_t received = right->receiveFrame(message);
+    PooledBuffer after;
+    const ssize_t afterSize = right->receiveFrame(after);
+    sender.join();
+
+    ASSERT_EQ(received, static_cast<ssize_t>(first.size() + second.size()));
+    EXPECT_TRUE(std::equal(first.begin(), first.end(), message.data()));
+    EXPECT_TRUE(std::equal(second.begin(), second.end(), message.data() + first.size()));
+    ASSERT_EQ(afterSize, 1);
+    EXPECT_EQ(after.data()[0], 9);
+}
+
+TEST_F(RdmaTransportTest, DisconnectClosesThePeer) {
+    if (!RdmaTransport::available()) {
+        GTEST_SKIP() << "No RDMA device";
+    }
+    ASSERT_TRUE(connectPair()) << left->getErrorDetails() << " / " << right->getErrorDetails();
+    const uint8_t last = 7;
+    ASSERT_EQ(left->send(&last, 1), 1);
+    left->disconnect();
+    EXPECT_FALSE(left->isConnected());
+
+    PooledBuffer message;
+    ASSERT_EQ(right->receiveFrame(message), 1);
+    EXPECT_EQ(right->receiveFrame(message), -1);
+    EXPECT_EQ(right->getLastErrorCode(), TransportError::CONNECTION_CLOSED);
+}
+
+} // namespace
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/replicated_capability_signaler.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace xenocomm::core;
+
+namespace {
+
+// Two replicas whose deltas are delivered to each other only when flush() is called
+class ReplicatedCapabilitySignalerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        nodeA = std::make_unique<ReplicatedCapabilitySignaler>(
+            "node_a", [this](const std::vector<uint8_t>& delta) { toB.push_back(delta); });
+        nodeB = std::make_unique<ReplicatedCapabilitySignaler>(
+            "node_b", [this](const std::vector<uint8_t>& delta) { toA.push_back(delta); });
+    }
+
+    void flush() {
+        for (const auto& delta : toB) {
+            ASSERT_TRUE(nodeB->applyDelta(delta));
+        }
+        for (const auto& delta : toA) {
+            ASSERT_TRUE(nodeA->applyDelta(delta));
+        }
+        toA.clear();
+        toB.clear();
+    }
+
+    std::vector<std::vector<uint8_t>> toA;
+    std::vector<std::vector<uint8_t>> toB;
+    std::unique_ptr<ReplicatedCapabilitySignaler> nodeA;
+    std::unique_ptr<ReplicatedCapabilitySignaler> nodeB;
+};
+
+TEST_F(ReplicatedCapabilitySignalerTest, RemoteRegistrationsAreDiscoveredLocally) {
+    Capability storage = {"storage", {1, 0, 0}, {{"tier", "hot"}}};
+    ASSERT_TRUE(nodeA->registerCapability("agent_a", storage));
+    ASSERT_EQ(nodeB->registerCapabilities("agent_b", {{"compute", {2, 0, 0}}, storage}), 2u);
+    EXPECT_TRUE(nodeB->discoverAgents({{"storage", {1, 0, 0}}}) == std::vector<std::string>{"agent_b"});
+
+    flush();
+    for (auto* node : {nodeA.get(), nodeB.get()}) {
+        auto agents = node->discoverAgents({storage});
+        std::sort(agents.begin(), agents.end());
+        EXPECT_EQ(agents, (std::vector<std::string>{"agent_a", "agent_b"}));
+        EXPECT_EQ(node->getAgentCapabilities("agent_b").size(), 2u);
+    }
+    EXPECT_EQ(nodeA->digest(), nodeB->digest());
+
+    ASSERT_TRUE(nodeB->unregisterCapability("agent_a", storage));
+    EXPECT_FALSE(nodeB->unregisterCapability("agent_a", storage));
+    flush();
+    EXPECT_TRUE(nodeA->getAgentCapabilities("agent_a").empty());
+    EXPECT_EQ(nodeA->digest(), nodeB->digest());
+}
+
+TEST_F(ReplicatedCapabilitySignalerTest, ConcurrentUpdatesConvergeInAnyOrder) {
+    Capability relay = {"relay", {1, 0, 0}};
+    ASSERT_TRUE(nodeA->registerCapability("agent_x", relay));
+    flush();
+
+    // Both sides change the same element before hearing from each other
+    ASSERT_TRUE(nodeA->unregisterCapability("agent_x", relay));
+    ASSERT_TRUE(nodeB->registerCapability("agent_x", {"relay", {1, 0, 0}, {{"mode", "fast"}}}));
+    auto fromA = toB;
+    auto fromB = toA;
+    flush();
+
+    // Redelivery and reordering change nothing
+    for (const auto& delta : fromB) {
+        ASSERT_TRUE(nodeA->applyDelta(delta));
+    }
+    for (const auto& delta : fromA) {
+        ASSERT_TRUE(nodeA->applyDelta(delta));
+    }
+    EXPECT_EQ(nodeA->digest(), nodeB->digest());
+    EXPECT_EQ(nodeA->getAgentCapabilities("agent_x").size(), nodeB->getAgentCapabilities("agent_x").size());
+}
+
+TEST_F(ReplicatedCapabilitySignalerTest, AntiEntropyRepairsLostDeltas) {
+    for (int i = 0; i < 50; ++i) {
+        nodeA->registerCapability("agent_" + std::to_string(i), {"sensor", {1, 0, 0}});
+    }
+    toB.clear();  // Lost in transit
+
+    ReplicatedCapabilitySignaler late("node_c");
+    EXPECT_TRUE(late.deltaForDigest(late.digest()).empty());
+    EXPECT_TRUE(nodeA->deltaForDigest({1, 2, 3}).empty());
+
+    for (auto* peer : {nodeB.get(), static_cast<ReplicatedCapabilitySignaler*>(&late)}) {
+        auto repair = nodeA->deltaForDigest(peer->digest());
+        ASSERT_FALSE(repair.empty());
+        ASSERT_TRUE(peer->applyDelta(repair));
+        EXPECT_EQ(peer->digest(), nodeA->digest());
+        EXPECT_EQ(peer->discoverAgents({{"sensor", {1, 0, 0}}}).size(), 50u);
+        EXPECT_TRUE(nodeA->deltaForDigest(peer->digest()).empty());
+    }
+
+    std::vector<uint8_t> truncated = nodeA->deltaForDigest(ReplicatedCapabilitySignaler("node_d").digest());
+    truncated.pop_back();
+    EXPECT_FALSE(late.applyDelta(truncated));
+}
+
+} // namespace
@@ -4,7 +4,13 @@
 #include "xenocomm/core/mock_transport.hpp"
 #include "xenocomm/core/security_manager.h"
 #include "xenocomm/core/security_config.hpp"
+#include <openssl/ssl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <thread>
 #include <random>
 
@@ -191,4 +197,87 @@ TEST_F(SecureTransportWrapperTest, DTLSCookieExchangeSucceeds) {
             Return(true)));
     
     ASSERT_NE(wrapper_, nullptr);
-} 
\ No newline at end of file
+} 
+TEST(SecureTransportWrapperKernelTlsTest, TlsEngineTakesOverTheSocket) {
+    auto dir = std::filesystem::temp_directory_path() / "ktls_test";
+    std::filesystem::create_directories(dir);
+    SecureTransportConfig config;  // No expected hostname, so the wrapper is the server
+    config.securityConfig.protocol = EncryptionProtocol::TLS_1_3;
+    config.securityConfig.verifyPeer = false;
+    config.securityConfig.allowSelfSigned = true;
+    config.securityConfig.kernelTls.enabled = true;
+    config.securityConfig.certificatePath = (dir / "server.crt").string();
+    config.securityConfig.privateKeyPath = (dir / "server.key").string();
+
+    // The certificate is written through a manager configured for files not yet there
+    SecurityConfig bootstrap = config.securityConfig;
+    bootstrap.certificatePath.clear();
+    bootstrap.privateKeyPath.clear();
+    SecurityManager generator(bootstrap);
+    generator.updateConfig(config.securityConfig);
+    ASSERT_TRUE(generator.generateSelfSignedCert("localhost").has_value());
+    auto securityManager = std::make_shared<SecurityManager>(config.securityConfig);
+
+    // A loopback TCP connection, as the kernel only offers TLS on TCP sockets
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length), 0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+    int clientFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(::connect(clientFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    int serverFd = ::accept(listener, nullptr, nullptr);
+    ::close(listener);
+    ASSERT_GE(serverFd, 0);
+
+    SSL_CTX* clientContext = SSL_CTX_new(TLS_client_method());
+    SSL* client = SSL_new(clientContext);
+    SSL_set_fd(client, clientFd);
+    std::thread peer([&] { EXPECT_EQ(SSL_connect(client), 1); });
+
+    auto transport = std::make_shared<NiceMock<MockTransport>>();
+    ON_CALL(*transport, getSocketFd()).WillByDefault(Return(serverFd));
+    ON_CALL(*transport, isReliableStream()).WillByDefault(Return(true));
+    std::unique_ptr<SecureTransportWrapper> wrapper;
+    EXPECT_NO_THROW(wrapper = std::make_unique<SecureTransportWrapper>(transport, securityManager, config));
+    peer.join();
+    ASSERT_NE(wrapper, nullptr);
+
+    // Whether or not this kernel takes the records, both ends see the same stream
+    std::vector<uint8_t> message(1000, 0x5A);
+    EXPECT_EQ(wrapper->send(message.data(), message.size()), 1000);
+    std::vector<uint8_t> received(64 * 1024);
+    ASSERT_EQ(SSL_read(client, received.data(), static_cast<int>(received.size())), 1000);
+    EXPECT_TRUE(std::equal(message.begin(), message.end(), received.begin()));
+
+    ASSERT_EQ(SSL_write(client, message.data(), 500), 500);
+    EXPECT_EQ(wrapper->receive(received.data(), received.size()), 500);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    std::vector<uint8_t> contents(100000);
+    for (size_t i = 0; i < contents.size(); ++i) {
+        contents[i] = static_cast<uint8_t>(i * 7);
+    }
+    ASSERT_EQ(std::fwrite(contents.data(), 1, contents.size(), file), contents.size());
+    std::fflush(file);
+    EXPECT_EQ(wrapper->sendFile(fileno(file), 10, 50000), 50000);
+    std::vector<uint8_t> sent;
+    while (sent.size() < 50000) {
+        int n = SSL_read(client, received.data(), static_cast<int>(received.size()));
+        ASSERT_GT(n, 0);
+        sent.insert(sent.end(), received.begin(), received.begin() + n);
+    }
+    EXPECT_TRUE(std::equal(sent.begin(), sent.end(), contents.begin() + 10));
+
+    std::fclose(file);
+    SSL_free(client);
+    SSL_CTX_free(clientContext);
+    ::close(clientFd);  // Before the wrapper's shutdown, which would otherwise wait for the client's
+    wrapper.reset();
+    ::close(serverFd);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/security_event_buffer.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+SecurityEvent makeEvent(SecurityEventType type, const std::string& description) {
+    SecurityEvent event{};
+    event.type = type;
+    event.timestamp = std::chrono::system_clock::now();
+    event.description = description;
+    return event;
+}
+
+TEST(SecurityEventBufferTest, KeepsTheNewestEventsOnceFull) {
+    SecurityEventBuffer buffer(4);
+    for (int i = 0; i < 10; ++i) {
+        buffer.record(makeEvent(i % 3 == 0 ? SecurityEventType::AUTH_FAILURE : SecurityEventType::AUTH_SUCCESS,
+                                std::to_string(i)));
+    }
+
+    auto events = buffer.recent(100);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].description, "9");
+    EXPECT_EQ(events[3].description, "6");
+    EXPECT_EQ(buffer.recent(2).size(), 2u);
+
+    // Failures 0, 3, 6 and 9 were logged; only those still kept come back
+    auto failures = buffer.recent(100, SecurityEventType::AUTH_FAILURE);
+    ASSERT_EQ(failures.size(), 2u);
+    EXPECT_EQ(failures[0].description, "9");
+    EXPECT_EQ(failures[1].description, "6");
+    EXPECT_TRUE(buffer.recent(100, SecurityEventType::KEY_ROTATION).empty());
+
+    EXPECT_EQ(buffer.count(SecurityEventType::AUTH_FAILURE), 4u);
+    EXPECT_EQ(buffer.count(SecurityEventType::AUTH_SUCCESS), 6u);
+    EXPECT_EQ(buffer.total(), 10u);
+}
+
+TEST(SecurityEventBufferTest, ConcurrentWritersAndReaders) {
+    SecurityEventBuffer buffer(64);
+    constexpr int WRITERS = 4;
+    constexpr int EVENTS = 5000;
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        while (!done.load()) {
+            for (const auto& event : buffer.recent(64, SecurityEventType::HANDSHAKE_FAILED)) {
+                ASSERT_EQ(event.type, SecurityEventType::HANDSHAKE_FAILED);
+            }
+            ASSERT_LE(buffer.recent(1000).size(), 64u);
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITERS; ++w) {
+        writers.emplace_back([&, w] {
+            for (int i = 0; i < EVENTS; ++i) {
+                buffer.record(makeEvent(w % 2 ? SecurityEventType::HANDSHAKE_FAILED
+                                              : SecurityEventType::HANDSHAKE_COMPLETE,
+                                        "writer " + std::to_string(w)));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(buffer.total(), static_cast<uint64_t>(WRITERS * EVENTS));
+    EXPECT_EQ(buffer.count(SecurityEventType::HANDSHAKE_FAILED), static_cast<uint64_t>(WRITERS / 2 * EVENTS));
+    EXPECT_EQ(buffer.recent(1000).size(), 64u);
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
@@ -1,5 +1,6 @@
 #include "xenocomm/core/security_manager.h"
 #include <gtest/gtest.h>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <thread>
@@ -220,6 +221,212 @@ TEST_F(SecurityManagerTest, CipherSuiteNegotiation) {
                 serverCipher == CipherSuite::CHACHA20_POLY1305_SHA256);
 }
 
+TEST_F(SecurityManagerTest, PrewarmsAndReusesContexts) {
+    config_.certificatePath.clear();
+    config_.privateKeyPath.clear();
+    config_.trustedCAsPath.clear();
+    config_.connectionPool.minPoolSize = 3;
+    config_.connectionPool.maxPoolSize = 4;
+    SecurityManager manager(config_);
+
+    // Nothing is built until asked for
+    EXPECT_EQ(manager.getConnectionPoolStatus(), std::make_pair(size_t(0), size_t(0)));
+    EXPECT_EQ(manager.prewarmContexts(false, config_.connectionPool.minPoolSize), 3u);
+    EXPECT_EQ(manager.prewarmContexts(true, config_.connectionPool.minPoolSize), 3u);
+    EXPECT_EQ(manager.getConnectionPoolStatus(), std::make_pair(size_t(0), size_t(6)));
+    EXPECT_EQ(manager.prewarmContexts(false, 10), 4u);
+
+    SecureContext* first;
+    {
+        auto context = manager.createContext(false);
+        ASSERT_TRUE(context.has_value()) << context.error();
+        first = context.value().get();
+        EXPECT_FALSE(context.value()->isServerSide());
+        EXPECT_EQ(manager.getConnectionPoolStatus(), std::make_pair(size_t(1), size_t(6)));
+    }
+
+    // Released contexts are reset and handed out again first
+    EXPECT_EQ(manager.getConnectionPoolStatus(), std::make_pair(size_t(0), size_t(7)));
+    auto again = manager.createContext(false);
+    ASSERT_TRUE(again.has_value()) << again.error();
+    EXPECT_EQ(again.value().get(), first);
+
+    // Contexts outliving the manager are simply freed
+    auto survivor = std::make_unique<SecurityManager>(config_)->createContext(true);
+    ASSERT_TRUE(survivor.has_value()) << survivor.error();
+    EXPECT_TRUE(survivor.value()->isServerSide());
+}
+
+TEST_F(SecurityManagerTest, ManagersWithTheSameSettingsShareOneSslContext) {
+    config_.certificatePath.clear();
+    config_.privateKeyPath.clear();
+    config_.trustedCAsPath.clear();
+    const size_t before = SecurityManager::sharedContextCount();
+    {
+        std::vector<std::unique_ptr<SecurityManager>> managers;
+        for (int i = 0; i < 8; ++i) {
+            managers.push_back(std::make_unique<SecurityManager>(config_));
+        }
+        EXPECT_EQ(SecurityManager::sharedContextCount(), before);
+
+        for (auto& manager : managers) {
+            ASSERT_TRUE(manager->createContext(false).has_value());
+        }
+        EXPECT_EQ(SecurityManager::sharedContextCount(), before + 1);
+
+        SecurityConfig other = config_;
+        other.allowedCipherSuites = {CipherSuite::AES_128_GCM_SHA256};
+        SecurityManager different(other);
+        ASSERT_TRUE(different.createContext(true).has_value());
+        EXPECT_EQ(SecurityManager::sharedContextCount(), before + 2);
+
+        // Moving to settings another manager already uses shares its context
+        ASSERT_TRUE(different.updateConfig(config_).has_value());
+        EXPECT_EQ(SecurityManager::sharedContextCount(), before + 1);
+    }
+    EXPECT_EQ(SecurityManager::sharedContextCount(), before);
+}
+
+TEST_F(SecurityManagerTest, DtlsCookiesAreBoundToTheClientAddress) {
+    config_.certificatePath.clear();
+    config_.privateKeyPath.clear();
+    config_.trustedCAsPath.clear();
+    SecurityManager manager(config_);
+
+    NetworkAddress client("192.0.2.10", 4433);
+    auto cookie = manager.generateDtlsCookie(client);
+    ASSERT_TRUE(cookie.has_value()) << cookie.error();
+    ASSERT_EQ(cookie.value().size(), SecurityManager::DTLS_COOKIE_SIZE);
+    EXPECT_TRUE(manager.verifyDtlsCookie(cookie.value(), client).has_value());
+
+    EXPECT_FALSE(manager.verifyDtlsCookie(cookie.value(), NetworkAddress("192.0.2.10", 4434)).has_value());
+    EXPECT_FALSE(manager.verifyDtlsCookie(cookie.value(), NetworkAddress("192.0.2.11", 4433)).has_value());
+    auto forged = cookie.value();
+    forged.back() ^= 0x01;
+    EXPECT_FALSE(manager.verifyDtlsCookie(forged, client).has_value());
+    forged = cookie.value();
+    forged.pop_back();
+    EXPECT_FALSE(manager.verifyDtlsCookie(forged, client).has_value());
+
+    // Addresses are compared as addresses, not as text
+    auto v6 = manager.generateDtlsCookie(NetworkAddress("2001:db8::1", 4433));
+    ASSERT_TRUE(v6.has_value());
+    EXPECT_TRUE(manager.verifyDtlsCookie(v6.value(), NetworkAddress("2001:0db8:0:0::1", 4433)).has_value());
+
+    // Another manager's keys do not vouch for it
+    EXPECT_FALSE(SecurityManager(config_).verifyDtlsCookie(cookie.value(), client).has_value());
+
+    std::vector<std::thread> threads;
+    std::atomic<int> verified{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 200; ++i) {
+                NetworkAddress peer("198.51.100." + std::to_string(t), static_cast<uint16_t>(1000 + i));
+                auto issued = manager.generateDtlsCookie(peer);
+                if (issued.has_value() && manager.verifyDtlsCookie(issued.value(), peer).has_value()) {
+                    ++verified;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(verified.load(), 800);
+}
+
+TEST_F(SecurityManagerTest, DtlsCookiesExpireWithTheNextBucket) {
+    config_.certificatePath.clear();
+    config_.privateKeyPath.clear();
+    config_.trustedCAsPath.clear();
+    config_.cookieLifetime = std::chrono::seconds(1);
+    SecurityManager manager(config_);
+
+    NetworkAddress client("192.0.2.10", 4433);
+    auto cookie = manager.generateDtlsCookie(client);
+    ASSERT_TRUE(cookie.has_value());
+    EXPECT_TRUE(manager.verifyDtlsCookie(cookie.value(), client).has_value());
+
+    // Two bucket boundaries later the key it was made with is gone
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    auto fresh = manager.generateDtlsCookie(client);
+    ASSERT_TRUE(fresh.has_value());
+    EXPECT_FALSE(manager.verifyDtlsCookie(cookie.value(), client).has_value());
+    EXPECT_TRUE(manager.verifyDtlsCookie(fresh.value(), client).has_value());
+
+    // So are all keys once buckets change length
+    auto updated = config_;
+    updated.cookieLifetime = std::chrono::seconds(60);
+    ASSERT_TRUE(manager.updateConfig(updated).has_value());
+    EXPECT_FALSE(manager.verifyDtlsCookie(fresh.value(), client).has_value());
+}
+
+TEST_F(SecurityManagerTest, KeepsRecentEventsAndCountsAll) {
+    config_.certificatePath.clear();
+    config_.privateKeyPath.clear();
+    config_.trustedCAsPath.clear();
+    config_.monitoring.enableAuditLog = false;
+    config_.monitoring.eventBufferSize = 4;
+    SecurityManager manager(config_);
+
+    // Construction and every update log a configuration change
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(manager.updateConfig(config_).has_value());
+    }
+    EXPECT_EQ(manager.getSecurityEventCount(SecurityEventType::CONFIG_CHANGE), 6u);
+    EXPECT_EQ(manager.getSecurityEvents(100).size(), 4u);
+    EXPECT_EQ(manager.getSecurityEvents(100, SecurityEventType::CONFIG_CHANGE).size(), 4u);
+    EXPECT_TRUE(manager.getSecurityEvents(100, SecurityEventType::HANDSHAKE_FAILED).empty());
+
+    // Reconfiguring monitoring starts afresh
+    config_.monitoring.eventBufferSize = 8;
+    ASSERT_TRUE(manager.updateConfig(config_).has_value());
+    EXPECT_EQ(manager.getSecurityEventCount(SecurityEventType::CONFIG_CHANGE), 1u);
+}
+
+TEST(SecurityMetricsTest, AggregatesSlotsFromManyThreads) {
+    SecurityMetrics metrics;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&metrics] {
+            for (int i = 0; i < 1000; ++i) {
+                metrics.recordEncryption(100, std::chrono::microseconds(10));
+                metrics.recordDecryption(50, std::chrono::microseconds(i == 999 ? 5000 : 20));
+            }
+            metrics.recordHandshake(std::chrono::microseconds(2000));
+            metrics.recordAuthAttempt(true);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    metrics.setConnections(3);
+    metrics.setConnections(1);
+
+    auto snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.totalEncryptionOps, 8000u);
+    EXPECT_EQ(snapshot.totalBytesEncrypted, 800000u);
+    EXPECT_EQ(snapshot.totalEncryptionTime, 80000u);
+    EXPECT_EQ(snapshot.totalDecryptionOps, 8000u);
+    EXPECT_EQ(snapshot.totalBytesDecrypted, 400000u);
+    EXPECT_EQ(snapshot.peakDecryptionLatency, 5000u);
+    EXPECT_GE(snapshot.decryptionLatency.p50, 20u);
+    EXPECT_LE(snapshot.decryptionLatency.p50, 22u);
+    EXPECT_GE(snapshot.decryptionLatency.p999, 5000u * 7 / 8);
+    EXPECT_EQ(snapshot.totalHandshakes, 8u);
+    EXPECT_EQ(snapshot.totalHandshakeTime, 16u);
+    EXPECT_EQ(snapshot.handshakeLatency.count, 8u);
+    EXPECT_EQ(snapshot.totalAuthCacheHits, 8u);
+    EXPECT_EQ(snapshot.currentConnections, 1u);
+    EXPECT_EQ(snapshot.peakConnections, 3u);
+
+    metrics.reset();
+    snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.totalEncryptionOps, 0u);
+    EXPECT_EQ(snapshot.encryptionLatency.count, 0u);
+    EXPECT_EQ(snapshot.peakConnections, 3u);
+}
+
 } // namespace
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/session_cache.hpp"
+#include <openssl/ssl.h>
+#include <ctime>
+
+using namespace xenocomm::core;
+
+namespace {
+
+SSL_SESSION* makeSession(int version, long timeout = 3600) {
+    SSL_SESSION* session = SSL_SESSION_new();
+    SSL_SESSION_set_protocol_version(session, version);
+    SSL_SESSION_set_time(session, static_cast<long>(std::time(nullptr)));
+    SSL_SESSION_set_timeout(session, timeout);
+    // Resumable needs a session ID or ticket
+    const unsigned char id[] = {1, 2, 3};
+    SSL_SESSION_set1_id(session, id, sizeof(id));
+    return session;
+}
+
+TEST(SessionCacheTest, Tls13TicketsAreHandedOutOnceNewestFirst) {
+    SessionCache cache(16, std::chrono::seconds(60));
+    SSL_SESSION* first = makeSession(TLS1_3_VERSION);
+    SSL_SESSION* second = makeSession(TLS1_3_VERSION);
+    cache.store("db:443", first);
+    cache.store("db:443", second);
+
+    SSL_SESSION* taken = cache.take("db:443");
+    EXPECT_EQ(taken, second);
+    SSL_SESSION_free(taken);
+    taken = cache.take("db:443");
+    EXPECT_EQ(taken, first);
+    SSL_SESSION_free(taken);
+    EXPECT_EQ(cache.take("db:443"), nullptr);
+    EXPECT_EQ(cache.take("other:443"), nullptr);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.sessions, 0u);
+}
+
+TEST(SessionCacheTest, Tls12SessionsAreReusedUntilRemoved) {
+    SessionCache cache(16, std::chrono::seconds(60));
+    SSL_SESSION* session = makeSession(TLS1_2_VERSION);
+    cache.store("db:443", session);
+
+    for (int i = 0; i < 3; ++i) {
+        SSL_SESSION* taken = cache.take("db:443");
+        EXPECT_EQ(taken, session);
+        SSL_SESSION_free(taken);
+    }
+    cache.remove("db:443");
+    EXPECT_EQ(cache.take("db:443"), nullptr);
+}
+
+TEST(SessionCacheTest, BoundsEvictOldestAndExpired) {
+    SessionCache cache(3, std::chrono::seconds(60));
+    for (int i = 0; i < 3; ++i) {
+        cache.store("a:1", makeSession(TLS1_3_VERSION));
+    }
+    SSL_SESSION* newest = makeSession(TLS1_3_VERSION);
+    cache.store("b:1", newest);
+    EXPECT_EQ(cache.getStats().sessions, 3u);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+
+    for (size_t i = 0; i < SessionCache::MAX_SESSIONS_PER_ENDPOINT + 2; ++i) {
+        cache.store("c:1", makeSession(TLS1_3_VERSION));
+    }
+    cache.configure(100, std::chrono::seconds(60));
+    for (size_t i = 0; i < SessionCache::MAX_SESSIONS_PER_ENDPOINT + 2; ++i) {
+        cache.store("d:1", makeSession(TLS1_3_VERSION));
+    }
+    size_t taken = 0;
+    while (SSL_SESSION* session = cache.take("d:1")) {
+        SSL_SESSION_free(session);
+        ++taken;
+    }
+    EXPECT_EQ(taken, SessionCache::MAX_SESSIONS_PER_ENDPOINT);
+
+    // A session whose own timeout has run out is never offered
+    cache.store("e:1", makeSession(TLS1_2_VERSION, 0));
+    EXPECT_EQ(cache.take("e:1"), nullptr);
+
+    cache.configure(0, std::chrono::seconds(60));
+    EXPECT_EQ(cache.getStats().sessions, 0u);
+}
+
+} // namespace
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/connection_manager.hpp"
+#include "xenocomm/core/mock_transport.hpp"
+#include "xenocomm/core/shared_memory_transport.hpp"
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+using xenocomm::utils::PooledBuffer;
+
+namespace {
+
+// Both ends in one process stand in for two co-located agents
+class SharedMemoryTransportTest : public ::testing::Test {
+protected:
+    void connectPair(SharedMemoryTransport& a, SharedMemoryTransport& b, uint16_t portA, uint16_t portB) {
+        ConnectionConfig configA;
+        configA.localPort = portA;
+        configA.connectionTimeoutMs = 2000;
+        ConnectionConfig configB = configA;
+        configB.localPort = portB;
+        auto other = std::async(std::launch::async, [&] {
+            return b.connect("127.0.0.1:" + std::to_string(portA), configB);
+        });
+        ASSERT_TRUE(a.connect("127.0.0.1:" + std::to_string(portB), configA)) << a.getErrorDetails();
+        ASSERT_TRUE(other.get()) << b.getErrorDetails();
+    }
+};
+
+TEST_F(SharedMemoryTransportTest, RecognizesLocalEndpoints) {
+    EXPECT_TRUE(SharedMemoryTransport::isLocalEndpoint("127.0.0.1:80"));
+    EXPECT_TRUE(SharedMemoryTransport::isLocalEndpoint("localhost:80"));
+    EXPECT_TRUE(SharedMemoryTransport::isLocalEndpoint("[::1]:80"));
+    EXPECT_FALSE(SharedMemoryTransport::isLocalEndpoint("192.0.2.1:80"));
+    EXPECT_FALSE(SharedMemoryTransport::isLocalEndpoint("127.0.0.1"));
+}
+
+TEST_F(SharedMemoryTransportTest, RoundTripKeepsMessageBoundaries) {
+    SharedMemoryTransport a;
+    SharedMemoryTransport b;
+    connectPair(a, b, 39411, 39412);
+
+    const uint8_t header[] = {1, 2};
+    const uint8_t body[] = {3, 4, 5};
+    const ByteSpan parts[] = {ByteSpan(header, 2), ByteSpan(body, 3)};
+    ASSERT_EQ(a.sendv(parts, 2), 5);
+    ASSERT_EQ(a.send(body, 0), 0);
+
+    PooledBuffer message;
+    ASSERT_EQ(b.receiveFrame(message), 5);
+    EXPECT_EQ(message.to_vector(), (std::vector<uint8_t>{1, 2, 3, 4, 5}));
+    ASSERT_EQ(b.receiveFrame(message), 0);
+
+    ASSERT_EQ(b.send(body, 3), 3);
+    uint8_t buffer[2];
+    EXPECT_EQ(a.receive(buffer, sizeof(buffer)), 2);
+    EXPECT_EQ(a.receive(buffer, sizeof(buffer)), 1);
+    EXPECT_EQ(buffer[0], 5);
+
+    b.setNonBlocking(true);
+    EXPECT_EQ(b.receiveFrame(message), -1);
+    EXPECT_EQ(b.getLastErrorCode(), TransportError::WOULD_BLOCK);
+}
+
+TEST_F(SharedMemoryTransportTest, StreamsMoreThanTheRingHolds) {
+    SharedMemoryTransport a(4096);
+    SharedMemoryTransport b(4096);
+    connectPair(a, b, 39413, 39414);
+
+    // Messages wrap around the ring, and the writer blocks until the reader frees space
+    constexpr int kMessages = 500;
+    std::thread writer([&] {
+        std::vector<uint8_t> data(1000);
+        for (int i = 0; i < kMessages; ++i) {
+            std::fill(data.begin(), data.end(), static_cast<uint8_t>(i));
+            ASSERT_EQ(a.send(data.data(), data.size()), 1000);
+        }
+    });
+    PooledBuffer message;
+    for (int i = 0; i < kMessages; ++i) {
+        ASSERT_EQ(b.receiveFrame(message), 1000);
+        EXPECT_EQ(message.data()[0], static_cast<uint8_t>(i));
+        EXPECT_EQ(message.data()[999], static_cast<uint8_t>(i));
+    }
+    writer.join();
+
+    std::vector<uint8_t> tooLarge(4096);
+    EXPECT_EQ(a.send(tooLarge.data(), tooLarge.size()), -1);
+    EXPECT_EQ(a.getLastErrorCode(), TransportError::MESSAGE_TOO_LARGE);
+}
+
+TEST_F(SharedMemoryTransportTest, PeerDisconnectEndsAfterDraining) {
+    SharedMemoryTransport a;
+    SharedMemoryTransport b;
+    connectPair(a, b, 39415, 39416);
+
+    const uint8_t last[] = {7};
+    ASSERT_EQ(a.send(last, 1), 1);
+    a.disconnect();
+    EXPECT_FALSE(a.isConnected());
+
+    PooledBuffer message;
+    ASSERT_EQ(b.receiveFrame(message), 1);
+    EXPECT_EQ(b.receiveFrame(message), -1);
+    EXPECT_EQ(b.getLastErrorCode(), TransportError::CONNECTION_CLOSED);
+    EXPECT_EQ(b.send(last, 1), -1);
+}
+
+TEST_F(SharedMemoryTransportTest, DisconnectWakesBlockedReceive) {
+    SharedMemoryTransport a;
+    SharedMemoryTransport b;
+    connectPair(a, b, 39417, 39418);
+
+    auto receiver = std::async(std::launch::async, [&] {
+        PooledBuffer message;
+        return b.receiveFrame(message);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    b.disconnect();
+    EXPECT_EQ(receiver.get(), -1);
+}
+
+TEST_F(SharedMemoryTransportTest, ConnectionManagerPrefersSharedMemoryForLocalPeers) {
+    ConnectionManager left;
+    ConnectionManager right;
+    ConnectionConfig leftConfig;
+    leftConfig.localPort = 39419;
+    leftConfig.preferSharedMemory = true;
+    ConnectionConfig rightConfig = leftConfig;
+    rightConfig.localPort = 39420;
+
+    // The transports handed in are never connected
+    auto leftFallback = std::make_shared<::testing::StrictMock<MockTransport>>();
+    auto rightFallback = std::make_shared<::testing::StrictMock<MockTransport>>();
+    EXPECT_CALL(*leftFallback, isConnected()).WillRepeatedly(::testing::Return(false));
+    EXPECT_CALL(*rightFallback, isConnected()).WillRepeatedly(::testing::Return(false));
+
+    auto other = std::async(std::launch::async, [&] {
+        return right.establish("peer", "127.0.0.1:39419", rightFallback, rightConfig);
+    });
+    auto connection = left.establish("peer", "127.0.0.1:39420", leftFallback, leftConfig);
+    auto remote = other.get();
+    ASSERT_NE(std::dynamic_pointer_cast<SharedMemoryTransport>(connection->getTransport()), nullptr);
+    ASSERT_NE(std::dynamic_pointer_cast<SharedMemoryTransport>(remote->getTransport()), nullptr);
+
+    const uint8_t byte = 9;
+    const ByteSpan part(&byte, 1);
+    ASSERT_EQ(left.sendv("peer", &part, 1), 1);
+    PooledBuffer message;
+    ASSERT_EQ(right.receiveBuffer("peer", message, 16), 1);
+    EXPECT_EQ(message.data()[0], 9);
+}
+
+} // namespace
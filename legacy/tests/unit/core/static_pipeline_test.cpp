@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/shared_memory_transport.hpp"
+#include "xenocomm/core/static_pipeline.hpp"
+#include <future>
+#include <numeric>
+#include <vector>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+using xenocomm::utils::ErrorCode;
+using xenocomm::utils::PooledBuffer;
+
+namespace {
+
+AeadRecordLayer::DirectionKeys makeKeys(uint8_t seed) {
+    AeadRecordLayer::DirectionKeys keys;
+    keys.key.resize(AeadRecordLayer::keyLength(CipherSuite::AES_128_GCM_SHA256));
+    std::iota(keys.key.begin(), keys.key.end(), seed);
+    std::iota(keys.iv.begin(), keys.iv.end(), static_cast<uint8_t>(seed + 100));
+    return keys;
+}
+
+using PlainPipeline = StaticPipeline<pipeline::MessageFraming, pipeline::NoIntegrity, pipeline::NoEncryption>;
+using CrcPipeline = StaticPipeline<pipeline::MessageFraming, pipeline::Crc32Integrity, pipeline::NoEncryption>;
+
+// Both ends in one process over shared memory, which keeps message boundaries
+class StaticPipelineTest : public ::testing::Test {
+protected:
+    void connectPair(uint16_t portA, uint16_t portB) {
+        ConnectionConfig configA;
+        configA.localPort = portA;
+        configA.connectionTimeoutMs = 2000;
+        ConnectionConfig configB = configA;
+        configB.localPort = portB;
+        auto other = std::async(std::launch::async, [&] {
+            return b.connect("127.0.0.1:" + std::to_string(portA), configB);
+        });
+        ASSERT_TRUE(a.connect("127.0.0.1:" + std::to_string(portB), configA)) << a.getErrorDetails();
+        ASSERT_TRUE(other.get()) << b.getErrorDetails();
+    }
+
+    SharedMemoryTransport a;
+    SharedMemoryTransport b;
+};
+
+TEST_F(StaticPipelineTest, DisabledStagesAddNothingToTheFrame) {
+    static_assert(PlainPipeline::FLAGS == 0 && PlainPipeline::OVERHEAD == 1);
+    static_assert(CrcAeadPipeline::OVERHEAD == 1 + AeadRecordLayer::TAG_SIZE + 4);
+    connectPair(39611, 39612);
+
+    PlainPipeline sender(a);
+    const std::vector<uint8_t> message{1, 2, 3};
+    ASSERT_FALSE(sender.send(ByteSpan(message)).has_error());
+
+    PooledBuffer frame;
+    ASSERT_EQ(b.receiveFrame(frame), 4);
+    EXPECT_EQ(frame.to_vector(), (std::vector<uint8_t>{0, 1, 2, 3}));
+}
+
+TEST_F(StaticPipelineTest, CrcAeadRoundTrip) {
+    connectPair(39613, 39614);
+    const auto aToB = makeKeys(1);
+    const auto bToA = makeKeys(50);
+    CrcAeadPipeline sender(a, pipeline::AeadEncryption(
+        std::make_shared<AeadRecordLayer>(CipherSuite::AES_128_GCM_SHA256, aToB, bToA)));
+    CrcAeadPipeline receiver(b, pipeline::AeadEncryption(
+        std::make_shared<AeadRecordLayer>(CipherSuite::AES_128_GCM_SHA256, bToA, aToB)));
+
+    // Each message takes the next sequence number on both ends
+    for (uint8_t i = 0; i < 3; ++i) {
+        std::vector<uint8_t> message(100 + i);
+        std::iota(message.begin(), message.end(), i);
+        ASSERT_FALSE(sender.send(ByteSpan(message)).has_error());
+        auto received = receiver.receive();
+        ASSERT_TRUE(received.has_value()) << received.error();
+        EXPECT_EQ(received.value(), message);
+    }
+    EXPECT_EQ(sender.messages_sent(), 3u);
+    EXPECT_EQ(receiver.messages_received(), 3u);
+}
+
+TEST_F(StaticPipelineTest, RejectsCorruptAndMismatchedFrames) {
+    connectPair(39615, 39616);
+    CrcPipeline sender(a);
+    CrcPipeline receiver(b);
+    const std::vector<uint8_t> message{9, 8, 7, 6};
+    ASSERT_FALSE(sender.send(ByteSpan(message)).has_error());
+    PooledBuffer frame;
+    ASSERT_EQ(b.receiveFrame(frame), static_cast<ssize_t>(CrcPipeline::OVERHEAD + message.size()));
+
+    // The same frame with one payload bit flipped
+    std::vector<uint8_t> corrupt = frame.to_vector();
+    corrupt[2] ^= 0x10;
+    const ByteSpan corruptPart(corrupt);
+    ASSERT_GE(a.sendFrame(&corruptPart, 1), 0);
+    EXPECT_EQ(receiver.receive().error_code(), ErrorCode::ErrorCheckMismatch);
+
+    // A plain frame reaching a checked pipeline
+    PlainPipeline plain(a);
+    ASSERT_FALSE(plain.send(ByteSpan(message)).has_error());
+    auto mismatched = receiver.receive();
+    ASSERT_TRUE(mismatched.has_error());
+    EXPECT_EQ(mismatched.error(), "Frame flags do not match the pipeline");
+}
+
+} // namespace
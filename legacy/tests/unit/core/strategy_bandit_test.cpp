@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/strategy_adapter.h"
+#include <map>
+#include <random>
+
+using namespace xenocomm;
+
+namespace {
+
+CommunicationOutcome outcome(bool success, std::chrono::microseconds latency = std::chrono::microseconds(100)) {
+    CommunicationOutcome result{};
+    result.success = success;
+    result.latency = latency;
+    result.timestamp = std::chrono::system_clock::now();
+    return result;
+}
+
+// Plays rounds against strategies that succeed with fixed probabilities; returns how often
+// each was selected in the last tail rounds
+std::map<std::string, int> play(StrategyAdapter& adapter, const std::map<std::string, double>& successRates,
+                                int rounds, int tail, uint64_t seed) {
+    std::mt19937_64 environment(seed);
+    std::map<std::string, int> selections;
+    for (int round = 0; round < rounds; ++round) {
+        auto strategy = adapter.selectStrategy();
+        EXPECT_TRUE(strategy.has_value());
+        bool success = std::bernoulli_distribution(successRates.at(*strategy))(environment);
+        EXPECT_TRUE(adapter.recordBanditOutcome(*strategy, outcome(success)).has_value());
+        if (round >= rounds - tail) {
+            ++selections[*strategy];
+        }
+    }
+    return selections;
+}
+
+const std::map<std::string, double> RATES{{"compact", 0.3}, {"balanced", 0.5}, {"robust", 0.8}};
+
+} // namespace
+
+TEST(StrategyBanditTest, ThompsonSamplingConvergesOnTheBestStrategy) {
+    StrategyAdapter adapter(nullptr);
+    ASSERT_TRUE(adapter.startBandit({"compact", "balanced", "robust"}, BanditPolicy::THOMPSON_SAMPLING, 7)
+                    .has_value());
+
+    auto selections = play(adapter, RATES, 2000, 500, 11);
+    EXPECT_GT(selections["robust"], 450);
+
+    // Every strategy was still tried, the winner far more than the others
+    auto stats = adapter.getBanditStats();
+    ASSERT_TRUE(stats.has_value());
+    std::map<std::string, BanditArmStats> arms;
+    for (const auto& arm : stats.value()) {
+        EXPECT_GT(arm.outcomes, 0u);
+        arms[arm.strategy] = arm;
+    }
+    EXPECT_GT(arms["robust"].outcomes, arms["balanced"].outcomes + arms["compact"].outcomes);
+    EXPECT_NEAR(arms["robust"].expectedSuccessRate, 0.8, 0.05);
+}
+
+TEST(StrategyBanditTest, Ucb1TriesEachStrategyOnceThenConverges) {
+    StrategyAdapter adapter(nullptr);
+    ASSERT_TRUE(adapter.startBandit({"compact", "balanced", "robust"}, BanditPolicy::UCB1).has_value());
+
+    for (const char* expected : {"compact", "balanced", "robust"}) {
+        auto strategy = adapter.selectStrategy();
+        ASSERT_TRUE(strategy.has_value());
+        EXPECT_EQ(*strategy, expected);
+        ASSERT_TRUE(adapter.recordBanditOutcome(*strategy, outcome(true)).has_value());
+    }
+
+    auto selections = play(adapter, RATES, 3000, 500, 11);
+    EXPECT_GT(selections["robust"], 400);
+}
+
+TEST(StrategyBanditTest, SameSeedSelectsTheSameSequence) {
+    auto sequence = [](uint64_t seed) {
+        StrategyAdapter adapter(nullptr);
+        EXPECT_TRUE(adapter.startBandit({"compact", "balanced", "robust"}, BanditPolicy::THOMPSON_SAMPLING, seed)
+                        .has_value());
+        std::vector<std::string> selected;
+        for (int i = 0; i < 100; ++i) {
+            auto strategy = adapter.selectStrategy();
+            selected.push_back(*strategy);
+            adapter.recordBanditOutcome(*strategy, outcome(*strategy == "balanced"));
+        }
+        return selected;
+    };
+    EXPECT_EQ(sequence(3), sequence(3));
+    EXPECT_NE(sequence(3), sequence(4));
+}
+
+TEST(StrategyBanditTest, OutcomesUpdateThePosterior) {
+    StrategyAdapter adapter(nullptr);
+    EXPECT_FALSE(adapter.selectStrategy().has_value());
+    EXPECT_FALSE(adapter.recordBanditOutcome("robust", outcome(true)).has_value());
+    EXPECT_FALSE(adapter.getBanditStats().has_value());
+
+    ASSERT_TRUE(adapter.startBandit({"compact", "robust"}).has_value());
+    ASSERT_TRUE(adapter.recordBanditOutcome("robust", outcome(true, std::chrono::microseconds(100))).has_value());
+    ASSERT_TRUE(adapter.recordBanditOutcome("robust", outcome(true, std::chrono::microseconds(300))).has_value());
+    ASSERT_TRUE(adapter.recordBanditOutcome("robust", outcome(false, std::chrono::microseconds(200))).has_value());
+    ASSERT_TRUE(adapter.recordBanditOutcome("compact", outcome(false)).has_value());
+    EXPECT_FALSE(adapter.recordBanditOutcome("unknown", outcome(true)).has_value());
+
+    auto stats = adapter.getBanditStats();
+    ASSERT_TRUE(stats.has_value());
+    ASSERT_EQ(stats.value().size(), 2u);
+    const auto& compact = stats.value()[0];
+    const auto& robust = stats.value()[1];
+    EXPECT_EQ(robust.outcomes, 3u);
+    EXPECT_EQ(robust.successes, 2u);
+    EXPECT_DOUBLE_EQ(robust.meanLatencyUs, 200.0);
+    EXPECT_DOUBLE_EQ(robust.expectedSuccessRate, 3.0 / 5.0);  // Beta(1 + 2, 1 + 1)
+    EXPECT_EQ(compact.outcomes, 1u);
+    EXPECT_DOUBLE_EQ(compact.expectedSuccessRate, 1.0 / 3.0);
+
+    // Restarting forgets what was learned
+    ASSERT_TRUE(adapter.startBandit({"compact", "robust"}).has_value());
+    stats = adapter.getBanditStats();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats.value()[1].outcomes, 0u);
+    EXPECT_DOUBLE_EQ(stats.value()[1].expectedSuccessRate, 0.5);
+
+    EXPECT_FALSE(adapter.startBandit({}).has_value());
+    EXPECT_FALSE(adapter.startBandit({"robust", "robust"}).has_value());
+}
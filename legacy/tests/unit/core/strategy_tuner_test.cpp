@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/strategy_adapter.h"
+#include "xenocomm/core/strategy_tuner.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+using namespace xenocomm;
+using namespace xenocomm::core;
+
+namespace {
+
+std::vector<TunerParameter> smallGrid() {
+    return {
+        {"fragmentSize", {512, 1024, 2048, 4096, 8192}, 1},
+        {"windowSize", {8, 16, 32}, 1},
+    };
+}
+
+// Goodput peaks at 4096-byte fragments; the window makes no difference
+double goodput(const TunedValues& values) {
+    static const std::map<double, double> shape{
+        {512, 0.5}, {1024, 0.7}, {2048, 0.85}, {4096, 1.0}, {8192, 0.9}};
+    return 1e6 * shape.at(values.at("fragmentSize"));
+}
+
+void run(StrategyTuner& tuner, const std::string& linkClass, int trials) {
+    for (int i = 0; i < trials; ++i) {
+        auto trial = tuner.propose(linkClass);
+        tuner.record(trial, goodput(trial.values), 10.0);
+    }
+}
+
+std::string temporaryPath() {
+    return (std::filesystem::temp_directory_path() /
+            ("strategy_tuner_test_" + std::to_string(::getpid()))).string();
+}
+
+} // namespace
+
+TEST(StrategyTunerTest, StartsAtDefaultsWithinBounds) {
+    StrategyTuner tuner;
+    auto values = tuner.best("lan");
+    EXPECT_EQ(values.at("fragmentSize"), 1024);
+    EXPECT_EQ(values.at("windowSize"), 16);
+    EXPECT_FALSE(tuner.learned("lan").has_value());
+
+    // Every proposal stays on the grid, one step at most from the incumbent
+    for (int i = 0; i < 200; ++i) {
+        auto trial = tuner.propose("lan");
+        for (const auto& parameter : StrategyTuner::defaultParameters()) {
+            double value = trial.values.at(parameter.name);
+            EXPECT_NE(std::find(parameter.values.begin(), parameter.values.end(), value), parameter.values.end());
+        }
+        tuner.record(trial, 1e6, 10.0);
+    }
+    EXPECT_TRUE(tuner.learned("lan").has_value());
+}
+
+TEST(StrategyTunerTest, ClimbsToTheBestValuePerLinkClass) {
+    StrategyTuner tuner(StrategyTunerConfig(), smallGrid());
+    run(tuner, "wan", 600);
+
+    auto best = tuner.best("wan");
+    EXPECT_EQ(best.at("fragmentSize"), 4096);
+    EXPECT_EQ(best.at("windowSize"), 16);  // Equal scores are never adopted
+    EXPECT_EQ(tuner.stats("wan").adoptions, 2u);
+
+    // Other classes learn separately
+    EXPECT_EQ(tuner.best("lan").at("fragmentSize"), 1024);
+}
+
+TEST(StrategyTunerTest, AbandonsUnsafeMovesAfterOneTrial) {
+    StrategyTunerConfig config;
+    config.safetyFloor = 0.9;  // 512-byte fragments lose 29% of the incumbent's goodput
+    StrategyTuner tuner(config, {{"fragmentSize", {512, 1024}, 1}});
+
+    int unsafe = 0;
+    for (int i = 0; i < 300; ++i) {
+        auto trial = tuner.propose("lossy");
+        unsafe += trial.values.at("fragmentSize") == 512 ? 1 : 0;
+        tuner.record(trial, goodput(trial.values), 10.0);
+    }
+    EXPECT_EQ(unsafe, 1);
+    EXPECT_EQ(tuner.best("lossy").at("fragmentSize"), 1024);
+}
+
+TEST(StrategyTunerTest, PersistsAdoptedConfigurations) {
+    const std::string path = temporaryPath();
+    StrategyTunerConfig config;
+    config.persistencePath = path;
+    {
+        StrategyTuner tuner(config, smallGrid());
+        run(tuner, "wan", 600);
+        ASSERT_EQ(tuner.best("wan").at("fragmentSize"), 4096);
+    }
+
+    StrategyTuner restarted(config, smallGrid());
+    auto learned = restarted.learned("wan");
+    ASSERT_TRUE(learned.has_value());
+    EXPECT_EQ(learned->at("fragmentSize"), 4096);
+    EXPECT_FALSE(restarted.learned("lan").has_value());
+
+    // Values read back snap onto the grid
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "# xenocomm strategy tuner v1\nwan\tfragmentSize=1000000\twindowSize=9\tunknown=1\n";
+    }
+    StrategyTuner edited(config, smallGrid());
+    EXPECT_EQ(edited.best("wan").at("fragmentSize"), 8192);
+    EXPECT_EQ(edited.best("wan").at("windowSize"), 8);
+    std::filesystem::remove(path);
+}
+
+TEST(StrategyTunerTest, RejectsInvalidParameters) {
+    EXPECT_THROW(StrategyTuner(StrategyTunerConfig(), {{"x", {}, 0}}), std::invalid_argument);
+    EXPECT_THROW(StrategyTuner(StrategyTunerConfig(), {{"x", {2, 1}, 0}}), std::invalid_argument);
+    EXPECT_THROW(StrategyTuner(StrategyTunerConfig(), {{"x", {1}, 1}}), std::invalid_argument);
+    EXPECT_THROW(StrategyTuner(StrategyTunerConfig(), {{"x", {1}, 0}, {"x", {1}, 0}}), std::invalid_argument);
+}
+
+TEST(StrategyTunerTest, AppliesTunedValuesWithinEachConfig) {
+    TunedValues tuned{{"fragmentSize", 4096}, {"timeoutMs", 2000}, {"initialWindowBytes", 1 << 24},
+                      {"pacingGain", 1.5}, {"batchMaxDelayMs", 10}, {"recordInitialSize", 65536}};
+
+    StrategyConfig strategy;
+    applyTuned(tuned, strategy);
+    EXPECT_EQ(strategy.fragmentSize, 4096u);
+    EXPECT_EQ(strategy.timeout, std::chrono::milliseconds(2000));
+    EXPECT_EQ(strategy.windowSize, 16u);  // Not tuned, left alone
+
+    TransmissionManager::FragmentConfig fragment;
+    TransmissionManager::FlowControlConfig flow;
+    applyTuned(tuned, fragment, flow);
+    EXPECT_EQ(fragment.max_fragment_size, 4096u);
+    EXPECT_EQ(flow.initial_window_size, flow.max_window_size);
+    EXPECT_DOUBLE_EQ(flow.pacing_gain, 1.5);
+
+    RecordBatchingConfig batching;
+    AdaptiveRecordConfig records;
+    applyTuned(tuned, batching, records);
+    EXPECT_EQ(batching.maxDelay, std::chrono::milliseconds(10));
+    EXPECT_EQ(records.initialSize, records.maxSize);
+}
@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/connection_manager.hpp"
+#include "xenocomm/core/stream_multiplexer.hpp"
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <numeric>
+#include <thread>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+using xenocomm::utils::PooledBuffer;
+
+namespace {
+
+// One end of a connected socketpair, standing in for a TCP connection
+class SocketPairTransport : public TransportProtocol {
+public:
+    explicit SocketPairTransport(int fd) : fd_(fd) {}
+    ~SocketPairTransport() override { ::close(fd_); }
+
+    bool connect(const std::string&, const ConnectionConfig&) override { return isConnected(); }
+    // Shuts the socket down but keeps the descriptor, so a blocked reader wakes up safely
+    bool disconnect() override {
+        if (connected_.exchange(false)) {
+            ::shutdown(fd_, SHUT_RDWR);
+        }
+        return true;
+    }
+    bool isConnected() const override { return connected_; }
+    bool isReliableStream() const override { return true; }
+
+    ssize_t send(const uint8_t* data, size_t size) override {
+        size_t sent = 0;
+        while (sent < size) {
+            ssize_t n = ::send(fd_, data + sent, size - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        bytesSent += size;
+        return static_cast<ssize_t>(size);
+    }
+    ssize_t receive(uint8_t* buffer, size_t size) override {
+        ssize_t n = ::recv(fd_, buffer, size, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return 0;
+        }
+        return n == 0 ? -1 : n;
+    }
+
+    bool getPeerAddress(std::string& address, uint16_t& port) override {
+        address = "socketpair";
+        port = 0;
+        return true;
+    }
+    int getSocketFd() const override { return fd_; }
+    bool setNonBlocking(bool) override { return true; }
+    bool setReceiveTimeout(const std::chrono::milliseconds& timeout) override {
+        timeval tv{static_cast<time_t>(timeout.count() / 1000), static_cast<suseconds_t>(timeout.count() % 1000 * 1000)};
+        return ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+    }
+    bool setSendTimeout(const std::chrono::milliseconds&) override { return true; }
+    bool setKeepAlive(bool) override { return true; }
+    bool setTcpNoDelay(bool) override { return true; }
+    bool setReuseAddress(bool) override { return true; }
+    bool setReceiveBufferSize(size_t) override { return true; }
+    bool setSendBufferSize(size_t) override { return true; }
+    std::string getLastError() const override { return "socket error"; }
+    bool setLocalPort(uint16_t) override { return false; }
+    ConnectionState getState() const override {
+        return isConnected() ? ConnectionState::CONNECTED : ConnectionState::DISCONNECTED;
+    }
+    TransportError getLastErrorCode() const override { return TransportError::NONE; }
+    std::string getErrorDetails() const override { return "socket error"; }
+    bool reconnect(uint32_t, uint32_t) override { return false; }
+    void setStateCallback(std::function<void(ConnectionState)>) override {}
+    void setErrorCallback(std::function<void(TransportError, const std::string&)>) override {}
+    bool checkHealth() override { return isConnected(); }
+
+    std::atomic<size_t> bytesSent{0};
+
+private:
+    const int fd_;
+    std::atomic<bool> connected_{true};
+};
+
+std::pair<std::shared_ptr<SocketPairTransport>, std::shared_ptr<SocketPairTransport>> makePair() {
+    int fds[2];
+    EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    return {std::make_shared<SocketPairTransport>(fds[0]), std::make_shared<SocketPairTransport>(fds[1])};
+}
+
+std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    std::iota(data.begin(), data.end(), seed);
+    return data;
+}
+
+} // namespace
+
+class StreamMultiplexerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto [a, b] = makePair();
+        left_ = a;
+        right_ = b;
+        MultiplexerConfig config;
+        config.pollIntervalMs = 20;
+        initiator_ = StreamMultiplexer::create(left_, StreamMultiplexer::Role::Initiator, config);
+        acceptor_ = StreamMultiplexer::create(right_, StreamMultiplexer::Role::Acceptor, config);
+    }
+
+    std::shared_ptr<SocketPairTransport> left_;
+    std::shared_ptr<SocketPairTransport> right_;
+    std::shared_ptr<StreamMultiplexer> initiator_;
+    std::shared_ptr<StreamMultiplexer> acceptor_;
+};
+
+TEST_F(StreamMultiplexerTest, CarriesMessagesBothWays) {
+    auto stream = initiator_->openStream();
+    ASSERT_TRUE(stream);
+    EXPECT_EQ(stream->getStreamId() % 2, 1u);
+
+    auto hello = pattern(100, 1);
+    ASSERT_EQ(stream->send(hello.data(), hello.size()), 100);
+    auto accepted = acceptor_->acceptStream(std::chrono::seconds(2));
+    ASSERT_TRUE(accepted);
+    EXPECT_EQ(accepted->getStreamId(), stream->getStreamId());
+
+    PooledBuffer message;
+    ASSERT_EQ(accepted->receiveFrame(message), 100);
+    EXPECT_EQ(message.to_vector(), hello);
+
+    // Message boundaries survive, large messages are reassembled and gathered sends are one message
+    auto big = pattern(200 * 1024, 7);
+    const ByteSpan parts[] = {ByteSpan(big.data(), 1000), ByteSpan(big.data() + 1000, big.size() - 1000)};
+    ASSERT_EQ(accepted->sendv(parts, 2), static_cast<ssize_t>(big.size()));
+    ASSERT_EQ(accepted->send(hello.data(), 10), 10);
+    ASSERT_EQ(stream->receiveFrame(message), static_cast<ssize_t>(big.size()));
+    EXPECT_EQ(message.to_vector(), big);
+    ASSERT_EQ(stream->receiveFrame(message), 10);
+
+    // Streams the acceptor opens are even
+    auto reverse = acceptor_->openStream();
+    ASSERT_TRUE(reverse);
+    EXPECT_EQ(reverse->getStreamId() % 2, 0u);
+}
+
+TEST_F(StreamMultiplexerTest, SmallMessagesOvertakeBulkTransfers) {
+    auto bulk = initiator_->openStream();
+    auto chat = initiator_->openStream();
+    const auto payload = pattern(4 * 1024 * 1024, 3);
+
+    // Prime both streams on the acceptor so they can be told apart
+    ASSERT_EQ(bulk->send(payload.data(), 1), 1);
+    ASSERT_EQ(chat->send(payload.data(), 1), 1);
+    auto bulkIn = acceptor_->acceptStream(std::chrono::seconds(2));
+    auto chatIn = acceptor_->acceptStream(std::chrono::seconds(2));
+    ASSERT_TRUE(bulkIn && chatIn);
+    PooledBuffer message;
+    ASSERT_EQ(bulkIn->receiveFrame(message), 1);
+    ASSERT_EQ(chatIn->receiveFrame(message), 1);
+
+    std::atomic<bool> bulkDone{false};
+    std::thread sender([&] {
+        for (int i = 0; i < 4; ++i) {
+            bulk->send(payload.data(), payload.size());
+        }
+        bulkDone = true;
+    });
+    std::atomic<bool> drained{false};
+    std::thread reader([&] {
+        PooledBuffer chunk;
+        for (int i = 0; i < 4; ++i) {
+            bulkIn->receiveFrame(chunk);
+        }
+        drained = true;
+    });
+
+    // While 16MB is queued on one stream, a short request on another goes straight through
+    while (left_->bytesSent < 512 * 1024) {
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(chat->send(payload.data(), 32), 32);
+    ASSERT_EQ(chatIn->receiveFrame(message), 32);
+    EXPECT_FALSE(bulkDone.load());
+
+    sender.join();
+    reader.join();
+    EXPECT_TRUE(drained.load());
+}
+
+TEST_F(StreamMultiplexerTest, SlowReaderOnlyStallsItsOwnStream) {
+    auto slow = initiator_->openStream();
+    auto fast = initiator_->openStream();
+    const auto window = initiator_->getConfig().initialStreamWindow;
+    auto payload = pattern(4096, 9);
+    const size_t messages = window / payload.size();
+
+    // Fill the slow stream's window with messages nobody reads
+    for (size_t i = 0; i < messages; ++i) {
+        ASSERT_EQ(slow->send(payload.data(), payload.size()), 4096);
+    }
+    slow->setSendTimeout(std::chrono::milliseconds(100));
+    EXPECT_EQ(slow->send(payload.data(), 1000), -1);
+    EXPECT_EQ(slow->getLastErrorCode(), TransportError::TIMEOUT);
+
+    ASSERT_EQ(fast->send(payload.data(), 64), 64);
+    auto first = acceptor_->acceptStream(std::chrono::seconds(2));
+    auto second = acceptor_->acceptStream(std::chrono::seconds(2));
+    ASSERT_TRUE(first && second);
+    PooledBuffer message;
+    ASSERT_EQ(second->receiveFrame(message), 64);
+
+    // Reading the slow stream returns credit and the sender can carry on
+    for (size_t i = 0; i < messages; ++i) {
+        ASSERT_EQ(first->receiveFrame(message), 4096);
+    }
+    slow->setSendTimeout(std::chrono::milliseconds(0));
+    ASSERT_EQ(slow->send(payload.data(), 1000), 1000);
+    ASSERT_EQ(first->receiveFrame(message), 1000);
+}
+
+TEST_F(StreamMultiplexerTest, ClosingAStreamResetsItOnThePeer) {
+    auto stream = initiator_->openStream();
+    ASSERT_EQ(stream->send(reinterpret_cast<const uint8_t*>("x"), 1), 1);
+    auto accepted = acceptor_->acceptStream(std::chrono::seconds(2));
+    ASSERT_TRUE(accepted);
+    EXPECT_EQ(acceptor_->streamCount(), 1u);
+
+    stream.reset();
+    PooledBuffer message;
+    ASSERT_EQ(accepted->receiveFrame(message), 1);  // Already delivered data is still readable
+    EXPECT_EQ(accepted->receiveFrame(message), -1);
+    EXPECT_EQ(accepted->getLastErrorCode(), TransportError::CONNECTION_CLOSED);
+    EXPECT_FALSE(accepted->isConnected());
+    EXPECT_EQ(accepted->send(message.data(), 0), -1);
+    EXPECT_EQ(acceptor_->streamCount(), 0u);
+    EXPECT_EQ(initiator_->streamCount(), 0u);
+}
+
+TEST_F(StreamMultiplexerTest, ConnectionFailureClosesEveryStream) {
+    auto stream = initiator_->openStream();
+    std::thread waiter([&] {
+        PooledBuffer message;
+        EXPECT_EQ(stream->receiveFrame(message), -1);
+    });
+    right_->disconnect();
+    waiter.join();
+    EXPECT_FALSE(stream->isConnected());
+    EXPECT_FALSE(initiator_->isRunning());
+    EXPECT_FALSE(initiator_->getErrorDetails().empty());
+    EXPECT_EQ(initiator_->openStream(), nullptr);
+}
+
+TEST(ConnectionManagerStreams, StreamsAreConnectionsOfTheirOwn) {
+    auto [a, b] = makePair();
+    ConnectionManager client;
+    ConnectionManager server;
+    client.establish("link", "", a);
+    server.establish("link", "", b);
+
+    EXPECT_THROW(client.openStream("link", "s1"), ConnectionError);
+    client.multiplex("link", StreamMultiplexer::Role::Initiator);
+    server.multiplex("link", StreamMultiplexer::Role::Acceptor);
+    EXPECT_THROW(client.multiplex("link", StreamMultiplexer::Role::Initiator), ConnectionError);
+
+    auto stream = client.openStream("link", "s1");
+    EXPECT_EQ(client.checkStatus("s1"), ConnectionStatus::Connected);
+    EXPECT_THROW(client.openStream("link", "s1"), ConnectionError);
+
+    const uint8_t ping[] = {1, 2, 3};
+    const ByteSpan part(ping, sizeof(ping));
+    ASSERT_EQ(client.sendv("s1", &part, 1), 3);
+    auto accepted = server.acceptStream("link", "peer-s1", std::chrono::seconds(2));
+    ASSERT_TRUE(accepted);
+    PooledBuffer message;
+    ASSERT_EQ(server.receiveBuffer("peer-s1", message, 64), 3);
+    EXPECT_EQ(server.acceptStream("link", "none", std::chrono::milliseconds(10)), nullptr);
+
+    EXPECT_TRUE(client.close("link"));
+    EXPECT_EQ(client.checkStatus("s1"), ConnectionStatus::Disconnected);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/streaming_transcoder.h"
+#include "xenocomm/core/data_adapters.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace xenocomm::core;
+using xenocomm::utils::ByteSpan;
+
+namespace {
+
+std::vector<float> ramp(size_t count) {
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.01f) * 8.0f;
+    }
+    return values;
+}
+
+ByteSpan bytesOf(const std::vector<float>& values) {
+    return ByteSpan(reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(float));
+}
+
+std::vector<std::vector<uint8_t>> drain(StreamingEncoder& encoder) {
+    std::vector<std::vector<uint8_t>> chunks;
+    std::vector<uint8_t> chunk;
+    while (encoder.pull(chunk)) {
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+} // namespace
+
+TEST(StreamingTranscoderTest, ChunksDecodeToWholePayloadEncoding) {
+    VectorFloat16Adapter adapter;
+    auto values = ramp(1001);
+    ByteSpan input = bytesOf(values);
+
+    // Push in uneven pieces so chunk boundaries fall inside them
+    StreamingEncoder encoder(adapter, DataFormat::VECTOR_FLOAT32, DataFormat::VECTOR_FLOAT16, 256);
+    for (size_t offset = 0; offset < input.size(); offset += 300) {
+        encoder.push(input.subspan(offset, std::min<size_t>(300, input.size() - offset)));
+    }
+    encoder.finish();
+    auto chunks = drain(encoder);
+    EXPECT_TRUE(encoder.finished());
+    ASSERT_EQ(chunks.size(), (input.size() + 255) / 256);
+
+    StreamingDecoder decoder(adapter);
+    std::vector<uint8_t> decoded;
+    for (const auto& chunk : chunks) {
+        decoder.push(chunk);
+        std::vector<uint8_t> data;
+        while (decoder.pull(data)) {
+            decoded.insert(decoded.end(), data.begin(), data.end());
+        }
+    }
+    EXPECT_TRUE(decoder.finished());
+    auto whole = adapter.decode(adapter.encode(input.data(), input.size(), DataFormat::VECTOR_FLOAT32),
+                                DataFormat::VECTOR_FLOAT16);
+    EXPECT_EQ(decoded, whole);
+}
+
+TEST(StreamingTranscoderTest, DecoderRestoresStreamOrder) {
+    VectorFloat32Adapter adapter;
+    auto values = ramp(64);
+    StreamingEncoder encoder(adapter, DataFormat::VECTOR_FLOAT32, DataFormat::VECTOR_FLOAT32, 64);
+    encoder.push(bytesOf(values));
+    encoder.finish();
+    auto chunks = drain(encoder);
+    ASSERT_EQ(chunks.size(), 5u);  // Four whole chunks and an empty last one
+
+    StreamingDecoder decoder(adapter);
+    std::vector<uint8_t> data;
+    decoder.push(chunks[2]);
+    decoder.push(chunks[4]);
+    EXPECT_FALSE(decoder.pull(data));
+    decoder.push(chunks[0]);
+    decoder.push(chunks[1]);
+    decoder.push(chunks[3]);
+
+    std::vector<uint8_t> decoded;
+    while (decoder.pull(data)) {
+        decoded.insert(decoded.end(), data.begin(), data.end());
+    }
+    EXPECT_TRUE(decoder.finished());
+    ByteSpan input = bytesOf(values);
+    EXPECT_EQ(decoded, input.to_vector());
+}
+
+TEST(StreamingTranscoderTest, RejectsMalformedAndRepeatedChunks) {
+    VectorFloat32Adapter adapter;
+    auto values = ramp(16);
+    StreamingEncoder encoder(adapter, DataFormat::VECTOR_FLOAT32, DataFormat::VECTOR_FLOAT32, 32);
+    encoder.push(bytesOf(values));
+    encoder.finish();
+    auto chunks = drain(encoder);
+    EXPECT_THROW(encoder.push(bytesOf(values)), TranscodingError);
+
+    StreamingDecoder decoder(adapter);
+    std::vector<uint8_t> stray(chunks[0].size(), 0);
+    EXPECT_THROW(decoder.push(stray), TranscodingError);
+    EXPECT_THROW(decoder.push(ByteSpan(chunks[0].data(), 3)), TranscodingError);
+    decoder.push(chunks[0]);
+    EXPECT_THROW(decoder.push(chunks[0]), TranscodingError);
+
+    EXPECT_THROW(StreamingEncoder(adapter, DataFormat::VECTOR_FLOAT32, DataFormat::VECTOR_FLOAT32, 0),
+                 TranscodingError);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/timeout_negotiation_protocol.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+using std::chrono::milliseconds;
+
+NegotiableParams plainParams() {
+    NegotiableParams params;
+    params.keySize = KeySize::NONE;
+    return params;
+}
+
+TimeoutConfig shortTimeouts() {
+    TimeoutConfig config;
+    config.negotiationTimeout = milliseconds(200);
+    config.responseTimeout = milliseconds(40);
+    return config;
+}
+
+// Polls until the session has been removed, or gives up
+bool waitForRemoval(const TimeoutNegotiationProtocol& protocol, NegotiationProtocol::SessionId id) {
+    auto deadline = std::chrono::steady_clock::now() + milliseconds(2000);
+    while (std::chrono::steady_clock::now() < deadline) {
+        try {
+            protocol.getSessionState(id);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        std::this_thread::sleep_for(milliseconds(2));
+    }
+    return false;
+}
+
+TEST(TimeoutNegotiationProtocolTest, RemovesSessionsWhenTheyTimeOut) {
+    utils::TimerService timers;
+    TimeoutNegotiationProtocol protocol(shortTimeouts(), false, &timers);
+    auto id = protocol.initiateSession("peer", plainParams());
+
+    EXPECT_EQ(protocol.getSessionState(id), NegotiationState::INITIATING);
+    EXPECT_TRUE(waitForRemoval(protocol, id));
+    EXPECT_EQ(timers.pending(), 0u);
+}
+
+TEST(TimeoutNegotiationProtocolTest, RemovesClosedSessionsPromptly) {
+    utils::TimerService timers;
+    TimeoutConfig config = shortTimeouts();
+    config.responseTimeout = milliseconds(60000);
+    config.negotiationTimeout = milliseconds(60000);
+    TimeoutNegotiationProtocol protocol(config, false, &timers);
+    auto id = protocol.initiateSession("peer", plainParams());
+
+    EXPECT_TRUE(protocol.closeSession(id));
+    EXPECT_TRUE(waitForRemoval(protocol, id));
+}
+
+TEST(TimeoutNegotiationProtocolTest, DestructionCancelsPendingTimers) {
+    utils::TimerService timers;
+    {
+        TimeoutConfig config;
+        config.negotiationTimeout = milliseconds(60000);
+        config.responseTimeout = milliseconds(60000);
+        TimeoutNegotiationProtocol protocol(config, false, &timers);
+        protocol.initiateSession("a", plainParams());
+        protocol.initiateSession("b", plainParams());
+        EXPECT_EQ(timers.pending(), 2u);
+    }
+    EXPECT_EQ(timers.pending(), 0u);
+}
+
+TEST(TimeoutNegotiationProtocolTest, RenegotiatesOnlyFinalizedSessions) {
+    utils::TimerService timers;
+    TimeoutNegotiationProtocol protocol(TimeoutConfig(), false, &timers);
+    auto id = protocol.initiateSession("peer", plainParams());
+
+    NegotiableParams updated = plainParams();
+    updated.compressionAlgorithm = CompressionAlgorithm::LZ4;
+    EXPECT_THROW(protocol.renegotiateSession(id, updated), std::runtime_error);
+    EXPECT_EQ(protocol.getSessionState(id), NegotiationState::INITIATING);
+}
+
+TEST(TimeoutNegotiationProtocolTest, SendsEarlyDataAsAPlainProposal) {
+    TimeoutNegotiationProtocol protocol(shortTimeouts(), false);
+    auto id = protocol.initiateSessionWithEarlyData("agent", plainParams(), {1, 2, 3});
+    EXPECT_EQ(protocol.getSessionState(id), NegotiationState::INITIATING);
+    EXPECT_EQ(protocol.getEarlyDataStatus(id), EarlyDataStatus::NONE);
+    EXPECT_FALSE(protocol.takeEarlyData(id).has_value());
+}
+
+TEST(RenegotiationTest, OnlyTransmissionParametersMayChange) {
+    NegotiableParams current = plainParams();
+
+    NegotiableParams updated = current;
+    updated.compressionAlgorithm = CompressionAlgorithm::ZSTD;
+    updated.errorCorrection = ErrorCorrectionScheme::REED_SOLOMON;
+    updated.customParameters["fragment.max_size"] = "512";
+    EXPECT_TRUE(isRenegotiable(current, updated));
+
+    NegotiableParams format = current;
+    format.dataFormat = DataFormat::VECTOR_FLOAT32;
+    EXPECT_FALSE(isRenegotiable(current, format));
+
+    NegotiableParams security = current;
+    security.encryptionAlgorithm = EncryptionAlgorithm::AES_GCM;
+    EXPECT_FALSE(isRenegotiable(current, security));
+
+    NegotiableParams version = current;
+    version.protocolVersion = "2.0.0";
+    EXPECT_FALSE(isRenegotiable(current, version));
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
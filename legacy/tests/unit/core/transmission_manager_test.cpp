@@ -2,13 +2,33 @@
 #include <catch2/matchers/catch_matchers_all.hpp>
 #include "xenocomm/core/transmission_manager.h"
 #include "xenocomm/core/connection_manager.hpp"
+#include "xenocomm/core/mock_transport.hpp"
+#include "xenocomm/core/udp_transport.hpp"
+#include "xenocomm/core/tcp_transport.hpp"
+#include "xenocomm/core/data_adapters.h"
 #include "xenocomm/utils/result.h"
 #include "xenocomm/core/error_correction_mode.h"
+#include "xenocomm/utils/frame_codec.hpp"
 #include <vector>
 #include <random>
 #include <chrono>
 #include <thread>
 #include <queue>
+#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <cstring>
+#include <map>
+#include <set>
+#include <optional>
+#include <string>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace xenocomm;
 using namespace xenocomm::core;
@@ -259,6 +279,49 @@ TEST_CASE("TransmissionManager fragmentation", "[transmission]") {
     }
 }
 
+TEST_CASE("TransmissionManager fragment header wire format", "[transmission]") {
+    TransmissionManager::FragmentHeader header{
+        .transmission_id = 0x01020304,
+        .fragment_index = 0x0506,
+        .total_fragments = 0x0708,
+        .fragment_size = 1400,
+        .original_size = 0x0A0B0C0D,
+        .error_check = 0xDEADBEEF,
+        .is_encrypted = true,
+        .security_flags = TransmissionManager::SECURITY_AEAD,
+        .fec_flags = TransmissionManager::FEC_PARITY,
+        .fec_data_fragments = 4,
+        .fec_parity_fragments = 2
+    };
+    uint8_t wire[TransmissionManager::FRAGMENT_HEADER_SIZE];
+    TransmissionManager::encode_header(header, wire);
+
+    // Little-endian regardless of the host
+    REQUIRE(wire[0] == TransmissionManager::FRAGMENT_HEADER_VERSION);
+    REQUIRE(wire[4] == 0x04);
+    REQUIRE(wire[7] == 0x01);
+    REQUIRE(wire[8] == 0x06);
+    REQUIRE(wire[23] == 0xDE);
+
+    TransmissionManager::FragmentHeader decoded{};
+    REQUIRE(TransmissionManager::decode_header(utils::ByteSpan(wire, sizeof(wire)), decoded));
+    REQUIRE(decoded.transmission_id == header.transmission_id);
+    REQUIRE(decoded.fragment_index == header.fragment_index);
+    REQUIRE(decoded.total_fragments == header.total_fragments);
+    REQUIRE(decoded.fragment_size == header.fragment_size);
+    REQUIRE(decoded.original_size == header.original_size);
+    REQUIRE(decoded.error_check == header.error_check);
+    REQUIRE(decoded.is_encrypted);
+    REQUIRE(decoded.security_flags == TransmissionManager::SECURITY_AEAD);
+    REQUIRE(decoded.fec_flags == TransmissionManager::FEC_PARITY);
+    REQUIRE(decoded.fec_data_fragments == 4);
+    REQUIRE(decoded.fec_parity_fragments == 2);
+
+    REQUIRE_FALSE(TransmissionManager::decode_header(utils::ByteSpan(wire, sizeof(wire) - 1), decoded));
+    wire[0] = TransmissionManager::FRAGMENT_HEADER_VERSION + 1;
+    REQUIRE_FALSE(TransmissionManager::decode_header(utils::ByteSpan(wire, sizeof(wire)), decoded));
+}
+
 TEST_CASE("TransmissionManager reassembly", "[transmission]") {
     MockConnectionManager mock_conn;
     TransmissionManager manager(mock_conn);
@@ -275,8 +338,8 @@ TEST_CASE("TransmissionManager reassembly", "[transmission]") {
 
         std::vector<uint8_t> fragment_data(100, 0x42);
         std::vector<uint8_t> complete_fragment;
-        complete_fragment.resize(sizeof(header));
-        std::memcpy(complete_fragment.data(), &header, sizeof(header));
+        complete_fragment.resize(TransmissionManager::FRAGMENT_HEADER_SIZE);
+        TransmissionManager::encode_header(header, complete_fragment.data());
         complete_fragment.insert(complete_fragment.end(), fragment_data.begin(), fragment_data.end());
 
         mock_conn.queue_received_data(complete_fragment);
@@ -300,8 +363,8 @@ TEST_CASE("TransmissionManager reassembly", "[transmission]") {
             .original_size = 1000
         };
         std::vector<uint8_t> complete_fragment1;
-        complete_fragment1.resize(sizeof(header1));
-        std::memcpy(complete_fragment1.data(), &header1, sizeof(header1));
+        complete_fragment1.resize(TransmissionManager::FRAGMENT_HEADER_SIZE);
+        TransmissionManager::encode_header(header1, complete_fragment1.data());
         complete_fragment1.insert(complete_fragment1.end(), fragment1.begin(), fragment1.end());
         
         // Create and queue second fragment
@@ -313,8 +376,8 @@ TEST_CASE("TransmissionManager reassembly", "[transmission]") {
             .original_size = 1000
         };
         std::vector<uint8_t> complete_fragment2;
-        complete_fragment2.resize(sizeof(header2));
-        std::memcpy(complete_fragment2.data(), &header2, sizeof(header2));
+        complete_fragment2.resize(TransmissionManager::FRAGMENT_HEADER_SIZE);
+        TransmissionManager::encode_header(header2, complete_fragment2.data());
         complete_fragment2.insert(complete_fragment2.end(), fragment2.begin(), fragment2.end());
 
         mock_conn.queue_received_data(complete_fragment1);
@@ -375,8 +438,8 @@ TEST_CASE("TransmissionManager configuration", "[transmission]") {
         };
         std::vector<uint8_t> fragment_data(100, 0x42);
         std::vector<uint8_t> complete_fragment;
-        complete_fragment.resize(sizeof(header));
-        std::memcpy(complete_fragment.data(), &header, sizeof(header));
+        complete_fragment.resize(TransmissionManager::FRAGMENT_HEADER_SIZE);
+        TransmissionManager::encode_header(header, complete_fragment.data());
         complete_fragment.insert(complete_fragment.end(), fragment_data.begin(), fragment_data.end());
 
         mock_conn.queue_received_data(complete_fragment);
@@ -403,7 +466,7 @@ TEST_CASE("TransmissionManager error correction", "[transmission_manager]") {
         REQUIRE(sent_data.size() > test_data.size()); // Account for header
         
         // Extract payload from sent data
-        std::vector<uint8_t> payload(sent_data.begin() + sizeof(TransmissionManager::FragmentHeader),
+        std::vector<uint8_t> payload(sent_data.begin() + TransmissionManager::FRAGMENT_HEADER_SIZE,
                                    sent_data.end());
         REQUIRE(payload == test_data);
     }
@@ -920,7 +983,7 @@ TEST_CASE("TransmissionManager complex retry scenarios", "[transmission_manager]
 }
 
 TEST_CASE("TransmissionManager with MockTransport", "[transmission_manager]") {
-    auto transport = std::make_shared<MockTransport>();
+    auto transport = std::make_shared<::MockTransport>();
     transport->setConnected(true);
     
     MockConnectionManager mock_conn;
@@ -941,4 +1004,1349 @@ TEST_CASE("TransmissionManager with MockTransport", "[transmission_manager]") {
     }
     
     // Add more test cases using MockTransport as needed
-} 
\ No newline at end of file
+} 
+
+TEST_CASE("TransmissionManager frames whole messages over reliable streams", "[transmission_manager]") {
+    using ::testing::_;
+    using ::testing::Invoke;
+    using ::testing::Return;
+
+    ::testing::NiceMock<core::MockTransport> transport;
+    ON_CALL(transport, isReliableStream()).WillByDefault(Return(true));
+
+    MockConnectionManager mock_conn;
+    TransmissionManager manager(mock_conn);
+    auto config = manager.get_config();
+    config.security.level = SecurityLevel::LOW;
+    config.fragment_config.max_fragment_size = 16;  // Would otherwise split the message below
+    manager.set_config(config);
+    manager.set_transport(&transport);
+
+    SECTION("Send writes one frame per message") {
+        std::vector<uint8_t> message(1000, 0x5A);
+        std::vector<std::vector<uint8_t>> frames;
+        EXPECT_CALL(transport, sendFrame(_, _))
+            .WillOnce(Invoke([&](const utils::ByteSpan* parts, size_t count) {
+                std::vector<uint8_t> frame;
+                for (size_t i = 0; i < count; ++i) {
+                    frame.insert(frame.end(), parts[i].begin(), parts[i].end());
+                }
+                frames.push_back(frame);
+                return static_cast<ssize_t>(frame.size());
+            }));
+
+        REQUIRE(manager.send(message).has_value());
+        REQUIRE(frames.size() == 1);
+        REQUIRE(frames[0].size() == message.size() + 1);
+        REQUIRE(frames[0][0] == 0);  // Plaintext flags byte
+        REQUIRE(std::equal(message.begin(), message.end(), frames[0].begin() + 1));
+        REQUIRE(mock_conn.get_sent_data().empty());
+    }
+
+    SECTION("Receive returns the frame payload without reassembly") {
+        EXPECT_CALL(transport, receiveFrame(_))
+            .WillOnce(Invoke([](utils::PooledBuffer& frame) {
+                frame = utils::BufferPool::shared().acquire(3);
+                std::memcpy(frame.data(), "\0hi", 3);
+                return static_cast<ssize_t>(frame.size());
+            }));
+
+        auto result = manager.receive(100);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value() == std::vector<uint8_t>{'h', 'i'});
+    }
+}
+
+TEST_CASE("TransmissionManager coalesces small sends into batches", "[transmission_manager]") {
+    using ::testing::_;
+    using ::testing::Invoke;
+    using ::testing::Return;
+
+    // Frames the sender writes are handed to the receiver's transport in order
+    std::mutex frames_mutex;
+    std::deque<std::vector<uint8_t>> frames;
+    ::testing::NiceMock<core::MockTransport> sender_transport, receiver_transport;
+    ON_CALL(sender_transport, isReliableStream()).WillByDefault(Return(true));
+    ON_CALL(receiver_transport, isReliableStream()).WillByDefault(Return(true));
+    ON_CALL(sender_transport, sendFrame(_, _))
+        .WillByDefault(Invoke([&](const utils::ByteSpan* parts, size_t count) {
+            std::vector<uint8_t> frame;
+            for (size_t i = 0; i < count; ++i) {
+                frame.insert(frame.end(), parts[i].begin(), parts[i].end());
+            }
+            std::lock_guard<std::mutex> lock(frames_mutex);
+            frames.push_back(frame);
+            return static_cast<ssize_t>(frame.size());
+        }));
+    ON_CALL(receiver_transport, receiveFrame(_))
+        .WillByDefault(Invoke([&](utils::PooledBuffer& frame) {
+            std::lock_guard<std::mutex> lock(frames_mutex);
+            if (frames.empty()) {
+                return static_cast<ssize_t>(-1);
+            }
+            frame = utils::BufferPool::shared().acquire(frames.front().size());
+            std::memcpy(frame.data(), frames.front().data(), frames.front().size());
+            frames.pop_front();
+            return static_cast<ssize_t>(frame.size());
+        }));
+
+    MockConnectionManager mock_conn;
+    TransmissionManager sender(mock_conn), receiver(mock_conn);
+    auto config = sender.get_config();
+    config.security.level = SecurityLevel::LOW;
+    config.coalescing.enabled = true;
+    config.coalescing.max_batch_messages = 3;
+    config.coalescing.max_delay_ms = 1000;
+    sender.set_config(config);
+    receiver.set_config(config);
+    sender.set_transport(&sender_transport);
+    receiver.set_transport(&receiver_transport);
+
+    auto frame_count = [&] {
+        std::lock_guard<std::mutex> lock(frames_mutex);
+        return frames.size();
+    };
+
+    SECTION("A full batch goes out as one frame and is received message by message") {
+        REQUIRE(sender.send(std::vector<uint8_t>{1}).has_value());
+        REQUIRE(sender.send(std::vector<uint8_t>{2, 2}).has_value());
+        REQUIRE(frame_count() == 0);
+        REQUIRE(sender.send(std::vector<uint8_t>{3, 3, 3}).has_value());
+        REQUIRE(frame_count() == 1);
+        REQUIRE(frames.front()[0] == 0x10);  // Plaintext batch
+        REQUIRE(sender.get_stats().coalesced_messages == 3);
+
+        for (const auto& expected : {std::vector<uint8_t>{1}, std::vector<uint8_t>{2, 2},
+                                     std::vector<uint8_t>{3, 3, 3}}) {
+            auto result = receiver.receive(100);
+            REQUIRE(result.has_value());
+            REQUIRE(result.value() == expected);
+        }
+        REQUIRE(frame_count() == 0);
+    }
+
+    SECTION("A large send flushes the batch ahead of itself") {
+        const std::vector<uint8_t> large(1000, 7);
+        REQUIRE(sender.send(std::vector<uint8_t>{1}).has_value());
+        REQUIRE(sender.send(std::vector<uint8_t>{2}).has_value());
+        REQUIRE(sender.send(large).has_value());
+        REQUIRE(frame_count() == 2);
+
+        REQUIRE(receiver.receive(100).value() == std::vector<uint8_t>{1});
+        REQUIRE(receiver.receive(100).value() == std::vector<uint8_t>{2});
+        REQUIRE(receiver.receive(100).value() == large);
+    }
+
+    SECTION("A lone message is sent unbatched by flush()") {
+        REQUIRE(sender.send(std::vector<uint8_t>{9, 9}).has_value());
+        REQUIRE(sender.flush().has_value());
+        REQUIRE(frame_count() == 1);
+        REQUIRE(frames.front() == std::vector<uint8_t>{0, 9, 9});
+        REQUIRE(sender.flush().has_value());
+        REQUIRE(frame_count() == 1);
+    }
+
+    SECTION("A pending batch goes out at its deadline") {
+        config.coalescing.max_delay_ms = 10;
+        sender.set_config(config);
+        REQUIRE(sender.send(std::vector<uint8_t>{4}).has_value());
+        REQUIRE(sender.send(std::vector<uint8_t>{5}).has_value());
+        for (int wait = 0; wait < 200 && frame_count() == 0; ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        REQUIRE(frame_count() == 1);
+        REQUIRE(receiver.receive(100).value() == std::vector<uint8_t>{4});
+        REQUIRE(receiver.receive(100).value() == std::vector<uint8_t>{5});
+    }
+}
+
+TEST_CASE("TransmissionManager admission control pushes back on senders", "[transmission_manager]") {
+    using ::testing::_;
+    using ::testing::Invoke;
+    using ::testing::Return;
+
+    std::deque<std::vector<uint8_t>> frames;
+    ::testing::NiceMock<core::MockTransport> transport;
+    ON_CALL(transport, isReliableStream()).WillByDefault(Return(true));
+    ON_CALL(transport, sendFrame(_, _))
+        .WillByDefault(Invoke([&](const utils::ByteSpan*, size_t) {
+            frames.emplace_back();
+            return static_cast<ssize_t>(1);
+        }));
+
+    MockConnectionManager mock_conn;
+    TransmissionManager sender(mock_conn);
+    auto config = sender.get_config();
+    config.security.level = SecurityLevel::LOW;
+    config.coalescing.enabled = true;
+    config.coalescing.max_batch_messages = 32;
+    config.coalescing.max_delay_ms = 1000;
+    config.admission.peer_quota_bytes = 64;  // Four batched 10-byte messages reach the 80% watermark
+    config.admission.admission_timeout_ms = 10;
+    sender.set_config(config);
+    sender.set_transport(&transport);
+
+    std::vector<TransmissionManager::BackpressureEvent> events;
+    sender.set_backpressure_callback([&](const TransmissionManager::BackpressureEvent& event) {
+        if (!event.process_wide) {
+            events.push_back(event);
+        }
+    });
+
+    const std::vector<uint8_t> message(10, 1);
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(sender.try_send(message.data(), message.size()).has_value());
+    }
+    REQUIRE(frames.empty());
+    REQUIRE(sender.under_backpressure());
+    REQUIRE(sender.get_stats().buffered_bytes == 56);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].engaged);
+
+    // The pending batch is what fills the quota, so sending it makes room for the next message
+    REQUIRE(sender.try_send(message.data(), message.size()).has_value());
+    REQUIRE(frames.size() == 1);
+    REQUIRE(sender.get_stats().buffered_bytes == 14);
+    REQUIRE(events.size() == 2);
+    REQUIRE_FALSE(events[1].engaged);
+    REQUIRE_FALSE(sender.under_backpressure());
+
+    // A message larger than the whole quota can never be admitted
+    const std::vector<uint8_t> large(100, 2);
+    auto refused = sender.try_send(large.data(), large.size());
+    REQUIRE_FALSE(refused.has_value());
+    REQUIRE(refused.error_code() == utils::ErrorCode::BufferFull);
+    REQUIRE(sender.send(large).error_code() == utils::ErrorCode::BufferFull);
+    REQUIRE(sender.get_stats().admission_refusals == 2);
+
+    REQUIRE(sender.flush().has_value());
+    REQUIRE(sender.get_stats().buffered_bytes == 0);
+}
+
+TEST_CASE("TransmissionManager streams transcoded chunks", "[transmission_manager]") {
+    using ::testing::_;
+    using ::testing::Invoke;
+    using ::testing::Return;
+
+    // Frames written by the sender are replayed to the receiver
+    std::deque<std::vector<uint8_t>> wire;
+    ::testing::NiceMock<core::MockTransport> transport;
+    ON_CALL(transport, isReliableStream()).WillByDefault(Return(true));
+    ON_CALL(transport, sendFrame(_, _))
+        .WillByDefault(Invoke([&](const utils::ByteSpan* parts, size_t count) {
+            std::vector<uint8_t> frame;
+            for (size_t i = 0; i < count; ++i) {
+                frame.insert(frame.end(), parts[i].begin(), parts[i].end());
+            }
+            wire.push_back(frame);
+            return static_cast<ssize_t>(frame.size());
+        }));
+    ON_CALL(transport, receiveFrame(_))
+        .WillByDefault(Invoke([&](utils::PooledBuffer& frame) {
+            if (wire.empty()) {
+                return static_cast<ssize_t>(0);
+            }
+            frame = utils::BufferPool::shared().acquire(wire.front().size());
+            std::memcpy(frame.data(), wire.front().data(), wire.front().size());
+            wire.pop_front();
+            return static_cast<ssize_t>(frame.size());
+        }));
+
+    MockConnectionManager mock_conn;
+    TransmissionManager manager(mock_conn);
+    auto config = manager.get_config();
+    config.security.level = SecurityLevel::LOW;
+    config.stream.chunk_size = 4096;
+    manager.set_config(config);
+    manager.set_transport(&transport);
+
+    std::vector<float> values(10000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i % 512) * 0.25f;
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+    const size_t total = values.size() * sizeof(float);
+
+    size_t offset = 0;
+    VectorFloat16Adapter encoder;
+    auto sent = manager.send_stream([&](utils::MutableByteSpan buffer) {
+        size_t count = std::min(buffer.size(), total - offset);
+        std::memcpy(buffer.data(), bytes + offset, count);
+        offset += count;
+        return count;
+    }, encoder, DataFormat::VECTOR_FLOAT32, DataFormat::VECTOR_FLOAT16);
+    REQUIRE(sent.has_value());
+    REQUIRE(wire.size() == (total + 4095) / 4096);  // One frame per chunk
+
+    std::vector<uint8_t> received;
+    VectorFloat16Adapter decoder;
+    auto result = manager.receive_stream([&](utils::ByteSpan data) {
+        received.insert(received.end(), data.begin(), data.end());
+    }, decoder, 100);
+    REQUIRE(result.has_value());
+    REQUIRE(wire.empty());
+
+    // Every value is exactly representable in half precision
+    REQUIRE(received.size() == total);
+    REQUIRE(std::memcmp(received.data(), bytes, total) == 0);
+}
+
+TEST_CASE("TransmissionManager applies configuration changes between messages", "[transmission_manager]") {
+    using ::testing::_;
+    using ::testing::Invoke;
+    using ::testing::Return;
+
+    ::testing::NiceMock<core::MockTransport> transport;
+    ON_CALL(transport, isReliableStream()).WillByDefault(Return(true));
+
+    MockConnectionManager mock_conn;
+    TransmissionManager manager(mock_conn);
+    auto config = manager.get_config();
+    config.security.level = SecurityLevel::LOW;
+    manager.set_config(config);
+    manager.set_transport(&transport);
+
+    auto renegotiated = config;
+    renegotiated.error_correction_mode = ErrorCorrectionMode::REED_SOLOMON;
+    renegotiated.fragment_config.max_fragment_size = 512;
+
+    // A change made while a message is on the wire waits for it, without blocking the caller
+    bool applied_mid_message = true;
+    EXPECT_CALL(transport, sendFrame(_, _))
+        .WillOnce(Invoke([&](const utils::ByteSpan* parts, size_t count) {
+            manager.set_config(renegotiated);
+            applied_mid_message = manager.get_config().error_correction_mode == ErrorCorrectionMode::REED_SOLOMON;
+            ssize_t size = 0;
+            for (size_t i = 0; i < count; ++i) {
+                size += static_cast<ssize_t>(parts[i].size());
+            }
+            return size;
+        }));
+
+    REQUIRE(manager.send(std::vector<uint8_t>(100, 0x42)).has_value());
+    REQUIRE_FALSE(applied_mid_message);
+    REQUIRE(manager.get_config().error_correction_mode == ErrorCorrectionMode::REED_SOLOMON);
+    REQUIRE(manager.get_config().fragment_config.max_fragment_size == 512);
+}
+
+TEST_CASE("TransmissionManager carries fragments over ConnectionManager connections", "[transmission_manager]") {
+    // Two UDP connections on loopback, pointed at each other
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39211;
+    receiver_config.localPort = 39212;
+    connections.establish("sender", "127.0.0.1:39212", std::make_shared<UDPTransport>(), sender_config);
+    connections.establish("receiver", "127.0.0.1:39211", std::make_shared<UDPTransport>(), receiver_config);
+    REQUIRE(connections.getActiveConnections().size() == 2);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        manager->set_config(config);
+    }
+    REQUIRE_FALSE(sender.bind_connection("nonexistent").has_value());
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    std::vector<uint8_t> message(2300);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 3);
+    }
+
+    // The receiver acknowledges each fragment back over its own connection
+    std::vector<uint8_t> received;
+    std::thread reader([&] {
+        for (int attempt = 0; attempt < 50 && received.empty(); ++attempt) {
+            auto result = receiver.receive(200);
+            if (result.has_value()) {
+                received = result.value();
+            }
+        }
+    });
+    auto sent = sender.send(message);
+    reader.join();
+
+    REQUIRE(sent.has_value());
+    REQUIRE(received == message);
+    REQUIRE(connections.close("sender"));
+    REQUIRE_FALSE(sender.send(message).has_value());
+}
+
+// Drops the first transmission of chosen fragments, as a lossy network would
+class LossyUdpTransport : public UDPTransport {
+public:
+    explicit LossyUdpTransport(std::vector<uint16_t> drop) : drop_(std::move(drop)) {}
+
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override {
+        TransmissionManager::FragmentHeader header{};
+        if (count == 2 && TransmissionManager::decode_header(buffers[0], header)) {
+            auto it = std::find(drop_.begin(), drop_.end(), header.fragment_index);
+            if (!(header.fec_flags & TransmissionManager::FEC_PARITY) && it != drop_.end()) {
+                drop_.erase(it);
+                return static_cast<ssize_t>(buffers[0].size() + buffers[1].size());
+            }
+        }
+        return UDPTransport::sendv(buffers, count);
+    }
+
+private:
+    std::vector<uint16_t> drop_;
+};
+
+// Reports each fragment on its way out, before it is sent
+class RecordingUdpTransport : public UDPTransport {
+public:
+    std::function<void(const TransmissionManager::FragmentHeader&)> on_fragment;
+
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override {
+        TransmissionManager::FragmentHeader header{};
+        if (on_fragment && count == 2 && TransmissionManager::decode_header(buffers[0], header) &&
+            !(header.fec_flags & TransmissionManager::FEC_PARITY)) {
+            on_fragment(header);
+        }
+        return UDPTransport::sendv(buffers, count);
+    }
+};
+
+TEST_CASE("TransmissionManager preempts bulk transfers for urgent messages", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39231;
+    receiver_config.localPort = 39232;
+    auto sender_transport = std::make_shared<RecordingUdpTransport>();
+    connections.establish("sender", "127.0.0.1:39232", sender_transport, sender_config);
+    connections.establish("receiver", "127.0.0.1:39231", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    const std::vector<uint8_t> bulk(10000, 0xB0);
+    const std::vector<uint8_t> urgent(800, 0x0C);
+    TransmissionManager::SendOptions urgent_options;
+    urgent_options.priority = TransmissionManager::MessagePriority::URGENT;
+
+    // The urgent send is queued while the bulk transfer's first fragment goes out
+    std::vector<std::pair<uint32_t, uint16_t>> order;
+    std::thread urgent_sender;
+    Result<void> urgent_sent("not sent");
+    sender_transport->on_fragment = [&](const TransmissionManager::FragmentHeader& header) {
+        order.emplace_back(header.transmission_id, header.fragment_index);
+        if (order.size() == 1) {
+            urgent_sender = std::thread([&] { urgent_sent = sender.send(urgent.data(), urgent.size(), urgent_options); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    };
+
+    std::vector<std::vector<uint8_t>> received;
+    std::thread reader([&] {
+        for (int attempt = 0; attempt < 50 && received.size() < 2; ++attempt) {
+            auto result = receiver.receive(200);
+            if (result.has_value()) {
+                received.push_back(result.value());
+            }
+        }
+    });
+    auto bulk_sent = sender.send(bulk.data(), bulk.size(), TransmissionManager::SendOptions{
+                                     TransmissionManager::MessagePriority::BULK});
+    urgent_sender.join();
+    reader.join();
+
+    REQUIRE(bulk_sent.has_value());
+    REQUIRE(urgent_sent.has_value());
+    REQUIRE(received.size() == 2);
+    REQUIRE(received[0] == urgent);
+    REQUIRE(received[1] == bulk);
+
+    // Both of the urgent message's fragments went out between the first and second bulk fragments
+    REQUIRE(order.size() == 22);
+    const uint32_t bulk_id = order[0].first;
+    REQUIRE(order[1].first != bulk_id);
+    REQUIRE(order[2].first == order[1].first);
+    REQUIRE(order[3] == std::make_pair(bulk_id, uint16_t{1}));
+    auto stats = sender.get_stats();
+    REQUIRE(stats.preemptions == 1);
+    REQUIRE(stats.retransmissions == 0);  // Bulk acks that arrived meanwhile were not lost
+
+    // A message past its deadline is dropped, or sent as bulk if the caller prefers
+    sender_transport->on_fragment = nullptr;
+    TransmissionManager::SendOptions late;
+    late.priority = TransmissionManager::MessagePriority::URGENT;
+    late.deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+    auto dropped = sender.send(urgent.data(), urgent.size(), late);
+    REQUIRE_FALSE(dropped.has_value());
+    REQUIRE(dropped.error_code() == utils::ErrorCode::DeadlineExceeded);
+    REQUIRE(sender.get_stats().deadline_drops == 1);
+
+    late.on_expiry = TransmissionManager::ExpiryPolicy::DEPRIORITIZE;
+    std::vector<uint8_t> late_received;
+    std::thread late_reader([&] {
+        for (int attempt = 0; attempt < 50 && late_received.empty(); ++attempt) {
+            auto result = receiver.receive(200);
+            if (result.has_value()) {
+                late_received = result.value();
+            }
+        }
+    });
+    REQUIRE(sender.send(urgent.data(), urgent.size(), late).has_value());
+    late_reader.join();
+    REQUIRE(late_received == urgent);
+    REQUIRE(sender.get_stats().deadline_drops == 1);
+}
+
+TEST_CASE("TransmissionManager compresses messages against the connection's history", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39241;
+    receiver_config.localPort = 39242;
+    auto sender_transport = std::make_shared<RecordingUdpTransport>();
+    connections.establish("sender", "127.0.0.1:39242", sender_transport, sender_config);
+    connections.establish("receiver", "127.0.0.1:39241", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.stream_compression.enabled = true;
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    std::vector<uint32_t> wire_sizes;
+    sender_transport->on_fragment = [&](const TransmissionManager::FragmentHeader& header) {
+        REQUIRE((header.fec_flags & TransmissionManager::STREAM_COMPRESSED) != 0);
+        wire_sizes.push_back(header.original_size);
+    };
+    auto message = [](int i) {
+        std::string text = "{\"type\":\"status\",\"agent\":\"planner-7\",\"state\":\"ready\",\"seq\":" +
+                           std::to_string(i) + "}";
+        return std::vector<uint8_t>(text.begin(), text.end());
+    };
+    // Sends one message and reports what the receiver made of it: the message, or nothing if it could not decompress it
+    auto exchange = [&](const std::vector<uint8_t>& data) {
+        std::optional<std::vector<uint8_t>> received;
+        std::thread reader([&] {
+            for (int attempt = 0; attempt < 20; ++attempt) {
+                auto result = receiver.receive(200);
+                if (result.has_value()) {
+                    received = result.value();
+                    return;
+                }
+                if (result.error().rfind("Decompression failed", 0) == 0) {
+                    return;
+                }
+            }
+        });
+        REQUIRE(sender.send(data).has_value());
+        reader.join();
+        return received;
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(exchange(message(i)) == message(i));
+    }
+    // Later messages are mostly references to the ones before them
+    REQUIRE(wire_sizes.size() == 10);
+    REQUIRE(wire_sizes.back() * 2 < wire_sizes.front());
+
+    // A receiver that loses the history asks for a new one, and the sender soon restarts
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+    int lost = 0;
+    for (int i = 10; i < 14 && exchange(message(i)) != message(i); ++i) {
+        ++lost;
+    }
+    REQUIRE(lost >= 1);
+    REQUIRE(lost <= 2);
+    REQUIRE(exchange(message(20)) == message(20));
+}
+
+TEST_CASE("TransmissionManager sends files without reading them into memory", "[transmission_manager]") {
+    // Every byte depends on its position, so an offset or length mistake shows
+    char path[] = "/tmp/xenocomm_send_file_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    unlink(path);
+    std::vector<uint8_t> contents(300000);
+    for (size_t i = 0; i < contents.size(); ++i) {
+        contents[i] = static_cast<uint8_t>(i * 7 + i / 251);
+    }
+    REQUIRE(write(fd, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()));
+
+    SECTION("Over TCP the file follows the frame header through the kernel") {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        REQUIRE(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        REQUIRE(listen(listener, 1) == 0);
+        REQUIRE(getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+
+        TCPTransport transport;
+        ConnectionConfig connection_config;
+        connection_config.autoReconnect = false;
+        connection_config.healthMonitoring = false;
+        REQUIRE(transport.connect("127.0.0.1:" + std::to_string(ntohs(address.sin_port)), connection_config));
+        int peer = accept(listener, nullptr, nullptr);
+        REQUIRE(peer >= 0);
+
+        MockConnectionManager mock_conn;
+        TransmissionManager manager(mock_conn);
+        auto config = manager.get_config();
+        config.security.level = SecurityLevel::LOW;
+        manager.set_config(config);
+        manager.set_transport(&transport);
+
+        // The frame outgrows the socket buffers, so the peer reads while it is sent
+        auto frame = std::async(std::launch::async, [peer] {
+            utils::FrameDecoder decoder;
+            utils::ByteSpan next;
+            while (decoder.next(next) == utils::FrameDecoder::Status::NEED_MORE) {
+                auto space = decoder.prepare(65536);
+                ssize_t received = recv(peer, space.data(), space.size(), 0);
+                if (received <= 0) {
+                    return std::vector<uint8_t>();
+                }
+                decoder.commit(static_cast<size_t>(received));
+            }
+            return next.to_vector();
+        });
+        REQUIRE(manager.send_file(fd, 1000, 250000).has_value());
+        auto received = frame.get();
+        REQUIRE(received.size() == 250001);
+        REQUIRE(received[0] == 0);  // Plaintext flags byte
+        REQUIRE(std::equal(contents.begin() + 1000, contents.begin() + 251000, received.begin() + 1));
+        REQUIRE(manager.get_stats().bytes_sent == 250000);
+
+        transport.disconnect();
+        close(peer);
+        close(listener);
+    }
+
+    SECTION("Other transports are given the mapped region") {
+        using ::testing::_;
+        using ::testing::Invoke;
+        using ::testing::Return;
+
+        ::testing::NiceMock<core::MockTransport> transport;
+        ON_CALL(transport, isReliableStream()).WillByDefault(Return(true));
+        MockConnectionManager mock_conn;
+        TransmissionManager manager(mock_conn);
+        auto config = manager.get_config();
+        config.security.level = SecurityLevel::LOW;
+        manager.set_config(config);
+        manager.set_transport(&transport);
+
+        std::vector<uint8_t> frame;
+        ON_CALL(transport, sendFrame(_, _))
+            .WillByDefault(Invoke([&](const utils::ByteSpan* parts, size_t count) {
+                frame.clear();
+                for (size_t i = 0; i < count; ++i) {
+                    frame.insert(frame.end(), parts[i].begin(), parts[i].end());
+                }
+                return static_cast<ssize_t>(frame.size());
+            }));
+
+        REQUIRE(manager.send_file(fd, 4099, 100).has_value());
+        REQUIRE(frame.size() == 101);
+        REQUIRE(std::equal(contents.begin() + 4099, contents.begin() + 4199, frame.begin() + 1));
+        // A region running past the end of the file is refused rather than faulted on
+        REQUIRE_FALSE(manager.send_file(fd, 299990, 100).has_value());
+        REQUIRE_FALSE(manager.send_file(-1, 0, 100).has_value());
+    }
+    close(fd);
+}
+
+TEST_CASE("TransmissionManager publishes to multicast subscribers and repairs by NACK", "[transmission_manager]") {
+    const std::string group = "239.255.42.1";
+    ConnectionConfig config;
+
+    // Fragment 1 leaves a gap and fragment 5, the last, a stall
+    LossyUdpTransport publisher_transport({1, 5});
+    REQUIRE(publisher_transport.setLocalPort(39221));
+    REQUIRE(publisher_transport.connect(group + ":39222", config));
+    REQUIRE(publisher_transport.setMulticastTTL(1));
+    REQUIRE(publisher_transport.setMulticastLoopback(true));
+    UDPTransport subscriber_transports[2];
+    for (auto& transport : subscriber_transports) {
+        REQUIRE(transport.setLocalPort(39222));
+        REQUIRE(transport.connect("127.0.0.1:39221", config));
+        REQUIRE(transport.joinMulticastGroup(group));
+    }
+
+    ConnectionManager connections;
+    TransmissionManager publisher(connections), first(connections), second(connections);
+    TransmissionManager* subscribers[] = {&first, &second};
+    for (auto* manager : {&publisher, &first, &second}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        config.multicast.enabled = true;
+        manager->set_config(config);
+    }
+    publisher.set_transport(&publisher_transport);
+    first.set_transport(&subscriber_transports[0]);
+    second.set_transport(&subscriber_transports[1]);
+
+    std::vector<uint8_t> message(3000);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 5);
+    }
+
+    std::vector<uint8_t> received[2];
+    std::atomic<int> done{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&, i] {
+            for (int attempt = 0; attempt < 50 && received[i].empty(); ++attempt) {
+                auto result = subscribers[i]->receive(100);
+                if (result.has_value()) {
+                    received[i] = result.value();
+                }
+            }
+            ++done;
+        });
+    }
+
+    // One transmission reaches both; send() does not wait for anyone
+    REQUIRE(publisher.send(message).has_value());
+    size_t repaired = 0;
+    for (int round = 0; round < 100 && done < 2; ++round) {
+        auto result = publisher.serve_repairs(50);
+        REQUIRE(result.has_value());
+        repaired += result.value();
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(received[0] == message);
+    REQUIRE(received[1] == message);
+    REQUIRE(repaired >= 2);
+    REQUIRE(publisher.get_stats().multicast_repairs == repaired);
+    // A repair prompted by one subscriber's NACK can spare the other from sending its own
+    REQUIRE(first.get_stats().nacks_sent + second.get_stats().nacks_sent >= 1);
+}
+
+TEST_CASE("TransmissionManager receives on the reactor without a waiting thread", "[transmission_manager]") {
+    ConnectionConfig config;
+    UDPTransport sender_transport, receiver_transport;
+    REQUIRE(sender_transport.setLocalPort(39231));
+    REQUIRE(receiver_transport.setLocalPort(39232));
+    REQUIRE(sender_transport.connect("127.0.0.1:39232", config));
+    REQUIRE(receiver_transport.connect("127.0.0.1:39231", config));
+
+    ConnectionManager connections;
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto manager_config = manager->get_config();
+        manager_config.security.level = SecurityLevel::LOW;
+        manager_config.fragment_config.max_fragment_size = 500;
+        manager->set_config(manager_config);
+    }
+    sender.set_transport(&sender_transport);
+    receiver.set_transport(&receiver_transport);
+
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<std::vector<uint8_t>> messages;
+    REQUIRE_FALSE(receiver.start_async_receive(nullptr).has_value());
+    REQUIRE(receiver.start_async_receive([&](Result<std::vector<uint8_t>> message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Checked on the test thread; assertions are not thread-safe
+        messages.push_back(message.has_value() ? std::move(message.value()) : std::vector<uint8_t>{});
+        // Stopping from the handler itself must not wait for the handler
+        if (messages.size() == 2) {
+            receiver.stop_async_receive();
+        }
+        arrived.notify_all();
+    }).has_value());
+    REQUIRE_FALSE(receiver.start_async_receive([](Result<std::vector<uint8_t>>) {}).has_value());
+
+    std::vector<uint8_t> first(2300), second(700);
+    for (size_t i = 0; i < first.size(); ++i) {
+        first[i] = static_cast<uint8_t>(i * 3);
+    }
+    std::fill(second.begin(), second.end(), 0x5A);
+    // Acks come back through the sender's own socket while the receiver's is watched by the reactor
+    REQUIRE(sender.send(first).has_value());
+    REQUIRE(sender.send(second.data(), second.size()).has_value());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    REQUIRE(arrived.wait_for(lock, std::chrono::seconds(5), [&] { return messages.size() == 2; }));
+    REQUIRE(messages[0] == first);
+    REQUIRE(messages[1] == second);
+    lock.unlock();
+
+    // Stopped, the socket is free for a blocking receive again
+    const std::vector<uint8_t> third(300, 0x33);
+    auto blocking = std::async(std::launch::async, [&] { return receiver.receive(1000); });
+    REQUIRE(sender.send(third).has_value());
+    auto result = blocking.get();
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == third);
+}
+
+TEST_CASE("TransmissionManager spins on low-latency connections", "[transmission_manager]") {
+    ConnectionConfig config;
+    config.lowLatency = true;
+    config.spinBeforeParkUs = 200;
+    config.ioThreadCpu = 0;
+    UDPTransport sender_transport, receiver_transport;
+    REQUIRE(sender_transport.setLocalPort(39241));
+    REQUIRE(receiver_transport.setLocalPort(39242));
+    REQUIRE(sender_transport.connect("127.0.0.1:39242", config));
+    REQUIRE(receiver_transport.connect("127.0.0.1:39241", config));
+
+    ConnectionManager connections;
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto manager_config = manager->get_config();
+        manager_config.security.level = SecurityLevel::LOW;
+        manager_config.coalescing.enabled = true;
+        manager_config.coalescing.max_delay_ms = 1000;
+        manager->set_config(manager_config);
+        manager->apply_connection_config(config);
+    }
+    sender.set_transport(&sender_transport);
+    receiver.set_transport(&receiver_transport);
+
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<std::vector<uint8_t>> messages;
+    std::thread::id handler_thread;
+    REQUIRE(receiver.start_async_receive([&](Result<std::vector<uint8_t>> message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handler_thread = std::this_thread::get_id();
+        messages.push_back(message.has_value() ? std::move(message.value()) : std::vector<uint8_t>{});
+        if (messages.size() == 2) {
+            receiver.stop_async_receive();
+        }
+        arrived.notify_all();
+    }).has_value());
+
+    // Small sends skip the batch and its delay altogether
+    REQUIRE(sender.send(std::vector<uint8_t>{1, 2, 3}).has_value());
+    REQUIRE(sender.send(std::vector<uint8_t>{4}).has_value());
+    REQUIRE(sender.get_stats().coalesced_messages == 0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    REQUIRE(arrived.wait_for(lock, std::chrono::seconds(5), [&] { return messages.size() == 2; }));
+    REQUIRE(messages[0] == std::vector<uint8_t>{1, 2, 3});
+    REQUIRE(messages[1] == std::vector<uint8_t>{4});
+    // The poller is a thread of the manager's own, not the shared reactor's
+    REQUIRE(handler_thread != std::this_thread::get_id());
+    lock.unlock();
+
+    // Restarted after stopping from the handler, then stopped from outside
+    REQUIRE(receiver.start_async_receive([&](Result<std::vector<uint8_t>>) {}).has_value());
+    receiver.stop_async_receive();
+}
+
+TEST_CASE("TransmissionManager paces pipelined fragments", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39251;
+    receiver_config.localPort = 39252;
+    auto sender_transport = std::make_shared<RecordingUdpTransport>();
+    connections.establish("sender", "127.0.0.1:39252", sender_transport, sender_config);
+    connections.establish("receiver", "127.0.0.1:39251", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        config.fragment_config.adaptive_sizing = false;
+        config.flow_control.max_pacing_rate = 100000;
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+    REQUIRE(sender.get_stats().pacing_rate == 100000);
+
+    // First transmissions only; a retransmission of the same index keeps its first time
+    std::map<uint16_t, std::chrono::steady_clock::time_point> sent_at;
+    sender_transport->on_fragment = [&](const TransmissionManager::FragmentHeader& header) {
+        sent_at.emplace(header.fragment_index, std::chrono::steady_clock::now());
+    };
+    std::vector<uint8_t> received;
+    std::thread reader([&] {
+        for (int attempt = 0; attempt < 50 && received.empty(); ++attempt) {
+            auto result = receiver.receive(200);
+            if (result.has_value()) {
+                received = result.value();
+            }
+        }
+    });
+
+    // 20 fragments fit the window at once; the pacer lets two out back to back, then one per 5 ms
+    const std::vector<uint8_t> message(10000, 0x5A);
+    REQUIRE(sender.send(message).has_value());
+    reader.join();
+    REQUIRE(received == message);
+
+    REQUIRE(sent_at.size() == 20);
+    auto spread = std::chrono::duration_cast<std::chrono::milliseconds>(sent_at[19] - sent_at[0]);
+    REQUIRE(spread.count() >= 80);
+    REQUIRE(sent_at[3] - sent_at[2] >= std::chrono::milliseconds(4));
+
+    auto unpaced = sender.get_config();
+    unpaced.flow_control.enable_pacing = false;
+    sender.set_config(unpaced);
+    REQUIRE(sender.get_stats().pacing_rate == 0);
+}
+
+TEST_CASE("TransmissionManager adapts FEC to the loss it sees", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39261;
+    receiver_config.localPort = 39262;
+    // Two losses in a row in the first message, a clean link afterwards
+    connections.establish("sender", "127.0.0.1:39262", std::make_shared<LossyUdpTransport>(std::vector<uint16_t>{3, 4}),
+                          sender_config);
+    connections.establish("receiver", "127.0.0.1:39261", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        config.retransmission_config.sack_frequency = 1;  // Holes are reported, and resent, right away
+        config.fec.adaptive = true;
+        config.fec.adapt_interval_packets = 16;
+        config.fec.step_down_intervals = 2;
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+    REQUIRE(sender.get_stats().protection_level == TransmissionManager::ProtectionLevel::CHECKSUM_ONLY);
+
+    const std::vector<uint8_t> message(8000, 0xFE);  // 16 fragments
+    auto transfer = [&] {
+        std::vector<uint8_t> received;
+        std::thread reader([&] {
+            for (int attempt = 0; attempt < 50 && received.empty(); ++attempt) {
+                auto result = receiver.receive(200);
+                if (result.has_value()) {
+                    received = result.value();
+                }
+            }
+        });
+        auto sent = sender.send(message);
+        reader.join();
+        return sent.has_value() && received == message;
+    };
+
+    // The burst was retransmitted, and it takes parity two deep to repair one like it
+    REQUIRE(transfer());
+    auto stats = sender.get_stats();
+    REQUIRE(stats.retransmissions == 2);
+    REQUIRE(stats.protection_level == TransmissionManager::ProtectionLevel::HEAVY_FEC);
+    REQUIRE(stats.fec_parity_fragments == 2);
+
+    // Quiet intervals step the protection back down one level at a time
+    REQUIRE(transfer());
+    REQUIRE(sender.get_stats().protection_level == TransmissionManager::ProtectionLevel::HEAVY_FEC);
+    REQUIRE(transfer());
+    REQUIRE(sender.get_stats().protection_level == TransmissionManager::ProtectionLevel::LIGHT_FEC);
+    REQUIRE(sender.get_stats().fec_parity_fragments == 1);
+    REQUIRE(transfer());
+    REQUIRE(transfer());
+    stats = sender.get_stats();
+    REQUIRE(stats.protection_level == TransmissionManager::ProtectionLevel::CHECKSUM_ONLY);
+    REQUIRE(stats.fec_parity_fragments == 0);
+    REQUIRE(stats.protection_changes == 3);
+    REQUIRE(stats.retransmissions == 2);
+
+    // Turning adaptation off goes back to the configured FEC
+    auto fixed = sender.get_config();
+    fixed.fec.adaptive = false;
+    fixed.fec.enabled = true;
+    fixed.fec.parity_fragments = 3;
+    sender.set_config(fixed);
+    REQUIRE(sender.get_stats().protection_level == TransmissionManager::ProtectionLevel::HEAVY_FEC);
+    REQUIRE(sender.get_stats().fec_parity_fragments == 3);
+    REQUIRE(transfer());
+}
+
+TEST_CASE("TransmissionManager rebuilds a lost fragment from XOR parity", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39311;
+    receiver_config.localPort = 39312;
+    // Fragment 5 of the second group never arrives
+    connections.establish("sender", "127.0.0.1:39312", std::make_shared<LossyUdpTransport>(std::vector<uint16_t>{5}),
+                          sender_config);
+    connections.establish("receiver", "127.0.0.1:39311", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        config.fec.enabled = true;
+        config.fec.data_fragments = 4;
+        config.fec.parity_fragments = 1;
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    std::vector<uint8_t> message(3800);  // Two groups of four, the last fragment short
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 31 + i / 256);
+    }
+    std::vector<uint8_t> received;
+    std::thread reader([&] {
+        for (int attempt = 0; attempt < 50 && received.empty(); ++attempt) {
+            auto result = receiver.receive(200);
+            if (result.has_value()) {
+                received = result.value();
+            }
+        }
+    });
+    REQUIRE(sender.send(message).has_value());
+    reader.join();
+
+    REQUIRE(received == message);
+    REQUIRE(receiver.get_stats().fec_recovered_fragments == 1);
+    REQUIRE(sender.get_stats().retransmissions == 0);
+}
+
+// Drops the first transmission of chosen fragments and keeps the size of every fragment sent
+class SizeRecordingLossyUdpTransport : public LossyUdpTransport {
+public:
+    using LossyUdpTransport::LossyUdpTransport;
+    std::vector<uint32_t> fragment_sizes;
+
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override {
+        TransmissionManager::FragmentHeader header{};
+        if (count == 2 && TransmissionManager::decode_header(buffers[0], header)) {
+            fragment_sizes.push_back(header.fragment_size);
+        }
+        return LossyUdpTransport::sendv(buffers, count);
+    }
+};
+
+TEST_CASE("TransmissionManager sizes fragments from path MTU and loss", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39301;
+    receiver_config.localPort = 39302;
+    // Three fragments of the first message are lost, the link is clean afterwards
+    auto sender_transport = std::make_shared<SizeRecordingLossyUdpTransport>(std::vector<uint16_t>{1, 2, 3});
+    connections.establish("sender", "127.0.0.1:39302", sender_transport, sender_config);
+    connections.establish("receiver", "127.0.0.1:39301", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.adaptive_sizing = true;
+        config.fragment_config.resize_interval_packets = 8;
+        config.retransmission_config.sack_frequency = 1;  // Holes are reported, and resent, right away
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    std::vector<uint8_t> message(8000);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 13 + 5);
+    }
+    // Sends the message and returns the sizes of the fragments it went out in, empty if it did not arrive whole
+    auto transfer = [&] {
+        sender_transport->fragment_sizes.clear();
+        std::vector<uint8_t> received;
+        std::thread reader([&] {
+            for (int attempt = 0; attempt < 50 && received.empty(); ++attempt) {
+                auto result = receiver.receive(200);
+                if (result.has_value()) {
+                    received = result.value();
+                }
+            }
+        });
+        auto sent = sender.send(message);
+        reader.join();
+        std::set<uint32_t> sizes(sender_transport->fragment_sizes.begin(), sender_transport->fragment_sizes.end());
+        return sent.has_value() && received == message ? sizes : std::set<uint32_t>{};
+    };
+
+    // Header and payload fill one packet of the path MTU
+    const uint32_t overhead = 28 + TransmissionManager::FRAGMENT_HEADER_SIZE;
+    sender.set_path_mtu(1000 + overhead);
+    REQUIRE(sender.current_fragment_size() == 1000);
+    REQUIRE(transfer() == std::set<uint32_t>{1000});
+
+    // Three of eleven sent were resends, so the fragments halve
+    REQUIRE(sender.get_stats().retransmissions == 3);
+    REQUIRE(sender.current_fragment_size() == 500);
+    REQUIRE(transfer() == std::set<uint32_t>{500});
+
+    // A clean interval closes half the gap to the ceiling
+    REQUIRE(sender.current_fragment_size() == 750);
+    REQUIRE(transfer() == std::set<uint32_t>{750, 500});  // The last fragment carries the remainder
+
+    // A smaller path MTU lowers the ceiling at once
+    sender.set_path_mtu(576);
+    REQUIRE(sender.current_fragment_size() == 576 - overhead);
+    auto sizes = transfer();
+    REQUIRE_FALSE(sizes.empty());
+    REQUIRE(*sizes.rbegin() == 576 - overhead);
+    REQUIRE(sender.get_stats().retransmissions == 3);
+}
+
+// Drops every third datagram the size of a bulk symbol or more, acks and completions never
+class EveryThirdLossUdpTransport : public UDPTransport {
+public:
+    ssize_t send(const uint8_t* data, size_t size) override {
+        if (size > TransmissionManager::FRAGMENT_HEADER_SIZE && ++sent_ % 3 == 0) {
+            return static_cast<ssize_t>(size);
+        }
+        return UDPTransport::send(data, size);
+    }
+
+private:
+    uint64_t sent_ = 0;
+};
+
+TEST_CASE("TransmissionManager streams fountain-coded bulk transfers until decoded", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39271;
+    receiver_config.localPort = 39272;
+    connections.establish("sender", "127.0.0.1:39272", std::make_shared<EveryThirdLossUdpTransport>(), sender_config);
+    connections.establish("receiver", "127.0.0.1:39271", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.bulk.symbol_size = 1000;
+        config.bulk.block_symbols = 64;
+        config.bulk.max_duration_ms = 5000;
+        config.bulk.send_rate = 50 * 1024 * 1024;  // Within what loopback takes without dropping more
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    std::vector<uint8_t> payload(300 * 1000 + 123);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+    }
+    auto received = std::async(std::launch::async, [&] { return receiver.receive_bulk(5000); });
+    auto sent = sender.send_bulk(utils::ByteSpan(payload));
+    auto result = received.get();
+    REQUIRE(sent.has_value());
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == payload);
+
+    // A third of the symbols were lost and made up by repair symbols, with nothing retransmitted
+    const auto stats = sender.get_stats();
+    REQUIRE(stats.bulk_symbols_sent > 301 * 3 / 2);
+    REQUIRE(stats.retransmissions == 0);
+    REQUIRE(receiver.get_stats().bulk_symbols_received >= 301);
+
+    // Regular messages are unaffected; receive() refuses symbols still in flight after completion
+    const std::vector<uint8_t> message(700, 0x42);
+    auto regular = std::async(std::launch::async, [&] {
+        for (int attempt = 0; attempt < 2000; ++attempt) {
+            auto result = receiver.receive(200);
+            if (result.has_value() && !result.value().empty()) {
+                return result.value();
+            }
+        }
+        return std::vector<uint8_t>{};
+    });
+    REQUIRE(sender.send(message).has_value());
+    REQUIRE(regular.get() == message);
+
+    // Without a receiver the sender gives up
+    auto config = sender.get_config();
+    config.bulk.max_duration_ms = 200;
+    sender.set_config(config);
+    REQUIRE_FALSE(sender.send_bulk(utils::ByteSpan(payload)).has_value());
+}
+
+// Sends every fragment twice, as spurious retransmissions would, and keeps a copy of each
+class DuplicatingUdpTransport : public UDPTransport {
+public:
+    std::vector<std::vector<uint8_t>> sent_fragments;
+
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override {
+        if (count == 2 && buffers[0].size() == TransmissionManager::FRAGMENT_HEADER_SIZE) {
+            std::vector<uint8_t> datagram(buffers[0].begin(), buffers[0].end());
+            datagram.insert(datagram.end(), buffers[1].begin(), buffers[1].end());
+            sent_fragments.push_back(datagram);
+            UDPTransport::send(datagram.data(), datagram.size());
+        }
+        return UDPTransport::sendv(buffers, count);
+    }
+};
+
+TEST_CASE("TransmissionManager drops duplicate and replayed fragments unverified", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39281;
+    receiver_config.localPort = 39282;
+    auto sender_transport = std::make_shared<DuplicatingUdpTransport>();
+    connections.establish("sender", "127.0.0.1:39282", sender_transport, sender_config);
+    connections.establish("receiver", "127.0.0.1:39281", std::make_shared<UDPTransport>(), receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        config.flow_control.enable_pipelining = false;
+        config.replay.unsealed = true;  // No record layer here, and the sender never restarts
+        manager->set_config(config);
+    }
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    const std::vector<uint8_t> message(1400, 0x5A);
+    std::vector<std::vector<uint8_t>> delivered;
+    auto drain = [&](int attempts) {
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            auto result = receiver.receive(50);
+            if (result.has_value()) {
+                delivered.push_back(result.value());
+            }
+        }
+    };
+    std::thread reader([&] { drain(40); });
+    REQUIRE(sender.send(message).has_value());
+    reader.join();
+
+    // Each of the three fragments was delivered once; every other copy, retransmissions included, was dropped
+    REQUIRE(delivered == std::vector<std::vector<uint8_t>>{message});
+    auto stats = receiver.get_stats();
+    REQUIRE(stats.duplicates_dropped + stats.replays_dropped == 2 * sender_transport->sent_fragments.size() - 3);
+
+    // Replaying the whole message, corrupted or not, delivers nothing
+    for (auto datagram : sender_transport->sent_fragments) {
+        sender_transport->UDPTransport::send(datagram.data(), datagram.size());
+        datagram.back() ^= 0xFF;
+        sender_transport->UDPTransport::send(datagram.data(), datagram.size());
+    }
+    drain(40);
+    REQUIRE(delivered.size() == 1);
+    REQUIRE(receiver.get_stats().replays_dropped ==
+            stats.replays_dropped + 2 * sender_transport->sent_fragments.size());
+}
+
+// Counts the SACK frames a receiver sends back
+class SackCountingUdpTransport : public UDPTransport {
+public:
+    std::atomic<int> sacks{0};
+
+    ssize_t send(const uint8_t* data, size_t size) override {
+        if (size == 1 + sizeof(TransmissionManager::SelectiveAck) &&
+            data[0] == static_cast<uint8_t>(TransmissionManager::AckFrameType::SELECTIVE_ACK)) {
+            sacks.fetch_add(1);
+        }
+        return UDPTransport::send(data, size);
+    }
+};
+
+// Loses the first transmission of one fragment
+class FragmentDroppingUdpTransport : public UDPTransport {
+public:
+    uint16_t drop_index = 0;
+    bool dropped = false;
+
+    ssize_t sendv(const utils::ByteSpan* buffers, size_t count) override {
+        if (!dropped && count == 2 && buffers[0].size() == TransmissionManager::FRAGMENT_HEADER_SIZE &&
+            (buffers[0][8] | buffers[0][9] << 8) == drop_index) {
+            dropped = true;
+            return static_cast<ssize_t>(buffers[0].size() + buffers[1].size());
+        }
+        return UDPTransport::sendv(buffers, count);
+    }
+};
+
+TEST_CASE("TransmissionManager batches selective ACKs without stalling the sender", "[transmission_manager]") {
+    ConnectionManager connections;
+    ConnectionConfig sender_config, receiver_config;
+    sender_config.localPort = 39291;
+    receiver_config.localPort = 39292;
+    auto sender_transport = std::make_shared<FragmentDroppingUdpTransport>();
+    auto receiver_transport = std::make_shared<SackCountingUdpTransport>();
+    connections.establish("sender", "127.0.0.1:39292", sender_transport, sender_config);
+    connections.establish("receiver", "127.0.0.1:39291", receiver_transport, receiver_config);
+
+    TransmissionManager sender(connections), receiver(connections);
+    for (auto* manager : {&sender, &receiver}) {
+        auto config = manager->get_config();
+        config.security.level = SecurityLevel::LOW;
+        config.fragment_config.max_fragment_size = 500;
+        config.flow_control.enable_pacing = false;
+        config.retransmission_config.sack_frequency = 1000;  // Only the timer, completion or the sender release a SACK
+        manager->set_config(config);
+    }
+    REQUIRE(sender.get_config().retransmission_config.enable_selective_ack);
+    REQUIRE(sender.bind_connection("sender").has_value());
+    REQUIRE(receiver.bind_connection("receiver").has_value());
+
+    std::vector<std::vector<uint8_t>> delivered;
+    auto receive_one = [&] {
+        for (int attempt = 0; attempt < 40 && delivered.empty(); ++attempt) {
+            auto result = receiver.receive(50);
+            if (result.has_value()) {
+                delivered.push_back(result.value());
+            }
+        }
+    };
+
+    SECTION("Stop-and-wait fragments are acknowledged one by one") {
+        sender_transport->dropped = true;
+        auto config = sender.get_config();
+        config.flow_control.enable_pipelining = false;
+        sender.set_config(config);
+
+        const std::vector<uint8_t> message(1400, 0x3C);
+        std::thread reader(receive_one);
+        REQUIRE(sender.send(message).has_value());
+        reader.join();
+        REQUIRE(delivered == std::vector<std::vector<uint8_t>>{message});
+        REQUIRE(receiver_transport->sacks.load() == 3);
+        REQUIRE(sender.get_stats().retransmissions == 0);
+    }
+
+    SECTION("Pipelined fragments share SACKs") {
+        sender_transport->dropped = true;
+        std::vector<uint8_t> message(20000);
+        for (size_t i = 0; i < message.size(); ++i) {
+            message[i] = static_cast<uint8_t>(i * 7);
+        }
+        std::thread reader(receive_one);
+        REQUIRE(sender.send(message).has_value());
+        reader.join();
+        REQUIRE(delivered == std::vector<std::vector<uint8_t>>{message});
+        REQUIRE(receiver_transport->sacks.load() < 40);
+        REQUIRE(sender.get_stats().retransmissions == 0);
+    }
+
+    SECTION("A held-back SACK goes out when the receiver times out") {
+        // The last fragment is lost, so nothing arrives to release the SACK for the ones before it
+        sender_transport->drop_index = 3;
+        const std::vector<uint8_t> message(2000, 0x77);
+        std::thread reader(receive_one);
+        REQUIRE(sender.send(message).has_value());
+        reader.join();
+        REQUIRE(delivered == std::vector<std::vector<uint8_t>>{message});
+        REQUIRE(sender.get_stats().retransmissions == 1);
+    }
+}
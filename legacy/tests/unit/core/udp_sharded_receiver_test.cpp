@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/udp_sharded_receiver.hpp"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+TEST(UDPShardedReceiverTest, SteersEachPeerToOneShard) {
+    UDPShardedReceiver::Config config;
+    config.shards = 4;
+    config.pollInterval = std::chrono::milliseconds(20);
+    UDPShardedReceiver receiver(config);
+
+    std::mutex mutex;
+    std::map<uint16_t, std::set<size_t>> shardsByPeer;
+    size_t misrouted = 0;
+    size_t received = 0;
+    ASSERT_TRUE(receiver.start([&](size_t shard, UDPTransport&, const DatagramRing& ring) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < ring.size(); ++i) {
+            const sockaddr_in& sender = ring.sender(i);
+            shardsByPeer[ntohs(sender.sin_port)].insert(shard);
+            if (UDPTransport::reusePortShard(sender.sin_addr.s_addr, sender.sin_port, 4) != shard) {
+                ++misrouted;
+            }
+            ++received;
+        }
+    })) << receiver.lastError();
+    ASSERT_EQ(receiver.shardCount(), 4u);
+    ASSERT_NE(receiver.port(), 0);
+
+    constexpr size_t PEERS = 8;
+    constexpr size_t DATAGRAMS = 25;
+    std::vector<std::unique_ptr<UDPTransport>> peers;
+    ConnectionConfig connection;
+    connection.healthMonitoring = false;
+    for (size_t p = 0; p < PEERS; ++p) {
+        peers.push_back(std::make_unique<UDPTransport>());
+        ASSERT_TRUE(peers.back()->connect("127.0.0.1:" + std::to_string(receiver.port()), connection));
+    }
+    const uint8_t payload[] = {'f', 'r', 'a', 'g'};
+    for (size_t d = 0; d < DATAGRAMS; ++d) {
+        for (auto& peer : peers) {
+            ASSERT_EQ(peer->send(payload, sizeof(payload)), static_cast<ssize_t>(sizeof(payload)));
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received == PEERS * DATAGRAMS) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    uint64_t counted = 0;
+    for (size_t shard = 0; shard < receiver.shardCount(); ++shard) {
+        counted += receiver.datagramsReceived(shard);
+    }
+    receiver.stop();
+    EXPECT_FALSE(receiver.running());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received, PEERS * DATAGRAMS);
+    EXPECT_EQ(counted, PEERS * DATAGRAMS);
+    EXPECT_EQ(misrouted, 0u);
+    EXPECT_EQ(shardsByPeer.size(), PEERS);
+    for (const auto& entry : shardsByPeer) {
+        EXPECT_EQ(entry.second.size(), 1u) << "peer port " << entry.first;
+    }
+}
+
+TEST(UDPShardedReceiverTest, RestartsOnTheSamePort) {
+    UDPShardedReceiver::Config config;
+    config.shards = 2;
+    config.steerByPeer = false;
+    config.pollInterval = std::chrono::milliseconds(20);
+    UDPShardedReceiver first(config);
+    ASSERT_TRUE(first.start([](size_t, UDPTransport&, const DatagramRing&) {})) << first.lastError();
+    EXPECT_FALSE(first.start([](size_t, UDPTransport&, const DatagramRing&) {}));
+
+    // Another group may join the port, since every member binds with SO_REUSEPORT
+    config.port = first.port();
+    UDPShardedReceiver second(config);
+    EXPECT_TRUE(second.start([](size_t, UDPTransport&, const DatagramRing&) {})) << second.lastError();
+    EXPECT_EQ(second.port(), config.port);
+    second.stop();
+    first.stop();
+    EXPECT_EQ(first.shardCount(), 0u);
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
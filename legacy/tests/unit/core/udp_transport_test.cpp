@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "xenocomm/core/udp_transport.hpp"
+#include <atomic>
 #include <thread>
 #include <future>
 #include <chrono>
@@ -250,6 +251,105 @@ TEST_F(UDPTransportTest, MulticastCommunication) {
     // receiver->cleanup(); // Removed
 }
 
+TEST_F(UDPTransportTest, ReactorDeliversReadiness) {
+    UDPTransport sender;
+    UDPTransport receiver;
+    ASSERT_TRUE(sender.setLocalPort(40101));
+    ASSERT_TRUE(receiver.setLocalPort(40102));
+    ASSERT_TRUE(sender.connect("127.0.0.1:40102", config_));
+    ASSERT_TRUE(receiver.connect("127.0.0.1:40101", config_));
+
+    EventReactor reactor;
+    std::atomic<size_t> datagrams{0};
+    std::atomic<bool> drained{false};
+    ASSERT_TRUE(receiver.attachReactor(reactor, EventReactor::READABLE, [&](uint32_t) {
+        uint8_t buffer[256];
+        while (receiver.receive(buffer, sizeof(buffer)) > 0) {
+            ++datagrams;
+        }
+        drained = receiver.getLastErrorCode() == TransportError::WOULD_BLOCK;
+    }));
+    EXPECT_FALSE(receiver.attachReactor(reactor, EventReactor::READABLE, [](uint32_t) {}));
+
+    std::vector<uint8_t> data = {1, 2, 3};
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(sender.send(data.data(), data.size()), 3);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (datagrams < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(datagrams, 3u);
+    EXPECT_TRUE(drained);
+
+    // Disconnecting unregisters before the socket is closed
+    EXPECT_TRUE(receiver.disconnect());
+    EXPECT_EQ(reactor.watchedCount(), 0u);
+}
+
+TEST_F(UDPTransportTest, BatchSendReceive) {
+    UDPTransport sender;
+    UDPTransport receiver;
+    ASSERT_TRUE(sender.setLocalPort(40103));
+    ASSERT_TRUE(receiver.setLocalPort(40104));
+    ASSERT_TRUE(sender.connect("127.0.0.1:40104", config_));
+    ASSERT_TRUE(receiver.connect("127.0.0.1:40103", config_));
+
+    std::vector<std::vector<uint8_t>> payloads;
+    for (uint8_t i = 0; i < 10; ++i) {
+        payloads.emplace_back(100 + i, i);
+    }
+    std::vector<utils::ByteSpan> spans(payloads.begin(), payloads.end());
+    ASSERT_EQ(sender.sendBatch(spans.data(), spans.size()), 10);
+
+    DatagramRing ring(16, 2048);
+    size_t received = 0;
+    while (received < payloads.size()) {
+        ASSERT_GT(receiver.receiveBatch(ring), 0);
+        for (const auto& datagram : ring) {
+            ASSERT_LT(received, payloads.size());
+            EXPECT_EQ(datagram.to_vector(), payloads[received]);
+            ++received;
+        }
+    }
+}
+
+TEST_F(UDPTransportTest, BatchWithSegmentationOffload) {
+    UDPTransport sender;
+    UDPTransport receiver;
+    ASSERT_TRUE(sender.setLocalPort(40105));
+    ASSERT_TRUE(receiver.setLocalPort(40106));
+    ASSERT_TRUE(sender.connect("127.0.0.1:40106", config_));
+    ASSERT_TRUE(receiver.connect("127.0.0.1:40105", config_));
+    if (!sender.enableGso(true) || !receiver.enableGro(true)) {
+        GTEST_SKIP() << "UDP GSO/GRO not supported on this platform";
+    }
+
+    // Equal 1 KB fragments with a short tail coalesce into one GSO send
+    std::vector<std::vector<uint8_t>> payloads;
+    for (uint8_t i = 0; i < 8; ++i) {
+        payloads.emplace_back(1024, i);
+    }
+    payloads.emplace_back(300, 0xEE);
+    std::vector<utils::ByteSpan> spans(payloads.begin(), payloads.end());
+    ASSERT_EQ(sender.sendBatch(spans.data(), spans.size()), 9);
+
+    DatagramRing smallRing(4, 2048);
+    EXPECT_EQ(receiver.receiveBatch(smallRing), -1);  // GRO needs 64 KB slots
+
+    DatagramRing ring(4, 65536);
+    size_t received = 0;
+    while (received < payloads.size()) {
+        ASSERT_GT(receiver.receiveBatch(ring), 0);
+        for (const auto& datagram : ring) {
+            ASSERT_LT(received, payloads.size());
+            EXPECT_EQ(datagram.to_vector(), payloads[received]);
+            ++received;
+        }
+    }
+}
+
 } // namespace test
 } // namespace core
 } // namespace xenocomm 
\ No newline at end of file
@@ -63,6 +63,30 @@ TEST_F(VersionTest, EdgeCases) {
     EXPECT_FALSE(v0_0_0.isNewerThan(v0_0_0));
 }
 
+TEST_F(VersionTest, PackedOrderMatchesVersionOrder) {
+    static_assert(Version(1, 2, 3).packed() == 0x000100020003ULL);
+    static_assert(Version::fromPacked(Version(7, 8, 9).packed()) == Version(7, 8, 9));
+
+    // Each component outranks every value of the ones after it
+    EXPECT_LT(Version(1, 65535, 65535).packed(), v2_0_0.packed());
+    EXPECT_LT(Version(1, 0, 65535).packed(), v1_1_0.packed());
+    EXPECT_TRUE(Version(1, 65535, 65535) < v2_0_0);
+    EXPECT_TRUE(Version(2, 0, 1).satisfies(Version(1, 65535, 65535)));
+    EXPECT_FALSE(Version(1, 65535, 65535).isCompatibleWith(v2_0_0));
+}
+
+TEST_F(VersionTest, HashAndFormatting) {
+    std::hash<Version> hasher;
+    EXPECT_EQ(hasher(v1_1_0), hasher(Version(1, 1, 0)));
+    EXPECT_NE(hasher(v1_1_0), hasher(Version(0, 1, 1)));
+
+    Version vMax{65535, 65535, 65535};
+    char buffer[Version::MAX_STRING_LENGTH];
+    ASSERT_EQ(vMax.formatTo(buffer), Version::MAX_STRING_LENGTH);
+    EXPECT_EQ(std::string(buffer, Version::MAX_STRING_LENGTH), "65535.65535.65535");
+    EXPECT_EQ(Version(0, 0, 0).toString(), "0.0.0");
+}
+
 // This is a placeholder test to verify the test framework is working
 TEST(VersionTest, TestFrameworkWorks) {
     EXPECT_TRUE(true);
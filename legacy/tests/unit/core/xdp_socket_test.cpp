@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "xenocomm/core/udp_transport.hpp"
+#include "xenocomm/core/xdp_socket.hpp"
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace xenocomm {
+namespace core {
+namespace {
+
+TEST(XdpSocketTest, RefusesBadConfiguration) {
+    XdpSocket::Config config;
+    config.interfaceName = "lo";
+    config.port = 39301;
+    config.frameSize = 3000;
+    XdpSocket badFrames(config);
+    EXPECT_FALSE(badFrames.isValid());
+    EXPECT_FALSE(badFrames.error().empty());
+
+    config.frameSize = 2048;
+    config.interfaceName = "no-such-interface";
+    XdpSocket badInterface(config);
+    EXPECT_FALSE(badInterface.isValid());
+    XdpSocket::Datagram datagram;
+    EXPECT_EQ(badInterface.receive(&datagram, 1), 0u);
+}
+
+TEST(XdpSocketTest, TakesThePortsDatagramsBeforeTheStack) {
+    XdpSocket::Config config;
+    config.interfaceName = "lo";
+    config.port = 39302;
+    config.frameCount = 256;
+    XdpSocket xdp(config);
+    if (!xdp.isValid()) {
+        GTEST_SKIP() << "AF_XDP unavailable here: " << xdp.error();
+    }
+
+    // No socket is bound to the port; only the redirect can deliver these
+    int sender = ::socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sender, 0);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(config.port);
+    target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    constexpr int COUNT = 500;  // More than the UMEM holds, so frames must be recycled
+    std::set<int> seen;
+    XdpSocket::Datagram datagrams[32];
+    for (int i = 0; i < COUNT; ++i) {
+        char payload[16];
+        const int length = std::snprintf(payload, sizeof(payload), "fragment-%d", i);
+        ASSERT_EQ(::sendto(sender, payload, length, 0, reinterpret_cast<sockaddr*>(&target), sizeof(target)), length);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        size_t taken = 0;
+        while (taken == 0 && std::chrono::steady_clock::now() < deadline) {
+            pollfd pfd{xdp.fd(), POLLIN, 0};
+            ::poll(&pfd, 1, 10);
+            taken = xdp.receive(datagrams, 32);
+        }
+        ASSERT_GT(taken, 0u) << "datagram " << i << " never arrived";
+        for (size_t d = 0; d < taken; ++d) {
+            const std::string text(reinterpret_cast<const char*>(datagrams[d].payload.data()),
+                                   datagrams[d].payload.size());
+            ASSERT_EQ(text.rfind("fragment-", 0), 0u);
+            seen.insert(std::stoi(text.substr(9)));
+            EXPECT_EQ(datagrams[d].sender.sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+        }
+    }
+    EXPECT_EQ(seen.size(), static_cast<size_t>(COUNT));
+    ::close(sender);
+
+    // Only one program per interface, and it filters one port
+    config.queue = 1;
+    config.port = 39303;
+    XdpSocket otherPort(config);
+    EXPECT_FALSE(otherPort.isValid());
+}
+
+TEST(XdpSocketTest, TransportFallsBackToItsSocket) {
+    ConnectionConfig connection;
+    connection.healthMonitoring = false;
+    UDPTransport sender, receiver;
+    ASSERT_TRUE(sender.setLocalPort(39304));
+    ASSERT_TRUE(receiver.setLocalPort(39305));
+    ASSERT_TRUE(sender.connect("127.0.0.1:39305", connection));
+    ASSERT_TRUE(receiver.connect("127.0.0.1:39304", connection));
+    ASSERT_TRUE(receiver.setReceiveTimeout(std::chrono::milliseconds(1000)));
+
+    EXPECT_FALSE(receiver.enableXdp("no-such-interface"));
+    EXPECT_FALSE(receiver.xdpActive());
+    const bool bypass = receiver.enableXdp("lo");
+    EXPECT_EQ(bypass, receiver.xdpActive());
+
+    const uint8_t payload[] = {1, 2, 3, 4, 5};
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(sender.send(payload, sizeof(payload)), static_cast<ssize_t>(sizeof(payload)));
+    }
+    DatagramRing ring(16);
+    size_t received = 0;
+    while (received < 10) {
+        ssize_t batch = receiver.receiveBatch(ring);
+        ASSERT_GT(batch, 0) << receiver.getLastError();
+        for (const auto& datagram : ring) {
+            EXPECT_EQ(datagram.size(), sizeof(payload));
+            EXPECT_EQ(std::memcmp(datagram.data(), payload, sizeof(payload)), 0);
+        }
+        EXPECT_EQ(ntohs(ring.sender(0).sin_port), 39304);
+        received += static_cast<size_t>(batch);
+    }
+    EXPECT_EQ(received, 10u);
+    receiver.disableXdp();
+    EXPECT_FALSE(receiver.xdpActive());
+}
+
+} // namespace
+} // namespace core
+} // namespace xenocomm
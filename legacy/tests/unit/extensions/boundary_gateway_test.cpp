@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/boundary_gateway.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::extensions;
+using namespace std::chrono_literals;
+
+TEST(TokenBucketTest, AdmitsUpToCapacity) {
+    TokenBucket bucket({3, 0.001});
+    EXPECT_TRUE(bucket.tryAcquire());
+    EXPECT_TRUE(bucket.tryAcquire(2));
+    EXPECT_FALSE(bucket.tryAcquire());
+    EXPECT_EQ(bucket.acquired(), 2u);
+    EXPECT_EQ(bucket.denied(), 1u);
+}
+
+TEST(TokenBucketTest, ZeroRefillIsAFixedBudget) {
+    TokenBucket bucket({1, 0});
+    EXPECT_TRUE(bucket.tryAcquire());
+    std::this_thread::sleep_for(5ms);
+    EXPECT_FALSE(bucket.tryAcquire());
+    EXPECT_DOUBLE_EQ(bucket.available(), 0.0);
+}
+
+TEST(TokenBucketTest, RefillsOverTime) {
+    TokenBucket bucket({2, 100});
+    EXPECT_TRUE(bucket.tryAcquire(2));
+    EXPECT_FALSE(bucket.tryAcquire());
+    std::this_thread::sleep_for(30ms);
+    EXPECT_TRUE(bucket.tryAcquire(2));
+}
+
+TEST(TokenBucketTest, RefundRestoresTokens) {
+    TokenBucket bucket({2, 0});
+    EXPECT_TRUE(bucket.tryAcquire(2));
+    bucket.refund(1);
+    EXPECT_DOUBLE_EQ(bucket.available(), 1.0);
+    bucket.refund(5);
+    EXPECT_DOUBLE_EQ(bucket.available(), 2.0);  // Never more than full
+}
+
+TEST(TokenBucketTest, SetLimitKeepsTokensTaken) {
+    TokenBucket bucket({4, 0});
+    EXPECT_TRUE(bucket.tryAcquire(3));
+    bucket.setLimit({10, 0});
+    EXPECT_NEAR(bucket.available(), 7.0, 1e-6);
+    EXPECT_NEAR(bucket.limit().capacity, 10.0, 1e-6);
+}
+
+TEST(TokenBucketTest, ConcurrentCallersNeverOverdraw) {
+    TokenBucket bucket({1000, 0});
+    std::atomic<int> admitted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 500; ++i) {
+                if (bucket.tryAcquire()) {
+                    admitted.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(admitted.load(), 1000);
+    EXPECT_EQ(bucket.denied(), 3000u);
+}
+
+TEST(GatewayRateLimiterTest, LimitsEachAgentSeparately) {
+    GatewayRateLimitConfig config;
+    config.perAgent = RateLimit{2, 0};
+    GatewayRateLimiter limiter(config);
+
+    EXPECT_TRUE(limiter.acquire("a", "search").allowed);
+    EXPECT_TRUE(limiter.acquire("a", "search").allowed);
+    auto denied = limiter.acquire("a", "search");
+    EXPECT_FALSE(denied.allowed);
+    EXPECT_EQ(denied.limitedBy, RateLimitScope::AGENT);
+    EXPECT_TRUE(limiter.acquire("b", "search").allowed);
+    EXPECT_FALSE(limiter.apiAvailable("search").has_value());  // APIs are unlimited
+}
+
+TEST(GatewayRateLimiterTest, DeniedLevelRefundsEarlierOnes) {
+    GatewayRateLimitConfig config;
+    config.perAgent = RateLimit{5, 0};
+    config.perApi = RateLimit{1, 0};
+    GatewayRateLimiter limiter(config);
+
+    EXPECT_TRUE(limiter.acquire("a", "search").allowed);
+    auto denied = limiter.acquire("a", "search");
+    EXPECT_EQ(denied.limitedBy, RateLimitScope::API);
+    EXPECT_DOUBLE_EQ(*limiter.agentAvailable("a"), 4.0);
+    EXPECT_TRUE(limiter.acquire("a", "translate").allowed);
+}
+
+TEST(GatewayRateLimiterTest, GlobalBucketSharedByAll) {
+    GatewayRateLimitConfig config;
+    config.global = RateLimit{2, 0};
+    GatewayRateLimiter limiter(config);
+
+    EXPECT_TRUE(limiter.acquire("a", "x").allowed);
+    EXPECT_TRUE(limiter.acquire("b", "y").allowed);
+    EXPECT_EQ(limiter.acquire("c", "z").limitedBy, RateLimitScope::GLOBAL);
+
+    auto stats = limiter.getStats();
+    EXPECT_EQ(stats.admitted, 2u);
+    EXPECT_EQ(stats.deniedGlobally, 1u);
+    EXPECT_EQ(stats.agents, 0u);  // Unlimited levels keep no buckets
+}
+
+TEST(GatewayRateLimiterTest, OverridesReplaceTheDefault) {
+    GatewayRateLimitConfig config;
+    config.perAgent = RateLimit{1, 0};
+    GatewayRateLimiter limiter(config);
+    limiter.setAgentLimit("trusted", {3, 0});
+    limiter.setApiLimit("admin", {0, 0});
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(limiter.acquire("trusted", "").allowed);
+    }
+    EXPECT_FALSE(limiter.acquire("trusted", "").allowed);
+    EXPECT_EQ(limiter.acquire("other", "admin").limitedBy, RateLimitScope::API);
+}
+
+TEST(ResponseCacheTest, StoresAndInvalidates) {
+    ResponseCache<std::string> cache;
+    EXPECT_FALSE(cache.get("k").has_value());
+    cache.set("k", "v");
+    EXPECT_EQ(*cache.get("k"), "v");
+    cache.set("k", "w");
+    EXPECT_EQ(*cache.get("k"), "w");
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.invalidate("k"));
+    EXPECT_FALSE(cache.invalidate("k"));
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST(ResponseCacheTest, EntriesExpire) {
+    ResponseCache<int> cache;
+    cache.set("short", 1, 10ms);
+    cache.set("long", 2, 10s);
+    cache.set("forever", 3);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(cache.get("short").has_value());
+    EXPECT_EQ(*cache.get("long"), 2);
+    EXPECT_EQ(*cache.get("forever"), 3);
+    EXPECT_EQ(cache.getStats().expirations, 1u);
+}
+
+TEST(ResponseCacheTest, CleanupDropsOnlyExpired) {
+    ResponseCache<int> cache(0, 10ms);
+    for (int i = 0; i < 50; ++i) {
+        cache.set("k" + std::to_string(i), i);
+    }
+    cache.set("kept", 0, std::chrono::milliseconds(0));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(cache.cleanupExpired(), 50u);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(ResponseCacheTest, FullShardEvictsSoonestToExpire) {
+    ResponseCache<int> cache(ResponseCache<int>::SHARD_COUNT);  // One entry a shard
+    for (int i = 0; i < 200; ++i) {
+        cache.set("k" + std::to_string(i), i, 1min);
+    }
+    EXPECT_LE(cache.size(), ResponseCache<int>::SHARD_COUNT);
+    EXPECT_EQ(cache.getStats().evictions, 200u - cache.size());
+    EXPECT_EQ(*cache.get("k199"), 199);  // The newest entry always survives
+}
+
+TEST(ResponseCacheTest, InvalidateIfMatchesKeysAndValues) {
+    ResponseCache<int> cache;
+    cache.set("agent1:a", 1);
+    cache.set("agent1:b", 2);
+    cache.set("agent2:a", 3);
+    EXPECT_EQ(cache.invalidateIf([](const std::string& key, const int&) { return key.rfind("agent1:", 0) == 0; }), 2u);
+    EXPECT_EQ(cache.size(), 1u);
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+}
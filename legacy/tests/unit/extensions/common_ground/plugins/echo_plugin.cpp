@@ -0,0 +1,32 @@
+// Test plugin for test_plugin_loader.cpp. Build it as a shared library and pass
+// its path to the test as XENOCOMM_TEST_PLUGIN_PATH; ECHO_PLUGIN_VERSION picks
+// the verdict, so a second build stands in for a new version on reload.
+#include "xenocomm/extensions/common_ground/extensibility/plugin_api.hpp"
+
+#ifndef ECHO_PLUGIN_VERSION
+#define ECHO_PLUGIN_VERSION 1
+#endif
+
+using namespace xenocomm::common_ground;
+
+namespace {
+
+bool applies(void*, const AlignmentContext& context) {
+    return context.getRemoteAgentId() != "unknown";
+}
+
+AlignmentResult verifyEcho(void*, const AlignmentContext& context) {
+    bool aligned = ECHO_PLUGIN_VERSION == 1;
+    return AlignmentResult(aligned, aligned ? std::vector<std::string>{} : std::vector<std::string>{context.getRemoteAgentId()},
+                           ECHO_PLUGIN_VERSION / 10.0);
+}
+
+const PluginStrategyEntry STRATEGIES[] = {
+    {"echo", nullptr, applies, verifyEcho},
+};
+
+const PluginDescriptor DESCRIPTOR{PLUGIN_ABI_VERSION, "Echo", ECHO_PLUGIN_VERSION == 1 ? "1.0" : "2.0", STRATEGIES, 1};
+
+} // namespace
+
+XENOCOMM_DEFINE_PLUGIN(DESCRIPTOR)
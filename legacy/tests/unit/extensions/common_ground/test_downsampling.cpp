@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/common_ground/metrics/downsampling.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace xenocomm::extensions::common_ground::metrics;
+
+namespace {
+
+std::vector<TimeSeriesPoint> series(const std::vector<double>& values) {
+    std::vector<TimeSeriesPoint> points;
+    const auto start = std::chrono::system_clock::time_point(std::chrono::hours(24 * 365 * 50));
+    for (size_t i = 0; i < values.size(); ++i) {
+        points.push_back({start + std::chrono::minutes(i), values[i]});
+    }
+    return points;
+}
+
+bool inTimeOrder(const std::vector<TimeSeriesPoint>& points) {
+    return std::is_sorted(points.begin(), points.end(),
+                          [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; });
+}
+
+bool contains(const std::vector<TimeSeriesPoint>& points, double value) {
+    return std::any_of(points.begin(), points.end(), [value](const auto& p) { return p.value == value; });
+}
+
+} // namespace
+
+TEST(DownsamplingTest, LttbKeepsEndpointsAndSpikes) {
+    std::vector<double> values(1000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<double>(i) / 50.0);
+    }
+    values[437] = 10.0;
+
+    auto sampled = lttb(series(values), 50);
+    ASSERT_EQ(sampled.size(), 50u);
+    EXPECT_TRUE(inTimeOrder(sampled));
+    EXPECT_EQ(sampled.front().value, values.front());
+    EXPECT_EQ(sampled.back().value, values.back());
+    EXPECT_TRUE(contains(sampled, 10.0));
+}
+
+TEST(DownsamplingTest, ShortSeriesAreReturnedWhole) {
+    auto points = series({1, 2, 3, 4});
+    EXPECT_EQ(lttb(points, 4).size(), 4u);
+    EXPECT_EQ(lttb(points, 2).size(), 4u);  // Below 3 there is nothing to choose
+    EXPECT_EQ(minMaxPerBucket(points, 2).size(), 4u);
+    EXPECT_EQ(downsample(points, 0).size(), 4u);
+}
+
+TEST(DownsamplingTest, MinMaxKeepsBothExtremesOfEachBucket) {
+    std::vector<double> values(400, 0.5);
+    values[10] = -3.0;
+    values[11] = 3.0;
+    values[390] = 7.0;
+
+    auto sampled = minMaxPerBucket(series(values), 20);
+    EXPECT_LE(sampled.size(), 40u);
+    EXPECT_TRUE(inTimeOrder(sampled));
+    EXPECT_TRUE(contains(sampled, -3.0));
+    EXPECT_TRUE(contains(sampled, 3.0));
+    EXPECT_TRUE(contains(sampled, 7.0));
+}
+
+TEST(DownsamplingTest, ReducesEverySeriesOfTrends) {
+    AlignmentTrends trends;
+    trends.successRate = series(std::vector<double>(500, 0.9));
+    trends.convergenceTime = series(std::vector<double>(500, 120.0));
+    trends.strategyPerformance["goal"] = series(std::vector<double>(500, 0.7));
+
+    auto reduced = downsample(trends, 100);
+    EXPECT_EQ(reduced.successRate.size(), 100u);
+    EXPECT_EQ(reduced.convergenceTime.size(), 100u);
+    EXPECT_TRUE(reduced.resourceUtilization.empty());
+    EXPECT_EQ(reduced.strategyPerformance.at("goal").size(), 100u);
+    EXPECT_LE(downsample(trends, 100, DownsampleMethod::MIN_MAX).successRate.size(), 100u);
+}
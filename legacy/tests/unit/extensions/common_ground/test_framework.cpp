@@ -2,8 +2,13 @@
 #include "xenocomm/extensions/common_ground/framework.hpp"
 #include "xenocomm/extensions/common_ground/context.hpp"
 #include <any>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace xenocomm::common_ground;
@@ -52,4 +57,324 @@ TEST(CommonGroundFrameworkTest, RegisterAndRunStandardStrategies_FailsKnowledge)
     AlignmentContext ctx = makeContext(params);
     AlignmentResult result = framework.verifyAlignment(ctx);
     EXPECT_FALSE(result.isAligned());
-} 
\ No newline at end of file
+} 
+namespace {
+
+// Sleeps while verifying and records how many strategies verify at once
+class SlowStrategy : public IAlignmentStrategy {
+public:
+    SlowStrategy(std::string id, bool aligned, std::atomic<int>& active, std::atomic<int>& peak)
+        : id_(std::move(id)), aligned_(aligned), active_(active), peak_(peak) {}
+
+    std::string getId() const override { return id_; }
+    bool isApplicable(const AlignmentContext&) const override { return true; }
+    AlignmentResult verify(const AlignmentContext& context) override {
+        int now = ++active_;
+        int seen = peak_.load();
+        while (now > seen && !peak_.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        --active_;
+        ++runs;
+        return AlignmentResult(aligned_, {context.getRemoteAgentId()}, 1.0);
+    }
+
+    std::atomic<int> runs{0};
+
+private:
+    std::string id_;
+    bool aligned_;
+    std::atomic<int>& active_;
+    std::atomic<int>& peak_;
+};
+
+} // namespace
+
+TEST(CommonGroundFrameworkTest, InvokeBatchRunsStrategiesInParallelInOrder) {
+    StrategyExecutor executor(3);
+    StrategyInvoker invoker(nullptr, executor);
+    std::atomic<int> active{0}, peak{0};
+    std::vector<std::shared_ptr<IAlignmentStrategy>> strategies;
+    for (int i = 0; i < 5; ++i) {
+        strategies.push_back(std::make_shared<SlowStrategy>("s" + std::to_string(i), i != 3, active, peak));
+    }
+
+    auto results = invoker.invokeBatch(strategies, makeContext({}));
+    ASSERT_EQ(results.size(), 5u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].isAligned(), i != 3);
+    }
+    EXPECT_GT(peak.load(), 1);
+    EXPECT_LE(peak.load(), 4);  // Three workers and the caller
+}
+
+TEST(CommonGroundFrameworkTest, InvokeBatchStopsEarlyWhenCancelled) {
+    StrategyExecutor executor(1);
+    StrategyInvoker invoker(nullptr, executor);
+    std::atomic<int> active{0}, peak{0};
+    std::vector<std::shared_ptr<IAlignmentStrategy>> strategies;
+    for (int i = 0; i < 8; ++i) {
+        strategies.push_back(std::make_shared<SlowStrategy>("s" + std::to_string(i), false, active, peak));
+    }
+
+    CancellationToken cancel;
+    auto results = invoker.invokeBatch(strategies, makeContext({}), cancel,
+                                      [](const AlignmentResult& result) { return !result.isAligned(); });
+    EXPECT_TRUE(cancel.isCancelled());
+    EXPECT_GE(results.size(), 1u);
+    EXPECT_LE(results.size(), 2u);  // Only what the two threads had already started
+
+    cancel.cancel();
+    EXPECT_TRUE(invoker.invokeBatch(strategies, makeContext({}), cancel).empty());
+    EXPECT_THROW(invoker.invokeAsync(strategies[0], makeContext({}), cancel).get(), std::runtime_error);
+}
+
+TEST(CommonGroundFrameworkTest, AsyncCallsOwnACopyOfTheContext) {
+    StrategyExecutor executor(1);
+    StrategyInvoker invoker(nullptr, executor);
+    std::atomic<int> active{0}, peak{0};
+    auto strategy = std::make_shared<SlowStrategy>("slow", true, active, peak);
+
+    std::future<AlignmentResult> future;
+    {
+        AgentInfo local{"local", "LocalAgent", {}};
+        AgentInfo remote{"remote-copy", "RemoteAgent", {}};
+        AlignmentContext context(local, remote, {});
+        future = invoker.invokeAsync(strategy, context);
+    }
+    AlignmentResult result = future.get();
+    ASSERT_EQ(result.getMisalignments().size(), 1u);
+    EXPECT_EQ(result.getMisalignments()[0], "remote-copy");
+
+    FrameworkConfig config{"test_framework"};
+    CommonGroundFramework framework(config);
+    framework.registerStrategy(strategy);
+    EXPECT_TRUE(framework.verifyAlignmentAsync(makeContext({})).get().isAligned());
+    EXPECT_EQ(strategy->runs.load(), 2);
+}
+
+namespace {
+
+class FixedStrategy : public IAlignmentStrategy {
+public:
+    FixedStrategy(std::string id, AlignmentResult result) : id_(std::move(id)), result_(std::move(result)) {}
+
+    std::string getId() const override { return id_; }
+    bool isApplicable(const AlignmentContext&) const override { return true; }
+    AlignmentResult verify(const AlignmentContext&) override { return result_; }
+
+private:
+    std::string id_;
+    AlignmentResult result_;
+};
+
+std::vector<std::string> idsOf(const std::vector<std::shared_ptr<IAlignmentStrategy>>& strategies) {
+    std::vector<std::string> ids;
+    for (const auto& strategy : strategies) {
+        ids.push_back(strategy->getId());
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST(CommonGroundFrameworkTest, SchedulerRunsCheapLikelyFailuresFirst) {
+    StrategyScheduler scheduler;
+    std::vector<std::shared_ptr<IAlignmentStrategy>> strategies = {
+        std::make_shared<FixedStrategy>("knowledge", AlignmentResult(true, {}, 1.0)),
+        std::make_shared<FixedStrategy>("goal", AlignmentResult(true, {}, 1.0)),
+        std::make_shared<FixedStrategy>("terminology", AlignmentResult(true, {}, 1.0)),
+    };
+    // Nothing measured: the incoming (priority) order stands
+    EXPECT_EQ(idsOf(scheduler.order(strategies)), (std::vector<std::string>{"knowledge", "goal", "terminology"}));
+
+    for (int i = 0; i < 10; ++i) {
+        scheduler.recordExecution("knowledge", std::chrono::milliseconds(40), i % 2 == 0);
+        scheduler.recordExecution("terminology", std::chrono::microseconds(200), i % 2 == 0);
+        scheduler.recordExecution("goal", std::chrono::microseconds(200), true);
+    }
+    // Same cost: the one that fails more often goes first; unmeasured ones never pass a cheaper, likelier failure
+    EXPECT_EQ(idsOf(scheduler.order(strategies)), (std::vector<std::string>{"terminology", "goal", "knowledge"}));
+
+    auto estimate = scheduler.estimate("terminology");
+    ASSERT_TRUE(estimate.has_value());
+    EXPECT_EQ(estimate->runs, 10u);
+    EXPECT_EQ(estimate->cost, std::chrono::microseconds(200));
+    EXPECT_DOUBLE_EQ(estimate->failureRate, 6.0 / 12.0);
+    EXPECT_FALSE(scheduler.estimate("unknown").has_value());
+}
+
+TEST(CommonGroundFrameworkTest, AggregatesConfidenceAcrossStrategies) {
+    AlignmentResult aligned = CommonGroundFramework::aggregateResults(
+        {AlignmentResult(true, {}, 1.0), AlignmentResult(true, {}, 0.6)});
+    EXPECT_TRUE(aligned.isAligned());
+    EXPECT_DOUBLE_EQ(aligned.getConfidenceScore(), 0.8);
+
+    AlignmentResult misaligned = CommonGroundFramework::aggregateResults(
+        {AlignmentResult(true, {}, 0.9), AlignmentResult(false, {"terms"}, 0.3), AlignmentResult(false, {"goal"}, 0.4)});
+    EXPECT_FALSE(misaligned.isAligned());
+    EXPECT_DOUBLE_EQ(misaligned.getConfidenceScore(), 0.3);
+    EXPECT_EQ(misaligned.getMisalignments(), (std::vector<std::string>{"terms", "goal"}));
+
+    EXPECT_TRUE(CommonGroundFramework::aggregateResults({}).isAligned());
+}
+
+TEST(CommonGroundFrameworkTest, VerifyAlignmentStopsAtADecisiveMisalignment) {
+    FrameworkConfig config{"test_framework"};
+    CommonGroundFramework framework(config);
+    std::atomic<int> active{0}, peak{0};
+    const size_t slowCount = StrategyExecutor::shared().workerCount() + 3;
+    std::vector<std::shared_ptr<SlowStrategy>> slow;
+    for (size_t i = 0; i < slowCount; ++i) {
+        slow.push_back(std::make_shared<SlowStrategy>("slow" + std::to_string(i), true, active, peak));
+        framework.registerStrategy(slow.back());
+    }
+    // Lowest priority, but measured as cheap and failing
+    framework.registerStrategy(std::make_shared<FixedStrategy>("cheap", AlignmentResult(false, {"terms"}, 0.0)), 10);
+    for (int i = 0; i < 5; ++i) {
+        framework.strategyScheduler().recordExecution("cheap", std::chrono::microseconds(50), false);
+    }
+
+    AlignmentResult result = framework.verifyAlignment(makeContext({}));
+    EXPECT_FALSE(result.isAligned());
+    EXPECT_DOUBLE_EQ(result.getConfidenceScore(), 0.0);
+    int slowRuns = 0;
+    for (const auto& strategy : slow) {
+        slowRuns += strategy->runs.load();
+    }
+    // Only strategies the workers had already claimed ran
+    EXPECT_LE(static_cast<size_t>(slowRuns), StrategyExecutor::shared().workerCount());
+    EXPECT_EQ(framework.strategyScheduler().estimate("cheap")->runs, 6u);
+
+    // Without short-circuiting every strategy runs
+    config.shortCircuit = false;
+    CommonGroundFramework exhaustive(config);
+    for (const auto& strategy : slow) {
+        exhaustive.registerStrategy(strategy);
+    }
+    exhaustive.registerStrategy(std::make_shared<FixedStrategy>("cheap", AlignmentResult(false, {"terms"}, 0.0)));
+    EXPECT_EQ(exhaustive.runApplicableStrategies(makeContext({})).size(), slowCount + 1);
+}
+
+namespace {
+
+class CountingStrategy : public IAlignmentStrategy {
+public:
+    explicit CountingStrategy(std::string id, bool aligned = true) : id_(std::move(id)), aligned_(aligned) {}
+
+    std::string getId() const override { return id_; }
+    bool isApplicable(const AlignmentContext&) const override { return true; }
+    AlignmentResult verify(const AlignmentContext&) override {
+        ++runs;
+        return AlignmentResult(aligned_, {}, aligned_ ? 1.0 : 0.0);
+    }
+
+    std::atomic<int> runs{0};
+
+private:
+    std::string id_;
+    bool aligned_;
+};
+
+} // namespace
+
+TEST(CommonGroundFrameworkTest, ReusesResultsForTheSameAgentPairAndParameters) {
+    FrameworkConfig config{"test_framework"};
+    CommonGroundFramework framework(config);
+    auto strategy = std::make_shared<CountingStrategy>("counting");
+    framework.registerStrategy(strategy);
+    std::map<std::string, std::any> params = {
+        {"remote_goal", std::string("goalA")},
+        {"remote_context", ContextData{{"foo"}}},
+        {"retries", 3},
+    };
+
+    EXPECT_TRUE(framework.verifyAlignment(makeContext(params)).isAligned());
+    EXPECT_TRUE(framework.verifyAlignment(makeContext(params)).isAligned());
+    EXPECT_EQ(strategy->runs.load(), 1);
+    EXPECT_EQ(framework.alignmentCache().hits(), 1u);
+
+    // Other parameters, or another remote agent, are verified afresh
+    params["retries"] = 4;
+    framework.verifyAlignment(makeContext(params));
+    AgentInfo local{"local", "LocalAgent", {}};
+    AgentInfo other{"other", "OtherAgent", {}};
+    framework.verifyAlignment(AlignmentContext(local, other, params));
+    EXPECT_EQ(strategy->runs.load(), 3);
+
+    // Narrowed to the goal, the retry count no longer matters
+    framework.alignmentCache().setRelevantParameters("counting", {"remote_goal"});
+    framework.verifyAlignment(makeContext(params));
+    params["retries"] = 5;
+    framework.verifyAlignment(makeContext(params));
+    EXPECT_EQ(strategy->runs.load(), 4);
+
+    // Re-registering drops what the old registration verified
+    framework.registerStrategy(strategy);
+    framework.verifyAlignment(makeContext(params));
+    EXPECT_EQ(strategy->runs.load(), 5);
+
+    // Parameters without a hasher are never cached
+    params["opaque"] = std::make_shared<int>(1);
+    framework.alignmentCache().setRelevantParameters("counting", {"opaque"});
+    framework.verifyAlignment(makeContext(params));
+    framework.verifyAlignment(makeContext(params));
+    EXPECT_EQ(strategy->runs.load(), 7);
+}
+
+TEST(CommonGroundFrameworkTest, CachedResultsExpireAndEvictTheLeastRecentlyUsed) {
+    AlignmentCache cache(std::chrono::milliseconds(40), 2);
+    auto context = [](const std::string& goal) {
+        return makeContext({{"remote_goal", goal}});
+    };
+    cache.store("goal", context("a"), AlignmentResult(true, {}, 1.0));
+    cache.store("goal", context("b"), AlignmentResult(false, {"b"}, 0.0));
+    ASSERT_TRUE(cache.find("goal", context("a")).has_value());  // "b" is now the least recent
+    cache.store("goal", context("c"), AlignmentResult(true, {}, 0.7));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_FALSE(cache.find("goal", context("b")).has_value());
+    EXPECT_DOUBLE_EQ(cache.find("goal", context("c"))->getConfidenceScore(), 0.7);
+
+    // A result verified across an invalidation is stale
+    uint64_t generation = cache.generation("goal");
+    cache.invalidateStrategy("goal");
+    cache.store("goal", context("d"), AlignmentResult(true, {}, 1.0), generation);
+    EXPECT_EQ(cache.size(), 0u);
+
+    cache.store("goal", context("a"), AlignmentResult(true, {}, 1.0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_FALSE(cache.find("goal", context("a")).has_value());
+
+    AlignmentCache disabled(std::chrono::milliseconds(0));
+    disabled.store("goal", context("a"), AlignmentResult(true, {}, 1.0));
+    EXPECT_FALSE(disabled.find("goal", context("a")).has_value());
+}
+
+TEST(CommonGroundFrameworkTest, TypedParameterKeysResolveWithoutStringLookups) {
+    static const ParameterKey<std::string> goal{"typed_goal"};
+    static const ParameterKey<int> retries{"typed_retries"};
+    auto context = std::make_unique<AlignmentContext>(makeContext({
+        {"typed_goal", std::string("goalA")},
+        {"typed_retries", std::string("not an int")},
+        {"typed_late", 7},
+    }));
+
+    ASSERT_NE(context->get(goal), nullptr);
+    EXPECT_EQ(*context->get(goal), "goalA");
+    EXPECT_EQ(context->get(goal), std::any_cast<std::string>(context->findParameter("typed_goal")));
+    EXPECT_EQ(context->get(retries), nullptr);  // Present, but of another type
+    EXPECT_TRUE(context->has(retries));
+
+    // Keys interned after the context was built still find their value
+    static const ParameterKey<int> late{"typed_late"};
+    ASSERT_NE(context->get(late), nullptr);
+    EXPECT_EQ(*context->get(late), 7);
+
+    // Copies point into their own parameters
+    AlignmentContext copy = *context;
+    context.reset();
+    EXPECT_EQ(*copy.get(goal), "goalA");
+    EXPECT_EQ(*copy.get(late), 7);
+    AlignmentContext moved = std::move(copy);
+    EXPECT_EQ(*moved.get(goal), "goalA");
+    EXPECT_FALSE(moved.has(ParameterKey<int>("typed_absent")));
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/common_ground/metrics/metric_storage.hpp"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace xenocomm::extensions::common_ground::metrics;
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+const Clock::time_point BASE = Clock::time_point(std::chrono::hours(24 * 365 * 50));
+
+MetricData makeMetric(const std::string& category, std::chrono::seconds offset, double value,
+                      const std::string& strategyId = "") {
+    MetricData data;
+    data.metricId = category + "_" + std::to_string(offset.count());
+    data.category = category;
+    data.timestamp = BASE + offset;
+    data.value = value;
+    if (!strategyId.empty()) {
+        data.labels["strategy_id"] = strategyId;
+    }
+    data.labels["success"] = value > 0.5 ? "true" : "false";
+    return data;
+}
+
+MetricsConfig memoryConfig(size_t maxEntries) {
+    MetricsConfig config;
+    config.enablePersistence = false;
+    config.aggregationInterval = std::chrono::seconds(60);
+    config.maxInMemoryEntries = maxEntries;
+    return config;
+}
+
+} // namespace
+
+TEST(MetricStorageTest, QueriesByCategoryStrategyAndTimeRange) {
+    MetricStorage storage(memoryConfig(1000));
+    for (int i = 0; i < 10; ++i) {
+        storage.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(i * 30), 1.0,
+                                      i % 2 ? "terminology" : "goal"));
+        storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(i * 30), i % 3 ? 1.0 : 0.0));
+    }
+
+    MetricQuery query;
+    query.category = "strategy.execution_time";
+    query.strategyId = "terminology";
+    EXPECT_EQ(storage.query(query).size(), 5u);
+
+    // Offsets 60..150s, inclusive at both ends, straddling partition boundaries
+    query = MetricQuery{};
+    query.category = "alignment.success_rate";
+    query.range.start = BASE + std::chrono::seconds(60);
+    query.range.end = BASE + std::chrono::seconds(150);
+    auto inRange = storage.query(query);
+    ASSERT_EQ(inRange.size(), 4u);
+    EXPECT_EQ(inRange.front().timestamp, BASE + std::chrono::seconds(60));
+    EXPECT_EQ(inRange.back().timestamp, BASE + std::chrono::seconds(150));
+
+    query.limit = 2;
+    EXPECT_EQ(storage.forEach(query, [](const MetricData&) {}), 2u);
+
+    query = MetricQuery{};
+    query.labels["success"] = "false";
+    EXPECT_EQ(storage.query(query).size(), 4u);
+}
+
+TEST(MetricStorageTest, ParsesFilterStrings) {
+    MetricQuery query = MetricQuery::parse(" strategy.execution_time , strategy_id=goal,success = true ");
+    EXPECT_EQ(query.category, std::optional<std::string>("strategy.execution_time"));
+    EXPECT_EQ(query.strategyId, std::optional<std::string>("goal"));
+    ASSERT_EQ(query.labels.size(), 1u);
+    EXPECT_EQ(query.labels.at("success"), "true");
+
+    MetricStorage storage(memoryConfig(100));
+    storage.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(0), 1.0, "goal"));
+    storage.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(1), 0.0, "goal"));
+    storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(2), 1.0));
+    EXPECT_EQ(storage.loadMetrics().size(), 3u);
+    EXPECT_EQ(storage.loadMetrics("category=strategy.execution_time,success=true").size(), 1u);
+}
+
+TEST(MetricStorageTest, EvictsOldestPartitionsBeyondTheBound) {
+    MetricStorage storage(memoryConfig(10));
+    for (int i = 0; i < 30; ++i) {
+        storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(i * 20), 1.0));
+    }
+    EXPECT_LE(storage.size(), 10u);
+    EXPECT_EQ(storage.spilledCount(), 0u);
+
+    auto kept = storage.loadMetrics();
+    ASSERT_FALSE(kept.empty());
+    EXPECT_EQ(kept.back().timestamp, BASE + std::chrono::seconds(29 * 20));
+
+    // A single busy interval is trimmed instead of dropped whole
+    MetricStorage busy(memoryConfig(10));
+    for (int i = 0; i < 25; ++i) {
+        busy.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(0), 1.0));
+    }
+    EXPECT_GT(busy.size(), 0u);
+    EXPECT_LE(busy.size(), 10u);
+}
+
+TEST(MetricStorageTest, PagesMetricsSavedAfterACursor) {
+    MetricStorage storage(memoryConfig(1000));
+    // Saved out of time order, as late metrics arrive
+    storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(600), 1.0));
+    storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(0), 1.0));
+    storage.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(300), 1.0));
+
+    MetricQuery query;
+    query.category = "alignment.success_rate";
+    MetricPage page = storage.page(query);
+    ASSERT_EQ(page.metrics.size(), 2u);
+    EXPECT_EQ(page.metrics[0].metricId, "alignment.success_rate_600");
+    EXPECT_EQ(page.cursor, 3u);
+
+    query.since = page.cursor;
+    EXPECT_TRUE(storage.page(query).metrics.empty());
+    EXPECT_EQ(storage.page(query).cursor, 3u);
+
+    storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(60), 1.0));
+    storage.saveMetric(makeMetric("alignment.success_rate", std::chrono::seconds(90), 1.0));
+    query.limit = 1;
+    page = storage.page(query);
+    ASSERT_EQ(page.metrics.size(), 1u);
+    EXPECT_EQ(page.metrics[0].metricId, "alignment.success_rate_60");
+    EXPECT_EQ(page.cursor, 4u);  // Cut short: resumes after the metric returned
+
+    query.since = page.cursor;
+    page = storage.page(query);
+    ASSERT_EQ(page.metrics.size(), 1u);
+    EXPECT_EQ(page.metrics[0].metricId, "alignment.success_rate_90");
+    EXPECT_EQ(page.cursor, 5u);
+}
+
+class MetricStorageSpillTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testDir_ = std::filesystem::temp_directory_path() / "metric_storage_test";
+        std::filesystem::remove_all(testDir_);
+        config_ = memoryConfig(8);
+        config_.enablePersistence = true;
+        config_.storageLocation = testDir_.string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDir_);
+    }
+
+    std::filesystem::path testDir_;
+    MetricsConfig config_;
+};
+
+TEST_F(MetricStorageSpillTest, SpillsEvictedPartitionsAndReadsThemBack) {
+    {
+        MetricStorage storage(config_);
+        for (int i = 0; i < 20; ++i) {
+            storage.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(i * 15), 1.0,
+                                          i < 4 ? "early" : "late"));
+        }
+        EXPECT_LE(storage.size(), 8u);
+        EXPECT_EQ(storage.size() + storage.spilledCount(), 20u);
+        EXPECT_EQ(storage.loadMetrics().size(), 20u);
+
+        MetricQuery query;
+        query.strategyId = "early";
+        auto early = storage.query(query);
+        ASSERT_EQ(early.size(), 4u);
+        EXPECT_EQ(early.front().metricId, "strategy.execution_time_0");
+        EXPECT_EQ(early.front().timestamp, BASE);
+        EXPECT_EQ(early.front().labels.at("strategy_id"), "early");
+    }
+
+    // A new instance finds the spilled partitions
+    MetricStorage reopened(config_);
+    EXPECT_EQ(reopened.size(), 0u);
+    EXPECT_GT(reopened.spilledCount(), 0u);
+    MetricQuery query;
+    query.range.end = BASE + std::chrono::seconds(45);
+    EXPECT_EQ(reopened.query(query).size(), 4u);
+
+    reopened.clear();
+    EXPECT_EQ(reopened.spilledCount(), 0u);
+    EXPECT_TRUE(std::filesystem::is_empty(testDir_));
+}
+
+TEST_F(MetricStorageSpillTest, CursorsSurviveSpillAndReopen) {
+    uint64_t cursor = 0;
+    {
+        MetricStorage storage(config_);
+        for (int i = 0; i < 20; ++i) {
+            storage.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(i * 15), 1.0));
+        }
+        MetricQuery query;
+        query.since = 2;
+        MetricPage page = storage.page(query);
+        ASSERT_EQ(page.metrics.size(), 18u);  // Spilled and in memory alike
+        EXPECT_EQ(page.metrics.front().metricId, "strategy.execution_time_30");
+        cursor = page.cursor;
+    }
+
+    MetricStorage reopened(config_);
+    reopened.saveMetric(makeMetric("strategy.execution_time", std::chrono::seconds(0), 2.0));
+    MetricQuery query;
+    query.since = cursor;
+    MetricPage page = reopened.page(query);
+    ASSERT_EQ(page.metrics.size(), 1u);
+    EXPECT_EQ(page.metrics.front().value, 2.0);
+    EXPECT_EQ(page.cursor, cursor + 1);
+}
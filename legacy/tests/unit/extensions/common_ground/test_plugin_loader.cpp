@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/common_ground/extensibility/plugin_loader.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+using namespace xenocomm::common_ground;
+
+namespace {
+
+AlignmentContext makeContext(const std::string& remote = "remote") {
+    AgentInfo local{"local", "LocalAgent", {}};
+    AgentInfo remoteAgent{remote, "RemoteAgent", {}};
+    return AlignmentContext(local, remoteAgent, {});
+}
+
+} // namespace
+
+class PluginLoaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+#if defined(XENOCOMM_TEST_PLUGIN_PATH) && defined(XENOCOMM_TEST_PLUGIN_V2_PATH)
+        testDir_ = std::filesystem::temp_directory_path() / "plugin_loader_test";
+        std::filesystem::remove_all(testDir_);
+        std::filesystem::create_directories(testDir_);
+        pluginPath_ = testDir_ / "libecho.so";
+        std::filesystem::copy_file(XENOCOMM_TEST_PLUGIN_PATH, pluginPath_);
+#else
+        GTEST_SKIP() << "Test plugins not built";
+#endif
+    }
+
+    void TearDown() override {
+        if (!testDir_.empty()) {
+            std::filesystem::remove_all(testDir_);
+        }
+    }
+
+    std::filesystem::path testDir_;
+    std::filesystem::path pluginPath_;
+};
+
+TEST_F(PluginLoaderTest, LoadsDirectoryPluginsOnFirstUse) {
+    PluginLoader loader(testDir_.string());
+    EXPECT_FALSE(loader.isPluginLoaded("echo"));
+    EXPECT_FALSE(loader.getPluginMetadata("echo").loaded);
+    EXPECT_TRUE(loader.getLoadedPlugins().empty());
+
+    auto strategy = loader.getStrategyFromPlugin("echo", "echo");
+    ASSERT_NE(strategy, nullptr);
+    EXPECT_TRUE(loader.isPluginLoaded("echo"));
+    EXPECT_EQ(strategy->getId(), "echo");
+    EXPECT_TRUE(strategy->isApplicable(makeContext()));
+    EXPECT_FALSE(strategy->isApplicable(makeContext("unknown")));
+    EXPECT_TRUE(strategy->verify(makeContext()).isAligned());
+
+    auto metadata = loader.getPluginMetadata("echo");
+    EXPECT_EQ(metadata.name, "Echo");
+    EXPECT_EQ(metadata.version, "1.0");
+    ASSERT_EQ(metadata.strategyIds.size(), 1u);
+    EXPECT_EQ(loader.getPluginStrategies().size(), 1u);
+    EXPECT_EQ(loader.getStrategyFromPlugin("echo", "missing"), nullptr);
+    EXPECT_EQ(loader.getStrategyFromPlugin("missing", "echo"), nullptr);
+}
+
+TEST_F(PluginLoaderTest, ReloadSwapsVersionsUnderHandedOutStrategies) {
+    PluginLoader loader(testDir_.string());
+    auto strategy = loader.getStrategyFromPlugin("echo", "echo");
+    ASSERT_NE(strategy, nullptr);
+    EXPECT_TRUE(strategy->verify(makeContext()).isAligned());
+
+#ifdef XENOCOMM_TEST_PLUGIN_V2_PATH
+    // Deployed the way a new version has to be: renamed over the old file, never rewritten in place
+    std::filesystem::copy_file(XENOCOMM_TEST_PLUGIN_V2_PATH, testDir_ / "libecho.so.new");
+    std::filesystem::rename(testDir_ / "libecho.so.new", pluginPath_);
+#endif
+    loader.reloadPlugin("echo");
+    EXPECT_EQ(loader.getPluginMetadata("echo").version, "2.0");
+    auto result = strategy->verify(makeContext());
+    EXPECT_FALSE(result.isAligned());
+    EXPECT_DOUBLE_EQ(result.getConfidenceScore(), 0.2);
+
+    loader.unloadPlugin("echo");
+    EXPECT_FALSE(loader.isPluginLoaded("echo"));
+    EXPECT_THROW(strategy->verify(makeContext()), std::runtime_error);
+    EXPECT_FALSE(strategy->isApplicable(makeContext()));
+}
+
+TEST_F(PluginLoaderTest, RejectsLibrariesThatAreNotPlugins) {
+    auto bogus = testDir_ / "libbogus.so";
+    std::filesystem::copy_file(pluginPath_, bogus);
+    {
+        std::FILE* f = std::fopen(bogus.c_str(), "r+");
+        ASSERT_NE(f, nullptr);
+        std::fputs("not an ELF file", f);
+        std::fclose(f);
+    }
+    PluginLoader loader(testDir_.string());
+    EXPECT_THROW(loader.loadPlugin(bogus.string()), std::runtime_error);
+    EXPECT_FALSE(loader.isPluginLoaded("bogus"));
+    // The broken plugin is skipped; the good one still loads
+    EXPECT_EQ(loader.getPluginStrategies().size(), 1u);
+}
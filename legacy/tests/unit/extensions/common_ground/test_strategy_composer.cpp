@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/common_ground/extensibility/strategy_composer.hpp"
+#include "xenocomm/utils/timer_service.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xenocomm::common_ground;
+
+namespace {
+
+AlignmentContext makeContext() {
+    AgentInfo local{"local", "LocalAgent", {}};
+    AgentInfo remote{"remote", "RemoteAgent", {}};
+    return AlignmentContext(local, remote, {});
+}
+
+// Sleeps, then reports a fixed verdict; tracks how many run at once
+class TimedStrategy : public IAlignmentStrategy {
+public:
+    TimedStrategy(std::string id, bool aligned, std::chrono::milliseconds delay, std::atomic<int>& active,
+                  std::atomic<int>& peak)
+        : id_(std::move(id)), aligned_(aligned), delay_(delay), active_(active), peak_(peak) {}
+
+    std::string getId() const override { return id_; }
+    bool isApplicable(const AlignmentContext&) const override { return true; }
+    AlignmentResult verify(const AlignmentContext&) override {
+        int now = ++active_;
+        int seen = peak_.load();
+        while (now > seen && !peak_.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(delay_);
+        --active_;
+        ++runs;
+        return AlignmentResult(aligned_, aligned_ ? std::vector<std::string>{} : std::vector<std::string>{id_}, 0.8);
+    }
+
+    std::atomic<int> runs{0};
+
+private:
+    std::string id_;
+    bool aligned_;
+    std::chrono::milliseconds delay_;
+    std::atomic<int>& active_;
+    std::atomic<int>& peak_;
+};
+
+// Misaligned or throwing until the given attempt
+class FlakyStrategy : public IAlignmentStrategy {
+public:
+    FlakyStrategy(int succeedOn, bool throws) : succeedOn_(succeedOn), throws_(throws) {}
+
+    std::string getId() const override { return "flaky"; }
+    bool isApplicable(const AlignmentContext&) const override { return true; }
+    AlignmentResult verify(const AlignmentContext&) override {
+        int attempt = ++attempts;
+        if (attempt >= succeedOn_) {
+            return AlignmentResult(true, {}, 1.0);
+        }
+        if (throws_) {
+            throw std::runtime_error("flaky");
+        }
+        return AlignmentResult(false, {"attempt " + std::to_string(attempt)}, 0.0);
+    }
+
+    std::atomic<int> attempts{0};
+
+private:
+    int succeedOn_;
+    bool throws_;
+};
+
+} // namespace
+
+TEST(StrategyComposerTest, ParallelRunsChildrenConcurrentlyWithinTheLimit) {
+    StrategyExecutor executor(4);
+    std::atomic<int> active{0}, peak{0};
+    std::vector<std::shared_ptr<IAlignmentStrategy>> children;
+    for (int i = 0; i < 6; ++i) {
+        children.push_back(std::make_shared<TimedStrategy>("c" + std::to_string(i), true,
+                                                           std::chrono::milliseconds(20), active, peak));
+    }
+
+    ParallelExecutionConfig config;
+    config.maxConcurrency = 2;
+    config.executor = &executor;
+    auto result = StrategyComposer::parallel(children, config)->verify(makeContext());
+    EXPECT_TRUE(result.isAligned());
+    EXPECT_DOUBLE_EQ(result.getConfidenceScore(), 0.8);
+    EXPECT_EQ(peak.load(), 2);
+}
+
+TEST(StrategyComposerTest, ParallelFinishesOnceAQuorumAgrees) {
+    StrategyExecutor executor(1);
+    std::atomic<int> active{0}, peak{0};
+    std::vector<std::shared_ptr<TimedStrategy>> children;
+    std::vector<std::shared_ptr<IAlignmentStrategy>> strategies;
+    for (int i = 0; i < 8; ++i) {
+        children.push_back(std::make_shared<TimedStrategy>("c" + std::to_string(i), i != 1,
+                                                           std::chrono::milliseconds(5), active, peak));
+        strategies.push_back(children.back());
+    }
+
+    ParallelExecutionConfig config;
+    config.quorum = 2;
+    config.executor = &executor;
+    auto result = StrategyComposer::parallel(strategies, config)->verify(makeContext());
+    EXPECT_TRUE(result.isAligned());
+    int runs = 0;
+    for (const auto& child : children) {
+        runs += child->runs.load();
+    }
+    EXPECT_LT(runs, 8);  // The two worker lanes stop claiming children once two agree
+
+    // Without a quorum, all-must-align is settled by the first misalignment
+    config.quorum.reset();
+    auto misaligned = StrategyComposer::parallel(strategies, config)->verify(makeContext());
+    EXPECT_FALSE(misaligned.isAligned());
+    ASSERT_EQ(misaligned.getMisalignments().size(), 1u);
+    EXPECT_EQ(misaligned.getMisalignments()[0], "c1");
+}
+
+TEST(StrategyComposerTest, CombinesResultsByStrategy) {
+    std::vector<AlignmentResult> results{AlignmentResult(true, {}, 0.9), AlignmentResult(false, {"a"}, 0.4),
+                                         AlignmentResult(true, {}, 0.7)};
+    auto all = StrategyComposer::combineResults(results, ResultCombinationStrategy::AllMustAlign);
+    EXPECT_FALSE(all.isAligned());
+    EXPECT_DOUBLE_EQ(all.getConfidenceScore(), 0.4);
+
+    auto any = StrategyComposer::combineResults(results, ResultCombinationStrategy::AnyAligned);
+    EXPECT_TRUE(any.isAligned());
+    EXPECT_DOUBLE_EQ(any.getConfidenceScore(), 0.8);
+
+    EXPECT_TRUE(StrategyComposer::combineResults(results, ResultCombinationStrategy::Majority).isAligned());
+    EXPECT_TRUE(StrategyComposer::combineResults({}, ResultCombinationStrategy::AllMustAlign).isAligned());
+}
+
+TEST(StrategyComposerTest, RetryBacksOffOnTimersWithoutHoldingAWorker) {
+    StrategyExecutor executor(1);
+    xenocomm::utils::TimerService timers;
+    RetryConfig config;
+    config.maxAttempts = 4;
+    config.initialBackoff = std::chrono::milliseconds(20);
+    config.timers = &timers;
+    config.executor = &executor;
+
+    auto flaky = std::make_shared<FlakyStrategy>(3, true);
+    auto retry = std::dynamic_pointer_cast<IAsyncAlignmentStrategy>(StrategyComposer::withRetry(flaky, config));
+    ASSERT_NE(retry, nullptr);
+    auto future = retry->verifyAsync(makeContext());
+
+    // The only worker stays free while the retry waits out its backoff
+    std::promise<void> ran;
+    executor.submit([&ran] { ran.set_value(); });
+    EXPECT_EQ(ran.get_future().wait_for(std::chrono::milliseconds(15)), std::future_status::ready);
+
+    auto result = future.get();
+    EXPECT_TRUE(result.isAligned());
+    EXPECT_EQ(flaky->attempts.load(), 3);
+
+    // Out of attempts: the last misaligned result is returned
+    auto stubborn = std::make_shared<FlakyStrategy>(10, false);
+    config.initialBackoff = std::chrono::milliseconds(1);
+    auto failed = StrategyComposer::withRetry(stubborn, config)->verify(makeContext());
+    EXPECT_FALSE(failed.isAligned());
+    EXPECT_EQ(failed.getMisalignments()[0], "attempt 4");
+}
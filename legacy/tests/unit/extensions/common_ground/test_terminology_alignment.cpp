@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "xenocomm/extensions/common_ground/strategies/terminology_alignment.hpp"
 #include "xenocomm/extensions/common_ground/context.hpp"
+#include "xenocomm/core/data_adapters.h"
 #include <any>
+#include <cmath>
 #include <map>
 #include <string>
 #include <vector>
@@ -117,4 +119,66 @@ TEST(TerminologyAlignmentStrategyTest, MissingTerminologyParameters) {
     EXPECT_EQ(result.getMisalignments().size(), 1);
     EXPECT_EQ(result.getMisalignments()[0], "Missing or invalid terminology definitions");
     EXPECT_DOUBLE_EQ(result.getConfidenceScore(), 0.0);
-} 
\ No newline at end of file
+} 
+TEST(TerminologyAlignmentStrategyTest, NormalizedDefinitionsMatchExactly) {
+    TerminologyAlignmentStrategy strategy;
+    strategy.addCriticalTerm("foo", "Definition  of foo");
+    strategy.addCriticalTerm("baz", "Definition of baz");
+    strategy.addCriticalTerm("baz", "Definition of qux");  // Replaces the first definition
+
+    std::unordered_map<std::string, std::string> remoteTerms = {
+        {"foo", "  definition of\tFOO "},
+        {"baz", "Definition of baz"}
+    };
+    AlignmentResult result = strategy.verify(makeContext({{"remote_terminology", remoteTerms}}));
+    EXPECT_FALSE(result.isAligned());
+    ASSERT_EQ(result.getMisalignments().size(), 1u);
+    EXPECT_EQ(result.getMisalignments()[0].rfind("Term definition mismatch for 'baz'", 0), 0u);
+    EXPECT_DOUBLE_EQ(result.getConfidenceScore(), 0.5);
+}
+
+TEST(TerminologyAlignmentStrategyTest, ScoresDifferingDefinitionsByEmbedding) {
+    const size_t dimension = 48;
+    const std::vector<std::string> terms = {"latency", "throughput", "jitter"};
+    std::vector<float> local(terms.size() * dimension);
+    for (size_t i = 0; i < local.size(); ++i) {
+        local[i] = std::sin(0.37f * static_cast<float>(i) + 1.0f);
+    }
+    // Remote rows: a close paraphrase, an unrelated definition, and the same vector
+    std::vector<float> remote(local);
+    for (size_t d = 0; d < dimension; ++d) {
+        remote[d] += 0.05f * std::cos(static_cast<float>(d));
+        remote[dimension + d] = -local[dimension + d];
+    }
+
+    TerminologyAlignmentStrategy strategy;
+    strategy.addCriticalTerm("latency", "Time for a message to arrive");
+    strategy.addCriticalTerm("throughput", "Messages delivered per second");
+    strategy.addCriticalTerm("jitter", "Variation in latency");
+    strategy.setMinimumAlignmentThreshold(0.9);
+    xenocomm::core::VectorFloat32Adapter floats;
+    strategy.setLocalEmbeddings(TermEmbeddings::decode(
+        terms, dimension, floats,
+        floats.encode(local.data(), local.size() * sizeof(float), xenocomm::core::DataFormat::VECTOR_FLOAT32),
+        xenocomm::core::DataFormat::VECTOR_FLOAT32));
+
+    // The remote side sends its embeddings quantized
+    auto int8 = xenocomm::core::VectorInt8Adapter::perBlock(16);
+    auto encoded = int8.encode(remote.data(), remote.size() * sizeof(float), xenocomm::core::DataFormat::VECTOR_FLOAT32);
+    std::unordered_map<std::string, std::string> remoteTerms = {
+        {"latency", "How long a message takes to get there"},
+        {"throughput", "Something else entirely"},
+        {"jitter", "How much latency varies"}
+    };
+    AlignmentResult result = strategy.verify(makeContext({
+        {"remote_terminology", remoteTerms},
+        {"remote_term_embeddings", TermEmbeddings::decode(terms, dimension, int8, encoded,
+                                                          xenocomm::core::DataFormat::VECTOR_INT8)},
+    }));
+    ASSERT_EQ(result.getMisalignments().size(), 1u);
+    EXPECT_EQ(result.getMisalignments()[0], "Term definition mismatch for 'throughput': similarity score 0.000000");
+    EXPECT_NEAR(result.getConfidenceScore(), 2.0 / 3.0, 1e-9);
+
+    EXPECT_THROW(TermEmbeddings::decode({"one"}, dimension, int8, encoded, xenocomm::core::DataFormat::VECTOR_INT8),
+                 xenocomm::core::TranscodingError);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/common_ground/extensibility/testing_harness.hpp"
+#include "xenocomm/extensions/common_ground/extensibility/allocation_tracking.hpp"
+#include "xenocomm/extensions/common_ground/strategies/goal_alignment.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace xenocomm::common_ground;
+
+XENOCOMM_TRACK_ALLOCATIONS()
+
+namespace {
+
+AlignmentContext goalContext(const std::string& goal) {
+    AgentInfo local{"local", "LocalAgent", {}};
+    AgentInfo remote{"remote", "RemoteAgent", {}};
+    return AlignmentContext(local, remote,
+                            {{"remote_goal", goal}, {"remote_intention", std::string("intentionA")}});
+}
+
+std::shared_ptr<GoalAlignmentStrategy> makeStrategy() {
+    auto strategy = std::make_shared<GoalAlignmentStrategy>();
+    strategy->setLocalGoal("goalA");
+    strategy->setLocalIntention("intentionA");
+    return strategy;
+}
+
+// Returns a misalignment list, which allocates, on every call
+class AllocatingStrategy : public IAlignmentStrategy {
+public:
+    std::string getId() const override { return "allocating"; }
+    bool isApplicable(const AlignmentContext&) const override { return true; }
+    AlignmentResult verify(const AlignmentContext&) override {
+        return AlignmentResult(false, {"scratch"}, 0.5);
+    }
+};
+
+} // namespace
+
+TEST(StrategyTestHarnessTest, ComparesAgainstTheExpectedResultWithMockData) {
+    StrategyTestHarness harness(makeStrategy());
+    harness.withContext(goalContext("goalB"));
+    harness.withExpectedResult(AlignmentResult(true, {}, 1.0));
+    EXPECT_FALSE(harness.runTest().passed);
+
+    // Mock data overrides the context's own parameters
+    harness.withMockData("remote_goal", std::string("goalA"));
+    EXPECT_TRUE(harness.runTest().passed);
+
+    TestSuite suite{"goals", {{"match", goalContext("goalA"), AlignmentResult(true, {}, 1.0)},
+                              {"unchecked", goalContext("goalC"), std::nullopt}}};
+    auto results = harness.runTestSuite(suite);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].name, "goals/match");
+    EXPECT_TRUE(results[1].passed);
+
+    auto report = harness.generateReport();
+    EXPECT_EQ(report.strategyId, "goal_alignment");
+    EXPECT_EQ(report.passed, 3u);
+    EXPECT_EQ(report.failed, 1u);
+}
+
+TEST(StrategyTestHarnessTest, BenchmarksACorpusAcrossThreadCounts) {
+    StrategyTestHarness harness(makeStrategy());
+    auto corpus = generateCorpus(32, [](size_t index, std::mt19937&) {
+        return goalContext(index % 2 ? "goalA" : "goalB");
+    });
+    ASSERT_EQ(corpus.size(), 32u);
+    harness.withCorpus(corpus);
+
+    BenchmarkConfig config;
+    config.iterations = 500;
+    config.warmupIterations = 10;
+    config.threadCounts = {1, 2};
+    auto results = harness.runBenchmark(config);
+    ASSERT_EQ(results.size(), 2u);
+    for (const auto& result : results) {
+        EXPECT_EQ(result.calls, 500u * result.threads);
+        EXPECT_LE(result.p50, result.p90);
+        EXPECT_LE(result.p90, result.p99);
+        EXPECT_LE(result.p99, result.max);
+        EXPECT_GT(result.callsPerSecond, 0.0);
+        ASSERT_TRUE(result.allocationsPerCall.has_value());
+    }
+    EXPECT_EQ(harness.generateReport().benchmarks.size(), 2u);
+
+    std::string path = testing::TempDir() + "harness_report.txt";
+    harness.exportReport(path);
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    EXPECT_NE(text.str().find("bench threads=2 calls=1000"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(StrategyTestHarnessTest, ChecksPerformanceCriteria) {
+    StrategyTestHarness harness(std::make_shared<AllocatingStrategy>());
+    harness.withContext(goalContext("goalA"));
+
+    PerformanceCriteria criteria;
+    criteria.benchmark.iterations = 200;
+    auto results = harness.runBenchmark(criteria.benchmark);
+    ASSERT_TRUE(results[0].allocationsPerCall.has_value());
+    EXPECT_GE(*results[0].allocationsPerCall, 1.0);
+
+    criteria.maxAllocationsPerCall = 0.0;
+    EXPECT_THROW(harness.checkPerformance(criteria), std::runtime_error);
+    criteria.maxAllocationsPerCall.reset();
+    criteria.maxP99 = std::chrono::seconds(10);
+    EXPECT_NO_THROW(harness.checkPerformance(criteria));
+}
+
+TEST(StrategyTestHarnessTest, RecordsContextsForReplay) {
+    auto recorder = std::make_shared<ContextRecorder>(makeStrategy(), 2);
+    for (const char* goal : {"goalA", "goalB", "goalC"}) {
+        recorder->verify(goalContext(goal));
+    }
+    auto corpus = recorder->corpus();
+    ASSERT_EQ(corpus.size(), 2u);
+    EXPECT_EQ(*corpus[1].get(GoalAlignmentStrategy::REMOTE_GOAL), "goalB");
+
+    StrategyTestHarness harness(makeStrategy());
+    EXPECT_THROW(harness.runBenchmark(), std::runtime_error);  // Neither a corpus nor a context
+    harness.withCorpus(corpus);
+    EXPECT_EQ(harness.runBenchmark({100, 0, {1}})[0].calls, 100u);
+}
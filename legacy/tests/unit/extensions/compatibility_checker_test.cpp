@@ -191,4 +191,50 @@ TEST_F(CompatibilityCheckerTest, SingleVariantValidation) {
 
     std::vector<ProtocolVariant> variants = {v1};
     EXPECT_TRUE(checker->validateVariantSet(variants));
-} 
\ No newline at end of file
+} 
+// Test incremental tracking of a variant set
+TEST_F(CompatibilityCheckerTest, TrackedSetUpdatesIncrementally) {
+    ProtocolVariant v1, v2, v3;
+    v1.setId("variant1");
+    v1.setVersion(1);
+    v2.setId("variant2");
+    v2.setVersion(2);
+    v3.setId("variant3");
+    v3.setVersion(6); // Too far from both with default config
+
+    EXPECT_TRUE(checker->addVariant(v1));
+    EXPECT_TRUE(checker->addVariant(v2));
+    EXPECT_TRUE(checker->isTrackedSetCompatible());
+
+    EXPECT_FALSE(checker->addVariant(v3));
+    EXPECT_EQ(checker->incompatiblePairCount(), 2u);
+    EXPECT_EQ(checker->trackedVariantCount(), 3u);
+
+    // Retiring the middle variant moves the last into its slot
+    EXPECT_TRUE(checker->retireVariant("variant2"));
+    EXPECT_EQ(checker->incompatiblePairCount(), 1u);
+    EXPECT_FALSE(checker->retireVariant("variant2"));
+
+    // Replacing a tracked id re-evaluates its row
+    v3.setVersion(3);
+    EXPECT_TRUE(checker->addVariant(v3));
+    EXPECT_TRUE(checker->isTrackedSetCompatible());
+    EXPECT_EQ(checker->trackedVariantCount(), 2u);
+}
+
+// Test that new rules re-evaluate the tracked set
+TEST_F(CompatibilityCheckerTest, ConfigureReevaluatesTrackedSet) {
+    std::vector<ProtocolVariant> variants(200);
+    for (size_t i = 0; i < variants.size(); ++i) {
+        variants[i].setId("variant" + std::to_string(i));
+        variants[i].setVersion(static_cast<int>(i % 4));
+        checker->addVariant(variants[i]);
+    }
+    // Equal versions fall below the default minimum gap
+    EXPECT_FALSE(checker->isTrackedSetCompatible());
+    EXPECT_FALSE(checker->validateVariantSet(variants));
+
+    checker->configure({{"min_version_gap", 0}});
+    EXPECT_TRUE(checker->isTrackedSetCompatible());
+    EXPECT_TRUE(checker->validateVariantSet(variants));
+}
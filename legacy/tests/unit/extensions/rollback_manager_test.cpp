@@ -117,7 +117,7 @@ TEST_F(RollbackManagerTest, VerifyRollbackPointIntegrity) {
     EXPECT_TRUE(manager_->verifyRollbackPoint(id));
 
     // Corrupt the file
-    std::ofstream file(config_.storagePath + id + ".json", std::ios::app);
+    std::ofstream file(config_.storagePath + id + ".rbp", std::ios::app);
     file << "corrupted";
     file.close();
 
@@ -208,6 +208,43 @@ TEST_F(RollbackManagerTest, HandleLargeState) {
     );
 }
 
+TEST_F(RollbackManagerTest, LargeStatesShareUnchangedChunks) {
+    config_.chunkSize = 4096;
+    manager_ = std::make_unique<RollbackManager>(config_, compatibilityChecker_);
+    auto countChunks = [this] {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(config_.storagePath + "chunks")) {
+            count += entry.path().extension() == ".bin";
+        }
+        return count;
+    };
+
+    json state;
+    for (int i = 0; i < 4000; i++) {
+        state["entry" + std::to_string(i)] = "value " + std::to_string(i * 7919);
+    }
+    auto id1 = manager_->createRollbackPoint("test_variant", state);
+    auto point1 = manager_->getRollbackPoint(id1);
+    ASSERT_TRUE(point1.has_value());
+    ASSERT_TRUE(point1->isChunked);
+    size_t firstChunks = countChunks();
+    EXPECT_GT(firstChunks, 4u);
+
+    // One changed and one inserted entry only rewrite the chunks around them
+    state["entry2000"] = "changed";
+    state["entry1000a"] = "inserted";
+    auto id2 = manager_->createRollbackPoint("test_variant", state);
+    EXPECT_LE(countChunks(), firstChunks + 4);
+    EXPECT_TRUE(manager_->verifyRollbackPoint(id1));
+    EXPECT_TRUE(manager_->verifyRollbackPoint(id2));
+    EXPECT_TRUE(manager_->restoreToPoint(id2));
+
+    // Manifests survive a restart
+    auto newManager = std::make_unique<RollbackManager>(config_, compatibilityChecker_);
+    EXPECT_TRUE(newManager->verifyRollbackPoint(id1));
+    EXPECT_TRUE(newManager->restoreToPoint(id1));
+}
+
 TEST_F(RollbackManagerTest, PersistenceAcrossRestarts) {
     // Create a rollback point
     auto state = createTestState(1, "test data");
@@ -222,6 +259,89 @@ TEST_F(RollbackManagerTest, PersistenceAcrossRestarts) {
     EXPECT_EQ(point->state, state);
 }
 
+TEST_F(RollbackManagerTest, StreamsAndReadsChunkedStatesInParts) {
+    config_.chunkSize = 4096;
+    manager_ = std::make_unique<RollbackManager>(config_, compatibilityChecker_);
+    json state;
+    for (int i = 0; i < 2000; i++) {
+        state["entry" + std::to_string(i)] = "value " + std::to_string(i * 7919);
+    }
+    const std::string serialized = state.dump();
+    auto id = manager_->createRollbackPoint("test_variant", state);
+
+    std::string streamed;
+    size_t pieces = 0;
+    EXPECT_TRUE(manager_->streamRollbackState(id, [&](const uint8_t* data, size_t size) {
+        streamed.append(reinterpret_cast<const char*>(data), size);
+        ++pieces;
+        return true;
+    }));
+    EXPECT_EQ(streamed, serialized);
+    EXPECT_GT(pieces, 1u);
+
+    // A sink can stop the stream
+    EXPECT_FALSE(manager_->streamRollbackState(id, [](const uint8_t*, size_t) { return false; }));
+
+    auto reader = manager_->openRollbackState(id);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_EQ(reader->size(), serialized.size());
+    for (size_t offset : {size_t{0}, size_t{4000}, serialized.size() / 2, serialized.size() - 10}) {
+        std::vector<uint8_t> part(9000);
+        size_t count = reader->read(offset, part.data(), part.size());
+        EXPECT_EQ(count, std::min(part.size(), serialized.size() - offset));
+        EXPECT_EQ(std::string(part.begin(), part.begin() + count), serialized.substr(offset, count));
+    }
+    uint8_t byte;
+    EXPECT_EQ(reader->read(serialized.size(), &byte, 1), 0u);
+
+    // Inline states read the same way
+    auto small = createTestState(1, "small");
+    auto inlineReader = manager_->openRollbackState(manager_->createRollbackPoint("other_variant", small));
+    ASSERT_NE(inlineReader, nullptr);
+    EXPECT_EQ(inlineReader->size(), small.dump().size());
+    EXPECT_EQ(manager_->openRollbackState("missing"), nullptr);
+}
+
+TEST_F(RollbackManagerTest, RestartsFromTheIndexAndConvertsLegacyPoints) {
+    auto state = createTestState(1, "indexed");
+    auto id = manager_->createRollbackPoint("test_variant", state, {{"k", "v"}});
+
+    // A point written in the JSON format
+    json legacy = {
+        {"id", "rb_legacy"},
+        {"timestamp", 1700000000},
+        {"variantId", "old_variant"},
+        {"state", {{"data", "legacy"}}},
+        {"checksum", computeSHA256(json({{"data", "legacy"}}).dump())},
+        {"metadata", json::object()}
+    };
+    std::ofstream(config_.storagePath + "rb_legacy.json") << legacy.dump();
+
+    auto restarted = std::make_unique<RollbackManager>(config_, compatibilityChecker_);
+    EXPECT_FALSE(std::filesystem::exists(config_.storagePath + "rb_legacy.json"));
+    auto points = restarted->listRollbackPoints();
+    ASSERT_EQ(points.size(), 2u);
+    for (const auto& point : points) {
+        EXPECT_TRUE(point.state.is_null());
+    }
+
+    // A second start reads only the index; states load on demand
+    restarted = std::make_unique<RollbackManager>(config_, compatibilityChecker_);
+    auto point = restarted->getRollbackPoint(id);
+    ASSERT_TRUE(point.has_value());
+    EXPECT_EQ(point->state, state);
+    EXPECT_EQ(point->metadata.at("k"), "v");
+    auto converted = restarted->getRollbackPoint("rb_legacy");
+    ASSERT_TRUE(converted.has_value());
+    EXPECT_EQ(converted->variantId, "old_variant");
+    EXPECT_TRUE(restarted->verifyRollbackPoint("rb_legacy"));
+
+    // An index that does not match the point files is rebuilt
+    std::filesystem::remove(config_.storagePath + id + ".rbp");
+    restarted = std::make_unique<RollbackManager>(config_, compatibilityChecker_);
+    EXPECT_EQ(restarted->listRollbackPoints().size(), 1u);
+}
+
 TEST_F(RollbackManagerTest, InvalidRollbackPoint) {
     // Try to restore a non-existent point
     EXPECT_FALSE(manager_->restoreToPoint("non_existent_id"));
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "xenocomm/extensions/swarm_kernels.hpp"
+#include <vector>
+
+using namespace xenocomm::extensions;
+
+TEST(SwarmKernelsTest, IdenticalParamsAreCompatible) {
+    AgentParams params;
+    auto report = checkParamCompatibility(params, params);
+    EXPECT_EQ(report.worst(), ParamCompatibility::COMPATIBLE);
+}
+
+TEST(SwarmKernelsTest, FallbacksAreUpgradeable) {
+    AgentParams self;
+    AgentParams other;
+    other.dataFormat = "msgpack";
+    other.compression = "lz4";
+    auto report = checkParamCompatibility(self, other);
+    EXPECT_EQ(report.dataFormat, ParamCompatibility::UPGRADEABLE);
+    EXPECT_EQ(report.compression, ParamCompatibility::UPGRADEABLE);
+
+    self.dataFormat = "protobuf";
+    self.compression = "zstd";
+    report = checkParamCompatibility(self, other);
+    EXPECT_EQ(report.dataFormat, ParamCompatibility::NEGOTIABLE);
+    EXPECT_EQ(report.compression, ParamCompatibility::NEGOTIABLE);
+}
+
+TEST(SwarmKernelsTest, EncryptionNeverDowngrades) {
+    AgentParams self;
+    AgentParams other;
+    other.encryption = "none";
+    EXPECT_EQ(checkParamCompatibility(self, other).encryption, ParamCompatibility::INCOMPATIBLE);
+    other.encryption = "aes256";
+    EXPECT_EQ(checkParamCompatibility(self, other).encryption, ParamCompatibility::NEGOTIABLE);
+}
+
+TEST(SwarmKernelsTest, MergeTakesTighterBoundsAndStrongerCipher) {
+    AgentParams self;
+    self.maxMessageSize = 4096;
+    self.compression = "gzip";
+    self.encryption = "aes256";
+    self.priority = 2;
+    AgentParams other;
+    other.protocolVersion = "2.1";
+    other.dataFormat = "msgpack";
+    other.timeoutMs = 5000;
+    other.encryption = "chacha20";
+    other.streamingEnabled = true;
+    other.maxRetries = 7;
+
+    AgentParams merged = mergeParams(self, other, true);
+    EXPECT_EQ(merged.protocolVersion, "2.1");
+    EXPECT_EQ(merged.dataFormat, "json");
+    EXPECT_FALSE(merged.compression.has_value());  // Only one side compresses
+    EXPECT_EQ(merged.maxMessageSize, 4096);
+    EXPECT_EQ(merged.timeoutMs, 5000);
+    EXPECT_EQ(merged.encryption, "chacha20");
+    EXPECT_FALSE(merged.streamingEnabled);
+    EXPECT_EQ(merged.maxRetries, 7);
+    EXPECT_EQ(merged.priority, 5);
+
+    EXPECT_EQ(mergeParams(self, other, false).dataFormat, "msgpack");
+}
+
+TEST(SwarmKernelsTest, MergeKeepsSelfCipherOnATie) {
+    AgentParams self;
+    self.encryption = "rot13";  // Unknown, ranks with none
+    AgentParams other;
+    other.encryption = "none";
+    EXPECT_EQ(mergeParams(self, other).encryption, "rot13");
+}
+
+TEST(SwarmKernelsTest, MatrixIsSymmetricWithCompatibleDiagonal) {
+    std::vector<AgentParams> agents(3);
+    agents[1].encryption = "none";
+    agents[2].dataFormat = "cbor";
+    auto matrix = compatibilityMatrix(agents);
+    ASSERT_EQ(matrix.size(), 9u);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(matrix[i * 3 + i], ParamCompatibility::COMPATIBLE);
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_EQ(matrix[i * 3 + j], matrix[j * 3 + i]);
+        }
+    }
+    EXPECT_EQ(matrix[0 * 3 + 1], ParamCompatibility::INCOMPATIBLE);
+    EXPECT_EQ(matrix[0 * 3 + 2], ParamCompatibility::UPGRADEABLE);
+
+    auto reports = checkParamCompatibility(agents[0], agents);
+    ASSERT_EQ(reports.size(), 3u);
+    EXPECT_EQ(reports[1].worst(), ParamCompatibility::INCOMPATIBLE);
+}
+
+TEST(SwarmKernelsTest, TrendFollowsRelativeSlope) {
+    EXPECT_EQ(analyzeMetricTrend({0.9}), MetricTrend::INSUFFICIENT_DATA);
+    EXPECT_EQ(analyzeMetricTrend({0.50, 0.55, 0.60, 0.65, 0.70, 0.75, 0.80, 0.85, 0.90, 0.95}), MetricTrend::IMPROVING);
+    EXPECT_EQ(analyzeMetricTrend({0.95, 0.90, 0.85, 0.80, 0.75, 0.70, 0.65, 0.60, 0.55, 0.50}), MetricTrend::DEGRADING);
+    EXPECT_EQ(analyzeMetricTrend({0.80, 0.82, 0.84, 0.86, 0.88, 0.90, 0.92, 0.94, 0.96, 0.98}), MetricTrend::STABLE);  // 2% of the mean
+    EXPECT_EQ(analyzeMetricTrend({0.9, 0.9, 0.9, 0.9, 0.9}), MetricTrend::STABLE);
+    EXPECT_EQ(analyzeMetricTrend({10, 12, 14, 16, 18}, true), MetricTrend::DEGRADING);
+    EXPECT_EQ(analyzeMetricTrend({1, 50, 2, 60, 3, 40}), MetricTrend::VOLATILE);
+}
+
+TEST(SwarmKernelsTest, AnomalyIsBeyondThreeDeviations) {
+    std::vector<double> samples = {0.90, 0.91, 0.89, 0.90, 0.92, 0.88, 0.90, 0.91, 0.89};
+    samples.push_back(0.90);
+    EXPECT_FALSE(isMetricAnomalous(samples));
+    samples.back() = 0.40;
+    EXPECT_TRUE(isMetricAnomalous(samples));
+    EXPECT_FALSE(isMetricAnomalous({0.9, 0.9, 0.1}));  // No spread to measure against
+}
@@ -5,6 +5,7 @@
 #include <thread>
 #include <fstream>
 #include <chrono>
+#include <filesystem>
 
 // Add namespace usage for xenocomm::extensions
 using namespace xenocomm::extensions;
@@ -199,6 +200,101 @@ TEST_F(EmergenceManagerTest, IsSignificantlyBetter) {
     EXPECT_FALSE(manager->isSignificantlyBetter("v1", "v2", criteria));
 }
 
+TEST_F(EmergenceManagerTest, SummarizesMetricsIncrementally) {
+    ProtocolVariant v1("v1", "variant 1", nlohmann::json::object(), nlohmann::json::object());
+    manager->proposeVariant("v1", v1, "variant 1", nlohmann::json::object());
+    EXPECT_FALSE(manager->getMetricSummary("v1", "latencyMs").has_value());
+    EXPECT_THROW(manager->getMetricSummary("missing", "latencyMs"), std::out_of_range);
+
+    for (double latency : {10.0, 20.0, 30.0}) {
+        PerformanceRecord record;
+        record.metrics.latencyMs = latency;
+        record.metrics.customMetrics["jitterMs"] = latency / 10;
+        manager->logPerformance("v1", record);
+    }
+
+    auto latency = manager->getMetricSummary("v1", "latencyMs");
+    ASSERT_TRUE(latency.has_value());
+    EXPECT_EQ(latency->count, 3u);
+    EXPECT_DOUBLE_EQ(latency->mean, 20.0);
+    EXPECT_DOUBLE_EQ(latency->variance, 100.0);
+
+    auto jitter = manager->getMetricSummary("v1", "jitterMs");
+    ASSERT_TRUE(jitter.has_value());
+    EXPECT_DOUBLE_EQ(jitter->mean, 2.0);
+    EXPECT_FALSE(manager->getMetricSummary("v1", "unknown").has_value());
+
+    // Custom metrics take part in scoring like the built-in ones
+    EvaluationCriteria criteria;
+    criteria.metricWeights = {{"jitterMs", 1.0}};
+    EXPECT_EQ(manager->getBestPerformingVariant(criteria), std::optional<std::string>("v1"));
+}
+
+TEST_F(EmergenceManagerTest, DownsamplesRecordsBeyondTheRetentionWindow) {
+    // A directory of its own, so the saved state does not leak into other tests
+    const std::string path = "test_retention";
+    auto retained = std::make_unique<EmergenceManager>(path, nlohmann::json::object());
+    ProtocolVariant v1("v1", "variant 1", nlohmann::json::object(), nlohmann::json::object());
+    retained->proposeVariant("v1", v1, "variant 1", nlohmann::json::object());
+    EXPECT_THROW(retained->setPerformanceRetention(PerformanceRetention{0}), std::invalid_argument);
+
+    PerformanceRetention retention;
+    retention.maxRawRecords = 3;
+    retention.bucketWidth = std::chrono::seconds(60);
+    retention.maxBuckets = 2;
+    retained->setPerformanceRetention(retention);
+
+    const auto epoch = std::chrono::system_clock::time_point();
+    for (int seconds : {0, 10, 70, 80, 130, 140}) {
+        PerformanceRecord record;
+        record.timestamp = epoch + std::chrono::seconds(seconds);
+        record.metrics.latencyMs = seconds;
+        record.sampleSize = 1;
+        if (seconds == 10) {
+            record.metrics.customMetrics["jitterMs"] = 5.0;
+        }
+        retained->logPerformance("v1", record);
+    }
+
+    auto raw = retained->getVariantPerformance("v1");
+    ASSERT_EQ(raw.size(), 3u);
+    EXPECT_EQ(raw.front().timestamp, epoch + std::chrono::seconds(80));
+    EXPECT_EQ(raw.back().timestamp, epoch + std::chrono::seconds(140));
+
+    auto buckets = retained->getPerformanceBuckets("v1");
+    ASSERT_EQ(buckets.size(), 2u);
+    EXPECT_EQ(buckets[0].start, epoch);
+    EXPECT_EQ(buckets[0].recordCount, 2u);
+    EXPECT_DOUBLE_EQ(buckets[0].metrics.at("latencyMs").mean, 5.0);
+    EXPECT_DOUBLE_EQ(buckets[0].metrics.at("jitterMs").mean, 5.0);
+    EXPECT_EQ(buckets[1].start, epoch + std::chrono::seconds(60));
+    EXPECT_EQ(buckets[1].metrics.count("jitterMs"), 0u);
+
+    // Summaries still cover every record, across a restart too
+    retained->saveState();
+    retained = std::make_unique<EmergenceManager>(path, nlohmann::json::object());
+    EXPECT_EQ(retained->getPerformanceRetention().maxRawRecords, 3u);
+    EXPECT_EQ(retained->getVariantPerformance("v1").size(), 3u);
+    EXPECT_EQ(retained->getPerformanceBuckets("v1").size(), 2u);
+    EXPECT_EQ(retained->getMetricSummary("v1", "latencyMs")->count, 6u);
+    EXPECT_DOUBLE_EQ(retained->getMetricSummary("v1", "latencyMs")->mean, 71.66666666666667);
+    EXPECT_EQ(retained->getMetricSummary("v1", "jitterMs")->count, 1u);
+
+    // Shrinking the window downsamples the records that no longer fit
+    retention.maxRawRecords = 1;
+    retained->setPerformanceRetention(retention);
+    EXPECT_EQ(retained->getVariantPerformance("v1").size(), 1u);
+    buckets = retained->getPerformanceBuckets("v1");
+    ASSERT_EQ(buckets.size(), 2u);
+    EXPECT_EQ(buckets[0].recordCount, 2u);
+    EXPECT_EQ(buckets[1].start, epoch + std::chrono::seconds(120));
+
+    retained.reset();
+    std::remove((path + "/emergence_state.json").c_str());
+    std::remove((path + "/emergence_manager.log").c_str());
+    std::remove(path.c_str());
+}
+
 // Performance Report Generation
 TEST_F(EmergenceManagerTest, GeneratePerformanceReport) {
     // Create test variants
@@ -335,6 +431,50 @@ TEST_F(EmergenceManagerTest, AutosaveFunctionality) {
     manager->disableAutosave();
 }
 
+TEST_F(EmergenceManagerTest, JournalsChangesAndCompactsInTheBackground) {
+    const std::string path = "test_journal";
+    std::filesystem::remove_all(path);
+    auto writer = std::make_unique<EmergenceManager>(path, nlohmann::json::object());
+    writer->enableAutosave(std::chrono::seconds(3600));
+
+    ProtocolVariant v1("v1", "journaled", nlohmann::json::object(), nlohmann::json::object());
+    writer->proposeVariant("v1", v1, "journaled", nlohmann::json::object());
+    PerformanceRecord record;
+    record.metrics.successRate = 0.9;
+    writer->logPerformance("v1", record);
+    AgentContext agent;
+    agent.agentId = "agent1";
+    writer->registerAgent("agent1", agent);
+
+    // Nothing was snapshotted yet; a reader replays the journal
+    EXPECT_FALSE(std::filesystem::exists(path + "/emergence_state.json"));
+    {
+        EmergenceManager reader(path, nlohmann::json::object());
+        EXPECT_EQ(reader.getVariant("v1").description, "journaled");
+        EXPECT_EQ(reader.getVariantPerformance("v1").size(), 1u);
+        EXPECT_NO_THROW(reader.getAgentContext("agent1"));
+    }
+
+    // An elapsed interval seals the segment and folds it into the snapshot
+    writer->enableAutosave(std::chrono::seconds(0));
+    writer->setVariantStatus("v1", VariantStatus::InTesting);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::filesystem::exists(path + "/emergence_journal.1.jsonl") &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_FALSE(std::filesystem::exists(path + "/emergence_journal.1.jsonl"));
+    EXPECT_TRUE(std::filesystem::exists(path + "/emergence_state.json"));
+    writer->logPerformance("v1", record);
+    writer.reset();
+
+    EmergenceManager reader(path, nlohmann::json::object());
+    EXPECT_EQ(reader.listVariants(VariantStatus::InTesting).size(), 1u);
+    EXPECT_EQ(reader.getVariantPerformance("v1").size(), 2u);
+    EXPECT_NO_THROW(reader.getAgentContext("agent1"));
+    std::filesystem::remove_all(path);
+}
+
 TEST_F(EmergenceManagerTest, ConflictResolution) {
     // Create original variant
     ProtocolVariant v1("v1", "original", nlohmann::json::object(), {{"timestamp", 100}});
@@ -484,6 +624,41 @@ TEST_F(EmergenceManagerTest, VariantProposalAndVoting) {
     std::remove(tempPath.c_str());
 }
 
+TEST_F(EmergenceManagerTest, TalliesBatchedVotesOncePerAgent) {
+    const std::string path = "test_vote_tally";
+    std::filesystem::remove_all(path);
+    EmergenceManager voting(path, nlohmann::json::object());
+    ConsensusConfig config;
+    config.requiredMajority = 0.6;
+    config.minimumVotes = 3;
+    config.requirePerformanceEvidence = false;
+    voting.setConsensusConfig(config);
+    for (const char* id : {"a1", "a2", "a3"}) {
+        AgentContext context;
+        context.agentId = id;
+        voting.registerAgent(id, context);
+    }
+    ProtocolVariant variant("swarm", "swarm variant", nlohmann::json::object(), nlohmann::json::object());
+    voting.proposeVariant("swarm", variant, "swarm variant", nlohmann::json::object());
+
+    // Votes cast before the quiet period, so consensus may be reached at once
+    const auto cast = std::chrono::system_clock::now() - std::chrono::hours(2);
+    auto vote = [&](const char* agent, bool support, double weight = 1.0) {
+        return VotingRecord{"swarm", agent, support, "", cast, weight};
+    };
+    EXPECT_THROW(voting.voteOnVariants({vote("a3", true, 10.0), vote("ghost", true)}), std::runtime_error);
+
+    // a1 changing its mind still counts as one voter
+    voting.voteOnVariants({vote("a1", true), vote("a2", false), vote("a1", false)});
+    EXPECT_TRUE(voting.listVariants(VariantStatus::Adopted).empty());
+
+    // Three voters; support weighs 4 of 5
+    voting.voteOnVariants({vote("a3", true, 3.0), vote("a1", true)});
+    EXPECT_EQ(voting.listVariants(VariantStatus::Adopted).count("swarm"), 1u);
+    EXPECT_THROW(voting.voteOnVariant("a2", "swarm", true, "late"), std::runtime_error);
+    std::filesystem::remove_all(path);
+}
+
 TEST_F(EmergenceManagerTest, VariantRecommendations) {
     // Create a temporary file for persistence
     std::string tempPath = "test_recommendations.json";
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/awaitable.hpp"
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(AwaitableTest, ThenChainsValuesAndAwaitables) {
+    AwaitableResolver<int> first;
+    AwaitableResolver<std::string> second;
+    bool reached = false;
+
+    auto chained = first.awaitable()
+        .then([&](int value) { return value * 2; })
+        .then([&](int value) {
+            reached = value == 42;
+            return second.awaitable();  // Flattened into the chain
+        })
+        .then([](std::string text) { return text.size(); });
+
+    EXPECT_FALSE(chained.isReady());
+    first.resolve(21);
+    EXPECT_TRUE(reached);
+    EXPECT_FALSE(chained.isReady());
+    second.resolve("done");
+    ASSERT_TRUE(chained.isReady());
+    EXPECT_EQ(chained.get(), 4u);
+}
+
+TEST(AwaitableTest, ErrorsSkipTheRestOfTheChain) {
+    AwaitableResolver<int> source;
+    bool ran = false;
+    auto chained = source.awaitable()
+        .then([](int) -> int { throw std::runtime_error("first"); })
+        .then([&](int value) { ran = true; return value; });
+
+    source.resolve(1);
+    source.resolve(2);  // Ignored: the first result wins
+    EXPECT_THROW(chained.get(), std::runtime_error);
+    EXPECT_FALSE(ran);
+
+    EXPECT_THROW(Awaitable<int>::failed(std::make_exception_ptr(std::logic_error("x"))).get(), std::logic_error);
+    EXPECT_EQ(Awaitable<int>::ready(5).then([](int v) { return v + 1; }).get(), 6);
+}
+
+TEST(AwaitableTest, ContinuationsRunThroughTheScheduler) {
+    std::vector<std::function<void()>> posted;
+    AwaitableResolver<int> resolver([&](std::function<void()> resume) { posted.push_back(std::move(resume)); });
+    int seen = 0;
+    auto done = resolver.awaitable().then([&](int value) { return seen = value; });
+
+    resolver.resolve(7);
+    EXPECT_EQ(seen, 0);  // Waiting to run where the scheduler puts it
+    ASSERT_EQ(posted.size(), 1u);
+    posted.front()();
+    EXPECT_EQ(seen, 7);
+    EXPECT_EQ(done.get(), 7);
+}
+
+TEST(AwaitableTest, GetWaitsForAnotherThread) {
+    AwaitableResolver<int> resolver;
+    std::thread producer([resolver] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        resolver.resolve(3);
+    });
+    EXPECT_EQ(resolver.awaitable().get(), 3);
+    producer.join();
+}
+
+#ifdef XENOCOMM_HAVE_COROUTINES
+Awaitable<int> addRoundTrips(Awaitable<int> a, Awaitable<int> b) {
+    int first = co_await a;
+    int second = co_await b;
+    co_return first + second;
+}
+
+TEST(AwaitableTest, CoroutinesAwaitWithoutBlocking) {
+    AwaitableResolver<int> a;
+    AwaitableResolver<int> b;
+    auto sum = addRoundTrips(a.awaitable(), b.awaitable());
+    EXPECT_FALSE(sum.isReady());
+    a.resolve(2);
+    EXPECT_FALSE(sum.isReady());
+    b.resolve(40);
+    EXPECT_EQ(sum.get(), 42);
+}
+#endif
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
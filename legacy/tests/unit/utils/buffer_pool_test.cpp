@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/buffer_pool.hpp"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(BufferPoolTest, AcquireRoundsUpAndReusesReleasedBlocks) {
+    BufferPool pool;
+    auto buffer = pool.acquire(1000);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(buffer.size(), 1000u);
+    EXPECT_EQ(buffer.capacity(), 1024u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % 64, 0u);
+    const uint8_t* first = buffer.data();
+
+    buffer.reset();
+    EXPECT_FALSE(buffer);
+    auto again = pool.acquire(600);
+    EXPECT_EQ(again.data(), first);  // Straight back out of this thread's cache
+    EXPECT_EQ(pool.get_stats().slabs, 1u);
+}
+
+TEST(BufferPoolTest, HandlesShareStorageUntilTheLastRelease) {
+    BufferPool pool;
+    auto buffer = pool.acquire(64);
+    std::memcpy(buffer.data(), "0123456789", 10);
+    buffer.resize(10);
+    EXPECT_TRUE(buffer.unique());
+
+    auto tail = buffer.slice(4, 3);
+    EXPECT_FALSE(buffer.unique());
+    ASSERT_EQ(tail.size(), 3u);
+    EXPECT_EQ(std::memcmp(tail.data(), "456", 3), 0);
+    EXPECT_EQ(buffer.slice(8).size(), 2u);
+
+    const uint8_t* storage = buffer.data();
+    buffer.reset();
+    EXPECT_TRUE(tail.unique());
+    EXPECT_EQ(std::memcmp(tail.data(), "456", 3), 0);  // Still alive through the slice
+
+    tail.reset();
+    EXPECT_EQ(pool.acquire(64).data(), storage);
+    EXPECT_THROW(pool.acquire(64).resize(1024), std::length_error);
+}
+
+TEST(BufferPoolTest, ReleaseAndAdoptCarryTheReferenceThroughPlainData) {
+    BufferPool pool;
+    auto buffer = pool.acquire(512);
+    std::memcpy(buffer.data(), "abcdef", 6);
+    auto slice = buffer.slice(2, 3);
+    const uint8_t* storage = buffer.data();
+    buffer.reset();
+
+    PooledBuffer::Raw raw = slice.release();
+    EXPECT_FALSE(slice);
+    EXPECT_EQ(raw.size, 3u);
+
+    auto adopted = PooledBuffer::adopt(raw);
+    ASSERT_TRUE(adopted.unique());
+    EXPECT_EQ(std::memcmp(adopted.data(), "cde", 3), 0);
+    adopted.reset();
+    EXPECT_EQ(pool.acquire(512).data(), storage);
+}
+
+TEST(BufferPoolTest, OversizeRequestsComeFromTheHeap) {
+    BufferPool pool;
+    auto buffer = pool.acquire(BufferPool::MAX_POOLED_SIZE + 1);
+    EXPECT_EQ(buffer.size(), BufferPool::MAX_POOLED_SIZE + 1);
+    std::memset(buffer.data(), 0xAB, buffer.size());
+    buffer.reset();
+    auto stats = pool.get_stats();
+    EXPECT_EQ(stats.oversize_allocations, 1u);
+    EXPECT_EQ(stats.slabs, 0u);
+}
+
+TEST(BufferPoolTest, ReserveCarvesSlabsUpFront) {
+    BufferPool::Config config;
+    config.slab_size = 16 * 1024;
+    BufferPool pool(config);
+    pool.reserve(2048, 32);
+    auto reserved = pool.get_stats();
+    EXPECT_GE(reserved.slabs, 4u);
+
+    std::vector<PooledBuffer> buffers;
+    for (int i = 0; i < 32; ++i) {
+        buffers.push_back(pool.acquire(2048));
+    }
+    EXPECT_EQ(pool.get_stats().slabs, reserved.slabs);
+}
+
+TEST(BufferPoolTest, BuffersCrossThreadsAndReturnThroughTheDepot) {
+    BufferPool::Config config;
+    config.thread_cache_bytes = 8 * 1024;  // Eight 1 KiB buffers per thread cache
+    BufferPool pool(config);
+
+    constexpr int COUNT = 2000;
+    std::vector<PooledBuffer> produced;
+    std::thread producer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            auto buffer = pool.acquire(1024);
+            std::memset(buffer.data(), i & 0xFF, buffer.size());
+            produced.push_back(std::move(buffer));
+        }
+    });
+    producer.join();
+
+    std::thread consumer([&] {
+        for (int i = 0; i < COUNT; ++i) {
+            ASSERT_EQ(produced[i].data()[1023], i & 0xFF);
+            produced[i].reset();  // Released on a different thread than it was acquired on
+        }
+    });
+    consumer.join();
+
+    auto stats = pool.get_stats();
+    EXPECT_GT(stats.depot_returns, 0u);
+    size_t slabs = stats.slabs;
+    for (int i = 0; i < COUNT; ++i) {
+        produced[i] = pool.acquire(1024);
+    }
+    EXPECT_EQ(pool.get_stats().slabs, slabs);  // Every block came back for reuse
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/busy_poll.hpp"
+#include <sched.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(BusyPollTest, SpinsUntilTheSocketIsReadable) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(spinUntilReadable(fds[0], std::chrono::microseconds(500)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(500));
+
+    const char byte = 'x';
+    ASSERT_EQ(::write(fds[1], &byte, 1), 1);
+    EXPECT_TRUE(spinUntilReadable(fds[0], std::chrono::seconds(1)));
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST(BusyPollTest, PinsOnlyToValidCpus) {
+    EXPECT_FALSE(pinCurrentThread(-1));
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed)) ++cpu;
+    std::thread([cpu] { EXPECT_TRUE(pinCurrentThread(cpu)); }).join();
+#endif
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
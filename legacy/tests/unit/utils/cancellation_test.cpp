@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/cancellation.hpp"
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+using std::chrono::milliseconds;
+using Clock = CancellationToken::Clock;
+
+TEST(CancellationTokenTest, CancelReachesChildrenAndCallbacks) {
+    CancellationToken parent;
+    auto child = parent.child();
+    auto grandchild = child.child();
+    int calls = 0;
+    auto id = grandchild.onCancel([&] { ++calls; });
+    EXPECT_NE(id, 0u);
+    auto removed = grandchild.onCancel([&] { calls += 100; });
+    grandchild.removeCallback(removed);
+
+    EXPECT_FALSE(grandchild.isCancelled());
+    parent.cancel();
+    EXPECT_TRUE(child.isCancelled());
+    EXPECT_TRUE(grandchild.isCancelled());
+    EXPECT_EQ(calls, 1);
+
+    // Registered after the fact, the callback runs right away
+    EXPECT_EQ(grandchild.onCancel([&] { ++calls; }), 0u);
+    EXPECT_EQ(calls, 2);
+
+    // Cancelling a child leaves the parent alone
+    CancellationToken other;
+    other.child().cancel();
+    EXPECT_FALSE(other.isCancelled());
+}
+
+TEST(CancellationTokenTest, DeadlinesNarrowDownTheTree) {
+    auto parent = CancellationToken::afterTimeout(milliseconds(50));
+    auto later = parent.child(Clock::now() + std::chrono::hours(1));
+    EXPECT_EQ(later.deadline(), parent.deadline());
+    auto sooner = parent.child(Clock::now() + milliseconds(5));
+    EXPECT_LT(sooner.deadline(), parent.deadline());
+
+    EXPECT_LE(parent.remaining(milliseconds(1000)), milliseconds(50));
+    EXPECT_EQ(parent.remaining(milliseconds(10)), milliseconds(10));
+
+    EXPECT_FALSE(sooner.sleepFor(milliseconds(1000)));
+    EXPECT_TRUE(sooner.isCancelled());
+    EXPECT_FALSE(parent.isCancelled());
+    EXPECT_EQ(sooner.remaining(milliseconds(10)), milliseconds(0));
+}
+
+TEST(CancellationTokenTest, NoneIsNeverCancelled) {
+    auto none = CancellationToken::none();
+    EXPECT_FALSE(none.isCancellable());
+    none.cancel();
+    EXPECT_FALSE(none.isCancelled());
+    EXPECT_EQ(none.onCancel([] {}), 0u);
+    EXPECT_EQ(none.remaining(milliseconds(7)), milliseconds(7));
+    EXPECT_TRUE(none.sleepFor(milliseconds(1)));
+    EXPECT_TRUE(none.child().isCancellable());
+}
+
+TEST(CancellationTokenTest, ScopesSetTheThreadsToken) {
+    EXPECT_FALSE(CancellationToken::current().isCancellable());
+    CancellationToken outer;
+    {
+        CancellationScope scope(outer);
+        CancellationToken inner;
+        {
+            CancellationScope nested(inner);
+            inner.cancel();
+            EXPECT_TRUE(CancellationToken::current().isCancelled());
+        }
+        EXPECT_FALSE(CancellationToken::current().isCancelled());
+        outer.cancel();
+        EXPECT_TRUE(CancellationToken::current().isCancelled());
+
+        // Other threads do not see this thread's scope
+        bool seen = true;
+        std::thread([&] { seen = CancellationToken::current().isCancellable(); }).join();
+        EXPECT_FALSE(seen);
+    }
+    EXPECT_FALSE(CancellationToken::current().isCancellable());
+}
+
+TEST(CancellationTokenTest, CancelWakesASleeper) {
+    CancellationToken token;
+    std::thread canceller([token] {
+        std::this_thread::sleep_for(milliseconds(10));
+        token.cancel();
+    });
+    auto start = Clock::now();
+    EXPECT_FALSE(token.sleepFor(milliseconds(5000)));
+    EXPECT_LT(Clock::now() - start, milliseconds(2000));
+    canceller.join();
+}
+
+TEST(WaitForSocketTest, EndsOnReadinessTimeoutOrCancel) {
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    CancellationToken token;
+    EXPECT_EQ(waitForSocket(fds[0], POLLIN, milliseconds(5), token), SocketWait::TIMED_OUT);
+    EXPECT_EQ(waitForSocket(fds[0], POLLOUT, milliseconds(5), token), SocketWait::READY);
+
+    // The deadline ends an unbounded wait as a cancellation
+    EXPECT_EQ(waitForSocket(fds[0], POLLIN, milliseconds(-1), CancellationToken::afterTimeout(milliseconds(5))),
+              SocketWait::CANCELLED);
+
+    // cancel() from another thread wakes the poll well before its timeout
+    std::thread canceller([token] {
+        std::this_thread::sleep_for(milliseconds(10));
+        token.cancel();
+    });
+    auto start = Clock::now();
+    EXPECT_EQ(waitForSocket(fds[0], POLLIN, milliseconds(5000), token), SocketWait::CANCELLED);
+    EXPECT_LT(Clock::now() - start, milliseconds(2000));
+    canceller.join();
+
+    // The wake left behind does not end the next wait early
+    char byte = 'x';
+    ASSERT_EQ(::write(fds[1], &byte, 1), 1);
+    CancellationToken fresh;
+    EXPECT_EQ(waitForSocket(fds[0], POLLIN, milliseconds(100), fresh), SocketWait::READY);
+    EXPECT_EQ(waitForSocket(fds[0], POLLOUT, milliseconds(100), token), SocketWait::CANCELLED);
+
+    // Without a scope the default token is none()
+    EXPECT_EQ(waitForSocket(fds[0], POLLIN, milliseconds(5)), SocketWait::READY);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
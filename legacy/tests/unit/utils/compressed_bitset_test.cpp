@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/compressed_bitset.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+CompressedBitset fromSet(const std::set<uint32_t>& values) {
+    CompressedBitset bitset;
+    for (uint32_t value : values) {
+        bitset.add(value);
+    }
+    return bitset;
+}
+
+TEST(CompressedBitsetTest, AddRemoveAcrossArrayAndBitmapChunks) {
+    CompressedBitset bitset;
+    EXPECT_TRUE(bitset.add(5));
+    EXPECT_FALSE(bitset.add(5));
+    EXPECT_TRUE(bitset.add(70000));
+    EXPECT_TRUE(bitset.contains(5));
+    EXPECT_FALSE(bitset.contains(6));
+
+    // Push the first chunk past the array limit and back
+    for (uint32_t v = 0; v < 10000; ++v) {
+        bitset.add(v * 2);
+    }
+    EXPECT_EQ(bitset.cardinality(), 10002u);
+    EXPECT_TRUE(bitset.contains(19998));
+    EXPECT_FALSE(bitset.contains(19999));
+    for (uint32_t v = 0; v < 10000; ++v) {
+        bitset.remove(v * 2);
+    }
+    EXPECT_EQ(bitset.to_vector(), (std::vector<uint32_t>{5, 70000}));
+    EXPECT_TRUE(bitset.remove(5));
+    EXPECT_FALSE(bitset.remove(5));
+    EXPECT_TRUE(bitset.remove(70000));
+    EXPECT_TRUE(bitset.empty());
+}
+
+TEST(CompressedBitsetTest, IntersectAndUnionMatchSetAlgebra) {
+    std::mt19937 rng(42);
+    // Densities chosen so chunks end up as arrays, bitmaps and mixtures of both
+    for (uint32_t modulo : {3u, 40u, 2000u}) {
+        std::set<uint32_t> a;
+        std::set<uint32_t> b;
+        for (int i = 0; i < 60000; ++i) {
+            a.insert(rng() % (200000 / (modulo == 3 ? 1 : 4)));
+            if (i % modulo == 0) {
+                b.insert(rng() % 200000);
+            }
+        }
+        std::vector<uint32_t> expectedAnd;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedAnd));
+        std::vector<uint32_t> expectedOr;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expectedOr));
+
+        CompressedBitset both = fromSet(a);
+        both.intersect_with(fromSet(b));
+        EXPECT_EQ(both.to_vector(), expectedAnd) << modulo;
+        EXPECT_EQ(both.cardinality(), expectedAnd.size());
+
+        CompressedBitset either = fromSet(b);
+        either.union_with(fromSet(a));
+        EXPECT_EQ(either.to_vector(), expectedOr) << modulo;
+        EXPECT_EQ(either.cardinality(), expectedOr.size());
+    }
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/contention_profile.hpp"
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+uint64_t samples(const MetricHistogram& histogram) {
+    LatencyHistogram merged;
+    histogram.collect(merged);
+    return merged.count();
+}
+
+TEST(ContentionProfileTest, CountsAcquisitionsAndHoldTime) {
+    MetricsRegistry registry;
+    InstrumentedMutex<> mutex("test.lock", registry);
+    LockStats stats = LockStats::named("test.lock", registry);
+
+    {
+        std::lock_guard<InstrumentedMutex<>> lock(mutex);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    EXPECT_EQ(stats.acquisitions.value(), 2u);
+    EXPECT_EQ(stats.contended.value(), 0u);
+    EXPECT_EQ(samples(stats.wait_ns), 1u);  // try_lock never waits, so records none
+    EXPECT_EQ(samples(stats.hold_ns), 2u);
+
+    LatencyHistogram held;
+    stats.hold_ns.collect(held);
+    EXPECT_GE(held.max(), 2'000'000u);
+}
+
+TEST(ContentionProfileTest, RecordsWaitWhenContended) {
+    MetricsRegistry registry;
+    InstrumentedMutex<> mutex("test.contended", registry);
+    LockStats stats = LockStats::named("test.contended", registry);
+
+    std::unique_lock<InstrumentedMutex<>> holder(mutex);
+    std::thread waiter([&mutex] { std::lock_guard<InstrumentedMutex<>> lock(mutex); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    holder.unlock();
+    waiter.join();
+
+    EXPECT_EQ(stats.acquisitions.value(), 2u);
+    EXPECT_EQ(stats.contended.value(), 1u);
+    LatencyHistogram waited;
+    stats.wait_ns.collect(waited);
+    EXPECT_GE(waited.max(), 1'000'000u);
+}
+
+TEST(ContentionProfileTest, SharedLocksCountWithoutHoldTime) {
+    MetricsRegistry registry;
+    InstrumentedMutex<std::shared_mutex> mutex("test.shared", registry);
+    LockStats stats = LockStats::named("test.shared", registry);
+    {
+        std::shared_lock<InstrumentedMutex<std::shared_mutex>> first(mutex);
+        std::shared_lock<InstrumentedMutex<std::shared_mutex>> second(mutex);
+    }
+    {
+        std::unique_lock<InstrumentedMutex<std::shared_mutex>> writer(mutex);
+    }
+    EXPECT_EQ(stats.acquisitions.value(), 3u);
+    EXPECT_EQ(stats.contended.value(), 0u);
+    EXPECT_EQ(samples(stats.hold_ns), 1u);
+}
+
+TEST(ContentionProfileTest, LocksSharingANameShareSeries) {
+    MetricsRegistry registry;
+    std::vector<std::unique_ptr<InstrumentedMutex<>>> shards;
+    for (int i = 0; i < 4; ++i) {
+        shards.push_back(std::make_unique<InstrumentedMutex<>>("test.shard", registry));
+    }
+    for (auto& shard : shards) {
+        std::lock_guard<InstrumentedMutex<>> lock(*shard);
+    }
+    EXPECT_EQ(LockStats::named("test.shard", registry).acquisitions.value(), 4u);
+
+    const std::string text = registry.exposition();
+    EXPECT_NE(text.find("xenocomm_lock_acquisitions_total{lock=\"test.shard\"} 4"), std::string::npos);
+}
+
+TEST(ContentionProfileTest, AllocationStatsPerSubsystem) {
+    MetricsRegistry registry;
+    AllocationStats::named("arena", registry).record(64);
+    AllocationStats::named("arena", registry).record(32);
+    AllocationStats::named("pool", registry).record(8);
+    EXPECT_EQ(AllocationStats::named("arena", registry).allocations.value(), 2u);
+    EXPECT_EQ(AllocationStats::named("arena", registry).bytes.value(), 96u);
+    EXPECT_EQ(AllocationStats::named("pool", registry).bytes.value(), 8u);
+}
+
+TEST(ContentionProfileTest, ProfiledMutexWorksWithStandardLocks) {
+    ProfiledMutex<> mutex("test.profiled");
+    int value = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                std::lock_guard<ProfiledMutex<>> lock(mutex);
+                ++value;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(value, 4000);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/crc32.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::vector<uint8_t> generateRandomData(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> dis(0, 255);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+    return data;
+}
+
+TEST(Crc32Test, KnownCheckValue) {
+    const std::string check = "123456789";
+    const auto* bytes = reinterpret_cast<const uint8_t*>(check.data());
+    EXPECT_EQ(crc32(bytes, check.size()), 0xCBF43926u);
+    EXPECT_EQ(crc32Portable(bytes, check.size()), 0xCBF43926u);
+}
+
+TEST(Crc32Test, EmptyInputReturnsSeed) {
+    EXPECT_EQ(crc32(nullptr, 0), 0u);
+    EXPECT_EQ(crc32(nullptr, 0, 0xDEADBEEF), 0xDEADBEEFu);
+}
+
+TEST(Crc32Test, DispatchedKernelMatchesPortable) {
+    // Cover lengths around every kernel's block boundaries and odd alignments
+    auto data = generateRandomData(4096 + 64, 42);
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t size : {1u, 7u, 8u, 15u, 16u, 63u, 64u, 65u, 127u, 128u, 1000u, 1024u, 4096u}) {
+            EXPECT_EQ(crc32(data.data() + offset, size), crc32Portable(data.data() + offset, size))
+                << "offset " << offset << " size " << size;
+        }
+    }
+}
+
+TEST(Crc32Test, ContinuationMatchesSinglePass) {
+    auto data = generateRandomData(3000, 7);
+    uint32_t whole = crc32(data.data(), data.size());
+    uint32_t partial = crc32(data.data(), 1234);
+    partial = crc32(data.data() + 1234, data.size() - 1234, partial);
+    EXPECT_EQ(partial, whole);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
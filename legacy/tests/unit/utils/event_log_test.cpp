@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/event_log.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST(EventLogTest, WritesEveryEventOfConcurrentWritersInOrder) {
+    const std::string path = "event_log_text_test.log";
+    std::remove(path.c_str());
+    constexpr int WRITERS = 4;
+    constexpr int EVENTS = 3000;  // More than the queue holds, so writers drain it too
+    {
+        auto log = EventLog::open(path);
+        EXPECT_EQ(EventLog::open(path), log);
+        std::vector<std::thread> writers;
+        for (int w = 0; w < WRITERS; ++w) {
+            writers.emplace_back([&, w] {
+                for (int i = 0; i < EVENTS; ++i) {
+                    log->write("writer " + std::to_string(w) + " event " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+    }
+
+    std::istringstream lines(readFile(path));
+    std::vector<int> next(WRITERS, 0);
+    std::string stamp, line;
+    int total = 0;
+    while (std::getline(lines, stamp) && std::getline(lines, line)) {
+        int writer = -1, event = -1;
+        ASSERT_EQ(std::sscanf(line.c_str(), ": writer %d event %d", &writer, &event), 2) << line;
+        ASSERT_EQ(event, next[writer]++);
+        ++total;
+    }
+    EXPECT_EQ(total, WRITERS * EVENTS);
+    std::remove(path.c_str());
+}
+
+TEST(EventLogTest, FlushWritesQueuedEventsAtOnce) {
+    const std::string path = "event_log_flush_test.log";
+    std::remove(path.c_str());
+    auto log = EventLog::open(path);
+    log->write("vote recorded");
+    log->flush();
+    EXPECT_NE(readFile(path).find(": vote recorded\n"), std::string::npos);
+    log.reset();
+    std::remove(path.c_str());
+}
+
+TEST(EventLogTest, RotatesFullFilesKeepingTheNewest) {
+    const std::string path = "event_log_rotate_test.log";
+    auto cleanup = [&] {
+        for (const char* suffix : {"", ".1", ".2", ".3"}) {
+            std::remove((path + suffix).c_str());
+        }
+    };
+    cleanup();
+    auto log = EventLog::open(path);
+    log->setRotation(100, 3);
+    for (int i = 0; i < 5; ++i) {
+        log->write("batch " + std::to_string(i) + std::string(100, '.'));
+        log->flush();  // One batch per file, each past the limit
+    }
+
+    // The last batch went to path.1: the file being written is only opened for the next one
+    EXPECT_NE(readFile(path + ".1").find(": batch 4"), std::string::npos);
+    EXPECT_NE(readFile(path + ".2").find(": batch 3"), std::string::npos);
+    EXPECT_FALSE(std::ifstream(path + ".3").good());
+    log->write("after");
+    log->flush();
+    EXPECT_NE(readFile(path).find(": after"), std::string::npos);
+    log.reset();
+    cleanup();
+}
+
+TEST(EventLogTest, RoundTripsBinaryRecordsAndStopsAtATornOne) {
+    const std::string path = "event_log_binary_test.log";
+    std::remove(path.c_str());
+    auto before = EventLog::Clock::now();
+    {
+        auto log = EventLog::open(path, EventLog::Format::Binary);
+        log->write("created");
+        log->write(std::string("with\0nul", 8));
+        log->write("");
+    }
+    auto events = EventLog::readBinary(path);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].message, "created");
+    EXPECT_EQ(events[1].message, std::string("with\0nul", 8));
+    EXPECT_EQ(events[2].message, "");
+    EXPECT_GE(events[0].time + std::chrono::microseconds(1), before);
+
+    // A record cut short by a crash ends the log
+    std::ofstream(path, std::ios::binary | std::ios::app) << "XEV1\x10";
+    EXPECT_EQ(EventLog::readBinary(path).size(), 3u);
+    std::remove(path.c_str());
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/frame_codec.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::vector<uint8_t> encodeFrames(const std::vector<std::string>& payloads, FrameLengthEncoding encoding) {
+    std::vector<uint8_t> stream;
+    for (const auto& payload : payloads) {
+        uint8_t prefix[MAX_FRAME_PREFIX];
+        size_t length = encodeFramePrefix(static_cast<uint32_t>(payload.size()), encoding, prefix);
+        stream.insert(stream.end(), prefix, prefix + length);
+        stream.insert(stream.end(), payload.begin(), payload.end());
+    }
+    return stream;
+}
+
+TEST(FrameCodecTest, VarintPrefixLengths) {
+    uint8_t prefix[MAX_FRAME_PREFIX];
+    EXPECT_EQ(encodeFramePrefix(0, FrameLengthEncoding::VARINT, prefix), 1u);
+    EXPECT_EQ(encodeFramePrefix(127, FrameLengthEncoding::VARINT, prefix), 1u);
+    EXPECT_EQ(encodeFramePrefix(128, FrameLengthEncoding::VARINT, prefix), 2u);
+    EXPECT_EQ(prefix[0], 0x80);
+    EXPECT_EQ(prefix[1], 0x01);
+    EXPECT_EQ(encodeFramePrefix(UINT32_MAX, FrameLengthEncoding::VARINT, prefix), 5u);
+    EXPECT_EQ(encodeFramePrefix(300, FrameLengthEncoding::FIXED32, prefix), 4u);
+    EXPECT_EQ(prefix[2], 0x01);
+    EXPECT_EQ(prefix[3], 0x2C);
+}
+
+TEST(FrameCodecTest, DecodesCoalescedFramesFedByteByByte) {
+    for (auto encoding : {FrameLengthEncoding::VARINT, FrameLengthEncoding::FIXED32}) {
+        std::vector<std::string> payloads = {"a", "", std::string(200, 'x'), "tail"};
+        auto stream = encodeFrames(payloads, encoding);
+
+        FrameDecoder decoder(encoding);
+        std::vector<std::string> decoded;
+        for (uint8_t byte : stream) {
+            decoder.feed(ByteSpan(&byte, 1));
+            ByteSpan frame;
+            while (decoder.next(frame) == FrameDecoder::Status::FRAME) {
+                decoded.emplace_back(reinterpret_cast<const char*>(frame.data()), frame.size());
+            }
+        }
+        EXPECT_EQ(decoded, payloads);
+        EXPECT_EQ(decoder.buffered(), 0u);
+    }
+}
+
+TEST(FrameCodecTest, PrepareReservesTheRestOfALargeFrame) {
+    std::string payload(100000, 'z');
+    auto stream = encodeFrames({payload}, FrameLengthEncoding::VARINT);
+
+    FrameDecoder decoder;
+    decoder.feed(ByteSpan(stream.data(), 10));
+    ByteSpan frame;
+    EXPECT_EQ(decoder.next(frame), FrameDecoder::Status::NEED_MORE);
+    EXPECT_EQ(decoder.missing(), stream.size() - 10);
+
+    auto space = decoder.prepare(16);
+    ASSERT_GE(space.size(), stream.size() - 10);
+    std::memcpy(space.data(), stream.data() + 10, stream.size() - 10);
+    decoder.commit(stream.size() - 10);
+    ASSERT_EQ(decoder.next(frame), FrameDecoder::Status::FRAME);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(frame.data()), frame.size()), payload);
+}
+
+TEST(FrameCodecTest, RejectsOversizedAndMalformedPrefixes) {
+    FrameDecoder small(FrameLengthEncoding::VARINT, 16);
+    auto stream = encodeFrames({std::string(17, 'q')}, FrameLengthEncoding::VARINT);
+    small.feed(ByteSpan(stream));
+    ByteSpan frame;
+    EXPECT_EQ(small.next(frame), FrameDecoder::Status::TOO_LARGE);
+
+    FrameDecoder decoder;
+    const uint8_t endless[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    decoder.feed(ByteSpan(endless, sizeof(endless)));
+    EXPECT_EQ(decoder.next(frame), FrameDecoder::Status::MALFORMED);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
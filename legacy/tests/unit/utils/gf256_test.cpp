@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/gf256.hpp"
+#include <random>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::vector<uint8_t> generateRandomData(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> dis(0, 255);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(dis(gen));
+    }
+    return data;
+}
+
+// Shift-and-add reference multiply, independent of the log/exp tables
+uint8_t referenceMul(uint8_t a, uint8_t b) {
+    unsigned product = 0;
+    unsigned x = a;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (b & (1u << bit)) {
+            product ^= x;
+        }
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11D;
+        }
+    }
+    return static_cast<uint8_t>(product);
+}
+
+TEST(Gf256Test, MultiplyMatchesReference) {
+    for (unsigned a = 0; a < 256; ++a) {
+        for (unsigned b = 0; b < 256; ++b) {
+            ASSERT_EQ(gf256Mul(static_cast<uint8_t>(a), static_cast<uint8_t>(b)),
+                      referenceMul(static_cast<uint8_t>(a), static_cast<uint8_t>(b)))
+                << a << " * " << b;
+        }
+    }
+}
+
+TEST(Gf256Test, InverseIsMultiplicativeInverse) {
+    EXPECT_EQ(gf256Inv(0), 0);
+    for (unsigned a = 1; a < 256; ++a) {
+        EXPECT_EQ(gf256Mul(static_cast<uint8_t>(a), gf256Inv(static_cast<uint8_t>(a))), 1) << a;
+    }
+}
+
+TEST(Gf256Test, RegionKernelsMatchScalarMultiply) {
+    // Cover the SIMD block boundaries, scalar tails and unaligned starts
+    auto src = generateRandomData(1024 + 64, 7);
+    auto base = generateRandomData(1024 + 64, 11);
+    for (unsigned coefficient : {0u, 1u, 2u, 0x53u, 0xFFu}) {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            for (size_t size : {1u, 15u, 16u, 17u, 31u, 32u, 33u, 100u, 1024u}) {
+                std::vector<uint8_t> mul(size);
+                std::vector<uint8_t> mulAdd(base.begin() + offset, base.begin() + offset + size);
+                gf256MulRegion(static_cast<uint8_t>(coefficient), src.data() + offset, mul.data(), size);
+                gf256MulAddRegion(static_cast<uint8_t>(coefficient), src.data() + offset, mulAdd.data(), size);
+
+                for (size_t i = 0; i < size; ++i) {
+                    uint8_t product = referenceMul(static_cast<uint8_t>(coefficient), src[offset + i]);
+                    ASSERT_EQ(mul[i], product) << "coefficient " << coefficient << " size " << size;
+                    ASSERT_EQ(mulAdd[i], base[offset + i] ^ product)
+                        << "coefficient " << coefficient << " size " << size;
+                }
+            }
+        }
+    }
+}
+
+TEST(Gf256Test, MulRegionWorksInPlace) {
+    auto data = generateRandomData(257, 3);
+    auto expected = data;
+    for (auto& byte : expected) {
+        byte = referenceMul(0x8E, byte);
+    }
+    gf256MulRegion(0x8E, data.data(), data.data(), data.size());
+    EXPECT_EQ(data, expected);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
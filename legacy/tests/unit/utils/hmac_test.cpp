@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/hmac.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::string hex(const uint8_t* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < size; ++i) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 0x0f];
+    }
+    return out;
+}
+
+ByteSpan bytes(const std::string& text) {
+    return ByteSpan(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+std::string macHex(const HmacSha256& hmac, std::initializer_list<ByteSpan> parts) {
+    uint8_t tag[HmacSha256::DIGEST_SIZE];
+    EXPECT_TRUE(hmac.mac(parts, tag));
+    return hex(tag, sizeof(tag));
+}
+
+} // namespace
+
+// RFC 4231 test cases 1, 2 and 6
+TEST(HmacSha256Test, MatchesRfc4231) {
+    std::vector<uint8_t> key1(20, 0x0b);
+    EXPECT_EQ(macHex(HmacSha256(key1), {bytes("Hi There")}),
+              "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+
+    EXPECT_EQ(macHex(HmacSha256(bytes("Jefe")), {bytes("what do ya want for nothing?")}),
+              "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    // Keys longer than the block are hashed first
+    std::vector<uint8_t> key6(131, 0xaa);
+    EXPECT_EQ(macHex(HmacSha256(key6), {bytes("Test Using Larger Than Block-Size Key - Hash Key First")}),
+              "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+}
+
+TEST(HmacSha256Test, PartsAreConcatenated) {
+    HmacSha256 hmac(bytes("Jefe"));
+    std::string whole = macHex(hmac, {bytes("what do ya want for nothing?")});
+    EXPECT_EQ(macHex(hmac, {bytes("what do ya "), ByteSpan(), bytes("want for nothing?")}), whole);
+    // The keyed context is reused, not consumed
+    EXPECT_EQ(macHex(hmac, {bytes("what do ya want for nothing?")}), whole);
+}
+
+TEST(HmacSha256Test, CopiesAndMovesKeepTheKey) {
+    HmacSha256 hmac(bytes("Jefe"));
+    std::string expected = macHex(hmac, {bytes("message")});
+
+    HmacSha256 copy(hmac);
+    EXPECT_EQ(macHex(copy, {bytes("message")}), expected);
+
+    HmacSha256 moved(std::move(copy));
+    EXPECT_EQ(macHex(moved, {bytes("message")}), expected);
+
+    HmacSha256 assigned;
+    EXPECT_FALSE(assigned.keyed());
+    uint8_t tag[HmacSha256::DIGEST_SIZE];
+    EXPECT_FALSE(assigned.mac(bytes("message"), tag));
+    assigned = hmac;
+    EXPECT_EQ(macHex(assigned, {bytes("message")}), expected);
+}
+
+TEST(HmacSha256Test, ConcurrentMacsAgree) {
+    HmacSha256 hmac(bytes("shared key"));
+    const std::string expected = macHex(hmac, {bytes("payload")});
+
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i) {
+                uint8_t tag[HmacSha256::DIGEST_SIZE];
+                if (!hmac.mac(bytes("payload"), tag) || hex(tag, sizeof(tag)) != expected) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        EXPECT_EQ(count, 0);
+    }
+}
+
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/latency_histogram.hpp"
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(LatencyHistogramTest, BucketsAreExactForSmallValuesAndBoundedAbove) {
+    for (uint64_t value = 0; value < LatencyHistogram::SUB_BUCKETS; ++value) {
+        EXPECT_EQ(LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_for(value)), value);
+    }
+    for (uint64_t value : {8ull, 9ull, 100ull, 1000ull, 123456ull, 1ull << 39}) {
+        uint64_t upper = LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_for(value));
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 8) << value;
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_for(~0ull), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(LatencyHistogramTest, ReportsPercentilesWithinBucketPrecision) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.value_at_percentile(50.0), 0u);
+    for (uint64_t value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.count(), 10000u);
+    EXPECT_EQ(histogram.max(), 10000u);
+    EXPECT_EQ(histogram.sum(), 10000u * 10001u / 2);
+    EXPECT_NEAR(static_cast<double>(histogram.value_at_percentile(50.0)), 5000.0, 5000.0 / 8);
+    EXPECT_NEAR(static_cast<double>(histogram.value_at_percentile(99.0)), 9900.0, 9900.0 / 8);
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 10000u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+}
+
+TEST(LatencyHistogramTest, MergesConcurrentRecorders) {
+    constexpr int THREADS = 4;
+    constexpr uint64_t PER_THREAD = 5000;
+    std::vector<LatencyHistogram> histograms(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&histograms, t] {
+            for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                histograms[t].record(i % 100 + static_cast<uint64_t>(t) * 1000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    LatencyHistogram total;
+    for (const auto& histogram : histograms) {
+        total.merge(histogram);
+    }
+    EXPECT_EQ(total.count(), THREADS * PER_THREAD);
+    EXPECT_EQ(total.max(), 3099u);
+    EXPECT_LT(total.value_at_percentile(25.0), 1000u);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/logging.hpp"
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+class CaptureSink : public LogSink {
+public:
+    void write(const LogRecord& record) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        records.push_back(record);
+    }
+
+    std::mutex mutex;
+    std::vector<LogRecord> records;
+};
+
+class LoggingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previousSink_ = Logger::sink();
+        previousLevel_ = Logger::level();
+        sink_ = std::make_shared<CaptureSink>();
+        Logger::setSink(sink_);
+    }
+
+    void TearDown() override {
+        Logger::setSink(previousSink_);
+        Logger::setLevel(previousLevel_);
+    }
+
+    std::shared_ptr<CaptureSink> sink_;
+
+private:
+    std::shared_ptr<LogSink> previousSink_;
+    LogLevel previousLevel_ = LogLevel::Warn;
+};
+
+int countedArgument(int& evaluations) {
+    ++evaluations;
+    return evaluations;
+}
+
+TEST(FormatLogTest, ReplacesPlaceholdersInOrder) {
+    EXPECT_EQ(formatLog("plain"), "plain");
+    EXPECT_EQ(formatLog("{} of {}", 3, std::string("five")), "3 of five");
+    EXPECT_EQ(formatLog("{{}} {}", 'x'), "{} x");
+    EXPECT_EQ(formatLog("{} {}", 1), "1 {}");
+    EXPECT_EQ(formatLog("{}", 1, 2), "1");
+}
+
+TEST_F(LoggingTest, RuntimeLevelFiltersWithoutEvaluatingArguments) {
+    Logger::setLevel(LogLevel::Error);
+    int evaluations = 0;
+    XLOG_WARN("skipped {}", countedArgument(evaluations));
+    EXPECT_EQ(evaluations, 0);
+    EXPECT_TRUE(sink_->records.empty());
+
+    XLOG_ERROR("kept {}", countedArgument(evaluations));
+    EXPECT_EQ(evaluations, 1);
+    ASSERT_EQ(sink_->records.size(), 1u);
+    EXPECT_EQ(sink_->records[0].level, LogLevel::Error);
+    EXPECT_EQ(sink_->records[0].message, "kept 1");
+    EXPECT_GT(sink_->records[0].line, 0);
+}
+
+TEST_F(LoggingTest, SitesBelowTheCompiledLevelAreRemoved) {
+    Logger::setLevel(LogLevel::Trace);
+    int evaluations = 0;
+    XLOG_TRACE("trace {}", countedArgument(evaluations));
+    const bool compiledIn = XENOCOMM_LOG_LEVEL <= XENOCOMM_LOG_LEVEL_TRACE;
+    EXPECT_EQ(evaluations, compiledIn ? 1 : 0);
+    EXPECT_EQ(sink_->records.size(), compiledIn ? 1u : 0u);
+}
+
+TEST_F(LoggingTest, AsyncSinkDeliversInOrderByFlush) {
+    Logger::setLevel(LogLevel::Info);
+    Logger::setSink(std::make_shared<AsyncLogSink>(sink_, 8));
+    for (int i = 0; i < 100; ++i) {
+        XLOG_ERROR("record {}", i);
+    }
+    Logger::flush();
+    std::lock_guard<std::mutex> lock(sink_->mutex);
+    ASSERT_EQ(sink_->records.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(sink_->records[i].message, "record " + std::to_string(i));
+    }
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
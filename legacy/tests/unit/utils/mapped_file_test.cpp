@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/mapped_file.hpp"
+#include <cstdlib>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+class MappedRegionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/xenocomm_mapped_file_XXXXXX";
+        fd_ = mkstemp(path);
+        ASSERT_GE(fd_, 0);
+        unlink(path);
+        contents_.resize(20000);
+        for (size_t i = 0; i < contents_.size(); ++i) {
+            contents_[i] = static_cast<uint8_t>(i * 13 + i / 256);
+        }
+        ASSERT_EQ(write(fd_, contents_.data(), contents_.size()), static_cast<ssize_t>(contents_.size()));
+    }
+
+    void TearDown() override { close(fd_); }
+
+    int fd_ = -1;
+    std::vector<uint8_t> contents_;
+};
+
+TEST_F(MappedRegionTest, MapsARegionAtAnyOffset) {
+    MappedRegion region(fd_, 5001, 9000);
+    ASSERT_TRUE(region.valid());
+    ASSERT_EQ(region.size(), 9000u);
+    EXPECT_TRUE(std::equal(region.data(), region.data() + region.size(), contents_.begin() + 5001));
+
+    // The mapping outlives the descriptor and moves with its owner
+    MappedRegion moved(std::move(region));
+    EXPECT_EQ(region.size(), 0u);
+    EXPECT_EQ(moved.span()[0], contents_[5001]);
+}
+
+TEST_F(MappedRegionTest, RefusesRegionsOutsideTheFile) {
+    MappedRegion past(fd_, 19990, 100);
+    EXPECT_FALSE(past.valid());
+    EXPECT_NE(past.error(), 0);
+    EXPECT_FALSE(MappedRegion(fd_, -1, 10).valid());
+    EXPECT_FALSE(MappedRegion(-1, 0, 10).valid());
+
+    // Nothing to map is never an error
+    MappedRegion empty(fd_, 0, 0);
+    EXPECT_TRUE(empty.valid());
+    EXPECT_TRUE(empty.span().empty());
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/memory_budget.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(MemoryBudgetTest, RefusesWhatDoesNotFit) {
+    MemoryBudget budget(100);
+    EXPECT_TRUE(budget.tryAcquire(60));
+    EXPECT_FALSE(budget.tryAcquire(50));
+    EXPECT_TRUE(budget.tryAcquire(40));
+    EXPECT_EQ(budget.used(), 100u);
+    budget.release(60);
+    EXPECT_TRUE(budget.tryAcquire(50));
+    EXPECT_FALSE(budget.fits(101));
+
+    // Lowering the limit keeps what is charged but admits nothing more until it drains
+    budget.setLimit(50);
+    EXPECT_EQ(budget.used(), 90u);
+    EXPECT_FALSE(budget.tryAcquire(1));
+    budget.release(90);
+    EXPECT_TRUE(budget.tryAcquire(50));
+
+    MemoryBudget unlimited;
+    EXPECT_TRUE(unlimited.fits(SIZE_MAX));
+    EXPECT_TRUE(unlimited.tryAcquire(size_t(1) << 40));
+}
+
+TEST(MemoryBudgetTest, WatermarksHaveHysteresis) {
+    MemoryBudget budget(100, 0.8, 0.5);
+    std::vector<bool> events;
+    auto id = budget.addWatermarkCallback([&](bool high, size_t) { events.push_back(high); });
+
+    ASSERT_TRUE(budget.tryAcquire(70));
+    EXPECT_TRUE(events.empty());
+    ASSERT_TRUE(budget.tryAcquire(10));
+    EXPECT_TRUE(budget.underPressure());
+    budget.release(20);  // 60: between the marks, so still high
+    ASSERT_TRUE(budget.tryAcquire(30));
+    budget.release(40);  // 50: low mark
+    EXPECT_FALSE(budget.underPressure());
+    EXPECT_EQ(events, (std::vector<bool>{true, false}));
+
+    // Removing the limit lifts pressure
+    ASSERT_TRUE(budget.tryAcquire(40));
+    budget.setLimit(0);
+    EXPECT_EQ(events, (std::vector<bool>{true, false, true, false}));
+
+    budget.removeWatermarkCallback(id);
+    budget.setLimit(100);
+    EXPECT_EQ(events.size(), 4u);
+}
+
+TEST(MemoryBudgetTest, CallbacksMayReleaseFromInsideTheCallback) {
+    MemoryBudget budget(100, 0.5, 0.1);
+    std::vector<bool> events;
+    budget.addWatermarkCallback([&](bool high, size_t) {
+        events.push_back(high);
+        if (high) {
+            budget.release(60);  // Shed load straight away
+        }
+    });
+    ASSERT_TRUE(budget.tryAcquire(60));
+    EXPECT_EQ(budget.used(), 0u);
+    EXPECT_EQ(events, (std::vector<bool>{true, false}));
+    EXPECT_FALSE(budget.underPressure());
+}
+
+TEST(MemoryBudgetTest, ConcurrentChargesNeverExceedTheLimit) {
+    MemoryBudget budget(1000);
+    std::atomic<bool> exceeded{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                if (budget.tryAcquire(7)) {
+                    if (budget.used() > 1000) {
+                        exceeded = true;
+                    }
+                    budget.release(7);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(exceeded.load());
+    EXPECT_EQ(budget.used(), 0u);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
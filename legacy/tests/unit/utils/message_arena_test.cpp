@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/message_arena.hpp"
+#include <map>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(MessageArenaTest, SmallMessagesStayInTheBlock) {
+    MessageArena arena(4096);
+    std::pmr::vector<int> numbers(arena.resource());
+    numbers.reserve(100);
+    std::pmr::map<int, int> map(arena.resource());
+    for (int i = 0; i < 20; ++i) {
+        numbers.push_back(i);
+        map[i] = i * i;
+    }
+    EXPECT_EQ(map[7], 49);
+    EXPECT_EQ(arena.overflow_bytes(), 0u);
+}
+
+TEST(MessageArenaTest, OverflowComesFromTheHeap) {
+    MessageArena arena(1024);
+    std::pmr::vector<uint8_t> first(512, 1, arena.resource());
+    std::pmr::vector<uint8_t> second(4096, 2, arena.resource());
+    EXPECT_GE(arena.overflow_bytes(), 4096u);
+    EXPECT_EQ(first[511], 1);
+    EXPECT_EQ(second[4095], 2);
+}
+
+TEST(MessageArenaTest, OutgrownBlocksAreEnlargedForLaterMessages) {
+    // Each overflowing arena hands back a block big enough for its message, so repeats stop overflowing
+    size_t overflow = 0;
+    for (int message = 0; message < 20; ++message) {
+        MessageArena arena(1024);
+        std::pmr::vector<uint8_t> large(8 * 1024, 1, arena.resource());
+        overflow = arena.overflow_bytes();
+    }
+    EXPECT_EQ(overflow, 0u);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
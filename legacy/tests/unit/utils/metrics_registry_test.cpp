@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/metrics_registry.hpp"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+TEST(MetricsRegistryTest, CountersSumEveryThreadsShard) {
+    MetricsRegistry registry;
+    MetricCounter& counter = registry.counter("requests", "Requests served");
+    constexpr int THREADS = 8;
+    constexpr int ADDS = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&registry] {
+            // Looking the counter up again returns the same one
+            MetricCounter& same = registry.counter("requests", "Requests served");
+            for (int i = 0; i < ADDS; ++i) {
+                same.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), static_cast<uint64_t>(THREADS * ADDS));
+}
+
+TEST(MetricsRegistryTest, LabelSetsAreSeparateSeries) {
+    MetricsRegistry registry;
+    registry.counter("bytes", "Bytes", {{"direction", "in"}}).add(3);
+    registry.counter("bytes", "Bytes", {{"direction", "out"}}).add(5);
+    EXPECT_EQ(registry.counter("bytes", "Bytes", {{"direction", "in"}}).value(), 3u);
+
+    const std::string text = registry.exposition();
+    EXPECT_TRUE(contains(text, "# TYPE bytes_total counter\n"));
+    EXPECT_TRUE(contains(text, "bytes_total{direction=\"in\"} 3\n"));
+    EXPECT_TRUE(contains(text, "bytes_total{direction=\"out\"} 5\n"));
+}
+
+TEST(MetricsRegistryTest, RejectsBadNamesAndTypeChanges) {
+    MetricsRegistry registry;
+    EXPECT_THROW(registry.counter("1bad", "help"), std::invalid_argument);
+    EXPECT_THROW(registry.gauge("has-dash", "help"), std::invalid_argument);
+    EXPECT_THROW(registry.gauge("ok", "help", {{"bad:label", "v"}}), std::invalid_argument);
+    registry.counter("taken", "help");
+    EXPECT_THROW(registry.gauge("taken", "help"), std::invalid_argument);
+}
+
+TEST(MetricsRegistryTest, GaugesSetAndAdd) {
+    MetricsRegistry registry;
+    MetricGauge& gauge = registry.gauge("depth", "Queue depth");
+    gauge.set(2.5);
+    gauge.add(-1.0);
+    EXPECT_DOUBLE_EQ(gauge.value(), 1.5);
+    EXPECT_TRUE(contains(registry.exposition(), "depth 1.5\n"));
+}
+
+TEST(MetricsRegistryTest, HistogramBucketsAreCumulative) {
+    MetricsRegistry registry;
+    MetricHistogram& histogram = registry.histogram("latency_us", "Latency");
+    for (uint64_t value : {0u, 1u, 2u, 3u, 4u, 100u, 1000u}) {
+        histogram.record(value);
+    }
+    const std::string text = registry.exposition();
+    EXPECT_TRUE(contains(text, "# TYPE latency_us histogram\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"0\"} 1\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"1\"} 2\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"3\"} 4\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"7\"} 5\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"127\"} 6\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"1023\"} 7\n"));
+    EXPECT_TRUE(contains(text, "latency_us_bucket{le=\"+Inf\"} 7\n"));
+    EXPECT_TRUE(contains(text, "latency_us_sum 1110\n"));
+    EXPECT_TRUE(contains(text, "latency_us_count 7\n"));
+}
+
+TEST(MetricsRegistryTest, CollectorsReportUntilTheirRegistrationEnds) {
+    MetricsRegistry registry;
+    {
+        MetricsRegistration registration = registry.addCollector([](MetricsWriter& writer) {
+            writer.gauge("pool_idle", "Idle connections", 4, {{"instance", "a\"b"}});
+            writer.summary("rtt_ms", "Round trip", 10, 55.0, {{0.5, 5.0}, {0.99, 9.0}});
+        });
+        const std::string text = registry.exposition();
+        EXPECT_TRUE(contains(text, "pool_idle{instance=\"a\\\"b\"} 4\n"));
+        EXPECT_TRUE(contains(text, "rtt_ms{quantile=\"0.5\"} 5\n"));
+        EXPECT_TRUE(contains(text, "rtt_ms_sum 55\n"));
+        EXPECT_TRUE(contains(text, "rtt_ms_count 10\n"));
+
+        MetricsRegistration moved = std::move(registration);
+        EXPECT_FALSE(registration.active());
+        EXPECT_TRUE(contains(registry.exposition(), "pool_idle"));
+    }
+    EXPECT_FALSE(contains(registry.exposition(), "pool_idle"));
+}
+
+TEST(MetricsRegistryTest, OpenMetricsNamesCounterFamiliesWithoutSuffix) {
+    MetricsRegistry registry;
+    registry.counter("sends", "Messages sent").add(2);
+    const std::string text = registry.exposition(ExpositionFormat::OPENMETRICS);
+    EXPECT_TRUE(contains(text, "# HELP sends Messages sent\n"));
+    EXPECT_TRUE(contains(text, "# TYPE sends counter\n"));
+    EXPECT_TRUE(contains(text, "sends_total 2\n"));
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+    EXPECT_FALSE(contains(registry.exposition(), "# EOF"));
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
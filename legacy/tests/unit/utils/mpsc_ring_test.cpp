@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/mpsc_ring.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+struct Item {
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+TEST(MpscRingTest, RoundsCapacityAndReportsFull) {
+    MpscRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(99));
+
+    int value = -1;
+    ASSERT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.try_push(8));  // The freed cell is reusable after wrap-around
+
+    for (int expected = 1; expected <= 8; ++expected) {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(MpscRingTest, ConcurrentProducersKeepPerProducerOrder) {
+    constexpr uint32_t PRODUCERS = 4;
+    constexpr uint32_t PER_PRODUCER = 50000;
+    MpscRing<Item> ring(256);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                while (!ring.try_push(Item{p, i})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(PRODUCERS, 0);
+    uint32_t received = 0;
+    Item item{};
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (!ring.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_LT(item.producer, PRODUCERS);
+        ASSERT_EQ(item.sequence, next[item.producer]) << "producer " << item.producer;
+        ++next[item.producer];
+        ++received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/quantile_sketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+double exactQuantile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    auto index = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+    return values[index];
+}
+
+TEST(QuantileSketchTest, QuantilesAreWithinTheRelativeAccuracy) {
+    QuantileSketch sketch(0.01);
+    std::mt19937 rng(7);
+    std::lognormal_distribution<double> latency(8.0, 1.5);
+    std::vector<double> values;
+    for (int i = 0; i < 20000; ++i) {
+        values.push_back(latency(rng));
+        sketch.add(values.back());
+    }
+
+    for (double q : {0.0, 0.5, 0.9, 0.95, 0.99, 1.0}) {
+        double exact = exactQuantile(values, q);
+        EXPECT_NEAR(sketch.quantile(q), exact, exact * 0.01) << q;
+    }
+    EXPECT_EQ(sketch.count(), values.size());
+}
+
+TEST(QuantileSketchTest, MeanAndDeviationAreExact) {
+    QuantileSketch sketch;
+    for (double value : {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0}) {
+        sketch.add(value);
+    }
+    EXPECT_DOUBLE_EQ(sketch.mean(), 5.0);
+    EXPECT_DOUBLE_EQ(sketch.standardDeviation(), 2.0);
+}
+
+TEST(QuantileSketchTest, RemovedValuesLeaveTheWindow) {
+    QuantileSketch sketch;
+    for (int i = 1; i <= 100; ++i) {
+        sketch.add(i);
+    }
+    for (int i = 1; i <= 50; ++i) {
+        sketch.remove(i);
+    }
+    EXPECT_EQ(sketch.count(), 50u);
+    EXPECT_NEAR(sketch.min(), 51.0, 51.0 * 0.01);
+    EXPECT_NEAR(sketch.mean(), 75.5, 1e-9);
+
+    // Values never added are not removed
+    sketch.remove(1e6);
+    EXPECT_EQ(sketch.count(), 50u);
+
+    for (int i = 51; i <= 100; ++i) {
+        sketch.remove(i);
+    }
+    EXPECT_TRUE(sketch.empty());
+    EXPECT_EQ(sketch.quantile(0.5), 0.0);
+    EXPECT_EQ(sketch.mean(), 0.0);
+}
+
+TEST(QuantileSketchTest, KeepsZeroesAndSkipsNonFiniteValues) {
+    QuantileSketch sketch;
+    sketch.add(0.0);
+    sketch.add(0.0);
+    sketch.add(-3.0);
+    sketch.add(10.0);
+    sketch.add(std::nan(""));
+    sketch.add(INFINITY);
+    EXPECT_EQ(sketch.count(), 4u);
+    EXPECT_EQ(sketch.quantile(0.5), 0.0);
+    EXPECT_NEAR(sketch.max(), 10.0, 0.1);
+}
+
+TEST(QuantileSketchTest, MergesAcrossRanges) {
+    QuantileSketch low;
+    QuantileSketch high;
+    for (int i = 0; i < 100; ++i) {
+        low.add(1.0 + i * 0.01);
+        high.add(1000.0 + i);
+    }
+    low.merge(high);
+    EXPECT_EQ(low.count(), 200u);
+    EXPECT_NEAR(low.min(), 1.0, 0.01);
+    EXPECT_NEAR(low.max(), 1099.0, 11.0);
+    EXPECT_NEAR(low.quantile(0.75), 1050.0, 11.0);
+
+    EXPECT_THROW(low.merge(QuantileSketch(0.05)), std::invalid_argument);
+    EXPECT_THROW(QuantileSketch(0.0), std::invalid_argument);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
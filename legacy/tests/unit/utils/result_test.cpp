@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/result.hpp"
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+TEST(ResultTest, CodedErrorsCarryTheirFixedText) {
+    Result<std::vector<uint8_t>> result(ErrorCode::IncompleteTransmission);
+    EXPECT_TRUE(result.has_error());
+    EXPECT_EQ(result.error_code(), ErrorCode::IncompleteTransmission);
+    EXPECT_EQ(result.error(), "Incomplete transmission");
+    // The text is shared, not built per error
+    EXPECT_EQ(&result.error(), &error_code_message(ErrorCode::IncompleteTransmission));
+}
+
+TEST(ResultTest, ContextIsAppendedToTheCodeText) {
+    Result<void> result(Error(ErrorCode::ReceiveFailed, "connection reset"));
+    EXPECT_EQ(result.error_code(), ErrorCode::ReceiveFailed);
+    EXPECT_EQ(result.error(), "Failed to receive fragment: connection reset");
+
+    // Forwarding the Error keeps the code
+    Result<int> forwarded(result.error_info());
+    EXPECT_TRUE(forwarded.error_info() == ErrorCode::ReceiveFailed);
+    EXPECT_EQ(forwarded.error(), result.error());
+}
+
+TEST(ResultTest, MessagesWithoutACodeAreUnknown) {
+    Result<int> result("Key not found");
+    EXPECT_EQ(result.error_code(), ErrorCode::Unknown);
+    EXPECT_EQ(result.error(), "Key not found");
+
+    Result<int> success(3);
+    EXPECT_EQ(success.error_code(), ErrorCode::None);
+    EXPECT_EQ(Result<void>().error_code(), ErrorCode::None);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/serialization.h"
+#include <string>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+using core::Capability;
+
+TEST(SerializationTest, CapabilityRoundTripAndTruncation) {
+    Capability cap = {"video.encode", {2, 1, 300}, {{"codec", "av1"}, {"profile", std::string(200, 'x')}}};
+    std::vector<uint8_t> data = {0xAA};  // Existing contents are kept
+    serializeCapability(cap, data);
+    ASSERT_EQ(data[0], 0xAA);
+    ASSERT_EQ(data[1], CAPABILITY_FORMAT_V1);
+
+    Capability decoded;
+    size_t bytesRead = 0;
+    ASSERT_TRUE(deserializeCapability(data.data() + 1, data.size() - 1, decoded, &bytesRead));
+    EXPECT_EQ(bytesRead, data.size() - 1);
+    EXPECT_EQ(decoded.name, cap.name);
+    EXPECT_EQ(decoded.version, cap.version);
+    EXPECT_EQ(decoded.parameters, cap.parameters);
+
+    for (size_t size = 0; size < data.size() - 1; ++size) {
+        EXPECT_FALSE(deserializeCapability(data.data() + 1, size, decoded)) << size;
+    }
+}
+
+TEST(SerializationTest, ViewMatchesLikeCapability) {
+    Capability offered = {"storage", {1, 4, 2}, {{"tier", "hot"}, {"region", "eu"}}};
+    std::vector<uint8_t> data;
+    serializeCapability(offered, data);
+    auto view = CapabilityView::parse(data.data(), data.size());
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->name(), "storage");
+    EXPECT_EQ(view->parameter("region"), std::string_view("eu"));
+    EXPECT_FALSE(view->parameter("zone").has_value());
+
+    std::vector<Capability> requirements = {
+        {"storage", {1, 2, 0}},
+        {"storage", {1, 5, 0}},
+        {"storage", {0, 9, 0}},
+        {"storage", {1, 0, 0}, {{"tier", "hot"}}},
+        {"storage", {1, 0, 0}, {{"tier", "cold"}}},
+        {"storage", {1, 0, 0}, {{"zone", "a"}}},
+        {"compute", {1, 0, 0}},
+    };
+    for (const auto& required : requirements) {
+        for (bool partial : {false, true}) {
+            EXPECT_EQ(view->matches(required, partial), offered.matches(required, partial))
+                << required.name << " " << required.version.toString() << " partial=" << partial;
+        }
+    }
+}
+
+TEST(SerializationTest, SetSharesStringsAndDecodesInPlace) {
+    std::vector<Capability> caps;
+    for (uint16_t minor = 0; minor < 20; ++minor) {
+        caps.push_back({"inference.text", {1, minor, 0}, {{"precision", "fp16"}, {"backend", "cuda"}}});
+    }
+    std::vector<uint8_t> set;
+    serializeCapabilitySet(caps, set);
+
+    size_t individual = 0;
+    for (const auto& cap : caps) {
+        std::vector<uint8_t> one;
+        serializeCapability(cap, one);
+        individual += one.size();
+    }
+    EXPECT_LT(set.size() * 3, individual);
+
+    auto view = CapabilitySetView::parse(set.data(), set.size());
+    ASSERT_TRUE(view.has_value());
+    ASSERT_EQ(view->size(), caps.size());
+    EXPECT_EQ((*view)[7].version(), caps[7].version);
+    EXPECT_EQ((*view)[7].parameter("backend"), std::string_view("cuda"));
+    EXPECT_TRUE(view->anyMatches({"inference.text", {1, 19, 0}}));
+    EXPECT_FALSE(view->anyMatches({"inference.text", {1, 20, 0}}));
+
+    std::vector<Capability> decoded;
+    ASSERT_TRUE(deserializeCapabilitySet(set.data(), set.size(), decoded));
+    ASSERT_EQ(decoded.size(), caps.size());
+    for (size_t i = 0; i < caps.size(); ++i) {
+        EXPECT_EQ(decoded[i].version, caps[i].version);
+        EXPECT_EQ(decoded[i].parameters, caps[i].parameters);
+    }
+
+    // A single capability is not a set, and a set must be consumed exactly
+    std::vector<uint8_t> single;
+    serializeCapability(caps[0], single);
+    EXPECT_FALSE(CapabilitySetView::parse(single.data(), single.size()).has_value());
+    set.push_back(0);
+    EXPECT_FALSE(CapabilitySetView::parse(set.data(), set.size()).has_value());
+    set.pop_back();
+    set.back() = 0xFF;  // Index past the string table
+    EXPECT_FALSE(CapabilitySetView::parse(set.data(), set.size()).has_value());
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/task_scheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+using std::chrono::milliseconds;
+
+// Polls until done() or the timeout elapses
+template <typename Pred>
+bool waitFor(Pred done, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = TaskScheduler::Clock::now() + timeout;
+    while (!done()) {
+        if (TaskScheduler::Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+TEST(TaskSchedulerTest, RunsPeriodicTasksUntilCancelled) {
+    TaskScheduler scheduler;
+    std::atomic<int> runs{0};
+    auto id = scheduler.scheduleEvery(milliseconds(5), [&] { ++runs; });
+
+    ASSERT_TRUE(waitFor([&] { return runs.load() >= 3; }));
+    scheduler.cancel(id);
+    int after = runs.load();
+    std::this_thread::sleep_for(milliseconds(30));
+    EXPECT_EQ(runs.load(), after);
+    EXPECT_EQ(scheduler.size(), 0u);
+}
+
+TEST(TaskSchedulerTest, RunsOnDemandTasksWhenAsked) {
+    TaskScheduler scheduler;
+    std::atomic<int> runs{0};
+    auto id = scheduler.add([&] { ++runs; });
+
+    std::this_thread::sleep_for(milliseconds(20));
+    EXPECT_EQ(runs.load(), 0);
+    scheduler.runNow(id);
+    ASSERT_TRUE(waitFor([&] { return runs.load() == 1; }));
+
+    // A later deadline does not postpone an earlier one
+    scheduler.runBy(id, TaskScheduler::Clock::now() + milliseconds(10));
+    scheduler.runBy(id, TaskScheduler::Clock::now() + milliseconds(60000));
+    ASSERT_TRUE(waitFor([&] { return runs.load() == 2; }));
+    std::this_thread::sleep_for(milliseconds(20));
+    EXPECT_EQ(runs.load(), 2);
+}
+
+TEST(TaskSchedulerTest, NeverRunsATaskTwiceAtOnce) {
+    TaskScheduler scheduler(4);
+    std::atomic<int> active{0};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> runs{0};
+    TaskScheduler::TaskId id = TaskScheduler::INVALID_TASK;
+    id = scheduler.add([&] {
+        if (++active > 1) {
+            ++overlaps;
+        }
+        std::this_thread::sleep_for(milliseconds(2));
+        --active;
+        ++runs;
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        scheduler.runNow(id);
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    ASSERT_TRUE(waitFor([&] { return runs.load() > 0 && active.load() == 0; }));
+    scheduler.cancel(id);
+    EXPECT_EQ(overlaps.load(), 0);
+}
+
+TEST(TaskSchedulerTest, CancelWaitsForARunningTask) {
+    TaskScheduler scheduler;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+    auto id = scheduler.add([&] {
+        started = true;
+        std::this_thread::sleep_for(milliseconds(30));
+        finished = true;
+    });
+    scheduler.runNow(id);
+    ASSERT_TRUE(waitFor([&] { return started.load(); }));
+
+    scheduler.cancel(id);
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(TaskSchedulerTest, TasksMayCancelThemselvesAndSurviveExceptions) {
+    TaskScheduler scheduler(1);
+    std::atomic<int> runs{0};
+    TaskScheduler::TaskId self = TaskScheduler::INVALID_TASK;
+    std::atomic<bool> ready{false};
+    self = scheduler.scheduleEvery(milliseconds(1), [&] {
+        while (!ready) {
+            std::this_thread::yield();
+        }
+        ++runs;
+        scheduler.cancel(self);
+        throw std::runtime_error("done");
+    });
+    ready = true;
+    ASSERT_TRUE(waitFor([&] { return scheduler.size() == 0; }));
+    EXPECT_EQ(runs.load(), 1);
+
+    // The worker is still serving other tasks
+    std::atomic<bool> ran{false};
+    scheduler.runNow(scheduler.add([&] { ran = true; }));
+    EXPECT_TRUE(waitFor([&] { return ran.load(); }));
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/timer_service.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+using std::chrono::milliseconds;
+
+// Polls until done() or the timeout elapses
+template <typename Pred>
+bool waitFor(Pred done, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = TimerService::Clock::now() + timeout;
+    while (!done()) {
+        if (TimerService::Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+TEST(TimerServiceTest, RunsCallbacksAfterTheirDelay) {
+    TimerService service;
+    std::atomic<int> fired{0};
+    auto start = TimerService::Clock::now();
+    std::atomic<TimerService::Clock::rep> firedAt{0};
+
+    service.scheduleAfter(milliseconds(20), [&] {
+        firedAt = (TimerService::Clock::now() - start).count();
+        ++fired;
+    });
+    ASSERT_TRUE(waitFor([&] { return fired.load() == 1; }));
+    EXPECT_GE(TimerService::Clock::duration(firedAt.load()), milliseconds(20));
+    EXPECT_EQ(service.pending(), 0u);
+}
+
+TEST(TimerServiceTest, EarlierTimerWakesSleepingThread) {
+    TimerService service;
+    std::atomic<bool> early{false};
+    service.scheduleAfter(milliseconds(60000), [] {});
+    service.scheduleAfter(milliseconds(5), [&] { early = true; });
+
+    EXPECT_TRUE(waitFor([&] { return early.load(); }, milliseconds(1000)));
+    EXPECT_EQ(service.pending(), 1u);
+}
+
+TEST(TimerServiceTest, CancelledTimersNeverRun) {
+    TimerService service;
+    std::atomic<bool> fired{false};
+    auto id = service.scheduleAfter(milliseconds(20), [&] { fired = true; });
+
+    EXPECT_TRUE(service.cancel(id));
+    EXPECT_FALSE(service.cancel(id));
+    std::this_thread::sleep_for(milliseconds(50));
+    EXPECT_FALSE(fired.load());
+}
+
+TEST(TimerServiceTest, RescheduleMovesTheDeadline) {
+    TimerService service;
+    std::atomic<bool> fired{false};
+    auto id = service.scheduleAfter(milliseconds(60000), [&] { fired = true; });
+
+    EXPECT_TRUE(service.reschedule(id, TimerService::Clock::now() + milliseconds(5)));
+    EXPECT_TRUE(waitFor([&] { return fired.load(); }));
+    EXPECT_FALSE(service.reschedule(id, TimerService::Clock::now()));
+}
+
+TEST(TimerServiceTest, CancelWaitsForARunningCallback) {
+    TimerService service;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+    auto id = service.scheduleAfter(milliseconds(0), [&] {
+        started = true;
+        std::this_thread::sleep_for(milliseconds(30));
+        finished = true;
+    });
+
+    ASSERT_TRUE(waitFor([&] { return started.load(); }));
+    EXPECT_FALSE(service.cancel(id));
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(TimerServiceTest, CallbacksMayScheduleAndCancel) {
+    TimerService service;
+    std::atomic<int> chain{0};
+    std::function<void()> step = [&] {
+        if (++chain < 3) {
+            service.scheduleAfter(milliseconds(1), step);
+        }
+    };
+    service.scheduleAfter(milliseconds(1), step);
+
+    EXPECT_TRUE(waitFor([&] { return chain.load() == 3; }));
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/timer_wheel.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+using Clock = TimerWheel<int>::Clock;
+using std::chrono::milliseconds;
+
+TEST(TimerWheelTest, ExpiresOnlyDueTimers) {
+    TimerWheel<int> wheel(milliseconds(1), 16);
+    auto start = Clock::now();
+    wheel.schedule(1, start + milliseconds(5));
+    wheel.schedule(2, start + milliseconds(50));
+
+    EXPECT_TRUE(wheel.expire(start + milliseconds(4)).empty());
+    EXPECT_EQ(wheel.expire(start + milliseconds(5)), std::vector<int>{1});
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_EQ(wheel.expire(start + milliseconds(50)), std::vector<int>{2});
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, KeepsTimersBeyondOneRevolution) {
+    TimerWheel<int> wheel(milliseconds(1), 8);
+    auto start = Clock::now();
+    wheel.schedule(7, start + milliseconds(20));
+
+    // Sweep past the slot several times before the deadline
+    for (int ms = 1; ms < 20; ++ms) {
+        EXPECT_TRUE(wheel.expire(start + milliseconds(ms)).empty());
+    }
+    EXPECT_EQ(wheel.expire(start + milliseconds(20)), std::vector<int>{7});
+}
+
+TEST(TimerWheelTest, PastDeadlinesFireOnNextExpire) {
+    TimerWheel<int> wheel(milliseconds(1), 16);
+    auto start = Clock::now();
+    wheel.expire(start + milliseconds(100));
+    wheel.schedule(3, start);
+
+    EXPECT_EQ(wheel.expire(start + milliseconds(100)), std::vector<int>{3});
+}
+
+TEST(TimerWheelTest, LongGapVisitsEverySlot) {
+    TimerWheel<int> wheel(milliseconds(1), 8);
+    auto start = Clock::now();
+    for (int i = 0; i < 8; ++i) {
+        wheel.schedule(i, start + milliseconds(i + 1));
+    }
+
+    auto expired = wheel.expire(start + milliseconds(1000));
+    std::sort(expired.begin(), expired.end());
+    EXPECT_EQ(expired, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST(TimerWheelTest, RescheduleFromExpiredKeys) {
+    TimerWheel<int> wheel(milliseconds(1), 16);
+    auto start = Clock::now();
+    wheel.schedule(1, start + milliseconds(1));
+
+    for (int key : wheel.expire(start + milliseconds(1))) {
+        wheel.schedule(key, start + milliseconds(10));
+    }
+    EXPECT_TRUE(wheel.expire(start + milliseconds(9)).empty());
+    EXPECT_EQ(wheel.expire(start + milliseconds(10)), std::vector<int>{1});
+}
+
+using Wheel = HierarchicalTimerWheel<int>;
+
+std::vector<int> keysOf(const std::vector<std::pair<Wheel::Handle, int>>& expired) {
+    std::vector<int> keys;
+    for (const auto& entry : expired) {
+        keys.push_back(entry.second);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+TEST(HierarchicalTimerWheelTest, ExpiresOnlyDueTimers) {
+    Wheel wheel;
+    auto start = Clock::now();
+    wheel.schedule(1, start + milliseconds(5));
+    wheel.schedule(2, start + milliseconds(50));
+
+    EXPECT_TRUE(wheel.expire(start + milliseconds(4)).empty());
+    EXPECT_EQ(keysOf(wheel.expire(start + milliseconds(5))), std::vector<int>{1});
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_EQ(keysOf(wheel.expire(start + milliseconds(50))), std::vector<int>{2});
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(HierarchicalTimerWheelTest, CascadesFromOuterLevels) {
+    Wheel wheel;
+    auto start = Clock::now();
+    // One deadline per level, and one beyond the span
+    std::vector<milliseconds> delays{milliseconds(300), milliseconds(20000),
+                                     milliseconds(2000000), milliseconds(70000000)};
+    for (int i = 0; i < static_cast<int>(delays.size()); ++i) {
+        wheel.schedule(i, start + delays[i]);
+    }
+
+    for (int i = 0; i < static_cast<int>(delays.size()); ++i) {
+        EXPECT_TRUE(wheel.expire(start + delays[i] - milliseconds(1)).empty());
+        EXPECT_EQ(keysOf(wheel.expire(start + delays[i])), std::vector<int>{i});
+    }
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(HierarchicalTimerWheelTest, CancelAndReschedule) {
+    Wheel wheel;
+    auto start = Clock::now();
+    auto dropped = wheel.schedule(1, start + milliseconds(10));
+    auto moved = wheel.schedule(2, start + milliseconds(10));
+
+    EXPECT_TRUE(wheel.cancel(dropped));
+    EXPECT_FALSE(wheel.cancel(dropped));
+    EXPECT_TRUE(wheel.reschedule(moved, start + milliseconds(5000)));
+    EXPECT_EQ(wheel.size(), 1u);
+
+    EXPECT_TRUE(wheel.expire(start + milliseconds(4999)).empty());
+    auto expired = wheel.expire(start + milliseconds(5000));
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0].first, moved);
+    EXPECT_EQ(expired[0].second, 2);
+}
+
+TEST(HierarchicalTimerWheelTest, StaleHandlesAreRejected) {
+    Wheel wheel;
+    auto start = Clock::now();
+    auto fired = wheel.schedule(1, start);
+    wheel.expire(start);
+
+    // The slot is reused, but the old handle must not reach the new timer
+    auto reused = wheel.schedule(2, start + milliseconds(10));
+    EXPECT_NE(reused, fired);
+    EXPECT_FALSE(wheel.cancel(fired));
+    EXPECT_FALSE(wheel.reschedule(fired, start));
+    EXPECT_FALSE(wheel.cancel(Wheel::INVALID_HANDLE));
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+TEST(HierarchicalTimerWheelTest, NextWakeupNeverPassesADeadline) {
+    Wheel wheel;
+    auto start = Clock::now();
+    EXPECT_EQ(wheel.nextWakeup(), Clock::time_point::max());
+
+    wheel.schedule(1, start + milliseconds(40000));
+    EXPECT_LE(wheel.nextWakeup(), start + milliseconds(40000));
+    wheel.schedule(2, start + milliseconds(3));
+    EXPECT_LE(wheel.nextWakeup(), start + milliseconds(3));
+    EXPECT_GT(wheel.nextWakeup(), start);
+}
+
+TEST(HierarchicalTimerWheelTest, MatchesReferenceOrdering) {
+    Wheel wheel;
+    auto start = Clock::now();
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> delay(0, 100000);
+    std::multimap<Clock::time_point, int> reference;
+    std::map<int, Wheel::Handle> handles;
+
+    for (int i = 0; i < 2000; ++i) {
+        auto deadline = start + milliseconds(delay(rng));
+        handles[i] = wheel.schedule(i, deadline);
+        reference.emplace(deadline, i);
+    }
+    // Cancel every third timer
+    for (auto it = reference.begin(); it != reference.end();) {
+        if (it->second % 3 == 0) {
+            EXPECT_TRUE(wheel.cancel(handles[it->second]));
+            it = reference.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (int ms = 0; ms <= 100000; ms += 997) {
+        auto now = start + milliseconds(ms);
+        std::vector<int> expected;
+        while (!reference.empty() && reference.begin()->first <= now) {
+            expected.push_back(reference.begin()->second);
+            reference.erase(reference.begin());
+        }
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(keysOf(wheel.expire(now)), expected) << "at " << ms << " ms";
+    }
+    EXPECT_EQ(keysOf(wheel.expire(start + milliseconds(100000))).size(), reference.size());
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/trace.hpp"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Tracer::shared().clear();
+        Tracer::setCurrentCorrelation(0);
+    }
+
+    void TearDown() override {
+        Tracer::shared().setEnabled(false);
+        Tracer::shared().clear();
+    }
+
+    static std::vector<TraceEvent> named(const char* name) {
+        std::vector<TraceEvent> events;
+        for (const auto& event : Tracer::shared().snapshot()) {
+            if (std::strcmp(event.name, name) == 0) {
+                events.push_back(event);
+            }
+        }
+        return events;
+    }
+};
+
+TEST_F(TraceTest, RecordsNothingWhileDisabled) {
+    Tracer::shared().setEnabled(false);
+    {
+        TraceSpan span("disabled");
+    }
+    EXPECT_TRUE(Tracer::shared().snapshot().empty());
+}
+
+TEST_F(TraceTest, SpansTakeTheCorrelationSetBeforeTheyEnd) {
+    Tracer::shared().setEnabled(true);
+    {
+        TraceSpan message("message", true);
+        {
+            TraceSpan stage("stage");
+            Tracer::setCurrentCorrelation(42);
+        }
+    }
+    auto stages = named("stage");
+    auto messages = named("message");
+    ASSERT_EQ(stages.size(), 1u);
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(stages[0].correlation_id, 42u);
+    EXPECT_EQ(messages[0].correlation_id, 42u);
+    EXPECT_GE(stages[0].start_ns, messages[0].start_ns);
+    EXPECT_LE(stages[0].start_ns + stages[0].duration_ns, messages[0].start_ns + messages[0].duration_ns);
+}
+
+TEST_F(TraceTest, MessageSpanRestoresTheOuterCorrelation) {
+    Tracer::shared().setEnabled(true);
+    Tracer::setCurrentCorrelation(7);
+    {
+        TraceSpan inner("inner", true);
+        EXPECT_EQ(Tracer::currentCorrelation(), 0u);
+        Tracer::setCurrentCorrelation(8);
+    }
+    EXPECT_EQ(Tracer::currentCorrelation(), 7u);
+    {
+        TraceSpan after("after");
+    }
+    ASSERT_EQ(named("inner").size(), 1u);
+    EXPECT_EQ(named("inner")[0].correlation_id, 8u);
+    ASSERT_EQ(named("after").size(), 1u);
+    EXPECT_EQ(named("after")[0].correlation_id, 7u);
+}
+
+TEST_F(TraceTest, CollectsSpansFromEveryThread) {
+    Tracer::shared().setEnabled(true);
+    constexpr int THREADS = 4;
+    constexpr int SPANS = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < SPANS; ++i) {
+                TraceSpan message("worker", true);
+                Tracer::setCurrentCorrelation(static_cast<uint64_t>(t + 1));
+            }
+        });
+    }
+    // Reading while the workers record must be safe
+    while (Tracer::shared().snapshot().size() < static_cast<size_t>(THREADS)) {
+        std::this_thread::yield();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto events = named("worker");
+    ASSERT_EQ(events.size(), static_cast<size_t>(THREADS * SPANS));
+    for (const auto& event : events) {
+        // Each thread labels its own spans, and each thread has its own ring
+        EXPECT_GE(event.correlation_id, 1u);
+        EXPECT_LE(event.correlation_id, static_cast<uint64_t>(THREADS));
+    }
+    std::vector<uint32_t> thread_of(THREADS + 1, 0);
+    for (const auto& event : events) {
+        uint32_t& id = thread_of[event.correlation_id];
+        if (id == 0) {
+            id = event.thread_id;
+        }
+        EXPECT_EQ(id, event.thread_id);
+    }
+}
+
+TEST_F(TraceTest, FullRingKeepsTheLatestSpans) {
+    Tracer::shared().setEnabled(true);
+    const size_t total = Tracer::RING_CAPACITY + 100;
+    for (size_t i = 0; i < total; ++i) {
+        Tracer::shared().record("wrap", i, i, i + 1);
+    }
+    auto events = named("wrap");
+    ASSERT_EQ(events.size(), Tracer::RING_CAPACITY);
+    EXPECT_EQ(events.front().correlation_id, 100u);
+    EXPECT_EQ(events.back().correlation_id, total - 1);
+}
+
+TEST_F(TraceTest, ClearForgetsRecordedSpans) {
+    Tracer::shared().setEnabled(true);
+    Tracer::shared().record("old", 1, 0, 1);
+    Tracer::shared().clear();
+    Tracer::shared().record("new", 2, 0, 1);
+    EXPECT_TRUE(named("old").empty());
+    EXPECT_EQ(named("new").size(), 1u);
+}
+
+TEST_F(TraceTest, ExportsChromeAndOtlpJson) {
+    Tracer::shared().setEnabled(true);
+    Tracer::shared().record("tm.\"send\"", 0x1234, 1000, 3000);
+
+    const std::string chrome = Tracer::shared().exportChromeTrace();
+    EXPECT_NE(chrome.find("\"traceEvents\":["), std::string::npos);
+    EXPECT_NE(chrome.find("\"name\":\"tm.\\\"send\\\"\""), std::string::npos);
+    EXPECT_NE(chrome.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(chrome.find("\"ts\":1.000,\"dur\":2.000"), std::string::npos);
+    EXPECT_NE(chrome.find("\"correlation_id\":4660"), std::string::npos);
+
+    const std::string otlp = Tracer::shared().exportOtlpJson("bench");
+    EXPECT_NE(otlp.find("\"stringValue\":\"bench\""), std::string::npos);
+    // The correlation ID is the trace ID, so both ends of a message share a trace
+    EXPECT_NE(otlp.find("\"traceId\":\"00000000000000000000000000001234\""), std::string::npos);
+    EXPECT_NE(otlp.find("\"intValue\":\"4660\""), std::string::npos);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/vector_quantize.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::vector<float> generateRandomFloats(size_t size, uint32_t seed) {
+    std::vector<float> data(size);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(-50.0f, 300.0f);
+    for (auto& value : data) {
+        value = dis(gen);
+    }
+    return data;
+}
+
+uint8_t referenceQuantize(float value, float scale, float bias) {
+    double scaled = static_cast<double>(value) * scale + bias;
+    return static_cast<uint8_t>(std::clamp(scaled, 0.0, 255.0));
+}
+
+TEST(VectorQuantizeTest, KernelsMatchReferenceAcrossTails) {
+    // Cover the SIMD block boundaries, scalar tails and unaligned starts
+    auto src = generateRandomFloats(1024 + 8, 7);
+    for (size_t offset = 0; offset < 3; ++offset) {
+        for (size_t size : {1u, 7u, 8u, 15u, 16u, 31u, 32u, 33u, 63u, 64u, 65u, 100u, 1024u}) {
+            std::vector<uint8_t> codes(size);
+            quantizeToUint8(src.data() + offset, codes.data(), size, 0.8f, 3.0f);
+            for (size_t i = 0; i < size; ++i) {
+                // The float and double paths may round differently right at a code boundary
+                int expected = referenceQuantize(src[offset + i], 0.8f, 3.0f);
+                ASSERT_NEAR(static_cast<int>(codes[i]), expected, 1) << "size " << size << " index " << i;
+            }
+
+            std::vector<float> decoded(size);
+            dequantizeFromUint8(codes.data(), decoded.data(), size, 1.25f, -2.0f);
+            for (size_t i = 0; i < size; ++i) {
+                ASSERT_FLOAT_EQ(decoded[i], codes[i] * 1.25f - 2.0f) << "size " << size << " index " << i;
+            }
+        }
+    }
+}
+
+TEST(VectorQuantizeTest, ClampsAndMapsNanToMaximum) {
+    std::vector<float> src(40, 1.0f);
+    src[0] = -5.0f;
+    src[1] = 1e9f;
+    src[2] = std::numeric_limits<float>::quiet_NaN();
+    src[33] = std::numeric_limits<float>::quiet_NaN();
+    std::vector<uint8_t> codes(src.size());
+    quantizeToUint8(src.data(), codes.data(), src.size(), 1.0f);
+
+    EXPECT_EQ(codes[0], 0);
+    EXPECT_EQ(codes[1], 255);
+    EXPECT_EQ(codes[2], 255);
+    EXPECT_EQ(codes[3], 1);
+    EXPECT_EQ(codes[33], 255);
+}
+
+TEST(VectorQuantizeTest, RangeIgnoresNan) {
+    auto src = generateRandomFloats(203, 11);
+    src[17] = std::numeric_limits<float>::quiet_NaN();
+    src[200] = std::numeric_limits<float>::quiet_NaN();
+    src[0] = std::numeric_limits<float>::quiet_NaN();
+    float expectedMin = std::numeric_limits<float>::infinity();
+    float expectedMax = -std::numeric_limits<float>::infinity();
+    for (float value : src) {
+        if (!std::isnan(value)) {
+            expectedMin = std::min(expectedMin, value);
+            expectedMax = std::max(expectedMax, value);
+        }
+    }
+
+    float min = 0.0f;
+    float max = 0.0f;
+    floatRange(src.data(), src.size(), min, max);
+    EXPECT_EQ(min, expectedMin);
+    EXPECT_EQ(max, expectedMax);
+
+    std::vector<float> nans(20, std::numeric_limits<float>::quiet_NaN());
+    floatRange(nans.data(), nans.size(), min, max);
+    EXPECT_GT(min, max);
+}
+
+TEST(VectorQuantizeTest, HalfConversionRoundTripsEveryHalf) {
+    std::vector<uint16_t> halves(65536);
+    for (size_t i = 0; i < halves.size(); ++i) {
+        halves[i] = static_cast<uint16_t>(i);
+    }
+    std::vector<float> floats(halves.size());
+    halfToFloat(halves.data(), floats.data(), halves.size());
+    std::vector<uint16_t> back(halves.size());
+    floatToHalf(floats.data(), back.data(), floats.size());
+
+    for (size_t i = 0; i < halves.size(); ++i) {
+        bool nan = (i & 0x7C00) == 0x7C00 && (i & 0x3FF) != 0;
+        if (nan) {
+            ASSERT_TRUE(std::isnan(floats[i])) << i;
+            ASSERT_EQ(back[i] & 0x7C00, 0x7C00) << i;
+            ASSERT_NE(back[i] & 0x3FF, 0) << i;
+        } else {
+            ASSERT_EQ(back[i], halves[i]) << i;
+        }
+    }
+    EXPECT_EQ(floats[0x3C00], 1.0f);
+    EXPECT_EQ(floats[0x0001], std::ldexp(1.0f, -24));
+    EXPECT_EQ(floats[0xFBFF], -65504.0f);
+}
+
+TEST(VectorQuantizeTest, HalfConversionRoundsToNearest) {
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> dis(-70000.0f, 70000.0f);
+    std::vector<float> src(1003);
+    for (size_t i = 0; i < src.size(); ++i) {
+        // Mix large values, overflow to infinity and subnormal-range values
+        src[i] = (i % 3 == 0) ? dis(gen) * 1e-9f : dis(gen);
+    }
+    std::vector<uint16_t> halves(src.size());
+    floatToHalf(src.data(), halves.data(), src.size());
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        float value = src[i];
+        uint16_t magnitude = halves[i] & 0x7FFF;
+        uint16_t sign = halves[i] & 0x8000;
+        if (std::fabs(value) >= 65520.0f) {
+            ASSERT_EQ(magnitude, 0x7C00) << value;
+            continue;
+        }
+        ASSERT_LT(magnitude, 0x7C00) << value;
+        float neighbours[3];
+        uint16_t candidates[3] = {static_cast<uint16_t>(sign | magnitude),
+                                  static_cast<uint16_t>(sign | (magnitude + 1)),
+                                  static_cast<uint16_t>(sign | (magnitude == 0 ? 0 : magnitude - 1))};
+        halfToFloat(candidates, neighbours, 3);
+        ASSERT_LE(std::fabs(neighbours[0] - value), std::fabs(neighbours[1] - value)) << value;
+        ASSERT_LE(std::fabs(neighbours[0] - value), std::fabs(neighbours[2] - value)) << value;
+    }
+}
+
+TEST(VectorQuantizeTest, Bfloat16RoundsToNearestEven) {
+    auto bits = [](float value) {
+        uint32_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    };
+    auto src = generateRandomFloats(1003, 13);
+    src[5] = std::numeric_limits<float>::quiet_NaN();
+    src[40] = std::numeric_limits<float>::infinity();
+    std::vector<uint16_t> narrowed(src.size());
+    floatToBfloat16(src.data(), narrowed.data(), src.size());
+    std::vector<float> widened(src.size());
+    bfloat16ToFloat(narrowed.data(), widened.data(), src.size());
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (std::isnan(src[i])) {
+            ASSERT_TRUE(std::isnan(widened[i])) << i;
+            continue;
+        }
+        uint32_t value = bits(src[i]);
+        uint32_t expected = (value + 0x7FFF + ((value >> 16) & 1)) >> 16;
+        ASSERT_EQ(narrowed[i], expected) << i;
+        ASSERT_EQ(bits(widened[i]), expected << 16) << i;
+    }
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
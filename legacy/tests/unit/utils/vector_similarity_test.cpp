@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/vector_similarity.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+std::vector<float> generateRandomFloats(size_t size, uint32_t seed) {
+    std::vector<float> data(size);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    for (auto& value : data) {
+        value = dis(gen);
+    }
+    return data;
+}
+
+double referenceCosine(const float* a, const float* b, size_t dimension) {
+    double dot = 0.0, normA = 0.0, normB = 0.0;
+    for (size_t i = 0; i < dimension; ++i) {
+        dot += double(a[i]) * b[i];
+        normA += double(a[i]) * a[i];
+        normB += double(b[i]) * b[i];
+    }
+    return normA > 0.0 && normB > 0.0 ? dot / std::sqrt(normA * normB) : 0.0;
+}
+
+TEST(VectorSimilarityTest, KernelsMatchReferenceAcrossTails) {
+    // Cover the SIMD block boundaries and scalar tails
+    for (size_t dimension : {1u, 7u, 8u, 15u, 16u, 31u, 32u, 33u, 64u, 100u, 384u}) {
+        const size_t rows = 5;
+        auto a = generateRandomFloats(rows * dimension, 3);
+        auto b = generateRandomFloats(rows * dimension, 4);
+        std::vector<float> out(rows);
+        cosineSimilarityRows(a.data(), nullptr, b.data(), nullptr, rows, dimension, out.data());
+        for (size_t r = 0; r < rows; ++r) {
+            ASSERT_NEAR(out[r], referenceCosine(&a[r * dimension], &b[r * dimension], dimension), 1e-5)
+                << "dimension " << dimension << " row " << r;
+        }
+    }
+}
+
+TEST(VectorSimilarityTest, PairsRowsThroughIndexArrays) {
+    const size_t dimension = 40;
+    auto a = generateRandomFloats(4 * dimension, 5);
+    auto b = generateRandomFloats(3 * dimension, 6);
+    const uint32_t aRows[] = {3, 0, 3};
+    const uint32_t bRows[] = {1, 2, 0};
+    float out[3];
+    cosineSimilarityRows(a.data(), aRows, b.data(), bRows, 3, dimension, out);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(out[i], referenceCosine(&a[aRows[i] * dimension], &b[bRows[i] * dimension], dimension), 1e-5);
+    }
+
+    // Identical rows score 1, opposite ones -1, and zero rows 0
+    std::vector<float> same(a.begin(), a.begin() + dimension);
+    std::vector<float> opposite(same);
+    for (auto& value : opposite) {
+        value = -value;
+    }
+    std::vector<float> zero(dimension, 0.0f);
+    cosineSimilarityRows(a.data(), nullptr, same.data(), nullptr, 1, dimension, out);
+    EXPECT_NEAR(out[0], 1.0f, 1e-6);
+    cosineSimilarityRows(a.data(), nullptr, opposite.data(), nullptr, 1, dimension, out);
+    EXPECT_NEAR(out[0], -1.0f, 1e-6);
+    cosineSimilarityRows(a.data(), nullptr, zero.data(), nullptr, 1, dimension, out);
+    EXPECT_EQ(out[0], 0.0f);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
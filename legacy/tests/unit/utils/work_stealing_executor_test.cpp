@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "xenocomm/utils/work_stealing_executor.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace xenocomm {
+namespace utils {
+namespace {
+
+using std::chrono::milliseconds;
+
+// Polls until done() or the timeout elapses
+template <typename Pred>
+bool waitFor(Pred done, milliseconds timeout = milliseconds(2000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+TEST(WorkStealingExecutorTest, RunsTasksSubmittedFromInsideAndOutside) {
+    WorkStealingExecutor executor(4);
+    ASSERT_EQ(executor.workerCount(), 4u);
+
+    std::atomic<int> runs{0};
+    for (int i = 0; i < 100; ++i) {
+        executor.submit([&] {
+            ++runs;
+            // Follow-up work from a worker lands on its own deque
+            executor.submit([&] { ++runs; });
+        });
+    }
+    EXPECT_TRUE(waitFor([&] { return runs.load() == 200; }));
+
+    // A throwing task does not stop the worker that ran it
+    executor.submit([] { throw std::runtime_error("dropped"); });
+    executor.submit([&] { ++runs; });
+    EXPECT_TRUE(waitFor([&] { return runs.load() == 201; }));
+}
+
+TEST(WorkStealingExecutorTest, IdleWorkersStealFromABusyOne) {
+    WorkStealingExecutor executor(3);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> done{0};
+
+    // Everything is queued on one worker's deque; the others must steal to help
+    executor.submit([&] {
+        for (int i = 0; i < 30; ++i) {
+            executor.submit([&] {
+                std::this_thread::sleep_for(milliseconds(2));
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+                ++done;
+            });
+        }
+    });
+    ASSERT_TRUE(waitFor([&] { return done.load() == 30; }));
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(WorkStealingExecutorTest, ResizesWithoutLosingQueuedTasks) {
+    WorkStealingExecutor executor(1);
+    std::atomic<bool> release{false};
+    std::atomic<int> runs{0};
+    executor.submit([&] {
+        while (!release.load()) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    });
+    executor.resize(4);
+    EXPECT_EQ(executor.workerCount(), 4u);
+    for (int i = 0; i < 50; ++i) {
+        executor.submit([&] { ++runs; });
+    }
+    // The first worker is still blocked, so the new ones ran these
+    EXPECT_TRUE(waitFor([&] { return runs.load() == 50; }));
+
+    for (int i = 0; i < 50; ++i) {
+        executor.submit([&] { ++runs; });
+    }
+    release = true;
+    executor.resize(1);
+    EXPECT_EQ(executor.workerCount(), 1u);
+    EXPECT_TRUE(waitFor([&] { return runs.load() == 100; }));
+
+    // Retiring from inside a task returns without waiting on itself
+    std::atomic<bool> resized{false};
+    executor.resize(2);
+    executor.submit([&] {
+        executor.resize(1);
+        resized = true;
+    });
+    EXPECT_TRUE(waitFor([&] { return resized.load(); }));
+    executor.submit([&] { ++runs; });
+    EXPECT_TRUE(waitFor([&] { return runs.load() == 101; }));
+}
+
+TEST(WorkStealingExecutorTest, PinningCanChangeWhileRunning) {
+    WorkStealingExecutor executor(2, ThreadPinning::CORE);
+    EXPECT_EQ(executor.pinning(), ThreadPinning::CORE);
+    std::atomic<int> runs{0};
+    executor.submit([&] { ++runs; });
+    executor.setPinning(ThreadPinning::NUMA_NODE);
+    executor.resize(3);
+    executor.submit([&] { ++runs; });
+    executor.setPinning(ThreadPinning::NONE);
+    executor.submit([&] { ++runs; });
+    EXPECT_TRUE(waitFor([&] { return runs.load() == 3; }));
+    EXPECT_EQ(executor.pinning(), ThreadPinning::NONE);
+}
+
+TEST(WorkStealingExecutorTest, DestructionRunsQueuedTasks) {
+    std::atomic<int> runs{0};
+    {
+        WorkStealingExecutor executor(1);
+        for (int i = 0; i < 20; ++i) {
+            executor.submit([&] {
+                std::this_thread::sleep_for(milliseconds(1));
+                ++runs;
+            });
+        }
+    }
+    EXPECT_EQ(runs.load(), 20);
+}
+
+} // namespace
+} // namespace utils
+} // namespace xenocomm
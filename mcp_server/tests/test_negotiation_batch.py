@@ -0,0 +1,110 @@
+"""Tests for batch negotiation checks on the native swarm kernel and its fallback.
+
+The kernel is replaced by a fake that answers with the pure-Python rules, so
+these run whether or not the xenocomm extension is installed.
+"""
+
+import pytest
+
+from xenocomm_mcp import native
+from xenocomm_mcp.negotiation import (
+    NegotiableParams,
+    NegotiationEngine,
+    ParamCompatibility,
+)
+
+
+class FakeSwarm:
+    """Answers like the kernel does: compatibility values as strings."""
+
+    def __init__(self, reject: bool = False):
+        self.reject = reject
+        self.calls: list[tuple[str, int]] = []
+
+    def check_compatibility_many(self, proposal, others):
+        self.calls.append(("check_compatibility_many", len(others)))
+        if self.reject:
+            raise TypeError("unconvertible value")
+        return [
+            {k: v.value for k, v in proposal.check_compatibility(other).items()}
+            for other in others
+        ]
+
+    def compatibility_matrix(self, agents):
+        self.calls.append(("compatibility_matrix", len(agents)))
+        if self.reject:
+            raise TypeError("unconvertible value")
+        native.swarm = None  # Let the reference implementation answer
+        try:
+            return [[c.value for c in row] for row in NegotiableParams.compatibility_matrix(agents)]
+        finally:
+            native.swarm = self
+
+
+@pytest.fixture
+def peers():
+    return [
+        NegotiableParams(),
+        NegotiableParams(data_format="msgpack", compression="zstd"),
+        NegotiableParams(compression="lz4", encryption="none"),
+        NegotiableParams(data_format="protobuf", max_message_size=4096),
+    ]
+
+
+@pytest.fixture(params=["native", "rejected", "python"])
+def kernel(request, monkeypatch):
+    """The native kernel, one that rejects every call, or none at all."""
+    swarm = {"native": FakeSwarm(), "rejected": FakeSwarm(reject=True), "python": None}[request.param]
+    monkeypatch.setattr(native, "swarm", swarm)
+    return swarm
+
+
+def test_check_compatibility_many_matches_pairwise(kernel, peers):
+    proposal = NegotiableParams(data_format="msgpack")
+    reports = proposal.check_compatibility_many(peers)
+
+    assert reports == [proposal.check_compatibility(peer) for peer in peers]
+    assert all(isinstance(v, ParamCompatibility) for r in reports for v in r.values())
+    if kernel is not None:
+        assert kernel.calls == [("check_compatibility_many", len(peers))]
+
+
+def test_compatibility_matrix_is_worst_of_each_pair(kernel, peers):
+    matrix = NegotiableParams.compatibility_matrix(peers)
+
+    assert matrix[1][1] == ParamCompatibility.COMPATIBLE
+    assert matrix[0][1] == matrix[1][0] == ParamCompatibility.UPGRADEABLE
+    assert matrix[0][2] == ParamCompatibility.INCOMPATIBLE  # Encryption downgrade
+    assert matrix[1][3] == ParamCompatibility.NEGOTIABLE
+    if kernel is not None:
+        assert kernel.calls == [("compatibility_matrix", len(peers))]
+
+
+def test_auto_resolve_many_batches_shared_proposals(kernel, peers):
+    engine = NegotiationEngine()
+    reference = NegotiationEngine()
+    proposal = {"data_format": "msgpack", "compression": "zstd", "encryption": "aes256"}
+    session_ids = {engine: [], reference: []}
+    for i, peer in enumerate(peers * 3):
+        for e in (engine, reference):
+            session = e.initiate_session("initiator", f"responder-{i}", proposal)
+            e.receive_proposal(session.session_id, f"responder-{i}")
+            if i % 4 != 3:  # Every fourth responder accepts instead of countering
+                e.respond_counter(session.session_id, f"responder-{i}", peer)
+            session_ids[e].append(session.session_id)
+
+    resolved = engine.auto_resolve_conflicts_many(session_ids[engine], prefer_initiator=False)
+
+    # The same merges and contest counts as resolving one session at a time
+    assert [resolved[s] for s in session_ids[engine]] == [
+        reference.auto_resolve_conflicts(s, prefer_initiator=False) for s in session_ids[reference]
+    ]
+    assert engine._param_contests == reference._param_contests
+    if kernel is not None:
+        # One batch for every countered session
+        assert kernel.calls == [("check_compatibility_many", 9)]
+
+
+def test_auto_resolve_many_rejects_unknown_session(kernel):
+    with pytest.raises(ValueError):
+        NegotiationEngine().auto_resolve_conflicts_many(["missing"])
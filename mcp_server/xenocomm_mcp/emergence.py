@@ -32,6 +32,8 @@ from collections import deque
 import math
 import statistics
 
+from . import native
+
 
 class VariantStatus(Enum):
     """Status of a protocol variant."""
@@ -694,6 +696,12 @@ class EmergenceEngine:
         recent = variant.metrics_history[-window:]
         values = [getattr(m, metric, 0) for m in recent]
 
+        if native.swarm is not None:
+            try:
+                return MetricTrend(native.swarm.analyze_trend(values, metric == "latency_ms"))
+            except native.NATIVE_ERRORS:
+                pass  # Non-numeric samples; the Python path below copes
+
         # Calculate linear regression slope
         n = len(values)
         if n < 2:
@@ -746,6 +754,12 @@ class EmergenceEngine:
         values = [getattr(m, metric, 0) for m in baseline]
         latest_value = getattr(latest, metric, 0)
 
+        if native.swarm is not None:
+            try:
+                return native.swarm.is_anomalous(values + [latest_value])
+            except native.NATIVE_ERRORS:
+                pass
+
         mean = sum(values) / len(values)
         try:
             std = statistics.stdev(values)
@@ -0,0 +1,23 @@
+"""
+XenoComm Native Kernels
+=======================
+
+The xenocomm C++ extension's ``swarm`` kernels, for the negotiation and
+emergence loops that dominate large multi-agent simulations.
+
+``swarm`` is None when the extension is not installed, or when
+XENOCOMM_MCP_NATIVE=0; callers then keep their pure-Python code, which
+defines the semantics the kernels match.
+"""
+
+import os
+
+swarm = None
+if os.environ.get("XENOCOMM_MCP_NATIVE", "1") != "0":
+    try:
+        from xenocomm._core import swarm
+    except ImportError:  # Bindings not built or not installed
+        swarm = None
+
+# What the kernels raise on a value they cannot convert; callers fall back
+NATIVE_ERRORS = (TypeError, ValueError, RuntimeError, AttributeError)
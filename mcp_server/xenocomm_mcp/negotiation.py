@@ -29,6 +29,8 @@ from enum import Enum
 import uuid
 from datetime import datetime, timedelta, timezone
 
+from . import native
+
 
 class NegotiationState(Enum):
     """States in the negotiation state machine."""
@@ -54,6 +56,20 @@ class ParamCompatibility(Enum):
     NEGOTIABLE = "negotiable"  # Requires negotiation
 
 
+# Least to most in the way of an agreement
+_COMPATIBILITY_SEVERITY = [
+    ParamCompatibility.COMPATIBLE,
+    ParamCompatibility.UPGRADEABLE,
+    ParamCompatibility.NEGOTIABLE,
+    ParamCompatibility.INCOMPATIBLE,
+]
+_COMPATIBILITY_BY_VALUE = {c.value: c for c in ParamCompatibility}
+
+
+def _worst_compatibility(results: dict[str, ParamCompatibility]) -> ParamCompatibility:
+    return max(results.values(), key=_COMPATIBILITY_SEVERITY.index)
+
+
 @dataclass
 class NegotiableParams:
     """Parameters that can be negotiated between agents."""
@@ -170,6 +186,48 @@ class NegotiableParams:
 
         return results
 
+    def check_compatibility_many(self, others: list["NegotiableParams"]) -> list[dict[str, ParamCompatibility]]:
+        """
+        check_compatibility() against each of others, in order.
+
+        Runs in the native swarm kernel when the xenocomm extension is
+        installed; a single pair is cheaper in Python than converting it.
+        """
+        if native.swarm is not None:
+            try:
+                return [
+                    {k: _COMPATIBILITY_BY_VALUE[v] for k, v in report.items()}
+                    for report in native.swarm.check_compatibility_many(self, others)
+                ]
+            except native.NATIVE_ERRORS:
+                pass  # Values the kernel cannot take; Python handles anything
+        return [self.check_compatibility(other) for other in others]
+
+    @staticmethod
+    def compatibility_matrix(agents: list["NegotiableParams"]) -> list[list[ParamCompatibility]]:
+        """
+        Worst compatibility between every pair of agents' parameters.
+
+        Row i, column j is the least agreeable entry of
+        agents[i].check_compatibility(agents[j]); the diagonal is COMPATIBLE.
+        """
+        if native.swarm is not None:
+            try:
+                return [
+                    [_COMPATIBILITY_BY_VALUE[v] for v in row]
+                    for row in native.swarm.compatibility_matrix(agents)
+                ]
+            except native.NATIVE_ERRORS:
+                pass
+        n = len(agents)
+        matrix = [[ParamCompatibility.COMPATIBLE] * n for _ in range(n)]
+        for i in range(n):
+            for j in range(i + 1, n):
+                worst = _worst_compatibility(agents[i].check_compatibility(agents[j]))
+                matrix[i][j] = worst
+                matrix[j][i] = worst
+        return matrix
+
     def merge_with(self, other: "NegotiableParams", prefer_self: bool = True) -> "NegotiableParams":
         """Create a merged parameter set that's compatible with both."""
         return NegotiableParams(
@@ -757,16 +815,53 @@ class NegotiationEngine:
         counter = session.counter_params
 
         # Check compatibility
-        compat = proposed.check_compatibility(counter)
+        self._track_contests(proposed.check_compatibility(counter))
+
+        # Merge based on compatibility
+        return proposed.merge_with(counter, prefer_self=prefer_initiator)
 
-        # Track contested parameters for analytics
+    def auto_resolve_conflicts_many(
+        self,
+        session_ids: list[str],
+        prefer_initiator: bool = True,
+    ) -> dict[str, NegotiableParams]:
+        """
+        auto_resolve_conflicts() for many sessions, keyed by session ID.
+
+        Sessions whose proposals agree on the checked fields are checked
+        against all their counters in one check_compatibility_many() call,
+        so simulations resolving hundreds of sessions run their checks in
+        the native swarm kernel when it is installed.
+        """
+        resolved: dict[str, NegotiableParams] = {}
+        groups: dict[tuple, list[NegotiationSession]] = {}
+        for session_id in session_ids:
+            session = self._get_session(session_id)
+            if session.counter_params is None:
+                resolved[session_id] = session.proposed_params
+                continue
+            proposed = session.proposed_params
+            # The fields check_compatibility() reads
+            key = (proposed.data_format, proposed.compression, proposed.encryption, proposed.max_message_size)
+            groups.setdefault(key, []).append(session)
+
+        for sessions in groups.values():
+            reports = sessions[0].proposed_params.check_compatibility_many(
+                [s.counter_params for s in sessions]
+            )
+            for session, compat in zip(sessions, reports):
+                self._track_contests(compat)
+                resolved[session.session_id] = session.proposed_params.merge_with(
+                    session.counter_params, prefer_self=prefer_initiator
+                )
+        return resolved
+
+    def _track_contests(self, compat: dict[str, ParamCompatibility]):
+        """Count contested parameters for analytics."""
         for param, status in compat.items():
             if status in (ParamCompatibility.NEGOTIABLE, ParamCompatibility.INCOMPATIBLE):
                 self._param_contests[param] = self._param_contests.get(param, 0) + 1
 
-        # Merge based on compatibility
-        return proposed.merge_with(counter, prefer_self=prefer_initiator)
-
     # ==================== Multi-Round Support ====================
 
     def submit_counter_proposal(